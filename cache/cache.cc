@@ -64,6 +64,15 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    enable_custom_split_merge),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"max_dict_bytes",
+         {offsetof(struct CompressedSecondaryCacheOptions, max_dict_bytes),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"zstd_max_train_bytes",
+         {offsetof(struct CompressedSecondaryCacheOptions,
+                   zstd_max_train_bytes),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 namespace {
@@ -169,6 +178,13 @@ void Cache::StartAsyncLookup(AsyncLookupHandle& async_handle) {
              async_handle.priority, async_handle.stats);
 }
 
+void Cache::StartAsyncLookupBatch(AsyncLookupHandle* async_handles,
+                                  size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    StartAsyncLookup(async_handles[i]);
+  }
+}
+
 Cache::Handle* Cache::Wait(AsyncLookupHandle& async_handle) {
   WaitAll(&async_handle, 1);
   return async_handle.Result();
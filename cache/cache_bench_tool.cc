@@ -25,8 +25,11 @@
 #include "rocksdb/secondary_cache.h"
 #include "rocksdb/system_clock.h"
 #include "rocksdb/table_properties.h"
+#include "rocksdb/trace_reader_writer.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/cachable_entry.h"
+#include "trace_replay/block_cache_tracer.h"
+#include "util/atomic.h"
 #include "util/coding.h"
 #include "util/distributed_mutex.h"
 #include "util/gflags_compat.h"
@@ -52,6 +55,10 @@ DEFINE_int32(
     eviction_effort_cap,
     ROCKSDB_NAMESPACE::HyperClockCacheOptions(1, 1).eviction_effort_cap,
     "HyperClockCacheOptions::eviction_effort_cap");
+DEFINE_bool(frequency_admission, false,
+            "HyperClockCacheOptions::frequency_admission");
+
+DEFINE_bool(lazy_promotion, false, "LRUCacheOptions::lazy_promotion");
 
 DEFINE_double(resident_ratio, 0.25,
               "Ratio of keys fitting in cache to keyspace.");
@@ -117,6 +124,24 @@ DEFINE_uint32(seed, 0, "Hashing/random seed to use. 0 = choose at random");
 DEFINE_string(secondary_cache_uri, "",
               "Full URI for creating a custom secondary cache object");
 
+DEFINE_uint64(compressed_secondary_cache_size, 0,
+              "If > 0, put a compressed secondary cache of this size under "
+              "the cache, making a tiered cache of cache_size + "
+              "compressed_secondary_cache_size");
+
+DEFINE_uint64(flash_cache_size, 0,
+              "If > 0, put a simulated flash cache of this size under the "
+              "cache, or under its compressed secondary cache if any");
+
+DEFINE_uint32(flash_read_latency_us, 100,
+              "Simulated latency of a hit in the flash cache, in "
+              "microseconds");
+
+DEFINE_string(block_cache_trace, "",
+              "If set, replay the block lookups of this block cache trace, "
+              "spread over the threads, instead of generating lookups. A miss "
+              "inserts the block, unless the trace record says not to.");
+
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
 DEFINE_bool(use_jemalloc_no_dump_allocator, false,
@@ -225,6 +250,10 @@ class SharedState {
     return 1.0 * lookup_hits_ / lookup_count_;
   }
 
+  uint64_t GetLookupCount() const { return lookup_count_; }
+
+  uint64_t GetLookupHits() const { return lookup_hits_; }
+
   size_t GetPinnedCount() const { return pinned_count_; }
 
  private:
@@ -248,6 +277,7 @@ struct ThreadState {
   SharedState* shared;
   HistogramImpl latency_ns_hist;
   uint64_t duration_us = 0;
+  uint64_t cpu_nanos = 0;
 
   ThreadState(uint32_t index, SharedState* _shared)
       : tid(index), rnd(FLAGS_seed + 1 + index), shared(_shared) {}
@@ -290,17 +320,26 @@ struct KeyGen {
   }
 };
 
-Cache::ObjectPtr createValue(Random64& rnd, MemoryAllocator* alloc) {
-  char* rv = AllocateBlock(FLAGS_value_bytes, alloc).release();
+// A value starts with its size, so that values of different sizes can be
+// saved to a secondary cache
+Cache::ObjectPtr createValue(Random64& rnd, MemoryAllocator* alloc,
+                             size_t size = FLAGS_value_bytes) {
+  size = std::max(size, sizeof(uint64_t));
+  char* rv = AllocateBlock(size, alloc).release();
+  EncodeFixed64(rv, size);
   // Fill with some filler data, and take some CPU time
-  for (uint32_t i = 0; i < FLAGS_value_bytes; i += 8) {
+  for (size_t i = sizeof(uint64_t); i + sizeof(uint64_t) <= size; i += 8) {
     EncodeFixed64(rv + i, rnd.Next());
   }
   return rv;
 }
 
+size_t ValueSize(Cache::ObjectPtr value) {
+  return static_cast<size_t>(DecodeFixed64(static_cast<char*>(value)));
+}
+
 // Callbacks for secondary cache
-size_t SizeFn(Cache::ObjectPtr /*obj*/) { return FLAGS_value_bytes; }
+size_t SizeFn(Cache::ObjectPtr obj) { return ValueSize(obj); }
 
 Status SaveToFn(Cache::ObjectPtr from_obj, size_t /*from_offset*/,
                 size_t length, char* out) {
@@ -332,8 +371,130 @@ Cache::CacheItemHelper helper3_wos(CacheEntryRole::kFilterBlock, DeleteFn);
 Cache::CacheItemHelper helper3(CacheEntryRole::kFilterBlock, DeleteFn, SizeFn,
                                SaveToFn, CreateFn, &helper3_wos);
 
-void ConfigureSecondaryCache(ShardedCacheOptions& opts) {
-  if (!FLAGS_secondary_cache_uri.empty()) {
+// A secondary cache keeping the saved entries in memory as a flash cache
+// would on flash, and taking flash_read_latency_us to look one up
+class SimulatedFlashCache : public SecondaryCache {
+ public:
+  explicit SimulatedFlashCache(size_t capacity)
+      : cache_(NewLRUCache(capacity, FLAGS_num_shard_bits,
+                           false /* strict_capacity_limit */,
+                           0.0 /* high_pri_pool_ratio */)) {}
+
+  const char* Name() const override { return "SimulatedFlashCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr obj,
+                const Cache::CacheItemHelper* helper,
+                bool /*force_insert*/) override {
+    if (!helper->IsSecondaryCacheCompatible()) {
+      return Status::OK();
+    }
+    std::string saved(helper->size_cb(obj), '\0');
+    Status s = helper->saveto_cb(obj, 0, saved.size(), &saved[0]);
+    if (!s.ok()) {
+      return s;
+    }
+    return InsertSaved(key, saved, kNoCompression, CacheTier::kVolatileTier);
+  }
+
+  Status InsertSaved(const Slice& key, const Slice& saved,
+                     CompressionType type = kNoCompression,
+                     CacheTier source = CacheTier::kVolatileTier) override {
+    auto entry = new Entry{saved.ToString(), type, source};
+    return cache_->Insert(key, entry, &kEntryHelper, saved.size());
+  }
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool /*wait*/,
+      bool /*advise_erase*/, Statistics* /*stats*/,
+      bool& kept_in_sec_cache) override {
+    kept_in_sec_cache = false;
+    Cache::Handle* handle = cache_->Lookup(key);
+    if (handle == nullptr) {
+      misses_.FetchAddRelaxed(1);
+      return nullptr;
+    }
+    hits_.FetchAddRelaxed(1);
+    if (FLAGS_flash_read_latency_us > 0) {
+      SystemClock::Default()->SleepForMicroseconds(
+          static_cast<int>(FLAGS_flash_read_latency_us));
+    }
+    auto entry = static_cast<Entry*>(cache_->Value(handle));
+    Cache::ObjectPtr value = nullptr;
+    size_t charge = 0;
+    Status s = helper->create_cb(entry->data, entry->type, entry->source,
+                                 create_context, /*allocator=*/nullptr, &value,
+                                 &charge);
+    cache_->Release(handle);
+    if (!s.ok()) {
+      return nullptr;
+    }
+    kept_in_sec_cache = true;
+    return std::make_unique<ResultHandle>(value, charge);
+  }
+
+  bool SupportForceErase() const override { return false; }
+
+  void Erase(const Slice& key) override { cache_->Erase(key); }
+
+  // The lookups are synchronous
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> /*handles*/) override {
+  }
+
+  Status GetCapacity(size_t& capacity) override {
+    capacity = cache_->GetCapacity();
+    return Status::OK();
+  }
+
+  size_t GetUsage() const { return cache_->GetUsage(); }
+  uint64_t GetHits() const { return hits_.LoadRelaxed(); }
+  uint64_t GetMisses() const { return misses_.LoadRelaxed(); }
+
+ private:
+  struct Entry {
+    std::string data;
+    CompressionType type;
+    CacheTier source;
+  };
+
+  class ResultHandle : public SecondaryCacheResultHandle {
+   public:
+    ResultHandle(Cache::ObjectPtr value, size_t size)
+        : value_(value), size_(size) {}
+    bool IsReady() override { return true; }
+    void Wait() override {}
+    Cache::ObjectPtr Value() override { return value_; }
+    size_t Size() override { return size_; }
+
+   private:
+    Cache::ObjectPtr value_;
+    size_t size_;
+  };
+
+  static void DeleteEntry(Cache::ObjectPtr obj, MemoryAllocator* /*alloc*/) {
+    delete static_cast<Entry*>(obj);
+  }
+  static const Cache::CacheItemHelper kEntryHelper;
+
+  std::shared_ptr<Cache> cache_;
+  RelaxedAtomic<uint64_t> hits_{0};
+  RelaxedAtomic<uint64_t> misses_{0};
+};
+
+const Cache::CacheItemHelper SimulatedFlashCache::kEntryHelper{
+    CacheEntryRole::kMisc, &SimulatedFlashCache::DeleteEntry};
+
+bool HasSecondaryCache() {
+  return !FLAGS_secondary_cache_uri.empty() ||
+         FLAGS_compressed_secondary_cache_size > 0 ||
+         FLAGS_flash_cache_size > 0;
+}
+
+void ConfigureSecondaryCache(ShardedCacheOptions& opts,
+                             std::shared_ptr<SecondaryCache> flash_cache) {
+  if (FLAGS_compressed_secondary_cache_size == 0 && flash_cache) {
+    opts.secondary_cache = flash_cache;
+  } else if (!FLAGS_secondary_cache_uri.empty()) {
     std::shared_ptr<SecondaryCache> secondary_cache;
     Status s = SecondaryCache::CreateFromString(
         ConfigOptions(), FLAGS_secondary_cache_uri, &secondary_cache);
@@ -347,8 +508,29 @@ void ConfigureSecondaryCache(ShardedCacheOptions& opts) {
   }
 }
 
+// Makes the cache of `opts`, under which NewTieredCache() puts a compressed
+// secondary cache and the flash cache, if any, when asked for
+template <class CacheOptions>
+std::shared_ptr<Cache> MakeCache(CacheOptions& opts, PrimaryCacheType type,
+                                 std::shared_ptr<SecondaryCache> flash_cache) {
+  if (FLAGS_compressed_secondary_cache_size > 0) {
+    TieredCacheOptions tiered_opts;
+    tiered_opts.cache_opts = &opts;
+    tiered_opts.cache_type = type;
+    tiered_opts.total_capacity =
+        FLAGS_cache_size + FLAGS_compressed_secondary_cache_size;
+    tiered_opts.compressed_secondary_ratio =
+        1.0 * FLAGS_compressed_secondary_cache_size /
+        tiered_opts.total_capacity;
+    tiered_opts.comp_cache_opts.num_shard_bits = FLAGS_num_shard_bits;
+    tiered_opts.nvm_sec_cache = flash_cache;
+    return NewTieredCache(tiered_opts);
+  }
+  return opts.MakeSharedCache();
+}
+
 ShardedCacheBase* AsShardedCache(Cache* c) {
-  if (!FLAGS_secondary_cache_uri.empty()) {
+  if (HasSecondaryCache()) {
     c = static_cast_with_check<CacheWrapper>(c)->GetTarget().get();
   }
   return static_cast_with_check<ShardedCacheBase>(c);
@@ -387,6 +569,13 @@ class CacheBench {
       Status s = NewJemallocNodumpAllocator(opts, &allocator);
       assert(s.ok());
     }
+    if (FLAGS_flash_cache_size > 0) {
+      flash_cache_ = std::make_shared<SimulatedFlashCache>(
+          static_cast<size_t>(FLAGS_flash_cache_size));
+    }
+    if (HasSecondaryCache()) {
+      statistics_ = CreateDBStatistics();
+    }
     if (FLAGS_cache_type == "clock_cache") {
       fprintf(stderr, "Old clock cache implementation has been removed.\n");
       exit(1);
@@ -396,6 +585,7 @@ class CacheBench {
       opts.hash_seed = BitwiseAnd(FLAGS_seed, INT32_MAX);
       opts.memory_allocator = allocator;
       opts.eviction_effort_cap = FLAGS_eviction_effort_cap;
+      opts.frequency_admission = FLAGS_frequency_admission;
       if (FLAGS_cache_type == "fixed_hyper_clock_cache" ||
           FLAGS_cache_type == "hyper_clock_cache") {
         opts.estimated_entry_charge = FLAGS_value_bytes_estimate > 0
@@ -409,20 +599,28 @@ class CacheBench {
         fprintf(stderr, "Cache type not supported.\n");
         exit(1);
       }
-      ConfigureSecondaryCache(opts);
-      cache_ = opts.MakeSharedCache();
+      ConfigureSecondaryCache(opts, flash_cache_);
+      cache_ = MakeCache(opts, PrimaryCacheType::kCacheTypeHCC, flash_cache_);
     } else if (FLAGS_cache_type == "lru_cache") {
       LRUCacheOptions opts(FLAGS_cache_size, FLAGS_num_shard_bits,
                            false /* strict_capacity_limit */,
                            0.5 /* high_pri_pool_ratio */);
       opts.hash_seed = BitwiseAnd(FLAGS_seed, INT32_MAX);
       opts.memory_allocator = allocator;
-      ConfigureSecondaryCache(opts);
-      cache_ = NewLRUCache(opts);
+      opts.lazy_promotion = FLAGS_lazy_promotion;
+      ConfigureSecondaryCache(opts, flash_cache_);
+      cache_ = MakeCache(opts, PrimaryCacheType::kCacheTypeLRU, flash_cache_);
     } else {
       fprintf(stderr, "Cache type not supported.\n");
       exit(1);
     }
+
+    if (!FLAGS_block_cache_trace.empty()) {
+      LoadTrace();
+      total_ops_ = trace_.size();
+    } else {
+      total_ops_ = uint64_t{FLAGS_threads} * FLAGS_ops_per_thread;
+    }
   }
 
   ~CacheBench() {}
@@ -517,21 +715,27 @@ class CacheBench {
     // Wall clock time - includes idle time if threads
     // finish at different times (not ideal).
     double elapsed_secs = static_cast<double>(end_time - start_time) * 1e-6;
-    uint32_t ops_per_sec = static_cast<uint32_t>(
-        1.0 * FLAGS_threads * FLAGS_ops_per_thread / elapsed_secs);
+    uint32_t ops_per_sec =
+        static_cast<uint32_t>(1.0 * total_ops_ / elapsed_secs);
     printf("Complete in %.3f s; Rough parallel ops/sec = %u\n", elapsed_secs,
            ops_per_sec);
 
     // Total time in each thread (more accurate throughput measure)
     elapsed_secs = 0;
+    uint64_t cpu_nanos = 0;
     for (uint32_t i = 0; i < FLAGS_threads; i++) {
       elapsed_secs += threads[i]->duration_us * 1e-6;
+      cpu_nanos += threads[i]->cpu_nanos;
     }
-    ops_per_sec = static_cast<uint32_t>(1.0 * FLAGS_threads *
-                                        FLAGS_ops_per_thread / elapsed_secs);
+    ops_per_sec = static_cast<uint32_t>(1.0 * total_ops_ / elapsed_secs);
     printf("Thread ops/sec = %u\n", ops_per_sec);
+    // Excludes the simulated flash latency, spent sleeping
+    printf("Thread CPU per op: %.1f ns\n", 1.0 * cpu_nanos / total_ops_);
 
     printf("Lookup hit ratio: %g\n", shared.GetLookupHitRatio());
+    if (HasSecondaryCache()) {
+      PrintTierStats(shared.GetLookupCount(), shared.GetLookupHits());
+    }
 
     size_t occ = cache_->GetOccupancyCount();
     size_t slot = cache_->GetTableAddressCount();
@@ -565,7 +769,92 @@ class CacheBench {
   }
 
  private:
+  // A lookup of a block cache trace
+  struct TraceAccess {
+    // The hash of the block key, as cache keys have a fixed size
+    char key[kCacheKeySize];
+    uint32_t charge;
+    TraceType block_type;
+    bool no_insert;
+  };
+
+  void LoadTrace() {
+    std::unique_ptr<TraceReader> trace_reader;
+    Status s = NewFileTraceReader(Env::Default(), EnvOptions(),
+                                  FLAGS_block_cache_trace, &trace_reader);
+    BlockCacheTraceHeader header;
+    std::unique_ptr<BlockCacheTraceReader> reader;
+    if (s.ok()) {
+      reader.reset(new BlockCacheTraceReader(std::move(trace_reader)));
+      s = reader->ReadHeader(&header);
+    }
+    if (!s.ok()) {
+      fprintf(stderr, "Cannot read block cache trace %s: %s\n",
+              FLAGS_block_cache_trace.c_str(), s.ToString().c_str());
+      exit(1);
+    }
+    for (;;) {
+      BlockCacheTraceRecord record;
+      if (!reader->ReadAccess(&record).ok()) {
+        break;
+      }
+      TraceAccess access;
+      uint64_t hi, lo;
+      Hash2x64(record.block_key.data(), record.block_key.size(), &hi, &lo);
+      EncodeFixed64(access.key, lo);
+      EncodeFixed64(access.key + 8, hi);
+      access.charge = static_cast<uint32_t>(
+          std::min<uint64_t>(record.block_size, UINT32_MAX));
+      access.block_type = record.block_type;
+      access.no_insert = record.no_insert;
+      trace_.push_back(access);
+    }
+    if (trace_.empty()) {
+      fprintf(stderr, "Block cache trace %s has no lookups\n",
+              FLAGS_block_cache_trace.c_str());
+      exit(1);
+    }
+  }
+
+  // The hits of the lookups in each tier, and the memory of each tier
+  void PrintTierStats(uint64_t lookups, uint64_t hits) const {
+    const uint64_t secondary_hits =
+        statistics_->getTickerCount(SECONDARY_CACHE_HITS);
+    const uint64_t compressed_hits =
+        statistics_->getTickerCount(COMPRESSED_SECONDARY_CACHE_HITS);
+    const uint64_t flash_hits = flash_cache_ ? flash_cache_->GetHits() : 0;
+    // The hits of the whole cache, less those served by the secondary tiers
+    const uint64_t primary_hits = hits - std::min(hits, secondary_hits);
+    printf("Primary tier hit ratio: %g\n", 1.0 * primary_hits / lookups);
+    printf("Secondary tiers hit ratio: %g\n", 1.0 * secondary_hits / lookups);
+    if (FLAGS_compressed_secondary_cache_size > 0) {
+      printf("Compressed tier hit ratio: %g\n",
+             1.0 * compressed_hits / lookups);
+    }
+    if (flash_cache_) {
+      printf("Flash tier hit ratio: %g\n", 1.0 * flash_hits / lookups);
+    }
+    printf("Primary tier usage: %s\n",
+           BytesToHumanString(AsShardedCache(cache_.get())->GetUsage())
+               .c_str());
+    size_t secondary_capacity = 0;
+    if (FLAGS_compressed_secondary_cache_size > 0 &&
+        cache_->GetSecondaryCacheCapacity(secondary_capacity).ok()) {
+      // Reserved in the primary tier, so part of its usage
+      printf("Compressed tier capacity: %s\n",
+             BytesToHumanString(secondary_capacity).c_str());
+    }
+    if (flash_cache_) {
+      printf("Flash tier usage: %s\n",
+             BytesToHumanString(flash_cache_->GetUsage()).c_str());
+    }
+  }
+
   std::shared_ptr<Cache> cache_;
+  std::shared_ptr<SimulatedFlashCache> flash_cache_;
+  std::shared_ptr<Statistics> statistics_;
+  std::vector<TraceAccess> trace_;
+  uint64_t total_ops_ = 0;
   const uint64_t max_key_;
   // Cumulative thresholds in the space of a random uint64_t
   const uint64_t lookup_insert_threshold_;
@@ -669,7 +958,11 @@ class CacheBench {
         shared->GetCondVar()->Wait();
       }
     }
-    thread->shared->GetCacheBench()->OperateCache(thread);
+    if (FLAGS_block_cache_trace.empty()) {
+      thread->shared->GetCacheBench()->OperateCache(thread);
+    } else {
+      thread->shared->GetCacheBench()->ReplayTrace(thread);
+    }
 
     {
       MutexLock l(shared->GetMutex());
@@ -695,6 +988,7 @@ class CacheBench {
     KeyGen gen;
     const auto clock = SystemClock::Default().get();
     uint64_t start_time = clock->NowMicros();
+    uint64_t start_cpu_nanos = clock->CPUNanos();
     StopWatchNano timer(clock);
     auto system_clock = SystemClock::Default();
     size_t steps_to_next_capacity_change = 0;
@@ -723,7 +1017,7 @@ class CacheBench {
       if (random_op < lookup_insert_threshold_) {
         // do lookup
         auto handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
-                                     Cache::Priority::LOW);
+                                     Cache::Priority::LOW, statistics_.get());
         if (handle) {
           ++lookup_hits;
           if (!FLAGS_lean) {
@@ -755,7 +1049,7 @@ class CacheBench {
       } else if (random_op < lookup_threshold_) {
         // do lookup
         auto handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
-                                     Cache::Priority::LOW);
+                                     Cache::Priority::LOW, statistics_.get());
         if (handle) {
           ++lookup_hits;
           if (!FLAGS_lean) {
@@ -804,6 +1098,69 @@ class CacheBench {
       exit(1);
     }
     thread->duration_us = clock->NowMicros() - start_time;
+    thread->cpu_nanos = clock->CPUNanos() - start_cpu_nanos;
+  }
+
+  // Looks up the blocks of every FLAGS_threads-th lookup of the trace,
+  // inserting the missed ones as the table reader would
+  void ReplayTrace(ThreadState* thread) {
+    uint64_t result = 0;
+    uint64_t lookup_misses = 0;
+    uint64_t lookup_hits = 0;
+    const auto clock = SystemClock::Default().get();
+    uint64_t start_time = clock->NowMicros();
+    uint64_t start_cpu_nanos = clock->CPUNanos();
+    StopWatchNano timer(clock);
+
+    for (size_t i = thread->tid; i < trace_.size(); i += FLAGS_threads) {
+      const TraceAccess& access = trace_[i];
+      const Slice key(access.key, kCacheKeySize);
+      const Cache::CacheItemHelper* helper = &helper1;
+      Cache::Priority priority = Cache::Priority::LOW;
+      if (access.block_type == TraceType::kBlockTraceIndexBlock) {
+        helper = &helper2;
+        priority = Cache::Priority::HIGH;
+      } else if (access.block_type == TraceType::kBlockTraceFilterBlock) {
+        helper = &helper3;
+        priority = Cache::Priority::HIGH;
+      }
+
+      if (FLAGS_histograms) {
+        timer.Start();
+      }
+      auto handle = cache_->Lookup(key, helper, /*context*/ nullptr, priority,
+                                   statistics_.get());
+      if (handle) {
+        ++lookup_hits;
+        if (!FLAGS_lean) {
+          // do something with the data
+          Cache::ObjectPtr value = cache_->Value(handle);
+          result += NPHash64(static_cast<char*>(value), ValueSize(value));
+        }
+        cache_->Release(handle);
+      } else {
+        ++lookup_misses;
+        if (!access.no_insert) {
+          Status s = cache_->Insert(
+              key,
+              createValue(thread->rnd, cache_->memory_allocator(),
+                          access.charge),
+              helper, access.charge, /*handle=*/nullptr, priority);
+          assert(s.ok());
+        }
+      }
+      if (FLAGS_histograms) {
+        thread->latency_ns_hist.Add(timer.ElapsedNanos());
+      }
+    }
+    thread->shared->AddLookupStats(lookup_hits, lookup_misses, 0);
+    // Ensure computations on `result` are not optimized away.
+    if (result == 1) {
+      printf("You are extremely unlucky(2). Try again.\n");
+      exit(1);
+    }
+    thread->duration_us = clock->NowMicros() - start_time;
+    thread->cpu_nanos = clock->CPUNanos() - start_cpu_nanos;
   }
 
   void PrintEnv() const {
@@ -817,9 +1174,23 @@ class CacheBench {
     printf("----------------------------\n");
     printf("RocksDB version     : %d.%d\n", kMajorVersion, kMinorVersion);
     printf("Cache impl name     : %s\n", cache_->Name());
+    if (FLAGS_compressed_secondary_cache_size > 0) {
+      printf("Compressed tier     : %s\n",
+             BytesToHumanString(FLAGS_compressed_secondary_cache_size).c_str());
+    }
+    if (flash_cache_) {
+      printf("Flash tier          : %s, %u us per hit\n",
+             BytesToHumanString(FLAGS_flash_cache_size).c_str(),
+             FLAGS_flash_read_latency_us);
+    }
     printf("DMutex impl name    : %s\n", DMutex::kName());
     printf("Number of threads   : %u\n", FLAGS_threads);
-    printf("Ops per thread      : %" PRIu64 "\n", FLAGS_ops_per_thread);
+    if (!trace_.empty()) {
+      printf("Block cache trace   : %s (%zu lookups)\n",
+             FLAGS_block_cache_trace.c_str(), trace_.size());
+    } else {
+      printf("Ops per thread      : %" PRIu64 "\n", FLAGS_ops_per_thread);
+    }
     printf("Cache size          : %s\n",
            BytesToHumanString(FLAGS_cache_size).c_str());
     printf("Num shard bits      : %d\n",
@@ -1157,13 +1528,22 @@ int cache_bench_tool(int argc, char** argv) {
     exit(1);
   }
 
+  if (!FLAGS_secondary_cache_uri.empty() &&
+      (FLAGS_compressed_secondary_cache_size > 0 ||
+       FLAGS_flash_cache_size > 0)) {
+    fprintf(stderr,
+            "secondary_cache_uri cannot be used with the simulated tiers\n");
+    exit(1);
+  }
+
   if (FLAGS_seed == 0) {
     FLAGS_seed = static_cast<uint32_t>(port::GetProcessID());
     printf("Using seed = %" PRIu32 "\n", FLAGS_seed);
   }
 
   ROCKSDB_NAMESPACE::CacheBench bench;
-  if (FLAGS_populate_cache) {
+  // The generated keys would not be looked up by a trace
+  if (FLAGS_populate_cache && FLAGS_block_cache_trace.empty()) {
     bench.PopulateCache();
   }
   if (bench.Run()) {
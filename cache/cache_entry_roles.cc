@@ -72,6 +72,11 @@ const std::string& BlockCacheEntryStatsMapKeys::LastCollectionAgeSeconds() {
   return kLastCollectionAgeSeconds;
 }
 
+const std::string& BlockCacheEntryStatsMapKeys::FarMemoryBytes() {
+  static const std::string kFarMemoryBytes = "far-memory-bytes";
+  return kFarMemoryBytes;
+}
+
 namespace {
 
 std::string GetPrefixedCacheEntryRoleName(const std::string& prefix,
@@ -364,6 +364,36 @@ TEST_P(CacheTest, HitAndMiss) {
   }
 }
 
+TEST_P(CacheTest, StartAsyncLookupBatch) {
+  for (int i = 0; i < 80; i += 2) {
+    Insert(i, i + 1000);
+  }
+  // More keys than ShardedCache handles at once, over several shards
+  constexpr int kCount = 70;
+  std::vector<std::string> keys;
+  for (int i = 0; i < kCount; ++i) {
+    keys.push_back(EncodeKey(i));
+  }
+  std::unique_ptr<Cache::AsyncLookupHandle[]> async_handles(
+      new Cache::AsyncLookupHandle[kCount]);
+  for (int i = 0; i < kCount; ++i) {
+    async_handles[i].key = keys[i];
+  }
+  cache_->StartAsyncLookupBatch(async_handles.get(), kCount);
+  cache_->WaitAll(async_handles.get(), kCount);
+  for (int i = 0; i < kCount; ++i) {
+    Cache::Handle* h = async_handles[i].Result();
+    if (i % 2 == 0) {
+      ASSERT_NE(h, nullptr);
+      ASSERT_EQ(i + 1000, DecodeValue(cache_->Value(h)));
+      cache_->Release(h);
+    } else {
+      ASSERT_EQ(h, nullptr);
+    }
+  }
+  ASSERT_EQ(0U, cache_->GetPinnedUsage());
+}
+
 TEST_P(CacheTest, InsertSameKey) {
   if (IsHyperClock()) {
     ROCKSDB_GTEST_BYPASS(
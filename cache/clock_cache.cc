@@ -375,6 +375,64 @@ uint32_t SanitizeEncodeEecAndScl(int eviction_effort_cap,
 
 }  // namespace
 
+FrequencySketch::FrequencySketch(size_t num_entries)
+    : length_mask_(
+          (size_t{1} << FloorLog2((std::max(num_entries, size_t{64}) << 1) -
+                                  1)) -
+          1),
+      words_(new RelaxedAtomic<uint64_t>[length_mask_ + 1]),
+      sample_size_(std::max(num_entries, size_t{1})) {}
+
+inline void FrequencySketch::Locate(const UniqueId64x2& hashed_key,
+                                    size_t* index,
+                                    std::array<int, 4>* shifts) const {
+  *index = static_cast<size_t>(hashed_key[1] >> 32) & length_mask_;
+  for (int i = 0; i < 4; ++i) {
+    // Row i picks one of counters 4*i .. 4*i+3 in the word
+    int counter = i * 4 + static_cast<int>((hashed_key[0] >> (i * 2)) & 3);
+    (*shifts)[i] = counter * 4;
+  }
+}
+
+void FrequencySketch::Increment(const UniqueId64x2& hashed_key) {
+  size_t index;
+  std::array<int, 4> shifts;
+  Locate(hashed_key, &index, &shifts);
+  uint64_t word = words_[index].LoadRelaxed();
+  uint64_t new_word = word;
+  for (int shift : shifts) {
+    if (((word >> shift) & 15) < 15) {
+      new_word += uint64_t{1} << shift;
+    }
+  }
+  if (new_word != word) {
+    words_[index].StoreRelaxed(new_word);
+  }
+  if (increments_.FetchAddRelaxed(1) + 1 >= sample_size_) {
+    increments_.StoreRelaxed(0);
+    Halve();
+  }
+}
+
+uint32_t FrequencySketch::Estimate(const UniqueId64x2& hashed_key) const {
+  size_t index;
+  std::array<int, 4> shifts;
+  Locate(hashed_key, &index, &shifts);
+  uint64_t word = words_[index].LoadRelaxed();
+  uint32_t estimate = 15;
+  for (int shift : shifts) {
+    estimate = std::min(estimate, static_cast<uint32_t>((word >> shift) & 15));
+  }
+  return estimate;
+}
+
+void FrequencySketch::Halve() {
+  for (size_t i = 0; i <= length_mask_; ++i) {
+    words_[i].StoreRelaxed((words_[i].LoadRelaxed() >> 1) &
+                           uint64_t{0x7777777777777777});
+  }
+}
+
 void ClockHandleBasicData::FreeData(MemoryAllocator* allocator) const {
   if (helper->del_cb) {
     helper->del_cb(value, allocator);
@@ -578,6 +636,24 @@ bool IsEvictionEffortExceeded(const BaseClockTable::EvictionData& data,
          data.seen_pinned_count;
 }
 
+bool BaseClockTable::RejectAdmission(const ClockHandleBasicData& proto,
+                                     Cache::Priority priority,
+                                     size_t capacity) {
+  if (priority == Cache::Priority::HIGH ||
+      usage_.LoadRelaxed() + proto.GetTotalCharge() <= capacity) {
+    // Not competing with existing entries
+    return false;
+  }
+  // The Lookup miss just before a typical insertion counts once, so this
+  // asks for an earlier miss too.
+  if (frequency_sketch_->Estimate(proto.hashed_key) < 2) {
+    admission_rejected_count_.FetchAddRelaxed(1);
+    return true;
+  }
+  admitted_count_.FetchAddRelaxed(1);
+  return false;
+}
+
 template <class Table>
 Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
                               typename Table::HandleImpl** handle,
@@ -586,6 +662,19 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
   using HandleImpl = typename Table::HandleImpl;
   Table& derived = static_cast<Table&>(*this);
 
+  if (frequency_sketch_ && !(eec_and_scl & kStrictCapacityLimitBit) &&
+      RejectAdmission(proto, priority, capacity)) {
+    if (handle == nullptr) {
+      // As if inserted and evicted immediately
+      proto.FreeData(allocator_);
+      return Status::OK();
+    }
+    // Like other insertions that do not go into the table
+    usage_.FetchAddRelaxed(proto.GetTotalCharge());
+    *handle = StandaloneInsert<HandleImpl>(proto);
+    return Status::OkOverwritten();
+  }
+
   typename Table::InsertState state;
   derived.StartInsert(state);
 
@@ -734,6 +823,9 @@ FixedHyperClockTable::FixedHyperClockTable(
       CacheMetadataChargePolicy::kFullChargeCacheMetadata) {
     usage_.FetchAddRelaxed(size_t{GetTableSize()} * sizeof(HandleImpl));
   }
+  if (opts.frequency_admission) {
+    InitFrequencySketch(GetTableSize());
+  }
 
   static_assert(sizeof(HandleImpl) == 64U,
                 "Expecting size / alignment with common cache line size");
@@ -828,6 +920,11 @@ FixedHyperClockTable::HandleImpl* FixedHyperClockTable::DoInsert(
   return nullptr;
 }
 
+void FixedHyperClockTable::Prefetch(const UniqueId64x2& hashed_key) {
+  // See FindSlot()
+  PREFETCH(&array_[ModTableSize(hashed_key[1])], 0 /* rw */, 3 /* locality */);
+}
+
 FixedHyperClockTable::HandleImpl* FixedHyperClockTable::Lookup(
     const UniqueId64x2& hashed_key) {
   HandleImpl* e = FindSlot(
@@ -1299,7 +1396,23 @@ typename ClockCacheShard<Table>::HandleImpl* ClockCacheShard<Table>::Lookup(
   if (UNLIKELY(key.size() != kCacheKeySize)) {
     return nullptr;
   }
-  return table_.Lookup(hashed_key);
+  HandleImpl* h = table_.Lookup(hashed_key);
+  if (h == nullptr) {
+    table_.TrackMiss(hashed_key);
+  }
+  return h;
+}
+
+template <class Table>
+void ClockCacheShard<Table>::LookupBatch(const Slice* keys,
+                                         const UniqueId64x2* hashed_keys,
+                                         size_t count, HandleImpl** handles) {
+  for (size_t i = 0; i < count; ++i) {
+    table_.Prefetch(hashed_keys[i]);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    handles[i] = Lookup(keys[i], hashed_keys[i]);
+  }
 }
 
 template <class Table>
@@ -1543,6 +1656,8 @@ void BaseHyperClockCache<Table>::ReportProblems(
   if (info_log->GetInfoLogLevel() <= InfoLogLevel::DEBUG_LEVEL) {
     LoadVarianceStats slot_stats;
     uint64_t eviction_effort_exceeded_count = 0;
+    uint64_t admitted_count = 0;
+    uint64_t admission_rejected_count = 0;
     this->ForEachShard([&](const BaseHyperClockCache<Table>::Shard* shard) {
       size_t count = shard->GetTableAddressCount();
       for (size_t i = 0; i < count; ++i) {
@@ -1550,12 +1665,21 @@ void BaseHyperClockCache<Table>::ReportProblems(
       }
       eviction_effort_exceeded_count +=
           shard->GetTable().GetEvictionEffortExceededCount();
+      admitted_count += shard->GetTable().GetAdmittedCount();
+      admission_rejected_count +=
+          shard->GetTable().GetAdmissionRejectedCount();
     });
     ROCKS_LOG_AT_LEVEL(info_log, InfoLogLevel::DEBUG_LEVEL,
                        "Slot occupancy stats: %s", slot_stats.Report().c_str());
     ROCKS_LOG_AT_LEVEL(info_log, InfoLogLevel::DEBUG_LEVEL,
                        "Eviction effort exceeded: %" PRIu64,
                        eviction_effort_exceeded_count);
+    if (admitted_count + admission_rejected_count > 0) {
+      ROCKS_LOG_AT_LEVEL(info_log, InfoLogLevel::DEBUG_LEVEL,
+                         "Frequency admission admitted/rejected: %" PRIu64
+                         "/%" PRIu64,
+                         admitted_count, admission_rejected_count);
+    }
   }
 }
 
@@ -1974,6 +2098,11 @@ AutoHyperClockTable::AutoHyperClockTable(
     // NOTE: ignoring page boundaries for simplicity
     usage_.FetchAddRelaxed(size_t{GetTableSize()} * sizeof(HandleImpl));
   }
+  if (opts.frequency_admission) {
+    // Sized for the table at its largest
+    InitFrequencySketch(CalcMaxUsableLength(
+        capacity, opts.min_avg_value_size, metadata_charge_policy));
+  }
 
   static_assert(sizeof(HandleImpl) == 64U,
                 "Expecting size / alignment with common cache line size");
@@ -3072,6 +3201,15 @@ AutoHyperClockTable::HandleImpl* AutoHyperClockTable::DoInsert(
   }
 }
 
+void AutoHyperClockTable::Prefetch(const UniqueId64x2& hashed_key) {
+  // See Lookup()
+  size_t home;
+  int home_shift;
+  GetHomeIndexAndShift(length_info_.LoadRelaxed(), hashed_key[1], &home,
+                       &home_shift);
+  PREFETCH(&array_.Get()[home], 0 /* rw */, 3 /* locality */);
+}
+
 AutoHyperClockTable::HandleImpl* AutoHyperClockTable::Lookup(
     const UniqueId64x2& hashed_key) {
   // Lookups are wait-free with low occurrence of retries, back-tracking,
@@ -373,14 +373,45 @@ struct ClockHandle : public ClockHandleBasicData {
   mutable AcqRelAtomic<uint64_t> meta{};
 };  // struct ClockHandle
 
+// Estimates how often keys recently missed in a cache shard, for
+// HyperClockCacheOptions::frequency_admission. A count-min sketch with four
+// 4-bit counters per key, all in one 64-bit word. There is one word per
+// expected entry, and all counters are halved after as many increments, which
+// keeps the estimate of a key seen once from being inflated by collisions.
+// Updates are racy by design: losing an occasional increment only makes an
+// estimate slightly low.
+class FrequencySketch {
+ public:
+  explicit FrequencySketch(size_t num_entries);
+
+  void Increment(const UniqueId64x2& hashed_key);
+
+  uint32_t Estimate(const UniqueId64x2& hashed_key) const;
+
+ private:
+  // Counter positions of `hashed_key` in the word at *index, one for each row
+  inline void Locate(const UniqueId64x2& hashed_key, size_t* index,
+                     std::array<int, 4>* shifts) const;
+  void Halve();
+
+  const size_t length_mask_;
+  std::unique_ptr<RelaxedAtomic<uint64_t>[]> words_;
+  // Number of increments between halvings
+  const size_t sample_size_;
+  RelaxedAtomic<size_t> increments_{};
+};
+
 class BaseClockTable {
  public:
   struct BaseOpts {
-    explicit BaseOpts(int _eviction_effort_cap)
-        : eviction_effort_cap(_eviction_effort_cap) {}
+    explicit BaseOpts(int _eviction_effort_cap,
+                      bool _frequency_admission = false)
+        : eviction_effort_cap(_eviction_effort_cap),
+          frequency_admission(_frequency_admission) {}
     explicit BaseOpts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {}
+        : BaseOpts(opts.eviction_effort_cap, opts.frequency_admission) {}
     int eviction_effort_cap;
+    bool frequency_admission;
   };
 
   BaseClockTable(CacheMetadataChargePolicy metadata_charge_policy,
@@ -419,6 +450,19 @@ class BaseClockTable {
     return eviction_effort_exceeded_count_.LoadRelaxed();
   }
 
+  uint64_t GetAdmittedCount() const { return admitted_count_.LoadRelaxed(); }
+
+  uint64_t GetAdmissionRejectedCount() const {
+    return admission_rejected_count_.LoadRelaxed();
+  }
+
+  // Feeds a Lookup miss to the frequency sketch, if any
+  void TrackMiss(const UniqueId64x2& hashed_key) {
+    if (frequency_sketch_) {
+      frequency_sketch_->Increment(hashed_key);
+    }
+  }
+
   struct EvictionData {
     size_t freed_charge = 0;
     size_t freed_count = 0;
@@ -467,6 +511,17 @@ class BaseClockTable {
                                       uint32_t eviction_effort_cap,
                                       typename Table::InsertState& state);
 
+  // With frequency_admission, whether an entry that would need evictions to
+  // fit should rather not be inserted into the table.
+  bool RejectAdmission(const ClockHandleBasicData& proto,
+                       Cache::Priority priority, size_t capacity);
+
+ protected:  // fns
+  // For frequency_admission, sized for about `num_entries` entries
+  void InitFrequencySketch(size_t num_entries) {
+    frequency_sketch_.reset(new FrequencySketch(num_entries));
+  }
+
  protected:  // data
   // We partition the following members into different cache lines
   // to avoid false sharing among Lookup, Release, Erase and Insert
@@ -486,6 +541,14 @@ class BaseClockTable {
   // (Relaxed: a simple stat counter.)
   RelaxedAtomic<uint64_t> eviction_effort_exceeded_count_{};
 
+  // Counters for insertions checked against the frequency sketch.
+  // (Relaxed: simple stat counters.)
+  RelaxedAtomic<uint64_t> admitted_count_{};
+  RelaxedAtomic<uint64_t> admission_rejected_count_{};
+
+  // For frequency_admission, otherwise nullptr
+  std::unique_ptr<FrequencySketch> frequency_sketch_;
+
   // TODO: is this separation needed if we don't do background evictions?
   ALIGN_AS(CACHE_LINE_SIZE)
   // Number of elements in the table.
@@ -540,11 +603,11 @@ class FixedHyperClockTable : public BaseClockTable {
   };  // struct HandleImpl
 
   struct Opts : public BaseOpts {
-    explicit Opts(size_t _estimated_value_size, int _eviction_effort_cap)
-        : BaseOpts(_eviction_effort_cap),
+    explicit Opts(size_t _estimated_value_size, int _eviction_effort_cap,
+                  bool _frequency_admission = false)
+        : BaseOpts(_eviction_effort_cap, _frequency_admission),
           estimated_value_size(_estimated_value_size) {}
-    explicit Opts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {
+    explicit Opts(const HyperClockCacheOptions& opts) : BaseOpts(opts) {
       assert(opts.estimated_entry_charge > 0);
       estimated_value_size = opts.estimated_entry_charge;
     }
@@ -578,6 +641,9 @@ class FixedHyperClockTable : public BaseClockTable {
 
   HandleImpl* Lookup(const UniqueId64x2& hashed_key);
 
+  // Brings the first slot Lookup() probes into the CPU cache
+  void Prefetch(const UniqueId64x2& hashed_key);
+
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref);
 
   void Erase(const UniqueId64x2& hashed_key);
@@ -829,12 +895,12 @@ class AutoHyperClockTable : public BaseClockTable {
   };  // struct HandleImpl
 
   struct Opts : public BaseOpts {
-    explicit Opts(size_t _min_avg_value_size, int _eviction_effort_cap)
-        : BaseOpts(_eviction_effort_cap),
+    explicit Opts(size_t _min_avg_value_size, int _eviction_effort_cap,
+                  bool _frequency_admission = false)
+        : BaseOpts(_eviction_effort_cap, _frequency_admission),
           min_avg_value_size(_min_avg_value_size) {}
 
-    explicit Opts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {
+    explicit Opts(const HyperClockCacheOptions& opts) : BaseOpts(opts) {
       assert(opts.estimated_entry_charge == 0);
       min_avg_value_size = opts.min_avg_entry_charge;
     }
@@ -873,6 +939,9 @@ class AutoHyperClockTable : public BaseClockTable {
 
   HandleImpl* Lookup(const UniqueId64x2& hashed_key);
 
+  // Brings the first slot Lookup() probes into the CPU cache
+  void Prefetch(const UniqueId64x2& hashed_key);
+
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref);
 
   void Erase(const UniqueId64x2& hashed_key);
@@ -1049,6 +1118,11 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
 
   HandleImpl* Lookup(const Slice& key, const UniqueId64x2& hashed_key);
 
+  // Lookup() of `count` keys of this shard, with the first probe of each
+  // prefetched before any is made
+  void LookupBatch(const Slice* keys, const UniqueId64x2* hashed_keys,
+                   size_t count, HandleImpl** handles);
+
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref);
 
   bool Release(HandleImpl* handle, bool erase_if_last_ref = false);
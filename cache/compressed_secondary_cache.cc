@@ -61,6 +61,7 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   const char* data_ptr = nullptr;
   CacheTier source = CacheTier::kVolatileCompressedTier;
   CompressionType type = cache_options_.compression_type;
+  uint32_t uses_dict = 0;
   if (cache_options_.enable_custom_split_merge) {
     CacheValueChunk* value_chunk_ptr =
         reinterpret_cast<CacheValueChunk*>(handle_value);
@@ -79,6 +80,7 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     data_ptr = GetVarint32Ptr(data_ptr, data_ptr + 1,
                               static_cast<uint32_t*>(&source_32));
     source = static_cast<CacheTier>(source_32);
+    data_ptr = GetVarint32Ptr(data_ptr, data_ptr + 1, &uses_dict);
     handle_value_charge -= (data_ptr - ptr->get());
   }
   MemoryAllocator* allocator = cache_options_.memory_allocator.get();
@@ -95,8 +97,11 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     } else {
       UncompressionContext uncompression_context(
           cache_options_.compression_type);
-      UncompressionInfo uncompression_info(uncompression_context,
-                                           UncompressionDict::GetEmptyDict(),
+      // Set before any value compressed with it was inserted
+      const UncompressionDict& dict = uses_dict
+                                          ? *uncompression_dict_
+                                          : UncompressionDict::GetEmptyDict();
+      UncompressionInfo uncompression_info(uncompression_context, dict,
                                            cache_options_.compression_type);
 
       size_t uncompressed_size{0};
@@ -158,6 +163,55 @@ bool CompressedSecondaryCache::MaybeInsertDummy(const Slice& key) {
   return false;
 }
 
+void CompressedSecondaryCache::SampleForDict(const Slice& value) {
+  const size_t sample_bytes = cache_options_.zstd_max_train_bytes > 0
+                                  ? cache_options_.zstd_max_train_bytes
+                                  : cache_options_.max_dict_bytes;
+  std::string samples;
+  std::vector<size_t> sample_lens;
+  {
+    MutexLock l(&dict_mutex_);
+    if (dict_sampling_done_) {
+      return;
+    }
+    size_t copy_len =
+        std::min(sample_bytes - dict_samples_.size(), value.size());
+    dict_samples_.append(value.data(), copy_len);
+    dict_sample_lens_.push_back(copy_len);
+    if (dict_samples_.size() < sample_bytes) {
+      return;
+    }
+    dict_sampling_done_ = true;
+    samples.swap(dict_samples_);
+    sample_lens.swap(dict_sample_lens_);
+  }
+
+  // Built outside of the mutex, as training can take a while
+  std::string dict;
+  if (cache_options_.zstd_max_train_bytes > 0 &&
+      (cache_options_.compression_type == kZSTD ||
+       cache_options_.compression_type == kZSTDNotFinalCompression) &&
+      ZSTD_TrainDictionarySupported()) {
+    dict = ZSTD_TrainDictionary(samples, sample_lens,
+                                cache_options_.max_dict_bytes);
+  } else {
+    samples.resize(std::min(samples.size(),
+                            size_t{cache_options_.max_dict_bytes}));
+    dict = std::move(samples);
+  }
+  if (dict.empty()) {
+    // Keep compressing without a dictionary
+    return;
+  }
+
+  compression_dict_.reset(new CompressionDict(
+      dict, cache_options_.compression_type, CompressionOptions().level));
+  uncompression_dict_.reset(new UncompressionDict(
+      dict, cache_options_.compression_type == kZSTD ||
+                cache_options_.compression_type == kZSTDNotFinalCompression));
+  dict_ready_.store(true, std::memory_order_release);
+}
+
 Status CompressedSecondaryCache::InsertInternal(
     const Slice& key, Cache::ObjectPtr value,
     const Cache::CacheItemHelper* helper, CompressionType type,
@@ -169,10 +223,17 @@ Status CompressedSecondaryCache::InsertInternal(
   }
 
   auto internal_helper = GetHelper(cache_options_.enable_custom_split_merge);
-  char header[10];
+  bool compress = cache_options_.compression_type != kNoCompression &&
+                  type == kNoCompression &&
+                  !cache_options_.do_not_compress_roles.Contains(helper->role);
+  bool use_dict = compress && cache_options_.max_dict_bytes > 0 &&
+                  !cache_options_.enable_custom_split_merge &&
+                  dict_ready_.load(std::memory_order_acquire);
+  char header[15];
   char* payload = header;
   payload = EncodeVarint32(payload, static_cast<uint32_t>(type));
   payload = EncodeVarint32(payload, static_cast<uint32_t>(source));
+  payload = EncodeVarint32(payload, use_dict ? 1 : 0);
 
   size_t header_size = payload - header;
   size_t data_size = (*helper->size_cb)(value);
@@ -188,16 +249,19 @@ Status CompressedSecondaryCache::InsertInternal(
   Slice val(data_ptr, data_size);
 
   std::string compressed_val;
-  if (cache_options_.compression_type != kNoCompression &&
-      type == kNoCompression &&
-      !cache_options_.do_not_compress_roles.Contains(helper->role)) {
+  if (compress) {
     PERF_COUNTER_ADD(compressed_sec_cache_uncompressed_bytes, data_size);
+    if (cache_options_.max_dict_bytes > 0 &&
+        !cache_options_.enable_custom_split_merge && !use_dict) {
+      SampleForDict(val);
+    }
     CompressionOptions compression_opts;
     CompressionContext compression_context(cache_options_.compression_type,
                                            compression_opts);
     uint64_t sample_for_compression{0};
     CompressionInfo compression_info(
-        compression_opts, compression_context, CompressionDict::GetEmptyDict(),
+        compression_opts, compression_context,
+        use_dict ? *compression_dict_ : CompressionDict::GetEmptyDict(),
         cache_options_.compression_type, sample_for_compression);
 
     bool success =
@@ -294,6 +358,12 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    max_dict_bytes : %u\n",
+           cache_options_.max_dict_bytes);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    zstd_max_train_bytes : %u\n",
+           cache_options_.zstd_max_train_bytes);
+  ret.append(buffer);
   return ret;
 }
 
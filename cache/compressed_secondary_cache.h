@@ -6,8 +6,11 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "cache/cache_reservation_manager.h"
 #include "cache/lru_cache.h"
@@ -135,6 +138,11 @@ class CompressedSecondaryCache : public SecondaryCache {
 
   bool MaybeInsertDummy(const Slice& key);
 
+  // Adds an uncompressed value to the samples for the dictionary, and builds
+  // the dictionary once there are enough. See
+  // CompressedSecondaryCacheOptions::max_dict_bytes.
+  void SampleForDict(const Slice& value);
+
   Status InsertInternal(const Slice& key, Cache::ObjectPtr value,
                         const Cache::CacheItemHelper* helper,
                         CompressionType type, CacheTier source);
@@ -146,6 +154,17 @@ class CompressedSecondaryCache : public SecondaryCache {
   mutable port::Mutex capacity_mutex_;
   std::shared_ptr<ConcurrentCacheReservationManager> cache_res_mgr_;
   bool disable_cache_;
+
+  // For dictionary compression. The dictionaries are set only once, by the
+  // thread that completed the samples, and never changed after dict_ready_
+  // is set, as cached values may depend on them.
+  port::Mutex dict_mutex_;
+  std::string dict_samples_;
+  std::vector<size_t> dict_sample_lens_;
+  bool dict_sampling_done_ = false;
+  std::atomic<bool> dict_ready_{false};
+  std::unique_ptr<CompressionDict> compression_dict_;
+  std::unique_ptr<UncompressionDict> uncompression_dict_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
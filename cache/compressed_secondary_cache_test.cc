@@ -977,6 +977,95 @@ TEST_P(CompressedSecondaryCacheTest, SplictValueAndMergeChunksTest) {
   SplictValueAndMergeChunksTest();
 }
 
+TEST_P(CompressedSecondaryCacheTest, DictionaryCompression) {
+  if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+    return;
+  }
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 0;
+  opts.compression_type = CompressionType::kLZ4Compression;
+  opts.max_dict_bytes = 2000;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  // Values that do not compress on their own, but are much alike
+  Random rnd(301);
+  std::string common = rnd.RandomString(1000);
+  std::array<std::string, 3> values;
+  for (auto& value : values) {
+    value = rnd.RandomString(16) + common.substr(16);
+  }
+  const std::array<std::string, 3> keys{{key1, key2, key3}};
+
+  // The first two values are sampled for the dictionary
+  get_perf_context()->Reset();
+  for (size_t i = 0; i < 2; ++i) {
+    TestItem item(values[i].data(), values[i].size());
+    ASSERT_OK(sec_cache->Insert(keys[i], &item, GetHelper(),
+                                /*force_insert=*/true));
+  }
+  ASSERT_GT(get_perf_context()->compressed_sec_cache_compressed_bytes, 1800);
+
+  get_perf_context()->Reset();
+  TestItem item(values[2].data(), values[2].size());
+  ASSERT_OK(
+      sec_cache->Insert(keys[2], &item, GetHelper(), /*force_insert=*/true));
+  ASSERT_LT(get_perf_context()->compressed_sec_cache_compressed_bytes, 200);
+
+  // With and without the dictionary, values read back as inserted
+  for (size_t i = 0; i < values.size(); ++i) {
+    bool kept_in_sec_cache{false};
+    std::unique_ptr<SecondaryCacheResultHandle> handle = sec_cache->Lookup(
+        keys[i], GetHelper(), this, true, /*advise_erase=*/false,
+        /*stats=*/nullptr, kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_EQ(val->ToString(), values[i]);
+  }
+}
+
+TEST_P(CompressedSecondaryCacheTest, ZSTDContextReuse) {
+  if (!ZSTD_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires ZSTD support.");
+    return;
+  }
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 0;
+  opts.compression_type = CompressionType::kZSTD;
+  opts.max_dict_bytes = 2000;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  Random rnd(301);
+  std::string common = rnd.RandomString(1000);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int i = 0; i < 10; ++i) {
+    keys.push_back("____    ____key" + std::to_string(i));
+    values.push_back(rnd.RandomString(16) + common.substr(16));
+  }
+
+  // A thread compressing and decompressing one value at a time borrows the
+  // cached contexts of its core, with and without a dictionary
+  get_perf_context()->Reset();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    TestItem item(values[i].data(), values[i].size());
+    ASSERT_OK(sec_cache->Insert(keys[i], &item, GetHelper(),
+                                /*force_insert=*/true));
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    bool kept_in_sec_cache{false};
+    std::unique_ptr<SecondaryCacheResultHandle> handle = sec_cache->Lookup(
+        keys[i], GetHelper(), this, true, /*advise_erase=*/false,
+        /*stats=*/nullptr, kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_EQ(val->ToString(), values[i]);
+  }
+  ASSERT_EQ(get_perf_context()->zstd_context_create_count, 0);
+}
+
 using secondary_cache_test_util::WithCacheType;
 
 class CompressedSecCacheTestWithTiered
@@ -0,0 +1,388 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/flash_secondary_cache.h"
+
+#include <cinttypes>
+#include <limits>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The result of a lookup, which is ready unless the record still has to be
+// read from the file.
+class FlashSecondaryCache::ResultHandle : public SecondaryCacheResultHandle {
+ public:
+  // A handle for a lookup that is done
+  ResultHandle(Cache::ObjectPtr value, size_t size)
+      : ready_(true), value_(value), size_(size) {}
+
+  // A handle for reading `record_size` bytes at `offset` of the file
+  ResultHandle(FlashSecondaryCache* cache, const Slice& key,
+               const Cache::CacheItemHelper* helper,
+               Cache::CreateContext* create_context, uint64_t offset,
+               uint32_t record_size)
+      : cache_(cache),
+        key_(key.ToString()),
+        helper_(helper),
+        create_context_(create_context),
+        offset_(offset),
+        record_size_(record_size) {}
+
+  bool IsReady() override { return ready_; }
+
+  void Wait() override {
+    if (!ready_) {
+      cache_->WaitAll({this});
+    }
+  }
+
+  Cache::ObjectPtr Value() override { return value_; }
+
+  size_t Size() override { return size_; }
+
+ private:
+  friend class FlashSecondaryCache;
+
+  FlashSecondaryCache* cache_ = nullptr;
+  std::string key_;
+  const Cache::CacheItemHelper* helper_ = nullptr;
+  Cache::CreateContext* create_context_ = nullptr;
+  uint64_t offset_ = 0;
+  uint32_t record_size_ = 0;
+
+  bool ready_ = false;
+  Cache::ObjectPtr value_ = nullptr;
+  size_t size_ = 0;
+};
+
+FlashSecondaryCache::FlashSecondaryCache(
+    const FlashSecondaryCacheOptions& opts,
+    std::unique_ptr<FSRandomRWFile>&& writer,
+    std::unique_ptr<FSRandomAccessFile>&& reader, uint32_t num_regions)
+    : opts_(opts),
+      fs_(opts.fs ? opts.fs : FileSystem::Default()),
+      num_regions_(num_regions),
+      writer_(std::move(writer)),
+      reader_(std::move(reader)),
+      regions_(num_regions),
+      active_region_(0) {
+  MutexLock l(&mutex_);
+  ActivateRegion(0);
+}
+
+FlashSecondaryCache::~FlashSecondaryCache() {
+  writer_.reset();
+  reader_.reset();
+  fs_->DeleteFile(opts_.path, IOOptions(), nullptr).PermitUncheckedError();
+}
+
+Status FlashSecondaryCache::Create(const FlashSecondaryCacheOptions& opts,
+                                   std::shared_ptr<SecondaryCache>* result) {
+  if (opts.path.empty()) {
+    return Status::InvalidArgument("Flash secondary cache needs a path");
+  }
+  if (opts.region_size == 0 ||
+      opts.region_size > std::numeric_limits<uint32_t>::max()) {
+    return Status::InvalidArgument("Invalid flash secondary cache region size");
+  }
+  uint64_t num_regions = opts.capacity / opts.region_size;
+  if (num_regions < 2 || num_regions > std::numeric_limits<uint32_t>::max()) {
+    return Status::InvalidArgument(
+        "Flash secondary cache capacity must allow at least two regions");
+  }
+
+  std::shared_ptr<FileSystem> fs = opts.fs ? opts.fs : FileSystem::Default();
+  FileOptions file_opts;
+  // Create or truncate the file, as NewRandomRWFile() needs an existing one
+  std::unique_ptr<FSWritableFile> file;
+  IOStatus s = fs->NewWritableFile(opts.path, file_opts, &file, nullptr);
+  if (s.ok()) {
+    s = file->Close(IOOptions(), nullptr);
+  }
+  std::unique_ptr<FSRandomRWFile> writer;
+  if (s.ok()) {
+    s = fs->NewRandomRWFile(opts.path, file_opts, &writer, nullptr);
+  }
+  std::unique_ptr<FSRandomAccessFile> reader;
+  if (s.ok()) {
+    s = fs->NewRandomAccessFile(opts.path, file_opts, &reader, nullptr);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  result->reset(new FlashSecondaryCache(opts, std::move(writer),
+                                        std::move(reader),
+                                        static_cast<uint32_t>(num_regions)));
+  return Status::OK();
+}
+
+Status FlashSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr value,
+                                   const Cache::CacheItemHelper* helper,
+                                   bool /*force_insert*/) {
+  if (!helper->IsSecondaryCacheCompatible()) {
+    return Status::OK();
+  }
+  size_t size = (*helper->size_cb)(value);
+  std::string saved(size, '\0');
+  Status s = (*helper->saveto_cb)(value, 0, size, &saved[0]);
+  if (!s.ok()) {
+    return s;
+  }
+  return InsertRecord(key, saved, kNoCompression, CacheTier::kVolatileTier);
+}
+
+Status FlashSecondaryCache::InsertSaved(const Slice& key, const Slice& saved,
+                                        CompressionType type,
+                                        CacheTier source) {
+  return InsertRecord(key, saved, type, source);
+}
+
+Status FlashSecondaryCache::InsertRecord(const Slice& key, const Slice& saved,
+                                         CompressionType type,
+                                         CacheTier source) {
+  std::string record;
+  record.reserve(sizeof(uint32_t) + key.size() + saved.size() + 16);
+  record.resize(sizeof(uint32_t));
+  PutLengthPrefixedSlice(&record, key);
+  PutVarint32(&record, static_cast<uint32_t>(type));
+  PutVarint32(&record, static_cast<uint32_t>(source));
+  record.append(saved.data(), saved.size());
+  if (record.size() > opts_.region_size) {
+    // Too large to be cached
+    return Status::OK();
+  }
+  EncodeFixed32(&record[0],
+                crc32c::Mask(crc32c::Value(record.data() + sizeof(uint32_t),
+                                           record.size() - sizeof(uint32_t))));
+
+  uint32_t full_region = 0;
+  uint64_t full_generation = 0;
+  std::shared_ptr<std::string> full_buffer;
+  {
+    MutexLock l(&mutex_);
+    Region* region = &regions_[active_region_];
+    if (region->buffer->size() + record.size() > opts_.region_size) {
+      full_region = active_region_;
+      full_generation = region->generation;
+      full_buffer = region->buffer;
+      ActivateRegion((active_region_ + 1) % num_regions_);
+      region = &regions_[active_region_];
+    }
+    Location& location = index_[key.ToString()];
+    location.region = active_region_;
+    location.offset = static_cast<uint32_t>(region->buffer->size());
+    location.size = static_cast<uint32_t>(record.size());
+    region->buffer->append(record);
+    region->keys.push_back(key.ToString());
+  }
+  if (full_buffer) {
+    FlushRegion(full_region, full_generation, full_buffer);
+  }
+  return Status::OK();
+}
+
+void FlashSecondaryCache::FlushRegion(
+    uint32_t region, uint64_t generation,
+    const std::shared_ptr<std::string>& buffer) {
+  MutexLock wl(&write_mutex_);
+  {
+    MutexLock l(&mutex_);
+    if (regions_[region].generation != generation) {
+      // Reused already, its entries are gone
+      return;
+    }
+  }
+  IOStatus s = writer_->Write(static_cast<uint64_t>(region) * opts_.region_size,
+                              *buffer, IOOptions(), nullptr);
+  MutexLock l(&mutex_);
+  if (regions_[region].generation != generation) {
+    return;
+  }
+  if (s.ok()) {
+    // From now on, lookups read the region's records from the file
+    regions_[region].buffer.reset();
+  } else {
+    // Drop the entries that could not be written
+    EvictRegion(region);
+  }
+}
+
+void FlashSecondaryCache::EvictRegion(uint32_t region) {
+  Region& r = regions_[region];
+  for (const std::string& key : r.keys) {
+    auto it = index_.find(key);
+    if (it != index_.end() && it->second.region == region) {
+      index_.erase(it);
+    }
+  }
+  r.keys.clear();
+  r.generation++;
+  r.buffer.reset();
+}
+
+void FlashSecondaryCache::ActivateRegion(uint32_t region) {
+  EvictRegion(region);
+  Region& r = regions_[region];
+  r.buffer = std::make_shared<std::string>();
+  r.buffer->reserve(opts_.region_size);
+  active_region_ = region;
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> FlashSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
+    Statistics* /*stats*/, bool& kept_in_sec_cache) {
+  kept_in_sec_cache = false;
+  std::string record;
+  Location location;
+  {
+    MutexLock l(&mutex_);
+    auto it = index_.find(key.ToString());
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    location = it->second;
+    const Region& region = regions_[location.region];
+    if (region.buffer) {
+      record.assign(region.buffer->data() + location.offset, location.size);
+    }
+    if (advise_erase) {
+      index_.erase(it);
+    }
+  }
+  kept_in_sec_cache = !advise_erase;
+
+  if (!record.empty()) {
+    Cache::ObjectPtr value = nullptr;
+    size_t charge = 0;
+    Status s =
+        ParseRecord(record, key, helper, create_context, &value, &charge);
+    if (!s.ok()) {
+      return nullptr;
+    }
+    return std::make_unique<ResultHandle>(value, charge);
+  }
+
+  auto handle = std::make_unique<ResultHandle>(
+      this, key, helper, create_context,
+      static_cast<uint64_t>(location.region) * opts_.region_size +
+          location.offset,
+      location.size);
+  if (wait) {
+    handle->Wait();
+  }
+  return handle;
+}
+
+void FlashSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<ResultHandle*> pending;
+  for (SecondaryCacheResultHandle* h : handles) {
+    if (!h->IsReady()) {
+      pending.push_back(static_cast<ResultHandle*>(h));
+    }
+  }
+  if (pending.empty()) {
+    return;
+  }
+
+  std::vector<FSReadRequest> reqs(pending.size());
+  std::vector<std::unique_ptr<char[]>> bufs(pending.size());
+  for (size_t i = 0; i < pending.size(); ++i) {
+    bufs[i].reset(new char[pending[i]->record_size_]);
+    reqs[i].offset = pending[i]->offset_;
+    reqs[i].len = pending[i]->record_size_;
+    reqs[i].scratch = bufs[i].get();
+  }
+  IOStatus s =
+      reader_->MultiRead(reqs.data(), reqs.size(), IOOptions(), nullptr);
+
+  for (size_t i = 0; i < pending.size(); ++i) {
+    ResultHandle* handle = pending[i];
+    handle->ready_ = true;
+    if (!s.ok() || !reqs[i].status.ok() ||
+        reqs[i].result.size() != handle->record_size_) {
+      continue;
+    }
+    Status ps = ParseRecord(reqs[i].result, handle->key_, handle->helper_,
+                            handle->create_context_, &handle->value_,
+                            &handle->size_);
+    if (!ps.ok()) {
+      handle->value_ = nullptr;
+      handle->size_ = 0;
+    }
+  }
+}
+
+Status FlashSecondaryCache::ParseRecord(const Slice& record, const Slice& key,
+                                        const Cache::CacheItemHelper* helper,
+                                        Cache::CreateContext* create_context,
+                                        Cache::ObjectPtr* value,
+                                        size_t* charge) {
+  if (record.size() < sizeof(uint32_t)) {
+    return Status::Corruption("Truncated flash cache record");
+  }
+  uint32_t expected = crc32c::Unmask(DecodeFixed32(record.data()));
+  Slice input(record.data() + sizeof(uint32_t),
+              record.size() - sizeof(uint32_t));
+  if (crc32c::Value(input.data(), input.size()) != expected) {
+    // Most likely the region was reused while reading
+    return Status::Corruption("Flash cache record checksum mismatch");
+  }
+  Slice record_key;
+  uint32_t type = 0;
+  uint32_t source = 0;
+  if (!GetLengthPrefixedSlice(&input, &record_key) ||
+      !GetVarint32(&input, &type) || !GetVarint32(&input, &source)) {
+    return Status::Corruption("Bad flash cache record");
+  }
+  if (record_key != key) {
+    return Status::NotFound();
+  }
+  return helper->create_cb(input, static_cast<CompressionType>(type),
+                           static_cast<CacheTier>(source), create_context,
+                           nullptr, value, charge);
+}
+
+void FlashSecondaryCache::Erase(const Slice& key) {
+  MutexLock l(&mutex_);
+  index_.erase(key.ToString());
+}
+
+Status FlashSecondaryCache::GetCapacity(size_t& capacity) {
+  capacity = static_cast<size_t>(num_regions_) * opts_.region_size;
+  return Status::OK();
+}
+
+std::string FlashSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  const int kBufferSize{200};
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    path : %s\n", opts_.path.c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    capacity : %" PRIu64 "\n",
+           opts_.capacity);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    region_size : %" ROCKSDB_PRIszt "\n",
+           opts_.region_size);
+  ret.append(buffer);
+  return ret;
+}
+
+size_t FlashSecondaryCache::TEST_GetNumEntries() {
+  MutexLock l(&mutex_);
+  return index_.size();
+}
+
+Status NewFlashSecondaryCache(const FlashSecondaryCacheOptions& opts,
+                              std::shared_ptr<SecondaryCache>* result) {
+  return FlashSecondaryCache::Create(opts, result);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
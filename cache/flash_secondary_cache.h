@@ -0,0 +1,132 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A SecondaryCache on local flash, see FlashSecondaryCacheOptions.
+//
+// The cache file is divided into regions, used one after the other as a log.
+// Entries are appended to the active region in memory. When it is full, it
+// is written to its place in the file, and the next region, holding the
+// oldest entries, is emptied (evicted) to become the active region. Each
+// entry is stored as a record
+//    checksum: fixed32, masked crc32c of the rest of the record
+//    key: length prefixed
+//    compression type: varint32
+//    source cache tier: varint32
+//    saved value
+// so that a read racing with the reuse of its region is detected.
+class FlashSecondaryCache : public SecondaryCache {
+ public:
+  ~FlashSecondaryCache() override;
+
+  static Status Create(const FlashSecondaryCacheOptions& opts,
+                       std::shared_ptr<SecondaryCache>* result);
+
+  static const char* kClassName() { return "FlashSecondaryCache"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr obj,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override;
+
+  Status InsertSaved(const Slice& key, const Slice& saved,
+                     CompressionType type = kNoCompression,
+                     CacheTier source = CacheTier::kVolatileTier) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return true; }
+
+  void Erase(const Slice& key) override;
+
+  // Reads the entries of all handles not ready yet in one MultiRead().
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  size_t TEST_GetNumEntries();
+
+ private:
+  class ResultHandle;
+
+  struct Location {
+    uint32_t region;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  struct Region {
+    // While not yet written to the file, the region's records, which then
+    // have to be read from here. Shared with the write in progress.
+    std::shared_ptr<std::string> buffer;
+    // Incremented each time the region is reused
+    uint64_t generation = 0;
+    // Keys of the records in the region, to evict them from the index
+    std::vector<std::string> keys;
+  };
+
+  FlashSecondaryCache(const FlashSecondaryCacheOptions& opts,
+                      std::unique_ptr<FSRandomRWFile>&& writer,
+                      std::unique_ptr<FSRandomAccessFile>&& reader,
+                      uint32_t num_regions);
+
+  Status InsertRecord(const Slice& key, const Slice& saved,
+                      CompressionType type, CacheTier source);
+
+  // Writes out the region if it was not reused in the meantime.
+  // REQUIRES: not holding mutex_
+  void FlushRegion(uint32_t region, uint64_t generation,
+                   const std::shared_ptr<std::string>& buffer);
+
+  // Removes the entries of the region from the index.
+  // REQUIRES: holding mutex_
+  void EvictRegion(uint32_t region);
+
+  // Evicts the entries of the region and makes it the active region.
+  // REQUIRES: holding mutex_
+  void ActivateRegion(uint32_t region);
+
+  // Checks the record and creates the cache object from it
+  static Status ParseRecord(const Slice& record, const Slice& key,
+                            const Cache::CacheItemHelper* helper,
+                            Cache::CreateContext* create_context,
+                            Cache::ObjectPtr* value, size_t* charge);
+
+  const FlashSecondaryCacheOptions opts_;
+  const std::shared_ptr<FileSystem> fs_;
+  const uint32_t num_regions_;
+
+  // Serializes writes to the file, so that an older version of a region
+  // cannot overwrite a newer one
+  port::Mutex write_mutex_;
+  std::unique_ptr<FSRandomRWFile> writer_;
+  std::unique_ptr<FSRandomAccessFile> reader_;
+
+  // Protects the following
+  port::Mutex mutex_;
+  std::unordered_map<std::string, Location> index_;
+  std::vector<Region> regions_;
+  uint32_t active_region_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
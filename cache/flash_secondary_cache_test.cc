@@ -0,0 +1,204 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/flash_secondary_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/cache.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::WithCacheType;
+
+class FlashSecondaryCacheTest : public testing::Test, public WithCacheType {
+ public:
+  FlashSecondaryCacheTest() {
+    path_ = test::PerThreadDBPath("flash_secondary_cache_test");
+  }
+
+  const std::string& Type() const override {
+    static const std::string kType = kLRU;
+    return kType;
+  }
+
+ protected:
+  static constexpr size_t kRegionSize = 4096;
+  static constexpr size_t kNumRegions = 4;
+
+  std::shared_ptr<SecondaryCache> NewFlashCache() {
+    FlashSecondaryCacheOptions opts;
+    opts.path = path_;
+    opts.capacity = kRegionSize * kNumRegions;
+    opts.region_size = kRegionSize;
+    std::shared_ptr<SecondaryCache> sec_cache;
+    EXPECT_OK(NewFlashSecondaryCache(opts, &sec_cache));
+    return sec_cache;
+  }
+
+  static std::string Key(int i) {
+    char buf[17];
+    snprintf(buf, sizeof(buf), "____    key%05d", i);
+    return buf;
+  }
+
+  void Insert(SecondaryCache* sec_cache, int i, const std::string& value) {
+    TestItem item(value.data(), value.size());
+    ASSERT_OK(sec_cache->Insert(Key(i), &item, GetHelper(), false));
+  }
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(SecondaryCache* sec_cache,
+                                                     int i, bool wait,
+                                                     bool advise_erase = false) {
+    bool kept_in_sec_cache = false;
+    auto handle = sec_cache->Lookup(Key(i), GetHelper(), this, wait,
+                                    advise_erase, /*stats=*/nullptr,
+                                    kept_in_sec_cache);
+    if (handle) {
+      EXPECT_EQ(kept_in_sec_cache, !advise_erase);
+    }
+    return handle;
+  }
+
+  static std::string TakeValue(SecondaryCacheResultHandle* handle) {
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    return item ? item->ToString() : "";
+  }
+
+  std::string path_;
+};
+
+TEST_F(FlashSecondaryCacheTest, InvalidOptions) {
+  FlashSecondaryCacheOptions opts;
+  std::shared_ptr<SecondaryCache> sec_cache;
+  opts.capacity = kRegionSize * kNumRegions;
+  opts.region_size = kRegionSize;
+  ASSERT_TRUE(NewFlashSecondaryCache(opts, &sec_cache).IsInvalidArgument());
+  opts.path = path_;
+  opts.capacity = kRegionSize;
+  ASSERT_TRUE(NewFlashSecondaryCache(opts, &sec_cache).IsInvalidArgument());
+  opts.capacity = kRegionSize * kNumRegions;
+  ASSERT_OK(NewFlashSecondaryCache(opts, &sec_cache));
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache->GetCapacity(capacity));
+  ASSERT_EQ(capacity, kRegionSize * kNumRegions);
+}
+
+TEST_F(FlashSecondaryCacheTest, InsertLookupErase) {
+  auto sec_cache = NewFlashCache();
+  Random rnd(301);
+  std::string value = rnd.RandomString(500);
+
+  ASSERT_EQ(Lookup(sec_cache.get(), 1, /*wait=*/true), nullptr);
+  Insert(sec_cache.get(), 1, value);
+
+  // Still in the active region, so ready even without waiting
+  auto handle = Lookup(sec_cache.get(), 1, /*wait=*/false);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_TRUE(handle->IsReady());
+  ASSERT_EQ(TakeValue(handle.get()), value);
+
+  sec_cache->Erase(Key(1));
+  ASSERT_EQ(Lookup(sec_cache.get(), 1, /*wait=*/true), nullptr);
+
+  Insert(sec_cache.get(), 2, value);
+  handle = Lookup(sec_cache.get(), 2, /*wait=*/true, /*advise_erase=*/true);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(TakeValue(handle.get()), value);
+  ASSERT_EQ(Lookup(sec_cache.get(), 2, /*wait=*/true), nullptr);
+
+  // Larger than a region, so not cached
+  Insert(sec_cache.get(), 3, rnd.RandomString(kRegionSize));
+  ASSERT_EQ(Lookup(sec_cache.get(), 3, /*wait=*/true), nullptr);
+}
+
+TEST_F(FlashSecondaryCacheTest, BatchedLookupFromFile) {
+  auto sec_cache = NewFlashCache();
+  Random rnd(301);
+  // Fill more than the first region, of three entries, which is then written
+  // to the file
+  std::vector<std::string> values;
+  for (int i = 0; i < 6; ++i) {
+    values.push_back(rnd.RandomString(1100));
+    Insert(sec_cache.get(), i, values.back());
+  }
+
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  std::vector<SecondaryCacheResultHandle*> pending;
+  for (int i = 0; i < 6; ++i) {
+    handles.push_back(Lookup(sec_cache.get(), i, /*wait=*/false));
+    ASSERT_NE(handles.back(), nullptr);
+    pending.push_back(handles.back().get());
+  }
+  // The first region's entries are read from the file
+  ASSERT_FALSE(handles[0]->IsReady());
+  ASSERT_FALSE(handles[2]->IsReady());
+  ASSERT_TRUE(handles[3]->IsReady());
+  ASSERT_TRUE(handles[5]->IsReady());
+
+  sec_cache->WaitAll(pending);
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_TRUE(handles[i]->IsReady());
+    ASSERT_EQ(TakeValue(handles[i].get()), values[i]);
+  }
+
+  // Waiting on a single handle reads it too
+  auto handle = Lookup(sec_cache.get(), 1, /*wait=*/true);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_TRUE(handle->IsReady());
+  ASSERT_EQ(TakeValue(handle.get()), values[1]);
+}
+
+TEST_F(FlashSecondaryCacheTest, RegionEviction) {
+  auto sec_cache = NewFlashCache();
+  auto flash_cache = static_cast<FlashSecondaryCache*>(sec_cache.get());
+  Random rnd(301);
+  // With their headers, each region holds three entries
+  std::vector<std::string> values;
+  for (int i = 0; i < 12; ++i) {
+    values.push_back(rnd.RandomString(1100));
+    Insert(sec_cache.get(), i, values.back());
+  }
+  ASSERT_EQ(flash_cache->TEST_GetNumEntries(), 12);
+
+  // Wraps around to the first region, evicting its entries
+  values.push_back(rnd.RandomString(1100));
+  Insert(sec_cache.get(), 12, values.back());
+  ASSERT_EQ(flash_cache->TEST_GetNumEntries(), 12 - 3 + 1);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(Lookup(sec_cache.get(), i, /*wait=*/true), nullptr);
+  }
+  for (int i = 3; i < 13; ++i) {
+    auto handle = Lookup(sec_cache.get(), i, /*wait=*/true);
+    ASSERT_NE(handle, nullptr);
+    ASSERT_EQ(TakeValue(handle.get()), values[i]);
+  }
+
+  // A lookup racing with the reuse of its region finds nothing
+  auto stale = Lookup(sec_cache.get(), 3, /*wait=*/false);
+  ASSERT_NE(stale, nullptr);
+  // Reuses the region of entry 3 and overwrites it on file
+  for (int i = 13; i < 19; ++i) {
+    Insert(sec_cache.get(), i, rnd.RandomString(1100));
+  }
+  ASSERT_EQ(Lookup(sec_cache.get(), 3, /*wait=*/true), nullptr);
+  stale->Wait();
+  ASSERT_TRUE(stale->IsReady());
+  ASSERT_EQ(stale->Value(), nullptr);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -120,7 +120,8 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              CacheMetadataChargePolicy metadata_charge_policy,
                              int max_upper_hash_bits,
                              MemoryAllocator* allocator,
-                             const Cache::EvictionCallback* eviction_callback)
+                             const Cache::EvictionCallback* eviction_callback,
+                             bool lazy_promotion)
     : CacheShardBase(metadata_charge_policy),
       capacity_(0),
       high_pri_pool_usage_(0),
@@ -129,10 +130,12 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
       high_pri_pool_ratio_(high_pri_pool_ratio),
       high_pri_pool_capacity_(0),
       low_pri_pool_ratio_(low_pri_pool_ratio),
+      lazy_promotion_(lazy_promotion),
       low_pri_pool_capacity_(0),
       table_(max_upper_hash_bits, allocator),
       usage_(0),
       lru_usage_(0),
+      pinned_usage_(0),
       mutex_(use_adaptive_mutex),
       eviction_callback_(*eviction_callback) {
   // Make empty circular linked list.
@@ -147,16 +150,22 @@ void LRUCacheShard::EraseUnRefEntries() {
   autovector<LRUHandle*> last_reference_list;
   {
     DMutexLock l(mutex_);
-    while (lru_.next != &lru_) {
-      LRUHandle* old = lru_.next;
-      // LRU list contains only elements which can be evicted.
-      assert(old->InCache() && !old->HasRefs());
-      LRU_Remove(old);
-      table_.Remove(old->key(), old->hash);
-      old->SetInCache(false);
-      assert(usage_ >= old->total_charge);
-      usage_ -= old->total_charge;
-      last_reference_list.push_back(old);
+    LRUHandle* old = lru_.next;
+    while (old != &lru_) {
+      LRUHandle* next = old->next;
+      assert(old->InCache());
+      if (old->HasRefs()) {
+        // Referenced entries are only in the LRU list with lazy_promotion
+        assert(lazy_promotion_);
+      } else {
+        LRU_Remove(old);
+        table_.Remove(old->key(), old->hash);
+        old->SetInCache(false);
+        assert(usage_ >= old->total_charge);
+        usage_ -= old->total_charge;
+        last_reference_list.push_back(old);
+      }
+      old = next;
     }
   }
 
@@ -321,8 +330,22 @@ void LRUCacheShard::MaintainPoolSize() {
 
 void LRUCacheShard::EvictFromLRU(size_t charge,
                                  autovector<LRUHandle*>* deleted) {
+  // With lazy_promotion, referenced entries and entries with a hit since they
+  // were last visited are moved to the head instead, up to a bound that stops
+  // the loop if nothing can be evicted.
+  size_t max_moves = lazy_promotion_ ? 2 * table_.GetOccupancyCount() : 0;
   while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
     LRUHandle* old = lru_.next;
+    if (lazy_promotion_ && (old->HasRefs() || old->HasPendingPromotion())) {
+      if (max_moves == 0) {
+        break;
+      }
+      --max_moves;
+      LRU_Remove(old);
+      old->SetPendingPromotion(false);
+      LRU_Insert(old);
+      continue;
+    }
     // LRU list contains only elements which can be evicted.
     assert(old->InCache() && !old->HasRefs());
     LRU_Remove(old);
@@ -402,7 +425,15 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
         s = Status::OkOverwritten();
         assert(old->InCache());
         old->SetInCache(false);
-        if (!old->HasRefs()) {
+        if (lazy_promotion_) {
+          LRU_Remove(old);
+          if (old->refs.fetch_add(LRUHandle::kDetachedRef,
+                                  std::memory_order_acq_rel) == 0) {
+            assert(usage_ >= old->total_charge);
+            usage_ -= old->total_charge;
+            last_reference_list.push_back(old);
+          }
+        } else if (!old->HasRefs()) {
           // old is on LRU because it's in cache and its reference count is 0.
           LRU_Remove(old);
           assert(usage_ >= old->total_charge);
@@ -412,6 +443,13 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
       }
       if (handle == nullptr) {
         LRU_Insert(e);
+      } else if (lazy_promotion_) {
+        LRU_Insert(e);
+        if (!e->HasRefs()) {
+          e->refs.fetch_add(1, std::memory_order_relaxed);
+          pinned_usage_.fetch_add(e->total_charge, std::memory_order_relaxed);
+        }
+        *handle = e;
       } else {
         // If caller already holds a ref, no need to take one here.
         if (!e->HasRefs()) {
@@ -433,24 +471,57 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
                                  Cache::Priority /*priority*/,
                                  Statistics* /*stats*/) {
   DMutexLock l(mutex_);
+  return LookupLocked(key, hash);
+}
+
+void LRUCacheShard::LookupBatch(const Slice* keys, const uint32_t* hashes,
+                                size_t count, LRUHandle** handles) {
+  DMutexLock l(mutex_);
+  // Like a hash join, issue the memory loads of all the probes before
+  // waiting on any of them
+  for (size_t i = 0; i < count; ++i) {
+    table_.PrefetchBucket(hashes[i]);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    table_.PrefetchFirstEntry(hashes[i]);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    handles[i] = LookupLocked(keys[i], hashes[i]);
+  }
+}
+
+LRUHandle* LRUCacheShard::LookupLocked(const Slice& key, uint32_t hash) {
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->InCache());
-    if (!e->HasRefs()) {
-      // The entry is in LRU since it's in hash and has no external
-      // references.
-      LRU_Remove(e);
+    if (lazy_promotion_) {
+      // Leave the entry where it is in the LRU list, for EvictFromLRU() to
+      // move to the head.
+      if (e->refs.fetch_add(1, std::memory_order_relaxed) == 0) {
+        pinned_usage_.fetch_add(e->total_charge, std::memory_order_relaxed);
+      }
+      e->SetPendingPromotion(true);
+    } else {
+      if (!e->HasRefs()) {
+        // The entry is in LRU since it's in hash and has no external
+        // references.
+        LRU_Remove(e);
+      }
+      e->Ref();
     }
-    e->Ref();
     e->SetHit();
   }
   return e;
 }
 
 bool LRUCacheShard::Ref(LRUHandle* e) {
-  DMutexLock l(mutex_);
   // To create another reference - entry must be already externally referenced.
   assert(e->HasRefs());
+  if (lazy_promotion_) {
+    e->refs.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  DMutexLock l(mutex_);
   e->Ref();
   return true;
 }
@@ -474,6 +545,9 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
   if (e == nullptr) {
     return false;
   }
+  if (lazy_promotion_) {
+    return LazyRelease(e, erase_if_last_ref);
+  }
   bool must_free;
   bool was_in_cache;
   {
@@ -517,6 +591,49 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
   return must_free;
 }
 
+bool LRUCacheShard::LazyRelease(LRUHandle* e, bool erase_if_last_ref) {
+  // Read before giving up our reference, after which e can be evicted
+  const size_t charge = e->total_charge;
+  uint32_t old_refs;
+  bool must_free = false;
+  if (erase_if_last_ref) {
+    DMutexLock l(mutex_);
+    old_refs = e->refs.fetch_sub(1, std::memory_order_acq_rel);
+    if (old_refs == 1) {
+      // The item is still in cache, and nobody else holds a reference to it.
+      assert(e->InCache());
+      LRU_Remove(e);
+      table_.Remove(e->key(), e->hash);
+      e->SetInCache(false);
+      must_free = true;
+    } else if (old_refs == LRUHandle::kDetachedRef + 1) {
+      must_free = true;
+    }
+    if (must_free) {
+      assert(usage_ >= charge);
+      usage_ -= charge;
+    }
+  } else {
+    old_refs = e->refs.fetch_sub(1, std::memory_order_acq_rel);
+    // Without the mutex unless the entry is no longer in the cache, the
+    // uncommon case.
+    if (old_refs == LRUHandle::kDetachedRef + 1) {
+      must_free = true;
+      DMutexLock l(mutex_);
+      assert(usage_ >= charge);
+      usage_ -= charge;
+    }
+  }
+  if ((old_refs & ~LRUHandle::kDetachedRef) == 1) {
+    assert(pinned_usage_.load(std::memory_order_relaxed) >= charge);
+    pinned_usage_.fetch_sub(charge, std::memory_order_relaxed);
+  }
+  if (must_free) {
+    e->Free(table_.GetAllocator());
+  }
+  return must_free;
+}
+
 LRUHandle* LRUCacheShard::CreateHandle(const Slice& key, uint32_t hash,
                                        Cache::ObjectPtr value,
                                        const Cache::CacheItemHelper* helper,
@@ -537,7 +654,7 @@ LRUHandle* LRUCacheShard::CreateHandle(const Slice& key, uint32_t hash,
   e->helper = helper;
   e->key_length = key.size();
   e->hash = hash;
-  e->refs = 0;
+  e->refs.store(0, std::memory_order_relaxed);
   e->next = e->prev = nullptr;
   memcpy(e->key_data, key.data(), key.size());
   e->CalcTotalCharge(charge, metadata_charge_policy_);
@@ -564,6 +681,10 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
   LRUHandle* e = CreateHandle(key, hash, value, helper, charge);
   e->SetIsStandalone(true);
   e->Ref();
+  if (lazy_promotion_) {
+    // Never in the cache
+    e->refs.fetch_add(LRUHandle::kDetachedRef, std::memory_order_relaxed);
+  }
 
   autovector<LRUHandle*> last_reference_list;
 
@@ -583,6 +704,9 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
       usage_ += e->total_charge;
     }
   }
+  if (e && lazy_promotion_) {
+    pinned_usage_.fetch_add(e->total_charge, std::memory_order_relaxed);
+  }
 
   NotifyEvicted(last_reference_list);
   return e;
@@ -597,7 +721,15 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
     if (e != nullptr) {
       assert(e->InCache());
       e->SetInCache(false);
-      if (!e->HasRefs()) {
+      if (lazy_promotion_) {
+        LRU_Remove(e);
+        if (e->refs.fetch_add(LRUHandle::kDetachedRef,
+                              std::memory_order_acq_rel) == 0) {
+          assert(usage_ >= e->total_charge);
+          usage_ -= e->total_charge;
+          last_reference = true;
+        }
+      } else if (!e->HasRefs()) {
         // The entry is in LRU since it's in hash and has no external references
         LRU_Remove(e);
         assert(usage_ >= e->total_charge);
@@ -620,6 +752,9 @@ size_t LRUCacheShard::GetUsage() const {
 }
 
 size_t LRUCacheShard::GetPinnedUsage() const {
+  if (lazy_promotion_) {
+    return pinned_usage_.load(std::memory_order_relaxed);
+  }
   DMutexLock l(mutex_);
   assert(usage_ >= lru_usage_);
   return usage_ - lru_usage_;
@@ -656,7 +791,7 @@ LRUCache::LRUCache(const LRUCacheOptions& opts) : ShardedCache(opts) {
                            opts.high_pri_pool_ratio, opts.low_pri_pool_ratio,
                            opts.use_adaptive_mutex, opts.metadata_charge_policy,
                            /* max_upper_hash_bits */ 32 - opts.num_shard_bits,
-                           alloc, &eviction_callback_);
+                           alloc, &eviction_callback_, opts.lazy_promotion);
   });
 }
 
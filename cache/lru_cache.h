@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -46,6 +47,11 @@ namespace lru_cache {
 // possibly different value). To move from state 2 to state 1, use
 // LRUCacheShard::Lookup.
 // While refs > 0, public properties like value and deleter must not change.
+//
+// With LRUCacheOptions::lazy_promotion, entries in state 1 also stay in the
+// LRU list, and eviction skips them. refs is then updated atomically, and
+// kDetachedRef is set in refs for entries in state 3, so that the last
+// Release can tell without the mutex whether it has to free the entry.
 
 struct LRUHandle {
   Cache::ObjectPtr value;
@@ -58,7 +64,9 @@ struct LRUHandle {
   // The hash of key(). Used for fast sharding and comparisons.
   uint32_t hash;
   // The number of external refs to this entry. The cache itself is not counted.
-  uint32_t refs;
+  // Without lazy_promotion, only changed while holding the shard mutex.
+  std::atomic<uint32_t> refs;
+  static constexpr uint32_t kDetachedRef = uint32_t{1} << 31;
 
   // Mutable flags - access controlled by mutex
   // The m_ and M_ prefixes (and im_ and IM_ later) are to hopefully avoid
@@ -73,6 +81,9 @@ struct LRUHandle {
     M_IN_HIGH_PRI_POOL = (1 << 2),
     // Whether this entry is in low-pri pool.
     M_IN_LOW_PRI_POOL = (1 << 3),
+    // Whether this entry has had a hit since eviction last moved it to the
+    // head of the LRU list (lazy_promotion only).
+    M_PENDING_PROMOTION = (1 << 4),
   };
 
   // "Immutable" flags - only set in single-threaded context and then
@@ -96,17 +107,23 @@ struct LRUHandle {
   uint32_t GetHash() const { return hash; }
 
   // Increase the reference count by 1.
-  void Ref() { refs++; }
+  void Ref() {
+    refs.store(refs.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+  }
 
   // Just reduce the reference count by 1. Return true if it was last reference.
   bool Unref() {
-    assert(refs > 0);
-    refs--;
-    return refs == 0;
+    assert(HasRefs());
+    uint32_t new_refs = refs.load(std::memory_order_relaxed) - 1;
+    refs.store(new_refs, std::memory_order_relaxed);
+    return new_refs == 0;
   }
 
   // Return true if there are external refs, false otherwise.
-  bool HasRefs() const { return refs > 0; }
+  bool HasRefs() const {
+    return (refs.load(std::memory_order_acquire) & ~kDetachedRef) > 0;
+  }
 
   bool InCache() const { return m_flags & M_IN_CACHE; }
   bool IsHighPri() const { return im_flags & IM_IS_HIGH_PRI; }
@@ -114,6 +131,7 @@ struct LRUHandle {
   bool IsLowPri() const { return im_flags & IM_IS_LOW_PRI; }
   bool InLowPriPool() const { return m_flags & M_IN_LOW_PRI_POOL; }
   bool HasHit() const { return m_flags & M_HAS_HIT; }
+  bool HasPendingPromotion() const { return m_flags & M_PENDING_PROMOTION; }
   bool IsStandalone() const { return im_flags & IM_IS_STANDALONE; }
 
   void SetInCache(bool in_cache) {
@@ -155,6 +173,14 @@ struct LRUHandle {
 
   void SetHit() { m_flags |= M_HAS_HIT; }
 
+  void SetPendingPromotion(bool pending) {
+    if (pending) {
+      m_flags |= M_PENDING_PROMOTION;
+    } else {
+      m_flags &= ~M_PENDING_PROMOTION;
+    }
+  }
+
   void SetIsStandalone(bool is_standalone) {
     if (is_standalone) {
       im_flags |= IM_IS_STANDALONE;
@@ -164,7 +190,7 @@ struct LRUHandle {
   }
 
   void Free(MemoryAllocator* allocator) {
-    assert(refs == 0);
+    assert(!HasRefs());
     assert(helper);
     if (helper->del_cb) {
       helper->del_cb(value, allocator);
@@ -214,6 +240,18 @@ class LRUHandleTable {
 
   LRUHandle* Lookup(const Slice& key, uint32_t hash);
   LRUHandle* Insert(LRUHandle* h);
+
+  // Bring the bucket of `hash` into the CPU cache, and then its first entry,
+  // so that the cache misses of several lookups overlap.
+  void PrefetchBucket(uint32_t hash) const {
+    PREFETCH(&list_[hash >> (32 - length_bits_)], 0 /* rw */, 3 /* locality */);
+  }
+  void PrefetchFirstEntry(uint32_t hash) const {
+    LRUHandle* h = list_[hash >> (32 - length_bits_)];
+    if (h != nullptr) {
+      PREFETCH(h, 0 /* rw */, 3 /* locality */);
+    }
+  }
   LRUHandle* Remove(const Slice& key, uint32_t hash);
 
   template <typename T>
@@ -271,7 +309,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                 bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits, MemoryAllocator* allocator,
-                const Cache::EvictionCallback* eviction_callback);
+                const Cache::EvictionCallback* eviction_callback,
+                bool lazy_promotion = false);
 
  public:  // Type definitions expected as parameter to ShardedCache
   using HandleImpl = LRUHandle;
@@ -312,6 +351,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                     Cache::CreateContext* create_context,
                     Cache::Priority priority, Statistics* stats);
 
+  // Lookup() of `count` keys of this shard, taking the mutex once
+  void LookupBatch(const Slice* keys, const uint32_t* hashes, size_t count,
+                   LRUHandle** handles);
+
   bool Release(LRUHandle* handle, bool useful, bool erase_if_last_ref);
   bool Ref(LRUHandle* handle);
   void Erase(const Slice& key, uint32_t hash);
@@ -359,6 +402,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   void LRU_Remove(LRUHandle* e);
   void LRU_Insert(LRUHandle* e);
 
+  // Lookup() while holding the mutex_
+  LRUHandle* LookupLocked(const Slice& key, uint32_t hash);
+
   // Overflow the last entry in high-pri pool to low-pri pool until size of
   // high-pri pool is no larger than the size specify by high_pri_pool_pct.
   void MaintainPoolSize();
@@ -369,6 +415,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // holding the mutex_.
   void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted);
 
+  // Release() with lazy_promotion
+  bool LazyRelease(LRUHandle* e, bool erase_if_last_ref);
+
   void NotifyEvicted(const autovector<LRUHandle*>& evicted_handles);
 
   LRUHandle* CreateHandle(const Slice& key, uint32_t hash,
@@ -397,6 +446,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Ratio of capacity reserved for low priority cache entries.
   double low_pri_pool_ratio_;
 
+  // See LRUCacheOptions::lazy_promotion
+  const bool lazy_promotion_;
+
   // Low-pri pool size, equals to capacity * low_pri_pool_ratio.
   // Remember the value to avoid recomputing each time.
   double low_pri_pool_capacity_;
@@ -431,6 +483,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // Memory size for entries residing only in the LRU list.
   size_t lru_usage_;
 
+  // Memory size for referenced entries, with lazy_promotion only, where the
+  // LRU list also holds referenced entries. Updated without the mutex.
+  std::atomic<size_t> pinned_usage_;
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
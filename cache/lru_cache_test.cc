@@ -45,7 +45,8 @@ class LRUCacheTest : public testing::Test {
 
   void NewCache(size_t capacity, double high_pri_pool_ratio = 0.0,
                 double low_pri_pool_ratio = 1.0,
-                bool use_adaptive_mutex = kDefaultToAdaptiveMutex) {
+                bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
+                bool lazy_promotion = false) {
     DeleteCache();
     cache_ = reinterpret_cast<LRUCacheShard*>(
         port::cacheline_aligned_alloc(sizeof(LRUCacheShard)));
@@ -53,7 +54,8 @@ class LRUCacheTest : public testing::Test {
                                high_pri_pool_ratio, low_pri_pool_ratio,
                                use_adaptive_mutex, kDontChargeCacheMetadata,
                                /*max_upper_hash_bits=*/24,
-                               /*allocator*/ nullptr, &eviction_callback_);
+                               /*allocator*/ nullptr, &eviction_callback_,
+                               lazy_promotion);
   }
 
   void Insert(const std::string& key,
@@ -79,6 +81,20 @@ class LRUCacheTest : public testing::Test {
 
   bool Lookup(char key) { return Lookup(std::string(1, key)); }
 
+  // Lookup without releasing the handle
+  LRUHandle* LookupAndRef(const std::string& key) {
+    return cache_->Lookup(key, 0 /*hash*/, nullptr, nullptr,
+                          Cache::Priority::LOW, nullptr);
+  }
+
+  bool Release(LRUHandle* handle, bool erase_if_last_ref = false) {
+    return cache_->Release(handle, true /*useful*/, erase_if_last_ref);
+  }
+
+  size_t GetUsage() { return cache_->GetUsage(); }
+
+  size_t GetPinnedUsage() { return cache_->GetPinnedUsage(); }
+
   void Erase(const std::string& key) { cache_->Erase(key, 0 /*hash*/); }
 
   void ValidateLRUList(std::vector<std::string> keys,
@@ -175,6 +191,74 @@ TEST_F(LRUCacheTest, BasicLRU) {
   ValidateLRUList({"e", "z", "d", "u", "v"}, 0, 5);
 }
 
+TEST_F(LRUCacheTest, LazyPromotion) {
+  NewCache(5, /*high_pri_pool_ratio=*/0.0, /*low_pri_pool_ratio=*/1.0,
+           kDefaultToAdaptiveMutex, /*lazy_promotion=*/true);
+  for (char ch = 'a'; ch <= 'e'; ch++) {
+    Insert(ch);
+  }
+  // A hit does not move the entry until eviction reaches it
+  ASSERT_TRUE(Lookup("a"));
+  ValidateLRUList({"a", "b", "c", "d", "e"}, 0, 5);
+  Insert("f");
+  ValidateLRUList({"c", "d", "e", "a", "f"}, 0, 5);
+
+  // Referenced entries stay in the LRU list, and are skipped by eviction
+  LRUHandle* c = LookupAndRef("c");
+  ASSERT_NE(c, nullptr);
+  EXPECT_EQ(GetPinnedUsage(), 1);
+  ValidateLRUList({"c", "d", "e", "a", "f"}, 0, 5);
+  Insert("g");
+  ValidateLRUList({"e", "a", "f", "c", "g"}, 0, 5);
+  EXPECT_FALSE(Release(c));
+  EXPECT_EQ(GetPinnedUsage(), 0);
+  EXPECT_EQ(GetUsage(), 5);
+
+  // Erased while referenced, freed on last release
+  LRUHandle* e = LookupAndRef("e");
+  ASSERT_NE(e, nullptr);
+  LRUHandle* e2 = LookupAndRef("e");
+  ASSERT_EQ(e, e2);
+  Erase("e");
+  ValidateLRUList({"a", "f", "c", "g"}, 0, 4);
+  EXPECT_EQ(GetUsage(), 5);
+  EXPECT_FALSE(Lookup("e"));
+  EXPECT_FALSE(Release(e));
+  EXPECT_EQ(GetPinnedUsage(), 1);
+  EXPECT_TRUE(Release(e2));
+  EXPECT_EQ(GetPinnedUsage(), 0);
+  EXPECT_EQ(GetUsage(), 4);
+
+  // Erase on last release
+  LRUHandle* a = LookupAndRef("a");
+  ASSERT_NE(a, nullptr);
+  EXPECT_TRUE(Release(a, /*erase_if_last_ref=*/true));
+  ValidateLRUList({"f", "c", "g"}, 0, 3);
+  EXPECT_EQ(GetUsage(), 3);
+
+  LRUHandle* f = LookupAndRef("f");
+  LRUHandle* g = LookupAndRef("g");
+  c = LookupAndRef("c");
+  Insert("h");
+  Insert("i");
+  Insert("j");
+  ValidateLRUList({"i", "f", "c", "g", "j"}, 0, 5);
+  EXPECT_EQ(GetPinnedUsage(), 3);
+
+  // Eviction gives up when all entries are referenced
+  LRUHandle* i = LookupAndRef("i");
+  LRUHandle* j = LookupAndRef("j");
+  Insert("k");
+  EXPECT_EQ(GetUsage(), 5);
+  EXPECT_EQ(GetPinnedUsage(), 5);
+  EXPECT_FALSE(Lookup("k"));
+  for (LRUHandle* h : {c, f, g, i, j}) {
+    EXPECT_FALSE(Release(h));
+  }
+  EXPECT_EQ(GetPinnedUsage(), 0);
+  EXPECT_EQ(GetUsage(), 5);
+}
+
 TEST_F(LRUCacheTest, LowPriorityMidpointInsertion) {
   // Allocate 2 cache entries to high-pri pool and 3 to low-pri pool.
   NewCache(5, /* high_pri_pool_ratio */ 0.40, /* low_pri_pool_ratio */ 0.60);
@@ -390,12 +474,13 @@ class ClockCacheTest : public testing::Test {
   }
 
   void NewShard(size_t capacity, bool strict_capacity_limit = true,
-                int eviction_effort_cap = 30) {
+                int eviction_effort_cap = 30,
+                bool frequency_admission = false) {
     DeleteShard();
     shard_ =
         reinterpret_cast<Shard*>(port::cacheline_aligned_alloc(sizeof(Shard)));
 
-    TableOpts opts{1 /*value_size*/, eviction_effort_cap};
+    TableOpts opts{1 /*value_size*/, eviction_effort_cap, frequency_admission};
     new (shard_)
         Shard(capacity, strict_capacity_limit, kDontChargeCacheMetadata,
               /*allocator*/ nullptr, &eviction_callback_, &hash_seed_, opts);
@@ -739,6 +824,48 @@ TYPED_TEST(ClockCacheTest, ClockEvictionEffortCapTest) {
   }
 }
 
+TYPED_TEST(ClockCacheTest, ClockFrequencyAdmissionTest) {
+  constexpr size_t kCapacity = 100;
+  this->NewShard(kCapacity, /*strict_capacity_limit*/ false,
+                 /*eviction_effort_cap*/ 30, /*frequency_admission*/ true);
+  auto& shard = *this->shard_;
+
+  // Nothing competes for space while filling the cache
+  for (size_t i = 0; i < kCapacity; ++i) {
+    UniqueId64x2 hkey = this->CheapHash(i);
+    ASSERT_FALSE(this->Lookup(hkey));
+    ASSERT_OK(this->Insert(hkey));
+  }
+  ASSERT_EQ(shard.GetOccupancyCount(), kCapacity);
+  ASSERT_EQ(shard.GetTable().GetAdmissionRejectedCount(), 0U);
+
+  // A scan of keys missing once leaves the cached keys alone
+  for (size_t i = kCapacity; i < 3 * kCapacity; ++i) {
+    UniqueId64x2 hkey = this->CheapHash(i);
+    ASSERT_FALSE(this->Lookup(hkey));
+    ASSERT_OK(this->Insert(hkey));
+  }
+  EXPECT_EQ(shard.GetTable().GetAdmissionRejectedCount(), 2 * kCapacity);
+  EXPECT_EQ(shard.GetTable().GetAdmittedCount(), 0U);
+  for (size_t i = 0; i < kCapacity; ++i) {
+    ASSERT_TRUE(this->Lookup(this->CheapHash(i)));
+  }
+
+  // A key missing again is admitted
+  UniqueId64x2 hkey = this->CheapHash(3 * kCapacity);
+  ASSERT_FALSE(this->Lookup(hkey));
+  ASSERT_OK(this->Insert(hkey));
+  ASSERT_FALSE(this->Lookup(hkey));
+  ASSERT_OK(this->Insert(hkey));
+  ASSERT_TRUE(this->Lookup(hkey));
+  EXPECT_EQ(shard.GetTable().GetAdmittedCount(), 1U);
+
+  // As is any high priority entry
+  hkey = this->CheapHash(3 * kCapacity + 1);
+  ASSERT_OK(this->Insert(hkey, Cache::Priority::HIGH));
+  ASSERT_TRUE(this->Lookup(hkey));
+}
+
 namespace {
 struct DeleteCounter {
   int deleted = 0;
@@ -79,11 +79,13 @@ const char* kTieredCacheName = "TieredCache";
 CacheWithSecondaryAdapter::CacheWithSecondaryAdapter(
     std::shared_ptr<Cache> target,
     std::shared_ptr<SecondaryCache> secondary_cache,
-    TieredAdmissionPolicy adm_policy, bool distribute_cache_res)
+    TieredAdmissionPolicy adm_policy, bool distribute_cache_res,
+    bool insert_compressed_on_fill)
     : CacheWrapper(std::move(target)),
       secondary_cache_(std::move(secondary_cache)),
       adm_policy_(adm_policy),
       distribute_cache_res_(distribute_cache_res),
+      insert_compressed_on_fill_(insert_compressed_on_fill),
       placeholder_usage_(0),
       reserved_usage_(0),
       sec_reserved_(0) {
@@ -269,7 +271,8 @@ Status CacheWithSecondaryAdapter::Insert(const Slice& key, ObjectPtr value,
   // Warm up the secondary cache with the compressed block. The secondary
   // cache may choose to ignore it based on the admission policy.
   if (value != nullptr && !compressed_value.empty() &&
-      adm_policy_ == TieredAdmissionPolicy::kAdmPolicyThreeQueue) {
+      (adm_policy_ == TieredAdmissionPolicy::kAdmPolicyThreeQueue ||
+       insert_compressed_on_fill_)) {
     Status status = secondary_cache_->InsertSaved(key, compressed_value, type);
     assert(status.ok() || status.IsNotSupported());
   }
@@ -363,6 +366,19 @@ void CacheWithSecondaryAdapter::StartAsyncLookupOnMySecondary(
 void CacheWithSecondaryAdapter::StartAsyncLookup(
     AsyncLookupHandle& async_handle) {
   target_->StartAsyncLookup(async_handle);
+  ContinueAsyncLookup(async_handle);
+}
+
+void CacheWithSecondaryAdapter::StartAsyncLookupBatch(
+    AsyncLookupHandle* async_handles, size_t count) {
+  target_->StartAsyncLookupBatch(async_handles, count);
+  for (size_t i = 0; i < count; ++i) {
+    ContinueAsyncLookup(async_handles[i]);
+  }
+}
+
+void CacheWithSecondaryAdapter::ContinueAsyncLookup(
+    AsyncLookupHandle& async_handle) {
   if (!async_handle.IsPending()) {
     bool secondary_compatible =
         async_handle.helper &&
@@ -712,7 +728,8 @@ std::shared_ptr<Cache> NewTieredCache(const TieredCacheOptions& _opts) {
   }
 
   return std::make_shared<CacheWithSecondaryAdapter>(
-      cache, sec_cache, opts.adm_policy, /*distribute_cache_res=*/true);
+      cache, sec_cache, opts.adm_policy, /*distribute_cache_res=*/true,
+      opts.insert_compressed_on_fill);
 }
 
 Status UpdateTieredCache(const std::shared_ptr<Cache>& cache,
@@ -16,7 +16,8 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
       std::shared_ptr<Cache> target,
       std::shared_ptr<SecondaryCache> secondary_cache,
       TieredAdmissionPolicy adm_policy = TieredAdmissionPolicy::kAdmPolicyAuto,
-      bool distribute_cache_res = false);
+      bool distribute_cache_res = false,
+      bool insert_compressed_on_fill = false);
 
   ~CacheWithSecondaryAdapter() override;
 
@@ -39,6 +40,9 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
 
   void StartAsyncLookup(AsyncLookupHandle& async_handle) override;
 
+  void StartAsyncLookupBatch(AsyncLookupHandle* async_handles,
+                             size_t count) override;
+
   void WaitAll(AsyncLookupHandle* async_handles, size_t count) override;
 
   std::string GetPrintableOptions() const override;
@@ -66,6 +70,9 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
 
   void StartAsyncLookupOnMySecondary(AsyncLookupHandle& async_handle);
 
+  // After the lookup in target_, goes on to my secondary cache if needed
+  void ContinueAsyncLookup(AsyncLookupHandle& async_handle);
+
   Handle* Promote(
       std::unique_ptr<SecondaryCacheResultHandle>&& secondary_handle,
       const Slice& key, const CacheItemHelper* helper, Priority priority,
@@ -81,6 +88,9 @@ class CacheWithSecondaryAdapter : public CacheWrapper {
   // placeholder entries with null value and a non-zero charge, across
   // the primary and secondary caches.
   bool distribute_cache_res_;
+  // Whether to offer the compressed form of a value inserted into the
+  // primary cache to the secondary cache, as with kAdmPolicyThreeQueue
+  bool insert_compressed_on_fill_;
   // A cache reservation manager to keep track of secondary cache memory
   // usage by reserving equivalent capacity against the primary cache
   std::shared_ptr<ConcurrentCacheReservationManager> pri_cache_res_;
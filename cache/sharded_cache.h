@@ -9,9 +9,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "port/lang.h"
 #include "port/port.h"
@@ -61,6 +63,9 @@ class CacheShardBase {
                         Cache::CreateContext* create_context,
                         Cache::Priority priority,
                         Statistics* stats) = 0;
+  // Lookup() of `count` keys all of this shard, possibly overlapping them
+  void LookupBatch(const Slice* keys, const HashVal* hashes, size_t count,
+                   HandleImpl** handles) = 0;
   bool Release(HandleImpl* handle, bool useful, bool erase_if_last_ref) = 0;
   bool Ref(HandleImpl* handle) = 0;
   void Erase(const Slice& key, HashCref hash) = 0;
@@ -205,6 +210,54 @@ class ShardedCache : public ShardedCacheBase {
     return reinterpret_cast<Handle*>(result);
   }
 
+  // Groups the keys by shard, so that each shard is probed once for all its
+  // keys, e.g. with a single lock acquisition.
+  void StartAsyncLookupBatch(AsyncLookupHandle* async_handles,
+                             size_t count) override {
+    // Works in chunks to keep everything on the stack, the size of a
+    // MultiGet batch
+    constexpr size_t kChunkSize = 32;
+    // (shard index, index in the chunk), sorted by shard
+    std::pair<uint32_t, uint32_t> order[kChunkSize];
+    HashVal hashes[kChunkSize];
+    Slice sorted_keys[kChunkSize];
+    HashVal sorted_hashes[kChunkSize];
+    HandleImpl* results[kChunkSize];
+    for (size_t start = 0; start < count; start += kChunkSize) {
+      AsyncLookupHandle* chunk = async_handles + start;
+      const size_t n = std::min(count - start, kChunkSize);
+      for (size_t i = 0; i < n; ++i) {
+        chunk[i].found_dummy_entry = false;  // in case re-used
+        assert(!chunk[i].IsPending());
+        hashes[i] = CacheShard::ComputeHash(chunk[i].key, hash_seed_);
+        uint32_t shard =
+            CacheShard::HashPieceForSharding(hashes[i]) & shard_mask_;
+        PREFETCH(&shards_[shard], 0 /* rw */, 3 /* locality */);
+        order[i] = {shard, static_cast<uint32_t>(i)};
+      }
+      std::sort(order, order + n);
+      for (size_t j = 0; j < n; ++j) {
+        sorted_keys[j] = chunk[order[j].second].key;
+        sorted_hashes[j] = hashes[order[j].second];
+      }
+      size_t begin = 0;
+      while (begin < n) {
+        size_t end = begin + 1;
+        while (end < n && order[end].first == order[begin].first) {
+          ++end;
+        }
+        shards_[order[begin].first].LookupBatch(
+            sorted_keys + begin, sorted_hashes + begin, end - begin,
+            results + begin);
+        begin = end;
+      }
+      for (size_t j = 0; j < n; ++j) {
+        chunk[order[j].second].result_handle =
+            reinterpret_cast<Handle*>(results[j]);
+      }
+    }
+  }
+
   void Erase(const Slice& key) override {
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
     GetShard(hash).Erase(key, hash);
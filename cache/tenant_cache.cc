@@ -0,0 +1,118 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/tenant_cache.h"
+
+#include <algorithm>
+
+#include "cache/cache_reservation_manager.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+TenantCache::TenantCache(std::shared_ptr<Cache> shared_cache,
+                         const TenantCacheOptions& options)
+    : CacheWrapper(options.cache),
+      tenant_id_(options.tenant_id),
+      min_usage_(options.min_usage),
+      max_usage_(options.cache->GetCapacity()),
+      cache_res_mgr_(std::make_shared<ConcurrentCacheReservationManager>(
+          std::make_shared<CacheReservationManagerImpl<CacheEntryRole::kMisc>>(
+              std::move(shared_cache)))) {
+  UpdateReservation();
+}
+
+size_t TenantCache::GetReservedUsage() const {
+  return cache_res_mgr_->GetTotalReservedCacheSize();
+}
+
+void TenantCache::UpdateReservation() {
+  assert(cache_res_mgr_);
+  Status s = cache_res_mgr_->UpdateCacheReservation(
+      std::max(min_usage_, target_->GetUsage()));
+  const size_t max_usage = GetMaxUsage();
+  if (s.IsMemoryLimit()) {
+    // The shared budget is used up. Make room among our own entries rather
+    // than going over what is reserved.
+    target_->SetCapacity(std::min(
+        max_usage,
+        std::max(min_usage_, cache_res_mgr_->GetTotalReservedCacheSize())));
+  } else if (target_->GetCapacity() != max_usage) {
+    target_->SetCapacity(max_usage);
+  }
+  s.PermitUncheckedError();
+}
+
+Status TenantCache::Insert(const Slice& key, ObjectPtr obj,
+                           const CacheItemHelper* helper, size_t charge,
+                           Handle** handle, Priority priority,
+                           const Slice& compressed_val, CompressionType type) {
+  Status s = target_->Insert(key, obj, helper, charge, handle, priority,
+                             compressed_val, type);
+  if (s.ok()) {
+    UpdateReservation();
+  }
+  return s;
+}
+
+Cache::Handle* TenantCache::Lookup(const Slice& key,
+                                   const CacheItemHelper* helper,
+                                   CreateContext* create_context,
+                                   Priority priority, Statistics* stats) {
+  auto handle = target_->Lookup(key, helper, create_context, priority, stats);
+  // For any promotion from a secondary cache, as in ChargedCache
+  if (helper && helper->create_cb) {
+    UpdateReservation();
+  }
+  return handle;
+}
+
+void TenantCache::WaitAll(AsyncLookupHandle* async_handles, size_t count) {
+  target_->WaitAll(async_handles, count);
+  UpdateReservation();
+}
+
+bool TenantCache::Release(Cache::Handle* handle, bool useful,
+                          bool erase_if_last_ref) {
+  bool erased = target_->Release(handle, useful, erase_if_last_ref);
+  if (erased) {
+    UpdateReservation();
+  }
+  return erased;
+}
+
+bool TenantCache::Release(Cache::Handle* handle, bool erase_if_last_ref) {
+  bool erased = target_->Release(handle, erase_if_last_ref);
+  if (erased) {
+    UpdateReservation();
+  }
+  return erased;
+}
+
+void TenantCache::Erase(const Slice& key) {
+  target_->Erase(key);
+  UpdateReservation();
+}
+
+void TenantCache::EraseUnRefEntries() {
+  target_->EraseUnRefEntries();
+  UpdateReservation();
+}
+
+void TenantCache::SetCapacity(size_t capacity) {
+  max_usage_.store(capacity, std::memory_order_relaxed);
+  target_->SetCapacity(capacity);
+  UpdateReservation();
+}
+
+std::shared_ptr<Cache> NewTenantCache(
+    const std::shared_ptr<Cache>& shared_cache,
+    const TenantCacheOptions& options) {
+  if (shared_cache == nullptr || options.cache == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<TenantCache>(shared_cache, options);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,76 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "port/port.h"
+#include "rocksdb/advanced_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ConcurrentCacheReservationManager;
+
+// A cache interface which wraps around the cache of one tenant, and reserves
+// the memory it uses in a cache shared among tenants, see NewTenantCache().
+// Like ChargedCache, but the reservation never drops below the guaranteed
+// minimum, and the tenant gives up capacity when the shared cache cannot take
+// more reservations.
+class TenantCache : public CacheWrapper {
+ public:
+  TenantCache(std::shared_ptr<Cache> shared_cache,
+              const TenantCacheOptions& options);
+
+  Status Insert(
+      const Slice& key, ObjectPtr obj, const CacheItemHelper* helper,
+      size_t charge, Handle** handle = nullptr,
+      Priority priority = Priority::LOW, const Slice& compressed_val = Slice(),
+      CompressionType type = CompressionType::kNoCompression) override;
+
+  Cache::Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
+                        CreateContext* create_context,
+                        Priority priority = Priority::LOW,
+                        Statistics* stats = nullptr) override;
+
+  void WaitAll(AsyncLookupHandle* async_handles, size_t count) override;
+
+  bool Release(Cache::Handle* handle, bool useful,
+               bool erase_if_last_ref = false) override;
+  bool Release(Cache::Handle* handle, bool erase_if_last_ref = false) override;
+
+  void Erase(const Slice& key) override;
+  void EraseUnRefEntries() override;
+
+  static const char* kClassName() { return "TenantCache"; }
+  const char* Name() const override { return kClassName(); }
+
+  // Sets the hard maximum of the tenant
+  void SetCapacity(size_t capacity) override;
+
+  const std::string& GetTenantId() const { return tenant_id_; }
+
+  size_t GetMinUsage() const { return min_usage_; }
+
+  size_t GetMaxUsage() const {
+    return max_usage_.load(std::memory_order_relaxed);
+  }
+
+  // Memory currently reserved in the shared cache
+  size_t GetReservedUsage() const;
+
+ private:
+  // Matches the reservation to the memory used, and the capacity of the
+  // tenant's cache to what could be reserved.
+  void UpdateReservation();
+
+  const std::string tenant_id_;
+  const size_t min_usage_;
+  std::atomic<size_t> max_usage_;
+  std::shared_ptr<ConcurrentCacheReservationManager> cache_res_mgr_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
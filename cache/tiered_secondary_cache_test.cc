@@ -185,7 +185,7 @@ class DBTieredSecondaryCacheTest : public DBTestBase {
   std::shared_ptr<Cache> NewCache(
       size_t pri_capacity, size_t compressed_capacity, size_t nvm_capacity,
       TieredAdmissionPolicy adm_policy = TieredAdmissionPolicy::kAdmPolicyAuto,
-      bool ready_before_wait = false) {
+      bool ready_before_wait = false, bool insert_compressed_on_fill = false) {
     LRUCacheOptions lru_opts;
     TieredCacheOptions opts;
     lru_opts.capacity = 0;
@@ -204,6 +204,7 @@ class DBTieredSecondaryCacheTest : public DBTestBase {
       opts.nvm_sec_cache = nvm_sec_cache_;
     }
     opts.adm_policy = adm_policy;
+    opts.insert_compressed_on_fill = insert_compressed_on_fill;
     cache_ = NewTieredCache(opts);
     assert(cache_ != nullptr);
 
@@ -816,6 +817,57 @@ TEST_P(DBTieredAdmPolicyTest, CompressedOnlyTest) {
   Destroy(options);
 }
 
+TEST_P(DBTieredAdmPolicyTest, InsertCompressedOnFill) {
+  if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+    return;
+  }
+
+  for (bool insert_compressed_on_fill : {false, true}) {
+    SCOPED_TRACE("insert_compressed_on_fill=" +
+                 std::to_string(insert_compressed_on_fill));
+    BlockBasedTableOptions table_options;
+    // See CompressedOnlyTest for the sizes
+    table_options.block_cache =
+        NewCache(256 * 1024, 10 * 1024, 0, GetParam(),
+                 /*ready_before_wait=*/false, insert_compressed_on_fill);
+    table_options.block_size = 4 * 1024;
+    table_options.cache_index_and_filter_blocks = false;
+    Options options = GetDefaultOptions();
+    options.create_if_missing = true;
+    options.compression = kLZ4Compression;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    options.paranoid_file_checks = false;
+    DestroyAndReopen(options);
+    Random rnd(301);
+    for (int i = 0; i < 256; i++) {
+      std::string p_v;
+      test::CompressibleString(&rnd, 0.5, 1007, &p_v);
+      ASSERT_OK(Put(Key(i), p_v));
+    }
+    ASSERT_OK(Flush());
+
+    SetPerfLevel(PerfLevel::kEnableCount);
+    // The block read from the file is offered to the compressed secondary
+    // cache, which admits a placeholder for it. The eviction from the primary
+    // cache then admits the block.
+    get_perf_context()->Reset();
+    ASSERT_EQ(1007, Get(Key(0)).size());
+    ASSERT_EQ(get_perf_context()->block_read_count, 1);
+    ClearPrimaryCache();
+
+    // Without the offer, the eviction only admitted a placeholder, and the
+    // block is read from the file again
+    get_perf_context()->Reset();
+    ASSERT_EQ(1007, Get(Key(0)).size());
+    ASSERT_EQ(get_perf_context()->block_read_count,
+              insert_compressed_on_fill ? 0 : 1);
+    SetPerfLevel(PerfLevel::kDisable);
+
+    Destroy(options);
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(
     DBTieredAdmPolicyTest, DBTieredAdmPolicyTest,
     ::testing::Values(TieredAdmissionPolicy::kAdmPolicyAuto,
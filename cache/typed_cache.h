@@ -366,6 +366,21 @@ class FullTypedCacheInterface
           async_handle);
     }
   }
+
+  // StartAsyncLookupFull() on each of an array of async handles, letting the
+  // cache overlap the lookups. See Cache::StartAsyncLookupBatch().
+  inline void StartAsyncLookupBatchFull(
+      TypedAsyncLookupHandle* async_handles, size_t count,
+      CacheTier lowest_used_cache_tier = CacheTier::kNonVolatileBlockTier) {
+    for (size_t i = 0; i < count; ++i) {
+      if (lowest_used_cache_tier > CacheTier::kVolatileTier) {
+        async_handles[i].helper = GetFullHelper();
+      } else {
+        assert(async_handles[i].helper == nullptr);
+      }
+    }
+    this->cache_->StartAsyncLookupBatch(async_handles, count);
+  }
 };
 
 // FullTypedSharedCacheInterface - Like FullTypedCacheInterface but with a
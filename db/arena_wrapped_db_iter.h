@@ -76,6 +76,8 @@ class ArenaWrappedDBIter : public Iterator {
   Status status() const override { return db_iter_->status(); }
   Slice timestamp() const override { return db_iter_->timestamp(); }
   bool IsBlob() const { return db_iter_->IsBlob(); }
+  bool IsKeyPinned() const { return db_iter_->IsKeyPinned(); }
+  bool IsValuePinned() const { return db_iter_->IsValuePinned(); }
 
   Status GetProperty(std::string prop_name, std::string* prop) override;
 
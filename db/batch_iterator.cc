@@ -0,0 +1,228 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/batch_iterator.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/arena_wrapped_db_iter.h"
+#include "util/cast_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The offsets of a column are 32-bit like in Arrow binary arrays
+constexpr size_t kMaxColumnBytes = std::numeric_limits<int32_t>::max();
+
+void StartColumn(BatchColumn* column, bool pinned) {
+  column->offsets.clear();
+  if (!pinned) {
+    column->offsets.push_back(0);
+  }
+  column->data.clear();
+  column->validity.clear();
+  column->null_count = 0;
+  column->pinned = pinned;
+  column->views.clear();
+}
+
+void SetValidity(BatchColumn* column, size_t row, bool valid) {
+  if (column->validity.empty() && valid) {
+    return;
+  }
+  if (column->validity.size() <= row / 8) {
+    column->validity.resize(row / 8 + 1, 0xff);
+  }
+  if (!valid) {
+    column->validity[row / 8] &= static_cast<uint8_t>(~(1 << (row % 8)));
+    column->null_count++;
+  }
+}
+
+// Copies the values of the column referenced so far
+void Unpin(BatchColumn* column) {
+  assert(column->pinned);
+  column->pinned = false;
+  column->offsets.assign(1, 0);
+  for (const Slice& view : column->views) {
+    column->data.append(view.data(), view.size());
+    column->offsets.push_back(static_cast<int32_t>(column->data.size()));
+  }
+  column->views.clear();
+}
+
+// Adds `value` as the value of `row`, or a null if nullptr. References it
+// rather than copying it if both the column and the value are pinned.
+void Append(BatchColumn* column, size_t row, const Slice* value,
+            bool pinned) {
+  SetValidity(column, row, value != nullptr);
+  const Slice data = value != nullptr ? *value : Slice();
+  if (column->pinned) {
+    if (pinned || value == nullptr) {
+      column->views.push_back(data);
+      return;
+    }
+    Unpin(column);
+  }
+  column->data.append(data.data(), data.size());
+  column->offsets.push_back(static_cast<int32_t>(column->data.size()));
+}
+
+class BatchIteratorImpl : public BatchIterator {
+ public:
+  BatchIteratorImpl(const BatchIteratorOptions& options,
+                    const ReadOptions& read_options)
+      : options_(options), read_options_(read_options) {
+    if (!options_.columns.empty() &&
+        read_options_.wide_column_projection == nullptr) {
+      for (const std::string& name : options_.columns) {
+        projection_.emplace_back(name);
+      }
+      if (options_.include_values) {
+        projection_.push_back(kDefaultWideColumnName);
+      }
+      std::sort(
+          projection_.begin(), projection_.end(),
+          [](const Slice& a, const Slice& b) { return a.compare(b) < 0; });
+      projection_.erase(std::unique(projection_.begin(), projection_.end()),
+                        projection_.end());
+      read_options_.wide_column_projection = &projection_;
+    }
+  }
+
+  // To create the underlying iterator with, which references the projection
+  const ReadOptions& read_options() const { return read_options_; }
+
+  void SetIterator(Iterator* iter, ArenaWrappedDBIter* db_iter) {
+    iter_.reset(iter);
+    db_iter_ = db_iter;
+  }
+
+  void SeekToFirst() override {
+    status_ = Status::OK();
+    iter_->SeekToFirst();
+  }
+
+  void Seek(const Slice& target) override {
+    status_ = Status::OK();
+    iter_->Seek(target);
+  }
+
+  bool NextBatch(RecordBatch* batch) override;
+
+  Status status() const override {
+    return status_.ok() ? iter_->status() : status_;
+  }
+
+ private:
+  // The value of each of options_.columns in `columns`, nullptr if missing
+  void FindColumns(const WideColumns& columns);
+
+  const BatchIteratorOptions options_;
+  ReadOptions read_options_;
+  std::vector<Slice> projection_;
+  std::unique_ptr<Iterator> iter_;
+  // iter_ if it tells whether its keys and values are pinned, else nullptr
+  ArenaWrappedDBIter* db_iter_ = nullptr;
+  Status status_;
+  std::vector<const Slice*> found_columns_;
+};
+
+void BatchIteratorImpl::FindColumns(const WideColumns& columns) {
+  found_columns_.clear();
+  for (const std::string& name : options_.columns) {
+    // Wide columns are sorted by name
+    auto it = std::lower_bound(columns.begin(), columns.end(), name,
+                               [](const WideColumn& column, const Slice& n) {
+                                 return column.name().compare(n) < 0;
+                               });
+    found_columns_.push_back(
+        it != columns.end() && it->name() == name ? &it->value() : nullptr);
+  }
+}
+
+bool BatchIteratorImpl::NextBatch(RecordBatch* batch) {
+  const bool pinning = db_iter_ != nullptr;
+  batch->num_rows = 0;
+  StartColumn(&batch->keys, pinning);
+  StartColumn(&batch->values, pinning);
+  batch->columns.resize(options_.columns.size());
+  for (BatchColumn& column : batch->columns) {
+    StartColumn(&column, pinning);
+  }
+
+  size_t num_bytes = 0;
+  while (batch->num_rows < options_.max_rows && status_.ok() &&
+         iter_->Valid()) {
+    const Slice key = iter_->key();
+    Slice value;
+    size_t row_bytes = key.size();
+    if (options_.include_values) {
+      value = iter_->value();
+      row_bytes += value.size();
+    }
+    if (!options_.columns.empty()) {
+      FindColumns(iter_->columns());
+      for (const Slice* column_value : found_columns_) {
+        row_bytes += column_value != nullptr ? column_value->size() : 0;
+      }
+    }
+    if (batch->num_rows > 0 && (num_bytes >= options_.max_bytes ||
+                                num_bytes + row_bytes > kMaxColumnBytes)) {
+      break;
+    }
+    if (row_bytes > kMaxColumnBytes) {
+      status_ = Status::NotSupported("Entry too large for a batch: ",
+                                     key.ToString(/*hex=*/true));
+      break;
+    }
+
+    const size_t row = batch->num_rows;
+    Append(&batch->keys, row, &key, pinning && db_iter_->IsKeyPinned());
+    const bool value_pinned = pinning && db_iter_->IsValuePinned();
+    if (options_.include_values) {
+      Append(&batch->values, row, &value, value_pinned);
+    }
+    for (size_t i = 0; i < found_columns_.size(); ++i) {
+      Append(&batch->columns[i], row, found_columns_[i], value_pinned);
+    }
+    num_bytes += row_bytes;
+    batch->num_rows++;
+    iter_->Next();
+  }
+
+  if (!status().ok()) {
+    batch->num_rows = 0;
+    StartColumn(&batch->keys, /*pinned=*/false);
+    StartColumn(&batch->values, /*pinned=*/false);
+    batch->columns.clear();
+    return false;
+  }
+  if (!options_.include_values) {
+    StartColumn(&batch->values, /*pinned=*/false);
+  }
+  return batch->num_rows > 0;
+}
+}  // namespace
+
+BatchIterator* NewBatchIterator(DB* db, const ReadOptions& read_options,
+                                ColumnFamilyHandle* column_family,
+                                const BatchIteratorOptions& batch_options,
+                                bool db_iter) {
+  auto batch_iter = new BatchIteratorImpl(batch_options, read_options);
+  Iterator* iter = db->NewIterator(batch_iter->read_options(), column_family);
+  ArenaWrappedDBIter* arena_iter = nullptr;
+  if (db_iter && iter->status().ok() && !read_options.tailing) {
+    arena_iter = static_cast_with_check<ArenaWrappedDBIter>(iter);
+  }
+  batch_iter->SetIterator(iter, arena_iter);
+  return batch_iter;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,22 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include "rocksdb/batch_iterator.h"
+#include "rocksdb/db.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Creates the iterator of DB::NewBatchIterator() from an iterator of `db`.
+// With `db_iter`, the iterators of `db` must be ArenaWrappedDBIter unless
+// they have an error or are tailing, and the batches reference the keys and
+// values they pin rather than copying them.
+BatchIterator* NewBatchIterator(DB* db, const ReadOptions& read_options,
+                                ColumnFamilyHandle* column_family,
+                                const BatchIteratorOptions& batch_options,
+                                bool db_iter);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -5,6 +5,7 @@
 
 #include "db/blob/blob_file_builder.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "db/blob/blob_contents.h"
@@ -41,13 +42,14 @@ BlobFileBuilder::BlobFileBuilder(
     BlobFileCompletionCallback* blob_callback,
     BlobFileCreationReason creation_reason,
     std::vector<std::string>* blob_file_paths,
-    std::vector<BlobFileAddition>* blob_file_additions)
+    std::vector<BlobFileAddition>* blob_file_additions,
+    BlobSeparationTuner* separation_tuner)
     : BlobFileBuilder([versions]() { return versions->NewFileNumber(); }, fs,
                       immutable_options, mutable_cf_options, file_options,
                       db_id, db_session_id, job_id, column_family_id,
                       column_family_name, io_priority, write_hint, io_tracer,
                       blob_callback, creation_reason, blob_file_paths,
-                      blob_file_additions) {}
+                      blob_file_additions, separation_tuner) {}
 
 BlobFileBuilder::BlobFileBuilder(
     std::function<uint64_t()> file_number_generator, FileSystem* fs,
@@ -60,13 +62,19 @@ BlobFileBuilder::BlobFileBuilder(
     BlobFileCompletionCallback* blob_callback,
     BlobFileCreationReason creation_reason,
     std::vector<std::string>* blob_file_paths,
-    std::vector<BlobFileAddition>* blob_file_additions)
+    std::vector<BlobFileAddition>* blob_file_additions,
+    BlobSeparationTuner* separation_tuner)
     : file_number_generator_(std::move(file_number_generator)),
       fs_(fs),
       immutable_options_(immutable_options),
-      min_blob_size_(mutable_cf_options->min_blob_size),
+      min_blob_size_(
+          separation_tuner && mutable_cf_options->adaptive_min_blob_size
+              ? separation_tuner->GetMinBlobSize(
+                    mutable_cf_options->min_blob_size)
+              : mutable_cf_options->min_blob_size),
       blob_file_size_(mutable_cf_options->blob_file_size),
       blob_compression_type_(mutable_cf_options->blob_compression_type),
+      max_dict_bytes_(mutable_cf_options->blob_compression_max_dict_bytes),
       prepopulate_blob_cache_(mutable_cf_options->prepopulate_blob_cache),
       file_options_(file_options),
       db_id_(std::move(db_id)),
@@ -82,7 +90,10 @@ BlobFileBuilder::BlobFileBuilder(
       blob_file_paths_(blob_file_paths),
       blob_file_additions_(blob_file_additions),
       blob_count_(0),
-      blob_bytes_(0) {
+      blob_bytes_(0),
+      separation_tuner_(mutable_cf_options->adaptive_min_blob_size
+                            ? separation_tuner
+                            : nullptr) {
   assert(file_number_generator_);
   assert(fs_);
   assert(immutable_options_);
@@ -100,6 +111,10 @@ Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
   assert(blob_index);
   assert(blob_index->empty());
 
+  if (separation_tuner_) {
+    value_sizes_.Add(value.size());
+  }
+
   if (value.size() < min_blob_size_) {
     return Status::OK();
   }
@@ -111,6 +126,10 @@ Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
     }
   }
 
+  if (IsSamplingForCompressionDict()) {
+    AddCompressionDictSample(value);
+  }
+
   Slice blob = value;
   std::string compressed_blob;
 
@@ -139,6 +158,13 @@ Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
     }
   }
 
+  {
+    const Status s = FinishCompressionDictSamplingIfNeeded();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
   {
     const Status s =
         PutBlobIntoCacheIfNeeded(value, blob_file_number, blob_offset);
@@ -156,6 +182,10 @@ Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
 }
 
 Status BlobFileBuilder::Finish() {
+  if (separation_tuner_) {
+    separation_tuner_->RecordValueSizes(value_sizes_);
+  }
+
   if (!IsBlobFileOpen()) {
     return Status::OK();
   }
@@ -229,6 +259,11 @@ Status BlobFileBuilder::OpenBlobFileIfNeeded() {
 
   BlobLogHeader header(column_family_id_, blob_compression_type_, has_ttl,
                        expiration_range);
+  if (compression_dict_) {
+    header.version = kVersion2;
+    header.has_compression_dict = true;
+    header.compression_dict = compression_dict_->GetRawDict().ToString();
+  }
 
   {
     Status s = blob_log_writer->WriteHeader(header);
@@ -242,6 +277,8 @@ Status BlobFileBuilder::OpenBlobFileIfNeeded() {
   }
 
   writer_ = std::move(blob_log_writer);
+  // Counted with the blobs, see blob_log_format.h
+  blob_bytes_ = header.compression_dict_encoded_size();
 
   assert(IsBlobFileOpen());
 
@@ -264,8 +301,10 @@ Status BlobFileBuilder::CompressBlobIfNeeded(
   CompressionContext context(blob_compression_type_, opts);
   constexpr uint64_t sample_for_compression = 0;
 
-  CompressionInfo info(opts, context, CompressionDict::GetEmptyDict(),
-                       blob_compression_type_, sample_for_compression);
+  CompressionInfo info(
+      opts, context,
+      compression_dict_ ? *compression_dict_ : CompressionDict::GetEmptyDict(),
+      blob_compression_type_, sample_for_compression);
 
   constexpr uint32_t compression_format_version = 2;
 
@@ -287,6 +326,70 @@ Status BlobFileBuilder::CompressBlobIfNeeded(
   return Status::OK();
 }
 
+bool BlobFileBuilder::IsSamplingForCompressionDict() const {
+  return max_dict_bytes_ > 0 &&
+         DictCompressionTypeSupported(blob_compression_type_) &&
+         !compression_dict_;
+}
+
+bool BlobFileBuilder::UseZstdDictTrainer() const {
+  return (blob_compression_type_ == kZSTD ||
+          blob_compression_type_ == kZSTDNotFinalCompression) &&
+         ZSTD_TrainDictionarySupported();
+}
+
+size_t BlobFileBuilder::GetCompressionDictSampleBytes() const {
+  // ZSTD trains the dictionary from about a hundred times its size of
+  // samples, other algorithms use the samples themselves
+  return UseZstdDictTrainer() ? size_t{100} * max_dict_bytes_
+                              : max_dict_bytes_;
+}
+
+void BlobFileBuilder::AddCompressionDictSample(const Slice& value) {
+  assert(IsSamplingForCompressionDict());
+
+  const size_t sample_bytes = GetCompressionDictSampleBytes();
+  assert(dict_samples_.size() < sample_bytes);
+  const size_t len = std::min(sample_bytes - dict_samples_.size(),
+                              static_cast<size_t>(value.size()));
+  if (len > 0) {
+    dict_samples_.append(value.data(), len);
+    dict_sample_lens_.emplace_back(len);
+  }
+}
+
+Status BlobFileBuilder::FinishCompressionDictSamplingIfNeeded() {
+  if (!IsSamplingForCompressionDict() ||
+      dict_samples_.size() < GetCompressionDictSampleBytes()) {
+    return Status::OK();
+  }
+
+  std::string dict;
+  if (UseZstdDictTrainer()) {
+    dict = ZSTD_TrainDictionary(dict_samples_, dict_sample_lens_,
+                                max_dict_bytes_);
+  }
+  if (dict.empty()) {
+    // ZSTD can use raw content as a dictionary too, if training fails
+    dict_samples_.resize(std::min(dict_samples_.size(),
+                                  static_cast<size_t>(max_dict_bytes_)));
+    dict = std::move(dict_samples_);
+  }
+  dict_samples_ = std::string();
+  dict_sample_lens_ = std::vector<size_t>();
+
+  const CompressionOptions opts;
+  compression_dict_.reset(
+      new CompressionDict(std::move(dict), blob_compression_type_, opts.level));
+
+  // The blobs so far are compressed without the dictionary, so the following
+  // ones go to a new file
+  if (!IsBlobFileOpen()) {
+    return Status::OK();
+  }
+  return CloseBlobFile();
+}
+
 Status BlobFileBuilder::WriteBlobToFile(const Slice& key, const Slice& blob,
                                         uint64_t* blob_file_number,
                                         uint64_t* blob_offset) {
@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "db/blob/blob_separation_tuner.h"
 #include "rocksdb/advanced_options.h"
 #include "rocksdb/compression_type.h"
 #include "rocksdb/env.h"
@@ -30,6 +31,7 @@ class Slice;
 class BlobLogWriter;
 class IOTracer;
 class BlobFileCompletionCallback;
+class CompressionDict;
 
 class BlobFileBuilder {
  public:
@@ -46,7 +48,8 @@ class BlobFileBuilder {
                   BlobFileCompletionCallback* blob_callback,
                   BlobFileCreationReason creation_reason,
                   std::vector<std::string>* blob_file_paths,
-                  std::vector<BlobFileAddition>* blob_file_additions);
+                  std::vector<BlobFileAddition>* blob_file_additions,
+                  BlobSeparationTuner* separation_tuner = nullptr);
 
   BlobFileBuilder(std::function<uint64_t()> file_number_generator,
                   FileSystem* fs, const ImmutableOptions* immutable_options,
@@ -61,7 +64,8 @@ class BlobFileBuilder {
                   BlobFileCompletionCallback* blob_callback,
                   BlobFileCreationReason creation_reason,
                   std::vector<std::string>* blob_file_paths,
-                  std::vector<BlobFileAddition>* blob_file_additions);
+                  std::vector<BlobFileAddition>* blob_file_additions,
+                  BlobSeparationTuner* separation_tuner = nullptr);
 
   BlobFileBuilder(const BlobFileBuilder&) = delete;
   BlobFileBuilder& operator=(const BlobFileBuilder&) = delete;
@@ -76,6 +80,11 @@ class BlobFileBuilder {
   bool IsBlobFileOpen() const;
   Status OpenBlobFileIfNeeded();
   Status CompressBlobIfNeeded(Slice* blob, std::string* compressed_blob) const;
+  bool IsSamplingForCompressionDict() const;
+  bool UseZstdDictTrainer() const;
+  size_t GetCompressionDictSampleBytes() const;
+  void AddCompressionDictSample(const Slice& value);
+  Status FinishCompressionDictSamplingIfNeeded();
   Status WriteBlobToFile(const Slice& key, const Slice& blob,
                          uint64_t* blob_file_number, uint64_t* blob_offset);
   Status CloseBlobFile();
@@ -90,6 +99,7 @@ class BlobFileBuilder {
   uint64_t min_blob_size_;
   uint64_t blob_file_size_;
   CompressionType blob_compression_type_;
+  uint32_t max_dict_bytes_;
   PrepopulateBlobCache prepopulate_blob_cache_;
   const FileOptions* file_options_;
   const std::string db_id_;
@@ -107,6 +117,15 @@ class BlobFileBuilder {
   std::unique_ptr<BlobLogWriter> writer_;
   uint64_t blob_count_;
   uint64_t blob_bytes_;
+  // Samples of the values for training the compression dictionary, which the
+  // files opened after it is trained are compressed with
+  std::string dict_samples_;
+  std::vector<size_t> dict_sample_lens_;
+  std::unique_ptr<CompressionDict> compression_dict_;
+  // Set when the min blob size is adaptive, to record the sizes of the
+  // values added
+  BlobSeparationTuner* separation_tuner_;
+  BlobSeparationTuner::ValueSizes value_sizes_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
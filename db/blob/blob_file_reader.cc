@@ -51,11 +51,12 @@ Status BlobFileReader::Create(
   Statistics* const statistics = immutable_options.stats;
 
   CompressionType compression_type = kNoCompression;
+  std::unique_ptr<UncompressionDict> uncompression_dict;
 
   {
-    const Status s =
-        ReadHeader(file_reader.get(), read_options, column_family_id,
-                   statistics, &compression_type);
+    const Status s = ReadHeader(file_reader.get(), read_options,
+                                column_family_id, file_size, statistics,
+                                &compression_type, &uncompression_dict);
     if (!s.ok()) {
       return s;
     }
@@ -69,9 +70,9 @@ Status BlobFileReader::Create(
     }
   }
 
-  blob_file_reader->reset(
-      new BlobFileReader(std::move(file_reader), file_size, compression_type,
-                         immutable_options.clock, statistics));
+  blob_file_reader->reset(new BlobFileReader(
+      std::move(file_reader), file_size, compression_type,
+      std::move(uncompression_dict), immutable_options.clock, statistics));
 
   return Status::OK();
 }
@@ -136,13 +137,14 @@ Status BlobFileReader::OpenFile(
   return Status::OK();
 }
 
-Status BlobFileReader::ReadHeader(const RandomAccessFileReader* file_reader,
-                                  const ReadOptions& read_options,
-                                  uint32_t column_family_id,
-                                  Statistics* statistics,
-                                  CompressionType* compression_type) {
+Status BlobFileReader::ReadHeader(
+    const RandomAccessFileReader* file_reader, const ReadOptions& read_options,
+    uint32_t column_family_id, uint64_t file_size, Statistics* statistics,
+    CompressionType* compression_type,
+    std::unique_ptr<UncompressionDict>* uncompression_dict) {
   assert(file_reader);
   assert(compression_type);
+  assert(uncompression_dict);
 
   Slice header_slice;
   Buffer buf;
@@ -186,6 +188,51 @@ Status BlobFileReader::ReadHeader(const RandomAccessFileReader* file_reader,
 
   *compression_type = header.compression;
 
+  if (header.has_compression_dict) {
+    // The file is long enough to hold the dictionary size, as it has the
+    // footer too
+    uint32_t dict_size = 0;
+
+    {
+      constexpr uint64_t read_offset = BlobLogHeader::kSize;
+      constexpr size_t read_size = BlobLogHeader::kCompressionDictSizeBytes;
+
+      Status s = ReadFromFile(file_reader, read_options, read_offset,
+                              read_size, statistics, &header_slice, &buf,
+                              &aligned_buf);
+      if (s.ok()) {
+        s = BlobLogHeader::DecodeCompressionDictSize(header_slice, &dict_size);
+      }
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    {
+      constexpr uint64_t read_offset =
+          BlobLogHeader::kSize + BlobLogHeader::kCompressionDictSizeBytes;
+      const size_t read_size = dict_size + sizeof(uint32_t);
+      if (read_offset + read_size + BlobLogFooter::kSize > file_size) {
+        return Status::Corruption("Malformed blob file compression dictionary");
+      }
+
+      Status s = ReadFromFile(file_reader, read_options, read_offset,
+                              read_size, statistics, &header_slice, &buf,
+                              &aligned_buf);
+      if (s.ok()) {
+        s = header.DecodeCompressionDictFrom(header_slice);
+      }
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
+    uncompression_dict->reset(new UncompressionDict(
+        std::move(header.compression_dict),
+        header.compression == kZSTD ||
+            header.compression == kZSTDNotFinalCompression));
+  }
+
   return Status::OK();
 }
 
@@ -281,11 +328,13 @@ Status BlobFileReader::ReadFromFile(const RandomAccessFileReader* file_reader,
 
 BlobFileReader::BlobFileReader(
     std::unique_ptr<RandomAccessFileReader>&& file_reader, uint64_t file_size,
-    CompressionType compression_type, SystemClock* clock,
-    Statistics* statistics)
+    CompressionType compression_type,
+    std::unique_ptr<UncompressionDict>&& uncompression_dict,
+    SystemClock* clock, Statistics* statistics)
     : file_reader_(std::move(file_reader)),
       file_size_(file_size),
       compression_type_(compression_type),
+      uncompression_dict_(std::move(uncompression_dict)),
       clock_(clock),
       statistics_(statistics) {
   assert(file_reader_);
@@ -374,7 +423,8 @@ Status BlobFileReader::GetBlob(
 
   {
     const Status s = UncompressBlobIfNeeded(
-        value_slice, compression_type, allocator, clock_, statistics_, result);
+        value_slice, compression_type, GetUncompressionDict(), allocator,
+        clock_, statistics_, result);
     if (!s.ok()) {
       return s;
     }
@@ -521,9 +571,9 @@ void BlobFileReader::MultiGetBlob(
 
     // Uncompress blob if needed
     Slice value_slice(record_slice.data() + adjustments[i], req->len);
-    *req->status =
-        UncompressBlobIfNeeded(value_slice, compression_type_, allocator,
-                               clock_, statistics_, &blob_reqs[i].second);
+    *req->status = UncompressBlobIfNeeded(
+        value_slice, compression_type_, GetUncompressionDict(), allocator,
+        clock_, statistics_, &blob_reqs[i].second);
     if (req->status->ok()) {
       total_bytes += record_slice.size();
     }
@@ -580,7 +630,8 @@ Status BlobFileReader::VerifyBlob(const Slice& record_slice,
 
 Status BlobFileReader::UncompressBlobIfNeeded(
     const Slice& value_slice, CompressionType compression_type,
-    MemoryAllocator* allocator, SystemClock* clock, Statistics* statistics,
+    const UncompressionDict& uncompression_dict, MemoryAllocator* allocator,
+    SystemClock* clock, Statistics* statistics,
     std::unique_ptr<BlobContents>* result) {
   assert(result);
 
@@ -591,8 +642,7 @@ Status BlobFileReader::UncompressBlobIfNeeded(
   }
 
   UncompressionContext context(compression_type);
-  UncompressionInfo info(context, UncompressionDict::GetEmptyDict(),
-                         compression_type);
+  UncompressionInfo info(context, uncompression_dict, compression_type);
 
   size_t uncompressed_size = 0;
   constexpr uint32_t compression_format_version = 2;
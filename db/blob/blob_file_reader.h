@@ -13,6 +13,7 @@
 #include "rocksdb/compression_type.h"
 #include "rocksdb/rocksdb_namespace.h"
 #include "util/autovector.h"
+#include "util/compression.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -61,9 +62,16 @@ class BlobFileReader {
 
   uint64_t GetFileSize() const { return file_size_; }
 
+  // The dictionary the blobs are compressed with, empty without one
+  const UncompressionDict& GetUncompressionDict() const {
+    return uncompression_dict_ ? *uncompression_dict_
+                               : UncompressionDict::GetEmptyDict();
+  }
+
  private:
   BlobFileReader(std::unique_ptr<RandomAccessFileReader>&& file_reader,
                  uint64_t file_size, CompressionType compression_type,
+                 std::unique_ptr<UncompressionDict>&& uncompression_dict,
                  SystemClock* clock, Statistics* statistics);
 
   static Status OpenFile(const ImmutableOptions& immutable_options,
@@ -74,10 +82,12 @@ class BlobFileReader {
                          uint64_t* file_size,
                          std::unique_ptr<RandomAccessFileReader>* file_reader);
 
-  static Status ReadHeader(const RandomAccessFileReader* file_reader,
-                           const ReadOptions& read_options,
-                           uint32_t column_family_id, Statistics* statistics,
-                           CompressionType* compression_type);
+  static Status ReadHeader(
+      const RandomAccessFileReader* file_reader,
+      const ReadOptions& read_options, uint32_t column_family_id,
+      uint64_t file_size, Statistics* statistics,
+      CompressionType* compression_type,
+      std::unique_ptr<UncompressionDict>* uncompression_dict);
 
   static Status ReadFooter(const RandomAccessFileReader* file_reader,
                            const ReadOptions& read_options, uint64_t file_size,
@@ -94,16 +104,16 @@ class BlobFileReader {
   static Status VerifyBlob(const Slice& record_slice, const Slice& user_key,
                            uint64_t value_size);
 
-  static Status UncompressBlobIfNeeded(const Slice& value_slice,
-                                       CompressionType compression_type,
-                                       MemoryAllocator* allocator,
-                                       SystemClock* clock,
-                                       Statistics* statistics,
-                                       std::unique_ptr<BlobContents>* result);
+  static Status UncompressBlobIfNeeded(
+      const Slice& value_slice, CompressionType compression_type,
+      const UncompressionDict& uncompression_dict, MemoryAllocator* allocator,
+      SystemClock* clock, Statistics* statistics,
+      std::unique_ptr<BlobContents>* result);
 
   std::unique_ptr<RandomAccessFileReader> file_reader_;
   uint64_t file_size_;
   CompressionType compression_type_;
+  std::unique_ptr<UncompressionDict> uncompression_dict_;
   SystemClock* clock_;
   Statistics* statistics_;
 };
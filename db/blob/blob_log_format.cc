@@ -11,18 +11,30 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+constexpr unsigned char kCompressionDictFlag = 2;
+}  // namespace
+
 void BlobLogHeader::EncodeTo(std::string* dst) {
   assert(dst != nullptr);
+  assert(!has_compression_dict || version >= kVersion2);
   dst->clear();
-  dst->reserve(BlobLogHeader::kSize);
+  dst->reserve(BlobLogHeader::kSize + compression_dict_encoded_size());
   PutFixed32(dst, kMagicNumber);
   PutFixed32(dst, version);
   PutFixed32(dst, column_family_id);
-  unsigned char flags = (has_ttl ? 1 : 0);
+  unsigned char flags =
+      (has_ttl ? 1 : 0) | (has_compression_dict ? kCompressionDictFlag : 0);
   dst->push_back(flags);
   dst->push_back(compression);
   PutFixed64(dst, expiration_range.first);
   PutFixed64(dst, expiration_range.second);
+  if (has_compression_dict) {
+    PutFixed32(dst, static_cast<uint32_t>(compression_dict.size()));
+    dst->append(compression_dict);
+    PutFixed32(dst, crc32c::Mask(crc32c::Value(compression_dict.data(),
+                                               compression_dict.size())));
+  }
 }
 
 Status BlobLogHeader::DecodeFrom(Slice src) {
@@ -42,12 +54,17 @@ Status BlobLogHeader::DecodeFrom(Slice src) {
   if (magic_number != kMagicNumber) {
     return Status::Corruption(kErrorMessage, "Magic number mismatch");
   }
-  if (version != kVersion1) {
+  if (version != kVersion1 && version != kVersion2) {
     return Status::Corruption(kErrorMessage, "Unknown header version");
   }
   flags = src.data()[0];
   compression = static_cast<CompressionType>(src.data()[1]);
   has_ttl = (flags & 1) == 1;
+  has_compression_dict = (flags & kCompressionDictFlag) != 0;
+  if (has_compression_dict && version == kVersion1) {
+    return Status::Corruption(kErrorMessage,
+                              "Compression dictionary in version 1");
+  }
   src.remove_prefix(2);
   if (!GetFixed64(&src, &expiration_range.first) ||
       !GetFixed64(&src, &expiration_range.second)) {
@@ -56,6 +73,32 @@ Status BlobLogHeader::DecodeFrom(Slice src) {
   return Status::OK();
 }
 
+Status BlobLogHeader::DecodeCompressionDictSize(Slice src,
+                                                uint32_t* dict_size) {
+  assert(dict_size != nullptr);
+  if (src.size() != kCompressionDictSizeBytes || !GetFixed32(&src, dict_size)) {
+    return Status::Corruption("Error while decoding blob log header",
+                              "Error decoding compression dictionary size");
+  }
+  return Status::OK();
+}
+
+Status BlobLogHeader::DecodeCompressionDictFrom(Slice src) {
+  const char* kErrorMessage = "Error while decoding blob log header";
+  if (src.size() < sizeof(uint32_t)) {
+    return Status::Corruption(kErrorMessage,
+                              "Unexpected compression dictionary size");
+  }
+  const size_t dict_size = src.size() - sizeof(uint32_t);
+  const uint32_t crc = crc32c::Value(src.data(), dict_size);
+  if (crc32c::Unmask(DecodeFixed32(src.data() + dict_size)) != crc) {
+    return Status::Corruption(kErrorMessage,
+                              "Compression dictionary CRC mismatch");
+  }
+  compression_dict.assign(src.data(), dict_size);
+  return Status::OK();
+}
+
 void BlobLogFooter::EncodeTo(std::string* dst) {
   assert(dst != nullptr);
   dst->clear();
@@ -19,6 +19,7 @@ namespace ROCKSDB_NAMESPACE {
 
 constexpr uint32_t kMagicNumber = 2395959;  // 0x00248f37
 constexpr uint32_t kVersion1 = 1;
+constexpr uint32_t kVersion2 = 2;
 
 using ExpirationRange = std::pair<uint64_t, uint64_t>;
 
@@ -34,14 +35,28 @@ using ExpirationRange = std::pair<uint64_t, uint64_t>;
 //
 // List of flags:
 //   has_ttl: Whether the file contain TTL data.
+//   has_compression_dict: Whether the blobs are compressed with a dictionary,
+//     which then follows the header. Requires version 2.
 //
 // Expiration range in the header is a rough range based on
 // blob_db_options.ttl_range_secs.
+//
+// Format of the compression dictionary (8 bytes + dict size):
+//
+//    +-----------+-----------+----------+
+//    | dict size |   dict    | dict CRC |
+//    +-----------+-----------+----------+
+//    |  Fixed32  | dict size |  Fixed32 |
+//    +-----------+-----------+----------+
+//
+// The dictionary is counted in the total blob bytes of the file, so that
+// the size of the file stays the header, the blob bytes and the footer.
 
 // clang-format on
 
 struct BlobLogHeader {
   static constexpr size_t kSize = 30;
+  static constexpr size_t kCompressionDictSizeBytes = 4;
 
   BlobLogHeader() = default;
   BlobLogHeader(uint32_t _column_family_id, CompressionType _compression,
@@ -56,10 +71,30 @@ struct BlobLogHeader {
   CompressionType compression = kNoCompression;
   bool has_ttl = false;
   ExpirationRange expiration_range;
+  bool has_compression_dict = false;
+  std::string compression_dict;
+
+  // Size of the compression dictionary after the header, 0 without one
+  uint64_t compression_dict_encoded_size() const {
+    return has_compression_dict ? kCompressionDictSizeBytes +
+                                      compression_dict.size() +
+                                      sizeof(uint32_t)
+                                : 0;
+  }
 
+  // Encodes the header followed by the compression dictionary, if any
   void EncodeTo(std::string* dst);
 
+  // Decodes the fixed size part of the header
   Status DecodeFrom(Slice slice);
+
+  // Decodes the dictionary size, the kCompressionDictSizeBytes after the
+  // fixed size part of the header
+  static Status DecodeCompressionDictSize(Slice src, uint32_t* dict_size);
+
+  // Decodes the dictionary and its CRC, the dict size + 4 bytes following
+  // the dictionary size
+  Status DecodeCompressionDictFrom(Slice src);
 };
 
 // clang-format off
@@ -58,7 +58,27 @@ Status BlobLogSequentialReader::ReadHeader(BlobLogHeader* header) {
     return Status::Corruption("EOF reached before file header");
   }
 
-  return header->DecodeFrom(buffer_);
+  s = header->DecodeFrom(buffer_);
+  if (!s.ok() || !header->has_compression_dict) {
+    return s;
+  }
+
+  uint32_t dict_size = 0;
+  s = ReadSlice(BlobLogHeader::kCompressionDictSizeBytes, &buffer_,
+                header_buf_);
+  if (s.ok()) {
+    s = BlobLogHeader::DecodeCompressionDictSize(buffer_, &dict_size);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  std::unique_ptr<char[]> dict_buf(new char[dict_size + sizeof(uint32_t)]);
+  s = ReadSlice(dict_size + sizeof(uint32_t), &buffer_, dict_buf.get());
+  if (s.ok()) {
+    s = header->DecodeCompressionDictFrom(buffer_);
+  }
+  buffer_.clear();
+  return s;
 }
 
 Status BlobLogSequentialReader::ReadRecord(BlobLogRecord* record,
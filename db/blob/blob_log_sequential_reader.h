@@ -46,6 +46,7 @@ class BlobLogSequentialReader {
 
   ~BlobLogSequentialReader();
 
+  // Reads the header, with the compression dictionary following it, if any
   Status ReadHeader(BlobLogHeader* header);
 
   // Read the next record into *record.  Returns true if read
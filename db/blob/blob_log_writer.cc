@@ -56,8 +56,7 @@ Status BlobLogWriter::WriteHeader(BlobLogHeader& header) {
     }
   }
   last_elem_type_ = kEtFileHdr;
-  RecordTick(statistics_, BLOB_DB_BLOB_FILE_BYTES_WRITTEN,
-             BlobLogHeader::kSize);
+  RecordTick(statistics_, BLOB_DB_BLOB_FILE_BYTES_WRITTEN, str.size());
   return s;
 }
 
@@ -0,0 +1,133 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_separation_tuner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "db/version_set.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+int BucketOf(uint64_t size) { return size == 0 ? 0 : FloorLog2(size) + 1; }
+
+uint64_t BucketLowerBound(int bucket) {
+  return bucket == 0 ? 0 : uint64_t{1} << (bucket - 1);
+}
+}  // namespace
+
+void BlobSeparationTuner::ValueSizes::Add(uint64_t size) {
+  const int bucket = BucketOf(size);
+  ++counts_[bucket];
+  bytes_[bucket] += size;
+  ++total_count_;
+}
+
+void BlobSeparationTuner::ValueSizes::Add(const ValueSizes& other) {
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    counts_[bucket] += other.counts_[bucket];
+    bytes_[bucket] += other.bytes_[bucket];
+  }
+  total_count_ += other.total_count_;
+}
+
+void BlobSeparationTuner::ValueSizes::Decay() {
+  total_count_ = 0;
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    counts_[bucket] /= 2;
+    bytes_[bucket] /= 2;
+    total_count_ += counts_[bucket];
+  }
+}
+
+uint64_t BlobSeparationTuner::PickMinBlobSize(const ValueSizes& sizes,
+                                              double write_amp,
+                                              double reads_per_key) {
+  // The bytes written and read for the values of each bucket, if stored in
+  // SST files or in blob files
+  std::array<double, kNumBuckets> in_sst{};
+  std::array<double, kNumBuckets> in_blob{};
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    const uint64_t count = sizes.GetCount(bucket);
+    if (count == 0) {
+      continue;
+    }
+    const double bytes = static_cast<double>(sizes.GetBytes(bucket));
+    const uint64_t avg_size = sizes.GetBytes(bucket) / count;
+    const double read_size = static_cast<double>(
+        std::max(kBlobReadUnit, (avg_size + kBlobReadUnit - 1) /
+                                    kBlobReadUnit * kBlobReadUnit));
+    in_sst[bucket] = write_amp * bytes;
+    in_blob[bucket] =
+        bytes + static_cast<double>(count) *
+                    (write_amp * kBlobIndexSize + reads_per_key * read_size);
+  }
+
+  // Storing no value in blob files first, then the values of the buckets
+  // from the largest. Ties keep the values in SST files.
+  double cost = 0;
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    cost += in_sst[bucket];
+  }
+  double best_cost = cost;
+  uint64_t best = std::numeric_limits<uint64_t>::max();
+  for (int bucket = kNumBuckets - 1; bucket >= 0; --bucket) {
+    if (sizes.GetCount(bucket) == 0) {
+      continue;
+    }
+    cost += in_blob[bucket] - in_sst[bucket];
+    if (cost < best_cost) {
+      best_cost = cost;
+      best = BucketLowerBound(bucket);
+    }
+  }
+  return best;
+}
+
+uint64_t BlobSeparationTuner::GetMinBlobSize(uint64_t min_blob_size) const {
+  return std::max(min_blob_size,
+                  picked_min_blob_size_.load(std::memory_order_relaxed));
+}
+
+void BlobSeparationTuner::RecordValueSizes(const ValueSizes& sizes) {
+  MutexLock l(&mutex_);
+  sizes_.Add(sizes);
+  while (sizes_.GetTotalCount() > kMaxRecordedValues) {
+    sizes_.Decay();
+  }
+}
+
+bool BlobSeparationTuner::Update(const VersionStorageInfo& vstorage,
+                                 double write_amp) {
+  uint64_t num_reads = 0;
+  uint64_t num_entries = 0;
+  for (int level = 0; level < vstorage.num_levels(); ++level) {
+    for (const auto* f : vstorage.LevelFiles(level)) {
+      num_reads += f->stats.num_reads_sampled.load(std::memory_order_relaxed);
+      num_entries += f->num_entries;
+    }
+  }
+  // Until compactions rewrite values, the amplification of their writes is
+  // unknown
+  if (num_entries == 0 || write_amp <= 1) {
+    return false;
+  }
+  const double reads_per_key =
+      static_cast<double>(num_reads) / static_cast<double>(num_entries);
+
+  MutexLock l(&mutex_);
+  if (sizes_.GetTotalCount() == 0) {
+    return false;
+  }
+  const uint64_t picked = PickMinBlobSize(sizes_, write_amp, reads_per_key);
+  return picked_min_blob_size_.exchange(picked, std::memory_order_relaxed) !=
+         picked;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,99 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "port/port.h"
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class VersionStorageInfo;
+
+// Picks the size of the smallest value stored in a blob file by the flushes
+// and compactions of a column family, for
+// AdvancedColumnFamilyOptions::adaptive_min_blob_size. A value stored in an
+// SST file is written once by the flush and again by each compaction, while
+// a value stored in a blob file is written once but costs a blob file read
+// to each lookup. From the sizes of the values written recently, the
+// lookups per key of the table files and the write amplification, the size
+// picked is the one with the fewest bytes written and read.
+//
+// Whether a value is in a blob file is recorded with the value, as a blob
+// index in place of it, so the size picked only matters to the values
+// written from now on.
+//
+// Thread-safe.
+class BlobSeparationTuner {
+ public:
+  // Values by the log2 of their size, bucket 0 holding the empty values and
+  // bucket b > 0 the sizes in [2^(b-1), 2^b)
+  static constexpr int kNumBuckets = 65;
+
+  // The sizes of the values written by a flush or compaction. Not
+  // thread-safe.
+  class ValueSizes {
+   public:
+    void Add(uint64_t size);
+    void Add(const ValueSizes& other);
+    // Halves the counts, for the recent values to weigh more
+    void Decay();
+
+    uint64_t GetCount(int bucket) const { return counts_[bucket]; }
+    uint64_t GetBytes(int bucket) const { return bytes_[bucket]; }
+    uint64_t GetTotalCount() const { return total_count_; }
+
+   private:
+    std::array<uint64_t, kNumBuckets> counts_{};
+    std::array<uint64_t, kNumBuckets> bytes_{};
+    uint64_t total_count_ = 0;
+  };
+
+  // The estimated size of the blob index stored in an SST file in place of
+  // a value
+  static constexpr uint64_t kBlobIndexSize = 16;
+  // Reading a value from a blob file costs at least a page
+  static constexpr uint64_t kBlobReadUnit = 4096;
+
+  // Returns the size of the smallest value to store in a blob file, among
+  // the lower bounds of the buckets of `sizes`, for values rewritten
+  // `write_amp` times and looked up `reads_per_key` times on average.
+  // Returns 0 if no value should stay in SST files, and the maximum of
+  // uint64_t if none should go to blob files.
+  static uint64_t PickMinBlobSize(const ValueSizes& sizes, double write_amp,
+                                  double reads_per_key);
+
+  BlobSeparationTuner() = default;
+
+  BlobSeparationTuner(const BlobSeparationTuner&) = delete;
+  BlobSeparationTuner& operator=(const BlobSeparationTuner&) = delete;
+
+  // The size picked, or `min_blob_size` if larger or nothing was picked yet
+  uint64_t GetMinBlobSize(uint64_t min_blob_size) const;
+
+  // Records the sizes of the values written by a flush or compaction
+  void RecordValueSizes(const ValueSizes& sizes);
+
+  // Picks the size again from the lookups per key of the table files of
+  // `vstorage` and the write amplification of the column family, once
+  // compactions made it more than 1. Returns whether it changed.
+  // REQUIRES: DB mutex held
+  bool Update(const VersionStorageInfo& vstorage, double write_amp);
+
+ private:
+  // The values recorded are halved beyond this many
+  static constexpr uint64_t kMaxRecordedValues = uint64_t{1} << 20;
+
+  port::Mutex mutex_;
+  ValueSizes sizes_;
+  // 0 until picked, as 0 does not raise any min_blob_size
+  std::atomic<uint64_t> picked_min_blob_size_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,81 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob/blob_separation_tuner.h"
+
+#include <limits>
+
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+}  // namespace
+
+TEST(BlobSeparationTunerTest, ValueSizes) {
+  BlobSeparationTuner::ValueSizes sizes;
+  sizes.Add(0);
+  sizes.Add(1);
+  sizes.Add(100);
+  sizes.Add(127);
+  sizes.Add(128);
+  ASSERT_EQ(sizes.GetTotalCount(), 5);
+  ASSERT_EQ(sizes.GetCount(0), 1);
+  ASSERT_EQ(sizes.GetCount(1), 1);
+  // [64, 128)
+  ASSERT_EQ(sizes.GetCount(7), 2);
+  ASSERT_EQ(sizes.GetBytes(7), 227);
+  ASSERT_EQ(sizes.GetCount(8), 1);
+
+  BlobSeparationTuner::ValueSizes more;
+  more.Add(sizes);
+  more.Add(sizes);
+  ASSERT_EQ(more.GetTotalCount(), 10);
+  ASSERT_EQ(more.GetBytes(7), 454);
+  more.Decay();
+  ASSERT_EQ(more.GetTotalCount(), 5);
+  ASSERT_EQ(more.GetCount(7), 2);
+  ASSERT_EQ(more.GetBytes(7), 227);
+}
+
+TEST(BlobSeparationTunerTest, PickMinBlobSize) {
+  BlobSeparationTuner::ValueSizes sizes;
+  ASSERT_EQ(BlobSeparationTuner::PickMinBlobSize(sizes, 10, 0), kNone);
+
+  for (int i = 0; i < 100; ++i) {
+    sizes.Add(100);
+    sizes.Add(10000);
+  }
+  // Without reads, the values rewritten by compactions are better in blob
+  // files, unless not much larger than a blob index
+  ASSERT_EQ(BlobSeparationTuner::PickMinBlobSize(sizes, 10, 0), 64);
+  // Without compactions, storing values in blob files saves nothing
+  ASSERT_EQ(BlobSeparationTuner::PickMinBlobSize(sizes, 1, 0), kNone);
+  // A read of a small value from a blob file costs more than rewriting it
+  ASSERT_EQ(BlobSeparationTuner::PickMinBlobSize(sizes, 10, 1), 8192);
+  // Values read often are better in SST files, whatever their size
+  ASSERT_EQ(BlobSeparationTuner::PickMinBlobSize(sizes, 10, 100), kNone);
+
+  // Empty values are never better in blob files
+  BlobSeparationTuner::ValueSizes empty;
+  empty.Add(0);
+  ASSERT_EQ(BlobSeparationTuner::PickMinBlobSize(empty, 10, 0), kNone);
+}
+
+TEST(BlobSeparationTunerTest, GetMinBlobSize) {
+  BlobSeparationTuner tuner;
+  // Nothing picked yet
+  ASSERT_EQ(tuner.GetMinBlobSize(0), 0);
+  ASSERT_EQ(tuner.GetMinBlobSize(1024), 1024);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1698,6 +1698,198 @@ TEST_F(DBBlobBasicTest, DynamicallyWarmCacheDuringFlush) {
   EXPECT_EQ(0, options.statistics->getTickerCount(BLOB_DB_CACHE_ADD));
 }
 
+TEST_F(DBBlobBasicTest, SkipCachingBlobsOfGarbageFiles) {
+  Options options = GetDefaultOptions();
+
+  LRUCacheOptions co;
+  co.capacity = 1 << 25;
+  co.num_shard_bits = 2;
+  co.metadata_charge_policy = kDontChargeCacheMetadata;
+  options.blob_cache = NewLRUCache(co);
+
+  options.enable_blob_files = true;
+  options.disable_auto_compactions = true;
+  options.blob_cache_max_garbage_ratio = 0.25;
+  options.statistics = CreateDBStatistics();
+
+  DestroyAndReopen(options);
+
+  const std::string value(100, 'a');
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_OK(Put("key" + std::to_string(i), value));
+  }
+  ASSERT_OK(Flush());
+
+  // No garbage yet
+  ASSERT_EQ(value, Get("key0"));
+  ASSERT_EQ(1, options.statistics->getAndResetTickerCount(BLOB_DB_CACHE_ADD));
+
+  // Half of the blob file becomes garbage
+  ASSERT_OK(Delete("key0"));
+  ASSERT_OK(Delete("key1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  options.statistics->Reset().PermitUncheckedError();
+
+  ASSERT_EQ(value, Get("key2"));
+  std::array<Slice, 2> keys{{"key2", "key3"}};
+  std::array<PinnableSlice, 2> values;
+  std::array<Status, 2> statuses;
+  db_->MultiGet(ReadOptions(), db_->DefaultColumnFamily(), keys.size(),
+                keys.data(), values.data(), statuses.data());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_OK(statuses[i]);
+    ASSERT_EQ(value, values[i]);
+  }
+  ASSERT_EQ(0, options.statistics->getAndResetTickerCount(BLOB_DB_CACHE_ADD));
+  ASSERT_EQ(3, options.statistics->getAndResetTickerCount(BLOB_DB_CACHE_MISS));
+
+  ASSERT_OK(dbfull()->SetOptions({{"blob_cache_max_garbage_ratio", "0.5"}}));
+  ASSERT_EQ(value, Get("key2"));
+  ASSERT_EQ(1, options.statistics->getAndResetTickerCount(BLOB_DB_CACHE_ADD));
+
+  ASSERT_TRUE(dbfull()
+                  ->SetOptions({{"blob_cache_max_garbage_ratio", "1.5"}})
+                  .IsInvalidArgument());
+}
+
+TEST_F(DBBlobBasicTest, IterateBlobsWithReadahead) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+
+  Reopen(options);
+
+  constexpr int kNumBlobs = 10;
+  const std::string value(100, 'a');
+  for (int i = 0; i < kNumBlobs; ++i) {
+    ASSERT_OK(Put("key" + std::to_string(i), value));
+  }
+  ASSERT_OK(Flush());
+
+  SetPerfLevel(kEnableCount);
+  for (size_t readahead_size : {size_t{0}, size_t{64 << 10}}) {
+    ReadOptions read_options;
+    read_options.blob_readahead_size = readahead_size;
+    get_perf_context()->Reset();
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(iter->value(), value);
+      ++i;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, kNumBlobs);
+
+    // Reads served by the readahead buffer are not counted
+    ASSERT_EQ(get_perf_context()->blob_read_count,
+              readahead_size == 0 ? kNumBlobs : 0);
+  }
+  SetPerfLevel(kDisable);
+}
+
+TEST_F(DBBlobBasicTest, IterateBlobsInBatches) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+
+  Reopen(options);
+
+  constexpr int kNumBlobs = 10;
+  for (int i = 0; i < kNumBlobs; ++i) {
+    ASSERT_OK(Put("key" + std::to_string(i), "blob" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  // Not blobs anymore
+  ASSERT_OK(Put("key3", "value3"));
+  ASSERT_OK(Delete("key5"));
+
+  int num_reads = 0;
+  int num_multi_reads = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::GetBlob:ReadFromFile", [&](void*) { ++num_reads; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::MultiGetBlob:ReadFromFile",
+      [&](void*) { ++num_multi_reads; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ReadOptions read_options;
+  read_options.blob_batch_size = 4;
+  std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+  std::vector<std::string> values;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    values.push_back(iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(values,
+            std::vector<std::string>({"blob0", "blob1", "blob2", "value3",
+                                      "blob4", "blob6", "blob7", "blob8",
+                                      "blob9"}));
+  // The blobs of key0 to key4, then of key6 to key9
+  ASSERT_EQ(num_reads, 0);
+  ASSERT_EQ(num_multi_reads, 2);
+
+  // Going back reads the blobs one by one
+  iter->SeekToLast();
+  ASSERT_TRUE(iter->Valid());
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(iter->value(), "blob8");
+  ASSERT_EQ(num_reads, 2);
+  ASSERT_EQ(num_multi_reads, 2);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBBlobBasicTest, CompressionDict) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  if (ZSTD_Supported()) {
+    options.blob_compression_type = kZSTD;
+  } else if (LZ4_Supported()) {
+    options.blob_compression_type = kLZ4Compression;
+  } else {
+    ROCKSDB_GTEST_BYPASS("Test requires ZSTD or LZ4 support");
+    return;
+  }
+  options.blob_compression_max_dict_bytes = 256;
+
+  Reopen(options);
+
+  constexpr int kNumBlobs = 300;
+  auto get_value = [](int i) {
+    return "{\"id\": " + std::to_string(i) +
+           ", \"name\": \"user" + std::to_string(i) +
+           "\", \"tags\": [\"alpha\", \"beta\", \"gamma\"], "
+           "\"address\": {\"street\": \"Main Street\", \"city\": "
+           "\"Springfield\"}}";
+  };
+  for (int i = 0; i < kNumBlobs; ++i) {
+    ASSERT_OK(Put(Key(i), get_value(i)));
+  }
+  ASSERT_OK(Flush());
+
+  // The first file is cut short once the samples are taken
+  VersionSet* const versions = dbfull()->GetVersionSet();
+  const VersionStorageInfo* const storage_info =
+      versions->GetColumnFamilySet()->GetDefault()->current()->storage_info();
+  const auto& blob_files = storage_info->GetBlobFiles();
+  ASSERT_EQ(blob_files.size(), 2);
+  for (const auto& meta : blob_files) {
+    uint64_t file_size = 0;
+    ASSERT_OK(env_->GetFileSize(
+        BlobFileName(dbname_, meta->GetBlobFileNumber()), &file_size));
+    ASSERT_EQ(file_size, meta->GetBlobFileSize());
+  }
+
+  // The dictionary is read back from the file
+  Reopen(options);
+  for (int i = 0; i < kNumBlobs; ++i) {
+    ASSERT_EQ(Get(Key(i)), get_value(i));
+  }
+}
+
 TEST_F(DBBlobBasicTest, WarmCacheWithBlobsSecondary) {
   CompressedSecondaryCacheOptions secondary_cache_opts;
   secondary_cache_opts.capacity = 1 << 20;
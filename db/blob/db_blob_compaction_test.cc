@@ -775,6 +775,123 @@ TEST_F(DBBlobCompactionTest, CompactionReadaheadGarbageCollection) {
   Close();
 }
 
+TEST_F(DBBlobCompactionTest, GarbageCollectBlobFiles) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.disable_auto_compactions = true;
+
+  Reopen(options);
+
+  // Blob file 1 with four blobs, blob file 2 with two
+  ASSERT_OK(Put("k1", "v1"));
+  ASSERT_OK(Put("k2", "v2"));
+  ASSERT_OK(Put("k3", "v3"));
+  ASSERT_OK(Put("k4", "v4"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("k1", "v5"));
+  ASSERT_OK(Put("k2", "v6"));
+  ASSERT_OK(Flush());
+
+  // Half of blob file 1 becomes garbage, with its live blobs staying there
+  constexpr Slice* begin = nullptr;
+  constexpr Slice* end = nullptr;
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), begin, end));
+
+  auto get_blob_files = [&]() {
+    ColumnFamilyMetaData cf_meta;
+    db_->GetColumnFamilyMetaData(&cf_meta);
+    return cf_meta.blob_files;
+  };
+  std::vector<BlobMetaData> blob_files = get_blob_files();
+  ASSERT_EQ(blob_files.size(), 2U);
+  const uint64_t oldest_blob_file_number = blob_files[0].blob_file_number;
+  ASSERT_EQ(blob_files[0].garbage_blob_count, 2U);
+
+  GarbageCollectBlobFilesOptions gc_options;
+  gc_options.garbage_ratio_threshold = 0.6;
+  ASSERT_OK(
+      db_->GarbageCollectBlobFiles(gc_options, db_->DefaultColumnFamily()));
+  ASSERT_EQ(get_blob_files().size(), 2U);
+
+  gc_options.garbage_ratio_threshold = 0.5;
+  gc_options.rate_limiter.reset(NewGenericRateLimiter(1 << 30));
+  ASSERT_OK(
+      db_->GarbageCollectBlobFiles(gc_options, db_->DefaultColumnFamily()));
+  ASSERT_GT(gc_options.rate_limiter->GetTotalBytesThrough(Env::IO_LOW), 0);
+
+  // The live blobs of blob file 1 were moved to a new blob file, with blob
+  // file 2 left as is
+  blob_files = get_blob_files();
+  ASSERT_EQ(blob_files.size(), 2U);
+  for (const auto& blob_file : blob_files) {
+    ASSERT_NE(blob_file.blob_file_number, oldest_blob_file_number);
+    ASSERT_EQ(blob_file.garbage_blob_count, 0U);
+    ASSERT_EQ(blob_file.total_blob_count, 2U);
+  }
+  ASSERT_EQ(Get("k1"), "v5");
+  ASSERT_EQ(Get("k2"), "v6");
+  ASSERT_EQ(Get("k3"), "v3");
+  ASSERT_EQ(Get("k4"), "v4");
+
+  Close();
+}
+
+TEST_F(DBBlobCompactionTest, AdaptiveMinBlobSize) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.adaptive_min_blob_size = true;
+  options.min_blob_size = 0;
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  options.disable_auto_compactions = true;
+
+  Reopen(options);
+
+  constexpr int kNumKeys = 100;
+  const std::string value(1000, 'v');
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), value));
+  }
+  ASSERT_OK(Flush());
+  // Nothing is picked before values are rewritten by compactions
+  ASSERT_EQ(GetBlobFileNumbers().size(), 1);
+
+  // Rewriting the values, rather than moving the file
+  CompactRangeOptions compact_options;
+  compact_options.bottommost_level_compaction =
+      BottommostLevelCompaction::kForce;
+  constexpr Slice* begin = nullptr;
+  constexpr Slice* end = nullptr;
+  ASSERT_OK(db_->CompactRange(compact_options, begin, end));
+  // Values never read stay in blob files
+  ASSERT_EQ(GetBlobFileNumbers().size(), 1);
+  auto* cfd = static_cast_with_check<ColumnFamilyHandleImpl>(
+                  db_->DefaultColumnFamily())
+                  ->cfd();
+  ASSERT_EQ(cfd->blob_separation_tuner()->GetMinBlobSize(0), 512);
+
+  // Values read often are better in SST files, which the next change to the
+  // table files picks up. Reads are sampled, so many of them make it all
+  // but certain.
+  for (int i = 0; i < 200 * kNumKeys; ++i) {
+    ASSERT_EQ(Get(Key(i % kNumKeys)), value);
+  }
+  ASSERT_OK(Put("small", "v"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(cfd->blob_separation_tuner()->GetMinBlobSize(0),
+            std::numeric_limits<uint64_t>::max());
+
+  // Garbage collection moves the values back into SST files
+  ASSERT_OK(db_->CompactRange(compact_options, begin, end));
+  ASSERT_TRUE(GetBlobFileNumbers().empty());
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ(Get(Key(i)), value);
+  }
+
+  Close();
+}
+
 TEST_F(DBBlobCompactionTest, CompactionReadaheadFilter) {
   Options options = GetDefaultOptions();
 
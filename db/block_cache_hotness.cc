@@ -0,0 +1,163 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/block_cache_hotness.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "cache/cache_key.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint32_t kFormatVersion = 1;
+
+// The part of a cache key varying with the offset in the file, see
+// OffsetableCacheKey::WithOffset()
+uint64_t OffsetPart(const Slice& key) {
+  uint64_t result;
+  std::memcpy(&result, key.data() + OffsetableCacheKey::kCommonPrefixSize,
+              sizeof(result));
+  return result;
+}
+}  // namespace
+
+void BlockCacheHotness::Collect(Cache* block_cache,
+                                const std::vector<TableFile>& table_files) {
+  // By cache key prefix, the index in `files` and the offset part of the
+  // file's cache key for offset 0
+  std::unordered_map<std::string, std::pair<size_t, uint64_t>> by_prefix;
+  const size_t first = files.size();
+  for (const TableFile& table_file : table_files) {
+    if (table_file.unique_id == kNullUniqueId64x2) {
+      continue;
+    }
+    UniqueId64x2 unique_id = table_file.unique_id;
+    OffsetableCacheKey base =
+        OffsetableCacheKey::FromInternalUniqueId(&unique_id);
+    by_prefix[base.CommonPrefixSlice().ToString()] = {
+        files.size(), OffsetPart(base.WithOffset(0).AsSlice())};
+    files.emplace_back();
+    files.back().file_number = table_file.file_number;
+  }
+  if (by_prefix.empty()) {
+    return;
+  }
+
+  std::string prefix;
+  block_cache->ApplyToAllEntries(
+      [&](const Slice& key, Cache::ObjectPtr /*value*/, size_t /*charge*/,
+          const Cache::CacheItemHelper* helper) {
+        if (helper == nullptr || key.size() != kCacheKeySize) {
+          return;
+        }
+        prefix.assign(key.data(), OffsetableCacheKey::kCommonPrefixSize);
+        auto it = by_prefix.find(prefix);
+        if (it == by_prefix.end()) {
+          return;
+        }
+        FileBlocks& file = files[it->second.first];
+        switch (helper->role) {
+          case CacheEntryRole::kDataBlock:
+            // See BlockBasedTable::GetCacheKey()
+            file.data_block_offsets.push_back(
+                (OffsetPart(key) ^ it->second.second) << 2);
+            break;
+          case CacheEntryRole::kIndexBlock:
+          case CacheEntryRole::kFilterBlock:
+          case CacheEntryRole::kFilterMetaBlock:
+            file.num_meta_blocks++;
+            break;
+          default:
+            break;
+        }
+      },
+      {});
+
+  for (size_t i = first; i < files.size(); ++i) {
+    std::sort(files[i].data_block_offsets.begin(),
+              files[i].data_block_offsets.end());
+  }
+  files.erase(std::remove_if(files.begin() + first, files.end(),
+                             [](const FileBlocks& file) {
+                               return file.num_meta_blocks == 0 &&
+                                      file.data_block_offsets.empty();
+                             }),
+              files.end());
+  std::stable_sort(files.begin(), files.end(),
+                   [](const FileBlocks& a, const FileBlocks& b) {
+                     return a.num_meta_blocks + a.data_block_offsets.size() >
+                            b.num_meta_blocks + b.data_block_offsets.size();
+                   });
+}
+
+void BlockCacheHotness::EncodeTo(std::string* dst) const {
+  const size_t start = dst->size();
+  PutVarint32(dst, kFormatVersion);
+  PutVarint64(dst, files.size());
+  for (const FileBlocks& file : files) {
+    PutVarint64(dst, file.file_number);
+    PutVarint32(dst, file.num_meta_blocks);
+    PutVarint64(dst, file.data_block_offsets.size());
+    uint64_t last_offset = 0;
+    for (uint64_t offset : file.data_block_offsets) {
+      PutVarint64(dst, offset - last_offset);
+      last_offset = offset;
+    }
+  }
+  PutFixed32(dst, crc32c::Mask(crc32c::Value(dst->data() + start,
+                                             dst->size() - start)));
+}
+
+Status BlockCacheHotness::DecodeFrom(const Slice& src) {
+  files.clear();
+  if (src.size() < sizeof(uint32_t)) {
+    return Status::Corruption("Block cache hotness too short");
+  }
+  Slice input(src.data(), src.size() - sizeof(uint32_t));
+  uint32_t expected = crc32c::Unmask(DecodeFixed32(src.data() + input.size()));
+  if (crc32c::Value(input.data(), input.size()) != expected) {
+    return Status::Corruption("Block cache hotness checksum mismatch");
+  }
+  uint32_t format_version = 0;
+  uint64_t num_files = 0;
+  if (!GetVarint32(&input, &format_version) ||
+      !GetVarint64(&input, &num_files)) {
+    return Status::Corruption("Bad block cache hotness");
+  }
+  if (format_version != kFormatVersion) {
+    return Status::NotSupported("Unknown block cache hotness format version");
+  }
+  for (uint64_t i = 0; i < num_files; ++i) {
+    FileBlocks file;
+    uint64_t num_data_blocks = 0;
+    if (!GetVarint64(&input, &file.file_number) ||
+        !GetVarint32(&input, &file.num_meta_blocks) ||
+        !GetVarint64(&input, &num_data_blocks) ||
+        num_data_blocks > input.size()) {
+      files.clear();
+      return Status::Corruption("Bad block cache hotness");
+    }
+    file.data_block_offsets.reserve(static_cast<size_t>(num_data_blocks));
+    uint64_t offset = 0;
+    for (uint64_t j = 0; j < num_data_blocks; ++j) {
+      uint64_t delta;
+      if (!GetVarint64(&input, &delta)) {
+        files.clear();
+        return Status::Corruption("Bad block cache hotness");
+      }
+      offset += delta;
+      file.data_block_offsets.push_back(offset);
+    }
+    files.push_back(std::move(file));
+  }
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
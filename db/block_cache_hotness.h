@@ -0,0 +1,51 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "rocksdb/advanced_cache.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/unique_id_impl.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Which blocks of which table files were in the block cache, so that the
+// block cache can be warmed up after the DB is reopened, see
+// DBOptions::block_cache_hotness_persist_period_sec. Blocks are found by the
+// cache keys derived from the unique ids of the files, so only the locations
+// of the blocks are recorded, not their contents.
+struct BlockCacheHotness {
+  struct TableFile {
+    uint64_t file_number;
+    UniqueId64x2 unique_id;
+  };
+
+  struct FileBlocks {
+    uint64_t file_number = 0;
+    // Number of index and filter blocks (including partitions) in the cache
+    uint32_t num_meta_blocks = 0;
+    // Offsets of the data blocks in the cache, ascending. They are rounded
+    // down to a multiple of 4, like in cache keys.
+    std::vector<uint64_t> data_block_offsets;
+  };
+
+  // Files with any block in the cache, those with the most first
+  std::vector<FileBlocks> files;
+
+  // Adds the files of `table_files` with blocks in `block_cache`. Files
+  // without a unique id are skipped.
+  void Collect(Cache* block_cache, const std::vector<TableFile>& table_files);
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+}  // namespace ROCKSDB_NAMESPACE
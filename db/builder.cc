@@ -74,7 +74,8 @@ Status BuildTable(
     const std::string* full_history_ts_low,
     BlobFileCompletionCallback* blob_callback, Version* version,
     uint64_t* num_input_entries, uint64_t* memtable_payload_bytes,
-    uint64_t* memtable_garbage_bytes) {
+    uint64_t* memtable_garbage_bytes,
+    BlobSeparationTuner* blob_separation_tuner) {
   assert((tboptions.column_family_id ==
           TablePropertiesCollectorFactory::Context::kUnknownColumnFamily) ==
          tboptions.column_family_name.empty());
@@ -166,8 +167,10 @@ Status BuildTable(
       FileTypeSet tmp_set = ioptions.checksum_handoff_file_types;
       file->SetIOPriority(io_priority);
       file->SetWriteLifeTimeHint(write_hint);
+      FileOptions fo_copy = file_options;
+      fo_copy.write_behind = ioptions.table_file_write_behind;
       file_writer.reset(new WritableFileWriter(
-          std::move(file), fname, file_options, ioptions.clock, io_tracer,
+          std::move(file), fname, fo_copy, ioptions.clock, io_tracer,
           ioptions.stats, ioptions.listeners,
           ioptions.file_checksum_gen_factory.get(),
           tmp_set.Contains(FileType::kTableFile), false));
@@ -191,7 +194,8 @@ Status BuildTable(
                   tboptions.db_id, tboptions.db_session_id, job_id,
                   tboptions.column_family_id, tboptions.column_family_name,
                   io_priority, write_hint, io_tracer, blob_callback,
-                  blob_creation_reason, &blob_file_paths, blob_file_additions)
+                  blob_creation_reason, &blob_file_paths, blob_file_additions,
+                  blob_separation_tuner)
             : nullptr);
 
     const std::atomic<bool> kManualCompactionCanceledFalse{false};
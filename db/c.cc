@@ -260,6 +260,11 @@ struct rocksdb_perfcontext_t {
 struct rocksdb_pinnableslice_t {
   PinnableSlice rep;
 };
+struct rocksdb_multiget_results_t {
+  std::vector<Slice> keys;
+  std::vector<PinnableSlice> values;
+  std::vector<Status> statuses;
+};
 struct rocksdb_transactiondb_options_t {
   TransactionDBOptions rep;
 };
@@ -1543,6 +1548,64 @@ void rocksdb_batched_multi_get_cf(rocksdb_t* db,
   delete[] statuses;
 }
 
+rocksdb_multiget_results_t* rocksdb_multiget_results_create() {
+  return new rocksdb_multiget_results_t;
+}
+
+void rocksdb_multiget_results_destroy(rocksdb_multiget_results_t* results) {
+  delete results;
+}
+
+void rocksdb_multiget_results_clear(rocksdb_multiget_results_t* results) {
+  for (auto& value : results->values) {
+    value.Reset();
+  }
+  results->statuses.clear();
+}
+
+void rocksdb_batched_multi_get_cf_into(
+    rocksdb_t* db, const rocksdb_readoptions_t* options,
+    rocksdb_column_family_handle_t* column_family, size_t num_keys,
+    const char* keys, const size_t* keys_sizes,
+    rocksdb_multiget_results_t* results, unsigned char sorted_input) {
+  rocksdb_multiget_results_clear(results);
+
+  results->keys.clear();
+  size_t offset = 0;
+  for (size_t i = 0; i < num_keys; ++i) {
+    results->keys.emplace_back(keys + offset, keys_sizes[i]);
+    offset += keys_sizes[i];
+  }
+  results->values.resize(num_keys);
+  results->statuses.resize(num_keys);
+
+  db->rep->MultiGet(options->rep, column_family->rep, num_keys,
+                    results->keys.data(), results->values.data(),
+                    results->statuses.data(), sorted_input);
+}
+
+size_t rocksdb_multiget_results_count(
+    const rocksdb_multiget_results_t* results) {
+  return results->statuses.size();
+}
+
+const char* rocksdb_multiget_results_value(
+    const rocksdb_multiget_results_t* results, size_t i, size_t* vlen) {
+  if (i >= results->statuses.size() || !results->statuses[i].ok()) {
+    *vlen = 0;
+    return nullptr;
+  }
+  *vlen = results->values[i].size();
+  return results->values[i].data();
+}
+
+void rocksdb_multiget_results_error(const rocksdb_multiget_results_t* results,
+                                    size_t i, char** errptr) {
+  if (i < results->statuses.size() && !results->statuses[i].IsNotFound()) {
+    SaveError(errptr, results->statuses[i]);
+  }
+}
+
 unsigned char rocksdb_key_may_exist(rocksdb_t* db,
                                     const rocksdb_readoptions_t* options,
                                     const char* key, size_t key_len,
@@ -1954,6 +2017,13 @@ rocksdb_writebatch_t* rocksdb_writebatch_create_from(const char* rep,
   return b;
 }
 
+rocksdb_writebatch_t* rocksdb_writebatch_create_with_reserved_bytes(
+    size_t reserved_bytes) {
+  rocksdb_writebatch_t* b = new rocksdb_writebatch_t;
+  b->rep = WriteBatch(reserved_bytes);
+  return b;
+}
+
 void rocksdb_writebatch_destroy(rocksdb_writebatch_t* b) { delete b; }
 
 void rocksdb_writebatch_clear(rocksdb_writebatch_t* b) { b->rep.Clear(); }
@@ -1980,6 +2050,29 @@ void rocksdb_writebatch_put_cf_with_ts(
              Slice(val, vlen));
 }
 
+void rocksdb_writebatch_put_many(rocksdb_writebatch_t* b, size_t num_records,
+                                 const char* keys, const size_t* keys_sizes,
+                                 const char* values,
+                                 const size_t* values_sizes) {
+  for (size_t i = 0; i < num_records; ++i) {
+    b->rep.Put(Slice(keys, keys_sizes[i]), Slice(values, values_sizes[i]));
+    keys += keys_sizes[i];
+    values += values_sizes[i];
+  }
+}
+
+void rocksdb_writebatch_put_many_cf(
+    rocksdb_writebatch_t* b, rocksdb_column_family_handle_t* column_family,
+    size_t num_records, const char* keys, const size_t* keys_sizes,
+    const char* values, const size_t* values_sizes) {
+  for (size_t i = 0; i < num_records; ++i) {
+    b->rep.Put(column_family->rep, Slice(keys, keys_sizes[i]),
+               Slice(values, values_sizes[i]));
+    keys += keys_sizes[i];
+    values += values_sizes[i];
+  }
+}
+
 void rocksdb_writebatch_putv(rocksdb_writebatch_t* b, int num_keys,
                              const char* const* keys_list,
                              const size_t* keys_list_sizes, int num_values,
@@ -2067,6 +2160,24 @@ void rocksdb_writebatch_delete(rocksdb_writebatch_t* b, const char* key,
   b->rep.Delete(Slice(key, klen));
 }
 
+void rocksdb_writebatch_delete_many(rocksdb_writebatch_t* b, size_t num_keys,
+                                    const char* keys,
+                                    const size_t* keys_sizes) {
+  for (size_t i = 0; i < num_keys; ++i) {
+    b->rep.Delete(Slice(keys, keys_sizes[i]));
+    keys += keys_sizes[i];
+  }
+}
+
+void rocksdb_writebatch_delete_many_cf(
+    rocksdb_writebatch_t* b, rocksdb_column_family_handle_t* column_family,
+    size_t num_keys, const char* keys, const size_t* keys_sizes) {
+  for (size_t i = 0; i < num_keys; ++i) {
+    b->rep.Delete(column_family->rep, Slice(keys, keys_sizes[i]));
+    keys += keys_sizes[i];
+  }
+}
+
 void rocksdb_writebatch_singledelete(rocksdb_writebatch_t* b, const char* key,
                                      size_t klen) {
   b->rep.SingleDelete(Slice(key, klen));
@@ -1008,6 +1008,35 @@ int main(int argc, char** argv) {
     rocksdb_writebatch_destroy(wb);
   }
 
+  StartPhase("writebatch_many");
+  {
+    rocksdb_writebatch_t* wb =
+        rocksdb_writebatch_create_with_reserved_bytes(1024);
+    const char* keys = "m1m22m333";
+    const size_t k_sizes[3] = {2, 3, 4};
+    const char* values = "abbccc";
+    const size_t v_sizes[3] = {1, 2, 3};
+    rocksdb_writebatch_put_many(wb, 3, keys, k_sizes, values, v_sizes);
+    CheckCondition(rocksdb_writebatch_count(wb) == 3);
+    rocksdb_write(db, woptions, wb, &err);
+    CheckNoError(err);
+    CheckGet(db, roptions, "m1", "a");
+    CheckGet(db, roptions, "m22", "bb");
+    CheckGet(db, roptions, "m333", "ccc");
+    rocksdb_writebatch_clear(wb);
+    rocksdb_writebatch_delete_many(wb, 2, keys, k_sizes);
+    rocksdb_write(db, woptions, wb, &err);
+    CheckNoError(err);
+    CheckGet(db, roptions, "m1", NULL);
+    CheckGet(db, roptions, "m22", NULL);
+    CheckGet(db, roptions, "m333", "ccc");
+    rocksdb_writebatch_clear(wb);
+    rocksdb_writebatch_delete_many(wb, 3, keys, k_sizes);
+    rocksdb_write(db, woptions, wb, &err);
+    CheckNoError(err);
+    rocksdb_writebatch_destroy(wb);
+  }
+
   StartPhase("writebatch_savepoint");
   {
     rocksdb_writebatch_t* wb = rocksdb_writebatch_create();
@@ -1635,6 +1664,32 @@ int main(int argc, char** argv) {
       }
     }
 
+    {
+      const char* batched_keys = "boxbuffbarfooxxbox";
+      const size_t batched_keys_sizes[4] = {3, 4, 8, 3};
+      const char* expected_value[4] = {"c", "rocksdb", NULL, "c"};
+      rocksdb_multiget_results_t* results = rocksdb_multiget_results_create();
+      const char* val;
+      size_t val_len;
+      int round;
+      // The results are reused by the second round
+      for (round = 0; round < 2; ++round) {
+        rocksdb_batched_multi_get_cf_into(db, roptions, handles[1], 4,
+                                          batched_keys, batched_keys_sizes,
+                                          results, 0);
+        CheckCondition(rocksdb_multiget_results_count(results) == 4);
+        for (i = 0; i < 4; ++i) {
+          rocksdb_multiget_results_error(results, i, &err);
+          CheckNoError(err);
+          val = rocksdb_multiget_results_value(results, i, &val_len);
+          CheckEqual(expected_value[i], val, val_len);
+        }
+      }
+      rocksdb_multiget_results_clear(results);
+      CheckCondition(rocksdb_multiget_results_count(results) == 0);
+      rocksdb_multiget_results_destroy(results);
+    }
+
     {
       unsigned char value_found = 0;
 
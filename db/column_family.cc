@@ -14,6 +14,7 @@
 #include <limits>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "db/blob/blob_file_cache.h"
@@ -37,6 +38,7 @@
 #include "rocksdb/convenience.h"
 #include "rocksdb/table.h"
 #include "table/merging_iterator.h"
+#include "test_util/sync_point.h"
 #include "util/autovector.h"
 #include "util/cast_util.h"
 #include "util/compression.h"
@@ -457,6 +459,17 @@ SuperVersion* SuperVersion::Ref() {
   return this;
 }
 
+bool SuperVersion::TryRef() {
+  uint32_t current_refs = refs.load(std::memory_order_relaxed);
+  while (current_refs > 0) {
+    if (refs.compare_exchange_weak(current_refs, current_refs + 1,
+                                   std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool SuperVersion::Unref() {
   // fetch_sub returns the previous value of ref
   uint32_t previous_refs = refs.fetch_sub(1);
@@ -466,6 +479,9 @@ bool SuperVersion::Unref() {
 
 void SuperVersion::Cleanup() {
   assert(refs.load(std::memory_order_relaxed) == 0);
+  // This is no longer the published SuperVersion, but a reader may still be
+  // about to find that it cannot reference it
+  cfd->WaitForSuperVersionAcquirers();
   // Since this SuperVersion object is being deleted,
   // decrement reference to the immutable MemtableList
   // this SV object was pointing to.
@@ -551,6 +567,8 @@ ColumnFamilyData::ColumnFamilyData(
            ioptions_.max_write_buffer_number_to_maintain,
            ioptions_.max_write_buffer_size_to_maintain),
       super_version_(nullptr),
+      published_super_version_(nullptr),
+      super_version_acquirers_(0),
       super_version_number_(0),
       local_sv_(new ThreadLocalPtr(&SuperVersionUnrefHandle)),
       next_(nullptr),
@@ -560,6 +578,7 @@ ColumnFamilyData::ColumnFamilyData(
       queued_for_flush_(false),
       queued_for_compaction_(false),
       prev_compaction_needed_bytes_(0),
+      prev_write_pressure_(0),
       allow_2pc_(db_options.allow_2pc),
       last_memtable_id_(0),
       db_paths_registered_(false),
@@ -592,6 +611,10 @@ ColumnFamilyData::ColumnFamilyData(
     table_cache_.reset(new TableCache(ioptions_, file_options, _table_cache,
                                       block_cache_tracer, io_tracer,
                                       db_session_id));
+    table_cache_->SetBlockFetchHistograms(
+        internal_stats_->GetBlockFetchHists(), ioptions_.num_levels);
+    table_cache_->SetBlockCacheHeatMaps(
+        internal_stats_->GetBlockCacheHeatMaps(), ioptions_.num_levels);
     blob_file_cache_.reset(
         new BlobFileCache(_table_cache, ioptions(), soptions(), id_,
                           internal_stats_->GetBlobFileReadHist(), io_tracer));
@@ -655,6 +678,36 @@ ColumnFamilyData::ColumnFamilyData(
               bbto->block_cache)));
     }
   }
+
+  // Older operands must not change under a cached result, and which of them
+  // a read sees must depend on the sequence number only. Entries replayed
+  // from the row cache of table files lack their sequence numbers.
+  if (ioptions_.merge_result_cache_size > 0 &&
+      ioptions_.merge_operator != nullptr &&
+      !ioptions_.inplace_update_support &&
+      (ioptions_.row_cache == nullptr || ioptions_.row_cache_by_user_key) &&
+      ioptions_.compaction_filter == nullptr &&
+      ioptions_.compaction_filter_factory == nullptr &&
+      user_comparator()->timestamp_size() == 0) {
+    std::shared_ptr<Cache> charge_cache;
+    const BlockBasedTableOptions* bbto =
+        ioptions_.table_factory->GetOptions<BlockBasedTableOptions>();
+    if (bbto != nullptr) {
+      charge_cache = bbto->block_cache;
+    }
+    merge_result_cache_.reset(new MergeResultCache(
+        ioptions_.merge_result_cache_size, std::move(charge_cache)));
+  }
+
+  // A compaction filter may change the values of keys without newer entries
+  if (_dummy_versions != nullptr && ioptions_.row_cache != nullptr &&
+      ioptions_.row_cache_by_user_key &&
+      ioptions_.compaction_filter == nullptr &&
+      ioptions_.compaction_filter_factory == nullptr &&
+      user_comparator()->timestamp_size() == 0) {
+    user_key_row_cache_.reset(
+        new UserKeyRowCache(ioptions_.row_cache.get()));
+  }
 }
 
 // DB mutex held
@@ -727,6 +780,7 @@ bool ColumnFamilyData::UnrefAndTryDelete() {
     // Only the super_version_ holds me
     SuperVersion* sv = super_version_;
     super_version_ = nullptr;
+    published_super_version_.store(nullptr);
 
     // Release SuperVersion references kept in ThreadLocalPtr.
     local_sv_.reset();
@@ -906,6 +960,37 @@ uint64_t GetPendingCompactionBytesForCompactionSpeedup(
       MultiplyCheckOverflow(bottommost_files_size, kBottommostSizeMultiplier);
   return std::min(size_threshold, slowdown_threshold);
 }
+
+// How far the column family is from where compactions are sped up (0) to where
+// writes are delayed (1), by the L0 file count or the compaction debt,
+// whichever is further along.
+double GetWritePressure(const MutableCFOptions& mutable_cf_options,
+                        const VersionStorageInfo* vstorage) {
+  double pressure = 0;
+  const int l0_speedup = GetL0FileCountForCompactionSpeedup(
+      mutable_cf_options.level0_file_num_compaction_trigger,
+      mutable_cf_options.level0_slowdown_writes_trigger);
+  const int l0_slowdown = mutable_cf_options.level0_slowdown_writes_trigger;
+  if (l0_slowdown > l0_speedup) {
+    pressure = std::max(
+        pressure,
+        static_cast<double>(vstorage->l0_delay_trigger_count() - l0_speedup) /
+            (l0_slowdown - l0_speedup));
+  }
+  const uint64_t soft_limit =
+      mutable_cf_options.soft_pending_compaction_bytes_limit;
+  if (soft_limit > 0) {
+    const uint64_t speedup = GetPendingCompactionBytesForCompactionSpeedup(
+        mutable_cf_options, vstorage);
+    const uint64_t debt = vstorage->estimated_compaction_needed_bytes();
+    if (soft_limit > speedup && debt > speedup) {
+      pressure =
+          std::max(pressure, static_cast<double>(debt - speedup) /
+                                 static_cast<double>(soft_limit - speedup));
+    }
+  }
+  return std::min(pressure, 1.0);
+}
 }  // anonymous namespace
 
 std::pair<WriteStallCondition, WriteStallCause>
@@ -961,9 +1046,13 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
         *ioptions());
     write_stall_condition = write_stall_condition_and_cause.first;
     auto write_stall_cause = write_stall_condition_and_cause.second;
+    write_stall_cause_ = write_stall_cause;
 
     bool was_stopped = write_controller->IsStopped();
     bool needed_delay = write_controller->NeedsDelay();
+    // Writes are under full pressure while they stall
+    double write_pressure =
+        write_stall_condition == WriteStallCondition::kNormal ? 0 : 1;
 
     if (write_stall_condition == WriteStallCondition::kStopped &&
         write_stall_cause == WriteStallCause::kMemtableLimit &&
@@ -1100,10 +1189,38 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       } else {
         write_controller_token_.reset();
       }
-      // If the DB recovers from delay conditions, we reward with reducing
-      // double the slowdown ratio. This is to balance the long term slowdown
-      // increase signal.
-      if (needed_delay) {
+      // With smooth slowdown, delay writes by the write pressure, extrapolated
+      // one recalculation ahead while it is increasing, so that the rate is
+      // already lowered when the backlog keeps growing into a write stall.
+      double predicted_pressure = 0;
+      if (mutable_cf_options.smooth_write_slowdown &&
+          !mutable_cf_options.disable_write_stall &&
+          !mutable_cf_options.disable_auto_compactions) {
+        write_pressure = GetWritePressure(mutable_cf_options, vstorage);
+        predicted_pressure = std::min(
+            1.0, write_pressure +
+                     std::max(0.0, write_pressure - prev_write_pressure_));
+      }
+      if (predicted_pressure > 0) {
+        const uint64_t kMinWriteRate = 16 * 1024u;
+        const double max_write_rate =
+            static_cast<double>(write_controller->max_delayed_write_rate());
+        uint64_t write_rate = std::max(
+            kMinWriteRate, static_cast<uint64_t>(max_write_rate *
+                                                 (1 - predicted_pressure / 2)));
+        write_controller_token_ = write_controller->GetDelayToken(write_rate);
+        ROCKS_LOG_INFO(
+            ioptions_.logger,
+            "[%s] Smoothly slowing down writes because we have %d level-0 "
+            "files and estimated pending compaction bytes %" PRIu64
+            " rate %" PRIu64,
+            name_.c_str(), vstorage->l0_delay_trigger_count(),
+            vstorage->estimated_compaction_needed_bytes(),
+            write_controller->delayed_write_rate());
+      } else if (needed_delay) {
+        // If the DB recovers from delay conditions, we reward with reducing
+        // double the slowdown ratio. This is to balance the long term slowdown
+        // increase signal.
         uint64_t write_rate = write_controller->delayed_write_rate();
         write_controller->set_delayed_write_rate(static_cast<uint64_t>(
             static_cast<double>(write_rate) * kDelayRecoverSlowdownRatio));
@@ -1126,10 +1243,52 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       }
     }
     prev_compaction_needed_bytes_ = compaction_needed_bytes;
+    prev_write_pressure_ = write_pressure;
   }
   return write_stall_condition;
 }
 
+void ColumnFamilyData::UpdateWriteStallTimeline(
+    WriteStallCondition write_stall_condition,
+    SuperVersionContext* sv_context) {
+  if (internal_stats_ == nullptr || current_ == nullptr) {
+    return;
+  }
+  WriteStallDetailInfo* ongoing = internal_stats_->GetOngoingWriteStall();
+  const bool unchanged =
+      ongoing == nullptr
+          ? write_stall_condition == WriteStallCondition::kNormal
+          : (ongoing->condition == write_stall_condition &&
+             ongoing->cause == write_stall_cause_);
+  if (unchanged) {
+    return;
+  }
+  const uint64_t now = ioptions_.clock->NowMicros();
+  if (ongoing != nullptr) {
+    ongoing->end_micros = now;
+    sv_context->PushWriteStallDetailNotification(*ongoing, ioptions());
+  }
+  WriteStallDetailInfo stall;
+  stall.condition = write_stall_condition;
+  if (write_stall_condition != WriteStallCondition::kNormal) {
+    auto* vstorage = current_->storage_info();
+    stall.cf_name = name_;
+    stall.cause = write_stall_cause_;
+    stall.start_micros = now;
+    stall.pending_compaction_bytes =
+        vstorage->estimated_compaction_needed_bytes();
+    stall.num_l0_files = vstorage->l0_delay_trigger_count();
+    stall.num_unflushed_memtables = imm()->NumNotFlushed();
+    stall.num_memtables_being_flushed = imm()->NumFlushRunning();
+    stall.num_running_compactions = static_cast<int>(
+        compaction_picker_->compactions_in_progress()->size());
+    stall.num_running_l0_compactions = static_cast<int>(
+        compaction_picker_->level0_compactions_in_progress()->size());
+    sv_context->PushWriteStallDetailNotification(stall, ioptions());
+  }
+  internal_stats_->AddWriteStall(stall);
+}
+
 const FileOptions* ColumnFamilyData::soptions() const {
   return &(column_family_set_->file_options_);
 }
@@ -1157,7 +1316,8 @@ uint64_t ColumnFamilyData::GetLiveSstFilesSize() const {
 MemTable* ColumnFamilyData::ConstructNewMemtable(
     const MutableCFOptions& mutable_cf_options, SequenceNumber earliest_seq) {
   return new MemTable(internal_comparator_, ioptions_, mutable_cf_options,
-                      write_buffer_manager_, earliest_seq, id_);
+                      write_buffer_manager_, earliest_seq, id_,
+                      column_family_set_->arena_block_pool());
 }
 
 void ColumnFamilyData::CreateNewMemtable(
@@ -1405,9 +1565,23 @@ SuperVersion* ColumnFamilyData::GetThreadLocalSuperVersion(DBImpl* db) {
   SuperVersion* sv = static_cast<SuperVersion*>(ptr);
   if (sv == SuperVersion::kSVObsolete) {
     RecordTick(ioptions_.stats, NUMBER_SUPERVERSION_ACQUIRES);
-    db->mutex()->Lock();
-    sv = super_version_->Ref();
-    db->mutex()->Unlock();
+    // Reference the published SuperVersion without the DB mutex, so that
+    // the readers of all threads do not queue up on it after a new
+    // SuperVersion is installed. The SuperVersion cannot be freed in the
+    // meantime, see WaitForSuperVersionAcquirers().
+    super_version_acquirers_.fetch_add(1);
+    sv = published_super_version_.load();
+    if (sv != nullptr && !sv->TryRef()) {
+      sv = nullptr;
+    }
+    super_version_acquirers_.fetch_sub(1, std::memory_order_release);
+    if (sv == nullptr) {
+      // Replaced and released in the meantime
+      TEST_SYNC_POINT("ColumnFamilyData::GetThreadLocalSuperVersion:Locked");
+      db->mutex()->Lock();
+      sv = super_version_->Ref();
+      db->mutex()->Unlock();
+    }
   }
   assert(sv != nullptr);
   return sv;
@@ -1431,6 +1605,12 @@ bool ColumnFamilyData::ReturnThreadLocalSuperVersion(SuperVersion* sv) {
   return false;
 }
 
+void ColumnFamilyData::WaitForSuperVersionAcquirers() {
+  while (super_version_acquirers_.load() != 0) {
+    std::this_thread::yield();
+  }
+}
+
 void ColumnFamilyData::InstallSuperVersion(SuperVersionContext* sv_context,
                                            InstrumentedMutex* db_mutex) {
   db_mutex->AssertHeld();
@@ -1445,6 +1625,7 @@ void ColumnFamilyData::InstallSuperVersion(
   new_superversion->Init(this, mem_, imm_.current(), current_);
   SuperVersion* old_superversion = super_version_;
   super_version_ = new_superversion;
+  published_super_version_.store(new_superversion);
   if (old_superversion == nullptr || old_superversion->current != current() ||
       old_superversion->mem != mem_ ||
       old_superversion->imm != imm_.current()) {
@@ -1453,10 +1634,24 @@ void ColumnFamilyData::InstallSuperVersion(
     // down is needed.
     super_version_->write_stall_condition = RecalculateWriteStallConditions(
         mutable_cf_options, ioptions_.rate_limiter.get());
+    if (old_superversion != nullptr &&
+        old_superversion->current != current()) {
+      internal_stats_->PruneBlockCacheHeatMaps(*current_->storage_info());
+      if (mutable_cf_options.enable_blob_files &&
+          mutable_cf_options.adaptive_min_blob_size &&
+          blob_separation_tuner_.Update(
+              *current_->storage_info(),
+              internal_stats_->GetTableWriteAmplification())) {
+        ROCKS_LOG_INFO(ioptions_.logger,
+                       "[%s] Picked min_blob_size %" PRIu64, GetName().c_str(),
+                       blob_separation_tuner_.GetMinBlobSize(0));
+      }
+    }
   } else {
     super_version_->write_stall_condition =
         old_superversion->write_stall_condition;
   }
+  UpdateWriteStallTimeline(super_version_->write_stall_condition, sv_context);
   if (old_superversion != nullptr) {
     // Reset SuperVersions cached in thread local storage.
     // This should be done before old_superversion->Unref(). That's to ensure
@@ -1580,6 +1775,13 @@ Status ColumnFamilyData::ValidateOptions(
     }
   }
 
+  if (cf_options.blob_cache_max_garbage_ratio < 0.0 ||
+      cf_options.blob_cache_max_garbage_ratio > 1.0) {
+    return Status::InvalidArgument(
+        "The maximum garbage ratio for caching blobs should be in the range "
+        "[0.0, 1.0].");
+  }
+
   if (cf_options.compaction_style == kCompactionStyleFIFO &&
       db_options.max_open_files != -1 && cf_options.ttl > 0) {
     return Status::NotSupported(
@@ -1650,6 +1852,9 @@ Status ColumnFamilyData::SetOptions(
   if (s.ok()) {
     mutable_cf_options_ = MutableCFOptions(cf_opts);
     mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+    if (column_family_set_ != nullptr) {
+      column_family_set_->UpdateArenaBlockPoolCapacity();
+    }
   }
   return s;
 }
@@ -1767,6 +1972,10 @@ ColumnFamilySet::ColumnFamilySet(const std::string& dbname,
       db_options_(db_options),
       table_cache_(table_cache),
       write_buffer_manager_(_write_buffer_manager),
+      arena_block_pool_(db_options->memtable_arena_pool_size > 0
+                            ? std::make_shared<ArenaBlockPool>(
+                                  0 /* capacity */, db_options->stats)
+                            : nullptr),
       write_controller_(_write_controller),
       block_cache_tracer_(block_cache_tracer),
       io_tracer_(io_tracer),
@@ -1861,6 +2070,7 @@ ColumnFamilyData* ColumnFamilySet::CreateColumnFamily(
   if (id == 0) {
     default_cfd_cache_ = new_cfd;
   }
+  UpdateArenaBlockPoolCapacity();
   return new_cfd;
 }
 
@@ -1873,6 +2083,28 @@ void ColumnFamilySet::RemoveColumnFamily(ColumnFamilyData* cfd) {
   column_families_.erase(cfd->GetName());
   running_ts_sz_.erase(cf_id);
   ts_sz_for_record_.erase(cf_id);
+  UpdateArenaBlockPoolCapacity();
+}
+
+void ColumnFamilySet::UpdateArenaBlockPoolCapacity() {
+  if (arena_block_pool_ == nullptr) {
+    return;
+  }
+  // One memtable per column family is always active; the pool only needs
+  // to hold on to the memory of the ones that could be waiting to flush.
+  uint64_t budget = 0;
+  for (const auto& entry : column_family_data_) {
+    const MutableCFOptions* mutable_cf_options =
+        entry.second->GetLatestMutableCFOptions();
+    if (mutable_cf_options->max_write_buffer_number > 1) {
+      budget +=
+          uint64_t{mutable_cf_options->write_buffer_size} *
+          static_cast<uint64_t>(mutable_cf_options->max_write_buffer_number -
+                                1);
+    }
+  }
+  arena_block_pool_->SetCapacity(static_cast<size_t>(std::min(
+      budget, uint64_t{db_options_->memtable_arena_pool_size})));
 }
 
 // under a DB mutex OR from a write thread
@@ -15,17 +15,22 @@
 #include <vector>
 
 #include "cache/cache_reservation_manager.h"
+#include "db/blob/blob_separation_tuner.h"
 #include "db/memtable_list.h"
+#include "db/merge_result_cache.h"
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
+#include "db/user_key_row_cache.h"
 #include "db/write_batch_internal.h"
 #include "db/write_controller.h"
+#include "memory/arena_block_pool.h"
 #include "options/cf_options.h"
 #include "rocksdb/compaction_job_stats.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
 #include "trace_replay/block_cache_tracer.h"
+#include "util/atomic.h"
 #include "util/hash_containers.h"
 #include "util/thread_local.h"
 
@@ -223,6 +228,9 @@ struct SuperVersion {
   SuperVersion() = default;
   ~SuperVersion();
   SuperVersion* Ref();
+  // References this SuperVersion unless its last reference was already
+  // dropped, and returns whether it did. Thread-safe.
+  bool TryRef();
   // If Unref() returns true, Cleanup() should be called with mutex held
   // before deleting this SuperVersion.
   bool Unref();
@@ -339,6 +347,15 @@ class ColumnFamilyData {
 
   bool is_delete_range_supported() { return is_delete_range_supported_; }
 
+  // Average costs in nanoseconds of a reseek of the iterators of the column
+  // family and of stepping over one hidden entry instead, see
+  // adapt_max_sequential_skip_in_iterations
+  struct IterSkipCosts {
+    RelaxedAtomic<uint64_t> reseek_nanos{0};
+    RelaxedAtomic<uint64_t> skip_nanos{0};
+  };
+  IterSkipCosts* iter_skip_costs() { return &iter_skip_costs_; }
+
   // Validate CF options against DB options
   static Status ValidateOptions(const DBOptions& db_options,
                                 const ColumnFamilyOptions& cf_options);
@@ -455,6 +472,10 @@ class ColumnFamilyData {
   // success and false on failure. It fails when the thread local storage
   // contains anything other than SuperVersion::kSVInUse flag.
   bool ReturnThreadLocalSuperVersion(SuperVersion* sv);
+  // Waits for the threads referencing the current SuperVersion without the
+  // DB mutex to be done, so that a SuperVersion whose last reference was
+  // dropped can be freed. Called by SuperVersion::Cleanup().
+  void WaitForSuperVersionAcquirers();
   // thread-safe
   uint64_t GetSuperVersionNumber() const {
     return super_version_number_.load();
@@ -490,6 +511,13 @@ class ColumnFamilyData {
       const MutableCFOptions& mutable_cf_options,
       RateLimiter* rate_limiter = nullptr);
 
+  // Ends the ongoing write stall in the timeline of the CF and starts a new
+  // one if the condition or cause of the stall changed, notifying the
+  // listeners through sv_context.
+  // REQUIRES: DB mutex held
+  void UpdateWriteStallTimeline(WriteStallCondition write_stall_condition,
+                                SuperVersionContext* sv_context);
+
   void set_initialized() { initialized_.store(true); }
 
   bool initialized() const { return initialized_.load(); }
@@ -534,6 +562,18 @@ class ColumnFamilyData {
   GetFileMetadataCacheReservationManager() {
     return file_metadata_cache_res_mgr_;
   }
+  // Null unless ColumnFamilyOptions::merge_result_cache_size enables it
+  MergeResultCache* merge_result_cache() const {
+    return merge_result_cache_.get();
+  }
+  // Null unless DBOptions::row_cache_by_user_key enables it
+  UserKeyRowCache* user_key_row_cache() const {
+    return user_key_row_cache_.get();
+  }
+  // Used when AdvancedColumnFamilyOptions::adaptive_min_blob_size is set
+  BlobSeparationTuner* blob_separation_tuner() {
+    return &blob_separation_tuner_;
+  }
 
   static const uint32_t kDummyColumnFamilyDataId;
 
@@ -592,6 +632,8 @@ class ColumnFamilyData {
 
   const bool is_delete_range_supported_;
 
+  IterSkipCosts iter_skip_costs_;
+
   std::unique_ptr<TableCache> table_cache_;
   std::unique_ptr<BlobFileCache> blob_file_cache_;
   std::unique_ptr<BlobSource> blob_source_;
@@ -603,6 +645,12 @@ class ColumnFamilyData {
   MemTable* mem_;
   MemTableList imm_;
   SuperVersion* super_version_;
+  // super_version_, for GetThreadLocalSuperVersion() to reference it without
+  // the DB mutex
+  std::atomic<SuperVersion*> published_super_version_;
+  // Number of threads between loading published_super_version_ and
+  // referencing the SuperVersion
+  std::atomic<uint32_t> super_version_acquirers_;
 
   // An ordinal representing the current SuperVersion. Updated by
   // InstallSuperVersion(), i.e. incremented every time super_version_
@@ -641,6 +689,14 @@ class ColumnFamilyData {
 
   uint64_t prev_compaction_needed_bytes_;
 
+  // The write pressure of the last RecalculateWriteStallConditions(), from 0
+  // to 1, for smooth_write_slowdown
+  double prev_write_pressure_;
+
+  // The cause of the last write stall condition computed by
+  // RecalculateWriteStallConditions()
+  WriteStallCause write_stall_cause_ = WriteStallCause::kNone;
+
   // if the database was opened with 2pc enabled
   bool allow_2pc_;
 
@@ -657,6 +713,9 @@ class ColumnFamilyData {
   // For charging memory usage of file metadata created for newly added files to
   // a Version associated with this CFD
   std::shared_ptr<CacheReservationManager> file_metadata_cache_res_mgr_;
+  std::unique_ptr<MergeResultCache> merge_result_cache_;
+  std::unique_ptr<UserKeyRowCache> user_key_row_cache_;
+  BlobSeparationTuner blob_separation_tuner_;
   bool mempurge_used_;
 
   std::atomic<uint64_t> next_epoch_number_;
@@ -742,6 +801,18 @@ class ColumnFamilySet {
 
   WriteBufferManager* write_buffer_manager() { return write_buffer_manager_; }
 
+  // Returns the pool that the memtables of all column families recycle
+  // their arena blocks through, or nullptr if memtable_arena_pool_size is 0.
+  const std::shared_ptr<ArenaBlockPool>& arena_block_pool() const {
+    return arena_block_pool_;
+  }
+
+  // Caps the capacity of the arena block pool at what the column families'
+  // write_buffer_size and max_write_buffer_number allow, so that pooled and
+  // live memtables together use no more memory than live ones alone could.
+  // REQUIRES: DB mutex held
+  void UpdateArenaBlockPoolCapacity();
+
   WriteController* write_controller() { return write_controller_; }
 
  private:
@@ -783,6 +854,7 @@ class ColumnFamilySet {
   const ImmutableDBOptions* const db_options_;
   Cache* table_cache_;
   WriteBufferManager* write_buffer_manager_;
+  std::shared_ptr<ArenaBlockPool> arena_block_pool_;
   WriteController* write_controller_;
   BlockCacheTracer* const block_cache_tracer_;
   std::shared_ptr<IOTracer> io_tracer_;
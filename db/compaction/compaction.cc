@@ -517,6 +517,14 @@ bool Compaction::InputCompressionMatchesOutput() const {
   return matches;
 }
 
+bool Compaction::IsTrivialCopy() const {
+  return compaction_reason_ == CompactionReason::kChangeTemperature &&
+         immutable_options_.compaction_style == kCompactionStyleFIFO &&
+         mutable_cf_options_.compaction_options_fifo
+             .allow_trivial_copy_when_change_temperature &&
+         num_input_levels() == 1 && start_level_ == output_level_;
+}
+
 bool Compaction::IsTrivialMove() const {
   // Avoid a move if there is lots of overlapping grandparent data.
   // Otherwise, the move could create a parent file that will require
@@ -844,7 +852,8 @@ std::unique_ptr<CompactionFilter> Compaction::CreateCompactionFilter() const {
 }
 
 std::pair<std::vector<Slice>, std::vector<uint64_t>>
-Compaction::CreateSegmentsForLevel(int level) const {
+Compaction::CreateSegmentsForLevel(int level,
+                                   std::vector<Slice>* smallest_keys) const {
   // So... the below files should be adjacently sorted.
   // For now, this is only for creating the next-of-output level info, so it
   // makes sense for not supporting L0.
@@ -885,6 +894,9 @@ Compaction::CreateSegmentsForLevel(int level) const {
     }
     ranges.push_back(ExtractUserKey(iter->largest_key));
     sizes.push_back(iter->fd.GetFileSize());
+    if (smallest_keys != nullptr) {
+      smallest_keys->push_back(ExtractUserKey(iter->smallest_key));
+    }
   }
   return std::make_pair(ranges, sizes);
 }
@@ -900,9 +912,11 @@ std::unique_ptr<SstPartitioner> Compaction::CreateSstPartitioner() const {
   context.output_level = output_level_;
   context.smallest_user_key = smallest_user_key_;
   context.largest_user_key = largest_user_key_;
+  context.user_comparator = immutable_options_.user_comparator;
   std::tie(context.output_next_level_boundaries,
            context.output_next_level_size) =
-      CreateSegmentsForLevel(output_level_ + 1);
+      CreateSegmentsForLevel(output_level_ + 1,
+                             &context.output_next_level_smallest_keys);
   return immutable_options_.sst_partitioner_factory->CreatePartitioner(context);
 }
 
@@ -958,6 +972,32 @@ bool Compaction::DoesInputReferenceBlobFiles() const {
   return false;
 }
 
+bool Compaction::MayHaveInputTimestampNewerThan(const Slice& ts) const {
+  const Comparator* ucmp = column_family_data()->user_comparator();
+  assert(ucmp->timestamp_size() == ts.size());
+  size_t num_input_files = 0;
+  for (const auto& input : inputs_) {
+    num_input_files += input.size();
+  }
+  if (input_table_properties_.size() != num_input_files) {
+    // The properties of some input files could not be loaded
+    return true;
+  }
+  for (const auto& file_and_props : input_table_properties_) {
+    const auto& props = file_and_props.second->user_collected_properties;
+    auto max_ts_pos = props.find("rocksdb.timestamp_max");
+    if (max_ts_pos == props.end()) {
+      return true;
+    }
+    // The timestamps are empty in a table without keys
+    if (!max_ts_pos->second.empty() &&
+        ucmp->CompareTimestamp(max_ts_pos->second, ts) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 uint64_t Compaction::MinInputFileOldestAncesterTime(
     const InternalKey* start, const InternalKey* end) const {
   uint64_t min_oldest_ancester_time = std::numeric_limits<uint64_t>::max();
@@ -981,6 +1021,16 @@ uint64_t Compaction::MinInputFileOldestAncesterTime(
   return min_oldest_ancester_time;
 }
 
+SequenceNumber Compaction::GetLargestSeqnoOfInputs() const {
+  SequenceNumber largest_seqno = 0;
+  for (const auto& level_files : inputs_) {
+    for (const auto& file : level_files.files) {
+      largest_seqno = std::max(largest_seqno, file->LargestSeqnoOfInputs());
+    }
+  }
+  return largest_seqno;
+}
+
 uint64_t Compaction::MinInputFileEpochNumber() const {
   uint64_t min_epoch_number = std::numeric_limits<uint64_t>::max();
   for (const auto& inputs_per_level : inputs_) {
@@ -197,10 +197,20 @@ class Compaction {
   // Whether need to write output file to second DB path.
   uint32_t output_path_id() const { return output_path_id_; }
 
+  // Change the path the output files are written to, e.g. for a path with more
+  // free space. REQUIRES: the compaction has not started running.
+  void set_output_path_id(uint32_t output_path_id) {
+    output_path_id_ = output_path_id;
+  }
+
   // Is this a trivial compaction that can be implemented by just
   // moving a single input file to the next level (no merging or splitting)
   bool IsTrivialMove() const;
 
+  // If true, the compaction changes the temperature of its input files by
+  // copying each of them byte for byte, instead of compacting them
+  bool IsTrivialCopy() const;
+
   // The split user key in the output level if this compaction is required to
   // split the output files according to the existing cursor in the output
   // level under round-robin compaction policy. Empty indicates no required
@@ -327,6 +337,12 @@ class Compaction {
   // PRE: input version has been set.
   bool DoesInputReferenceBlobFiles() const;
 
+  // Returns false iff the table properties of all input files show that
+  // their keys have no user-defined timestamp newer than `ts`.
+  //
+  // PRE: input table properties have been initialized.
+  bool MayHaveInputTimestampNewerThan(const Slice& ts) const;
+
   // test function to validate the functionality of IsBottommostLevel()
   // function -- determines if compaction with inputs and storage is bottommost
   static bool TEST_IsBottommostLevel(
@@ -406,6 +422,10 @@ class Compaction {
   // input files' associated with this compaction
   uint64_t MinInputFileEpochNumber() const;
 
+  // Return the largest sequence number that the input files have, or had
+  // before they were compacted. See FileMetaData::LargestSeqnoOfInputs().
+  SequenceNumber GetLargestSeqnoOfInputs() const;
+
   // Called by DBImpl::NotifyOnCompactionCompleted to make sure number of
   // compaction begin and compaction completion callbacks match.
   void SetNotifyOnCompactionCompleted() {
@@ -475,8 +495,10 @@ class Compaction {
   static bool IsFullCompaction(VersionStorageInfo* vstorage,
                                const std::vector<CompactionInputFiles>& inputs);
 
+  // If smallest_keys is not null, it also gets the smallest key of each file
+  // of the segments.
   std::pair<std::vector<Slice>, std::vector<uint64_t>> CreateSegmentsForLevel(
-      int in_level) const;
+      int in_level, std::vector<Slice>* smallest_keys = nullptr) const;
 
   VersionStorageInfo* input_vstorage_;
 
@@ -494,7 +516,7 @@ class Compaction {
   ColumnFamilyData* cfd_;
   Arena arena_;  // Arena used to allocate space for file_levels_
 
-  const uint32_t output_path_id_;
+  uint32_t output_path_id_;
   CompressionType output_compression_;
   CompressionOptions output_compression_opts_;
   Temperature output_temperature_;
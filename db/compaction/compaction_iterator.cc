@@ -68,7 +68,16 @@ CompactionIterator::CompactionIterator(
     const std::string* full_history_ts_low,
     const SequenceNumber preserve_time_min_seqno,
     const SequenceNumber preclude_last_level_min_seqno)
-    : input_(input, cmp, must_count_input_entries),
+    : filter_batcher_(
+          compaction_filter != nullptr &&
+                  compaction_filter->FilterBatchSize() > 0 && cmp != nullptr &&
+                  cmp->timestamp_size() == 0
+              ? std::make_unique<FilterBatchingIterator>(
+                    input, compaction_filter, cmp,
+                    compaction == nullptr ? 0 : compaction->level())
+              : nullptr),
+      input_(filter_batcher_ ? filter_batcher_.get() : input, cmp,
+             must_count_input_entries),
       cmp_(cmp),
       merge_helper_(merge_helper),
       snapshots_(snapshots),
@@ -341,10 +350,17 @@ bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
         existing_col = &existing_columns;
       }
 
-      decision = compaction_filter_->FilterV3(
-          level_, filter_key, value_type, existing_val, existing_col,
-          &compaction_filter_value_, &new_columns,
-          compaction_filter_skip_until_.rep());
+      // input_ is still positioned on the current key, so the batcher can
+      // tell what FilterBatch() decided for it.
+      if (filter_batcher_ && ikey_.type == kTypeValue) {
+        decision = filter_batcher_->decision(&compaction_filter_value_);
+      }
+      if (decision == CompactionFilter::Decision::kUndetermined) {
+        decision = compaction_filter_->FilterV3(
+            level_, filter_key, value_type, existing_val, existing_col,
+            &compaction_filter_value_, &new_columns,
+            compaction_filter_skip_until_.rep());
+      }
     }
 
     iter_stats_.total_filter_time +=
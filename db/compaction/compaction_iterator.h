@@ -13,6 +13,7 @@
 
 #include "db/compaction/compaction.h"
 #include "db/compaction/compaction_iteration_stats.h"
+#include "db/compaction/filter_batching_iterator.h"
 #include "db/merge_helper.h"
 #include "db/pinned_iterators_manager.h"
 #include "db/range_del_aggregator.h"
@@ -352,6 +353,9 @@ class CompactionIterator {
   static std::unique_ptr<PrefetchBufferCollection>
   CreatePrefetchBufferCollectionIfNeeded(const CompactionProxy* compaction);
 
+  // Set if compaction_filter_ filters in batches. Sits between the input
+  // iterator passed in and input_.
+  std::unique_ptr<FilterBatchingIterator> filter_batcher_;
   SequenceIterWrapper input_;
   const Comparator* cmp_;
   MergeHelper* merge_helper_;
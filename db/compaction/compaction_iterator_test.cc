@@ -753,6 +753,65 @@ TEST_P(CompactionIteratorTest, RemoveAllSingleDeletes) {
   ASSERT_EQ(filter.filtered, 2);
 }
 
+TEST_P(CompactionIteratorTest, FilterBatch) {
+  struct Filter : public CompactionFilter {
+    size_t FilterBatchSize() const override { return 2; }
+
+    void FilterBatch(int /*level*/, const std::vector<Slice>& keys,
+                     const std::vector<Slice>& existing_values,
+                     std::vector<Decision>* decisions,
+                     std::vector<std::string>* new_values) const override {
+      EXPECT_EQ(keys.size(), existing_values.size());
+      EXPECT_EQ(keys.size(), decisions->size());
+      EXPECT_EQ(keys.size(), new_values->size());
+      std::string batch;
+      for (size_t i = 0; i < keys.size(); i++) {
+        batch += keys[i].ToString() + "=" + existing_values[i].ToString() + ";";
+        if (keys[i] == "b") {
+          (*decisions)[i] = Decision::kRemove;
+        } else if (keys[i] == "c") {
+          (*decisions)[i] = Decision::kChangeValue;
+          (*new_values)[i] = "cv2";
+        } else if (keys[i] != "d") {
+          (*decisions)[i] = Decision::kKeep;
+        }
+      }
+      batches.push_back(batch);
+    }
+
+    Decision FilterV2(int /*level*/, const Slice& key, ValueType /*t*/,
+                      const Slice& /*existing_value*/,
+                      std::string* /*new_value*/,
+                      std::string* /*skip_until*/) const override {
+      filtered_one_by_one.push_back(key.ToString());
+      return Decision::kKeep;
+    }
+
+    const char* Name() const override {
+      return "CompactionIteratorTest.FilterBatch::Filter";
+    }
+
+    mutable std::vector<std::string> batches;
+    mutable std::vector<std::string> filtered_one_by_one;
+  };
+
+  // Only the newest version of each key goes to FilterBatch(), and "d", which
+  // it leaves undecided, goes through FilterV2() instead.
+  Filter filter;
+  RunTest(
+      {test::KeyStr("a", 90, kTypeValue), test::KeyStr("a", 80, kTypeValue),
+       test::KeyStr("b", 70, kTypeValue), test::KeyStr("c", 60, kTypeValue),
+       test::KeyStr("d", 50, kTypeValue)},
+      {"av2", "av1", "bv1", "cv1", "dv1"},
+      {test::KeyStr("a", 90, kTypeValue), test::KeyStr("b", 70, kTypeDeletion),
+       test::KeyStr("c", 60, kTypeValue), test::KeyStr("d", 50, kTypeValue)},
+      {"av2", "", "cv2", "dv1"}, kMaxSequenceNumber,
+      nullptr /*merge_operator*/, &filter);
+  ASSERT_EQ(std::vector<std::string>({"a=av2;", "b=bv1;c=cv1;", "d=dv1;"}),
+            filter.batches);
+  ASSERT_EQ(std::vector<std::string>({"d"}), filter.filtered_one_by_one);
+}
+
 // In bottommost level, values earlier than earliest snapshot can be output
 // with sequence = 0.
 TEST_P(CompactionIteratorTest, ZeroOutSequenceAtBottomLevel) {
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <set>
 #include <utility>
@@ -33,6 +34,7 @@
 #include "db/range_del_aggregator.h"
 #include "db/version_edit.h"
 #include "db/version_set.h"
+#include "file/file_util.h"
 #include "file/filename.h"
 #include "file/read_write_util.h"
 #include "file/sst_file_manager_impl.h"
@@ -101,6 +103,8 @@ const char* GetCompactionReasonString(CompactionReason compaction_reason) {
       return "RoundRobinTtl";
     case CompactionReason::kRefitLevel:
       return "RefitLevel";
+    case CompactionReason::kRangeDeletionCoveredFiles:
+      return "RangeDeletionCoveredFiles";
     case CompactionReason::kNumOfReasons:
       // fall through
     default:
@@ -181,6 +185,7 @@ CompactionJob::CompactionJob(
       event_logger_(event_logger),
       paranoid_file_checks_(paranoid_file_checks),
       measure_io_stats_(measure_io_stats),
+      num_subcompaction_threads_(1),
       thread_pri_(thread_pri),
       full_history_ts_low_(std::move(full_history_ts_low)),
       trim_ts_(std::move(trim_ts)),
@@ -236,6 +241,7 @@ void CompactionJob::ReportStartedCompaction(Compaction* compaction) {
   // Set the thread operation after operation properties
   // to ensure GetThreadList() can always show them all together.
   ThreadStatusUtil::SetThreadOperation(ThreadStatus::OP_COMPACTION);
+  ThreadStatusUtil::GetThreadStageTimes(&stage_times_at_start_);
 
   compaction_job_stats_->is_manual_compaction =
       compaction->is_manual_compaction();
@@ -585,9 +591,15 @@ void CompactionJob::GenSubcompactionBoundaries() {
                            &num_planned_subcompactions);
   if (num_planned_subcompactions == 1) return;
 
+  // With subcompaction_ranges_per_thread > 1 we cut more ranges than there
+  // are threads, and Run() hands them out to whichever thread is free.
+  const uint64_t num_planned_ranges =
+      num_planned_subcompactions *
+      std::max(uint32_t{1}, db_options_.subcompaction_ranges_per_thread);
+
   // Group the ranges into subcompactions
   uint64_t target_range_size = std::max(
-      total_size / num_planned_subcompactions,
+      total_size / num_planned_ranges,
       MaxFileSizeForLevel(
           *(c->mutable_cf_options()), out_lvl,
           c->immutable_options()->compaction_style, base_level,
@@ -599,18 +611,25 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   uint64_t next_threshold = target_range_size;
   uint64_t cumulative_size = 0;
-  uint64_t num_actual_subcompactions = 1U;
+  uint64_t range_start_size = 0;
+  uint64_t num_actual_ranges = 1U;
   for (TableReader::Anchor& anchor : all_anchors) {
     cumulative_size += anchor.range_size;
     if (cumulative_size > next_threshold) {
       next_threshold += target_range_size;
-      num_actual_subcompactions++;
+      num_actual_ranges++;
       boundaries_.push_back(anchor.user_key);
+      range_sizes_.push_back(cumulative_size - range_start_size);
+      range_start_size = cumulative_size;
     }
-    if (num_actual_subcompactions == num_planned_subcompactions) {
+    if (num_actual_ranges == num_planned_ranges) {
       break;
     }
   }
+  range_sizes_.push_back(total_size - range_start_size);
+  uint64_t num_actual_subcompactions =
+      std::min(num_actual_ranges, num_planned_subcompactions);
+  num_subcompaction_threads_ = static_cast<size_t>(num_actual_subcompactions);
   TEST_SYNC_POINT_CALLBACK("CompactionJob::GenSubcompactionBoundaries:1",
                            &num_actual_subcompactions);
   // Shrink extra subcompactions resources when extra resrouces are acquired
@@ -626,21 +645,44 @@ Status CompactionJob::Run() {
   log_buffer_->FlushBufferToLog();
   LogCompaction();
 
-  const size_t num_threads = compact_->sub_compact_states.size();
+  const size_t num_subcompactions = compact_->sub_compact_states.size();
+  assert(num_subcompactions > 0);
+  const size_t num_threads =
+      std::min(num_subcompaction_threads_, num_subcompactions);
   assert(num_threads > 0);
   const uint64_t start_micros = db_options_.clock->NowMicros();
 
-  // Launch a thread for each of subcompactions 1...num_threads-1
+  // When there are more subcompactions than threads, every thread keeps
+  // taking the next one until none are left. They are handed out largest
+  // estimated size first, so that the ones still running at the end are the
+  // small ones.
+  std::vector<size_t> schedule(num_subcompactions);
+  std::iota(schedule.begin(), schedule.end(), size_t{0});
+  if (num_threads < num_subcompactions &&
+      range_sizes_.size() == num_subcompactions) {
+    std::stable_sort(schedule.begin(), schedule.end(),
+                     [this](size_t a, size_t b) {
+                       return range_sizes_[a] > range_sizes_[b];
+                     });
+  }
+  std::atomic<size_t> next_subcompaction{num_threads};
+  auto run_subcompactions = [&](size_t first) {
+    for (size_t i = first; i < num_subcompactions;
+         i = next_subcompaction.fetch_add(1, std::memory_order_relaxed)) {
+      ProcessKeyValueCompaction(&compact_->sub_compact_states[schedule[i]]);
+    }
+  };
+
+  // Launch threads 1...num_threads-1
   std::vector<port::Thread> thread_pool;
   thread_pool.reserve(num_threads - 1);
-  for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this,
-                             &compact_->sub_compact_states[i]);
+  for (size_t i = 1; i < num_threads; i++) {
+    thread_pool.emplace_back(run_subcompactions, i);
   }
 
-  // Always schedule the first subcompaction (whether or not there are also
+  // Always run the first thread's work (whether or not there are also
   // others) in the current thread to be efficient with resources
-  ProcessKeyValueCompaction(&compact_->sub_compact_states[0]);
+  run_subcompactions(0);
 
   // Wait for all other threads (if there are any) to finish execution
   for (auto& thread : thread_pool) {
@@ -775,7 +817,7 @@ Status CompactionJob::Run() {
         }
       }
     };
-    for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
+    for (size_t i = 1; i < num_threads; i++) {
       thread_pool.emplace_back(
           verify_table, std::ref(compact_->sub_compact_states[i].status));
     }
@@ -865,6 +907,10 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options,
   int output_level = compact_->compaction->output_level();
   cfd->internal_stats()->AddCompactionStats(output_level, thread_pri_,
                                             compaction_stats_);
+  ThreadStageTimes stage_times;
+  ThreadStatusUtil::GetThreadStageTimes(&stage_times);
+  stage_times.Subtract(stage_times_at_start_);
+  cfd->internal_stats()->AddJobStageTimes(stage_times);
 
   if (status.ok()) {
     status = InstallCompactionResults(mutable_cf_options, compaction_released);
@@ -983,6 +1029,11 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options,
     stream << "file_fsync_nanos" << compaction_job_stats_->file_fsync_nanos;
     stream << "file_prepare_write_nanos"
            << compaction_job_stats_->file_prepare_write_nanos;
+    stream << "input_read_cpu_nanos"
+           << compaction_job_stats_->input_read_cpu_nanos;
+    stream << "output_write_cpu_nanos"
+           << compaction_job_stats_->output_write_cpu_nanos;
+    stream << "merge_cpu_nanos" << compaction_job_stats_->merge_cpu_nanos;
   }
 
   stream << "lsm_state";
@@ -1124,6 +1175,9 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   read_options.fill_cache = false;
   read_options.rate_limiter_priority = GetRateLimiterPriority();
   read_options.io_activity = Env::IOActivity::kCompaction;
+  read_options.async_io =
+      db_options_.compaction_async_io &&
+      CheckFSFeatureSupport(fs_.get(), FSSupportedOps::kAsyncIO);
   // Compaction iterators shouldn't be confined to a single prefix.
   // Compactions use Seek() for
   // (a) concurrent compactions,
@@ -1211,7 +1265,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   }
 
   std::unique_ptr<InternalIterator> trim_history_iter;
-  if (ts_sz > 0 && !trim_ts_.empty()) {
+  // No key needs trimming when the inputs have no timestamp newer than
+  // trim_ts_
+  if (ts_sz > 0 && !trim_ts_.empty() &&
+      sub_compact->compaction->MayHaveInputTimestampNewerThan(trim_ts_)) {
     trim_history_iter = std::make_unique<HistoryTrimmingIterator>(
         input, cfd->user_comparator(), trim_ts_);
     input = trim_history_iter.get();
@@ -1231,6 +1288,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   uint64_t prev_prepare_write_nanos = 0;
   uint64_t prev_cpu_write_nanos = 0;
   uint64_t prev_cpu_read_nanos = 0;
+  // Per-stage CPU time, see CompactionJobStats::input_read_cpu_nanos
+  uint64_t prev_thread_cpu_nanos = 0;
+  uint64_t prev_block_read_cpu_nanos = 0;
+  uint64_t output_cpu_nanos = 0;
   if (measure_io_stats_) {
     prev_perf_level = GetPerfLevel();
     SetPerfLevel(PerfLevel::kEnableTimeAndCPUTimeExceptForMutex);
@@ -1240,7 +1301,20 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     prev_prepare_write_nanos = IOSTATS(prepare_write_nanos);
     prev_cpu_write_nanos = IOSTATS(cpu_write_nanos);
     prev_cpu_read_nanos = IOSTATS(cpu_read_nanos);
-  }
+    prev_thread_cpu_nanos = db_options_.clock->CPUNanos();
+    prev_block_read_cpu_nanos = get_perf_context()->block_read_cpu_time +
+                                get_perf_context()->block_decompress_time;
+  }
+  // Adds the CPU time of out() to output_cpu_nanos.
+  auto timed_output = [&](auto&& out) {
+    if (!measure_io_stats_) {
+      return out();
+    }
+    uint64_t start_cpu_nanos = db_options_.clock->CPUNanos();
+    Status s = out();
+    output_cpu_nanos += db_options_.clock->CPUNanos() - start_cpu_nanos;
+    return s;
+  };
 
   MergeHelper merge(
       env_, cfd->user_comparator(), cfd->ioptions()->merge_operator.get(),
@@ -1268,7 +1342,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
                 job_id_, cfd->GetID(), cfd->GetName(), Env::IOPriority::IO_LOW,
                 write_hint_, io_tracer_, blob_callback_,
                 BlobFileCreationReason::kCompaction, &blob_file_paths,
-                sub_compact->Current().GetBlobFileAdditionsPtr())
+                sub_compact->Current().GetBlobFileAdditionsPtr(),
+                cfd->blob_separation_tuner())
           : nullptr);
 
   TEST_SYNC_POINT("CompactionJob::Run():Inprogress");
@@ -1350,7 +1425,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     // and `close_file_func`.
     // TODO: it would be better to have the compaction file open/close moved
     // into `CompactionOutputs` which has the output file information.
-    status = sub_compact->AddToOutput(*c_iter, open_file_func, close_file_func);
+    status = timed_output([&]() {
+      return sub_compact->AddToOutput(*c_iter, open_file_func,
+                                      close_file_func);
+    });
     if (!status.ok()) {
       break;
     }
@@ -1437,8 +1515,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   // close the output files. Open file function is also passed, in case there's
   // only range-dels, no file was opened, to save the range-dels, it need to
   // create a new output file.
-  status = sub_compact->CloseCompactionFiles(status, open_file_func,
+  status = timed_output([&]() {
+    return sub_compact->CloseCompactionFiles(status, open_file_func,
                                              close_file_func);
+  });
 
   if (blob_file_builder) {
     if (status.ok()) {
@@ -1465,6 +1545,18 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
         IOSTATS(range_sync_nanos) - prev_range_sync_nanos;
     sub_compact->compaction_job_stats.file_prepare_write_nanos +=
         IOSTATS(prepare_write_nanos) - prev_prepare_write_nanos;
+    const uint64_t thread_cpu_nanos =
+        db_options_.clock->CPUNanos() - prev_thread_cpu_nanos;
+    const uint64_t read_cpu_nanos = get_perf_context()->block_read_cpu_time +
+                                    get_perf_context()->block_decompress_time -
+                                    prev_block_read_cpu_nanos;
+    sub_compact->compaction_job_stats.input_read_cpu_nanos += read_cpu_nanos;
+    sub_compact->compaction_job_stats.output_write_cpu_nanos +=
+        output_cpu_nanos;
+    if (thread_cpu_nanos > read_cpu_nanos + output_cpu_nanos) {
+      sub_compact->compaction_job_stats.merge_cpu_nanos +=
+          thread_cpu_nanos - read_cpu_nanos - output_cpu_nanos;
+    }
     sub_compact->compaction_job_stats.cpu_micros -=
         (IOSTATS(cpu_write_nanos) - prev_cpu_write_nanos +
          IOSTATS(cpu_read_nanos) - prev_cpu_read_nanos) /
@@ -1745,6 +1837,12 @@ Status CompactionJob::InstallCompactionResults(
   for (const auto& sub_compact : compact_->sub_compact_states) {
     sub_compact.AddOutputsEdit(edit);
 
+    // Dropping deletions, with what they cover or a matching put, may leave
+    // no newer entries of the keys behind
+    if (sub_compact.compaction_job_stats.num_expired_deletion_records > 0) {
+      edit->MarkInvalidatesCachedRows();
+    }
+
     for (const auto& blob : sub_compact.Current().GetBlobFileAdditions()) {
       edit->AddBlobFile(blob);
     }
@@ -1852,6 +1950,7 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
         sub_compact->compaction->mutable_cf_options()->last_level_temperature;
   }
   fo_copy.temperature = temperature;
+  fo_copy.write_behind = db_options_.table_file_write_behind;
 
   Status s;
   IOStatus io_s = NewWritableFile(fs_.get(), fname, &writable_file, fo_copy);
@@ -332,7 +332,14 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<std::string> boundaries_;
+  // Estimated input size of each subcompaction, if boundaries_ is not empty
+  std::vector<uint64_t> range_sizes_;
+  // Number of threads that run the subcompactions. Less than the number of
+  // subcompactions if subcompaction_ranges_per_thread > 1.
+  size_t num_subcompaction_threads_;
   Env::Priority thread_pri_;
+  // The stage times of the thread when the job started
+  ThreadStageTimes stage_times_at_start_;
   std::string full_history_ts_low_;
   std::string trim_ts_;
   BlobFileCompletionCallback* blob_callback_;
@@ -491,7 +498,9 @@ class CompactionServiceCompactionJob : private CompactionJob {
       const std::string& db_id, const std::string& db_session_id,
       std::string output_path,
       const CompactionServiceInput& compaction_service_input,
-      CompactionServiceResult* compaction_service_result);
+      CompactionServiceResult* compaction_service_result,
+      std::function<void(const CompactionServiceProgress&)> on_progress =
+          nullptr);
 
   // Run the compaction in current thread and return the result
   Status Run();
@@ -514,6 +523,10 @@ class CompactionServiceCompactionJob : private CompactionJob {
 
   // Compaction job result
   CompactionServiceResult* compaction_result_;
+
+  // Called with the bytes read and written so far each time the IO stats
+  // are recorded
+  std::function<void(const CompactionServiceProgress&)> on_progress_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
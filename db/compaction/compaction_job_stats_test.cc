@@ -417,6 +417,8 @@ class CompactionJobStatsChecker : public EventListener {
       ASSERT_GT(ci.stats.file_range_sync_nanos, 0);
       ASSERT_GT(ci.stats.file_fsync_nanos, 0);
       ASSERT_GT(ci.stats.file_prepare_write_nanos, 0);
+      ASSERT_GT(ci.stats.output_write_cpu_nanos, 0);
+      ASSERT_GT(ci.stats.merge_cpu_nanos, 0);
       verify_next_comp_io_stats_ = false;
     }
 
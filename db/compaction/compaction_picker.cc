@@ -378,7 +378,11 @@ Compaction* CompactionPicker::CompactFiles(
       mutable_cf_options.max_compaction_bytes, output_path_id, compression_type,
       GetCompressionOptions(mutable_cf_options, vstorage, output_level),
       Temperature::kUnknown, compact_options.max_subcompactions,
-      /* grandparents */ {}, true);
+      /* grandparents */ {}, /* is manual */ true, /* trim_ts */ "",
+      /* score */ -1, /* deletion_compaction */ false,
+      /* l0_files_might_overlap */ true, CompactionReason::kUnknown,
+      compact_options.blob_garbage_collection_policy,
+      compact_options.blob_garbage_collection_age_cutoff);
   RegisterCompaction(c);
   return c;
 }
@@ -9,12 +9,14 @@
 
 #include "db/compaction/compaction_picker_level.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "db/version_edit.h"
 #include "logging/log_buffer.h"
+#include "logging/logging.h"
 #include "test_util/sync_point.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -36,6 +38,9 @@ bool LevelCompactionPicker::NeedsCompaction(
   if (!vstorage->FilesMarkedForForcedBlobGC().empty()) {
     return true;
   }
+  if (!vstorage->FilesCoveredByRangeDeletions().empty()) {
+    return true;
+  }
   for (int i = 0; i <= vstorage->MaxInputLevel(); i++) {
     if (vstorage->CompactionScore(i) >= 1) {
       return true;
@@ -83,6 +88,10 @@ class LevelCompactionBuilder {
 
   Compaction* GetCompaction();
 
+  // Returns a deletion compaction dropping the files of one level covered by
+  // range tombstones of a higher level, or nullptr if there are none.
+  Compaction* PickRangeDeletionCoveredFilesCompaction();
+
   // From `start_level_`, pick files to compact to `output_level_`.
   // Returns false if there is no file to compact.
   // If it returns true, inputs->files.size() will be exactly one for
@@ -474,6 +483,14 @@ bool LevelCompactionBuilder::SetupOtherInputsIfNeeded() {
 }
 
 Compaction* LevelCompactionBuilder::PickCompaction() {
+  // Dropping files costs no IO and frees the most space, so it goes first
+  Compaction* c = PickRangeDeletionCoveredFilesCompaction();
+  if (c != nullptr) {
+    TEST_SYNC_POINT_CALLBACK("LevelCompactionPicker::PickCompaction:Return",
+                             c);
+    return c;
+  }
+
   // Pick up the first file to start compaction. It may have been extended
   // to a clean cut.
   SetupInitialFiles();
@@ -495,7 +512,7 @@ Compaction* LevelCompactionBuilder::PickCompaction() {
   }
 
   // Form a compaction object containing the files we picked.
-  Compaction* c = GetCompaction();
+  c = GetCompaction();
 
   TEST_SYNC_POINT_CALLBACK("LevelCompactionPicker::PickCompaction:Return", c);
 
@@ -541,6 +558,49 @@ Compaction* LevelCompactionBuilder::GetCompaction() {
   return c;
 }
 
+Compaction* LevelCompactionBuilder::PickRangeDeletionCoveredFilesCompaction() {
+  const auto& covered_files = vstorage_->FilesCoveredByRangeDeletions();
+  CompactionInputFiles inputs;
+  inputs.level = -1;
+  for (const auto& level_and_file : covered_files) {
+    FileMetaData* f = level_and_file.second;
+    if (f->being_compacted ||
+        (inputs.level >= 0 && level_and_file.first != inputs.level)) {
+      continue;
+    }
+    inputs.level = level_and_file.first;
+    inputs.files.push_back(f);
+  }
+  if (inputs.empty()) {
+    return nullptr;
+  }
+  const InternalKeyComparator* icmp = vstorage_->InternalComparator();
+  std::sort(inputs.files.begin(), inputs.files.end(),
+            [icmp](const FileMetaData* a, const FileMetaData* b) {
+              return icmp->Compare(a->smallest, b->smallest) < 0;
+            });
+
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] Level compaction: dropping %" ROCKSDB_PRIszt
+                   " files of level %d covered by range deletions",
+                   cf_name_.c_str(), inputs.size(), inputs.level);
+  const int level = inputs.level;
+  auto c = new Compaction(
+      vstorage_, ioptions_, mutable_cf_options_, mutable_db_options_,
+      {std::move(inputs)}, level,
+      /* target_file_size */ 0,
+      /* max_compaction_bytes */ 0,
+      /* output_path_id */ 0, kNoCompression,
+      mutable_cf_options_.compression_opts, Temperature::kUnknown,
+      /* max_subcompactions */ 0, {}, /* is manual */ false,
+      /* trim_ts */ "", /* score */ -1, /* is deletion compaction */ true,
+      /* l0_files_might_overlap */ false,
+      CompactionReason::kRangeDeletionCoveredFiles);
+  compaction_picker_->RegisterCompaction(c);
+  vstorage_->ComputeCompactionScore(ioptions_, mutable_cf_options_);
+  return c;
+}
+
 /*
  * Find the optimal path to place a file
  * Given a level, finds the path where levels up to it will fit in levels
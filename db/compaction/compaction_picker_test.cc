@@ -996,6 +996,59 @@ TEST_F(CompactionPickerTest, UniversalIncrementalSpace5) {
   ASSERT_EQ(13, compaction->num_input_files(1));
 }
 
+TEST_F(CompactionPickerTest, UniversalIncrementalNoFullFallback) {
+  // Every range of L3 has a fanout of 10 into L4, too high compared to the
+  // fanout of compacting everything, which happens unless disabled.
+  const uint64_t kFileSize = 100000;
+
+  for (bool fallback : {true, false}) {
+    mutable_cf_options_.max_compaction_bytes = 2400000;
+    mutable_cf_options_.compaction_options_universal.incremental = true;
+    mutable_cf_options_.compaction_options_universal
+        .incremental_fallback_to_full_compaction = fallback;
+    mutable_cf_options_.compaction_options_universal
+        .max_size_amplification_percent = 30;
+    UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+
+    NewVersionStorage(5, kCompactionStyleUniversal);
+
+    Add(0, 1U, "150", "200", kFileSize * 10, 0, 500, 550);
+    Add(2, 2U, "010", "080", kFileSize * 10, 0, 200, 251);
+    for (int i = 1; i <= 4; i++) {
+      Add(3, 10 + i, std::to_string(i * 100 + 10).c_str(),
+          std::to_string(i * 100 + 80).c_str(), kFileSize, 0, 200, 251);
+      Add(4, 20 + i, std::to_string(i * 100).c_str(),
+          std::to_string(i * 100 + 90).c_str(), kFileSize * 10, 0, 101, 150);
+    }
+    UpdateVersionStorageInfo();
+
+    std::unique_ptr<Compaction> compaction(
+        universal_compaction_picker.PickCompaction(
+            cf_name_, mutable_cf_options_, mutable_db_options_,
+            vstorage_.get(), &log_buffer_));
+    ASSERT_TRUE(compaction);
+    ASSERT_EQ(CompactionReason::kUniversalSizeAmplification,
+              compaction->compaction_reason());
+    ASSERT_EQ(4, compaction->output_level());
+    if (fallback) {
+      ASSERT_EQ(0, compaction->start_level());
+      size_t num_input_files = 0;
+      for (size_t i = 0; i < compaction->num_input_levels(); i++) {
+        num_input_files += compaction->num_input_files(i);
+      }
+      ASSERT_EQ(10U, num_input_files);
+    } else {
+      ASSERT_EQ(3, compaction->start_level());
+      ASSERT_EQ(2U, compaction->num_input_files(0));
+      ASSERT_EQ(11U, compaction->input(0, 0)->fd.GetNumber());
+      ASSERT_EQ(12U, compaction->input(0, 1)->fd.GetNumber());
+      ASSERT_EQ(2U, compaction->num_input_files(1));
+      ASSERT_EQ(21U, compaction->input(1, 0)->fd.GetNumber());
+      ASSERT_EQ(22U, compaction->input(1, 1)->fd.GetNumber());
+    }
+  }
+}
+
 TEST_F(CompactionPickerTest,
        PartiallyExcludeL0ToReduceWriteStopForSizeAmpCompaction) {
   const uint64_t kFileSize = 100000;
@@ -1379,6 +1432,48 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping1) {
   ASSERT_GE(uint64_t{55000000}, compaction->OutputFilePreallocationSize());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriByTombstoneDensity) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kByTombstoneDensity;
+  mutable_cf_options_.target_file_size_base = 100000000000;
+  mutable_cf_options_.target_file_size_multiplier = 10;
+  mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+
+  // Same files as CompactionPriMinOverlapping1, which picks file 8
+  Add(2, 6U, "150", "179", 50000000U);
+  Add(2, 7U, "180", "220", 50000000U);
+  Add(2, 8U, "321", "400", 50000000U);
+  Add(2, 9U, "721", "800", 50000000U);
+
+  Add(3, 26U, "150", "170", 260000000U);
+  Add(3, 27U, "171", "179", 260000000U);
+  Add(3, 28U, "191", "220", 260000000U);
+  Add(3, 29U, "221", "300", 260000000U);
+  Add(3, 30U, "750", "900", 260000000U);
+
+  // Files 6 and 9 are half tombstones, but file 6 is the one being read.
+  // File 7 has a few tombstones and file 8 none.
+  const std::vector<FileMetaData*>& files = vstorage_->LevelFiles(2);
+  for (FileMetaData* f : files) {
+    f->num_entries = 100;
+  }
+  files[0]->num_deletions = 50;
+  files[0]->stats.num_reads_sampled = 10;
+  files[1]->num_deletions = 10;
+  files[3]->num_deletions = 50;
+  UpdateVersionStorageInfo();
+
+  ASSERT_EQ(std::vector<int>({0, 3, 1, 2}),
+            vstorage_->FilesByCompactionPri(2));
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, CompactionPriMinOverlapping2) {
   NewVersionStorage(6, kCompactionStyleLevel);
   ioptions_.compaction_pri = kMinOverlappingRatio;
@@ -965,15 +965,31 @@ Compaction* UniversalCompactionBuilder::PickCompactionToReduceSizeAmp() {
   // configurable in the future.
   // This also prevent the case when compaction falls behind and we
   // need to compact more levels for compactions to catch up.
-  if (mutable_cf_options_.compaction_options_universal.incremental) {
-    double fanout_threshold = static_cast<double>(base_sr_size) /
-                              static_cast<double>(candidate_size) * 1.8;
+  // When incremental_fallback_to_full_compaction is false, any fanout goes
+  // instead, to keep compactions small.
+  const CompactionOptionsUniversal& universal_options =
+      mutable_cf_options_.compaction_options_universal;
+  if (universal_options.incremental) {
+    const bool full_fallback =
+        universal_options.incremental_fallback_to_full_compaction ||
+        sorted_runs_[sorted_runs_.size() - 2].level == 0;
+    double fanout_threshold =
+        full_fallback ? static_cast<double>(base_sr_size) /
+                            static_cast<double>(candidate_size) * 1.8
+                      : std::numeric_limits<double>::max();
     Compaction* picked = PickIncrementalForReduceSizeAmp(fanout_threshold);
     if (picked != nullptr) {
       // As the feature is still incremental, picking incremental compaction
       // might fail and we will fall bck to compacting full level.
       return picked;
     }
+    if (!full_fallback) {
+      ROCKS_LOG_BUFFER(log_buffer_,
+                       "[%s] Universal: no incremental compaction to reduce "
+                       "size amp, will retry",
+                       cf_name_.c_str());
+      return nullptr;
+    }
   }
   return PickCompactionWithSortedRunRange(
       start_index, end_index, CompactionReason::kUniversalSizeAmplification);
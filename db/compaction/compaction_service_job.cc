@@ -217,6 +217,12 @@ void CompactionServiceCompactionJob::RecordCompactionIOStats() {
   compaction_result_->bytes_read += IOSTATS(bytes_read);
   compaction_result_->bytes_written += IOSTATS(bytes_written);
   CompactionJob::RecordCompactionIOStats();
+  if (on_progress_) {
+    CompactionServiceProgress progress;
+    progress.bytes_read = compaction_result_->bytes_read;
+    progress.bytes_written = compaction_result_->bytes_written;
+    on_progress_(progress);
+  }
 }
 
 CompactionServiceCompactionJob::CompactionServiceCompactionJob(
@@ -232,7 +238,8 @@ CompactionServiceCompactionJob::CompactionServiceCompactionJob(
     const std::string& db_id, const std::string& db_session_id,
     std::string output_path,
     const CompactionServiceInput& compaction_service_input,
-    CompactionServiceResult* compaction_service_result)
+    CompactionServiceResult* compaction_service_result,
+    std::function<void(const CompactionServiceProgress&)> on_progress)
     : CompactionJob(
           job_id, compaction, db_options, mutable_db_options, file_options,
           versions, shutting_down, log_buffer, nullptr, output_directory,
@@ -246,7 +253,8 @@ CompactionServiceCompactionJob::CompactionServiceCompactionJob(
           compaction->column_family_data()->GetFullHistoryTsLow()),
       output_path_(std::move(output_path)),
       compaction_input_(compaction_service_input),
-      compaction_result_(compaction_service_result) {}
+      compaction_result_(compaction_service_result),
+      on_progress_(std::move(on_progress)) {}
 
 Status CompactionServiceCompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
@@ -570,6 +578,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionJobStats, total_output_bytes_blob),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"total_trivially_moved_bytes",
+         {offsetof(struct CompactionJobStats, total_trivially_moved_bytes),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"num_records_replaced",
          {offsetof(struct CompactionJobStats, num_records_replaced),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -610,6 +622,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionJobStats, file_prepare_write_nanos),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"input_read_cpu_nanos",
+         {offsetof(struct CompactionJobStats, input_read_cpu_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"output_write_cpu_nanos",
+         {offsetof(struct CompactionJobStats, output_write_cpu_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"merge_cpu_nanos",
+         {offsetof(struct CompactionJobStats, merge_cpu_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"smallest_output_key_prefix",
          {offsetof(struct CompactionJobStats, smallest_output_key_prefix),
           OptionType::kEncodedString, OptionVerificationType::kNormal,
@@ -89,6 +89,10 @@ class MyTestCompactionService : public CompactionService {
 
     OpenAndCompactOptions options;
     options.canceled = &canceled_;
+    options.on_progress = [this](const CompactionServiceProgress& progress) {
+      progress_calls_.fetch_add(1);
+      last_progress_bytes_written_.store(progress.bytes_written);
+    };
 
     Status s = DB::OpenAndCompact(
         options, db_path_, db_path_ + "/" + std::to_string(info.job_id),
@@ -132,6 +136,16 @@ class MyTestCompactionService : public CompactionService {
 
   void SetCanceled(bool canceled) { canceled_ = canceled; }
 
+  void CancelAwaitingJobs() override { cancel_awaiting_jobs_num_.fetch_add(1); }
+
+  int GetCancelAwaitingJobsNum() { return cancel_awaiting_jobs_num_.load(); }
+
+  int GetProgressCalls() { return progress_calls_.load(); }
+
+  uint64_t GetLastProgressBytesWritten() {
+    return last_progress_bytes_written_.load();
+  }
+
  private:
   InstrumentedMutex mutex_;
   std::atomic_int compaction_num_{0};
@@ -153,6 +167,9 @@ class MyTestCompactionService : public CompactionService {
   std::vector<std::shared_ptr<TablePropertiesCollectorFactory>>
       table_properties_collector_factories_;
   std::atomic_bool canceled_{false};
+  std::atomic_int cancel_awaiting_jobs_num_{0};
+  std::atomic_int progress_calls_{0};
+  std::atomic<uint64_t> last_progress_bytes_written_{0};
 };
 
 class CompactionServiceTest : public DBTestBase {
@@ -409,6 +426,24 @@ TEST_F(CompactionServiceTest, CancelCompactionOnRemoteSide) {
   VerifyTestData();
 }
 
+TEST_F(CompactionServiceTest, ProgressAndCancelAwaitingJobs) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  ReopenWithCompactionService(&options);
+  GenerateTestData();
+
+  auto my_cs = GetCompactionService();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GE(my_cs->GetCompactionNum(), 1);
+  ASSERT_GE(my_cs->GetProgressCalls(), my_cs->GetCompactionNum());
+  ASSERT_GT(my_cs->GetLastProgressBytesWritten(), 0);
+  VerifyTestData();
+
+  ASSERT_EQ(my_cs->GetCancelAwaitingJobsNum(), 0);
+  Close();
+  ASSERT_GE(my_cs->GetCancelAwaitingJobsNum(), 1);
+}
+
 TEST_F(CompactionServiceTest, FailedToStart) {
   Options options = CurrentOptions();
   options.disable_auto_compactions = true;
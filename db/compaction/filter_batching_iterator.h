@@ -0,0 +1,203 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "port/lang.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/compaction_filter.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// An internal iterator that reads CompactionFilter::FilterBatchSize() entries
+// at a time from the wrapped iterator, copies them, and passes the newest
+// version of each plain key-value among them to FilterBatch() before handing
+// them out one by one. CompactionIterator then asks decision()
+// instead of calling FilterV3() while it is positioned on such a key.
+//
+// Only supports forward iteration, which is all compactions and flushes need.
+class FilterBatchingIterator : public InternalIterator {
+ public:
+  FilterBatchingIterator(InternalIterator* iter,
+                         const CompactionFilter* compaction_filter,
+                         const Comparator* ucmp, int level)
+      : iter_(iter),
+        compaction_filter_(compaction_filter),
+        ucmp_(ucmp),
+        level_(level),
+        batch_size_(compaction_filter->FilterBatchSize()) {
+    assert(iter_);
+    assert(ucmp_);
+    assert(batch_size_ > 0);
+    if (iter_->Valid()) {
+      Fill();
+    }
+  }
+
+  bool Valid() const override { return pos_ < num_entries_; }
+
+  void SeekToFirst() override {
+    iter_->SeekToFirst();
+    has_last_user_key_ = false;
+    Fill();
+  }
+
+  void Seek(const Slice& target) override {
+    iter_->Seek(target);
+    has_last_user_key_ = false;
+    Fill();
+  }
+
+  void Next() override {
+    assert(Valid());
+    if (++pos_ == num_entries_) {
+      Fill();
+    }
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return entries_[pos_].key;
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    return entries_[pos_].value;
+  }
+
+  Status status() const override {
+    return Valid() ? Status::OK() : iter_->status();
+  }
+
+  bool IsDeleteRangeSentinelKey() const override {
+    assert(Valid());
+    return entries_[pos_].is_range_del_sentinel;
+  }
+
+  // The decision FilterBatch() made for the current entry, with the new value
+  // moved to *new_value for kChangeValue, or kUndetermined if it made none.
+  CompactionFilter::Decision decision(std::string* new_value) {
+    assert(Valid());
+    Entry& entry = entries_[pos_];
+    if (entry.decision == CompactionFilter::Decision::kChangeValue) {
+      new_value->swap(entry.new_value);
+    }
+    return entry.decision;
+  }
+
+  // Unused InternalIterator methods
+  void SeekToLast() override { assert(false); }
+  void SeekForPrev(const Slice& /* target */) override { assert(false); }
+  void Prev() override { assert(false); }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string value;
+    bool is_range_del_sentinel = false;
+    CompactionFilter::Decision decision =
+        CompactionFilter::Decision::kUndetermined;
+    std::string new_value;
+  };
+
+  // Reads the next batch from iter_ and runs FilterBatch() on it.
+  void Fill() {
+    pos_ = 0;
+    num_entries_ = 0;
+    for (; num_entries_ < batch_size_ && iter_->Valid(); iter_->Next()) {
+      if (num_entries_ == entries_.size()) {
+        entries_.emplace_back();
+      }
+      Entry& entry = entries_[num_entries_++];
+      entry.key.assign(iter_->key().data(), iter_->key().size());
+      entry.value.assign(iter_->value().data(), iter_->value().size());
+      entry.is_range_del_sentinel = iter_->IsDeleteRangeSentinelKey();
+      entry.decision = CompactionFilter::Decision::kUndetermined;
+    }
+
+    // Pick the newest version of each user key, as CompactionIterator filters
+    // only those. The entries can't move any more, so the slices stay valid.
+    keys_.clear();
+    values_.clear();
+    batch_entries_.clear();
+    Slice last_user_key = last_user_key_;
+    bool last_user_key_changed = false;
+    for (size_t i = 0; i < num_entries_; i++) {
+      const Entry& entry = entries_[i];
+      if (entry.is_range_del_sentinel) {
+        continue;
+      }
+      ParsedInternalKey ikey;
+      if (!ParseInternalKey(entry.key, &ikey, false /* log_err_key */).ok()) {
+        has_last_user_key_ = false;
+        continue;
+      }
+      if (ikey.type == kTypeValue &&
+          (!has_last_user_key_ ||
+           ucmp_->Compare(ikey.user_key, last_user_key) != 0)) {
+        keys_.push_back(ikey.user_key);
+        values_.push_back(entry.value);
+        batch_entries_.push_back(i);
+      }
+      last_user_key = ikey.user_key;
+      last_user_key_changed = true;
+      has_last_user_key_ = true;
+    }
+    if (last_user_key_changed) {
+      last_user_key_.assign(last_user_key.data(), last_user_key.size());
+    }
+    if (keys_.empty()) {
+      return;
+    }
+
+    decisions_.assign(keys_.size(), CompactionFilter::Decision::kUndetermined);
+    new_values_.clear();
+    new_values_.resize(keys_.size());
+    compaction_filter_->FilterBatch(level_, keys_, values_, &decisions_,
+                                    &new_values_);
+    for (size_t i = 0; i < batch_entries_.size(); i++) {
+      Entry& entry = entries_[batch_entries_[i]];
+      switch (decisions_[i]) {
+        case CompactionFilter::Decision::kChangeValue:
+          entry.new_value.swap(new_values_[i]);
+          FALLTHROUGH_INTENDED;
+        case CompactionFilter::Decision::kKeep:
+        case CompactionFilter::Decision::kRemove:
+          entry.decision = decisions_[i];
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  InternalIterator* iter_;
+  const CompactionFilter* compaction_filter_;
+  const Comparator* ucmp_;
+  const int level_;
+  const size_t batch_size_;
+
+  std::vector<Entry> entries_;
+  size_t num_entries_ = 0;
+  size_t pos_ = 0;
+  // The user key of the last entry of the previous batch
+  std::string last_user_key_;
+  bool has_last_user_key_ = false;
+
+  // Arguments to FilterBatch(), kept around to reuse their memory
+  std::vector<Slice> keys_;
+  std::vector<Slice> values_;
+  std::vector<size_t> batch_entries_;
+  std::vector<CompactionFilter::Decision> decisions_;
+  std::vector<std::string> new_values_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "rocksdb/comparator.h"
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
@@ -20,6 +21,13 @@ static std::unordered_map<std::string, OptionTypeInfo>
           OptionTypeFlags::kNone}},
 };
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    sst_next_level_type_info = {
+        {"min_file_size",
+         {0, OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
 SstPartitionerFixedPrefixFactory::SstPartitionerFixedPrefixFactory(size_t len)
     : len_(len) {
   RegisterOptions("Length", &len_, &sst_fixed_prefix_type_info);
@@ -56,6 +64,77 @@ std::shared_ptr<SstPartitionerFactory> NewSstPartitionerFixedPrefixFactory(
   return std::make_shared<SstPartitionerFixedPrefixFactory>(prefix_len);
 }
 
+SstPartitionerNextLevel::SstPartitionerNextLevel(const Context& context,
+                                                 uint64_t min_file_size)
+    : ucmp_(context.user_comparator != nullptr ? context.user_comparator
+                                               : BytewiseComparator()),
+      min_file_size_(min_file_size) {
+  // Without the smallest keys, treat each segment as a single file.
+  const size_t num_files = context.OutputNextLevelSegmentCount();
+  const bool has_smallest_keys =
+      context.output_next_level_smallest_keys.size() == num_files;
+  smallest_keys_.reserve(num_files);
+  largest_keys_.reserve(num_files);
+  for (size_t i = 0; i < num_files; i++) {
+    Slice smallest, largest;
+    context.OutputNextLevelSegment(i, &smallest, &largest, nullptr);
+    if (has_smallest_keys) {
+      smallest = context.output_next_level_smallest_keys[i];
+    }
+    smallest_keys_.push_back(smallest.ToString());
+    largest_keys_.push_back(largest.ToString());
+  }
+}
+
+size_t SstPartitionerNextLevel::Region(const Slice& user_key) const {
+  // The first file not entirely before user_key
+  const size_t i = static_cast<size_t>(
+      std::lower_bound(largest_keys_.begin(), largest_keys_.end(), user_key,
+                       [this](const std::string& largest, const Slice& key) {
+                         return ucmp_->Compare(largest, key) < 0;
+                       }) -
+      largest_keys_.begin());
+  if (i < smallest_keys_.size() &&
+      ucmp_->Compare(smallest_keys_[i], user_key) <= 0) {
+    return 2 * i + 1;
+  }
+  return 2 * i;
+}
+
+PartitionerResult SstPartitionerNextLevel::ShouldPartition(
+    const PartitionerRequest& request) {
+  if (largest_keys_.empty() ||
+      request.current_output_file_size < min_file_size_) {
+    return kNotRequired;
+  }
+  return Region(*request.prev_user_key) != Region(*request.current_user_key)
+             ? kRequired
+             : kNotRequired;
+}
+
+bool SstPartitionerNextLevel::CanDoTrivialMove(
+    const Slice& smallest_user_key, const Slice& largest_user_key) {
+  return Region(smallest_user_key) == Region(largest_user_key);
+}
+
+SstPartitionerNextLevelFactory::SstPartitionerNextLevelFactory(
+    uint64_t min_file_size)
+    : min_file_size_(min_file_size) {
+  RegisterOptions("MinFileSize", &min_file_size_, &sst_next_level_type_info);
+}
+
+std::unique_ptr<SstPartitioner>
+SstPartitionerNextLevelFactory::CreatePartitioner(
+    const SstPartitioner::Context& context) const {
+  return std::unique_ptr<SstPartitioner>(
+      new SstPartitionerNextLevel(context, min_file_size_));
+}
+
+std::shared_ptr<SstPartitionerFactory> NewSstPartitionerNextLevelFactory(
+    uint64_t min_file_size) {
+  return std::make_shared<SstPartitionerNextLevelFactory>(min_file_size);
+}
+
 namespace {
 static int RegisterSstPartitionerFactories(ObjectLibrary& library,
                                            const std::string& /*arg*/) {
@@ -67,7 +146,15 @@ static int RegisterSstPartitionerFactories(ObjectLibrary& library,
         guard->reset(new SstPartitionerFixedPrefixFactory(0));
         return guard->get();
       });
-  return 1;
+  library.AddFactory<SstPartitionerFactory>(
+      SstPartitionerNextLevelFactory::kClassName(),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<SstPartitionerFactory>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new SstPartitionerNextLevelFactory(0));
+        return guard->get();
+      });
+  return 2;
 }
 }  // namespace
 
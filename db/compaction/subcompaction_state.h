@@ -169,11 +169,22 @@ class SubcompactionState {
 
   // Add all the new files from this compaction to version_edit
   void AddOutputsEdit(VersionEdit* out_edit) const {
+    const SequenceNumber largest_input_seqno =
+        compaction->GetLargestSeqnoOfInputs();
+    auto add_file = [&](int level, const FileMetaData& meta) {
+      if (largest_input_seqno <= meta.fd.largest_seqno) {
+        out_edit->AddFile(level, meta);
+        return;
+      }
+      FileMetaData f = meta;
+      f.largest_input_seqno = largest_input_seqno;
+      out_edit->AddFile(level, f);
+    };
     for (const auto& file : penultimate_level_outputs_.outputs_) {
-      out_edit->AddFile(compaction->GetPenultimateLevel(), file.meta);
+      add_file(compaction->GetPenultimateLevel(), file.meta);
     }
     for (const auto& file : compaction_outputs_.outputs_) {
-      out_edit->AddFile(compaction->output_level(), file.meta);
+      add_file(compaction->output_level(), file.meta);
     }
   }
 
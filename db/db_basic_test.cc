@@ -340,6 +340,58 @@ TEST_F(DBBasicTest, CompactedDB) {
             "Not implemented: Not supported operation in read only mode.");
 }
 
+TEST_F(DBBasicTest, CompactedDBMultipleLevels) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  Reopen(options);
+
+  ASSERT_OK(Put("a", "a3"));
+  ASSERT_OK(Put("b", "b3"));
+  ASSERT_OK(Put("c", "c3"));
+  ASSERT_OK(Put("d", "d3"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(3);
+  ASSERT_OK(Put("a", "a2"));
+  ASSERT_OK(Delete("b"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "c",
+                             "d"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(Put("a", "a1"));
+  ASSERT_OK(Put("e", "e1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b", "b0"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("2,1,0,1", FilesPerLevel());
+  Close();
+
+  options.max_open_files = -1;
+  ASSERT_OK(ReadOnlyReopen(options));
+  Status s = Put("new", "value");
+  ASSERT_EQ(s.ToString(),
+            "Not implemented: Not supported in compacted db mode.");
+  ASSERT_EQ("a1", Get("a"));
+  ASSERT_EQ("b0", Get("b"));
+  ASSERT_EQ("NOT_FOUND", Get("c"));
+  ASSERT_EQ("d3", Get("d"));
+  ASSERT_EQ("e1", Get("e"));
+  ASSERT_EQ("NOT_FOUND", Get("f"));
+
+  std::vector<std::string> values;
+  std::vector<Status> status_list = dbfull()->MultiGet(
+      ReadOptions(),
+      std::vector<Slice>({Slice("a"), Slice("c"), Slice("d"), Slice("f")}),
+      &values);
+  ASSERT_EQ(4, status_list.size());
+  ASSERT_OK(status_list[0]);
+  ASSERT_EQ("a1", values[0]);
+  ASSERT_TRUE(status_list[1].IsNotFound());
+  ASSERT_OK(status_list[2]);
+  ASSERT_EQ("d3", values[2]);
+  ASSERT_TRUE(status_list[3].IsNotFound());
+}
+
 TEST_F(DBBasicTest, LevelLimitReopen) {
   Options options = CurrentOptions();
   CreateAndReopenWithCF({"pikachu"}, options);
@@ -597,6 +649,39 @@ TEST_F(DBBasicTest, ManifestRollOver) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBasicTest, ManifestRollOverBySpaceAmp) {
+  for (uint32_t amp_pct : {0, 50}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.max_manifest_space_amp_pct = amp_pct;
+    DestroyAndReopen(options);
+
+    VersionSet* versions = dbfull()->GetVersionSet();
+    uint64_t manifest_file_number = dbfull()->TEST_Current_Manifest_FileNo();
+    int num_roll_overs = 0;
+    for (int i = 0; i < 30; ++i) {
+      ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+      ASSERT_OK(Flush());
+      if (dbfull()->TEST_Current_Manifest_FileNo() != manifest_file_number) {
+        manifest_file_number = dbfull()->TEST_Current_Manifest_FileNo();
+        ++num_roll_overs;
+      }
+      ASSERT_LE(versions->manifest_file_size(),
+                versions->ManifestRollOverSize() + 4096);
+    }
+    if (amp_pct == 0) {
+      ASSERT_EQ(0, num_roll_overs);
+    } else {
+      ASSERT_GE(num_roll_overs, 2);
+    }
+
+    Reopen(options);
+    for (int i = 0; i < 30; ++i) {
+      ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+    }
+  }
+}
+
 TEST_F(DBBasicTest, IdentityAcrossRestarts) {
   constexpr size_t kMinIdSize = 10;
   do {
@@ -2678,6 +2763,149 @@ INSTANTIATE_TEST_CASE_P(DBMultiGetAsyncIOTest, DBMultiGetAsyncIOTest,
                         testing::Bool());
 #endif  // USE_COROUTINES
 
+#ifndef USE_COROUTINES
+TEST_F(DBBasicTest, MultiGetPrefetchAcrossLevels) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("b", "val_l2"));
+  ASSERT_OK(Put("x", "val_l2"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  ASSERT_OK(Put("a", "val_l1"));
+  ASSERT_OK(Put("z", "val_l1"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+
+  int num_prefetches = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTable::PrefetchForMultiGet:Prefetch",
+      [&](void* /*arg*/) { ++num_prefetches; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<Slice> keys{"a", "b"};
+  std::vector<PinnableSlice> values(keys.size());
+  std::vector<Status> statuses(keys.size());
+  ReadOptions ro;
+  ro.async_io = true;
+  // "a" only in L1, and "b" ruled out there by the filter, only in L2
+  for (int expected_prefetches : {2, 0}) {
+    num_prefetches = 0;
+    db_->MultiGet(ro, db_->DefaultColumnFamily(), keys.size(), keys.data(),
+                  values.data(), statuses.data());
+    ASSERT_OK(statuses[0]);
+    ASSERT_OK(statuses[1]);
+    ASSERT_EQ(values[0], "val_l1");
+    ASSERT_EQ(values[1], "val_l2");
+    // None once the blocks are in the block cache
+    ASSERT_EQ(num_prefetches, expected_prefetches);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+#endif  // USE_COROUTINES
+
+TEST_F(DBBasicTest, MultiGetStreaming) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("c", "val_l2"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  ASSERT_OK(Put("a", "val_l1"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(Put("b", "val_mem"));
+
+  std::vector<Slice> keys{"d", "c", "b", "a"};
+  std::vector<PinnableSlice> values(keys.size());
+  std::vector<Status> statuses(keys.size());
+  std::vector<size_t> order;
+  std::vector<std::string> values_when_done(keys.size());
+  std::vector<Status> statuses_when_done(keys.size());
+  db_->MultiGetStreaming(ReadOptions(), db_->DefaultColumnFamily(),
+                         keys.size(), keys.data(), values.data(),
+                         statuses.data(), [&](size_t index) {
+                           order.push_back(index);
+                           values_when_done[index] = values[index].ToString();
+                           statuses_when_done[index] = statuses[index];
+                         });
+
+  // The memtable first, then level by level, and the keys not found last
+  ASSERT_EQ(order, std::vector<size_t>({2, 3, 1, 0}));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(statuses_when_done[i], statuses[i]);
+    ASSERT_EQ(values_when_done[i], values[i].ToString());
+  }
+  ASSERT_TRUE(statuses[0].IsNotFound());
+  ASSERT_EQ(values[1], "val_l2");
+  ASSERT_EQ(values[2], "val_mem");
+  ASSERT_EQ(values[3], "val_l1");
+}
+
+TEST_F(DBBasicTest, ParallelScan) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    if (i % 500 == 499) {
+      ASSERT_OK(Flush());
+    }
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(Put(Key(1000), "val_mem"));
+
+  size_t num_boundaries = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::ParallelScan:Boundaries", [&](void* arg) {
+        num_boundaries = static_cast<std::vector<std::string>*>(arg)->size();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::string start = Key(100);
+  std::string limit = Key(1900);
+  port::Mutex mutex;
+  std::map<std::string, std::string> scanned;
+  int num_duplicates = 0;
+  ASSERT_OK(db_->ParallelScan(
+      ReadOptions(), db_->DefaultColumnFamily(), Range(start, limit),
+      /*num_threads=*/4, [&](const Slice& key, const Slice& value) {
+        MutexLock l(&mutex);
+        if (!scanned.emplace(key.ToString(), value.ToString()).second) {
+          ++num_duplicates;
+        }
+        return true;
+      }));
+  ASSERT_GT(num_boundaries, 0);
+  ASSERT_EQ(num_duplicates, 0);
+  ASSERT_EQ(scanned.size(), 1800);
+  ASSERT_EQ(scanned.begin()->first, start);
+  ASSERT_EQ(scanned.rbegin()->first, Key(1899));
+  ASSERT_EQ(scanned[Key(1000)], "val_mem");
+
+  // Stopped by the callback, each thread sees at most one more key
+  std::atomic<int> num_scanned{0};
+  ASSERT_OK(db_->ParallelScan(ReadOptions(), db_->DefaultColumnFamily(),
+                              Range(start, limit), /*num_threads=*/4,
+                              [&](const Slice&, const Slice&) {
+                                ++num_scanned;
+                                return false;
+                              }));
+  ASSERT_LE(num_scanned.load(), 4);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBBasicTest, MultiGetStats) {
   Options options;
   options.create_if_missing = true;
@@ -3074,6 +3302,45 @@ TEST_F(DBBasicTest, IncrementalRecoveryNoCorrupt) {
   }
 }
 
+TEST_F(DBBasicTest, RecoverManifestPipelined) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_open_files = -1;
+  DestroyAndReopen(options);
+  CreateAndReopenWithCF({"pikachu", "eevee"}, options);
+  const int kNumCfs = 3;
+  const int kNumFlushes = 100;
+  // Many more edits than a batch handed over by the reader thread
+  for (int cf = 0; cf < kNumCfs; ++cf) {
+    for (int i = 0; i < kNumFlushes; ++i) {
+      ASSERT_OK(Put(cf, Key(i), std::to_string(cf) + "_" + std::to_string(i)));
+      ASSERT_OK(Flush(cf));
+    }
+  }
+  Close();
+
+  size_t recovered_edits = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionEditHandlerBase::Iterate:Finish", [&](void* arg) {
+        recovered_edits = *static_cast<size_t*>(arg);
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  options.max_file_opening_threads = 4;
+  ReopenWithColumnFamilies({kDefaultColumnFamilyName, "pikachu", "eevee"},
+                           options);
+  ASSERT_GE(recovered_edits, static_cast<size_t>(kNumCfs * kNumFlushes));
+  for (int cf = 0; cf < kNumCfs; ++cf) {
+    for (int i = 0; i < kNumFlushes; ++i) {
+      ASSERT_EQ(std::to_string(cf) + "_" + std::to_string(i), Get(cf, Key(i)));
+    }
+    ASSERT_EQ(kNumFlushes, NumTableFilesAtLevel(0, cf));
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBBasicTest, BestEffortsRecoveryWithVersionBuildingFailure) {
   Options options = CurrentOptions();
   DestroyAndReopen(options);
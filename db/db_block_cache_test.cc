@@ -14,6 +14,7 @@
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_key.h"
 #include "cache/lru_cache.h"
+#include "cache/tenant_cache.h"
 #include "cache/typed_cache.h"
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
@@ -32,6 +33,7 @@
 #include "util/math.h"
 #include "util/random.h"
 #include "utilities/fault_injection_fs.h"
+#include "utilities/memory_allocators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -1347,6 +1349,235 @@ TEST_F(DBBlockCacheTest, HyperClockCacheReportProblems) {
   EXPECT_EQ(logger->PopCounts(), (std::array<int, 3>{{0, 1, 0}}));
 }
 
+TEST_F(DBBlockCacheTest, TenantCacheQuotas) {
+  constexpr size_t kMiB = 1024 * 1024;
+  constexpr size_t kEntrySize = 64 * 1024;
+  LRUCacheOptions shared_opts;
+  shared_opts.capacity = 4 * kMiB;
+  shared_opts.num_shard_bits = 0;
+  shared_opts.strict_capacity_limit = true;
+  shared_opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  std::shared_ptr<Cache> shared = shared_opts.MakeSharedCache();
+
+  LRUCacheOptions tenant_opts;
+  tenant_opts.num_shard_bits = 0;
+  tenant_opts.metadata_charge_policy = kDontChargeCacheMetadata;
+
+  TenantCacheOptions a_opts;
+  a_opts.tenant_id = "a";
+  tenant_opts.capacity = 2 * kMiB;
+  a_opts.cache = tenant_opts.MakeSharedCache();
+  a_opts.min_usage = 1 * kMiB;
+  std::shared_ptr<Cache> a = NewTenantCache(shared, a_opts);
+  ASSERT_NE(a, nullptr);
+
+  TenantCacheOptions b_opts;
+  b_opts.tenant_id = "b";
+  tenant_opts.capacity = 4 * kMiB;
+  b_opts.cache = tenant_opts.MakeSharedCache();
+  std::shared_ptr<Cache> b = NewTenantCache(shared, b_opts);
+  ASSERT_NE(b, nullptr);
+
+  auto* tenant_a = static_cast<TenantCache*>(a.get());
+  auto* tenant_b = static_cast<TenantCache*>(b.get());
+
+  // The guaranteed minimum is reserved up front
+  EXPECT_EQ(tenant_a->GetReservedUsage(), 1 * kMiB);
+  EXPECT_EQ(tenant_b->GetReservedUsage(), 0);
+  EXPECT_EQ(shared->GetUsage(), 1 * kMiB);
+
+  auto fill = [&](Cache& cache, const std::string& prefix, size_t bytes) {
+    void* fake_value = &cache;
+    for (size_t i = 0; i * kEntrySize < bytes; ++i) {
+      ASSERT_OK(cache.Insert(prefix + std::to_string(i), fake_value,
+                             &kNoopCacheItemHelper, kEntrySize));
+    }
+  };
+
+  // A tenant stays within its hard maximum
+  fill(*a, "a", 3 * kMiB);
+  EXPECT_EQ(a->GetUsage(), 2 * kMiB);
+  EXPECT_EQ(tenant_a->GetReservedUsage(), 2 * kMiB);
+
+  // Another tenant only gets what is left of the shared cache, and does not
+  // evict anything of the first
+  fill(*b, "b", 4 * kMiB);
+  EXPECT_LE(b->GetUsage(), 2 * kMiB);
+  EXPECT_LE(tenant_b->GetReservedUsage(), 2 * kMiB);
+  EXPECT_EQ(a->GetUsage(), 2 * kMiB);
+  EXPECT_LE(shared->GetUsage(), 4 * kMiB);
+
+  // Nothing below the guaranteed minimum is given back
+  a->EraseUnRefEntries();
+  EXPECT_EQ(a->GetUsage(), 0);
+  EXPECT_EQ(tenant_a->GetReservedUsage(), 1 * kMiB);
+
+  // Per-tenant usage is exported by the DB
+  auto table_options = GetTableOptions();
+  table_options.block_cache = a;
+  auto options = GetOptions(table_options);
+  Reopen(options);
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("bar", Get("foo"));
+
+  a->SetCapacity(3 * kMiB);
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheTenantStats, &values));
+  EXPECT_EQ(values["tenant-id"], "a");
+  EXPECT_EQ(values["usage"], std::to_string(a->GetUsage()));
+  EXPECT_EQ(values["min-usage"], std::to_string(1 * kMiB));
+  EXPECT_EQ(values["max-usage"], std::to_string(3 * kMiB));
+  EXPECT_EQ(values["reserved"],
+            std::to_string(tenant_a->GetReservedUsage()));
+
+  // Not available for other caches
+  table_options.block_cache = shared;
+  options = GetOptions(table_options);
+  Reopen(options);
+  ASSERT_FALSE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheTenantStats, &values));
+}
+
+TEST_F(DBBlockCacheTest, WarmUpFromPersistedHotness) {
+  auto table_options = GetTableOptions();
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  auto options = GetOptions(table_options);
+  options.block_cache_hotness_persist_period_sec = 3600;
+  DestroyAndReopen(options);
+
+  // One key per data block
+  for (int i = 0; i < 20; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForBlockCacheWarmUp();
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  dbfull()->TEST_PersistBlockCacheHotness();
+  ASSERT_OK(env_->FileExists(BlockCacheHotnessFileName(dbname_)));
+
+  // Reopen with an empty block cache
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  dbfull()->TEST_WaitForBlockCacheWarmUp();
+  ASSERT_OK(options.statistics->Reset());
+
+  // The blocks read before are cached again
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  EXPECT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS), 0);
+  EXPECT_EQ(TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS), 0);
+  EXPECT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT), 5);
+
+  // But not the others
+  ASSERT_EQ("value10", Get(Key(10)));
+  EXPECT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS), 1);
+
+  // Nothing is loaded without the option
+  options.block_cache_hotness_persist_period_sec = 0;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_OK(options.statistics->Reset());
+  ASSERT_EQ("value0", Get(Key(0)));
+  EXPECT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS), 1);
+
+  // Destroying the DB removes the record
+  Close();
+  ASSERT_OK(DestroyDB(dbname_, options));
+  ASSERT_TRUE(
+      env_->FileExists(BlockCacheHotnessFileName(dbname_)).IsNotFound());
+}
+
+TEST_F(DBBlockCacheTest, DynamicMetadataPinning) {
+  auto table_options = GetTableOptions();
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  table_options.partition_filters = true;
+  table_options.metadata_block_size = 128;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  table_options.metadata_cache_options.top_level_index_pinning =
+      PinningTier::kNone;
+  table_options.metadata_cache_options.partition_pinning = PinningTier::kNone;
+  table_options.metadata_cache_options.unpartitioned_pinning =
+      PinningTier::kNone;
+  table_options.pin_top_level_index_and_filter = false;
+  table_options.metadata_cache_options.dynamic_pinning_budget = 1 << 20;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  auto options = GetOptions(table_options);
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 500; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(table_options.block_cache->GetPinnedUsage(), 0);
+
+  // Reads sample their index and filter block accesses, and pin the blocks
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 500; i++) {
+      ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+    }
+  }
+  const size_t pinned_usage = table_options.block_cache->GetPinnedUsage();
+  EXPECT_GT(pinned_usage, 0);
+  EXPECT_LE(pinned_usage,
+            table_options.metadata_cache_options.dynamic_pinning_budget);
+
+  // Closing the table readers unpins their blocks
+  Close();
+  EXPECT_EQ(table_options.block_cache->GetPinnedUsage(), 0);
+}
+
+TEST_F(DBBlockCacheTest, FarMemoryDataBlocks) {
+  auto far_allocator = std::make_shared<CountedMemoryAllocator>();
+  auto table_options = GetTableOptions();
+  table_options.block_cache = NewLRUCache(8 << 20);
+  table_options.far_memory_allocator = far_allocator;
+  table_options.far_memory_promotion_hits = 1;
+  auto options = GetOptions(table_options);
+  options.num_levels = 3;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 500; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  // The data blocks of a table above the last level stay in DRAM
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("1", FilesPerLevel());
+  for (int i = 0; i < 500; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+  ASSERT_EQ(0, TestGetTickerCount(options, BLOCK_CACHE_FAR_MEMORY_ADD));
+  ASSERT_EQ(0, far_allocator->GetNumAllocations());
+
+  // The data blocks of a table of the last level are cached in far memory
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,0,1", FilesPerLevel());
+  table_options.block_cache->EraseUnRefEntries();
+  ASSERT_EQ("value0", Get(Key(0)));
+  ASSERT_EQ(1, TestGetTickerCount(options, BLOCK_CACHE_FAR_MEMORY_ADD));
+  EXPECT_GT(far_allocator->GetNumAllocations(), 0);
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheEntryStats, &values));
+  EXPECT_GT(std::stoull(values[BlockCacheEntryStatsMapKeys::FarMemoryBytes()]),
+            0);
+
+  // A hit promotes the block to DRAM, and the next ones find it there
+  ASSERT_EQ("value0", Get(Key(0)));
+  ASSERT_EQ("value0", Get(Key(0)));
+  EXPECT_EQ(1, TestGetTickerCount(options, BLOCK_CACHE_FAR_MEMORY_PROMOTE));
+  EXPECT_EQ(far_allocator->GetNumAllocations(),
+            far_allocator->GetNumDeallocations());
+}
 
 class DBBlockCacheKeyTest
     : public DBTestBase,
@@ -1775,6 +1775,67 @@ TEST_F(DBBloomFilterTest, ContextCustomFilterPolicy) {
   }
 }
 
+TEST_F(DBBloomFilterTest, RangeFilterPolicy) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(
+      NewRangeFilterPolicy(10, /*prefix_len*/ 1, /*levels*/ 8));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Keys are "k" followed by a big-endian number
+  auto key = [](uint64_t value) {
+    std::string k = "k";
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      k.push_back(static_cast<char>(value >> shift));
+    }
+    return k;
+  };
+  const uint64_t kNumKeys = 1000;
+  for (uint64_t i = 1; i <= kNumKeys; ++i) {
+    ASSERT_OK(Put(key(i * 1000), "v"));
+  }
+  ASSERT_OK(Flush());
+
+  std::string upper_bound;
+  Slice upper_bound_slice;
+  ReadOptions ro;
+  ro.iterate_upper_bound = &upper_bound_slice;
+  for (uint64_t i = 1; i <= kNumKeys; ++i) {
+    // Non-empty range
+    upper_bound = key(i * 1000 + 50);
+    upper_bound_slice = upper_bound;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    iter->Seek(key(i * 1000 - 50));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(iter->key(), key(i * 1000));
+    iter->Next();
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+
+    // Empty range
+    upper_bound = key(i * 1000 + 101);
+    upper_bound_slice = upper_bound;
+    iter.reset(db_->NewIterator(ro));
+    iter->Seek(key(i * 1000 + 1));
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+  }
+  // Most empty ranges are ruled out by the filter
+  EXPECT_GT(TestGetTickerCount(options, NON_LAST_LEVEL_SEEK_FILTERED),
+            kNumKeys * 8 / 10);
+
+  // Without an upper bound, the filter is not consulted
+  ASSERT_OK(options.statistics->Reset());
+  ro.iterate_upper_bound = nullptr;
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+  iter->Seek(key(1001));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(iter->key(), key(2000));
+  ASSERT_EQ(TestGetTickerCount(options, NON_LAST_LEVEL_SEEK_FILTERED), 0);
+}
+
 TEST_F(DBBloomFilterTest, MutatingRibbonFilterPolicy) {
   // Test that RibbonFilterPolicy has a mutable bloom_before_level fields that
   // can be updated through SetOptions
@@ -2020,6 +2081,51 @@ TEST_F(DBBloomFilterTest, MemtableWholeKeyBloomFilterMultiGet) {
   db_->ReleaseSnapshot(snapshot);
 }
 
+TEST_F(DBBloomFilterTest, MultiKeyMayExist) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // The even keys, in two files and the memtable
+  const int kNumKeys = 300;
+  for (int i = 0; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), "value"));
+    if (i == 98 || i == 198) {
+      ASSERT_OK(Flush());
+    }
+  }
+  std::vector<std::string> key_strs;
+  for (int i = 0; i < kNumKeys; ++i) {
+    key_strs.push_back(Key(i));
+  }
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::unique_ptr<bool[]> may_exist(new bool[kNumKeys]);
+
+  uint64_t data_blocks_before =
+      TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS) +
+      TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT);
+  ASSERT_OK(db_->MultiKeyMayExist(ReadOptions(), db_->DefaultColumnFamily(),
+                                  keys.size(), keys.data(), may_exist.get()));
+  int false_positives = 0;
+  for (int i = 0; i < kNumKeys; ++i) {
+    if (i % 2 == 0) {
+      ASSERT_TRUE(may_exist[i]) << i;
+    } else if (i > 200) {
+      // Only the memtable could have them
+      ASSERT_FALSE(may_exist[i]) << i;
+    } else if (may_exist[i]) {
+      false_positives++;
+    }
+  }
+  ASSERT_LT(false_positives, 10);
+  ASSERT_EQ(data_blocks_before,
+            TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS) +
+                TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT));
+}
+
 TEST_F(DBBloomFilterTest, MemtablePrefixBloomOutOfDomain) {
   constexpr size_t kPrefixSize = 8;
   const std::string kKey = "key";
@@ -1267,6 +1267,62 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNextLevel) {
   ASSERT_EQ(8, files.size());
 }
 
+TEST_F(DBCompactionTest, CompactionSstPartitionerNextLevelBoundaries) {
+  class TrivialMoveListener : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      trivially_moved_bytes_ += ci.stats.total_trivially_moved_bytes;
+    }
+    std::atomic<uint64_t> trivially_moved_bytes_{0};
+  };
+  auto* listener = new TrivialMoveListener();
+
+  Options options = CurrentOptions();
+  options.num_levels = 4;
+  options.disable_auto_compactions = true;
+  options.sst_partitioner_factory = NewSstPartitionerNextLevelFactory();
+  options.listeners.emplace_back(listener);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("b", "v"));
+  ASSERT_OK(Put("c", "v"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  ASSERT_OK(Put("f", "v"));
+  ASSERT_OK(Put("g", "v"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  ASSERT_EQ("0,0,2", FilesPerLevel());
+
+  for (const char* key : {"a", "b5", "d", "e", "f5", "h"}) {
+    ASSERT_OK(Put(key, "v"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+
+  // The output is cut around [b, c] and [f, g]
+  std::vector<std::pair<std::string, std::string>> expected_ranges = {
+      {"a", "a"}, {"b5", "b5"}, {"d", "e"}, {"f5", "f5"}, {"h", "h"}};
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  std::vector<std::pair<std::string, std::string>> ranges;
+  for (const auto& file : files) {
+    if (file.level == 1) {
+      ranges.emplace_back(file.smallestkey, file.largestkey);
+    }
+  }
+  std::sort(ranges.begin(), ranges.end());
+  ASSERT_EQ(expected_ranges, ranges);
+
+  // The files overlapping no L2 file move down without being rewritten.
+  Slice begin("d");
+  Slice end("e");
+  ASSERT_OK(dbfull()->TEST_CompactRange(1, &begin, &end));
+  ASSERT_EQ("0,4,3", FilesPerLevel());
+  ASSERT_GT(listener->trivially_moved_bytes_.load(), 0);
+}
+
 TEST_F(DBCompactionTest, ZeroSeqIdCompaction) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -6299,7 +6355,8 @@ INSTANTIATE_TEST_CASE_P(
                       CompactionPri::kOldestLargestSeqFirst,
                       CompactionPri::kOldestSmallestSeqFirst,
                       CompactionPri::kMinOverlappingRatio,
-                      CompactionPri::kRoundRobin));
+                      CompactionPri::kRoundRobin,
+                      CompactionPri::kByTombstoneDensity));
 
 TEST_F(DBCompactionTest, PersistRoundRobinCompactCursor) {
   Options options = CurrentOptions();
@@ -9266,6 +9323,59 @@ TEST_F(DBCompactionTest, FIFOChangeTemperature) {
   Destroy(options);
 }
 
+TEST_F(DBCompactionTest, FIFOChangeTemperatureByTrivialCopy) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleFIFO;
+  options.num_levels = 1;
+  options.max_open_files = -1;
+  options.level0_file_num_compaction_trigger = 2;
+  options.create_if_missing = true;
+  CompactionOptionsFIFO fifo_options;
+  fifo_options.file_temperature_age_thresholds = {{Temperature::kCold, 1000}};
+  fifo_options.max_table_files_size = 100000000;
+  fifo_options.allow_trivial_copy_when_change_temperature = true;
+  options.compaction_options_fifo = fifo_options;
+  env_->SetMockSleep();
+  Reopen(options);
+
+  int trivial_copies = 0;
+  int non_trivial_compactions = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:TrivialCopy",
+      [&](void* /*arg*/) { trivial_copies++; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:NonTrivial",
+      [&](void* /*arg*/) { non_trivial_compactions++; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 4; i++) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+    env_->MockSleepForSeconds(800);
+    ASSERT_OK(Flush());
+    ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  }
+
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The files older than 1000 seconds are copied one by one, rather than
+  // compacted together
+  ColumnFamilyMetaData metadata;
+  db_->GetColumnFamilyMetaData(&metadata);
+  ASSERT_EQ(4, metadata.file_count);
+  ASSERT_EQ(Temperature::kUnknown, metadata.levels[0].files[0].temperature);
+  ASSERT_EQ(Temperature::kUnknown, metadata.levels[0].files[1].temperature);
+  ASSERT_EQ(Temperature::kCold, metadata.levels[0].files[2].temperature);
+  ASSERT_EQ(Temperature::kCold, metadata.levels[0].files[3].temperature);
+  ASSERT_GT(trivial_copies, 0);
+  ASSERT_EQ(0, non_trivial_compactions);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ("value" + std::to_string(i), Get(Key(i)));
+  }
+
+  Destroy(options);
+}
+
 TEST_F(DBCompactionTest, DisableMultiManualCompaction) {
   const int kNumL0Files = 10;
 
@@ -10204,6 +10314,54 @@ TEST_F(DBCompactionTest, NumberOfSubcompactions) {
   }
 }
 
+TEST_F(DBCompactionTest, SubcompactionRangesPerThread) {
+  // Tests that the extra ranges are all compacted, by no more than
+  // max_subcompactions threads at a time.
+  class SubCompactionEventListener : public EventListener {
+   public:
+    void OnSubcompactionBegin(const SubcompactionJobInfo&) override {
+      int running = ++running_;
+      int prev = max_running_.load();
+      while (running > prev &&
+             !max_running_.compare_exchange_weak(prev, running)) {
+      }
+    }
+    void OnSubcompactionCompleted(const SubcompactionJobInfo&) override {
+      --running_;
+      sub_compaction_finished_++;
+    }
+    std::atomic<int> running_{0};
+    std::atomic<int> max_running_{0};
+    std::atomic<int> sub_compaction_finished_{0};
+  };
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleLevel;
+  options.compression = kNoCompression;
+  options.target_file_size_base = 100 << 10;  // 100KB
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_subcompactions = 2;
+  options.subcompaction_ranges_per_thread = 4;
+  SubCompactionEventListener* listener = new SubCompactionEventListener();
+  options.listeners.emplace_back(listener);
+  DestroyAndReopen(options);
+
+  // Same data as NumberOfSubcompactions, which is enough for 8 ranges
+  Random rnd(301);
+  for (int file = 0; file < 2; ++file) {
+    for (int key = file; key < 2000; key += 2) {
+      ASSERT_OK(Put(Key(key), rnd.RandomString(500)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  EXPECT_EQ(listener->sub_compaction_finished_, 8);
+  EXPECT_LE(listener->max_running_, 2);
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  for (int key = 0; key < 2000; ++key) {
+    ASSERT_NE("NOT_FOUND", Get(Key(key)));
+  }
+}
+
 TEST_F(DBCompactionTest, VerifyRecordCount) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -3497,6 +3497,113 @@ TEST_F(DBFlushTest, DBStuckAfterAtomicFlushError) {
   ASSERT_OK(dbfull()->TEST_WaitForBackgroundWork());
   ASSERT_EQ(1, NumTableFilesAtLevel(0));
 }
+
+TEST_F(DBFlushTest, SplitFlushIntoKeyRanges) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.compression = kNoCompression;
+  options.write_buffer_size = 8 << 20;
+  options.target_file_size_base = 256 << 10;
+  options.max_flush_subjobs = 4;
+  Reopen(options);
+
+  Random rnd(301);
+  const int kNumKeys = 2000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(1000)));
+  }
+  ASSERT_OK(Flush());
+
+  // The ranges are built into non-overlapping files of the same epoch
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1);
+  ASSERT_LE(files.size(), 4);
+  std::sort(files.begin(), files.end(),
+            [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+              return a.smallestkey < b.smallestkey;
+            });
+  for (size_t i = 0; i < files.size(); i++) {
+    ASSERT_EQ(0, files[i].level);
+    ASSERT_EQ(files[0].epoch_number, files[i].epoch_number);
+    if (i > 0) {
+      ASSERT_LT(files[i - 1].largestkey, files[i].smallestkey);
+    }
+  }
+
+  int num_keys = 0;
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      num_keys++;
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(kNumKeys, num_keys);
+  for (int i = 0; i < kNumKeys; i += 97) {
+    ASSERT_EQ(1000, Get(Key(i)).size());
+  }
+
+  // A range deletion keeps the flush in one file
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(10)));
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(1000)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(files.size() + 1, NumTableFilesAtLevel(0));
+
+  Reopen(options);
+  ASSERT_EQ(files.size() + 1, NumTableFilesAtLevel(0));
+  ASSERT_EQ("NOT_FOUND", Get(Key(0)));
+  ASSERT_EQ(1000, Get(Key(kNumKeys - 1)).size());
+}
+
+TEST_F(DBFlushTest, FlushToLowestLevel) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  options.level_compaction_dynamic_level_bytes = false;
+  options.flush_to_lowest_level = true;
+  Reopen(options);
+
+  // Sequential keys go straight to the last level
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put(Key(i), "v1"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,0,0,1", FilesPerLevel());
+  for (int i = 100; i < 200; i++) {
+    ASSERT_OK(Put(Key(i), "v1"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,0,0,2", FilesPerLevel());
+
+  // Overwrites go above the files they overlap
+  ASSERT_OK(Put(Key(50), "v2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,0,1,2", FilesPerLevel());
+  ASSERT_OK(Put(Key(50), "v3"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,1,1,2", FilesPerLevel());
+  ASSERT_OK(Put(Key(50), "v4"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,1,1,2", FilesPerLevel());
+  ASSERT_EQ("v4", Get(Key(50)));
+  ASSERT_EQ("v1", Get(Key(150)));
+
+  ASSERT_OK(dbfull()->SetOptions({{"flush_to_lowest_level", "false"}}));
+  ASSERT_OK(Put(Key(300), "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("2,1,1,2", FilesPerLevel());
+
+  Reopen(options);
+  ASSERT_EQ("2,1,1,2", FilesPerLevel());
+  ASSERT_EQ("v4", Get(Key(50)));
+  ASSERT_EQ("v1", Get(Key(300)));
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
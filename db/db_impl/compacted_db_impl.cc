@@ -6,6 +6,7 @@
 #include "db/db_impl/compacted_db_impl.h"
 
 #include "db/db_impl/db_impl.h"
+#include "db/range_tombstone_fragmenter.h"
 #include "db/version_set.h"
 #include "logging/logging.h"
 #include "table/get_context.h"
@@ -27,14 +28,77 @@ CompactedDBImpl::CompactedDBImpl(const DBOptions& options,
 
 CompactedDBImpl::~CompactedDBImpl() {}
 
-size_t CompactedDBImpl::FindFile(const Slice& key) {
-  size_t right = files_.num_files - 1;
+const FdWithKeyRange* CompactedDBImpl::FindFile(const LevelFilesBrief& run,
+                                                const Slice& key,
+                                                const Slice& user_key) {
+  size_t right = run.num_files - 1;
   auto cmp = [&](const FdWithKeyRange& f, const Slice& k) -> bool {
     return user_comparator_->Compare(ExtractUserKey(f.largest_key), k) < 0;
   };
-  return static_cast<size_t>(
-      std::lower_bound(files_.files, files_.files + right, key, cmp) -
-      files_.files);
+  const FdWithKeyRange& f =
+      *std::lower_bound(run.files, run.files + right, user_key, cmp);
+  const size_t ts_sz = user_comparator_->timestamp_size();
+  if (user_comparator_->CompareWithoutTimestamp(
+          key, /*a_has_ts=*/false,
+          ExtractUserKeyAndStripTimestamp(f.smallest_key, ts_sz),
+          /*b_has_ts=*/false) < 0 ||
+      user_comparator_->CompareWithoutTimestamp(
+          key, /*a_has_ts=*/false,
+          ExtractUserKeyAndStripTimestamp(f.largest_key, ts_sz),
+          /*b_has_ts=*/false) > 0) {
+    return nullptr;
+  }
+  return &f;
+}
+
+Status CompactedDBImpl::GetFromRuns(const ReadOptions& read_options,
+                                    const Slice& key, PinnableSlice* value,
+                                    std::string* timestamp) {
+  GetWithTimestampReadCallback read_cb(kMaxSequenceNumber);
+  std::string* ts =
+      user_comparator_->timestamp_size() > 0 ? timestamp : nullptr;
+  LookupKey lkey(key, kMaxSequenceNumber, read_options.timestamp);
+  // Range tombstones of a run delete the older entries of the runs below it
+  SequenceNumber max_covering_tombstone_seq = 0;
+  GetContext get_context(user_comparator_, nullptr, nullptr, nullptr,
+                         GetContext::kNotFound, lkey.user_key(), value,
+                         /*columns=*/nullptr, ts, nullptr, nullptr, true,
+                         &max_covering_tombstone_seq, nullptr, nullptr,
+                         nullptr, &read_cb);
+
+  for (const LevelFilesBrief& run : runs_) {
+    const FdWithKeyRange* f = FindFile(run, key, lkey.user_key());
+    if (f == nullptr) {
+      continue;
+    }
+    TableReader* t = f->fd.table_reader;
+    if (!read_options.ignore_range_deletions) {
+      std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
+          t->NewRangeTombstoneIterator(read_options));
+      if (range_del_iter != nullptr) {
+        SequenceNumber seq =
+            range_del_iter->MaxCoveringTombstoneSeqnum(lkey.user_key());
+        if (seq > max_covering_tombstone_seq) {
+          max_covering_tombstone_seq = seq;
+          if (get_context.NeedTimestamp()) {
+            get_context.SetTimestampFromRangeTombstone(
+                range_del_iter->timestamp());
+          }
+        }
+      }
+    }
+    Status s = t->Get(read_options, lkey.internal_key(), &get_context, nullptr);
+    if (!s.ok() && !s.IsNotFound()) {
+      return s;
+    }
+    if (get_context.State() != GetContext::kNotFound) {
+      break;
+    }
+  }
+  if (get_context.State() == GetContext::kFound) {
+    return Status::OK();
+  }
+  return Status::NotFound();
 }
 
 Status CompactedDBImpl::Get(const ReadOptions& options, ColumnFamilyHandle*,
@@ -84,32 +148,7 @@ Status CompactedDBImpl::Get(const ReadOptions& _read_options,
     timestamp->clear();
   }
 
-  GetWithTimestampReadCallback read_cb(kMaxSequenceNumber);
-  std::string* ts =
-      user_comparator_->timestamp_size() > 0 ? timestamp : nullptr;
-  LookupKey lkey(key, kMaxSequenceNumber, read_options.timestamp);
-  GetContext get_context(user_comparator_, nullptr, nullptr, nullptr,
-                         GetContext::kNotFound, lkey.user_key(), value,
-                         /*columns=*/nullptr, ts, nullptr, nullptr, true,
-                         nullptr, nullptr, nullptr, nullptr, &read_cb);
-
-  const FdWithKeyRange& f = files_.files[FindFile(lkey.user_key())];
-  if (user_comparator_->CompareWithoutTimestamp(
-          key, /*a_has_ts=*/false,
-          ExtractUserKeyAndStripTimestamp(f.smallest_key,
-                                          user_comparator_->timestamp_size()),
-          /*b_has_ts=*/false) < 0) {
-    return Status::NotFound();
-  }
-  Status s = f.fd.table_reader->Get(read_options, lkey.internal_key(),
-                                    &get_context, nullptr);
-  if (!s.ok() && !s.IsNotFound()) {
-    return s;
-  }
-  if (get_context.State() == GetContext::kFound) {
-    return Status::OK();
-  }
-  return Status::NotFound();
+  return GetFromRuns(read_options, key, value, timestamp);
 }
 
 std::vector<Status> CompactedDBImpl::MultiGet(
@@ -165,52 +204,19 @@ std::vector<Status> CompactedDBImpl::MultiGet(
     }
   }
 
-  GetWithTimestampReadCallback read_cb(kMaxSequenceNumber);
-  autovector<TableReader*, 16> reader_list;
-  for (const auto& key : keys) {
-    LookupKey lkey(key, kMaxSequenceNumber, read_options.timestamp);
-    const FdWithKeyRange& f = files_.files[FindFile(lkey.user_key())];
-    if (user_comparator_->CompareWithoutTimestamp(
-            key, /*a_has_ts=*/false,
-            ExtractUserKeyAndStripTimestamp(f.smallest_key,
-                                            user_comparator_->timestamp_size()),
-            /*b_has_ts=*/false) < 0) {
-      reader_list.push_back(nullptr);
-    } else {
-      f.fd.table_reader->Prepare(lkey.internal_key());
-      reader_list.push_back(f.fd.table_reader);
-    }
-  }
-  std::vector<Status> statuses(num_keys, Status::NotFound());
+  std::vector<Status> statuses(num_keys);
   values->resize(num_keys);
   if (timestamps) {
     timestamps->resize(num_keys);
   }
-  int idx = 0;
-  for (auto* r : reader_list) {
-    if (r != nullptr) {
-      PinnableSlice pinnable_val;
-      std::string& value = (*values)[idx];
-      LookupKey lkey(keys[idx], kMaxSequenceNumber, read_options.timestamp);
-      std::string* timestamp = timestamps ? &(*timestamps)[idx] : nullptr;
-      GetContext get_context(
-          user_comparator_, nullptr, nullptr, nullptr, GetContext::kNotFound,
-          lkey.user_key(), &pinnable_val, /*columns=*/nullptr,
-          user_comparator_->timestamp_size() > 0 ? timestamp : nullptr, nullptr,
-          nullptr, true, nullptr, nullptr, nullptr, nullptr, &read_cb);
-      Status s =
-          r->Get(read_options, lkey.internal_key(), &get_context, nullptr);
-      assert(static_cast<size_t>(idx) < statuses.size());
-      if (!s.ok() && !s.IsNotFound()) {
-        statuses[idx] = s;
-      } else {
-        value.assign(pinnable_val.data(), pinnable_val.size());
-        if (get_context.State() == GetContext::kFound) {
-          statuses[idx] = Status::OK();
-        }
-      }
+  for (size_t idx = 0; idx < num_keys; ++idx) {
+    PinnableSlice pinnable_val;
+    std::string* timestamp = timestamps ? &(*timestamps)[idx] : nullptr;
+    statuses[idx] =
+        GetFromRuns(read_options, keys[idx], &pinnable_val, timestamp);
+    if (statuses[idx].ok()) {
+      (*values)[idx].assign(pinnable_val.data(), pinnable_val.size());
     }
-    ++idx;
   }
   return statuses;
 }
@@ -235,34 +241,25 @@ Status CompactedDBImpl::Init(const Options& options) {
   version_ = cfd_->GetSuperVersion()->current;
   user_comparator_ = cfd_->user_comparator();
   auto* vstorage = version_->storage_info();
-  if (vstorage->num_non_empty_levels() == 0) {
-    return Status::NotSupported("no file exists");
-  }
+  // L0 files may overlap, so each is a sorted run of its own, the newest
+  // first. The files of any other level do not overlap.
   const LevelFilesBrief& l0 = vstorage->LevelFilesBrief(0);
-  // L0 should not have files
-  if (l0.num_files > 1) {
-    return Status::NotSupported("L0 contain more than 1 file");
+  for (size_t i = 0; i < l0.num_files; ++i) {
+    LevelFilesBrief run;
+    run.num_files = 1;
+    run.files = &l0.files[i];
+    runs_.push_back(run);
   }
-  if (l0.num_files == 1) {
-    if (vstorage->num_non_empty_levels() > 1) {
-      return Status::NotSupported("Both L0 and other level contain files");
-    }
-    files_ = l0;
-    return Status::OK();
-  }
-
-  for (int i = 1; i < vstorage->num_non_empty_levels() - 1; ++i) {
-    if (vstorage->LevelFilesBrief(i).num_files > 0) {
-      return Status::NotSupported("Other levels also contain files");
+  for (int level = 1; level < vstorage->num_non_empty_levels(); ++level) {
+    const LevelFilesBrief& files = vstorage->LevelFilesBrief(level);
+    if (files.num_files > 0) {
+      runs_.push_back(files);
     }
   }
-
-  int level = vstorage->num_non_empty_levels() - 1;
-  if (vstorage->LevelFilesBrief(level).num_files > 0) {
-    files_ = vstorage->LevelFilesBrief(level);
-    return Status::OK();
+  if (runs_.empty()) {
+    return Status::NotSupported("no file exists");
   }
-  return Status::NotSupported("no file exists");
+  return Status::OK();
 }
 
 Status CompactedDBImpl::Open(const Options& options, const std::string& dbname,
@@ -283,7 +280,9 @@ Status CompactedDBImpl::Open(const Options& options, const std::string& dbname,
   }
   if (s.ok()) {
     ROCKS_LOG_INFO(db->immutable_db_options_.info_log,
-                   "Opened the db as fully compacted mode");
+                   "Opened the db as compacted mode with %" ROCKSDB_PRIszt
+                   " sorted runs",
+                   db->runs_.size());
     LogFlush(db->immutable_db_options_.info_log);
     *dbptr = db.release();
   }
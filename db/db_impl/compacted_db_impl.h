@@ -148,12 +148,22 @@ class CompactedDBImpl : public DBImpl {
 
  private:
   friend class DB;
-  inline size_t FindFile(const Slice& key);
+  // Returns the file of `run` that may contain `key`, or nullptr if the key is
+  // outside of the run. `user_key` is `key` with the read timestamp, if any.
+  inline const FdWithKeyRange* FindFile(const LevelFilesBrief& run,
+                                        const Slice& key,
+                                        const Slice& user_key);
+  // Looks `key` up in the sorted runs, the newest first, until one has an
+  // entry for it
+  Status GetFromRuns(const ReadOptions& read_options, const Slice& key,
+                     PinnableSlice* value, std::string* timestamp);
   Status Init(const Options& options);
 
   ColumnFamilyData* cfd_;
   Version* version_;
   const Comparator* user_comparator_;
-  LevelFilesBrief files_;
+  // The sorted runs of the DB, the newest first: each L0 file on its own,
+  // then each non-empty level
+  std::vector<LevelFilesBrief> runs_;
 };
 }  // namespace ROCKSDB_NAMESPACE
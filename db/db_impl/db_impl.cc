@@ -25,6 +25,8 @@
 #include <vector>
 
 #include "db/arena_wrapped_db_iter.h"
+#include "db/batch_iterator.h"
+#include "db/block_cache_hotness.h"
 #include "db/builder.h"
 #include "db/compaction/compaction_job.h"
 #include "db/convenience_impl.h"
@@ -45,6 +47,8 @@
 #include "db/memtable_list.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
+#include "db/multi_scan_iterator.h"
+#include "db/parallel_scan.h"
 #include "db/periodic_task_scheduler.h"
 #include "db/range_tombstone_fragmenter.h"
 #include "db/table_cache.h"
@@ -65,6 +69,7 @@
 #include "monitoring/instrumented_mutex.h"
 #include "monitoring/iostats_context_imp.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_context_sampler.h"
 #include "monitoring/persistent_stats_history.h"
 #include "monitoring/thread_status_updater.h"
 #include "monitoring/thread_status_util.h"
@@ -207,6 +212,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       bg_flush_scheduled_(0),
       num_running_flushes_(0),
       bg_purge_scheduled_(0),
+      bg_block_cache_warmup_scheduled_(0),
       disable_delete_obsolete_files_(0),
       pending_purge_obsolete_files_(0),
       delete_obsolete_files_last_run_(immutable_db_options_.clock->NowMicros()),
@@ -249,19 +255,48 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   // WriteUnprepared, which should use seq_per_batch_.
   assert(batch_per_txn_ || seq_per_batch_);
 
+  if (immutable_db_options_.db_mutex_contention_threshold_micros > 0) {
+    mutex_contention_profiler_.reset(new MutexContentionProfiler(
+        immutable_db_options_.clock,
+        immutable_db_options_.db_mutex_contention_threshold_micros));
+    mutex_.SetContentionProfiler(mutex_contention_profiler_.get());
+  }
+
+  if (immutable_db_options_.background_job_weight > 0) {
+    // Envs without fair scheduling don't support the weights
+    for (uint8_t i = 0; i < static_cast<uint8_t>(TaskType::kCount); i++) {
+      for (auto pri : {Env::Priority::BOTTOM, Env::Priority::LOW,
+                       Env::Priority::HIGH}) {
+        env_->SetThreadPoolSchedulingWeight(
+                pri, GetTaskTag(i), immutable_db_options_.background_job_weight)
+            .PermitUncheckedError();
+      }
+    }
+  }
+
   // Reserve ten files or so for other uses and give the rest to TableCache.
   // Give a large number for setting of "infinite" open files.
   const int table_cache_size = (mutable_db_options_.max_open_files == -1)
                                    ? TableCache::kInfiniteCapacity
                                    : mutable_db_options_.max_open_files - 10;
-  LRUCacheOptions co;
-  co.capacity = table_cache_size;
-  co.num_shard_bits = immutable_db_options_.table_cache_numshardbits;
-  co.metadata_charge_policy = kDontChargeCacheMetadata;
-  // TODO: Consider a non-fixed seed once test fallout (prefetch_test) is
-  // dealt with
-  co.hash_seed = 0;
-  table_cache_ = NewLRUCache(co);
+  if (immutable_db_options_.lock_free_table_cache &&
+      mutable_db_options_.max_open_files != -1) {
+    // Each table reader is charged 1
+    HyperClockCacheOptions co(table_cache_size, /*estimated_entry_charge=*/1);
+    co.num_shard_bits = immutable_db_options_.table_cache_numshardbits;
+    co.metadata_charge_policy = kDontChargeCacheMetadata;
+    co.hash_seed = 0;
+    table_cache_ = co.MakeSharedCache();
+  } else {
+    LRUCacheOptions co;
+    co.capacity = table_cache_size;
+    co.num_shard_bits = immutable_db_options_.table_cache_numshardbits;
+    co.metadata_charge_policy = kDontChargeCacheMetadata;
+    // TODO: Consider a non-fixed seed once test fallout (prefetch_test) is
+    // dealt with
+    co.hash_seed = 0;
+    table_cache_ = NewLRUCache(co);
+  }
   SetDbSessionId();
   assert(!db_session_id_.empty());
 
@@ -271,6 +306,11 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
                                    [this]() { this->PersistStats(); });
   periodic_task_functions_.emplace(PeriodicTaskType::kFlushInfoLog,
                                    [this]() { this->FlushInfoLog(); });
+  periodic_task_functions_.emplace(PeriodicTaskType::kThrottleCompaction,
+                                   [this]() { this->ThrottleCompaction(); });
+  periodic_task_functions_.emplace(
+      PeriodicTaskType::kPersistBlockCacheHotness,
+      [this]() { this->PersistBlockCacheHotness(); });
   periodic_task_functions_.emplace(
       PeriodicTaskType::kRecordSeqnoTime, [this]() {
         this->RecordSeqnoToTimeMapping(/*populate_historical_seconds=*/0);
@@ -292,6 +332,10 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
 
   max_total_wal_size_.store(mutable_db_options_.max_total_wal_size,
                             std::memory_order_relaxed);
+  for (size_t i = 0; i < pending_memtable_writes_.Size(); ++i) {
+    pending_memtable_writes_.AccessAtCore(i)->obj_.store(
+        0, std::memory_order_relaxed);
+  }
   if (write_buffer_manager_) {
     wbm_stall_.reset(new WBMStallInterface());
   }
@@ -501,6 +545,11 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
 
   shutting_down_.store(true, std::memory_order_release);
   bg_cv_.SignalAll();
+  if (immutable_db_options_.compaction_service) {
+    mutex_.Unlock();
+    immutable_db_options_.compaction_service->CancelAwaitingJobs();
+    mutex_.Lock();
+  }
   if (!wait) {
     return;
   }
@@ -551,6 +600,13 @@ Status DBImpl::CloseHelper() {
     env_->UnSchedule(GetTaskTag(i), Env::Priority::BOTTOM);
     env_->UnSchedule(GetTaskTag(i), Env::Priority::LOW);
     env_->UnSchedule(GetTaskTag(i), Env::Priority::HIGH);
+    if (immutable_db_options_.background_job_weight > 0) {
+      for (auto pri : {Env::Priority::BOTTOM, Env::Priority::LOW,
+                       Env::Priority::HIGH}) {
+        env_->SetThreadPoolSchedulingWeight(pri, GetTaskTag(i), 0)
+            .PermitUncheckedError();
+      }
+    }
   }
 
   Status ret = Status::OK();
@@ -558,7 +614,7 @@ Status DBImpl::CloseHelper() {
   // Wait for background work to finish
   while (bg_bottom_compaction_scheduled_ || bg_compaction_scheduled_ ||
          bg_flush_scheduled_ || bg_purge_scheduled_ ||
-         pending_purge_obsolete_files_ ||
+         bg_block_cache_warmup_scheduled_ || pending_purge_obsolete_files_ ||
          error_handler_.IsRecoveryInProgress()) {
     TEST_SYNC_POINT("DBImpl::~DBImpl:WaitJob");
     bg_cv_.Wait();
@@ -803,6 +859,15 @@ Status DBImpl::StartPeriodicTaskScheduler() {
     }
   }
 
+  if (mutable_db_options_.compaction_throttle_latency_micros > 0) {
+    Status s = periodic_task_scheduler_.Register(
+        PeriodicTaskType::kThrottleCompaction,
+        periodic_task_functions_.at(PeriodicTaskType::kThrottleCompaction));
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
   Status s = periodic_task_scheduler_.Register(
       PeriodicTaskType::kFlushInfoLog,
       periodic_task_functions_.at(PeriodicTaskType::kFlushInfoLog));
@@ -985,20 +1050,21 @@ void DBImpl::PersistStats() {
       ROCKS_LOG_INFO(immutable_db_options_.info_log,
                      "Reading %" ROCKSDB_PRIszt " stats from statistics\n",
                      stats_slice_.size());
+      // calculate the delta from last time
+      std::map<std::string, uint64_t> stats_delta;
       for (const auto& stat : stats_map) {
-        if (s.ok()) {
-          char key[100];
-          int length =
-              EncodePersistentStatsKey(now_seconds, stat.first, 100, key);
-          // calculate the delta from last time
-          if (stats_slice_.find(stat.first) != stats_slice_.end()) {
-            uint64_t delta = stat.second - stats_slice_[stat.first];
-            s = batch.Put(persist_stats_cf_handle_,
-                          Slice(key, std::min(100, length)),
-                          std::to_string(delta));
-          }
+        auto it = stats_slice_.find(stat.first);
+        if (it != stats_slice_.end()) {
+          stats_delta[stat.first] = stat.second - it->second;
         }
       }
+      // all the stats of the snapshot go into a single key
+      char key[100];
+      int length = EncodePersistentStatsKey(now_seconds, "", 100, key);
+      std::string value;
+      EncodePersistentStatsSnapshot(stats_delta, &value);
+      s = batch.Put(persist_stats_cf_handle_, Slice(key, std::min(100, length)),
+                    value);
     }
     stats_slice_initialized_ = true;
     std::swap(stats_slice_, stats_map);
@@ -1097,6 +1163,27 @@ Status DBImpl::GetStatsHistory(
   return (*stats_iterator)->status();
 }
 
+Status DBImpl::GetTickerHistory(
+    const std::string& ticker_name, uint64_t start_time, uint64_t end_time,
+    std::vector<std::pair<uint64_t, uint64_t>>* history) {
+  if (!immutable_db_options_.persist_stats_to_disk) {
+    return DB::GetTickerHistory(ticker_name, start_time, end_time, history);
+  }
+  if (!history) {
+    return Status::InvalidArgument("history not preallocated.");
+  }
+  history->clear();
+  return ReadPersistentStatsHistory(
+      this, start_time, end_time,
+      [&](uint64_t time, const std::map<std::string, uint64_t>& stats) {
+        auto it = stats.find(ticker_name);
+        if (it != stats.end()) {
+          history->emplace_back(time, it->second);
+        }
+        return true;
+      });
+}
+
 void DBImpl::DumpStats() {
   TEST_SYNC_POINT("DBImpl::DumpStats:1");
   std::string stats;
@@ -1179,6 +1266,260 @@ void DBImpl::FlushInfoLog() {
   LogFlush(immutable_db_options_.info_log);
 }
 
+void DBImpl::ThrottleCompaction() {
+  if (shutdown_initiated_) {
+    return;
+  }
+  TEST_SYNC_POINT("DBImpl::ThrottleCompaction:StartRunning");
+  Statistics* stats = immutable_db_options_.statistics.get();
+  if (stats == nullptr) {
+    return;
+  }
+  uint64_t op_count = 0;
+  uint64_t op_micros = 0;
+  for (uint32_t histogram : {DB_GET, DB_MULTIGET, DB_WRITE, DB_SEEK}) {
+    HistogramData data;
+    stats->histogramData(histogram, &data);
+    op_count += data.count;
+    op_micros += data.sum;
+  }
+  uint64_t count = 0;
+  uint64_t micros = 0;
+  // A smaller total means the statistics were reset
+  if (op_count >= throttle_last_op_count_ &&
+      op_micros >= throttle_last_op_micros_) {
+    count = op_count - throttle_last_op_count_;
+    micros = op_micros - throttle_last_op_micros_;
+  }
+  throttle_last_op_count_ = op_count;
+  throttle_last_op_micros_ = op_micros;
+
+  InstrumentedMutexLock l(&mutex_);
+  const uint64_t target =
+      mutable_db_options_.compaction_throttle_latency_micros;
+  if (target == 0) {
+    return;
+  }
+  const bool slow_down = count > 0 && micros > target * count;
+  const bool speed_up = count == 0 || micros * 10 < target * 8 * count;
+  const int max_compactions =
+      GetBGJobLimits(mutable_db_options_.max_background_flushes,
+                     mutable_db_options_.max_background_compactions,
+                     mutable_db_options_.max_background_jobs,
+                     /* parallelize_compactions */ true)
+          .max_compactions;
+  const int old_budget = compaction_budget_;
+  if (compaction_budget_ == 0) {
+    compaction_budget_ = 1;
+  } else if (slow_down) {
+    compaction_budget_ = std::max(1, compaction_budget_ / 2);
+  } else if (speed_up) {
+    compaction_budget_++;
+  }
+  compaction_budget_ = std::min(compaction_budget_, max_compactions);
+
+  RateLimiter* rate_limiter = immutable_db_options_.rate_limiter.get();
+  if (rate_limiter != nullptr && (slow_down || speed_up)) {
+    const int64_t rate = rate_limiter->GetBytesPerSecond();
+    if (throttle_max_rate_bytes_per_sec_ == 0) {
+      throttle_max_rate_bytes_per_sec_ = rate;
+    }
+    const int64_t new_rate =
+        slow_down ? std::max(throttle_max_rate_bytes_per_sec_ / 8, rate / 2)
+                  : std::min(throttle_max_rate_bytes_per_sec_, rate + rate / 4);
+    if (new_rate > 0 && new_rate != rate) {
+      rate_limiter->SetBytesPerSecond(new_rate);
+      ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                     "[ThrottleCompaction] Rate limit %" PRId64
+                     " -> %" PRId64 " bytes/s",
+                     rate, new_rate);
+    }
+  }
+  if (compaction_budget_ != old_budget) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "[ThrottleCompaction] %" PRIu64
+                   " foreground operations at %" PRIu64
+                   " micros/op, compactions allowed %d -> %d",
+                   count, count > 0 ? micros / count : 0, old_budget,
+                   compaction_budget_);
+    MaybeScheduleFlushOrCompaction();
+  }
+}
+
+Status DBImpl::RegisterBlockCacheHotnessWorker() {
+  const uint64_t period_sec =
+      immutable_db_options_.block_cache_hotness_persist_period_sec;
+  if (period_sec == 0) {
+    return Status::OK();
+  }
+  {
+    InstrumentedMutexLock l(&mutex_);
+    bg_block_cache_warmup_scheduled_++;
+    env_->Schedule(&DBImpl::BGWorkBlockCacheWarmUp, this, Env::Priority::LOW,
+                   nullptr);
+  }
+  return periodic_task_scheduler_.Register(
+      PeriodicTaskType::kPersistBlockCacheHotness,
+      periodic_task_functions_.at(PeriodicTaskType::kPersistBlockCacheHotness),
+      period_sec);
+}
+
+void DBImpl::BGWorkBlockCacheWarmUp(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  TEST_SYNC_POINT("DBImpl::BGWorkBlockCacheWarmUp:start");
+  DBImpl* db_impl = static_cast<DBImpl*>(db);
+  db_impl->WarmUpBlockCache();
+  InstrumentedMutexLock l(&db_impl->mutex_);
+  db_impl->bg_block_cache_warmup_scheduled_--;
+  db_impl->bg_cv_.SignalAll();
+}
+
+void DBImpl::PersistBlockCacheHotness() {
+  if (shutdown_initiated_) {
+    return;
+  }
+  TEST_SYNC_POINT("DBImpl::PersistBlockCacheHotness:StartRunning");
+  // The table files using each block cache
+  std::vector<std::pair<Cache*, std::vector<BlockCacheHotness::TableFile>>>
+      caches;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    if (bg_block_cache_warmup_scheduled_ > 0) {
+      // Would replace the record being loaded with a partial one
+      return;
+    }
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped() || !cfd->initialized()) {
+        continue;
+      }
+      Cache* cache = cfd->ioptions()->table_factory->GetOptions<Cache>(
+          TableFactory::kBlockCacheOpts());
+      if (cache == nullptr) {
+        continue;
+      }
+      auto it = std::find_if(
+          caches.begin(), caches.end(),
+          [cache](const std::pair<Cache*,
+                                  std::vector<BlockCacheHotness::TableFile>>&
+                      c) { return c.first == cache; });
+      if (it == caches.end()) {
+        caches.emplace_back(cache, std::vector<BlockCacheHotness::TableFile>());
+        it = caches.end() - 1;
+      }
+      const VersionStorageInfo* vstorage = cfd->current()->storage_info();
+      for (int level = 0; level < vstorage->num_levels(); ++level) {
+        for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+          it->second.push_back({f->fd.GetNumber(), f->unique_id});
+        }
+      }
+    }
+  }
+
+  BlockCacheHotness hotness;
+  for (const auto& cache : caches) {
+    hotness.Collect(cache.first, cache.second);
+  }
+  std::string contents;
+  hotness.EncodeTo(&contents);
+  const std::string fname = BlockCacheHotnessFileName(dbname_);
+  const std::string tmp_fname = fname + ".tmp";
+  IOStatus s = WriteStringToFile(fs_.get(), contents, tmp_fname,
+                                 /*should_sync=*/true);
+  if (s.ok()) {
+    s = fs_->RenameFile(tmp_fname, fname, IOOptions(), nullptr);
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to persist block cache hotness: %s",
+                   s.ToString().c_str());
+  }
+}
+
+void DBImpl::WarmUpBlockCache() {
+  std::string contents;
+  if (!ReadFileToString(fs_.get(), BlockCacheHotnessFileName(dbname_),
+                        &contents)
+           .ok()) {
+    // Nothing persisted yet
+    return;
+  }
+  BlockCacheHotness hotness;
+  Status s = hotness.DecodeFrom(contents);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to read block cache hotness: %s",
+                   s.ToString().c_str());
+    return;
+  }
+
+  // The current table files, with their versions kept alive while loading
+  std::unordered_map<uint64_t, std::pair<Version*, const FileMetaData*>>
+      table_files;
+  autovector<Version*> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped() || !cfd->initialized()) {
+        continue;
+      }
+      Version* version = cfd->current();
+      version->Ref();
+      versions.push_back(version);
+      const VersionStorageInfo* vstorage = version->storage_info();
+      for (int level = 0; level < vstorage->num_levels(); ++level) {
+        for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+          table_files[f->fd.GetNumber()] = {version, f};
+        }
+      }
+    }
+  }
+
+  ReadOptions read_options;
+  read_options.rate_limiter_priority = Env::IO_LOW;
+  const std::vector<uint64_t> no_data_blocks;
+  // By pass, the number of files loaded
+  size_t num_files_loaded[2] = {0, 0};
+  // Index and filter blocks first, then data blocks, the files with the most
+  // cached blocks first
+  for (bool data_blocks : {false, true}) {
+    for (const BlockCacheHotness::FileBlocks& file : hotness.files) {
+      if (shutting_down_.load(std::memory_order_acquire)) {
+        break;
+      }
+      if (data_blocks ? file.data_block_offsets.empty()
+                      : file.num_meta_blocks == 0) {
+        continue;
+      }
+      auto it = table_files.find(file.file_number);
+      if (it == table_files.end()) {
+        // Compacted away since
+        continue;
+      }
+      s = it->second.first->PrefetchDataBlocks(
+          read_options, *it->second.second,
+          data_blocks ? file.data_block_offsets : no_data_blocks);
+      if (s.ok()) {
+        num_files_loaded[data_blocks]++;
+      } else {
+        ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                       "Failed to warm up block cache for file #%" PRIu64
+                       ": %s",
+                       file.file_number, s.ToString().c_str());
+      }
+    }
+  }
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Warmed up block cache with the index and filter blocks of %"
+                 ROCKSDB_PRIszt " files and data blocks of %" ROCKSDB_PRIszt
+                 " files",
+                 num_files_loaded[0], num_files_loaded[1]);
+
+  InstrumentedMutexLock l(&mutex_);
+  for (Version* version : versions) {
+    version->Unref();
+  }
+}
+
 Status DBImpl::TablesRangeTombstoneSummary(ColumnFamilyHandle* column_family,
                                            int max_entries_to_print,
                                            std::string* out_str) {
@@ -1389,10 +1730,34 @@ Status DBImpl::SetDBOptions(
               new_options.stats_persist_period_sec);
         }
       }
+      const bool throttle_changed =
+          (new_options.compaction_throttle_latency_micros > 0) !=
+          (mutable_db_options_.compaction_throttle_latency_micros > 0);
+      if (s.ok() && throttle_changed) {
+        if (new_options.compaction_throttle_latency_micros == 0) {
+          s = periodic_task_scheduler_.Unregister(
+              PeriodicTaskType::kThrottleCompaction);
+        } else {
+          s = periodic_task_scheduler_.Register(
+              PeriodicTaskType::kThrottleCompaction,
+              periodic_task_functions_.at(
+                  PeriodicTaskType::kThrottleCompaction));
+        }
+      }
       mutex_.Lock();
       if (!s.ok()) {
         return s;
       }
+      if (throttle_changed &&
+          new_options.compaction_throttle_latency_micros == 0) {
+        // Undo ThrottleCompaction()
+        compaction_budget_ = 0;
+        if (throttle_max_rate_bytes_per_sec_ > 0) {
+          immutable_db_options_.rate_limiter->SetBytesPerSecond(
+              throttle_max_rate_bytes_per_sec_);
+          throttle_max_rate_bytes_per_sec_ = 0;
+        }
+      }
 
       write_controller_.set_max_delayed_write_rate(
           new_options.delayed_write_rate);
@@ -2025,7 +2390,9 @@ Status DBImpl::Get(const ReadOptions& _read_options,
     read_options.io_activity = Env::IOActivity::kGet;
   }
 
+  PerfContextSampler sampler(immutable_db_options_, dbname_, "Get");
   Status s = GetImpl(read_options, column_family, key, value, timestamp);
+  sampler.Finish(s);
   return s;
 }
 
@@ -2063,6 +2430,7 @@ Status DBImpl::GetEntity(const ReadOptions& _read_options,
     read_options.io_activity = Env::IOActivity::kGetEntity;
   }
   columns->Reset();
+  columns->SetProjection(read_options.wide_column_projection);
 
   GetImplOptions get_impl_options;
   get_impl_options.column_family = column_family;
@@ -2302,15 +2670,39 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   bool done = false;
   std::string* timestamp =
       ucmp->timestamp_size() > 0 ? get_impl_options.timestamp : nullptr;
+  // Merge results of operands whose newest one is in the memtables are
+  // cached here, those of operands all in table files by Version::Get()
+  MergeResultCache* merge_result_cache =
+      (get_impl_options.get_value && get_impl_options.value != nullptr &&
+       get_impl_options.callback == nullptr &&
+       get_impl_options.is_blob_index == nullptr &&
+       !read_options.merge_operand_count_threshold.has_value())
+          ? cfd->merge_result_cache()
+          : nullptr;
+  // Sequence number of the newest merge operand in the memtables, if its
+  // merge result is to be cached
+  SequenceNumber merge_result_seq = kMaxSequenceNumber;
+  // Values found in the table files after missing the memtables are cached
+  // by user key here, see DBOptions::row_cache_by_user_key
+  UserKeyRowCache* user_key_row_cache =
+      (get_impl_options.get_value && get_impl_options.value != nullptr &&
+       get_impl_options.callback == nullptr &&
+       get_impl_options.is_blob_index == nullptr &&
+       read_options.read_tier == kReadAllTier &&
+       !read_options.merge_operand_count_threshold.has_value())
+          ? cfd->user_key_row_cache()
+          : nullptr;
   if (!skip_memtable) {
     // Get value associated with key
     if (get_impl_options.get_value) {
+      SequenceNumber mem_seq = kMaxSequenceNumber;
+      SequenceNumber imm_seq = kMaxSequenceNumber;
       if (sv->mem->Get(
               lkey,
               get_impl_options.value ? get_impl_options.value->GetSelf()
                                      : nullptr,
               get_impl_options.columns, timestamp, &s, &merge_context,
-              &max_covering_tombstone_seq, read_options,
+              &max_covering_tombstone_seq, &mem_seq, read_options,
               false /* immutable_memtable */, get_impl_options.callback,
               get_impl_options.is_blob_index)) {
         done = true;
@@ -2327,7 +2719,7 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
                                   : nullptr,
                               get_impl_options.columns, timestamp, &s,
                               &merge_context, &max_covering_tombstone_seq,
-                              read_options, get_impl_options.callback,
+                              &imm_seq, read_options, get_impl_options.callback,
                               get_impl_options.is_blob_index)) {
         done = true;
 
@@ -2336,6 +2728,17 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
         }
 
         RecordTick(stats_, MEMTABLE_HIT);
+      } else if (merge_result_cache != nullptr && s.IsMergeInProgress()) {
+        const SequenceNumber seq =
+            mem_seq != kMaxSequenceNumber ? mem_seq : imm_seq;
+        assert(seq != kMaxSequenceNumber);
+        if (merge_result_cache->Lookup(key, seq, get_impl_options.value,
+                                       stats_)) {
+          s = Status::OK();
+          done = true;
+        } else {
+          merge_result_seq = seq;
+        }
       }
     } else {
       // Get Merge Operands associated with key, Merge Operands should not be
@@ -2363,6 +2766,25 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   TEST_SYNC_POINT("DBImpl::GetImpl:PostMemTableGet:0");
   TEST_SYNC_POINT("DBImpl::GetImpl:PostMemTableGet:1");
   PinnedIteratorsManager pinned_iters_mgr;
+  // Sequence number to cache the value found in the table files with, if any
+  SequenceNumber row_cache_seq = kMaxSequenceNumber;
+  if (!done && user_key_row_cache != nullptr && s.ok() &&
+      merge_context.GetNumOperands() == 0 && max_covering_tombstone_seq == 0) {
+    if (user_key_row_cache->Lookup(key, snapshot, sv->current,
+                                   get_impl_options.value, stats_)) {
+      RecordTick(stats_, MEMTABLE_MISS);
+      done = true;
+    } else {
+      // Any entry of the key the read doesn't see is newer than the
+      // snapshot or in a memtable newer than the ones it looked into, whose
+      // entries are newer than the last sequence number when the mutable
+      // one was created
+      const SequenceNumber earliest = sv->mem->GetEarliestSequenceNumber();
+      if (earliest != kMaxSequenceNumber) {
+        row_cache_seq = std::min(snapshot, earliest);
+      }
+    }
+  }
   if (!done) {
     PERF_TIMER_GUARD(get_from_output_files_time);
     sv->current->Get(
@@ -2375,6 +2797,14 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
         get_impl_options.get_value ? get_impl_options.is_blob_index : nullptr,
         get_impl_options.get_value);
     RecordTick(stats_, MEMTABLE_MISS);
+    if (merge_result_seq != kMaxSequenceNumber && s.ok()) {
+      merge_result_cache->Insert(key, merge_result_seq,
+                                 *get_impl_options.value);
+    }
+    if (row_cache_seq != kMaxSequenceNumber && s.ok()) {
+      user_key_row_cache->Insert(key, row_cache_seq, sv->current,
+                                 *get_impl_options.value);
+    }
   }
 
   {
@@ -2964,6 +3394,7 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
 
       col = &columns[i];
       col->Reset();
+      col->SetProjection(read_options.wide_column_projection);
     }
 
     key_context.emplace_back(column_families[i], keys[i], val, col,
@@ -3027,7 +3458,7 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
   for (; cf_iter != multiget_cf_data.end(); ++cf_iter) {
     s = MultiGetImpl(read_options, cf_iter->start, cf_iter->num_keys,
                      &sorted_keys, cf_iter->super_version, consistent_seqnum,
-                     read_callback);
+                     read_callback, /* key_done_callback */ nullptr);
     if (!s.ok()) {
       break;
     }
@@ -3079,6 +3510,17 @@ struct CompareKeyContext {
   }
 };
 
+// Turns an OK status into OkMergeOperandThresholdExceeded if the key has
+// more merge operands than ReadOptions::merge_operand_count_threshold
+void CheckMergeOperandCountThreshold(const ReadOptions& read_options,
+                                     KeyContext* key) {
+  const auto& merge_threshold = read_options.merge_operand_count_threshold;
+  if (key->s->ok() && merge_threshold.has_value() &&
+      key->merge_context.GetNumOperands() > merge_threshold) {
+    *(key->s) = Status::OkMergeOperandThresholdExceeded();
+  }
+}
+
 }  // anonymous namespace
 
 void DBImpl::PrepareMultiGetKeys(
@@ -3127,7 +3569,51 @@ void DBImpl::MultiGet(const ReadOptions& _read_options,
     read_options.io_activity = Env::IOActivity::kMultiGet;
   }
   MultiGetCommon(read_options, column_family, num_keys, keys, values,
-                 /* columns */ nullptr, timestamps, statuses, sorted_input);
+                 /* columns */ nullptr, timestamps, statuses, sorted_input,
+                 /* key_done_callback */ nullptr);
+}
+
+void DBImpl::MultiGetStreaming(const ReadOptions& _read_options,
+                               ColumnFamilyHandle* column_family,
+                               const size_t num_keys, const Slice* keys,
+                               PinnableSlice* values, Status* statuses,
+                               const std::function<void(size_t)>& on_key_done,
+                               const bool sorted_input) {
+  std::vector<bool> reported(num_keys, false);
+  MultiGetContext::KeyDoneCallback key_done = [&](KeyContext* key) {
+    const size_t index = static_cast<size_t>(key->s - statuses);
+    assert(index < num_keys);
+    assert(!reported[index]);
+    reported[index] = true;
+    on_key_done(index);
+  };
+
+  if (_read_options.io_activity != Env::IOActivity::kUnknown &&
+      _read_options.io_activity != Env::IOActivity::kMultiGet) {
+    Status s = Status::InvalidArgument(
+        "Can only call MultiGet with `ReadOptions::io_activity` is "
+        "`Env::IOActivity::kUnknown` or `Env::IOActivity::kMultiGet`");
+    for (size_t i = 0; i < num_keys; ++i) {
+      if (statuses[i].ok()) {
+        statuses[i] = s;
+      }
+    }
+  } else {
+    ReadOptions read_options(_read_options);
+    if (read_options.io_activity == Env::IOActivity::kUnknown) {
+      read_options.io_activity = Env::IOActivity::kMultiGet;
+    }
+    MultiGetCommon(read_options, column_family, num_keys, keys, values,
+                   /* columns */ nullptr, /* timestamps */ nullptr, statuses,
+                   sorted_input, &key_done);
+  }
+
+  // Keys failing before their lookup, e.g. on a deadline, are reported last
+  for (size_t i = 0; i < num_keys; ++i) {
+    if (!reported[i]) {
+      on_key_done(i);
+    }
+  }
 }
 
 void DBImpl::MultiGetCommon(const ReadOptions& read_options,
@@ -3135,7 +3621,9 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
                             const size_t num_keys, const Slice* keys,
                             PinnableSlice* values, PinnableWideColumns* columns,
                             std::string* timestamps, Status* statuses,
-                            bool sorted_input) {
+                            bool sorted_input,
+                            const MultiGetContext::KeyDoneCallback*
+                                key_done_callback) {
   if (tracer_) {
     // TODO: This mutex should be removed later, to improve performance when
     // tracing is enabled.
@@ -3160,6 +3648,7 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
 
       col = &columns[i];
       col->Reset();
+      col->SetProjection(read_options.wide_column_projection);
     }
 
     key_context.emplace_back(column_family, keys[i], val, col,
@@ -3170,7 +3659,8 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
     sorted_keys[i] = &key_context[i];
   }
   PrepareMultiGetKeys(num_keys, sorted_input, &sorted_keys);
-  MultiGetWithCallbackImpl(read_options, column_family, nullptr, &sorted_keys);
+  MultiGetWithCallbackImpl(read_options, column_family, nullptr, &sorted_keys,
+                           key_done_callback);
 }
 
 void DBImpl::MultiGetWithCallback(
@@ -3187,13 +3677,15 @@ void DBImpl::MultiGetWithCallback(
   if (read_options.io_activity == Env::IOActivity::kUnknown) {
     read_options.io_activity = Env::IOActivity::kMultiGet;
   }
-  MultiGetWithCallbackImpl(read_options, column_family, callback, sorted_keys);
+  MultiGetWithCallbackImpl(read_options, column_family, callback, sorted_keys,
+                           /* key_done_callback */ nullptr);
 }
 
 void DBImpl::MultiGetWithCallbackImpl(
     const ReadOptions& read_options, ColumnFamilyHandle* column_family,
     ReadCallback* callback,
-    autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys) {
+    autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
+    const MultiGetContext::KeyDoneCallback* key_done_callback) {
   std::array<MultiGetColumnFamilyData, 1> multiget_cf_data;
   multiget_cf_data[0] = MultiGetColumnFamilyData(column_family, nullptr);
   std::function<MultiGetColumnFamilyData*(
@@ -3248,7 +3740,7 @@ void DBImpl::MultiGetWithCallbackImpl(
 
   s = MultiGetImpl(read_options, 0, num_keys, sorted_keys,
                    multiget_cf_data[0].super_version, consistent_seqnum,
-                   read_callback);
+                   read_callback, key_done_callback);
   assert(s.ok() || s.IsTimedOut() || s.IsAborted());
   ReturnAndCleanupSuperVersion(multiget_cf_data[0].cfd,
                                multiget_cf_data[0].super_version);
@@ -3267,7 +3759,8 @@ Status DBImpl::MultiGetImpl(
     const ReadOptions& read_options, size_t start_key, size_t num_keys,
     autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
     SuperVersion* super_version, SequenceNumber snapshot,
-    ReadCallback* callback) {
+    ReadCallback* callback,
+    const MultiGetContext::KeyDoneCallback* key_done_callback) {
   PERF_CPU_TIMER_GUARD(get_cpu_nanos, immutable_db_options_.clock);
   StopWatch sw(immutable_db_options_.clock, stats_, DB_MULTIGET);
 
@@ -3288,6 +3781,13 @@ Status DBImpl::MultiGetImpl(
   size_t keys_left = num_keys;
   Status s;
   uint64_t curr_value_size = 0;
+  MultiGetContext::KeyDoneCallback key_done;
+  if (key_done_callback) {
+    key_done = [&](KeyContext* key) {
+      CheckMergeOperandCountThreshold(read_options, key);
+      (*key_done_callback)(key);
+    };
+  }
   while (keys_left) {
     if (read_options.deadline.count() &&
         immutable_db_options_.clock->NowMicros() >
@@ -3302,6 +3802,9 @@ Status DBImpl::MultiGetImpl(
     MultiGetContext ctx(sorted_keys, start_key + num_keys - keys_left,
                         batch_size, snapshot, read_options, GetFileSystem(),
                         stats_);
+    if (key_done_callback) {
+      ctx.SetKeyDoneCallback(&key_done);
+    }
     MultiGetRange range = ctx.GetMultiGetRange();
     range.AddValueSize(curr_value_size);
     bool lookup_current = true;
@@ -3328,11 +3831,13 @@ Status DBImpl::MultiGetImpl(
       } else {
         lookup_current = false;
       }
+      ctx.ReportDoneKeys(/*all=*/false);
     }
     if (lookup_current) {
       PERF_TIMER_GUARD(get_from_output_files_time);
       super_version->current->MultiGet(read_options, &range, callback);
     }
+    ctx.ReportDoneKeys(/*all=*/true);
     curr_value_size = range.GetValueSize();
     if (curr_value_size > read_options.value_size_soft_limit) {
       s = Status::Aborted();
@@ -3350,11 +3855,7 @@ Status DBImpl::MultiGetImpl(
     assert(key->s);
 
     if (key->s->ok()) {
-      const auto& merge_threshold = read_options.merge_operand_count_threshold;
-      if (merge_threshold.has_value() &&
-          key->merge_context.GetNumOperands() > merge_threshold) {
-        *(key->s) = Status::OkMergeOperandThresholdExceeded();
-      }
+      CheckMergeOperandCountThreshold(read_options, key);
 
       if (key->value) {
         bytes_read += key->value->size();
@@ -3433,7 +3934,7 @@ void DBImpl::MultiGetEntity(const ReadOptions& _read_options,
   }
   MultiGetCommon(read_options, column_family, num_keys, keys,
                  /* values */ nullptr, results, /* timestamps */ nullptr,
-                 statuses, sorted_input);
+                 statuses, sorted_input, /* key_done_callback */ nullptr);
 }
 
 void DBImpl::MultiGetEntity(const ReadOptions& _read_options, size_t num_keys,
@@ -3816,6 +4317,68 @@ bool DBImpl::KeyMayExist(const ReadOptions& read_options,
   return s.ok() || s.IsIncomplete();
 }
 
+Status DBImpl::MultiKeyMayExist(const ReadOptions& _read_options,
+                                ColumnFamilyHandle* column_family,
+                                size_t num_keys, const Slice* keys,
+                                bool* may_exist) {
+  std::fill(may_exist, may_exist + num_keys, true);
+  if (num_keys == 0) {
+    return Status::OK();
+  }
+  assert(column_family);
+  Status s = _read_options.timestamp
+                 ? FailIfTsMismatchCf(column_family,
+                                      *(_read_options.timestamp))
+                 : FailIfCfHasTs(column_family);
+  if (!s.ok()) {
+    return s;
+  }
+  ReadOptions read_options(_read_options);
+  // Range tombstones could only rule out more keys
+  read_options.ignore_range_deletions = true;
+
+  autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE> key_context;
+  autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE> sorted_keys;
+  for (size_t i = 0; i < num_keys; ++i) {
+    key_context.emplace_back(column_family, keys[i], /*val=*/nullptr,
+                             /*cols=*/nullptr, /*ts=*/nullptr,
+                             /*stat=*/nullptr);
+  }
+  sorted_keys.resize(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    sorted_keys[i] = &key_context[i];
+  }
+  PrepareMultiGetKeys(num_keys, /*sorted_input=*/false, &sorted_keys);
+
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(column_family)
+                 ->cfd();
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  for (size_t start = 0; start < num_keys && s.ok();
+       start += MultiGetContext::MAX_BATCH_SIZE) {
+    size_t batch_size = std::min(
+        num_keys - start, static_cast<size_t>(MultiGetContext::MAX_BATCH_SIZE));
+    // Entries of any sequence number make a key exist
+    MultiGetContext ctx(&sorted_keys, start, batch_size, kMaxSequenceNumber,
+                        read_options, GetFileSystem(), stats_);
+    MultiGetRange range = ctx.GetMultiGetRange();
+    sv->mem->KeysMayExist(&range);
+    if (!range.empty()) {
+      sv->imm->KeysMayExist(&range);
+    }
+    if (!range.empty()) {
+      s = sv->current->KeysMayExist(read_options, &range);
+    }
+  }
+  ReturnAndCleanupSuperVersion(cfd, sv);
+
+  if (s.ok()) {
+    for (size_t i = 0; i < num_keys; ++i) {
+      may_exist[i] = key_context[i].key_exists;
+    }
+  }
+  return s;
+}
+
 Iterator* DBImpl::NewIterator(const ReadOptions& _read_options,
                               ColumnFamilyHandle* column_family) {
   if (_read_options.io_activity != Env::IOActivity::kUnknown &&
@@ -3887,6 +4450,84 @@ Iterator* DBImpl::NewIterator(const ReadOptions& _read_options,
   return result;
 }
 
+Iterator* DBImpl::NewMultiScanIterator(const ReadOptions& read_options,
+                                       ColumnFamilyHandle* column_family,
+                                       const std::vector<Range>& ranges) {
+  Iterator* iter = ROCKSDB_NAMESPACE::NewMultiScanIterator(
+      this, read_options, column_family, ranges);
+  if (iter->status().ok() && !ranges.empty() && !read_options.tailing &&
+      read_options.read_tier != kBlockCacheTier) {
+    auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(column_family)
+                   ->cfd();
+    SuperVersion* sv = GetAndRefSuperVersion(cfd);
+    sv->current->PrefetchScanRanges(read_options, ranges);
+    ReturnAndCleanupSuperVersion(cfd, sv);
+  }
+  return iter;
+}
+
+BatchIterator* DBImpl::NewBatchIterator(
+    const ReadOptions& read_options, ColumnFamilyHandle* column_family,
+    const BatchIteratorOptions& batch_options) {
+  return ROCKSDB_NAMESPACE::NewBatchIterator(this, read_options, column_family,
+                                             batch_options, /*db_iter=*/true);
+}
+
+Status DBImpl::ParallelScan(const ReadOptions& read_options,
+                            ColumnFamilyHandle* column_family,
+                            const Range& range, int num_threads,
+                            const ParallelScanCallback& callback) {
+  // Split the range into more sub-ranges than threads for the threads
+  // finishing early to take over
+  constexpr uint64_t kRangesPerThread = 4;
+  std::vector<std::string> boundaries;
+  if (num_threads > 1) {
+    GetScanBoundaries(read_options, column_family, range,
+                      static_cast<uint64_t>(num_threads) * kRangesPerThread,
+                      &boundaries);
+  }
+  TEST_SYNC_POINT_CALLBACK("DBImpl::ParallelScan:Boundaries", &boundaries);
+  return ROCKSDB_NAMESPACE::ParallelScan(this, read_options, column_family,
+                                         range, boundaries, num_threads,
+                                         callback);
+}
+
+void DBImpl::GetScanBoundaries(const ReadOptions& read_options,
+                               ColumnFamilyHandle* column_family,
+                               const Range& range, uint64_t num_ranges,
+                               std::vector<std::string>* boundaries) {
+  boundaries->clear();
+  auto cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(column_family)->cfd();
+  const Comparator* ucmp = cfd->user_comparator();
+  if (num_ranges <= 1 || ucmp->timestamp_size() > 0 ||
+      ucmp->Compare(range.start, range.limit) >= 0) {
+    return;
+  }
+  // Split the range like GenSubcompactionBoundaries() does
+  std::vector<TableReader::Anchor> anchors;
+  SuperVersion* sv = GetAndRefSuperVersion(cfd);
+  const uint64_t total_size =
+      sv->current->ApproximateKeyAnchors(read_options, range, &anchors);
+  ReturnAndCleanupSuperVersion(cfd, sv);
+  std::sort(anchors.begin(), anchors.end(),
+            [ucmp](const TableReader::Anchor& a, const TableReader::Anchor& b) {
+              return ucmp->Compare(a.user_key, b.user_key) < 0;
+            });
+  const uint64_t target_range_size = total_size / num_ranges;
+  uint64_t cumulative_size = 0;
+  uint64_t next_threshold = target_range_size;
+  for (TableReader::Anchor& anchor : anchors) {
+    cumulative_size += anchor.range_size;
+    if (cumulative_size > next_threshold && target_range_size > 0 &&
+        (boundaries->empty() ||
+         ucmp->Compare(boundaries->back(), anchor.user_key) < 0)) {
+      next_threshold += target_range_size;
+      boundaries->push_back(std::move(anchor.user_key));
+    }
+  }
+}
+
 ArenaWrappedDBIter* DBImpl::NewIteratorImpl(
     const ReadOptions& read_options, ColumnFamilyData* cfd, SuperVersion* sv,
     SequenceNumber snapshot, ReadCallback* read_callback,
@@ -4302,6 +4943,26 @@ void DBImpl::ReleaseSnapshot(const Snapshot* s) {
       }
       bottommost_files_mark_threshold_ = new_bottommost_files_mark_threshold;
     }
+    // Likewise for files covered by range deletions now visible to all
+    // snapshots
+    if (oldest_snapshot > files_covered_by_range_deletions_threshold_) {
+      SequenceNumber new_threshold = kMaxSequenceNumber;
+      for (auto* cfd : *versions_->GetColumnFamilySet()) {
+        if (!DropsFilesCoveredByRangeDeletions(cfd)) {
+          continue;
+        }
+        VersionStorageInfo* vstorage = cfd->current()->storage_info();
+        vstorage->ComputeFilesCoveredByRangeDeletions(oldest_snapshot);
+        new_threshold =
+            std::min(new_threshold,
+                     vstorage->files_covered_by_range_deletions_threshold());
+        if (!vstorage->FilesCoveredByRangeDeletions().empty()) {
+          SchedulePendingCompaction(cfd);
+          MaybeScheduleFlushOrCompaction();
+        }
+      }
+      files_covered_by_range_deletions_threshold_ = new_threshold;
+    }
   }
   delete casted_s;
 }
@@ -4372,7 +5033,8 @@ SystemClock* DBImpl::GetSystemClock() const {
 
 Status DBImpl::StartIOTrace(const TraceOptions& trace_options,
                             std::unique_ptr<TraceWriter>&& trace_writer) {
-  assert(trace_writer != nullptr);
+  assert(trace_writer != nullptr ||
+         trace_options.io_trace_ring_buffer_records > 0);
   return io_tracer_->StartIOTrace(GetSystemClock(), trace_options,
                                   std::move(trace_writer));
 }
@@ -4382,6 +5044,14 @@ Status DBImpl::EndIOTrace() {
   return Status::OK();
 }
 
+Status DBImpl::DumpIOTrace(uint64_t last_micros,
+                           std::unique_ptr<TraceWriter>&& trace_writer) {
+  if (trace_writer == nullptr) {
+    return Status::InvalidArgument("A trace writer is required");
+  }
+  return io_tracer_->DumpIOTrace(last_micros, std::move(trace_writer));
+}
+
 Options DBImpl::GetOptions(ColumnFamilyHandle* column_family) const {
   InstrumentedMutexLock l(&mutex_);
   auto cfh = static_cast_with_check<ColumnFamilyHandleImpl>(column_family);
@@ -4412,8 +5082,11 @@ bool DBImpl::GetProperty(ColumnFamilyHandle* column_family,
     return ret_value;
   } else if (property_info->handle_string) {
     if (property_info->need_out_of_mutex) {
-      return cfd->internal_stats()->GetStringProperty(*property_info, property,
-                                                      value);
+      SuperVersion* sv = GetAndRefSuperVersion(cfd);
+      bool ret = cfd->internal_stats()->GetStringProperty(
+          *property_info, property, value, sv->current);
+      ReturnAndCleanupSuperVersion(cfd, sv);
+      return ret;
     } else {
       InstrumentedMutexLock l(&mutex_);
       return cfd->internal_stats()->GetStringProperty(*property_info, property,
@@ -4444,8 +5117,11 @@ bool DBImpl::GetMapProperty(ColumnFamilyHandle* column_family,
     return false;
   } else if (property_info->handle_map) {
     if (property_info->need_out_of_mutex) {
-      return cfd->internal_stats()->GetMapProperty(*property_info, property,
-                                                   value);
+      SuperVersion* sv = GetAndRefSuperVersion(cfd);
+      bool ret = cfd->internal_stats()->GetMapProperty(*property_info, property,
+                                                       value, sv->current);
+      ReturnAndCleanupSuperVersion(cfd, sv);
+      return ret;
     } else {
       InstrumentedMutexLock l(&mutex_);
       return cfd->internal_stats()->GetMapProperty(*property_info, property,
@@ -4468,6 +5144,17 @@ bool DBImpl::GetIntProperty(ColumnFamilyHandle* column_family,
   return GetIntPropertyInternal(cfd, *property_info, false, value);
 }
 
+bool DBImpl::GetIntPropertyByInfo(ColumnFamilyHandle* column_family,
+                                  const DBPropertyInfo& property_info,
+                                  uint64_t* value) {
+  if (property_info.handle_int == nullptr) {
+    return false;
+  }
+  auto cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(column_family)->cfd();
+  return GetIntPropertyInternal(cfd, property_info, false, value);
+}
+
 bool DBImpl::GetIntPropertyInternal(ColumnFamilyData* cfd,
                                     const DBPropertyInfo& property_info,
                                     bool is_locked, uint64_t* value) {
@@ -4509,6 +5196,45 @@ bool DBImpl::GetPropertyHandleOptionsStatistics(std::string* value) {
   return true;
 }
 
+bool DBImpl::GetPropertyHandleDBMutexContention(std::string* value) {
+  assert(value != nullptr);
+  if (!mutex_contention_profiler_) {
+    return false;
+  }
+  *value = mutex_contention_profiler_->ToString();
+  return true;
+}
+
+bool DBImpl::GetPropertyHandleBackgroundQueueStats(std::string* value) {
+  assert(value != nullptr);
+  if (immutable_db_options_.background_job_weight == 0) {
+    return false;
+  }
+  value->clear();
+  for (auto pri :
+       {Env::Priority::HIGH, Env::Priority::LOW, Env::Priority::BOTTOM}) {
+    ThreadPoolQueueStats total;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(TaskType::kCount); i++) {
+      ThreadPoolQueueStats stats;
+      if (!env_->GetThreadPoolQueueStats(pri, GetTaskTag(i), &stats).ok()) {
+        return false;
+      }
+      total.num_jobs += stats.num_jobs;
+      total.total_wait_micros += stats.total_wait_micros;
+      total.max_wait_micros =
+          std::max(total.max_wait_micros, stats.max_wait_micros);
+    }
+    char buf[200];
+    snprintf(buf, sizeof(buf),
+             "%s pool: %" PRIu64 " jobs, %" PRIu64
+             " micros total queue wait, %" PRIu64 " micros max queue wait\n",
+             Env::PriorityToString(pri).c_str(), total.num_jobs,
+             total.total_wait_micros, total.max_wait_micros);
+    value->append(buf);
+  }
+  return true;
+}
+
 Status DBImpl::ResetStats() {
   InstrumentedMutexLock l(&mutex_);
   for (auto* cfd : *versions_->GetColumnFamilySet()) {
@@ -4516,6 +5242,9 @@ Status DBImpl::ResetStats() {
       cfd->internal_stats()->Clear();
     }
   }
+  if (mutex_contention_profiler_) {
+    mutex_contention_profiler_->Clear();
+  }
   return Status::OK();
 }
 
@@ -4678,6 +5407,40 @@ void DBImpl::GetApproximateActiveMemTableStats(
   }
 }
 
+uint64_t DBImpl::GetApproximateWalBytesPinnedByMemTables(
+    ColumnFamilyHandle* column_family) {
+  auto* cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(column_family)->cfd();
+  InstrumentedMutexLock l(&mutex_);
+  if (cfd->IsDropped()) {
+    return 0;
+  }
+  // WALs from this column family's log number up to the oldest one any other
+  // column family still needs. The current WAL can't be deleted either way.
+  uint64_t end = logfile_number_;
+  for (auto* other : *versions_->GetColumnFamilySet()) {
+    if (other != cfd && !other->IsDropped()) {
+      end = std::min(end, other->GetLogNumber());
+    }
+  }
+  if (allow_2pc()) {
+    // Neither can WALs holding prepared sections that are still outstanding.
+    uint64_t min_prep_log =
+        logs_with_prep_tracker_.FindMinLogContainingOutstandingPrep();
+    if (min_prep_log != 0) {
+      end = std::min(end, min_prep_log);
+    }
+  }
+  uint64_t bytes = 0;
+  InstrumentedMutexLock wl(&log_write_mutex_);
+  for (const auto& log : alive_log_files_) {
+    if (log.number >= cfd->GetLogNumber() && log.number < end) {
+      bytes += log.size;
+    }
+  }
+  return bytes;
+}
+
 Status DBImpl::GetApproximateSizes(const SizeApproximationOptions& options,
                                    ColumnFamilyHandle* column_family,
                                    const Range* range, int n, uint64_t* sizes) {
@@ -4839,6 +5602,7 @@ Status DBImpl::DeleteFile(std::string name) {
     }
     edit.SetColumnFamily(cfd->GetID());
     edit.DeleteFile(level, number);
+    edit.MarkInvalidatesCachedRows();
     status = versions_->LogAndApply(cfd, *cfd->GetLatestMutableCFOptions(),
                                     read_options, &edit, &mutex_,
                                     directories_.GetDbDir());
@@ -4930,6 +5694,7 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
       job_context.Clean();
       return status;
     }
+    edit.MarkInvalidatesCachedRows();
     input_version->Ref();
     status = versions_->LogAndApply(cfd, *cfd->GetLatestMutableCFOptions(),
                                     read_options, &edit, &mutex_,
@@ -5174,6 +5939,53 @@ Status DB::DestroyColumnFamilyHandle(ColumnFamilyHandle* column_family) {
 
 DB::~DB() {}
 
+Iterator* DB::NewMultiScanIterator(const ReadOptions& options,
+                                   ColumnFamilyHandle* column_family,
+                                   const std::vector<Range>& ranges) {
+  return ROCKSDB_NAMESPACE::NewMultiScanIterator(this, options, column_family,
+                                                 ranges);
+}
+
+BatchIterator* DB::NewBatchIterator(const ReadOptions& options,
+                                    ColumnFamilyHandle* column_family,
+                                    const BatchIteratorOptions& batch_options) {
+  return ROCKSDB_NAMESPACE::NewBatchIterator(this, options, column_family,
+                                             batch_options, /*db_iter=*/false);
+}
+
+Status DB::GetTickerHistory(
+    const std::string& ticker_name, uint64_t start_time, uint64_t end_time,
+    std::vector<std::pair<uint64_t, uint64_t>>* history) {
+  if (!history) {
+    return Status::InvalidArgument("history not preallocated.");
+  }
+  history->clear();
+  std::unique_ptr<StatsHistoryIterator> stats_iter;
+  Status s = GetStatsHistory(start_time, end_time, &stats_iter);
+  if (!s.ok()) {
+    return s;
+  }
+  for (; stats_iter->Valid(); stats_iter->Next()) {
+    if (stats_iter->GetStatsTime() >= end_time) {
+      break;
+    }
+    const auto& stats = stats_iter->GetStatsMap();
+    auto it = stats.find(ticker_name);
+    if (it != stats.end()) {
+      history->emplace_back(stats_iter->GetStatsTime(), it->second);
+    }
+  }
+  return stats_iter->status();
+}
+
+Status DB::ParallelScan(const ReadOptions& options,
+                        ColumnFamilyHandle* column_family, const Range& range,
+                        int num_threads, const ParallelScanCallback& callback) {
+  return ROCKSDB_NAMESPACE::ParallelScan(this, options, column_family, range,
+                                         /*boundaries=*/{}, num_threads,
+                                         callback);
+}
+
 Status DBImpl::Close() {
   InstrumentedMutexLock closing_lock_guard(&closing_mutex_);
   if (closed_) {
@@ -5247,6 +6059,9 @@ Status DestroyDB(const std::string& dbname, const Options& options,
       }
     }
 
+    // Not one of the file types known to ParseFileName()
+    env->DeleteFile(BlockCacheHotnessFileName(dbname)).PermitUncheckedError();
+
     std::set<std::string> paths;
     for (const DbPath& db_path : options.db_paths) {
       paths.insert(db_path.path);
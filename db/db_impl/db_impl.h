@@ -14,6 +14,8 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -61,6 +63,7 @@
 #include "table/merging_iterator.h"
 #include "table/scoped_arena_iterator.h"
 #include "util/autovector.h"
+#include "util/core_local.h"
 #include "util/hash.h"
 #include "util/repeatable_thread.h"
 #include "util/stop_watch.h"
@@ -305,6 +308,13 @@ class DBImpl : public DB {
                 PinnableSlice* values, std::string* timestamps,
                 Status* statuses, const bool sorted_input = false) override;
 
+  void MultiGetStreaming(const ReadOptions& _read_options,
+                         ColumnFamilyHandle* column_family,
+                         const size_t num_keys, const Slice* keys,
+                         PinnableSlice* values, Status* statuses,
+                         const std::function<void(size_t)>& on_key_done,
+                         const bool sorted_input = false) override;
+
   void MultiGetWithCallback(
       const ReadOptions& _read_options, ColumnFamilyHandle* column_family,
       ReadCallback* callback,
@@ -349,9 +359,31 @@ class DBImpl : public DB {
                            std::string* value, std::string* timestamp,
                            bool* value_found = nullptr) override;
 
+  Status MultiKeyMayExist(const ReadOptions& options,
+                          ColumnFamilyHandle* column_family, size_t num_keys,
+                          const Slice* keys, bool* may_exist) override;
+
   using DB::NewIterator;
   virtual Iterator* NewIterator(const ReadOptions& _read_options,
                                 ColumnFamilyHandle* column_family) override;
+  Iterator* NewMultiScanIterator(const ReadOptions& read_options,
+                                 ColumnFamilyHandle* column_family,
+                                 const std::vector<Range>& ranges) override;
+  BatchIterator* NewBatchIterator(
+      const ReadOptions& read_options, ColumnFamilyHandle* column_family,
+      const BatchIteratorOptions& batch_options) override;
+  Status ParallelScan(const ReadOptions& read_options,
+                      ColumnFamilyHandle* column_family, const Range& range,
+                      int num_threads,
+                      const ParallelScanCallback& callback) override;
+  // Sets `*boundaries` to sorted user keys strictly inside of `range` that
+  // split it into up to `num_ranges` sub-ranges of about the same size of
+  // table file data, found from the key anchors of the files like the
+  // boundaries of subcompactions. No boundaries with user timestamps.
+  void GetScanBoundaries(const ReadOptions& read_options,
+                         ColumnFamilyHandle* column_family, const Range& range,
+                         uint64_t num_ranges,
+                         std::vector<std::string>* boundaries);
   virtual Status NewIterators(
       const ReadOptions& _read_options,
       const std::vector<ColumnFamilyHandle*>& column_families,
@@ -382,6 +414,11 @@ class DBImpl : public DB {
   using DB::GetIntProperty;
   virtual bool GetIntProperty(ColumnFamilyHandle* column_family,
                               const Slice& property, uint64_t* value) override;
+  // Like GetIntProperty(), for a property already looked up with
+  // GetPropertyInfo(), without the allocations of the lookup
+  bool GetIntPropertyByInfo(ColumnFamilyHandle* column_family,
+                            const DBPropertyInfo& property_info,
+                            uint64_t* value);
   using DB::GetAggregatedIntProperty;
   virtual bool GetAggregatedIntProperty(const Slice& property,
                                         uint64_t* aggregated_value) override;
@@ -400,6 +437,8 @@ class DBImpl : public DB {
   virtual void GetApproximateActiveMemTableStats(
       ColumnFamilyHandle* column_family, uint64_t* const memory_bytes,
       uint64_t* const oldest_key_time) override;
+  uint64_t GetApproximateWalBytesPinnedByMemTables(
+      ColumnFamilyHandle* column_family) override;
 
   using DB::CompactRange;
   virtual Status CompactRange(const CompactRangeOptions& options,
@@ -415,6 +454,9 @@ class DBImpl : public DB {
       std::vector<std::string>* const output_file_names = nullptr,
       CompactionJobInfo* compaction_job_info = nullptr) override;
 
+  Status GarbageCollectBlobFiles(const GarbageCollectBlobFilesOptions& options,
+                                 ColumnFamilyHandle* column_family) override;
+
   virtual Status PauseBackgroundWork() override;
   virtual Status ContinueBackgroundWork() override;
 
@@ -492,6 +534,10 @@ class DBImpl : public DB {
       uint64_t start_time, uint64_t end_time,
       std::unique_ptr<StatsHistoryIterator>* stats_iterator) override;
 
+  Status GetTickerHistory(
+      const std::string& ticker_name, uint64_t start_time, uint64_t end_time,
+      std::vector<std::pair<uint64_t, uint64_t>>* history) override;
+
   using DB::ResetStats;
   virtual Status ResetStats() override;
   // All the returned filenames start with "/"
@@ -615,6 +661,10 @@ class DBImpl : public DB {
   using DB::EndIOTrace;
   Status EndIOTrace() override;
 
+  using DB::DumpIOTrace;
+  Status DumpIOTrace(uint64_t last_micros,
+                     std::unique_ptr<TraceWriter>&& trace_writer) override;
+
   using DB::GetPropertiesOfAllTables;
   virtual Status GetPropertiesOfAllTables(
       ColumnFamilyHandle* column_family,
@@ -931,6 +981,8 @@ class DBImpl : public DB {
 
   const WriteController& write_controller() { return write_controller_; }
 
+  const WriteThread& write_thread() const { return write_thread_; }
+
   // hollow transactions shell used for recovery.
   // these will then be passed to TransactionDB so that
   // locks can be reacquired before writing can resume.
@@ -1142,6 +1194,11 @@ class DBImpl : public DB {
   // Wait for any background purge
   Status TEST_WaitForPurge();
 
+  // Wait for the block cache warm-up after DB::Open()
+  void TEST_WaitForBlockCacheWarmUp();
+
+  void TEST_PersistBlockCacheHotness() { PersistBlockCacheHotness(); }
+
   // Get the background error status
   Status TEST_GetBGError();
 
@@ -1240,6 +1297,18 @@ class DBImpl : public DB {
   // flush LOG out of application buffer
   void FlushInfoLog();
 
+  // adjust compaction_budget_ and the rate limiter to the foreground latency,
+  // see DBOptions::compaction_throttle_latency_micros
+  void ThrottleCompaction();
+
+  // record which blocks of the table files are in the block cache, see
+  // DBOptions::block_cache_hotness_persist_period_sec
+  void PersistBlockCacheHotness();
+
+  // load the blocks recorded by PersistBlockCacheHotness() back into the
+  // block cache
+  void WarmUpBlockCache();
+
   // record current sequence number to time mapping. If
   // populate_historical_seconds > 0 then pre-populate all the
   // sequence numbers from [1, last] to map to [now minus
@@ -1336,6 +1405,11 @@ class DBImpl : public DB {
   // logs_, logfile_number_. Refer to the definition of each variable below for
   // more description.
   //
+  // Profiles the contention of mutex_, if
+  // DBOptions::db_mutex_contention_threshold_micros is set. Declared before
+  // mutex_ to outlive it.
+  std::unique_ptr<MutexContentionProfiler> mutex_contention_profiler_;
+
   // `mutex_` can be a hot lock in some workloads, so it deserves dedicated
   // cachelines.
   mutable CacheAlignedInstrumentedMutex mutex_;
@@ -1979,6 +2053,11 @@ class DBImpl : public DB {
 
   Status SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context);
 
+  // Moves the pages of the memtable `mem`, just switched out, to
+  // DBOptions::immutable_memtable_numa_node if set. Releases mutex_ while
+  // moving them.
+  void MoveMemTableToFarMemory(MemTable* mem, WriteContext* context);
+
   // Select and output column families qualified for atomic flush in
   // `selected_cfds`. If `provided_candidate_cfds` is non-empty, it will be used
   // as candidate CFs to select qualified ones from. Otherwise, all column
@@ -2047,13 +2126,45 @@ class DBImpl : public DB {
 
     // Wait for the ones who already wrote to the WAL to finish their
     // memtable write.
-    if (pending_memtable_writes_.load() != 0) {
+    if (PendingMemtableWrites() != 0) {
       std::unique_lock<std::mutex> guard(switch_mutex_);
-      switch_cv_.wait(guard,
-                      [&] { return pending_memtable_writes_.load() == 0; });
+      pending_memtable_write_waiters_.fetch_add(1);
+      switch_cv_.wait(guard, [&] { return PendingMemtableWrites() == 0; });
+      pending_memtable_write_waiters_.fetch_sub(1);
+    }
+  }
+
+  // Counts memtable writes that a write group leader handed off to its
+  // writers after writing their batches to the WAL.
+  void AddPendingMemtableWrites(size_t count) {
+    pending_memtable_writes_.Access()->obj_.fetch_add(
+        static_cast<int64_t>(count));
+  }
+
+  // Called by a writer once its handed-off memtable write is done.
+  void FinishPendingMemtableWrite() {
+    pending_memtable_writes_.Access()->obj_.fetch_sub(1);
+    // The shards only need adding up while WaitForPendingWrites() waits. No
+    // memtable writes are handed off meanwhile, so a zero sum here is final.
+    if (pending_memtable_write_waiters_.load() > 0 &&
+        PendingMemtableWrites() == 0) {
+      // switch_cv_ waits until pending_memtable_writes_ = 0. Locking its mutex
+      // before notify ensures that cv is in waiting state when it is notified
+      // thus not missing the update to pending_memtable_writes_ even though it
+      // is not modified under the mutex.
+      std::lock_guard<std::mutex> lck(switch_mutex_);
+      switch_cv_.notify_all();
     }
   }
 
+  int64_t PendingMemtableWrites() const {
+    int64_t pending = 0;
+    for (size_t i = 0; i < pending_memtable_writes_.Size(); ++i) {
+      pending += pending_memtable_writes_.AccessAtCore(i)->obj_.load();
+    }
+    return pending;
+  }
+
   // TaskType is used to identify tasks in thread-pool, currently only
   // differentiate manual compaction, which could be unscheduled from the
   // thread-pool.
@@ -2086,17 +2197,34 @@ class DBImpl : public DB {
   // Merge write batches in the write group into merged_batch.
   // Returns OK if merge is successful.
   // Returns Corruption if corruption in write batch is detected.
+  // If `parts` is not null and the batches have to be merged, tmp_batch only
+  // gets the merged header and `parts` is set to the header followed by the
+  // records of each batch, which are left where they are.
   Status MergeBatch(const WriteThread::WriteGroup& write_group,
                     WriteBatch* tmp_batch, WriteBatch** merged_batch,
-                    size_t* write_with_wal, WriteBatch** to_be_cached_state);
+                    size_t* write_with_wal, WriteBatch** to_be_cached_state,
+                    std::vector<Slice>* parts = nullptr);
 
   // rate_limiter_priority is used to charge `DBOptions::rate_limiter`
   // for automatic WAL flush (`Options::manual_wal_flush` == false)
   // associated with this WriteToWAL
+  // If `parts` is not empty, it is the record to write, as set up by
+  // MergeBatch, and merged_batch only holds its header.
+  // If `compressed_payload` is not empty, it is the payload of the record
+  // compressed by the writers, see MaybeCompressWALPayload(), which follows
+  // the header of merged_batch.
   IOStatus WriteToWAL(const WriteBatch& merged_batch, log::Writer* log_writer,
                       uint64_t* log_used, uint64_t* log_size,
                       Env::IOPriority rate_limiter_priority,
-                      LogFileNumberSize& log_file_number_size);
+                      LogFileNumberSize& log_file_number_size,
+                      const std::vector<Slice>& parts = {},
+                      const std::vector<Slice>& compressed_payload = {});
+
+  // With wal_compression, compresses the WAL payload of the batches of `w`
+  // in the calling thread before it joins a write group, so that the group
+  // leader doesn't compress the whole group while the others wait.
+  void MaybeCompressWALPayload(const WriteOptions& write_options,
+                               WriteThread::Writer* w);
 
   IOStatus WriteToWAL(const WriteThread::WriteGroup& write_group,
                       log::Writer* log_writer, uint64_t* log_used,
@@ -2104,6 +2232,13 @@ class DBImpl : public DB {
                       SequenceNumber sequence,
                       LogFileNumberSize& log_file_number_size);
 
+  // Used by PipelinedWriteImpl with enable_pipelined_wal_sync. Makes sure
+  // every WAL record up to `sequence` is synced, either by waiting for a sync
+  // already in flight to cover it or by syncing the WAL itself.
+  Status SyncPipelinedWAL(SequenceNumber sequence);
+
+  void AdvancePipelinedWALSyncedSeq(SequenceNumber sequence);
+
   IOStatus ConcurrentWriteToWAL(const WriteThread::WriteGroup& write_group,
                                 uint64_t* log_used,
                                 SequenceNumber* last_sequence, size_t seq_inc);
@@ -2170,6 +2305,7 @@ class DBImpl : public DB {
   static void BGWorkBottomCompaction(void* arg);
   static void BGWorkFlush(void* arg);
   static void BGWorkPurge(void* arg);
+  static void BGWorkBlockCacheWarmUp(void* arg);
   static void UnscheduleCompactionCallback(void* arg);
   static void UnscheduleFlushCallback(void* arg);
   void BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
@@ -2185,9 +2321,11 @@ class DBImpl : public DB {
                          bool* flush_rescheduled_to_retain_udt,
                          Env::Priority thread_pri);
 
+  // May change `output_path_id` to a path with room for the compaction
   bool EnoughRoomForCompaction(ColumnFamilyData* cfd,
                                const std::vector<CompactionInputFiles>& inputs,
-                               bool* sfm_bookkeeping, LogBuffer* log_buffer);
+                               uint32_t* output_path_id, bool* sfm_bookkeeping,
+                               LogBuffer* log_buffer);
 
   // Request compaction tasks token from compaction thread limiter.
   // It always succeeds if force = true or limiter is disable.
@@ -2209,6 +2347,10 @@ class DBImpl : public DB {
 
   Status RegisterRecordSeqnoTimeWorker(bool is_new_db);
 
+  // If enabled, schedules WarmUpBlockCache() and then
+  // PersistBlockCacheHotness() periodically
+  Status RegisterBlockCacheHotnessWorker();
+
   void PrintStatistics();
 
   size_t EstimateInMemoryStatsHistorySize() const;
@@ -2271,6 +2413,10 @@ class DBImpl : public DB {
   // All ColumnFamily state changes go through this function. Here we analyze
   // the new state and we schedule background work if we detect that the new
   // state needs flush or compaction.
+  // Whether `cfd` drops the files covered by range deletions, see
+  // drop_files_covered_by_range_deletions
+  bool DropsFilesCoveredByRangeDeletions(const ColumnFamilyData* cfd) const;
+
   void InstallSuperVersionAndScheduleWork(
       ColumnFamilyData* cfd, SuperVersionContext* sv_context,
       const MutableCFOptions& mutable_cf_options);
@@ -2279,6 +2425,8 @@ class DBImpl : public DB {
                               const DBPropertyInfo& property_info,
                               bool is_locked, uint64_t* value);
   bool GetPropertyHandleOptionsStatistics(std::string* value);
+  bool GetPropertyHandleDBMutexContention(std::string* value);
+  bool GetPropertyHandleBackgroundQueueStats(std::string* value);
 
   bool HasPendingManualCompaction();
   bool HasExclusiveManualCompaction();
@@ -2323,11 +2471,14 @@ class DBImpl : public DB {
       const size_t num_keys, bool sorted,
       autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* key_ptrs);
 
-  void MultiGetCommon(const ReadOptions& options,
-                      ColumnFamilyHandle* column_family, const size_t num_keys,
-                      const Slice* keys, PinnableSlice* values,
-                      PinnableWideColumns* columns, std::string* timestamps,
-                      Status* statuses, bool sorted_input);
+  // If key_done_callback is non-null, it is called for each key once its
+  // result is final
+  void MultiGetCommon(
+      const ReadOptions& options, ColumnFamilyHandle* column_family,
+      const size_t num_keys, const Slice* keys, PinnableSlice* values,
+      PinnableWideColumns* columns, std::string* timestamps, Status* statuses,
+      bool sorted_input,
+      const MultiGetContext::KeyDoneCallback* key_done_callback);
 
   void MultiGetCommon(const ReadOptions& options, const size_t num_keys,
                       ColumnFamilyHandle** column_families, const Slice* keys,
@@ -2404,12 +2555,14 @@ class DBImpl : public DB {
   Status MultiGetImpl(
       const ReadOptions& read_options, size_t start_key, size_t num_keys,
       autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
-      SuperVersion* sv, SequenceNumber snap_seqnum, ReadCallback* callback);
+      SuperVersion* sv, SequenceNumber snap_seqnum, ReadCallback* callback,
+      const MultiGetContext::KeyDoneCallback* key_done_callback);
 
   void MultiGetWithCallbackImpl(
       const ReadOptions& read_options, ColumnFamilyHandle* column_family,
       ReadCallback* callback,
-      autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys);
+      autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE>* sorted_keys,
+      const MultiGetContext::KeyDoneCallback* key_done_callback);
 
   Status DisableFileDeletionsWithLock();
 
@@ -2572,6 +2725,11 @@ class DBImpl : public DB {
 
   // Signaled when getting_synced becomes false for some of the logs_.
   InstrumentedCondVar log_sync_cv_;
+  // With enable_pipelined_wal_sync, the last sequence appended to the WAL by
+  // a write group that deferred its sync, and the last sequence known to be
+  // synced. Both only move forward.
+  std::atomic<SequenceNumber> pipelined_wal_written_seq_{0};
+  std::atomic<SequenceNumber> pipelined_wal_synced_seq_{0};
   // This is the app-level state that is written to the WAL but will be used
   // only during recovery. Using this feature enables not writing the state to
   // memtable on normal writes and hence improving the throughput. Each new
@@ -2582,6 +2740,9 @@ class DBImpl : public DB {
   WriteBatch cached_recoverable_state_;
   std::atomic<bool> cached_recoverable_state_empty_ = {true};
   std::atomic<uint64_t> total_log_size_;
+  // Set when a new WAL brings the number of alive WAL files over
+  // max_alive_wal_files, and cleared once the write path acts on it.
+  std::atomic<bool> too_many_alive_wal_files_{false};
 
   // If this is non-empty, we need to delete these log files in background
   // threads. Protected by log_write_mutex_.
@@ -2605,6 +2766,15 @@ class DBImpl : public DB {
 
   WriteThread write_thread_;
   WriteBatch tmp_batch_;
+  // Record parts of a merged write group, reused like tmp_batch_.
+  std::vector<Slice> tmp_batch_parts_;
+  // The payloads compressed by the writers of a write group, reused like
+  // tmp_batch_.
+  std::vector<Slice> tmp_compressed_payload_;
+  // Compressors for MaybeCompressWALPayload(), each taken by one writing
+  // thread at a time
+  std::mutex wal_compressors_mutex_;
+  std::vector<std::unique_ptr<log::RecordCompressor>> wal_compressors_;
   // The write thread when the writers have no memtable write. This will be used
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
@@ -2684,6 +2854,17 @@ class DBImpl : public DB {
   // count how many background compactions are running or have been scheduled
   int bg_compaction_scheduled_;
 
+  // If positive, the number of compactions ThrottleCompaction() currently
+  // allows to run at once
+  int compaction_budget_ = 0;
+  // The rate of the rate limiter before ThrottleCompaction() started
+  // adjusting it, or 0
+  int64_t throttle_max_rate_bytes_per_sec_ = 0;
+  // The count and total latency of the foreground operations recorded in
+  // statistics when ThrottleCompaction() last ran. Only used by it.
+  uint64_t throttle_last_op_count_ = 0;
+  uint64_t throttle_last_op_micros_ = 0;
+
   // stores the number of compactions are currently running
   int num_running_compactions_;
 
@@ -2696,6 +2877,9 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_;
 
+  // number of background block cache warm-ups, submitted to the LOW pool
+  int bg_block_cache_warmup_scheduled_;
+
   std::deque<ManualCompactionState*> manual_compaction_dequeue_;
 
   // shall we disable deletion of obsolete files
@@ -2719,8 +2903,15 @@ class DBImpl : public DB {
   std::condition_variable switch_cv_;
   // The mutex used by switch_cv_. mutex_ should be acquired beforehand.
   std::mutex switch_mutex_;
-  // Number of threads intending to write to memtable
-  std::atomic<size_t> pending_memtable_writes_ = {};
+  // Number of threads intending to write to memtable, spread over per-core
+  // shards so that writers finishing their memtable writes do not all update
+  // the same cache line. A shard goes negative when a writer finishes on
+  // another core than the one its leader counted it on, only the sum is
+  // meaningful.
+  CoreLocalArray<CacheAlignedWrapper<std::atomic<int64_t>>>
+      pending_memtable_writes_;
+  // Number of WaitForPendingWrites() calls waiting on switch_cv_.
+  std::atomic<int> pending_memtable_write_waiters_{0};
 
   // A flag indicating whether the current rocksdb database has any
   // data that is not yet persisted into either WAL or SST file.
@@ -2758,6 +2949,11 @@ class DBImpl : public DB {
   // garbages, among all column families.
   SequenceNumber bottommost_files_mark_threshold_ = kMaxSequenceNumber;
 
+  // The min threshold to look again for files covered by range deletions,
+  // among all column families dropping them.
+  SequenceNumber files_covered_by_range_deletions_threshold_ =
+      kMaxSequenceNumber;
+
   LogsWithPrepTracker logs_with_prep_tracker_;
 
   // Callback for compaction to check if a key is visible to a snapshot.
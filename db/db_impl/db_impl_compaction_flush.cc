@@ -13,12 +13,14 @@
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
 #include "db/event_helpers.h"
+#include "file/file_util.h"
 #include "file/sst_file_manager_impl.h"
 #include "logging/logging.h"
 #include "monitoring/iostats_context_imp.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/thread_status_updater.h"
 #include "monitoring/thread_status_util.h"
+#include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 #include "util/coding.h"
@@ -29,7 +31,8 @@ namespace ROCKSDB_NAMESPACE {
 
 bool DBImpl::EnoughRoomForCompaction(
     ColumnFamilyData* cfd, const std::vector<CompactionInputFiles>& inputs,
-    bool* sfm_reserved_compact_space, LogBuffer* log_buffer) {
+    uint32_t* output_path_id, bool* sfm_reserved_compact_space,
+    LogBuffer* log_buffer) {
   // Check if we have enough room to do the compaction
   bool enough_room = true;
   auto sfm = static_cast<SstFileManagerImpl*>(
@@ -39,7 +42,8 @@ bool DBImpl::EnoughRoomForCompaction(
     // perform. If this DB instance hasn't seen any error yet, the SFM can be
     // optimistic and not do disk space checks
     Status bg_error = error_handler_.GetBGError();
-    enough_room = sfm->EnoughRoomForCompaction(cfd, inputs, bg_error);
+    enough_room =
+        sfm->EnoughRoomForCompaction(cfd, inputs, bg_error, output_path_id);
     bg_error.PermitUncheckedError();  // bg_error is just a copy of the Status
                                       // from the error_handler_
     if (enough_room) {
@@ -413,6 +417,11 @@ Status DBImpl::FlushMemTableToOutputFile(
       // exists. Otherwise, some tests may fail.  Ignore the error in the
       // interim.
       sfm->OnAddFile(file_path).PermitUncheckedError();
+      for (const FileMetaData& meta : flush_job.GetExtraFileMetaData()) {
+        sfm->OnAddFile(MakeTableFileName(cfd->ioptions()->cf_paths[0].path,
+                                         meta.fd.GetNumber()))
+            .PermitUncheckedError();
+      }
       if (sfm->IsMaxAllowedSpaceReached()) {
         Status new_bg_error =
             Status::SpaceLimit("Max allowed space was reached");
@@ -1449,6 +1458,128 @@ Status DBImpl::CompactFiles(const CompactionOptions& compact_options,
   return s;
 }
 
+Status DBImpl::GarbageCollectBlobFiles(
+    const GarbageCollectBlobFilesOptions& options,
+    ColumnFamilyHandle* column_family) {
+  if (column_family == nullptr) {
+    return Status::InvalidArgument("ColumnFamilyHandle must be non-null.");
+  }
+  if (!(options.garbage_ratio_threshold >= 0.0 &&
+        options.garbage_ratio_threshold <= 1.0)) {
+    return Status::InvalidArgument(
+        "garbage_ratio_threshold must be between 0 and 1");
+  }
+  auto cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(column_family)->cfd();
+  assert(cfd);
+
+  // The newest blob file collected, and the live bytes of those collected
+  uint64_t last_blob_file_number = kInvalidBlobFileNumber;
+  uint64_t live_blob_bytes = 0;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    const auto& blob_files = cfd->current()->storage_info()->GetBlobFiles();
+    uint64_t total_blob_bytes = 0;
+    uint64_t garbage_blob_bytes = 0;
+    uint64_t blob_file_bytes = 0;
+    for (const auto& meta : blob_files) {
+      assert(meta);
+      blob_file_bytes += meta->GetBlobFileSize();
+      if (options.max_blob_file_bytes > 0 &&
+          last_blob_file_number != kInvalidBlobFileNumber &&
+          blob_file_bytes > options.max_blob_file_bytes) {
+        break;
+      }
+      total_blob_bytes += meta->GetTotalBlobBytes();
+      garbage_blob_bytes += meta->GetGarbageBlobBytes();
+      if (garbage_blob_bytes >=
+          options.garbage_ratio_threshold * total_blob_bytes) {
+        last_blob_file_number = meta->GetBlobFileNumber();
+        live_blob_bytes = total_blob_bytes - garbage_blob_bytes;
+      } else if (last_blob_file_number == kInvalidBlobFileNumber) {
+        // Compaction relocates the blobs of the oldest blob files, so the
+        // oldest one must be collected
+        break;
+      }
+    }
+  }
+  if (last_blob_file_number == kInvalidBlobFileNumber) {
+    return Status::OK();
+  }
+
+  Status s;
+  for (int level = 0; s.ok() && level < cfd->NumberLevels(); ++level) {
+    // Runs of adjacent files of the level to rewrite, with their bytes. The
+    // files between two runs would be compacted as well otherwise.
+    std::vector<std::pair<std::vector<std::string>, uint64_t>> runs;
+    CompactionOptions compact_options;
+    compact_options.compression = kDisableCompressionOption;
+    compact_options.blob_garbage_collection_policy =
+        BlobGarbageCollectionPolicy::kForce;
+    {
+      InstrumentedMutexLock l(&mutex_);
+      const VersionStorageInfo* vstorage = cfd->current()->storage_info();
+      bool in_run = false;
+      for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+        if (f->oldest_blob_file_number == kInvalidBlobFileNumber ||
+            f->oldest_blob_file_number > last_blob_file_number ||
+            f->being_compacted) {
+          // Files of L0 may be compacted together regardless
+          in_run = in_run && level == 0;
+          continue;
+        }
+        if (!in_run) {
+          runs.emplace_back();
+          runs.back().second = 0;
+          in_run = true;
+        }
+        runs.back().first.push_back(MakeTableFileName(f->fd.GetNumber()));
+        runs.back().second += f->fd.GetFileSize();
+      }
+      // The cutoff is an index into the current blob files, see
+      // CompactionIterator::ComputeBlobGarbageCollectionCutoffFileNumber(),
+      // so that the blob files up to last_blob_file_number fall below it. A
+      // blob file added before the compaction starts may move the cutoff by
+      // one file.
+      const auto& blob_files = vstorage->GetBlobFiles();
+      size_t count = 0;
+      while (count < blob_files.size() &&
+             blob_files[count]->GetBlobFileNumber() <= last_blob_file_number) {
+        ++count;
+      }
+      compact_options.blob_garbage_collection_age_cutoff =
+          count == blob_files.size()
+              ? 1.0
+              : (count + 0.5) / static_cast<double>(blob_files.size());
+      compact_options.output_file_size_limit = MaxFileSizeForLevel(
+          *cfd->GetLatestMutableCFOptions(), level,
+          cfd->ioptions()->compaction_style);
+    }
+    for (size_t i = 0; s.ok() && i < runs.size(); ++i) {
+      if (options.rate_limiter) {
+        // The live blobs are charged with the first run
+        uint64_t bytes = runs[i].second + live_blob_bytes;
+        live_blob_bytes = 0;
+        RateLimiter* const rate_limiter = options.rate_limiter.get();
+        while (bytes > 0) {
+          const uint64_t request = std::min<uint64_t>(
+              bytes,
+              static_cast<uint64_t>(rate_limiter->GetSingleBurstBytes()));
+          rate_limiter->Request(static_cast<int64_t>(request), Env::IO_LOW,
+                                stats_, RateLimiter::OpType::kRead);
+          bytes -= request;
+        }
+      }
+      s = CompactFiles(compact_options, column_family, runs[i].first, level);
+      if (s.IsAborted()) {
+        // Conflicts with a running compaction, so left to later calls
+        s = Status::OK();
+      }
+    }
+  }
+  return s;
+}
+
 Status DBImpl::CompactFilesImpl(
     const CompactionOptions& compact_options, ColumnFamilyData* cfd,
     Version* version, const std::vector<std::string>& input_file_names,
@@ -1514,9 +1645,11 @@ Status DBImpl::CompactFilesImpl(
     }
   }
   bool sfm_reserved_compact_space = false;
+  uint32_t compaction_output_path_id = static_cast<uint32_t>(output_path_id);
   // First check if we have enough room to do the compaction
-  bool enough_room = EnoughRoomForCompaction(
-      cfd, input_files, &sfm_reserved_compact_space, log_buffer);
+  bool enough_room =
+      EnoughRoomForCompaction(cfd, input_files, &compaction_output_path_id,
+                              &sfm_reserved_compact_space, log_buffer);
 
   if (!enough_room) {
     // m's vars will get set properly at the end of this function,
@@ -1531,7 +1664,8 @@ Status DBImpl::CompactFilesImpl(
   assert(cfd->compaction_picker());
   c.reset(cfd->compaction_picker()->CompactFiles(
       compact_options, input_files, output_level, version->storage_info(),
-      *cfd->GetLatestMutableCFOptions(), mutable_db_options_, output_path_id));
+      *cfd->GetLatestMutableCFOptions(), mutable_db_options_,
+      compaction_output_path_id));
   // we already sanitized the set of input files and checked for conflicts
   // without releasing the lock, so we're guaranteed a compaction can be formed.
   assert(c != nullptr);
@@ -2908,10 +3042,20 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
 
 DBImpl::BGJobLimits DBImpl::GetBGJobLimits() const {
   mutex_.AssertHeld();
-  return GetBGJobLimits(mutable_db_options_.max_background_flushes,
-                        mutable_db_options_.max_background_compactions,
-                        mutable_db_options_.max_background_jobs,
-                        write_controller_.NeedSpeedupCompaction());
+  // The compaction budget set by ThrottleCompaction() replaces the default of
+  // a single compaction, unless writes are already held back
+  const bool throttled = compaction_budget_ > 0 &&
+                         !write_controller_.IsStopped() &&
+                         !write_controller_.NeedsDelay();
+  BGJobLimits res = GetBGJobLimits(
+      mutable_db_options_.max_background_flushes,
+      mutable_db_options_.max_background_compactions,
+      mutable_db_options_.max_background_jobs,
+      throttled || write_controller_.NeedSpeedupCompaction());
+  if (throttled) {
+    res.max_compactions = std::min(res.max_compactions, compaction_budget_);
+  }
+  return res;
 }
 
 DBImpl::BGJobLimits DBImpl::GetBGJobLimits(int max_background_flushes,
@@ -3582,8 +3726,11 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
           (m->end ? m->end->DebugString(true).c_str() : "(end)"));
     } else {
       // First check if we have enough room to do the compaction
-      bool enough_room = EnoughRoomForCompaction(
-          m->cfd, *(c->inputs()), &sfm_reserved_compact_space, log_buffer);
+      uint32_t output_path_id = c->output_path_id();
+      bool enough_room =
+          EnoughRoomForCompaction(m->cfd, *(c->inputs()), &output_path_id,
+                                  &sfm_reserved_compact_space, log_buffer);
+      c->set_output_path_id(output_path_id);
 
       if (!enough_room) {
         // Then don't do the compaction
@@ -3651,8 +3798,11 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
       TEST_SYNC_POINT("DBImpl::BackgroundCompaction():AfterPickCompaction");
 
       if (c != nullptr) {
-        bool enough_room = EnoughRoomForCompaction(
-            cfd, *(c->inputs()), &sfm_reserved_compact_space, log_buffer);
+        uint32_t output_path_id = c->output_path_id();
+        bool enough_room =
+            EnoughRoomForCompaction(cfd, *(c->inputs()), &output_path_id,
+                                    &sfm_reserved_compact_space, log_buffer);
+        c->set_output_path_id(output_path_id);
 
         if (!enough_room) {
           // Then don't do the compaction
@@ -3712,7 +3862,9 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
                              c->column_family_data());
     assert(c->num_input_files(1) == 0);
     assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+               kCompactionStyleFIFO ||
+           c->compaction_reason() ==
+               CompactionReason::kRangeDeletionCoveredFiles);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3722,6 +3874,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     for (const auto& f : *c->inputs(0)) {
       c->edit()->DeleteFile(c->level(), f->fd.GetNumber());
     }
+    c->edit()->MarkInvalidatesCachedRows();
     status = versions_->LogAndApply(
         c->column_family_data(), *c->mutable_cf_options(), read_options,
         c->edit(), &mutex_, directories_.GetDbDir(),
@@ -3743,6 +3896,142 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     *made_progress = true;
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
                              c->column_family_data());
+  } else if (c->IsTrivialCopy()) {
+    TEST_SYNC_POINT("DBImpl::BackgroundCompaction:TrivialCopy");
+    TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:BeforeCompaction",
+                             c->column_family_data());
+    ThreadStatusUtil::SetColumnFamily(c->column_family_data());
+    ThreadStatusUtil::SetThreadOperation(ThreadStatus::OP_COMPACTION);
+    auto cfd = c->column_family_data();
+
+    compaction_job_stats.num_input_files = c->num_input_files(0);
+
+    NotifyOnCompactionBegin(cfd, c.get(), status, compaction_job_stats,
+                            job_context->job_id);
+
+    // The input files are copied to new files of the output temperature,
+    // outside of the mutex, and swapped for them in a single edit. The new
+    // file numbers are protected by the pending outputs of the background
+    // job.
+    std::vector<uint64_t> copy_numbers;
+    for (size_t i = 0; i < c->num_input_files(0); i++) {
+      copy_numbers.push_back(versions_->NewFileNumber());
+    }
+    FileOptions copy_file_options = file_options_for_compaction_;
+    copy_file_options.temperature = c->output_temperature();
+    copy_file_options.rate_limiter = immutable_db_options_.rate_limiter.get();
+    const Env::IOPriority io_priority =
+        write_controller_.NeedsDelay() || write_controller_.IsStopped()
+            ? Env::IO_USER
+            : Env::IO_LOW;
+    auto sfm = static_cast<SstFileManagerImpl*>(
+        immutable_db_options_.sst_file_manager.get());
+    size_t num_copied = 0;
+    uint64_t copied_bytes = 0;
+    mutex_.Unlock();
+    for (; num_copied < c->num_input_files(0) && io_s.ok(); num_copied++) {
+      if (shutting_down_.load(std::memory_order_acquire)) {
+        status = Status::ShutdownInProgress();
+        break;
+      }
+      const FileMetaData* f = c->input(0, num_copied);
+      const std::string src = TableFileName(
+          cfd->ioptions()->cf_paths, f->fd.GetNumber(), f->fd.GetPathId());
+      const std::string dst =
+          TableFileName(cfd->ioptions()->cf_paths, copy_numbers[num_copied],
+                        f->fd.GetPathId());
+      std::unique_ptr<FSWritableFile> dst_file;
+      io_s = fs_->NewWritableFile(dst, copy_file_options, &dst_file, nullptr);
+      if (!io_s.ok()) {
+        break;
+      }
+      dst_file->SetIOPriority(io_priority);
+      std::unique_ptr<WritableFileWriter> dst_writer(new WritableFileWriter(
+          std::move(dst_file), dst, copy_file_options,
+          immutable_db_options_.clock, io_tracer_, stats_,
+          immutable_db_options_.listeners));
+      io_s = CopyFile(fs_.get(), src, f->temperature, dst_writer,
+                      f->fd.GetFileSize(), immutable_db_options_.use_fsync,
+                      io_tracer_, immutable_db_options_.rate_limiter.get(),
+                      io_priority);
+      if (io_s.ok()) {
+        io_s = dst_writer->Close();
+      }
+      if (io_s.ok() && sfm != nullptr) {
+        sfm->OnAddFile(dst).PermitUncheckedError();
+      }
+      copied_bytes += f->fd.GetFileSize();
+    }
+    if (io_s.ok() && status.ok()) {
+      io_s = GetDataDir(cfd, 0)->FsyncWithDirOptions(
+          IOOptions(), nullptr,
+          DirFsyncOptions(DirFsyncOptions::FsyncReason::kNewFileSynced));
+    }
+    if (!io_s.ok() || !status.ok()) {
+      // The copies are deleted, and the input files are left as they are
+      for (size_t i = 0; i < c->num_input_files(0); i++) {
+        const std::string dst =
+            TableFileName(cfd->ioptions()->cf_paths, copy_numbers[i],
+                          c->input(0, i)->fd.GetPathId());
+        fs_->DeleteFile(dst, IOOptions(), nullptr).PermitUncheckedError();
+      }
+    }
+    mutex_.Lock();
+
+    if (io_s.ok() && status.ok()) {
+      for (size_t i = 0; i < c->num_input_files(0); i++) {
+        const FileMetaData* f = c->input(0, i);
+        c->edit()->DeleteFile(c->level(), f->fd.GetNumber());
+        c->edit()->AddFile(
+            c->output_level(), copy_numbers[i], f->fd.GetPathId(),
+            f->fd.GetFileSize(), f->smallest, f->largest, f->fd.smallest_seqno,
+            f->fd.largest_seqno, f->marked_for_compaction,
+            c->output_temperature(), f->oldest_blob_file_number,
+            f->oldest_ancester_time, f->file_creation_time, f->epoch_number,
+            f->file_checksum, f->file_checksum_func_name, f->unique_id,
+            f->compensated_range_deletion_size, f->tail_size,
+            f->user_defined_timestamps_persisted);
+        // The copy doesn't know what the file had before it was compacted
+        if (f->largest_input_seqno != 0) {
+          c->edit()->MarkInvalidatesCachedRows();
+        }
+      }
+      status = versions_->LogAndApply(
+          cfd, *c->mutable_cf_options(), read_options, c->edit(), &mutex_,
+          directories_.GetDbDir(),
+          /*new_descriptor_log=*/false, /*column_family_options=*/nullptr,
+          [&c, &compaction_released](const Status& s) {
+            c->ReleaseCompactionFiles(s);
+            compaction_released = true;
+          });
+      io_s = versions_->io_status();
+      InstallSuperVersionAndScheduleWork(cfd,
+                                         &job_context->superversion_contexts[0],
+                                         *c->mutable_cf_options());
+    }
+    compaction_job_stats.num_output_files = num_copied;
+    compaction_job_stats.total_input_bytes = copied_bytes;
+    compaction_job_stats.total_output_bytes = copied_bytes;
+    {
+      event_logger_.LogToBuffer(log_buffer)
+          << "job" << job_context->job_id << "event"
+          << "trivial_copy"
+          << "output_temperature"
+          << temperature_to_string[c->output_temperature()] << "files"
+          << num_copied << "total_files_size" << copied_bytes;
+    }
+    ROCKS_LOG_BUFFER(log_buffer,
+                     "[%s] Copied #%" ROCKSDB_PRIszt
+                     " files to temperature %s %" PRIu64 " bytes: %s %s\n",
+                     cfd->GetName().c_str(), num_copied,
+                     temperature_to_string[c->output_temperature()].c_str(),
+                     copied_bytes, status.ToString().c_str(),
+                     io_s.ToString().c_str());
+    *made_progress = true;
+
+    ThreadStatusUtil::ResetThreadStatus();
+    TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
+                             c->column_family_data());
   } else if (!trivial_move_disallowed && c->IsTrivialMove()) {
     TEST_SYNC_POINT("DBImpl::BackgroundCompaction:TrivialMove");
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:BeforeCompaction",
@@ -3786,6 +4075,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
         moved_bytes += f->fd.GetFileSize();
       }
     }
+    compaction_job_stats.total_trivially_moved_bytes =
+        static_cast<uint64_t>(moved_bytes);
     if (c->compaction_reason() == CompactionReason::kLevelMaxLevelSize &&
         c->immutable_options()->compaction_pri == kRoundRobin) {
       int start_level = c->start_level();
@@ -4133,6 +4424,8 @@ void DBImpl::UpdateDeletionCompactionStats(
     case CompactionReason::kFIFOTtl:
       RecordTick(stats_, FIFO_TTL_COMPACTIONS);
       break;
+    case CompactionReason::kRangeDeletionCoveredFiles:
+      break;
     default:
       assert(false);
       break;
@@ -4240,6 +4533,11 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
   }
   cfd->InstallSuperVersion(sv_context, mutable_cf_options);
 
+  if (DropsFilesCoveredByRangeDeletions(cfd)) {
+    cfd->current()->storage_info()->ComputeFilesCoveredByRangeDeletions(
+        snapshots_.empty() ? GetLastPublishedSequence()
+                           : snapshots_.oldest()->number_);
+  }
   // There may be a small data race here. The snapshot tricking bottommost
   // compaction may already be released here. But assuming there will always be
   // newer snapshot created and released frequently, the compaction will be
@@ -4252,6 +4550,16 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
           my_cfd->current()->storage_info()->bottommost_files_mark_threshold());
     }
   }
+  files_covered_by_range_deletions_threshold_ = kMaxSequenceNumber;
+  for (auto* my_cfd : *versions_->GetColumnFamilySet()) {
+    if (DropsFilesCoveredByRangeDeletions(my_cfd)) {
+      files_covered_by_range_deletions_threshold_ =
+          std::min(files_covered_by_range_deletions_threshold_,
+                   my_cfd->current()
+                       ->storage_info()
+                       ->files_covered_by_range_deletions_threshold());
+    }
+  }
 
   // Whenever we install new SuperVersion, we might need to issue new flushes or
   // compactions.
@@ -4264,6 +4572,16 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
                                    mutable_cf_options.max_write_buffer_number;
 }
 
+bool DBImpl::DropsFilesCoveredByRangeDeletions(
+    const ColumnFamilyData* cfd) const {
+  // Without a snapshot checker, a sequence number no newer than the oldest
+  // snapshot is visible to all snapshots
+  return cfd->ioptions()->drop_files_covered_by_range_deletions &&
+         cfd->ioptions()->compaction_style == kCompactionStyleLevel &&
+         !cfd->ioptions()->allow_ingest_behind &&
+         snapshot_checker_ == nullptr && !cfd->IsDropped();
+}
+
 // ShouldPurge is called by FindObsoleteFiles when doing a full scan,
 // and db mutex (mutex_) should already be held.
 // Actually, the current implementation of FindObsoleteFiles with
@@ -194,6 +194,13 @@ Status DBImpl::TEST_WaitForPurge() {
   return error_handler_.GetBGError();
 }
 
+void DBImpl::TEST_WaitForBlockCacheWarmUp() {
+  InstrumentedMutexLock l(&mutex_);
+  while (bg_block_cache_warmup_scheduled_) {
+    bg_cv_.Wait();
+  }
+}
+
 Status DBImpl::TEST_GetBGError() {
   InstrumentedMutexLock l(&mutex_);
   return error_handler_.GetBGError();
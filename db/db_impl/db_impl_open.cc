@@ -7,6 +7,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
 
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
@@ -23,6 +27,7 @@
 #include "options/options_helper.h"
 #include "rocksdb/table.h"
 #include "rocksdb/wal_filter.h"
+#include "table/scoped_arena_iterator.h"
 #include "test_util/sync_point.h"
 #include "util/rate_limiter_impl.h"
 #include "util/string_util.h"
@@ -890,6 +895,11 @@ Status DBImpl::PersistentStatsProcessFormatVersion() {
         // should also persist version here because old stats CF is discarded
         should_persist_format_version = true;
       }
+    } else if (format_version_recovered < kStatsCFCurrentFormatVersion) {
+      // Snapshots of older format versions are still read, but the new ones
+      // are written in the current format, which older releases must not
+      // read as their own
+      should_persist_format_version = true;
     }
   }
   if (should_persist_format_version) {
@@ -1079,6 +1089,252 @@ bool DBImpl::InvokeWalFilterIfNeededOnWalRecord(uint64_t wal_number,
   return true;
 }
 
+namespace {
+// Reads and verifies the records of a WAL file on a background thread, so
+// that the recovery thread can decode and insert one record while the next
+// ones are read and checksummed.
+class WalRecordPrefetcher {
+ public:
+  // `read_status` is where the reporter of `reader` records corruptions. It
+  // is only written by the background thread.
+  WalRecordPrefetcher(log::Reader* reader, WALRecoveryMode recovery_mode,
+                      const Status* read_status)
+      : reader_(reader),
+        recovery_mode_(recovery_mode),
+        read_status_(read_status) {
+    thread_ = port::Thread([this]() { Run(); });
+  }
+
+  ~WalRecordPrefetcher() { Stop(); }
+
+  // Returns false once the reader has stopped and all the records it read
+  // have been consumed. `*record` is valid until the next call.
+  bool ReadRecord(Slice* record, uint64_t* record_checksum,
+                  const UnorderedMap<uint32_t, size_t>** record_ts_sz) {
+    std::unique_lock<std::mutex> lock(mu_);
+    consumer_cv_.wait(lock, [this]() { return !queue_.empty() || done_; });
+    if (queue_.empty()) {
+      return false;
+    }
+    current_ = std::move(queue_.front());
+    queue_.pop_front();
+    queued_bytes_ -= current_.data.size();
+    lock.unlock();
+    producer_cv_.notify_one();
+
+    *record = current_.data;
+    *record_checksum = current_.checksum;
+    *record_ts_sz = current_.ts_sz.get();
+    return true;
+  }
+
+  // Stops reading and waits for the background thread to exit. Records that
+  // were already read but not consumed are dropped.
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    producer_cv_.notify_one();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+ private:
+  // Upper bound of the record bytes read ahead of the recovery thread.
+  static constexpr size_t kMaxQueuedBytes = 16 << 20;
+
+  struct Record {
+    std::string data;
+    uint64_t checksum = 0;
+    std::shared_ptr<const UnorderedMap<uint32_t, size_t>> ts_sz;
+  };
+
+  void Run() {
+    std::string scratch;
+    Slice record;
+    uint64_t record_checksum = 0;
+    std::shared_ptr<const UnorderedMap<uint32_t, size_t>> ts_sz;
+    while (reader_->ReadRecord(&record, &scratch, recovery_mode_,
+                               &record_checksum) &&
+           read_status_->ok()) {
+      // The recorded timestamp sizes only ever grow, so a new snapshot is
+      // only needed when an entry was added.
+      const UnorderedMap<uint32_t, size_t>& recorded_ts_sz =
+          reader_->GetRecordedTimestampSize();
+      if (ts_sz == nullptr || ts_sz->size() != recorded_ts_sz.size()) {
+        ts_sz = std::make_shared<const UnorderedMap<uint32_t, size_t>>(
+            recorded_ts_sz);
+      }
+      std::unique_lock<std::mutex> lock(mu_);
+      producer_cv_.wait(lock, [this]() {
+        return stop_ || queued_bytes_ < kMaxQueuedBytes;
+      });
+      if (stop_) {
+        break;
+      }
+      queued_bytes_ += record.size();
+      queue_.push_back(Record{record.ToString(), record_checksum, ts_sz});
+      lock.unlock();
+      consumer_cv_.notify_one();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      done_ = true;
+    }
+    consumer_cv_.notify_one();
+  }
+
+  log::Reader* const reader_;
+  const WALRecoveryMode recovery_mode_;
+  const Status* const read_status_;
+
+  std::mutex mu_;
+  std::condition_variable producer_cv_;
+  std::condition_variable consumer_cv_;
+  std::deque<Record> queue_;
+  size_t queued_bytes_ = 0;
+  bool stop_ = false;
+  bool done_ = false;
+  // Owned by the consumer.
+  Record current_;
+  port::Thread thread_;
+};
+
+// A fixed set of helper threads that run tasks together with the calling
+// thread. Used to insert a group of recovered write batches into memtables
+// concurrently.
+class WalReplayThreads {
+ public:
+  explicit WalReplayThreads(int num_helpers) {
+    for (int i = 0; i < num_helpers; ++i) {
+      threads_.emplace_back([this]() { HelperLoop(); });
+    }
+  }
+
+  ~WalReplayThreads() {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      shutdown_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Calls `task(i)` for every i in [0, num_tasks) and returns once all the
+  // calls have finished.
+  void Run(size_t num_tasks, const std::function<void(size_t)>& task) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      task_ = &task;
+      num_tasks_ = num_tasks;
+      next_task_.store(0, std::memory_order_relaxed);
+      pending_helpers_ = threads_.size();
+      ++generation_;
+    }
+    work_cv_.notify_all();
+    RunTasks(task, num_tasks);
+    std::unique_lock<std::mutex> lock(mu_);
+    done_cv_.wait(lock, [this]() { return pending_helpers_ == 0; });
+    task_ = nullptr;
+  }
+
+ private:
+  void RunTasks(const std::function<void(size_t)>& task, size_t num_tasks) {
+    size_t i;
+    while ((i = next_task_.fetch_add(1, std::memory_order_relaxed)) <
+           num_tasks) {
+      task(i);
+    }
+  }
+
+  void HelperLoop() {
+    uint64_t seen_generation = 0;
+    while (true) {
+      const std::function<void(size_t)>* task;
+      size_t num_tasks;
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        work_cv_.wait(lock, [&]() {
+          return shutdown_ || generation_ != seen_generation;
+        });
+        if (shutdown_) {
+          return;
+        }
+        seen_generation = generation_;
+        task = task_;
+        num_tasks = num_tasks_;
+      }
+      RunTasks(*task, num_tasks);
+      std::lock_guard<std::mutex> lock(mu_);
+      if (--pending_helpers_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  std::vector<port::Thread> threads_;
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(size_t)>* task_ = nullptr;
+  size_t num_tasks_ = 0;
+  std::atomic<size_t> next_task_{0};
+  size_t pending_helpers_ = 0;
+  uint64_t generation_ = 0;
+  bool shutdown_ = false;
+};
+
+// Replaces the memtable of `cfd` with a copy of its entries with sequence
+// numbers smaller than `seq`, to undo the inserts of the batches that were
+// inserted concurrently with a failing one but come after it in the WAL.
+Status DropMemTableEntriesFrom(ColumnFamilyData* cfd, SequenceNumber seq) {
+  MemTable* mem = cfd->mem();
+  MemTable* new_mem = cfd->ConstructNewMemtable(
+      *cfd->GetLatestMutableCFOptions(), mem->GetEarliestSequenceNumber());
+  ReadOptions read_options;
+  read_options.total_order_seek = true;
+  Status s;
+  Arena arena;
+  {
+    ScopedArenaIterator iter(mem->NewIterator(read_options, &arena));
+    for (iter->SeekToFirst(); s.ok() && iter->Valid(); iter->Next()) {
+      ParsedInternalKey ikey;
+      s = ParseInternalKey(iter->key(), &ikey, /*log_err_key=*/false);
+      if (s.ok() && ikey.sequence < seq) {
+        s = new_mem->Add(ikey.sequence, ikey.type, ikey.user_key,
+                         iter->value(), /*kv_prot_info=*/nullptr);
+      }
+    }
+  }
+  std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
+      mem->NewRangeTombstoneIterator(read_options, seq - 1,
+                                     /*immutable_memtable=*/false));
+  if (range_del_iter != nullptr) {
+    for (range_del_iter->SeekToFirst(); s.ok() && range_del_iter->Valid();
+         range_del_iter->Next()) {
+      const RangeTombstone tombstone = range_del_iter->Tombstone();
+      if (tombstone.seq_ < seq) {
+        s = new_mem->Add(tombstone.seq_, kTypeRangeDeletion,
+                         tombstone.start_key_, tombstone.end_key_,
+                         /*kv_prot_info=*/nullptr);
+      }
+    }
+  }
+  if (!s.ok()) {
+    delete new_mem;
+    return s;
+  }
+  cfd->SetMemtable(new_mem);
+  new_mem->Ref();
+  delete mem->Unref();
+  return s;
+}
+}  // namespace
+
 // REQUIRES: wal_numbers are sorted in ascending order
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                                SequenceNumber* next_sequence, bool read_only,
@@ -1128,6 +1384,34 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
   bool stop_replay_for_corruption = false;
   bool flushed = false;
   uint64_t corrupted_wal_number = kMaxSequenceNumber;
+
+  // With more than one recovery thread, records are read ahead on their own
+  // thread. Beyond that, consecutive write batches are inserted into the
+  // memtables concurrently, provided the memtables support it. Batches that
+  // carry two-phase-commit markers rebuild recovered transactions under the
+  // DB mutex and are always inserted on this thread.
+  const int recovery_threads = immutable_db_options_.wal_recovery_threads;
+  const bool prefetch_records = recovery_threads > 1;
+  std::unique_ptr<WalReplayThreads> replay_threads;
+  if (recovery_threads > 2 &&
+      immutable_db_options_.allow_concurrent_memtable_write && !allow_2pc() &&
+      !seq_per_batch_) {
+    replay_threads.reset(new WalReplayThreads(recovery_threads - 2));
+  }
+  // Write batches waiting to be inserted by `replay_threads`.
+  struct PendingBatch {
+    WriteBatch batch;
+    size_t record_size;
+    SequenceNumber next_sequence;
+    bool has_valid_writes;
+    Status status;
+  };
+  static constexpr size_t kMaxPendingBatches = 64;
+  std::vector<PendingBatch> pending_batches;
+  pending_batches.reserve(replay_threads ? kMaxPendingBatches : 0);
+  const uint64_t replay_start_micros = immutable_db_options_.clock->NowMicros();
+  uint64_t replayed_records = 0;
+  size_t replayed_wals = 0;
   uint64_t min_wal_number = MinLogNumberToKeep();
   if (!allow_2pc()) {
     // In non-2pc mode, we skip WALs that do not back unflushed data.
@@ -1198,12 +1482,21 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     } else {
       reporter.status = &status;
     }
+    // When records are read ahead, the reader reports corruptions into its
+    // own status, which is merged into `status` once the reader has stopped.
+    Status read_status;
+    LogReporter read_reporter = reporter;
+    if (reporter.status != nullptr) {
+      read_reporter.status = &read_status;
+    }
     // We intentially make log::Reader do checksumming even if
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
     // large sequence numbers).
     log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+                       prefetch_records ? &read_reporter : &reporter,
+                       true /*checksum*/, wal_number);
+    ++replayed_wals;
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
@@ -1215,12 +1508,108 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
 
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
+    std::unique_ptr<WalRecordPrefetcher> prefetcher;
+    if (prefetch_records) {
+      prefetcher.reset(new WalRecordPrefetcher(
+          &reader, immutable_db_options_.wal_recovery_mode, &read_status));
+    }
     uint64_t record_checksum;
-    while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode,
-                             &record_checksum) &&
-           status.ok()) {
+    const UnorderedMap<uint32_t, size_t>* record_ts_sz = nullptr;
+    auto read_record = [&]() {
+      if (prefetcher) {
+        return prefetcher->ReadRecord(&record, &record_checksum,
+                                      &record_ts_sz);
+      }
+      record_ts_sz = &reader.GetRecordedTimestampSize();
+      return reader.ReadRecord(&record, &scratch,
+                               immutable_db_options_.wal_recovery_mode,
+                               &record_checksum);
+    };
+
+    // Flushes the memtables that the inserts so far have filled up.
+    auto flush_full_memtables = [&]() {
+      // we can do this because this is called before client has access to the
+      // DB and there is only a single thread operating on DB
+      ColumnFamilyData* cfd;
+      Status s;
+      while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
+        cfd->UnrefAndTryDelete();
+        // If this asserts, it means that InsertInto failed in
+        // filtering updates to already-flushed column families
+        assert(cfd->GetLogNumber() <= wal_number);
+        auto iter = version_edits.find(cfd->GetID());
+        assert(iter != version_edits.end());
+        VersionEdit* edit = &iter->second;
+        s = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
+        if (!s.ok()) {
+          // Reflect errors immediately so that conditions like full
+          // file-systems cause the DB::Open() to fail.
+          return s;
+        }
+        flushed = true;
+
+        cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                               *next_sequence - 1);
+      }
+      return s;
+    };
+
+    // Inserts `pending_batches` concurrently and then handles their results in
+    // WAL order, like the batches inserted one by one would have been. Returns
+    // a non-ok status only if a memtable flush failed, or undoing the inserts
+    // past a failed batch did.
+    auto insert_pending_batches = [&]() {
+      if (pending_batches.empty()) {
+        return Status::OK();
+      }
+      replay_threads->Run(pending_batches.size(), [&](size_t i) {
+        PendingBatch& pending = pending_batches[i];
+        ColumnFamilyMemTablesImpl column_family_memtables(
+            versions_->GetColumnFamilySet());
+        pending.status = WriteBatchInternal::InsertInto(
+            &pending.batch, &column_family_memtables, &flush_scheduler_,
+            &trim_history_scheduler_, true, wal_number, 0, this,
+            true /* concurrent_memtable_writes */, &pending.next_sequence,
+            &pending.has_valid_writes, seq_per_batch_, batch_per_txn_);
+      });
+      bool has_valid_writes = false;
+      bool stopped = false;
+      for (size_t i = 0; i < pending_batches.size(); i++) {
+        PendingBatch& pending = pending_batches[i];
+        *next_sequence = pending.next_sequence;
+        has_valid_writes |= pending.has_valid_writes;
+        MaybeIgnoreError(&pending.status);
+        if (!pending.status.ok()) {
+          reporter.Corruption(pending.record_size, pending.status);
+          if (!status.ok()) {
+            stopped = i + 1 < pending_batches.size();
+            break;
+          }
+        }
+      }
+      pending_batches.clear();
+      if (stopped) {
+        // The replay stops at the failed batch, so the batches after it must
+        // not stay in the memtables. The failed batch has inserted its
+        // entries before *next_sequence, like it would have on its own.
+        for (auto cfd : *versions_->GetColumnFamilySet()) {
+          if (cfd->IsDropped() || cfd->mem()->IsEmpty()) {
+            continue;
+          }
+          Status s = DropMemTableEntriesFrom(cfd, *next_sequence);
+          if (!s.ok()) {
+            return s;
+          }
+        }
+      }
+      if (has_valid_writes && !read_only) {
+        return flush_full_memtables();
+      }
+      return Status::OK();
+    };
+
+    while (!stop_replay_by_wal_filter && read_record() && status.ok()) {
+      ++replayed_records;
       if (record.size() < WriteBatchInternal::kHeader) {
         reporter.Corruption(record.size(),
                             Status::Corruption("log record too small"));
@@ -1236,10 +1625,8 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
         return status;
       }
 
-      const UnorderedMap<uint32_t, size_t>& record_ts_sz =
-          reader.GetRecordedTimestampSize();
       status = HandleWriteBatchTimestampSizeDifference(
-          &batch, running_ts_sz, record_ts_sz,
+          &batch, running_ts_sz, *record_ts_sz,
           TimestampSizeConsistencyMode::kReconcileInconsistency, &new_batch);
       if (!status.ok()) {
         return status;
@@ -1275,7 +1662,10 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
         // consecutive, we continue recovery despite corruption. This could
         // happen when we open and write to a corrupted DB, where sequence id
         // will start from the last sequence id we recovered.
-        if (sequence == *next_sequence) {
+        const SequenceNumber expected_sequence =
+            pending_batches.empty() ? *next_sequence
+                                    : pending_batches.back().next_sequence;
+        if (sequence == expected_sequence) {
           stop_replay_for_corruption = false;
         }
         if (stop_replay_for_corruption) {
@@ -1292,6 +1682,34 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
         continue;
       }
 
+      if (replay_threads) {
+        const bool has_2pc_markers =
+            batch_to_use->HasBeginPrepare() || batch_to_use->HasEndPrepare() ||
+            batch_to_use->HasCommit() || batch_to_use->HasRollback();
+        if (!has_2pc_markers) {
+          // The inserts fill in the actual next sequence, this one is only
+          // used for the point-in-time recovery check above.
+          pending_batches.push_back(PendingBatch{
+              std::move(*batch_to_use), record.size(),
+              sequence + WriteBatchInternal::Count(batch_to_use), false,
+              Status::OK()});
+          if (pending_batches.size() >= kMaxPendingBatches) {
+            Status s = insert_pending_batches();
+            if (!s.ok()) {
+              return s;
+            }
+          }
+          continue;
+        }
+        Status s = insert_pending_batches();
+        if (!s.ok()) {
+          return s;
+        }
+        if (!status.ok()) {
+          break;
+        }
+      }
+
       // If column family was not found, it might mean that the WAL write
       // batch references to the column family that was dropped after the
       // insert. We don't want to fail the whole write batch in that case --
@@ -1312,32 +1730,28 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
 
       if (has_valid_writes && !read_only) {
-        // we can do this because this is called before client has access to the
-        // DB and there is only a single thread operating on DB
-        ColumnFamilyData* cfd;
-
-        while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
-          cfd->UnrefAndTryDelete();
-          // If this asserts, it means that InsertInto failed in
-          // filtering updates to already-flushed column families
-          assert(cfd->GetLogNumber() <= wal_number);
-          auto iter = version_edits.find(cfd->GetID());
-          assert(iter != version_edits.end());
-          VersionEdit* edit = &iter->second;
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Reflect errors immediately so that conditions like full
-            // file-systems cause the DB::Open() to fail.
-            return status;
-          }
-          flushed = true;
-
-          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
-                                 *next_sequence - 1);
+        status = flush_full_memtables();
+        if (!status.ok()) {
+          return status;
         }
       }
     }
 
+    // The batches still pending were read before whatever ended the replay of
+    // this file, so they are inserted in any case.
+    if (replay_threads) {
+      Status s = insert_pending_batches();
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    if (prefetcher) {
+      prefetcher->Stop();
+      if (status.ok()) {
+        status = read_status;
+      }
+    }
+
     if (!status.ok()) {
       if (status.IsNotSupported()) {
         // We should not treat NotSupported as corruption. It is rather a clear
@@ -1391,6 +1805,13 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       versions_->SetLastSequence(last_sequence);
     }
   }
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Replayed %" PRIu64 " records from %" ROCKSDB_PRIszt
+                 " WAL files in %" PRIu64 " us with %d recovery threads",
+                 replayed_records, replayed_wals,
+                 immutable_db_options_.clock->NowMicros() -
+                     replay_start_micros,
+                 recovery_threads);
   // Compare the corrupted log number to all columnfamily's current log number.
   // Abort Open() if any column family's log number is greater than
   // the corrupted log number, which means CF contains data beyond the point of
@@ -1834,8 +2255,59 @@ Status DB::Open(const DBOptions& db_options, const std::string& dbname,
 
 // TODO: Implement the trimming in flush code path.
 // TODO: Perform trimming before inserting into memtable during recovery.
-// TODO: Pick files with max_timestamp > trim_ts by each file's timestamp meta
-// info, and handle only these files to reduce io.
+namespace {
+// Sets `*smallest` and `*largest` to the range of the user keys, timestamps
+// included, of the files of `cfd` that may have a timestamp newer than
+// `trim_ts` by their table properties. Sets `*found` to false if there are
+// none, in which case there is nothing to trim. Keys left in the memtables,
+// which recovery normally flushes, are trimmed over the whole key range.
+Status GetRangeToTrimHistory(DBImpl* db_impl, ColumnFamilyData* cfd,
+                             const std::string& trim_ts,
+                             std::string* smallest, std::string* largest,
+                             bool* found) {
+  const Comparator* ucmp = cfd->user_comparator();
+  *found = false;
+  Status s;
+  const ReadOptions read_options;
+  SuperVersion* sv = db_impl->GetAndRefSuperVersion(cfd);
+  if (!sv->mem->IsEmpty() || sv->imm->GetTotalNumEntries() > 0) {
+    db_impl->ReturnAndCleanupSuperVersion(cfd, sv);
+    smallest->clear();
+    largest->clear();
+    *found = true;
+    return s;
+  }
+  const VersionStorageInfo* vstorage = sv->current->storage_info();
+  for (int level = 0; level < vstorage->num_levels() && s.ok(); level++) {
+    for (FileMetaData* f : vstorage->LevelFiles(level)) {
+      std::shared_ptr<const TableProperties> tp;
+      s = sv->current->GetTableProperties(read_options, &tp, f);
+      if (!s.ok()) {
+        break;
+      }
+      const auto& props = tp->user_collected_properties;
+      auto max_ts = props.find("rocksdb.timestamp_max");
+      if (max_ts != props.end() &&
+          (max_ts->second.empty() ||
+           ucmp->CompareTimestamp(max_ts->second, trim_ts) <= 0)) {
+        continue;
+      }
+      const Slice file_smallest = f->smallest.user_key();
+      const Slice file_largest = f->largest.user_key();
+      if (!*found || ucmp->Compare(file_smallest, *smallest) < 0) {
+        smallest->assign(file_smallest.data(), file_smallest.size());
+      }
+      if (!*found || ucmp->Compare(file_largest, *largest) > 0) {
+        largest->assign(file_largest.data(), file_largest.size());
+      }
+      *found = true;
+    }
+  }
+  db_impl->ReturnAndCleanupSuperVersion(cfd, sv);
+  return s;
+}
+}  // namespace
+
 Status DB::OpenAndTrimHistory(
     const DBOptions& db_options, const std::string& dbname,
     const std::vector<ColumnFamilyDescriptor>& column_families,
@@ -1874,8 +2346,19 @@ Status DB::OpenAndTrimHistory(
     // Only compact column families with timestamp enabled
     if (cfd->user_comparator() != nullptr &&
         cfd->user_comparator()->timestamp_size() > 0) {
-      s = db_impl->CompactRangeInternal(options, handle, nullptr, nullptr,
-                                        trim_ts);
+      // Only the files with timestamps newer than trim_ts are compacted
+      std::string smallest, largest;
+      bool found = false;
+      s = GetRangeToTrimHistory(db_impl, cfd, trim_ts, &smallest, &largest,
+                                &found);
+      if (s.ok() && found) {
+        Slice begin(smallest);
+        Slice end(largest);
+        const bool whole_range = smallest.empty() && largest.empty();
+        s = db_impl->CompactRangeInternal(
+            options, handle, whole_range ? nullptr : &begin,
+            whole_range ? nullptr : &end, trim_ts);
+      }
       if (!s.ok()) {
         break;
       }
@@ -2312,6 +2795,9 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   if (s.ok()) {
     s = impl->RegisterRecordSeqnoTimeWorker(recovery_ctx.is_new_db_);
   }
+  if (s.ok()) {
+    s = impl->RegisterBlockCacheHotnessWorker();
+  }
   impl->options_mutex_.Unlock();
   if (!s.ok()) {
     for (auto* h : *handles) {
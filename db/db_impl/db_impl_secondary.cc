@@ -13,7 +13,9 @@
 #include "logging/logging.h"
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/configurable.h"
+#include "test_util/sync_point.h"
 #include "util/cast_util.h"
+#include "util/mutexlock.h"
 #include "util/write_batch_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -22,13 +24,66 @@ DBImplSecondary::DBImplSecondary(const DBOptions& db_options,
                                  const std::string& dbname,
                                  std::string secondary_path)
     : DBImpl(db_options, dbname, false, true, true),
-      secondary_path_(std::move(secondary_path)) {
+      secondary_path_(std::move(secondary_path)),
+      tailing_cv_(&tailing_mutex_) {
   ROCKS_LOG_INFO(immutable_db_options_.info_log,
                  "Opening the db in secondary mode");
   LogFlush(immutable_db_options_.info_log);
 }
 
-DBImplSecondary::~DBImplSecondary() {}
+DBImplSecondary::~DBImplSecondary() { StopTailingPrimary(); }
+
+Status DBImplSecondary::Close() {
+  StopTailingPrimary();
+  return DBImpl::Close();
+}
+
+void DBImplSecondary::StartTailingPrimary() {
+  if (immutable_db_options_.secondary_catch_up_interval_ms == 0) {
+    return;
+  }
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Catching up with the primary every %" PRIu64 " ms",
+                 immutable_db_options_.secondary_catch_up_interval_ms);
+  tailing_thread_ = port::Thread(&DBImplSecondary::TailPrimary, this);
+}
+
+void DBImplSecondary::StopTailingPrimary() {
+  {
+    MutexLock l(&tailing_mutex_);
+    tailing_stopped_ = true;
+    tailing_cv_.SignalAll();
+  }
+  if (tailing_thread_.joinable()) {
+    tailing_thread_.join();
+  }
+}
+
+void DBImplSecondary::TailPrimary() {
+  const uint64_t interval_micros =
+      immutable_db_options_.secondary_catch_up_interval_ms * 1000;
+  // port::CondVar::TimedWait() takes a deadline of the system clock
+  SystemClock* clock = SystemClock::Default().get();
+  MutexLock l(&tailing_mutex_);
+  while (!tailing_stopped_) {
+    const uint64_t deadline = clock->NowMicros() + interval_micros;
+    while (!tailing_stopped_ && clock->NowMicros() < deadline) {
+      tailing_cv_.TimedWait(deadline);
+    }
+    if (tailing_stopped_) {
+      break;
+    }
+    tailing_mutex_.Unlock();
+    Status s = TryCatchUpWithPrimary();
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to catch up with the primary: %s",
+                     s.ToString().c_str());
+    }
+    TEST_SYNC_POINT("DBImplSecondary::TailPrimary:AfterCatchUp");
+    tailing_mutex_.Lock();
+  }
+}
 
 Status DBImplSecondary::Recover(
     const std::vector<ColumnFamilyDescriptor>& column_families,
@@ -669,6 +724,7 @@ Status DBImplSecondary::CheckConsistency() {
 Status DBImplSecondary::TryCatchUpWithPrimary() {
   assert(versions_.get() != nullptr);
   assert(manifest_reader_.get() != nullptr);
+  MutexLock catch_up_lock(&catch_up_mutex_);
   Status s;
   // read the manifest and apply new changes to the secondary instance
   std::unordered_set<ColumnFamilyData*> cfds_changed;
@@ -827,6 +883,7 @@ Status DB::OpenAsSecondary(
       impl->NewThreadStatusCfInfo(
           static_cast_with_check<ColumnFamilyHandleImpl>(h)->cfd());
     }
+    impl->StartTailingPrimary();
   } else {
     for (auto h : *handles) {
       delete h;
@@ -911,7 +968,8 @@ Status DBImplSecondary::CompactWithoutInstallation(
       &log_buffer, output_dir.get(), stats_, &mutex_, &error_handler_,
       input.snapshots, table_cache_, &event_logger_, dbname_, io_tracer_,
       options.canceled ? *options.canceled : kManualCompactionCanceledFalse_,
-      input.db_id, db_session_id_, secondary_path_, input, result);
+      input.db_id, db_session_id_, secondary_path_, input, result,
+      options.on_progress);
 
   mutex_.Unlock();
   s = compaction_job.Run();
@@ -243,6 +243,9 @@ class DBImplSecondary : public DBImpl {
   // method can take long time due to all the I/O and CPU costs.
   Status TryCatchUpWithPrimary() override;
 
+  // Stops the tailing of the primary, if any, before closing the DB
+  Status Close() override;
+
   // Try to find log reader using log_number from log_readers_ map, initialize
   // if it doesn't exist
   Status MaybeInitLogReader(uint64_t log_number,
@@ -286,6 +289,14 @@ class DBImplSecondary : public DBImpl {
 
   using DBImpl::Recover;
 
+  // Starts tailing_thread_ if secondary_catch_up_interval_ms is non-zero
+  void StartTailingPrimary();
+  // Stops tailing_thread_ and waits for its current catch-up to finish
+  void StopTailingPrimary();
+  // Body of tailing_thread_, calling TryCatchUpWithPrimary() every
+  // secondary_catch_up_interval_ms until StopTailingPrimary()
+  void TailPrimary();
+
   Status FindAndRecoverLogFiles(
       std::unordered_set<ColumnFamilyData*>* cfds_changed,
       JobContext* job_context);
@@ -317,6 +328,13 @@ class DBImplSecondary : public DBImpl {
   std::unordered_map<ColumnFamilyData*, uint64_t> cfd_to_current_log_;
 
   const std::string secondary_path_;
+
+  // Serializes the catch-ups of the application and of tailing_thread_
+  port::Mutex catch_up_mutex_;
+  port::Mutex tailing_mutex_;
+  port::CondVar tailing_cv_;
+  bool tailing_stopped_ = false;
+  port::Thread tailing_thread_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -13,6 +13,7 @@
 #include "db/event_helpers.h"
 #include "logging/logging.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/perf_context_sampler.h"
 #include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
@@ -149,6 +150,7 @@ void DBImpl::SetRecoverableStatePreReleaseCallback(
 
 Status DBImpl::Write(const WriteOptions& write_options, WriteBatch* my_batch,
                      PostWriteCallback* callback) {
+  PerfContextSampler sampler(immutable_db_options_, dbname_, "Write");
   Status s;
   if (write_options.protection_bytes_per_key > 0) {
     s = WriteBatchInternal::UpdateProtectionInfo(
@@ -161,6 +163,7 @@ Status DBImpl::Write(const WriteOptions& write_options, WriteBatch* my_batch,
                   /*pre_release_callback=*/nullptr,
                   /*post_memtable_callback=*/nullptr, callback);
   }
+  sampler.Finish(s);
   return s;
 }
 
@@ -179,16 +182,11 @@ Status DBImpl::WriteWithCallback(const WriteOptions& write_options,
 }
 
 void DBImpl::MultiBatchWriteCommit(CommitRequest* request) {
+  PERF_TIMER_GUARD(write_commit_wait_nanos);
+  StopWatch sw(immutable_db_options_.clock, stats_,
+               MULTI_BATCH_WRITE_COMMIT_WAIT_MICROS);
   write_thread_.ExitWaitSequenceCommit(request, &versions_->last_sequence_);
-  size_t pending_cnt = pending_memtable_writes_.fetch_sub(1) - 1;
-  if (pending_cnt == 0) {
-    // switch_cv_ waits until pending_memtable_writes_ = 0. Locking its mutex
-    // before notify ensures that cv is in waiting state when it is notified
-    // thus not missing the update to pending_memtable_writes_ even though it
-    // is not modified under the mutex.
-    std::lock_guard<std::mutex> lck(switch_mutex_);
-    switch_cv_.notify_all();
-  }
+  FinishPendingMemtableWrite();
 }
 
 Status DBImpl::MultiBatchWrite(const WriteOptions& options,
@@ -255,6 +253,8 @@ Status DBImpl::MultiBatchWriteImpl(const WriteOptions& write_options,
                              log_ref, false /*disable_memtable*/,
                              /*pre_release_callback=*/nullptr,
                              /*post_memtable_callback=*/nullptr, post_callback);
+  writer.multi_batch.PrepareTasks(
+      immutable_db_options_.multi_batch_write_split_bytes);
   CommitRequest request(&writer);
   writer.request = &request;
   write_thread_.JoinBatchGroup(&writer);
@@ -298,7 +298,7 @@ Status DBImpl::MultiBatchWriteImpl(const WriteOptions& write_options,
               w->multi_batch.SetContext(
                   versions_->GetColumnFamilySet(), &flush_scheduler_,
                   &trim_history_scheduler_,
-                  write_options.ignore_missing_column_families, this);
+                  write_options.ignore_missing_column_families, this, stats_);
               w->request->commit_lsn = next_sequence + count - 1;
               write_thread_.EnterCommitQueue(w->request);
               next_sequence += count;
@@ -367,7 +367,7 @@ Status DBImpl::MultiBatchWriteImpl(const WriteOptions& write_options,
       writer.status = ApplyWALToManifest(read_options, &synced_wals);
     }
     if (writer.status.ok()) {
-      pending_memtable_writes_ += memtable_write_cnt;
+      AddPendingMemtableWrites(memtable_write_cnt);
     } else {
       // The `pending_wb_cnt` must be reset to avoid other writers helping
       // the front writer write its WBs after it failed to write the WAL.
@@ -389,8 +389,12 @@ Status DBImpl::MultiBatchWriteImpl(const WriteOptions& write_options,
     stats->AddDBStats(InternalStats::kIntStatsNumKeysWritten, total_count);
     RecordTick(stats_, NUMBER_KEYS_WRITTEN, total_count);
 
-    while (writer.ConsumeOne())
-      ;
+    {
+      StopWatch sw(immutable_db_options_.clock, stats_,
+                   MULTI_BATCH_WRITE_MEMTABLE_MICROS);
+      while (writer.ConsumeOne())
+        ;
+    }
     MultiBatchWriteCommit(writer.request);
 
     WriteStatusCheck(writer.status);
@@ -576,6 +580,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                         post_memtable_callback, post_callback);
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
 
+  MaybeCompressWALPayload(write_options, &w);
   write_thread_.JoinBatchGroup(&w);
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
     // we are a non-leader in a parallel group
@@ -942,6 +947,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
                         disable_memtable, /*_batch_cnt=*/0,
                         /*_pre_release_callback=*/nullptr,
                         /*_post_memtable_callback=*/nullptr, post_callback);
+  MaybeCompressWALPayload(write_options, &w);
   write_thread_.JoinBatchGroup(&w);
   TEST_SYNC_POINT("DBImplWrite::PipelinedWriteImpl:AfterJoinBatchGroup");
   if (w.state == WriteThread::STATE_GROUP_LEADER) {
@@ -1010,6 +1016,23 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     IOStatus io_s;
     io_s.PermitUncheckedError();  // Allow io_s to be uninitialized
 
+    // With enable_pipelined_wal_sync the fsync is left to the memtable writer
+    // stage, so the next WAL group can append while it is in flight. That is
+    // only possible if the WAL file can be synced concurrently with appends,
+    // and if every writer in the group goes through the memtable stage.
+    bool defer_wal_sync = false;
+    if (w.status.ok() && log_context.need_log_sync &&
+        immutable_db_options_.enable_pipelined_wal_sync && !manual_wal_flush_ &&
+        log_context.writer->file()->writable_file()->IsSyncThreadSafe()) {
+      defer_wal_sync = true;
+      for (auto* writer : wal_write_group) {
+        if (writer->disable_memtable) {
+          defer_wal_sync = false;
+          break;
+        }
+      }
+    }
+
     if (w.status.ok() && !write_options.disableWAL) {
       PERF_TIMER_GUARD(write_wal_time);
       stats->AddDBStats(InternalStats::kIntStatsWriteDoneBySelf, 1);
@@ -1022,11 +1045,15 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
       assert(log_context.log_file_number_size);
       LogFileNumberSize& log_file_number_size =
           *(log_context.log_file_number_size);
-      io_s =
-          WriteToWAL(wal_write_group, log_context.writer, log_used,
-                     log_context.need_log_sync, log_context.need_log_dir_sync,
-                     current_sequence, log_file_number_size);
+      io_s = WriteToWAL(wal_write_group, log_context.writer, log_used,
+                        log_context.need_log_sync && !defer_wal_sync,
+                        log_context.need_log_dir_sync && !defer_wal_sync,
+                        current_sequence, log_file_number_size);
       w.status = io_s;
+      if (io_s.ok() && total_count > 0) {
+        pipelined_wal_written_seq_.store(current_sequence + total_count - 1,
+                                         std::memory_order_release);
+      }
     }
 
     if (!io_s.ok()) {
@@ -1039,10 +1066,12 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     VersionEdit synced_wals;
     if (log_context.need_log_sync) {
       InstrumentedMutexLock l(&log_write_mutex_);
-      if (w.status.ok()) {
+      if (w.status.ok() && !defer_wal_sync) {
         MarkLogsSynced(logfile_number_, log_context.need_log_dir_sync,
                        &synced_wals);
       } else {
+        // Also releases the logs PreprocessWrite prepared for a sync that
+        // is now left to the memtable writer stage.
         MarkLogsNotSynced(logfile_number_);
       }
     }
@@ -1052,6 +1081,17 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
       const ReadOptions read_options;
       w.status = ApplyWALToManifest(read_options, &synced_wals);
     }
+    if (w.status.ok() && log_context.need_log_sync && !defer_wal_sync &&
+        total_count > 0) {
+      AdvancePipelinedWALSyncedSeq(current_sequence + total_count - 1);
+    }
+    TEST_SYNC_POINT_CALLBACK("DBImpl::PipelinedWriteImpl:AfterWALWrite",
+                             &defer_wal_sync);
+    // In pipelined mode this also waits for the memtable stage to take the
+    // group.
+    PERF_TIMER_GUARD(write_memtable_queue_wait_nanos);
+    StopWatch sw(immutable_db_options_.clock, stats_,
+                 PIPELINED_WRITE_MEMTABLE_WAIT_MICROS);
     write_thread_.ExitAsBatchGroupLeader(wal_write_group, w.status);
   }
 
@@ -1065,8 +1105,25 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     PERF_TIMER_GUARD(write_memtable_time);
     assert(w.ShouldWriteToMemtable());
     write_thread_.EnterAsMemTableWriter(&w, &memtable_write_group);
-    if (memtable_write_group.size > 1 &&
-        immutable_db_options_.allow_concurrent_memtable_write) {
+    if (immutable_db_options_.enable_pipelined_wal_sync) {
+      // The WAL group may have left its fsync to us. Nothing in the group
+      // becomes visible before the WAL is durable up to its last sync write.
+      SequenceNumber sync_up_to = 0;
+      for (auto* writer : memtable_write_group) {
+        if (writer->sync && !writer->disable_wal) {
+          const uint32_t count =
+              WriteBatchInternal::Count(writer->multi_batch.batches[0]);
+          sync_up_to = writer->sequence + count - 1;
+        }
+      }
+      if (sync_up_to > 0) {
+        memtable_write_group.status = SyncPipelinedWAL(sync_up_to);
+      }
+    }
+    if (!memtable_write_group.status.ok()) {
+      write_thread_.ExitAsMemTableWriter(&w, memtable_write_group);
+    } else if (memtable_write_group.size > 1 &&
+               immutable_db_options_.allow_concurrent_memtable_write) {
       write_thread_.LaunchParallelMemTableWriters(&memtable_write_group);
     } else {
       memtable_write_group.status = WriteBatchInternal::InsertInto(
@@ -1141,15 +1198,7 @@ Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
     }
   }
 
-  size_t pending_cnt = pending_memtable_writes_.fetch_sub(1) - 1;
-  if (pending_cnt == 0) {
-    // switch_cv_ waits until pending_memtable_writes_ = 0. Locking its mutex
-    // before notify ensures that cv is in waiting state when it is notified
-    // thus not missing the update to pending_memtable_writes_ even though it is
-    // not modified under the mutex.
-    std::lock_guard<std::mutex> lck(switch_mutex_);
-    switch_cv_.notify_all();
-  }
+  FinishPendingMemtableWrite();
   WriteStatusCheck(w.status);
 
   if (!w.FinalStatus().ok()) {
@@ -1357,7 +1406,7 @@ Status DBImpl::WriteImplWALOnly(
     assert(immutable_db_options_.unordered_write);
   }
   if (immutable_db_options_.unordered_write && status.ok()) {
-    pending_memtable_writes_ += memtable_write_cnt;
+    AddPendingMemtableWrites(memtable_write_cnt);
   }
   write_thread->ExitAsBatchGroupLeader(write_group, status);
   if (status.ok()) {
@@ -1439,9 +1488,12 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
 
   PERF_TIMER_GUARD(write_scheduling_flushes_compactions_time);
 
-  if (UNLIKELY(status.ok() && total_log_size_ > GetMaxTotalWalSize())) {
+  if (UNLIKELY(status.ok() &&
+               (total_log_size_ > GetMaxTotalWalSize() ||
+                too_many_alive_wal_files_.load(std::memory_order_relaxed)))) {
     assert(versions_);
     InstrumentedMutexLock l(&mutex_);
+    too_many_alive_wal_files_.store(false, std::memory_order_relaxed);
     const ColumnFamilySet* const column_families =
         versions_->GetColumnFamilySet();
     assert(column_families);
@@ -1541,7 +1593,8 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
 Status DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
                           WriteBatch* tmp_batch, WriteBatch** merged_batch,
                           size_t* write_with_wal,
-                          WriteBatch** to_be_cached_state) {
+                          WriteBatch** to_be_cached_state,
+                          std::vector<Slice>* parts) {
   assert(write_with_wal != nullptr);
   assert(tmp_batch != nullptr);
   assert(*to_be_cached_state == nullptr);
@@ -1560,17 +1613,27 @@ Status DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
     }
     *write_with_wal = 1;
   } else {
-    // WAL needs all of the batches flattened into a single batch.
-    // We could avoid copying here with an iov-like AddRecord
-    // interface
+    // WAL needs all of the batches flattened into a single batch. With
+    // `parts`, the log writer gathers them instead of copying them here.
     *merged_batch = tmp_batch;
+    if (parts != nullptr) {
+      parts->clear();
+      // The header, which is only complete once every batch is counted.
+      parts->emplace_back();
+    }
     for (auto writer : write_group) {
       if (!writer->CallbackFailed()) {
         for (auto b : writer->multi_batch.batches) {
-          Status s = WriteBatchInternal::Append(*merged_batch, b,
-                                                /*WAL_only*/ true);
+          Status s = parts != nullptr
+                         ? WriteBatchInternal::AppendReference(*merged_batch,
+                                                               b, parts)
+                         : WriteBatchInternal::Append(*merged_batch, b,
+                                                      /*WAL_only*/ true);
           if (!s.ok()) {
             tmp_batch->Clear();
+            if (parts != nullptr) {
+              parts->clear();
+            }
             return s;
           }
           if (WriteBatchInternal::IsLatestPersistentState(b)) {
@@ -1581,18 +1644,71 @@ Status DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
         }
       }
     }
+    if (parts != nullptr) {
+      (*parts)[0] = WriteBatchInternal::Contents(tmp_batch);
+      assert((*parts)[0].size() == WriteBatchInternal::kHeader);
+    }
   }
   // return merged_batch;
   return Status::OK();
 }
 
+void DBImpl::MaybeCompressWALPayload(const WriteOptions& write_options,
+                                     WriteThread::Writer* w) {
+  // The writes of two_write_queues_ are written by ConcurrentWriteToWAL(),
+  // which leaves compressing them to the log writer
+  if (immutable_db_options_.wal_compression == kNoCompression ||
+      write_options.disableWAL || two_write_queues_) {
+    return;
+  }
+  std::unique_ptr<log::RecordCompressor> compressor;
+  {
+    std::lock_guard<std::mutex> lock(wal_compressors_mutex_);
+    if (!wal_compressors_.empty()) {
+      compressor = std::move(wal_compressors_.back());
+      wal_compressors_.pop_back();
+    }
+  }
+  if (compressor == nullptr) {
+    compressor =
+        log::RecordCompressor::Create(immutable_db_options_.wal_compression);
+    if (compressor == nullptr) {
+      return;
+    }
+  }
+  IOStatus s;
+  for (WriteBatch* batch : w->multi_batch.batches) {
+    // The records MergeBatch() takes from the batch
+    const Slice contents = WriteBatchInternal::Contents(batch);
+    const SavePoint& wal_end = batch->GetWalTerminationPoint();
+    const size_t size = wal_end.is_cleared() ? contents.size() : wal_end.size;
+    assert(size >= WriteBatchInternal::kHeader);
+    s = compressor->Compress(
+        Slice(contents.data() + WriteBatchInternal::kHeader,
+              size - WriteBatchInternal::kHeader),
+        &w->compressed_wal_payload);
+    if (!s.ok()) {
+      break;
+    }
+  }
+  // Otherwise the leader compresses the batch with the others
+  w->wal_payload_compressed = s.ok();
+  if (!s.ok()) {
+    w->compressed_wal_payload.clear();
+  }
+  std::lock_guard<std::mutex> lock(wal_compressors_mutex_);
+  wal_compressors_.push_back(std::move(compressor));
+}
+
 // When two_write_queues_ is disabled, this function is called from the only
 // write thread. Otherwise this must be called holding log_write_mutex_.
 IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
                             log::Writer* log_writer, uint64_t* log_used,
                             uint64_t* log_size,
                             Env::IOPriority rate_limiter_priority,
-                            LogFileNumberSize& log_file_number_size) {
+                            LogFileNumberSize& log_file_number_size,
+                            const std::vector<Slice>& parts,
+                            const std::vector<Slice>& compressed_payload) {
   assert(log_size != nullptr);
 
   Slice log_entry = WriteBatchInternal::Contents(&merged_batch);
@@ -1601,7 +1717,14 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (!s.ok()) {
     return status_to_io_status(std::move(s));
   }
-  *log_size = log_entry.size();
+  if (parts.empty()) {
+    *log_size = log_entry.size();
+  } else {
+    *log_size = 0;
+    for (const Slice& part : parts) {
+      *log_size += part.size();
+    }
+  }
   // When two_write_queues_ WriteToWAL has to be protected from concurretn calls
   // from the two queues anyway and log_write_mutex_ is already held. Otherwise
   // if manual_wal_flush_ is enabled we need to protect log_writer->AddRecord
@@ -1619,7 +1742,19 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (!io_s.ok()) {
     return io_s;
   }
-  io_s = log_writer->AddRecord(log_entry, rate_limiter_priority);
+  if (!compressed_payload.empty()) {
+    io_s = log_writer->AddRecordWithCompressedPayload(
+        Slice(log_entry.data(), WriteBatchInternal::kHeader),
+        SliceParts(compressed_payload.data(),
+                   static_cast<int>(compressed_payload.size())),
+        rate_limiter_priority);
+  } else if (parts.empty()) {
+    io_s = log_writer->AddRecord(log_entry, rate_limiter_priority);
+  } else {
+    io_s = log_writer->AddRecord(
+        SliceParts(parts.data(), static_cast<int>(parts.size())),
+        rate_limiter_priority);
+  }
 
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Unlock();
@@ -1627,7 +1762,7 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (log_used != nullptr) {
     *log_used = logfile_number_;
   }
-  total_log_size_ += log_entry.size();
+  total_log_size_ += *log_size;
   log_file_number_size.AddSize(*log_size);
   log_empty_ = false;
   return io_s;
@@ -1645,9 +1780,14 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   size_t write_with_wal = 0;
   WriteBatch* to_be_cached_state = nullptr;
   StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE_WAL_TIME);
+  const uint64_t wal_write_start_micros =
+      write_thread_.adaptive_group_size()
+          ? immutable_db_options_.clock->NowMicros()
+          : 0;
   WriteBatch* merged_batch;
   io_s = status_to_io_status(MergeBatch(write_group, &tmp_batch_, &merged_batch,
-                                        &write_with_wal, &to_be_cached_state));
+                                        &write_with_wal, &to_be_cached_state,
+                                        &tmp_batch_parts_));
   if (UNLIKELY(!io_s.ok())) {
     return io_s;
   }
@@ -1662,10 +1802,30 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
 
   WriteBatchInternal::SetSequence(merged_batch, sequence);
 
+  // Unless a writer didn't compress its payload, only the header is left to
+  // compress
+  tmp_compressed_payload_.clear();
+  if (log_writer->compression_type() != kNoCompression &&
+      log_writer->compression_type() ==
+          immutable_db_options_.wal_compression) {
+    for (auto writer : write_group) {
+      if (writer->CallbackFailed()) {
+        continue;
+      }
+      if (!writer->wal_payload_compressed) {
+        tmp_compressed_payload_.clear();
+        break;
+      }
+      tmp_compressed_payload_.emplace_back(writer->compressed_wal_payload);
+    }
+  }
+
   uint64_t log_size;
   io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size,
                     write_group.leader->rate_limiter_priority,
-                    log_file_number_size);
+                    log_file_number_size, tmp_batch_parts_,
+                    tmp_compressed_payload_);
+  tmp_compressed_payload_.clear();
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
     cached_recoverable_state_empty_ = false;
@@ -1715,6 +1875,7 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
 
   if (merged_batch == &tmp_batch_) {
     tmp_batch_.Clear();
+    tmp_batch_parts_.clear();
   }
   if (io_s.ok()) {
     auto stats = default_cf_internal_stats_;
@@ -1726,10 +1887,44 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
     RecordTick(stats_, WAL_FILE_BYTES, log_size);
     stats->AddDBStats(InternalStats::kIntStatsWriteWithWal, write_with_wal);
     RecordTick(stats_, WRITE_WITH_WAL, write_with_wal);
+    if (write_thread_.adaptive_group_size()) {
+      uint64_t wal_write_micros =
+          immutable_db_options_.clock->NowMicros() - wal_write_start_micros;
+      TEST_SYNC_POINT_CALLBACK("DBImpl::WriteToWAL:WALWriteLatency",
+                               &wal_write_micros);
+      write_thread_.RecordWALWriteLatency(write_group, wal_write_micros);
+    }
   }
   return io_s;
 }
 
+Status DBImpl::SyncPipelinedWAL(SequenceNumber sequence) {
+  if (pipelined_wal_synced_seq_.load(std::memory_order_acquire) >= sequence) {
+    // A sync issued after this sequence was appended already covered it.
+    return Status::OK();
+  }
+  // Everything appended before the sync starts is covered by it, including
+  // groups the WAL leader appended after `sequence`.
+  const SequenceNumber written =
+      pipelined_wal_written_seq_.load(std::memory_order_acquire);
+  TEST_SYNC_POINT("DBImpl::SyncPipelinedWAL:BeforeSync");
+  Status s = SyncWAL();
+  if (s.ok()) {
+    AdvancePipelinedWALSyncedSeq(written);
+  }
+  return s;
+}
+
+void DBImpl::AdvancePipelinedWALSyncedSeq(SequenceNumber sequence) {
+  SequenceNumber synced =
+      pipelined_wal_synced_seq_.load(std::memory_order_relaxed);
+  while (synced < sequence &&
+         !pipelined_wal_synced_seq_.compare_exchange_weak(
+             synced, sequence, std::memory_order_release,
+             std::memory_order_relaxed)) {
+  }
+}
+
 IOStatus DBImpl::ConcurrentWriteToWAL(
     const WriteThread::WriteGroup& write_group, uint64_t* log_used,
     SequenceNumber* last_sequence, size_t seq_inc) {
@@ -1936,8 +2131,10 @@ Status DBImpl::SwitchWAL(WriteContext* write_context) {
   ROCKS_LOG_INFO(
       immutable_db_options_.info_log,
       "Flushing all column families with data in WAL number %" PRIu64
-      ". Total log size is %" PRIu64 " while max_total_wal_size is %" PRIu64,
-      oldest_alive_log, total_log_size_.load(), GetMaxTotalWalSize());
+      ". Total log size is %" PRIu64 " while max_total_wal_size is %" PRIu64
+      ". %" ROCKSDB_PRIszt " WAL files are alive",
+      oldest_alive_log, total_log_size_.load(), GetMaxTotalWalSize(),
+      alive_log_files_.size());
   // no need to refcount because drop is happening in write thread, so can't
   // happen while we're in the write thread
   autovector<ColumnFamilyData*> cfds;
@@ -2292,6 +2489,24 @@ void DBImpl::NotifyOnMemTableSealed(ColumnFamilyData* /*cfd*/,
   mutex_.Lock();
 }
 
+void DBImpl::MoveMemTableToFarMemory(MemTable* mem, WriteContext* context) {
+  mutex_.AssertHeld();
+  const int node = immutable_db_options_.immutable_memtable_numa_node;
+  if (node < 0) {
+    return;
+  }
+  // The memtable can be flushed and dropped from the immutable list while
+  // its pages are being moved without the mutex
+  mem->Ref();
+  mutex_.Unlock();
+  mem->MoveToNumaNode(node);
+  mutex_.Lock();
+  MemTable* to_free = mem->Unref();
+  if (to_free != nullptr) {
+    context->memtables_to_free_.push_back(to_free);
+  }
+}
+
 // REQUIRES: mutex_ is held
 // REQUIRES: this thread is currently at the front of the writer queue
 // REQUIRES: this thread is currently at the front of the 2nd writer queue if
@@ -2403,6 +2618,10 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
       log_dir_synced_ = false;
       logs_.emplace_back(logfile_number_, new_log);
       alive_log_files_.push_back(LogFileNumberSize(logfile_number_));
+      if (immutable_db_options_.max_alive_wal_files > 0 &&
+          alive_log_files_.size() > immutable_db_options_.max_alive_wal_files) {
+        too_many_alive_wal_files_.store(true, std::memory_order_relaxed);
+      }
     }
   }
 
@@ -2490,7 +2709,8 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
 
   cfd->mem()->SetNextLogNumber(logfile_number_);
   assert(new_mem != nullptr);
-  cfd->imm()->Add(cfd->mem(), &context->memtables_to_free_);
+  MemTable* sealed_mem = cfd->mem();
+  cfd->imm()->Add(sealed_mem, &context->memtables_to_free_);
   new_mem->Ref();
   cfd->SetMemtable(new_mem);
   InstallSuperVersionAndScheduleWork(cfd, &context->superversion_context,
@@ -2499,6 +2719,7 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
   // Notify client that memtable is sealed, now that we have successfully
   // installed a new memtable
   NotifyOnMemTableSealed(cfd, memtable_info);
+  MoveMemTableToFarMemory(sealed_mem, context);
   // It is possible that we got here without checking the value of i_os, but
   // that is okay.  If we did, it most likely means that s was already an error.
   // In any case, ignore any unchecked error for i_os here.
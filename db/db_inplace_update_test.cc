@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
+#include "util/coding.h"
+#include "utilities/merge_operators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -253,6 +255,65 @@ TEST_F(DBTestInPlaceUpdate, InPlaceUpdateAndSnapshot) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBTestInPlaceUpdate, InPlaceMergeOperands) {
+  do {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.inplace_update_support = true;
+    options.inplace_merge_operands = true;
+    options.merge_operator = MergeOperators::CreateUInt64AddOperator();
+    options.statistics = CreateDBStatistics();
+    options.env = env_;
+    options.write_buffer_size = 100000;
+    options.allow_concurrent_memtable_write = false;
+    Reopen(options);
+    CreateAndReopenWithCF({"pikachu"}, options);
+
+    std::string operand;
+    PutFixed64(&operand, 1);
+    ASSERT_OK(Put(1, "key", operand));
+    // The first operand follows a value, the later ones are folded into it
+    int numOperands = 10;
+    for (int i = 0; i < numOperands; i++) {
+      ASSERT_OK(Merge(1, "key", operand));
+    }
+    std::string expected;
+    PutFixed64(&expected, 1 + numOperands);
+    ASSERT_EQ(expected, Get(1, "key"));
+    ASSERT_EQ(numOperands - 1,
+              options.statistics->getTickerCount(NUMBER_KEYS_UPDATED));
+
+    // The value and 1 merge operand for that key.
+    validateNumberOfEntries(2, 1);
+  } while (ChangeCompactOptions());
+}
+
+TEST_F(DBTestInPlaceUpdate, InPlaceMergeOperandsLargerResult) {
+  do {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.inplace_update_support = true;
+    options.inplace_merge_operands = true;
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    options.env = env_;
+    options.write_buffer_size = 100000;
+    options.allow_concurrent_memtable_write = false;
+    Reopen(options);
+    CreateAndReopenWithCF({"pikachu"}, options);
+
+    // Appending grows the operands, so none of them is folded
+    int numOperands = 10;
+    std::string expected;
+    for (int i = 0; i < numOperands; i++) {
+      ASSERT_OK(Merge(1, "key", "a"));
+      expected += expected.empty() ? "a" : ",a";
+    }
+    ASSERT_EQ(expected, Get(1, "key"));
+
+    validateNumberOfEntries(numOperands, 1);
+  } while (ChangeCompactOptions());
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
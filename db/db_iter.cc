@@ -9,10 +9,12 @@
 
 #include "db/db_iter.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <string>
 
+#include "db/blob/blob_index.h"
 #include "db/dbformat.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
@@ -30,6 +32,7 @@
 #include "rocksdb/system_clock.h"
 #include "table/internal_iterator.h"
 #include "table/iterator_wrapper.h"
+#include "test_util/sync_point.h"
 #include "trace_replay/trace_replay.h"
 #include "util/mutexlock.h"
 #include "util/string_util.h"
@@ -57,6 +60,12 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
       sequence_(s),
       statistics_(ioptions.stats),
       max_skip_(max_sequential_skip_in_iterations),
+      skip_costs_(cfd != nullptr &&
+                          mutable_cf_options
+                              .adapt_max_sequential_skip_in_iterations
+                      ? cfd->iter_skip_costs()
+                      : nullptr),
+      max_adapted_skip_(std::max(uint64_t{1}, max_skip_ * 16)),
       max_skippable_internal_keys_(read_options.max_skippable_internal_keys),
       num_internal_keys_skipped_(0),
       iterate_lower_bound_(read_options.iterate_lower_bound),
@@ -79,10 +88,19 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
       is_blob_(false),
       arena_mode_(arena_mode),
       io_activity_(read_options.io_activity),
+      blob_prefetch_buffers_(read_options.blob_readahead_size > 0
+                                 ? new PrefetchBufferCollection(
+                                       read_options.blob_readahead_size)
+                                 : nullptr),
+      blob_batch_(read_options.blob_batch_size > 1 && !expose_blob_index &&
+                          read_options.read_tier != kBlockCacheTier
+                      ? new BlobBatch()
+                      : nullptr),
       db_impl_(db_impl),
       cfd_(cfd),
       timestamp_ub_(read_options.timestamp),
       timestamp_lb_(read_options.iter_start_ts),
+      wide_column_projection_(read_options.wide_column_projection),
       timestamp_size_(timestamp_ub_ ? timestamp_ub_->size() : 0) {
   RecordTick(statistics_, NO_ITERATOR_CREATED);
   if (pin_thru_lifetime_) {
@@ -94,6 +112,13 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
   status_.PermitUncheckedError();
   assert(timestamp_size_ ==
          user_comparator_.user_comparator()->timestamp_size());
+  if (skip_costs_ != nullptr) {
+    AdaptMaxSkip(/*skip_nanos=*/0, /*reseek_nanos=*/0);
+  }
+  if (blob_batch_ != nullptr) {
+    blob_batch_->max_size =
+        std::min(read_options.blob_batch_size, BlobBatch::kMaxSize);
+  }
 }
 
 Status DBIter::GetProperty(std::string prop_name, std::string* prop) {
@@ -105,7 +130,7 @@ Status DBIter::GetProperty(std::string prop_name, std::string* prop) {
     return iter_.iter()->GetProperty(prop_name, prop);
   } else if (prop_name == "rocksdb.iterator.is-key-pinned") {
     if (valid_) {
-      *prop = (pin_thru_lifetime_ && saved_key_.IsKeyPinned()) ? "1" : "0";
+      *prop = IsKeyPinned() ? "1" : "0";
     } else {
       *prop = "Iterator is not valid.";
     }
@@ -120,6 +145,16 @@ Status DBIter::GetProperty(std::string prop_name, std::string* prop) {
   return Status::InvalidArgument("Unidentified property.");
 }
 
+bool DBIter::IsValuePinned() const {
+  assert(valid_);
+  if (!pin_thru_lifetime_ || is_blob_ || current_entry_is_merged_) {
+    return false;
+  }
+  // Moving forward, iter_ is at the entry of the value. Moving backward, the
+  // value was only taken from an entry if it was pinned.
+  return direction_ == kReverse || iter_.iter()->IsValuePinned();
+}
+
 bool DBIter::ParseKey(ParsedInternalKey* ikey) {
   Status s = ParseInternalKey(iter_.key(), ikey, false /* log_err_key */);
   if (!s.ok()) {
@@ -184,7 +219,7 @@ void DBIter::Next() {
 }
 
 bool DBIter::SetBlobValueIfNeeded(const Slice& user_key,
-                                  const Slice& blob_index) {
+                                  const Slice& blob_index, bool read_ahead) {
   assert(!is_blob_);
   assert(blob_value_.empty());
 
@@ -206,11 +241,49 @@ bool DBIter::SetBlobValueIfNeeded(const Slice& user_key,
   read_options.fill_cache = fill_cache_;
   read_options.verify_checksums = verify_checksums_;
   read_options.io_activity = io_activity_;
-  constexpr FilePrefetchBuffer* prefetch_buffer = nullptr;
   constexpr uint64_t* bytes_read = nullptr;
 
-  const Status s = version_->GetBlob(read_options, user_key, blob_index,
-                                     prefetch_buffer, &blob_value_, bytes_read);
+  Status s;
+  if (blob_batch_ && direction_ == kForward) {
+    BlobIndex decoded_blob_index;
+    s = decoded_blob_index.DecodeFrom(blob_index);
+    bool taken = false;
+    if (s.ok() && !decoded_blob_index.IsInlined() &&
+        !decoded_blob_index.HasTTL() &&
+        !TakeBlobFromBatch(decoded_blob_index, &taken) && read_ahead) {
+      s = ReadBlobBatch(read_options, user_key, decoded_blob_index);
+      if (s.ok()) {
+        TakeBlobFromBatch(decoded_blob_index, &taken);
+      }
+    }
+    if (!s.ok()) {
+      status_ = s;
+      valid_ = false;
+      return false;
+    }
+    if (taken) {
+      is_blob_ = true;
+      return true;
+    }
+  }
+
+  if (blob_prefetch_buffers_ && direction_ == kForward) {
+    BlobIndex decoded_blob_index;
+    s = decoded_blob_index.DecodeFrom(blob_index);
+    if (s.ok()) {
+      FilePrefetchBuffer* const prefetch_buffer =
+          decoded_blob_index.IsInlined()
+              ? nullptr
+              : blob_prefetch_buffers_->GetOrCreatePrefetchBuffer(
+                    decoded_blob_index.file_number());
+      s = version_->GetBlob(read_options, user_key, decoded_blob_index,
+                            prefetch_buffer, &blob_value_, bytes_read);
+    }
+  } else {
+    constexpr FilePrefetchBuffer* prefetch_buffer = nullptr;
+    s = version_->GetBlob(read_options, user_key, blob_index, prefetch_buffer,
+                          &blob_value_, bytes_read);
+  }
 
   if (!s.ok()) {
     status_ = s;
@@ -222,11 +295,122 @@ bool DBIter::SetBlobValueIfNeeded(const Slice& user_key,
   return true;
 }
 
+bool DBIter::TakeBlobFromBatch(const BlobIndex& blob_index, bool* taken) {
+  assert(blob_batch_);
+  assert(taken);
+  BlobBatch& batch = *blob_batch_;
+  for (size_t i = batch.next; i < batch.size; ++i) {
+    const BlobIndex& batched = batch.blob_indexes[i];
+    if (batched.file_number() == blob_index.file_number() &&
+        batched.offset() == blob_index.offset()) {
+      batch.next = i + 1;
+      // Otherwise read again on its own, so that the error is reported
+      *taken = batch.statuses[i].ok();
+      if (*taken) {
+        blob_value_ = std::move(batch.values[i]);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+Status DBIter::ReadBlobBatch(const ReadOptions& read_options,
+                             const Slice& user_key,
+                             const BlobIndex& blob_index) {
+  assert(blob_batch_);
+  assert(iter_.Valid());
+  BlobBatch& batch = *blob_batch_;
+  for (size_t i = 0; i < batch.size; ++i) {
+    batch.values[i].Reset();
+  }
+  batch.next = 0;
+  batch.user_keys[0].assign(user_key.data(), user_key.size());
+  batch.blob_indexes[0] = blob_index;
+  batch.size = 1;
+
+  // Looks at the newest visible entry of each following user key. As the
+  // entries are all scanned again, it stops after a few per blob so that long
+  // runs of hidden entries cost little.
+  const std::string entry = iter_.key().ToString();
+  std::string last_user_key = batch.user_keys[0];
+  const size_t max_entries = 4 * batch.max_size;
+  size_t num_entries = 0;
+  for (iter_.Next(); iter_.Valid() && batch.size < batch.max_size &&
+                     num_entries < max_entries;
+       iter_.Next(), ++num_entries) {
+    ParsedInternalKey ikey;
+    if (!ParseInternalKey(iter_.key(), &ikey, false /* log_err_key */).ok()) {
+      break;
+    }
+    const Slice user_key_without_ts =
+        StripTimestampFromUserKey(ikey.user_key, timestamp_size_);
+    if (iterate_upper_bound_ != nullptr &&
+        user_comparator_.CompareWithoutTimestamp(
+            user_key_without_ts, /*a_has_ts=*/false, *iterate_upper_bound_,
+            /*b_has_ts=*/false) >= 0) {
+      break;
+    }
+    if (prefix_same_as_start_ &&
+        prefix_extractor_->Transform(user_key_without_ts)
+                .compare(prefix_.GetUserKey()) != 0) {
+      break;
+    }
+    const Slice ts = timestamp_size_ > 0 ? ExtractTimestampFromUserKey(
+                                               ikey.user_key, timestamp_size_)
+                                         : Slice();
+    if (!IsVisible(ikey.sequence, ts, /*more_recent=*/nullptr) ||
+        CompareKeyForSkip(ikey.user_key, last_user_key) == 0) {
+      continue;
+    }
+    last_user_key.assign(ikey.user_key.data(), ikey.user_key.size());
+    if (ikey.type != kTypeBlobIndex) {
+      continue;
+    }
+    if (!iter_.PrepareValue()) {
+      break;
+    }
+    BlobIndex next_blob_index;
+    if (!next_blob_index.DecodeFrom(iter_.value()).ok() ||
+        next_blob_index.IsInlined() || next_blob_index.HasTTL()) {
+      continue;
+    }
+    batch.user_keys[batch.size].assign(ikey.user_key.data(),
+                                       ikey.user_key.size());
+    batch.blob_indexes[batch.size] = next_blob_index;
+    batch.size++;
+  }
+
+  iter_.Seek(entry);
+  if (!iter_.Valid() || iter_.key() != Slice(entry)) {
+    batch.size = 0;
+    return iter_.status().ok()
+               ? Status::Corruption("Could not return to the entry in DBIter")
+               : iter_.status();
+  }
+
+  std::array<Slice, BlobBatch::kMaxSize> user_keys;
+  for (size_t i = 0; i < batch.size; ++i) {
+    user_keys[i] = batch.user_keys[i];
+  }
+  version_->MultiGetBlob(read_options, batch.size, user_keys.data(),
+                         batch.blob_indexes.data(), batch.values.data(),
+                         batch.statuses.data());
+  for (size_t i = 0; i < batch.size; ++i) {
+    batch.statuses[i].PermitUncheckedError();
+  }
+  return Status::OK();
+}
+
 bool DBIter::SetValueAndColumnsFromEntity(Slice slice) {
   assert(value_.empty());
   assert(wide_columns_.empty());
 
-  const Status s = WideColumnSerialization::Deserialize(slice, wide_columns_);
+  const Status s =
+      wide_column_projection_
+          ? WideColumnSerialization::DeserializeProjection(
+                slice, *wide_column_projection_, wide_columns_)
+          : WideColumnSerialization::Deserialize(slice, wide_columns_);
 
   if (!s.ok()) {
     status_ = s;
@@ -306,6 +490,9 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
   //  - none of the above     : saved_key_ can contain anything, it doesn't
   //                            matter.
   uint64_t num_skipped = 0;
+  // When the second half of the current run of skipped entries started, with
+  // adapt_max_sequential_skip_in_iterations
+  uint64_t skip_run_start_nanos = 0;
   // For write unprepared, the target sequence number in reseek could be larger
   // than the snapshot, and thus needs to be skipped again. This could result in
   // an infinite loop of reseeks. To avoid that, we limit the number of reseeks
@@ -408,7 +595,8 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
 
             if (ikey_.type == kTypeBlobIndex ||
                 ikey_.type == kTypeTitanBlobIndex) {
-              if (!SetBlobValueIfNeeded(ikey_.user_key, iter_.value())) {
+              if (!SetBlobValueIfNeeded(ikey_.user_key, iter_.value(),
+                                        /*read_ahead=*/true)) {
                 return false;
               }
 
@@ -468,6 +656,12 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
       }
     }
 
+    // Time the second half of runs long enough to end in a reseek
+    if (skip_costs_ != nullptr && num_skipped > 0 &&
+        num_skipped == (max_skip_ + 1) / 2) {
+      skip_run_start_nanos = clock_->NowNanos();
+    }
+
     // If we have sequentially iterated via numerous equal keys, then it's
     // better to seek so that we can avoid too many key comparisons.
     //
@@ -478,6 +672,13 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
     // then it does not make sense to reseek as we would actually land further
     // away from the desired key. There is opportunity for optimization here.
     if (num_skipped > max_skip_ && !reseek_done) {
+      uint64_t reseek_start_nanos = 0;
+      uint64_t skip_nanos = 0;
+      if (skip_costs_ != nullptr && num_skipped > (max_skip_ + 1) / 2) {
+        reseek_start_nanos = clock_->NowNanos();
+        skip_nanos = (reseek_start_nanos - skip_run_start_nanos) /
+                     (num_skipped - (max_skip_ + 1) / 2);
+      }
       is_key_seqnum_zero_ = false;
       num_skipped = 0;
       reseek_done = true;
@@ -519,6 +720,9 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
       }
       iter_.Seek(last_key);
       RecordTick(statistics_, NUMBER_OF_RESEEKS_IN_ITERATION);
+      if (reseek_start_nanos != 0) {
+        AdaptMaxSkip(skip_nanos, clock_->NowNanos() - reseek_start_nanos);
+      }
     } else {
       iter_.Next();
     }
@@ -528,6 +732,30 @@ bool DBIter::FindNextUserEntryInternal(bool skipping_saved_key,
   return iter_.status().ok();
 }
 
+void DBIter::AdaptMaxSkip(uint64_t skip_nanos, uint64_t reseek_nanos) {
+  assert(skip_costs_ != nullptr);
+  // Moving averages giving each new measurement a weight of 1/8
+  auto update = [](RelaxedAtomic<uint64_t>& average, uint64_t sample) {
+    uint64_t old_average = average.LoadRelaxed();
+    uint64_t new_average =
+        old_average == 0 ? sample : old_average - old_average / 8 + sample / 8;
+    average.StoreRelaxed(new_average);
+    return new_average;
+  };
+  if (skip_nanos > 0 && reseek_nanos > 0) {
+    skip_nanos = update(skip_costs_->skip_nanos, skip_nanos);
+    reseek_nanos = update(skip_costs_->reseek_nanos, reseek_nanos);
+  } else {
+    skip_nanos = skip_costs_->skip_nanos.LoadRelaxed();
+    reseek_nanos = skip_costs_->reseek_nanos.LoadRelaxed();
+  }
+  if (skip_nanos > 0 && reseek_nanos > 0) {
+    max_skip_ = std::min(std::max(reseek_nanos / skip_nanos, uint64_t{1}),
+                         max_adapted_skip_);
+    TEST_SYNC_POINT_CALLBACK("DBIter::AdaptMaxSkip", &max_skip_);
+  }
+}
+
 // Merge values of the same user key starting from the current iter_ position
 // Scan from the newer entries to older entries.
 // PRE: iter_.key() points to the first merge type entry
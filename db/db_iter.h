@@ -8,9 +8,12 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <array>
 #include <cstdint>
 #include <string>
 
+#include "db/blob/blob_index.h"
+#include "db/blob/prefetch_buffer_collection.h"
 #include "db/db_impl/db_impl.h"
 #include "db/range_del_aggregator.h"
 #include "memory/arena.h"
@@ -19,6 +22,7 @@
 #include "rocksdb/iterator.h"
 #include "rocksdb/wide_columns.h"
 #include "table/iterator_wrapper.h"
+#include "table/multiget_context.h"
 #include "util/autovector.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -192,6 +196,16 @@ class DBIter final : public Iterator {
     assert(valid_);
     return is_blob_;
   }
+  // Whether key() stays valid as long as the iterator is not deleted
+  bool IsKeyPinned() const {
+    assert(valid_);
+    return pin_thru_lifetime_ && saved_key_.IsKeyPinned();
+  }
+  // Whether value() and columns() stay valid as long as the iterator is not
+  // deleted, which is the case with ReadOptions::pin_data for the values of
+  // the entries in the memtables and table files, but not for blobs nor the
+  // results of merges
+  bool IsValuePinned() const;
 
   Status GetProperty(std::string prop_name, std::string* prop) override;
 
@@ -238,6 +252,10 @@ class DBIter final : public Iterator {
   bool FindNextUserEntry(bool skipping_saved_key, const Slice* prefix);
   // Internal implementation of FindNextUserEntry().
   bool FindNextUserEntryInternal(bool skipping_saved_key, const Slice* prefix);
+  // Records the costs measured around a reseek of FindNextUserEntryInternal()
+  // and sets max_skip_ from their averages, see
+  // adapt_max_sequential_skip_in_iterations
+  void AdaptMaxSkip(uint64_t skip_nanos, uint64_t reseek_nanos);
   bool ParseKey(ParsedInternalKey* key);
   bool MergeValuesNewToOld();
 
@@ -295,8 +313,20 @@ class DBIter final : public Iterator {
   }
 
   // Retrieves the blob value for the specified user key using the given blob
-  // index when using the integrated BlobDB implementation.
-  bool SetBlobValueIfNeeded(const Slice& user_key, const Slice& blob_index);
+  // index when using the integrated BlobDB implementation. With `read_ahead`,
+  // iter_ is at the entry, and the blobs of the following keys may be read
+  // along with it, see ReadOptions::blob_batch_size.
+  bool SetBlobValueIfNeeded(const Slice& user_key, const Slice& blob_index,
+                            bool read_ahead = false);
+
+  // Returns whether the blob of `blob_index` was read ahead, setting *taken
+  // if it could be read, and moving it into blob_value_
+  bool TakeBlobFromBatch(const BlobIndex& blob_index, bool* taken);
+
+  // Reads the blob of the current entry of iter_ together with the blobs of
+  // the following keys into blob_batch_, then returns iter_ to the entry
+  Status ReadBlobBatch(const ReadOptions& read_options, const Slice& user_key,
+                       const BlobIndex& blob_index);
 
   void ResetBlobValue() {
     is_blob_ = false;
@@ -372,6 +402,9 @@ class DBIter final : public Iterator {
   WideColumns wide_columns_;
   Statistics* statistics_;
   uint64_t max_skip_;
+  // Where to average the costs adapting max_skip_, nullptr if it is fixed
+  ColumnFamilyData::IterSkipCosts* skip_costs_;
+  const uint64_t max_adapted_skip_;
   uint64_t max_skippable_internal_keys_;
   uint64_t num_internal_keys_skipped_;
   const Slice* iterate_lower_bound_;
@@ -408,6 +441,30 @@ class DBIter final : public Iterator {
   bool is_blob_;
   bool arena_mode_;
   const Env::IOActivity io_activity_;
+  // Readahead for blob files in forward iteration, see
+  // ReadOptions::blob_readahead_size. nullptr if disabled.
+  std::unique_ptr<PrefetchBufferCollection> blob_prefetch_buffers_;
+  // Blobs read together ahead of the iterator, see
+  // ReadOptions::blob_batch_size. nullptr if disabled.
+  struct BlobBatch {
+    static constexpr size_t kMaxSize = MultiGetContext::MAX_BATCH_SIZE;
+
+    BlobBatch() {
+      for (auto& status : statuses) {
+        status.PermitUncheckedError();
+      }
+    }
+
+    size_t max_size = 0;
+    size_t size = 0;
+    // The first blob not yet taken by the iterator
+    size_t next = 0;
+    std::array<std::string, kMaxSize> user_keys;
+    std::array<BlobIndex, kMaxSize> blob_indexes;
+    std::array<PinnableSlice, kMaxSize> values;
+    std::array<Status, kMaxSize> statuses;
+  };
+  std::unique_ptr<BlobBatch> blob_batch_;
   // List of operands for merge operator.
   MergeContext merge_context_;
   LocalStatistics local_stats_;
@@ -416,6 +473,7 @@ class DBIter final : public Iterator {
   ColumnFamilyData* cfd_;
   const Slice* const timestamp_ub_;
   const Slice* const timestamp_lb_;
+  const std::vector<Slice>* const wide_column_projection_;
   const size_t timestamp_size_;
   std::string saved_timestamp_;
 };
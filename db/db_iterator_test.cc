@@ -679,6 +679,55 @@ TEST_P(DBIteratorTest, IterReseek) {
   delete iter;
 }
 
+TEST_P(DBIteratorTest, AdaptMaxSequentialSkip) {
+  Options options = CurrentOptions();
+  options.max_sequential_skip_in_iterations = 4;
+  options.adapt_max_sequential_skip_in_iterations = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  // A long run of hidden versions of "a" behind its tombstone
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put("a", "v" + std::to_string(i)));
+  }
+  ASSERT_OK(Delete("a"));
+  ASSERT_OK(Put("b", "vb"));
+
+  std::vector<uint64_t> max_skips;
+  SyncPoint::GetInstance()->SetCallBack("DBIter::AdaptMaxSkip", [&](void* arg) {
+    max_skips.push_back(*static_cast<uint64_t*>(arg));
+  });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 3; ++i) {
+    std::unique_ptr<Iterator> iter(NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    ASSERT_EQ(IterStatus(iter.get()), "b->vb");
+    iter->Next();
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(TestGetTickerCount(options, NUMBER_OF_RESEEKS_IN_ITERATION), 3);
+  // Measured on each reseek, and later iterators start from the averages
+  ASSERT_GE(max_skips.size(), 3);
+  for (uint64_t max_skip : max_skips) {
+    ASSERT_GE(max_skip, 1);
+    ASSERT_LE(max_skip, 4 * 16);
+  }
+
+  // Fixed again once disabled
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"adapt_max_sequential_skip_in_iterations", "false"}}));
+  max_skips.clear();
+  std::unique_ptr<Iterator> iter(NewIterator(ReadOptions()));
+  iter->SeekToFirst();
+  ASSERT_EQ(IterStatus(iter.get()), "b->vb");
+  ASSERT_TRUE(max_skips.empty());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBIteratorTest, ReseekUponDirectionChange) {
   Options options = GetDefaultOptions();
   options.create_if_missing = true;
@@ -3550,6 +3599,296 @@ TEST_F(DBIteratorTest, ErrorWhenReadFile) {
   iter->Reset();
 }
 
+TEST_F(DBIteratorBaseTest, TableCacheOpenAhead) {
+  for (bool lock_free_table_cache : {false, true}) {
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.max_open_files = 20;
+    // One shard holding all ten table readers
+    options.table_cache_numshardbits = 0;
+    options.lock_free_table_cache = lock_free_table_cache;
+    options.table_cache_open_ahead = true;
+    options.statistics = CreateDBStatistics();
+    DestroyAndReopen(options);
+
+    // Four files in L1
+    for (int i = 0; i < 4; ++i) {
+      for (int j = 0; j < 10; ++j) {
+        ASSERT_OK(Put(Key(i * 10 + j), "v" + std::to_string(i * 10 + j)));
+      }
+      ASSERT_OK(Flush());
+    }
+    MoveFilesToLevel(1);
+    ASSERT_EQ("0,4", FilesPerLevel());
+    dbfull()->TEST_table_cache()->EraseUnRefEntries();
+
+    SyncPoint::GetInstance()->LoadDependency(
+        {{"TableCache::OpenAhead::BGWork:Done",
+          "DBIteratorBaseTest::TableCacheOpenAhead:OpenedAhead"}});
+    SyncPoint::GetInstance()->EnableProcessing();
+
+    const uint64_t opens = TestGetTickerCount(options, NO_FILE_OPENS);
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    TEST_SYNC_POINT("DBIteratorBaseTest::TableCacheOpenAhead:OpenedAhead");
+    // The first file, and the second one in the background
+    ASSERT_EQ(opens + 2, TestGetTickerCount(options, NO_FILE_OPENS));
+
+    int count = 0;
+    for (; iter->Valid(); iter->Next()) {
+      ASSERT_EQ("v" + std::to_string(count), iter->value());
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(40, count);
+    iter.reset();
+    // Each file was opened only once
+    ASSERT_EQ(opens + 4, TestGetTickerCount(options, NO_FILE_OPENS));
+
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+    SyncPoint::GetInstance()->ClearTrace();
+
+    ASSERT_EQ("v17", Get(Key(17)));
+    dbfull()->TEST_table_cache()->EraseUnRefEntries();
+    ASSERT_EQ("v33", Get(Key(33)));
+  }
+}
+
+TEST_F(DBIteratorBaseTest, TableCacheOpenAheadFraction) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_open_files = 20;
+  options.table_cache_open_ahead = true;
+  options.table_cache_open_ahead_fraction = 0.5;
+  options.table_cache_open_ahead_prefetch_size = 1;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions bbto;
+  bbto.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  // Two files in L1, with one data block each
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      ASSERT_OK(Put(Key(i * 10 + j), "v" + std::to_string(i * 10 + j)));
+    }
+    ASSERT_OK(Flush());
+  }
+  MoveFilesToLevel(1);
+  ASSERT_EQ("0,2", FilesPerLevel());
+  dbfull()->TEST_table_cache()->EraseUnRefEntries();
+  bbto.block_cache->EraseUnRefEntries();
+
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"TableCache::OpenAhead::BGWork:Done",
+        "DBIteratorBaseTest::TableCacheOpenAheadFraction:OpenedAhead"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  const uint64_t opens = TestGetTickerCount(options, NO_FILE_OPENS);
+  const uint64_t adds = TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD);
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  iter->SeekToFirst();
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(iter->Valid());
+    iter->Next();
+  }
+  // Less than half of the first file read, so the second one is not opened
+  ASSERT_EQ(opens + 1, TestGetTickerCount(options, NO_FILE_OPENS));
+  iter->Next();
+  ASSERT_EQ("v5", iter->value());
+  TEST_SYNC_POINT(
+      "DBIteratorBaseTest::TableCacheOpenAheadFraction:OpenedAhead");
+  ASSERT_EQ(opens + 2, TestGetTickerCount(options, NO_FILE_OPENS));
+  // The data block of the second file was loaded in the background
+  ASSERT_EQ(adds + 2, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+
+  int count = 5;
+  for (; iter->Valid(); iter->Next()) {
+    ASSERT_EQ("v" + std::to_string(count), iter->value());
+    ++count;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(20, count);
+  iter.reset();
+  ASSERT_EQ(opens + 2, TestGetTickerCount(options, NO_FILE_OPENS));
+  ASSERT_EQ(adds + 2, TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  SyncPoint::GetInstance()->ClearTrace();
+}
+
+TEST_F(DBIteratorTest, MultiScanIterator) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.compression = kNoCompression;
+  BlockBasedTableOptions bbto;
+  bbto.block_size = 256;
+  bbto.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  // L1: [key000, key099], L0: even keys of [key000, key049], memtable:
+  // key041 and key091
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v1_" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  for (int i = 0; i < 50; i += 2) {
+    ASSERT_OK(Put(Key(i), "v2_" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put(Key(41), "v3_41"));
+  ASSERT_OK(Put(Key(91), "v3_91"));
+  ASSERT_OK(Delete(Key(12)));
+
+  std::string starts[] = {Key(10), Key(40), Key(90)};
+  std::string limits[] = {Key(15), Key(42), Key(93)};
+  std::vector<Range> ranges;
+  for (int i = 0; i < 3; ++i) {
+    ranges.emplace_back(starts[i], limits[i]);
+  }
+
+  int multi_reads = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTable::PrefetchScanRanges:MultiRead",
+      [&](void* /*arg*/) { ++multi_reads; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::unique_ptr<Iterator> iter(
+      db_->NewMultiScanIterator(ReadOptions(), db_->DefaultColumnFamily(),
+                                ranges));
+  // One batched read for each of the two files
+  ASSERT_EQ(2, multi_reads);
+  std::vector<std::string> keys;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    keys.push_back(iter->key().ToString() + "=" + iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  std::vector<std::string> expected = {
+      Key(10) + "=v2_10", Key(11) + "=v1_11", Key(13) + "=v1_13",
+      Key(14) + "=v2_14", Key(40) + "=v2_40", Key(41) + "=v3_41",
+      Key(90) + "=v1_90", Key(91) + "=v3_91", Key(92) + "=v1_92"};
+  ASSERT_EQ(expected, keys);
+
+  // Seeks land in the first range ending after the target
+  iter->Seek(Key(20));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(40), iter->key());
+  iter->Seek(Key(91));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(91), iter->key());
+  iter->Seek(Key(93));
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+
+  // Only forward iteration is supported
+  iter->SeekToFirst();
+  iter->Prev();
+  ASSERT_TRUE(iter->status().IsNotSupported());
+  iter.reset();
+
+  // The blocks were already cached, so there is nothing more to read
+  iter.reset(db_->NewMultiScanIterator(ReadOptions(),
+                                       db_->DefaultColumnFamily(), ranges));
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(2, multi_reads);
+  iter.reset();
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::swap(ranges[0], ranges[1]);
+  iter.reset(db_->NewMultiScanIterator(ReadOptions(),
+                                       db_->DefaultColumnFamily(), ranges));
+  ASSERT_TRUE(iter->status().IsInvalidArgument());
+  ASSERT_FALSE(iter->Valid());
+}
+
+TEST_F(DBIteratorTest, BatchIterator) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.compression = kNoCompression;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  BlockBasedTableOptions bbto;
+  bbto.use_delta_encoding = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "v_" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(Merge(Key(50), "m"));
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(),
+                           Key(70), {{kDefaultWideColumnName, "e_70"},
+                                     {"a", "x"}, {"b", "y"}}));
+
+  auto expected_value = [](int i) -> std::string {
+    return i == 50 ? "v_50,m" : i == 70 ? "e_70" : "v_" + std::to_string(i);
+  };
+
+  BatchIteratorOptions batch_options;
+  batch_options.max_rows = 30;
+  batch_options.columns = {"a"};
+  ReadOptions read_options;
+  read_options.pin_data = true;
+  std::unique_ptr<BatchIterator> iter(db_->NewBatchIterator(
+      read_options, db_->DefaultColumnFamily(), batch_options));
+  iter->SeekToFirst();
+  RecordBatch batch;
+  int num_rows = 0;
+  for (int b = 0; iter->NextBatch(&batch); ++b) {
+    ASSERT_EQ(batch.num_rows, b < 3 ? 30 : 10);
+    ASSERT_EQ(batch.columns.size(), 1);
+    const BatchColumn& a = batch.columns[0];
+    for (size_t row = 0; row < batch.num_rows; ++row, ++num_rows) {
+      ASSERT_EQ(batch.keys.Get(row), Key(num_rows));
+      ASSERT_EQ(batch.values.Get(row), expected_value(num_rows));
+      ASSERT_EQ(a.IsNull(row), num_rows != 70);
+      ASSERT_EQ(a.Get(row), num_rows == 70 ? "x" : "");
+    }
+    ASSERT_EQ(a.null_count, b == 2 ? 29 : batch.num_rows);
+    // The keys and values are referenced in the pinned blocks and memtable,
+    // but the result of the merge is copied along with its batch
+    ASSERT_TRUE(batch.keys.pinned);
+    ASSERT_EQ(batch.values.pinned, b != 1);
+    if (!batch.values.pinned) {
+      ASSERT_EQ(batch.values.offsets.size(), batch.num_rows + 1);
+      ASSERT_TRUE(batch.values.views.empty());
+    }
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(num_rows, 100);
+
+  // Without pinning, the columns are copied. Tiny batches hold one row.
+  batch_options.max_bytes = 1;
+  batch_options.include_values = false;
+  iter.reset(db_->NewBatchIterator(ReadOptions(), db_->DefaultColumnFamily(),
+                                   batch_options));
+  iter->Seek(Key(69));
+  ASSERT_TRUE(iter->NextBatch(&batch));
+  ASSERT_EQ(batch.num_rows, 1);
+  ASSERT_FALSE(batch.keys.pinned);
+  ASSERT_EQ(batch.keys.offsets, std::vector<int32_t>({0, 9}));
+  ASSERT_EQ(batch.keys.data, Key(69));
+  ASSERT_TRUE(batch.columns[0].IsNull(0));
+  ASSERT_TRUE(batch.values.offsets.empty());
+  ASSERT_TRUE(iter->NextBatch(&batch));
+  ASSERT_EQ(batch.keys.Get(0), Key(70));
+  ASSERT_FALSE(batch.columns[0].IsNull(0));
+  ASSERT_EQ(batch.columns[0].Get(0), "x");
+  ASSERT_EQ(batch.columns[0].offsets, std::vector<int32_t>({0, 1}));
+
+  iter->Seek(Key(100));
+  ASSERT_FALSE(iter->NextBatch(&batch));
+  ASSERT_EQ(batch.num_rows, 0);
+  ASSERT_OK(iter->status());
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
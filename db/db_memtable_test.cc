@@ -3,6 +3,8 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -12,6 +14,7 @@
 #include "port/stack_trace.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/slice_transform.h"
+#include "utilities/merge_operators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -316,6 +319,100 @@ TEST_F(DBMemTableTest, InsertWithHint) {
   ASSERT_EQ("vvv", Get("NotInPrefixDomain"));
 }
 
+TEST_F(DBMemTableTest, InsertHintPerBatch) {
+  Options options;
+  options.allow_concurrent_memtable_write = false;
+  options.create_if_missing = true;
+  options.memtable_factory.reset(new MockMemTableRepFactory());
+  options.env = env_;
+  Reopen(options);
+  MockMemTableRep* rep =
+      static_cast<MockMemTableRepFactory*>(options.memtable_factory.get())
+          ->rep();
+  WriteOptions write_options;
+  write_options.memtable_insert_hint_per_batch = true;
+
+  WriteBatch batch;
+  for (int i = 0; i < 5; i++) {
+    ASSERT_OK(batch.Put(Key(i), "v" + std::to_string(i)));
+  }
+  ASSERT_OK(db_->Write(write_options, &batch));
+  ASSERT_EQ(5, rep->num_insert_with_hint());
+  void* hint = rep->last_hint_out();
+  ASSERT_NE(nullptr, hint);
+
+  // Non-concurrent writers continue from the memtable's hint.
+  batch.Clear();
+  for (int i = 5; i < 10; i++) {
+    ASSERT_OK(batch.Put(Key(i), "v" + std::to_string(i)));
+  }
+  // Range deletions live in a separate table and can't use the hint.
+  ASSERT_OK(batch.DeleteRange(Key(2), Key(4)));
+  ASSERT_OK(db_->Write(write_options, &batch));
+  ASSERT_EQ(10, rep->num_insert_with_hint());
+  ASSERT_EQ(hint, rep->last_hint_in());
+  ASSERT_EQ(hint, rep->last_hint_out());
+
+  ASSERT_OK(Put(Key(10), "v10"));
+  ASSERT_EQ(10, rep->num_insert_with_hint());
+
+  for (int i = 0; i <= 10; i++) {
+    ASSERT_EQ(i == 2 || i == 3 ? "NOT_FOUND" : "v" + std::to_string(i),
+              Get(Key(i)));
+  }
+}
+
+TEST_F(DBMemTableTest, SortedBatchesWithInsertHint) {
+  for (bool concurrent : {false, true}) {
+    Options options = CurrentOptions();
+    options.allow_concurrent_memtable_write = concurrent;
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    DestroyAndReopen(options);
+    WriteOptions write_options;
+    write_options.memtable_insert_hint_per_batch = true;
+
+    constexpr int kNumBatches = 20;
+    constexpr int kBatchSize = 100;
+    for (int b = 0; b < kNumBatches; b++) {
+      // Batches are sorted, later ones overwrite every other key of earlier
+      // ones, and a few keys are merged or range deleted.
+      WriteBatch batch;
+      const int begin = b * kBatchSize / 2;
+      for (int i = begin; i < begin + kBatchSize; i++) {
+        if (i % 7 == 0) {
+          ASSERT_OK(batch.Merge(Key(i), std::to_string(b)));
+        } else {
+          ASSERT_OK(batch.Put(Key(i), std::to_string(b)));
+        }
+      }
+      ASSERT_OK(batch.DeleteRange(Key(begin + 10), Key(begin + 12)));
+      ASSERT_OK(db_->Write(write_options, &batch));
+    }
+
+    const int num_keys = (kNumBatches + 1) * kBatchSize / 2;
+    for (int i = 0; i < num_keys; i++) {
+      // The last batch that wrote key i, and whether a later one deleted it.
+      const int last = std::min(i / (kBatchSize / 2), kNumBatches - 1);
+      const int first = std::max(i / (kBatchSize / 2) - 1, 0);
+      std::string expected;
+      for (int b = first; b <= last; b++) {
+        const int begin = b * kBatchSize / 2;
+        if (i < begin || i >= begin + kBatchSize) {
+          continue;
+        }
+        if (i == begin + 10 || i == begin + 11) {
+          expected.clear();
+        } else if (i % 7 == 0 && !expected.empty()) {
+          expected += "," + std::to_string(b);
+        } else {
+          expected = std::to_string(b);
+        }
+      }
+      ASSERT_EQ(expected.empty() ? "NOT_FOUND" : expected, Get(Key(i)));
+    }
+  }
+}
+
 TEST_F(DBMemTableTest, ColumnFamilyId) {
   // Verifies MemTableRepFactory is told the right column family id.
   Options options;
@@ -335,6 +432,304 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+TEST_F(DBMemTableTest, BTreeRep) {
+  Options options = CurrentOptions();
+  ConfigOptions config_options;
+  std::shared_ptr<MemTableRepFactory> factory;
+  ASSERT_OK(MemTableRepFactory::CreateFromString(config_options, "btree",
+                                                 &factory));
+  ASSERT_STREQ(BTreeRepFactory::kClassName(), factory->Name());
+  options.memtable_factory = factory;
+  options.allow_concurrent_memtable_write = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeys = 1000;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < kNumKeys; i += kNumThreads) {
+        ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  // Overwrite and delete some keys so that there are several versions of a
+  // user key in the memtable.
+  for (int i = 0; i < kNumKeys; i += 3) {
+    ASSERT_OK(Put(Key(i), "w" + std::to_string(i)));
+  }
+  for (int i = 1; i < kNumKeys; i += 3) {
+    ASSERT_OK(Delete(Key(i)));
+  }
+
+  auto expected = [](int i) -> std::string {
+    if (i % 3 == 0) {
+      return "w" + std::to_string(i);
+    }
+    return i % 3 == 1 ? "NOT_FOUND" : "v" + std::to_string(i);
+  };
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(expected(i), Get(Key(i)));
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+      if (i % 3 == 1) {
+        i++;
+      }
+      ASSERT_EQ(Key(i), iter->key());
+      ASSERT_EQ(expected(i), iter->value());
+    }
+    ASSERT_OK(iter->status());
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      i--;
+      if (i % 3 == 1) {
+        i--;
+      }
+      ASSERT_EQ(Key(i), iter->key());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(0, i);
+    // The second pass reads the same data back from an SST file.
+    ASSERT_OK(Flush());
+  }
+}
+
+TEST_F(DBMemTableTest, SkipListKeyHead) {
+  Options options = CurrentOptions();
+  ConfigOptions config_options;
+  std::shared_ptr<MemTableRepFactory> factory;
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "id=skip_list; use_key_head=true", &factory));
+  ASSERT_TRUE(factory->IsInstanceOf(SkipListFactory::kNickName()));
+  options.memtable_factory = factory;
+  DestroyAndReopen(options);
+
+  // User keys that are shorter than, equal to or longer than a key head,
+  // and that tie on their heads, must keep their bytewise order.
+  std::map<std::string, std::string> model;
+  std::vector<std::string> keys = {"",
+                                   std::string("\0", 1),
+                                   "a",
+                                   std::string("a\0", 2),
+                                   "abcdefg",
+                                   std::string("abcdefg\0", 8),
+                                   "abcdefgh",
+                                   "abcdefgh0",
+                                   "abcdefgh1",
+                                   "abcdefgi",
+                                   "\xff\xff\xff\xff\xff\xff\xff\xff",
+                                   "\xff\xff\xff\xff\xff\xff\xff\xff\xff"};
+  Random rnd(301);
+  for (int i = 0; i < 200; i++) {
+    keys.push_back("abcdefgh" + rnd.RandomString(rnd.Uniform(4)));
+    keys.push_back(rnd.RandomBinaryString(rnd.Uniform(12)));
+  }
+  for (int round = 0; round < 2; round++) {
+    for (size_t i = 0; i < keys.size(); i++) {
+      std::string value = std::to_string(round) + "_" + std::to_string(i);
+      ASSERT_OK(Put(keys[i], value));
+      model[keys[i]] = value;
+    }
+  }
+
+  for (const auto& kv : model) {
+    ASSERT_EQ(kv.second, Get(kv.first));
+  }
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  auto model_iter = model.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++model_iter) {
+    ASSERT_TRUE(model_iter != model.end());
+    ASSERT_EQ(model_iter->first, iter->key().ToString());
+    ASSERT_EQ(model_iter->second, iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_TRUE(model_iter == model.end());
+  for (const auto& key : keys) {
+    iter->Seek(key);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key, iter->key().ToString());
+    iter->Prev();
+    auto it = model.find(key);
+    if (it == model.begin()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ((--it)->first, iter->key().ToString());
+    }
+  }
+  ASSERT_OK(iter->status());
+}
+
+TEST_F(DBMemTableTest, SkipListPointLookupIndex) {
+  Options options = CurrentOptions();
+  ConfigOptions config_options;
+  std::shared_ptr<MemTableRepFactory> factory;
+  // Few buckets, so that many user keys share a chain
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "id=skip_list; point_lookup_index_buckets=16",
+      &factory));
+  options.memtable_factory = factory;
+  options.allow_concurrent_memtable_write = true;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeys = 1000;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < kNumKeys; i += kNumThreads) {
+        ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  const Snapshot* snapshot = db_->GetSnapshot();
+  // Newer versions that a lookup at the snapshot has to look past
+  for (int i = 0; i < kNumKeys; i += 2) {
+    if (i % 3 == 0) {
+      ASSERT_OK(Delete(Key(i)));
+    } else {
+      ASSERT_OK(Merge(Key(i), "m"));
+    }
+  }
+
+  ReadOptions snapshot_read;
+  snapshot_read.snapshot = snapshot;
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string expected = "v" + std::to_string(i);
+    ASSERT_EQ(expected, Get(Key(i), snapshot));
+    if (i % 2 == 0) {
+      expected = i % 3 == 0 ? "NOT_FOUND" : expected + ",m";
+    }
+    ASSERT_EQ(expected, Get(Key(i)));
+  }
+  ASSERT_EQ("NOT_FOUND", Get(Key(kNumKeys)));
+  ASSERT_EQ("NOT_FOUND", Get("a"));
+  db_->ReleaseSnapshot(snapshot);
+
+  // The index is allocated from the memtable's arena
+  uint64_t with_index = 0;
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kCurSizeActiveMemTable,
+                                  &with_index));
+  options.memtable_factory.reset(new SkipListFactory());
+  DestroyAndReopen(options);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+  }
+  uint64_t without_index = 0;
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kCurSizeActiveMemTable,
+                                  &without_index));
+  ASSERT_GT(with_index, without_index);
+}
+
+TEST_F(DBMemTableTest, ArenaBlockPool) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 256 << 10;
+  options.arena_block_size = 16 << 10;
+  options.memtable_arena_pool_size = 1 << 20;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+
+  ArenaBlockPool* pool = dbfull()
+                             ->GetVersionSet()
+                             ->GetColumnFamilySet()
+                             ->arena_block_pool()
+                             .get();
+  ASSERT_NE(nullptr, pool);
+  // Sized for the one immutable memtable that max_write_buffer_number allows
+  ASSERT_EQ(options.write_buffer_size, pool->capacity());
+  // The first memtable asked for the pool to be filled
+  for (int i = 0; pool->PooledBytes() < pool->capacity(); i++) {
+    ASSERT_LT(i, 10000);
+    env_->SleepForMicroseconds(1000);
+  }
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 100; i++) {
+    values.push_back(rnd.RandomString(1000));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  // The memtable took its blocks from the pool
+  ASSERT_LT(pool->PooledBytes(), pool->capacity());
+  ASSERT_GT(TestGetTickerCount(options, MEMTABLE_ARENA_POOL_HIT), 0);
+  ASSERT_OK(Flush());
+  // Enough to switch memtables a few times
+  for (int i = 100; i < 1000; i++) {
+    values.push_back(rnd.RandomString(1000));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+
+  ASSERT_OK(dbfull()->SetOptions({{"max_write_buffer_number", "4"}}));
+  ASSERT_EQ(3 * options.write_buffer_size, pool->capacity());
+  ASSERT_OK(dbfull()->SetOptions({{"write_buffer_size", "131072"}}));
+  ASSERT_EQ(3 * 131072, pool->capacity());
+  ASSERT_LE(pool->PooledBytes(), pool->capacity());
+
+  Reopen(options);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
+TEST_F(DBMemTableTest, VectorRepConcurrentInsert) {
+  Options options = CurrentOptions();
+  ConfigOptions config_options;
+  std::shared_ptr<MemTableRepFactory> factory;
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "id=vector; sort_threads=4", &factory));
+  ASSERT_TRUE(factory->IsInsertConcurrentlySupported());
+  options.memtable_factory = factory;
+  options.allow_concurrent_memtable_write = true;
+  options.write_buffer_size = 64 << 20;
+  DestroyAndReopen(options);
+
+  // Enough keys for the sort on flush to be split across threads
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeys = 40000;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < kNumKeys; i += kNumThreads) {
+        ASSERT_OK(Put(Key(i), "v" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  // Reads of the mutable memtable see entries of all threads
+  for (int i = 0; i < kNumKeys; i += 997) {
+    ASSERT_EQ("v" + std::to_string(i), Get(Key(i)));
+  }
+
+  ASSERT_OK(Flush());
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  std::vector<std::string> keys;
+  for (int i = 0; i < kNumKeys; i++) {
+    keys.push_back(Key(i));
+  }
+  std::sort(keys.begin(), keys.end());
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), count++) {
+    ASSERT_LT(count, keys.size());
+    ASSERT_EQ(keys[count], iter->key().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(keys.size(), count);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
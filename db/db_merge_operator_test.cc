@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 
+#include "cache/cache_reservation_manager.h"
 #include "db/db_test_util.h"
 #include "db/dbformat.h"
 #include "db/forward_iterator.h"
@@ -951,6 +952,64 @@ TEST_P(PerConfigMergeOperatorPinningTest, Randomized) {
   VerifyDBFromMap(true_data);
 }
 
+TEST_F(DBMergeOperatorTest, MergeResultCache) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  options.merge_result_cache_size = 1 << 20;
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // A base value and operands spread over table files
+  ASSERT_OK(Put("key", "v0"));
+  ASSERT_OK(Flush());
+  for (int i = 1; i <= 3; i++) {
+    ASSERT_OK(Merge("key", "v" + std::to_string(i)));
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("v0,v1,v2,v3", Get("key"));
+  ASSERT_EQ(1, TestGetTickerCount(options, MERGE_RESULT_CACHE_MISS));
+  ASSERT_EQ(0, TestGetTickerCount(options, MERGE_RESULT_CACHE_HIT));
+  ASSERT_EQ("v0,v1,v2,v3", Get("key"));
+  ASSERT_EQ(1, TestGetTickerCount(options, MERGE_RESULT_CACHE_HIT));
+  // The cached result is charged to the block cache
+  ASSERT_GE(table_options.block_cache->GetUsage(),
+            CacheReservationManagerImpl<
+                CacheEntryRole::kMisc>::GetDummyEntrySize());
+
+  // A newer operand in the memtable supersedes the cached result, which
+  // still serves reads of a snapshot taken before it
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Merge("key", "v4"));
+  ASSERT_EQ("v0,v1,v2,v3,v4", Get("key"));
+  ASSERT_EQ(2, TestGetTickerCount(options, MERGE_RESULT_CACHE_MISS));
+  ASSERT_EQ("v0,v1,v2,v3,v4", Get("key"));
+  ASSERT_EQ(2, TestGetTickerCount(options, MERGE_RESULT_CACHE_HIT));
+  ASSERT_EQ("v0,v1,v2,v3", Get("key", snapshot));
+  ASSERT_EQ(3, TestGetTickerCount(options, MERGE_RESULT_CACHE_HIT));
+  db_->ReleaseSnapshot(snapshot);
+
+  // Operands without a base value, and a key without operands
+  ASSERT_OK(Merge("key2", "a"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Merge("key2", "b"));
+  ASSERT_OK(Put("key3", "c"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("a,b", Get("key2"));
+  ASSERT_EQ("a,b", Get("key2"));
+  ASSERT_EQ("c", Get("key3"));
+  ASSERT_EQ(3, TestGetTickerCount(options, MERGE_RESULT_CACHE_MISS));
+  ASSERT_EQ(4, TestGetTickerCount(options, MERGE_RESULT_CACHE_HIT));
+
+  // Compacting the operands leaves the result unchanged
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("v0,v1,v2,v3,v4", Get("key"));
+  ASSERT_EQ("a,b", Get("key2"));
+}
+
 TEST_F(DBMergeOperatorTest, MaxSuccessiveMergesBaseValues) {
   Options options = CurrentOptions();
   options.create_if_missing = true;
@@ -1043,6 +1102,50 @@ TEST_F(DBMergeOperatorTest, MaxSuccessiveMergesBaseValues) {
   }
 }
 
+TEST_F(DBMergeOperatorTest, UInt64AddManyOperands) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.merge_operator = MergeOperators::CreateUInt64AddOperator();
+  options.env = env_;
+  Reopen(options);
+
+  auto encode = [](uint64_t v) {
+    std::string result;
+    PutFixed64(&result, v);
+    return result;
+  };
+
+  // Operand counts around the unrolled loop, with and without base values and
+  // with a corrupted operand counted as 0
+  uint64_t expected = 0;
+  ASSERT_OK(Put("base", encode(1000)));
+  expected += 1000;
+  for (uint64_t i = 1; i <= 7; ++i) {
+    ASSERT_OK(Merge("base", encode(i)));
+    ASSERT_OK(Merge("nobase", encode(i)));
+    expected += i;
+  }
+  ASSERT_OK(Merge("nobase", "bad"));
+  ASSERT_OK(Flush());
+
+  auto verify = [&]() {
+    ASSERT_EQ(Get("base"), encode(expected));
+    ASSERT_EQ(Get("nobase"), encode(expected - 1000));
+  };
+  verify();
+
+  // Partial merges in compaction
+  for (uint64_t i = 8; i <= 13; ++i) {
+    ASSERT_OK(Merge("base", encode(i)));
+    ASSERT_OK(Merge("nobase", encode(i)));
+    expected += i;
+    ASSERT_OK(Flush());
+  }
+  verify();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  verify();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -10,6 +10,7 @@
 #include <stdio.h>
 
 #include <algorithm>
+#include <sstream>
 #include <string>
 
 #include "db/db_test_util.h"
@@ -503,6 +504,215 @@ TEST_F(DBPropertiesTest, ReadLatencyHistogramByLevel) {
   ASSERT_EQ(std::string::npos, prop.find("** Level 2 read latency histogram"));
 }
 
+TEST_F(DBPropertiesTest, BlockFetchHistogram) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+  std::string prop;
+  ASSERT_TRUE(db_->GetProperty("rocksdb.cf-block-fetch-histogram", &prop));
+  ASSERT_EQ(std::string::npos, prop.find("** Level 0"));
+
+  // Only recorded when statistics time operations
+  options.statistics->set_stats_level(StatsLevel::kExceptTimers);
+  ASSERT_EQ("bar", Get("foo"));
+  ASSERT_TRUE(db_->GetProperty("rocksdb.cf-block-fetch-histogram", &prop));
+  ASSERT_EQ(std::string::npos, prop.find("** Level 0"));
+
+  options.statistics->set_stats_level(StatsLevel::kExceptDetailedTimers);
+  ASSERT_EQ("bar", Get("foo"));
+  ASSERT_TRUE(db_->GetProperty("rocksdb.cf-block-fetch-histogram", &prop));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Level 0 Get block cache hit latency histogram"));
+  ASSERT_EQ(std::string::npos, prop.find("Get block cache miss"));
+
+  // Misses after the cache is emptied
+  ASSERT_OK(dbfull()->ResetStats());
+  table_options.block_cache->EraseUnRefEntries();
+  ASSERT_EQ(std::vector<std::string>({"bar"}), MultiGet({"foo"}, nullptr));
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+  }
+  ASSERT_TRUE(db_->GetProperty("rocksdb.cf-block-fetch-histogram", &prop));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Level 0 MultiGet block cache miss latency"));
+  ASSERT_NE(std::string::npos,
+            prop.find("** Level 0 Iterator block cache hit latency"));
+  ASSERT_EQ(std::string::npos, prop.find("Level 0 Get block cache hit"));
+}
+
+TEST_F(DBPropertiesTest, BlockCacheHeatMap) {
+  Options options = CurrentOptions();
+  options.block_cache_heat_sample_one_in = 1;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "v1"));
+  ASSERT_OK(Put("c", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("x", "v2"));
+  ASSERT_OK(Flush());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(2U, files.size());
+  uint64_t ac_file = 0;
+  for (const auto& f : files) {
+    if (f.smallestkey == "a") {
+      ac_file = f.file_number;
+    }
+  }
+  ASSERT_NE(0U, ac_file);
+
+  table_options.block_cache->EraseUnRefEntries();
+  ASSERT_EQ("v1", Get("a"));
+  ASSERT_EQ("v1", Get("c"));
+  std::string prop;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlockCacheHeatMap, &prop));
+  ASSERT_NE(std::string::npos, prop.find("One in 1 block cache lookups"));
+  // A miss and a hit of the data block, as the index and filter blocks are
+  // held by the table reader
+  char expected[100];
+  snprintf(expected, sizeof(expected),
+           "    0 %10" PRIu64 "          1          1  [61, 63]\n", ac_file);
+  ASSERT_NE(std::string::npos, prop.find(expected)) << prop;
+  ASSERT_EQ(std::string::npos, prop.find("[78, 78]"));
+
+  // The samples of compacted files are dropped
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  prop.clear();
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlockCacheHeatMap, &prop));
+  ASSERT_EQ(std::string::npos, prop.find("[61, 63]"));
+  ASSERT_EQ(std::string::npos, prop.find("untracked"));
+
+  ASSERT_EQ("v2", Get("x"));
+  prop.clear();
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlockCacheHeatMap, &prop));
+  ASSERT_NE(std::string::npos, prop.find("[61, 78]"));
+  ASSERT_OK(dbfull()->ResetStats());
+  prop.clear();
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlockCacheHeatMap, &prop));
+  ASSERT_EQ(std::string::npos, prop.find("[61, 78]"));
+}
+
+TEST_F(DBPropertiesTest, DBMutexContention) {
+  Options options = CurrentOptions();
+  Reopen(options);
+  std::string prop;
+  ASSERT_FALSE(db_->GetProperty(DB::Properties::kDBMutexContention, &prop));
+
+  options.db_mutex_contention_threshold_micros = 1000;
+  Reopen(options);
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"InstrumentedMutex::Lock:Wait",
+        "DBPropertiesTest::DBMutexContention:Unlock"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+  dbfull()->TEST_LockMutex();
+  port::Thread waiter([&]() {
+    uint64_t value;
+    EXPECT_TRUE(
+        db_->GetIntProperty(DB::Properties::kNumRunningFlushes, &value));
+  });
+  TEST_SYNC_POINT("DBPropertiesTest::DBMutexContention:Unlock");
+  env_->SleepForMicroseconds(2000);
+  dbfull()->TEST_UnlockMutex();
+  waiter.join();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kDBMutexContention, &prop));
+  ASSERT_NE(std::string::npos, prop.find("Waits and holds of at least 1000"));
+  // The long hold of the test, and the wait it caused
+  ASSERT_NE(std::string::npos, prop.find("\ndb_impl_debug.cc:"));
+  ASSERT_NE(std::string::npos, prop.find("micros for db_impl_debug.cc:"));
+
+  ASSERT_OK(dbfull()->ResetStats());
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kDBMutexContention, &prop));
+  ASSERT_EQ(std::string::npos, prop.find("micros for db_impl_debug.cc:"));
+}
+
+TEST_F(DBPropertiesTest, BackgroundQueueStats) {
+  Options options = CurrentOptions();
+  options.background_job_weight = 0;
+  Reopen(options);
+  std::string prop;
+  ASSERT_FALSE(db_->GetProperty(DB::Properties::kBackgroundQueueStats, &prop));
+
+  options.background_job_weight = 1;
+  Reopen(options);
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBackgroundQueueStats, &prop));
+  ASSERT_NE(std::string::npos, prop.find("High pool: 0 jobs"));
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Flush());
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBackgroundQueueStats, &prop));
+  // In the HIGH pool, or the LOW pool without HIGH threads
+  ASSERT_NE(std::string::npos, prop.find(" pool: 1 jobs"));
+}
+
+TEST_F(DBPropertiesTest, VersionPropertiesWithoutDBMutex) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  Reopen(options);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_OK(Put("key" + std::to_string(i), "value"));
+    ASSERT_OK(Flush());
+  }
+
+  int num_computed = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "Version::GetAggregatedTableProperties:Compute",
+      [&](void* /*arg*/) { num_computed++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // The properties of the current version are served from a referenced
+  // super version, so they don't wait for the DB mutex
+  std::string num_files;
+  std::string level_stats;
+  std::string sstables;
+  std::map<std::string, std::string> tp;
+  dbfull()->TEST_LockMutex();
+  port::Thread reader([&]() {
+    EXPECT_TRUE(db_->GetProperty(DB::Properties::kNumFilesAtLevelPrefix + "0",
+                                 &num_files));
+    EXPECT_TRUE(db_->GetProperty(DB::Properties::kLevelStats, &level_stats));
+    EXPECT_TRUE(db_->GetProperty(DB::Properties::kSSTables, &sstables));
+    EXPECT_TRUE(
+        db_->GetMapProperty(DB::Properties::kAggregatedTableProperties, &tp));
+  });
+  reader.join();
+  dbfull()->TEST_UnlockMutex();
+  ASSERT_EQ("2", num_files);
+  ASSERT_NE(std::string::npos, level_stats.find("  0        2"));
+  ASSERT_NE(std::string::npos, sstables.find("--- level 0 ---"));
+  ASSERT_EQ("2", tp["num_entries"]);
+  ASSERT_EQ(1, num_computed);
+
+  // Cached for the version
+  std::string tp_string;
+  ASSERT_TRUE(
+      db_->GetProperty(DB::Properties::kAggregatedTableProperties, &tp_string));
+  ASSERT_EQ(1, num_computed);
+
+  // A new version computes its own
+  ASSERT_OK(Put("key2", "value"));
+  ASSERT_OK(Flush());
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kAggregatedTableProperties, &tp));
+  ASSERT_EQ("3", tp["num_entries"]);
+  ASSERT_EQ(2, num_computed);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBPropertiesTest, AggregatedTablePropertiesAtLevel) {
   const int kTableCount = 100;
   const int kDeletionsPerTable = 0;
@@ -1035,6 +1245,45 @@ TEST_F(DBPropertiesTest, EstimatePendingCompBytes) {
   ASSERT_EQ(int_num, 0U);
 }
 
+TEST_F(DBPropertiesTest, CompactionReadHeat) {
+  Options options = CurrentOptions();
+  options.num_levels = 3;
+  options.compaction_read_heat_weight = 1;
+  Reopen(options);
+
+  ASSERT_OK(Put("a", "v"));
+  ASSERT_OK(Flush());
+  // Reads are sampled one in kFileReadSampleRate, so this is all but certain
+  // to sample some.
+  for (int i = 0; i < 20 * 1024; i++) {
+    ASSERT_EQ("v", Get("a"));
+  }
+
+  std::string heat;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kCompactionReadHeat, &heat));
+  std::istringstream lines(heat);
+  std::string line;
+  std::getline(lines, line);
+  std::getline(lines, line);
+  for (int level = 0; level < options.num_levels; level++) {
+    ASSERT_TRUE(std::getline(lines, line));
+    std::istringstream fields(line);
+    int line_level = -1;
+    uint64_t reads = 0;
+    double level_heat = -1;
+    fields >> line_level >> reads >> level_heat;
+    ASSERT_EQ(level, line_level);
+    if (level == 0) {
+      ASSERT_GT(reads, 0U);
+      ASSERT_DOUBLE_EQ(1.0, level_heat);
+    } else {
+      ASSERT_EQ(0U, reads);
+      ASSERT_DOUBLE_EQ(0.0, level_heat);
+    }
+  }
+  ASSERT_FALSE(std::getline(lines, line));
+}
+
 TEST_F(DBPropertiesTest, EstimateCompressionRatio) {
   if (!Snappy_Supported()) {
     return;
@@ -1810,6 +2059,52 @@ TEST_F(DBPropertiesTest, MinObsoleteSstNumberToKeep) {
   ASSERT_TRUE(listener->Validated());
 }
 
+TEST_F(DBPropertiesTest, WriteGroupSizeLimits) {
+  Options options = CurrentOptions();
+  DestroyAndReopen(options);
+  uint64_t limit_bytes = 0;
+  uint64_t limit_writers = 0;
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kWriteGroupSizeLimitBytes,
+                                  &limit_bytes));
+  ASSERT_EQ(options.max_write_batch_group_size_bytes, limit_bytes);
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kWriteGroupSizeLimitWriters,
+                                  &limit_writers));
+  ASSERT_EQ(0u, limit_writers);
+
+  options.write_group_target_wal_latency_us = 100;
+  Reopen(options);
+  uint64_t wal_write_micros = 1000;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WriteToWAL:WALWriteLatency", [&](void* arg) {
+        *static_cast<uint64_t*>(arg) = wal_write_micros;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Every WAL write misses the target, so the limits shrink to their floor.
+  for (int i = 0; i < 64; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kWriteGroupSizeLimitBytes,
+                                  &limit_bytes));
+  ASSERT_EQ(4u << 10, limit_bytes);
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kWriteGroupSizeLimitWriters,
+                                  &limit_writers));
+  ASSERT_EQ(1u, limit_writers);
+
+  // Meeting the target is not enough to grow them again while no writer is
+  // held back by the limits.
+  wal_write_micros = 10;
+  for (int i = 0; i < 256; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kWriteGroupSizeLimitBytes,
+                                  &limit_bytes));
+  ASSERT_EQ(4u << 10, limit_bytes);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBPropertiesTest, BlobCacheProperties) {
   Options options;
   uint64_t value;
@@ -2275,6 +2570,89 @@ TEST_F(DBPropertiesTest, GetMapPropertyWriteStallStats) {
   }
 }
 
+TEST_F(DBPropertiesTest, WriteStallTimeline) {
+  class WriteStallDetailListener : public EventListener {
+   public:
+    void OnWriteStallDetail(const WriteStallDetailInfo& info) override {
+      std::lock_guard<std::mutex> lock(mutex_);
+      details_.push_back(info);
+    }
+    std::vector<WriteStallDetailInfo> GetDetails() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return details_;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::vector<WriteStallDetailInfo> details_;
+  };
+
+  auto listener = std::make_shared<WriteStallDetailListener>();
+  Options options = CurrentOptions();
+  options.max_write_buffer_number = 2;
+  options.disable_auto_compactions = true;
+  options.listeners.push_back(listener);
+  CreateAndReopenWithCF({"heavy_write_cf"}, options);
+
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(dbfull()->GetMapProperty(
+      handles_[1], DB::Properties::kCFWriteStallTimeline, &values));
+  ASSERT_TRUE(values.empty());
+
+  // Pause flush thread to stop writes with two unflushed memtables
+  std::unique_ptr<test::SleepingBackgroundTask> sleeping_task(
+      new test::SleepingBackgroundTask());
+  env_->SetBackgroundThreads(1, Env::HIGH);
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask,
+                 sleeping_task.get(), Env::Priority::HIGH);
+  sleeping_task->WaitUntilSleeping();
+
+  FlushOptions fo;
+  fo.allow_write_stall = true;
+  fo.wait = false;
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK(dbfull()->Put(WriteOptions(), handles_[1], Key(i), "v"));
+    ASSERT_OK(dbfull()->Flush(fo, handles_[1]));
+  }
+
+  values.clear();
+  ASSERT_TRUE(dbfull()->GetMapProperty(
+      handles_[1], DB::Properties::kCFWriteStallTimeline, &values));
+  ASSERT_EQ(values["000.condition"], "stops");
+  ASSERT_EQ(values["000.cause"], "memtable-limit");
+  ASSERT_EQ(values["000.unflushed-memtables"], "2");
+  ASSERT_EQ(values["000.end-micros"], "0");
+  ASSERT_EQ(values.count("001.condition"), 0);
+  values.clear();
+  ASSERT_TRUE(dbfull()->GetMapProperty(
+      handles_[0], DB::Properties::kCFWriteStallTimeline, &values));
+  ASSERT_TRUE(values.empty());
+
+  sleeping_task->WakeUp();
+  sleeping_task->WaitUntilDone();
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable(handles_[1]));
+
+  values.clear();
+  ASSERT_TRUE(dbfull()->GetMapProperty(
+      handles_[1], DB::Properties::kCFWriteStallTimeline, &values));
+  ASSERT_NE(values["000.end-micros"], "0");
+  ASSERT_EQ(values.count("001.condition"), 0);
+  std::string timeline;
+  ASSERT_TRUE(dbfull()->GetProperty(
+      handles_[1], DB::Properties::kCFWriteStallTimeline, &timeline));
+  ASSERT_NE(timeline.find("cause: memtable-limit"), std::string::npos);
+
+  std::vector<WriteStallDetailInfo> details = listener->GetDetails();
+  ASSERT_EQ(details.size(), 2);
+  ASSERT_EQ(details[0].cf_name, "heavy_write_cf");
+  ASSERT_EQ(details[0].condition, WriteStallCondition::kStopped);
+  ASSERT_EQ(details[0].cause, WriteStallCause::kMemtableLimit);
+  ASSERT_EQ(details[0].end_micros, 0);
+  ASSERT_EQ(details[1].start_micros, details[0].start_micros);
+  ASSERT_GE(details[1].end_micros, details[1].start_micros);
+  ASSERT_EQ(std::to_string(details[1].end_micros), values["000.end-micros"]);
+}
+
 namespace {
 std::string PopMetaIndexKey(InternalIterator* meta_iter) {
   Status s = meta_iter->status();
@@ -3769,6 +3769,117 @@ TEST_F(DBRangeDelTest, RefreshWithSnapshot) {
   iter.reset();
   db_->ReleaseSnapshot(snapshot);
 }
+
+TEST_F(DBRangeDelTest, DropFilesCoveredByRangeDeletions) {
+  Options options = CurrentOptions();
+  options.drop_files_covered_by_range_deletions = true;
+  options.level_compaction_dynamic_level_bytes = false;
+  options.num_levels = 3;
+  DestroyAndReopen(options);
+
+  int num_dropped = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        auto* c = static_cast<Compaction*>(arg);
+        ASSERT_EQ(c->compaction_reason(),
+                  CompactionReason::kRangeDeletionCoveredFiles);
+        ASSERT_TRUE(c->deletion_compaction());
+        num_dropped += static_cast<int>(c->num_input_files(0));
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Two files in L2, the first covered by the range deletion below
+  for (int i = 0; i < 20; i += 10) {
+    for (int j = i; j < i + 10; j++) {
+      ASSERT_OK(Put(Key(j), "val"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(2);
+  }
+  ASSERT_EQ(2, NumTableFilesAtLevel(2));
+
+  // The snapshot keeps the covered file
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(15)));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  ASSERT_EQ(2, NumTableFilesAtLevel(2));
+  ASSERT_EQ(0, num_dropped);
+  ReadOptions read_opts;
+  read_opts.snapshot = snapshot;
+  std::string value;
+  ASSERT_OK(db_->Get(read_opts, Key(5), &value));
+  ASSERT_EQ("val", value);
+
+  // Releasing it drops the file without compacting it
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(1, num_dropped);
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  ASSERT_EQ(1, NumTableFilesAtLevel(2));
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(i < 15 ? "NOT_FOUND" : "val", Get(Key(i)));
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBRangeDelTest, IteratorSkipsCoveredBlocksAndFiles) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.index_type =
+      BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey;
+  table_options.block_size = 1;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Three files in L1 with the even keys in [0, 60), a block per key
+  for (int i = 0; i < 60; i += 20) {
+    for (int j = i; j < i + 20; j += 2) {
+      ASSERT_OK(Put(Key(j), "val"));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+  }
+  ASSERT_EQ(3, NumTableFilesAtLevel(1));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(9), Key(51)));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+
+  int num_skipped_blocks = 0;
+  int num_skipped_files = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableIterator:SkipCoveredBlock",
+      [&](void*) { num_skipped_blocks++; });
+  SyncPoint::GetInstance()->SetCallBack("LevelIterator:SkipCoveredFile",
+                                        [&](void*) { num_skipped_files++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<std::string> keys;
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    keys.push_back(iter->key().ToString());
+  }
+  ASSERT_OK(iter->status());
+  std::vector<std::string> expected_keys;
+  for (int i : {0, 2, 4, 6, 8, 52, 54, 56, 58}) {
+    expected_keys.push_back(Key(i));
+  }
+  ASSERT_EQ(expected_keys, keys);
+  // The blocks of the first file after Key(9), and the second file, are not
+  // read. The third file is read up to its first key, which is then skipped
+  // by seeking past the range tombstone.
+  ASSERT_EQ(5, num_skipped_blocks);
+  ASSERT_EQ(1, num_skipped_files);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -615,6 +615,61 @@ TEST_F(DBSecondaryTest, OpenAsSecondaryWALTailing) {
   verify_db_func("new_foo_value_1", "new_bar_value");
 }
 
+TEST_F(DBSecondaryTest, CatchUpInBackground) {
+  Options options;
+  options.env = env_;
+  Reopen(options);
+  ASSERT_OK(Put("foo", "foo_value0"));
+
+  std::atomic<int> num_catch_ups{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImplSecondary::TailPrimary:AfterCatchUp",
+      [&](void* /*arg*/) { num_catch_ups++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Options options1;
+  options1.env = env_;
+  options1.max_open_files = -1;
+  options1.secondary_catch_up_interval_ms = 1;
+  OpenSecondary(options1);
+
+  // A catch-up may be in progress when the primary writes, so wait for the
+  // one after it
+  const auto wait_for_catch_ups = [&]() {
+    const int target = num_catch_ups.load() + 2;
+    while (num_catch_ups.load() < target) {
+      env_->SleepForMicroseconds(1000);
+    }
+  };
+
+  std::string value;
+  ASSERT_OK(db_secondary_->Get(ReadOptions(), "foo", &value));
+  ASSERT_EQ("foo_value0", value);
+
+  // Catch up with the WAL
+  ASSERT_OK(Put("foo", "foo_value1"));
+  wait_for_catch_ups();
+  ASSERT_OK(db_secondary_->Get(ReadOptions(), "foo", &value));
+  ASSERT_EQ("foo_value1", value);
+
+  // Catch up with the MANIFEST
+  ASSERT_OK(Put("bar", "bar_value"));
+  ASSERT_OK(Flush());
+  wait_for_catch_ups();
+  ASSERT_OK(db_secondary_->Get(ReadOptions(), "bar", &value));
+  ASSERT_EQ("bar_value", value);
+
+  // The application can still catch up itself
+  ASSERT_OK(db_secondary_->TryCatchUpWithPrimary());
+
+  CloseSecondary();
+  const int num_catch_ups_at_close = num_catch_ups.load();
+  env_->SleepForMicroseconds(10000);
+  ASSERT_EQ(num_catch_ups_at_close, num_catch_ups.load());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBSecondaryTest, SecondaryTailingBug_ISSUE_8467) {
   Options options;
   options.env = env_;
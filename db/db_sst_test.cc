@@ -1059,6 +1059,46 @@ TEST_F(DBSSTTest, DeleteSchedulerMultipleDBPaths) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+// With a full first db_path, compaction output goes to the other one
+TEST_F(DBSSTTest, CompactionOutputToPathWithRoom) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.db_paths.emplace_back(dbname_, 1024 * 1024 * 1024);
+  options.db_paths.emplace_back(dbname_ + "_2", 1024 * 1024 * 1024);
+  options.sst_file_manager.reset(NewSstFileManager(env_));
+  auto sfm = static_cast<SstFileManagerImpl*>(options.sst_file_manager.get());
+  DestroyAndReopen(options);
+
+  const std::string full_path = dbname_;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "SstFileManagerImpl::PickCompactionOutputPath:FreeSpace",
+      [&](void* arg) {
+        auto path_and_free_space =
+            static_cast<std::pair<const std::string*, uint64_t*>*>(arg);
+        *path_and_free_space->second =
+            *path_and_free_space->first == full_path ? 0 : 1024 * 1024 * 1024;
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 4; i++) {
+    ASSERT_OK(Put("Key" + std::to_string(i), DummyString(1024, 'A')));
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("4", FilesPerLevel(0));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel(0));
+  std::vector<LiveFileMetaData> metadata;
+  db_->GetLiveFilesMetaData(&metadata);
+  ASSERT_EQ(1, metadata.size());
+  ASSERT_EQ(dbname_ + "_2", metadata[0].db_path);
+  ASSERT_EQ(0, sfm->GetCompactionsReservedSize(dbname_));
+  ASSERT_EQ(0, sfm->GetCompactionsReservedSize(dbname_ + "_2"));
+
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(DBSSTTest, DestroyDBWithRateLimitedDelete) {
   int bg_delete_file = 0;
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
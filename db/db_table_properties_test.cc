@@ -483,6 +483,114 @@ TEST_F(DBTablePropertiesTest, FactoryReturnsNull) {
   }
 }
 
+TEST_F(DBTablePropertiesTest, BlockPropertyFilter) {
+  // Records the smallest and largest first byte of the values in each block
+  struct MinMaxBlockPropertiesCollector : public TablePropertiesCollector {
+    const char* Name() const override {
+      return "MinMaxBlockPropertiesCollector";
+    }
+    Status AddUserKey(const Slice& /*key*/, const Slice& value,
+                      EntryType type, SequenceNumber /*seq*/,
+                      uint64_t /*file_size*/) override {
+      if (type == kEntryPut && !value.empty()) {
+        if (block_min_max_.empty()) {
+          block_min_max_.assign(2, value[0]);
+        }
+        block_min_max_[0] = std::min(block_min_max_[0], value[0]);
+        block_min_max_[1] = std::max(block_min_max_[1], value[0]);
+      }
+      return Status::OK();
+    }
+    void FinishDataBlock(std::string* block_property) override {
+      block_property->swap(block_min_max_);
+      block_min_max_.clear();
+    }
+    Status Finish(UserCollectedProperties* /*properties*/) override {
+      return Status::OK();
+    }
+    UserCollectedProperties GetReadableProperties() const override {
+      return {};
+    }
+
+    std::string block_min_max_;
+  };
+  struct MinMaxBlockPropertiesCollectorFactory
+      : public TablePropertiesCollectorFactory {
+    const char* Name() const override {
+      return "MinMaxBlockPropertiesCollectorFactory";
+    }
+    TablePropertiesCollector* CreateTablePropertiesCollector(
+        TablePropertiesCollectorFactory::Context /*context*/) override {
+      return new MinMaxBlockPropertiesCollector();
+    }
+  };
+
+  Options options = CurrentOptions();
+  options.table_properties_collector_factories.emplace_back(
+      std::make_shared<MinMaxBlockPropertiesCollectorFactory>());
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Values of 10 keys in a row start with the same letter
+  constexpr int kNumKeys = 260;
+  Random rnd(301);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), std::string(1, static_cast<char>('a' + i / 10)) +
+                              rnd.RandomString(100)));
+  }
+  ASSERT_OK(Flush());
+
+  ReadOptions read_options;
+  read_options.block_property_filter = [](const Slice& collector_name,
+                                          const Slice& block_property) {
+    EXPECT_EQ("MinMaxBlockPropertiesCollector", collector_name.ToString());
+    EXPECT_EQ(2, block_property.size());
+    return block_property[0] <= 'c' && 'c' <= block_property[1];
+  };
+  SetPerfLevel(kEnableCount);
+  for (bool forward : {true, false}) {
+    SCOPED_TRACE("forward=" + std::to_string(forward));
+    get_perf_context()->Reset();
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    int num_keys = 0;
+    int num_c_keys = 0;
+    if (forward) {
+      iter->SeekToFirst();
+    } else {
+      iter->SeekToLast();
+    }
+    for (; iter->Valid(); forward ? iter->Next() : iter->Prev()) {
+      num_keys++;
+      if (iter->value()[0] == 'c') {
+        num_c_keys++;
+      }
+    }
+    ASSERT_OK(iter->status());
+    // Only the blocks with 'c' values are read, in full
+    ASSERT_EQ(10, num_c_keys);
+    ASSERT_LT(num_keys, 30);
+    ASSERT_LT(get_perf_context()->block_read_count, 5);
+  }
+  SetPerfLevel(kDisable);
+
+  // Blocks without properties are never skipped
+  read_options.block_property_filter = [](const Slice&, const Slice&) {
+    return false;
+  };
+  ASSERT_OK(Put(Key(kNumKeys), ""));
+  ASSERT_OK(Flush());
+  std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+  iter->SeekToFirst();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(kNumKeys), iter->key());
+  iter->Next();
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+}
+
 class DBTableHostnamePropertyTest
     : public DBTestBase,
       public ::testing::WithParamInterface<std::tuple<int, std::string>> {
@@ -4798,6 +4798,52 @@ TEST_F(DBTest, ThreadStatusFlush) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBTest, ThreadStatusStageTimes) {
+  Options options;
+  options.env = env_;
+  options.enable_thread_tracking = true;
+  options = CurrentOptions(options);
+  Reopen(options);
+
+  // Make the flush spend some wall time writing its L0 file
+  constexpr uint64_t kSleepMicros = 10000;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "FlushJob::WriteLevel0Table", [&](void* /*arg*/) {
+        SystemClock::Default()->SleepForMicroseconds(kSleepMicros);
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(Flush());
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  uint64_t thread_write_l0_micros = 0;
+  std::vector<ThreadStatus> thread_list;
+  ASSERT_OK(env_->GetThreadList(&thread_list));
+  for (const auto& thread : thread_list) {
+    ASSERT_EQ(thread.stage_cpu_micros[ThreadStatus::STAGE_UNKNOWN], 0);
+    ASSERT_EQ(thread.stage_elapsed_micros[ThreadStatus::STAGE_UNKNOWN], 0);
+    thread_write_l0_micros +=
+        thread.stage_elapsed_micros[ThreadStatus::STAGE_FLUSH_WRITE_L0];
+    ASSERT_LE(thread.stage_cpu_micros[ThreadStatus::STAGE_FLUSH_WRITE_L0],
+              thread.stage_elapsed_micros[ThreadStatus::STAGE_FLUSH_WRITE_L0]);
+  }
+  ASSERT_GE(thread_write_l0_micros, kSleepMicros);
+
+  std::map<std::string, std::string> stage_times;
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kCFJobStageTimes, &stage_times));
+  ASSERT_GE(
+      std::stoull(stage_times["FlushJob::WriteLevel0Table.elapsed-micros"]),
+      kSleepMicros);
+  ASSERT_EQ(stage_times.count("FlushJob::WriteLevel0Table.cpu-micros"), 1);
+  ASSERT_EQ(stage_times.count("FlushJob::Run.elapsed-micros"), 1);
+  std::string value;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kCFJobStageTimes, &value));
+  ASSERT_NE(value.find("FlushJob::WriteLevel0Table: cpu-micros: "),
+            std::string::npos);
+}
+
 TEST_P(DBTestWithParam, ThreadStatusSingleCompaction) {
   const int kTestKeySize = 16;
   const int kTestValueSize = 984;
@@ -18,11 +18,13 @@
 #include "options/options_helper.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
+#include "rocksdb/compressor.h"
 #include "rocksdb/experimental.h"
 #include "rocksdb/iostats_context.h"
 #include "rocksdb/persistent_cache.h"
 #include "rocksdb/trace_record.h"
 #include "rocksdb/trace_record_result.h"
+#include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/replayer.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/mock_time_env.h"
@@ -4573,6 +4575,11 @@ TEST_F(DBTest2, TraceAndReplay) {
   ASSERT_EQ(res_handler.GetNumIterSeeks(), 2);
   ASSERT_EQ(res_handler.GetNumMultiGets(), 0);
   res_handler.Reset();
+  ReplayTimingStats timing_stats;
+  ASSERT_OK(replayer->GetTimingStats(&timing_stats));
+  ASSERT_EQ(timing_stats.num_traces, 13U);
+  ASSERT_GE(static_cast<double>(timing_stats.max_lag_micros),
+            timing_stats.average_lag_micros);
 
   // Re-replay using 2 threads, 1/2 speed.
   ASSERT_OK(replayer->Prepare());
@@ -5008,6 +5015,58 @@ TEST_F(DBTest2, TraceWithLimit) {
   ASSERT_OK(DestroyDB(dbname2, options));
 }
 
+TEST_F(DBTest2, TraceReplayWriteError) {
+  Options options = CurrentOptions();
+  TraceOptions trace_opts;
+  EnvOptions env_opts;
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  std::string trace_filename = dbname_ + "/rocksdb.trace_error";
+  std::unique_ptr<TraceWriter> trace_writer;
+  ASSERT_OK(NewFileTraceWriter(env_, env_opts, trace_filename, &trace_writer));
+  ASSERT_OK(db_->StartTrace(trace_opts, std::move(trace_writer)));
+  ASSERT_OK(Put(0, "a", "1"));
+  ASSERT_OK(Put(1, "b", "1"));
+  ASSERT_OK(Put(0, "c", "1"));
+  ASSERT_OK(db_->EndTrace());
+
+  // The write to "pikachu" fails against a DB without it
+  std::string dbname2 = test::PerThreadDBPath(env_, "/db_replay_error");
+  ASSERT_OK(DestroyDB(dbname2, options));
+  options.create_if_missing = true;
+  DB* db2 = nullptr;
+  ASSERT_OK(DB::Open(options, dbname2, &db2));
+  std::vector<ColumnFamilyHandle*> handles = {db2->DefaultColumnFamily()};
+
+  std::unique_ptr<TraceReader> trace_reader;
+  ASSERT_OK(NewFileTraceReader(env_, env_opts, trace_filename, &trace_reader));
+  std::unique_ptr<Replayer> replayer;
+  ASSERT_OK(
+      db2->NewDefaultReplayer(handles, std::move(trace_reader), &replayer));
+  for (uint32_t num_threads : {1, 2}) {
+    ASSERT_OK(replayer->Prepare());
+    ASSERT_TRUE(replayer->Replay(ReplayOptions(num_threads, 1.0), nullptr)
+                    .IsInvalidArgument());
+
+    std::atomic<int> num_errors{0};
+    auto res_cb = [&](Status exec_s, std::unique_ptr<TraceRecordResult>&&) {
+      if (!exec_s.ok()) {
+        num_errors++;
+      }
+    };
+    ASSERT_OK(replayer->Prepare());
+    ASSERT_TRUE(replayer->Replay(ReplayOptions(num_threads, 1.0), res_cb)
+                    .IsInvalidArgument());
+    ASSERT_EQ(1, num_errors);
+  }
+  replayer.reset();
+
+  std::string value;
+  ASSERT_OK(db2->Get(ReadOptions(), "a", &value));
+  delete db2;
+  ASSERT_OK(DestroyDB(dbname2, options));
+}
+
 TEST_F(DBTest2, TraceWithSampling) {
   Options options = CurrentOptions();
   ReadOptions ro;
@@ -5755,6 +5814,60 @@ TEST_F(DBTest2, RowCacheSnapshot) {
   db_->ReleaseSnapshot(s3);
 }
 
+TEST_F(DBTest2, RowCacheByUserKey) {
+  Options options = CurrentOptions();
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.row_cache = NewLRUCache(8 * 8192);
+  options.row_cache_by_user_key = true;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  auto check = [&](const std::string& key, const std::string& expected,
+                   uint64_t hits, uint64_t misses) {
+    ASSERT_EQ(Get(key), expected);
+    ASSERT_EQ(TestGetTickerCount(options, ROW_CACHE_HIT), hits);
+    ASSERT_EQ(TestGetTickerCount(options, ROW_CACHE_MISS), misses);
+  };
+
+  ASSERT_OK(Put("bar", "v0"));
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(Flush());
+  check("foo", "v1", 0, 1);
+  check("foo", "v1", 1, 1);
+
+  // Rewriting the file keeps the cached value
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  check("foo", "v1", 2, 1);
+
+  // Reads of the memtables don't look into the row cache
+  ASSERT_OK(Put("foo", "v2"));
+  check("foo", "v2", 2, 1);
+  // A flushed newer entry invalidates the cached value
+  ASSERT_OK(Flush());
+  check("foo", "v2", 2, 2);
+  check("foo", "v2", 3, 2);
+  // So does a newer file overlapping the key
+  ASSERT_OK(Put("baz", "v0"));
+  ASSERT_OK(Put("goo", "v0"));
+  ASSERT_OK(Flush());
+  check("foo", "v2", 3, 3);
+  check("foo", "v2", 4, 3);
+
+  // A compaction dropping the key entirely doesn't bring back its value
+  ASSERT_OK(Delete("foo"));
+  ASSERT_OK(Flush());
+  check("foo", "NOT_FOUND", 4, 4);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  check("foo", "NOT_FOUND", 4, 5);
+
+  // Neither do deleted files
+  check("bar", "v0", 4, 6);
+  check("bar", "v0", 5, 6);
+  ASSERT_OK(DeleteFilesInRange(db_, db_->DefaultColumnFamily(), nullptr,
+                               nullptr));
+  check("bar", "NOT_FOUND", 5, 7);
+}
+
 // When DB is reopened with multiple column families, the manifest file
 // is written after the first CF is flushed, and it is written again
 // after each flush. If DB crashes between the flushes, the flushed CF
@@ -7857,6 +7970,225 @@ TEST_F(DBTest2, ZSTDChecksum) {
 }
 #endif
 
+TEST_F(DBTest2, AdaptiveBlockCompression) {
+  if (!ZSTD_Supported() || !LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("Test requires ZSTD and LZ4 support");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.compression = kZSTD;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  // Number of blocks written with each compression type
+  std::map<CompressionType, int> num_blocks;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::WriteMaybeCompressedBlock:TamperWithChecksum",
+      [&](void* arg) {
+        num_blocks[static_cast<CompressionType>(static_cast<char*>(arg)[0])]++;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const auto write_and_verify = [&](uint32_t tolerance_pct,
+                                    double compressible_to) {
+    options.compression_opts.adaptive_tolerance_pct = tolerance_pct;
+    DestroyAndReopen(options);
+    num_blocks.clear();
+    std::vector<std::string> values;
+    for (int i = 0; i < 200; ++i) {
+      std::string value;
+      test::CompressibleString(&rnd, compressible_to, 500, &value);
+      values.push_back(value);
+      ASSERT_OK(Put(Key(i), value));
+    }
+    ASSERT_OK(Flush());
+    for (int i = 0; i < 200; ++i) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  };
+
+  // Without adaptive compression, data blocks are compressed with ZSTD only
+  write_and_verify(0, 0.25);
+  ASSERT_GT(num_blocks[kZSTD], 50);
+  ASSERT_EQ(num_blocks[kLZ4Compression], 0);
+
+  // LZ4 is about as good as ZSTD on this data and cheaper to decompress
+  write_and_verify(50, 0.25);
+  ASSERT_GT(num_blocks[kLZ4Compression], 50);
+
+  // With a large enough tolerance, nothing is worth compressing
+  write_and_verify(1000, 0.25);
+  ASSERT_GT(num_blocks[kNoCompression], 50);
+  ASSERT_EQ(num_blocks[kLZ4Compression], 0);
+
+  // Data that does not compress is stored as is
+  write_and_verify(10, 1.0);
+  ASSERT_GT(num_blocks[kNoCompression], 50);
+  ASSERT_EQ(num_blocks[kLZ4Compression], 0);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+namespace {
+// Compresses with the built-in library, as an accelerator would in its format
+class TestCompressor : public Compressor {
+ public:
+  explicit TestCompressor(CompressionType type) : type_(type) {}
+
+  static const char* kClassName() { return "TestCompressor"; }
+  const char* Name() const override { return kClassName(); }
+
+  CompressionType GetCompressionType() const override { return type_; }
+
+  Status Compress(const CompressionOptions& opts, const Slice& input,
+                  std::string* output) override {
+    num_calls_++;
+    if (fail_) {
+      return Status::Busy("Accelerator unavailable");
+    }
+    CompressionContext context(type_, opts);
+    CompressionInfo info(opts, context, CompressionDict::GetEmptyDict(), type_,
+                         0 /* sample_for_compression */);
+    std::string compressed;
+    if (!CompressData(input, info, 2 /* compress_format_version */,
+                      &compressed)) {
+      return Status::NotSupported();
+    }
+    // Drop the uncompressed size, which RocksDB writes itself
+    Slice data(compressed);
+    uint32_t size = 0;
+    if (!GetVarint32(&data, &size) || size != input.size()) {
+      return Status::Corruption("Bad uncompressed size");
+    }
+    output->append(data.data(), data.size());
+    return Status::OK();
+  }
+
+  std::atomic<int> num_calls_{0};
+  std::atomic<bool> fail_{false};
+
+ private:
+  const CompressionType type_;
+};
+}  // namespace
+
+TEST_F(DBTest2, PluggableCompressor) {
+  if (!ZSTD_Supported()) {
+    ROCKSDB_GTEST_SKIP("Test requires ZSTD support");
+    return;
+  }
+  ConfigOptions config_options;
+  config_options.registry = ObjectRegistry::NewInstance();
+  config_options.registry->AddLibrary("test")->AddFactory<Compressor>(
+      TestCompressor::kClassName(),
+      [](const std::string& /*uri*/, std::unique_ptr<Compressor>* guard,
+         std::string* /*errmsg*/) {
+        guard->reset(new TestCompressor(kZSTD));
+        return guard->get();
+      });
+  BlockBasedTableOptions table_options;
+  ASSERT_OK(GetBlockBasedTableOptionsFromString(
+      config_options, BlockBasedTableOptions(),
+      "block_size=1024;verify_compression=true;compressor=TestCompressor",
+      &table_options));
+  ASSERT_NE(table_options.compressor, nullptr);
+  auto* compressor =
+      static_cast<TestCompressor*>(table_options.compressor.get());
+
+  Options options = CurrentOptions();
+  options.compression = kZSTD;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  // Number of blocks written with each compression type
+  std::map<CompressionType, int> num_blocks;
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::WriteMaybeCompressedBlock:TamperWithChecksum",
+      [&](void* arg) {
+        num_blocks[static_cast<CompressionType>(static_cast<char*>(arg)[0])]++;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const auto write_and_verify = [&]() {
+    DestroyAndReopen(options);
+    num_blocks.clear();
+    compressor->num_calls_ = 0;
+    std::vector<std::string> values;
+    for (int i = 0; i < 200; ++i) {
+      std::string value;
+      test::CompressibleString(&rnd, 0.25, 500, &value);
+      values.push_back(value);
+      ASSERT_OK(Put(Key(i), value));
+    }
+    ASSERT_OK(Flush());
+    for (int i = 0; i < 200; ++i) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  };
+
+  // The blocks are compressed by the compressor, in the format of ZSTD
+  write_and_verify();
+  ASSERT_GT(compressor->num_calls_, 50);
+  ASSERT_GT(num_blocks[kZSTD], 50);
+
+  // When the compressor fails, the built-in library compresses the blocks
+  compressor->fail_ = true;
+  write_and_verify();
+  ASSERT_GT(compressor->num_calls_, 50);
+  ASSERT_GT(num_blocks[kZSTD], 50);
+
+  // The compressor is not used for other compression types
+  compressor->fail_ = false;
+  if (Snappy_Supported()) {
+    options.compression = kSnappyCompression;
+    write_and_verify();
+    ASSERT_EQ(compressor->num_calls_, 0);
+    ASSERT_GT(num_blocks[kSnappyCompression], 50);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBTest2, SuperVersionAcquireWithoutDBMutex) {
+  Options options = CurrentOptions();
+  DestroyAndReopen(options);
+  ASSERT_OK(Put("a", "v1"));
+  // Caches the SuperVersion in this thread
+  ASSERT_EQ("v1", Get("a"));
+
+  std::atomic<int> locked_acquires{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "ColumnFamilyData::GetThreadLocalSuperVersion:Locked",
+      [&](void* /*arg*/) { locked_acquires++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 3; ++i) {
+    // Installs a new SuperVersion, making the cached one obsolete
+    ASSERT_OK(Put("a", "v" + std::to_string(i + 2)));
+    ASSERT_OK(Flush());
+    ASSERT_EQ("v" + std::to_string(i + 2), Get("a"));
+  }
+  // Also while another thread holds the DB mutex
+  ASSERT_OK(Put("b", "v1"));
+  ASSERT_OK(Flush());
+  dbfull()->TEST_LockMutex();
+  std::string value;
+  port::Thread reader([&]() {
+    ASSERT_OK(db_->Get(ReadOptions(), "b", &value));
+  });
+  reader.join();
+  dbfull()->TEST_UnlockMutex();
+  ASSERT_EQ("v1", value);
+  ASSERT_EQ(0, locked_acquires.load());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
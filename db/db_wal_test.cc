@@ -15,6 +15,7 @@
 #include "rocksdb/file_system.h"
 #include "test_util/sync_point.h"
 #include "util/udt_util.h"
+#include "util/xxhash.h"
 #include "utilities/fault_injection_env.h"
 #include "utilities/fault_injection_fs.h"
 
@@ -210,6 +211,43 @@ TEST_F(DBWALTest, WAL) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, WALCompressedByWriters) {
+  if (!StreamingCompressionTypeSupported(kZSTD)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.wal_compression = kZSTD;
+  DestroyAndReopen(options);
+
+  // Concurrent writes to be grouped, with records past the WAL termination
+  // point of their batch, which are not to be recovered
+  constexpr int kNumThreads = 4;
+  constexpr int kNumWrites = 100;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kNumWrites; i++) {
+        const int k = t * kNumWrites + i;
+        WriteBatch batch;
+        ASSERT_OK(batch.Put(Key(k), "v" + std::to_string(k)));
+        batch.MarkWalTerminationPoint();
+        ASSERT_OK(batch.Put("unlogged" + Key(k), "v"));
+        ASSERT_OK(db_->Write(WriteOptions(), &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  Reopen(options);
+  for (int k = 0; k < kNumThreads * kNumWrites; k++) {
+    ASSERT_EQ("v" + std::to_string(k), Get(Key(k)));
+    ASSERT_EQ("NOT_FOUND", Get("unlogged" + Key(k)));
+  }
+}
+
 TEST_F(DBWALTest, RollLog) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -1034,6 +1072,138 @@ TEST_F(DBWALTest, RecoveryWithEmptyLog) {
   } while (ChangeWalOptions());
 }
 
+TEST_F(DBWALTest, RecoverWithMultipleThreads) {
+  for (int recovery_threads : {2, 4}) {
+    Options options = CurrentOptions();
+    options.write_buffer_size = 4 << 20;
+    DestroyAndReopen(options);
+    CreateAndReopenWithCF({"pikachu"}, options);
+
+    // Keys are overwritten and deleted many times over so that replay has to
+    // keep the versions of each key in sequence order.
+    std::map<std::string, std::string> expected[2];
+    Random rnd(301);
+    for (int i = 0; i < 5000; ++i) {
+      const int cf = i % 2;
+      const std::string key = Key(rnd.Uniform(200));
+      if (rnd.OneIn(5)) {
+        ASSERT_OK(Delete(cf, key));
+        expected[cf].erase(key);
+      } else {
+        const std::string value = rnd.RandomString(100);
+        ASSERT_OK(Put(cf, key, value));
+        expected[cf][key] = value;
+      }
+    }
+
+    // A small write buffer makes replay flush memtables part-way through.
+    options.wal_recovery_threads = recovery_threads;
+    options.write_buffer_size = 64 << 10;
+    ReopenWithColumnFamilies({"default", "pikachu"}, options);
+    for (int cf = 0; cf < 2; ++cf) {
+      for (int k = 0; k < 200; ++k) {
+        const std::string key = Key(k);
+        auto it = expected[cf].find(key);
+        ASSERT_EQ(it == expected[cf].end() ? "NOT_FOUND" : it->second,
+                  Get(cf, key));
+      }
+    }
+  }
+}
+
+TEST_F(DBWALTest, MultiThreadedRecoveryInsertFailure) {
+  // The 101st batch of the WAL fails to insert. Replaying it with batches
+  // inserted concurrently, some of which come after the failed one, must
+  // end up where replaying it on one thread does, in every recovery mode.
+  for (auto mode : {WALRecoveryMode::kTolerateCorruptedTailRecords,
+                    WALRecoveryMode::kAbsoluteConsistency,
+                    WALRecoveryMode::kPointInTimeRecovery,
+                    WALRecoveryMode::kSkipAnyCorruptedRecords}) {
+    std::string results[2];
+    for (int i = 0; i < 2; ++i) {
+      Options options = CurrentOptions();
+      options.allow_concurrent_memtable_write = true;
+      DestroyAndReopen(options);
+      for (int k = 0; k < 200; ++k) {
+        ASSERT_OK(Put(Key(k), "v" + std::to_string(k)));
+      }
+      Close();
+
+      // Replaces the batch with a range deletion whose end comes before
+      // its start, which the memtable inserter rejects
+      int records = 0;
+      WriteBatch* replaced = nullptr;
+      SyncPoint::GetInstance()->SetCallBack(
+          "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:batch",
+          [&](void* arg) {
+            if (records++ != 100) {
+              return;
+            }
+            auto batch = static_cast<WriteBatch*>(arg);
+            WriteBatch bad;
+            ASSERT_OK(bad.DeleteRange(Key(9), Key(0)));
+            WriteBatchInternal::SetSequence(
+                &bad, WriteBatchInternal::Sequence(batch));
+            ASSERT_OK(WriteBatchInternal::SetContents(
+                batch, WriteBatchInternal::Contents(&bad)));
+            replaced = batch;
+          });
+      SyncPoint::GetInstance()->SetCallBack(
+          "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:checksum",
+          [&](void* arg) {
+            if (replaced != nullptr) {
+              *static_cast<uint64_t*>(arg) =
+                  XXH3_64bits(replaced->Data().data(), replaced->GetDataSize());
+              replaced = nullptr;
+            }
+          });
+      SyncPoint::GetInstance()->EnableProcessing();
+      options.wal_recovery_mode = mode;
+      options.wal_recovery_threads = i == 0 ? 1 : 4;
+      Status s = TryReopen(options);
+      SyncPoint::GetInstance()->DisableProcessing();
+      SyncPoint::GetInstance()->ClearAllCallBacks();
+      ASSERT_GT(records, 100);
+
+      results[i] = s.ToString();
+      if (s.ok()) {
+        results[i] +=
+            " seq=" + std::to_string(db_->GetLatestSequenceNumber());
+        for (int k = 0; k < 200; ++k) {
+          results[i] += " " + Get(Key(k));
+        }
+      }
+    }
+    ASSERT_EQ(results[0], results[1]) << static_cast<int>(mode);
+  }
+}
+
+TEST_F(DBWALTest, MaxAliveWalFiles) {
+  Options options = CurrentOptions();
+  options.max_alive_wal_files = 3;
+  DestroyAndReopen(options);
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  // A single write to "pikachu" pins the oldest WAL while the default column
+  // family keeps rolling over to new ones.
+  ASSERT_OK(Put(1, "cold", "v1"));
+  for (int i = 0; i <= 3; ++i) {
+    ASSERT_EQ(0, NumTableFilesAtLevel(0, 1));
+    ASSERT_OK(Put(0, "hot" + std::to_string(i), "v1"));
+    ASSERT_OK(Flush(0));
+  }
+  // The next write notices that too many WAL files are alive and flushes the
+  // column family that holds the oldest one.
+  ASSERT_OK(Put(0, "hot", "v2"));
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable(handles_[1]));
+  ASSERT_EQ(1, NumTableFilesAtLevel(0, 1));
+  ASSERT_EQ("v1", Get(1, "cold"));
+
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  ASSERT_EQ("v1", Get(1, "cold"));
+  ASSERT_EQ("v2", Get(0, "hot"));
+}
+
 #if !(defined NDEBUG) || !defined(OS_WIN)
 TEST_F(DBWALTest, PreallocateBlock) {
   Options options = CurrentOptions();
@@ -4599,6 +4599,67 @@ TEST_F(DBBasicTestWithTimestamp, TimestampFilterTableReadOnGet) {
   Close();
 }
 
+TEST_F(DBBasicTestWithTimestamp, TimestampFilterTableReadOnIterator) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  const size_t kTimestampSize = Timestamp(0, 0).size();
+  TestComparator test_cmp(kTimestampSize);
+  options.comparator = &test_cmp;
+  DestroyAndReopen(options);
+
+  // file1: key => [1, 3], timestamp => [10, 20]
+  // file2, key => [2, 4], timestamp => [30, 40]
+  WriteOptions write_opts;
+  ASSERT_OK(db_->Put(write_opts, Key1(1), Timestamp(10, 0), "value1"));
+  ASSERT_OK(db_->Put(write_opts, Key1(3), Timestamp(20, 0), "value3"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->Put(write_opts, Key1(2), Timestamp(30, 0), "value2"));
+  ASSERT_OK(db_->Put(write_opts, Key1(4), Timestamp(40, 0), "value4"));
+  ASSERT_OK(Flush());
+
+  auto check = [&](const std::string& read_ts, const std::string* start_ts,
+                   const std::vector<std::string>& expected_keys) {
+    Slice read_ts_slice = read_ts;
+    Slice start_ts_slice;
+    ReadOptions read_opts;
+    read_opts.timestamp = &read_ts_slice;
+    if (start_ts != nullptr) {
+      start_ts_slice = *start_ts;
+      read_opts.iter_start_ts = &start_ts_slice;
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_opts));
+    std::vector<std::string> keys;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      // With iter_start_ts, the keys are internal keys with timestamps
+      Slice key = start_ts == nullptr ? iter->key()
+                                      : ExtractUserKeyAndStripTimestamp(
+                                            iter->key(), kTimestampSize);
+      keys.push_back(key.ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(expected_keys, keys);
+  };
+
+  // file2 is skipped, because 25 < [30, 40]
+  auto prev_filtered_events = options.statistics->getTickerCount(
+      Tickers::TIMESTAMP_FILTER_TABLE_FILTERED);
+  check(Timestamp(25, 0), nullptr, {Key1(1), Key1(3)});
+  ASSERT_EQ(prev_filtered_events + 1,
+            options.statistics->getTickerCount(
+                Tickers::TIMESTAMP_FILTER_TABLE_FILTERED));
+
+  // file1 is skipped, because [10, 20] < 25, the start of the history read
+  const std::string start_ts = Timestamp(25, 0);
+  check(Timestamp(50, 0), &start_ts, {Key1(2), Key1(4)});
+  ASSERT_EQ(prev_filtered_events + 2,
+            options.statistics->getTickerCount(
+                Tickers::TIMESTAMP_FILTER_TABLE_FILTERED));
+
+  Close();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -1293,6 +1293,61 @@ TEST_P(DBWriteBufferManagerTest, BackgroundWorkPaused) {
   }
 }
 
+TEST_P(DBWriteBufferManagerTest, CostAwareFlushPolicy) {
+  auto policy = NewCostAwareWriteBufferFlushPolicy(/*wal_weight=*/0.5,
+                                                   /*age_horizon_seconds=*/100);
+  WriteBufferFlushCandidate base;
+  base.memtable_bytes = 1000;
+  base.level0_file_num_compaction_trigger = 4;
+
+  WriteBufferFlushCandidate c = base;
+  ASSERT_DOUBLE_EQ(1000, policy->Score(c));
+  c.wal_bytes_pinned = 1000;
+  ASSERT_DOUBLE_EQ(1500, policy->Score(c));
+  c = base;
+  c.memtable_age_seconds = 50;
+  ASSERT_DOUBLE_EQ(1500, policy->Score(c));
+  // Age counts for at most twice the size
+  c.memtable_age_seconds = 1000;
+  ASSERT_DOUBLE_EQ(2000, policy->Score(c));
+  c = base;
+  c.num_level0_files = 4;
+  ASSERT_DOUBLE_EQ(500, policy->Score(c));
+}
+
+TEST_P(DBWriteBufferManagerTest, FlushPolicyPrefersPinnedWal) {
+  Options options = CurrentOptions();
+  options.write_buffer_size = 500000;  // this is never hit
+  cost_cache_ = GetParam();
+  std::shared_ptr<Cache> cache = NewLRUCache(4 * 1024 * 1024, 2);
+  options.write_buffer_manager.reset(new WriteBufferManager(
+      100000, cost_cache_ ? cache : nullptr, 0.0));
+  options.write_buffer_manager->SetFlushPolicy(
+      NewCostAwareWriteBufferFlushPolicy(/*wal_weight=*/1000));
+  CreateAndReopenWithCF({"cf1"}, options);
+
+  // "cf1" is the only column family left in the first WAL once "default"
+  // is flushed.
+  ASSERT_OK(Put(1, Key(1), DummyString(1000)));
+  ASSERT_OK(Put(0, Key(1), DummyString(1000)));
+  ASSERT_OK(Flush(0));
+  ASSERT_GT(dbfull()->GetApproximateWalBytesPinnedByMemTables(handles_[1]),
+            1000);
+  ASSERT_EQ(dbfull()->GetApproximateWalBytesPinnedByMemTables(handles_[0]),
+            0);
+
+  // "default" has by far the largest memtable, but flushing "cf1" frees
+  // the first WAL.
+  ASSERT_OK(Put(0, Key(2), DummyString(60000)));
+  ASSERT_OK(Put(0, Key(3), DummyString(50000)));
+  ASSERT_OK(Put(0, Key(4), DummyString(1)));
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable(handles_[1]));
+  ASSERT_EQ("1", FilesPerLevel(1));
+  ASSERT_EQ("1", FilesPerLevel(0));
+  ASSERT_EQ(dbfull()->GetApproximateWalBytesPinnedByMemTables(handles_[1]),
+            0);
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteBufferManagerTest, DBWriteBufferManagerTest,
                         testing::Bool());
 
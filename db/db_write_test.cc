@@ -15,6 +15,7 @@
 #include "db/write_thread.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
+#include "rocksdb/perf_context.h"
 #include "test_util/sync_point.h"
 #include "util/random.h"
 #include "util/string_util.h"
@@ -469,6 +470,145 @@ TEST_F(DBWriteTestUnparameterized, PipelinedWriteRace) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
 }
 
+TEST_F(DBWriteTestUnparameterized, PipelinedWalSync) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_SKIP("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+  Options options = CurrentOptions();
+  std::shared_ptr<FaultInjectionTestFS> fault_fs(
+      new FaultInjectionTestFS(FileSystem::Default()));
+  std::unique_ptr<Env> fault_fs_env(NewCompositeEnv(fault_fs));
+  options.env = fault_fs_env.get();
+  options.create_if_missing = true;
+  options.enable_pipelined_write = true;
+  options.enable_pipelined_wal_sync = true;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+
+  std::atomic<int> deferred_syncs{0};
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::PipelinedWriteImpl:AfterWALWrite", [&](void* arg) {
+        if (*static_cast<bool*>(arg)) {
+          deferred_syncs.fetch_add(1);
+        }
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumWrites = 50;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      WriteOptions wopts;
+      // Mix sync and non-sync writes so that some memtable groups have
+      // nothing to sync.
+      wopts.sync = (t % 2 == 0);
+      for (int i = 0; i < kNumWrites; i++) {
+        ASSERT_OK(dbfull()->Put(
+            wopts, "key_" + std::to_string(t) + "_" + std::to_string(i),
+            "value" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GT(deferred_syncs.load(), 0);
+  ASSERT_GT(options.statistics->getTickerCount(WAL_FILE_SYNCED), 0u);
+
+  // Simulate a crash: every write acknowledged with sync=true must survive
+  // the loss of the unsynced data.
+  fault_fs->SetFilesystemActive(false);
+  Close();
+  ASSERT_OK(fault_fs->DropUnsyncedFileData());
+  fault_fs->SetFilesystemActive(true);
+  Reopen(options);
+  for (int t = 0; t < kNumThreads; t += 2) {
+    for (int i = 0; i < kNumWrites; i++) {
+      ASSERT_EQ("value" + std::to_string(i),
+                Get("key_" + std::to_string(t) + "_" + std::to_string(i)));
+    }
+  }
+  Close();
+}
+
+TEST_F(DBWriteTestUnparameterized, UnorderedWriteFlushWaitsForWriters) {
+  Options options = CurrentOptions();
+  options.unordered_write = true;
+  Reopen(options);
+
+  // Hold the first writer between its WAL write and its memtable write until
+  // a flush is under way, which then has to wait for it.
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->LoadDependency(
+      {{"DBImpl::WriteImpl:BeforeUnorderedWriteMemtable",
+        "UnorderedWriteFlushWaitsForWriters:BeforeFlush"}});
+  std::atomic<bool> delayed{false};
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WriteImpl:BeforeUnorderedWriteMemtable", [&](void* /*arg*/) {
+        if (!delayed.exchange(true)) {
+          env_->SleepForMicroseconds(100000);
+        }
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumWrites = 200;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kNumWrites; i++) {
+        ASSERT_OK(Put("key_" + std::to_string(t) + "_" + std::to_string(i),
+                      "value" + std::to_string(i)));
+      }
+    });
+  }
+  TEST_SYNC_POINT("UnorderedWriteFlushWaitsForWriters:BeforeFlush");
+  ASSERT_OK(Flush());
+  for (auto& t : threads) {
+    t.join();
+  }
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // Once all writers returned, a flush leaves nothing in the memtable.
+  ASSERT_OK(Flush());
+  uint64_t num_entries = 0;
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kNumEntriesActiveMemTable,
+                                  &num_entries));
+  ASSERT_EQ(0u, num_entries);
+  for (int t = 0; t < kNumThreads; t++) {
+    for (int i = 0; i < kNumWrites; i++) {
+      ASSERT_EQ("value" + std::to_string(i),
+                Get("key_" + std::to_string(t) + "_" + std::to_string(i)));
+    }
+  }
+}
+
+TEST_F(DBWriteTestUnparameterized, PipelinedWriteStageTimes) {
+  Options options = CurrentOptions();
+  options.enable_pipelined_write = true;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+
+  SetPerfLevel(kEnableTimeExceptForMutex);
+  get_perf_context()->Reset();
+  ASSERT_OK(Put("foo", "bar"));
+  // A lone writer leads its WAL group and then waits to enter the memtable
+  // stage itself.
+  ASSERT_GT(get_perf_context()->write_memtable_queue_wait_nanos, 0u);
+  ASSERT_EQ(0u, get_perf_context()->write_commit_wait_nanos);
+  SetPerfLevel(kDisable);
+
+  HistogramData data;
+  options.statistics->histogramData(PIPELINED_WRITE_MEMTABLE_WAIT_MICROS,
+                                    &data);
+  ASSERT_EQ(1u, data.count);
+}
+
 TEST_P(DBWriteTest, ManualWalFlushInEffect) {
   Options options = GetOptions();
   Reopen(options);
@@ -859,6 +999,59 @@ TEST_P(DBWriteTest, MultiThreadWrite) {
   Close();
 }
 
+TEST_P(DBWriteTest, MultiThreadWriteSplitBatches) {
+  Options options = GetOptions();
+  if (!options.enable_multi_batch_write) {
+    return;
+  }
+  constexpr int kNumThreads = 4;
+  constexpr int kNumWrite = 4;
+  options.multi_batch_write_split_bytes = 1024;
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.push_back(port::Thread(
+        [&](int index) {
+          // The first thread writes batches much larger than the others, so
+          // that they have something to steal.
+          const int batch_size = index == 0 ? 1000 : 10;
+          WriteOptions opt;
+          for (int j = 0; j < kNumWrite; j++) {
+            WriteBatch large, small;
+            for (int k = 0; k < batch_size; k++) {
+              ASSERT_OK(large.Put("key_" + std::to_string(index) + "_" +
+                                      std::to_string(j) + "_" +
+                                      std::to_string(k),
+                                  "value" + std::to_string(k)));
+            }
+            ASSERT_OK(small.Delete("key_" + std::to_string(index) + "_" +
+                                   std::to_string(j) + "_0"));
+            std::vector<WriteBatch*> batches = {&large, &small};
+            ASSERT_OK(dbfull()->MultiBatchWrite(opt, std::move(batches)));
+          }
+        },
+        t));
+  }
+  for (int i = 0; i < kNumThreads; i++) {
+    threads[i].join();
+  }
+  for (int t = 0; t < kNumThreads; t++) {
+    const int batch_size = t == 0 ? 1000 : 10;
+    for (int j = 0; j < kNumWrite; j++) {
+      const std::string prefix =
+          "key_" + std::to_string(t) + "_" + std::to_string(j) + "_";
+      ASSERT_EQ("NOT_FOUND", Get(prefix + "0"));
+      for (int k = 1; k < batch_size; k++) {
+        ASSERT_EQ("value" + std::to_string(k), Get(prefix + std::to_string(k)));
+      }
+    }
+  }
+  ASSERT_LE(options.statistics->getTickerCount(MULTI_BATCH_WRITE_STOLEN_BYTES),
+            options.statistics->getTickerCount(BYTES_WRITTEN));
+  Close();
+}
+
 class SimpleCallback : public PostWriteCallback {
   std::function<void(SequenceNumber)> f_;
 
@@ -868,6 +1061,107 @@ class SimpleCallback : public PostWriteCallback {
   void Callback(SequenceNumber seq) override { f_(seq); }
 };
 
+TEST_P(DBWriteTest, MultiBatchWritePostCallbackAfterAllRanges) {
+  Options options = GetOptions();
+  if (!options.enable_multi_batch_write) {
+    return;
+  }
+  constexpr int kNumThreads = 4;
+  constexpr int kNumWrite = 8;
+  constexpr int kBatchSize = 500;
+  options.multi_batch_write_split_bytes = 512;
+  // Keep everything in one memtable, which the callbacks read directly.
+  options.write_buffer_size = 64 << 20;
+  Reopen(options);
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(
+                 db_->DefaultColumnFamily())
+                 ->cfd();
+  // The sequence numbers are not published yet when the callback runs, so
+  // count the entries of a batch in the memtable.
+  auto count_in_memtable = [&](const std::string& prefix) {
+    Arena arena;
+    ScopedArenaIterator iter(cfd->mem()->NewIterator(ReadOptions(), &arena));
+    int count = 0;
+    for (iter->Seek(InternalKey(prefix, kMaxSequenceNumber, kValueTypeForSeek)
+                        .Encode());
+         iter->Valid() && ExtractUserKey(iter->key()).starts_with(prefix);
+         iter->Next()) {
+      count++;
+    }
+    return count;
+  };
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.push_back(port::Thread(
+        [&](int index) {
+          for (int j = 0; j < kNumWrite; j++) {
+            const std::string prefix =
+                "key_" + std::to_string(index) + "_" + std::to_string(j) + "_";
+            WriteBatch first, second;
+            for (int k = 0; k < kBatchSize; k++) {
+              ASSERT_OK(first.Put(prefix + "a" + std::to_string(k), "value"));
+              ASSERT_OK(second.Put(prefix + "b" + std::to_string(k), "value"));
+            }
+            std::atomic<int> calls(0);
+            std::atomic<int> complete(0);
+            SimpleCallback callback([&](SequenceNumber) {
+              calls.fetch_add(1);
+              // The callback does not say which batch it is for, but each
+              // call must find one more batch fully inserted.
+              int done = (count_in_memtable(prefix + "a") == kBatchSize) +
+                         (count_in_memtable(prefix + "b") == kBatchSize);
+              if (done >= calls.load()) {
+                complete.fetch_add(1);
+              }
+            });
+            std::vector<WriteBatch*> batches = {&first, &second};
+            ASSERT_OK(dbfull()->MultiBatchWrite(WriteOptions(),
+                                                std::move(batches), &callback));
+            ASSERT_EQ(2, calls.load());
+            ASSERT_EQ(2, complete.load());
+          }
+        },
+        t));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  Close();
+}
+
+TEST_P(DBWriteTest, MultiBatchWriteStageTimes) {
+  Options options = GetOptions();
+  if (!options.enable_multi_batch_write) {
+    return;
+  }
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+
+  constexpr int kNumWrites = 10;
+  SetPerfLevel(kEnableTimeExceptForMutex);
+  get_perf_context()->Reset();
+  for (int i = 0; i < kNumWrites; i++) {
+    WriteBatch first, second;
+    ASSERT_OK(first.Put("a" + std::to_string(i), "value"));
+    ASSERT_OK(second.Put("b" + std::to_string(i), "value"));
+    std::vector<WriteBatch*> batches = {&first, &second};
+    ASSERT_OK(dbfull()->MultiBatchWrite(WriteOptions(), std::move(batches)));
+  }
+  ASSERT_GT(get_perf_context()->write_commit_wait_nanos, 0u);
+  // Nobody else is writing, so there is nothing to help with.
+  ASSERT_EQ(0u, get_perf_context()->write_help_other_writers_nanos);
+  ASSERT_EQ(0u, get_perf_context()->write_memtable_queue_wait_nanos);
+  SetPerfLevel(kDisable);
+
+  HistogramData data;
+  options.statistics->histogramData(MULTI_BATCH_WRITE_MEMTABLE_MICROS, &data);
+  ASSERT_EQ(static_cast<uint64_t>(kNumWrites), data.count);
+  options.statistics->histogramData(MULTI_BATCH_WRITE_COMMIT_WAIT_MICROS,
+                                    &data);
+  ASSERT_EQ(static_cast<uint64_t>(kNumWrites), data.count);
+  Close();
+}
+
 TEST_P(DBWriteTest, PostWriteCallback) {
   Options options = GetOptions();
   if (options.two_write_queues) {
@@ -767,7 +767,9 @@ class IterKey {
   const char* key_;
   size_t key_size_;
   size_t buf_size_;
-  char space_[39];  // Avoid allocation for short keys
+  // Avoid allocation for short keys. Point lookups rebuild the keys of a
+  // restart interval here, so a longer key would cost an allocation per Get.
+  char space_[71];
   bool is_user_key_;
 
   Slice SetKeyImpl(const Slice& key, bool copy) {
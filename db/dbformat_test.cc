@@ -12,6 +12,7 @@
 #include "table/block_based/index_builder.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
+#include "util/user_comparator_wrapper.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -333,6 +334,39 @@ TEST_F(FormatTest, ReplaceInternalKeyWithMinTimestamp) {
   ASSERT_EQ(kTypeValue, new_key.type);
 }
 
+TEST_F(FormatTest, BuiltinComparatorsInlined) {
+  // The comparisons of the built-in comparators are inlined, and must agree
+  // with the comparators themselves
+  const std::vector<std::string> user_keys = {"",     "a",    "ab", "b",
+                                              "\xff", "\x01", "aa"};
+  for (const Comparator* ucmp :
+       {BytewiseComparator(), ReverseBytewiseComparator()}) {
+    SCOPED_TRACE(ucmp->Name());
+    InternalKeyComparator icmp(ucmp);
+    UserComparatorWrapper wrapper(ucmp);
+    for (const std::string& a : user_keys) {
+      for (const std::string& b : user_keys) {
+        ASSERT_EQ(ucmp->Compare(a, b), wrapper.Compare(a, b));
+        ASSERT_EQ(ucmp->Equal(a, b), wrapper.Equal(a, b));
+        ASSERT_EQ(ucmp->CompareWithoutTimestamp(a, b),
+                  wrapper.CompareWithoutTimestamp(a, b));
+        ASSERT_EQ(ucmp->EqualWithoutTimestamp(a, b),
+                  wrapper.EqualWithoutTimestamp(a, b));
+        for (SequenceNumber seq : {1, 2}) {
+          const std::string ikey_a = IKey(a, 1, kTypeValue);
+          const std::string ikey_b = IKey(b, seq, kTypeValue);
+          int expected = ucmp->Compare(a, b);
+          if (expected == 0 && seq > 1) {
+            // Newer first
+            expected = 1;
+          }
+          ASSERT_EQ(expected, icmp.Compare(ikey_a, ikey_b));
+        }
+      }
+    }
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -689,6 +689,106 @@ TEST_F(ExternalSSTFileBasicTest, NoCopy) {
   }
 }
 
+TEST_F(ExternalSSTFileBasicTest, ParallelFilePreparation) {
+  if (!random_rwfile_supported_) {
+    ROCKSDB_GTEST_SKIP("Test requires NewRandomRWFile support");
+    return;
+  }
+  Options options = CurrentOptions();
+  options.file_checksum_gen_factory = GetFileChecksumGenCrc32cFactory();
+  DestroyAndReopen(options);
+  ChecksumVerifyHelper checksum_helper(options);
+
+  ASSERT_OK(Put(Key(0), "old_val"));
+  // The snapshot makes the ingestion assign global sequence numbers
+  const Snapshot* snapshot = db_->GetSnapshot();
+
+  SstFileWriter sst_file_writer(EnvOptions(), options);
+  std::vector<std::string> files;
+  for (int i = 0; i < 16; i++) {
+    std::string file = sst_files_dir_ + "file" + std::to_string(i) + ".sst";
+    ASSERT_OK(sst_file_writer.Open(file));
+    for (int k = i * 10; k < (i + 1) * 10; k++) {
+      ASSERT_OK(sst_file_writer.Put(Key(k), Key(k) + "_val"));
+    }
+    ASSERT_OK(sst_file_writer.Finish());
+    files.push_back(file);
+  }
+
+  IngestExternalFileOptions ifo;
+  ifo.write_global_seqno = true;
+  ifo.max_file_preparation_threads = 4;
+  ASSERT_OK(db_->IngestExternalFile(files, ifo));
+
+  for (int k = 0; k < 160; k++) {
+    ASSERT_EQ(Get(Key(k)), Key(k) + "_val");
+  }
+  ASSERT_EQ(Get(Key(0), snapshot), "old_val");
+  db_->ReleaseSnapshot(snapshot);
+
+  // The checksums in the MANIFEST are of the files with their global sequence
+  // numbers written
+  std::vector<LiveFileMetaData> live_files;
+  db_->GetLiveFilesMetaData(&live_files);
+  ASSERT_EQ(16, live_files.size());
+  for (const auto& meta : live_files) {
+    std::string file_checksum, file_checksum_func_name;
+    ASSERT_OK(checksum_helper.GetSingleFileChecksumAndFuncName(
+        meta.directory + "/" + meta.relative_filename, &file_checksum,
+        &file_checksum_func_name));
+    ASSERT_EQ(meta.file_checksum, file_checksum);
+    ASSERT_EQ(meta.file_checksum_func_name, file_checksum_func_name);
+  }
+}
+
+TEST_F(ExternalSSTFileBasicTest, ParallelCompressionAndConcurrentWriters) {
+  Options options = CurrentOptions();
+  if (Snappy_Supported()) {
+    options.compression = kSnappyCompression;
+  }
+  options.compression_opts.parallel_threads = 4;
+  DestroyAndReopen(options);
+
+  // Two files of disjoint key ranges, each written by its own writer on its
+  // own thread
+  const int kNumFiles = 2;
+  const int kKeysPerFile = 10000;
+  std::vector<std::string> files(kNumFiles);
+  std::vector<Status> statuses(kNumFiles);
+  std::vector<port::Thread> threads;
+  for (int i = 0; i < kNumFiles; i++) {
+    files[i] = sst_files_dir_ + "file" + std::to_string(i) + ".sst";
+    threads.emplace_back([&, i]() {
+      SstFileWriter sst_file_writer(EnvOptions(), options);
+      statuses[i] = sst_file_writer.Open(files[i]);
+      for (int k = i * kKeysPerFile;
+           statuses[i].ok() && k < (i + 1) * kKeysPerFile; k++) {
+        statuses[i] = sst_file_writer.Put(Key(k), Key(k) + "_val");
+      }
+      if (statuses[i].ok()) {
+        statuses[i] = sst_file_writer.Finish();
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (const Status& s : statuses) {
+    ASSERT_OK(s);
+  }
+
+  IngestExternalFileOptions ifo;
+  ifo.max_file_preparation_threads = kNumFiles;
+  ASSERT_OK(db_->IngestExternalFile(files, ifo));
+
+  for (int k = 0; k < kNumFiles * kKeysPerFile; k++) {
+    ASSERT_EQ(Get(Key(k)), Key(k) + "_val");
+  }
+  std::vector<LiveFileMetaData> live_files;
+  db_->GetLiveFilesMetaData(&live_files);
+  ASSERT_EQ(kNumFiles, live_files.size());
+}
+
 TEST_P(ExternalSSTFileBasicTest, IngestFileWithGlobalSeqnoPickedSeqno) {
   bool write_global_seqno = std::get<0>(GetParam());
   bool verify_checksums_before_ingest = std::get<1>(GetParam());
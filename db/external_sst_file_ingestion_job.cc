@@ -22,6 +22,7 @@
 #include "table/table_builder.h"
 #include "table/unique_id_impl.h"
 #include "test_util/sync_point.h"
+#include "util/parallel_for_each.h"
 #include "util/stop_watch.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -35,13 +36,15 @@ Status ExternalSstFileIngestionJob::Prepare(
   Status status;
 
   // Read the information of files we are ingesting
-  for (const std::string& file_path : external_files_paths) {
-    IngestedFileInfo file_to_ingest;
-    status =
-        GetIngestedFileInfo(file_path, next_file_number++, &file_to_ingest, sv);
-    if (!status.ok()) {
-      return status;
-    }
+  std::vector<IngestedFileInfo> files_info(external_files_paths.size());
+  status = ForEachFileInParallel(files_info.size(), [&](size_t i) {
+    return GetIngestedFileInfo(external_files_paths[i], next_file_number + i,
+                               &files_info[i], sv);
+  });
+  if (!status.ok()) {
+    return status;
+  }
+  for (IngestedFileInfo& file_to_ingest : files_info) {
 
     if (file_to_ingest.cf_id !=
             TablePropertiesCollectorFactory::Context::kUnknownColumnFamily &&
@@ -100,49 +103,49 @@ Status ExternalSstFileIngestionJob::Prepare(
   }
 
   // Copy/Move external files into DB
-  std::unordered_set<size_t> ingestion_path_ids;
-  for (IngestedFileInfo& f : files_to_ingest_) {
+  status = ForEachFileInParallel(files_to_ingest_.size(), [&](size_t i) {
+    IngestedFileInfo& f = files_to_ingest_[i];
+    Status s;
     f.copy_file = false;
     const std::string path_outside_db = f.external_file_path;
     const std::string path_inside_db = TableFileName(
         cfd_->ioptions()->cf_paths, f.fd.GetNumber(), f.fd.GetPathId());
     if (ingestion_options_.move_files) {
-      status =
-          fs_->LinkFile(path_outside_db, path_inside_db, IOOptions(), nullptr);
-      if (status.ok()) {
+      s = fs_->LinkFile(path_outside_db, path_inside_db, IOOptions(), nullptr);
+      if (s.ok()) {
         // It is unsafe to assume application had sync the file and file
         // directory before ingest the file. For integrity of RocksDB we need
         // to sync the file.
         std::unique_ptr<FSWritableFile> file_to_sync;
-        Status s = fs_->ReopenWritableFile(path_inside_db, env_options_,
-                                           &file_to_sync, nullptr);
+        Status reopen_s = fs_->ReopenWritableFile(path_inside_db, env_options_,
+                                                  &file_to_sync, nullptr);
         TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::Prepare:Reopen",
-                                 &s);
+                                 &reopen_s);
         // Some file systems (especially remote/distributed) don't support
         // reopening a file for writing and don't require reopening and
         // syncing the file. Ignore the NotSupported error in that case.
-        if (!s.IsNotSupported()) {
-          status = s;
-          if (status.ok()) {
+        if (!reopen_s.IsNotSupported()) {
+          s = reopen_s;
+          if (s.ok()) {
             TEST_SYNC_POINT(
                 "ExternalSstFileIngestionJob::BeforeSyncIngestedFile");
-            status = SyncIngestedFile(file_to_sync.get());
+            s = SyncIngestedFile(file_to_sync.get());
             TEST_SYNC_POINT(
                 "ExternalSstFileIngestionJob::AfterSyncIngestedFile");
-            if (!status.ok()) {
+            if (!s.ok()) {
               ROCKS_LOG_WARN(db_options_.info_log,
                              "Failed to sync ingested file %s: %s",
-                             path_inside_db.c_str(), status.ToString().c_str());
+                             path_inside_db.c_str(), s.ToString().c_str());
             }
           }
         }
-      } else if (status.IsNotSupported() &&
+      } else if (s.IsNotSupported() &&
                  ingestion_options_.failed_move_fall_back_to_copy) {
         // Original file is on a different FS, use copy instead of hard linking.
         f.copy_file = true;
         ROCKS_LOG_INFO(db_options_.info_log,
                        "Triy to link file %s but it's not supported : %s",
-                       path_outside_db.c_str(), status.ToString().c_str());
+                       path_outside_db.c_str(), s.ToString().c_str());
       }
     } else {
       f.copy_file = true;
@@ -152,19 +155,24 @@ Status ExternalSstFileIngestionJob::Prepare(
       TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::Prepare:CopyFile",
                                nullptr);
       // CopyFile also sync the new file.
-      status =
-          CopyFile(fs_.get(), path_outside_db, path_inside_db, 0,
+      s = CopyFile(fs_.get(), path_outside_db, path_inside_db, 0,
                    db_options_.use_fsync, io_tracer_, Temperature::kUnknown);
     }
     TEST_SYNC_POINT("ExternalSstFileIngestionJob::Prepare:FileAdded");
-    if (!status.ok()) {
-      break;
+    if (!s.ok()) {
+      return s;
     }
     f.internal_file_path = path_inside_db;
     // Initialize the checksum information of ingested files.
     f.file_checksum = kUnknownFileChecksum;
     f.file_checksum_func_name = kUnknownFileChecksumFuncName;
-    ingestion_path_ids.insert(f.fd.GetPathId());
+    return s;
+  });
+  std::unordered_set<size_t> ingestion_path_ids;
+  for (const IngestedFileInfo& f : files_to_ingest_) {
+    if (!f.internal_file_path.empty()) {
+      ingestion_path_ids.insert(f.fd.GetPathId());
+    }
   }
 
   TEST_SYNC_POINT("ExternalSstFileIngestionJob::BeforeSyncDir");
@@ -210,9 +218,12 @@ Status ExternalSstFileIngestionJob::Prepare(
     std::vector<std::string> generated_checksum_func_names;
     // Step 1: generate the checksum for ingested sst file.
     if (need_generate_file_checksum_) {
-      for (size_t i = 0; i < files_to_ingest_.size(); i++) {
-        std::string generated_checksum;
-        std::string generated_checksum_func_name;
+      generated_checksums.resize(files_to_ingest_.size());
+      generated_checksum_func_names.resize(files_to_ingest_.size());
+      status = ForEachFileInParallel(files_to_ingest_.size(), [&](size_t i) {
+        std::string& generated_checksum = generated_checksums[i];
+        std::string& generated_checksum_func_name =
+            generated_checksum_func_names[i];
         std::string requested_checksum_func_name;
         // TODO: rate limit file reads for checksum calculation during file
         // ingestion.
@@ -228,21 +239,19 @@ Status ExternalSstFileIngestionJob::Prepare(
             db_options_.rate_limiter.get(), ro, db_options_.stats,
             db_options_.clock);
         if (!io_s.ok()) {
-          status = io_s;
           ROCKS_LOG_WARN(db_options_.info_log,
                          "Sst file checksum generation of file: %s failed: %s",
                          files_to_ingest_[i].internal_file_path.c_str(),
-                         status.ToString().c_str());
-          break;
+                         io_s.ToString().c_str());
+          return Status(io_s);
         }
         if (ingestion_options_.write_global_seqno == false) {
           files_to_ingest_[i].file_checksum = generated_checksum;
           files_to_ingest_[i].file_checksum_func_name =
               generated_checksum_func_name;
         }
-        generated_checksums.push_back(generated_checksum);
-        generated_checksum_func_names.push_back(generated_checksum_func_name);
-      }
+        return Status::OK();
+      });
     }
 
     // Step 2: based on the verify_file_checksum and ingested checksum
@@ -404,6 +413,8 @@ Status ExternalSstFileIngestionJob::Run() {
   edit_.SetColumnFamily(cfd_->GetID());
   // The levels that the files will be ingested into
 
+  std::vector<SequenceNumber> assigned_seqnos;
+  assigned_seqnos.reserve(files_to_ingest_.size());
   for (IngestedFileInfo& f : files_to_ingest_) {
     SequenceNumber assigned_seqno = 0;
     if (ingestion_options_.ingest_behind) {
@@ -439,7 +450,6 @@ Status ExternalSstFileIngestionJob::Run() {
                         largest_parsed.type);
     }
 
-    status = AssignGlobalSeqnoForIngestedFile(&f, assigned_seqno);
     TEST_SYNC_POINT_CALLBACK("ExternalSstFileIngestionJob::Run",
                              &assigned_seqno);
     if (assigned_seqno > last_seqno) {
@@ -447,15 +457,24 @@ Status ExternalSstFileIngestionJob::Run() {
       last_seqno = assigned_seqno;
       ++consumed_seqno_count_;
     }
-    if (!status.ok()) {
-      return status;
-    }
+    assigned_seqnos.push_back(assigned_seqno);
+  }
 
-    status = GenerateChecksumForIngestedFile(&f);
-    if (!status.ok()) {
-      return status;
+  // Writing the global sequence numbers into the files and generating their
+  // checksums is IO, done for the files in parallel
+  status = ForEachFileInParallel(files_to_ingest_.size(), [&](size_t i) {
+    IngestedFileInfo& f = files_to_ingest_[i];
+    Status s = AssignGlobalSeqnoForIngestedFile(&f, assigned_seqnos[i]);
+    if (s.ok()) {
+      s = GenerateChecksumForIngestedFile(&f);
     }
+    return s;
+  });
+  if (!status.ok()) {
+    return status;
+  }
 
+  for (IngestedFileInfo& f : files_to_ingest_) {
     // We use the import time as the ancester time. This is the time the data
     // is written to the database.
     int64_t temp_current_time = 0;
@@ -489,6 +508,9 @@ Status ExternalSstFileIngestionJob::Run() {
     f_metadata.temperature = f.file_temperature;
     edit_.AddFile(f.picked_level, f_metadata);
   }
+  // Files ingested behind, or without a sequence number, may have older
+  // entries of keys than what the keys read
+  edit_.MarkInvalidatesCachedRows();
 
   CreateEquivalentFileIngestingCompactions();
   return status;
@@ -1124,6 +1146,12 @@ bool ExternalSstFileIngestionJob::IngestedFileFitInLevel(
   return true;
 }
 
+Status ExternalSstFileIngestionJob::ForEachFileInParallel(
+    size_t num_files, const std::function<Status(size_t)>& work) {
+  return ParallelForEach(num_files,
+                         ingestion_options_.max_file_preparation_threads, work);
+}
+
 template <typename TWritableFile>
 Status ExternalSstFileIngestionJob::SyncIngestedFile(TWritableFile* file) {
   assert(file != nullptr);
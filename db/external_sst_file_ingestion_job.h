@@ -4,6 +4,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #pragma once
+#include <functional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -198,6 +199,12 @@ class ExternalSstFileIngestionJob {
   template <typename TWritableFile>
   Status SyncIngestedFile(TWritableFile* file);
 
+  // Calls `work` with the indexes of `num_files` files on up to
+  // `max_file_preparation_threads` threads. No more files are handed out after
+  // a failure, and the failure of the first file that failed is returned.
+  Status ForEachFileInParallel(size_t num_files,
+                               const std::function<Status(size_t)>& work);
+
   // Create equivalent `Compaction` objects to this file ingestion job
   // , which will be used to check range conflict with other ongoing
   // compactions.
@@ -11,9 +11,12 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "db/builder.h"
+#include "db/compaction/clipping_iterator.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
@@ -45,6 +48,7 @@
 #include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/mutexlock.h"
+#include "util/parallel_for_each.h"
 #include "util/stop_watch.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -148,6 +152,7 @@ void FlushJob::ReportStartedFlush() {
   ThreadStatusUtil::SetEnableTracking(db_options_.enable_thread_tracking);
   ThreadStatusUtil::SetColumnFamily(cfd_);
   ThreadStatusUtil::SetThreadOperation(ThreadStatus::OP_FLUSH);
+  ThreadStatusUtil::GetThreadStageTimes(&stage_times_at_start_);
   ThreadStatusUtil::SetThreadOperationProperty(ThreadStatus::COMPACTION_JOB_ID,
                                                job_context_->job_id);
 
@@ -348,6 +353,11 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker, FileMetaData* file_meta,
   }
   RecordFlushIOStats();
 
+  ThreadStageTimes stage_times;
+  ThreadStatusUtil::GetThreadStageTimes(&stage_times);
+  stage_times.Subtract(stage_times_at_start_);
+  cfd_->internal_stats()->AddJobStageTimes(stage_times);
+
   // When measure_io_stats_ is true, the default 512 bytes is not enough.
   auto stream = event_logger_->LogToBuffer(log_buffer_, 1024);
   stream << "job" << job_context_->job_id << "event"
@@ -851,6 +861,89 @@ bool FlushJob::MemPurgeDecider(double threshold) {
           threshold);
 }
 
+std::vector<std::string> FlushJob::GenRangeBoundaries(
+    uint64_t total_data_size) {
+  std::vector<std::string> boundaries;
+  // No range is made smaller than the target file size of L1
+  const uint64_t num_ranges = std::min(
+      static_cast<uint64_t>(db_options_.max_flush_subjobs),
+      total_data_size /
+          std::max(mutable_cf_options_.target_file_size_base, uint64_t{1}));
+  // The boundaries are sampled keys, which only skip list memtables can
+  // provide. Timestamps are not supported, and neither is atomic flush, whose
+  // jobs report a single file each.
+  if (num_ranges <= 1 || db_options_.atomic_flush ||
+      cfd_->user_comparator()->timestamp_size() > 0 ||
+      !cfd_->ioptions()->memtable_factory->IsInstanceOf(
+          SkipListFactory::kClassName())) {
+    return boundaries;
+  }
+
+  // Cut at the quantiles of keys sampled from each memtable
+  constexpr uint64_t kSamplesPerRange = 32;
+  std::vector<std::string> samples;
+  for (MemTable* m : mems_) {
+    if (m->num_entries() == 0) {
+      continue;
+    }
+    std::unordered_set<const char*> entries;
+    m->UniqueRandomSample(kSamplesPerRange * num_ranges, &entries);
+    for (const char* entry : entries) {
+      samples.push_back(
+          ExtractUserKey(GetLengthPrefixedSlice(entry)).ToString());
+    }
+  }
+  if (samples.empty()) {
+    return boundaries;
+  }
+  const Comparator* ucmp = cfd_->user_comparator();
+  std::sort(samples.begin(), samples.end(),
+            [ucmp](const std::string& a, const std::string& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  for (uint64_t i = 1; i < num_ranges; i++) {
+    const std::string& key = samples[i * samples.size() / num_ranges];
+    // Every range starts at a sampled key, so none is known to be empty
+    if (ucmp->Compare(boundaries.empty() ? samples.front() : boundaries.back(),
+                      key) < 0) {
+      boundaries.push_back(key);
+    }
+  }
+  return boundaries;
+}
+
+int FlushJob::PickOutputLevel(const FileMetaData& meta) const {
+  db_mutex_->AssertHeld();
+  // Older memtables flushed later to L0, or purged into a new memtable, would
+  // hide the newer data of the file
+  if (!mutable_cf_options_.flush_to_lowest_level ||
+      cfd_->ioptions()->compaction_style != kCompactionStyleLevel ||
+      db_options_.atomic_flush ||
+      mutable_cf_options_.experimental_mempurge_threshold > 0.0 ||
+      cfd_->imm()->GetEarliestMemTableID() != mems_.front()->GetID()) {
+    return 0;
+  }
+
+  // The same levels as an ingested file of that range could go to
+  const Slice smallest_user_key = meta.smallest.user_key();
+  const Slice largest_user_key = meta.largest.user_key();
+  VersionStorageInfo* vstorage = cfd_->current()->storage_info();
+  int output_level = 0;
+  for (int level = 0; level < cfd_->NumberLevels(); level++) {
+    if (level > 0 && level < vstorage->base_level()) {
+      continue;
+    }
+    if (vstorage->OverlapInLevel(level, &smallest_user_key,
+                                 &largest_user_key) ||
+        cfd_->RangeOverlapWithCompaction(smallest_user_key, largest_user_key,
+                                         level)) {
+      break;
+    }
+    output_level = level;
+  }
+  return output_level;
+}
+
 Status FlushJob::WriteLevel0Table() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_FLUSH_WRITE_L0);
@@ -970,29 +1063,130 @@ Status FlushJob::WriteLevel0Table() {
 
       const std::string* const full_history_ts_low =
           (full_history_ts_low_.empty()) ? nullptr : &full_history_ts_low_;
-      TableBuilderOptions tboptions(
-          *cfd_->ioptions(), mutable_cf_options_, cfd_->internal_comparator(),
-          cfd_->int_tbl_prop_collector_factories(), output_compression_,
-          mutable_cf_options_.compression_opts, cfd_->GetID(), cfd_->GetName(),
-          0 /* level */, false /* is_bottommost */,
-          TableFileCreationReason::kFlush, oldest_key_time, current_time,
-          db_id_, db_session_id_, 0 /* target_file_size */,
-          meta_.fd.GetNumber());
       const SequenceNumber job_snapshot_seq =
           job_context_->GetJobSnapshotSequence();
       const ReadOptions read_options(Env::IOActivity::kFlush);
-      s = BuildTable(dbname_, versions_, db_options_, tboptions, file_options_,
-                     read_options, cfd_->table_cache(), iter.get(),
-                     std::move(range_del_iters), &meta_, &blob_file_additions,
-                     existing_snapshots_, earliest_write_conflict_snapshot_,
-                     job_snapshot_seq, snapshot_checker_,
-                     mutable_cf_options_.paranoid_file_checks,
-                     cfd_->internal_stats(), &io_s, io_tracer_,
-                     BlobFileCreationReason::kFlush, seqno_to_time_mapping_,
-                     event_logger_, job_context_->job_id, io_priority,
-                     &table_properties_, write_hint, full_history_ts_low,
-                     blob_callback_, base_, &num_input_entries,
-                     &memtable_payload_bytes, &memtable_garbage_bytes);
+      // Builds the table file of `meta` from `input`
+      auto build_table =
+          [&](InternalIterator* input,
+              std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>
+                  input_range_del_iters,
+              FileMetaData* meta, std::vector<BlobFileAddition>* blob_files,
+              IOStatus* table_io_s, TableProperties* table_properties,
+              uint64_t* table_num_input_entries, uint64_t* payload_bytes,
+              uint64_t* garbage_bytes) {
+            TableBuilderOptions tboptions(
+                *cfd_->ioptions(), mutable_cf_options_,
+                cfd_->internal_comparator(),
+                cfd_->int_tbl_prop_collector_factories(), output_compression_,
+                mutable_cf_options_.compression_opts, cfd_->GetID(),
+                cfd_->GetName(), 0 /* level */, false /* is_bottommost */,
+                TableFileCreationReason::kFlush, oldest_key_time, current_time,
+                db_id_, db_session_id_, 0 /* target_file_size */,
+                meta->fd.GetNumber());
+            return BuildTable(
+                dbname_, versions_, db_options_, tboptions, file_options_,
+                read_options, cfd_->table_cache(), input,
+                std::move(input_range_del_iters), meta, blob_files,
+                existing_snapshots_, earliest_write_conflict_snapshot_,
+                job_snapshot_seq, snapshot_checker_,
+                mutable_cf_options_.paranoid_file_checks,
+                cfd_->internal_stats(), table_io_s, io_tracer_,
+                BlobFileCreationReason::kFlush, seqno_to_time_mapping_,
+                event_logger_, job_context_->job_id, io_priority,
+                table_properties, write_hint, full_history_ts_low,
+                blob_callback_, base_, table_num_input_entries, payload_bytes,
+                garbage_bytes, cfd_->blob_separation_tuner());
+          };
+
+      // Range tombstones would widen the files of the ranges into each other
+      std::vector<std::string> boundaries;
+      if (range_del_iters.empty()) {
+        boundaries = GenRangeBoundaries(total_data_size);
+      }
+      if (boundaries.empty()) {
+        s = build_table(iter.get(), std::move(range_del_iters), &meta_,
+                        &blob_file_additions, &io_s, &table_properties_,
+                        &num_input_entries, &memtable_payload_bytes,
+                        &memtable_garbage_bytes);
+      } else {
+        // Each range is built on its own thread through its own iterators
+        // over the memtables, into a file of the same epoch as meta_, which
+        // is the output of the first range
+        const size_t num_ranges = boundaries.size() + 1;
+        extra_metas_.resize(boundaries.size());
+        for (FileMetaData& meta : extra_metas_) {
+          meta.fd = FileDescriptor(versions_->NewFileNumber(), 0, 0);
+          meta.epoch_number = meta_.epoch_number;
+          meta.oldest_ancester_time = meta_.oldest_ancester_time;
+          meta.file_creation_time = meta_.file_creation_time;
+        }
+        std::vector<InternalKey> bounds;
+        bounds.reserve(boundaries.size());
+        for (const std::string& boundary : boundaries) {
+          bounds.emplace_back(boundary, kMaxSequenceNumber, kValueTypeForSeek);
+        }
+        std::vector<std::vector<BlobFileAddition>> range_blob_files(
+            num_ranges);
+        std::vector<IOStatus> range_io_s(num_ranges);
+        std::vector<TableProperties> range_table_properties(num_ranges);
+        std::vector<uint64_t> range_num_input_entries(num_ranges, 0);
+        std::vector<uint64_t> range_payload_bytes(num_ranges, 0);
+        std::vector<uint64_t> range_garbage_bytes(num_ranges, 0);
+        // The bytes written by the other threads, which are added to the
+        // IO stats of this one
+        std::atomic<uint64_t> other_threads_bytes_written{0};
+        const std::thread::id flush_thread_id = std::this_thread::get_id();
+        const InternalKeyComparator& icmp = cfd_->internal_comparator();
+
+        s = ParallelForEach(
+            num_ranges, static_cast<int>(num_ranges), [&](size_t i) {
+              const uint64_t prev_bytes_written = IOSTATS(bytes_written);
+              Arena range_arena;
+              std::vector<InternalIterator*> range_memtables;
+              for (MemTable* m : mems_) {
+                range_memtables.push_back(m->NewIterator(ro, &range_arena));
+              }
+              ScopedArenaIterator range_iter(NewMergingIterator(
+                  &icmp, range_memtables.data(),
+                  static_cast<int>(range_memtables.size()), &range_arena));
+              const Slice start = i > 0 ? bounds[i - 1].Encode() : Slice();
+              const Slice end =
+                  i < bounds.size() ? bounds[i].Encode() : Slice();
+              ClippingIterator clip(range_iter.get(), i > 0 ? &start : nullptr,
+                                    i < bounds.size() ? &end : nullptr, &icmp);
+              Status range_s = build_table(
+                  &clip, {}, i == 0 ? &meta_ : &extra_metas_[i - 1],
+                  &range_blob_files[i], &range_io_s[i],
+                  &range_table_properties[i], &range_num_input_entries[i],
+                  &range_payload_bytes[i], &range_garbage_bytes[i]);
+              if (std::this_thread::get_id() != flush_thread_id) {
+                other_threads_bytes_written.fetch_add(
+                    IOSTATS(bytes_written) - prev_bytes_written,
+                    std::memory_order_relaxed);
+                IOSTATS_RESET(bytes_written);
+              }
+              return range_s;
+            });
+        IOSTATS_ADD(bytes_written, other_threads_bytes_written.load());
+
+        for (size_t i = 0; i < num_ranges; i++) {
+          assert(!s.ok() || range_io_s[i].ok());
+          range_io_s[i].PermitUncheckedError();
+          num_input_entries += range_num_input_entries[i];
+          memtable_payload_bytes += range_payload_bytes[i];
+          memtable_garbage_bytes += range_garbage_bytes[i];
+          blob_file_additions.insert(
+              blob_file_additions.end(),
+              std::make_move_iterator(range_blob_files[i].begin()),
+              std::make_move_iterator(range_blob_files[i].end()));
+          if (i == 0) {
+            table_properties_ = range_table_properties[i];
+          } else {
+            table_properties_.Add(range_table_properties[i]);
+          }
+        }
+      }
       TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:s", &s);
       // TODO: Cleanup io_status in BuildTable and table builders
       assert(!s.ok() || io_s.ok());
@@ -1008,13 +1202,11 @@ Status FlushJob::WriteLevel0Table() {
           s = Status::Corruption(msg);
         }
       }
-      if (tboptions.reason == TableFileCreationReason::kFlush) {
-        TEST_SYNC_POINT("DBImpl::FlushJob:Flush");
-        RecordTick(stats_, MEMTABLE_PAYLOAD_BYTES_AT_FLUSH,
-                   memtable_payload_bytes);
-        RecordTick(stats_, MEMTABLE_GARBAGE_BYTES_AT_FLUSH,
-                   memtable_garbage_bytes);
-      }
+      TEST_SYNC_POINT("DBImpl::FlushJob:Flush");
+      RecordTick(stats_, MEMTABLE_PAYLOAD_BYTES_AT_FLUSH,
+                 memtable_payload_bytes);
+      RecordTick(stats_, MEMTABLE_GARBAGE_BYTES_AT_FLUSH,
+                 memtable_garbage_bytes);
       LogFlush(db_options_.info_log);
     }
     ROCKS_LOG_BUFFER(log_buffer_,
@@ -1025,6 +1217,14 @@ Status FlushJob::WriteLevel0Table() {
                      meta_.fd.GetNumber(), meta_.fd.GetFileSize(),
                      s.ToString().c_str(),
                      meta_.marked_for_compaction ? " (needs compaction)" : "");
+    for (const FileMetaData& meta : extra_metas_) {
+      ROCKS_LOG_BUFFER(log_buffer_,
+                       "[%s] [JOB %d] Level-0 flush table #%" PRIu64
+                       ": %" PRIu64 " bytes%s",
+                       cfd_->GetName().c_str(), job_context_->job_id,
+                       meta.fd.GetNumber(), meta.fd.GetFileSize(),
+                       meta.marked_for_compaction ? " (needs compaction)" : "");
+    }
 
     if (s.ok() && output_file_directory_ != nullptr && sync_output_directory_) {
       s = output_file_directory_->FsyncWithDirOptions(
@@ -1038,7 +1238,16 @@ Status FlushJob::WriteLevel0Table() {
 
   // Note that if file_size is zero, the file has been deleted and
   // should not be added to the manifest.
-  const bool has_output = meta_.fd.GetFileSize() > 0;
+  autovector<const FileMetaData*> outputs;
+  if (meta_.fd.GetFileSize() > 0) {
+    outputs.push_back(&meta_);
+  }
+  for (const FileMetaData& meta : extra_metas_) {
+    if (meta.fd.GetFileSize() > 0) {
+      outputs.push_back(&meta);
+    }
+  }
+  const bool has_output = !outputs.empty();
 
   if (s.ok() && has_output) {
     TEST_SYNC_POINT("DBImpl::FlushJob:SSTFileCreated");
@@ -1046,16 +1255,25 @@ Status FlushJob::WriteLevel0Table() {
     // insert files directly into higher levels because some other
     // threads could be concurrently producing compacted files for
     // that key range.
-    // Add file to L0
-    edit_->AddFile(0 /* level */, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
-                   meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
-                   meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
-                   meta_.marked_for_compaction, meta_.temperature,
-                   meta_.oldest_blob_file_number, meta_.oldest_ancester_time,
-                   meta_.file_creation_time, meta_.epoch_number,
-                   meta_.file_checksum, meta_.file_checksum_func_name,
-                   meta_.unique_id, meta_.compensated_range_deletion_size,
-                   meta_.tail_size, meta_.user_defined_timestamps_persisted);
+    // Add files to L0, or lower with flush_to_lowest_level
+    for (const FileMetaData* meta : outputs) {
+      const int output_level = PickOutputLevel(*meta);
+      if (output_level > 0) {
+        ROCKS_LOG_INFO(db_options_.info_log,
+                       "[%s] [JOB %d] Flush table #%" PRIu64 " added to L%d",
+                       cfd_->GetName().c_str(), job_context_->job_id,
+                       meta->fd.GetNumber(), output_level);
+      }
+      edit_->AddFile(output_level, meta->fd.GetNumber(), meta->fd.GetPathId(),
+                     meta->fd.GetFileSize(), meta->smallest, meta->largest,
+                     meta->fd.smallest_seqno, meta->fd.largest_seqno,
+                     meta->marked_for_compaction, meta->temperature,
+                     meta->oldest_blob_file_number, meta->oldest_ancester_time,
+                     meta->file_creation_time, meta->epoch_number,
+                     meta->file_checksum, meta->file_checksum_func_name,
+                     meta->unique_id, meta->compensated_range_deletion_size,
+                     meta->tail_size, meta->user_defined_timestamps_persisted);
+    }
     edit_->SetBlobFileAdditions(std::move(blob_file_additions));
   }
   // Piggyback FlushJobInfo on the first first flushed memtable.
@@ -1074,10 +1292,10 @@ Status FlushJob::WriteLevel0Table() {
                  cfd_->GetName().c_str(), job_context_->job_id, micros,
                  cpu_micros);
 
-  if (has_output) {
-    stats.bytes_written = meta_.fd.GetFileSize();
-    stats.num_output_files = 1;
+  for (const FileMetaData* meta : outputs) {
+    stats.bytes_written += meta->fd.GetFileSize();
   }
+  stats.num_output_files = outputs.size();
 
   const auto& blobs = edit_->GetBlobFileAdditions();
   for (const auto& blob : blobs) {
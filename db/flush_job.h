@@ -101,6 +101,12 @@ class FlushJob {
     return &committed_flush_jobs_info_;
   }
 
+  // The output files after the first one, whose metadata is returned by
+  // Run(), when the flush was split into key ranges
+  const std::vector<FileMetaData>& GetExtraFileMetaData() const {
+    return extra_metas_;
+  }
+
  private:
   friend class FlushJobTest_GetRateLimiterPriorityForWrite_Test;
 
@@ -108,6 +114,13 @@ class FlushJob {
   void ReportFlushInputSize(const autovector<MemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
+  // Returns the user keys at which to split the flush into key ranges built
+  // in parallel, or none to build one file.
+  std::vector<std::string> GenRangeBoundaries(uint64_t total_data_size);
+  // Returns the level to add the output file `meta` to, which is L0 unless
+  // flush_to_lowest_level allows a lower one.
+  // Require db_mutex held.
+  int PickOutputLevel(const FileMetaData& meta) const;
 
   // Memtable Garbage Collection algorithm: a MemPurge takes the list
   // of immutable memtables and filters out (or "purge") the outdated bytes
@@ -201,11 +214,15 @@ class FlushJob {
 
   // Variables below are set by PickMemTable():
   FileMetaData meta_;
+  // The outputs of the key ranges after the first, whose output is meta_
+  std::vector<FileMetaData> extra_metas_;
   autovector<MemTable*> mems_;
   VersionEdit* edit_;
   Version* base_;
   bool pick_memtable_called;
   Env::Priority thread_pri_;
+  // The stage times of the thread when the job started
+  ThreadStageTimes stage_times_at_start_;
 
   const std::shared_ptr<IOTracer> io_tracer_;
   SystemClock* clock_;
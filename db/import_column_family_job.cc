@@ -9,6 +9,7 @@
 #include "db/import_column_family_job.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <string>
 #include <vector>
@@ -22,6 +23,7 @@
 #include "table/sst_file_writer_collectors.h"
 #include "table/table_builder.h"
 #include "table/unique_id_impl.h"
+#include "util/parallel_for_each.h"
 #include "util/stop_watch.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -29,23 +31,40 @@ namespace ROCKSDB_NAMESPACE {
 Status ImportColumnFamilyJob::Prepare(uint64_t next_file_number,
                                       SuperVersion* sv) {
   Status status;
+  // Read the information of files we are importing, on several threads. The
+  // files of all CFs are worked on as one list, file `i` of the list being
+  // `file_indexes[i].second` of CF `file_indexes[i].first`.
+  std::vector<std::pair<size_t, size_t>> file_indexes;
+  files_to_import_.resize(metadatas_.size());
+  for (size_t cf = 0; cf < metadatas_.size(); cf++) {
+    if (metadatas_[cf].empty()) {
+      return Status::InvalidArgument("The list of files is empty");
+    }
+    files_to_import_[cf].resize(metadatas_[cf].size());
+    for (size_t i = 0; i < metadatas_[cf].size(); i++) {
+      file_indexes.emplace_back(cf, i);
+    }
+  }
+  status = ParallelForEach(
+      file_indexes.size(), import_options_.max_file_preparation_threads,
+      [&](size_t i) {
+        const auto& file_metadata =
+            *metadatas_[file_indexes[i].first][file_indexes[i].second];
+        const auto file_path = file_metadata.db_path + "/" + file_metadata.name;
+        return GetIngestedFileInfo(
+            file_path, next_file_number + i, sv, file_metadata,
+            &files_to_import_[file_indexes[i].first][file_indexes[i].second]);
+      });
+  if (!status.ok()) {
+    return status;
+  }
+
   std::vector<ColumnFamilyIngestFileInfo> cf_ingest_infos;
-  for (const auto& metadata_per_cf : metadatas_) {
-    // Read the information of files we are importing
+  for (const auto& files_to_import_per_cf : files_to_import_) {
     ColumnFamilyIngestFileInfo cf_file_info;
     InternalKey smallest, largest;
-    int num_files = 0;
-    std::vector<IngestedFileInfo> files_to_import_per_cf;
-    for (size_t i = 0; i < metadata_per_cf.size(); i++) {
-      auto file_metadata = *metadata_per_cf[i];
-      const auto file_path = file_metadata.db_path + "/" + file_metadata.name;
-      IngestedFileInfo file_to_import;
-      status = GetIngestedFileInfo(file_path, next_file_number++, sv,
-                                   file_metadata, &file_to_import);
-      if (!status.ok()) {
-        return status;
-      }
-
+    for (size_t i = 0; i < files_to_import_per_cf.size(); i++) {
+      const auto& file_to_import = files_to_import_per_cf[i];
       if (file_to_import.num_entries == 0) {
         status = Status::InvalidArgument("File contain no entries");
         return status;
@@ -57,9 +76,6 @@ Status ImportColumnFamilyJob::Prepare(uint64_t next_file_number,
         return status;
       }
 
-      files_to_import_per_cf.push_back(file_to_import);
-      num_files++;
-
       // Calculate the smallest and largest keys of all files in this CF
       if (i == 0) {
         smallest = file_to_import.smallest_internal_key;
@@ -76,11 +92,6 @@ Status ImportColumnFamilyJob::Prepare(uint64_t next_file_number,
       }
     }
 
-    if (num_files == 0) {
-      status = Status::InvalidArgument("The list of files is empty");
-      return status;
-    }
-    files_to_import_.push_back(files_to_import_per_cf);
     cf_file_info.smallest_internal_key = smallest;
     cf_file_info.largest_internal_key = largest;
     cf_ingest_infos.push_back(cf_file_info);
@@ -103,50 +114,50 @@ Status ImportColumnFamilyJob::Prepare(uint64_t next_file_number,
     }
   }
 
-  // Copy/Move external files into DB
-  auto hardlink_files = import_options_.move_files;
-
-  for (auto& files_to_import_per_cf : files_to_import_) {
-    for (auto& f : files_to_import_per_cf) {
-      const auto path_outside_db = f.external_file_path;
-      const auto path_inside_db = TableFileName(
-          cfd_->ioptions()->cf_paths, f.fd.GetNumber(), f.fd.GetPathId());
-
-      if (hardlink_files) {
-        status = fs_->LinkFile(path_outside_db, path_inside_db, IOOptions(),
-                               nullptr);
-        if (status.IsNotSupported()) {
-          // Original file is on a different FS, use copy instead of hard
-          // linking
-          hardlink_files = false;
-          ROCKS_LOG_INFO(db_options_.info_log,
-                         "Try to link file %s but it's not supported : %s",
-                         f.internal_file_path.c_str(),
-                         status.ToString().c_str());
+  // Copy/Move external files into DB, on several threads
+  std::atomic<bool> hardlink_files{import_options_.move_files};
+  status = ParallelForEach(
+      file_indexes.size(), import_options_.max_file_preparation_threads,
+      [&](size_t i) {
+        auto& f =
+            files_to_import_[file_indexes[i].first][file_indexes[i].second];
+        const auto path_outside_db = f.external_file_path;
+        const auto path_inside_db = TableFileName(
+            cfd_->ioptions()->cf_paths, f.fd.GetNumber(), f.fd.GetPathId());
+
+        Status s;
+        bool linked = false;
+        if (hardlink_files.load(std::memory_order_relaxed)) {
+          s = fs_->LinkFile(path_outside_db, path_inside_db, IOOptions(),
+                            nullptr);
+          linked = s.ok();
+          if (s.IsNotSupported()) {
+            // Original file is on a different FS, use copy instead of hard
+            // linking
+            hardlink_files.store(false, std::memory_order_relaxed);
+            ROCKS_LOG_INFO(db_options_.info_log,
+                           "Try to link file %s but it's not supported : %s",
+                           path_outside_db.c_str(), s.ToString().c_str());
+          }
         }
-      }
-      if (!hardlink_files) {
-        status =
-            CopyFile(fs_.get(), path_outside_db, path_inside_db, 0,
-                     db_options_.use_fsync, io_tracer_, Temperature::kUnknown);
-      }
-      if (!status.ok()) {
-        break;
-      }
-      f.copy_file = !hardlink_files;
-      f.internal_file_path = path_inside_db;
-    }
-    if (!status.ok()) {
-      break;
-    }
-  }
+        if (!linked && !hardlink_files.load(std::memory_order_relaxed)) {
+          s = CopyFile(fs_.get(), path_outside_db, path_inside_db, 0,
+                       db_options_.use_fsync, io_tracer_,
+                       Temperature::kUnknown);
+        }
+        if (s.ok()) {
+          f.copy_file = !linked;
+          f.internal_file_path = path_inside_db;
+        }
+        return s;
+      });
 
   if (!status.ok()) {
     // We failed, remove all files that we copied into the db
     for (auto& files_to_import_per_cf : files_to_import_) {
       for (auto& f : files_to_import_per_cf) {
         if (f.internal_file_path.empty()) {
-          break;
+          continue;
         }
         const auto s =
             fs_->DeleteFile(f.internal_file_path, IOOptions(), nullptr);
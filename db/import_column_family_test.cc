@@ -453,6 +453,55 @@ TEST_F(ImportColumnFamilyTest, ImportExportedSSTFromAnotherCF) {
   }
 }
 
+TEST_F(ImportColumnFamilyTest, ImportWithFilePreparationThreads) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"koko"}, options);
+
+  // Create some L0 files with overlapping keys
+  for (int f = 0; f < 8; ++f) {
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_OK(Put(1, Key(i), Key(i) + "_val" + std::to_string(f)));
+    }
+    ASSERT_OK(Flush(1));
+  }
+
+  Checkpoint* checkpoint;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+  ASSERT_OK(checkpoint->ExportColumnFamily(handles_[1], export_files_dir_,
+                                           &metadata_ptr_));
+  ASSERT_NE(metadata_ptr_, nullptr);
+  ASSERT_EQ(8, metadata_ptr_->files.size());
+  delete checkpoint;
+
+  ImportColumnFamilyOptions import_options;
+  import_options.max_file_preparation_threads = 4;
+  import_options.move_files = false;
+  ASSERT_OK(db_->CreateColumnFamilyWithImport(options, "toto", import_options,
+                                              *metadata_ptr_, &import_cfh_));
+  ASSERT_NE(import_cfh_, nullptr);
+
+  import_options.move_files = true;
+  ASSERT_OK(db_->CreateColumnFamilyWithImport(options, "yoyo", import_options,
+                                              *metadata_ptr_, &import_cfh2_));
+  ASSERT_NE(import_cfh2_, nullptr);
+  delete metadata_ptr_;
+  metadata_ptr_ = nullptr;
+
+  ColumnFamilyMetaData cf_meta;
+  db_->GetColumnFamilyMetaData(import_cfh_, &cf_meta);
+  ASSERT_EQ(8, cf_meta.file_count);
+  db_->GetColumnFamilyMetaData(import_cfh2_, &cf_meta);
+  ASSERT_EQ(8, cf_meta.file_count);
+  std::string value1, value2;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(db_->Get(ReadOptions(), import_cfh_, Key(i), &value1));
+    ASSERT_EQ(Key(i) + "_val7", value1);
+    ASSERT_OK(db_->Get(ReadOptions(), import_cfh2_, Key(i), &value2));
+    ASSERT_EQ(Key(i) + "_val7", value2);
+  }
+}
+
 TEST_F(ImportColumnFamilyTest, ImportExportedSSTFromAnotherDB) {
   Options options = CurrentOptions();
   CreateAndReopenWithCF({"koko"}, options);
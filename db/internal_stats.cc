@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstddef>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -21,12 +22,16 @@
 
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_entry_stats.h"
+#include "cache/tenant_cache.h"
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
 #include "db/write_stall_stats.h"
 #include "port/port.h"
 #include "rocksdb/system_clock.h"
 #include "rocksdb/table.h"
+#include "rocksdb/utilities/sim_cache.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_cache.h"
 #include "table/block_based/cachable_entry.h"
 #include "util/hash_containers.h"
 #include "util/string_util.h"
@@ -248,13 +253,21 @@ static const std::string cfstats = "cfstats";
 static const std::string cfstats_no_file_histogram =
     "cfstats-no-file-histogram";
 static const std::string cf_file_histogram = "cf-file-histogram";
+static const std::string cf_block_fetch_histogram = "cf-block-fetch-histogram";
 static const std::string cf_write_stall_stats = "cf-write-stall-stats";
+static const std::string cf_write_stall_timeline = "cf-write-stall-timeline";
+static const std::string cf_job_stage_times = "cf-job-stage-times";
 static const std::string dbstats = "dbstats";
 static const std::string db_write_stall_stats = "db-write-stall-stats";
 static const std::string levelstats = "levelstats";
+static const std::string compaction_read_heat = "compaction-read-heat";
+static const std::string block_cache_heat_map = "block-cache-heat-map";
 static const std::string block_cache_entry_stats = "block-cache-entry-stats";
 static const std::string fast_block_cache_entry_stats =
     "fast-block-cache-entry-stats";
+static const std::string block_cache_tenant_stats = "block-cache-tenant-stats";
+static const std::string block_cache_miss_ratio_curve =
+    "block-cache-miss-ratio-curve";
 static const std::string num_immutable_mem_table = "num-immutable-mem-table";
 static const std::string num_immutable_mem_table_flushed =
     "num-immutable-mem-table-flushed";
@@ -305,11 +318,17 @@ static const std::string num_running_flushes = "num-running-flushes";
 static const std::string actual_delayed_write_rate =
     "actual-delayed-write-rate";
 static const std::string is_write_stopped = "is-write-stopped";
+static const std::string write_group_size_limit_bytes =
+    "write-group-size-limit-bytes";
+static const std::string write_group_size_limit_writers =
+    "write-group-size-limit-writers";
 static const std::string estimate_oldest_key_time = "estimate-oldest-key-time";
 static const std::string block_cache_capacity = "block-cache-capacity";
 static const std::string block_cache_usage = "block-cache-usage";
 static const std::string block_cache_pinned_usage = "block-cache-pinned-usage";
 static const std::string options_statistics = "options-statistics";
+static const std::string db_mutex_contention = "db-mutex-contention";
+static const std::string background_queue_stats = "background-queue-stats";
 static const std::string num_blob_files = "num-blob-files";
 static const std::string blob_stats = "blob-stats";
 static const std::string total_blob_file_size = "total-blob-file-size";
@@ -331,16 +350,30 @@ const std::string DB::Properties::kCFStatsNoFileHistogram =
     rocksdb_prefix + cfstats_no_file_histogram;
 const std::string DB::Properties::kCFFileHistogram =
     rocksdb_prefix + cf_file_histogram;
+const std::string DB::Properties::kCFBlockFetchHistogram =
+    rocksdb_prefix + cf_block_fetch_histogram;
 const std::string DB::Properties::kCFWriteStallStats =
     rocksdb_prefix + cf_write_stall_stats;
+const std::string DB::Properties::kCFWriteStallTimeline =
+    rocksdb_prefix + cf_write_stall_timeline;
+const std::string DB::Properties::kCFJobStageTimes =
+    rocksdb_prefix + cf_job_stage_times;
 const std::string DB::Properties::kDBWriteStallStats =
     rocksdb_prefix + db_write_stall_stats;
 const std::string DB::Properties::kDBStats = rocksdb_prefix + dbstats;
 const std::string DB::Properties::kLevelStats = rocksdb_prefix + levelstats;
+const std::string DB::Properties::kCompactionReadHeat =
+    rocksdb_prefix + compaction_read_heat;
+const std::string DB::Properties::kBlockCacheHeatMap =
+    rocksdb_prefix + block_cache_heat_map;
 const std::string DB::Properties::kBlockCacheEntryStats =
     rocksdb_prefix + block_cache_entry_stats;
 const std::string DB::Properties::kFastBlockCacheEntryStats =
     rocksdb_prefix + fast_block_cache_entry_stats;
+const std::string DB::Properties::kBlockCacheTenantStats =
+    rocksdb_prefix + block_cache_tenant_stats;
+const std::string DB::Properties::kBlockCacheMissRatioCurve =
+    rocksdb_prefix + block_cache_miss_ratio_curve;
 const std::string DB::Properties::kNumImmutableMemTable =
     rocksdb_prefix + num_immutable_mem_table;
 const std::string DB::Properties::kNumImmutableMemTableFlushed =
@@ -408,6 +441,10 @@ const std::string DB::Properties::kActualDelayedWriteRate =
     rocksdb_prefix + actual_delayed_write_rate;
 const std::string DB::Properties::kIsWriteStopped =
     rocksdb_prefix + is_write_stopped;
+const std::string DB::Properties::kWriteGroupSizeLimitBytes =
+    rocksdb_prefix + write_group_size_limit_bytes;
+const std::string DB::Properties::kWriteGroupSizeLimitWriters =
+    rocksdb_prefix + write_group_size_limit_writers;
 const std::string DB::Properties::kEstimateOldestKeyTime =
     rocksdb_prefix + estimate_oldest_key_time;
 const std::string DB::Properties::kBlockCacheCapacity =
@@ -418,6 +455,10 @@ const std::string DB::Properties::kBlockCachePinnedUsage =
     rocksdb_prefix + block_cache_pinned_usage;
 const std::string DB::Properties::kOptionsStatistics =
     rocksdb_prefix + options_statistics;
+const std::string DB::Properties::kDBMutexContention =
+    rocksdb_prefix + db_mutex_contention;
+const std::string DB::Properties::kBackgroundQueueStats =
+    rocksdb_prefix + background_queue_stats;
 const std::string DB::Properties::kLiveSstFilesSizeAtTemperature =
     rocksdb_prefix + live_sst_files_size_at_temperature;
 const std::string DB::Properties::kNumBlobFiles =
@@ -439,17 +480,24 @@ const std::string DB::Properties::kBlobCachePinnedUsage =
 const std::string InternalStats::kPeriodicCFStats =
     DB::Properties::kCFStats + ".periodic";
 const int InternalStats::kMaxNoChangePeriodSinceDump = 8;
+const size_t InternalStats::kMaxWriteStallTimelineSize = 64;
 
 const UnorderedMap<std::string, DBPropertyInfo>
     InternalStats::ppt_name_to_info = {
         {DB::Properties::kNumFilesAtLevelPrefix,
-         {false, &InternalStats::HandleNumFilesAtLevel, nullptr, nullptr,
+         {true, &InternalStats::HandleNumFilesAtLevel, nullptr, nullptr,
           nullptr}},
         {DB::Properties::kCompressionRatioAtLevelPrefix,
-         {false, &InternalStats::HandleCompressionRatioAtLevelPrefix, nullptr,
+         {true, &InternalStats::HandleCompressionRatioAtLevelPrefix, nullptr,
           nullptr, nullptr}},
         {DB::Properties::kLevelStats,
-         {false, &InternalStats::HandleLevelStats, nullptr, nullptr, nullptr}},
+         {true, &InternalStats::HandleLevelStats, nullptr, nullptr, nullptr}},
+        {DB::Properties::kCompactionReadHeat,
+         {false, &InternalStats::HandleCompactionReadHeat, nullptr, nullptr,
+          nullptr}},
+        {DB::Properties::kBlockCacheHeatMap,
+         {false, &InternalStats::HandleBlockCacheHeatMap, nullptr, nullptr,
+          nullptr}},
         {DB::Properties::kStats,
          {false, &InternalStats::HandleStats, nullptr, nullptr, nullptr}},
         {DB::Properties::kCFStats,
@@ -464,9 +512,18 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kCFFileHistogram,
          {false, &InternalStats::HandleCFFileHistogram, nullptr, nullptr,
           nullptr}},
+        {DB::Properties::kCFBlockFetchHistogram,
+         {false, &InternalStats::HandleCFBlockFetchHistogram, nullptr, nullptr,
+          nullptr}},
         {DB::Properties::kCFWriteStallStats,
          {false, &InternalStats::HandleCFWriteStallStats, nullptr,
           &InternalStats::HandleCFWriteStallStatsMap, nullptr}},
+        {DB::Properties::kCFWriteStallTimeline,
+         {false, &InternalStats::HandleCFWriteStallTimeline, nullptr,
+          &InternalStats::HandleCFWriteStallTimelineMap, nullptr}},
+        {DB::Properties::kCFJobStageTimes,
+         {false, &InternalStats::HandleCFJobStageTimes, nullptr,
+          &InternalStats::HandleCFJobStageTimesMap, nullptr}},
         {DB::Properties::kDBStats,
          {false, &InternalStats::HandleDBStats, nullptr,
           &InternalStats::HandleDBMapStats, nullptr}},
@@ -479,13 +536,19 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kFastBlockCacheEntryStats,
          {true, &InternalStats::HandleFastBlockCacheEntryStats, nullptr,
           &InternalStats::HandleFastBlockCacheEntryStatsMap, nullptr}},
+        {DB::Properties::kBlockCacheTenantStats,
+         {false, nullptr, nullptr,
+          &InternalStats::HandleBlockCacheTenantStatsMap, nullptr}},
+        {DB::Properties::kBlockCacheMissRatioCurve,
+         {false, &InternalStats::HandleBlockCacheMissRatioCurve, nullptr,
+          &InternalStats::HandleBlockCacheMissRatioCurveMap, nullptr}},
         {DB::Properties::kSSTables,
-         {false, &InternalStats::HandleSsTables, nullptr, nullptr, nullptr}},
+         {true, &InternalStats::HandleSsTables, nullptr, nullptr, nullptr}},
         {DB::Properties::kAggregatedTableProperties,
-         {false, &InternalStats::HandleAggregatedTableProperties, nullptr,
+         {true, &InternalStats::HandleAggregatedTableProperties, nullptr,
           &InternalStats::HandleAggregatedTablePropertiesMap, nullptr}},
         {DB::Properties::kAggregatedTablePropertiesAtLevel,
-         {false, &InternalStats::HandleAggregatedTablePropertiesAtLevel,
+         {true, &InternalStats::HandleAggregatedTablePropertiesAtLevel,
           nullptr, &InternalStats::HandleAggregatedTablePropertiesAtLevelMap,
           nullptr}},
         {DB::Properties::kNumImmutableMemTable,
@@ -586,6 +649,12 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kIsWriteStopped,
          {false, nullptr, &InternalStats::HandleIsWriteStopped, nullptr,
           nullptr}},
+        {DB::Properties::kWriteGroupSizeLimitBytes,
+         {false, nullptr, &InternalStats::HandleWriteGroupSizeLimitBytes,
+          nullptr, nullptr}},
+        {DB::Properties::kWriteGroupSizeLimitWriters,
+         {false, nullptr, &InternalStats::HandleWriteGroupSizeLimitWriters,
+          nullptr, nullptr}},
         {DB::Properties::kEstimateOldestKeyTime,
          {false, nullptr, &InternalStats::HandleEstimateOldestKeyTime, nullptr,
           nullptr}},
@@ -601,6 +670,12 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kOptionsStatistics,
          {true, nullptr, nullptr, nullptr,
           &DBImpl::GetPropertyHandleOptionsStatistics}},
+        {DB::Properties::kDBMutexContention,
+         {true, nullptr, nullptr, nullptr,
+          &DBImpl::GetPropertyHandleDBMutexContention}},
+        {DB::Properties::kBackgroundQueueStats,
+         {true, nullptr, nullptr, nullptr,
+          &DBImpl::GetPropertyHandleBackgroundQueueStats}},
         {DB::Properties::kNumBlobFiles,
          {false, nullptr, &InternalStats::HandleNumBlobFiles, nullptr,
           nullptr}},
@@ -634,6 +709,8 @@ InternalStats::InternalStats(int num_levels, SystemClock* clock,
       comp_stats_(num_levels),
       comp_stats_by_pri_(Env::Priority::TOTAL),
       file_read_latency_(num_levels),
+      block_fetch_latency_(num_levels),
+      block_cache_heat_maps_(num_levels),
       has_cf_change_since_dump_(true),
       bg_error_count_(0),
       number_levels_(num_levels),
@@ -684,12 +761,25 @@ void InternalStats::CollectCacheEntryStats(bool foreground) {
 std::function<void(const Slice& key, Cache::ObjectPtr value, size_t charge,
                    const Cache::CacheItemHelper* helper)>
 InternalStats::CacheEntryRoleStats::GetEntryCallback() {
-  return [&](const Slice& /*key*/, Cache::ObjectPtr /*value*/, size_t charge,
+  const Cache::CacheItemHelper* basic_data_helper =
+      GetCacheItemHelper(BlockType::kData, CacheTier::kVolatileTier);
+  const Cache::CacheItemHelper* full_data_helper =
+      GetCacheItemHelper(BlockType::kData);
+  return [&, basic_data_helper, full_data_helper](
+             const Slice& /*key*/, Cache::ObjectPtr value, size_t charge,
              const Cache::CacheItemHelper* helper) -> void {
     size_t role_idx =
         static_cast<size_t>(helper ? helper->role : CacheEntryRole::kMisc);
     entry_counts[role_idx]++;
     total_charges[role_idx] += charge;
+    if (value != nullptr &&
+        (helper == basic_data_helper || helper == full_data_helper)) {
+      auto* block = static_cast<Block_kData*>(value);
+      if (block->own_bytes() &&
+          block->memory_allocator() != cache_memory_allocator) {
+        far_memory_charge += charge;
+      }
+    }
   };
 }
 
@@ -707,6 +797,7 @@ void InternalStats::CacheEntryRoleStats::BeginCollection(
   table_size = cache->GetTableAddressCount();
   occupancy = cache->GetOccupancyCount();
   hash_seed = cache->GetHashSeed();
+  cache_memory_allocator = cache->memory_allocator();
 }
 
 void InternalStats::CacheEntryRoleStats::EndCollection(
@@ -747,6 +838,10 @@ std::string InternalStats::CacheEntryRoleStats::ToString(
     }
   }
   str << "\n";
+  if (far_memory_charge > 0) {
+    str << "Block cache far memory: " << BytesToHumanString(far_memory_charge)
+        << "\n";
+  }
   return str.str();
 }
 
@@ -761,6 +856,8 @@ void InternalStats::CacheEntryRoleStats::ToMap(
       std::to_string(GetLastDurationMicros() / 1000000.0);
   v[BlockCacheEntryStatsMapKeys::LastCollectionAgeSeconds()] =
       std::to_string((clock->NowMicros() - last_end_time_micros_) / 1000000U);
+  v[BlockCacheEntryStatsMapKeys::FarMemoryBytes()] =
+      std::to_string(far_memory_charge);
   for (size_t i = 0; i < kNumCacheEntryRoles; ++i) {
     auto role = static_cast<CacheEntryRole>(i);
     v[BlockCacheEntryStatsMapKeys::EntryCount(role)] =
@@ -797,27 +894,32 @@ bool InternalStats::HandleBlockCacheEntryStatsMapInternal(
 }
 
 bool InternalStats::HandleBlockCacheEntryStats(std::string* value,
-                                               Slice /*suffix*/) {
+                                               Slice /*suffix*/,
+                                               Version* /*version*/) {
   return HandleBlockCacheEntryStatsInternal(value, false /* fast */);
 }
 
 bool InternalStats::HandleBlockCacheEntryStatsMap(
-    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+    std::map<std::string, std::string>* values, Slice /*suffix*/,
+    Version* /*version*/) {
   return HandleBlockCacheEntryStatsMapInternal(values, false /* fast */);
 }
 
 bool InternalStats::HandleFastBlockCacheEntryStats(std::string* value,
-                                                   Slice /*suffix*/) {
+                                                   Slice /*suffix*/,
+                                                   Version* /*version*/) {
   return HandleBlockCacheEntryStatsInternal(value, true /* fast */);
 }
 
 bool InternalStats::HandleFastBlockCacheEntryStatsMap(
-    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+    std::map<std::string, std::string>* values, Slice /*suffix*/,
+    Version* /*version*/) {
   return HandleBlockCacheEntryStatsMapInternal(values, true /* fast */);
 }
 
 bool InternalStats::HandleLiveSstFilesSizeAtTemperature(std::string* value,
-                                                        Slice suffix) {
+                                                        Slice suffix,
+                                                        Version* /*version*/) {
   uint64_t temperature;
   bool ok = ConsumeDecimalNumber(&suffix, &temperature) && suffix.empty();
   if (!ok) {
@@ -856,7 +958,8 @@ bool InternalStats::HandleNumBlobFiles(uint64_t* value, DBImpl* /*db*/,
   return true;
 }
 
-bool InternalStats::HandleBlobStats(std::string* value, Slice /*suffix*/) {
+bool InternalStats::HandleBlobStats(std::string* value, Slice /*suffix*/,
+                                    Version* /*version*/) {
   assert(value);
   assert(cfd_);
 
@@ -968,20 +1071,21 @@ const DBPropertyInfo* GetPropertyInfo(const Slice& property) {
 
 bool InternalStats::GetStringProperty(const DBPropertyInfo& property_info,
                                       const Slice& property,
-                                      std::string* value) {
+                                      std::string* value, Version* version) {
   assert(value != nullptr);
   assert(property_info.handle_string != nullptr);
   Slice arg = GetPropertyNameAndArg(property).second;
-  return (this->*(property_info.handle_string))(value, arg);
+  return (this->*(property_info.handle_string))(value, arg, version);
 }
 
 bool InternalStats::GetMapProperty(const DBPropertyInfo& property_info,
                                    const Slice& property,
-                                   std::map<std::string, std::string>* value) {
+                                   std::map<std::string, std::string>* value,
+                                   Version* version) {
   assert(value != nullptr);
   assert(property_info.handle_map != nullptr);
   Slice arg = GetPropertyNameAndArg(property).second;
-  return (this->*(property_info.handle_map))(value, arg);
+  return (this->*(property_info.handle_map))(value, arg, version);
 }
 
 bool InternalStats::GetIntProperty(const DBPropertyInfo& property_info,
@@ -1001,9 +1105,11 @@ bool InternalStats::GetIntPropertyOutOfMutex(
   return (this->*(property_info.handle_int))(value, nullptr /* db */, version);
 }
 
-bool InternalStats::HandleNumFilesAtLevel(std::string* value, Slice suffix) {
+bool InternalStats::HandleNumFilesAtLevel(std::string* value, Slice suffix,
+                                          Version* version) {
+  assert(version != nullptr);
   uint64_t level;
-  const auto* vstorage = cfd_->current()->storage_info();
+  const auto* vstorage = version->storage_info();
   bool ok = ConsumeDecimalNumber(&suffix, &level) && suffix.empty();
   if (!ok || static_cast<int>(level) >= number_levels_) {
     return false;
@@ -1017,9 +1123,11 @@ bool InternalStats::HandleNumFilesAtLevel(std::string* value, Slice suffix) {
 }
 
 bool InternalStats::HandleCompressionRatioAtLevelPrefix(std::string* value,
-                                                        Slice suffix) {
+                                                        Slice suffix,
+                                                        Version* version) {
+  assert(version != nullptr);
   uint64_t level;
-  const auto* vstorage = cfd_->current()->storage_info();
+  const auto* vstorage = version->storage_info();
   bool ok = ConsumeDecimalNumber(&suffix, &level) && suffix.empty();
   if (!ok || level >= static_cast<uint64_t>(number_levels_)) {
     return false;
@@ -1029,9 +1137,11 @@ bool InternalStats::HandleCompressionRatioAtLevelPrefix(std::string* value,
   return true;
 }
 
-bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/) {
+bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/,
+                                     Version* version) {
+  assert(version != nullptr);
   char buf[1000];
-  const auto* vstorage = cfd_->current()->storage_info();
+  const auto* vstorage = version->storage_info();
   snprintf(buf, sizeof(buf),
            "Level Files Size(MB)\n"
            "--------------------\n");
@@ -1046,29 +1156,120 @@ bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/) {
   return true;
 }
 
-bool InternalStats::HandleStats(std::string* value, Slice suffix) {
-  if (!HandleCFStats(value, suffix)) {
+bool InternalStats::HandleCompactionReadHeat(std::string* value,
+                                             Slice /*suffix*/,
+                                             Version* /*version*/) {
+  char buf[1000];
+  const auto* vstorage = cfd_->current()->storage_info();
+  snprintf(buf, sizeof(buf),
+           "Level      Reads  Heat  Score\n"
+           "-----------------------------\n");
+  value->append(buf);
+
+  // Compaction scores are sorted based on its value. Restore them to the
+  // level order
+  std::vector<double> compaction_score(number_levels_, 0);
+  for (int i = 0; i <= vstorage->MaxInputLevel(); ++i) {
+    compaction_score[vstorage->CompactionScoreLevel(i)] =
+        vstorage->CompactionScore(i);
+  }
+  std::vector<uint64_t> level_reads(number_levels_);
+  uint64_t total_reads = 0;
+  for (int level = 0; level < number_levels_; level++) {
+    level_reads[level] = vstorage->NumLevelReadsSampled(level);
+    total_reads += level_reads[level];
+  }
+  for (int level = 0; level < number_levels_; level++) {
+    double heat = total_reads > 0 ? static_cast<double>(level_reads[level]) /
+                                        static_cast<double>(total_reads)
+                                  : 0;
+    snprintf(buf, sizeof(buf), "%3d %12" PRIu64 " %5.2f %6.2f\n", level,
+             level_reads[level], heat, compaction_score[level]);
+    value->append(buf);
+  }
+  return true;
+}
+
+bool InternalStats::HandleBlockCacheHeatMap(std::string* value,
+                                            Slice /*suffix*/,
+                                            Version* /*version*/) {
+  char buf[200];
+  const auto* vstorage = cfd_->current()->storage_info();
+  snprintf(buf, sizeof(buf),
+           "One in %u block cache lookups sampled\n"
+           "Level       File       Hits     Misses  Key range\n"
+           "---------------------------------------------------\n",
+           cfd_->ioptions()->block_cache_heat_sample_one_in);
+  value->append(buf);
+
+  for (int level = 0; level < number_levels_; level++) {
+    std::map<uint64_t, BlockCacheHeatMap::Counts> file_counts;
+    BlockCacheHeatMap::Counts untracked;
+    block_cache_heat_maps_[level].GetCounts(&file_counts, &untracked);
+    // In the order of the files in the level, i.e. by key range below L0
+    for (const auto* f : vstorage->LevelFiles(level)) {
+      auto it = file_counts.find(f->fd.GetNumber());
+      if (it == file_counts.end()) {
+        continue;
+      }
+      snprintf(buf, sizeof(buf),
+               "%5d %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "  ", level,
+               it->first, it->second.hits, it->second.misses);
+      value->append(buf);
+      value->append("[" + f->smallest.user_key().ToString(true) + ", " +
+                    f->largest.user_key().ToString(true) + "]\n");
+      file_counts.erase(it);
+    }
+    // Files moved to other levels by now
+    for (const auto& moved : file_counts) {
+      untracked.hits += moved.second.hits;
+      untracked.misses += moved.second.misses;
+    }
+    if (untracked.hits + untracked.misses > 0) {
+      snprintf(buf, sizeof(buf),
+               "%5d  untracked %10" PRIu64 " %10" PRIu64 "\n", level,
+               untracked.hits, untracked.misses);
+      value->append(buf);
+    }
+  }
+  return true;
+}
+
+void InternalStats::PruneBlockCacheHeatMaps(
+    const VersionStorageInfo& vstorage) {
+  for (auto& heat_map : block_cache_heat_maps_) {
+    heat_map.Prune([&vstorage](uint64_t file_number) {
+      return vstorage.GetFileLocation(file_number).IsValid();
+    });
+  }
+}
+
+bool InternalStats::HandleStats(std::string* value, Slice suffix,
+                                Version* /*version*/) {
+  if (!HandleCFStats(value, suffix, nullptr /* version */)) {
     return false;
   }
-  if (!HandleDBStats(value, suffix)) {
+  if (!HandleDBStats(value, suffix, nullptr /* version */)) {
     return false;
   }
   return true;
 }
 
 bool InternalStats::HandleCFMapStats(
-    std::map<std::string, std::string>* cf_stats, Slice /*suffix*/) {
+    std::map<std::string, std::string>* cf_stats, Slice /*suffix*/,
+    Version* /*version*/) {
   DumpCFMapStats(cf_stats);
   return true;
 }
 
-bool InternalStats::HandleCFStats(std::string* value, Slice /*suffix*/) {
+bool InternalStats::HandleCFStats(std::string* value, Slice /*suffix*/,
+                                  Version* /*version*/) {
   DumpCFStats(value);
   return true;
 }
 
-bool InternalStats::HandleCFStatsPeriodic(std::string* value,
-                                          Slice /*suffix*/) {
+bool InternalStats::HandleCFStatsPeriodic(std::string* value, Slice /*suffix*/,
+                                          Version* /*version*/) {
   bool has_change = has_cf_change_since_dump_;
   if (!has_change) {
     // If file histogram changes, there is activity in this period too.
@@ -1100,64 +1301,167 @@ bool InternalStats::HandleCFStatsPeriodic(std::string* value,
 }
 
 bool InternalStats::HandleCFStatsNoFileHistogram(std::string* value,
-                                                 Slice /*suffix*/) {
+                                                 Slice /*suffix*/,
+                                                 Version* /*version*/) {
   DumpCFStatsNoFileHistogram(/*is_periodic=*/false, value);
   return true;
 }
 
-bool InternalStats::HandleCFFileHistogram(std::string* value,
-                                          Slice /*suffix*/) {
+bool InternalStats::HandleCFFileHistogram(std::string* value, Slice /*suffix*/,
+                                          Version* /*version*/) {
   DumpCFFileHistogram(value);
   return true;
 }
 
+bool InternalStats::HandleCFBlockFetchHistogram(std::string* value,
+                                                Slice /*suffix*/,
+                                                Version* /*version*/) {
+  DumpCFBlockFetchHistogram(value);
+  return true;
+}
+
 bool InternalStats::HandleCFWriteStallStats(std::string* value,
-                                            Slice /*suffix*/) {
+                                            Slice /*suffix*/,
+                                            Version* /*version*/) {
   DumpCFStatsWriteStall(value);
   return true;
 }
 
 bool InternalStats::HandleCFWriteStallStatsMap(
-    std::map<std::string, std::string>* value, Slice /*suffix*/) {
+    std::map<std::string, std::string>* value, Slice /*suffix*/,
+    Version* /*version*/) {
   DumpCFMapStatsWriteStall(value);
   return true;
 }
 
+bool InternalStats::HandleCFWriteStallTimeline(std::string* value,
+                                               Slice /*suffix*/,
+                                               Version* /*version*/) {
+  std::ostringstream str;
+  for (const auto& stall : write_stall_timeline_) {
+    str << "start-micros: " << stall.start_micros
+        << ", end-micros: " << stall.end_micros << ", condition: "
+        << WriteStallConditionToHyphenString(stall.condition)
+        << ", cause: " << WriteStallCauseToHyphenString(stall.cause)
+        << ", pending-compaction-bytes: " << stall.pending_compaction_bytes
+        << ", l0-files: " << stall.num_l0_files
+        << ", unflushed-memtables: " << stall.num_unflushed_memtables
+        << ", memtables-being-flushed: " << stall.num_memtables_being_flushed
+        << ", running-compactions: " << stall.num_running_compactions
+        << ", running-l0-compactions: " << stall.num_running_l0_compactions
+        << "\n";
+  }
+  *value = str.str();
+  return true;
+}
+
+bool InternalStats::HandleCFWriteStallTimelineMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/,
+    Version* /*version*/) {
+  // The keys are "<index>.<field>", where the zero-padded index of a stall
+  // orders the stalls from the oldest one
+  char buf[16];
+  size_t index = 0;
+  for (const auto& stall : write_stall_timeline_) {
+    snprintf(buf, sizeof(buf), "%03" ROCKSDB_PRIszt ".", index++);
+    const std::string prefix = buf;
+    (*values)[prefix + "start-micros"] = std::to_string(stall.start_micros);
+    (*values)[prefix + "end-micros"] = std::to_string(stall.end_micros);
+    (*values)[prefix + "condition"] =
+        WriteStallConditionToHyphenString(stall.condition);
+    (*values)[prefix + "cause"] = WriteStallCauseToHyphenString(stall.cause);
+    (*values)[prefix + "pending-compaction-bytes"] =
+        std::to_string(stall.pending_compaction_bytes);
+    (*values)[prefix + "l0-files"] = std::to_string(stall.num_l0_files);
+    (*values)[prefix + "unflushed-memtables"] =
+        std::to_string(stall.num_unflushed_memtables);
+    (*values)[prefix + "memtables-being-flushed"] =
+        std::to_string(stall.num_memtables_being_flushed);
+    (*values)[prefix + "running-compactions"] =
+        std::to_string(stall.num_running_compactions);
+    (*values)[prefix + "running-l0-compactions"] =
+        std::to_string(stall.num_running_l0_compactions);
+  }
+  return true;
+}
+
+bool InternalStats::HandleCFJobStageTimes(std::string* value, Slice /*suffix*/,
+                                          Version* /*version*/) {
+  std::ostringstream str;
+  for (int i = ThreadStatus::STAGE_UNKNOWN + 1; i < ThreadStatus::NUM_OP_STAGES;
+       ++i) {
+    if (job_stage_times_.elapsed_micros[i] == 0) {
+      continue;
+    }
+    str << ThreadStatus::GetOperationStageName(
+               static_cast<ThreadStatus::OperationStage>(i))
+        << ": cpu-micros: " << job_stage_times_.cpu_micros[i]
+        << ", elapsed-micros: " << job_stage_times_.elapsed_micros[i] << "\n";
+  }
+  *value = str.str();
+  return true;
+}
+
+bool InternalStats::HandleCFJobStageTimesMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/,
+    Version* /*version*/) {
+  for (int i = ThreadStatus::STAGE_UNKNOWN + 1; i < ThreadStatus::NUM_OP_STAGES;
+       ++i) {
+    if (job_stage_times_.elapsed_micros[i] == 0) {
+      continue;
+    }
+    const std::string& name = ThreadStatus::GetOperationStageName(
+        static_cast<ThreadStatus::OperationStage>(i));
+    (*values)[name + ".cpu-micros"] =
+        std::to_string(job_stage_times_.cpu_micros[i]);
+    (*values)[name + ".elapsed-micros"] =
+        std::to_string(job_stage_times_.elapsed_micros[i]);
+  }
+  return true;
+}
+
 bool InternalStats::HandleDBMapStats(
-    std::map<std::string, std::string>* db_stats, Slice /*suffix*/) {
+    std::map<std::string, std::string>* db_stats, Slice /*suffix*/,
+    Version* /*version*/) {
   DumpDBMapStats(db_stats);
   return true;
 }
 
-bool InternalStats::HandleDBStats(std::string* value, Slice /*suffix*/) {
+bool InternalStats::HandleDBStats(std::string* value, Slice /*suffix*/,
+                                  Version* /*version*/) {
   DumpDBStats(value);
   return true;
 }
 
 bool InternalStats::HandleDBWriteStallStats(std::string* value,
-                                            Slice /*suffix*/) {
+                                            Slice /*suffix*/,
+                                            Version* /*version*/) {
   DumpDBStatsWriteStall(value);
   return true;
 }
 
 bool InternalStats::HandleDBWriteStallStatsMap(
-    std::map<std::string, std::string>* value, Slice /*suffix*/) {
+    std::map<std::string, std::string>* value, Slice /*suffix*/,
+    Version* /*version*/) {
   DumpDBMapStatsWriteStall(value);
   return true;
 }
 
-bool InternalStats::HandleSsTables(std::string* value, Slice /*suffix*/) {
-  auto* current = cfd_->current();
-  *value = current->DebugString(true, true);
+bool InternalStats::HandleSsTables(std::string* value, Slice /*suffix*/,
+                                   Version* version) {
+  assert(version != nullptr);
+  *value = version->DebugString(true, true);
   return true;
 }
 
 bool InternalStats::HandleAggregatedTableProperties(std::string* value,
-                                                    Slice /*suffix*/) {
+                                                    Slice /*suffix*/,
+                                                    Version* version) {
+  assert(version != nullptr);
   std::shared_ptr<const TableProperties> tp;
   // TODO: plumb Env::IOActivity
   const ReadOptions read_options;
-  auto s = cfd_->current()->GetAggregatedTableProperties(read_options, &tp);
+  auto s = version->GetAggregatedTableProperties(read_options, &tp);
   if (!s.ok()) {
     return false;
   }
@@ -1175,11 +1479,13 @@ static std::map<std::string, std::string> MapUint64ValuesToString(
 }
 
 bool InternalStats::HandleAggregatedTablePropertiesMap(
-    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+    std::map<std::string, std::string>* values, Slice /*suffix*/,
+    Version* version) {
+  assert(version != nullptr);
   std::shared_ptr<const TableProperties> tp;
   // TODO: plumb Env::IOActivity
   const ReadOptions read_options;
-  auto s = cfd_->current()->GetAggregatedTableProperties(read_options, &tp);
+  auto s = version->GetAggregatedTableProperties(read_options, &tp);
   if (!s.ok()) {
     return false;
   }
@@ -1187,8 +1493,9 @@ bool InternalStats::HandleAggregatedTablePropertiesMap(
   return true;
 }
 
-bool InternalStats::HandleAggregatedTablePropertiesAtLevel(std::string* values,
-                                                           Slice suffix) {
+bool InternalStats::HandleAggregatedTablePropertiesAtLevel(
+    std::string* values, Slice suffix, Version* version) {
+  assert(version != nullptr);
   uint64_t level;
   bool ok = ConsumeDecimalNumber(&suffix, &level) && suffix.empty();
   if (!ok || static_cast<int>(level) >= number_levels_) {
@@ -1197,8 +1504,8 @@ bool InternalStats::HandleAggregatedTablePropertiesAtLevel(std::string* values,
   std::shared_ptr<const TableProperties> tp;
   // TODO: plumb Env::IOActivity
   const ReadOptions read_options;
-  auto s = cfd_->current()->GetAggregatedTableProperties(
-      read_options, &tp, static_cast<int>(level));
+  auto s = version->GetAggregatedTableProperties(read_options, &tp,
+                                                static_cast<int>(level));
   if (!s.ok()) {
     return false;
   }
@@ -1207,7 +1514,9 @@ bool InternalStats::HandleAggregatedTablePropertiesAtLevel(std::string* values,
 }
 
 bool InternalStats::HandleAggregatedTablePropertiesAtLevelMap(
-    std::map<std::string, std::string>* values, Slice suffix) {
+    std::map<std::string, std::string>* values, Slice suffix,
+    Version* version) {
+  assert(version != nullptr);
   uint64_t level;
   bool ok = ConsumeDecimalNumber(&suffix, &level) && suffix.empty();
   if (!ok || static_cast<int>(level) >= number_levels_) {
@@ -1216,8 +1525,8 @@ bool InternalStats::HandleAggregatedTablePropertiesAtLevelMap(
   std::shared_ptr<const TableProperties> tp;
   // TODO: plumb Env::IOActivity
   const ReadOptions read_options;
-  auto s = cfd_->current()->GetAggregatedTableProperties(
-      read_options, &tp, static_cast<int>(level));
+  auto s = version->GetAggregatedTableProperties(read_options, &tp,
+                                                static_cast<int>(level));
   if (!s.ok()) {
     return false;
   }
@@ -1463,6 +1772,19 @@ bool InternalStats::HandleIsWriteStopped(uint64_t* value, DBImpl* db,
   return true;
 }
 
+bool InternalStats::HandleWriteGroupSizeLimitBytes(uint64_t* value, DBImpl* db,
+                                                   Version* /*version*/) {
+  *value = db->write_thread().GetGroupSizeLimitBytes();
+  return true;
+}
+
+bool InternalStats::HandleWriteGroupSizeLimitWriters(uint64_t* value,
+                                                     DBImpl* db,
+                                                     Version* /*version*/) {
+  *value = db->write_thread().GetGroupSizeLimitWriters();
+  return true;
+}
+
 bool InternalStats::HandleEstimateOldestKeyTime(uint64_t* value, DBImpl* /*db*/,
                                                 Version* /*version*/) {
   // TODO(yiwu): The property is currently available for fifo compaction
@@ -1530,6 +1852,68 @@ bool InternalStats::HandleBlockCachePinnedUsage(uint64_t* value, DBImpl* /*db*/,
   return false;
 }
 
+bool InternalStats::HandleBlockCacheTenantStatsMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/,
+    Version* /*version*/) {
+  Cache* block_cache = GetBlockCacheForStats();
+  if (!block_cache ||
+      std::strcmp(block_cache->Name(), TenantCache::kClassName()) != 0) {
+    return false;
+  }
+  auto* tenant_cache = static_cast<TenantCache*>(block_cache);
+  values->clear();
+  (*values)["tenant-id"] = tenant_cache->GetTenantId();
+  (*values)["usage"] = std::to_string(tenant_cache->GetUsage());
+  (*values)["capacity"] = std::to_string(tenant_cache->GetCapacity());
+  (*values)["min-usage"] = std::to_string(tenant_cache->GetMinUsage());
+  (*values)["max-usage"] = std::to_string(tenant_cache->GetMaxUsage());
+  (*values)["reserved"] = std::to_string(tenant_cache->GetReservedUsage());
+  return true;
+}
+
+bool InternalStats::GetBlockCacheMissRatioCurve(
+    std::map<uint64_t, double>* curve) {
+  Cache* block_cache = GetBlockCacheForStats();
+  if (!block_cache ||
+      std::strcmp(block_cache->Name(), SimCache::kClassName()) != 0) {
+    return false;
+  }
+  *curve = static_cast<SimCache*>(block_cache)->GetMissRatioCurve();
+  return true;
+}
+
+bool InternalStats::HandleBlockCacheMissRatioCurve(std::string* value,
+                                                   Slice /*suffix*/,
+                                                   Version* /*version*/) {
+  std::map<uint64_t, double> curve;
+  if (!GetBlockCacheMissRatioCurve(&curve)) {
+    return false;
+  }
+  char buf[100];
+  snprintf(buf, sizeof(buf), "%20s %10s\n", "Capacity(bytes)", "MissRatio");
+  value->append(buf);
+  for (const auto& point : curve) {
+    snprintf(buf, sizeof(buf), "%20" PRIu64 " %10.4f\n", point.first,
+             point.second);
+    value->append(buf);
+  }
+  return true;
+}
+
+bool InternalStats::HandleBlockCacheMissRatioCurveMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/,
+    Version* /*version*/) {
+  std::map<uint64_t, double> curve;
+  if (!GetBlockCacheMissRatioCurve(&curve)) {
+    return false;
+  }
+  values->clear();
+  for (const auto& point : curve) {
+    (*values)[std::to_string(point.first)] = std::to_string(point.second);
+  }
+  return true;
+}
+
 void InternalStats::DumpDBMapStats(
     std::map<std::string, std::string>* db_stats) {
   for (int i = 0; i < static_cast<int>(kIntStatsNumMax); ++i) {
@@ -2129,5 +2513,33 @@ void InternalStats::DumpCFFileHistogram(std::string* value) {
   value->append(oss.str());
 }
 
+void InternalStats::DumpCFBlockFetchHistogram(std::string* value) {
+  assert(value);
+  assert(cfd_);
+
+  std::ostringstream oss;
+  oss << "\n** Block Fetch Latency Histogram By Level [" << cfd_->GetName()
+      << "] **\n";
+
+  for (int level = 0; level < number_levels_; level++) {
+    const BlockFetchHistograms& hists = block_fetch_latency_[level];
+    for (int op = 0; op < BlockFetchHistograms::kNumOperations; ++op) {
+      const char* op_name = BlockFetchHistograms::OperationName(op);
+      if (!hists.cache_hit[op].Empty()) {
+        oss << "** Level " << level << " " << op_name
+            << " block cache hit latency histogram (micros):\n"
+            << hists.cache_hit[op].ToString() << '\n';
+      }
+      if (!hists.cache_miss[op].Empty()) {
+        oss << "** Level " << level << " " << op_name
+            << " block cache miss latency histogram (micros):\n"
+            << hists.cache_miss[op].ToString() << '\n';
+      }
+    }
+  }
+
+  value->append(oss.str());
+}
+
 
 }  // namespace ROCKSDB_NAMESPACE
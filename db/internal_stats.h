@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
@@ -17,7 +18,11 @@
 
 #include "cache/cache_entry_roles.h"
 #include "db/version_set.h"
+#include "monitoring/thread_status_updater.h"
+#include "rocksdb/listener.h"
 #include "rocksdb/system_clock.h"
+#include "table/block_cache_heat_map.h"
+#include "table/block_fetch_histograms.h"
 #include "util/hash_containers.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -39,19 +44,22 @@ struct DBPropertyInfo {
   // @param suffix Argument portion of the property. For example, suffix would
   //      be "5" for the property "rocksdb.num-files-at-level5". So far, only
   //      certain string properties take an argument.
-  bool (InternalStats::*handle_string)(std::string* value, Slice suffix);
+  // @param version Version is needed in case the property is retrieved without
+  //      holding db mutex.
+  bool (InternalStats::*handle_string)(std::string* value, Slice suffix,
+                                       Version* version);
 
   // @param value Value-result argument for storing the property's uint64 value
   // @param db Many of the int properties rely on DBImpl methods.
-  // @param version Version is needed in case the property is retrieved without
-  //      holding db mutex, which is only supported for int properties.
+  // @param version (see handle_string)
   bool (InternalStats::*handle_int)(uint64_t* value, DBImpl* db,
                                     Version* version);
 
   // @param props Map of general properties to populate
   // @param suffix Argument portion of the property. (see handle_string)
+  // @param version (see handle_string)
   bool (InternalStats::*handle_map)(std::map<std::string, std::string>* props,
-                                    Slice suffix);
+                                    Slice suffix, Version* version);
 
   // handle the string type properties rely on DBImpl methods
   // @param value Value-result argument for storing the property's string value
@@ -474,6 +482,10 @@ class InternalStats {
     std::string cache_id;
     std::array<uint64_t, kNumCacheEntryRoles> total_charges;
     std::array<size_t, kNumCacheEntryRoles> entry_counts;
+    // Charge of the data blocks not allocated from the cache's memory
+    // allocator, so from BlockBasedTableOptions::far_memory_allocator
+    uint64_t far_memory_charge = 0;
+    MemoryAllocator* cache_memory_allocator = nullptr;
     uint32_t collection_count = 0;
     uint32_t copies_of_last_collection = 0;
     uint64_t last_start_time_micros_ = 0;
@@ -518,6 +530,17 @@ class InternalStats {
       h.Clear();
     }
     blob_file_read_latency_.Clear();
+    for (auto& h : block_fetch_latency_) {
+      h.Clear();
+    }
+    for (auto& heat_map : block_cache_heat_maps_) {
+      heat_map.Clear();
+    }
+    job_stage_times_ = ThreadStageTimes();
+    // Keep the ongoing write stall, so that it can be ended
+    write_stall_timeline_.erase(
+        write_stall_timeline_.begin(),
+        write_stall_timeline_.end() - (write_stall_ongoing_ ? 1 : 0));
     cf_stats_snapshot_.Clear();
     db_stats_snapshot_.Clear();
     bg_error_count_ = 0;
@@ -544,6 +567,20 @@ class InternalStats {
     comp_stats_[level].bytes_moved += amount;
   }
 
+  // The bytes written to the SST files of the column family per byte written
+  // to level 0, mostly by flushes, or 0 if none was
+  double GetTableWriteAmplification() const {
+    if (comp_stats_.empty() || comp_stats_[0].bytes_written == 0) {
+      return 0;
+    }
+    uint64_t bytes_written = 0;
+    for (const auto& stats : comp_stats_) {
+      bytes_written += stats.bytes_written;
+    }
+    return static_cast<double>(bytes_written) /
+           static_cast<double>(comp_stats_[0].bytes_written);
+  }
+
   void AddCFStats(InternalCFStatsType type, uint64_t value) {
     has_cf_change_since_dump_ = true;
     cf_stats_value_[type] += value;
@@ -571,16 +608,64 @@ class InternalStats {
 
   HistogramImpl* GetBlobFileReadHist() { return &blob_file_read_latency_; }
 
+  // The histograms of each level, for TableCache::SetBlockFetchHistograms()
+  BlockFetchHistograms* GetBlockFetchHists() {
+    return block_fetch_latency_.data();
+  }
+
+  // The heat map of each level, for TableCache::SetBlockCacheHeatMaps()
+  BlockCacheHeatMap* GetBlockCacheHeatMaps() {
+    return block_cache_heat_maps_.data();
+  }
+
+  // Drops the block cache samples of the files no longer in `vstorage`
+  // REQUIRES: DB mutex held
+  void PruneBlockCacheHeatMaps(const VersionStorageInfo& vstorage);
+
+  // Adds the time the thread of a flush or compaction job of the CF spent in
+  // each operation stage during the job
+  // REQUIRES: DB mutex held
+  void AddJobStageTimes(const ThreadStageTimes& times) {
+    job_stage_times_.Add(times);
+  }
+
+  // Returns the ongoing write stall of the CF, or nullptr if writes are not
+  // stalled.
+  // REQUIRES: DB mutex held
+  WriteStallDetailInfo* GetOngoingWriteStall() {
+    return write_stall_ongoing_ ? &write_stall_timeline_.back() : nullptr;
+  }
+
+  // Ends the ongoing write stall, if any, and adds `stall` as the ongoing
+  // one unless its condition is kNormal. Only the last
+  // kMaxWriteStallTimelineSize stalls are kept.
+  // REQUIRES: DB mutex held
+  void AddWriteStall(const WriteStallDetailInfo& stall) {
+    write_stall_ongoing_ = false;
+    if (stall.condition == WriteStallCondition::kNormal) {
+      return;
+    }
+    if (write_stall_timeline_.size() >= kMaxWriteStallTimelineSize) {
+      write_stall_timeline_.pop_front();
+    }
+    write_stall_timeline_.push_back(stall);
+    write_stall_ongoing_ = true;
+  }
+
   uint64_t GetBackgroundErrorCount() const { return bg_error_count_; }
 
   uint64_t BumpAndGetBackgroundErrorCount() { return ++bg_error_count_; }
 
+  // `version` is the referenced current version for properties retrieved
+  // without holding db mutex
   bool GetStringProperty(const DBPropertyInfo& property_info,
-                         const Slice& property, std::string* value);
+                         const Slice& property, std::string* value,
+                         Version* version = nullptr);
 
   bool GetMapProperty(const DBPropertyInfo& property_info,
                       const Slice& property,
-                      std::map<std::string, std::string>* value);
+                      std::map<std::string, std::string>* value,
+                      Version* version = nullptr);
 
   bool GetIntProperty(const DBPropertyInfo& property_info, uint64_t* value,
                       DBImpl* db);
@@ -634,12 +719,15 @@ class InternalStats {
   // if is_periodic = true, it is an internal call by RocksDB periodically to
   // dump the status.
   void DumpCFFileHistogram(std::string* value);
+  void DumpCFBlockFetchHistogram(std::string* value);
 
   void DumpCFMapStatsWriteStall(std::map<std::string, std::string>* value);
   void DumpCFStatsWriteStall(std::string* value,
                              uint64_t* total_stall_count = nullptr);
 
   Cache* GetBlockCacheForStats();
+  // The miss ratio curve estimated by the block cache, if a SimCache
+  bool GetBlockCacheMissRatioCurve(std::map<uint64_t, double>* curve);
   Cache* GetBlobCacheForStats();
 
   // Per-DB stats
@@ -660,6 +748,14 @@ class InternalStats {
   CompactionStats per_key_placement_comp_stats_;
   std::vector<HistogramImpl> file_read_latency_;
   HistogramImpl blob_file_read_latency_;
+  std::vector<BlockFetchHistograms> block_fetch_latency_;
+  std::vector<BlockCacheHeatMap> block_cache_heat_maps_;
+  // See AddJobStageTimes()
+  ThreadStageTimes job_stage_times_;
+  // The last write stalls of the CF, oldest first
+  std::deque<WriteStallDetailInfo> write_stall_timeline_;
+  bool write_stall_ongoing_ = false;
+  static const size_t kMaxWriteStallTimelineSize;
   bool has_cf_change_since_dump_;
   // How many periods of no change since the last time stats are dumped for
   // a periodic dump.
@@ -757,32 +853,57 @@ class InternalStats {
 
   // Handler functions for getting property values. They use "value" as a value-
   // result argument, and return true upon successfully setting "value".
-  bool HandleNumFilesAtLevel(std::string* value, Slice suffix);
-  bool HandleCompressionRatioAtLevelPrefix(std::string* value, Slice suffix);
-  bool HandleLevelStats(std::string* value, Slice suffix);
-  bool HandleStats(std::string* value, Slice suffix);
+  bool HandleNumFilesAtLevel(std::string* value, Slice suffix,
+                             Version* version);
+  bool HandleCompressionRatioAtLevelPrefix(std::string* value, Slice suffix,
+                                           Version* version);
+  bool HandleLevelStats(std::string* value, Slice suffix, Version* version);
+  bool HandleCompactionReadHeat(std::string* value, Slice suffix,
+                                Version* version);
+  bool HandleBlockCacheHeatMap(std::string* value, Slice suffix,
+                               Version* version);
+  bool HandleStats(std::string* value, Slice suffix, Version* version);
   bool HandleCFMapStats(std::map<std::string, std::string>* compaction_stats,
-                        Slice suffix);
-  bool HandleCFStats(std::string* value, Slice suffix);
-  bool HandleCFStatsNoFileHistogram(std::string* value, Slice suffix);
-  bool HandleCFFileHistogram(std::string* value, Slice suffix);
-  bool HandleCFStatsPeriodic(std::string* value, Slice suffix);
-  bool HandleCFWriteStallStats(std::string* value, Slice suffix);
+                        Slice suffix, Version* version);
+  bool HandleCFStats(std::string* value, Slice suffix, Version* version);
+  bool HandleCFStatsNoFileHistogram(std::string* value, Slice suffix,
+                                    Version* version);
+  bool HandleCFFileHistogram(std::string* value, Slice suffix,
+                             Version* version);
+  bool HandleCFBlockFetchHistogram(std::string* value, Slice suffix,
+                                   Version* version);
+  bool HandleCFStatsPeriodic(std::string* value, Slice suffix,
+                             Version* version);
+  bool HandleCFWriteStallStats(std::string* value, Slice suffix,
+                               Version* version);
   bool HandleCFWriteStallStatsMap(std::map<std::string, std::string>* values,
-                                  Slice suffix);
+                                  Slice suffix, Version* version);
+  bool HandleCFWriteStallTimeline(std::string* value, Slice suffix,
+                                  Version* version);
+  bool HandleCFJobStageTimes(std::string* value, Slice suffix,
+                             Version* version);
+  bool HandleCFJobStageTimesMap(std::map<std::string, std::string>* values,
+                                Slice suffix, Version* version);
+  bool HandleCFWriteStallTimelineMap(std::map<std::string, std::string>* values,
+                                     Slice suffix, Version* version);
   bool HandleDBMapStats(std::map<std::string, std::string>* compaction_stats,
-                        Slice suffix);
-  bool HandleDBStats(std::string* value, Slice suffix);
-  bool HandleDBWriteStallStats(std::string* value, Slice suffix);
+                        Slice suffix, Version* version);
+  bool HandleDBStats(std::string* value, Slice suffix, Version* version);
+  bool HandleDBWriteStallStats(std::string* value, Slice suffix,
+                               Version* version);
   bool HandleDBWriteStallStatsMap(std::map<std::string, std::string>* values,
-                                  Slice suffix);
-  bool HandleSsTables(std::string* value, Slice suffix);
-  bool HandleAggregatedTableProperties(std::string* value, Slice suffix);
-  bool HandleAggregatedTablePropertiesAtLevel(std::string* value, Slice suffix);
+                                  Slice suffix, Version* version);
+  bool HandleSsTables(std::string* value, Slice suffix, Version* version);
+  bool HandleAggregatedTableProperties(std::string* value, Slice suffix,
+                                       Version* version);
+  bool HandleAggregatedTablePropertiesAtLevel(std::string* value, Slice suffix,
+                                              Version* version);
   bool HandleAggregatedTablePropertiesMap(
-      std::map<std::string, std::string>* values, Slice suffix);
+      std::map<std::string, std::string>* values, Slice suffix,
+      Version* version);
   bool HandleAggregatedTablePropertiesAtLevelMap(
-      std::map<std::string, std::string>* values, Slice suffix);
+      std::map<std::string, std::string>* values, Slice suffix,
+      Version* version);
   bool HandleNumImmutableMemTable(uint64_t* value, DBImpl* db,
                                   Version* version);
   bool HandleNumImmutableMemTableFlushed(uint64_t* value, DBImpl* db,
@@ -833,6 +954,10 @@ class InternalStats {
   bool HandleActualDelayedWriteRate(uint64_t* value, DBImpl* db,
                                     Version* version);
   bool HandleIsWriteStopped(uint64_t* value, DBImpl* db, Version* version);
+  bool HandleWriteGroupSizeLimitBytes(uint64_t* value, DBImpl* db,
+                                      Version* version);
+  bool HandleWriteGroupSizeLimitWriters(uint64_t* value, DBImpl* db,
+                                        Version* version);
   bool HandleEstimateOldestKeyTime(uint64_t* value, DBImpl* db,
                                    Version* version);
   bool HandleBlockCacheCapacity(uint64_t* value, DBImpl* db, Version* version);
@@ -842,15 +967,27 @@ class InternalStats {
   bool HandleBlockCacheEntryStatsInternal(std::string* value, bool fast);
   bool HandleBlockCacheEntryStatsMapInternal(
       std::map<std::string, std::string>* values, bool fast);
-  bool HandleBlockCacheEntryStats(std::string* value, Slice suffix);
+  bool HandleBlockCacheEntryStats(std::string* value, Slice suffix,
+                                  Version* version);
   bool HandleBlockCacheEntryStatsMap(std::map<std::string, std::string>* values,
-                                     Slice suffix);
-  bool HandleFastBlockCacheEntryStats(std::string* value, Slice suffix);
+                                     Slice suffix, Version* version);
+  bool HandleFastBlockCacheEntryStats(std::string* value, Slice suffix,
+                                      Version* version);
   bool HandleFastBlockCacheEntryStatsMap(
-      std::map<std::string, std::string>* values, Slice suffix);
-  bool HandleLiveSstFilesSizeAtTemperature(std::string* value, Slice suffix);
+      std::map<std::string, std::string>* values, Slice suffix,
+      Version* version);
+  bool HandleBlockCacheTenantStatsMap(
+      std::map<std::string, std::string>* values, Slice suffix,
+      Version* version);
+  bool HandleBlockCacheMissRatioCurve(std::string* value, Slice suffix,
+                                      Version* version);
+  bool HandleBlockCacheMissRatioCurveMap(
+      std::map<std::string, std::string>* values, Slice suffix,
+      Version* version);
+  bool HandleLiveSstFilesSizeAtTemperature(std::string* value, Slice suffix,
+                                           Version* version);
   bool HandleNumBlobFiles(uint64_t* value, DBImpl* db, Version* version);
-  bool HandleBlobStats(std::string* value, Slice suffix);
+  bool HandleBlobStats(std::string* value, Slice suffix, Version* version);
   bool HandleTotalBlobFileSize(uint64_t* value, DBImpl* db, Version* version);
   bool HandleLiveBlobFileSize(uint64_t* value, DBImpl* db, Version* version);
   bool HandleLiveBlobFileGarbageSize(uint64_t* value, DBImpl* db,
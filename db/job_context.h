@@ -28,9 +28,15 @@ struct SuperVersionContext {
     const ImmutableOptions* immutable_options;
   };
 
+  struct WriteStallDetailNotification {
+    WriteStallDetailInfo write_stall_detail_info;
+    const ImmutableOptions* immutable_options;
+  };
+
   autovector<SuperVersion*> superversions_to_free;
 #ifndef ROCKSDB_DISABLE_STALL_NOTIFICATION
   autovector<WriteStallNotification> write_stall_notifications;
+  autovector<WriteStallDetailNotification> write_stall_detail_notifications;
 #endif
   std::unique_ptr<SuperVersion>
       new_superversion;  // if nullptr no new superversion
@@ -42,6 +48,8 @@ struct SuperVersionContext {
       : superversions_to_free(std::move(other.superversions_to_free)),
 #ifndef ROCKSDB_DISABLE_STALL_NOTIFICATION
         write_stall_notifications(std::move(other.write_stall_notifications)),
+        write_stall_detail_notifications(
+            std::move(other.write_stall_detail_notifications)),
 #endif
         new_superversion(std::move(other.new_superversion)) {
   }
@@ -55,7 +63,9 @@ struct SuperVersionContext {
 
   inline bool HaveSomethingToDelete() const {
 #ifndef ROCKSDB_DISABLE_STALL_NOTIFICATION
-    return !superversions_to_free.empty() || !write_stall_notifications.empty();
+    return !superversions_to_free.empty() ||
+           !write_stall_notifications.empty() ||
+           !write_stall_detail_notifications.empty();
 #else
     return !superversions_to_free.empty();
 #endif
@@ -80,6 +90,19 @@ struct SuperVersionContext {
 #endif  // !defined(ROCKSDB_DISABLE_STALL_NOTIFICATION)
   }
 
+  void PushWriteStallDetailNotification(const WriteStallDetailInfo& info,
+                                        const ImmutableOptions* ioptions) {
+#if !defined(ROCKSDB_DISABLE_STALL_NOTIFICATION)
+    WriteStallDetailNotification notif;
+    notif.write_stall_detail_info = info;
+    notif.immutable_options = ioptions;
+    write_stall_detail_notifications.push_back(notif);
+#else
+    (void)info;
+    (void)ioptions;
+#endif  // !defined(ROCKSDB_DISABLE_STALL_NOTIFICATION)
+  }
+
   void Clean() {
 #if !defined(ROCKSDB_DISABLE_STALL_NOTIFICATION)
     // notify listeners on changed write stall conditions
@@ -89,6 +112,12 @@ struct SuperVersionContext {
       }
     }
     write_stall_notifications.clear();
+    for (auto& notif : write_stall_detail_notifications) {
+      for (auto& listener : notif.immutable_options->listeners) {
+        listener->OnWriteStallDetail(notif.write_stall_detail_info);
+      }
+    }
+    write_stall_detail_notifications.clear();
 #endif
     // free superversions
     for (auto s : superversions_to_free) {
@@ -100,6 +129,7 @@ struct SuperVersionContext {
   ~SuperVersionContext() {
 #ifndef ROCKSDB_DISABLE_STALL_NOTIFICATION
     assert(write_stall_notifications.empty());
+    assert(write_stall_detail_notifications.empty());
 #endif
     assert(superversions_to_free.empty());
   }
@@ -18,6 +18,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/filter_policy.h"
+#include "rocksdb/iostats_context.h"
 #include "rocksdb/options.h"
 #include "rocksdb/perf_context.h"
 #include "rocksdb/slice.h"
@@ -1274,6 +1275,54 @@ TEST_F(EventListenerTest, ReadManifestAndWALOnRecovery) {
   ASSERT_GT(listener->file_seq_reads_.load(), seq_reads);
 }
 
+class SampledOperationListener : public EventListener {
+ public:
+  void OnSampledOperation(const SampledOperationInfo& info) override {
+    ASSERT_OK(info.status);
+    operations_.push_back(info.operation);
+    if (std::string(info.operation) == "Get") {
+      memtable_gets_ += info.perf_context->get_from_memtable_count;
+    } else {
+      wal_bytes_ += info.iostats_context->bytes_written;
+    }
+  }
+
+  std::vector<std::string> operations_;
+  uint64_t memtable_gets_ = 0;
+  uint64_t wal_bytes_ = 0;
+};
+
+TEST_F(EventListenerTest, OnSampledOperation) {
+  Options options = CurrentOptions();
+  auto* listener = new SampledOperationListener();
+  options.listeners.emplace_back(listener);
+  options.perf_context_sample_one_in = 1;
+  DestroyAndReopen(options);
+
+  const uint64_t memtable_gets = get_perf_context()->get_from_memtable_count;
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_EQ("bar", Get("foo"));
+  ASSERT_EQ(listener->operations_,
+            std::vector<std::string>({"Write", "Get"}));
+  ASSERT_EQ(1, listener->memtable_gets_);
+  ASSERT_GT(listener->wal_bytes_, 0);
+  // The contexts of the thread are left as they were
+  ASSERT_EQ(memtable_gets, get_perf_context()->get_from_memtable_count);
+
+  // Threads that time perf counters themselves are not sampled
+  SetPerfLevel(PerfLevel::kEnableTime);
+  ASSERT_EQ("bar", Get("foo"));
+  SetPerfLevel(PerfLevel::kEnableCount);
+  ASSERT_EQ(2, listener->operations_.size());
+
+  // Nor are operations under the threshold
+  options.perf_context_sample_threshold_micros = 1000000000;
+  Reopen(options);
+  ASSERT_OK(Put("foo", "baz"));
+  ASSERT_EQ("baz", Get("foo"));
+  ASSERT_EQ(2, listener->operations_.size());
+}
+
 class BlobDBJobLevelEventListenerTest : public EventListener {
  public:
   explicit BlobDBJobLevelEventListenerTest(EventListenerTest* test)
@@ -349,6 +349,23 @@ TEST_P(LogTest, Fragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, FragmentationWithParts) {
+  // Part boundaries that fall inside, at and across block boundaries, and
+  // empty parts.
+  const std::string a = BigString("a", 20000);
+  const std::string b = BigString("b", 12765);
+  const std::string c = BigString("c", 70000);
+  const Slice parts[] = {Slice(a), Slice(), Slice(b), Slice(c), Slice("d")};
+  ASSERT_OK(writer_->AddRecord(SliceParts(parts, 5)));
+  const Slice empty_parts[] = {Slice(), Slice()};
+  ASSERT_OK(writer_->AddRecord(SliceParts(empty_parts, 2)));
+  Write("small");
+  ASSERT_EQ(a + b + c + "d", Read());
+  ASSERT_EQ("", Read());
+  ASSERT_EQ("small", Read());
+  ASSERT_EQ("EOF", Read());
+}
+
 TEST_P(LogTest, MarginalTrailer) {
   // Make a trailer that is exactly the same length as an empty record.
   int header_size =
@@ -1128,6 +1145,49 @@ TEST_P(CompressionLogTest, AlignedFragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(CompressionLogTest, CompressedPayload) {
+  CompressionType compression_type = std::get<2>(GetParam());
+  if (compression_type == kNoCompression ||
+      !StreamingCompressionTypeSupported(compression_type)) {
+    ROCKSDB_GTEST_SKIP("Test requires support for compression type");
+    return;
+  }
+  ASSERT_OK(SetupTestEnv());
+  std::unique_ptr<RecordCompressor> compressor =
+      RecordCompressor::Create(compression_type);
+  ASSERT_NE(compressor, nullptr);
+  Random rnd(301);
+  // Payloads of one part, empty parts and parts spanning blocks
+  const std::vector<std::vector<std::string>> payloads = {
+      {"foo"},
+      {"", "bar", ""},
+      {rnd.RandomBinaryString(3 * kBlockSize / 2), "baz",
+       rnd.RandomBinaryString(3 * kBlockSize)},
+  };
+  std::vector<std::string> expected;
+  for (const auto& payload : payloads) {
+    std::vector<std::string> compressed(payload.size());
+    std::vector<Slice> parts;
+    std::string record = "header";
+    for (size_t i = 0; i < payload.size(); ++i) {
+      ASSERT_OK(compressor->Compress(payload[i], &compressed[i]));
+      parts.emplace_back(compressed[i]);
+      record += payload[i];
+    }
+    ASSERT_OK(writer_->AddRecordWithCompressedPayload(
+        "header", SliceParts(parts.data(), static_cast<int>(parts.size()))));
+    expected.push_back(record);
+    // Mixed with records compressed by the writer
+    Write("qux");
+    expected.push_back("qux");
+  }
+
+  for (const std::string& record : expected) {
+    ASSERT_EQ(record, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
 INSTANTIATE_TEST_CASE_P(
     Compression, CompressionLogTest,
     ::testing::Combine(::testing::Values(0, 1), ::testing::Bool(),
@@ -9,18 +9,25 @@
 
 #include "db/log_writer.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "file/writable_file_writer.h"
 #include "rocksdb/env.h"
 #include "rocksdb/io_status.h"
 #include "util/coding.h"
+#include "util/autovector.h"
 #include "util/crc32c.h"
 #include "util/udt_util.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace log {
 
+namespace {
+// The format of the stream frames of compressed records
+constexpr uint32_t kCompressionFormatVersion = 2;
+}  // namespace
+
 Writer::Writer(std::unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
                bool recycle_log_files, bool manual_flush,
                CompressionType compression_type)
@@ -84,22 +91,9 @@ IOStatus Writer::AddRecord(const Slice& slice,
 
   IOStatus s;
   do {
-    const int64_t leftover = kBlockSize - block_offset_;
-    assert(leftover >= 0);
-    if (leftover < header_size) {
-      // Switch to a new block
-      if (leftover > 0) {
-        // Fill the trailer (literal below relies on kHeaderSize and
-        // kRecyclableHeaderSize being <= 11)
-        assert(header_size <= 11);
-        s = dest_->Append(Slice("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
-                                static_cast<size_t>(leftover)),
-                          0 /* crc32c_checksum */, rate_limiter_priority);
-        if (!s.ok()) {
-          break;
-        }
-      }
-      block_offset_ = 0;
+    s = MaybeSwitchBlock(header_size, rate_limiter_priority);
+    if (!s.ok()) {
+      break;
     }
 
     // Invariant: we never leave < header_size bytes in a block.
@@ -159,6 +153,134 @@ IOStatus Writer::AddRecord(const Slice& slice,
   return s;
 }
 
+IOStatus Writer::AddRecord(const SliceParts& record,
+                           Env::IOPriority rate_limiter_priority) {
+  if (record.num_parts == 1) {
+    return AddRecord(record.parts[0], rate_limiter_priority);
+  }
+  if (compress_) {
+    std::string buf;
+    return AddRecord(Slice(record, &buf), rate_limiter_priority);
+  }
+  return EmitRecordParts(record, rate_limiter_priority);
+}
+
+IOStatus Writer::AddRecordWithCompressedPayload(
+    const Slice& header, const SliceParts& compressed_payload,
+    Env::IOPriority rate_limiter_priority) {
+  assert(compress_ != nullptr);
+  std::vector<Slice> parts;
+  parts.reserve(1 + compressed_payload.num_parts);
+  // The header is small enough for its frame to fit in the buffer
+  compress_->Reset();
+  size_t header_frame_size = 0;
+  if (compress_->Compress(header.data(), header.size(),
+                          compressed_buffer_.get(), &header_frame_size) != 0) {
+    IOStatus s = IOStatus::IOError("Unexpected WAL compression error");
+    s.SetDataLoss(true);
+    return s;
+  }
+  parts.emplace_back(compressed_buffer_.get(), header_frame_size);
+  for (int i = 0; i < compressed_payload.num_parts; ++i) {
+    parts.push_back(compressed_payload.parts[i]);
+  }
+  return EmitRecordParts(
+      SliceParts(parts.data(), static_cast<int>(parts.size())),
+      rate_limiter_priority);
+}
+
+IOStatus Writer::EmitRecordParts(const SliceParts& record,
+                                 Env::IOPriority rate_limiter_priority) {
+  size_t left = 0;
+  for (int i = 0; i < record.num_parts; ++i) {
+    left += record.parts[i].size();
+  }
+  const int header_size =
+      recycle_log_files_ ? kRecyclableHeaderSize : kHeaderSize;
+
+  // Position of the next byte to emit.
+  int part = 0;
+  size_t part_offset = 0;
+  std::vector<Slice> pieces;
+  bool begin = true;
+  IOStatus s;
+  do {
+    s = MaybeSwitchBlock(header_size, rate_limiter_priority);
+    if (!s.ok()) {
+      break;
+    }
+
+    const size_t avail = kBlockSize - block_offset_ - header_size;
+    const size_t fragment_length = (left < avail) ? left : avail;
+
+    RecordType type;
+    const bool end = (left == fragment_length);
+    if (begin && end) {
+      type = recycle_log_files_ ? kRecyclableFullType : kFullType;
+    } else if (begin) {
+      type = recycle_log_files_ ? kRecyclableFirstType : kFirstType;
+    } else if (end) {
+      type = recycle_log_files_ ? kRecyclableLastType : kLastType;
+    } else {
+      type = recycle_log_files_ ? kRecyclableMiddleType : kMiddleType;
+    }
+
+    // Collect the pieces of the parts that make up this fragment.
+    pieces.clear();
+    size_t needed = fragment_length;
+    while (needed > 0) {
+      assert(part < record.num_parts);
+      const Slice& p = record.parts[part];
+      const size_t take = std::min(needed, p.size() - part_offset);
+      if (take > 0) {
+        pieces.emplace_back(p.data() + part_offset, take);
+      }
+      part_offset += take;
+      needed -= take;
+      if (part_offset == p.size()) {
+        ++part;
+        part_offset = 0;
+      }
+    }
+
+    s = EmitPhysicalRecord(type, pieces.data(), pieces.size(), fragment_length,
+                           rate_limiter_priority);
+    left -= fragment_length;
+    begin = false;
+  } while (s.ok() && left > 0);
+
+  if (s.ok()) {
+    if (!manual_flush_) {
+      s = dest_->Flush(rate_limiter_priority);
+    }
+  }
+
+  return s;
+}
+
+IOStatus Writer::MaybeSwitchBlock(int header_size,
+                                  Env::IOPriority rate_limiter_priority) {
+  const int64_t leftover = kBlockSize - block_offset_;
+  assert(leftover >= 0);
+  if (leftover < header_size) {
+    // Switch to a new block
+    if (leftover > 0) {
+      // Fill the trailer (literal below relies on kHeaderSize and
+      // kRecyclableHeaderSize being <= 11)
+      assert(header_size <= 11);
+      IOStatus s =
+          dest_->Append(Slice("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+                              static_cast<size_t>(leftover)),
+                        0 /* crc32c_checksum */, rate_limiter_priority);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    block_offset_ = 0;
+  }
+  return IOStatus::OK();
+}
+
 IOStatus Writer::AddCompressionTypeRecord() {
   // Should be the first record
   assert(block_offset_ == 0);
@@ -181,9 +303,8 @@ IOStatus Writer::AddCompressionTypeRecord() {
     const size_t max_output_buffer_len =
         kBlockSize - (recycle_log_files_ ? kRecyclableHeaderSize : kHeaderSize);
     CompressionOptions opts;
-    constexpr uint32_t compression_format_version = 2;
     compress_ = StreamingCompress::Create(compression_type_, opts,
-                                          compression_format_version,
+                                          kCompressionFormatVersion,
                                           max_output_buffer_len);
     assert(compress_ != nullptr);
     compressed_buffer_ =
@@ -227,6 +348,13 @@ bool Writer::BufferIsEmpty() { return dest_->BufferIsEmpty(); }
 
 IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n,
                                     Env::IOPriority rate_limiter_priority) {
+  const Slice piece(ptr, n);
+  return EmitPhysicalRecord(t, &piece, 1, n, rate_limiter_priority);
+}
+
+IOStatus Writer::EmitPhysicalRecord(RecordType t, const Slice* pieces,
+                                    size_t num_pieces, size_t n,
+                                    Env::IOPriority rate_limiter_priority) {
   assert(n <= 0xffff);  // Must fit in two bytes
 
   size_t header_size;
@@ -257,9 +385,26 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n,
     crc = crc32c::Extend(crc, buf + 7, 4);
   }
 
-  // Compute the crc of the record type and the payload.
-  uint32_t payload_crc = crc32c::Value(ptr, n);
-  crc = crc32c::Crc32cCombine(crc, payload_crc, n);
+  // Compute the crc of the record type and the payload. The crcs of the
+  // pieces are computed together, three at a time as crc32c::ValueMulti()
+  // interleaves them.
+  autovector<uint32_t, 4> piece_crcs;
+  constexpr size_t kGroupSize = 3;
+  for (size_t i = 0; i < num_pieces; i += kGroupSize) {
+    const size_t m = std::min(kGroupSize, num_pieces - i);
+    const char* data[kGroupSize];
+    size_t lens[kGroupSize];
+    uint32_t crcs[kGroupSize];
+    for (size_t j = 0; j < m; ++j) {
+      data[j] = pieces[i + j].data();
+      lens[j] = pieces[i + j].size();
+    }
+    crc32c::ValueMulti(data, lens, m, crcs);
+    for (size_t j = 0; j < m; ++j) {
+      piece_crcs.push_back(crcs[j]);
+      crc = crc32c::Crc32cCombine(crc, crcs[j], lens[j]);
+    }
+  }
   crc = crc32c::Mask(crc);  // Adjust for storage
   TEST_SYNC_POINT_CALLBACK("LogWriter::EmitPhysicalRecord:BeforeEncodeChecksum",
                            &crc);
@@ -268,12 +413,43 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n,
   // Write the header and the payload
   IOStatus s = dest_->Append(Slice(buf, header_size), 0 /* crc32c_checksum */,
                              rate_limiter_priority);
-  if (s.ok()) {
-    s = dest_->Append(Slice(ptr, n), payload_crc, rate_limiter_priority);
+  for (size_t i = 0; s.ok() && i < num_pieces; ++i) {
+    s = dest_->Append(pieces[i], piece_crcs[i], rate_limiter_priority);
   }
   block_offset_ += header_size + n;
   return s;
 }
 
+std::unique_ptr<RecordCompressor> RecordCompressor::Create(
+    CompressionType compression_type) {
+  StreamingCompress* compress =
+      StreamingCompress::Create(compression_type, CompressionOptions(),
+                                kCompressionFormatVersion, kBlockSize);
+  if (compress == nullptr) {
+    return nullptr;
+  }
+  return std::unique_ptr<RecordCompressor>(new RecordCompressor(compress));
+}
+
+RecordCompressor::RecordCompressor(StreamingCompress* compress)
+    : compress_(compress), buffer_(new char[kBlockSize]) {}
+
+IOStatus RecordCompressor::Compress(const Slice& data, std::string* output) {
+  compress_->Reset();
+  int remaining = 0;
+  do {
+    size_t output_size = 0;
+    remaining = compress_->Compress(data.data(), data.size(), buffer_.get(),
+                                    &output_size);
+    if (remaining < 0) {
+      IOStatus s = IOStatus::IOError("Unexpected WAL compression error");
+      s.SetDataLoss(true);
+      return s;
+    }
+    output->append(buffer_.get(), output_size);
+  } while (remaining > 0);
+  return IOStatus::OK();
+}
+
 }  // namespace log
 }  // namespace ROCKSDB_NAMESPACE
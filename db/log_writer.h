@@ -10,6 +10,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -88,8 +89,28 @@ class Writer {
 
   IOStatus AddRecord(const Slice& slice,
                      Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
+  // Adds one record made of the concatenation of `record`'s parts, without
+  // concatenating them first. The parts are copied straight into the file
+  // buffer, except with compression, which needs the whole record at once.
+  IOStatus AddRecord(const SliceParts& record,
+                     Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
   IOStatus AddCompressionTypeRecord();
 
+  // Adds one record made of `header` followed by a payload compressed ahead
+  // of time by a RecordCompressor of compression_type(), so that only the
+  // header is compressed here. Records compressed by AddRecord() are one
+  // stream frame, and these are a frame for the header followed by the
+  // frames of the payload, which readers decompress the same way.
+  IOStatus AddRecordWithCompressedPayload(
+      const Slice& header, const SliceParts& compressed_payload,
+      Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
+
+  // The compression of the records, kNoCompression if they are not
+  // compressed
+  CompressionType compression_type() const {
+    return compress_ != nullptr ? compression_type_ : kNoCompression;
+  }
+
   // If there are column families in `cf_to_ts_sz` not included in
   // `recorded_cf_to_ts_sz_` and its user-defined timestamp size is non-zero,
   // adds a record of type kUserDefinedTimestampSizeType or
@@ -124,6 +145,20 @@ class Writer {
   IOStatus EmitPhysicalRecord(
       RecordType type, const char* ptr, size_t length,
       Env::IOPriority rate_limiter_priority = Env::IO_TOTAL);
+  // Same as above, for a payload of `length` bytes split over `num_pieces`.
+  IOStatus EmitPhysicalRecord(RecordType type, const Slice* pieces,
+                              size_t num_pieces, size_t length,
+                              Env::IOPriority rate_limiter_priority);
+
+  // Emits one record made of the concatenation of `record`'s parts, as they
+  // are
+  IOStatus EmitRecordParts(const SliceParts& record,
+                           Env::IOPriority rate_limiter_priority);
+
+  // Pads the rest of the block and starts a new one if fewer than
+  // header_size bytes are left in it.
+  IOStatus MaybeSwitchBlock(int header_size,
+                            Env::IOPriority rate_limiter_priority);
 
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
@@ -141,5 +176,26 @@ class Writer {
   UnorderedMap<uint32_t, size_t> recorded_cf_to_ts_sz_;
 };
 
+// Compresses parts of records for Writer::AddRecordWithCompressedPayload()
+// like a Writer with the same compression type would, so that the threads
+// producing the records can compress them in parallel before handing them
+// over to the thread writing the log. Not thread-safe.
+class RecordCompressor {
+ public:
+  // Returns nullptr if the compression type doesn't support streaming
+  static std::unique_ptr<RecordCompressor> Create(
+      CompressionType compression_type);
+
+  // Appends `data` compressed to one stream frame to `output`, or nothing if
+  // `data` is empty
+  IOStatus Compress(const Slice& data, std::string* output);
+
+ private:
+  explicit RecordCompressor(StreamingCompress* compress);
+
+  std::unique_ptr<StreamingCompress> compress_;
+  std::unique_ptr<char[]> buffer_;
+};
+
 }  // namespace log
 }  // namespace ROCKSDB_NAMESPACE
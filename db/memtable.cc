@@ -58,6 +58,7 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
       memtable_whole_key_filtering(
           mutable_cf_options.memtable_whole_key_filtering),
       inplace_update_support(ioptions.inplace_update_support),
+      inplace_merge_operands(ioptions.inplace_merge_operands),
       inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
       inplace_callback(ioptions.inplace_callback),
       max_successive_merges(mutable_cf_options.max_successive_merges),
@@ -72,18 +73,22 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                    const ImmutableOptions& ioptions,
                    const MutableCFOptions& mutable_cf_options,
                    WriteBufferManager* write_buffer_manager,
-                   SequenceNumber latest_seq, uint32_t column_family_id)
+                   SequenceNumber latest_seq, uint32_t column_family_id,
+                   std::shared_ptr<ArenaBlockPool> arena_block_pool)
     : comparator_(cmp),
       moptions_(ioptions, mutable_cf_options),
       refs_(0),
       kArenaBlockSize(Arena::OptimizeBlockSize(moptions_.arena_block_size)),
       mem_tracker_(write_buffer_manager),
+      arena_block_pool_(std::move(arena_block_pool)),
       arena_(
           moptions_.arena_block_size,
           (write_buffer_manager != nullptr && (write_buffer_manager->enabled()))
               ? &mem_tracker_
               : nullptr,
-          mutable_cf_options.memtable_huge_page_size),
+          mutable_cf_options.memtable_huge_page_size,
+          ioptions.numa_aware_memtable_arena, arena_block_pool_.get(),
+          /*movable=*/ioptions.immutable_memtable_numa_node >= 0),
       table_(ioptions.memtable_factory->CreateMemTableRep(
           comparator_, &arena_, mutable_cf_options.prefix_extractor.get(),
           ioptions.logger, column_family_id)),
@@ -119,6 +124,7 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       clock_(ioptions.clock),
       insert_with_hint_prefix_extractor_(
           ioptions.memtable_insert_with_hint_prefix_extractor.get()),
+      serial_insert_hint_(nullptr),
       oldest_key_time_(std::numeric_limits<uint64_t>::max()),
       atomic_flush_seqno_(kMaxSequenceNumber),
       approximate_memory_usage_(0),
@@ -128,6 +134,11 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
   // something went wrong if we need to flush before inserting anything
   assert(!ShouldScheduleFlush());
 
+  if (arena_block_pool_ != nullptr) {
+    // Refill the pool for the memtable after this one
+    arena_block_pool_->Prefault(kArenaBlockSize);
+  }
+
   // Initialize cached_range_tombstone_ here since it could
   // be read before it is constructed in MemTable::Add(), which could also lead
   // to a data race on the global mutex table backing atomic shared_ptr.
@@ -148,6 +159,9 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
   assert(ucmp);
   ts_sz_ = ucmp->timestamp_size();
   persist_user_defined_timestamps_ = ioptions.persist_user_defined_timestamps;
+  if (ts_sz_ == 0) {
+    range_tombstone_index_.reset(new RangeTombstoneIndex(ucmp, &arena_));
+  }
 }
 
 MemTable::~MemTable() {
@@ -155,6 +169,18 @@ MemTable::~MemTable() {
   assert(refs_ == 0);
 }
 
+void MemTable::MarkImmutable() {
+  table_->MarkReadOnly();
+  mem_tracker_.DoneAllocating();
+  RecordTick(moptions_.statistics, MEMTABLE_NUMA_REMOTE_BYTES,
+             arena_.NumaRemoteBytes());
+}
+
+void MemTable::MoveToNumaNode(int node) {
+  RecordTick(moptions_.statistics, MEMTABLE_FAR_MEMORY_BYTES,
+             arena_.MoveToNumaNode(node));
+}
+
 size_t MemTable::ApproximateMemoryUsage() {
   autovector<size_t> usages = {
       arena_.ApproximateMemoryUsage(), table_->ApproximateMemoryUsage(),
@@ -333,6 +359,11 @@ int MemTable::KeyComparator::operator()(
   return comparator.CompareKeySeq(a, key);
 }
 
+bool MemTable::KeyComparator::IsBytewiseUserKeyOrder() const {
+  const Comparator* ucmp = comparator.user_comparator();
+  return ucmp == BytewiseComparator() && ucmp->timestamp_size() == 0;
+}
+
 void MemTableRep::InsertConcurrently(KeyHandle /*handle*/) {
   throw std::runtime_error("concurrent insert not supported");
 }
@@ -739,10 +770,20 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
 
   Slice key_without_ts = StripTimestampFromUserKey(key, ts_sz_);
 
+  if (type == kTypeRangeDeletion) {
+    // The hint is a position in table_, not in range_del_table_
+    hint = nullptr;
+  }
   if (!allow_concurrent) {
-    // Extract prefix for insert with hint.
-    if (insert_with_hint_prefix_extractor_ != nullptr &&
-        insert_with_hint_prefix_extractor_->InDomain(key_slice)) {
+    assert(hint == nullptr || hint == serial_insert_hint());
+    if (hint != nullptr) {
+      bool res = table->InsertKeyWithHint(handle, hint);
+      if (UNLIKELY(!res)) {
+        return Status::TryAgain("key+seq exists");
+      }
+    } else if (insert_with_hint_prefix_extractor_ != nullptr &&
+               insert_with_hint_prefix_extractor_->InDomain(key_slice)) {
+      // Extract prefix for insert with hint.
       Slice prefix = insert_with_hint_prefix_extractor_->Transform(key_slice);
       bool res = table->InsertKeyWithHint(handle, &insert_hints_[prefix]);
       if (UNLIKELY(!res)) {
@@ -846,6 +887,9 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
       post_process_info->num_range_deletes++;
       range_del_mutex_.lock();
     }
+    if (range_tombstone_index_ != nullptr) {
+      range_tombstone_index_->Add(key, value, s);
+    }
     for (size_t i = 0; i < size; ++i) {
       std::shared_ptr<FragmentedRangeTombstoneListCache>* local_cache_ref_ptr =
           cached_range_tombstone_.AccessAtCore(i);
@@ -1186,10 +1230,16 @@ static bool SaveValue(void* arg, const char* entry) {
           *(s->found_final_value) = true;
           return false;
         }
+        if (s->inplace_update_support) {
+          s->mem->GetLock(s->key->user_key())->ReadLock();
+        }
         Slice v = GetLengthPrefixedSlice(key_ptr + key_length);
         *(s->merge_in_progress) = true;
         merge_context->PushOperand(
             v, s->inplace_update_support == false /* operand_pinned */);
+        if (s->inplace_update_support) {
+          s->mem->GetLock(s->key->user_key())->ReadUnlock();
+        }
         PERF_COUNTER_ADD(internal_merge_point_lookup_count, 1);
 
         if (s->do_merge && merge_operator->ShouldMerge(
@@ -1244,10 +1294,20 @@ bool MemTable::Get(const LookupKey& key, std::string* value,
 
   PERF_TIMER_GUARD(get_from_memtable_time);
 
-  std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
-      NewRangeTombstoneIterator(read_opts,
-                                GetInternalKeySeqno(key.internal_key()),
-                                immutable_memtable));
+  std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter;
+  if (!immutable_memtable && range_tombstone_index_ != nullptr) {
+    if (!read_opts.ignore_range_deletions &&
+        !is_range_del_table_empty_.load(std::memory_order_relaxed)) {
+      *max_covering_tombstone_seq = std::max(
+          *max_covering_tombstone_seq,
+          range_tombstone_index_->MaxCoveringTombstoneSeqnum(
+              key.user_key(), GetInternalKeySeqno(key.internal_key())));
+    }
+  } else {
+    range_del_iter.reset(NewRangeTombstoneIterator(
+        read_opts, GetInternalKeySeqno(key.internal_key()),
+        immutable_memtable));
+  }
   if (range_del_iter != nullptr) {
     SequenceNumber covering_seq =
         range_del_iter->MaxCoveringTombstoneSeqnum(key.user_key());
@@ -1355,38 +1415,20 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   bool no_range_del = read_options.ignore_range_deletions ||
                       is_range_del_table_empty_.load(std::memory_order_relaxed);
   MultiGetRange temp_range(*range, range->begin(), range->end());
-  auto bloom_filter = GetBloomFilter();
-  if (bloom_filter && no_range_del) {
-    bool whole_key =
-        !prefix_extractor_ || moptions_.memtable_whole_key_filtering;
-    std::array<Slice, MultiGetContext::MAX_BATCH_SIZE> bloom_keys;
-    std::array<bool, MultiGetContext::MAX_BATCH_SIZE> may_match;
-    std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> range_indexes;
-    int num_keys = 0;
-    for (auto iter = temp_range.begin(); iter != temp_range.end(); ++iter) {
-      if (whole_key) {
-        bloom_keys[num_keys] = iter->ukey_without_ts;
-        range_indexes[num_keys++] = iter.index();
-      } else if (prefix_extractor_->InDomain(iter->ukey_without_ts)) {
-        bloom_keys[num_keys] =
-            prefix_extractor_->Transform(iter->ukey_without_ts);
-        range_indexes[num_keys++] = iter.index();
-      }
-    }
-    bloom_filter->MayContain(num_keys, bloom_keys.data(), may_match.data());
-    for (int i = 0; i < num_keys; ++i) {
-      if (!may_match[i]) {
-        temp_range.SkipIndex(range_indexes[i]);
-        PERF_COUNTER_ADD(bloom_memtable_miss_count, 1);
-      } else {
-        PERF_COUNTER_ADD(bloom_memtable_hit_count, 1);
-      }
-    }
+  if (GetBloomFilter() != nullptr && no_range_del) {
+    SkipKeysNotInBloomFilter(&temp_range);
   }
   for (auto iter = temp_range.begin(); iter != temp_range.end(); ++iter) {
     bool found_final_value{false};
     bool merge_in_progress = iter->s->IsMergeInProgress();
-    if (!no_range_del) {
+    if (!no_range_del && !immutable_memtable &&
+        range_tombstone_index_ != nullptr) {
+      iter->max_covering_tombstone_seq = std::max(
+          iter->max_covering_tombstone_seq,
+          range_tombstone_index_->MaxCoveringTombstoneSeqnum(
+              iter->lkey->user_key(),
+              GetInternalKeySeqno(iter->lkey->internal_key())));
+    } else if (!no_range_del) {
       std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
           NewRangeTombstoneIteratorInternal(
               read_options, GetInternalKeySeqno(iter->lkey->internal_key()),
@@ -1439,6 +1481,68 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   PERF_COUNTER_ADD(get_from_memtable_count, 1);
 }
 
+void MemTable::KeysMayExist(MultiGetRange* range) {
+  if (IsEmpty()) {
+    return;
+  }
+  MultiGetRange temp_range(*range, range->begin(), range->end());
+  if (GetBloomFilter() != nullptr) {
+    SkipKeysNotInBloomFilter(&temp_range);
+  }
+  const Comparator* user_comparator =
+      comparator_.comparator.user_comparator();
+  for (auto iter = temp_range.begin(); iter != temp_range.end(); ++iter) {
+    struct State {
+      const Comparator* user_comparator;
+      Slice user_key;
+      bool found;
+    } state{user_comparator, iter->ukey_with_ts, false};
+    // The first entry at or after the lookup key is the only one to check
+    table_->Get(*(iter->lkey), &state, [](void* arg, const char* entry) {
+      State* st = static_cast<State*>(arg);
+      uint32_t key_length = 0;
+      const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+      assert(key_length >= 8);
+      st->found = st->user_comparator->EqualWithoutTimestamp(
+          Slice(key_ptr, key_length - 8), st->user_key);
+      return false;
+    });
+    if (state.found) {
+      iter->key_exists = true;
+      range->MarkKeyDone(iter);
+    }
+  }
+}
+
+void MemTable::SkipKeysNotInBloomFilter(MultiGetRange* range) {
+  DynamicBloom* bloom_filter = GetBloomFilter();
+  assert(bloom_filter != nullptr);
+  bool whole_key = !prefix_extractor_ || moptions_.memtable_whole_key_filtering;
+  std::array<Slice, MultiGetContext::MAX_BATCH_SIZE> bloom_keys;
+  std::array<bool, MultiGetContext::MAX_BATCH_SIZE> may_match;
+  std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> range_indexes;
+  int num_keys = 0;
+  for (auto iter = range->begin(); iter != range->end(); ++iter) {
+    if (whole_key) {
+      bloom_keys[num_keys] = iter->ukey_without_ts;
+      range_indexes[num_keys++] = iter.index();
+    } else if (prefix_extractor_->InDomain(iter->ukey_without_ts)) {
+      bloom_keys[num_keys] =
+          prefix_extractor_->Transform(iter->ukey_without_ts);
+      range_indexes[num_keys++] = iter.index();
+    }
+  }
+  bloom_filter->MayContain(num_keys, bloom_keys.data(), may_match.data());
+  for (int i = 0; i < num_keys; ++i) {
+    if (!may_match[i]) {
+      range->SkipIndex(range_indexes[i]);
+      PERF_COUNTER_ADD(bloom_memtable_miss_count, 1);
+    } else {
+      PERF_COUNTER_ADD(bloom_memtable_hit_count, 1);
+    }
+  }
+}
+
 Status MemTable::Update(SequenceNumber seq, ValueType value_type,
                         const Slice& key, const Slice& value,
                         const ProtectionInfoKVOS64* kv_prot_info) {
@@ -1595,6 +1699,69 @@ Status MemTable::UpdateCallback(SequenceNumber seq, const Slice& key,
   return Status::NotFound();
 }
 
+Status MemTable::UpdateMerge(SequenceNumber seq, const Slice& key,
+                             const Slice& operand,
+                             const ProtectionInfoKVOS64* kv_prot_info) {
+  LookupKey lkey(key, seq);
+  Slice memkey = lkey.memtable_key();
+
+  std::unique_ptr<MemTableRep::Iterator> iter(
+      table_->GetDynamicPrefixIterator());
+  iter->Seek(lkey.internal_key(), memkey.data());
+
+  if (iter->Valid() && moptions_.merge_operator != nullptr) {
+    // Refer to comments under MemTable::Add() for entry format.
+    // Check that it belongs to same user key.  We do not check the
+    // sequence number since the Seek() call above should have skipped
+    // all entries with overly large sequence numbers.
+    const char* entry = iter->key();
+    uint32_t key_length = 0;
+    const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+    if (comparator_.comparator.user_comparator()->Equal(
+            Slice(key_ptr, key_length - 8), lkey.user_key())) {
+      // Correct user key
+      const uint64_t tag = DecodeFixed64(key_ptr + key_length - 8);
+      ValueType type;
+      SequenceNumber existing_seq;
+      UnPackSequenceAndType(tag, &existing_seq, &type);
+      std::string merged;
+      if (type == kTypeMerge) {
+        Slice prev_operand = GetLengthPrefixedSlice(key_ptr + key_length);
+        // Only this writer modifies the entry, so it can be read unlocked
+        if (moptions_.merge_operator->PartialMerge(
+                key, prev_operand, operand, &merged, moptions_.info_log) &&
+            merged.size() <= prev_operand.size()) {
+          char* p;
+          {
+            WriteLock wl(GetLock(lkey.user_key()));
+            p = EncodeVarint32(const_cast<char*>(key_ptr) + key_length,
+                               static_cast<uint32_t>(merged.size()));
+            memcpy(p, merged.data(), merged.size());
+          }
+          RecordTick(moptions_.statistics, NUMBER_KEYS_UPDATED);
+          if (kv_prot_info != nullptr) {
+            ProtectionInfoKVOS64 updated_kv_prot_info(*kv_prot_info);
+            // `seq` is swallowed and `existing_seq` prevails.
+            updated_kv_prot_info.UpdateS(seq, existing_seq);
+            updated_kv_prot_info.UpdateV(operand, merged);
+            UpdateEntryChecksum(&updated_kv_prot_info, key, merged, type,
+                                existing_seq, p + merged.size());
+            Slice encoded(entry, p + merged.size() - entry);
+            return VerifyEncodedEntry(encoded, updated_kv_prot_info);
+          } else {
+            UpdateEntryChecksum(nullptr, key, merged, type, existing_seq,
+                                p + merged.size());
+          }
+          return Status::OK();
+        }
+      }
+    }
+  }
+
+  // The latest version is not a merge operand that could absorb `operand`
+  return Add(seq, kTypeMerge, key, operand, kv_prot_info);
+}
+
 size_t MemTable::CountSuccessiveMergeEntries(const LookupKey& key) {
   Slice memkey = key.memtable_key();
 
@@ -19,6 +19,7 @@
 #include "db/dbformat.h"
 #include "db/kv_checksum.h"
 #include "db/range_tombstone_fragmenter.h"
+#include "db/range_tombstone_index.h"
 #include "db/read_callback.h"
 #include "db/version_edit.h"
 #include "memory/allocator.h"
@@ -48,6 +49,7 @@ struct ImmutableMemTableOptions {
   size_t memtable_huge_page_size;
   bool memtable_whole_key_filtering;
   bool inplace_update_support;
+  bool inplace_merge_operands;
   size_t inplace_update_num_locks;
   UpdateStatus (*inplace_callback)(char* existing_value,
                                    uint32_t* existing_value_size,
@@ -94,6 +96,7 @@ class MemTable {
                            const char* prefix_len_key2) const override;
     virtual int operator()(const char* prefix_len_key,
                            const DecodedType& key) const override;
+    bool IsBytewiseUserKeyOrder() const override;
   };
 
   // MemTables are reference counted.  The initial reference count
@@ -105,11 +108,15 @@ class MemTable {
   // If the earliest sequence number is not known, kMaxSequenceNumber may be
   // used, but this may prevent some transactions from succeeding until the
   // first key is inserted into the memtable.
-  explicit MemTable(const InternalKeyComparator& comparator,
-                    const ImmutableOptions& ioptions,
-                    const MutableCFOptions& mutable_cf_options,
-                    WriteBufferManager* write_buffer_manager,
-                    SequenceNumber earliest_seq, uint32_t column_family_id);
+  //
+  // If arena_block_pool is not null, the arena recycles its blocks through
+  // it, and asks it to pre-fault more in the background.
+  explicit MemTable(
+      const InternalKeyComparator& comparator, const ImmutableOptions& ioptions,
+      const MutableCFOptions& mutable_cf_options,
+      WriteBufferManager* write_buffer_manager, SequenceNumber earliest_seq,
+      uint32_t column_family_id,
+      std::shared_ptr<ArenaBlockPool> arena_block_pool = nullptr);
   // No copying allowed
   MemTable(const MemTable&) = delete;
   MemTable& operator=(const MemTable&) = delete;
@@ -231,12 +238,22 @@ class MemTable {
   // Returns `Status::TryAgain` if the `seq`, `key` combination already exists
   // in the memtable and `MemTableRepFactory::CanHandleDuplicatedKey()` is true.
   // The next attempt should try a larger value for `seq`.
+  //
+  // If hint is not nullptr, the insert starts from, and then updates, the
+  // position it records, which makes inserting keys in ascending order close
+  // to O(1) each. With allow_concurrent the hint is allocated on heap and
+  // owned by the caller. Otherwise it must be serial_insert_hint(). Range
+  // deletions are kept in a separate table and ignore the hint.
   Status Add(SequenceNumber seq, ValueType type, const Slice& key,
              const Slice& value, const ProtectionInfoKVOS64* kv_prot_info,
              bool allow_concurrent = false,
              MemTablePostProcessInfo* post_process_info = nullptr,
              void** hint = nullptr);
 
+  // The insert hint shared by non-concurrent calls to Add(). Those are
+  // serialized, so one position is enough, and it is allocated only once.
+  void** serial_insert_hint() { return &serial_insert_hint_; }
+
   // Used to Get value associated with key or Get Merge Operands associated
   // with key.
   // If do_merge = true the default behavior which is Get value for key is
@@ -287,6 +304,11 @@ class MemTable {
   void MultiGet(const ReadOptions& read_options, MultiGetRange* range,
                 ReadCallback* callback, bool immutable_memtable);
 
+  // For the keys of `range` with an entry in this memtable, of any type and
+  // sequence number, sets KeyContext::key_exists and marks them done.
+  // Checks the memtable Bloom filter, if any, first.
+  void KeysMayExist(MultiGetRange* range);
+
   // If `key` exists in current memtable with type value_type and the existing
   // value is at least as large as the new value, updates it in-place. Otherwise
   // adds the new value to the memtable out-of-place.
@@ -318,6 +340,21 @@ class MemTable {
                         const Slice& delta,
                         const ProtectionInfoKVOS64* kv_prot_info);
 
+  // If the latest version of `key` in current memtable is a merge operand,
+  // and `MergeOperator::PartialMerge()` of it with `operand` succeeds with a
+  // result no larger than it, replaces it in-place with the result. Otherwise
+  // adds `operand` to the memtable out-of-place.
+  //
+  // Returns `Status::TryAgain` if the `seq`, `key` combination already exists
+  // in the memtable and `MemTableRepFactory::CanHandleDuplicatedKey()` is true.
+  // The next attempt should try a larger value for `seq`.
+  //
+  // REQUIRES: external synchronization to prevent simultaneous
+  // operations on the same MemTable.
+  Status UpdateMerge(SequenceNumber seq, const Slice& key,
+                     const Slice& operand,
+                     const ProtectionInfoKVOS64* kv_prot_info);
+
   // Returns the number of successive merge entries starting from the newest
   // entry for the key up to the last non-merge entry or last entry for the
   // key in the memtable.
@@ -464,10 +501,12 @@ class MemTable {
   // operations on the same MemTable.
   // After MarkImmutable() is called, you should not attempt to
   // write anything to this MemTable().  (Ie. do not call Add() or Update()).
-  void MarkImmutable() {
-    table_->MarkReadOnly();
-    mem_tracker_.DoneAllocating();
-  }
+  void MarkImmutable();
+
+  // Moves the pages of the arena of this immutable memtable to the NUMA node
+  // `node`, see DBOptions::immutable_memtable_numa_node. Thread-safe with
+  // the reads.
+  void MoveToNumaNode(int node);
 
   // Notify the underlying storage that all data it contained has been
   // persisted.
@@ -577,6 +616,8 @@ class MemTable {
   int refs_;
   const size_t kArenaBlockSize;
   AllocTracker mem_tracker_;
+  // Must outlive arena_, which returns its blocks to it
+  std::shared_ptr<ArenaBlockPool> arena_block_pool_;
   ConcurrentArena arena_;
   std::unique_ptr<MemTableRep> table_;
   std::unique_ptr<MemTableRep> range_del_table_;
@@ -642,6 +683,9 @@ class MemTable {
   // Insert hints for each prefix.
   UnorderedMapH<Slice, void*, SliceHasher32> insert_hints_;
 
+  // See serial_insert_hint(). Allocated on the arena by the rep.
+  void* serial_insert_hint_;
+
   // Timestamp of oldest key
   std::atomic<uint64_t> oldest_key_time_;
 
@@ -683,6 +727,10 @@ class MemTable {
 
   void UpdateOldestKeyTime();
 
+  // Skips the keys of `range` that the memtable Bloom filter rules out.
+  // REQUIRES: GetBloomFilter() != nullptr
+  void SkipKeysNotInBloomFilter(MultiGetRange* range);
+
   void GetFromTable(const LookupKey& key,
                     SequenceNumber max_covering_tombstone_seq, bool do_merge,
                     ReadCallback* callback, bool* is_blob_index,
@@ -710,6 +758,11 @@ class MemTable {
   std::mutex range_del_mutex_;
   CoreLocalArray<std::shared_ptr<FragmentedRangeTombstoneListCache>>
       cached_range_tombstone_;
+  // Finds the tombstones covering a key for Get() and MultiGet() while the
+  // memtable is mutable, so that they don't have to fragment the tombstones
+  // again after every DeleteRange(). Updated under range_del_mutex_, and not
+  // used with user-defined timestamps.
+  std::unique_ptr<RangeTombstoneIndex> range_tombstone_index_;
 
   void UpdateEntryChecksum(const ProtectionInfoKVOS64* kv_prot_info,
                            const Slice& key, const Slice& value, ValueType type,
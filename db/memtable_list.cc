@@ -101,6 +101,10 @@ int MemTableList::NumFlushed() const {
   return static_cast<int>(current_->memlist_history_.size());
 }
 
+int MemTableList::NumFlushRunning() const {
+  return static_cast<int>(current_->memlist_.size()) - num_flush_not_started_;
+}
+
 // Search all the memtables starting from the most recent one.
 // Return the most recent value found, if any.
 // Operands stores the list of merge operations to apply, so far.
@@ -128,6 +132,15 @@ void MemTableListVersion::MultiGet(const ReadOptions& read_options,
   }
 }
 
+void MemTableListVersion::KeysMayExist(MultiGetRange* range) {
+  for (auto memtable : memlist_) {
+    memtable->KeysMayExist(range);
+    if (range->empty()) {
+      return;
+    }
+  }
+}
+
 bool MemTableListVersion::GetMergeOperands(
     const LookupKey& key, Status* s, MergeContext* merge_context,
     SequenceNumber* max_covering_tombstone_seq, const ReadOptions& read_opts) {
@@ -79,6 +79,9 @@ class MemTableListVersion {
   void MultiGet(const ReadOptions& read_options, MultiGetRange* range,
                 ReadCallback* callback);
 
+  // See MemTable::KeysMayExist()
+  void KeysMayExist(MultiGetRange* range);
+
   // Returns all the merge operands corresponding to the key by searching all
   // memtables starting from the most recent one.
   bool GetMergeOperands(const LookupKey& key, Status* s,
@@ -255,6 +258,10 @@ class MemTableList {
   // completely flushed and logged.
   int NumFlushed() const;
 
+  // Returns the number of memtables in the list whose flush has started but
+  // has not been installed yet.
+  int NumFlushRunning() const;
+
   // Returns true if there is at least one memtable on which flush has
   // not yet started.
   bool IsFlushPending() const;
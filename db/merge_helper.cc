@@ -5,6 +5,7 @@
 
 #include "db/merge_helper.h"
 
+#include <cstring>
 #include <string>
 
 #include "db/blob/blob_fetcher.h"
@@ -106,6 +107,66 @@ Status MergeHelper::TimedFullMergeCommonImpl(
                     std::move(merge_out.new_value));
 }
 
+bool MergeHelper::IsColumnUpdateMergeOperator(
+    const MergeOperator* merge_operator) {
+  return strcmp(merge_operator->Name(),
+                WideColumnSerialization::kUpdateMergeOperatorName) == 0;
+}
+
+Status MergeHelper::TimedColumnUpdateMerge(
+    const MergeOperator::MergeOperationInputV3::ExistingValue& existing_value,
+    const std::vector<Slice>& operands, Statistics* statistics,
+    SystemClock* clock, bool update_num_ops_stats,
+    MergeOperator::OpFailureScope* op_failure_scope, std::string* result) {
+  assert(!operands.empty());
+  assert(result);
+
+  if (update_num_ops_stats) {
+    RecordInHistogram(statistics, READ_NUM_MERGE_OPERANDS,
+                      static_cast<uint64_t>(operands.size()));
+  }
+
+  Status s;
+
+  {
+    StopWatchNano timer(clock, statistics != nullptr);
+    PERF_TIMER_GUARD(merge_operator_time_nanos);
+
+    WideColumns base;
+    if (const Slice* value = std::get_if<Slice>(&existing_value)) {
+      base.emplace_back(kDefaultWideColumnName, *value);
+    } else if (const WideColumns* columns =
+                   std::get_if<WideColumns>(&existing_value)) {
+      base = *columns;
+    }
+
+    WideColumnUpdates updates;
+    s = WideColumnSerialization::DeserializeUpdates(operands, updates);
+    if (s.ok()) {
+      WideColumns columns;
+      WideColumnSerialization::ApplyUpdates(base, updates, columns);
+
+      result->clear();
+      s = WideColumnSerialization::Serialize(columns, *result);
+    }
+
+    RecordTick(statistics, MERGE_OPERATION_TOTAL_TIME,
+               statistics ? timer.ElapsedNanos() : 0);
+  }
+
+  if (!s.ok()) {
+    RecordTick(statistics, NUMBER_MERGE_FAILURES);
+
+    if (op_failure_scope) {
+      *op_failure_scope = MergeOperator::OpFailureScope::kTryMerge;
+    }
+
+    return Status::Corruption(Status::SubCode::kMergeOperatorFailed);
+  }
+
+  return Status::OK();
+}
+
 Status MergeHelper::TimedFullMergeImpl(
     const MergeOperator* merge_operator, const Slice& key,
     MergeOperator::MergeOperationInputV3::ExistingValue&& existing_value,
@@ -116,6 +177,18 @@ Status MergeHelper::TimedFullMergeImpl(
   assert(result);
   assert(result_type);
 
+  if (IsColumnUpdateMergeOperator(merge_operator)) {
+    *result_type = kTypeWideColumnEntity;
+
+    if (result_operand) {
+      *result_operand = Slice(nullptr, 0);
+    }
+
+    return TimedColumnUpdateMerge(existing_value, operands, statistics, clock,
+                                  update_num_ops_stats, op_failure_scope,
+                                  result);
+  }
+
   auto visitor = overload{
       [&](std::string&& new_value) -> Status {
         *result_type = kTypeValue;
@@ -178,6 +251,34 @@ Status MergeHelper::TimedFullMergeImpl(
   assert(result_value || result_entity);
   assert(!result_value || !result_entity);
 
+  if (IsColumnUpdateMergeOperator(merge_operator)) {
+    std::string result;
+    Status s = TimedColumnUpdateMerge(existing_value, operands, statistics,
+                                      clock, update_num_ops_stats,
+                                      op_failure_scope, &result);
+    if (!s.ok()) {
+      if (result_entity) {
+        result_entity->Reset();
+      }
+      return s;
+    }
+
+    if (result_value) {
+      Slice entity(result);
+      Slice value;
+      s = WideColumnSerialization::GetValueOfDefaultColumn(entity, value);
+      if (s.ok()) {
+        result_value->assign(value.data(), value.size());
+      }
+
+      return s;
+    }
+
+    assert(result_entity);
+
+    return result_entity->SetWideColumnValue(std::move(result));
+  }
+
   auto visitor = overload{
       [&](std::string&& new_value) -> Status {
         if (result_value) {
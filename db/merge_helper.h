@@ -271,6 +271,19 @@ class MergeHelper {
       Statistics* statistics, SystemClock* clock, bool update_num_ops_stats,
       MergeOperator::OpFailureScope* op_failure_scope, Visitor&& visitor);
 
+  // Whether the operands of `merge_operator` are column updates
+  static bool IsColumnUpdateMergeOperator(const MergeOperator* merge_operator);
+
+  // Merges column updates into the existing value, treating a plain value as
+  // the default column, by splicing the columns of the base entity and the
+  // updates as slices and serializing the resulting entity into `result`.
+  static Status TimedColumnUpdateMerge(
+      const MergeOperator::MergeOperationInputV3::ExistingValue&
+          existing_value,
+      const std::vector<Slice>& operands, Statistics* statistics,
+      SystemClock* clock, bool update_num_ops_stats,
+      MergeOperator::OpFailureScope* op_failure_scope, std::string* result);
+
   // Variant that exposes the merge result directly (in serialized form for wide
   // columns) as well as its value type. Used by iterator and compaction.
   static Status TimedFullMergeImpl(
@@ -0,0 +1,74 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/merge_result_cache.h"
+
+#include "monitoring/statistics_impl.h"
+#include "rocksdb/statistics.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+std::shared_ptr<Cache> NewResultCache(size_t capacity) {
+  LRUCacheOptions opts;
+  opts.capacity = capacity;
+  return opts.MakeSharedCache();
+}
+}  // namespace
+
+MergeResultCache::MergeResultCache(size_t capacity,
+                                   std::shared_ptr<Cache> charge_cache)
+    : cache_(NewResultCache(capacity)) {
+  if (charge_cache) {
+    // Delay decreases, as evictions shrink the usage a little at a time
+    cache_res_mgr_ = std::make_shared<ConcurrentCacheReservationManager>(
+        std::make_shared<CacheReservationManagerImpl<CacheEntryRole::kMisc>>(
+            std::move(charge_cache), /*delayed_decrease=*/true));
+  }
+}
+
+void MergeResultCache::EncodeKey(const Slice& user_key, SequenceNumber seq,
+                                 std::string* key) {
+  key->reserve(user_key.size() + sizeof(uint64_t));
+  key->assign(user_key.data(), user_key.size());
+  PutFixed64(key, seq);
+}
+
+bool MergeResultCache::Lookup(const Slice& user_key, SequenceNumber seq,
+                              PinnableSlice* value, Statistics* stats) {
+  std::string key;
+  EncodeKey(user_key, seq, &key);
+  auto handle = cache_.Lookup(key);
+  if (handle == nullptr) {
+    RecordTick(stats, MERGE_RESULT_CACHE_MISS);
+    return false;
+  }
+  RecordTick(stats, MERGE_RESULT_CACHE_HIT);
+  Cleanable release;
+  cache_.RegisterReleaseAsCleanup(handle, release);
+  value->Reset();
+  value->PinSlice(*cache_.Value(handle), &release);
+  return true;
+}
+
+void MergeResultCache::Insert(const Slice& user_key, SequenceNumber seq,
+                              const Slice& value) {
+  std::string key;
+  EncodeKey(user_key, seq, &key);
+  auto result = std::make_unique<std::string>(value.data(), value.size());
+  const size_t charge = sizeof(std::string) + result->size();
+  Status s = cache_.Insert(key, result.get(), charge);
+  if (s.ok()) {
+    result.release();
+  }
+  if (cache_res_mgr_) {
+    // Failing to charge the block cache, when it is full with a strict
+    // capacity limit, is not a reason to fail the read
+    cache_res_mgr_->UpdateCacheReservation(GetUsage()).PermitUncheckedError();
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,58 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "cache/cache_reservation_manager.h"
+#include "cache/typed_cache.h"
+#include "db/dbformat.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class PinnableSlice;
+class Statistics;
+
+// Caches the results of merging the operands of a key on reads, keyed by the
+// user key and the sequence number of its newest operand. The entries with a
+// sequence number up to that one never change, so a cached result stays
+// valid, and a newer write of the key gives it a new newest sequence number,
+// which leaves the cached result to age out. The memory of the results is
+// charged to `charge_cache`, if any.
+//
+// Thread-safe.
+class MergeResultCache {
+ public:
+  MergeResultCache(size_t capacity, std::shared_ptr<Cache> charge_cache);
+
+  MergeResultCache(const MergeResultCache&) = delete;
+  MergeResultCache& operator=(const MergeResultCache&) = delete;
+
+  // Pins the merge result of `user_key` whose newest operand has sequence
+  // number `seq` to `value` and returns true if it is cached. Records the
+  // MERGE_RESULT_CACHE_HIT or MERGE_RESULT_CACHE_MISS ticker.
+  bool Lookup(const Slice& user_key, SequenceNumber seq, PinnableSlice* value,
+              Statistics* stats);
+
+  void Insert(const Slice& user_key, SequenceNumber seq, const Slice& value);
+
+  size_t GetUsage() const { return cache_.get()->GetUsage(); }
+
+ private:
+  using CacheInterface =
+      BasicTypedSharedCacheInterface<std::string, CacheEntryRole::kMisc>;
+
+  static void EncodeKey(const Slice& user_key, SequenceNumber seq,
+                        std::string* key);
+
+  CacheInterface cache_;
+  std::shared_ptr<CacheReservationManager> cache_res_mgr_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,156 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/multi_scan_iterator.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "rocksdb/comparator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Iterates over the ranges one after the other, with the upper bound of the
+// underlying iterator set to the limit of the current range. Only forward
+// iteration is supported.
+class MultiScanIterator : public Iterator {
+ public:
+  MultiScanIterator(const Comparator* ucmp, const std::vector<Range>& ranges)
+      : ucmp_(ucmp) {
+    ranges_.reserve(ranges.size());
+    for (const Range& range : ranges) {
+      ranges_.emplace_back(range.start.ToString(), range.limit.ToString());
+    }
+  }
+
+  // To set as ReadOptions::iterate_upper_bound of the underlying iterator
+  const Slice* upper_bound() const { return &upper_bound_; }
+
+  void SetIterator(Iterator* iter) { iter_.reset(iter); }
+
+  bool Valid() const override {
+    return current_ < ranges_.size() && status_.ok() && iter_->Valid();
+  }
+
+  void SeekToFirst() override {
+    status_ = Status::OK();
+    SeekInRange(0, ranges_.empty() ? Slice() : Slice(ranges_[0].first));
+  }
+
+  void Seek(const Slice& target) override {
+    status_ = Status::OK();
+    // The first range ending after the target
+    size_t index = 0;
+    size_t end = ranges_.size();
+    while (index < end) {
+      size_t mid = index + (end - index) / 2;
+      if (ucmp_->CompareWithoutTimestamp(ranges_[mid].second, target) > 0) {
+        end = mid;
+      } else {
+        index = mid + 1;
+      }
+    }
+    if (index < ranges_.size() &&
+        ucmp_->CompareWithoutTimestamp(target, ranges_[index].first) < 0) {
+      SeekInRange(index, ranges_[index].first);
+    } else {
+      SeekInRange(index, target);
+    }
+  }
+
+  void Next() override {
+    assert(Valid());
+    iter_->Next();
+    SkipExhaustedRanges();
+  }
+
+  void SeekToLast() override { SetNotSupported(); }
+  void SeekForPrev(const Slice& /*target*/) override { SetNotSupported(); }
+  void Prev() override { SetNotSupported(); }
+
+  Slice key() const override {
+    assert(Valid());
+    return iter_->key();
+  }
+  Slice value() const override {
+    assert(Valid());
+    return iter_->value();
+  }
+  const WideColumns& columns() const override {
+    assert(Valid());
+    return iter_->columns();
+  }
+  Slice timestamp() const override {
+    assert(Valid());
+    return iter_->timestamp();
+  }
+  Status status() const override {
+    return status_.ok() ? iter_->status() : status_;
+  }
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(std::move(prop_name), prop);
+  }
+
+ private:
+  void SeekInRange(size_t index, const Slice& target) {
+    current_ = index;
+    if (current_ < ranges_.size()) {
+      upper_bound_ = ranges_[current_].second;
+      iter_->Seek(target);
+      SkipExhaustedRanges();
+    }
+  }
+
+  // Moves to the first key of the next ranges if the current one has none
+  // left
+  void SkipExhaustedRanges() {
+    while (!iter_->Valid() && iter_->status().ok() &&
+           ++current_ < ranges_.size()) {
+      upper_bound_ = ranges_[current_].second;
+      iter_->Seek(ranges_[current_].first);
+    }
+  }
+
+  void SetNotSupported() {
+    status_ = Status::NotSupported(
+        "Multi-range scan iterators only iterate forward");
+  }
+
+  const Comparator* const ucmp_;
+  // Start and limit of each range
+  std::vector<std::pair<std::string, std::string>> ranges_;
+  size_t current_ = 0;
+  Slice upper_bound_;
+  Status status_;
+  // Declared last, as it points to upper_bound_
+  std::unique_ptr<Iterator> iter_;
+};
+}  // namespace
+
+Iterator* NewMultiScanIterator(DB* db, const ReadOptions& read_options,
+                               ColumnFamilyHandle* column_family,
+                               const std::vector<Range>& ranges) {
+  const Comparator* ucmp = column_family->GetComparator();
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (ucmp->CompareWithoutTimestamp(ranges[i].start, ranges[i].limit) >= 0 ||
+        (i > 0 && ucmp->CompareWithoutTimestamp(ranges[i - 1].limit,
+                                                ranges[i].start) > 0)) {
+      return NewErrorIterator(Status::InvalidArgument(
+          "Ranges of a multi-range scan must be non-empty, sorted and "
+          "disjoint"));
+    }
+  }
+  auto* multi_scan_iter = new MultiScanIterator(ucmp, ranges);
+  ReadOptions scan_read_options(read_options);
+  scan_read_options.iterate_lower_bound = nullptr;
+  scan_read_options.iterate_upper_bound = multi_scan_iter->upper_bound();
+  multi_scan_iter->SetIterator(db->NewIterator(scan_read_options,
+                                               column_family));
+  return multi_scan_iter;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
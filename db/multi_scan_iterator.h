@@ -0,0 +1,22 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <vector>
+
+#include "rocksdb/db.h"
+#include "rocksdb/iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Creates the iterator of DB::NewMultiScanIterator() from an iterator of
+// `db`, whose upper bound is moved from range to range. Returns an error
+// iterator if `ranges` are not sorted and disjoint.
+Iterator* NewMultiScanIterator(DB* db, const ReadOptions& read_options,
+                               ColumnFamilyHandle* column_family,
+                               const std::vector<Range>& ranges);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,86 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/parallel_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "port/port.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+Status ParallelScan(DB* db, const ReadOptions& read_options,
+                    ColumnFamilyHandle* column_family, const Range& range,
+                    const std::vector<std::string>& boundaries,
+                    int num_threads, const DB::ParallelScanCallback& callback) {
+  ReadOptions scan_read_options(read_options);
+  size_t num_ranges = boundaries.size() + 1;
+  const Snapshot* snapshot = nullptr;
+  if (num_ranges > 1 && read_options.snapshot == nullptr) {
+    snapshot = db->GetSnapshot();
+    if (snapshot == nullptr) {
+      // Without a snapshot the sub-ranges would see different states of the
+      // DB, so scan the range at once
+      num_ranges = 1;
+    }
+    scan_read_options.snapshot = snapshot;
+  }
+
+  std::atomic<size_t> next_range{0};
+  std::atomic<bool> stop{false};
+  port::Mutex mutex;
+  Status status;
+  auto scan = [&]() {
+    ReadOptions ro(scan_read_options);
+    Slice lower_bound;
+    Slice upper_bound;
+    ro.iterate_lower_bound = &lower_bound;
+    ro.iterate_upper_bound = &upper_bound;
+    size_t i;
+    while (!stop.load(std::memory_order_relaxed) &&
+           (i = next_range.fetch_add(1, std::memory_order_relaxed)) <
+               num_ranges) {
+      lower_bound = i == 0 ? range.start : Slice(boundaries[i - 1]);
+      upper_bound = i + 1 == num_ranges ? range.limit : Slice(boundaries[i]);
+      std::unique_ptr<Iterator> iter(db->NewIterator(ro, column_family));
+      for (iter->Seek(lower_bound);
+           iter->Valid() && !stop.load(std::memory_order_relaxed);
+           iter->Next()) {
+        if (!callback(iter->key(), iter->value())) {
+          stop.store(true, std::memory_order_relaxed);
+        }
+      }
+      Status s = iter->status();
+      if (!s.ok()) {
+        MutexLock l(&mutex);
+        if (status.ok()) {
+          status = s;
+        }
+        stop.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  std::vector<port::Thread> threads;
+  const size_t num_scan_threads =
+      std::min(static_cast<size_t>(std::max(num_threads, 1)), num_ranges);
+  threads.reserve(num_scan_threads - 1);
+  for (size_t i = 1; i < num_scan_threads; ++i) {
+    threads.emplace_back(scan);
+  }
+  scan();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (snapshot != nullptr) {
+    db->ReleaseSnapshot(snapshot);
+  }
+  return status;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,23 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "rocksdb/db.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Scans `range` as in DB::ParallelScan(), split into sub-ranges at
+// `boundaries`, which must be sorted and strictly inside of `range`. Without
+// boundaries, `range` is scanned on the calling thread.
+Status ParallelScan(DB* db, const ReadOptions& read_options,
+                    ColumnFamilyHandle* column_family, const Range& range,
+                    const std::vector<std::string>& boundaries,
+                    int num_threads, const DB::ParallelScanCallback& callback);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -22,6 +22,8 @@ enum class PeriodicTaskType : uint8_t {
   kPersistStats,
   kFlushInfoLog,
   kRecordSeqnoTime,
+  kThrottleCompaction,
+  kPersistBlockCacheHotness,
   kMax,
 };
 
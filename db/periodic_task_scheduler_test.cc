@@ -219,6 +219,68 @@ TEST_F(PeriodicTaskSchedulerTest, MultiEnv) {
   Close();
 }
 
+TEST_F(PeriodicTaskSchedulerTest, ThrottleCompaction) {
+  constexpr int kPeriodSec = 10;
+  constexpr int64_t kRateBytesPerSec = 1 << 20;
+  Close();
+  Options options;
+  options.create_if_missing = true;
+  options.env = mock_env_.get();
+  options.statistics = CreateDBStatistics();
+  options.rate_limiter.reset(NewGenericRateLimiter(kRateBytesPerSec));
+  // Allows 6 compactions
+  options.max_background_jobs = 8;
+  options.compaction_throttle_latency_micros = 1000000;
+
+  int throttle_counter = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::ThrottleCompaction:StartRunning",
+      [&](void*) { throttle_counter++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Reopen(options);
+  const PeriodicTaskScheduler& scheduler =
+      dbfull()->TEST_GetPeriodicTaskScheduler();
+  ASSERT_EQ(2, scheduler.TEST_GetValidTaskNum());
+  ASSERT_EQ(1, dbfull()->TEST_BGCompactionsAllowed());
+
+  // Without foreground operations the budget grows up to the limit
+  for (int i = 1; i <= 7; i++) {
+    dbfull()->TEST_WaitForPeriodicTaskRun(
+        [&] { mock_clock_->MockSleepForSeconds(kPeriodSec); });
+    ASSERT_EQ(i, throttle_counter);
+    ASSERT_EQ(std::min(i, 6), dbfull()->TEST_BGCompactionsAllowed());
+  }
+  ASSERT_EQ(kRateBytesPerSec, options.rate_limiter->GetBytesPerSecond());
+
+  // Slow foreground operations halve it, along with the compaction rate
+  options.statistics->reportTimeToHistogram(DB_GET, 2000000);
+  dbfull()->TEST_WaitForPeriodicTaskRun(
+      [&] { mock_clock_->MockSleepForSeconds(kPeriodSec); });
+  ASSERT_EQ(3, dbfull()->TEST_BGCompactionsAllowed());
+  ASSERT_EQ(kRateBytesPerSec / 2, options.rate_limiter->GetBytesPerSecond());
+
+  // Fast ones let both grow again
+  options.statistics->reportTimeToHistogram(DB_WRITE, 10);
+  dbfull()->TEST_WaitForPeriodicTaskRun(
+      [&] { mock_clock_->MockSleepForSeconds(kPeriodSec); });
+  ASSERT_EQ(4, dbfull()->TEST_BGCompactionsAllowed());
+  ASSERT_EQ(kRateBytesPerSec / 2 + kRateBytesPerSec / 8,
+            options.rate_limiter->GetBytesPerSecond());
+
+  // Disabling it restores the defaults
+  ASSERT_OK(
+      dbfull()->SetDBOptions({{"compaction_throttle_latency_micros", "0"}}));
+  ASSERT_EQ(1, scheduler.TEST_GetValidTaskNum());
+  ASSERT_EQ(1, dbfull()->TEST_BGCompactionsAllowed());
+  ASSERT_EQ(kRateBytesPerSec, options.rate_limiter->GetBytesPerSecond());
+
+  ASSERT_OK(dbfull()->SetDBOptions(
+      {{"compaction_throttle_latency_micros", "1000000"}}));
+  ASSERT_EQ(2, scheduler.TEST_GetValidTaskNum());
+  Close();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
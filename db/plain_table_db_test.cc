@@ -668,6 +668,41 @@ TEST_P(PlainTableDBTest, Immortal) {
   }
 }
 
+TEST_P(PlainTableDBTest, OpenWithIndexInFile) {
+  // A table with its index stored in the file opens without scanning data
+  for (int store_index_in_file = 0; store_index_in_file <= 1;
+       ++store_index_in_file) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    PlainTableOptions plain_table_options;
+    plain_table_options.user_key_len = 16;
+    plain_table_options.bloom_bits_per_key = 10;
+    plain_table_options.hash_table_ratio = 0.75;
+    plain_table_options.index_sparseness = 2;
+    plain_table_options.store_index_in_file = store_index_in_file;
+    options.table_factory.reset(NewPlainTableFactory(plain_table_options));
+
+    DestroyAndReopen(&options);
+    ASSERT_OK(Put("1000000000000foo", "v1"));
+    ASSERT_OK(Put("0000000000000bar", "v2"));
+    ASSERT_OK(dbfull()->TEST_FlushMemTable());
+    Close();
+
+    int scans = 0;
+    SyncPoint::GetInstance()->SetCallBack(
+        "PlainTableReader::PopulateIndexRecordList",
+        [&](void* /*arg*/) { scans++; });
+    SyncPoint::GetInstance()->EnableProcessing();
+    ASSERT_OK(ReopenForReadOnly(&options));
+    ASSERT_EQ("v1", Get("1000000000000foo"));
+    ASSERT_EQ("v2", Get("0000000000000bar"));
+    ASSERT_EQ("NOT_FOUND", Get("1000000000000bar"));
+    ASSERT_EQ(store_index_in_file ? 0 : 1, scans);
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+  }
+}
+
 TEST_P(PlainTableDBTest, Iterator) {
   for (size_t huge_page_tlb_size = 0; huge_page_tlb_size <= 2 * 1024 * 1024;
        huge_page_tlb_size += 2 * 1024 * 1024) {
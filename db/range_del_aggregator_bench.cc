@@ -22,6 +22,8 @@ int main() {
 #include "db/dbformat.h"
 #include "db/range_del_aggregator.h"
 #include "db/range_tombstone_fragmenter.h"
+#include "db/range_tombstone_index.h"
+#include "memory/arena.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/system_clock.h"
 #include "util/coding.h"
@@ -58,6 +60,12 @@ DEFINE_bool(use_compaction_range_del_aggregator, false,
             "Whether to use CompactionRangeDelAggregator. Default is to use "
             "ReadRangeDelAggregator.");
 
+DEFINE_bool(memtable_churn, false,
+            "Instead of the aggregators, measure looking up keys in a memtable "
+            "after each of its range tombstones is added, with the tombstones "
+            "fragmented again on every change as the memtable cache does, and "
+            "with RangeTombstoneIndex.");
+
 namespace {
 
 struct Stats {
@@ -65,6 +73,9 @@ struct Stats {
   uint64_t time_first_should_delete = 0;
   uint64_t time_rest_should_delete = 0;
   uint64_t time_fragment_tombstones = 0;
+  uint64_t time_index_add = 0;
+  uint64_t time_index_lookup = 0;
+  uint64_t time_fragmented_lookup = 0;
 };
 
 std::ostream& operator<<(std::ostream& os, const Stats& s) {
@@ -72,6 +83,20 @@ std::ostream& operator<<(std::ostream& os, const Stats& s) {
   fmt_holder.copyfmt(os);
 
   os << std::left;
+  if (FLAGS_memtable_churn) {
+    const double adds = FLAGS_num_range_tombstones * FLAGS_num_runs * 1.0e3;
+    const double lookups = adds * FLAGS_should_deletes_per_run;
+    os << std::setw(25) << "Fragment Tombstones: "
+       << s.time_fragment_tombstones / adds << " us\n";
+    os << std::setw(25) << "Fragmented Lookup: "
+       << s.time_fragmented_lookup / lookups << " us\n";
+    os << std::setw(25) << "Index Add: " << s.time_index_add / adds
+       << " us\n";
+    os << std::setw(25) << "Index Lookup: " << s.time_index_lookup / lookups
+       << " us\n";
+    os.copyfmt(fmt_holder);
+    return os;
+  }
   os << std::setw(25) << "Fragment Tombstones: "
      << s.time_fragment_tombstones /
             (FLAGS_add_tombstones_per_run * FLAGS_num_runs * 1.0e3)
@@ -173,6 +198,54 @@ static std::string Key(int64_t val) {
   return big_endian_key;
 }
 
+// Adds range tombstones one at a time, as DeleteRange() does to a memtable,
+// and after each one looks up should_deletes_per_run keys the way
+// MemTable::Get() does.
+void RunMemtableChurn(Stats* stats, SystemClock* clock, Random64* rnd,
+                      std::default_random_engine* random_gen,
+                      std::normal_distribution<double>* normal_dist) {
+  for (int i = 0; i < FLAGS_num_runs; i++) {
+    std::vector<PersistentRangeTombstone> range_dels;
+    range_dels.reserve(FLAGS_num_range_tombstones);
+    Arena arena;
+    RangeTombstoneIndex index(BytewiseComparator(), &arena);
+    for (int j = 0; j < FLAGS_num_range_tombstones; j++) {
+      uint64_t start = rnd->Uniform(FLAGS_tombstone_start_upper_bound);
+      uint64_t end = static_cast<uint64_t>(
+          std::round(start + std::max(1.0, (*normal_dist)(*random_gen))));
+      range_dels.emplace_back(Key(start), Key(end), j + 1);
+
+      StopWatchNano stop_watch_fragment(clock, true /* auto_start */);
+      FragmentedRangeTombstoneList fragmented(MakeRangeDelIterator(range_dels),
+                                              icmp);
+      stats->time_fragment_tombstones += stop_watch_fragment.ElapsedNanos();
+      StopWatchNano stop_watch_index_add(clock, true /* auto_start */);
+      index.Add(range_dels.back().start_key, range_dels.back().end_key, j + 1);
+      stats->time_index_add += stop_watch_index_add.ElapsedNanos();
+
+      for (int k = 0; k < FLAGS_should_deletes_per_run; k++) {
+        std::string key = Key(rnd->Uniform(FLAGS_should_delete_upper_bound));
+        StopWatchNano stop_watch_fragmented_lookup(clock,
+                                                   true /* auto_start */);
+        FragmentedRangeTombstoneIterator iter(&fragmented, icmp,
+                                              kMaxSequenceNumber);
+        SequenceNumber expected = iter.MaxCoveringTombstoneSeqnum(key);
+        stats->time_fragmented_lookup +=
+            stop_watch_fragmented_lookup.ElapsedNanos();
+        StopWatchNano stop_watch_index_lookup(clock, true /* auto_start */);
+        SequenceNumber actual =
+            index.MaxCoveringTombstoneSeqnum(key, kMaxSequenceNumber);
+        stats->time_index_lookup += stop_watch_index_lookup.ElapsedNanos();
+        if (actual != expected) {
+          fprintf(stderr, "Mismatch: fragmented %" PRIu64 ", index %" PRIu64
+                  "\n", expected, actual);
+          exit(1);
+        }
+      }
+    }
+  }
+}
+
 }  // anonymous namespace
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -187,6 +260,15 @@ int main(int argc, char** argv) {
   std::default_random_engine random_gen(FLAGS_seed);
   std::normal_distribution<double> normal_dist(FLAGS_tombstone_width_mean,
                                                FLAGS_tombstone_width_stddev);
+  if (FLAGS_memtable_churn) {
+    ROCKSDB_NAMESPACE::RunMemtableChurn(&stats, clock, &rnd, &random_gen,
+                                        &normal_dist);
+    std::cout << "=========================\n"
+              << "Results:\n"
+              << "=========================\n"
+              << stats;
+    return 0;
+  }
   std::vector<std::vector<ROCKSDB_NAMESPACE::PersistentRangeTombstone> >
       all_persistent_range_tombstones(FLAGS_add_tombstones_per_run);
   for (int i = 0; i < FLAGS_add_tombstones_per_run; i++) {
@@ -0,0 +1,95 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/range_tombstone_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "memory/allocator.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+RangeTombstoneIndex::RangeTombstoneIndex(const Comparator* ucmp,
+                                         Allocator* allocator)
+    : ucmp_(ucmp),
+      allocator_(allocator),
+      boundaries_(BoundaryComparator{ucmp}, allocator) {}
+
+void RangeTombstoneIndex::EncodeTarget(std::string* buf,
+                                       const Slice& user_key) {
+  buf->assign(sizeof(std::atomic<const SeqNode*>), '\0');
+  PutLengthPrefixedSlice(buf, user_key);
+}
+
+const char* RangeTombstoneIndex::EnsureBoundary(const Slice& key) {
+  std::string target;
+  EncodeTarget(&target, key);
+  BoundaryList::Iterator iter(&boundaries_);
+  iter.SeekForPrev(target.data());
+  if (iter.Valid() &&
+      ucmp_->Compare(BoundaryComparator::decode_key(iter.key()), key) == 0) {
+    return iter.key();
+  }
+  // The new boundary splits the fragment before it, so it starts out covered
+  // by the same tombstones.
+  const SeqNode* covering =
+      iter.Valid() ? Head(iter.key())->load(std::memory_order_relaxed)
+                   : nullptr;
+  const uint32_t key_size = static_cast<uint32_t>(key.size());
+  char* buf = boundaries_.AllocateKey(sizeof(std::atomic<const SeqNode*>) +
+                                      VarintLength(key_size) + key_size);
+  assert(reinterpret_cast<uintptr_t>(buf) %
+             alignof(std::atomic<const SeqNode*>) ==
+         0);
+  new (buf) std::atomic<const SeqNode*>(covering);
+  char* p = EncodeVarint32(buf + sizeof(std::atomic<const SeqNode*>), key_size);
+  memcpy(p, key.data(), key_size);
+  boundaries_.Insert(buf);
+  return buf;
+}
+
+void RangeTombstoneIndex::Add(const Slice& start, const Slice& end,
+                              SequenceNumber seq) {
+  if (ucmp_->Compare(start, end) >= 0) {
+    return;
+  }
+  EnsureBoundary(end);
+  BoundaryList::Iterator iter(&boundaries_);
+  for (iter.Seek(EnsureBoundary(start));
+       iter.Valid() &&
+       ucmp_->Compare(BoundaryComparator::decode_key(iter.key()), end) < 0;
+       iter.Next()) {
+    std::atomic<const SeqNode*>* head = Head(iter.key());
+    const SeqNode* next = head->load(std::memory_order_relaxed);
+    const SequenceNumber max_seq =
+        next != nullptr ? std::max(seq, next->max_seq) : seq;
+    auto* node = new (allocator_->AllocateAligned(sizeof(SeqNode)))
+        SeqNode{seq, max_seq, next};
+    head->store(node, std::memory_order_release);
+  }
+}
+
+SequenceNumber RangeTombstoneIndex::MaxCoveringTombstoneSeqnum(
+    const Slice& user_key, SequenceNumber read_seq) const {
+  std::string target;
+  EncodeTarget(&target, user_key);
+  BoundaryList::Iterator iter(&boundaries_);
+  iter.SeekForPrev(target.data());
+  if (!iter.Valid()) {
+    return 0;
+  }
+  SequenceNumber result = 0;
+  for (const SeqNode* node = Head(iter.key())->load(std::memory_order_acquire);
+       node != nullptr && node->max_seq > result; node = node->next) {
+    if (node->seq <= read_seq && node->seq > result) {
+      result = node->seq;
+    }
+  }
+  return result;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,98 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "db/dbformat.h"
+#include "memtable/inlineskiplist.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Allocator;
+
+// RangeTombstoneIndex answers which range tombstones cover a user key without
+// fragmenting them first, so that a memtable taking a steady stream of
+// DeleteRange() does not have to rebuild a FragmentedRangeTombstoneList for
+// every Get() after each new tombstone.
+//
+// It keeps the fragment boundaries, the start and end keys of all tombstones,
+// in a skip list. Each boundary points to the sequence numbers of the
+// tombstones covering the keys from it up to the next boundary, as a linked
+// list that is only ever prepended to, so that a new boundary can share the
+// list of the fragment it splits. Adding a tombstone costs O(log n) plus the
+// number of fragments it covers; a lookup costs O(log n) plus, at most, the
+// number of tombstones covering the key.
+//
+// Add() requires external synchronization. MaxCoveringTombstoneSeqnum() can be
+// called concurrently with it and with itself. User-defined timestamps are
+// not supported.
+class RangeTombstoneIndex {
+ public:
+  // ucmp and allocator must outlive the index.
+  RangeTombstoneIndex(const Comparator* ucmp, Allocator* allocator);
+  // No copying allowed
+  RangeTombstoneIndex(const RangeTombstoneIndex&) = delete;
+  void operator=(const RangeTombstoneIndex&) = delete;
+
+  // Adds the tombstone deleting [start, end) at seq. Does nothing if the
+  // range is empty.
+  void Add(const Slice& start, const Slice& end, SequenceNumber seq);
+
+  // Returns the largest sequence number not above read_seq of the tombstones
+  // covering user_key, or 0 if there is none.
+  SequenceNumber MaxCoveringTombstoneSeqnum(const Slice& user_key,
+                                            SequenceNumber read_seq) const;
+
+ private:
+  struct SeqNode {
+    SequenceNumber seq;
+    // The largest seq of this node and the ones after it, so that a lookup
+    // can stop once the rest of the list can't beat what it found
+    SequenceNumber max_seq;
+    const SeqNode* next;
+  };
+
+  // A boundary is stored in the skip list as the head of its fragment's
+  // SeqNode list, followed by the varint32-prefixed user key.
+  struct BoundaryComparator {
+    using DecodedType = Slice;
+
+    static Slice decode_key(const char* b) {
+      return GetLengthPrefixedSlice(b + sizeof(std::atomic<const SeqNode*>));
+    }
+    int operator()(const char* a, const char* b) const {
+      return ucmp->Compare(decode_key(a), decode_key(b));
+    }
+    int operator()(const char* a, const Slice& b) const {
+      return ucmp->Compare(decode_key(a), b);
+    }
+
+    const Comparator* ucmp;
+  };
+
+  using BoundaryList = InlineSkipList<BoundaryComparator>;
+
+  static std::atomic<const SeqNode*>* Head(const char* boundary) {
+    return reinterpret_cast<std::atomic<const SeqNode*>*>(
+        const_cast<char*>(boundary));
+  }
+
+  // Encodes user_key as a search target for boundaries_.
+  static void EncodeTarget(std::string* buf, const Slice& user_key);
+
+  // Makes key a boundary if it isn't one, and returns it.
+  const char* EnsureBoundary(const Slice& key);
+
+  const Comparator* ucmp_;
+  Allocator* const allocator_;
+  BoundaryList boundaries_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,101 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/range_tombstone_index.h"
+
+#include <string>
+#include <vector>
+
+#include "memory/arena.h"
+#include "port/stack_trace.h"
+#include "rocksdb/comparator.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class RangeTombstoneIndexTest : public testing::Test {
+ public:
+  RangeTombstoneIndexTest() : index_(BytewiseComparator(), &arena_) {}
+
+ protected:
+  Arena arena_;
+  RangeTombstoneIndex index_;
+};
+
+TEST_F(RangeTombstoneIndexTest, Empty) {
+  ASSERT_EQ(0, index_.MaxCoveringTombstoneSeqnum("a", kMaxSequenceNumber));
+  index_.Add("b", "b", 1);
+  index_.Add("c", "b", 2);
+  ASSERT_EQ(0, index_.MaxCoveringTombstoneSeqnum("b", kMaxSequenceNumber));
+}
+
+TEST_F(RangeTombstoneIndexTest, OverlappingTombstones) {
+  index_.Add("b", "f", 10);
+  index_.Add("d", "h", 20);
+  index_.Add("a", "c", 5);
+  index_.Add("e", "e", 30);
+
+  ASSERT_EQ(5, index_.MaxCoveringTombstoneSeqnum("a", kMaxSequenceNumber));
+  ASSERT_EQ(10, index_.MaxCoveringTombstoneSeqnum("b", kMaxSequenceNumber));
+  ASSERT_EQ(10, index_.MaxCoveringTombstoneSeqnum("c", kMaxSequenceNumber));
+  ASSERT_EQ(20, index_.MaxCoveringTombstoneSeqnum("d", kMaxSequenceNumber));
+  ASSERT_EQ(20, index_.MaxCoveringTombstoneSeqnum("ee", kMaxSequenceNumber));
+  ASSERT_EQ(20, index_.MaxCoveringTombstoneSeqnum("g", kMaxSequenceNumber));
+  ASSERT_EQ(0, index_.MaxCoveringTombstoneSeqnum("h", kMaxSequenceNumber));
+  ASSERT_EQ(0, index_.MaxCoveringTombstoneSeqnum("z", kMaxSequenceNumber));
+
+  // Tombstones newer than the read are not visible
+  ASSERT_EQ(10, index_.MaxCoveringTombstoneSeqnum("e", 19));
+  ASSERT_EQ(0, index_.MaxCoveringTombstoneSeqnum("g", 19));
+  ASSERT_EQ(5, index_.MaxCoveringTombstoneSeqnum("b", 9));
+  ASSERT_EQ(0, index_.MaxCoveringTombstoneSeqnum("b", 4));
+}
+
+TEST_F(RangeTombstoneIndexTest, RandomAgainstModel) {
+  struct Tombstone {
+    std::string start;
+    std::string end;
+    SequenceNumber seq;
+  };
+  auto key = [](uint32_t k) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%06u", k);
+    return std::string(buf);
+  };
+  constexpr uint32_t kKeySpace = 1000;
+  Random rnd(301);
+  std::vector<Tombstone> model;
+  for (SequenceNumber seq = 1; seq <= 500; seq++) {
+    uint32_t start = rnd.Uniform(kKeySpace);
+    uint32_t end = start + rnd.Uniform(100);
+    model.push_back({key(start), key(end), seq});
+    index_.Add(model.back().start, model.back().end, seq);
+
+    if (seq % 50 != 0) {
+      continue;
+    }
+    for (uint32_t k = 0; k < kKeySpace + 100; k += 3) {
+      std::string user_key = key(k);
+      SequenceNumber read_seq = rnd.Uniform(static_cast<int>(seq) + 1);
+      SequenceNumber expected = 0;
+      for (const auto& t : model) {
+        if (t.start <= user_key && user_key < t.end && t.seq <= read_seq) {
+          expected = std::max(expected, t.seq);
+        }
+      }
+      ASSERT_EQ(expected, index_.MaxCoveringTombstoneSeqnum(user_key, read_seq))
+          << user_key << " @" << read_seq;
+    }
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
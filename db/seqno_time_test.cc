@@ -1194,6 +1194,50 @@ TEST_F(SeqnoTimeTest, PrePopulate) {
   }
 }
 
+TEST_F(SeqnoTimeTest, InterpolatedLookups) {
+  // Lookups start at interpolated positions, so check them against a linear
+  // scan on evenly spread samples and on skewed ones, where the interpolation
+  // misses by far
+  Random rnd(301);
+  for (bool skewed : {false, true}) {
+    SeqnoToTimeMapping test(/*max_time_duration=*/0, /*max_capacity=*/1000);
+    std::vector<std::pair<SequenceNumber, uint64_t>> pairs;
+    SequenceNumber seqno = 100;
+    uint64_t time = 1000;
+    for (int i = 0; i < 500; ++i) {
+      if (skewed && i % 100 == 99) {
+        seqno += 1000000;
+        time += 1000000;
+      } else {
+        seqno += 1 + rnd.Uniform(20);
+        time += 1 + rnd.Uniform(20);
+      }
+      ASSERT_TRUE(test.Append(seqno, time));
+      pairs.emplace_back(seqno, time);
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+      const SequenceNumber s = rnd.Uniform(static_cast<int>(seqno + 200));
+      uint64_t expected_time = kUnknownTimeBeforeAll;
+      for (const auto& p : pairs) {
+        if (p.first < s) {
+          expected_time = p.second;
+        }
+      }
+      ASSERT_EQ(test.GetProximalTimeBeforeSeqno(s), expected_time);
+
+      const uint64_t t = rnd.Uniform(static_cast<int>(time + 200));
+      SequenceNumber expected_seqno = kUnknownSeqnoBeforeAll;
+      for (const auto& p : pairs) {
+        if (p.second <= t) {
+          expected_seqno = p.first;
+        }
+      }
+      ASSERT_EQ(test.GetProximalSeqnoBeforeTime(t), expected_seqno);
+    }
+  }
+}
+
 TEST_F(SeqnoTimeTest, TruncateOldEntries) {
   constexpr uint64_t kMaxTimeDuration = 42;
   SeqnoToTimeMapping test(kMaxTimeDuration, /*max_capacity=*/10);
@@ -1283,7 +1327,7 @@ TEST_F(SeqnoTimeTest, Sort) {
 
   auto seqs = test.TEST_GetInternalMapping();
 
-  std::deque<SeqnoToTimeMapping::SeqnoTimePair> expected;
+  std::vector<SeqnoToTimeMapping::SeqnoTimePair> expected;
   expected.emplace_back(1, 10);
   expected.emplace_back(10, 11);
   expected.emplace_back(100, 100);
@@ -1339,7 +1383,7 @@ TEST_F(SeqnoTimeTest, EncodeDecodePerferNewTime) {
   ASSERT_EQ(decoded.Size(), 3);
 
   auto seqs = decoded.TEST_GetInternalMapping();
-  std::deque<SeqnoToTimeMapping::SeqnoTimePair> expected;
+  std::vector<SeqnoToTimeMapping::SeqnoTimePair> expected;
   expected.emplace_back(1, 10);
   expected.emplace_back(6, 25);
   expected.emplace_back(8, 30);
@@ -11,22 +11,80 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// Returns the first pair of `pairs`, sorted by `key`, not `before` the target.
+// The search starts at the position of the target interpolated between the
+// first and last keys and gallops from there, so it takes O(1) probes when
+// the keys grow about linearly and O(log n) at worst.
+template <typename Key, typename Before>
+std::vector<SeqnoToTimeMapping::SeqnoTimePair>::const_iterator
+InterpolatedPartitionPoint(
+    const std::vector<SeqnoToTimeMapping::SeqnoTimePair>& pairs,
+    uint64_t target, Key key, Before before) {
+  const size_t n = pairs.size();
+  if (n == 0 || !before(pairs.front())) {
+    return pairs.cbegin();
+  }
+  if (before(pairs.back())) {
+    return pairs.cend();
+  }
+
+  // Here key(front) <= target <= key(back), and the keys differ
+  const uint64_t first = key(pairs.front());
+  const uint64_t last = key(pairs.back());
+  assert(first < last);
+  const double fraction = static_cast<double>(target - first) /
+                          static_cast<double>(last - first);
+  const size_t guess = std::min(
+      n - 1, static_cast<size_t>(fraction * static_cast<double>(n - 1)));
+
+  // Narrow down [lo, hi] with before(lo) and !before(hi)
+  size_t lo = 0;
+  size_t hi = n - 1;
+  if (before(pairs[guess])) {
+    lo = guess;
+    for (size_t step = 1; lo + step < hi; step *= 2) {
+      if (!before(pairs[lo + step])) {
+        hi = lo + step;
+        break;
+      }
+      lo += step;
+    }
+  } else {
+    hi = guess;
+    for (size_t step = 1; lo + step < hi; step *= 2) {
+      if (before(pairs[hi - step])) {
+        lo = hi - step;
+        break;
+      }
+      hi -= step;
+    }
+  }
+
+  return std::partition_point(pairs.cbegin() + lo + 1, pairs.cbegin() + hi,
+                              before);
+}
+}  // namespace
+
 SeqnoToTimeMapping::pair_const_iterator SeqnoToTimeMapping::FindGreaterTime(
     uint64_t time) const {
-  return std::upper_bound(pairs_.cbegin(), pairs_.cend(),
-                          SeqnoTimePair{0, time}, SeqnoTimePair::TimeLess);
+  return InterpolatedPartitionPoint(
+      pairs_, time, [](const SeqnoTimePair& p) { return p.time; },
+      [time](const SeqnoTimePair& p) { return p.time <= time; });
 }
 
 SeqnoToTimeMapping::pair_const_iterator SeqnoToTimeMapping::FindGreaterEqSeqno(
     SequenceNumber seqno) const {
-  return std::lower_bound(pairs_.cbegin(), pairs_.cend(),
-                          SeqnoTimePair{seqno, 0}, SeqnoTimePair::SeqnoLess);
+  return InterpolatedPartitionPoint(
+      pairs_, seqno, [](const SeqnoTimePair& p) { return p.seqno; },
+      [seqno](const SeqnoTimePair& p) { return p.seqno < seqno; });
 }
 
 SeqnoToTimeMapping::pair_const_iterator SeqnoToTimeMapping::FindGreaterSeqno(
     SequenceNumber seqno) const {
-  return std::upper_bound(pairs_.cbegin(), pairs_.cend(),
-                          SeqnoTimePair{seqno, 0}, SeqnoTimePair::SeqnoLess);
+  return InterpolatedPartitionPoint(
+      pairs_, seqno, [](const SeqnoTimePair& p) { return p.seqno; },
+      [seqno](const SeqnoTimePair& p) { return p.seqno <= seqno; });
 }
 
 uint64_t SeqnoToTimeMapping::GetProximalTimeBeforeSeqno(
@@ -151,9 +209,10 @@ void SeqnoToTimeMapping::Encode(std::string& dest, const SequenceNumber start,
   // evenly distributed for time. Anyway the following algorithm is simple and
   // may over-select new data, which is good. We do want more accurate time
   // information for recent data.
-  std::deque<SeqnoTimePair> output_copy;
+  std::vector<SeqnoTimePair> output_copy;
   if (std::distance(start_it, end_it) > static_cast<int64_t>(output_size)) {
     int64_t num_entries_to_fill = static_cast<int64_t>(output_size);
+    output_copy.reserve(output_size);
     auto last_it = end_it;
     last_it--;
     uint64_t end_time = last_it->time;
@@ -260,7 +319,7 @@ bool SeqnoToTimeMapping::Append(SequenceNumber seqno, uint64_t time) {
   if (pairs_.size() > max_capacity_) {
     // FIXME: be smarter about how we erase to avoid data falling off the
     // front prematurely.
-    pairs_.pop_front();
+    pairs_.erase(pairs_.begin());
   }
   return true;
 }
@@ -309,30 +368,35 @@ Status SeqnoToTimeMapping::Sort() {
     return Status::OK();
   }
 
-  std::deque<SeqnoTimePair> copy = std::move(pairs_);
+  std::vector<SeqnoTimePair> copy = std::move(pairs_);
 
   std::sort(copy.begin(), copy.end());
 
   pairs_.clear();
 
   // remove seqno = 0, which may have special meaning, like zeroed out data
-  while (copy.front().seqno == 0) {
-    copy.pop_front();
+  auto first = copy.cbegin();
+  while (first != copy.cend() && first->seqno == 0) {
+    ++first;
+  }
+  if (first == copy.cend()) {
+    is_sorted_ = true;
+    return Status::OK();
   }
 
-  SeqnoTimePair prev = copy.front();
-  for (const auto& it : copy) {
+  SeqnoTimePair prev = *first;
+  for (auto it = first; it != copy.cend(); ++it) {
     // If sequence number is the same, pick the one with larger time, which is
     // more accurate than the older time.
-    if (it.seqno == prev.seqno) {
-      assert(it.time >= prev.time);
-      prev.time = it.time;
+    if (it->seqno == prev.seqno) {
+      assert(it->time >= prev.time);
+      prev.time = it->time;
     } else {
-      assert(it.seqno > prev.seqno);
+      assert(it->seqno > prev.seqno);
       // If a larger sequence number has an older time which is not useful, skip
-      if (it.time > prev.time) {
+      if (it->time > prev.time) {
         pairs_.push_back(prev);
-        prev = it;
+        prev = *it;
       }
     }
   }
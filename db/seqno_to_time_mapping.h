@@ -8,10 +8,10 @@
 
 #include <algorithm>
 #include <cinttypes>
-#include <deque>
 #include <functional>
 #include <iterator>
 #include <string>
+#include <vector>
 
 #include "rocksdb/status.h"
 #include "rocksdb/types.h"
@@ -43,6 +43,10 @@ constexpr SequenceNumber kUnknownSeqnoBeforeAll = 0;
 // with a bounded number of entries, but some public working states violate
 // these constraints.
 //
+// The pairs are kept in a vector, and lookups in the sorted list start at the
+// position interpolated from the first and last pairs, which is at or next to
+// the answer when the samples are spread evenly, as with periodic sampling.
+//
 // NOT thread safe - requires external synchronization.
 class SeqnoToTimeMapping {
  public:
@@ -192,7 +196,7 @@ class SeqnoToTimeMapping {
   std::string ToHumanString() const;
 
 #ifndef NDEBUG
-  const std::deque<SeqnoTimePair>& TEST_GetInternalMapping() const {
+  const std::vector<SeqnoTimePair>& TEST_GetInternalMapping() const {
     return pairs_;
   }
 #endif
@@ -204,7 +208,7 @@ class SeqnoToTimeMapping {
   uint64_t max_time_duration_;
   uint64_t max_capacity_;
 
-  std::deque<SeqnoTimePair> pairs_;
+  std::vector<SeqnoTimePair> pairs_;
 
   bool is_sorted_ = true;
 
@@ -217,7 +221,7 @@ class SeqnoToTimeMapping {
   }
 
   using pair_const_iterator =
-      std::deque<SeqnoToTimeMapping::SeqnoTimePair>::const_iterator;
+      std::vector<SeqnoToTimeMapping::SeqnoTimePair>::const_iterator;
   pair_const_iterator FindGreaterTime(uint64_t time) const;
   pair_const_iterator FindGreaterSeqno(SequenceNumber seqno) const;
   pair_const_iterator FindGreaterEqSeqno(SequenceNumber seqno) const;
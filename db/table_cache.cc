@@ -9,6 +9,7 @@
 
 #include "db/table_cache.h"
 
+#include "cache/cache_key.h"
 #include "db/dbformat.h"
 #include "db/range_tombstone_fragmenter.h"
 #include "db/snapshot_impl.h"
@@ -29,6 +30,7 @@
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 #include "util/coding.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 
 // Generate the regular and coroutine versions of some methods by
@@ -48,10 +50,17 @@ namespace ROCKSDB_NAMESPACE {
 
 namespace {
 
-static Slice GetSliceForFileNumber(const uint64_t* file_number) {
-  return Slice(reinterpret_cast<const char*>(file_number),
-               sizeof(*file_number));
-}
+// Keys are padded to the fixed key size of HyperClockCache, see
+// DBOptions::lock_free_table_cache
+struct TableCacheKey {
+  explicit TableCacheKey(uint64_t file_number) {
+    EncodeFixed64(data, file_number);
+    EncodeFixed64(data + sizeof(file_number), 0);
+  }
+  Slice AsSlice() const { return Slice(data, sizeof(data)); }
+
+  char data[kCacheKeySize];
+};
 
 
 void AppendVarint64(IterKey* key, uint64_t v) {
@@ -78,7 +87,7 @@ TableCache::TableCache(const ImmutableOptions& ioptions,
       loader_mutex_(kLoadConcurency),
       io_tracer_(io_tracer),
       db_session_id_(db_session_id) {
-  if (ioptions_.row_cache) {
+  if (ioptions_.row_cache && !ioptions_.row_cache_by_user_key) {
     // If the same cache is shared by multiple instances, we need to
     // disambiguate its entries.
     PutVarint64(&row_cache_id_, ioptions_.row_cache->NewId());
@@ -128,6 +137,10 @@ Status TableCache::GetTableReader(
   if (s.ok()) {
     if (!sequential_mode && ioptions_.advise_random_on_open) {
       file->Hint(FSRandomAccessFile::kRandom);
+    } else if (sequential_mode && ioptions_.allow_mmap_reads) {
+      // A mapping of its own is read by page faults, which the kernel reads
+      // ahead of for sequential access
+      file->Hint(FSRandomAccessFile::kSequential);
     }
     if (ioptions_.default_temperature != Temperature::kUnknown &&
         file_temperature == Temperature::kUnknown) {
@@ -146,18 +159,22 @@ Status TableCache::GetTableReader(
     } else {
       expected_unique_id = kNullUniqueId64x2;  // null ID == no verification
     }
+    TableReaderOptions reader_options(
+        ioptions_, prefix_extractor, file_options, internal_comparator,
+        block_protection_bytes_per_key, skip_filters, immortal_tables_,
+        false /* force_direct_prefetch */, level, block_cache_tracer_,
+        max_file_size_for_l0_meta_pin, db_session_id_, file_meta.fd.GetNumber(),
+        expected_unique_id, file_meta.fd.largest_seqno, file_meta.tail_size,
+        file_meta.user_defined_timestamps_persisted);
+    if (level >= 0 && level < block_fetch_hists_levels_) {
+      reader_options.block_fetch_hists = &block_fetch_hists_[level];
+    }
+    if (level >= 0 && level < block_cache_heat_maps_levels_) {
+      reader_options.block_cache_heat_map = &block_cache_heat_maps_[level];
+    }
     s = ioptions_.table_factory->NewTableReader(
-        ro,
-        TableReaderOptions(
-            ioptions_, prefix_extractor, file_options, internal_comparator,
-            block_protection_bytes_per_key, skip_filters, immortal_tables_,
-            false /* force_direct_prefetch */, level, block_cache_tracer_,
-            max_file_size_for_l0_meta_pin, db_session_id_,
-            file_meta.fd.GetNumber(), expected_unique_id,
-            file_meta.fd.largest_seqno, file_meta.tail_size,
-            file_meta.user_defined_timestamps_persisted),
-        std::move(file_reader), file_meta.fd.GetFileSize(), table_reader,
-        prefetch_index_and_filter_in_cache);
+        ro, reader_options, std::move(file_reader), file_meta.fd.GetFileSize(),
+        table_reader, prefetch_index_and_filter_in_cache);
     TEST_SYNC_POINT("TableCache::GetTableReader:0");
   }
   return s;
@@ -173,8 +190,8 @@ Status TableCache::FindTable(
     int level, bool prefetch_index_and_filter_in_cache,
     size_t max_file_size_for_l0_meta_pin, Temperature file_temperature) {
   PERF_TIMER_GUARD_WITH_CLOCK(find_table_nanos, ioptions_.clock);
-  uint64_t number = file_meta.fd.GetNumber();
-  Slice key = GetSliceForFileNumber(&number);
+  TableCacheKey cache_key(file_meta.fd.GetNumber());
+  Slice key = cache_key.AsSlice();
   *handle = cache_.Lookup(key);
   TEST_SYNC_POINT_CALLBACK("TableCache::FindTable:0",
                            const_cast<bool*>(&no_io));
@@ -440,7 +457,7 @@ Status TableCache::Get(
 
   // Check row cache if enabled.
   // Reuse row_cache_key sequence number when row cache hits.
-  if (ioptions_.row_cache && !get_context->NeedToReadSequence()) {
+  if (!row_cache_id_.empty() && !get_context->NeedToReadSequence()) {
     auto user_key = ExtractUserKey(k);
     uint64_t cache_entry_seq_no =
         CreateRowCacheKeyPrefix(options, fd, k, get_context, row_cache_key);
@@ -551,9 +568,11 @@ Status TableCache::MultiGetFilter(
 
   // Check if we need to use the row cache. If yes, then we cannot do the
   // filtering here, since the filtering needs to happen after the row cache
-  // lookup.
+  // lookup. Without a GetContext, only the filter is checked, see
+  // Version::KeysMayExist().
   KeyContext& first_key = *mget_range->begin();
-  if (ioptions_.row_cache && !first_key.get_context->NeedToReadSequence()) {
+  if (!row_cache_id_.empty() && first_key.get_context != nullptr &&
+      !first_key.get_context->NeedToReadSequence()) {
     return Status::NotSupported();
   }
   Status s;
@@ -591,6 +610,53 @@ Status TableCache::MultiGetFilter(
   return s;
 }
 
+void TableCache::PrefetchForMultiGet(
+    const ReadOptions& options,
+    const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, const MultiGetContext::Range* mget_range,
+    uint8_t block_protection_bytes_per_key) {
+  TableReader* t = file_meta.fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    Status s = FindTable(options, file_options_, internal_comparator, file_meta,
+                         &handle, block_protection_bytes_per_key,
+                         /*prefix_extractor=*/nullptr, /*no_io=*/true);
+    if (!s.ok()) {
+      // Not open yet, which MultiGet() then does
+      s.PermitUncheckedError();
+      return;
+    }
+    t = cache_.Value(handle);
+  }
+  t->PrefetchForMultiGet(options, mget_range);
+  if (handle) {
+    cache_.Release(handle);
+  }
+}
+
+void TableCache::PrefetchScanRanges(
+    const ReadOptions& options,
+    const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, const std::vector<Range>& ranges,
+    uint8_t block_protection_bytes_per_key) {
+  TableReader* t = file_meta.fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    Status s = FindTable(options, file_options_, internal_comparator, file_meta,
+                         &handle, block_protection_bytes_per_key);
+    if (!s.ok()) {
+      // Left to the scans
+      s.PermitUncheckedError();
+      return;
+    }
+    t = cache_.Value(handle);
+  }
+  t->PrefetchScanRanges(options, ranges);
+  if (handle) {
+    cache_.Release(handle);
+  }
+}
+
 Status TableCache::GetTableProperties(
     const FileOptions& file_options, const ReadOptions& read_options,
     const InternalKeyComparator& internal_comparator,
@@ -643,6 +709,30 @@ Status TableCache::ApproximateKeyAnchors(
   return s;
 }
 
+Status TableCache::PrefetchDataBlocks(
+    const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, uint8_t block_protection_bytes_per_key,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor,
+    const std::vector<uint64_t>& block_offsets) {
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, file_meta, &handle,
+                  block_protection_bytes_per_key, prefix_extractor);
+    if (s.ok()) {
+      t = cache_.Value(handle);
+    }
+  }
+  if (s.ok() && t != nullptr) {
+    s = t->PrefetchDataBlocks(ro, block_offsets);
+  }
+  if (handle != nullptr) {
+    cache_.Release(handle);
+  }
+  return s;
+}
+
 size_t TableCache::GetMemoryUsageByTableReader(
     const FileOptions& file_options, const ReadOptions& read_options,
     const InternalKeyComparator& internal_comparator,
@@ -668,8 +758,110 @@ size_t TableCache::GetMemoryUsageByTableReader(
   return ret;
 }
 
+TableCache::OpenAhead::OpenAhead(TableCache* table_cache)
+    : table_cache_(table_cache), cv_(&mutex_) {}
+
+TableCache::OpenAhead::~OpenAhead() {
+  // Calls Unschedule() if the open has not started yet
+  table_cache_->ioptions_.env->UnSchedule(this, Env::Priority::LOW);
+  MutexLock l(&mutex_);
+  while (in_progress_) {
+    cv_.Wait();
+  }
+}
+
+void TableCache::OpenAhead::Start(
+    const ReadOptions& ro, const FileOptions& file_options,
+    const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, uint8_t block_protection_bytes_per_key,
+    const std::shared_ptr<const SliceTransform>& prefix_extractor,
+    HistogramImpl* file_read_hist, bool skip_filters, int level) {
+  // Whether the first data blocks of the file are to be loaded as well
+  const bool prefetch =
+      table_cache_->ioptions_.table_cache_open_ahead_prefetch_size > 0 &&
+      ro.fill_cache;
+  if (file_meta.fd.table_reader != nullptr && !prefetch) {
+    return;
+  }
+  {
+    MutexLock l(&mutex_);
+    if (in_progress_) {
+      return;
+    }
+  }
+  if (!prefetch) {
+    TableCacheKey key(file_meta.fd.GetNumber());
+    TypedHandle* handle = table_cache_->cache_.Lookup(key.AsSlice());
+    if (handle != nullptr) {
+      table_cache_->cache_.Release(handle);
+      return;
+    }
+  }
+
+  ro_ = &ro;
+  file_options_ = &file_options;
+  internal_comparator_ = &internal_comparator;
+  file_meta_ = &file_meta;
+  block_protection_bytes_per_key_ = block_protection_bytes_per_key;
+  prefix_extractor_ = &prefix_extractor;
+  file_read_hist_ = file_read_hist;
+  skip_filters_ = skip_filters;
+  level_ = level;
+  {
+    MutexLock l(&mutex_);
+    in_progress_ = true;
+  }
+  table_cache_->ioptions_.env->Schedule(&OpenAhead::BGWork, this,
+                                        Env::Priority::LOW, this,
+                                        &OpenAhead::Unschedule);
+}
+
+void TableCache::OpenAhead::BGWork(void* arg) {
+  auto* open_ahead = static_cast<OpenAhead*>(arg);
+  TableCache* table_cache = open_ahead->table_cache_;
+  const size_t prefetch_size =
+      open_ahead->ro_->fill_cache
+          ? table_cache->ioptions_.table_cache_open_ahead_prefetch_size
+          : 0;
+  TypedHandle* handle = nullptr;
+  TableReader* t = open_ahead->file_meta_->fd.table_reader;
+  Status s;
+  if (t == nullptr) {
+    s = table_cache->FindTable(
+        *open_ahead->ro_, *open_ahead->file_options_,
+        *open_ahead->internal_comparator_, *open_ahead->file_meta_, &handle,
+        open_ahead->block_protection_bytes_per_key_,
+        *open_ahead->prefix_extractor_, /*no_io=*/false,
+        open_ahead->file_read_hist_, open_ahead->skip_filters_,
+        open_ahead->level_);
+    if (s.ok()) {
+      t = table_cache->cache_.Value(handle);
+    }
+  }
+  if (s.ok() && prefetch_size > 0) {
+    s = t->PrefetchFirstDataBlocks(*open_ahead->ro_, prefetch_size);
+  }
+  if (handle != nullptr) {
+    table_cache->cache_.Release(handle);
+  }
+  // Errors surface again when the table is used
+  s.PermitUncheckedError();
+  TEST_SYNC_POINT("TableCache::OpenAhead::BGWork:Done");
+  open_ahead->Finish();
+}
+
+void TableCache::OpenAhead::Unschedule(void* arg) {
+  static_cast<OpenAhead*>(arg)->Finish();
+}
+
+void TableCache::OpenAhead::Finish() {
+  MutexLock l(&mutex_);
+  in_progress_ = false;
+  cv_.SignalAll();
+}
+
 void TableCache::Evict(Cache* cache, uint64_t file_number) {
-  cache->Erase(GetSliceForFileNumber(&file_number));
+  cache->Erase(TableCacheKey(file_number).AsSlice());
 }
 
 uint64_t TableCache::ApproximateOffsetOf(
@@ -23,6 +23,8 @@
 #include "rocksdb/env.h"
 #include "rocksdb/options.h"
 #include "rocksdb/table.h"
+#include "table/block_cache_heat_map.h"
+#include "table/block_fetch_histograms.h"
 #include "table/table_reader.h"
 #include "trace_replay/block_cache_tracer.h"
 #include "util/coro_utils.h"
@@ -143,6 +145,22 @@ class TableCache {
       MultiGetContext::Range* mget_range, TypedHandle** table_handle,
       uint8_t block_protection_bytes_per_key);
 
+  // Calls the table reader's PrefetchForMultiGet() if the table is already
+  // open, see TableReader::PrefetchForMultiGet().
+  void PrefetchForMultiGet(const ReadOptions& options,
+                           const InternalKeyComparator& internal_comparator,
+                           const FileMetaData& file_meta,
+                           const MultiGetContext::Range* mget_range,
+                           uint8_t block_protection_bytes_per_key);
+
+  // Opens the table if needed and calls its PrefetchScanRanges(), see
+  // TableReader::PrefetchScanRanges().
+  void PrefetchScanRanges(const ReadOptions& options,
+                          const InternalKeyComparator& internal_comparator,
+                          const FileMetaData& file_meta,
+                          const std::vector<Range>& ranges,
+                          uint8_t block_protection_bytes_per_key);
+
   // If a seek to internal key "k" in specified file finds an entry,
   // call get_context->SaveValue() repeatedly until
   // it returns false. As a side effect, it will insert the TableReader
@@ -201,6 +219,56 @@ class TableCache {
                                uint8_t block_protection_bytes_per_key,
                                std::vector<TableReader::Anchor>& anchors);
 
+  // Opens the table of the file, and loads the data blocks at
+  // `block_offsets` into the block cache. See
+  // TableReader::PrefetchDataBlocks().
+  Status PrefetchDataBlocks(
+      const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+      const FileMetaData& file_meta, uint8_t block_protection_bytes_per_key,
+      const std::shared_ptr<const SliceTransform>& prefix_extractor,
+      const std::vector<uint64_t>& block_offsets);
+
+  // Opens tables in the background ahead of their use, one at a time, see
+  // DBOptions::table_cache_open_ahead. Destroying it cancels or waits for the
+  // open in progress, so it must not outlive the arguments of Start().
+  class OpenAhead {
+   public:
+    explicit OpenAhead(TableCache* table_cache);
+    ~OpenAhead();
+
+    // Opens the table of `file_meta` into the table cache with Env::LOW
+    // priority, unless it is there already or another open is in progress.
+    // With DBOptions::table_cache_open_ahead_prefetch_size, also loads the
+    // first data blocks of the table into the block cache.
+    void Start(const ReadOptions& ro, const FileOptions& file_options,
+               const InternalKeyComparator& internal_comparator,
+               const FileMetaData& file_meta,
+               uint8_t block_protection_bytes_per_key,
+               const std::shared_ptr<const SliceTransform>& prefix_extractor,
+               HistogramImpl* file_read_hist, bool skip_filters, int level);
+
+   private:
+    static void BGWork(void* arg);
+    static void Unschedule(void* arg);
+    void Finish();
+
+    TableCache* const table_cache_;
+    const ReadOptions* ro_ = nullptr;
+    const FileOptions* file_options_ = nullptr;
+    const InternalKeyComparator* internal_comparator_ = nullptr;
+    const FileMetaData* file_meta_ = nullptr;
+    uint8_t block_protection_bytes_per_key_ = 0;
+    const std::shared_ptr<const SliceTransform>* prefix_extractor_ = nullptr;
+    HistogramImpl* file_read_hist_ = nullptr;
+    bool skip_filters_ = false;
+    int level_ = -1;
+
+    port::Mutex mutex_;
+    port::CondVar cv_;
+    // Whether an open is scheduled or running. Protected by mutex_.
+    bool in_progress_ = false;
+  };
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
@@ -228,6 +296,12 @@ class TableCache {
 
   CacheInterface& get_cache() { return cache_; }
 
+  // See DBOptions::table_cache_open_ahead
+  bool open_ahead() const { return ioptions_.table_cache_open_ahead; }
+  double open_ahead_fraction() const {
+    return ioptions_.table_cache_open_ahead_fraction;
+  }
+
   // Capacity of the backing Cache that indicates infinite TableCache capacity.
   // For example when max_open_files is -1 we set the backing Cache to this.
   static const int kInfiniteCapacity = 0x400000;
@@ -240,6 +314,22 @@ class TableCache {
     }
   }
 
+  // The tables opened from now on record the latency of their block fetches
+  // in block_fetch_hists[level], for levels below num_levels
+  void SetBlockFetchHistograms(BlockFetchHistograms* block_fetch_hists,
+                               int num_levels) {
+    block_fetch_hists_ = block_fetch_hists;
+    block_fetch_hists_levels_ = num_levels;
+  }
+
+  // The tables opened from now on sample their block cache lookups in
+  // block_cache_heat_maps[level], for levels below num_levels
+  void SetBlockCacheHeatMaps(BlockCacheHeatMap* block_cache_heat_maps,
+                             int num_levels) {
+    block_cache_heat_maps_ = block_cache_heat_maps;
+    block_cache_heat_maps_levels_ = num_levels;
+  }
+
  private:
   // Build a table reader
   Status GetTableReader(
@@ -284,6 +374,10 @@ class TableCache {
   Striped<CacheAlignedWrapper<port::Mutex>> loader_mutex_;
   std::shared_ptr<IOTracer> io_tracer_;
   std::string db_session_id_;
+  BlockFetchHistograms* block_fetch_hists_ = nullptr;
+  int block_fetch_hists_levels_ = 0;
+  BlockCacheHeatMap* block_cache_heat_maps_ = nullptr;
+  int block_cache_heat_maps_levels_ = 0;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
\ No newline at end of file
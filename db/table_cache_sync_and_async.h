@@ -34,7 +34,7 @@ DEFINE_SYNC_AND_ASYNC(Status, TableCache::MultiGet)
   size_t row_cache_key_prefix_size = 0;
   KeyContext& first_key = *table_range.begin();
   bool lookup_row_cache =
-      ioptions_.row_cache && !first_key.get_context->NeedToReadSequence();
+      !row_cache_id_.empty() && !first_key.get_context->NeedToReadSequence();
 
   // Check row cache if enabled. Since row cache does not currently store
   // sequence numbers, we cannot use it if we need to fetch the sequence.
@@ -49,6 +49,11 @@ void UserKeyTablePropertiesCollector::BlockAdd(
                               block_compressed_bytes_slow);
 }
 
+void UserKeyTablePropertiesCollector::FinishDataBlock(
+    std::string* block_property) {
+  collector_->FinishDataBlock(block_property);
+}
+
 Status UserKeyTablePropertiesCollector::Finish(
     UserCollectedProperties* properties) {
   return collector_->Finish(properties);
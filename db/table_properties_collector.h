@@ -33,6 +33,9 @@ class IntTblPropCollector {
                         uint64_t block_compressed_bytes_fast,
                         uint64_t block_compressed_bytes_slow) = 0;
 
+  // See TablePropertiesCollector::FinishDataBlock()
+  virtual void FinishDataBlock(std::string* /*block_property*/) {}
+
   virtual UserCollectedProperties GetReadableProperties() const = 0;
 
   virtual bool NeedCompact() const { return false; }
@@ -73,6 +76,8 @@ class UserKeyTablePropertiesCollector : public IntTblPropCollector {
                         uint64_t block_compressed_bytes_fast,
                         uint64_t block_compressed_bytes_slow) override;
 
+  virtual void FinishDataBlock(std::string* block_property) override;
+
   virtual Status Finish(UserCollectedProperties* properties) override;
 
   virtual const char* Name() const override { return collector_->Name(); }
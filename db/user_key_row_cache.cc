@@ -0,0 +1,70 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/user_key_row_cache.h"
+
+#include "db/version_set.h"
+#include "monitoring/statistics_impl.h"
+#include "rocksdb/statistics.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+UserKeyRowCache::UserKeyRowCache(RowCache* cache)
+    : cache_(cache), id_(cache->NewId()) {}
+
+void UserKeyRowCache::EncodeKey(const Slice& user_key,
+                                std::string* key) const {
+  key->reserve(kMaxVarint64Length + user_key.size());
+  PutVarint64(key, id_);
+  key->append(user_key.data(), user_key.size());
+}
+
+bool UserKeyRowCache::Lookup(const Slice& user_key, SequenceNumber snapshot,
+                             const Version* version, PinnableSlice* value,
+                             Statistics* stats) {
+  std::string key;
+  EncodeKey(user_key, &key);
+  auto handle = cache_.Lookup(key);
+  if (handle != nullptr) {
+    // An entry is the epoch and the sequence number it is valid from, then
+    // the value
+    Slice entry(*cache_.Value(handle));
+    uint64_t epoch = 0;
+    uint64_t seq = 0;
+    if (GetVarint64(&entry, &epoch) && GetVarint64(&entry, &seq) &&
+        epoch == version->GetCachedRowsEpoch() && seq <= snapshot &&
+        !version->MayHaveNewerEntries(user_key, seq)) {
+      RecordTick(stats, ROW_CACHE_HIT);
+      Cleanable release;
+      cache_.RegisterReleaseAsCleanup(handle, release);
+      value->Reset();
+      value->PinSlice(entry, &release);
+      return true;
+    }
+    cache_.Release(handle);
+  }
+  RecordTick(stats, ROW_CACHE_MISS);
+  return false;
+}
+
+void UserKeyRowCache::Insert(const Slice& user_key, SequenceNumber seq,
+                             const Version* version, const Slice& value) {
+  std::string key;
+  EncodeKey(user_key, &key);
+  auto entry = std::make_unique<std::string>();
+  entry->reserve(2 * kMaxVarint64Length + value.size());
+  PutVarint64(entry.get(), version->GetCachedRowsEpoch());
+  PutVarint64(entry.get(), seq);
+  entry->append(value.data(), value.size());
+  const size_t charge = sizeof(std::string) + entry->capacity();
+  // Failing to insert, when the cache is full with a strict capacity limit,
+  // is not a reason to fail the read
+  if (cache_.Insert(key, entry.get(), charge).ok()) {
+    entry.release();
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,66 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+
+#include "cache/typed_cache.h"
+#include "db/dbformat.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class PinnableSlice;
+class Statistics;
+class Version;
+
+// Caches in the row cache the values that reads found in the table files of
+// a column family, for DBOptions::row_cache_by_user_key, keyed by user key
+// rather than by table file. Each value is cached with a sequence number
+// such that every entry of the key that the read did not see, in any table
+// file or memtable, is newer. It stays valid as long as no table file that
+// may have entries newer than that includes the key: compactions rewrite
+// the entries of the key without adding newer ones, and a flush of a newer
+// entry adds a file with a larger sequence number. The version edits which
+// remove the entries of keys or add older ones start a new epoch of cached
+// values, see Version::GetCachedRowsEpoch().
+//
+// Thread-safe.
+class UserKeyRowCache {
+ public:
+  explicit UserKeyRowCache(RowCache* cache);
+
+  UserKeyRowCache(const UserKeyRowCache&) = delete;
+  UserKeyRowCache& operator=(const UserKeyRowCache&) = delete;
+
+  // Pins the value of `user_key` in the table files of `version` to `value`
+  // and returns true if it is cached and visible at `snapshot`. Only for the
+  // reads which did not find the key in the memtables. Records the
+  // ROW_CACHE_HIT or ROW_CACHE_MISS ticker.
+  bool Lookup(const Slice& user_key, SequenceNumber snapshot,
+              const Version* version, PinnableSlice* value,
+              Statistics* stats);
+
+  // Caches `value` for `user_key`, which a read found in the table files of
+  // `version` after not finding the key in the memtables. `seq` is the
+  // smaller of the read's snapshot and the earliest sequence number of the
+  // mutable memtable the read looked into.
+  void Insert(const Slice& user_key, SequenceNumber seq,
+              const Version* version, const Slice& value);
+
+ private:
+  using CacheInterface =
+      BasicTypedCacheInterface<std::string, CacheEntryRole::kMisc>;
+
+  void EncodeKey(const Slice& user_key, std::string* key) const;
+
+  CacheInterface cache_;
+  // Disambiguates the entries of this column family in a shared cache
+  const uint64_t id_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -245,6 +245,9 @@ class VersionBuilder::Rep {
   // Whether there are invalid new files or invalid deletion on levels larger
   // than num_levels_.
   bool has_invalid_levels_;
+  // Whether the base version passed the consistency checks in Apply(). It
+  // does not change while the builder applies edits, so it is checked once.
+  bool base_consistency_checked_;
   // Current levels of table files affected by additions/deletions.
   std::unordered_map<uint64_t, int> table_file_levels_;
   // Current compact cursors that should be changed after the last compaction
@@ -271,6 +274,7 @@ class VersionBuilder::Rep {
         version_set_(version_set),
         num_levels_(base_vstorage->num_levels()),
         has_invalid_levels_(false),
+        base_consistency_checked_(false),
         level_nonzero_cmp_(base_vstorage_->InternalComparator()),
         file_metadata_cache_res_mgr_(file_metadata_cache_res_mgr) {
     assert(ioptions_);
@@ -328,6 +332,15 @@ class VersionBuilder::Rep {
     (*expected_linked_ssts)[blob_file_number].emplace(table_file_number);
   }
 
+  // Whether the edits applied so far add or delete table files on the level.
+  // A level that they do not change has the files of the base version in the
+  // same order.
+  bool IsLevelChanged(int level) const {
+    assert(level >= 0 && level < num_levels_);
+    return !levels_[level].added_files.empty() ||
+           !levels_[level].deleted_files.empty();
+  }
+
   template <typename Checker>
   Status CheckConsistencyDetailsForLevel(
       const VersionStorageInfo* vstorage, int level, Checker checker,
@@ -352,6 +365,22 @@ class VersionBuilder::Rep {
                              level_files[0]->oldest_blob_file_number,
                              expected_linked_ssts);
 
+#ifdef NDEBUG
+    // The order of a level not changed by the edits was checked when the base
+    // version was saved, so only the links to blob files are collected.
+    if (vstorage != base_vstorage_ && !IsLevelChanged(level) &&
+        (level > 0 || vstorage->GetEpochNumberRequirement() ==
+                          base_vstorage_->GetEpochNumberRequirement())) {
+      for (size_t i = 1; i < level_files.size(); ++i) {
+        assert(level_files[i]);
+        UpdateExpectedLinkedSsts(level_files[i]->fd.GetNumber(),
+                                 level_files[i]->oldest_blob_file_number,
+                                 expected_linked_ssts);
+      }
+      return Status::OK();
+    }
+#endif  // NDEBUG
+
     for (size_t i = 1; i < level_files.size(); ++i) {
       assert(level_files[i]);
       UpdateExpectedLinkedSsts(level_files[i]->fd.GetNumber(),
@@ -792,6 +821,16 @@ class VersionBuilder::Rep {
     FileMetaData* const f = new FileMetaData(meta);
     f->refs = 1;
 
+    // A file moved to another level, which is added back as a new file, keeps
+    // what is not persisted
+    if (f->largest_input_seqno == 0) {
+      const FileMetaData* const base_f =
+          base_vstorage_->GetFileMetaDataByNumber(file_number);
+      if (base_f != nullptr) {
+        f->largest_input_seqno = base_f->largest_input_seqno;
+      }
+    }
+
     if (file_metadata_cache_res_mgr_) {
       Status s = file_metadata_cache_res_mgr_->UpdateCacheReservation(
           f->ApproximateMemoryUsage(), true /* increase */);
@@ -845,11 +884,12 @@ class VersionBuilder::Rep {
 
   // Apply all of the edits in *edit to the current state.
   Status Apply(const VersionEdit* edit) {
-    {
+    if (!base_consistency_checked_) {
       const Status s = CheckConsistency(base_vstorage_);
       if (!s.ok()) {
         return s;
       }
+      base_consistency_checked_ = true;
     }
 
     // Note: we process the blob file related changes first because the
@@ -1150,6 +1190,15 @@ class VersionBuilder::Rep {
     const auto& unordered_added_files = levels_[level].added_files;
     vstorage->Reserve(level, base_files.size() + unordered_added_files.size());
 
+    // Most edits change one or two levels, and the files of the others are
+    // taken from the base version as they are.
+    if (!IsLevelChanged(level)) {
+      for (FileMetaData* f : base_files) {
+        vstorage->AddFile(level, f);
+      }
+      return;
+    }
+
     // Sort added files for the level.
     std::vector<FileMetaData*> added_files;
     added_files.reserve(unordered_added_files.size());
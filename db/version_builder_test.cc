@@ -216,6 +216,54 @@ TEST_F(VersionBuilderTest, ApplyAndSaveTo) {
   UnrefFilesInVersion(&new_vstorage);
 }
 
+TEST_F(VersionBuilderTest, ApplyAndSaveToUnchangedLevels) {
+  Add(1, 66U, "150", "200", 100U);
+  Add(1, 88U, "201", "300", 100U);
+
+  Add(2, 6U, "150", "179", 100U);
+  Add(2, 7U, "180", "220", 100U);
+
+  Add(3, 26U, "150", "170", 100U);
+  Add(3, 27U, "171", "179", 100U);
+
+  UpdateVersionStorageInfo();
+
+  VersionEdit version_edit;
+  version_edit.DeleteFile(2, 7U);
+
+  EnvOptions env_options;
+  constexpr TableCache* table_cache = nullptr;
+  constexpr VersionSet* version_set = nullptr;
+
+  VersionBuilder version_builder(env_options, &ioptions_, table_cache,
+                                 &vstorage_, version_set);
+
+  VersionStorageInfo new_vstorage(
+      &icmp_, ucmp_, options_.num_levels, kCompactionStyleLevel, nullptr, false,
+      EpochNumberRequirement::kMightMissing, nullptr, 0,
+      OffpeakTimeOption(options_.daily_offpeak_time_utc));
+  ASSERT_OK(version_builder.Apply(&version_edit));
+  ASSERT_OK(version_builder.SaveTo(&new_vstorage));
+
+  UpdateVersionStorageInfo(&new_vstorage);
+
+  // The levels the edit does not change hold the files of the base version,
+  // referenced by both versions
+  for (int level : {1, 3}) {
+    ASSERT_EQ(vstorage_.LevelFiles(level), new_vstorage.LevelFiles(level));
+    for (const FileMetaData* f : new_vstorage.LevelFiles(level)) {
+      ASSERT_EQ(2, f->refs);
+    }
+  }
+
+  const auto& l2_files = new_vstorage.LevelFiles(2);
+  ASSERT_EQ(1U, l2_files.size());
+  ASSERT_EQ(6U, l2_files[0]->fd.GetNumber());
+  ASSERT_EQ(100U, new_vstorage.NumLevelBytes(2));
+
+  UnrefFilesInVersion(&new_vstorage);
+}
+
 TEST_F(VersionBuilderTest, ApplyAndSaveToDynamic) {
   ioptions_.level_compaction_dynamic_level_bytes = true;
 
@@ -90,6 +90,7 @@ void VersionEdit::Clear() {
   column_family_name_.clear();
   is_in_atomic_group_ = false;
   remaining_entries_ = 0;
+  invalidates_cached_rows_ = false;
   full_history_ts_low_.clear();
 }
 
@@ -258,6 +258,12 @@ struct FileMetaData {
   // false, it's explicitly written to Manifest.
   bool user_defined_timestamps_persisted = true;
 
+  // Not persisted. For compaction output files, the largest sequence number
+  // of the entries of the input files, which may have been dropped or had
+  // their sequence numbers zeroed out, if larger than fd.largest_seqno. 0
+  // otherwise. See LargestSeqnoOfInputs().
+  SequenceNumber largest_input_seqno = 0;
+
   FileMetaData() = default;
 
   FileMetaData(uint64_t file, uint32_t file_path_id, uint64_t file_size,
@@ -289,6 +295,12 @@ struct FileMetaData {
     TEST_SYNC_POINT_CALLBACK("FileMetaData::FileMetaData", this);
   }
 
+  // The largest sequence number of the entries this file has, or had before
+  // they were compacted into it
+  SequenceNumber LargestSeqnoOfInputs() const {
+    return std::max(fd.largest_seqno, largest_input_seqno);
+  }
+
   // REQUIRED: Keys must be given to the function in sorted order (it expects
   // the last key to be the largest).
   Status UpdateBoundaries(const Slice& key, const Slice& value,
@@ -377,9 +389,15 @@ struct FdWithKeyRange {
 struct LevelFilesBrief {
   size_t num_files;
   FdWithKeyRange* files;
+  // If not null, the first 8 bytes of the largest user key of each file as a
+  // big-endian number (zero padded), so that most files of a level can be
+  // ruled out by comparing packed integers instead of keys. Only set for the
+  // bytewise comparator without timestamps.
+  uint64_t* largest_key_prefixes;
   LevelFilesBrief() {
     num_files = 0;
     files = nullptr;
+    largest_key_prefixes = nullptr;
   }
 };
 
@@ -665,6 +683,13 @@ class VersionEdit {
   }
   uint32_t GetRemainingEntries() const { return remaining_entries_; }
 
+  // Not persisted. Marks an edit which removes entries of keys without
+  // newer entries of the keys taking their place, or adds older entries, so
+  // that the values cached by user key may no longer be what the keys read.
+  // See Version::GetCachedRowsEpoch().
+  void MarkInvalidatesCachedRows() { invalidates_cached_rows_ = true; }
+  bool InvalidatesCachedRows() const { return invalidates_cached_rows_; }
+
   bool HasFullHistoryTsLow() const { return !full_history_ts_low_.empty(); }
   const std::string& GetFullHistoryTsLow() const {
     assert(HasFullHistoryTsLow());
@@ -752,6 +777,8 @@ class VersionEdit {
   bool is_in_atomic_group_ = false;
   uint32_t remaining_entries_ = 0;
 
+  bool invalidates_cached_rows_ = false;
+
   std::string full_history_ts_low_;
   bool persist_user_defined_timestamps_ = true;
 
@@ -10,6 +10,7 @@
 #include "db/version_edit_handler.h"
 
 #include <cinttypes>
+#include <deque>
 #include <sstream>
 
 #include "db/blob/blob_file_reader.h"
@@ -17,6 +18,8 @@
 #include "db/version_edit.h"
 #include "logging/logging.h"
 #include "monitoring/persistent_stats_history.h"
+#include "port/port.h"
+#include "util/mutexlock.h"
 #include "util/udt_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -28,41 +31,20 @@ void VersionEditHandlerBase::Iterate(log::Reader& reader,
   assert(log_read_status);
   assert(log_read_status->ok());
 
-  [[maybe_unused]] size_t recovered_edits = 0;
+  recovered_edits_ = 0;
   Status s = Initialize();
-  while (reader.LastRecordEnd() < max_manifest_read_size_ && s.ok() &&
-         reader.ReadRecord(&record, &scratch) && log_read_status->ok()) {
+  if (s.ok() && pipelined_read_) {
+    s = IteratePipelined(reader, log_read_status);
+  }
+  while (!pipelined_read_ && reader.LastRecordEnd() < max_manifest_read_size_ &&
+         s.ok() && reader.ReadRecord(&record, &scratch) &&
+         log_read_status->ok()) {
     VersionEdit edit;
     s = edit.DecodeFrom(record);
     if (!s.ok()) {
       break;
     }
-
-    s = read_buffer_.AddEdit(&edit);
-    if (!s.ok()) {
-      break;
-    }
-    ColumnFamilyData* cfd = nullptr;
-    if (edit.IsInAtomicGroup()) {
-      if (read_buffer_.IsFull()) {
-        for (auto& e : read_buffer_.replay_buffer()) {
-          s = ApplyVersionEdit(e, &cfd);
-          if (!s.ok()) {
-            break;
-          }
-          ++recovered_edits;
-        }
-        if (!s.ok()) {
-          break;
-        }
-        read_buffer_.Clear();
-      }
-    } else {
-      s = ApplyVersionEdit(edit, &cfd);
-      if (s.ok()) {
-        ++recovered_edits;
-      }
-    }
+    s = ProcessEdit(edit);
   }
   if (!log_read_status->ok()) {
     s = *log_read_status;
@@ -95,7 +77,118 @@ void VersionEditHandlerBase::Iterate(log::Reader& reader,
     status_ = s;
   }
   TEST_SYNC_POINT_CALLBACK("VersionEditHandlerBase::Iterate:Finish",
-                           &recovered_edits);
+                           &recovered_edits_);
+}
+
+Status VersionEditHandlerBase::ProcessEdit(VersionEdit& edit) {
+  Status s = read_buffer_.AddEdit(&edit);
+  if (!s.ok()) {
+    return s;
+  }
+  ColumnFamilyData* cfd = nullptr;
+  if (edit.IsInAtomicGroup()) {
+    if (read_buffer_.IsFull()) {
+      for (auto& e : read_buffer_.replay_buffer()) {
+        s = ApplyVersionEdit(e, &cfd);
+        if (!s.ok()) {
+          return s;
+        }
+        ++recovered_edits_;
+      }
+      read_buffer_.Clear();
+    }
+  } else {
+    s = ApplyVersionEdit(edit, &cfd);
+    if (s.ok()) {
+      ++recovered_edits_;
+    }
+  }
+  return s;
+}
+
+Status VersionEditHandlerBase::IteratePipelined(log::Reader& reader,
+                                                Status* log_read_status) {
+  // The reader thread hands over the decoded edits in batches, and waits
+  // when this thread is kMaxPendingBatches behind
+  const size_t kBatchSize = 64;
+  const size_t kMaxPendingBatches = 16;
+
+  port::Mutex mu;
+  port::CondVar cv(&mu);
+  std::deque<std::vector<VersionEdit>> pending;
+  bool done = false;
+  bool stop = false;
+  Status decode_status;
+
+  port::Thread read_thread([&]() {
+    Slice record;
+    std::string scratch;
+    std::vector<VersionEdit> batch;
+    auto hand_over = [&]() {
+      MutexLock l(&mu);
+      while (pending.size() >= kMaxPendingBatches && !stop) {
+        cv.Wait();
+      }
+      pending.push_back(std::move(batch));
+      batch.clear();
+      cv.SignalAll();
+      return !stop;
+    };
+    // The log reporter writes *log_read_status on this thread, so only this
+    // thread checks it until it is joined
+    while (reader.LastRecordEnd() < max_manifest_read_size_ &&
+           reader.ReadRecord(&record, &scratch) && log_read_status->ok()) {
+      batch.emplace_back();
+      Status s = batch.back().DecodeFrom(record);
+      if (!s.ok()) {
+        batch.pop_back();
+        decode_status = s;
+        break;
+      }
+      if (batch.size() >= kBatchSize && !hand_over()) {
+        break;
+      }
+    }
+    if (!batch.empty()) {
+      hand_over();
+    }
+    MutexLock l(&mu);
+    done = true;
+    cv.SignalAll();
+  });
+
+  Status s;
+  while (s.ok()) {
+    std::vector<VersionEdit> batch;
+    {
+      MutexLock l(&mu);
+      while (pending.empty() && !done) {
+        cv.Wait();
+      }
+      if (pending.empty()) {
+        break;
+      }
+      batch = std::move(pending.front());
+      pending.pop_front();
+      cv.SignalAll();
+    }
+    for (auto& edit : batch) {
+      s = ProcessEdit(edit);
+      if (!s.ok()) {
+        break;
+      }
+    }
+  }
+  {
+    MutexLock l(&mu);
+    stop = true;
+    cv.SignalAll();
+  }
+  read_thread.join();
+  if (s.ok()) {
+    s = decode_status;
+  }
+  return s;
 }
 
 Status ListColumnFamiliesHandler::ApplyVersionEdit(
@@ -427,27 +520,15 @@ void VersionEditHandler::CheckIterationResult(const log::Reader& reader,
       }
     }
   }
+  SystemClock* clock = version_set_->clock_;
   if (s->ok()) {
-    for (auto* cfd : *(version_set_->GetColumnFamilySet())) {
-      if (cfd->IsDropped()) {
-        continue;
-      }
-      if (read_only_) {
-        cfd->table_cache()->SetTablesAreImmortal();
-      }
-      *s = LoadTables(cfd, /*prefetch_index_and_filter_in_cache=*/false,
-                      /*is_initial_load=*/true);
-      if (!s->ok()) {
-        // If s is IOError::PathNotFound, then we mark the db as corrupted.
-        if (s->IsPathNotFound()) {
-          *s = Status::Corruption("Corruption: " + s->ToString());
-        }
-        break;
-      }
-    }
+    const uint64_t start_micros = clock->NowMicros();
+    *s = LoadTablesOfColumnFamilies();
+    load_tables_micros_ = clock->NowMicros() - start_micros;
   }
 
   if (s->ok()) {
+    const uint64_t start_micros = clock->NowMicros();
     for (auto* cfd : *(version_set_->column_family_set_)) {
       if (cfd->IsDropped()) {
         continue;
@@ -459,6 +540,7 @@ void VersionEditHandler::CheckIterationResult(const log::Reader& reader,
         break;
       }
     }
+    create_versions_micros_ = clock->NowMicros() - start_micros;
   }
   if (s->ok()) {
     version_set_->manifest_file_size_ = reader.GetReadOffset();
@@ -561,7 +643,70 @@ Status VersionEditHandler::MaybeCreateVersion(const VersionEdit& /*edit*/,
   return s;
 }
 
-Status VersionEditHandler::LoadTables(ColumnFamilyData* cfd,
+Status VersionEditHandler::LoadTablesOfColumnFamilies() {
+  std::vector<ColumnFamilyData*> cfds;
+  for (auto* cfd : *(version_set_->GetColumnFamilySet())) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    if (read_only_) {
+      cfd->table_cache()->SetTablesAreImmortal();
+    }
+    cfds.push_back(cfd);
+  }
+
+  // With a table cache of limited capacity, each column family loads only
+  // as many tables as the cache has room for after the previous ones, so
+  // they are loaded one after another. Otherwise they share the threads.
+  const int max_threads =
+      std::max(1, version_set_->db_options_->max_file_opening_threads);
+  int num_threads = 1;
+  if (version_set_->table_cache_->GetCapacity() ==
+      TableCache::kInfiniteCapacity) {
+    num_threads = std::min(static_cast<int>(cfds.size()), max_threads);
+    num_threads = std::max(1, num_threads);
+  }
+  const int threads_per_cfd = std::max(1, max_threads / num_threads);
+
+  std::vector<Status> statuses(cfds.size());
+  std::atomic<size_t> next_cfd_idx(0);
+  std::atomic<bool> failed(false);
+  std::function<void()> load_tables_func([&]() {
+    while (!failed.load(std::memory_order_relaxed)) {
+      size_t idx = next_cfd_idx.fetch_add(1);
+      if (idx >= cfds.size()) {
+        break;
+      }
+      statuses[idx] = LoadTables(cfds[idx], threads_per_cfd,
+                                 /*prefetch_index_and_filter_in_cache=*/false,
+                                 /*is_initial_load=*/true);
+      if (!statuses[idx].ok()) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+  std::vector<port::Thread> threads;
+  for (int i = 1; i < num_threads; i++) {
+    threads.emplace_back(load_tables_func);
+  }
+  load_tables_func();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (auto& s : statuses) {
+    if (!s.ok()) {
+      // If s is IOError::PathNotFound, then we mark the db as corrupted.
+      if (s.IsPathNotFound()) {
+        s = Status::Corruption("Corruption: " + s.ToString());
+      }
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+Status VersionEditHandler::LoadTables(ColumnFamilyData* cfd, int max_threads,
                                       bool prefetch_index_and_filter_in_cache,
                                       bool is_initial_load) {
   bool skip_load_table_files = skip_load_table_files_;
@@ -580,9 +725,8 @@ Status VersionEditHandler::LoadTables(ColumnFamilyData* cfd,
   assert(builder);
   const MutableCFOptions* moptions = cfd->GetLatestMutableCFOptions();
   Status s = builder->LoadTableHandlers(
-      cfd->internal_stats(),
-      version_set_->db_options_->max_file_opening_threads,
-      prefetch_index_and_filter_in_cache, is_initial_load,
+      cfd->internal_stats(), max_threads, prefetch_index_and_filter_in_cache,
+      is_initial_load,
       moptions->prefix_extractor, MaxFileSizeForL0MetaPin(*moptions),
       read_options_, moptions->block_protection_bytes_per_key);
   if ((s.IsPathNotFound() || s.IsCorruption()) && no_error_if_files_missing_) {
@@ -945,8 +1089,8 @@ Status VersionEditHandlerPointInTime::VerifyBlobFile(
 }
 
 Status VersionEditHandlerPointInTime::LoadTables(
-    ColumnFamilyData* /*cfd*/, bool /*prefetch_index_and_filter_in_cache*/,
-    bool /*is_initial_load*/) {
+    ColumnFamilyData* /*cfd*/, int /*max_threads*/,
+    bool /*prefetch_index_and_filter_in_cache*/, bool /*is_initial_load*/) {
   return Status::OK();
 }
 
@@ -27,8 +27,17 @@ class VersionEditHandlerBase {
 
   void Iterate(log::Reader& reader, Status* log_read_status);
 
+  // Reads and decodes the records of the MANIFEST on another thread, while
+  // this one applies the edits decoded so far
+  void SetPipelinedRead(bool pipelined_read) {
+    pipelined_read_ = pipelined_read;
+  }
+
   const Status& status() const { return status_; }
 
+  // The number of edits applied by Iterate()
+  size_t recovered_edits() const { return recovered_edits_; }
+
   AtomicGroupReadBuffer& GetReadBuffer() { return read_buffer_; }
 
  protected:
@@ -50,8 +59,15 @@ class VersionEditHandlerBase {
   const ReadOptions& read_options_;
 
  private:
+  // Applies an edit, or buffers it until its atomic group is complete
+  Status ProcessEdit(VersionEdit& edit);
+
+  Status IteratePipelined(log::Reader& reader, Status* log_read_status);
+
   AtomicGroupReadBuffer read_buffer_;
   const uint64_t max_manifest_read_size_;
+  bool pipelined_read_ = false;
+  size_t recovered_edits_ = 0;
 };
 
 class ListColumnFamiliesHandler : public VersionEditHandlerBase {
@@ -138,6 +154,11 @@ class VersionEditHandler : public VersionEditHandlerBase {
     }
   }
 
+  // The time taken by Iterate() to load the table files and to create the
+  // versions once the edits were applied
+  uint64_t load_tables_micros() const { return load_tables_micros_; }
+  uint64_t create_versions_micros() const { return create_versions_micros_; }
+
  protected:
   explicit VersionEditHandler(
       bool read_only, std::vector<ColumnFamilyDescriptor> column_families,
@@ -176,12 +197,16 @@ class VersionEditHandler : public VersionEditHandlerBase {
                                     ColumnFamilyData* cfd,
                                     bool force_create_version);
 
-  virtual Status LoadTables(ColumnFamilyData* cfd,
+  virtual Status LoadTables(ColumnFamilyData* cfd, int max_threads,
                             bool prefetch_index_and_filter_in_cache,
                             bool is_initial_load);
 
   virtual bool MustOpenAllColumnFamilies() const { return !read_only_; }
 
+  // Loads the tables of the live column families, of several at a time when
+  // the table cache has no capacity limit
+  Status LoadTablesOfColumnFamilies();
+
   const bool read_only_;
   std::vector<ColumnFamilyDescriptor> column_families_;
   VersionSet* version_set_;
@@ -203,6 +228,8 @@ class VersionEditHandler : public VersionEditHandlerBase {
   std::unique_ptr<std::unordered_map<uint32_t, std::string>> cf_to_cmp_names_;
   EpochNumberRequirement epoch_number_requirement_;
   std::unordered_set<uint32_t> cfds_to_mark_no_udt_;
+  uint64_t load_tables_micros_ = 0;
+  uint64_t create_versions_micros_ = 0;
 
  private:
   Status ExtractInfoFromVersionEdit(ColumnFamilyData* cfd,
@@ -246,7 +273,7 @@ class VersionEditHandlerPointInTime : public VersionEditHandler {
   virtual Status VerifyBlobFile(ColumnFamilyData* cfd, uint64_t blob_file_num,
                                 const BlobFileAddition& blob_addition);
 
-  Status LoadTables(ColumnFamilyData* cfd,
+  Status LoadTables(ColumnFamilyData* cfd, int max_threads,
                     bool prefetch_index_and_filter_in_cache,
                     bool is_initial_load) override;
 
@@ -18,6 +18,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "db/blob/blob_fetcher.h"
@@ -73,6 +74,8 @@
 #include "util/cast_util.h"
 #include "util/coding.h"
 #include "util/coro_utils.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/user_comparator_wrapper.h"
@@ -94,11 +97,31 @@ namespace ROCKSDB_NAMESPACE {
 
 namespace {
 
+// See LevelFilesBrief::largest_key_prefixes
+uint64_t UserKeyPrefix(const Slice& user_key) {
+  char buf[sizeof(uint64_t)] = {};
+  memcpy(buf, user_key.data(), std::min(user_key.size(), sizeof(buf)));
+  // Big-endian, so that the numbers are ordered like the keys
+  return EndianSwapValue(DecodeFixed64(buf));
+}
+
 // Find File in LevelFilesBrief data structure
 // Within an index range defined by left and right
 int FindFileInRange(const InternalKeyComparator& icmp,
                     const LevelFilesBrief& file_level, const Slice& key,
                     uint32_t left, uint32_t right) {
+  if (file_level.largest_key_prefixes != nullptr && left < right) {
+    // The prefixes of keys are ordered like the keys, so only the files
+    // whose largest key has the same prefix as `key` need their keys
+    // compared. Those before have a smaller, and those after a larger
+    // largest key.
+    const uint64_t prefix = UserKeyPrefix(ExtractUserKey(key));
+    const uint64_t* p = file_level.largest_key_prefixes;
+    const uint64_t* first = std::lower_bound(p + left, p + right, prefix);
+    const uint64_t* last = std::upper_bound(first, p + right, prefix);
+    left = static_cast<uint32_t>(first - p);
+    right = static_cast<uint32_t>(last - p);
+  }
   auto cmp = [&](const FdWithKeyRange& f, const Slice& k) -> bool {
     return icmp.InternalKeyComparator::Compare(f.largest_key, k) < 0;
   };
@@ -853,7 +876,7 @@ int FindFile(const InternalKeyComparator& icmp,
 
 void DoGenerateLevelFilesBrief(LevelFilesBrief* file_level,
                                const std::vector<FileMetaData*>& files,
-                               Arena* arena) {
+                               Arena* arena, const Comparator* ucmp) {
   assert(file_level);
   assert(arena);
 
@@ -879,6 +902,16 @@ void DoGenerateLevelFilesBrief(LevelFilesBrief* file_level,
     f.smallest_key = Slice(mem, smallest_size);
     f.largest_key = Slice(mem + smallest_size, largest_size);
   }
+
+  file_level->largest_key_prefixes = nullptr;
+  if (ucmp != nullptr && ucmp == BytewiseComparator() && num > 0) {
+    file_level->largest_key_prefixes = reinterpret_cast<uint64_t*>(
+        arena->AllocateAligned(num * sizeof(uint64_t)));
+    for (size_t i = 0; i < num; i++) {
+      file_level->largest_key_prefixes[i] =
+          UserKeyPrefix(files[i]->largest.user_key());
+    }
+  }
 }
 
 static bool AfterFile(const Comparator* ucmp, const Slice* user_key,
@@ -1065,12 +1098,32 @@ class LevelIterator final : public InternalIterator {
     read_seq_ = read_seq;
   }
 
+  void SetCoveredRangeChecker(CoveredRangeChecker* checker) override {
+    covered_range_checker_ = checker;
+    if (file_iter_.iter()) {
+      file_iter_.iter()->SetCoveredRangeChecker(checker);
+    }
+  }
+
  private:
   // Return true if at least one invalid file is seen and skipped.
   bool SkipEmptyFileForward();
   void SkipEmptyFileBackward();
   void SetFileIterator(InternalIterator* iter);
   void InitFileIterator(size_t new_file_index);
+  // Starts opening the file after the current one in the background if it
+  // is likely to be read next, see DBOptions::table_cache_open_ahead. With
+  // DBOptions::table_cache_open_ahead_fraction, the open is deferred until
+  // that many of the entries of the current file have been read.
+  void OpenNextFileAhead();
+  void StartOpenAhead();
+  // Counts down the entries read from the current file before the deferred
+  // open ahead is started
+  void MaybeStartOpenAhead() {
+    if (open_ahead_countdown_ > 0 && --open_ahead_countdown_ == 0) {
+      StartOpenAhead();
+    }
+  }
 
   const Slice& file_smallest_key(size_t file_index) {
     assert(file_index < flevel_->num_files);
@@ -1144,6 +1197,11 @@ class LevelIterator final : public InternalIterator {
   const InternalKeyComparator& icomparator_;
   const UserComparatorWrapper user_comparator_;
   const LevelFilesBrief* flevel_;
+  // Created on first use
+  std::unique_ptr<TableCache::OpenAhead> open_ahead_;
+  // Entries left to read from the current file before the next one is
+  // opened ahead, 0 if it is not to be
+  uint64_t open_ahead_countdown_ = 0;
   mutable FileDescriptor current_value_;
   // `prefix_extractor_` may be non-null even for total order seek. Checking
   // this variable is not the right way to identify whether prefix iterator
@@ -1156,6 +1214,9 @@ class LevelIterator final : public InternalIterator {
   RangeDelAggregator* range_del_agg_;
   IteratorWrapper file_iter_;  // May be nullptr
   PinnedIteratorsManager* pinned_iters_mgr_;
+  // Set by the merging iterator, to skip the files whose keys are all deleted
+  // by range tombstones of newer sorted runs
+  CoveredRangeChecker* covered_range_checker_ = nullptr;
 
   // To be propagated to RangeDelAggregator in order to safely truncate range
   // tombstones.
@@ -1345,6 +1406,7 @@ void LevelIterator::SeekToFirst() {
   prefix_exhausted_ = false;
   ClearSentinel();
   InitFileIterator(0);
+  OpenNextFileAhead();
   if (file_iter_.iter() != nullptr) {
     file_iter_.SeekToFirst();
     if (range_tombstone_iter_) {
@@ -1381,6 +1443,7 @@ void LevelIterator::Next() {
     if (range_tombstone_iter_) {
       TrySetDeleteRangeSentinel(file_largest_key(file_index_));
     }
+    MaybeStartOpenAhead();
   }
   SkipEmptyFileForward();
 }
@@ -1389,7 +1452,9 @@ bool LevelIterator::NextAndGetResult(IterateResult* result) {
   assert(Valid());
   // file_iter_ is at EOF already when to_return_sentinel_
   bool is_valid = !to_return_sentinel_ && file_iter_.NextAndGetResult(result);
-  if (!is_valid) {
+  if (is_valid) {
+    MaybeStartOpenAhead();
+  } else {
     if (to_return_sentinel_) {
       ClearSentinel();
     } else if (range_tombstone_iter_) {
@@ -1441,16 +1506,27 @@ bool LevelIterator::SkipEmptyFileForward() {
            file_iter_.iter()->UpperBoundCheckResult() !=
                IterBoundCheck::kOutOfBound))) {
     seen_empty_file = true;
-    // Move to next file
-    if (file_index_ >= flevel_->num_files - 1 ||
-        KeyReachedUpperBound(file_smallest_key(file_index_ + 1)) ||
+    // Move to next file, skipping those deleted by range tombstones of newer
+    // sorted runs without opening them
+    size_t next_file_index = file_index_ + 1;
+    while (covered_range_checker_ != nullptr &&
+           next_file_index < flevel_->num_files &&
+           covered_range_checker_->IsCovered(
+               ExtractUserKey(file_smallest_key(next_file_index)),
+               ExtractUserKey(file_largest_key(next_file_index)))) {
+      TEST_SYNC_POINT("LevelIterator:SkipCoveredFile");
+      next_file_index++;
+    }
+    if (next_file_index >= flevel_->num_files ||
+        KeyReachedUpperBound(file_smallest_key(next_file_index)) ||
         prefix_exhausted_) {
       SetFileIterator(nullptr);
       ClearRangeTombstoneIter();
       break;
     }
     // may init a new *range_tombstone_iter
-    InitFileIterator(file_index_ + 1);
+    InitFileIterator(next_file_index);
+    OpenNextFileAhead();
     // We moved to a new SST file
     // Seek range_tombstone_iter_ to reset its !Valid() default state.
     // We do not need to call range_tombstone_iter_.Seek* in
@@ -1504,6 +1580,9 @@ void LevelIterator::SetFileIterator(InternalIterator* iter) {
   if (pinned_iters_mgr_ && iter) {
     iter->SetPinnedItersMgr(pinned_iters_mgr_);
   }
+  if (covered_range_checker_ && iter) {
+    iter->SetCoveredRangeChecker(covered_range_checker_);
+  }
 
   InternalIterator* old_iter = file_iter_.Set(iter);
 
@@ -1519,11 +1598,42 @@ void LevelIterator::SetFileIterator(InternalIterator* iter) {
   }
 }
 
+void LevelIterator::OpenNextFileAhead() {
+  open_ahead_countdown_ = 0;
+  if (!table_cache_->open_ahead() ||
+      caller_ == TableReaderCaller::kCompaction ||
+      read_options_.read_tier == kBlockCacheTier || prefix_exhausted_ ||
+      file_index_ + 1 >= flevel_->num_files ||
+      KeyReachedUpperBound(file_smallest_key(file_index_ + 1))) {
+    return;
+  }
+  const double fraction = table_cache_->open_ahead_fraction();
+  const uint64_t num_entries =
+      flevel_->files[file_index_].file_metadata->num_entries;
+  if (fraction > 0 && num_entries > 0) {
+    open_ahead_countdown_ = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::min(fraction, 1.0) * num_entries));
+    return;
+  }
+  StartOpenAhead();
+}
+
+void LevelIterator::StartOpenAhead() {
+  if (!open_ahead_) {
+    open_ahead_.reset(new TableCache::OpenAhead(table_cache_));
+  }
+  open_ahead_->Start(read_options_, file_options_, icomparator_,
+                     *flevel_->files[file_index_ + 1].file_metadata,
+                     block_protection_bytes_per_key_, prefix_extractor_,
+                     file_read_hist_, skip_filters_, level_);
+}
+
 void LevelIterator::InitFileIterator(size_t new_file_index) {
   if (new_file_index >= flevel_->num_files) {
     file_index_ = new_file_index;
     SetFileIterator(nullptr);
     ClearRangeTombstoneIter();
+    open_ahead_countdown_ = 0;
     return;
   } else {
     // If the file iterator shows incomplete, we try it again if users seek
@@ -1536,6 +1646,7 @@ void LevelIterator::InitFileIterator(size_t new_file_index) {
       // no need to change anything
     } else {
       file_index_ = new_file_index;
+      open_ahead_countdown_ = 0;
       InternalIterator* iter = NewFileIterator();
       SetFileIterator(iter);
     }
@@ -1601,6 +1712,15 @@ Status Version::GetTableProperties(const ReadOptions& read_options,
   return s;
 }
 
+Status Version::PrefetchDataBlocks(
+    const ReadOptions& read_options, const FileMetaData& file_meta,
+    const std::vector<uint64_t>& block_offsets) const {
+  return cfd_->table_cache()->PrefetchDataBlocks(
+      read_options, cfd_->internal_comparator(), file_meta,
+      mutable_cf_options_.block_protection_bytes_per_key,
+      mutable_cf_options_.prefix_extractor, block_offsets);
+}
+
 Status Version::GetPropertiesOfAllTables(const ReadOptions& read_options,
                                          TablePropertiesCollection* props) {
   Status s;
@@ -1731,6 +1851,17 @@ Status Version::GetPropertiesOfTablesInRange(
 Status Version::GetAggregatedTableProperties(
     const ReadOptions& read_options, std::shared_ptr<const TableProperties>* tp,
     int level) {
+  const size_t index = level < 0 ? 0 : static_cast<size_t>(level) + 1;
+  {
+    MutexLock l(&aggregated_table_properties_mutex_);
+    if (index < aggregated_table_properties_.size() &&
+        aggregated_table_properties_[index] != nullptr) {
+      *tp = aggregated_table_properties_[index];
+      return Status::OK();
+    }
+  }
+
+  TEST_SYNC_POINT("Version::GetAggregatedTableProperties:Compute");
   TablePropertiesCollection props;
   Status s;
   if (level < 0) {
@@ -1742,11 +1873,17 @@ Status Version::GetAggregatedTableProperties(
     return s;
   }
 
-  auto* new_tp = new TableProperties();
+  auto new_tp = std::make_shared<TableProperties>();
   for (const auto& item : props) {
     new_tp->Add(*item.second);
   }
-  tp->reset(new_tp);
+  *tp = new_tp;
+
+  MutexLock l(&aggregated_table_properties_mutex_);
+  if (aggregated_table_properties_.size() <= index) {
+    aggregated_table_properties_.resize(index + 1);
+  }
+  aggregated_table_properties_[index] = *tp;
   return Status::OK();
 }
 
@@ -2224,6 +2361,18 @@ Version::Version(ColumnFamilyData* column_family_data, VersionSet* vset,
   }
 }
 
+namespace {
+// Whether blobs read from the file should be added to the blob cache, see
+// AdvancedColumnFamilyOptions::blob_cache_max_garbage_ratio
+bool ShouldCacheBlobs(const BlobFileMetaData& blob_file_meta,
+                      double max_garbage_ratio) {
+  return max_garbage_ratio >= 1.0 ||
+         static_cast<double>(blob_file_meta.GetGarbageBlobBytes()) <=
+             max_garbage_ratio *
+                 static_cast<double>(blob_file_meta.GetTotalBlobBytes());
+}
+}  // anonymous namespace
+
 Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
                         const Slice& blob_index_slice,
                         FilePrefetchBuffer* prefetch_buffer,
@@ -2260,6 +2409,16 @@ Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
 
   assert(blob_source_);
   value->Reset();
+  if (read_options.fill_cache &&
+      !ShouldCacheBlobs(*blob_file_meta,
+                        mutable_cf_options_.blob_cache_max_garbage_ratio)) {
+    ReadOptions no_fill_read_options(read_options);
+    no_fill_read_options.fill_cache = false;
+    return blob_source_->GetBlob(
+        no_fill_read_options, user_key, blob_file_number, blob_index.offset(),
+        blob_file_meta->GetBlobFileSize(), blob_index.size(),
+        blob_index.compression(), prefetch_buffer, value, bytes_read);
+  }
   const Status s = blob_source_->GetBlob(
       read_options, user_key, blob_file_number, blob_index.offset(),
       blob_file_meta->GetBlobFileSize(), blob_index.size(),
@@ -2274,6 +2433,8 @@ void Version::MultiGetBlob(
   assert(!blob_ctxs.empty());
 
   autovector<BlobFileReadRequests> blob_reqs;
+  // For files with too much garbage to be worth caching
+  autovector<BlobFileReadRequests> no_fill_blob_reqs;
 
   for (auto& ctx : blob_ctxs) {
     const auto file_number = ctx.first;
@@ -2313,7 +2474,14 @@ void Version::MultiGetBlob(
     }
     if (blob_reqs_in_file.size() > 0) {
       const auto file_size = blob_file_meta->GetBlobFileSize();
-      blob_reqs.emplace_back(file_number, file_size, blob_reqs_in_file);
+      if (read_options.fill_cache &&
+          !ShouldCacheBlobs(*blob_file_meta,
+                            mutable_cf_options_.blob_cache_max_garbage_ratio)) {
+        no_fill_blob_reqs.emplace_back(file_number, file_size,
+                                       blob_reqs_in_file);
+      } else {
+        blob_reqs.emplace_back(file_number, file_size, blob_reqs_in_file);
+      }
     }
   }
 
@@ -2321,6 +2489,12 @@ void Version::MultiGetBlob(
     blob_source_->MultiGetBlob(read_options, blob_reqs,
                                /*bytes_read=*/nullptr);
   }
+  if (no_fill_blob_reqs.size() > 0) {
+    ReadOptions no_fill_read_options(read_options);
+    no_fill_read_options.fill_cache = false;
+    blob_source_->MultiGetBlob(no_fill_read_options, no_fill_blob_reqs,
+                               /*bytes_read=*/nullptr);
+  }
 
   for (auto& ctx : blob_ctxs) {
     BlobReadContexts& blobs_in_file = ctx.second;
@@ -2353,6 +2527,84 @@ void Version::MultiGetBlob(
   }
 }
 
+void Version::MultiGetBlob(const ReadOptions& read_options, size_t num_blobs,
+                           const Slice* user_keys,
+                           const BlobIndex* blob_indexes,
+                           PinnableSlice* values, Status* statuses) const {
+  assert(num_blobs <= MultiGetContext::MAX_BATCH_SIZE);
+
+  // The blobs of each file must be read in offset order
+  std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> order;
+  for (size_t i = 0; i < num_blobs; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.begin() + num_blobs,
+            [blob_indexes](size_t a, size_t b) {
+              const BlobIndex& x = blob_indexes[a];
+              const BlobIndex& y = blob_indexes[b];
+              return x.file_number() < y.file_number() ||
+                     (x.file_number() == y.file_number() &&
+                      x.offset() < y.offset());
+            });
+
+  autovector<BlobFileReadRequests> blob_reqs;
+  // For files with too much garbage to be worth caching
+  autovector<BlobFileReadRequests> no_fill_blob_reqs;
+
+  for (size_t begin = 0; begin < num_blobs;) {
+    const uint64_t file_number = blob_indexes[order[begin]].file_number();
+    size_t end = begin + 1;
+    while (end < num_blobs &&
+           blob_indexes[order[end]].file_number() == file_number) {
+      ++end;
+    }
+    const auto blob_file_meta = storage_info_.GetBlobFileMetaData(file_number);
+
+    autovector<BlobReadRequest> blob_reqs_in_file;
+    for (size_t k = begin; k < end; ++k) {
+      const size_t i = order[k];
+      const BlobIndex& blob_index = blob_indexes[i];
+      values[i].Reset();
+      if (!blob_file_meta) {
+        statuses[i] = Status::Corruption("Invalid blob file number");
+        continue;
+      }
+      if (blob_index.HasTTL() || blob_index.IsInlined()) {
+        statuses[i] = Status::Corruption("Unexpected TTL/inlined blob index");
+        continue;
+      }
+      blob_reqs_in_file.emplace_back(user_keys[i], blob_index.offset(),
+                                     blob_index.size(),
+                                     blob_index.compression(), &values[i],
+                                     &statuses[i]);
+    }
+    if (blob_reqs_in_file.size() > 0) {
+      const auto file_size = blob_file_meta->GetBlobFileSize();
+      if (read_options.fill_cache &&
+          !ShouldCacheBlobs(*blob_file_meta,
+                            mutable_cf_options_.blob_cache_max_garbage_ratio)) {
+        no_fill_blob_reqs.emplace_back(file_number, file_size,
+                                       blob_reqs_in_file);
+      } else {
+        blob_reqs.emplace_back(file_number, file_size, blob_reqs_in_file);
+      }
+    }
+    begin = end;
+  }
+
+  assert(blob_source_);
+  if (blob_reqs.size() > 0) {
+    blob_source_->MultiGetBlob(read_options, blob_reqs,
+                               /*bytes_read=*/nullptr);
+  }
+  if (no_fill_blob_reqs.size() > 0) {
+    ReadOptions no_fill_read_options(read_options);
+    no_fill_read_options.fill_cache = false;
+    blob_source_->MultiGetBlob(no_fill_read_options, no_fill_blob_reqs,
+                               /*bytes_read=*/nullptr);
+  }
+}
+
 void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                   PinnableSlice* value, PinnableWideColumns* columns,
                   std::string* timestamp, Status* status,
@@ -2394,6 +2646,13 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       merge_operator_ ? pinned_iters_mgr : nullptr, callback, is_blob_to_use,
       tracing_get_id, &blob_fetcher);
 
+  if (cfd_ != nullptr && cfd_->merge_result_cache() != nullptr && do_merge &&
+      value != nullptr && columns == nullptr && callback == nullptr &&
+      is_blob == nullptr &&
+      !read_options.merge_operand_count_threshold.has_value()) {
+    get_context.SetMergeResultCache(cfd_->merge_result_cache());
+  }
+
   // Pin blocks that we read to hold merge operands
   if (merge_operator_) {
     pinned_iters_mgr->StartPinning();
@@ -2541,6 +2800,7 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       if (status->ok()) {
         if (LIKELY(value != nullptr)) {
           value->PinSelf();
+          get_context.CacheMergeResult(*value);
         }
       }
     }
@@ -2552,6 +2812,40 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+bool Version::MayHaveNewerEntries(const Slice& user_key,
+                                  SequenceNumber seq) const {
+  const Comparator* ucmp = user_comparator();
+  auto newer_and_overlapping = [&](const FdWithKeyRange& f) {
+    return f.file_metadata->LargestSeqnoOfInputs() > seq &&
+           ucmp->CompareWithoutTimestamp(ExtractUserKey(f.largest_key),
+                                         user_key) >= 0 &&
+           ucmp->CompareWithoutTimestamp(ExtractUserKey(f.smallest_key),
+                                         user_key) <= 0;
+  };
+  InternalKey ikey;
+  ikey.SetMinPossibleForUserKey(user_key);
+  for (int level = 0; level < storage_info_.num_non_empty_levels(); level++) {
+    const LevelFilesBrief& files = storage_info_.LevelFilesBrief(level);
+    size_t i = 0;
+    if (level > 0) {
+      i = static_cast<size_t>(
+          FindFile(*internal_comparator(), files, ikey.Encode()));
+    }
+    for (; i < files.num_files; i++) {
+      if (newer_and_overlapping(files.files[i])) {
+        return true;
+      }
+      // Files of a level past 0 are sorted, and only share boundary keys
+      if (level > 0 &&
+          ucmp->CompareWithoutTimestamp(
+              ExtractUserKey(files.files[i].largest_key), user_key) > 0) {
+        break;
+      }
+    }
+  }
+  return false;
+}
+
 void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
                        ReadCallback* callback) {
   PinnedIteratorsManager pinned_iters_mgr;
@@ -2604,6 +2898,12 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   } else
 #endif  // USE_COROUTINES
   {
+    if (read_options.async_io && read_options.optimize_multiget_for_io &&
+        !(using_coroutines() && use_async_io_) &&
+        read_options.read_tier != kBlockCacheTier) {
+      PrefetchForMultiGet(read_options, range);
+    }
+
     MultiGetRange file_picker_range(*range, range->begin(), range->end());
     FilePickerMultiGet fp(&file_picker_range, &storage_info_.level_files_brief_,
                           storage_info_.num_non_empty_levels_,
@@ -2711,7 +3011,9 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         break;
       }
       if (!f) {
-        // Reached the end of this level. Prepare the next level
+        // Reached the end of this level. The keys found so far are final
+        range->context()->ReportDoneKeys(/*all=*/false);
+        // Prepare the next level
         fp.PrepareNextLevelForSearch();
         if (!fp.IsSearchEnded()) {
           // Its possible there is no overlap on this level and f is nullptr
@@ -2809,6 +3111,144 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   }
 }
 
+void Version::PrefetchForMultiGet(const ReadOptions& read_options,
+                                  MultiGetRange* range) {
+  MultiGetRange prefetch_range(*range, range->begin(), range->end());
+  FilePickerMultiGet fp(&prefetch_range, &storage_info_.level_files_brief_,
+                        storage_info_.num_non_empty_levels_,
+                        &storage_info_.file_indexer_, user_comparator(),
+                        internal_comparator());
+  while (!fp.IsSearchEnded()) {
+    for (FdWithKeyRange* f = fp.GetNextFileInLevel(); f != nullptr;
+         f = fp.GetNextFileInLevel()) {
+      table_cache_->PrefetchForMultiGet(
+          read_options, *internal_comparator(), *f->file_metadata,
+          &fp.CurrentFileRange(),
+          mutable_cf_options_.block_protection_bytes_per_key);
+    }
+    fp.PrepareNextLevelForSearch();
+  }
+}
+
+Status Version::KeysMayExist(const ReadOptions& read_options,
+                             MultiGetRange* range) {
+  assert(read_options.ignore_range_deletions);
+  MultiGetRange file_picker_range(*range, range->begin(), range->end());
+  FilePickerMultiGet fp(&file_picker_range, &storage_info_.level_files_brief_,
+                        storage_info_.num_non_empty_levels_,
+                        &storage_info_.file_indexer_, user_comparator(),
+                        internal_comparator());
+  while (!fp.IsSearchEnded()) {
+    for (FdWithKeyRange* f = fp.GetNextFileInLevel(); f != nullptr;
+         f = fp.GetNextFileInLevel()) {
+      MultiGetRange file_range = fp.CurrentFileRange();
+      TableCache::TypedHandle* table_handle = nullptr;
+      Status s = table_cache_->MultiGetFilter(
+          read_options, *internal_comparator(), *f->file_metadata,
+          mutable_cf_options_.prefix_extractor,
+          cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
+          fp.GetHitFileLevel(), &file_range, &table_handle,
+          mutable_cf_options_.block_protection_bytes_per_key);
+      if (table_handle != nullptr) {
+        table_cache_->get_cache().Release(table_handle);
+      }
+      if (s.IsNotSupported()) {
+        // No filter to check, so all keys may be in the file
+        s = Status::OK();
+      }
+      if (!s.ok()) {
+        return s;
+      }
+      for (auto iter = file_range.begin(); iter != file_range.end(); ++iter) {
+        iter->key_exists = true;
+        range->MarkKeyDone(iter);
+      }
+    }
+    fp.PrepareNextLevelForSearch();
+  }
+  return Status::OK();
+}
+
+void Version::PrefetchScanRanges(const ReadOptions& read_options,
+                                 const std::vector<Range>& ranges) {
+  const Comparator* ucmp = user_comparator();
+  std::vector<Range> file_ranges;
+  for (int level = 0; level < storage_info_.num_non_empty_levels(); ++level) {
+    const LevelFilesBrief& files = storage_info_.LevelFilesBrief(level);
+    // In levels after L0 the files are sorted, so start with the first one
+    // not before the ranges
+    size_t first = 0;
+    if (level > 0) {
+      InternalKey start(ranges.front().start, kMaxSequenceNumber,
+                        kValueTypeForSeek);
+      first = static_cast<size_t>(
+          FindFile(*internal_comparator(), files, start.Encode()));
+    }
+    for (size_t i = first; i < files.num_files; ++i) {
+      const FdWithKeyRange& f = files.files[i];
+      const Slice smallest = ExtractUserKey(f.smallest_key);
+      const Slice largest = ExtractUserKey(f.largest_key);
+      if (level > 0 && ucmp->CompareWithoutTimestamp(
+                           smallest, /*a_has_ts=*/true, ranges.back().limit,
+                           /*b_has_ts=*/false) >= 0) {
+        break;
+      }
+      file_ranges.clear();
+      for (const Range& range : ranges) {
+        if (ucmp->CompareWithoutTimestamp(range.start, /*a_has_ts=*/false,
+                                          largest, /*b_has_ts=*/true) <= 0 &&
+            ucmp->CompareWithoutTimestamp(smallest, /*a_has_ts=*/true,
+                                          range.limit,
+                                          /*b_has_ts=*/false) < 0) {
+          file_ranges.push_back(range);
+        }
+      }
+      if (!file_ranges.empty()) {
+        table_cache_->PrefetchScanRanges(
+            read_options, *internal_comparator(), *f.file_metadata,
+            file_ranges, mutable_cf_options_.block_protection_bytes_per_key);
+      }
+    }
+  }
+}
+
+uint64_t Version::ApproximateKeyAnchors(
+    const ReadOptions& read_options, const Range& range,
+    std::vector<TableReader::Anchor>* anchors) {
+  const Comparator* ucmp = user_comparator();
+  uint64_t total_size = 0;
+  std::vector<TableReader::Anchor> file_anchors;
+  for (int level = 0; level < storage_info_.num_non_empty_levels(); ++level) {
+    for (FileMetaData* f : storage_info_.LevelFiles(level)) {
+      if (ucmp->Compare(f->smallest.user_key(), range.limit) >= 0) {
+        if (level > 0) {
+          break;
+        }
+        continue;
+      }
+      if (ucmp->Compare(f->largest.user_key(), range.start) < 0) {
+        continue;
+      }
+      file_anchors.clear();
+      Status s = table_cache_->ApproximateKeyAnchors(
+          read_options, *internal_comparator(), *f,
+          mutable_cf_options_.block_protection_bytes_per_key, file_anchors);
+      if (!s.ok() || file_anchors.empty()) {
+        file_anchors.clear();
+        file_anchors.emplace_back(f->largest.user_key(), f->fd.GetFileSize());
+      }
+      for (TableReader::Anchor& anchor : file_anchors) {
+        if (ucmp->Compare(anchor.user_key, range.start) > 0 &&
+            ucmp->Compare(anchor.user_key, range.limit) < 0) {
+          total_size += anchor.range_size;
+          anchors->push_back(std::move(anchor));
+        }
+      }
+    }
+  }
+  return total_size;
+}
+
 #ifdef USE_COROUTINES
 Status Version::ProcessBatch(
     const ReadOptions& read_options, FilePickerMultiGet* batch,
@@ -3052,8 +3492,9 @@ bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
 void VersionStorageInfo::GenerateLevelFilesBrief() {
   level_files_brief_.resize(num_non_empty_levels_);
   for (int level = 0; level < num_non_empty_levels_; level++) {
+    // Level 0 files overlap, so they are not searched by key
     DoGenerateLevelFilesBrief(&level_files_brief_[level], files_[level],
-                              &arena_);
+                              &arena_, level > 0 ? user_comparator_ : nullptr);
   }
 }
 
@@ -3570,6 +4011,26 @@ void VersionStorageInfo::ComputeCompactionScore(
     compaction_score_[level] = score;
   }
 
+  // Among the levels due for compaction, favor those serving the most reads.
+  const double read_heat_weight =
+      mutable_cf_options.compaction_read_heat_weight;
+  if (compaction_style_ == kCompactionStyleLevel && read_heat_weight > 0) {
+    std::vector<uint64_t> level_reads(num_levels());
+    uint64_t total_reads = 0;
+    for (int level = 0; level < num_levels(); level++) {
+      level_reads[level] = NumLevelReadsSampled(level);
+      total_reads += level_reads[level];
+    }
+    for (int level = 0; total_reads > 0 && level <= MaxInputLevel();
+         level++) {
+      if (compaction_score_[level] > 1) {
+        compaction_score_[level] *=
+            1 + read_heat_weight * static_cast<double>(level_reads[level]) /
+                    static_cast<double>(total_reads);
+      }
+    }
+  }
+
   // sort all the levels based on their score. Higher scores get listed
   // first. Use bubble sort because the number of entries are small.
   for (int i = 0; i < num_levels() - 2; i++) {
@@ -3717,6 +4178,82 @@ void VersionStorageInfo::ComputeFilesMarkedForPeriodicCompaction(
   }
 }
 
+void VersionStorageInfo::ComputeFilesCoveredByRangeDeletions(
+    SequenceNumber oldest_snapshot_seqnum) {
+  files_covered_by_range_deletions_.clear();
+  files_covered_by_range_deletions_threshold_ = kMaxSequenceNumber;
+  if (user_comparator_->timestamp_size() > 0) {
+    return;
+  }
+
+  std::unordered_set<FileMetaData*> covered;
+  for (int level = 0; level + 1 < num_non_empty_levels_; level++) {
+    for (FileMetaData* t : files_[level]) {
+      if (t->num_range_deletions == 0) {
+        continue;
+      }
+      if (t->fd.largest_seqno > oldest_snapshot_seqnum) {
+        // More of its tombstones become visible to all snapshots once the
+        // oldest snapshot reaches the first of them above the current one
+        files_covered_by_range_deletions_threshold_ = std::min(
+            files_covered_by_range_deletions_threshold_,
+            std::max(t->fd.smallest_seqno, oldest_snapshot_seqnum + 1) - 1);
+      }
+      if (t->fd.table_reader == nullptr) {
+        continue;
+      }
+      std::unique_ptr<FragmentedRangeTombstoneIterator> iter(
+          t->fd.table_reader->NewRangeTombstoneIterator(
+              oldest_snapshot_seqnum, /*timestamp=*/nullptr));
+      if (iter == nullptr) {
+        continue;
+      }
+      // The tombstones only apply within the key range of their file
+      const Slice lower = t->smallest.user_key();
+      const Slice upper = t->largest.user_key();
+      iter->SeekToTopFirst();
+      while (iter->Valid()) {
+        // A run of adjacent fragments, each with a visible tombstone
+        Slice start = iter->start_key();
+        Slice end = iter->end_key();
+        SequenceNumber seq = iter->seq();
+        for (iter->TopNext(); iter->Valid() &&
+                              user_comparator_->Compare(iter->start_key(),
+                                                        end) == 0;
+             iter->TopNext()) {
+          end = iter->end_key();
+          seq = std::min(seq, iter->seq());
+        }
+        if (user_comparator_->Compare(start, lower) < 0) {
+          start = lower;
+        }
+        // `upper` is inclusive, so it is taken as the end conservatively
+        if (user_comparator_->Compare(end, upper) > 0) {
+          end = upper;
+        }
+        for (int l = level + 1; l < num_non_empty_levels_; l++) {
+          const auto& files = files_[l];
+          auto it = std::lower_bound(
+              files.begin(), files.end(), start,
+              [this](const FileMetaData* f, const Slice& key) {
+                return user_comparator_->Compare(f->smallest.user_key(), key) <
+                       0;
+              });
+          for (; it != files.end() &&
+                 user_comparator_->Compare((*it)->largest.user_key(), end) < 0;
+               ++it) {
+            FileMetaData* f = *it;
+            if (f->fd.largest_seqno < seq && !f->being_compacted &&
+                covered.insert(f).second) {
+              files_covered_by_range_deletions_.emplace_back(l, f);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
     double blob_garbage_collection_age_cutoff,
     double blob_garbage_collection_force_threshold,
@@ -3849,7 +4386,21 @@ void VersionStorageInfo::AddFile(int level, FileMetaData* f) {
   auto& level_files = files_[level];
   level_files.push_back(f);
 
-  f->refs++;
+  if (!defer_file_refs_) {
+    f->refs++;
+  }
+}
+
+void VersionStorageInfo::RefDeferredFiles() {
+  if (!defer_file_refs_) {
+    return;
+  }
+  for (int level = 0; level < num_levels_; level++) {
+    for (auto* f : files_[level]) {
+      f->refs++;
+    }
+  }
+  defer_file_refs_ = false;
 }
 
 void VersionStorageInfo::AddBlobFile(
@@ -3985,6 +4536,43 @@ void SortFileByOverlappingRatio(
                     });
 }
 
+void SortFileByTombstoneDensity(
+    const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
+    const std::vector<FileMetaData*>& next_level_files, SystemClock* clock,
+    int level, int num_non_empty_levels, uint64_t ttl,
+    std::vector<Fsize>* temp) {
+  // Ties, most importantly among the files without deletions, keep the
+  // kMinOverlappingRatio order.
+  SortFileByOverlappingRatio(icmp, files, next_level_files, clock, level,
+                             num_non_empty_levels, ttl, temp);
+
+  // The read counts keep changing under us, so take a snapshot to sort by.
+  std::vector<uint64_t> num_reads(temp->size());
+  uint64_t total_reads = 0;
+  for (size_t i = 0; i < temp->size(); i++) {
+    const FileSampledStats& stats = (*temp)[i].file->stats;
+    num_reads[i] = stats.num_reads_sampled.load(std::memory_order_relaxed);
+    total_reads += num_reads[i];
+  }
+  const double avg_reads =
+      temp->empty() ? 0 : static_cast<double>(total_reads) / temp->size();
+  std::unordered_map<uint64_t, double> file_to_score;
+  for (size_t i = 0; i < temp->size(); i++) {
+    const FileMetaData* f = (*temp)[i].file;
+    double score = 0;
+    if (f->num_entries > 0 && f->num_deletions > 0) {
+      score = static_cast<double>(f->num_deletions) / f->num_entries *
+              (1 + num_reads[i] / (avg_reads + 1));
+    }
+    file_to_score[f->fd.GetNumber()] = score;
+  }
+  std::stable_sort(temp->begin(), temp->end(),
+                   [&](const Fsize& f1, const Fsize& f2) -> bool {
+                     return file_to_score[f1.file->fd.GetNumber()] >
+                            file_to_score[f2.file->fd.GetNumber()];
+                   });
+}
+
 void SortFileByRoundRobin(const InternalKeyComparator& icmp,
                           std::vector<InternalKey>* compact_cursor,
                           bool level0_non_overlapping, int level,
@@ -4095,6 +4683,11 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
         SortFileByRoundRobin(*internal_comparator_, &compact_cursor_,
                              level0_non_overlapping_, level, &temp);
         break;
+      case kByTombstoneDensity:
+        SortFileByTombstoneDensity(*internal_comparator_, files_[level],
+                                   files_[level + 1], ioptions.clock, level,
+                                   num_non_empty_levels_, options.ttl, &temp);
+        break;
       default:
         assert(false);
     }
@@ -4500,6 +5093,16 @@ uint64_t VersionStorageInfo::NumLevelBytes(int level) const {
   return TotalFileSize(files_[level]);
 }
 
+uint64_t VersionStorageInfo::NumLevelReadsSampled(int level) const {
+  assert(level >= 0);
+  assert(level < num_levels());
+  uint64_t num_reads = 0;
+  for (const auto* f : files_[level]) {
+    num_reads += f->stats.num_reads_sampled.load(std::memory_order_relaxed);
+  }
+  return num_reads;
+}
+
 const char* VersionStorageInfo::LevelSummary(
     LevelSummaryStorage* scratch) const {
   int len = 0;
@@ -5138,6 +5741,7 @@ void VersionSet::Reset() {
   current_version_number_ = 0;
   manifest_writers_.clear();
   manifest_file_size_ = 0;
+  manifest_snapshot_size_ = 0;
   obsolete_files_.clear();
   obsolete_manifests_.clear();
   wals_.Reset();
@@ -5171,6 +5775,19 @@ void VersionSet::AppendVersion(ColumnFamilyData* column_family_data,
   v->next_->prev_ = v;
 }
 
+uint64_t VersionSet::ManifestRollOverSize() const {
+  uint64_t roll_over_size = db_options_->max_manifest_file_size;
+  const uint32_t amp_pct = db_options_->max_manifest_space_amp_pct;
+  if (amp_pct > 0) {
+    const double amp_size = static_cast<double>(manifest_snapshot_size_) *
+                            (100.0 + amp_pct) / 100.0;
+    if (amp_size < static_cast<double>(roll_over_size)) {
+      roll_over_size = static_cast<uint64_t>(amp_size);
+    }
+  }
+  return roll_over_size;
+}
+
 Status VersionSet::ProcessManifestWrites(
     std::deque<ManifestWriter>& writers, InstrumentedMutex* mu,
     FSDirectory* dir_contains_current_file, bool new_descriptor_log,
@@ -5276,6 +5893,8 @@ Status VersionSet::ProcessManifestWrites(
           version = new Version(last_writer->cfd, this, file_options_,
                                 last_writer->mutable_cf_options, io_tracer_,
                                 current_version_number_++);
+          version->cached_rows_epoch_ =
+              last_writer->cfd->current()->GetCachedRowsEpoch();
           versions.push_back(version);
           mutable_cf_options_ptrs.push_back(&last_writer->mutable_cf_options);
           builder_guards.emplace_back(
@@ -5309,23 +5928,13 @@ Status VersionSet::ProcessManifestWrites(
           }
           return s;
         }
+        if (version != nullptr && e->InvalidatesCachedRows()) {
+          ++version->cached_rows_epoch_;
+        }
         batch_edits.push_back(e);
         batch_edits_ts_sz.push_back(edit_ts_sz);
       }
     }
-    for (int i = 0; i < static_cast<int>(versions.size()); ++i) {
-      assert(!builder_guards.empty() &&
-             builder_guards.size() == versions.size());
-      auto* builder = builder_guards[i]->version_builder();
-      Status s = builder->SaveTo(versions[i]->storage_info());
-      if (!s.ok()) {
-        // free up the allocated memory
-        for (auto v : versions) {
-          delete v;
-        }
-        return s;
-      }
-    }
   }
 
 #ifndef NDEBUG
@@ -5365,8 +5974,7 @@ Status VersionSet::ProcessManifestWrites(
 #endif  // NDEBUG
 
   assert(pending_manifest_file_number_ == 0);
-  if (!descriptor_log_ ||
-      manifest_file_size_ > db_options_->max_manifest_file_size) {
+  if (!descriptor_log_ || manifest_file_size_ > ManifestRollOverSize()) {
     TEST_SYNC_POINT("VersionSet::ProcessManifestWrites:BeforeNewManifest");
     new_descriptor_log = true;
   } else {
@@ -5401,15 +6009,32 @@ Status VersionSet::ProcessManifestWrites(
   }
 
   uint64_t new_manifest_file_size = 0;
+  uint64_t new_manifest_snapshot_size = 0;
   Status s;
   IOStatus io_s;
   IOStatus manifest_io_status;
+  bool versions_built = true;
   {
     FileOptions opt_file_opts = fs_->OptimizeForManifestWrite(file_options_);
     mu->Unlock();
     TEST_SYNC_POINT("VersionSet::LogAndApply:WriteManifestStart");
     TEST_SYNC_POINT_CALLBACK("VersionSet::LogAndApply:WriteManifest", nullptr);
-    if (!first_writer.edit_list.front()->IsColumnFamilyManipulation()) {
+    // The new versions are built without the DB mutex, as the builders
+    // reference the base versions and hold the files they add. Only the refs
+    // of the files are taken once the mutex is locked again.
+    for (int i = 0; i < static_cast<int>(versions.size()); ++i) {
+      assert(!builder_guards.empty() &&
+             builder_guards.size() == versions.size());
+      auto* builder = builder_guards[i]->version_builder();
+      versions[i]->storage_info()->DeferFileRefs();
+      s = builder->SaveTo(versions[i]->storage_info());
+      if (!s.ok()) {
+        versions_built = false;
+        break;
+      }
+    }
+    if (s.ok() &&
+        !first_writer.edit_list.front()->IsColumnFamilyManipulation()) {
       for (int i = 0; i < static_cast<int>(versions.size()); ++i) {
         assert(!builder_guards.empty() &&
                builder_guards.size() == versions.size());
@@ -5456,6 +6081,7 @@ Status VersionSet::ProcessManifestWrites(
             new log::Writer(std::move(file_writer), 0, false));
         s = WriteCurrentStateToManifest(curr_state, wal_additions,
                                         descriptor_log_.get(), io_s);
+        new_manifest_snapshot_size = descriptor_log_->file()->GetFileSize();
       } else {
         manifest_io_status = io_s;
         s = io_s;
@@ -5552,6 +6178,9 @@ Status VersionSet::ProcessManifestWrites(
     LogFlush(db_options_->info_log);
     TEST_SYNC_POINT("VersionSet::LogAndApply:WriteManifestDone");
     mu->Lock();
+    for (auto* v : versions) {
+      v->storage_info()->RefDeferredFiles();
+    }
   }
 
   if (s.ok()) {
@@ -5643,6 +6272,9 @@ Status VersionSet::ProcessManifestWrites(
     descriptor_last_sequence_ = max_last_sequence;
     manifest_file_number_ = pending_manifest_file_number_;
     manifest_file_size_ = new_manifest_file_size;
+    if (new_descriptor_log) {
+      manifest_snapshot_size_ = new_manifest_snapshot_size;
+    }
     prev_log_number_ = first_writer.edit_list.front()->GetPrevLogNumber();
   } else {
     std::string version_edits;
@@ -5655,7 +6287,8 @@ Status VersionSet::ProcessManifestWrites(
     for (auto v : versions) {
       delete v;
     }
-    if (manifest_io_status.ok()) {
+    // A new manifest file is not created when the versions fail to build
+    if (manifest_io_status.ok() && versions_built) {
       manifest_file_number_ = pending_manifest_file_number_;
       manifest_file_size_ = new_manifest_file_size;
     }
@@ -5967,13 +6600,29 @@ Status VersionSet::Recover(
         read_only, column_families, const_cast<VersionSet*>(this),
         /*track_missing_files=*/false, no_error_if_files_missing, io_tracer_,
         read_options, EpochNumberRequirement::kMightMissing);
+    handler.SetPipelinedRead(db_options_->max_file_opening_threads > 1);
+    const uint64_t start_micros = clock_->NowMicros();
     handler.Iterate(reader, &log_read_status);
+    const uint64_t iterate_micros = clock_->NowMicros() - start_micros;
     s = handler.status();
     if (s.ok()) {
       log_number = handler.GetVersionEditParams().GetLogNumber();
       current_manifest_file_size = reader.GetReadOffset();
       assert(current_manifest_file_size != 0);
       handler.GetDbId(db_id);
+
+      const uint64_t load_micros = handler.load_tables_micros();
+      const uint64_t versions_micros = handler.create_versions_micros();
+      ROCKS_LOG_INFO(
+          db_options_->info_log,
+          "Replayed %" ROCKSDB_PRIszt " edits of %" PRIu64
+          " bytes of MANIFEST in %" PRIu64
+          " micros, then loaded table files in %" PRIu64
+          " micros and created versions in %" PRIu64 " micros\n",
+          handler.recovered_edits(), current_manifest_file_size,
+          iterate_micros - std::min(iterate_micros,
+                                    load_micros + versions_micros),
+          load_micros, versions_micros);
     }
     if (s.ok()) {
       RecoverEpochNumbers();
@@ -116,9 +116,12 @@ extern bool SomeFileOverlapsRange(const InternalKeyComparator& icmp,
 // Generate LevelFilesBrief from vector<FdWithKeyRange*>
 // Would copy smallest_key and largest_key data to sequential memory
 // arena: Arena used to allocate the memory
+// ucmp: if given, used to decide whether to also fill
+// LevelFilesBrief::largest_key_prefixes
 extern void DoGenerateLevelFilesBrief(LevelFilesBrief* file_level,
                                       const std::vector<FileMetaData*>& files,
-                                      Arena* arena);
+                                      Arena* arena,
+                                      const Comparator* ucmp = nullptr);
 enum EpochNumberRequirement {
   kMightMissing,
   kMustPresent,
@@ -147,6 +150,13 @@ class VersionStorageInfo {
 
   void AddFile(int level, FileMetaData* f);
 
+  // FileMetaData::refs is protected by the DB mutex. The files added while
+  // building the storage info without the mutex are only referenced by
+  // RefDeferredFiles(), which must be called with the mutex held before the
+  // version is used or destroyed.
+  void DeferFileRefs() { defer_file_refs_ = true; }
+  void RefDeferredFiles();
+
   // Resize/Initialize the space for compact_cursor_
   void ResizeCompactCursors(int level) {
     compact_cursor_.resize(level, InternalKey());
@@ -233,6 +243,17 @@ class VersionStorageInfo {
   // REQUIRES: DB mutex held
   void ComputeBottommostFilesMarkedForCompaction(bool allow_ingest_behind);
 
+  // This computes files_covered_by_range_deletions_: the files of levels other
+  // than L0 all of whose keys are covered by a range tombstone in a file of a
+  // higher level, and older than it. Only tombstones visible to all snapshots,
+  // those with a sequence number up to `oldest_snapshot_seqnum`, are
+  // considered, so that the files can be dropped without reading them. To do
+  // no IO, only the tombstones of files whose table reader is open are read.
+  //
+  // REQUIRES: DB mutex held
+  void ComputeFilesCoveredByRangeDeletions(
+      SequenceNumber oldest_snapshot_seqnum);
+
   // This computes files_marked_for_forced_blob_gc_ and is called by
   // ComputeCompactionScore()
   //
@@ -327,6 +348,10 @@ class VersionStorageInfo {
   // Return the combined file size of all files at the specified level.
   uint64_t NumLevelBytes(int level) const;
 
+  // Return the combined number of reads sampled over all files at the
+  // specified level.
+  uint64_t NumLevelReadsSampled(int level) const;
+
   // REQUIRES: This version has been saved (see VersionBuilder::SaveTo)
   const std::vector<FileMetaData*>& LevelFiles(int level) const {
     return files_[level];
@@ -504,6 +529,13 @@ class VersionStorageInfo {
     return bottommost_files_marked_for_compaction_;
   }
 
+  // REQUIRES: ComputeFilesCoveredByRangeDeletions has been called
+  // REQUIRES: DB mutex held during access
+  const autovector<std::pair<int, FileMetaData*>>&
+  FilesCoveredByRangeDeletions() const {
+    return files_covered_by_range_deletions_;
+  }
+
   // REQUIRES: ComputeCompactionScore has been called
   // REQUIRES: DB mutex held during access
   const autovector<std::pair<int, FileMetaData*>>& FilesMarkedForForcedBlobGC()
@@ -606,6 +638,10 @@ class VersionStorageInfo {
     return bottommost_files_mark_threshold_;
   }
 
+  SequenceNumber files_covered_by_range_deletions_threshold() const {
+    return files_covered_by_range_deletions_threshold_;
+  }
+
   // Returns whether any key in [`smallest_key`, `largest_key`] could appear in
   // an older L0 file than `last_l0_idx` or in a greater level than `last_level`
   //
@@ -714,6 +750,13 @@ class VersionStorageInfo {
 
   autovector<std::pair<int, FileMetaData*>> files_marked_for_forced_blob_gc_;
 
+  autovector<std::pair<int, FileMetaData*>> files_covered_by_range_deletions_;
+
+  // The oldest snapshot beyond which more range tombstones could become
+  // visible to all snapshots, and more files covered by them
+  SequenceNumber files_covered_by_range_deletions_threshold_ =
+      kMaxSequenceNumber;
+
   // Threshold for needing to mark another bottommost file. Maintain it so we
   // can quickly check when releasing a snapshot whether more bottommost files
   // became eligible for compaction. It's defined as the min of the max nonzero
@@ -767,6 +810,8 @@ class VersionStorageInfo {
 
   bool finalized_;
 
+  bool defer_file_refs_ = false;
+
   // If set to true, we will run consistency checks even if RocksDB
   // is compiled in release mode
   bool force_consistency_checks_;
@@ -898,9 +943,37 @@ class Version {
            SequenceNumber* seq = nullptr, ReadCallback* callback = nullptr,
            bool* is_blob = nullptr, bool do_merge = true);
 
+  // Returns true if `user_key` is in the key range of a file that may have
+  // entries with a sequence number larger than `seq`, or had before they
+  // were compacted. No file is read.
+  bool MayHaveNewerEntries(const Slice& user_key, SequenceNumber seq) const;
+
+  // The number of version edits up to this version that invalidated the
+  // values cached by user key, see VersionEdit::MarkInvalidatesCachedRows()
+  uint64_t GetCachedRowsEpoch() const { return cached_rows_epoch_; }
+
   void MultiGet(const ReadOptions&, MultiGetRange* range,
                 ReadCallback* callback = nullptr);
 
+  // For the keys of `range` that the filters of any of the files they may be
+  // in do not rule out, sets KeyContext::key_exists and marks them done. No
+  // data blocks are read. See DB::MultiKeyMayExist().
+  // REQUIRES: read_options.ignore_range_deletions
+  Status KeysMayExist(const ReadOptions& read_options, MultiGetRange* range);
+
+  // Reads into the block cache the first data blocks of `ranges` in every
+  // file overlapping them, with one MultiRead() per file, before the ranges
+  // are scanned one after the other. See DB::NewMultiScanIterator().
+  void PrefetchScanRanges(const ReadOptions& read_options,
+                          const std::vector<Range>& ranges);
+
+  // Appends to `anchors` those of the files overlapping `range` that are
+  // strictly inside of it, see TableReader::ApproximateKeyAnchors(), in no
+  // particular order. Returns the total size of the data they delimit.
+  uint64_t ApproximateKeyAnchors(const ReadOptions& read_options,
+                                 const Range& range,
+                                 std::vector<TableReader::Anchor>* anchors);
+
   // Interprets blob_index_slice as a blob reference, and (assuming the
   // corresponding blob file is part of this Version) retrieves the blob and
   // saves it in *value.
@@ -930,6 +1003,14 @@ class Version {
   void MultiGetBlob(const ReadOptions& read_options, MultiGetRange& range,
                     std::unordered_map<uint64_t, BlobReadContexts>& blob_ctxs);
 
+  // Retrieves the blobs of `num_blobs` blob references together, reading
+  // the ones in the same blob file with one MultiRead() in offset order, and
+  // saves them in values[i] with their status in statuses[i].
+  // REQUIRES: num_blobs <= MultiGetContext::MAX_BATCH_SIZE
+  void MultiGetBlob(const ReadOptions& read_options, size_t num_blobs,
+                    const Slice* user_keys, const BlobIndex* blob_indexes,
+                    PinnableSlice* values, Status* statuses) const;
+
   // Loads some stats information from files (if update_stats is set) and
   // populates derived data structures. Call without mutex held. It needs to be
   // called before appending the version to the version set.
@@ -969,6 +1050,12 @@ class Version {
                             const FileMetaData* file_meta,
                             const std::string* fname = nullptr) const;
 
+  // Loads the data blocks of the file at `block_offsets` (ascending) into the
+  // block cache, after the index and filter blocks if the table was not open.
+  Status PrefetchDataBlocks(const ReadOptions& read_options,
+                            const FileMetaData& file_meta,
+                            const std::vector<uint64_t>& block_offsets) const;
+
   // REQUIRES: lock is held
   // On success, *props will be populated with all SSTables' table properties.
   // The keys of `props` are the sst file name, the values of `props` are the
@@ -986,9 +1073,11 @@ class Version {
   Status TablesRangeTombstoneSummary(int max_entries_to_print,
                                      std::string* out_str);
 
-  // REQUIRES: lock is held
+  // REQUIRES: lock is held or this version is referenced
   // On success, "tp" will contains the aggregated table property among
-  // the table properties of all sst files in this version.
+  // the table properties of all sst files in this version. The result is
+  // computed on the first call for each level and cached, since the files of
+  // a version never change.
   Status GetAggregatedTableProperties(
       const ReadOptions& read_options,
       std::shared_ptr<const TableProperties>* tp, int level = -1);
@@ -1069,6 +1158,14 @@ class Version {
       TableCache::TypedHandle* table_handle, uint64_t& num_filter_read,
       uint64_t& num_index_read, uint64_t& num_sst_read);
 
+  // Hints the file system to read ahead the data blocks of all the files, in
+  // all levels, that the keys of `range` may be in according to the filters,
+  // so that their I/O overlaps before the levels are searched one after the
+  // other. Used by MultiGet with ReadOptions::async_io when the coroutine
+  // based MultiGetAsync() is not available.
+  void PrefetchForMultiGet(const ReadOptions& read_options,
+                           MultiGetRange* range);
+
 #ifdef USE_COROUTINES
   // MultiGet using async IO to read data blocks from SST files in parallel
   // within and across levels
@@ -1112,6 +1209,13 @@ class Version {
   uint64_t version_number_;
   std::shared_ptr<IOTracer> io_tracer_;
   bool use_async_io_;
+  uint64_t cached_rows_epoch_ = 0;
+
+  // Aggregated table properties computed by GetAggregatedTableProperties(),
+  // at index 0 for all levels and at index level + 1 for a level
+  port::Mutex aggregated_table_properties_mutex_;
+  std::vector<std::shared_ptr<const TableProperties>>
+      aggregated_table_properties_;
 
   Version(ColumnFamilyData* cfd, VersionSet* vset, const FileOptions& file_opt,
           MutableCFOptions mutable_cf_options,
@@ -1471,6 +1575,10 @@ class VersionSet {
   // Return the size of the current manifest file
   uint64_t manifest_file_size() const { return manifest_file_size_; }
 
+  // The size of the current manifest file past which the next edits go to a
+  // new one
+  uint64_t ManifestRollOverSize() const;
+
   Status GetMetadataForFile(uint64_t number, int* filelevel,
                             FileMetaData** metadata, ColumnFamilyData** cfd);
 
@@ -1656,6 +1764,8 @@ class VersionSet {
 
   // Current size of manifest file
   uint64_t manifest_file_size_;
+  // Size of the snapshot of the live state that starts the manifest file
+  uint64_t manifest_snapshot_size_ = 0;
 
   std::vector<ObsoleteFileInfo> obsolete_files_;
   std::vector<ObsoleteBlobFileInfo> obsolete_blob_files_;
@@ -91,6 +91,41 @@ TEST_F(GenerateLevelFilesBriefTest, Multiple) {
   ASSERT_EQ(0, Compare());
 }
 
+TEST_F(GenerateLevelFilesBriefTest, LargestKeyPrefixes) {
+  Add("a", "b");
+  Add("c", "commonprefix1");
+  Add("commonprefix2", "commonprefix3");
+  Add("commonprefix4", "d");
+  Add("e", "f\xff");
+  DoGenerateLevelFilesBrief(&file_level_, files_, &arena_);
+  ASSERT_EQ(nullptr, file_level_.largest_key_prefixes);
+  LevelFilesBrief without_prefixes = file_level_;
+
+  DoGenerateLevelFilesBrief(&file_level_, files_, &arena_,
+                            BytewiseComparator());
+  ASSERT_EQ(0, Compare());
+  ASSERT_NE(nullptr, file_level_.largest_key_prefixes);
+  ASSERT_EQ(file_level_.largest_key_prefixes[1],
+            file_level_.largest_key_prefixes[2]);
+
+  // Same results as comparing the keys
+  InternalKeyComparator icmp(BytewiseComparator());
+  for (const char* key :
+       {"", "a", "b", "b1", "commonprefix", "commonprefix1", "commonprefix15",
+        "commonprefix3", "commonprefix5", "d", "d0", "f", "f\xff", "g"}) {
+    InternalKey target(key, 100, kTypeValue);
+    ASSERT_EQ(FindFile(icmp, without_prefixes, target.Encode()),
+              FindFile(icmp, file_level_, target.Encode()))
+        << key;
+  }
+  InternalKey target("commonprefix2", 100, kTypeValue);
+  ASSERT_EQ(2, FindFile(icmp, file_level_, target.Encode()));
+
+  DoGenerateLevelFilesBrief(&file_level_, files_, &arena_,
+                            ReverseBytewiseComparator());
+  ASSERT_EQ(nullptr, file_level_.largest_key_prefixes);
+}
+
 class CountingLogger : public Logger {
  public:
   CountingLogger() : log_count(0) {}
@@ -491,6 +526,40 @@ TEST_F(VersionStorageInfoTest, DrainUnnecessaryLevel) {
   ASSERT_GT(vstorage_.CompactionScore(1), 10);
 }
 
+TEST_F(VersionStorageInfoTest, CompactionReadHeat) {
+  ioptions_.level_compaction_dynamic_level_bytes = false;
+  mutable_cf_options_.max_bytes_for_level_base = 10;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 5;
+
+  Add(1, 1U, "1", "2", 30U);   // score 3
+  Add(2, 2U, "1", "2", 200U);  // score 4
+  Add(3, 3U, "1", "2", 125U);  // score 0.5
+  Add(5, 4U, "1", "2", 1000U);
+
+  vstorage_.LevelFiles(1)[0]->stats.num_reads_sampled = 80;
+  vstorage_.LevelFiles(2)[0]->stats.num_reads_sampled = 10;
+  vstorage_.LevelFiles(3)[0]->stats.num_reads_sampled = 10;
+
+  UpdateVersionStorageInfo();
+  vstorage_.ComputeCompactionScore(ioptions_, mutable_cf_options_);
+  ASSERT_EQ(80U, vstorage_.NumLevelReadsSampled(1));
+  ASSERT_EQ(2, vstorage_.CompactionScoreLevel(0));
+  ASSERT_DOUBLE_EQ(4.0, vstorage_.CompactionScore(0));
+  ASSERT_EQ(1, vstorage_.CompactionScoreLevel(1));
+  ASSERT_DOUBLE_EQ(3.0, vstorage_.CompactionScore(1));
+
+  // L1 serves most reads, so it goes first. L3 is not due for compaction no
+  // matter how hot it is.
+  mutable_cf_options_.compaction_read_heat_weight = 1;
+  vstorage_.ComputeCompactionScore(ioptions_, mutable_cf_options_);
+  ASSERT_EQ(1, vstorage_.CompactionScoreLevel(0));
+  ASSERT_DOUBLE_EQ(3.0 * 1.8, vstorage_.CompactionScore(0));
+  ASSERT_EQ(2, vstorage_.CompactionScoreLevel(1));
+  ASSERT_DOUBLE_EQ(4.0 * 1.1, vstorage_.CompactionScore(1));
+  ASSERT_EQ(3, vstorage_.CompactionScoreLevel(2));
+  ASSERT_DOUBLE_EQ(0.5, vstorage_.CompactionScore(2));
+}
+
 TEST_F(VersionStorageInfoTest, EstimateLiveDataSize) {
   // Test whether the overlaps are detected as expected
   Add(1, 1U, "4", "7", 1U);  // Perfect overlap with last level
@@ -520,6 +589,24 @@ TEST_F(VersionStorageInfoTest, EstimateLiveDataSize2) {
   ASSERT_EQ(4U, vstorage_.EstimateLiveDataSize());
 }
 
+TEST_F(VersionStorageInfoTest, DeferFileRefs) {
+  vstorage_.DeferFileRefs();
+  Add(0, 1U, "1", "2", 1U);
+  Add(1, 2U, "3", "4", 1U);
+  ASSERT_EQ(0, vstorage_.LevelFiles(0)[0]->refs);
+  ASSERT_EQ(0, vstorage_.LevelFiles(1)[0]->refs);
+
+  vstorage_.RefDeferredFiles();
+  ASSERT_EQ(1, vstorage_.LevelFiles(0)[0]->refs);
+  ASSERT_EQ(1, vstorage_.LevelFiles(1)[0]->refs);
+
+  // Only once
+  vstorage_.RefDeferredFiles();
+  ASSERT_EQ(1, vstorage_.LevelFiles(0)[0]->refs);
+  Add(1, 3U, "5", "6", 1U);
+  ASSERT_EQ(1, vstorage_.LevelFiles(1)[1]->refs);
+}
+
 TEST_F(VersionStorageInfoTest, SingleLevelBottommostData) {
   // In case of a single level, the oldest L0 file is bottommost. This could be
   // improved in case the L0 files cover disjoint key-ranges.
@@ -12,6 +12,7 @@
 #include "test_util/testutil.h"
 #include "util/overload.h"
 #include "utilities/merge_operators.h"
+#include "utilities/merge_operators/wide_column_update.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -236,6 +237,108 @@ TEST_F(DBWideBasicTest, PutEntityColumnFamily) {
   ASSERT_OK(db_->Write(WriteOptions(), &batch));
 }
 
+TEST_F(DBWideBasicTest, WideColumnProjection) {
+  Options options = GetDefaultOptions();
+
+  constexpr char entity_key[] = "entity";
+  WideColumns entity_columns{{kDefaultWideColumnName, "foo"},
+                             {"attr_name1", "bar"},
+                             {"attr_name2", "baz"},
+                             {"attr_name3", "qux"}};
+
+  constexpr char plain_key[] = "plain";
+  constexpr char plain_value[] = "quux";
+
+  auto verify = [&]() {
+    const std::vector<Slice> projection{"attr_name1", "attr_name3",
+                                        "attr_name4"};
+    const WideColumns expected_columns{entity_columns[1], entity_columns[3]};
+    const WideColumns expected_plain_columns{
+        {kDefaultWideColumnName, plain_value}};
+
+    ReadOptions read_options;
+    read_options.wide_column_projection = &projection;
+
+    {
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               entity_key, &result));
+      ASSERT_EQ(result.columns(), expected_columns);
+    }
+
+    {
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               plain_key, &result));
+      ASSERT_EQ(result.columns(), expected_plain_columns);
+    }
+
+    {
+      // The projection does not stick to a reused result object
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               entity_key, &result));
+      ASSERT_OK(db_->GetEntity(ReadOptions(), db_->DefaultColumnFamily(),
+                               entity_key, &result));
+      ASSERT_EQ(result.columns(), entity_columns);
+    }
+
+    {
+      constexpr size_t num_keys = 2;
+      std::array<Slice, num_keys> keys{{entity_key, plain_key}};
+      std::array<PinnableWideColumns, num_keys> results;
+      std::array<Status, num_keys> statuses;
+
+      db_->MultiGetEntity(read_options, db_->DefaultColumnFamily(), num_keys,
+                          keys.data(), results.data(), statuses.data());
+      ASSERT_OK(statuses[0]);
+      ASSERT_EQ(results[0].columns(), expected_columns);
+      ASSERT_OK(statuses[1]);
+      ASSERT_EQ(results[1].columns(), expected_plain_columns);
+    }
+
+    {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+
+      iter->SeekToFirst();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), entity_key);
+      ASSERT_EQ(iter->columns(), expected_columns);
+      ASSERT_TRUE(iter->value().empty());
+
+      iter->Next();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), plain_key);
+      ASSERT_EQ(iter->columns(), expected_plain_columns);
+      ASSERT_EQ(iter->value(), plain_value);
+
+      iter->Next();
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+    }
+  };
+
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(),
+                           entity_key, entity_columns));
+  ASSERT_OK(db_->Put(WriteOptions(), db_->DefaultColumnFamily(), plain_key,
+                     plain_value));
+
+  // Try reading from memtable
+  verify();
+
+  // Try reading after recovery
+  Close();
+  options.avoid_flush_during_recovery = true;
+  Reopen(options);
+
+  verify();
+
+  // Try reading from storage
+  ASSERT_OK(Flush());
+
+  verify();
+}
+
 TEST_F(DBWideBasicTest, GetEntityAsPinnableAttributeGroups) {
   Options options = GetDefaultOptions();
   CreateAndReopenWithCF({"hot_cf", "cold_cf"}, options);
@@ -1376,6 +1479,128 @@ TEST_F(DBWideMergeV3Test, MergeV3PlainOutput) {
   RunTest(first_expected, second_expected, third_expected);
 }
 
+TEST_F(DBWideBasicTest, MergeColumnUpdates) {
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.merge_operator = MergeOperators::CreateWideColumnUpdateOperator();
+  Reopen(options);
+
+  // Entity base, plain base and no base
+  constexpr char first_key[] = "first";
+  constexpr char second_key[] = "second";
+  constexpr char third_key[] = "third";
+
+  auto write = [&]() {
+    ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(),
+                             first_key,
+                             {{"a", "1"}, {"b", "2"}, {"c", "3"}}));
+    ASSERT_OK(db_->Put(WriteOptions(), second_key, "plain"));
+
+    ASSERT_OK(db_->Merge(WriteOptions(), first_key,
+                         WideColumnUpdateOperator::SetColumn("b", "20")));
+    ASSERT_OK(db_->Merge(WriteOptions(), first_key,
+                         WideColumnUpdateOperator::UpdateColumns(
+                             {{"d", "4"}, {"a", "10"}}, {"c"})));
+    ASSERT_OK(db_->Merge(WriteOptions(), first_key,
+                         WideColumnUpdateOperator::DeleteColumn("a")));
+
+    ASSERT_OK(db_->Merge(WriteOptions(), second_key,
+                         WideColumnUpdateOperator::SetColumn("x", "y")));
+
+    ASSERT_OK(db_->Merge(WriteOptions(), third_key,
+                         WideColumnUpdateOperator::SetColumn(
+                             kDefaultWideColumnName, "v")));
+    ASSERT_OK(db_->Merge(WriteOptions(), third_key,
+                         WideColumnUpdateOperator::SetColumn("z", "w")));
+  };
+
+  const WideColumns first_expected{{"b", "20"}, {"d", "4"}};
+  const WideColumns second_expected{{kDefaultWideColumnName, "plain"},
+                                    {"x", "y"}};
+  const WideColumns third_expected{{kDefaultWideColumnName, "v"}, {"z", "w"}};
+
+  auto verify = [&]() {
+    {
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(ReadOptions(), db_->DefaultColumnFamily(),
+                               first_key, &result));
+      ASSERT_EQ(result.columns(), first_expected);
+    }
+
+    {
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(ReadOptions(), db_->DefaultColumnFamily(),
+                               second_key, &result));
+      ASSERT_EQ(result.columns(), second_expected);
+    }
+
+    {
+      PinnableSlice result;
+      ASSERT_OK(db_->Get(ReadOptions(), db_->DefaultColumnFamily(), third_key,
+                         &result));
+      ASSERT_EQ(result, "v");
+    }
+
+    {
+      std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+
+      iter->SeekToFirst();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), first_key);
+      ASSERT_EQ(iter->columns(), first_expected);
+      ASSERT_TRUE(iter->value().empty());
+
+      iter->Next();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), second_key);
+      ASSERT_EQ(iter->columns(), second_expected);
+      ASSERT_EQ(iter->value(), "plain");
+
+      iter->Next();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), third_key);
+      ASSERT_EQ(iter->columns(), third_expected);
+
+      iter->Next();
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+    }
+  };
+
+  // Memtable
+  write();
+  verify();
+
+  // Base in a table file, operands in the memtable
+  ASSERT_OK(db_->Delete(WriteOptions(), first_key));
+  ASSERT_OK(db_->Delete(WriteOptions(), second_key));
+  ASSERT_OK(db_->Delete(WriteOptions(), third_key));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(),
+                           first_key, {{"a", "1"}, {"b", "2"}, {"c", "3"}}));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->Merge(WriteOptions(), first_key,
+                       WideColumnUpdateOperator::SetColumn("b", "20")));
+  ASSERT_OK(db_->Merge(WriteOptions(), first_key,
+                       WideColumnUpdateOperator::UpdateColumns(
+                           {{"d", "4"}, {"a", "10"}}, {"c"})));
+  ASSERT_OK(db_->Merge(WriteOptions(), first_key,
+                       WideColumnUpdateOperator::DeleteColumn("a")));
+  ASSERT_OK(db_->Put(WriteOptions(), second_key, "plain"));
+  ASSERT_OK(db_->Merge(WriteOptions(), second_key,
+                       WideColumnUpdateOperator::SetColumn("x", "y")));
+  ASSERT_OK(db_->Merge(WriteOptions(), third_key,
+                       WideColumnUpdateOperator::SetColumn(
+                           kDefaultWideColumnName, "v")));
+  ASSERT_OK(db_->Merge(WriteOptions(), third_key,
+                       WideColumnUpdateOperator::SetColumn("z", "w")));
+  verify();
+
+  // Compaction merges the updates into the entities
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  verify();
+}
+
 TEST_F(DBWideBasicTest, CompactionFilter) {
   Options options = GetDefaultOptions();
   options.create_if_missing = true;
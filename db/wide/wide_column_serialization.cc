@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cassert>
 #include <limits>
+#include <utility>
 
 #include "db/wide/wide_columns_helper.h"
 #include "rocksdb/slice.h"
@@ -16,6 +17,26 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// Sorts `updates` by name, stably, and keeps the last update of each column
+void SortUpdates(WideColumnUpdates& updates) {
+  std::stable_sort(
+      updates.begin(), updates.end(),
+      [](const WideColumnUpdate& lhs, const WideColumnUpdate& rhs) {
+        return lhs.name.compare(rhs.name) < 0;
+      });
+
+  size_t num_updates = 0;
+  for (size_t i = 0; i < updates.size(); ++i) {
+    if (i + 1 < updates.size() && updates[i + 1].name == updates[i].name) {
+      continue;
+    }
+    updates[num_updates++] = updates[i];
+  }
+  updates.resize(num_updates);
+}
+}  // namespace
+
 Status WideColumnSerialization::Serialize(const WideColumns& columns,
                                           std::string& output) {
   const size_t num_columns = columns.size();
@@ -129,6 +150,80 @@ Status WideColumnSerialization::Deserialize(Slice& input,
   return Status::OK();
 }
 
+Status WideColumnSerialization::DeserializeProjection(
+    Slice& input, const std::vector<Slice>& projection, WideColumns& columns) {
+  assert(columns.empty());
+  assert(std::is_sorted(projection.cbegin(), projection.cend(),
+                        [](const Slice& lhs, const Slice& rhs) {
+                          return lhs.compare(rhs) < 0;
+                        }));
+
+  uint32_t version = 0;
+  if (!GetVarint32(&input, &version)) {
+    return Status::Corruption("Error decoding wide column version");
+  }
+
+  if (version > kCurrentVersion) {
+    return Status::NotSupported("Unsupported wide column version");
+  }
+
+  uint32_t num_columns = 0;
+  if (!GetVarint32(&input, &num_columns)) {
+    return Status::Corruption("Error decoding number of wide columns");
+  }
+
+  if (!num_columns) {
+    return Status::OK();
+  }
+
+  columns.reserve(std::min<size_t>(num_columns, projection.size()));
+
+  autovector<std::pair<size_t, uint32_t>, 16> column_value_ranges;
+  auto wanted = projection.cbegin();
+  Slice prev_name;
+  size_t pos = 0;
+
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    Slice name;
+    if (!GetLengthPrefixedSlice(&input, &name)) {
+      return Status::Corruption("Error decoding wide column name");
+    }
+
+    if (i > 0 && prev_name.compare(name) >= 0) {
+      return Status::Corruption("Wide columns out of order");
+    }
+    prev_name = name;
+
+    uint32_t value_size = 0;
+    if (!GetVarint32(&input, &value_size)) {
+      return Status::Corruption("Error decoding wide column value size");
+    }
+
+    while (wanted != projection.cend() && wanted->compare(name) < 0) {
+      ++wanted;
+    }
+
+    if (wanted != projection.cend() && *wanted == name) {
+      columns.emplace_back(name, Slice());
+      column_value_ranges.emplace_back(pos, value_size);
+      ++wanted;
+    }
+
+    pos += value_size;
+  }
+
+  if (pos > input.size()) {
+    return Status::Corruption("Error decoding wide column value payload");
+  }
+
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const auto& range = column_value_ranges[i];
+    columns[i].value() = Slice(input.data() + range.first, range.second);
+  }
+
+  return Status::OK();
+}
+
 WideColumns::const_iterator WideColumnSerialization::Find(
     const WideColumns& columns, const Slice& column_name) {
   const auto it =
@@ -144,6 +239,121 @@ WideColumns::const_iterator WideColumnSerialization::Find(
   return it;
 }
 
+Status WideColumnSerialization::SerializeUpdates(WideColumnUpdates& updates,
+                                                 std::string& output) {
+  SortUpdates(updates);
+
+  const size_t num_updates = updates.size();
+  if (num_updates > static_cast<size_t>(std::numeric_limits<uint32_t>::max())) {
+    return Status::InvalidArgument("Too many wide column updates");
+  }
+
+  PutVarint32(&output, kCurrentVersion);
+  PutVarint32(&output, static_cast<uint32_t>(num_updates));
+
+  for (const auto& update : updates) {
+    if (update.name.size() >
+            static_cast<size_t>(std::numeric_limits<uint32_t>::max()) ||
+        update.value.size() >
+            static_cast<size_t>(std::numeric_limits<uint32_t>::max())) {
+      return Status::InvalidArgument("Wide column update too long");
+    }
+
+    output.push_back(static_cast<char>(update.type));
+    PutLengthPrefixedSlice(&output, update.name);
+    if (update.type == WideColumnUpdate::kSet) {
+      PutLengthPrefixedSlice(&output, update.value);
+    }
+  }
+
+  return Status::OK();
+}
+
+Status WideColumnSerialization::DeserializeUpdates(
+    const std::vector<Slice>& operands, WideColumnUpdates& updates) {
+  assert(updates.empty());
+
+  for (const Slice& operand : operands) {
+    Slice input = operand;
+
+    uint32_t version = 0;
+    if (!GetVarint32(&input, &version)) {
+      return Status::Corruption("Error decoding wide column update version");
+    }
+
+    if (version > kCurrentVersion) {
+      return Status::NotSupported("Unsupported wide column update version");
+    }
+
+    uint32_t num_updates = 0;
+    if (!GetVarint32(&input, &num_updates)) {
+      return Status::Corruption("Error decoding number of column updates");
+    }
+
+    for (uint32_t i = 0; i < num_updates; ++i) {
+      if (input.empty()) {
+        return Status::Corruption("Error decoding wide column update type");
+      }
+
+      const uint8_t type = static_cast<uint8_t>(input[0]);
+      input.remove_prefix(1);
+      if (type != WideColumnUpdate::kSet && type != WideColumnUpdate::kDelete) {
+        return Status::Corruption("Unknown wide column update type");
+      }
+
+      WideColumnUpdate update;
+      update.type = static_cast<WideColumnUpdate::Type>(type);
+
+      if (!GetLengthPrefixedSlice(&input, &update.name)) {
+        return Status::Corruption("Error decoding wide column update name");
+      }
+
+      if (update.type == WideColumnUpdate::kSet &&
+          !GetLengthPrefixedSlice(&input, &update.value)) {
+        return Status::Corruption("Error decoding wide column update value");
+      }
+
+      updates.emplace_back(update);
+    }
+  }
+
+  if (operands.size() == 1) {
+    // Already sorted and deduplicated by SerializeUpdates()
+    return Status::OK();
+  }
+
+  // The operands are in order, so the stable sort keeps the newest update of
+  // each column
+  SortUpdates(updates);
+
+  return Status::OK();
+}
+
+void WideColumnSerialization::ApplyUpdates(const WideColumns& base,
+                                           const WideColumnUpdates& updates,
+                                           WideColumns& columns) {
+  assert(columns.empty());
+  columns.reserve(base.size() + updates.size());
+
+  auto base_it = base.cbegin();
+  for (const auto& update : updates) {
+    while (base_it != base.cend() && base_it->name().compare(update.name) < 0) {
+      columns.emplace_back(*base_it);
+      ++base_it;
+    }
+
+    if (base_it != base.cend() && base_it->name() == update.name) {
+      ++base_it;
+    }
+
+    if (update.type == WideColumnUpdate::kSet) {
+      columns.emplace_back(update.name, update.value);
+    }
+  }
+
+  columns.insert(columns.end(), base_it, base.cend());
+}
+
 Status WideColumnSerialization::GetValueOfDefaultColumn(Slice& input,
                                                         Slice& value) {
   WideColumns columns;
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "rocksdb/rocksdb_namespace.h"
 #include "rocksdb/status.h"
@@ -16,6 +17,18 @@ namespace ROCKSDB_NAMESPACE {
 
 class Slice;
 
+// A change to one column of an entity, as carried by the merge operands of the
+// wide-column update merge operator: the column is set to `value`, or deleted.
+struct WideColumnUpdate {
+  enum Type : uint8_t { kSet = 0, kDelete = 1 };
+
+  Type type;
+  Slice name;
+  Slice value;
+};
+
+using WideColumnUpdates = std::vector<WideColumnUpdate>;
+
 // Wide-column serialization/deserialization primitives.
 //
 // The two main parts of the layout are 1) a sorted index containing the column
@@ -47,11 +60,43 @@ class WideColumnSerialization {
 
   static Status Deserialize(Slice& input, WideColumns& columns);
 
+  // Like Deserialize() but only materializes the columns named in
+  // `projection`, which must be sorted in bytewise order. The index is still
+  // walked to find the value offsets, but the values of the other columns are
+  // never touched.
+  static Status DeserializeProjection(Slice& input,
+                                      const std::vector<Slice>& projection,
+                                      WideColumns& columns);
+
   static WideColumns::const_iterator Find(const WideColumns& columns,
                                           const Slice& column_name);
   static Status GetValueOfDefaultColumn(Slice& input, Slice& value);
 
+  // Column updates are serialized as a version and the number of updates,
+  // followed by the type, the length-prefixed name and, for kSet, the
+  // length-prefixed value of each update, sorted by name. `updates` is sorted
+  // in place; of several updates to a column, the last one is kept.
+  static Status SerializeUpdates(WideColumnUpdates& updates,
+                                 std::string& output);
+
+  // Deserializes the column updates of `operands`, oldest first, and combines
+  // them into `updates`, sorted by name, the newest update of each column
+  // winning. The updates point into the operands.
+  static Status DeserializeUpdates(const std::vector<Slice>& operands,
+                                   WideColumnUpdates& updates);
+
+  // Applies sorted `updates` to the sorted `base` columns by merging the two,
+  // without copying any name or value: `columns` points into both.
+  static void ApplyUpdates(const WideColumns& base,
+                           const WideColumnUpdates& updates,
+                           WideColumns& columns);
+
   static constexpr uint32_t kCurrentVersion = 1;
+
+  // Name of the merge operator whose operands are column updates, which
+  // MergeHelper merges into entities itself
+  static constexpr const char* kUpdateMergeOperatorName =
+      "WideColumnUpdateOperator";
 };
 
 }  // namespace ROCKSDB_NAMESPACE
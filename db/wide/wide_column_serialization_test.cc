@@ -124,6 +124,54 @@ TEST(WideColumnSerializationTest, SerializeDeserialize) {
   }
 }
 
+TEST(WideColumnSerializationTest, DeserializeProjection) {
+  WideColumns columns{{kDefaultWideColumnName, "baz"},
+                      {"foo", "bar"},
+                      {"hello", "world"},
+                      {"snafu", "fubar"}};
+  std::string output;
+
+  ASSERT_OK(WideColumnSerialization::Serialize(columns, output));
+
+  {
+    Slice input(output);
+    WideColumns deserialized_columns;
+
+    ASSERT_OK(WideColumnSerialization::DeserializeProjection(
+        input, {"foo", "missing", "snafu"}, deserialized_columns));
+    ASSERT_EQ(deserialized_columns, (WideColumns{columns[1], columns[3]}));
+  }
+
+  {
+    Slice input(output);
+    WideColumns deserialized_columns;
+
+    ASSERT_OK(WideColumnSerialization::DeserializeProjection(
+        input, {kDefaultWideColumnName, "hello"}, deserialized_columns));
+    ASSERT_EQ(deserialized_columns, (WideColumns{columns[0], columns[2]}));
+  }
+
+  {
+    Slice input(output);
+    WideColumns deserialized_columns;
+
+    ASSERT_OK(WideColumnSerialization::DeserializeProjection(
+        input, {}, deserialized_columns));
+    ASSERT_TRUE(deserialized_columns.empty());
+  }
+
+  {
+    // A truncated value payload is detected even if the projection skips it
+    Slice input(output.data(), output.size() - 1);
+    WideColumns deserialized_columns;
+
+    const Status s = WideColumnSerialization::DeserializeProjection(
+        input, {"foo"}, deserialized_columns);
+    ASSERT_TRUE(s.IsCorruption());
+    ASSERT_TRUE(std::strstr(s.getState(), "payload"));
+  }
+}
+
 TEST(WideColumnSerializationTest, SerializeDuplicateError) {
   WideColumns columns{{"foo", "bar"}, {"foo", "baz"}};
   std::string output;
@@ -300,6 +348,41 @@ TEST(WideColumnSerializationTest, DeserializeColumnsOutOfOrder) {
   ASSERT_TRUE(std::strstr(s.getState(), "order"));
 }
 
+TEST(WideColumnSerializationTest, ApplyUpdates) {
+  WideColumnUpdates first_updates{{WideColumnUpdate::kSet, "c", "30"},
+                                  {WideColumnUpdate::kDelete, "a", ""},
+                                  {WideColumnUpdate::kSet, "e", "5"},
+                                  {WideColumnUpdate::kSet, "c", "300"}};
+  std::string first;
+  ASSERT_OK(WideColumnSerialization::SerializeUpdates(first_updates, first));
+  ASSERT_EQ(first_updates.size(), 3);
+
+  WideColumnUpdates second_updates{{WideColumnUpdate::kDelete, "e", ""},
+                                   {WideColumnUpdate::kSet, "b", "20"}};
+  std::string second;
+  ASSERT_OK(WideColumnSerialization::SerializeUpdates(second_updates, second));
+
+  WideColumnUpdates updates;
+  ASSERT_OK(WideColumnSerialization::DeserializeUpdates({first, second},
+                                                        updates));
+  ASSERT_EQ(updates.size(), 4);
+
+  const WideColumns base{{"a", "1"}, {"b", "2"}, {"d", "4"}};
+  WideColumns columns;
+  WideColumnSerialization::ApplyUpdates(base, updates, columns);
+
+  const WideColumns expected{{"b", "20"}, {"c", "300"}, {"d", "4"}};
+  ASSERT_EQ(columns, expected);
+
+  {
+    std::string truncated = first.substr(0, first.size() - 1);
+    WideColumnUpdates result;
+    const Status s =
+        WideColumnSerialization::DeserializeUpdates({truncated}, result);
+    ASSERT_TRUE(s.IsCorruption());
+  }
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -16,6 +16,11 @@ const WideColumns kNoWideColumns;
 Status PinnableWideColumns::CreateIndexForWideColumns() {
   Slice value_copy = value_;
 
+  if (projection_) {
+    return WideColumnSerialization::DeserializeProjection(
+        value_copy, *projection_, columns_);
+  }
+
   return WideColumnSerialization::Deserialize(value_copy, columns_);
 }
 
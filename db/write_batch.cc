@@ -1881,6 +1881,20 @@ class MemTableInserter : public WriteBatch::Handler {
     return *reinterpret_cast<HintMap*>(&hint_);
   }
 
+  // Returns the insert hint to pass to mem->Add(), or nullptr if this batch
+  // does not keep one.
+  void** GetHint(MemTable* mem) {
+    if (!hint_per_batch_) {
+      return nullptr;
+    }
+    if (!concurrent_memtable_writes_) {
+      // Serialized writers share the hint of the memtable itself, which keeps
+      // its position from one batch to the next.
+      return mem->serial_insert_hint();
+    }
+    return &GetHintMap()[mem];
+  }
+
   MemPostInfoMap& GetPostMap() {
     assert(concurrent_memtable_writes_);
     if (!post_info_created_) {
@@ -1983,7 +1997,7 @@ class MemTableInserter : public WriteBatch::Handler {
       reinterpret_cast<MemPostInfoMap*>(&mem_post_info_map_)->~MemPostInfoMap();
     }
     if (hint_created_) {
-      for (auto iter : GetHintMap()) {
+      for (auto iter : *reinterpret_cast<HintMap*>(&hint_)) {
         delete[] reinterpret_cast<char*>(iter.second);
       }
       reinterpret_cast<HintMap*>(&hint_)->~HintMap();
@@ -2011,6 +2025,9 @@ class MemTableInserter : public WriteBatch::Handler {
   }
 
   void set_log_number_ref(uint64_t log) { log_number_ref_ = log; }
+  void set_hint_per_batch(bool hint_per_batch) {
+    hint_per_batch_ = hint_per_batch;
+  }
   void set_prot_info(const WriteBatch::ProtectionInfo* prot_info) {
     prot_info_ = prot_info;
     prot_info_idx_ = 0;
@@ -2107,7 +2124,7 @@ class MemTableInserter : public WriteBatch::Handler {
       ret_status =
           mem->Add(sequence_, value_type, key, value, kv_prot_info,
                    concurrent_memtable_writes_, get_post_process_info(mem),
-                   hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                   GetHint(mem));
     } else if (moptions->inplace_callback == nullptr ||
                value_type != kTypeValue) {
       assert(!concurrent_memtable_writes_);
@@ -2272,7 +2289,7 @@ class MemTableInserter : public WriteBatch::Handler {
     ret_status =
         mem->Add(sequence_, delete_type, key, value, kv_prot_info,
                  concurrent_memtable_writes_, get_post_process_info(mem),
-                 hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                 GetHint(mem));
     if (UNLIKELY(ret_status.IsTryAgain())) {
       assert(seq_per_batch_);
       const bool kBatchBoundary = true;
@@ -2640,7 +2657,21 @@ class MemTableInserter : public WriteBatch::Handler {
       }
     }
 
-    if (!perform_merge) {
+    if (!perform_merge && moptions->inplace_update_support &&
+        moptions->inplace_merge_operands) {
+      assert(ret_status.ok());
+      assert(!concurrent_memtable_writes_);
+      // Fold the merge operand into the latest one of the key, if possible
+      if (kv_prot_info != nullptr) {
+        auto mem_kv_prot_info =
+            kv_prot_info->StripC(column_family_id).ProtectS(sequence_);
+        ret_status =
+            mem->UpdateMerge(sequence_, key, value, &mem_kv_prot_info);
+      } else {
+        ret_status = mem->UpdateMerge(sequence_, key, value,
+                                      nullptr /* kv_prot_info */);
+      }
+    } else if (!perform_merge) {
       assert(ret_status.ok());
       // Add merge operand to memtable
       if (kv_prot_info != nullptr) {
@@ -2648,11 +2679,13 @@ class MemTableInserter : public WriteBatch::Handler {
             kv_prot_info->StripC(column_family_id).ProtectS(sequence_);
         ret_status =
             mem->Add(sequence_, kTypeMerge, key, value, &mem_kv_prot_info,
-                     concurrent_memtable_writes_, get_post_process_info(mem));
+                     concurrent_memtable_writes_, get_post_process_info(mem),
+                     GetHint(mem));
       } else {
         ret_status = mem->Add(
             sequence_, kTypeMerge, key, value, nullptr /* kv_prot_info */,
-            concurrent_memtable_writes_, get_post_process_info(mem));
+            concurrent_memtable_writes_, get_post_process_info(mem),
+            GetHint(mem));
       }
     }
 
@@ -3025,6 +3058,7 @@ Status WriteBatchInternal::InsertInto(
     }
     SetSequence(w->multi_batch.batches[0], inserter.sequence());
     inserter.set_log_number_ref(w->log_ref);
+    inserter.set_hint_per_batch(w->memtable_insert_hint_per_batch);
     inserter.set_prot_info(w->multi_batch.batches[0]->prot_info_.get());
     w->status = w->multi_batch.batches[0]->Iterate(&inserter);
     if (!w->status.ok()) {
@@ -3071,6 +3105,91 @@ Status WriteBatchInternal::InsertInto(
   return s;
 }
 
+Status WriteBatchInternal::InsertInto(
+    const WriteBatch* batch, size_t begin, size_t end, SequenceNumber sequence,
+    ColumnFamilyMemTables* memtables, FlushScheduler* flush_scheduler,
+    TrimHistoryScheduler* trim_history_scheduler,
+    bool ignore_missing_column_families, uint64_t log_ref, DB* db,
+    bool hint_per_batch) {
+  // Protection info is indexed from the first record of the batch, so it can
+  // only be used when the whole batch is inserted.
+  const bool whole_batch = begin == WriteBatchInternal::kHeader &&
+                           end == WriteBatchInternal::ByteSize(batch);
+  assert(whole_batch || batch->prot_info_ == nullptr);
+  MemTableInserter inserter(
+      sequence, memtables, flush_scheduler, trim_history_scheduler,
+      ignore_missing_column_families, 0 /* recovery_log_number */, db,
+      true /* concurrent_memtable_writes */,
+      whole_batch ? batch->prot_info_.get() : nullptr,
+      nullptr /* has_valid_writes */, false /* seq_per_batch */,
+      true /* batch_per_txn */, hint_per_batch);
+  inserter.set_log_number_ref(log_ref);
+  Status s = Iterate(batch, &inserter, begin, end);
+  inserter.PostProcess();
+  return s;
+}
+
+bool WriteBatchInternal::SplitIntoRanges(
+    const WriteBatch* batch, size_t range_bytes,
+    std::vector<std::pair<size_t, uint32_t>>* ranges) {
+  assert(range_bytes > 0);
+  if (batch->prot_info_ != nullptr ||
+      batch->rep_.size() <= WriteBatchInternal::kHeader + range_bytes) {
+    return false;
+  }
+  std::vector<std::pair<size_t, uint32_t>> result;
+  result.emplace_back(WriteBatchInternal::kHeader, 0);
+  Slice input(batch->rep_.data() + WriteBatchInternal::kHeader,
+              batch->rep_.size() - WriteBatchInternal::kHeader);
+  Slice key, value, blob, xid;
+  char tag = 0;
+  uint32_t column_family = 0;
+  uint32_t seq_offset = 0;
+  while (!input.empty()) {
+    const size_t offset = batch->rep_.size() - input.size();
+    if (offset - result.back().first >= range_bytes) {
+      result.emplace_back(offset, seq_offset);
+    }
+    Status s = ReadRecordFromWriteBatch(&input, &tag, &column_family, &key,
+                                        &value, &blob, &xid);
+    if (!s.ok()) {
+      return false;
+    }
+    switch (tag) {
+      case kTypeColumnFamilyValue:
+      case kTypeValue:
+      case kTypeColumnFamilyDeletion:
+      case kTypeDeletion:
+      case kTypeColumnFamilySingleDeletion:
+      case kTypeSingleDeletion:
+      case kTypeColumnFamilyRangeDeletion:
+      case kTypeRangeDeletion:
+      case kTypeColumnFamilyMerge:
+      case kTypeMerge:
+      case kTypeColumnFamilyBlobIndex:
+      case kTypeBlobIndex:
+      case kTypeTitanColumnFamilyBlobIndex:
+      case kTypeTitanBlobIndex:
+      case kTypeColumnFamilyWideColumnEntity:
+      case kTypeWideColumnEntity:
+        // Every data record consumes one sequence number.
+        ++seq_offset;
+        break;
+      case kTypeLogData:
+        break;
+      default:
+        // Transaction markers and Noops delimit sub-batches, which need the
+        // whole batch to be inserted by one MemTableInserter.
+        return false;
+    }
+  }
+  if (result.size() <= 1) {
+    return false;
+  }
+  ranges->insert(ranges->end(), result.begin(), result.end());
+  return true;
+}
+
 Status WriteBatchInternal::InsertInto(
     const WriteBatch* batch, ColumnFamilyMemTables* memtables,
     FlushScheduler* flush_scheduler,
@@ -3249,6 +3368,46 @@ Status WriteBatchInternal::Append(WriteBatch* dst, const WriteBatch* src,
   return Status::OK();
 }
 
+Status WriteBatchInternal::AppendReference(WriteBatch* dst,
+                                           const WriteBatch* src,
+                                           std::vector<Slice>* parts) {
+  assert(dst->prot_info_ == nullptr || dst->prot_info_->entries_.empty());
+  if (src->prot_info_ != nullptr) {
+    if (src->prot_info_->entries_.size() != src->Count()) {
+      return Status::Corruption(
+          "Write batch has inconsistent count and number of checksums");
+    }
+    Status s = src->VerifyChecksum();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  size_t src_len;
+  int src_count;
+  uint32_t src_flags;
+
+  const SavePoint& batch_end = src->GetWalTerminationPoint();
+
+  if (!batch_end.is_cleared()) {
+    src_len = batch_end.size - WriteBatchInternal::kHeader;
+    src_count = batch_end.count;
+    src_flags = batch_end.content_flags;
+  } else {
+    src_len = src->rep_.size() - WriteBatchInternal::kHeader;
+    src_count = Count(src);
+    src_flags = src->content_flags_.load(std::memory_order_relaxed);
+  }
+
+  SetCount(dst, Count(dst) + src_count);
+  assert(src->rep_.size() >= WriteBatchInternal::kHeader);
+  parts->emplace_back(src->rep_.data() + WriteBatchInternal::kHeader, src_len);
+  dst->content_flags_.store(
+      dst->content_flags_.load(std::memory_order_relaxed) | src_flags,
+      std::memory_order_relaxed);
+  return Status::OK();
+}
+
 size_t WriteBatchInternal::AppendedByteSize(size_t leftByteSize,
                                             size_t rightByteSize) {
   if (leftByteSize == 0 || rightByteSize == 0) {
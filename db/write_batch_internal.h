@@ -219,6 +219,28 @@ class WriteBatchInternal {
                            bool batch_per_txn = true,
                            bool hint_per_batch = false);
 
+  // Concurrently inserts the records in [begin, end) of batch into the
+  // memtables, the first of them with sequence number `sequence`. The range
+  // is either the whole batch or one produced by SplitIntoRanges().
+  static Status InsertInto(const WriteBatch* batch, size_t begin, size_t end,
+                           SequenceNumber sequence,
+                           ColumnFamilyMemTables* memtables,
+                           FlushScheduler* flush_scheduler,
+                           TrimHistoryScheduler* trim_history_scheduler,
+                           bool ignore_missing_column_families,
+                           uint64_t log_ref, DB* db,
+                           bool hint_per_batch = false);
+
+  // Cuts batch into consecutive ranges of records of roughly `range_bytes`
+  // bytes each, which can be inserted into the memtables independently. For
+  // every range, appends its begin offset and the number of sequence numbers
+  // consumed by the records before it to `ranges`. Returns false, leaving
+  // `ranges` untouched, if the batch has a single range or can't be split,
+  // i.e. it carries per-key protection info or non data records such as
+  // transaction markers.
+  static bool SplitIntoRanges(const WriteBatch* batch, size_t range_bytes,
+                              std::vector<std::pair<size_t, uint32_t>>* ranges);
+
   // Appends src write batch to dst write batch and updates count in dst
   // write batch. Returns OK if the append is successful. Checks number of
   // checksum against count in dst and src write batches, and returns Corruption
@@ -228,6 +250,13 @@ class WriteBatchInternal {
 
   static Status AppendContents(WriteBatch* dst, const Slice& content);
 
+  // Like Append(dst, src, /*WAL_only=*/true), but src's records are not
+  // copied: dst only gets its count and content flags updated and a Slice
+  // referencing the records is added to `parts`. src is verified against its
+  // own checksums instead of through dst. src must outlive `parts`.
+  static Status AppendReference(WriteBatch* dst, const WriteBatch* src,
+                                std::vector<Slice>* parts);
+
   // Returns the byte size of appending a WriteBatch with ByteSize
   // leftByteSize and a WriteBatch with ByteSize rightByteSize
   static size_t AppendedByteSize(size_t leftByteSize, size_t rightByteSize);
@@ -473,6 +473,68 @@ TEST_F(WriteBatchTest, PrepareCommit) {
       handler.seen);
 }
 
+TEST_F(WriteBatchTest, SplitIntoRanges) {
+  WriteBatch batch;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(batch.Put("key" + std::to_string(i), std::string(20, 'v')));
+    if (i % 10 == 0) {
+      batch.PutLogData("blob");
+      ASSERT_OK(batch.Delete("key" + std::to_string(i)));
+    }
+  }
+  std::vector<std::pair<size_t, uint32_t>> ranges;
+  ASSERT_FALSE(WriteBatchInternal::SplitIntoRanges(
+      &batch, WriteBatchInternal::ByteSize(&batch), &ranges));
+  ASSERT_TRUE(ranges.empty());
+  ASSERT_TRUE(WriteBatchInternal::SplitIntoRanges(&batch, 128, &ranges));
+  ASSERT_GT(ranges.size(), 1u);
+  ASSERT_EQ(WriteBatchInternal::kHeader, ranges[0].first);
+  ASSERT_EQ(0u, ranges[0].second);
+
+  TestHandler whole;
+  ASSERT_OK(batch.Iterate(&whole));
+  std::string seen;
+  uint32_t num_records = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const size_t end = i + 1 < ranges.size()
+                           ? ranges[i + 1].first
+                           : WriteBatchInternal::ByteSize(&batch);
+    ASSERT_GT(end, ranges[i].first);
+    TestHandler handler;
+    ASSERT_OK(
+        WriteBatchInternal::Iterate(&batch, &handler, ranges[i].first, end));
+    ASSERT_EQ(num_records, ranges[i].second);
+    seen.append(handler.seen);
+    // Every record but the LogData names a key.
+    for (size_t pos = handler.seen.find("key"); pos != std::string::npos;
+         pos = handler.seen.find("key", pos + 1)) {
+      ++num_records;
+    }
+  }
+  ASSERT_EQ(whole.seen, seen);
+  ASSERT_EQ(batch.Count(), num_records);
+
+  // Transaction markers confine the batch to one MemTableInserter.
+  WriteBatch prepared;
+  ASSERT_OK(WriteBatchInternal::InsertNoop(&prepared));
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(prepared.Put("key" + std::to_string(i), std::string(20, 'v')));
+  }
+  ASSERT_OK(WriteBatchInternal::MarkEndPrepare(&prepared, Slice("xid1")));
+  ASSERT_FALSE(WriteBatchInternal::SplitIntoRanges(&prepared, 128, &ranges));
+
+  // So does per-key protection info.
+  WriteBatch protected_batch(0 /* reserved_bytes */, 0 /* max_bytes */,
+                             8 /* protection_bytes_per_key */,
+                             0 /* default_cf_ts_sz */);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(
+        protected_batch.Put("key" + std::to_string(i), std::string(20, 'v')));
+  }
+  ASSERT_FALSE(
+      WriteBatchInternal::SplitIntoRanges(&protected_batch, 128, &ranges));
+}
+
 // It requires more than 30GB of memory to run the test. With single memory
 // allocation of more than 30GB.
 // Not all platform can run it. Also it runs a long time. So disable it.
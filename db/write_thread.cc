@@ -5,11 +5,14 @@
 
 #include "db/write_thread.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 #include "db/column_family.h"
+#include "db/write_batch_internal.h"
 #include "monitoring/perf_context_imp.h"
+#include "monitoring/statistics_impl.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
 #include "util/random.h"
@@ -26,10 +29,17 @@ WriteThread::WriteThread(const ImmutableDBOptions& db_options)
       enable_pipelined_write_(db_options.enable_pipelined_write),
       max_write_batch_group_size_bytes(
           db_options.max_write_batch_group_size_bytes),
+      target_wal_latency_us_(
+          db_options.two_write_queues
+              ? 0
+              : db_options.write_group_target_wal_latency_us),
+      group_size_limit_bytes_(max_write_batch_group_size_bytes),
+      group_size_limit_writers_(0),
       newest_writer_(nullptr),
       newest_memtable_writer_(nullptr),
       last_sequence_(0),
       write_stall_dummy_(),
+      commit_queue_(max_yield_usec_),
       stall_mu_(),
       stall_cv_(&stall_mu_) {}
 
@@ -445,16 +455,21 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
   // Allow the group to grow up to a maximum size, but if the
   // original write is small, limit the growth so we do not slow
   // down the small write too much.
-  size_t max_size = max_write_batch_group_size_bytes;
-  const uint64_t min_batch_size_bytes = max_write_batch_group_size_bytes / 8;
+  const uint64_t max_group_size_bytes = GetGroupSizeLimitBytes();
+  size_t max_size = max_group_size_bytes;
+  const uint64_t min_batch_size_bytes = max_group_size_bytes / 8;
   if (size <= min_batch_size_bytes) {
     max_size = size + min_batch_size_bytes;
   }
+  const bool adaptive_limits =
+      max_group_size_bytes < max_write_batch_group_size_bytes;
+  const size_t max_writers = GetGroupSizeLimitWriters();
 
   leader->write_group = write_group;
   write_group->leader = leader;
   write_group->last_writer = leader;
   write_group->size = 1;
+  write_group->size_limited = false;
   Writer* newest_writer = newest_writer_.load(std::memory_order_acquire);
 
   // This is safe regardless of any db mutex status of the caller. Previous
@@ -509,9 +524,15 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
       break;
     }
 
+    if (max_writers > 0 && write_group->size >= max_writers) {
+      write_group->size_limited = true;
+      break;
+    }
+
     auto batch_size = WriteBatchInternal::ByteSize(w->multi_batch.batches);
     if (size + batch_size > max_size) {
       // Do not make batch too big
+      write_group->size_limited = adaptive_limits;
       break;
     }
 
@@ -525,6 +546,55 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
   return size;
 }
 
+void WriteThread::RecordWALWriteLatency(const WriteGroup& write_group,
+                                        uint64_t micros) {
+  assert(adaptive_group_size());
+  // Number of samples the p99 is estimated over.
+  constexpr size_t kWindowSamples = 128;
+  // Slow samples allowed in a window while staying within the p99 target.
+  constexpr size_t kMaxSlowSamples = kWindowSamples / 100;
+  const uint64_t min_limit_bytes =
+      std::min<uint64_t>(max_write_batch_group_size_bytes, 4 << 10);
+
+  ++latency_window_samples_;
+  if (micros > target_wal_latency_us_) {
+    ++latency_window_slow_samples_;
+  }
+  latency_window_max_writers_ =
+      std::max(latency_window_max_writers_, write_group.size);
+  latency_window_size_limited_ |= write_group.size_limited;
+
+  uint64_t limit_bytes = GetGroupSizeLimitBytes();
+  size_t limit_writers = GetGroupSizeLimitWriters();
+  if (latency_window_slow_samples_ > kMaxSlowSamples) {
+    // Over target: halve the limits right away rather than waiting for the
+    // window to fill up.
+    limit_bytes = std::max(min_limit_bytes, limit_bytes / 2);
+    limit_writers = std::max<size_t>(1, latency_window_max_writers_ / 2);
+  } else if (latency_window_samples_ >= kWindowSamples &&
+             latency_window_size_limited_) {
+    // Within target while writers are being held back: grow the limits by a
+    // quarter, lifting the writer limit once the byte limit is back at its
+    // configured maximum.
+    limit_bytes = std::min(max_write_batch_group_size_bytes,
+                           limit_bytes + std::max<uint64_t>(
+                                             limit_bytes / 4, min_limit_bytes));
+    if (limit_bytes == max_write_batch_group_size_bytes) {
+      limit_writers = 0;
+    } else if (limit_writers > 0) {
+      limit_writers += std::max<size_t>(1, limit_writers / 4);
+    }
+  } else if (latency_window_samples_ < kWindowSamples) {
+    return;
+  }
+  group_size_limit_bytes_.store(limit_bytes, std::memory_order_relaxed);
+  group_size_limit_writers_.store(limit_writers, std::memory_order_relaxed);
+  latency_window_samples_ = 0;
+  latency_window_slow_samples_ = 0;
+  latency_window_max_writers_ = 0;
+  latency_window_size_limited_ = false;
+}
+
 void WriteThread::EnterAsMemTableWriter(Writer* leader,
                                         WriteGroup* write_group) {
   assert(leader != nullptr);
@@ -640,6 +710,7 @@ bool WriteThread::CompleteParallelMemTableWriter(Writer* w) {
 
   if (write_group->running-- > 1) {
     // we're not the last one
+    PERF_TIMER_GUARD(write_parallel_memtable_wait_nanos);
     AwaitState(w, STATE_COMPLETED, &cpmtw_ctx);
     return false;
   }
@@ -844,67 +915,209 @@ void WriteThread::WaitForMemTableWriters() {
   newest_memtable_writer_.store(nullptr);
 }
 
-RequestQueue::RequestQueue() {}
+RequestQueue::RequestQueue(uint64_t max_yield_usec)
+    : max_yield_usec_(max_yield_usec),
+      head_(0),
+      tail_(0),
+      publishing_(false),
+      blocked_waiters_(0) {
+  for (auto& slot : ring_) {
+    slot.store(0, std::memory_order_relaxed);
+  }
+}
 
-RequestQueue::~RequestQueue() {}
+RequestQueue::~RequestQueue() {
+  assert(head_.load(std::memory_order_relaxed) ==
+         tail_.load(std::memory_order_relaxed));
+}
 
 void RequestQueue::Enter(CommitRequest* req) {
-  std::unique_lock<std::mutex> guard(commit_mu_);
-  requests_.push_back(req);
+  assert((reinterpret_cast<uintptr_t>(req) & kHelperMask) == 0);
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  auto& slot = ring_[tail % kCapacity];
+  // The ring is only full with kCapacity writers in flight. Their commits
+  // don't depend on the leader, so just wait for the oldest one.
+  while (slot.load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+  slot.store(reinterpret_cast<uintptr_t>(req), std::memory_order_release);
+  tail_.store(tail + 1, std::memory_order_release);
+}
+
+bool RequestQueue::FrontPublishable() {
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  auto& slot = ring_[head % kCapacity];
+  uintptr_t value = slot.load(std::memory_order_acquire);
+  if (value == 0 || (value & kHelperMask) != 0) {
+    return false;
+  }
+  // Without publishing_, another thread may commit the front request and
+  // its owner free it, so pin it like HelpFront() before looking at it.
+  if (!slot.compare_exchange_strong(value, value + 1,
+                                    std::memory_order_acq_rel)) {
+    return false;
+  }
+  const bool pending = RequestOf(value)->writer->HasPendingWB();
+  slot.fetch_sub(1, std::memory_order_acq_rel);
+  return !pending;
+}
+
+void RequestQueue::TryPublish(std::atomic<uint64_t>* commit_sequence) {
+  bool committed_any = false;
+  // Pairs with the fence below: either we see the writer that finished the
+  // front request, or it sees that we released publishing_ and retries.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  while (!publishing_.exchange(true, std::memory_order_acquire)) {
+    while (true) {
+      const uint64_t head = head_.load(std::memory_order_relaxed);
+      auto& slot = ring_[head % kCapacity];
+      uintptr_t value = slot.load(std::memory_order_acquire);
+      if (value == 0 || (value & kHelperMask) != 0) {
+        break;
+      }
+      CommitRequest* front = RequestOf(value);
+      if (front->writer->HasPendingWB()) {
+        break;
+      }
+      const uint64_t commit_lsn = front->commit_lsn;
+      // Fails if a helper pinned the slot in the meantime.
+      if (!slot.compare_exchange_strong(value, 0, std::memory_order_acq_rel)) {
+        break;
+      }
+      commit_sequence->store(commit_lsn, std::memory_order_release);
+      head_.store(head + 1, std::memory_order_release);
+      // The owner may return and free the request as soon as it sees this.
+      front->committed.store(true, std::memory_order_release);
+      committed_any = true;
+    }
+    publishing_.store(false, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!FrontPublishable()) {
+      break;
+    }
+  }
+  if (committed_any && blocked_waiters_.load(std::memory_order_acquire) > 0) {
+    std::lock_guard<std::mutex> guard(wait_mu_);
+    wait_cv_.notify_all();
+  }
+}
+
+bool RequestQueue::HelpFront(CommitRequest* req) {
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  auto& slot = ring_[head % kCapacity];
+  uintptr_t value = slot.load(std::memory_order_acquire);
+  if (value == 0 || RequestOf(value) == req ||
+      (value & kHelperMask) == kHelperMask) {
+    return false;
+  }
+  // Pin the front request so that it can't be committed while we steal.
+  if (!slot.compare_exchange_strong(value, value + 1,
+                                    std::memory_order_acq_rel)) {
+    return false;
+  }
+  WriteThread::Writer* front = RequestOf(value)->writer;
+  PERF_TIMER_GUARD(write_help_other_writers_nanos);
+  bool stolen = front->ConsumableOnOtherThreads() && front->StealOne();
+  slot.fetch_sub(1, std::memory_order_acq_rel);
+  return stolen;
 }
 
 void RequestQueue::CommitSequenceAwait(CommitRequest* req,
                                        std::atomic<uint64_t>* commit_sequence) {
-  std::unique_lock<std::mutex> guard(commit_mu_);
-  while (!requests_.empty() && requests_.front() != req && !req->committed) {
-    // When the subsequent commit finds that the front writer has not yet
-    // submitted, it will help the front writer to perform some tasks
-    auto front = requests_.front()->writer;
-    if (front->ConsumableOnOtherThreads()) {
-      auto claimed = front->Claim();
-      if (claimed < front->multi_batch.batches.size()) {
-        guard.unlock();
-        front->ConsumeOne(claimed);
-        guard.lock();
-        continue;
-      }
+  // Like WriteThread::AwaitState: spin briefly, then yield for up to
+  // max_yield_usec_, then block. Every round first commits what it can and
+  // helps the front writer, which is where the time usually goes.
+  auto spin_begin = std::chrono::steady_clock::now();
+  uint32_t tries = 0;
+  while (!req->committed.load(std::memory_order_acquire)) {
+    TryPublish(commit_sequence);
+    if (req->committed.load(std::memory_order_acquire)) {
+      break;
+    }
+    if (HelpFront(req)) {
+      // Helping took a while, restart the wait.
+      spin_begin = std::chrono::steady_clock::now();
+      tries = 0;
+      continue;
+    }
+    if (tries < 200) {
+      ++tries;
+      port::AsmVolatilePause();
+    } else if (std::chrono::steady_clock::now() - spin_begin <
+               std::chrono::microseconds(max_yield_usec_)) {
+      std::this_thread::yield();
     } else {
-      // The front writer may be waiting for this helper writer
-      commit_cv_.notify_all();
+      PERF_TIMER_GUARD(write_thread_wait_nanos);
+      std::unique_lock<std::mutex> guard(wait_mu_);
+      blocked_waiters_.fetch_add(1, std::memory_order_seq_cst);
+      // Finishing the front request always leads to a TryPublish() that
+      // wakes us up. The timeout is only a safety net.
+      wait_cv_.wait_for(guard, std::chrono::milliseconds(1), [req] {
+        return req->committed.load(std::memory_order_acquire);
+      });
+      blocked_waiters_.fetch_sub(1, std::memory_order_relaxed);
+      spin_begin = std::chrono::steady_clock::now();
+      tries = 0;
     }
-    commit_cv_.wait(guard);
   }
-  if (req->committed) {
-    return;
-  } else if (requests_.front() == req) {
-    // As the front writer, some write tasks can be stolen by other writers.
-    // Wait for them to finish.
-    while (req->writer->HasPendingWB()) {
-      commit_cv_.wait(guard);
-    }
-    while (!requests_.empty() && !requests_.front()->writer->HasPendingWB()) {
-      CommitRequest* current = requests_.front();
-      commit_sequence->store(current->commit_lsn, std::memory_order_release);
-      current->committed = true;
-      requests_.pop_front();
+}
+
+void WriteThread::MultiBatch::PrepareTasks(size_t split_bytes) {
+  tasks.clear();
+  std::vector<std::pair<size_t, uint32_t>> ranges;
+  pending_tasks_per_batch.reset(new std::atomic<size_t>[batches.size()]);
+  for (size_t idx = 0; idx < batches.size(); idx++) {
+    WriteBatch* b = batches[idx];
+    const size_t size = WriteBatchInternal::ByteSize(b);
+    const size_t first_task = tasks.size();
+    ranges.clear();
+    if (split_bytes > 0 &&
+        WriteBatchInternal::SplitIntoRanges(b, split_bytes, &ranges)) {
+      for (size_t i = 0; i < ranges.size(); i++) {
+        const size_t end = i + 1 < ranges.size() ? ranges[i + 1].first : size;
+        tasks.push_back({b, ranges[i].first, end, ranges[i].second, idx});
+      }
+    } else {
+      tasks.push_back({b, WriteBatchInternal::kHeader, size, 0, idx});
     }
-    commit_cv_.notify_all();
+    pending_tasks_per_batch[idx].store(tasks.size() - first_task,
+                                       std::memory_order_relaxed);
   }
+  task_deque.Reset(static_cast<uint32_t>(tasks.size()));
+  pending_wb_cnt.store(tasks.size(), std::memory_order_release);
 }
 
-void WriteThread::Writer::ConsumeOne(size_t claimed) {
-  assert(claimed < multi_batch.batches.size());
+void WriteThread::Writer::ConsumeOne(size_t task_idx, bool stolen) {
+  assert(task_idx < multi_batch.tasks.size());
+  const MultiBatch::Task& task = multi_batch.tasks[task_idx];
   ColumnFamilyMemTablesImpl memtables(multi_batch.version_set);
   Status s = WriteBatchInternal::InsertInto(
-      multi_batch.batches[claimed], &memtables, multi_batch.flush_scheduler,
-      multi_batch.trim_history_scheduler,
-      multi_batch.ignore_missing_column_families, 0, this->log_ref,
-      multi_batch.db, true);
+      task.batch, task.begin, task.end,
+      WriteBatchInternal::Sequence(task.batch) + task.seq_offset, &memtables,
+      multi_batch.flush_scheduler, multi_batch.trim_history_scheduler,
+      multi_batch.ignore_missing_column_families, this->log_ref,
+      multi_batch.db, memtable_insert_hint_per_batch);
   if (!s.ok()) {
     std::lock_guard<SpinMutex> guard(this->status_lock);
     this->status = s;
-  } else if (post_callback) {
-    post_callback->Callback(sequence);
+  }
+  // Invoked once per batch, by whoever finishes its last pending range, so
+  // that the inserts of all the other ranges are visible to the callback.
+  if (multi_batch.pending_tasks_per_batch[task.batch_idx].fetch_sub(
+          1, std::memory_order_acq_rel) == 1 &&
+      post_callback) {
+    bool ok;
+    {
+      std::lock_guard<SpinMutex> guard(this->status_lock);
+      ok = this->status.ok();
+    }
+    if (ok) {
+      post_callback->Callback(sequence);
+    }
+  }
+  if (stolen) {
+    RecordTick(multi_batch.statistics, MULTI_BATCH_WRITE_STOLEN_BYTES,
+               task.end - task.begin);
   }
   multi_batch.pending_wb_cnt.fetch_sub(1, std::memory_order_acq_rel);
 }
@@ -10,8 +10,9 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
-#include <deque>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -35,19 +36,122 @@ struct CommitRequest;
 
 class ColumnFamilySet;
 class FlushScheduler;
+class Statistics;
+
+// A double-ended queue over a fixed number of tasks [0, n), all of which are
+// known before the first one is taken. The owner pops tasks from the front
+// while other threads steal from the back, so that they only race for the
+// last remaining task. Both ends live in one atomic word, which makes every
+// operation a single CAS and never blocks.
+class TaskDeque {
+ public:
+  TaskDeque() : range_(0) {}
+
+  void Reset(uint32_t num_tasks) {
+    range_.store(Pack(0, num_tasks), std::memory_order_release);
+  }
 
+  // Drops all remaining tasks and returns how many there were.
+  uint32_t Clear() {
+    uint64_t range = range_.exchange(0, std::memory_order_acq_rel);
+    return Tail(range) - Head(range);
+  }
+
+  bool PopFront(uint32_t* task) {
+    uint64_t range = range_.load(std::memory_order_acquire);
+    while (Head(range) < Tail(range)) {
+      if (range_.compare_exchange_weak(range,
+                                       Pack(Head(range) + 1, Tail(range)),
+                                       std::memory_order_acq_rel)) {
+        *task = Head(range);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool StealBack(uint32_t* task) {
+    uint64_t range = range_.load(std::memory_order_acquire);
+    while (Head(range) < Tail(range)) {
+      if (range_.compare_exchange_weak(range,
+                                       Pack(Head(range), Tail(range) - 1),
+                                       std::memory_order_acq_rel)) {
+        *task = Tail(range) - 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  static uint64_t Pack(uint32_t head, uint32_t tail) {
+    return (static_cast<uint64_t>(head) << 32) | tail;
+  }
+  static uint32_t Head(uint64_t range) {
+    return static_cast<uint32_t>(range >> 32);
+  }
+  static uint32_t Tail(uint64_t range) {
+    return static_cast<uint32_t>(range);
+  }
+
+  std::atomic<uint64_t> range_;
+};
+
+// Commit queue of multi-batch writers. Requests enter in sequence order,
+// apply their batches to the memtable concurrently, and are committed in
+// sequence order: whichever writer finds the front requests finished
+// publishes their commit sequence. The queue is a fixed ring of request
+// pointers and is lock-free except for waiters that have spun for longer
+// than max_yield_usec, which block on a condvar.
 class RequestQueue {
  public:
-  RequestQueue();
+  explicit RequestQueue(uint64_t max_yield_usec);
   ~RequestQueue();
+
+  // Appends req to the queue. Requests must be entered in commit order by
+  // one thread at a time, the write group leader.
   void Enter(CommitRequest* req);
+
+  // Waits until req is committed. While waiting, steals memtable inserts
+  // from the writer at the front of the queue and publishes the commit
+  // sequence of every finished request at the front.
   void CommitSequenceAwait(CommitRequest* req,
                            std::atomic<uint64_t>* commit_sequence);
 
  private:
-  std::mutex commit_mu_;
-  std::condition_variable commit_cv_;
-  std::deque<CommitRequest*> requests_;
+  // A slot holds a CommitRequest pointer whose low bits count the helpers
+  // currently stealing from it. A request is only removed from a slot that
+  // has no helpers, so that it can't be committed and freed under them.
+  static constexpr uintptr_t kHelperMask = 7;
+  static constexpr size_t kCapacity = 1024;
+
+  static CommitRequest* RequestOf(uintptr_t slot) {
+    return reinterpret_cast<CommitRequest*>(slot & ~kHelperMask);
+  }
+
+  // Commits every finished request at the front of the queue, unless
+  // another thread is already doing so.
+  void TryPublish(std::atomic<uint64_t>* commit_sequence);
+
+  // Returns true if the front request has finished and may be committed.
+  bool FrontPublishable();
+
+  // Steals one memtable insert from the front request, unless it is req.
+  bool HelpFront(CommitRequest* req);
+
+  const uint64_t max_yield_usec_;
+  std::atomic<uintptr_t> ring_[kCapacity];
+  // Position of the oldest uncommitted request. Written by the publisher.
+  std::atomic<uint64_t> head_;
+  // Position of the next request to enter. Written by Enter().
+  std::atomic<uint64_t> tail_;
+  // Held by the thread that is committing requests.
+  std::atomic<bool> publishing_;
+
+  // Slow path for waiters that have yielded for too long.
+  std::atomic<uint32_t> blocked_waiters_;
+  std::mutex wait_mu_;
+  std::condition_variable wait_cv_;
 };
 
 class WriteThread {
@@ -106,6 +210,9 @@ class WriteThread {
     Status status;
     std::atomic<size_t> running;
     size_t size = 0;
+    // Set when the group left out writers that only the adaptive group size
+    // limits kept from joining.
+    bool size_limited = false;
 
     struct Iterator {
       Writer* writer;
@@ -136,43 +243,70 @@ class WriteThread {
   };
 
   struct MultiBatch {
+    // A range of records of one of the batches, which is applied to the
+    // memtable as a unit. Covers the whole batch unless it has been split.
+    struct Task {
+      WriteBatch* batch;
+      size_t begin;
+      size_t end;
+      // Number of sequence numbers consumed by the records before `begin`.
+      uint32_t seq_offset;
+      // Index of `batch` in `batches`.
+      size_t batch_idx;
+    };
+
     std::vector<WriteBatch*> batches;
-    std::atomic<size_t> claimed_cnt;
+    std::vector<Task> tasks;
+    // Number of tasks of each batch that have not finished yet. The ranges
+    // of a batch may finish in any order, so the one bringing this to zero
+    // completes the batch.
+    std::unique_ptr<std::atomic<size_t>[]> pending_tasks_per_batch;
+    // The owner pops tasks from the front, other writers steal from the back.
+    TaskDeque task_deque;
+    // Number of tasks that have not finished yet.
     std::atomic<size_t> pending_wb_cnt;
     ColumnFamilySet* version_set;
     FlushScheduler* flush_scheduler;
     TrimHistoryScheduler* trim_history_scheduler;
     bool ignore_missing_column_families;
     DB* db;
+    Statistics* statistics;
 
     MultiBatch()
-        : claimed_cnt(0),
-          pending_wb_cnt(0),
+        : pending_wb_cnt(0),
           version_set(nullptr),
           flush_scheduler(nullptr),
           trim_history_scheduler(nullptr),
           ignore_missing_column_families(false),
-          db(nullptr) {}
+          db(nullptr),
+          statistics(nullptr) {}
 
     explicit MultiBatch(std::vector<WriteBatch*>&& _batch)
         : batches(_batch),
-          claimed_cnt(0),
           pending_wb_cnt(_batch.size()),
           version_set(nullptr),
           flush_scheduler(nullptr),
           trim_history_scheduler(nullptr),
           ignore_missing_column_families(false),
-          db(nullptr) {}
+          db(nullptr),
+          statistics(nullptr) {}
+
+    // Builds the tasks of the batches, cutting every batch larger than
+    // split_bytes into ranges of about that size. split_bytes == 0 creates
+    // one task per batch. Must be called before the writer joins the group.
+    void PrepareTasks(size_t split_bytes);
 
     void SetContext(ColumnFamilySet* _version_set,
                     FlushScheduler* _flush_scheduler,
                     TrimHistoryScheduler* _trim_history_scheduler,
-                    bool _ignore_missing_column_families, DB* _db) {
+                    bool _ignore_missing_column_families, DB* _db,
+                    Statistics* _statistics) {
       version_set = _version_set;
       flush_scheduler = _flush_scheduler;
       trim_history_scheduler = _trim_history_scheduler;
       ignore_missing_column_families = _ignore_missing_column_families;
       db = _db;
+      statistics = _statistics;
     }
   };
 
@@ -183,6 +317,7 @@ class WriteThread {
     bool disable_wal;
     Env::IOPriority rate_limiter_priority;
     bool disable_memtable;
+    bool memtable_insert_hint_per_batch;
     size_t batch_cnt;  // if non-zero, number of sub-batches in the write batch
     size_t protection_bytes_per_key;
     PreReleaseCallback* pre_release_callback;
@@ -207,12 +342,19 @@ class WriteThread {
 
     MultiBatch multi_batch;
 
+    // The WAL payload of the batches, if wal_payload_compressed, compressed
+    // by the writing thread before joining a group so that the leader only
+    // has to append it
+    std::string compressed_wal_payload;
+    bool wal_payload_compressed = false;
+
     Writer()
         : sync(false),
           no_slowdown(false),
           disable_wal(false),
           rate_limiter_priority(Env::IOPriority::IO_TOTAL),
           disable_memtable(false),
+          memtable_insert_hint_per_batch(false),
           batch_cnt(0),
           protection_bytes_per_key(0),
           pre_release_callback(nullptr),
@@ -240,6 +382,8 @@ class WriteThread {
           disable_wal(write_options.disableWAL),
           rate_limiter_priority(write_options.rate_limiter_priority),
           disable_memtable(_disable_memtable),
+          memtable_insert_hint_per_batch(
+              write_options.memtable_insert_hint_per_batch),
           batch_cnt(_batch_cnt),
           protection_bytes_per_key(_batch->GetProtectionBytesPerKey()),
           pre_release_callback(_pre_release_callback),
@@ -269,6 +413,8 @@ class WriteThread {
           disable_wal(write_options.disableWAL),
           rate_limiter_priority(write_options.rate_limiter_priority),
           disable_memtable(_disable_memtable),
+          memtable_insert_hint_per_batch(
+              write_options.memtable_insert_hint_per_batch),
           batch_cnt(0),
           pre_release_callback(_pre_release_callback),
           post_memtable_callback(_post_memtable_callback),
@@ -361,28 +507,40 @@ class WriteThread {
       return multi_batch.pending_wb_cnt.load(std::memory_order_acquire) > 1;
     }
 
-    size_t Claim() {
-      return multi_batch.claimed_cnt.fetch_add(1, std::memory_order_acq_rel);
-    }
-
     bool HasPendingWB() {
       return multi_batch.pending_wb_cnt.load(std::memory_order_acquire) > 0;
     }
 
+    // Drops the tasks nobody has taken yet. Tasks already being applied by
+    // other writers still count down when they finish.
     void ResetPendingWBCnt() {
-      multi_batch.pending_wb_cnt.store(0, std::memory_order_release);
+      multi_batch.pending_wb_cnt.fetch_sub(multi_batch.task_deque.Clear(),
+                                           std::memory_order_acq_rel);
     }
 
+    // Applies the next task from the front of this writer's own queue.
+    // Returns false if no task is left.
     bool ConsumeOne() {
-      auto claimed = Claim();
-      if (claimed < multi_batch.batches.size()) {
-        ConsumeOne(claimed);
+      uint32_t task;
+      if (multi_batch.task_deque.PopFront(&task)) {
+        ConsumeOne(task, false /* stolen */);
         return true;
       }
       return false;
     }
 
-    void ConsumeOne(size_t claimed);
+    // Called by another writer to apply a task from the back of this
+    // writer's queue. Returns false if no task is left.
+    bool StealOne() {
+      uint32_t task;
+      if (multi_batch.task_deque.StealBack(&task)) {
+        ConsumeOne(task, true /* stolen */);
+        return true;
+      }
+      return false;
+    }
+
+    void ConsumeOne(size_t task, bool stolen);
   };
 
   struct AdaptationContext {
@@ -503,6 +661,26 @@ class WriteThread {
 
   void EnterCommitQueue(CommitRequest* req) { return commit_queue_.Enter(req); }
 
+  // Whether the write group limits adapt to WAL write latency. See
+  // DBOptions::write_group_target_wal_latency_us.
+  bool adaptive_group_size() const { return target_wal_latency_us_ > 0; }
+
+  // Feeds the latency of writing write_group to the WAL, including any sync,
+  // into the adaptive group size limits. Must be called by the WAL writer,
+  // for groups built by EnterAsBatchGroupLeader.
+  void RecordWALWriteLatency(const WriteGroup& write_group, uint64_t micros);
+
+  // Current byte limit of a write group.
+  uint64_t GetGroupSizeLimitBytes() const {
+    return group_size_limit_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Current limit on the number of writers in a write group, 0 if there is
+  // none.
+  size_t GetGroupSizeLimitWriters() const {
+    return group_size_limit_writers_.load(std::memory_order_relaxed);
+  }
+
   void ExitWaitSequenceCommit(CommitRequest* req,
                               std::atomic<uint64_t>* commit_sequence) {
     commit_queue_.CommitSequenceAwait(req, commit_sequence);
@@ -524,6 +702,21 @@ class WriteThread {
   // is larger than 1/8 of this limit.
   const uint64_t max_write_batch_group_size_bytes;
 
+  // See DBOptions::write_group_target_wal_latency_us.
+  const uint64_t target_wal_latency_us_;
+
+  // Limits applied by EnterAsBatchGroupLeader. Without adaptive sizing they
+  // stay at max_write_batch_group_size_bytes and no writer limit.
+  std::atomic<uint64_t> group_size_limit_bytes_;
+  std::atomic<size_t> group_size_limit_writers_;
+
+  // Window of WAL write latency samples the adaptive limits are derived
+  // from. Only accessed by the WAL writer.
+  size_t latency_window_samples_ = 0;
+  size_t latency_window_slow_samples_ = 0;
+  size_t latency_window_max_writers_ = 0;
+  bool latency_window_size_limited_ = false;
+
   // Points to the newest pending writer. Only leader can remove
   // elements, adding can be done lock-free by anybody.
   std::atomic<Writer*> newest_writer_;
@@ -596,11 +789,12 @@ class WriteThread {
   void CompleteFollower(Writer* w, WriteGroup& write_group);
 };
 
-struct CommitRequest {
+struct alignas(8) CommitRequest {
   WriteThread::Writer* writer;
   uint64_t commit_lsn;
-  // protected by RequestQueue::commit_mu_
-  bool committed;
+  // Set by the thread that committed the request, which must not touch the
+  // request afterwards.
+  std::atomic<bool> committed;
   CommitRequest(WriteThread::Writer* w)
       : writer(w), commit_lsn(0), committed(false) {}
 };
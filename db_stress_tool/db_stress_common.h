@@ -102,6 +102,10 @@ DECLARE_bool(histogram);
 DECLARE_bool(destroy_db_initially);
 DECLARE_bool(verbose);
 DECLARE_bool(progress_reports);
+DECLARE_double(perf_min_ops_per_sec);
+DECLARE_uint64(perf_max_p99_micros);
+DECLARE_uint64(perf_max_reopen_micros);
+DECLARE_uint64(perf_max_error_recovery_micros);
 DECLARE_uint64(db_write_buffer_size);
 DECLARE_int32(write_buffer_size);
 DECLARE_int32(max_write_buffer_number);
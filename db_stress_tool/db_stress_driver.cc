@@ -219,11 +219,18 @@ bool RunStressTestImpl(SharedState* shared) {
   // TODO: We need to create verification stats (e.g. how many keys
   // are verified by which method) and report them here instead of operation
   // stats.
+  bool within_perf_budgets = true;
   if (!FLAGS_verification_only) {
     for (unsigned int i = 1; i < n; i++) {
       threads[0]->stats.Merge(threads[i]->stats);
     }
     threads[0]->stats.Report("Stress Test");
+    if (FLAGS_perf_regression_mode) {
+      within_perf_budgets = threads[0]->stats.ReportPhases(
+          FLAGS_perf_min_ops_per_sec, FLAGS_perf_max_p99_micros);
+      within_perf_budgets &= recovery_times.Report(
+          FLAGS_perf_max_reopen_micros, FLAGS_perf_max_error_recovery_micros);
+    }
   }
 
   for (unsigned int i = 0; i < n; i++) {
@@ -256,6 +263,10 @@ bool RunStressTestImpl(SharedState* shared) {
     fprintf(stderr, "Verification failed :(\n");
     return false;
   }
+  if (!within_perf_budgets) {
+    fprintf(stderr, "Performance budget exceeded :(\n");
+    return false;
+  }
   return true;
 }
 bool RunStressTest(SharedState* shared) {
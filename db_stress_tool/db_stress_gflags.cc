@@ -1051,6 +1051,32 @@ DEFINE_int32(inject_error_severity, 1,
              "The severity of the injected IO Error. 1 is soft error (e.g. "
              "retryable error), 2 is fatal error, and the default is "
              "retryable error.");
+
+DEFINE_bool(perf_regression_mode, false,
+            "Checks the performance of the operations and of the recoveries "
+            "of the DB, for the op mix and injected faults fixed by --seed. "
+            "The operations between two reopens are a phase, whose "
+            "throughput and latency are reported, as are the times of the "
+            "reopens, including WAL recovery, and of the automatic "
+            "recoveries from background errors. The listener does not sleep "
+            "at random. The run fails if any of the --perf_* budgets is "
+            "exceeded.");
+
+DEFINE_double(perf_min_ops_per_sec, 0,
+              "With --perf_regression_mode, the minimum throughput of the "
+              "threads in every phase. 0 for no budget.");
+
+DEFINE_uint64(perf_max_p99_micros, 0,
+              "With --perf_regression_mode, the maximum P99 latency of the "
+              "operations in every phase. 0 for no budget.");
+
+DEFINE_uint64(perf_max_reopen_micros, 0,
+              "With --perf_regression_mode, the maximum time of a reopen of "
+              "the DB. 0 for no budget.");
+
+DEFINE_uint64(perf_max_error_recovery_micros, 0,
+              "With --perf_regression_mode, the maximum time of an automatic "
+              "recovery from a background error. 0 for no budget.");
 DEFINE_int32(prepopulate_block_cache,
              static_cast<int32_t>(ROCKSDB_NAMESPACE::BlockBasedTableOptions::
                                       PrepopulateBlockCache::kDisable),
@@ -209,7 +209,10 @@ class DbStressListener : public EventListener {
 
   void OnErrorRecoveryBegin(BackgroundErrorReason /* reason */,
                             Status /* bg_error */,
-                            bool* /* auto_recovery */) override {
+                            bool* auto_recovery) override {
+    if (*auto_recovery) {
+      error_recovery_start_micros_.store(SystemClock::Default()->NowMicros());
+    }
     RandomSleep();
   }
 
@@ -217,6 +220,15 @@ class DbStressListener : public EventListener {
     RandomSleep();
   }
 
+  void OnErrorRecoveryEnd(
+      const BackgroundErrorRecoveryInfo& /* info */) override {
+    const uint64_t start = error_recovery_start_micros_.exchange(0);
+    if (start != 0) {
+      recovery_times.AddErrorRecovery(
+          SystemClock::Default()->NowMicros() - start);
+    }
+  }
+
  protected:
   bool IsValidColumnFamilyName(const std::string& cf_name) const {
     if (cf_name == kDefaultColumnFamilyName) {
@@ -288,6 +300,9 @@ class DbStressListener : public EventListener {
                                const std::string& file_path);
 
   void RandomSleep() {
+    if (FLAGS_perf_regression_mode) {
+      return;
+    }
     std::this_thread::sleep_for(
         std::chrono::microseconds(Random::GetTLSInstance()->Uniform(5000)));
   }
@@ -298,6 +313,9 @@ class DbStressListener : public EventListener {
   std::vector<ColumnFamilyDescriptor> column_families_;
   std::atomic<int> num_pending_file_creations_;
   UniqueIdVerifier unique_ids_;
+  // The start of the automatic recovery from a background error in progress,
+  // or 0
+  std::atomic<uint64_t> error_recovery_start_micros_{0};
 };
 }  // namespace ROCKSDB_NAMESPACE
 #endif  // GFLAGS
@@ -11,6 +11,35 @@ namespace ROCKSDB_NAMESPACE {
 
 std::shared_ptr<ROCKSDB_NAMESPACE::Statistics> dbstats;
 std::shared_ptr<ROCKSDB_NAMESPACE::Statistics> dbstats_secondaries;
+RecoveryTimes recovery_times;
+
+bool RecoveryTimes::Report(uint64_t max_reopen_micros,
+                           uint64_t max_error_recovery_micros) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool ok = true;
+  auto report = [&ok](const char* name, const std::vector<uint64_t>& micros,
+                      uint64_t max_micros) {
+    uint64_t total = 0;
+    uint64_t longest = 0;
+    for (uint64_t m : micros) {
+      total += m;
+      longest = std::max(longest, m);
+    }
+    fprintf(stdout,
+            "%-16s: %zu times, %" PRIu64 " micros in total, longest %" PRIu64
+            " micros\n",
+            name, micros.size(), total, longest);
+    if (max_micros > 0 && longest > max_micros) {
+      fprintf(stderr, "%s took %" PRIu64 " micros, above %" PRIu64 "\n", name,
+              longest, max_micros);
+      ok = false;
+    }
+  };
+  report("Reopen", reopen_micros_, max_reopen_micros);
+  report("Error recovery", error_recovery_micros_, max_error_recovery_micros);
+  fflush(stdout);
+  return ok;
+}
 
 }  // namespace ROCKSDB_NAMESPACE
 
@@ -4,10 +4,13 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #pragma once
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <unordered_set>
+#include <vector>
 
 #include "monitoring/histogram.h"
 #include "port/port.h"
@@ -19,6 +22,7 @@
 
 DECLARE_bool(histogram);
 DECLARE_bool(progress_reports);
+DECLARE_bool(perf_regression_mode);
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -26,6 +30,32 @@ namespace ROCKSDB_NAMESPACE {
 extern std::shared_ptr<ROCKSDB_NAMESPACE::Statistics> dbstats;
 extern std::shared_ptr<ROCKSDB_NAMESPACE::Statistics> dbstats_secondaries;
 
+// The durations of the reopens of the DB, including WAL recovery, and of its
+// automatic recoveries from background errors, for --perf_regression_mode
+class RecoveryTimes {
+ public:
+  void AddReopen(uint64_t micros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reopen_micros_.push_back(micros);
+  }
+
+  void AddErrorRecovery(uint64_t micros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_recovery_micros_.push_back(micros);
+  }
+
+  // Prints the durations. Returns false if any is longer than its budget,
+  // where a budget of 0 is no budget.
+  bool Report(uint64_t max_reopen_micros, uint64_t max_error_recovery_micros);
+
+ private:
+  std::mutex mutex_;
+  std::vector<uint64_t> reopen_micros_;
+  std::vector<uint64_t> error_recovery_micros_;
+};
+
+extern RecoveryTimes recovery_times;
+
 class Stats {
  private:
   uint64_t start_;
@@ -51,6 +81,16 @@ class Stats {
   uint64_t last_op_finish_;
   HistogramImpl hist_;
 
+  // The operations between two reopens of the DB, for --perf_regression_mode
+  struct Phase {
+    uint64_t start = 0;
+    uint64_t finish = 0;
+    long done = 0;
+    HistogramImpl hist;
+  };
+  std::vector<std::unique_ptr<Phase>> phases_;
+  bool in_phase_ = false;
+
  public:
   Stats() {}
 
@@ -77,6 +117,20 @@ class Stats {
     start_ = SystemClock::Default()->NowMicros();
     last_op_finish_ = start_;
     finish_ = start_;
+    phases_.clear();
+    in_phase_ = false;
+  }
+
+  void StartPhase() {
+    phases_.emplace_back(new Phase());
+    phases_.back()->start = SystemClock::Default()->NowMicros();
+    last_op_finish_ = phases_.back()->start;
+    in_phase_ = true;
+  }
+
+  void FinishPhase() {
+    phases_.back()->finish = SystemClock::Default()->NowMicros();
+    in_phase_ = false;
   }
 
   void Merge(const Stats& other) {
@@ -100,6 +154,20 @@ class Stats {
     num_compact_files_failed_ += other.num_compact_files_failed_;
     if (other.start_ < start_) start_ = other.start_;
     if (other.finish_ > finish_) finish_ = other.finish_;
+    // The phases of all threads run between the same reopens
+    while (phases_.size() < other.phases_.size()) {
+      phases_.emplace_back(new Phase());
+    }
+    for (size_t i = 0; i < other.phases_.size(); ++i) {
+      Phase& phase = *phases_[i];
+      const Phase& other_phase = *other.phases_[i];
+      if (phase.start == 0 || other_phase.start < phase.start) {
+        phase.start = other_phase.start;
+      }
+      phase.finish = std::max(phase.finish, other_phase.finish);
+      phase.done += other_phase.done;
+      phase.hist.Merge(other_phase.hist);
+    }
   }
 
   void Stop() {
@@ -108,12 +176,18 @@ class Stats {
   }
 
   void FinishedSingleOp() {
-    if (FLAGS_histogram) {
+    if (FLAGS_histogram || (FLAGS_perf_regression_mode && in_phase_)) {
       auto now = SystemClock::Default()->NowMicros();
       auto micros = now - last_op_finish_;
-      hist_.Add(micros);
-      if (micros > 20000) {
-        fprintf(stdout, "long op: %" PRIu64 " micros%30s\r", micros, "");
+      if (FLAGS_histogram) {
+        hist_.Add(micros);
+        if (micros > 20000) {
+          fprintf(stdout, "long op: %" PRIu64 " micros%30s\r", micros, "");
+        }
+      }
+      if (in_phase_) {
+        phases_.back()->hist.Add(micros);
+        phases_.back()->done++;
       }
       last_op_finish_ = now;
     }
@@ -215,5 +289,35 @@ class Stats {
     }
     fflush(stdout);
   }
+
+  // Prints the throughput and latency of each phase. Returns false if any
+  // phase is slower than the budgets, where a budget of 0 is no budget.
+  bool ReportPhases(double min_ops_per_sec, uint64_t max_p99_micros) {
+    bool ok = true;
+    fprintf(stdout, "%-6s %10s %10s %12s %10s %10s %10s\n", "Phase", "Ops",
+            "Secs", "Ops/sec", "P50", "P99", "Max");
+    for (size_t i = 0; i < phases_.size(); ++i) {
+      const Phase& phase = *phases_[i];
+      const double secs = (phase.finish - phase.start) * 1e-6;
+      const double ops_per_sec = secs > 0 ? phase.done / secs : 0;
+      const double p99 = phase.hist.Percentile(99);
+      fprintf(stdout, "%-6zu %10ld %10.3f %12.1f %10.1f %10.1f %10" PRIu64 "\n",
+              i, phase.done, secs, ops_per_sec, phase.hist.Median(), p99,
+              phase.hist.max());
+      if (min_ops_per_sec > 0 && phase.done > 0 &&
+          ops_per_sec < min_ops_per_sec) {
+        fprintf(stderr, "Phase %zu: %.1f ops/sec is below %.1f\n", i,
+                ops_per_sec, min_ops_per_sec);
+        ok = false;
+      }
+      if (max_p99_micros > 0 && p99 > static_cast<double>(max_p99_micros)) {
+        fprintf(stderr, "Phase %zu: P99 of %.1f micros is above %" PRIu64 "\n",
+                i, p99, max_p99_micros);
+        ok = false;
+      }
+    }
+    fflush(stdout);
+    return ok;
+  }
 };
 }  // namespace ROCKSDB_NAMESPACE
@@ -882,6 +882,9 @@ void StressTest::OperateDb(ThreadState* thread) {
       // Commenting this out as we don't want to reset stats on each open.
       // thread->stats.Start();
     }
+    if (FLAGS_perf_regression_mode) {
+      thread->stats.StartPhase();
+    }
 
     for (uint64_t i = 0; i < ops_per_open; i++) {
       if (thread->shared->HasVerificationFailedYet()) {
@@ -1175,6 +1178,9 @@ void StressTest::OperateDb(ThreadState* thread) {
       }
       thread->stats.FinishedSingleOp();
     }
+    if (FLAGS_perf_regression_mode) {
+      thread->stats.FinishPhase();
+    }
   }
   while (!thread->snapshot_queue.empty()) {
     db_->ReleaseSnapshot(thread->snapshot_queue.front().second.snapshot);
@@ -3075,6 +3081,7 @@ void StressTest::Reopen(ThreadState* thread) {
   fprintf(stdout, "%s Reopening database for the %dth time\n",
           clock_->TimeToString(now / 1000000).c_str(), num_times_reopened_);
   Open(thread->shared, /*reopen=*/true);
+  recovery_times.AddReopen(clock_->NowMicros() - now);
 
   if ((FLAGS_sync_fault_injection || FLAGS_disable_wal ||
        FLAGS_manual_wal_flush_one_in > 0) &&
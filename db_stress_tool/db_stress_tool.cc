@@ -166,6 +166,14 @@ int db_stress_tool(int argc, char** argv) {
             FLAGS_reopen, (unsigned long)FLAGS_ops_per_thread);
     exit(1);
   }
+  if (!FLAGS_perf_regression_mode &&
+      (FLAGS_perf_min_ops_per_sec > 0 || FLAGS_perf_max_p99_micros > 0 ||
+       FLAGS_perf_max_reopen_micros > 0 ||
+       FLAGS_perf_max_error_recovery_micros > 0)) {
+    fprintf(stderr,
+            "Error: the --perf_* budgets need --perf_regression_mode\n");
+    exit(1);
+  }
   if (FLAGS_test_batches_snapshots && FLAGS_delrangepercent > 0) {
     fprintf(stderr,
             "Error: nonzero delrangepercent unsupported in "
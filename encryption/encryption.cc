@@ -46,6 +46,58 @@ void PutBigEndian64(uint64_t value, unsigned char* buf) {
     *(reinterpret_cast<uint64_t*>(buf)) = value;
   }
 }
+
+#if OPENSSL_VERSION_NUMBER >= 0x01000200f
+// The cipher context of a thread, kept across the calls of the thread. The
+// key schedule is only set up when the cipher, the key or the direction
+// changes, otherwise only the IV is set, which saves most of the cost of
+// ciphering a small block.
+class ThreadCipherContext {
+ public:
+  ~ThreadCipherContext() {
+    if (ctx_ != nullptr) {
+      EVP_CIPHER_CTX_free(ctx_);
+    }
+  }
+
+  // Returns the context initialized with the arguments, without padding, or
+  // nullptr on failure
+  EVP_CIPHER_CTX* Init(const EVP_CIPHER* cipher, const std::string& key,
+                       const unsigned char* iv, int enc) {
+    if (ctx_ == nullptr) {
+      ctx_ = EVP_CIPHER_CTX_new();
+      if (ctx_ == nullptr) {
+        return nullptr;
+      }
+    } else if (cipher == cipher_ && enc == enc_ && key == key_) {
+      TEST_SYNC_POINT("ThreadCipherContext::Init:Reuse");
+      if (EVP_CipherInit_ex(ctx_, nullptr, nullptr, nullptr, iv, enc) == 1) {
+        return ctx_;
+      }
+    }
+    // Not reused until fully initialized again
+    cipher_ = nullptr;
+    if (EVP_CipherInit(ctx_, cipher,
+                       reinterpret_cast<const unsigned char*>(key.data()), iv,
+                       enc) != 1 ||
+        EVP_CIPHER_CTX_set_padding(ctx_, 0) != 1) {
+      return nullptr;
+    }
+    cipher_ = cipher;
+    key_ = key;
+    enc_ = enc;
+    return ctx_;
+  }
+
+ private:
+  EVP_CIPHER_CTX* ctx_ = nullptr;
+  const EVP_CIPHER* cipher_ = nullptr;
+  std::string key_;
+  int enc_ = -1;
+};
+
+thread_local ThreadCipherContext thread_cipher_context;
+#endif
 }  // anonymous namespace
 
 // AESCTRCipherStream use OpenSSL EVP API with CTR mode to encrypt and decrypt
@@ -55,6 +107,8 @@ void PutBigEndian64(uint64_t value, unsigned char* buf) {
 // 1. The EVP API automatically figure out if AES-NI can be enabled.
 // 2. Keep the data format consistent with OpenSSL (e.g. how IV is interpreted
 // as block counter).
+// 3. The full blocks are ciphered in one call, which OpenSSL pipelines over
+// several blocks at a time.
 //
 // References for the openssl EVP API:
 // * man page: https://www.openssl.org/docs/man1.1.1/man3/EVP_EncryptUpdate.html
@@ -71,12 +125,6 @@ Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
   return Status::NotSupported("OpenSSL version < 1.0.2");
 #else
   int ret = 1;
-  EVP_CIPHER_CTX* ctx = nullptr;
-  InitCipherContext(ctx);
-  if (ctx == nullptr) {
-    return Status::IOError("Failed to create cipher context.");
-  }
-
   const size_t block_size = BlockSize();
 
   uint64_t block_index = file_offset / block_size;
@@ -97,21 +145,14 @@ Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
   PutBigEndian64(iv_high, iv);
   PutBigEndian64(iv_low, iv + sizeof(uint64_t));
 
-  ret = EVP_CipherInit(ctx, cipher_,
-                       reinterpret_cast<const unsigned char*>(key_.data()), iv,
-                       (is_encrypt ? 1 : 0));
-  if (ret != 1) {
+  // Padding is disabled, so data size should always be multiply of block
+  // size.
+  EVP_CIPHER_CTX* ctx =
+      thread_cipher_context.Init(cipher_, key_, iv, (is_encrypt ? 1 : 0));
+  if (ctx == nullptr) {
     return Status::IOError("Failed to init cipher.");
   }
 
-  // Disable padding. After disabling padding, data size should always be
-  // multiply of block size.
-  ret = EVP_CIPHER_CTX_set_padding(ctx, 0);
-  if (ret != 1) {
-    FreeCipherContext(ctx);
-    return Status::IOError("Failed to disable padding for cipher context.");
-  }
-
   uint64_t data_offset = 0;
   size_t remaining_data_size = data_size;
   int output_size = 0;
@@ -129,12 +170,10 @@ Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
     ret = EVP_CipherUpdate(ctx, partial_block, &output_size, partial_block,
                            static_cast<int>(block_size));
     if (ret != 1) {
-      FreeCipherContext(ctx);
       return Status::IOError("Crypter failed for first block, offset " +
                              std::to_string(file_offset));
     }
     if (output_size != static_cast<int>(block_size)) {
-      FreeCipherContext(ctx);
       return Status::IOError(
           "Unexpected crypter output size for first block, expected " +
           std::to_string(block_size) + " vs actual " +
@@ -154,12 +193,10 @@ Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
     ret = EVP_CipherUpdate(ctx, full_blocks, &output_size, full_blocks,
                            static_cast<int>(actual_data_size));
     if (ret != 1) {
-      FreeCipherContext(ctx);
       return Status::IOError("Crypter failed at offset " +
                              std::to_string(file_offset + data_offset));
     }
     if (output_size != static_cast<int>(actual_data_size)) {
-      FreeCipherContext(ctx);
       return Status::IOError("Unexpected crypter output size, expected " +
                              std::to_string(actual_data_size) + " vs actual " +
                              std::to_string(output_size));
@@ -176,12 +213,10 @@ Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
     ret = EVP_CipherUpdate(ctx, partial_block, &output_size, partial_block,
                            static_cast<int>(block_size));
     if (ret != 1) {
-      FreeCipherContext(ctx);
       return Status::IOError("Crypter failed for last block, offset " +
                              std::to_string(file_offset + data_offset));
     }
     if (output_size != static_cast<int>(block_size)) {
-      FreeCipherContext(ctx);
       return Status::IOError(
           "Unexpected crypter output size for last block, expected " +
           std::to_string(block_size) + " vs actual " +
@@ -195,7 +230,6 @@ Status AESCTRCipherStream::Cipher(uint64_t file_offset, char* data,
   // EVP_CipherFinal_ex to finish the last block cipher.
   // Reference to the implement of EVP_CipherFinal_ex:
   // https://github.com/openssl/openssl/blob/OpenSSL_1_1_1-stable/crypto/evp/evp_enc.c#L219
-  FreeCipherContext(ctx);
   return Status::OK();
 #endif
 }
@@ -151,6 +151,38 @@ TEST_P(EncryptionTest, EncryptionTest) {
   EXPECT_TRUE(TestEncryption(16, 16 * 2, IV_OVERFLOW_FULL));
 }
 
+// The cipher context of the thread is reused across streams with the same
+// key, and set up again when another key or direction is used in between.
+TEST_P(EncryptionTest, InterleavedStreams) {
+  int reuses = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "ThreadCipherContext::Init:Reuse", [&](void* /*arg*/) { reuses++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  EncryptionMethod method = std::get<1>(GetParam());
+  std::string other_key(reinterpret_cast<const char*>(KEY), KeySize(method));
+  std::reverse(other_key.begin(), other_key.end());
+  std::string iv_str(reinterpret_cast<const char*>(IV_RANDOM), 16);
+  std::unique_ptr<AESCTRCipherStream> other_stream;
+  ASSERT_OK(NewAESCTRCipherStream(method, other_key, iv_str, &other_stream));
+  char other_data[16 * 3] = {};
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(TestEncryption(16 * 5 + 1, 16 * 8 + 15));
+    EXPECT_TRUE(TestEncryption(16, 16 * 2, IV_OVERFLOW_LOW));
+    ASSERT_OK(other_stream->Encrypt(7, other_data, sizeof(other_data)));
+    EXPECT_TRUE(TestEncryption(16 * 5, 16 * 6));
+    ASSERT_OK(other_stream->Decrypt(7, other_data, sizeof(other_data)));
+  }
+  for (char c : other_data) {
+    ASSERT_EQ(c, 0);
+  }
+  ASSERT_GT(reuses, 0);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 // Openssl support SM4 after 1.1.1 release version.
 #if OPENSSL_VERSION_NUMBER < 0x1010100fL || defined(OPENSSL_NO_SM4)
 INSTANTIATE_TEST_CASE_P(
@@ -358,6 +358,25 @@ class CompositeEnvWrapper : public CompositeEnv {
     return target_.env->LowerThreadPoolCPUPriority(pool, pri);
   }
 
+  Status SetThreadPoolCpuAffinity(Priority pool,
+                                  const std::vector<int>& cpus) override {
+    return target_.env->SetThreadPoolCpuAffinity(pool, cpus);
+  }
+
+  Status SetThreadPoolFairScheduling(Priority pool, bool fair) override {
+    return target_.env->SetThreadPoolFairScheduling(pool, fair);
+  }
+
+  Status SetThreadPoolSchedulingWeight(Priority pool, void* tag,
+                                       uint32_t weight) override {
+    return target_.env->SetThreadPoolSchedulingWeight(pool, tag, weight);
+  }
+
+  Status GetThreadPoolQueueStats(Priority pool, void* tag,
+                                 ThreadPoolQueueStats* stats) override {
+    return target_.env->GetThreadPoolQueueStats(pool, tag, stats);
+  }
+
   Status GetThreadList(std::vector<ThreadStatus>* thread_list) override {
     return target_.env->GetThreadList(thread_list);
   }
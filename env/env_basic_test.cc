@@ -118,6 +118,13 @@ static Env* GetInspectedEnv() {
   return inspected_env.get();
 }
 
+static Env* GetInspectedFSEnv() {
+  static std::unique_ptr<Env> inspected_fs_env(NewCompositeEnv(
+      NewFileSystemInspectedFS(FileSystem::Default(),
+                               std::make_shared<DummyFileSystemInspector>(1))));
+  return inspected_fs_env.get();
+}
+
 #ifdef OPENSSL
 static Env* GetKeyManagedEncryptedEnv() {
   static std::shared_ptr<encryption::KeyManager> key_manager(
@@ -168,6 +175,9 @@ INSTANTIATE_TEST_CASE_P(MemEnv, EnvBasicTestWithParam,
 INSTANTIATE_TEST_CASE_P(InspectedEnv, EnvBasicTestWithParam,
                         ::testing::Values(&GetInspectedEnv));
 
+INSTANTIATE_TEST_CASE_P(InspectedFS, EnvBasicTestWithParam,
+                        ::testing::Values(&GetInspectedFSEnv));
+
 #ifdef OPENSSL
 INSTANTIATE_TEST_CASE_P(KeyManagedEncryptedEnv, EnvBasicTestWithParam,
                         ::testing::Values(&GetKeyManagedEncryptedEnv));
@@ -360,6 +370,39 @@ TEST_P(EnvBasicTestWithParam, ReadWrite) {
   ASSERT_TRUE(rand_file->Read(1000, 5, &result, scratch).ok());
 }
 
+TEST_P(EnvBasicTestWithParam, MultiRead) {
+  std::string data;
+  for (size_t i = 0; i < 10000; ++i) {
+    data.append(1, static_cast<char>(i * 7));
+  }
+  std::unique_ptr<WritableFile> writable_file;
+  ASSERT_OK(env_->NewWritableFile(test_dir_ + "/f", &writable_file, soptions_));
+  ASSERT_OK(writable_file->Append(data));
+  ASSERT_OK(writable_file->Close());
+  writable_file.reset();
+
+  std::unique_ptr<RandomAccessFile> rand_file;
+  ASSERT_OK(env_->NewRandomAccessFile(test_dir_ + "/f", &rand_file, soptions_));
+  // Unaligned, out of order and past the end of the file
+  const std::vector<std::pair<uint64_t, size_t>> ranges = {
+      {5000, 4096}, {3, 100}, {17, 5000}, {9990, 100}};
+  std::vector<ReadRequest> reqs(ranges.size());
+  std::vector<std::unique_ptr<char[]>> scratches;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    scratches.emplace_back(new char[ranges[i].second]);
+    reqs[i].offset = ranges[i].first;
+    reqs[i].len = ranges[i].second;
+    reqs[i].scratch = scratches.back().get();
+  }
+  ASSERT_OK(rand_file->MultiRead(reqs.data(), reqs.size()));
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    ASSERT_OK(reqs[i].status);
+    ASSERT_EQ(reqs[i].offset, ranges[i].first);
+    ASSERT_EQ(reqs[i].result.ToString(),
+              data.substr(ranges[i].first, ranges[i].second));
+  }
+}
+
 TEST_P(EnvBasicTestWithParam, Misc) {
   std::unique_ptr<WritableFile> writable_file;
   ASSERT_OK(env_->NewWritableFile(test_dir_ + "/b", &writable_file, soptions_));
@@ -489,6 +532,63 @@ TEST_P(EnvMoreTestWithParam, GetChildrenIgnoresDotAndDotDot) {
   ASSERT_EQ(result.at(0), "test_file");
 }
 
+TEST(InspectedFSTest, BatchedMultiRead) {
+  // Allows reads of up to 4 bytes at a time, and counts the calls
+  class CountingInspector : public DummyFileSystemInspector {
+   public:
+    CountingInspector() : DummyFileSystemInspector(4) {}
+
+    Status Read(size_t len, size_t* allowed) override {
+      num_reads++;
+      return DummyFileSystemInspector::Read(len, allowed);
+    }
+
+    Status ReadBatch(size_t n, const size_t* lens, size_t* allowed) override {
+      num_batches++;
+      for (size_t i = 0; i < n; ++i) {
+        EXPECT_OK(DummyFileSystemInspector::Read(lens[i], &allowed[i]));
+      }
+      return Status::OK();
+    }
+
+    int num_reads = 0;
+    int num_batches = 0;
+  };
+  auto inspector = std::make_shared<CountingInspector>();
+  std::shared_ptr<FileSystem> fs =
+      NewFileSystemInspectedFS(FileSystem::Default(), inspector);
+  const std::string fname = test::PerThreadDBPath("inspected_fs_multiread");
+  ASSERT_OK(WriteStringToFile(fs.get(), "0123456789", fname));
+  inspector->num_reads = 0;
+
+  std::unique_ptr<FSRandomAccessFile> file;
+  ASSERT_OK(fs->NewRandomAccessFile(fname, FileOptions(), &file, nullptr));
+  char scratch[3][10];
+  FSReadRequest reqs[3];
+  reqs[0].offset = 0;
+  reqs[0].len = 2;
+  reqs[1].offset = 2;
+  reqs[1].len = 8;
+  reqs[2].offset = 6;
+  reqs[2].len = 4;
+  for (int i = 0; i < 3; ++i) {
+    reqs[i].scratch = scratch[i];
+  }
+  ASSERT_OK(file->MultiRead(reqs, 3, IOOptions(), nullptr));
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(reqs[i].status);
+  }
+  ASSERT_EQ(reqs[0].result.ToString(), "01");
+  ASSERT_EQ(reqs[1].result.ToString(), "23456789");
+  ASSERT_EQ(reqs[2].result.ToString(), "6789");
+  // One call for the batch, and one for the rest of the second read
+  ASSERT_EQ(inspector->num_batches, 1);
+  ASSERT_EQ(inspector->num_reads, 1);
+
+  file.reset();
+  ASSERT_OK(fs->DeleteFile(fname, IOOptions(), nullptr));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 int main(int argc, char** argv) {
   ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
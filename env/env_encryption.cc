@@ -109,6 +109,29 @@ IOStatus EncryptedRandomAccessFile::Read(uint64_t offset, size_t n,
   return io_s;
 }
 
+IOStatus EncryptedRandomAccessFile::MultiRead(FSReadRequest* reqs,
+                                              size_t num_reqs,
+                                              const IOOptions& options,
+                                              IODebugContext* dbg) {
+  for (size_t i = 0; i < num_reqs; ++i) {
+    assert(reqs[i].scratch);
+    reqs[i].offset += prefixLength_;
+  }
+  IOStatus io_s = file_->MultiRead(reqs, num_reqs, options, dbg);
+  {
+    PERF_TIMER_GUARD(decrypt_data_nanos);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      FSReadRequest& req = reqs[i];
+      if (io_s.ok() && req.status.ok()) {
+        req.status = status_to_io_status(stream_->Decrypt(
+            req.offset, (char*)req.result.data(), req.result.size()));
+      }
+      req.offset -= prefixLength_;
+    }
+  }
+  return io_s;
+}
+
 IOStatus EncryptedRandomAccessFile::Prefetch(uint64_t offset, size_t n,
                                              const IOOptions& options,
                                              IODebugContext* dbg) {
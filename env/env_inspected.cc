@@ -2,6 +2,8 @@
 
 #include "rocksdb/env_inspected.h"
 
+#include <vector>
+
 namespace ROCKSDB_NAMESPACE {
 
 class InspectedSequentialFile : public SequentialFileWrapper {
@@ -93,14 +95,69 @@ class InspectedRandomAccessFile : public RandomAccessFileWrapper {
 
   Status Read(uint64_t offset, size_t n, Slice* result,
               char* scratch) const override {
+    return InspectedRead(offset, n, result, scratch, /*allowed=*/0);
+  }
+
+  Status MultiRead(ReadRequest* reqs, size_t num_reqs) override {
+    assert(inspector_);
+    assert(reqs != nullptr);
+    std::vector<size_t> lens(num_reqs);
+    std::vector<size_t> allowed(num_reqs, 0);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      lens[i] = reqs[i].len;
+    }
+    Status s = inspector_->ReadBatch(num_reqs, lens.data(), allowed.data());
+    if (!s.ok()) {
+      return s;
+    }
+    // Reads allowed in full are issued together
+    std::vector<ReadRequest> full_reqs;
+    std::vector<size_t> full_indexes;
+    for (size_t i = 0; i < num_reqs; ++i) {
+      assert(allowed[i] <= lens[i]);
+      if (allowed[i] == lens[i]) {
+        full_reqs.push_back(reqs[i]);
+        full_indexes.push_back(i);
+      }
+    }
+    if (full_reqs.size() == num_reqs) {
+      return RandomAccessFileWrapper::MultiRead(reqs, num_reqs);
+    }
+    if (!full_reqs.empty()) {
+      s = RandomAccessFileWrapper::MultiRead(full_reqs.data(),
+                                             full_reqs.size());
+      if (!s.ok()) {
+        return s;
+      }
+      for (size_t j = 0; j < full_reqs.size(); ++j) {
+        reqs[full_indexes[j]].result = full_reqs[j].result;
+        reqs[full_indexes[j]].status = full_reqs[j].status;
+      }
+    }
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      if (allowed[i] < lens[i]) {
+        req.status = InspectedRead(req.offset, req.len, &req.result,
+                                   req.scratch, allowed[i]);
+      }
+    }
+    return Status::OK();
+  }
+
+ private:
+  // Reads in pieces allowed by the inspector, the first `allowed` bytes being
+  // allowed already
+  Status InspectedRead(uint64_t offset, size_t n, Slice* result, char* scratch,
+                       size_t allowed) const {
     assert(inspector_);
     Status s;
     size_t roffset = 0;
-    size_t allowed = 0;
     while (roffset < n) {
-      s = inspector_->Read(n - roffset, &allowed);
-      if (!s.ok()) {
-        return s;
+      if (allowed == 0) {
+        s = inspector_->Read(n - roffset, &allowed);
+        if (!s.ok()) {
+          return s;
+        }
       }
       assert(allowed <= n - roffset);
       if (allowed > 0) {
@@ -118,23 +175,13 @@ class InspectedRandomAccessFile : public RandomAccessFileWrapper {
         if (actual_read < allowed) {
           break;
         }
+        allowed = 0;
       }
     }
     *result = Slice(scratch, roffset);
     return s;
   }
 
-  // TODO: support parallel MultiRead
-  Status MultiRead(ReadRequest* reqs, size_t num_reqs) override {
-    assert(reqs != nullptr);
-    for (size_t i = 0; i < num_reqs; ++i) {
-      ReadRequest& req = reqs[i];
-      req.status = Read(req.offset, req.len, &req.result, req.scratch);
-    }
-    return Status::OK();
-  }
-
- private:
   std::unique_ptr<RandomAccessFile> owner_;
   std::shared_ptr<FileSystemInspector> inspector_;
 };
@@ -396,4 +443,487 @@ Env* NewFileSystemInspectedEnv(Env* base_env,
   return new FileSystemInspectedEnv(base_env, inspector);
 }
 
+class InspectedFSSequentialFile : public FSSequentialFileOwnerWrapper {
+ public:
+  InspectedFSSequentialFile(std::unique_ptr<FSSequentialFile>&& target,
+                            std::shared_ptr<FileSystemInspector> inspector)
+      : FSSequentialFileOwnerWrapper(std::move(target)),
+        inspector_(inspector) {}
+
+  IOStatus Read(size_t n, const IOOptions& options, Slice* result,
+                char* scratch, IODebugContext* dbg) override {
+    assert(inspector_);
+    IOStatus s;
+    size_t offset = 0;
+    size_t allowed = 0;
+    while (offset < n) {
+      s = status_to_io_status(inspector_->Read(n - offset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= n - offset);
+      if (allowed > 0) {
+        s = FSSequentialFileOwnerWrapper::Read(allowed, options, result,
+                                               scratch + offset, dbg);
+        if (!s.ok()) {
+          break;
+        }
+        size_t actual_read = result->size();
+        if (result->data() != scratch + offset) {
+          memmove(scratch + offset, result->data(), actual_read);
+          assert(false);
+        }
+        offset += actual_read;
+        if (actual_read < allowed) {
+          break;
+        }
+      }
+    }
+    *result = Slice(scratch, offset);
+    return s;
+  }
+
+  IOStatus PositionedRead(uint64_t offset, size_t n, const IOOptions& options,
+                          Slice* result, char* scratch,
+                          IODebugContext* dbg) override {
+    assert(inspector_);
+    IOStatus s;
+    size_t roffset = 0;
+    size_t allowed = 0;
+    while (roffset < n) {
+      s = status_to_io_status(inspector_->Read(n - roffset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= n - roffset);
+      if (allowed > 0) {
+        s = FSSequentialFileOwnerWrapper::PositionedRead(
+            offset + roffset, allowed, options, result, scratch + roffset,
+            dbg);
+        if (!s.ok()) {
+          break;
+        }
+        size_t actual_read = result->size();
+        if (result->data() != scratch + roffset) {
+          memmove(scratch + roffset, result->data(), actual_read);
+          assert(false);
+        }
+        roffset += actual_read;
+        if (actual_read < allowed) {
+          break;
+        }
+      }
+    }
+    *result = Slice(scratch, roffset);
+    return s;
+  }
+
+ private:
+  std::shared_ptr<FileSystemInspector> inspector_;
+};
+
+class InspectedFSRandomAccessFile : public FSRandomAccessFileOwnerWrapper {
+ public:
+  InspectedFSRandomAccessFile(std::unique_ptr<FSRandomAccessFile>&& target,
+                              std::shared_ptr<FileSystemInspector> inspector)
+      : FSRandomAccessFileOwnerWrapper(std::move(target)),
+        inspector_(inspector) {}
+
+  IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                Slice* result, char* scratch,
+                IODebugContext* dbg) const override {
+    return InspectedRead(offset, n, options, result, scratch, dbg,
+                         /*allowed=*/0);
+  }
+
+  IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
+                     const IOOptions& options, IODebugContext* dbg) override {
+    assert(inspector_);
+    assert(reqs != nullptr);
+    std::vector<size_t> lens(num_reqs);
+    std::vector<size_t> allowed(num_reqs, 0);
+    for (size_t i = 0; i < num_reqs; ++i) {
+      lens[i] = reqs[i].len;
+    }
+    IOStatus s = status_to_io_status(
+        inspector_->ReadBatch(num_reqs, lens.data(), allowed.data()));
+    if (!s.ok()) {
+      return s;
+    }
+    // Reads allowed in full are issued together
+    std::vector<FSReadRequest> full_reqs;
+    std::vector<size_t> full_indexes;
+    for (size_t i = 0; i < num_reqs; ++i) {
+      assert(allowed[i] <= lens[i]);
+      if (allowed[i] == lens[i]) {
+        full_reqs.emplace_back();
+        full_reqs.back().offset = reqs[i].offset;
+        full_reqs.back().len = reqs[i].len;
+        full_reqs.back().scratch = reqs[i].scratch;
+        full_indexes.push_back(i);
+      }
+    }
+    if (full_reqs.size() == num_reqs) {
+      return FSRandomAccessFileOwnerWrapper::MultiRead(reqs, num_reqs, options,
+                                                       dbg);
+    }
+    if (!full_reqs.empty()) {
+      s = FSRandomAccessFileOwnerWrapper::MultiRead(
+          full_reqs.data(), full_reqs.size(), options, dbg);
+      if (!s.ok()) {
+        return s;
+      }
+      for (size_t j = 0; j < full_reqs.size(); ++j) {
+        reqs[full_indexes[j]].result = full_reqs[j].result;
+        reqs[full_indexes[j]].status = full_reqs[j].status;
+      }
+    }
+    for (size_t i = 0; i < num_reqs; ++i) {
+      FSReadRequest& req = reqs[i];
+      if (allowed[i] < lens[i]) {
+        req.status = InspectedRead(req.offset, req.len, options, &req.result,
+                                   req.scratch, dbg, allowed[i]);
+      }
+    }
+    return IOStatus::OK();
+  }
+
+  // The whole read is allowed before it is submitted, as it cannot be split
+  IOStatus ReadAsync(FSReadRequest& req, const IOOptions& opts,
+                     std::function<void(const FSReadRequest&, void*)> cb,
+                     void* cb_arg, void** io_handle, IOHandleDeleter* del_fn,
+                     IODebugContext* dbg) override {
+    assert(inspector_);
+    size_t roffset = 0;
+    size_t allowed = 0;
+    while (roffset < req.len) {
+      IOStatus s =
+          status_to_io_status(inspector_->Read(req.len - roffset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= req.len - roffset);
+      roffset += allowed;
+    }
+    return FSRandomAccessFileOwnerWrapper::ReadAsync(req, opts, cb, cb_arg,
+                                                     io_handle, del_fn, dbg);
+  }
+
+ private:
+  // Reads in pieces allowed by the inspector, the first `allowed` bytes being
+  // allowed already
+  IOStatus InspectedRead(uint64_t offset, size_t n, const IOOptions& options,
+                         Slice* result, char* scratch, IODebugContext* dbg,
+                         size_t allowed) const {
+    assert(inspector_);
+    IOStatus s;
+    size_t roffset = 0;
+    while (roffset < n) {
+      if (allowed == 0) {
+        s = status_to_io_status(inspector_->Read(n - roffset, &allowed));
+        if (!s.ok()) {
+          return s;
+        }
+      }
+      assert(allowed <= n - roffset);
+      if (allowed > 0) {
+        s = FSRandomAccessFileOwnerWrapper::Read(offset + roffset, allowed,
+                                                 options, result,
+                                                 scratch + roffset, dbg);
+        if (!s.ok()) {
+          break;
+        }
+        size_t actual_read = result->size();
+        if (result->data() != scratch + roffset) {
+          memmove(scratch + roffset, result->data(), actual_read);
+          assert(false);
+        }
+        roffset += actual_read;
+        if (actual_read < allowed) {
+          break;
+        }
+        allowed = 0;
+      }
+    }
+    *result = Slice(scratch, roffset);
+    return s;
+  }
+
+  std::shared_ptr<FileSystemInspector> inspector_;
+};
+
+class InspectedFSWritableFile : public FSWritableFileOwnerWrapper {
+ public:
+  InspectedFSWritableFile(std::unique_ptr<FSWritableFile>&& target,
+                          std::shared_ptr<FileSystemInspector> inspector)
+      : FSWritableFileOwnerWrapper(std::move(target)), inspector_(inspector) {}
+
+  IOStatus Append(const Slice& data, const IOOptions& options,
+                  IODebugContext* dbg) override {
+    assert(inspector_);
+    IOStatus s;
+    size_t size = data.size();
+    size_t offset = 0;
+    size_t allowed = 0;
+    while (offset < size) {
+      s = status_to_io_status(inspector_->Write(size - offset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= size - offset);
+      if (allowed > 0) {
+        s = FSWritableFileOwnerWrapper::Append(
+            Slice(data.data() + offset, allowed), options, dbg);
+        if (!s.ok()) {
+          break;
+        }
+      }
+      offset += allowed;
+    }
+    return s;
+  }
+
+  IOStatus Append(const Slice& data, const IOOptions& options,
+                  const DataVerificationInfo& verification_info,
+                  IODebugContext* dbg) override {
+    assert(inspector_);
+    IOStatus s;
+    size_t size = data.size();
+    size_t offset = 0;
+    size_t allowed = 0;
+    while (offset < size) {
+      s = status_to_io_status(inspector_->Write(size - offset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= size - offset);
+      if (allowed > 0) {
+        s = FSWritableFileOwnerWrapper::Append(
+            Slice(data.data() + offset, allowed), options, verification_info,
+            dbg);
+        if (!s.ok()) {
+          break;
+        }
+      }
+      offset += allowed;
+    }
+    return s;
+  }
+
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& options,
+                            IODebugContext* dbg) override {
+    assert(inspector_);
+    IOStatus s;
+    size_t size = data.size();
+    size_t roffset = 0;
+    size_t allowed = 0;
+    while (roffset < size) {
+      s = status_to_io_status(inspector_->Write(size - roffset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= size - roffset);
+      if (allowed > 0) {
+        s = FSWritableFileOwnerWrapper::PositionedAppend(
+            Slice(data.data() + roffset, allowed), offset + roffset, options,
+            dbg);
+        if (!s.ok()) {
+          break;
+        }
+      }
+      roffset += allowed;
+    }
+    return s;
+  }
+
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& options,
+                            const DataVerificationInfo& verification_info,
+                            IODebugContext* dbg) override {
+    assert(inspector_);
+    IOStatus s;
+    size_t size = data.size();
+    size_t roffset = 0;
+    size_t allowed = 0;
+    while (roffset < size) {
+      s = status_to_io_status(inspector_->Write(size - roffset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= size - roffset);
+      if (allowed > 0) {
+        s = FSWritableFileOwnerWrapper::PositionedAppend(
+            Slice(data.data() + roffset, allowed), offset + roffset, options,
+            verification_info, dbg);
+        if (!s.ok()) {
+          break;
+        }
+      }
+      roffset += allowed;
+    }
+    return s;
+  }
+
+ private:
+  std::shared_ptr<FileSystemInspector> inspector_;
+};
+
+class InspectedFSRandomRWFile : public FSRandomRWFileOwnerWrapper {
+ public:
+  InspectedFSRandomRWFile(std::unique_ptr<FSRandomRWFile>&& target,
+                          std::shared_ptr<FileSystemInspector> inspector)
+      : FSRandomRWFileOwnerWrapper(std::move(target)), inspector_(inspector) {}
+
+  IOStatus Write(uint64_t offset, const Slice& data, const IOOptions& options,
+                 IODebugContext* dbg) override {
+    assert(inspector_);
+    IOStatus s;
+    size_t size = data.size();
+    size_t roffset = 0;
+    size_t allowed = 0;
+    while (roffset < size) {
+      s = status_to_io_status(inspector_->Write(size - roffset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= size - roffset);
+      if (allowed > 0) {
+        s = FSRandomRWFileOwnerWrapper::Write(
+            offset + roffset, Slice(data.data() + roffset, allowed), options,
+            dbg);
+        if (!s.ok()) {
+          break;
+        }
+      }
+      roffset += allowed;
+    }
+    return s;
+  }
+
+  IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                Slice* result, char* scratch,
+                IODebugContext* dbg) const override {
+    assert(inspector_);
+    IOStatus s;
+    size_t roffset = 0;
+    size_t allowed = 0;
+    while (roffset < n) {
+      s = status_to_io_status(inspector_->Read(n - roffset, &allowed));
+      if (!s.ok()) {
+        return s;
+      }
+      assert(allowed <= n - roffset);
+      if (allowed > 0) {
+        s = FSRandomRWFileOwnerWrapper::Read(offset + roffset, allowed,
+                                             options, result,
+                                             scratch + roffset, dbg);
+        if (!s.ok()) {
+          return s;
+        }
+        size_t actual_read = result->size();
+        if (result->data() != scratch + roffset) {
+          memmove(scratch + roffset, result->data(), actual_read);
+          assert(false);
+        }
+        roffset += actual_read;
+        if (actual_read < allowed) {
+          break;
+        }
+      }
+    }
+    *result = Slice(scratch, roffset);
+    return s;
+  }
+
+ private:
+  std::shared_ptr<FileSystemInspector> inspector_;
+};
+
+FileSystemInspectedFS::FileSystemInspectedFS(
+    const std::shared_ptr<FileSystem>& base,
+    const std::shared_ptr<FileSystemInspector>& inspector)
+    : FileSystemWrapper(base), inspector_(inspector) {}
+
+IOStatus FileSystemInspectedFS::NewSequentialFile(
+    const std::string& fname, const FileOptions& options,
+    std::unique_ptr<FSSequentialFile>* result, IODebugContext* dbg) {
+  auto s = FileSystemWrapper::NewSequentialFile(fname, options, result, dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  result->reset(new InspectedFSSequentialFile(std::move(*result), inspector_));
+  return s;
+}
+
+IOStatus FileSystemInspectedFS::NewRandomAccessFile(
+    const std::string& fname, const FileOptions& options,
+    std::unique_ptr<FSRandomAccessFile>* result, IODebugContext* dbg) {
+  auto s = FileSystemWrapper::NewRandomAccessFile(fname, options, result, dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  result->reset(
+      new InspectedFSRandomAccessFile(std::move(*result), inspector_));
+  return s;
+}
+
+IOStatus FileSystemInspectedFS::NewWritableFile(
+    const std::string& fname, const FileOptions& options,
+    std::unique_ptr<FSWritableFile>* result, IODebugContext* dbg) {
+  auto s = FileSystemWrapper::NewWritableFile(fname, options, result, dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  result->reset(new InspectedFSWritableFile(std::move(*result), inspector_));
+  return s;
+}
+
+IOStatus FileSystemInspectedFS::ReopenWritableFile(
+    const std::string& fname, const FileOptions& options,
+    std::unique_ptr<FSWritableFile>* result, IODebugContext* dbg) {
+  auto s = FileSystemWrapper::ReopenWritableFile(fname, options, result, dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  result->reset(new InspectedFSWritableFile(std::move(*result), inspector_));
+  return s;
+}
+
+IOStatus FileSystemInspectedFS::ReuseWritableFile(
+    const std::string& fname, const std::string& old_fname,
+    const FileOptions& options, std::unique_ptr<FSWritableFile>* result,
+    IODebugContext* dbg) {
+  auto s = FileSystemWrapper::ReuseWritableFile(fname, old_fname, options,
+                                                result, dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  result->reset(new InspectedFSWritableFile(std::move(*result), inspector_));
+  return s;
+}
+
+IOStatus FileSystemInspectedFS::NewRandomRWFile(
+    const std::string& fname, const FileOptions& options,
+    std::unique_ptr<FSRandomRWFile>* result, IODebugContext* dbg) {
+  auto s = FileSystemWrapper::NewRandomRWFile(fname, options, result, dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  result->reset(new InspectedFSRandomRWFile(std::move(*result), inspector_));
+  return s;
+}
+
+void FileSystemInspectedFS::SupportedOps(int64_t& supported_ops) {
+  FileSystemWrapper::SupportedOps(supported_ops);
+  // The reads of the file system's buffers could not be split
+  supported_ops &= ~(1 << FSSupportedOps::kFSBuffer);
+}
+
+std::shared_ptr<FileSystem> NewFileSystemInspectedFS(
+    const std::shared_ptr<FileSystem>& base,
+    std::shared_ptr<FileSystemInspector> inspector) {
+  return std::make_shared<FileSystemInspectedFS>(base, inspector);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
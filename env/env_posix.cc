@@ -395,6 +395,34 @@ class PosixEnv : public CompositeEnv {
     return Status::OK();
   }
 
+  Status SetThreadPoolCpuAffinity(Priority pool,
+                                  const std::vector<int>& cpus) override {
+    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    return thread_pools_[pool].SetCpuAffinity(cpus);
+  }
+
+  Status SetThreadPoolFairScheduling(Priority pool, bool fair) override {
+    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    thread_pools_[pool].SetFairScheduling(fair);
+    return Status::OK();
+  }
+
+  Status SetThreadPoolSchedulingWeight(Priority pool, void* tag,
+                                       uint32_t weight) override {
+    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    thread_pools_[pool].SetSchedulingWeight(tag, weight);
+    return Status::OK();
+  }
+
+  Status GetThreadPoolQueueStats(Priority pool, void* tag,
+                                 ThreadPoolQueueStats* stats) override {
+    assert(pool >= Priority::BOTTOM && pool <= Priority::HIGH);
+    if (!thread_pools_[pool].GetQueueStats(tag, stats)) {
+      return Status::NotFound("Tag not registered with the thread pool");
+    }
+    return Status::OK();
+  }
+
  private:
   friend Env* Env::Default();
   // Constructs the default Env, a singleton
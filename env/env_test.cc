@@ -312,6 +312,58 @@ TEST_F(EnvPosixTest, LowerThreadPoolCpuPriority) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
 }
+
+TEST_F(EnvPosixTest, ThreadPoolCpuAffinity) {
+  cpu_set_t allowed;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  int first_cpu = 0;
+  while (!CPU_ISSET(first_cpu, &allowed)) {
+    first_cpu++;
+  }
+
+  ASSERT_TRUE(env_->SetThreadPoolCpuAffinity(Env::Priority::BOTTOM, {-1})
+                  .IsInvalidArgument());
+  ASSERT_TRUE(
+      env_->SetThreadPoolCpuAffinity(Env::Priority::BOTTOM, {CPU_SETSIZE})
+          .IsInvalidArgument());
+
+  env_->SetBackgroundThreads(1, Env::BOTTOM);
+  // Returns the number of CPUs a job of the pool may run on, and whether the
+  // first allowed CPU is one of them
+  auto RunTask = [&](int* num_cpus, bool* has_first_cpu) {
+    struct Arg {
+      std::atomic<bool> called{false};
+      cpu_set_t set;
+    } arg;
+    env_->Schedule(
+        [](void* a) {
+          auto* job_arg = static_cast<Arg*>(a);
+          ASSERT_EQ(sched_getaffinity(0, sizeof(job_arg->set), &job_arg->set),
+                    0);
+          job_arg->called.store(true);
+        },
+        &arg, Env::Priority::BOTTOM);
+    for (int i = 0; i < kDelayMicros && !arg.called.load(); i++) {
+      Env::Default()->SleepForMicroseconds(1);
+    }
+    ASSERT_TRUE(arg.called.load());
+    *num_cpus = CPU_COUNT(&arg.set);
+    *has_first_cpu = CPU_ISSET(first_cpu, &arg.set);
+  };
+
+  int num_cpus = 0;
+  bool has_first_cpu = false;
+  ASSERT_OK(env_->SetThreadPoolCpuAffinity(Env::Priority::BOTTOM, {first_cpu}));
+  RunTask(&num_cpus, &has_first_cpu);
+  ASSERT_EQ(num_cpus, 1);
+  ASSERT_TRUE(has_first_cpu);
+
+  // Lift the restriction
+  ASSERT_OK(env_->SetThreadPoolCpuAffinity(Env::Priority::BOTTOM, {}));
+  RunTask(&num_cpus, &has_first_cpu);
+  ASSERT_GE(num_cpus, CPU_COUNT(&allowed));
+  ASSERT_TRUE(has_first_cpu);
+}
 #endif
 
 TEST_F(EnvPosixTest, MemoryMappedFileBuffer) {
@@ -349,6 +401,42 @@ TEST_F(EnvPosixTest, MemoryMappedFileBuffer) {
   ASSERT_EQ(expected_data, actual_data);
 }
 
+#ifdef OS_LINUX
+TEST_F(EnvPosixTest, MmapReadPrefetch) {
+  const int kFileBytes = 3 * 4096 + 100;
+  std::string expected_data;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+  {
+    std::unique_ptr<WritableFile> wfile;
+    const EnvOptions soptions;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+
+    Random rnd(301);
+    expected_data = rnd.RandomString(kFileBytes);
+    ASSERT_OK(wfile->Append(expected_data));
+  }
+
+  FileOptions file_options;
+  file_options.use_mmap_reads = true;
+  std::unique_ptr<FSRandomAccessFile> file;
+  const auto& fs = env_->GetFileSystem();
+  ASSERT_OK(fs->NewRandomAccessFile(fname, file_options, &file, nullptr));
+  file->Hint(FSRandomAccessFile::kRandom);
+
+  // Ranges of mapped files are advised to be read ahead, wherever they start
+  // and end, even past the end of the file
+  const IOOptions io_options;
+  ASSERT_OK(file->Prefetch(0, kFileBytes, io_options, nullptr));
+  ASSERT_OK(file->Prefetch(4097, 5000, io_options, nullptr));
+  ASSERT_OK(file->Prefetch(kFileBytes - 10, 1 << 20, io_options, nullptr));
+  ASSERT_OK(file->Prefetch(kFileBytes + 4096, 100, io_options, nullptr));
+
+  Slice result;
+  ASSERT_OK(file->Read(4097, 5000, io_options, &result, nullptr, nullptr));
+  ASSERT_EQ(expected_data.substr(4097, 5000), result.ToString());
+}
+#endif  // OS_LINUX
+
 #ifndef ROCKSDB_NO_DYNAMIC_EXTENSION
 TEST_F(EnvPosixTest, LoadRocksDBLibrary) {
   std::shared_ptr<DynamicLibrary> library;
@@ -431,6 +519,72 @@ TEST_P(EnvPosixTestWithParam, UnSchedule) {
   WaitThreadPoolsEmpty();
 }
 
+TEST_P(EnvPosixTestWithParam, FairScheduling) {
+  env_->SetBackgroundThreads(1, Env::LOW);
+  int tag_a = 0;
+  int tag_b = 0;
+  ASSERT_OK(env_->SetThreadPoolSchedulingWeight(Env::LOW, &tag_a, 2));
+  ThreadPoolQueueStats stats;
+  ASSERT_TRUE(
+      env_->GetThreadPoolQueueStats(Env::LOW, &tag_b, &stats).IsNotFound());
+
+  // Records the order the jobs ran in
+  struct Job {
+    std::mutex* mu;
+    std::string* order;
+    char name;
+  };
+  std::mutex mu;
+  std::string order;
+  std::vector<Job> jobs;
+  for (char name : std::string("ABCDE")) {
+    jobs.push_back({&mu, &order, name});
+  }
+  auto run_job = [](void* arg) {
+    auto* job = static_cast<Job*>(arg);
+    std::lock_guard<std::mutex> lock(*job->mu);
+    job->order->push_back(job->name);
+  };
+
+  // Block the pool while the jobs are queued
+  test::SleepingBackgroundTask sleeping_task;
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &sleeping_task,
+                 Env::Priority::LOW);
+  sleeping_task.WaitUntilSleeping();
+  ASSERT_OK(env_->SetThreadPoolFairScheduling(Env::LOW, true));
+  // A, B and C for tag_a, D and E for tag_b
+  for (size_t i = 0; i < jobs.size(); i++) {
+    env_->Schedule(run_job, &jobs[i], Env::Priority::LOW,
+                   i < 3 ? &tag_a : &tag_b);
+  }
+  sleeping_task.WakeUp();
+  sleeping_task.WaitUntilDone();
+  WaitThreadPoolsEmpty();
+  for (int i = 0; i < kDelayMicros; i++) {
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      if (order.size() == jobs.size()) {
+        break;
+      }
+    }
+    Env::Default()->SleepForMicroseconds(1);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    // tag_a runs two jobs per turn
+    ASSERT_EQ(order, "ABDCE");
+  }
+
+  ASSERT_OK(env_->GetThreadPoolQueueStats(Env::LOW, &tag_a, &stats));
+  ASSERT_EQ(stats.num_jobs, 3U);
+  ASSERT_LE(stats.total_wait_micros, 3 * stats.max_wait_micros);
+
+  ASSERT_OK(env_->SetThreadPoolFairScheduling(Env::LOW, false));
+  ASSERT_OK(env_->SetThreadPoolSchedulingWeight(Env::LOW, &tag_a, 0));
+  ASSERT_TRUE(
+      env_->GetThreadPoolQueueStats(Env::LOW, &tag_a, &stats).IsNotFound());
+}
+
 // This tests assumes that the last scheduled
 // task will run last. In fact, in the allotted
 // sleeping time nothing may actually run or they may
@@ -1736,6 +1890,37 @@ TEST_F(EnvPosixTest, MultiReadIOUringError2) {
 }
 #endif  // ROCKSDB_IOURING_PRESENT
 
+TEST_F(EnvPosixTest, IOUringWrites) {
+  // Falls back to write(2) when io_uring is not available, in which case this
+  // only checks that the option does no harm.
+  EnvOptions soptions;
+  soptions.use_mmap_writes = false;
+  soptions.use_io_uring_writes = true;
+  std::string fname = test::PerThreadDBPath(env_, "uring_writes");
+
+  std::unique_ptr<WritableFile> file;
+  ASSERT_OK(env_->NewWritableFile(fname, &file, soptions));
+  // More appends than the ring holds, with a sync in the middle.
+  std::string expected;
+  Random rnd(301);
+  for (int i = 0; i < 600; i++) {
+    std::string chunk = rnd.RandomString(1 + rnd.Uniform(4096));
+    ASSERT_OK(file->Append(chunk));
+    expected += chunk;
+    if (i == 300) {
+      ASSERT_OK(file->Sync());
+    }
+  }
+  ASSERT_EQ(expected.size(), file->GetFileSize());
+  ASSERT_OK(file->Fsync());
+  ASSERT_OK(file->Close());
+
+  std::string actual;
+  ASSERT_OK(ReadFileToString(env_, fname, &actual));
+  ASSERT_EQ(expected, actual);
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
 // Only works in linux platforms
 #ifdef OS_WIN
 TEST_P(EnvPosixTestWithParam, DISABLED_InvalidateCache) {
@@ -0,0 +1,167 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "env/fs_io_scheduler.h"
+
+#include "monitoring/statistics_impl.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+const Histograms kQueueHistograms[Env::IO_USER + 1] = {
+    IO_SCHEDULER_QUEUE_LOW_MICROS, IO_SCHEDULER_QUEUE_MID_MICROS,
+    IO_SCHEDULER_QUEUE_HIGH_MICROS, IO_SCHEDULER_QUEUE_USER_MICROS};
+
+class IOSchedulingRandomAccessFile : public FSRandomAccessFileOwnerWrapper {
+ public:
+  IOSchedulingRandomAccessFile(std::unique_ptr<FSRandomAccessFile>&& file,
+                               const std::shared_ptr<IOScheduler>& scheduler)
+      : FSRandomAccessFileOwnerWrapper(std::move(file)),
+        scheduler_(scheduler) {}
+
+  IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                Slice* result, char* scratch,
+                IODebugContext* dbg) const override {
+    scheduler_->Admit(options.rate_limiter_priority);
+    IOStatus s = target()->Read(offset, n, options, result, scratch, dbg);
+    scheduler_->Release(options.rate_limiter_priority);
+    return s;
+  }
+
+  // The requests are issued together, so they are admitted as one read
+  IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
+                     const IOOptions& options, IODebugContext* dbg) override {
+    scheduler_->Admit(options.rate_limiter_priority);
+    IOStatus s = target()->MultiRead(reqs, num_reqs, options, dbg);
+    scheduler_->Release(options.rate_limiter_priority);
+    return s;
+  }
+
+ private:
+  const std::shared_ptr<IOScheduler> scheduler_;
+};
+}  // namespace
+
+IOScheduler::IOScheduler(const IOSchedulerOptions& opts)
+    : opts_(opts), clock_(SystemClock::Default().get()) {}
+
+void IOScheduler::Admit(Env::IOPriority pri) {
+  pri = Normalize(pri);
+  uint64_t queue_micros = 0;
+  {
+    MutexLock l(&mutex_);
+    bool waiting_ahead = false;
+    for (int p = pri; p <= Env::IO_USER; ++p) {
+      waiting_ahead = waiting_ahead || !queues_[p].empty();
+    }
+    if (!waiting_ahead && HasRoom(pri)) {
+      AddOutstanding(pri);
+    } else {
+      Waiter waiter(&mutex_, clock_->NowMicros());
+      queues_[pri].push_back(&waiter);
+      while (!waiter.admitted) {
+        waiter.cv.Wait();
+      }
+      queue_micros = clock_->NowMicros() - waiter.enqueue_micros;
+    }
+  }
+  RecordInHistogram(opts_.statistics.get(), kQueueHistograms[pri],
+                    queue_micros);
+}
+
+void IOScheduler::Release(Env::IOPriority pri) {
+  pri = Normalize(pri);
+  MutexLock l(&mutex_);
+  assert(outstanding_ > 0);
+  outstanding_--;
+  if (pri != Env::IO_USER) {
+    assert(outstanding_low_pri_ > 0);
+    outstanding_low_pri_--;
+  }
+  AdmitWaiters();
+}
+
+void IOScheduler::AdmitWaiters() {
+  mutex_.AssertHeld();
+  uint64_t now = 0;
+  for (;;) {
+    Waiter* next = nullptr;
+    Env::IOPriority next_pri = Env::IO_USER;
+    if (opts_.max_queue_micros > 0 && HasRoom(Env::IO_LOW)) {
+      for (int p = Env::IO_LOW; p < Env::IO_USER; ++p) {
+        if (queues_[p].empty()) {
+          continue;
+        }
+        Waiter* waiter = queues_[p].front();
+        if (now == 0) {
+          now = clock_->NowMicros();
+        }
+        if (now - waiter->enqueue_micros >= opts_.max_queue_micros &&
+            (next == nullptr ||
+             waiter->enqueue_micros < next->enqueue_micros)) {
+          next = waiter;
+          next_pri = static_cast<Env::IOPriority>(p);
+        }
+      }
+    }
+    for (int p = Env::IO_USER; next == nullptr && p >= Env::IO_LOW; --p) {
+      if (!queues_[p].empty() && HasRoom(static_cast<Env::IOPriority>(p))) {
+        next = queues_[p].front();
+        next_pri = static_cast<Env::IOPriority>(p);
+      }
+    }
+    if (next == nullptr) {
+      return;
+    }
+    queues_[next_pri].pop_front();
+    AddOutstanding(next_pri);
+    next->admitted = true;
+    next->cv.Signal();
+  }
+}
+
+size_t IOScheduler::TEST_GetNumQueued() {
+  MutexLock l(&mutex_);
+  size_t result = 0;
+  for (const auto& queue : queues_) {
+    result += queue.size();
+  }
+  return result;
+}
+
+IOSchedulingFileSystem::IOSchedulingFileSystem(
+    const std::shared_ptr<FileSystem>& base, const IOSchedulerOptions& opts)
+    : FileSystemWrapper(base),
+      scheduler_(std::make_shared<IOScheduler>(opts)) {}
+
+IOStatus IOSchedulingFileSystem::NewRandomAccessFile(
+    const std::string& fname, const FileOptions& options,
+    std::unique_ptr<FSRandomAccessFile>* result, IODebugContext* dbg) {
+  std::unique_ptr<FSRandomAccessFile> file;
+  IOStatus s = target()->NewRandomAccessFile(fname, options, &file, dbg);
+  if (s.ok()) {
+    result->reset(
+        new IOSchedulingRandomAccessFile(std::move(file), scheduler_));
+  }
+  return s;
+}
+
+Status NewIOSchedulingFileSystem(const std::shared_ptr<FileSystem>& base,
+                                 const IOSchedulerOptions& opts,
+                                 std::shared_ptr<FileSystem>* result) {
+  if (base == nullptr) {
+    return Status::InvalidArgument("No file system to wrap");
+  }
+  if (opts.max_outstanding_reads <= 0 ||
+      opts.max_outstanding_low_pri_reads <= 0) {
+    return Status::InvalidArgument(
+        "Max outstanding reads of IOSchedulerOptions must be positive");
+  }
+  *result = std::make_shared<IOSchedulingFileSystem>(base, opts);
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
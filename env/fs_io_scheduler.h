@@ -0,0 +1,102 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "port/port.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/system_clock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Decides when reads may be issued to the file system, see
+// IOSchedulerOptions. Reads are admitted right away while there is room for
+// them and no read of the same or higher priority is waiting. Otherwise they
+// wait in the queue of their priority, and each completed read admits the
+// next ones: first any read of priority below Env::IO_USER past its
+// deadline, then the reads of the highest priority with room.
+class IOScheduler {
+ public:
+  explicit IOScheduler(const IOSchedulerOptions& opts);
+
+  // Blocks until a read of priority `pri` may be issued. Each call must be
+  // followed by Release() with the same priority once the read completes.
+  void Admit(Env::IOPriority pri);
+
+  void Release(Env::IOPriority pri);
+
+  size_t TEST_GetNumQueued();
+
+ private:
+  struct Waiter {
+    Waiter(port::Mutex* mu, uint64_t now) : cv(mu), enqueue_micros(now) {}
+
+    port::CondVar cv;
+    const uint64_t enqueue_micros;
+    bool admitted = false;
+  };
+
+  // Reads without a priority are treated as user reads
+  static Env::IOPriority Normalize(Env::IOPriority pri) {
+    return pri < Env::IO_USER ? pri : Env::IO_USER;
+  }
+
+  // REQUIRES: holding mutex_
+  bool HasRoom(Env::IOPriority pri) const {
+    return outstanding_ < opts_.max_outstanding_reads &&
+           (pri == Env::IO_USER ||
+            outstanding_low_pri_ < opts_.max_outstanding_low_pri_reads);
+  }
+
+  // REQUIRES: holding mutex_
+  void AddOutstanding(Env::IOPriority pri) {
+    outstanding_++;
+    if (pri != Env::IO_USER) {
+      outstanding_low_pri_++;
+    }
+  }
+
+  // Admits waiting reads while there is room for them.
+  // REQUIRES: holding mutex_
+  void AdmitWaiters();
+
+  const IOSchedulerOptions opts_;
+  SystemClock* const clock_;
+
+  // Protects the following
+  port::Mutex mutex_;
+  int outstanding_ = 0;
+  int outstanding_low_pri_ = 0;
+  // Waiting reads of each priority, oldest first
+  std::deque<Waiter*> queues_[Env::IO_USER + 1];
+};
+
+// Schedules the reads of the random access files it opens with an
+// IOScheduler shared by all of them
+class IOSchedulingFileSystem : public FileSystemWrapper {
+ public:
+  IOSchedulingFileSystem(const std::shared_ptr<FileSystem>& base,
+                         const IOSchedulerOptions& opts);
+
+  static const char* kClassName() { return "IOSchedulingFileSystem"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& options,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override;
+
+  IOScheduler* TEST_GetScheduler() { return scheduler_.get(); }
+
+ private:
+  // Shared with the files, which may outlive the file system
+  std::shared_ptr<IOScheduler> scheduler_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,155 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "env/fs_io_scheduler.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/statistics.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class IOSchedulerTest : public testing::Test {
+ protected:
+  // Admits a read of the priority from a new thread, which then records
+  // `id` and completes the read
+  void StartRead(IOScheduler* scheduler, Env::IOPriority pri, int id) {
+    size_t queued = scheduler->TEST_GetNumQueued();
+    threads_.emplace_back([this, scheduler, pri, id]() {
+      scheduler->Admit(pri);
+      {
+        MutexLock l(&mutex_);
+        order_.push_back(id);
+      }
+      scheduler->Release(pri);
+    });
+    while (scheduler->TEST_GetNumQueued() == queued) {
+      std::this_thread::yield();
+    }
+  }
+
+  std::vector<int> JoinReads() {
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+    return order_;
+  }
+
+  port::Mutex mutex_;
+  std::vector<int> order_;
+  std::vector<port::Thread> threads_;
+};
+
+TEST_F(IOSchedulerTest, UserReadsJumpAhead) {
+  IOSchedulerOptions opts;
+  opts.max_outstanding_reads = 1;
+  opts.max_queue_micros = 0;
+  IOScheduler scheduler(opts);
+
+  scheduler.Admit(Env::IO_LOW);
+  StartRead(&scheduler, Env::IO_LOW, 1);
+  StartRead(&scheduler, Env::IO_HIGH, 2);
+  StartRead(&scheduler, Env::IO_TOTAL, 3);
+  StartRead(&scheduler, Env::IO_USER, 4);
+  ASSERT_EQ(scheduler.TEST_GetNumQueued(), 4U);
+  scheduler.Release(Env::IO_LOW);
+  ASSERT_EQ(JoinReads(), std::vector<int>({3, 4, 2, 1}));
+}
+
+TEST_F(IOSchedulerTest, LowPriDepth) {
+  IOSchedulerOptions opts;
+  opts.max_outstanding_reads = 2;
+  opts.max_outstanding_low_pri_reads = 1;
+  IOScheduler scheduler(opts);
+
+  scheduler.Admit(Env::IO_MID);
+  // Room is left for user reads
+  scheduler.Admit(Env::IO_USER);
+  StartRead(&scheduler, Env::IO_HIGH, 1);
+  scheduler.Release(Env::IO_USER);
+  ASSERT_EQ(scheduler.TEST_GetNumQueued(), 1U);
+  scheduler.Release(Env::IO_MID);
+  ASSERT_EQ(JoinReads(), std::vector<int>({1}));
+  ASSERT_EQ(scheduler.TEST_GetNumQueued(), 0U);
+}
+
+TEST_F(IOSchedulerTest, LowPriDeadline) {
+  IOSchedulerOptions opts;
+  opts.max_outstanding_reads = 1;
+  opts.max_queue_micros = 1000;
+  IOScheduler scheduler(opts);
+
+  scheduler.Admit(Env::IO_USER);
+  StartRead(&scheduler, Env::IO_LOW, 1);
+  StartRead(&scheduler, Env::IO_MID, 2);
+  SystemClock::Default()->SleepForMicroseconds(
+      static_cast<int>(2 * opts.max_queue_micros));
+  StartRead(&scheduler, Env::IO_USER, 3);
+  // The low priority reads are past their deadline, so are issued first,
+  // the oldest first
+  scheduler.Release(Env::IO_USER);
+  ASSERT_EQ(JoinReads(), std::vector<int>({1, 2, 3}));
+}
+
+TEST_F(IOSchedulerTest, FileSystem) {
+  IOSchedulerOptions opts;
+  std::shared_ptr<FileSystem> fs;
+  ASSERT_TRUE(
+      NewIOSchedulingFileSystem(nullptr, opts, &fs).IsInvalidArgument());
+  opts.max_outstanding_low_pri_reads = 0;
+  ASSERT_TRUE(NewIOSchedulingFileSystem(FileSystem::Default(), opts, &fs)
+                  .IsInvalidArgument());
+  opts.max_outstanding_low_pri_reads = 1;
+  opts.statistics = CreateDBStatistics();
+  ASSERT_OK(NewIOSchedulingFileSystem(FileSystem::Default(), opts, &fs));
+
+  const std::string fname = test::PerThreadDBPath("io_scheduler_test_file");
+  const std::string data = "0123456789";
+  ASSERT_OK(WriteStringToFile(fs.get(), data, fname));
+  std::unique_ptr<FSRandomAccessFile> file;
+  ASSERT_OK(fs->NewRandomAccessFile(fname, FileOptions(), &file, nullptr));
+
+  IOOptions io_opts;
+  char scratch[4];
+  Slice result;
+  io_opts.rate_limiter_priority = Env::IO_USER;
+  ASSERT_OK(file->Read(2, 4, io_opts, &result, scratch, nullptr));
+  ASSERT_EQ(result.ToString(), "2345");
+
+  io_opts.rate_limiter_priority = Env::IO_LOW;
+  FSReadRequest req;
+  req.offset = 6;
+  req.len = 4;
+  req.scratch = scratch;
+  ASSERT_OK(file->MultiRead(&req, 1, io_opts, nullptr));
+  ASSERT_OK(req.status);
+  ASSERT_EQ(req.result.ToString(), "6789");
+
+  HistogramData user_queue;
+  opts.statistics->histogramData(IO_SCHEDULER_QUEUE_USER_MICROS, &user_queue);
+  ASSERT_EQ(user_queue.count, 1U);
+  HistogramData low_queue;
+  opts.statistics->histogramData(IO_SCHEDULER_QUEUE_LOW_MICROS, &low_queue);
+  ASSERT_EQ(low_queue.count, 1U);
+
+  file.reset();
+  ASSERT_OK(fs->DeleteFile(fname, IOOptions(), nullptr));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
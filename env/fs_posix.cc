@@ -246,8 +246,8 @@ class PosixFileSystem : public FileSystem {
       if (s.ok()) {
         void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
         if (base != MAP_FAILED) {
-          result->reset(
-              new PosixMmapReadableFile(fd, fname, base, size, options));
+          result->reset(new PosixMmapReadableFile(fd, fname, base, size,
+                                                  page_size_, options));
         } else {
           s = IOError("while mmap file for read", fname, errno);
           close(fd);
@@ -919,6 +919,10 @@ class PosixFileSystem : public FileSystem {
     optimized.fallocate_with_keep_size = true;
     optimized.writable_file_max_buffer_size =
         db_options.writable_file_max_buffer_size;
+#ifdef ROCKSDB_IOURING_PRESENT
+    optimized.use_io_uring_writes =
+        db_options.wal_use_io_uring && IsIOUringEnabled();
+#endif  // ROCKSDB_IOURING_PRESENT
     return optimized;
   }
 
@@ -989,7 +993,7 @@ class PosixFileSystem : public FileSystem {
   }
 
 #ifdef ROCKSDB_IOURING_PRESENT
-  bool IsIOUringEnabled() {
+  bool IsIOUringEnabled() const {
     if (RocksDbIOUringEnable && RocksDbIOUringEnable()) {
       return true;
     } else {
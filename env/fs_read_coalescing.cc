@@ -0,0 +1,304 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "env/fs_read_coalescing.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "port/port.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+class ReadCoalescingRandomAccessFile : public FSRandomAccessFileOwnerWrapper {
+ public:
+  // Without a local copy of the tail when `tail_path` is empty
+  ReadCoalescingRandomAccessFile(std::unique_ptr<FSRandomAccessFile>&& file,
+                                 const ReadCoalescingOptions& opts,
+                                 const std::string& tail_path,
+                                 uint64_t tail_offset, size_t tail_size)
+      : FSRandomAccessFileOwnerWrapper(std::move(file)),
+        max_gap_bytes_(opts.max_gap_bytes),
+        max_merged_bytes_(opts.max_merged_bytes),
+        local_fs_(opts.local_fs),
+        tail_path_(tail_path),
+        tail_offset_(tail_offset),
+        tail_size_(tail_size) {}
+
+  IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                Slice* result, char* scratch,
+                IODebugContext* dbg) const override {
+    FSRandomAccessFile* tail = InTail(offset) ? GetTail(options, dbg) : nullptr;
+    if (tail != nullptr) {
+      return tail->Read(offset - tail_offset_, n, options, result, scratch,
+                        dbg);
+    }
+    return target()->Read(offset, n, options, result, scratch, dbg);
+  }
+
+  IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
+                     const IOOptions& options, IODebugContext* dbg) override;
+
+ private:
+  bool InTail(uint64_t offset) const {
+    return !tail_path_.empty() && offset >= tail_offset_;
+  }
+
+  // Returns the local copy of the tail, making it first if needed, or
+  // nullptr if it cannot be made, in which case the file is read as is
+  FSRandomAccessFile* GetTail(const IOOptions& options,
+                              IODebugContext* dbg) const;
+
+  const size_t max_gap_bytes_;
+  const size_t max_merged_bytes_;
+  const std::shared_ptr<FileSystem> local_fs_;
+  const std::string tail_path_;
+  const uint64_t tail_offset_;
+  const size_t tail_size_;
+
+  mutable port::Mutex tail_mutex_;
+  // Protected by tail_mutex_
+  mutable std::unique_ptr<FSRandomAccessFile> tail_;
+  mutable bool tail_failed_ = false;
+};
+
+FSRandomAccessFile* ReadCoalescingRandomAccessFile::GetTail(
+    const IOOptions& options, IODebugContext* dbg) const {
+  MutexLock l(&tail_mutex_);
+  if (tail_ != nullptr || tail_failed_) {
+    return tail_.get();
+  }
+  // Another reader of the file may have made the copy already
+  uint64_t size = 0;
+  IOStatus s = local_fs_->GetFileSize(tail_path_, options, &size, dbg);
+  if (!s.ok() || size != tail_size_) {
+    std::unique_ptr<char[]> buf(new char[tail_size_]);
+    Slice data;
+    s = target()->Read(tail_offset_, tail_size_, options, &data, buf.get(),
+                       dbg);
+    if (s.ok() && data.size() != tail_size_) {
+      s = IOStatus::Corruption("Short read of SST file tail");
+    }
+    // Written under a temporary name so that no reader finds it partial
+    const std::string tmp_path = tail_path_ + ".tmp";
+    if (s.ok()) {
+      s = WriteStringToFile(local_fs_.get(), data, tmp_path);
+    }
+    if (s.ok()) {
+      s = local_fs_->RenameFile(tmp_path, tail_path_, options, dbg);
+    }
+  }
+  if (s.ok()) {
+    s = local_fs_->NewRandomAccessFile(tail_path_, FileOptions(), &tail_, dbg);
+  }
+  if (!s.ok()) {
+    tail_failed_ = true;
+    tail_.reset();
+  }
+  return tail_.get();
+}
+
+IOStatus ReadCoalescingRandomAccessFile::MultiRead(FSReadRequest* reqs,
+                                                   size_t num_reqs,
+                                                   const IOOptions& options,
+                                                   IODebugContext* dbg) {
+  // Requests served from the local copy of the tail are done first, the
+  // others are sorted by offset
+  std::vector<size_t> order;
+  order.reserve(num_reqs);
+  for (size_t i = 0; i < num_reqs; ++i) {
+    FSRandomAccessFile* tail =
+        InTail(reqs[i].offset) ? GetTail(options, dbg) : nullptr;
+    if (tail != nullptr) {
+      reqs[i].status =
+          tail->Read(reqs[i].offset - tail_offset_, reqs[i].len, options,
+                     &reqs[i].result, reqs[i].scratch, dbg);
+    } else {
+      order.push_back(i);
+    }
+  }
+  if (order.size() == num_reqs && (num_reqs <= 1 || use_direct_io())) {
+    // Nothing to merge. Direct IO buffers would have to be aligned.
+    return target()->MultiRead(reqs, num_reqs, options, dbg);
+  }
+  std::sort(order.begin(), order.end(), [reqs](size_t a, size_t b) {
+    return reqs[a].offset < reqs[b].offset;
+  });
+
+  // Each merged request covers the requests order[first[j]..first[j+1])
+  std::vector<FSReadRequest> merged;
+  std::vector<size_t> first;
+  std::vector<std::unique_ptr<char[]>> bufs;
+  for (size_t k = 0; k < order.size(); ++k) {
+    const FSReadRequest& req = reqs[order[k]];
+    const uint64_t end = req.offset + req.len;
+    if (!merged.empty() && !use_direct_io()) {
+      FSReadRequest& last = merged.back();
+      const uint64_t last_end = last.offset + last.len;
+      const uint64_t new_end = std::max(last_end, end);
+      if (req.offset <= last_end + max_gap_bytes_ &&
+          new_end - last.offset <= max_merged_bytes_) {
+        last.len = static_cast<size_t>(new_end - last.offset);
+        continue;
+      }
+    }
+    merged.emplace_back();
+    merged.back().offset = req.offset;
+    merged.back().len = req.len;
+    first.push_back(k);
+  }
+  first.push_back(order.size());
+  for (size_t j = 0; j < merged.size(); ++j) {
+    if (first[j + 1] - first[j] == 1) {
+      // Read into the scratch of the one request
+      merged[j].scratch = reqs[order[first[j]]].scratch;
+    } else {
+      bufs.emplace_back(new char[merged[j].len]);
+      merged[j].scratch = bufs.back().get();
+    }
+  }
+
+  IOStatus s;
+  if (!merged.empty()) {
+    s = target()->MultiRead(merged.data(), merged.size(), options, dbg);
+  }
+  for (size_t j = 0; j < merged.size(); ++j) {
+    const FSReadRequest& m = merged[j];
+    for (size_t k = first[j]; k < first[j + 1]; ++k) {
+      FSReadRequest& req = reqs[order[k]];
+      req.status = s.ok() ? m.status : s;
+      if (!req.status.ok()) {
+        continue;
+      }
+      if (m.scratch == req.scratch) {
+        req.result = m.result;
+        continue;
+      }
+      // The merged read may be short at the end of the file
+      const uint64_t pos = req.offset - m.offset;
+      const size_t len =
+          pos < m.result.size()
+              ? std::min(req.len, static_cast<size_t>(m.result.size() - pos))
+              : 0;
+      if (len > 0) {
+        std::memcpy(req.scratch, m.result.data() + pos, len);
+      }
+      req.result = Slice(req.scratch, len);
+    }
+  }
+  return s;
+}
+}  // namespace
+
+ReadCoalescingFileSystem::ReadCoalescingFileSystem(
+    const std::shared_ptr<FileSystem>& base, const ReadCoalescingOptions& opts)
+    : FileSystemWrapper(base), opts_(opts) {
+  if (opts_.local_fs == nullptr) {
+    opts_.local_fs = FileSystem::Default();
+  }
+}
+
+std::string ReadCoalescingFileSystem::TailCachePath(
+    const std::string& fname) const {
+  if (opts_.tail_cache_dir.empty() || !EndsWith(fname, ".sst")) {
+    return "";
+  }
+  // The hash of the full name tells apart files of the same name in
+  // different directories
+  const size_t sep = fname.find_last_of('/');
+  const std::string base =
+      sep == std::string::npos ? fname : fname.substr(sep + 1);
+  char hash[17];
+  snprintf(hash, sizeof(hash), "%016" PRIx64,
+           Hash64(fname.data(), fname.size()));
+  return opts_.tail_cache_dir + "/" + hash + "-" + base;
+}
+
+void ReadCoalescingFileSystem::DropTailCache(const std::string& fname) {
+  const std::string tail_path = TailCachePath(fname);
+  if (!tail_path.empty()) {
+    // Usually there is no copy
+    opts_.local_fs->DeleteFile(tail_path, IOOptions(), nullptr)
+        .PermitUncheckedError();
+  }
+}
+
+IOStatus ReadCoalescingFileSystem::NewRandomAccessFile(
+    const std::string& fname, const FileOptions& options,
+    std::unique_ptr<FSRandomAccessFile>* result, IODebugContext* dbg) {
+  std::unique_ptr<FSRandomAccessFile> file;
+  IOStatus s = target()->NewRandomAccessFile(fname, options, &file, dbg);
+  if (!s.ok()) {
+    return s;
+  }
+  std::string tail_path = TailCachePath(fname);
+  uint64_t file_size = 0;
+  if (!tail_path.empty()) {
+    s = target()->GetFileSize(fname, options.io_options, &file_size, dbg);
+    if (!s.ok()) {
+      return s;
+    }
+    if (file_size == 0) {
+      tail_path.clear();
+    }
+  }
+  const size_t tail_size = static_cast<size_t>(
+      std::min<uint64_t>(file_size, opts_.tail_cache_bytes));
+  result->reset(new ReadCoalescingRandomAccessFile(
+      std::move(file), opts_, tail_path, file_size - tail_size, tail_size));
+  return s;
+}
+
+IOStatus ReadCoalescingFileSystem::DeleteFile(const std::string& fname,
+                                              const IOOptions& options,
+                                              IODebugContext* dbg) {
+  DropTailCache(fname);
+  return target()->DeleteFile(fname, options, dbg);
+}
+
+IOStatus ReadCoalescingFileSystem::RenameFile(const std::string& src,
+                                              const std::string& target,
+                                              const IOOptions& options,
+                                              IODebugContext* dbg) {
+  DropTailCache(src);
+  DropTailCache(target);
+  return FileSystemWrapper::RenameFile(src, target, options, dbg);
+}
+
+Status NewReadCoalescingFileSystem(const std::shared_ptr<FileSystem>& base,
+                                   const ReadCoalescingOptions& opts,
+                                   std::shared_ptr<FileSystem>* result) {
+  if (base == nullptr) {
+    return Status::InvalidArgument("No file system to wrap");
+  }
+  if (opts.max_merged_bytes == 0) {
+    return Status::InvalidArgument(
+        "max_merged_bytes of ReadCoalescingOptions must be positive");
+  }
+  if (!opts.tail_cache_dir.empty()) {
+    if (opts.tail_cache_bytes == 0) {
+      return Status::InvalidArgument(
+          "tail_cache_bytes of ReadCoalescingOptions must be positive");
+    }
+    FileSystem* local_fs =
+        opts.local_fs ? opts.local_fs.get() : FileSystem::Default().get();
+    Status s = local_fs->CreateDirIfMissing(opts.tail_cache_dir, IOOptions(),
+                                            nullptr);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  *result = std::make_shared<ReadCoalescingFileSystem>(base, opts);
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,53 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/file_system.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Merges the MultiRead() requests of the random access files it opens, and
+// keeps local copies of the tails of SST files, see ReadCoalescingOptions
+class ReadCoalescingFileSystem : public FileSystemWrapper {
+ public:
+  ReadCoalescingFileSystem(const std::shared_ptr<FileSystem>& base,
+                           const ReadCoalescingOptions& opts);
+
+  static const char* kClassName() { return "ReadCoalescingFileSystem"; }
+  const char* Name() const override { return kClassName(); }
+
+  // Requests are merged into buffers of this file system, so it must be
+  // passed the scratch buffers to copy them into
+  void SupportedOps(int64_t& supported_ops) override {
+    target()->SupportedOps(supported_ops);
+    supported_ops &= ~(1 << FSSupportedOps::kFSBuffer);
+  }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& options,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override;
+
+  IOStatus DeleteFile(const std::string& fname, const IOOptions& options,
+                      IODebugContext* dbg) override;
+
+  IOStatus RenameFile(const std::string& src, const std::string& target,
+                      const IOOptions& options, IODebugContext* dbg) override;
+
+  // Name of the local copy of the tail of `fname`, empty if there is none
+  // to keep
+  std::string TailCachePath(const std::string& fname) const;
+
+ private:
+  void DropTailCache(const std::string& fname);
+
+  ReadCoalescingOptions opts_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,205 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "env/fs_read_coalescing.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "file/file_util.h"
+#include "port/port.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Counts the reads of the random access files it opens, MultiRead()
+// requests counted one by one
+class ReadCountingFileSystem : public FileSystemWrapper {
+ public:
+  explicit ReadCountingFileSystem(const std::shared_ptr<FileSystem>& base)
+      : FileSystemWrapper(base) {}
+
+  static const char* kClassName() { return "ReadCountingFileSystem"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& options,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    class CountingFile : public FSRandomAccessFileOwnerWrapper {
+     public:
+      CountingFile(std::unique_ptr<FSRandomAccessFile>&& file,
+                   std::atomic<int>* reads)
+          : FSRandomAccessFileOwnerWrapper(std::move(file)), reads_(reads) {}
+
+      IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                    Slice* result, char* scratch,
+                    IODebugContext* dbg) const override {
+        (*reads_)++;
+        return target()->Read(offset, n, options, result, scratch, dbg);
+      }
+
+      IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
+                         const IOOptions& options,
+                         IODebugContext* dbg) override {
+        *reads_ += static_cast<int>(num_reqs);
+        return target()->MultiRead(reqs, num_reqs, options, dbg);
+      }
+
+     private:
+      std::atomic<int>* reads_;
+    };
+
+    std::unique_ptr<FSRandomAccessFile> file;
+    IOStatus s = target()->NewRandomAccessFile(fname, options, &file, dbg);
+    if (s.ok()) {
+      result->reset(new CountingFile(std::move(file), &reads_));
+    }
+    return s;
+  }
+
+  std::atomic<int> reads_{0};
+};
+}  // namespace
+
+class ReadCoalescingTest : public testing::Test {
+ protected:
+  ReadCoalescingTest()
+      : counting_fs_(
+            std::make_shared<ReadCountingFileSystem>(FileSystem::Default())),
+        dir_(test::PerThreadDBPath("read_coalescing_test")) {
+    EXPECT_OK(counting_fs_->CreateDirIfMissing(dir_, IOOptions(), nullptr));
+  }
+
+  ~ReadCoalescingTest() override {
+    EXPECT_OK(DestroyDir(Env::Default(), dir_));
+  }
+
+  std::shared_ptr<ReadCountingFileSystem> counting_fs_;
+  const std::string dir_;
+};
+
+TEST_F(ReadCoalescingTest, MergeMultiRead) {
+  ReadCoalescingOptions opts;
+  std::shared_ptr<FileSystem> fs;
+  ASSERT_TRUE(
+      NewReadCoalescingFileSystem(nullptr, opts, &fs).IsInvalidArgument());
+  opts.max_gap_bytes = 4;
+  opts.max_merged_bytes = 32;
+  ASSERT_OK(NewReadCoalescingFileSystem(counting_fs_, opts, &fs));
+
+  const std::string fname = dir_ + "/data";
+  std::string data;
+  for (int i = 0; i < 100; ++i) {
+    data.push_back(static_cast<char>('a' + i % 26));
+  }
+  ASSERT_OK(WriteStringToFile(fs.get(), data, fname));
+  std::unique_ptr<FSRandomAccessFile> file;
+  ASSERT_OK(fs->NewRandomAccessFile(fname, FileOptions(), &file, nullptr));
+
+  char scratch[5][32];
+  FSReadRequest reqs[5];
+  const uint64_t offsets[5] = {16, 10, 50, 6, 96};
+  const size_t lens[5] = {4, 4, 8, 4, 8};
+  for (int i = 0; i < 5; ++i) {
+    reqs[i].offset = offsets[i];
+    reqs[i].len = lens[i];
+    reqs[i].scratch = scratch[i];
+  }
+  ASSERT_OK(file->MultiRead(reqs, 5, IOOptions(), nullptr));
+  // [6, 10), [10, 14) and [16, 20) are read together, while [50, 58) and
+  // [96, 104) are too far apart
+  ASSERT_EQ(3, counting_fs_->reads_.load());
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_OK(reqs[i].status);
+    ASSERT_EQ(data.substr(offsets[i], lens[i]), reqs[i].result.ToString());
+  }
+  // Short at the end of the file
+  ASSERT_OK(reqs[4].status);
+  ASSERT_EQ(data.substr(96), reqs[4].result.ToString());
+
+  // A merged request is bounded by max_merged_bytes
+  counting_fs_->reads_ = 0;
+  reqs[0].offset = 0;
+  reqs[0].len = 8;
+  reqs[1].offset = 10;
+  reqs[1].len = 30;
+  ASSERT_OK(file->MultiRead(reqs, 2, IOOptions(), nullptr));
+  ASSERT_EQ(2, counting_fs_->reads_.load());
+  ASSERT_EQ(data.substr(0, 8), reqs[0].result.ToString());
+  ASSERT_EQ(data.substr(10, 30), reqs[1].result.ToString());
+}
+
+TEST_F(ReadCoalescingTest, TailCache) {
+  ReadCoalescingOptions opts;
+  opts.tail_cache_dir = dir_ + "/tails";
+  opts.tail_cache_bytes = 16;
+  std::shared_ptr<FileSystem> fs;
+  ASSERT_OK(NewReadCoalescingFileSystem(counting_fs_, opts, &fs));
+  auto* coalescing_fs = static_cast<ReadCoalescingFileSystem*>(fs.get());
+
+  const std::string fname = dir_ + "/000010.sst";
+  std::string data;
+  for (int i = 0; i < 64; ++i) {
+    data.push_back(static_cast<char>('a' + i % 26));
+  }
+  ASSERT_OK(WriteStringToFile(fs.get(), data, fname));
+  const std::string tail_path = coalescing_fs->TailCachePath(fname);
+  ASSERT_FALSE(tail_path.empty());
+  ASSERT_TRUE(coalescing_fs->TailCachePath(dir_ + "/MANIFEST-000001").empty());
+
+  std::unique_ptr<FSRandomAccessFile> file;
+  ASSERT_OK(fs->NewRandomAccessFile(fname, FileOptions(), &file, nullptr));
+  char scratch[16];
+  Slice result;
+  // Before the tail
+  ASSERT_OK(file->Read(40, 4, IOOptions(), &result, scratch, nullptr));
+  ASSERT_EQ(data.substr(40, 4), result.ToString());
+  ASSERT_EQ(1, counting_fs_->reads_.load());
+  ASSERT_TRUE(fs->FileExists(tail_path, IOOptions(), nullptr).IsNotFound());
+
+  // The whole tail is read once
+  ASSERT_OK(file->Read(56, 8, IOOptions(), &result, scratch, nullptr));
+  ASSERT_EQ(data.substr(56), result.ToString());
+  ASSERT_EQ(2, counting_fs_->reads_.load());
+  ASSERT_OK(fs->FileExists(tail_path, IOOptions(), nullptr));
+  ASSERT_OK(file->Read(48, 4, IOOptions(), &result, scratch, nullptr));
+  ASSERT_EQ(data.substr(48, 4), result.ToString());
+  ASSERT_EQ(2, counting_fs_->reads_.load());
+
+  // Another reader of the file uses the copy, with MultiRead() too
+  file.reset();
+  ASSERT_OK(fs->NewRandomAccessFile(fname, FileOptions(), &file, nullptr));
+  FSReadRequest reqs[2];
+  char multi_scratch[2][8];
+  reqs[0].offset = 50;
+  reqs[0].len = 8;
+  reqs[0].scratch = multi_scratch[0];
+  reqs[1].offset = 8;
+  reqs[1].len = 8;
+  reqs[1].scratch = multi_scratch[1];
+  ASSERT_OK(file->MultiRead(reqs, 2, IOOptions(), nullptr));
+  ASSERT_OK(reqs[0].status);
+  ASSERT_EQ(data.substr(50, 8), reqs[0].result.ToString());
+  ASSERT_OK(reqs[1].status);
+  ASSERT_EQ(data.substr(8, 8), reqs[1].result.ToString());
+  ASSERT_EQ(3, counting_fs_->reads_.load());
+
+  // Deleting the file drops the copy
+  file.reset();
+  ASSERT_OK(fs->DeleteFile(fname, IOOptions(), nullptr));
+  ASSERT_TRUE(fs->FileExists(tail_path, IOOptions(), nullptr).IsNotFound());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -620,7 +620,7 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
   if (thread_local_io_urings_) {
     iu = static_cast<struct io_uring*>(thread_local_io_urings_->Get());
     if (iu == nullptr) {
-      iu = CreateIOUring();
+      iu = CreateThreadLocalIOUring();
       if (iu != nullptr) {
         thread_local_io_urings_->Reset(iu);
       }
@@ -675,8 +675,8 @@ IOStatus PosixRandomAccessFile::MultiRead(FSReadRequest* reqs, size_t num_reqs,
 
       struct io_uring_sqe* sqe;
       sqe = io_uring_get_sqe(iu);
-      io_uring_prep_readv(
-          sqe, fd_, &rep_to_submit->iov, 1,
+      PrepareIOUringRead(
+          iu, sqe, fd_, &rep_to_submit->iov,
           rep_to_submit->req->offset + rep_to_submit->finished_len);
       io_uring_sqe_set_data(sqe, rep_to_submit);
       wrap_cache.emplace(rep_to_submit);
@@ -871,7 +871,7 @@ IOStatus PosixRandomAccessFile::ReadAsync(
   if (thread_local_io_urings_) {
     iu = static_cast<struct io_uring*>(thread_local_io_urings_->Get());
     if (iu == nullptr) {
-      iu = CreateIOUring();
+      iu = CreateThreadLocalIOUring();
       if (iu != nullptr) {
         thread_local_io_urings_->Reset(iu);
       }
@@ -903,8 +903,7 @@ IOStatus PosixRandomAccessFile::ReadAsync(
   struct io_uring_sqe* sqe;
   sqe = io_uring_get_sqe(iu);
 
-  io_uring_prep_readv(sqe, fd_, /*sqe->addr=*/&posix_handle->iov,
-                      /*sqe->len=*/1, /*sqe->offset=*/posix_handle->offset);
+  PrepareIOUringRead(iu, sqe, fd_, &posix_handle->iov, posix_handle->offset);
 
   // Sets sqe->user_data to posix_handle.
   io_uring_sqe_set_data(sqe, posix_handle);
@@ -936,14 +935,20 @@ IOStatus PosixRandomAccessFile::ReadAsync(
 PosixMmapReadableFile::PosixMmapReadableFile(const int fd,
                                              const std::string& fname,
                                              void* base, size_t length,
+                                             size_t page_size,
                                              const EnvOptions& options)
-    : fd_(fd), filename_(fname), mmapped_region_(base), length_(length) {
+    : fd_(fd),
+      filename_(fname),
+      mmapped_region_(base),
+      length_(length),
+      page_size_(page_size) {
 #ifdef NDEBUG
   (void)options;
 #endif
   fd_ = fd_ + 0;  // suppress the warning for used variables
   assert(options.use_mmap_reads);
   assert(!options.use_direct_reads);
+  assert((page_size & (page_size - 1)) == 0);
 }
 
 PosixMmapReadableFile::~PosixMmapReadableFile() {
@@ -972,6 +977,26 @@ IOStatus PosixMmapReadableFile::Read(uint64_t offset, size_t n,
   return s;
 }
 
+IOStatus PosixMmapReadableFile::Prefetch(uint64_t offset, size_t n,
+                                         const IOOptions& /*opts*/,
+                                         IODebugContext* /*dbg*/) {
+  if (offset >= length_ || n == 0) {
+    return IOStatus::OK();
+  }
+  n = static_cast<size_t>(std::min(uint64_t{n}, length_ - offset));
+  // The mapping starts at a page boundary
+  const size_t start = static_cast<size_t>(offset) & ~(page_size_ - 1);
+  const size_t len = static_cast<size_t>(offset) + n - start;
+  int ret = Madvise(static_cast<char*>(mmapped_region_) + start, len,
+                    POSIX_MADV_WILLNEED);
+  if (ret != 0) {
+    return IOError("While madvise WILLNEED offset " + std::to_string(offset) +
+                       " len " + std::to_string(n),
+                   filename_, ret);
+  }
+  return IOStatus::OK();
+}
+
 void PosixMmapReadableFile::Hint(AccessPattern pattern) {
   switch (pattern) {
     case kNormal:
@@ -1287,6 +1312,14 @@ PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
 #ifdef ROCKSDB_RANGESYNC_PRESENT
   sync_file_range_supported_ = IsSyncFileRangeSupported(fd_);
 #endif  // ROCKSDB_RANGESYNC_PRESENT
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // Writes go to explicit offsets, which direct IO would also need to align.
+  // Fall back to write(2) if that is asked for or no ring can be created.
+  write_uring_ = nullptr;
+  if (options.use_io_uring_writes && !use_direct_io_) {
+    write_uring_ = CreateIOUring();
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
   assert(!options.use_mmap_writes);
 }
 
@@ -1297,6 +1330,154 @@ PosixWritableFile::~PosixWritableFile() {
   }
 }
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+IOStatus PosixWritableFile::SubmitUringWrite(const char* data, size_t n,
+                                             uint64_t offset, bool is_sync,
+                                             bool datasync) {
+  uring_mu_.AssertHeld();
+  if (!uring_status_.ok()) {
+    return uring_status_;
+  }
+  // Make room in the ring, reaping whatever has completed on the way.
+  IOStatus s = ReapUringWrites(kIoUringDepth - 1);
+  if (!s.ok()) {
+    return s;
+  }
+  struct io_uring_sqe* sqe = io_uring_get_sqe(write_uring_);
+  if (sqe == nullptr) {
+    uring_status_ = IOStatus::IOError("io_uring_get_sqe() returned nullptr");
+    return uring_status_;
+  }
+  uring_writes_.emplace_back();
+  UringWrite* req = &uring_writes_.back();
+  req->self = std::prev(uring_writes_.end());
+  req->is_sync = is_sync;
+  if (is_sync) {
+    ++uring_syncs_submitted_;
+    io_uring_prep_fsync(sqe, fd_, datasync ? IORING_FSYNC_DATASYNC : 0);
+    // A sync must not start before the writes submitted ahead of it are
+    // done; io_uring does not order independent requests otherwise.
+    if (uring_writes_.size() > 1) {
+      io_uring_sqe_set_flags(sqe, IOSQE_IO_DRAIN);
+    }
+  } else {
+    req->data.assign(data, n);
+    req->offset = offset;
+    req->iov.iov_base = &req->data[0];
+    req->iov.iov_len = n;
+    io_uring_prep_writev(sqe, fd_, &req->iov, 1, offset);
+  }
+  io_uring_sqe_set_data(sqe, req);
+  int ret = io_uring_submit(write_uring_);
+  if (ret < 0) {
+    uring_status_ =
+        IOError("While submitting io_uring write", filename_, -ret);
+  }
+  return uring_status_;
+}
+
+IOStatus PosixWritableFile::ReapUringWrites(size_t max_in_flight) {
+  uring_mu_.AssertHeld();
+  // Leave the completion queue to the thread reaping without the mutex, and
+  // only wait for it to make room if needed.
+  while (uring_reaping_ && uring_writes_.size() > max_in_flight) {
+    uring_cv_.Wait();
+  }
+  if (uring_reaping_) {
+    return uring_status_;
+  }
+  while (!uring_writes_.empty()) {
+    struct io_uring_cqe* cqe = nullptr;
+    int ret = uring_writes_.size() > max_in_flight
+                  ? io_uring_wait_cqe(write_uring_, &cqe)
+                  : io_uring_peek_cqe(write_uring_, &cqe);
+    if (ret == -EAGAIN) {
+      // Nothing completed, and not required to wait.
+      break;
+    } else if (ret == -EINTR) {
+      continue;
+    } else if (ret < 0) {
+      if (uring_status_.ok()) {
+        uring_status_ =
+            IOError("While waiting for io_uring write", filename_, -ret);
+      }
+      break;
+    }
+    UringWrite* req = static_cast<UringWrite*>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(write_uring_, cqe);
+    CompleteUringWrite(req, res);
+  }
+  return uring_status_;
+}
+
+IOStatus PosixWritableFile::WaitUringSync(uint64_t sync) {
+  uring_mu_.AssertHeld();
+  while (uring_syncs_completed_ < sync) {
+    if (uring_reaping_) {
+      uring_cv_.Wait();
+      continue;
+    }
+    // Become the only thread reaping, and wait for the next completion
+    // without the mutex. Append() keeps submitting meanwhile, which io_uring
+    // allows concurrently with reaping.
+    uring_reaping_ = true;
+    uring_mu_.Unlock();
+    struct io_uring_cqe* cqe = nullptr;
+    int ret;
+    do {
+      ret = io_uring_wait_cqe(write_uring_, &cqe);
+    } while (ret == -EINTR);
+    uring_mu_.Lock();
+    uring_reaping_ = false;
+    if (ret < 0) {
+      if (uring_status_.ok()) {
+        uring_status_ =
+            IOError("While waiting for io_uring sync", filename_, -ret);
+      }
+      uring_cv_.SignalAll();
+      break;
+    }
+    UringWrite* req = static_cast<UringWrite*>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(write_uring_, cqe);
+    CompleteUringWrite(req, res);
+  }
+  return uring_status_;
+}
+
+void PosixWritableFile::CompleteUringWrite(UringWrite* req, int res) {
+  if (req->is_sync) {
+    ++uring_syncs_completed_;
+  }
+  if (uring_status_.ok()) {
+    if (res < 0) {
+      uring_status_ = IOError(req->is_sync ? "While syncing via io_uring"
+                                           : "While appending via io_uring",
+                              filename_, -res);
+    } else if (!req->is_sync && static_cast<size_t>(res) < req->data.size()) {
+      // Short write. Finish it synchronously rather than resubmitting.
+      const size_t done = static_cast<size_t>(res);
+      if (!PosixPositionedWrite(fd_, req->data.data() + done,
+                                req->data.size() - done,
+                                static_cast<off_t>(req->offset + done))) {
+        uring_status_ = IOError("While appending to file", filename_, errno);
+      }
+    }
+  }
+  uring_writes_.erase(req->self);
+  uring_cv_.SignalAll();
+}
+
+IOStatus PosixWritableFile::DrainUringWrites() {
+  if (write_uring_ == nullptr) {
+    return IOStatus::OK();
+  }
+  MutexLock l(&uring_mu_);
+  return ReapUringWrites(0);
+}
+#endif  // ROCKSDB_IOURING_PRESENT
+
 IOStatus PosixWritableFile::Append(const Slice& data, const IOOptions& /*opts*/,
                                    IODebugContext* /*dbg*/) {
   if (use_direct_io()) {
@@ -1306,6 +1487,18 @@ IOStatus PosixWritableFile::Append(const Slice& data, const IOOptions& /*opts*/,
   const char* src = data.data();
   size_t nbytes = data.size();
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (write_uring_ != nullptr) {
+    MutexLock l(&uring_mu_);
+    IOStatus s = SubmitUringWrite(src, nbytes, filesize_, /*is_sync=*/false,
+                                  /*datasync=*/false);
+    if (s.ok()) {
+      filesize_ += nbytes;
+    }
+    return s;
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
+
   if (!PosixWrite(fd_, src, nbytes)) {
     return IOError("While appending to file", filename_, errno);
   }
@@ -1323,6 +1516,12 @@ IOStatus PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset,
     assert(IsSectorAligned(data.data(), GetRequiredBufferAlignment()));
   }
   assert(offset <= static_cast<uint64_t>(std::numeric_limits<off_t>::max()));
+#if defined(ROCKSDB_IOURING_PRESENT)
+  IOStatus s = DrainUringWrites();
+  if (!s.ok()) {
+    return s;
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
   const char* src = data.data();
   size_t nbytes = data.size();
   if (!PosixPositionedWrite(fd_, src, nbytes, static_cast<off_t>(offset))) {
@@ -1336,6 +1535,12 @@ IOStatus PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset,
 IOStatus PosixWritableFile::Truncate(uint64_t size, const IOOptions& /*opts*/,
                                      IODebugContext* /*dbg*/) {
   IOStatus s;
+#if defined(ROCKSDB_IOURING_PRESENT)
+  s = DrainUringWrites();
+  if (!s.ok()) {
+    return s;
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
   int r = ftruncate(fd_, size);
   if (r < 0) {
     s = IOError("While ftruncate file to size " + std::to_string(size),
@@ -1349,6 +1554,15 @@ IOStatus PosixWritableFile::Truncate(uint64_t size, const IOOptions& /*opts*/,
 IOStatus PosixWritableFile::Close(const IOOptions& /*opts*/,
                                   IODebugContext* /*dbg*/) {
   IOStatus s;
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (write_uring_ != nullptr) {
+    s = DrainUringWrites();
+    io_uring_queue_exit(write_uring_);
+    DeleteIOUring(write_uring_);
+    write_uring_ = nullptr;
+    uring_writes_.clear();
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
 
   size_t block_size;
   size_t last_allocated_block;
@@ -1389,7 +1603,7 @@ IOStatus PosixWritableFile::Close(const IOOptions& /*opts*/,
 #endif
   }
 
-  if (close(fd_) < 0) {
+  if (close(fd_) < 0 && s.ok()) {
     s = IOError("While closing file after writing", filename_, errno);
   }
   fd_ = -1;
@@ -1404,6 +1618,14 @@ IOStatus PosixWritableFile::Flush(const IOOptions& /*opts*/,
 
 IOStatus PosixWritableFile::Sync(const IOOptions& /*opts*/,
                                  IODebugContext* /*dbg*/) {
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (write_uring_ != nullptr) {
+    MutexLock l(&uring_mu_);
+    IOStatus s = SubmitUringWrite(nullptr, 0, 0, /*is_sync=*/true,
+                                  /*datasync=*/true);
+    return s.ok() ? WaitUringSync(uring_syncs_submitted_) : s;
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
 #ifdef HAVE_FULLFSYNC
   if (::fcntl(fd_, F_FULLFSYNC) < 0) {
     return IOError("while fcntl(F_FULLFSYNC)", filename_, errno);
@@ -1418,6 +1640,14 @@ IOStatus PosixWritableFile::Sync(const IOOptions& /*opts*/,
 
 IOStatus PosixWritableFile::Fsync(const IOOptions& /*opts*/,
                                   IODebugContext* /*dbg*/) {
+#if defined(ROCKSDB_IOURING_PRESENT)
+  if (write_uring_ != nullptr) {
+    MutexLock l(&uring_mu_);
+    IOStatus s = SubmitUringWrite(nullptr, 0, 0, /*is_sync=*/true,
+                                  /*datasync=*/false);
+    return s.ok() ? WaitUringSync(uring_syncs_submitted_) : s;
+  }
+#endif  // ROCKSDB_IOURING_PRESENT
 #ifdef HAVE_FULLFSYNC
   if (::fcntl(fd_, F_FULLFSYNC) < 0) {
     return IOError("while fcntl(F_FULLFSYNC)", filename_, errno);
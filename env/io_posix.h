@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <functional>
+#include <list>
 #include <map>
 #include <string>
 
@@ -268,15 +269,48 @@ inline void DeleteIOUring(void* p) {
   delete iu;
 }
 
-inline struct io_uring* CreateIOUring() {
+inline struct io_uring* CreateIOUring(unsigned int flags = 0) {
   struct io_uring* new_io_uring = new struct io_uring;
-  int ret = io_uring_queue_init(kIoUringDepth, new_io_uring, 0);
+  int ret = io_uring_queue_init(kIoUringDepth, new_io_uring, flags);
   if (ret) {
     delete new_io_uring;
     new_io_uring = nullptr;
   }
   return new_io_uring;
 }
+
+// Creates one of the thread local io_urings for reads, which is only used by
+// the thread creating it. Where the kernel supports it, the ring is set up
+// for a single submitter that runs the completion work when it waits for
+// completions, rather than being interrupted as each read completes.
+inline struct io_uring* CreateThreadLocalIOUring() {
+  struct io_uring* new_io_uring = nullptr;
+#if defined(IORING_SETUP_SINGLE_ISSUER) && defined(IORING_SETUP_DEFER_TASKRUN)
+  new_io_uring =
+      CreateIOUring(IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN);
+#endif
+  if (new_io_uring == nullptr) {
+    new_io_uring = CreateIOUring();
+  }
+  return new_io_uring;
+}
+
+// Prepares `sqe` to read into the buffer of `iov`
+inline void PrepareIOUringRead(struct io_uring* iu, struct io_uring_sqe* sqe,
+                               int fd, struct iovec* iov, uint64_t offset) {
+#if defined(IORING_SETUP_DEFER_TASKRUN)
+  if (iu->flags & IORING_SETUP_DEFER_TASKRUN) {
+    // Kernels supporting that also have IORING_OP_READ, which spares
+    // copying in the iovec for each read
+    io_uring_prep_read(sqe, fd, iov->iov_base,
+                       static_cast<unsigned int>(iov->iov_len), offset);
+    return;
+  }
+#else
+  (void)iu;
+#endif
+  io_uring_prep_readv(sqe, fd, iov, 1, offset);
+}
 #endif  // defined(ROCKSDB_IOURING_PRESENT)
 
 class PosixRandomAccessFile : public FSRandomAccessFile {
@@ -342,6 +376,49 @@ class PosixWritableFile : public FSWritableFile {
   // support it, so we need to do a dynamic check too.
   bool sync_file_range_supported_;
 #endif  // ROCKSDB_RANGESYNC_PRESENT
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // A write or sync submitted to write_uring_ and not yet reaped. Appends
+  // copy their data here, so the caller's buffer can be reused right away.
+  struct UringWrite {
+    std::string data;
+    uint64_t offset = 0;
+    struct iovec iov;
+    bool is_sync = false;
+    std::list<UringWrite>::iterator self;
+  };
+  // Non-null if EnvOptions::use_io_uring_writes was set and a ring could
+  // be created. Append() then submits the write and returns without waiting
+  // for it, and Sync()/Fsync() wait for everything submitted before them.
+  struct io_uring* write_uring_;
+  // Sync() may run concurrently with Append(), so the ring and the requests
+  // in flight are protected by this mutex. Completions are reaped under it,
+  // except by a Sync() waiting for its own, see WaitUringSync().
+  port::Mutex uring_mu_;
+  // Signaled when a completion is reaped or the reaping thread is done
+  port::CondVar uring_cv_{&uring_mu_};
+  // Set while a thread reaps completions without uring_mu_. No other thread
+  // touches the completion queue then.
+  bool uring_reaping_ = false;
+  std::list<UringWrite> uring_writes_;
+  // Syncs submitted and completed so far. They complete in order, as each
+  // one drains the requests submitted ahead of it.
+  uint64_t uring_syncs_submitted_ = 0;
+  uint64_t uring_syncs_completed_ = 0;
+  // First error reported by a completion. Sticky, like a failed write(2).
+  IOStatus uring_status_;
+
+  IOStatus SubmitUringWrite(const char* data, size_t n, uint64_t offset,
+                            bool is_sync, bool datasync);
+  // Reaps completions, blocking while more than `max_in_flight` requests are
+  // outstanding. Requires uring_mu_.
+  IOStatus ReapUringWrites(size_t max_in_flight);
+  // Waits until the sync numbered `sync` has completed. Requires uring_mu_,
+  // which is released while waiting, so that appends are not held up by the
+  // device flush.
+  IOStatus WaitUringSync(uint64_t sync);
+  void CompleteUringWrite(UringWrite* req, int res);
+  IOStatus DrainUringWrites();
+#endif  // ROCKSDB_IOURING_PRESENT
 
  public:
   explicit PosixWritableFile(const std::string& fname, int fd,
@@ -402,13 +479,19 @@ class PosixMmapReadableFile : public FSRandomAccessFile {
   std::string filename_;
   void* mmapped_region_;
   size_t length_;
+  size_t page_size_;
 
  public:
   PosixMmapReadableFile(const int fd, const std::string& fname, void* base,
-                        size_t length, const EnvOptions& options);
+                        size_t length, size_t page_size,
+                        const EnvOptions& options);
   virtual ~PosixMmapReadableFile();
   IOStatus Read(uint64_t offset, size_t n, const IOOptions& opts, Slice* result,
                 char* scratch, IODebugContext* dbg) const override;
+  // Advises the kernel to read the pages of the range ahead, as the mapping
+  // is read by page faults which don't read ahead after Hint(kRandom)
+  IOStatus Prefetch(uint64_t offset, size_t n, const IOOptions& opts,
+                    IODebugContext* dbg) override;
   void Hint(AccessPattern pattern) override;
   IOStatus InvalidateCache(size_t offset, size_t length) override;
 };
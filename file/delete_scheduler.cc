@@ -6,6 +6,7 @@
 
 #include "file/delete_scheduler.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <thread>
 #include <vector>
@@ -37,7 +38,11 @@ DeleteScheduler::DeleteScheduler(SystemClock* clock, FileSystem* fs,
       bg_thread_(nullptr),
       info_log_(info_log),
       sst_file_manager_(sst_file_manager),
-      max_trash_db_ratio_(max_trash_db_ratio) {
+      max_trash_db_ratio_(max_trash_db_ratio),
+      max_read_latency_micros_(0),
+      delete_rate_shift_(0),
+      last_read_count_(0),
+      last_read_sum_(0) {
   assert(sst_file_manager != nullptr);
   assert(max_trash_db_ratio >= 0);
   MaybeCreateBackgroundThread();
@@ -115,6 +120,7 @@ Status DeleteScheduler::DeleteFile(const std::string& file_path,
   {
     InstrumentedMutexLock l(&mu_);
     RecordTick(stats_.get(), FILES_MARKED_TRASH);
+    RecordTick(stats_.get(), FILES_DELETION_DEFERRED_BYTES, trash_file_size);
     queue_.emplace(trash_file, dir_to_sync);
     pending_files_++;
     if (pending_files_ == 1) {
@@ -233,9 +239,10 @@ void DeleteScheduler::BackgroundEmptyTrash() {
     uint64_t total_deleted_bytes = 0;
     int64_t current_delete_rate = rate_bytes_per_sec_.load();
     while (!queue_.empty() && !closing_) {
-      if (current_delete_rate != rate_bytes_per_sec_.load()) {
-        // User changed the delete rate
-        current_delete_rate = rate_bytes_per_sec_.load();
+      int64_t delete_rate = AdaptDeleteRate(rate_bytes_per_sec_.load());
+      if (current_delete_rate != delete_rate) {
+        // User changed the delete rate, or it adapted to the read latency
+        current_delete_rate = delete_rate;
         start_time = clock_->NowMicros();
         total_deleted_bytes = 0;
         ROCKS_LOG_INFO(info_log_, "rate_bytes_per_sec is changed to %" PRIi64,
@@ -298,6 +305,36 @@ void DeleteScheduler::BackgroundEmptyTrash() {
   }
 }
 
+int64_t DeleteScheduler::AdaptDeleteRate(int64_t rate_bytes_per_sec) {
+  mu_.AssertHeld();
+  const uint64_t max_read_latency_micros = max_read_latency_micros_.load();
+  if (max_read_latency_micros == 0 || stats_ == nullptr ||
+      rate_bytes_per_sec <= 0) {
+    delete_rate_shift_ = 0;
+    return rate_bytes_per_sec;
+  }
+  HistogramData reads;
+  stats_->histogramData(SST_READ_MICROS, &reads);
+  uint64_t read_count = 0;
+  uint64_t read_sum = 0;
+  // Statistics may have been reset since
+  if (reads.count >= last_read_count_ && reads.sum >= last_read_sum_) {
+    read_count = reads.count - last_read_count_;
+    read_sum = reads.sum - last_read_sum_;
+  }
+  last_read_count_ = reads.count;
+  last_read_sum_ = reads.sum;
+  if (read_count > 0 && read_sum / read_count > max_read_latency_micros) {
+    if (delete_rate_shift_ < kMaxDeleteRateShift) {
+      delete_rate_shift_++;
+      RecordTick(stats_.get(), FILES_DELETION_SLOWED_DOWN);
+    }
+  } else if (delete_rate_shift_ > 0) {
+    delete_rate_shift_--;
+  }
+  return std::max<int64_t>(rate_bytes_per_sec >> delete_rate_shift_, 1);
+}
+
 Status DeleteScheduler::DeleteTrashFile(const std::string& path_in_trash,
                                         const std::string& dir_to_sync,
                                         uint64_t* deleted_bytes,
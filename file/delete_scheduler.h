@@ -73,6 +73,18 @@ class DeleteScheduler {
     max_trash_db_ratio_.store(r);
   }
 
+  // Return the average SST file read latency above which the delete rate is
+  // lowered, 0 if it is not
+  uint64_t GetMaxReadLatencyMicros() {
+    return max_read_latency_micros_.load();
+  }
+
+  // Set the average SST file read latency above which the delete rate is
+  // lowered
+  void SetMaxReadLatencyMicros(uint64_t micros) {
+    max_read_latency_micros_.store(micros);
+  }
+
   static const std::string kTrashExtension;
   static bool IsTrashFile(const std::string& file_path);
 
@@ -95,6 +107,11 @@ class DeleteScheduler {
 
   void BackgroundEmptyTrash();
 
+  // Return the delete rate to use given the delete rate limit, lowered while
+  // SST file reads are slower than max_read_latency_micros_
+  // REQUIRES: mu_ held
+  int64_t AdaptDeleteRate(int64_t rate_bytes_per_sec);
+
   void MaybeCreateBackgroundThread();
 
   SystemClock* clock_;
@@ -139,6 +156,15 @@ class DeleteScheduler {
   // size we will start deleting new files passed to DeleteScheduler
   // immediately
   std::atomic<double> max_trash_db_ratio_;
+  std::atomic<uint64_t> max_read_latency_micros_;
+  // The delete rate is lowered to the delete rate limit divided by
+  // 2^delete_rate_shift_, protected by mu_
+  int delete_rate_shift_;
+  static const int kMaxDeleteRateShift = 4;
+  // SST_READ_MICROS count and sum at the last AdaptDeleteRate(), protected
+  // by mu_
+  uint64_t last_read_count_;
+  uint64_t last_read_sum_;
   static const uint64_t kMicrosInSecond = 1000 * 1000LL;
   std::shared_ptr<Statistics> stats_;
 };
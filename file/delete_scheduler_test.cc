@@ -192,6 +192,54 @@ TEST_F(DeleteSchedulerTest, BasicRateLimiting) {
   }
 }
 
+// Deletions slow down while SST file reads are slower than the max read
+// latency, and speed up again once they are not
+TEST_F(DeleteSchedulerTest, AdaptToReadLatency) {
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->LoadDependency({
+      {"DeleteSchedulerTest::AdaptToReadLatency:1",
+       "DeleteScheduler::BackgroundEmptyTrash"},
+  });
+  const int kNumSlowReads = 5;
+  std::vector<uint64_t> penalties;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "DeleteScheduler::BackgroundEmptyTrash:Wait", [&](void* arg) {
+        penalties.push_back(*(static_cast<uint64_t*>(arg)));
+        if (penalties.size() <= kNumSlowReads) {
+          stats_->reportTimeToHistogram(SST_READ_MICROS, 1000);
+        }
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  rate_bytes_per_sec_ = 1024 * 1024;  // 1 MB / sec
+  NewDeleteScheduler();
+  sst_file_mgr_->SetDeleteMaxReadLatencyMicros(100);
+  ASSERT_EQ(sst_file_mgr_->GetDeleteMaxReadLatencyMicros(), 100);
+
+  const int num_files = 8;
+  const uint64_t file_size = 1024;
+  for (int i = 0; i < num_files; i++) {
+    std::string file_name = "file" + std::to_string(i) + ".data";
+    ASSERT_OK(delete_scheduler_->DeleteFile(NewDummyFile(file_name, file_size),
+                                            ""));
+  }
+  TEST_SYNC_POINT("DeleteSchedulerTest::AdaptToReadLatency:1");
+  delete_scheduler_->WaitForEmptyTrash();
+
+  // The delete rate is halved after each slow read, down to 1/16 of the
+  // limit, and then doubled back. Bytes deleted at the same rate add up.
+  const std::vector<int> shifts = {0, 1, 2, 3, 4, 4, 3, 2};
+  const std::vector<uint64_t> deleted = {1, 1, 1, 1, 1, 2, 1, 1};
+  ASSERT_EQ(penalties.size(), num_files);
+  for (int i = 0; i < num_files; i++) {
+    ASSERT_EQ(penalties[i], deleted[i] * file_size * 1000000 /
+                                (rate_bytes_per_sec_ >> shifts[i]));
+  }
+  ASSERT_EQ(4, stats_->getAndResetTickerCount(FILES_DELETION_SLOWED_DOWN));
+  ASSERT_EQ(num_files * file_size,
+            stats_->getAndResetTickerCount(FILES_DELETION_DEFERRED_BYTES));
+  ASSERT_EQ(CountTrashFiles(), 0);
+}
+
 TEST_F(DeleteSchedulerTest, MultiDirectoryDeletionsScheduled) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->LoadDependency({
       {"DeleteSchedulerTest::MultiDbPathDeletionsScheduled:1",
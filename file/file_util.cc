@@ -23,12 +23,24 @@ IOStatus CopyFile(FileSystem* fs, const std::string& source,
                   uint64_t size, bool use_fsync,
                   const std::shared_ptr<IOTracer>& io_tracer,
                   const Temperature temperature) {
+  return CopyFile(fs, source, temperature, dest_writer, size, use_fsync,
+                  io_tracer, nullptr /* rate_limiter */,
+                  Env::IO_TOTAL /* rate_limiter_priority */);
+}
+
+IOStatus CopyFile(FileSystem* fs, const std::string& source,
+                  const Temperature src_temperature,
+                  std::unique_ptr<WritableFileWriter>& dest_writer,
+                  uint64_t size, bool use_fsync,
+                  const std::shared_ptr<IOTracer>& io_tracer,
+                  RateLimiter* rate_limiter,
+                  Env::IOPriority rate_limiter_priority) {
   FileOptions soptions;
   IOStatus io_s;
   std::unique_ptr<SequentialFileReader> src_reader;
 
   {
-    soptions.temperature = temperature;
+    soptions.temperature = src_temperature;
     std::unique_ptr<FSSequentialFile> srcfile;
     io_s = fs->NewSequentialFile(source, soptions, &srcfile, nullptr);
     if (!io_s.ok()) {
@@ -42,18 +54,18 @@ IOStatus CopyFile(FileSystem* fs, const std::string& source,
         return io_s;
       }
     }
-    src_reader.reset(
-        new SequentialFileReader(std::move(srcfile), source, io_tracer));
+    src_reader.reset(new SequentialFileReader(std::move(srcfile), source,
+                                              io_tracer, {} /* listeners */,
+                                              rate_limiter));
   }
 
-  char buffer[4096];
+  const size_t kBufferSize = 64 << 10;
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
   Slice slice;
   while (size > 0) {
-    size_t bytes_to_read = std::min(sizeof(buffer), static_cast<size_t>(size));
-    // TODO: rate limit copy file
-    io_s = status_to_io_status(
-        src_reader->Read(bytes_to_read, &slice, buffer,
-                         Env::IO_TOTAL /* rate_limiter_priority */));
+    size_t bytes_to_read = std::min(kBufferSize, static_cast<size_t>(size));
+    io_s = status_to_io_status(src_reader->Read(
+        bytes_to_read, &slice, buffer.get(), rate_limiter_priority));
     if (!io_s.ok()) {
       return io_s;
     }
@@ -25,6 +25,15 @@ extern IOStatus CopyFile(FileSystem* fs, const std::string& source,
                          uint64_t size, bool use_fsync,
                          const std::shared_ptr<IOTracer>& io_tracer,
                          const Temperature temperature);
+// Like the above, but `source` is read with `src_temperature`, and the reads
+// are charged to `rate_limiter`, if any, at `rate_limiter_priority`
+extern IOStatus CopyFile(FileSystem* fs, const std::string& source,
+                         const Temperature src_temperature,
+                         std::unique_ptr<WritableFileWriter>& dest_writer,
+                         uint64_t size, bool use_fsync,
+                         const std::shared_ptr<IOTracer>& io_tracer,
+                         RateLimiter* rate_limiter,
+                         Env::IOPriority rate_limiter_priority);
 extern IOStatus CopyFile(FileSystem* fs, const std::string& source,
                          const std::string& destination, uint64_t size,
                          bool use_fsync,
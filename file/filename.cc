@@ -281,6 +281,10 @@ std::string IdentityFileName(const std::string& dbname) {
   return dbname + "/IDENTITY";
 }
 
+std::string BlockCacheHotnessFileName(const std::string& dbname) {
+  return dbname + "/BLOCK_CACHE_HOTNESS";
+}
+
 // Owned filenames have the form:
 //    dbname/IDENTITY
 //    dbname/CURRENT
@@ -155,6 +155,10 @@ extern std::string MetaDatabaseName(const std::string& dbname, uint64_t number);
 // either from a backup-image or empty
 extern std::string IdentityFileName(const std::string& dbname);
 
+// Return the name of the file recording which blocks were in the block cache,
+// see DBOptions::block_cache_hotness_persist_period_sec
+extern std::string BlockCacheHotnessFileName(const std::string& dbname);
+
 // If filename is a rocksdb file, store the type of the file in *type.
 // The number encoded in the filename is stored in *number.  If the
 // filename was successfully parsed, returns true.  Else return false.
@@ -844,6 +844,100 @@ TEST_P(PrefetchTest, ConfigureNumFilesReadsForReadaheadSize) {
   Close();
 }
 
+// This test verifies that with learn_auto_readahead_size, a new iterator reads
+// ahead the length of the previous scans from its first data block on.
+TEST_P(PrefetchTest, LearnAutoReadaheadSize) {
+  // First param is if the mockFS support_prefetch or not
+  bool support_prefetch =
+      std::get<0>(GetParam()) &&
+      test::IsPrefetchSupported(env_->GetFileSystem(), dbname_);
+
+  const int kNumKeys = 2000;
+  std::shared_ptr<MockFS> fs =
+      std::make_shared<MockFS>(env_->GetFileSystem(), support_prefetch);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  // Second param is if directIO is enabled or not
+  bool use_direct_io = std::get<1>(GetParam());
+
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  table_options.learn_auto_readahead_size = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  int buff_prefetch_count = 0;
+  size_t learned_readahead_size = 0;
+  SyncPoint::GetInstance()->SetCallBack("FilePrefetchBuffer::Prefetch:Start",
+                                        [&](void*) { buff_prefetch_count++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockPrefetcher::PrefetchForLearnedScan", [&](void* arg) {
+        learned_readahead_size = *static_cast<size_t*>(arg);
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  WriteBatch batch;
+  Random rnd(309);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(batch.Put(BuildKey(i), rnd.RandomString(1000)));
+  }
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+
+  std::string start_key = BuildKey(0);
+  std::string end_key = BuildKey(kNumKeys - 1);
+  Slice least(start_key.data(), start_key.size());
+  Slice greatest(end_key.data(), end_key.size());
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), &least, &greatest));
+
+  Close();
+  ASSERT_OK(TryReopen(options));
+
+  // Data blocks hold about 4 keys, so this scan reads 6 of them, ramping up
+  // the readahead as without learning
+  {
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    for (int i = 0; i < 24 && iter->Valid(); ++i) {
+      iter->Next();
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(learned_readahead_size, 0);
+
+  fs->ClearPrefetchCount();
+  buff_prefetch_count = 0;
+  // A shorter scan is served by a single readahead from its first block
+  {
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ReadOptions()));
+    iter->Seek(BuildKey(1000));
+    for (int i = 0; i < 12 && iter->Valid(); ++i) {
+      iter->Next();
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_GT(learned_readahead_size, 0);
+  ASSERT_LE(learned_readahead_size, table_options.max_auto_readahead_size);
+  if (support_prefetch && !use_direct_io) {
+    ASSERT_EQ(fs->GetPrefetchCount(), 1);
+  } else {
+    ASSERT_EQ(buff_prefetch_count, 1);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+}
+
 // This test verifies the basic functionality of implicit autoreadahead:
 // - Enable implicit autoreadahead and prefetch only if sequential blocks are
 //   read,
@@ -2479,6 +2573,88 @@ TEST_P(PrefetchTest, ReadAsyncWithPosixFS) {
   Close();
 }
 
+// This test verifies that compaction input files are read ahead
+// asynchronously with DBOptions::compaction_async_io.
+TEST_P(PrefetchTest, CompactionAsyncIOWithPosixFS) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_SKIP("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+
+  const int kNumKeys = 1000;
+  std::shared_ptr<MockFS> fs = std::make_shared<MockFS>(
+      FileSystem::Default(), /*support_prefetch=*/false);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  bool use_direct_io = std::get<0>(GetParam());
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  options.statistics = CreateDBStatistics();
+  options.compaction_async_io = true;
+  options.compaction_readahead_size = 16 * 1024;
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  // Overlapping files, so that all of them are read at once
+  int total_keys = 0;
+  Random rnd(309);
+  for (int j = 0; j < 4; j++) {
+    WriteBatch batch;
+    for (int i = j; i < 4 * kNumKeys; i += 4) {
+      ASSERT_OK(batch.Put(BuildKey(i), rnd.RandomString(100)));
+      total_keys++;
+    }
+    ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    ASSERT_OK(Flush());
+  }
+
+  int buff_prefetch_count = 0;
+  bool read_async_called = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "FilePrefetchBuffer::PrefetchAsyncInternal:Start",
+      [&](void*) { buff_prefetch_count++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "UpdateResults::io_uring_result",
+      [&](void* /*arg*/) { read_async_called = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(options.statistics->Reset());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  if (read_async_called) {
+    ASSERT_GT(buff_prefetch_count, 0);
+    HistogramData async_read_bytes;
+    options.statistics->histogramData(ASYNC_READ_BYTES, &async_read_bytes);
+    ASSERT_GT(async_read_bytes.count, 0);
+  } else {
+    // Not all platforms support iouring. Without it, the file system does
+    // not support async reads and compactions read ahead synchronously.
+    ASSERT_EQ(buff_prefetch_count, 0);
+  }
+
+  auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ReadOptions()));
+  int num_keys = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    num_keys++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(num_keys, total_keys);
+
+  Close();
+}
+
 // This test verifies implementation of seek parallelization with
 // PosixFileSystem during prefetching.
 TEST_P(PrefetchTest, MultipleSeekWithPosixFS) {
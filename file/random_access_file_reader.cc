@@ -22,6 +22,20 @@
 #include "util/rate_limiter_impl.h"
 
 namespace ROCKSDB_NAMESPACE {
+namespace {
+// Direct I/O reads that have to be copied out of an aligned buffer keep the
+// buffer for the next such read of the thread, unless larger than this
+constexpr size_t kMaxReusedAlignedBufferSize = 256 << 10;
+
+struct ReusedAlignedBuffer {
+  AlignedBuffer buffer;
+  // Set while a read of the thread uses the buffer, in case a listener
+  // notified of the read reads a file too
+  bool in_use = false;
+};
+thread_local ReusedAlignedBuffer reused_aligned_buffer;
+}  // namespace
+
 inline Histograms GetFileReadHistograms(Statistics* stats,
                                         Env::IOActivity io_activity) {
   switch (io_activity) {
@@ -144,15 +158,28 @@ IOStatus RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
       size_t offset_advance = static_cast<size_t>(offset) - aligned_offset;
       size_t read_size =
           Roundup(static_cast<size_t>(offset + n), alignment) - aligned_offset;
-      AlignedBuffer buf;
-      buf.Alignment(alignment);
-      buf.AllocateNewBuffer(read_size);
+      AlignedBuffer new_buf;
+      AlignedBuffer* buf_ptr = &new_buf;
+      const bool reuse_buf = aligned_buf == nullptr &&
+                             !reused_aligned_buffer.in_use &&
+                             read_size <= kMaxReusedAlignedBufferSize;
+      if (reuse_buf) {
+        reused_aligned_buffer.in_use = true;
+        buf_ptr = &reused_aligned_buffer.buffer;
+      }
+      AlignedBuffer& buf = *buf_ptr;
+      if (buf.Alignment() != alignment || buf.Capacity() < read_size) {
+        buf.Alignment(alignment);
+        buf.AllocateNewBuffer(read_size);
+      } else {
+        buf.Clear();
+      }
       while (buf.CurrentSize() < read_size) {
         size_t allowed;
         if (rate_limiter_priority != Env::IO_TOTAL &&
             rate_limiter_ != nullptr) {
           allowed = rate_limiter_->RequestToken(
-              buf.Capacity() - buf.CurrentSize(), buf.Alignment(),
+              read_size - buf.CurrentSize(), buf.Alignment(),
               rate_limiter_priority, stats_, RateLimiter::OpType::kRead);
         } else {
           assert(buf.CurrentSize() == 0);
@@ -202,6 +229,9 @@ IOStatus RandomAccessFileReader::Read(const IOOptions& opts, uint64_t offset,
           aligned_buf->reset(buf.Release());
         }
       }
+      if (reuse_buf) {
+        reused_aligned_buffer.in_use = false;
+      }
       *result = Slice(scratch, res_len);
     } else {
       size_t pos = 0;
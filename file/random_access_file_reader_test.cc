@@ -90,6 +90,31 @@ TEST_F(RandomAccessFileReaderTest, ReadDirectIO) {
   }
 }
 
+TEST_F(RandomAccessFileReaderTest, ReadDirectIOIntoScratch) {
+  std::string fname = "read-direct-io-into-scratch";
+  Random rand(0);
+  std::string content = rand.RandomString(8 * kDefaultPageSize);
+  Write(fname, content);
+
+  FileOptions opts;
+  opts.use_direct_reads = true;
+  std::unique_ptr<RandomAccessFileReader> r;
+  Read(fname, opts, &r);
+  ASSERT_TRUE(r->use_direct_io());
+
+  // Copied out of an aligned buffer reused by the reads of this thread,
+  // whether it has to grow or not
+  const size_t page_size = r->file()->GetRequiredBufferAlignment();
+  std::string scratch(content.size(), '\0');
+  for (size_t len : {page_size / 3, 5 * page_size + 7, page_size, size_t{1}}) {
+    size_t offset = page_size / 2 + len % page_size;
+    Slice result;
+    ASSERT_OK(
+        r->Read(IOOptions(), offset, len, &result, &scratch[0], nullptr));
+    ASSERT_EQ(result.ToString(), content.substr(offset, len));
+  }
+}
+
 TEST_F(RandomAccessFileReaderTest, MultiReadDirectIO) {
   std::vector<FSReadRequest> aligned_reqs;
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
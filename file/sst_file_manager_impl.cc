@@ -5,6 +5,7 @@
 
 #include "file/sst_file_manager_impl.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
@@ -100,6 +101,19 @@ void SstFileManagerImpl::OnCompactionCompletion(Compaction* c) {
     }
   }
   cur_compactions_reserved_size_ -= size_added_by_compaction;
+
+  const auto& cf_paths = c->immutable_options()->cf_paths;
+  auto reserved = path_reserved_sizes_.find(
+      cf_paths[std::min(c->output_path_id(),
+                        static_cast<uint32_t>(cf_paths.size() - 1))]
+          .path);
+  if (reserved != path_reserved_sizes_.end()) {
+    if (reserved->second > size_added_by_compaction) {
+      reserved->second -= size_added_by_compaction;
+    } else {
+      path_reserved_sizes_.erase(reserved);
+    }
+  }
 }
 
 Status SstFileManagerImpl::OnMoveFile(const std::string& old_path,
@@ -147,7 +161,7 @@ bool SstFileManagerImpl::IsMaxAllowedSpaceReachedIncludingCompactions() {
 
 bool SstFileManagerImpl::EnoughRoomForCompaction(
     ColumnFamilyData* cfd, const std::vector<CompactionInputFiles>& inputs,
-    const Status& bg_error) {
+    const Status& bg_error, uint32_t* output_path_id) {
   MutexLock l(&mu_);
   uint64_t size_added_by_compaction = 0;
   // First check if we even have the space to do the compaction
@@ -167,16 +181,24 @@ bool SstFileManagerImpl::EnoughRoomForCompaction(
     return false;
   }
 
+  const auto& cf_paths = cfd->ioptions()->cf_paths;
+  // Like TableFileName(), a path id past the last path means the last path
+  *output_path_id = std::min(*output_path_id,
+                             static_cast<uint32_t>(cf_paths.size() - 1));
+  if (cf_paths.size() > 1) {
+    *output_path_id = PickCompactionOutputPath(cf_paths, *output_path_id,
+                                               size_added_by_compaction);
+  }
+  const std::string& output_path = cf_paths[*output_path_id].path;
+
   // Implement more aggressive checks only if this DB instance has already
   // seen a NoSpace() error. This is tin order to contain a single potentially
   // misbehaving DB instance and prevent it from slowing down compactions of
   // other DB instances
   if (bg_error.IsNoSpace() && CheckFreeSpace()) {
-    auto fn =
-        TableFileName(cfd->ioptions()->cf_paths, inputs[0][0]->fd.GetNumber(),
-                      inputs[0][0]->fd.GetPathId());
     uint64_t free_space = 0;
-    Status s = fs_->GetFreeSpace(fn, IOOptions(), &free_space, nullptr);
+    Status s =
+        fs_->GetFreeSpace(output_path, IOOptions(), &free_space, nullptr);
     s.PermitUncheckedError();  // TODO: Check the status
     // needed_headroom is based on current size reserved by compactions,
     // minus any files created by running compactions as they would count
@@ -198,6 +220,7 @@ bool SstFileManagerImpl::EnoughRoomForCompaction(
   }
 
   cur_compactions_reserved_size_ += size_added_by_compaction;
+  path_reserved_sizes_[output_path] += size_added_by_compaction;
   // Take a snapshot of cur_compactions_reserved_size_ for when we encounter
   // a NoSpace error.
   free_space_trigger_ = cur_compactions_reserved_size_;
@@ -209,6 +232,66 @@ uint64_t SstFileManagerImpl::GetCompactionsReservedSize() {
   return cur_compactions_reserved_size_;
 }
 
+uint64_t SstFileManagerImpl::GetCompactionsReservedSize(
+    const std::string& path) {
+  MutexLock l(&mu_);
+  auto reserved = path_reserved_sizes_.find(path);
+  return reserved == path_reserved_sizes_.end() ? 0 : reserved->second;
+}
+
+uint32_t SstFileManagerImpl::PickCompactionOutputPath(
+    const std::vector<DbPath>& paths, uint32_t path_id, uint64_t size) {
+  // The space a path has left for the compaction after the ones running on
+  // it, if it can hold the compaction
+  auto room_left = [&](uint32_t id, uint64_t* room) {
+    uint64_t free_space = 0;
+    IOStatus s =
+        fs_->GetFreeSpace(paths[id].path, IOOptions(), &free_space, nullptr);
+    std::pair<const std::string*, uint64_t*> path_and_free_space(
+        &paths[id].path, &free_space);
+    TEST_SYNC_POINT_CALLBACK(
+        "SstFileManagerImpl::PickCompactionOutputPath:FreeSpace",
+        &path_and_free_space);
+    if (!s.ok()) {
+      // Without its free space, a path is only used if it was picked
+      *room = 0;
+      return id == path_id;
+    }
+    uint64_t needed = size + compaction_buffer_size_;
+    auto reserved = path_reserved_sizes_.find(paths[id].path);
+    if (reserved != path_reserved_sizes_.end()) {
+      needed += reserved->second;
+    }
+    if (free_space < needed) {
+      return false;
+    }
+    *room = free_space - needed;
+    return true;
+  };
+
+  uint64_t room = 0;
+  if (room_left(path_id, &room)) {
+    return path_id;
+  }
+  uint32_t best_id = path_id;
+  uint64_t best_room = 0;
+  for (uint32_t id = 0; id < paths.size(); id++) {
+    if (id != path_id && room_left(id, &room) &&
+        (best_id == path_id || room > best_room)) {
+      best_id = id;
+      best_room = room;
+    }
+  }
+  if (best_id != path_id) {
+    ROCKS_LOG_INFO(logger_,
+                   "Compaction output of %" PRIu64
+                   " bytes moved from %s to %s for lack of space",
+                   size, paths[path_id].path.c_str(),
+                   paths[best_id].path.c_str());
+  }
+  return best_id;
+}
+
 uint64_t SstFileManagerImpl::GetTotalSize() {
   MutexLock l(&mu_);
   return total_files_size_;
@@ -240,6 +323,14 @@ uint64_t SstFileManagerImpl::GetTotalTrashSize() {
   return delete_scheduler_.GetTotalTrashSize();
 }
 
+uint64_t SstFileManagerImpl::GetDeleteMaxReadLatencyMicros() {
+  return delete_scheduler_.GetMaxReadLatencyMicros();
+}
+
+void SstFileManagerImpl::SetDeleteMaxReadLatencyMicros(uint64_t micros) {
+  delete_scheduler_.SetMaxReadLatencyMicros(micros);
+}
+
 void SstFileManagerImpl::ReserveDiskBuffer(uint64_t size,
                                            const std::string& path) {
   MutexLock l(&mu_);
@@ -71,9 +71,16 @@ class SstFileManagerImpl : public SstFileManager {
   // estimates how much space is currently being used by compactions (i.e.
   // if a compaction has started, this function bumps the used space by
   // the full compaction size).
+  //
+  // `output_path_id` is the index in the cf_paths of `cfd` of the path the
+  // compaction outputs go to, and the space is reserved on that path. With
+  // more than one path, if the free space of the path less what running
+  // compactions reserved on it cannot hold the compaction, it is changed to
+  // the path with the most such space left, if any can hold it.
   bool EnoughRoomForCompaction(ColumnFamilyData* cfd,
                                const std::vector<CompactionInputFiles>& inputs,
-                               const Status& bg_error);
+                               const Status& bg_error,
+                               uint32_t* output_path_id);
 
   // Bookkeeping so total_file_sizes_ goes back to normal after compaction
   // finishes
@@ -81,6 +88,9 @@ class SstFileManagerImpl : public SstFileManager {
 
   uint64_t GetCompactionsReservedSize();
 
+  // Return the estimated size of the ongoing compactions writing to `path`.
+  uint64_t GetCompactionsReservedSize(const std::string& path);
+
   // Return the total size of all tracked files.
   uint64_t GetTotalSize() override;
 
@@ -102,6 +112,10 @@ class SstFileManagerImpl : public SstFileManager {
   // Return the total size of trash files
   uint64_t GetTotalTrashSize() override;
 
+  uint64_t GetDeleteMaxReadLatencyMicros() override;
+
+  void SetDeleteMaxReadLatencyMicros(uint64_t micros) override;
+
   // Called by each DB instance using this sst file manager to reserve
   // disk buffer space for recovery from out of space errors
   void ReserveDiskBuffer(uint64_t buffer, const std::string& path);
@@ -141,6 +155,11 @@ class SstFileManagerImpl : public SstFileManager {
   void OnAddFileImpl(const std::string& file_path, uint64_t file_size);
   // REQUIRES: mutex locked
   void OnDeleteFileImpl(const std::string& file_path);
+  // Returns the index in `paths` of the path for the output of a compaction
+  // of `size` bytes, preferably `path_id`.
+  // REQUIRES: mutex locked
+  uint32_t PickCompactionOutputPath(const std::vector<DbPath>& paths,
+                                    uint32_t path_id, uint64_t size);
 
   void ClearError();
   bool CheckFreeSpace() {
@@ -159,6 +178,8 @@ class SstFileManagerImpl : public SstFileManager {
   uint64_t compaction_buffer_size_;
   // Estimated size of the current ongoing compactions
   uint64_t cur_compactions_reserved_size_;
+  // Estimated size of the current ongoing compactions by output path
+  std::unordered_map<std::string, uint64_t> path_reserved_sizes_;
   // A map containing all tracked files and there sizes
   //  file_path => file_size
   std::unordered_map<std::string, uint64_t> tracked_files_;
@@ -21,9 +21,24 @@
 #include "test_util/sync_point.h"
 #include "util/crc32c.h"
 #include "util/random.h"
+#include "util/mutexlock.h"
 #include "util/rate_limiter_impl.h"
+#include "util/threadpool_imp.h"
 
 namespace ROCKSDB_NAMESPACE {
+namespace {
+// Writes out the buffers of all the writers in the write-behind mode
+ThreadPoolImpl* WriteBehindThreadPool() {
+  static ThreadPoolImpl* const pool = []() {
+    // Leaked, as writers may still be used during static destruction
+    auto* result = new ThreadPoolImpl();
+    result->SetBackgroundThreads(4);
+    return result;
+  }();
+  return pool;
+}
+}  // namespace
+
 IOStatus WritableFileWriter::Create(const std::shared_ptr<FileSystem>& fs,
                                     const std::string& fname,
                                     const FileOptions& file_opts,
@@ -58,7 +73,8 @@ IOStatus WritableFileWriter::Append(const Slice& data, uint32_t crc32c_checksum,
   // Calculate the checksum of appended data
   UpdateFileChecksum(data);
 
-  {
+  // In the write-behind mode, the file is prepared right before each write
+  if (!write_behind_) {
     IOOptions io_options;
     io_options.rate_limiter_priority =
         WritableFileWriter::DecideRateLimiterPriority(
@@ -88,7 +104,7 @@ IOStatus WritableFileWriter::Append(const Slice& data, uint32_t crc32c_checksum,
   // Flush only when buffered I/O
   if (!use_direct_io() && (buf_.Capacity() - buf_.CurrentSize()) < left) {
     if (buf_.CurrentSize() > 0) {
-      s = Flush(op_rate_limiter_priority);
+      s = FlushOrWriteBehind(op_rate_limiter_priority);
       if (!s.ok()) {
         set_seen_error();
         return s;
@@ -119,7 +135,7 @@ IOStatus WritableFileWriter::Append(const Slice& data, uint32_t crc32c_checksum,
           src += appended;
 
           if (left > 0) {
-            s = Flush(op_rate_limiter_priority);
+            s = FlushOrWriteBehind(op_rate_limiter_priority);
             if (!s.ok()) {
               break;
             }
@@ -149,7 +165,7 @@ IOStatus WritableFileWriter::Append(const Slice& data, uint32_t crc32c_checksum,
         src += appended;
 
         if (left > 0) {
-          s = Flush(op_rate_limiter_priority);
+          s = FlushOrWriteBehind(op_rate_limiter_priority);
           if (!s.ok()) {
             break;
           }
@@ -161,6 +177,12 @@ IOStatus WritableFileWriter::Append(const Slice& data, uint32_t crc32c_checksum,
       if (perform_data_verification_ && buffered_data_with_checksum_) {
         buffered_data_crc32c_checksum_ = crc32c::Value(src, left);
         s = WriteBufferedWithChecksum(src, left, op_rate_limiter_priority);
+      } else if (write_behind_) {
+        // After the data in the background, to keep the writes in order
+        s = WaitForWriteBehind();
+        if (s.ok()) {
+          s = WriteAndRangeSync(src, left, op_rate_limiter_priority);
+        }
       } else {
         s = WriteBuffered(src, left, op_rate_limiter_priority);
       }
@@ -195,7 +217,7 @@ IOStatus WritableFileWriter::Pad(const size_t pad_bytes,
     buf_.PadWith(append_bytes, 0);
     left -= append_bytes;
     if (left > 0) {
-      IOStatus s = Flush(op_rate_limiter_priority);
+      IOStatus s = FlushOrWriteBehind(op_rate_limiter_priority);
       if (!s.ok()) {
         set_seen_error();
         return s;
@@ -215,6 +237,11 @@ IOStatus WritableFileWriter::Pad(const size_t pad_bytes,
 }
 
 IOStatus WritableFileWriter::Close() {
+  if (write_behind_) {
+    // The background write must complete before the file is closed. Its
+    // error, if any, is seen below.
+    WaitForWriteBehind().PermitUncheckedError();
+  }
   if (seen_error()) {
     IOStatus interim;
     if (writable_file_.get() != nullptr) {
@@ -339,6 +366,8 @@ IOStatus WritableFileWriter::Flush(Env::IOPriority op_rate_limiter_priority) {
           s = WriteDirect(op_rate_limiter_priority);
         }
       }
+    } else if (write_behind_) {
+      s = WriteBehind(op_rate_limiter_priority);
     } else {
       if (perform_data_verification_ && buffered_data_with_checksum_) {
         s = WriteBufferedWithChecksum(buf_.BufferStart(), buf_.CurrentSize(),
@@ -346,6 +375,17 @@ IOStatus WritableFileWriter::Flush(Env::IOPriority op_rate_limiter_priority) {
       } else {
         s = WriteBuffered(buf_.BufferStart(), buf_.CurrentSize(),
                           op_rate_limiter_priority);
+        // If writable_file_->Append() failed, then the data may or may not
+        // exist in the underlying memory buffer, OS page cache, remote file
+        // system's buffer, etc. If WritableFileWriter keeps the data in
+        // buf_, then a future Close() or write retry may send the data to
+        // the underlying file again. If the data does exist in the
+        // underlying buffer and gets written to the file eventually despite
+        // returning error, the file may end up with two duplicate pieces of
+        // data. Therefore, clear the buf_ at the WritableFileWriter layer
+        // even on failure and let caller determine error handling.
+        buf_.Size(0);
+        buffered_data_crc32c_checksum_ = 0;
       }
     }
     if (!s.ok()) {
@@ -354,6 +394,15 @@ IOStatus WritableFileWriter::Flush(Env::IOPriority op_rate_limiter_priority) {
     }
   }
 
+  if (write_behind_) {
+    // All the data is written out once flushed
+    s = WaitForWriteBehind();
+    if (!s.ok()) {
+      set_seen_error();
+      return s;
+    }
+  }
+
   {
     FileOperationInfo::StartTimePoint start_ts;
     if (ShouldNotifyListeners()) {
@@ -378,6 +427,16 @@ IOStatus WritableFileWriter::Flush(Env::IOPriority op_rate_limiter_priority) {
     return s;
   }
 
+  // In the write-behind mode, range syncs follow the writes
+  if (!use_direct_io() && !write_behind_) {
+    s = MaybeRangeSync(filesize_.load(std::memory_order_acquire));
+  }
+
+  return s;
+}
+
+IOStatus WritableFileWriter::MaybeRangeSync(uint64_t cur_size) {
+  IOStatus s;
   // sync OS cache to disk for every bytes_per_sync_
   // TODO: give log file and sst file different options (log
   // files could be potentially cached in OS for their whole
@@ -389,11 +448,10 @@ IOStatus WritableFileWriter::Flush(Env::IOPriority op_rate_limiter_priority) {
   //     the page.
   // Xfs does neighbor page flushing outside of the specified ranges. We
   // need to make sure sync range is far from the write offset.
-  if (!use_direct_io() && bytes_per_sync_) {
+  if (bytes_per_sync_) {
     const uint64_t kBytesNotSyncRange =
         1024 * 1024;                                // recent 1MB is not synced.
     const uint64_t kBytesAlignWhenSync = 4 * 1024;  // Align 4KB.
-    uint64_t cur_size = filesize_.load(std::memory_order_acquire);
     if (cur_size > kBytesNotSyncRange) {
       uint64_t offset_sync_to = cur_size - kBytesNotSyncRange;
       offset_sync_to -= offset_sync_to % kBytesAlignWhenSync;
@@ -412,6 +470,84 @@ IOStatus WritableFileWriter::Flush(Env::IOPriority op_rate_limiter_priority) {
   return s;
 }
 
+IOStatus WritableFileWriter::WriteBehind(
+    Env::IOPriority op_rate_limiter_priority) {
+  IOStatus s = WaitForWriteBehind();
+  if (!s.ok()) {
+    return s;
+  }
+  std::swap(buf_, write_behind_buf_);
+  if (buf_.Capacity() < write_behind_buf_.Capacity()) {
+    buf_.AllocateNewBuffer(write_behind_buf_.Capacity());
+  }
+  buffered_data_crc32c_checksum_ = 0;
+  {
+    MutexLock l(&write_behind_mu_);
+    write_behind_pending_ = true;
+  }
+  WriteBehindThreadPool()->SubmitJob([this, op_rate_limiter_priority]() {
+    BGWriteBehind(op_rate_limiter_priority);
+  });
+  return s;
+}
+
+IOStatus WritableFileWriter::WaitForWriteBehind() {
+  MutexLock l(&write_behind_mu_);
+  while (write_behind_pending_) {
+    write_behind_cv_.Wait();
+  }
+  IOSTATS_ADD(bytes_written, write_behind_bytes_);
+  IOSTATS_ADD(write_nanos, write_behind_nanos_);
+  write_behind_bytes_ = 0;
+  write_behind_nanos_ = 0;
+  return write_behind_status_;
+}
+
+IOStatus WritableFileWriter::WriteAndRangeSync(
+    const char* data, size_t size, Env::IOPriority op_rate_limiter_priority) {
+  {
+    IOOptions io_options;
+    io_options.rate_limiter_priority =
+        WritableFileWriter::DecideRateLimiterPriority(
+            writable_file_->GetIOPriority(), op_rate_limiter_priority);
+    IOSTATS_TIMER_GUARD(prepare_write_nanos);
+    writable_file_->PrepareWrite(static_cast<size_t>(GetFlushedSize()), size,
+                                 io_options, nullptr);
+  }
+  IOStatus s = WriteBuffered(data, size, op_rate_limiter_priority);
+  if (s.ok()) {
+    s = MaybeRangeSync(GetFlushedSize());
+  }
+  return s;
+}
+
+void WritableFileWriter::BGWriteBehind(
+    Env::IOPriority op_rate_limiter_priority) {
+  TEST_SYNC_POINT("WritableFileWriter::BGWriteBehind:Start");
+  const uint64_t prev_bytes = IOSTATS(bytes_written);
+  const uint64_t prev_nanos = IOSTATS(write_nanos);
+  IOStatus s;
+  // An error of the writer is only seen after a background write completed,
+  // so none is expected here
+  if (!seen_error()) {
+    s = WriteAndRangeSync(write_behind_buf_.BufferStart(),
+                          write_behind_buf_.CurrentSize(),
+                          op_rate_limiter_priority);
+  }
+  // Even on failure, see Flush()
+  write_behind_buf_.Size(0);
+
+  MutexLock l(&write_behind_mu_);
+  if (write_behind_status_.ok()) {
+    write_behind_status_ = s;
+  }
+  s.PermitUncheckedError();
+  write_behind_bytes_ += IOSTATS(bytes_written) - prev_bytes;
+  write_behind_nanos_ += IOSTATS(write_nanos) - prev_nanos;
+  write_behind_pending_ = false;
+  write_behind_cv_.SignalAll();
+}
+
 std::string WritableFileWriter::GetFileChecksum() {
   if (checksum_generator_ != nullptr) {
     assert(checksum_finalized_);
@@ -590,19 +726,6 @@ IOStatus WritableFileWriter::WriteBuffered(
         } else {
           s = writable_file_->Append(Slice(src, allowed), io_options, nullptr);
         }
-        if (!s.ok()) {
-          // If writable_file_->Append() failed, then the data may or may not
-          // exist in the underlying memory buffer, OS page cache, remote file
-          // system's buffer, etc. If WritableFileWriter keeps the data in
-          // buf_, then a future Close() or write retry may send the data to
-          // the underlying file again. If the data does exist in the
-          // underlying buffer and gets written to the file eventually despite
-          // returning error, the file may end up with two duplicate pieces of
-          // data. Therefore, clear the buf_ at the WritableFileWriter layer
-          // and let caller determine error handling.
-          buf_.Size(0);
-          buffered_data_crc32c_checksum_ = 0;
-        }
         SetPerfLevel(prev_perf_level);
       }
       if (ShouldNotifyListeners()) {
@@ -627,8 +750,6 @@ IOStatus WritableFileWriter::WriteBuffered(
     uint64_t cur_size = flushed_size_.load(std::memory_order_acquire);
     flushed_size_.store(cur_size + allowed, std::memory_order_release);
   }
-  buf_.Size(0);
-  buffered_data_crc32c_checksum_ = 0;
   if (!s.ok()) {
     set_seen_error();
   }
@@ -166,6 +166,21 @@ class WritableFileWriter {
   uint32_t buffered_data_crc32c_checksum_;
   bool buffered_data_with_checksum_;
   Temperature temperature_;
+  // Whether full buffers are written out by a background thread while the
+  // next one is filled, see EnvOptions::write_behind
+  bool write_behind_;
+  // The buffer being written out in the background, swapped with buf_
+  AlignedBuffer write_behind_buf_;
+  port::Mutex write_behind_mu_;
+  port::CondVar write_behind_cv_;
+  // Protected by write_behind_mu_
+  bool write_behind_pending_;
+  // The first error of the background writes
+  IOStatus write_behind_status_;
+  // IO stats of the background writes, to be added to those of the thread
+  // using the writer
+  uint64_t write_behind_bytes_;
+  uint64_t write_behind_nanos_;
 
  public:
   WritableFileWriter(
@@ -196,12 +211,21 @@ class WritableFileWriter {
         checksum_finalized_(false),
         perform_data_verification_(perform_data_verification),
         buffered_data_crc32c_checksum_(0),
-        buffered_data_with_checksum_(buffered_data_with_checksum) {
+        buffered_data_with_checksum_(buffered_data_with_checksum),
+        write_behind_(false),
+        write_behind_cv_(&write_behind_mu_),
+        write_behind_pending_(false),
+        write_behind_bytes_(0),
+        write_behind_nanos_(0) {
     temperature_ = options.temperature;
     assert(!use_direct_io() || max_buffer_size_ > 0);
     TEST_SYNC_POINT_CALLBACK("WritableFileWriter::WritableFileWriter:0",
                              reinterpret_cast<void*>(max_buffer_size_));
+    write_behind_ =
+        options.write_behind && !use_direct_io() && max_buffer_size_ > 0 &&
+        !(perform_data_verification_ && buffered_data_with_checksum_);
     buf_.Alignment(writable_file_->GetRequiredBufferAlignment());
+    write_behind_buf_.Alignment(writable_file_->GetRequiredBufferAlignment());
     buf_.AllocateNewBuffer(std::min((size_t)65536, max_buffer_size_));
     std::for_each(listeners.begin(), listeners.end(),
                   [this](const std::shared_ptr<EventListener>& e) {
@@ -229,6 +253,7 @@ class WritableFileWriter {
   ~WritableFileWriter() {
     auto s = Close();
     s.PermitUncheckedError();
+    write_behind_status_.PermitUncheckedError();
   }
 
   std::string file_name() const { return file_name_; }
@@ -294,6 +319,13 @@ class WritableFileWriter {
   void set_seen_error() { seen_error_.store(true, std::memory_order_relaxed); }
 
   IOStatus AssertFalseAndGetStatusForPrevError() {
+    if (write_behind_) {
+      // The error may be from a background write
+      IOStatus s = WaitForWriteBehind();
+      if (!s.ok()) {
+        return s;
+      }
+    }
     // This should only happen if SyncWithoutFlush() was called.
     assert(sync_without_flush_called_);
     return IOStatus::IOError("Writer has previous error.");
@@ -315,6 +347,27 @@ class WritableFileWriter {
   IOStatus WriteBufferedWithChecksum(const char* data, size_t size,
                                      Env::IOPriority op_rate_limiter_priority);
   IOStatus RangeSync(uint64_t offset, uint64_t nbytes);
+  // Range syncs the data written up to `cur_size` per bytes_per_sync_
+  IOStatus MaybeRangeSync(uint64_t cur_size);
   IOStatus SyncInternal(bool use_fsync);
+
+  // Makes room in buf_: hands it to the background thread in the write-behind
+  // mode, otherwise flushes it
+  IOStatus FlushOrWriteBehind(Env::IOPriority op_rate_limiter_priority) {
+    return write_behind_ ? WriteBehind(op_rate_limiter_priority)
+                         : Flush(op_rate_limiter_priority);
+  }
+  // Hands buf_ to a background thread to be written out, once the previous
+  // background write completed
+  IOStatus WriteBehind(Env::IOPriority op_rate_limiter_priority);
+  // Waits for the background write, and returns the first error of the
+  // background writes
+  IOStatus WaitForWriteBehind();
+  // Writes data in the write-behind mode, in the background or not. The file
+  // is prepared right before the write, as it may not be used by several
+  // threads at once.
+  IOStatus WriteAndRangeSync(const char* data, size_t size,
+                             Env::IOPriority op_rate_limiter_priority);
+  void BGWriteBehind(Env::IOPriority op_rate_limiter_priority);
 };
 }  // namespace ROCKSDB_NAMESPACE
@@ -520,6 +520,13 @@ class Cache {
   // SecondaryCache configured.)
   virtual void StartAsyncLookup(AsyncLookupHandle& async_handle);
 
+  // Like StartAsyncLookup() on each of an array of async handles. Caches
+  // can overlap the lookups, e.g. by prefetching the memory each one probes
+  // before probing any, and by locking each shard once for all its keys.
+  // Default implementation calls StartAsyncLookup() on each handle.
+  virtual void StartAsyncLookupBatch(AsyncLookupHandle* async_handles,
+                                     size_t count);
+
   // A convenient wrapper around WaitAll() and AsyncLookupHandle::Result()
   // for a single async handle. See StartAsyncLookup().
   Handle* Wait(AsyncLookupHandle& async_handle);
@@ -642,6 +649,11 @@ class CacheWrapper : public Cache {
     target_->StartAsyncLookup(async_handle);
   }
 
+  void StartAsyncLookupBatch(AsyncLookupHandle* async_handles,
+                             size_t count) override {
+    target_->StartAsyncLookupBatch(async_handles, count);
+  }
+
   void WaitAll(AsyncLookupHandle* async_handles, size_t count) override {
     target_->WaitAll(async_handles, count);
   }
@@ -57,6 +57,13 @@ enum CompactionPri : char {
   // level. The file picking process will cycle through all the files in a
   // round-robin manner.
   kRoundRobin = 0x4,
+  // First compact files with the largest share of deletion entries (point
+  // and range tombstones) among their entries, weighted up for files that
+  // are read more often than the average of their level, as seen by read
+  // sampling. This clears the tombstones that slow down reads, e.g. of
+  // queue-like workloads, before the ones nobody reads. Files without
+  // deletions are picked as with kMinOverlappingRatio.
+  kByTombstoneDensity = 0x5,
 };
 
 // Compression options for different compression algorithms like Zlib
@@ -196,6 +203,21 @@ struct CompressionOptions {
   // decompression.
   bool checksum = false;
 
+  // EXPERIMENTAL
+  // Block-based tables only. If non-zero, each data block is stored with the
+  // cheapest to decompress of no compression, a fast type (LZ4, or Snappy
+  // without LZ4 support) and the configured compression type, among those
+  // whose compressed size is at most this many percent above the smallest.
+  // Every 16th data block of an SST file is compressed with all of them to
+  // pick the type, and the data blocks up to the next one use that type. The
+  // type of each block is recorded in its trailer, so reading needs no
+  // support. Ignored with a dictionary (`max_dict_bytes > 0`) or without
+  // compression.
+  //
+  // For example, with ZSTD and 10, a block that LZ4 compresses to 3500 bytes
+  // and ZSTD to 3200 bytes is stored with LZ4, which decompresses faster.
+  uint32_t adaptive_tolerance_pct = 0;
+
   // A convenience function for setting max_compressed_bytes_per_kb based on a
   // minimum acceptable compression ratio (uncompressed size over compressed
   // size).
@@ -264,6 +286,17 @@ struct CompactionOptionsFIFO {
   // Default: empty
   std::vector<FileTemperatureAge> file_temperature_age_thresholds{};
 
+  // EXPERIMENTAL
+  // If true, the files changing temperature by
+  // `file_temperature_age_thresholds` are copied byte for byte to files of the
+  // new temperature, one by one, instead of being compacted. They are neither
+  // decoded nor re-encoded, so they keep the compression they were written
+  // with. The copy is charged to `DBOptions::rate_limiter` like the IO of
+  // compactions.
+  //
+  // Default: false
+  bool allow_trivial_copy_when_change_temperature = false;
+
   CompactionOptionsFIFO() : max_table_files_size(1 * 1024 * 1024 * 1024) {}
   CompactionOptionsFIFO(uint64_t _max_table_files_size, bool _allow_compaction)
       : max_table_files_size(_max_table_files_size),
@@ -386,6 +419,19 @@ struct AdvancedColumnFamilyOptions {
   // Default: false.
   bool inplace_update_support = false;
 
+  // EXPERIMENTAL
+  // Applicable only when inplace_update_support is true. A merge operand is
+  // then folded into the latest version of its key in the memtable iff
+  //   * that version is a merge operand
+  //   * MergeOperator::PartialMerge() of the two succeeds
+  //   * the result is no larger than the existing operand
+  // Otherwise it is added as usual. With counter-like merge operators, a key
+  // then keeps one operand per memtable, which reads need not collect and
+  // merge again. As with in-place updates of values, reads may see the
+  // folded operand of a later write than they would have otherwise.
+  // Default: false.
+  bool inplace_merge_operands = false;
+
   // Number of locks used for inplace update
   // Default: 10000, if inplace_update_support = true, else 0.
   //
@@ -699,6 +745,20 @@ struct AdvancedColumnFamilyOptions {
   // Default: true
   bool level_compaction_dynamic_file_size = true;
 
+  // EXPERIMENTAL
+  // Applicable only to level compaction, and ignored with
+  // allow_ingest_behind. If true, a file of level 1 or below is dropped from
+  // the DB without being compacted, through a compaction changing only the
+  // metadata, when the range tombstones of a file of a higher level cover
+  // all of its keys and are visible to all snapshots. Only files of higher
+  // levels whose table readers are open, such as those just written by a
+  // flush or compaction, are checked for covering range tombstones. This
+  // saves the IO of compacting data deleted by DeleteRange() down the LSM
+  // tree, like DeleteFilesInRange() but without its effect on snapshots.
+  //
+  // Default: false
+  bool drop_files_covered_by_range_deletions = false;
+
   // Default: 10.
   //
   // Dynamically changeable through SetOptions() API
@@ -784,6 +844,19 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   uint64_t max_sequential_skip_in_iterations = 8;
 
+  // If true, iterators replace max_sequential_skip_in_iterations by the
+  // ratio of the cost of a reseek to the cost of stepping over one hidden
+  // entry, both measured on runs of hidden entries long enough to trigger a
+  // reseek, and averaged over the iterators of the column family. The
+  // threshold starts at max_sequential_skip_in_iterations and stays between
+  // 1 and 16 times max_sequential_skip_in_iterations. Measuring takes a few
+  // clock reads per long run of hidden entries.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool adapt_max_sequential_skip_in_iterations = false;
+
   // This is a factory that provides MemTableRep objects.
   // Default: a factory that provides a skip-list-based implementation of
   // MemTableRep.
@@ -824,6 +897,29 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t max_successive_merges = 0;
 
+  // EXPERIMENTAL
+  // If non-zero, the results of merging the operands of keys on point lookups
+  // are cached in a cache of this many bytes, keyed by the user key and the
+  // sequence number of its newest merge operand. A later Get() of the key
+  // finding the same newest operand then takes the result from the cache,
+  // without reading and merging the older operands again. A newer write of
+  // the key supersedes the cached result.
+  //
+  // The memory of the cache is charged to the block cache of
+  // BlockBasedTableOptions, if any. The cache is not used with
+  // inplace_update_support, a compaction filter, user-defined timestamps or
+  // a row cache, under which older operands may change or are chosen by
+  // something other than the sequence number. It is also not used by
+  // MultiGet(), GetEntity(), reads with a ReadCallback such as those of
+  // transactions, or reads with ReadOptions::merge_operand_count_threshold.
+  // The MERGE_RESULT_CACHE_HIT and MERGE_RESULT_CACHE_MISS tickers count its
+  // lookups.
+  //
+  // Default: 0 (disabled)
+  //
+  // Not dynamically changeable through SetOptions() API
+  size_t merge_result_cache_size = 0;
+
   // This flag specifies that the implementation should optimize the filters
   // mainly for cases where keys are found rather than also optimize for keys
   // missed. This would be used in cases where the application knows that
@@ -857,6 +953,21 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   bool paranoid_file_checks = false;
 
+  // EXPERIMENTAL
+  // With level compaction, places each file written by a flush in the lowest
+  // level where neither its key range nor the output of a running compaction
+  // overlaps it, the way ingested files are placed, instead of in L0. This
+  // suits column families with sequential keys, such as time-ordered appends,
+  // whose flushes then skip the compactions down the LSM tree, reducing
+  // write amplification to about one. A file is only placed below L0 if its
+  // memtables are the oldest ones not yet flushed, so that no older data can
+  // later be flushed above it.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool flush_to_lowest_level = false;
+
   // In debug mode, RocksDB runs consistency checks on the LSM every time the
   // LSM changes (Flush, Compaction, AddFile). When this option is true, these
   // checks are also enabled in release mode. These checks were historically
@@ -954,6 +1065,23 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   uint64_t periodic_compaction_seconds = 0xfffffffffffffffe;
 
+  // If positive, leveled compaction favors levels that serve many reads when
+  // several of them need compaction. The score of each level that is due for
+  // compaction (score above 1) is multiplied by
+  //   1 + compaction_read_heat_weight * heat
+  // where heat is the fraction of the reads sampled over the column family's
+  // live files (`FileMetaData::stats.num_reads_sampled`) that went to that
+  // level. Scores at or below 1 are left alone, so this changes the order of
+  // compactions but not whether one is needed. The current heat of each
+  // level is reported by the "rocksdb.compaction-read-heat" DB property.
+  //
+  // Only supported with compaction_style = kCompactionStyleLevel.
+  //
+  // Default: 0 (disabled)
+  //
+  // Dynamically changeable through SetOptions() API
+  double compaction_read_heat_weight = 0;
+
   // If this option is set then 1 in N blocks are compressed
   // using a fast (lz4) and slow (zstd) compression algorithm.
   // The compressibility is reported as stats and the stored
@@ -1038,6 +1166,24 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   bool enable_blob_files = false;
 
+  // When set, the flushes and compactions of the column family pick the size
+  // of the smallest value stored in a blob file themselves, min_blob_size
+  // being only its lower bound. It is picked at each change to the table
+  // files from the sizes of the values written by the recent flushes and
+  // compactions, the rate of the reads of the table files and the write
+  // amplification of the column family, so that the bytes of the values
+  // stored in SST files, rewritten by each compaction, plus the bytes read
+  // from blob files by the lookups of the values stored there are the
+  // fewest. With blob garbage collection, the values relocated from blob
+  // files are stored in SST files again when the size picked has grown past
+  // them. Note that enable_blob_files has to be set in order for this option
+  // to have any effect.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through the SetOptions() API
+  bool adaptive_min_blob_size = false;
+
   // The size of the smallest value to be stored separately in a blob file.
   // Values which have an uncompressed size smaller than this threshold are
   // stored alongside the keys in SST files in the usual fashion. A value of
@@ -1068,6 +1214,21 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   CompressionType blob_compression_type = kNoCompression;
 
+  // If non-zero, blob files are compressed with a dictionary of at most this
+  // many bytes, which is stored in the blob file and kept with its reader in
+  // the blob file cache. The dictionary is trained (with ZSTD, otherwise the
+  // raw samples are used) from samples of the values written by a flush or
+  // compaction; its first blob file is cut short once enough samples are
+  // taken, and the following ones use the dictionary. This helps values of a
+  // few KB that share much structure, like JSON documents. Note that
+  // blob_compression_type has to be set in order for this option to have any
+  // effect.
+  //
+  // Default: 0 (no dictionary)
+  //
+  // Dynamically changeable through the SetOptions() API
+  uint32_t blob_compression_max_dict_bytes = 0;
+
   // Enables garbage collection of blobs. Blob GC is performed as part of
   // compaction. Valid blobs residing in blob files older than a cutoff get
   // relocated to new files as they are encountered during compaction, which
@@ -1147,6 +1308,17 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   PrepopulateBlobCache prepopulate_blob_cache = PrepopulateBlobCache::kDisable;
 
+  // Blobs read from a blob file whose ratio of garbage bytes to total bytes
+  // (see BlobMetaData) is above this value are not added to the blob cache,
+  // as the file is likely to be garbage collected and its blobs relocated
+  // soon. Reads are still served from the cache if the blobs are there. Set
+  // to 1.0 to cache blobs regardless of garbage; must be in [0.0, 1.0].
+  //
+  // Default: 1.0
+  //
+  // Dynamically changeable through the SetOptions() API
+  double blob_cache_max_garbage_ratio = 1.0;
+
   // Enable memtable per key-value checksum protection.
   //
   // Each entry in memtable will be suffixed by a per key-value checksum.
@@ -0,0 +1,115 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// A batch iterator fills batches of rows from a column family, one column of
+// keys and columns of values, for the consumers that process data column by
+// column, like the ones using Apache Arrow, at the cost of one call per batch
+// rather than one per key.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The values of a column of a RecordBatch, one per row. Unless `pinned`, they
+// are laid out like an Apache Arrow binary array: the value of row i is
+// data[offsets[i], offsets[i + 1]), and the validity bitmap has bit (i % 8)
+// of byte (i / 8) set if the row has a value. The buffers can be handed over
+// to Arrow as they are.
+//
+// If `pinned`, the values are not copied: `views` has the value of each row,
+// in memory pinned by the iterator (see ReadOptions::pin_data), and `offsets`
+// and `data` are empty. The views are valid until the iterator is deleted.
+struct BatchColumn {
+  // num_rows + 1 offsets into `data`, starting with 0, unless `pinned`
+  std::vector<int32_t> offsets;
+  std::string data;
+  // Empty if no row is null
+  std::vector<uint8_t> validity;
+  size_t null_count = 0;
+  bool pinned = false;
+  // The values of the rows if `pinned`, empty for the null rows
+  std::vector<Slice> views;
+
+  bool IsNull(size_t row) const {
+    return !validity.empty() && (validity[row / 8] & (1 << (row % 8))) == 0;
+  }
+
+  // The value of `row`, empty if it is null
+  Slice Get(size_t row) const {
+    if (pinned) {
+      return views[row];
+    }
+    return Slice(data.data() + offsets[row],
+                 static_cast<size_t>(offsets[row + 1] - offsets[row]));
+  }
+};
+
+// Rows of consecutive entries of a column family. A batch passed again to
+// BatchIterator::NextBatch() reuses its memory.
+struct RecordBatch {
+  size_t num_rows = 0;
+  // The user keys, never null
+  BatchColumn keys;
+  // The values, or the values of the default column of the wide-column
+  // entities, never null. Empty if BatchIteratorOptions::include_values is
+  // false.
+  BatchColumn values;
+  // The values of BatchIteratorOptions::columns, in the same order. A row is
+  // null if its entry doesn't have the column. Plain values only have the
+  // default column.
+  std::vector<BatchColumn> columns;
+};
+
+struct BatchIteratorOptions {
+  // The maximum number of rows of a batch
+  size_t max_rows = 1024;
+
+  // A batch ends before reaching max_rows once its columns hold more bytes
+  // than this. A batch has at least one row, however large.
+  size_t max_bytes = 4 << 20;
+
+  // Whether to fill RecordBatch::values
+  bool include_values = true;
+
+  // The names of the wide columns to fill RecordBatch::columns with. Unless
+  // ReadOptions::wide_column_projection is set, the other columns of the
+  // entities are skipped without being materialized.
+  std::vector<std::string> columns;
+};
+
+// Iterates forward over the entries of a column family in batches of rows,
+// see DB::NewBatchIterator(). Not thread-safe.
+class BatchIterator {
+ public:
+  BatchIterator() {}
+  // No copying allowed
+  BatchIterator(const BatchIterator&) = delete;
+  void operator=(const BatchIterator&) = delete;
+
+  virtual ~BatchIterator() {}
+
+  // Positions the iterator at the first entry
+  virtual void SeekToFirst() = 0;
+
+  // Positions the iterator at the first entry at or past `target`
+  virtual void Seek(const Slice& target) = 0;
+
+  // Fills `batch` with the next entries from the position of the iterator,
+  // and moves past them. Returns false, with an empty batch, once there are
+  // no more entries or on error, see status(). The iterator must have been
+  // positioned first.
+  virtual bool NextBatch(RecordBatch* batch) = 0;
+
+  virtual Status status() const = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -124,6 +124,7 @@ typedef struct rocksdb_sstfilewriter_t rocksdb_sstfilewriter_t;
 typedef struct rocksdb_ratelimiter_t rocksdb_ratelimiter_t;
 typedef struct rocksdb_perfcontext_t rocksdb_perfcontext_t;
 typedef struct rocksdb_pinnableslice_t rocksdb_pinnableslice_t;
+typedef struct rocksdb_multiget_results_t rocksdb_multiget_results_t;
 typedef struct rocksdb_transactiondb_options_t rocksdb_transactiondb_options_t;
 typedef struct rocksdb_transactiondb_t rocksdb_transactiondb_t;
 typedef struct rocksdb_transaction_options_t rocksdb_transaction_options_t;
@@ -571,6 +572,34 @@ extern ROCKSDB_LIBRARY_API void rocksdb_batched_multi_get_cf(
     const char* const* keys_list, const size_t* keys_list_sizes,
     rocksdb_pinnableslice_t** values, char** errs, const bool sorted_input);
 
+// Like rocksdb_batched_multi_get_cf(), but without allocations per key or per
+// call once `results` has grown to num_keys: the keys are laid out back to
+// back in `keys`, with their sizes in keys_sizes, and the values are pinned in
+// `results`, which is reused across calls. The values stay valid until the
+// next call with `results`, rocksdb_multiget_results_clear() or
+// rocksdb_multiget_results_destroy().
+extern ROCKSDB_LIBRARY_API rocksdb_multiget_results_t*
+rocksdb_multiget_results_create(void);
+extern ROCKSDB_LIBRARY_API void rocksdb_multiget_results_destroy(
+    rocksdb_multiget_results_t* results);
+// Releases the pinned values, keeping the memory for the next call
+extern ROCKSDB_LIBRARY_API void rocksdb_multiget_results_clear(
+    rocksdb_multiget_results_t* results);
+extern ROCKSDB_LIBRARY_API void rocksdb_batched_multi_get_cf_into(
+    rocksdb_t* db, const rocksdb_readoptions_t* options,
+    rocksdb_column_family_handle_t* column_family, size_t num_keys,
+    const char* keys, const size_t* keys_sizes,
+    rocksdb_multiget_results_t* results, unsigned char sorted_input);
+extern ROCKSDB_LIBRARY_API size_t
+rocksdb_multiget_results_count(const rocksdb_multiget_results_t* results);
+// Returns the value of the i-th key, or NULL if it was not found or failed
+extern ROCKSDB_LIBRARY_API const char* rocksdb_multiget_results_value(
+    const rocksdb_multiget_results_t* results, size_t i, size_t* vlen);
+// Sets *errptr if the lookup of the i-th key failed, but not if the key was
+// not found
+extern ROCKSDB_LIBRARY_API void rocksdb_multiget_results_error(
+    const rocksdb_multiget_results_t* results, size_t i, char** errptr);
+
 // The value is only allocated (using malloc) and returned if it is found and
 // value_found isn't NULL. In that case the user is responsible for freeing it.
 extern ROCKSDB_LIBRARY_API unsigned char rocksdb_key_may_exist(
@@ -744,6 +773,9 @@ extern ROCKSDB_LIBRARY_API rocksdb_writebatch_t* rocksdb_writebatch_create(
     void);
 extern ROCKSDB_LIBRARY_API rocksdb_writebatch_t* rocksdb_writebatch_create_from(
     const char* rep, size_t size);
+// Creates a batch whose buffer has room for `reserved_bytes` of records
+extern ROCKSDB_LIBRARY_API rocksdb_writebatch_t*
+rocksdb_writebatch_create_with_reserved_bytes(size_t reserved_bytes);
 extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_destroy(
     rocksdb_writebatch_t*);
 extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_clear(rocksdb_writebatch_t*);
@@ -769,6 +801,15 @@ extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_putv_cf(
     int num_keys, const char* const* keys_list, const size_t* keys_list_sizes,
     int num_values, const char* const* values_list,
     const size_t* values_list_sizes);
+// Appends num_records records in one call. The keys are laid out back to back
+// in `keys`, with their sizes in keys_sizes, and likewise the values.
+extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_put_many(
+    rocksdb_writebatch_t* b, size_t num_records, const char* keys,
+    const size_t* keys_sizes, const char* values, const size_t* values_sizes);
+extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_put_many_cf(
+    rocksdb_writebatch_t* b, rocksdb_column_family_handle_t* column_family,
+    size_t num_records, const char* keys, const size_t* keys_sizes,
+    const char* values, const size_t* values_sizes);
 extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_merge(rocksdb_writebatch_t*,
                                                          const char* key,
                                                          size_t klen,
@@ -791,6 +832,13 @@ extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_delete(rocksdb_writebatch_t*,
                                                           size_t klen);
 extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_singledelete(
     rocksdb_writebatch_t* b, const char* key, size_t klen);
+// Appends num_keys deletes, the keys laid out back to back in `keys`
+extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_delete_many(
+    rocksdb_writebatch_t* b, size_t num_keys, const char* keys,
+    const size_t* keys_sizes);
+extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_delete_many_cf(
+    rocksdb_writebatch_t* b, rocksdb_column_family_handle_t* column_family,
+    size_t num_keys, const char* keys, const size_t* keys_sizes);
 extern ROCKSDB_LIBRARY_API void rocksdb_writebatch_delete_cf(
     rocksdb_writebatch_t*, rocksdb_column_family_handle_t* column_family,
     const char* key, size_t klen);
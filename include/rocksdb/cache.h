@@ -24,6 +24,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
+class FileSystem;
 class SecondaryCache;
 
 // These definitions begin source compatibility for a future change in which
@@ -103,6 +104,9 @@ struct BlockCacheEntryStatsMapKeys {
   static const std::string& CacheCapacityBytes();
   static const std::string& LastCollectionDurationSeconds();
   static const std::string& LastCollectionAgeSeconds();
+  // Total charge of the data blocks allocated from
+  // BlockBasedTableOptions::far_memory_allocator
+  static const std::string& FarMemoryBytes();
 
   static std::string EntryCount(CacheEntryRole);
   static std::string UsedBytes(CacheEntryRole);
@@ -243,6 +247,18 @@ struct LRUCacheOptions : public ShardedCacheOptions {
   // -DROCKSDB_DEFAULT_TO_ADAPTIVE_MUTEX, false otherwise.
   bool use_adaptive_mutex = kDefaultToAdaptiveMutex;
 
+  // EXPERIMENTAL
+  // If true, entries stay in their LRU list while referenced, and a hit only
+  // marks the entry, to be moved to the head of its list when eviction next
+  // reaches it (second chance). Reference counts are updated atomically, so
+  // that releasing a handle, usually the last reference after a hit, does not
+  // take the shard mutex. Lookups still take it to search the hash table, but
+  // for a shorter time. Eviction may scan past referenced entries, and an
+  // over-capacity cache is only brought back under capacity on the next
+  // insertion. Best for read-heavy workloads with high hit rates and
+  // contention on the shard mutexes.
+  bool lazy_promotion = false;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -310,6 +326,20 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // (Filter blocks are essentially non-compressible but others usually are.)
   CacheEntryRoleSet do_not_compress_roles = {CacheEntryRole::kFilterBlock};
 
+  // If positive, values compressed by this cache are compressed using a
+  // dictionary of up to this many bytes, built once from samples of the
+  // first values compressed. This helps with small blocks, which compress
+  // poorly on their own. Blocks saved in the compressed form of their SST
+  // file (see SecondaryCache::InsertSaved()) are kept as they are, and still
+  // decompressed with the dictionary of their file. Not supported with
+  // enable_custom_split_merge. See also CompressionOptions::max_dict_bytes.
+  uint32_t max_dict_bytes = 0;
+
+  // If positive and compression_type is kZSTD, the dictionary is trained by
+  // zstd from this many bytes of samples, rather than being the samples
+  // themselves. See also CompressionOptions::zstd_max_train_bytes.
+  uint32_t zstd_max_train_bytes = 0;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -368,6 +398,36 @@ inline std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
   return opts.MakeSharedSecondaryCache();
 }
 
+// EXPERIMENTAL
+// Options for a SecondaryCache on local flash, such as for
+// TieredCacheOptions::nvm_sec_cache. Entries are appended to a region of the
+// cache file, buffered in memory until the region is full and then written
+// out in one go. Space is reclaimed a region at a time, oldest first (FIFO).
+// The index of entries is kept in memory. Lookups with wait=false are read
+// together when waited on, using FSRandomAccessFile::MultiRead() (which uses
+// io_uring where available).
+struct FlashSecondaryCacheOptions {
+  // The file holding the cache. It is created (or truncated) with the cache,
+  // and deleted with it, as entries cannot be found again without the
+  // in-memory index.
+  std::string path;
+
+  // The file system for the cache file. nullptr means FileSystem::Default().
+  std::shared_ptr<FileSystem> fs;
+
+  // Size of the cache file, rounded down to a multiple of region_size. Must
+  // allow at least two regions.
+  uint64_t capacity = 0;
+
+  // Unit of writing and eviction. Larger regions mean fewer and larger
+  // writes, but more memory for the regions being filled or written. Entries
+  // larger than a region are not cached.
+  size_t region_size = 16 << 20;
+};
+
+extern Status NewFlashSecondaryCache(const FlashSecondaryCacheOptions& opts,
+                                     std::shared_ptr<SecondaryCache>* result);
+
 // HyperClockCache - A lock-free Cache alternative for RocksDB block cache
 // that offers much improved CPU efficiency vs. LRUCache under high parallel
 // load or high contention, with some caveats:
@@ -475,6 +535,19 @@ struct HyperClockCacheOptions : public ShardedCacheOptions {
   // keep operations very fast.
   int eviction_effort_cap = 30;
 
+  // EXPERIMENTAL: If true, keeps a small frequency sketch (a count-min sketch
+  // of 4-bit counters, as in TinyLFU) of recent cache misses in each shard,
+  // and declines to insert a LOW or BOTTOM priority entry into a full shard
+  // unless its key has missed at least twice recently, that is within about
+  // as many misses as the shard has table slots. Blocks read only once, e.g.
+  // by a large scan, then pass through the cache without evicting the working
+  // set. A declined entry is freed right away or, if the caller asks for a
+  // handle, returned as a standalone entry, like any insertion the table
+  // cannot take. The sketch uses 8 bytes per table slot (of the largest table
+  // size with estimated_entry_charge = 0), not charged to the cache.
+  // (Ignored with strict_capacity_limit=true.)
+  bool frequency_admission = false;
+
   HyperClockCacheOptions(
       size_t _capacity, size_t _estimated_entry_charge,
       int _num_shard_bits = -1, bool _strict_capacity_limit = false,
@@ -551,6 +624,14 @@ struct TieredCacheOptions {
   // tier. If present, compressed blocks will be written to this
   // secondary cache.
   std::shared_ptr<SecondaryCache> nvm_sec_cache;
+  // If true, a compressed block read from an SST file is also offered to the
+  // compressed secondary cache when it is inserted into the primary cache, as
+  // it was read, i.e. after any decryption by the Env and before
+  // decompression. A later miss in the primary cache can then be served by
+  // the compressed secondary cache without reading and decrypting the block
+  // again. As for blocks evicted from the primary cache, the admission
+  // policy applies. Always the case with kAdmPolicyThreeQueue.
+  bool insert_compressed_on_fill = false;
 };
 
 extern std::shared_ptr<Cache> NewTieredCache(
@@ -569,4 +650,31 @@ extern Status UpdateTieredCache(
     const std::shared_ptr<Cache>& cache, int64_t total_capacity = -1,
     double compressed_secondary_ratio = std::numeric_limits<double>::max(),
     TieredAdmissionPolicy adm_policy = TieredAdmissionPolicy::kAdmPolicyMax);
+
+// EXPERIMENTAL
+// The following feature is experimental, and the API is subject to change
+//
+// A block cache for one of several tenants, such as DB instances, sharing a
+// single memory budget without one tenant being able to push the others out.
+// Each tenant keeps its entries in its own cache, and reserves the memory they
+// use in the shared cache with pinned placeholder entries (as with
+// CacheUsageOptions), so that other tenants cannot evict them. If the shared
+// cache has strict_capacity_limit and its budget is used up, a tenant beyond
+// its min_usage makes room among its own entries instead.
+// See DB::Properties::kBlockCacheTenantStats for the tenant's usage.
+struct TenantCacheOptions {
+  // Reported in DB::Properties::kBlockCacheTenantStats
+  std::string tenant_id;
+  // Holds the tenant's entries. Its capacity is the most the tenant can use
+  // (hard maximum), and SetCapacity() on the returned cache changes it.
+  std::shared_ptr<Cache> cache;
+  // Reserved in the shared cache from the start, so that the tenant can
+  // always use this much (guaranteed minimum). Rounded up to the size of a
+  // reservation placeholder, 256KB.
+  size_t min_usage = 0;
+};
+
+extern std::shared_ptr<Cache> NewTenantCache(
+    const std::shared_ptr<Cache>& shared_cache,
+    const TenantCacheOptions& options);
 }  // namespace ROCKSDB_NAMESPACE
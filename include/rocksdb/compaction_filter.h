@@ -322,6 +322,33 @@ class CompactionFilter : public Customizable {
     }
   }
 
+  // If this returns a non-zero value, compactions and flushes read up to that
+  // many input entries ahead and pass the newest version of each plain
+  // key-value among them (value type kValue) to FilterBatch() in one call,
+  // so that the filter can amortize its per-key work, e.g. by probing a hash
+  // table for a whole batch of keys at a time. The decisions it makes are
+  // then used in place of calling FilterV3() for those keys.
+  //
+  // Not used when user-defined timestamps are enabled.
+  virtual size_t FilterBatchSize() const { return 0; }
+
+  // Decides on each of `keys` with value `existing_values` at the same index,
+  // as FilterV3() would with value type kValue. `decisions` and `new_values`
+  // have been resized to the number of keys, with every decision set to
+  // kUndetermined. Only kKeep, kRemove and kChangeValue, with the new value
+  // in the matching element of `new_values`, can be returned this way; keys
+  // left kUndetermined or given any other decision go through FilterV3().
+  //
+  // Because the input is read ahead, a batch can include keys that FilterV3()
+  // would never have been asked about, such as keys not yet committed or
+  // keys dropped by an earlier kRemoveAndSkipUntil. The decisions for those
+  // are discarded, so this must not rely on seeing only the keys that end up
+  // filtered.
+  virtual void FilterBatch(int /*level*/, const std::vector<Slice>& /*keys*/,
+                           const std::vector<Slice>& /*existing_values*/,
+                           std::vector<Decision>* /*decisions*/,
+                           std::vector<std::string>* /*new_values*/) const {}
+
   // Internal (BlobDB) use only. Do not override in application code.
   virtual BlobDecision PrepareBlobOutput(const Slice& /* key */,
                                          const Slice& /* existing_value */,
@@ -56,6 +56,9 @@ struct CompactionJobStats {
   uint64_t total_output_bytes;
   // the total size of blob files in the compaction output
   uint64_t total_output_bytes_blob;
+  // the total size of table files moved to the output level by a trivial
+  // move, i.e. the bytes a compaction did not have to rewrite
+  uint64_t total_trivially_moved_bytes;
 
   // number of records being replaced by newer record associated with same key.
   // this could be a new value or a deletion entry for that key so this field
@@ -94,6 +97,15 @@ struct CompactionJobStats {
   // Time spent on preparing file write (fallocate, etc)
   uint64_t file_prepare_write_nanos;
 
+  // CPU time of the compaction threads, split by stage:
+  // - reading and decompressing input blocks
+  uint64_t input_read_cpu_nanos;
+  // - building, compressing and writing output files. Compression done by
+  //   the threads of CompressionOptions::parallel_threads is not included.
+  uint64_t output_write_cpu_nanos;
+  // - everything else, mostly merging the inputs in CompactionIterator
+  uint64_t merge_cpu_nanos;
+
   // 0-terminated strings storing the first 8 bytes of the smallest and
   // largest key in the output.
   static const size_t kMaxPrefixLength = 8;
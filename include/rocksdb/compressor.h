@@ -0,0 +1,61 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/compression_type.h"
+#include "rocksdb/customizable.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Slice;
+struct CompressionOptions;
+struct ConfigOptions;
+
+// EXPERIMENTAL
+// A Compressor compresses the blocks of block-based tables in place of the
+// library RocksDB was built with for one compression type, for example to
+// offload the work of flushes and compactions to a hardware accelerator. The
+// blocks are in the format of that compression type, so they are read with
+// the built-in library like any other, by any build supporting the type.
+//
+// The blocks of a table file may be compressed concurrently, with
+// CompressionOptions::parallel_threads > 1, which keeps several blocks in
+// flight for the queues of an accelerator. A Compressor must therefore be
+// thread-safe.
+//
+// Exceptions MUST NOT propagate out of overridden functions into RocksDB,
+// because RocksDB is not exception-safe. This could cause undefined behavior
+// including data loss, unreported corruption, deadlocks, and more.
+class Compressor : public Customizable {
+ public:
+  ~Compressor() override {}
+
+  static const char* Type() { return "Compressor"; }
+
+  // Creates a Compressor registered with the ObjectRegistry under `id`
+  static Status CreateFromString(const ConfigOptions& config_options,
+                                 const std::string& id,
+                                 std::shared_ptr<Compressor>* result);
+
+  // The compression type whose blocks this compressor produces. It is used
+  // for the blocks of that type compressed without a dictionary.
+  virtual CompressionType GetCompressionType() const = 0;
+
+  // Appends `input` compressed with `opts` to `output`, in the format of the
+  // built-in library: a zstd frame for kZSTD, a deflate stream with the
+  // window_bits of `opts` for kZlibCompression, and so on. RocksDB writes the
+  // uncompressed size ahead of it where the block format has one. On failure,
+  // including an accelerator being unavailable, RocksDB compresses the block
+  // with the built-in library instead.
+  virtual Status Compress(const CompressionOptions& opts, const Slice& input,
+                          std::string* output) = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -11,12 +11,14 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "rocksdb/batch_iterator.h"
 #include "rocksdb/block_cache_trace_writer.h"
 #include "rocksdb/iterator.h"
 #include "rocksdb/listener.h"
@@ -208,6 +210,13 @@ class DB {
 
   // Open the database for read only.
   //
+  // With max_open_files = -1, no merge operator and no data in the WAL files,
+  // the default column family is served by a lighter-weight implementation
+  // looking keys up directly in the table files of each level, whatever the
+  // shape of the LSM tree. All table files are opened up front, with their
+  // filters and indexes when cache_index_and_filter_blocks is false. With
+  // allow_mmap_reads and BlockBasedTableOptions::no_block_cache as well,
+  // reads are served from the mapped files without the block cache.
   static Status OpenForReadOnly(const Options& options, const std::string& name,
                                 DB** dbptr,
                                 bool error_if_wal_file_exists = false);
@@ -892,6 +901,26 @@ class DB {
     }
   }
 
+  // Like the single column family MultiGet() above, but calls `on_key_done`
+  // with the index of each key in `keys` as soon as its result is final, so
+  // that the keys found in the memtables or in the upper levels can be
+  // consumed while the others are still being looked up. When it is called,
+  // the value and the status of the key are set, and are not changed by the
+  // rest of the lookup. It is called once per key, on the calling thread,
+  // before this returns, so it should be quick.
+  virtual void MultiGetStreaming(const ReadOptions& options,
+                                 ColumnFamilyHandle* column_family,
+                                 const size_t num_keys, const Slice* keys,
+                                 PinnableSlice* values, Status* statuses,
+                                 const std::function<void(size_t)>& on_key_done,
+                                 const bool sorted_input = false) {
+    MultiGet(options, column_family, num_keys, keys, values, statuses,
+             sorted_input);
+    for (size_t i = 0; i < num_keys; ++i) {
+      on_key_done(i);
+    }
+  }
+
   // Batched MultiGet-like API that returns wide-column entities from a single
   // column family. For any given "key[i]" in "keys" (where 0 <= "i" <
   // "num_keys"), if the column family specified by "column_family" contains an
@@ -1019,6 +1048,24 @@ class DB {
                        value_found);
   }
 
+  // Batched version of KeyMayExist() for existence checks only. Sets
+  // may_exist[i] to false if keys[i] definitely does not exist in the column
+  // family, else to true. Only the memtables and the filters of the table
+  // files are checked, so there can be false positives, e.g. for deleted
+  // keys, but no data block is ever read. Filter blocks not in the block
+  // cache are read unless options.read_tier is kBlockCacheTier. On error,
+  // a non-ok status is returned and may_exist is all true.
+  // Default implementation sets may_exist to all true.
+  virtual Status MultiKeyMayExist(const ReadOptions& /*options*/,
+                                  ColumnFamilyHandle* /*column_family*/,
+                                  size_t num_keys, const Slice* /*keys*/,
+                                  bool* may_exist) {
+    for (size_t i = 0; i < num_keys; ++i) {
+      may_exist[i] = true;
+    }
+    return Status::OK();
+  }
+
   // Return a heap-allocated iterator over the contents of the database.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -1030,6 +1077,60 @@ class DB {
   virtual Iterator* NewIterator(const ReadOptions& options) {
     return NewIterator(options, DefaultColumnFamily());
   }
+  // Returns a heap-allocated iterator over the keys of several ranges of a
+  // column family, each from its start (inclusive) to its limit (exclusive),
+  // one range after the other. The ranges must be non-empty, sorted and
+  // disjoint, and are copied. Knowing them upfront, the DB reads the first
+  // data blocks of every range into the block cache in one batch of reads
+  // per table file, and only visits the files overlapping them, which is
+  // faster than seeking an iterator to each range in turn.
+  //
+  // The iterator is initially invalid. SeekToFirst() positions it at the
+  // first key of the ranges, Seek() at the first key of the ranges at or
+  // after the target, and Next() continues with the next range when the
+  // current one is exhausted. Backward iteration is not supported and sets a
+  // NotSupported status. ReadOptions::iterate_lower_bound and
+  // iterate_upper_bound are ignored.
+  virtual Iterator* NewMultiScanIterator(const ReadOptions& options,
+                                         ColumnFamilyHandle* column_family,
+                                         const std::vector<Range>& ranges);
+
+  // Returns a heap-allocated iterator filling batches of up to
+  // BatchIteratorOptions::max_rows rows from a column family, with a column
+  // of keys, a column of values and the wide columns of `batch_options`, see
+  // RecordBatch. The batches are laid out like Apache Arrow record batches,
+  // and passing the same batch again to NextBatch() reuses its memory.
+  //
+  // With ReadOptions::pin_data, the keys and values that the DB iterator pins
+  // until it is deleted, like the ones in uncompressed blocks, are referenced
+  // by the batches rather than copied, see BatchColumn::pinned. The iterator
+  // should be deleted before this db is deleted.
+  virtual BatchIterator* NewBatchIterator(
+      const ReadOptions& options, ColumnFamilyHandle* column_family,
+      const BatchIteratorOptions& batch_options);
+
+  // Called by ParallelScan() with each key and its value, which are only
+  // valid during the call. Returning false stops the scan.
+  using ParallelScanCallback =
+      std::function<bool(const Slice& key, const Slice& value)>;
+
+  // Scans the keys of `range` of a column family, from its start (inclusive)
+  // to its limit (exclusive), on up to `num_threads` threads including the
+  // calling one. The range is split into disjoint sub-ranges of about the
+  // same size of table file data, found like the boundaries of
+  // subcompactions, and the threads scan one sub-range after the other.
+  // Unless ReadOptions::snapshot is set, all of them read from a snapshot
+  // taken by this call, so they see a consistent state of the DB.
+  //
+  // `callback` is called concurrently from several threads, in key order
+  // within a sub-range but in no particular order across them. Returns the
+  // first error of any of the scans. ReadOptions::iterate_lower_bound and
+  // iterate_upper_bound are ignored.
+  virtual Status ParallelScan(const ReadOptions& options,
+                              ColumnFamilyHandle* column_family,
+                              const Range& range, int num_threads,
+                              const ParallelScanCallback& callback);
+
   // Returns iterators from a consistent database state across multiple
   // column families. Iterators are heap allocated and need to be deleted
   // before the db is deleted
@@ -1092,12 +1193,36 @@ class DB {
     //      level, as well as the histogram of latency of single requests.
     static const std::string kCFFileHistogram;
 
+    //  "rocksdb.cf-block-fetch-histogram" - print out, for every level, the
+    //      histograms of the latency of the block fetches of Get, MultiGet
+    //      and iterators, split by block cache hit and miss. Only recorded
+    //      when Statistics time operations, i.e. with a stats level above
+    //      kExceptTimers.
+    static const std::string kCFBlockFetchHistogram;
+
     // "rocksdb.cf-write-stall-stats" - returns a multi-line string or
     //      map with statistics on CF-scope write stalls for a given CF
     // See`WriteStallStatsMapKeys` for structured representation of keys
     // available in the map form.
     static const std::string kCFWriteStallStats;
 
+    // "rocksdb.cf-write-stall-timeline" - returns a multi-line string or
+    //      map with the last write stalls of a given CF, oldest first: their
+    //      start and end time, condition and cause, and the pending
+    //      compaction bytes, L0 files, memtables and running compactions of
+    //      the CF when they started. The end time of an ongoing stall is 0.
+    //      The map keys are "<index>.<field>", e.g. "000.start-micros". See
+    //      also EventListener::OnWriteStallDetail().
+    static const std::string kCFWriteStallTimeline;
+
+    //  "rocksdb.cf-job-stage-times" - returns a multi-line string or map
+    //      with the CPU and wall time in microseconds that the flushes and
+    //      compactions of a given CF spent in each ThreadStatus operation
+    //      stage, e.g. "CompactionJob::ProcessKeyValueCompaction.cpu-micros".
+    //      Only the thread running a job is timed, not the threads of its
+    //      subcompactions, and only with DBOptions::enable_thread_tracking.
+    static const std::string kCFJobStageTimes;
+
     // "rocksdb.db-write-stall-stats" - returns a multi-line string or
     //      map with statistics on DB-scope write stalls
     // See`WriteStallStatsMapKeys` for structured representation of keys
@@ -1115,6 +1240,20 @@ class DB {
     //      of files per level and total size of each level (MB).
     static const std::string kLevelStats;
 
+    //  "rocksdb.compaction-read-heat" - returns a multi-line string with the
+    //      number of reads sampled at each level, its share of the reads
+    //      sampled over all levels, and the level's compaction score. See
+    //      `AdvancedColumnFamilyOptions::compaction_read_heat_weight`.
+    static const std::string kCompactionReadHeat;
+
+    //  "rocksdb.block-cache-heat-map" - returns a multi-line string with the
+    //      block cache hits and misses sampled for each SST file of each
+    //      level, with the user key range of the file. The samples of the
+    //      files that did not fit in the fixed table of a level, or that were
+    //      moved to another level, are shown as untracked. See
+    //      `DBOptions::block_cache_heat_sample_one_in`.
+    static const std::string kBlockCacheHeatMap;
+
     //  "rocksdb.block-cache-entry-stats" - returns a multi-line string or
     //      map with statistics on block cache usage. See
     //      `BlockCacheEntryStatsMapKeys` for structured representation of keys
@@ -1125,6 +1264,19 @@ class DB {
     //      stale values more frequently to reduce overhead and latency.
     static const std::string kFastBlockCacheEntryStats;
 
+    //  "rocksdb.block-cache-tenant-stats" - returns a map with the usage and
+    //      quotas of the tenant, when the block cache was created with
+    //      NewTenantCache(). Keys are "tenant-id", "usage", "capacity",
+    //      "min-usage", "max-usage" and "reserved", the last being the memory
+    //      reserved in the cache shared among tenants.
+    static const std::string kBlockCacheTenantStats;
+
+    //  "rocksdb.block-cache-miss-ratio-curve" - returns a multi-line string
+    //      or map with the estimated miss ratio of the block cache for each
+    //      capacity in bytes where it changes, when the block cache is a
+    //      SimCache estimating it. See `SimCache::StartMissRatioCurve()`.
+    static const std::string kBlockCacheMissRatioCurve;
+
     //  "rocksdb.num-immutable-mem-table" - returns number of immutable
     //      memtables that have not yet been flushed.
     static const std::string kNumImmutableMemTable;
@@ -1284,6 +1436,15 @@ class DB {
     //  "rocksdb.is-write-stopped" - Return 1 if write has been stopped.
     static const std::string kIsWriteStopped;
 
+    //  "rocksdb.write-group-size-limit-bytes" - returns the current byte limit
+    //      of a write group. It is below max_write_batch_group_size_bytes
+    //      only while write_group_target_wal_latency_us is holding it back.
+    static const std::string kWriteGroupSizeLimitBytes;
+
+    //  "rocksdb.write-group-size-limit-writers" - returns the current limit
+    //      on the number of writers in a write group. 0 means no limit.
+    static const std::string kWriteGroupSizeLimitWriters;
+
     //  "rocksdb.estimate-oldest-key-time" - returns an estimation of
     //      oldest key timestamp in the DB. Currently only available for
     //      FIFO compaction with
@@ -1305,6 +1466,23 @@ class DB {
     //      of options.statistics
     static const std::string kOptionsStatistics;
 
+    // "rocksdb.db-mutex-contention" - returns a multi-line string with, for
+    //      each source file and line that locked the DB mutex, the waits for
+    //      it and the holds of it that took at least
+    //      `DBOptions::db_mutex_contention_threshold_micros`, and the number
+    //      of long waits that started while it held the mutex. Followed by
+    //      the last long waits, with the call site holding the mutex when
+    //      each started. Not available unless the threshold is set.
+    static const std::string kDBMutexContention;
+
+    // "rocksdb.background-queue-stats" - returns a multi-line string with,
+    //      for each thread pool of the Env, the number of flushes and
+    //      compactions of this DB that started running, and their total and
+    //      maximum waits in the queue of the pool. Not available with
+    //      `DBOptions::background_job_weight` 0 or an Env without the stats,
+    //      see Env::GetThreadPoolQueueStats().
+    static const std::string kBackgroundQueueStats;
+
     // "rocksdb.num-blob-files" - returns number of blob files in the current
     //      version.
     static const std::string kNumBlobFiles;
@@ -1392,6 +1570,8 @@ class DB {
   //  "rocksdb.num-running-flushes"
   //  "rocksdb.actual-delayed-write-rate"
   //  "rocksdb.is-write-stopped"
+  //  "rocksdb.write-group-size-limit-bytes"
+  //  "rocksdb.write-group-size-limit-writers"
   //  "rocksdb.estimate-oldest-key-time"
   //  "rocksdb.block-cache-capacity"
   //  "rocksdb.block-cache-usage"
@@ -1475,6 +1655,14 @@ class DB {
       ColumnFamilyHandle* /*column_family*/, uint64_t* const /*memory_bytes*/,
       uint64_t* const /*oldest_key_time*/) {}
 
+  // Returns the approximate bytes of WAL files that could be deleted once the
+  // memtables of `column_family` are flushed, that is the WALs it is the only
+  // column family to still need.
+  virtual uint64_t GetApproximateWalBytesPinnedByMemTables(
+      ColumnFamilyHandle* /*column_family*/) {
+    return 0;
+  }
+
   // Compact the underlying storage for the key range [*begin,*end].
   // The actual compaction interval might be superset of [*begin, *end].
   // In particular, deleted and overwritten versions are discarded,
@@ -1572,6 +1760,20 @@ class DB {
                         output_file_names, compaction_job_info);
   }
 
+  // GarbageCollectBlobFiles() collects the garbage of the oldest blob files
+  // selected by `options`, without waiting for compactions to relocate their
+  // live blobs. Only the SST files referencing those blob files are
+  // compacted, each level into itself, with blob garbage collection forced
+  // for the selected blob files. The live blobs are written to new blob
+  // files and the references to them in the SST files are updated, so the
+  // selected blob files become obsolete. Like CompactFiles(), it runs in the
+  // calling thread. SST files being compacted are skipped.
+  virtual Status GarbageCollectBlobFiles(
+      const GarbageCollectBlobFilesOptions& /*options*/,
+      ColumnFamilyHandle* /*column_family*/) {
+    return Status::NotSupported("GarbageCollectBlobFiles() not supported");
+  }
+
   // This function will wait until all currently running background processes
   // finish. After it returns, no background process will be run until
   // ContinueBackgroundWork is called, once for each preceding OK-returning
@@ -2039,6 +2241,14 @@ class DB {
     return Status::NotSupported("EndIOTrace() is not implemented.");
   }
 
+  // Writes the IO operations of the last `last_micros` microseconds to
+  // trace_writer, as a trace file readable by the IO trace parser. Requires
+  // an IO trace started with TraceOptions::io_trace_ring_buffer_records > 0.
+  virtual Status DumpIOTrace(uint64_t /*last_micros*/,
+                             std::unique_ptr<TraceWriter>&& /*trace_writer*/) {
+    return Status::NotSupported("DumpIOTrace() is not implemented.");
+  }
+
   // Trace block cache accesses. Use EndBlockCacheTrace() to stop tracing.
   virtual Status StartBlockCacheTrace(
       const TraceOptions& /*trace_options*/,
@@ -2076,6 +2286,16 @@ class DB {
     return Status::NotSupported("GetStatsHistory() is not implemented.");
   }
 
+  // Returns in `history` the time series of the ticker named `ticker_name`,
+  // e.g. "rocksdb.block.cache.miss", in the stats history of the window
+  // [start_time, end_time): the time stamp of each stats snapshot holding the
+  // ticker, in increasing order, with the ticker's count since the previous
+  // snapshot. With persist_stats_to_disk, the history is read in a single
+  // scan of the persistent stats column family.
+  virtual Status GetTickerHistory(
+      const std::string& ticker_name, uint64_t start_time, uint64_t end_time,
+      std::vector<std::pair<uint64_t, uint64_t>>* history);
+
   // Make the secondary instance catch up with the primary by tailing and
   // replaying the MANIFEST and WAL of the primary.
   // Column families created by the primary after the secondary instance starts
@@ -70,6 +70,14 @@ struct ConfigOptions;
 
 const size_t kDefaultPageSize = 4 * 1024;
 
+// How long the jobs scheduled with a tag waited in the queue of a thread
+// pool before running, see Env::GetThreadPoolQueueStats()
+struct ThreadPoolQueueStats {
+  uint64_t num_jobs = 0;
+  uint64_t total_wait_micros = 0;
+  uint64_t max_wait_micros = 0;
+};
+
 // Options while opening a file to read/write
 struct EnvOptions {
   // Construct with default Options
@@ -91,6 +99,17 @@ struct EnvOptions {
   // If true, then use O_DIRECT for writing data
   bool use_direct_writes = false;
 
+  // If true, buffered writes may be submitted asynchronously through
+  // io_uring where the file system supports it. See
+  // DBOptions::wal_use_io_uring.
+  bool use_io_uring_writes = false;
+
+  // If true, WritableFileWriter hands each full buffer of buffered writes to
+  // a background thread to be written out, while the next buffer is filled,
+  // and range syncs per bytes_per_sync in the background as well. See
+  // DBOptions::table_file_write_behind.
+  bool write_behind = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -582,6 +601,46 @@ class Env : public Customizable {
   // Lower CPU priority for threads from the specified pool.
   virtual void LowerThreadPoolCPUPriority(Priority /*pool*/ = LOW) {}
 
+  // Restricts the threads of the specified pool to run on the given CPUs,
+  // for example those of one NUMA node, or lifts the restriction when `cpus`
+  // is empty. A thread applies the change before it runs its next job.
+  virtual Status SetThreadPoolCpuAffinity(Priority /*pool*/,
+                                          const std::vector<int>& /*cpus*/) {
+    return Status::NotSupported(
+        "Env::SetThreadPoolCpuAffinity() not supported");
+  }
+
+  // With `fair`, the specified pool takes turns between the tags the jobs
+  // were scheduled with, instead of running the jobs in the order they were
+  // scheduled. The jobs of a tag still run in order. DBs schedule their
+  // flushes and compactions with tags of their own, so a DB with a backlog
+  // of compactions doesn't hold up the jobs of the other DBs on the Env.
+  virtual Status SetThreadPoolFairScheduling(Priority /*pool*/,
+                                             bool /*fair*/) {
+    return Status::NotSupported(
+        "Env::SetThreadPoolFairScheduling() not supported");
+  }
+
+  // Registers `tag` with the specified pool: with fair scheduling, the jobs
+  // of `tag` run up to `weight` at a time when it is their turn, and the
+  // queue waits of its jobs are counted, see GetThreadPoolQueueStats(). A
+  // weight of 0 unregisters the tag. DBs register their tags with
+  // DBOptions::background_job_weight.
+  virtual Status SetThreadPoolSchedulingWeight(Priority /*pool*/,
+                                               void* /*tag*/,
+                                               uint32_t /*weight*/) {
+    return Status::NotSupported(
+        "Env::SetThreadPoolSchedulingWeight() not supported");
+  }
+
+  // Gets the queue waits of the jobs of `tag` in the specified pool since it
+  // was registered. Returns NotFound if it isn't registered.
+  virtual Status GetThreadPoolQueueStats(Priority /*pool*/, void* /*tag*/,
+                                         ThreadPoolQueueStats* /*stats*/) {
+    return Status::NotSupported(
+        "Env::GetThreadPoolQueueStats() not supported");
+  }
+
   // Converts seconds-since-Jan-01-1970 to a printable string
   virtual std::string TimeToString(uint64_t time) = 0;
 
@@ -1625,6 +1684,25 @@ class EnvWrapper : public Env {
     return target_.env->LowerThreadPoolCPUPriority(pool, pri);
   }
 
+  Status SetThreadPoolCpuAffinity(Priority pool,
+                                  const std::vector<int>& cpus) override {
+    return target_.env->SetThreadPoolCpuAffinity(pool, cpus);
+  }
+
+  Status SetThreadPoolFairScheduling(Priority pool, bool fair) override {
+    return target_.env->SetThreadPoolFairScheduling(pool, fair);
+  }
+
+  Status SetThreadPoolSchedulingWeight(Priority pool, void* tag,
+                                       uint32_t weight) override {
+    return target_.env->SetThreadPoolSchedulingWeight(pool, tag, weight);
+  }
+
+  Status GetThreadPoolQueueStats(Priority pool, void* tag,
+                                 ThreadPoolQueueStats* stats) override {
+    return target_.env->GetThreadPoolQueueStats(pool, tag, stats);
+  }
+
   std::string TimeToString(uint64_t time) override {
     return target_.env->TimeToString(time);
   }
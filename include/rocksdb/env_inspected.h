@@ -6,17 +6,34 @@
 #include <string>
 
 #include "rocksdb/env.h"
+#include "rocksdb/file_system.h"
 
 namespace ROCKSDB_NAMESPACE {
 
-// Interface to inspect storage requests. FileSystemInspectedEnv will consult
-// FileSystemInspector before issuing actual disk IO.
+// Interface to inspect storage requests. FileSystemInspectedEnv and
+// FileSystemInspectedFS will consult FileSystemInspector before issuing actual
+// disk IO.
 class FileSystemInspector {
  public:
   virtual ~FileSystemInspector() = default;
 
   virtual Status Read(size_t len, size_t* allowed) = 0;
   virtual Status Write(size_t len, size_t* allowed) = 0;
+
+  // Inspects the reads of a MultiRead() at once: sets allowed[i] to how many
+  // of the lens[i] bytes of read i may be issued. Reads allowed in full are
+  // issued together; the rest of the others is requested with Read() as
+  // they are read. The default calls Read() for each read.
+  virtual Status ReadBatch(size_t num_reads, const size_t* lens,
+                           size_t* allowed) {
+    for (size_t i = 0; i < num_reads; ++i) {
+      Status s = Read(lens[i], &allowed[i]);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return Status::OK();
+  }
 };
 
 // An Env with underlying IO requests being inspected. It holds a reference to
@@ -53,4 +70,50 @@ class FileSystemInspectedEnv : public EnvWrapper {
 extern Env* NewFileSystemInspectedEnv(
     Env* base_env, std::shared_ptr<FileSystemInspector> inspector);
 
+// A FileSystem with underlying IO requests being inspected, like
+// FileSystemInspectedEnv. Also inspects FSRandomAccessFile::ReadAsync(),
+// admitting the whole read before submitting it. Buffers allocated by the
+// file system (FSSupportedOps::kFSBuffer) are not supported through it.
+class FileSystemInspectedFS : public FileSystemWrapper {
+ public:
+  FileSystemInspectedFS(const std::shared_ptr<FileSystem>& base,
+                        const std::shared_ptr<FileSystemInspector>& inspector);
+
+  static const char* kClassName() { return "FileSystemInspectedFS"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewSequentialFile(const std::string& fname,
+                             const FileOptions& options,
+                             std::unique_ptr<FSSequentialFile>* result,
+                             IODebugContext* dbg) override;
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& options,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override;
+  IOStatus NewWritableFile(const std::string& fname, const FileOptions& options,
+                           std::unique_ptr<FSWritableFile>* result,
+                           IODebugContext* dbg) override;
+  IOStatus ReopenWritableFile(const std::string& fname,
+                              const FileOptions& options,
+                              std::unique_ptr<FSWritableFile>* result,
+                              IODebugContext* dbg) override;
+  IOStatus ReuseWritableFile(const std::string& fname,
+                             const std::string& old_fname,
+                             const FileOptions& options,
+                             std::unique_ptr<FSWritableFile>* result,
+                             IODebugContext* dbg) override;
+  IOStatus NewRandomRWFile(const std::string& fname, const FileOptions& options,
+                           std::unique_ptr<FSRandomRWFile>* result,
+                           IODebugContext* dbg) override;
+
+  void SupportedOps(int64_t& supported_ops) override;
+
+ private:
+  const std::shared_ptr<FileSystemInspector> inspector_;
+};
+
+extern std::shared_ptr<FileSystem> NewFileSystemInspectedFS(
+    const std::shared_ptr<FileSystem>& base,
+    std::shared_ptr<FileSystemInspector> inspector);
+
 }  // namespace ROCKSDB_NAMESPACE
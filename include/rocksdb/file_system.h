@@ -1915,6 +1915,77 @@ class FSDirectoryWrapper : public FSDirectory {
   FSDirectory* target_;
 };
 
+// Options for NewIOSchedulingFileSystem(). The returned file system queues
+// the reads of the random access files it opens when too many are in flight,
+// and issues them by IOOptions::rate_limiter_priority, so that reads already
+// queued in the device do not hold up a user read for long. Reads of
+// priority below Env::IO_USER (those of compactions and flushes) may only use
+// part of the reads in flight. Unlike the RateLimiter, this does not limit
+// the bytes read per second. Reads submitted with ReadAsync() are not
+// scheduled.
+struct IOSchedulerOptions {
+  // Max reads issued to the wrapped file system and not yet completed.
+  // Further reads wait in the queue of their priority.
+  int max_outstanding_reads = 32;
+
+  // Max reads of priority below Env::IO_USER issued and not yet completed,
+  // so that the rest of max_outstanding_reads stays available to user reads.
+  int max_outstanding_low_pri_reads = 8;
+
+  // A read of priority below Env::IO_USER queued for longer than this is
+  // issued ahead of any read queued after it, even of higher priority, so
+  // that user reads cannot starve compactions. 0 means no deadline.
+  uint64_t max_queue_micros = 100 * 1000;
+
+  // If set, the time reads spend queued is recorded in the histograms
+  // IO_SCHEDULER_QUEUE_{LOW,MID,HIGH,USER}_MICROS. Reads without a priority
+  // (Env::IO_TOTAL) are scheduled and counted as user reads.
+  std::shared_ptr<Statistics> statistics;
+};
+
+// Wraps `base` into a file system scheduling reads, see IOSchedulerOptions.
+// All files opened through the result share the same queues.
+extern Status NewIOSchedulingFileSystem(const std::shared_ptr<FileSystem>& base,
+                                        const IOSchedulerOptions& opts,
+                                        std::shared_ptr<FileSystem>* result);
+
+// Options for NewReadCoalescingFileSystem(), for file systems where each
+// read is costly whatever its size, such as remote object stores. The
+// returned file system merges the requests of a MultiRead() that are close
+// together in the file into fewer reads of the wrapped file system. It can
+// also keep a local copy of the tail of each SST file, where the footer, the
+// metaindex, and the index and filter blocks and partitions are, so that
+// reopening a table and reading its metadata does not go to the wrapped
+// file system again.
+struct ReadCoalescingOptions {
+  // MultiRead() requests of a file at most this many bytes apart are read
+  // with one request to the wrapped file system, the bytes between them read
+  // and dropped. 0 merges only adjacent and overlapping requests.
+  size_t max_gap_bytes = 64 << 10;
+
+  // Max bytes of a request merging several MultiRead() requests.
+  size_t max_merged_bytes = 1 << 20;
+
+  // If not empty, a directory of `local_fs` where the last
+  // `tail_cache_bytes` of an SST file (`.sst` name) are copied, in a single
+  // read of the wrapped file system, the first time a read falls into them.
+  // Later reads there by any reader of the file are served from the copy.
+  // The copy is dropped when the SST file is deleted or renamed through the
+  // returned file system, so SST files must not be changed otherwise.
+  std::string tail_cache_dir;
+
+  size_t tail_cache_bytes = 4 << 20;
+
+  // File system of `tail_cache_dir`. nullptr means FileSystem::Default().
+  std::shared_ptr<FileSystem> local_fs;
+};
+
+// Wraps `base` into a file system coalescing reads, see
+// ReadCoalescingOptions.
+extern Status NewReadCoalescingFileSystem(
+    const std::shared_ptr<FileSystem>& base, const ReadCoalescingOptions& opts,
+    std::shared_ptr<FileSystem>* result);
+
 // A utility routine: write "data" to the named file.
 extern IOStatus WriteStringToFile(FileSystem* fs, const Slice& data,
                                   const std::string& fname,
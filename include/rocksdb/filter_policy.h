@@ -208,4 +208,26 @@ const FilterPolicy* NewBloomFilterPolicy(
 FilterPolicy* NewRibbonFilterPolicy(double bloom_equivalent_bits_per_key,
                                     int bloom_before_level = 0);
 
+// EXPERIMENTAL
+// A filter that, in addition to point lookups and prefix seeks, can rule out
+// ranges of keys, so that a short range scan (iterator Seek() with
+// ReadOptions::iterate_upper_bound) finding no keys in an SST file does not
+// need to read any of its data blocks. The range [target, upper bound) can
+// only be ruled out when both ends share the same first `prefix_len` bytes,
+// and works best when the keys in the range differ within the next eight
+// bytes (after which keys are treated as equal).
+//
+// Each key is added to an underlying Bloom filter at `levels` levels of
+// granularity, and bits_per_key applies to each of these entries, though
+// adjacent keys share their entries at coarser levels. A range check takes
+// up to about 2 * `levels` probes, and ranges spanning more than a few
+// times 2^(levels - 1) distinct values of those eight bytes are not ruled
+// out. Range checks require BytewiseComparator, whole_key_filtering, and
+// a full (not partitioned) filter.
+//
+// Range filters are only readable by RocksDB versions with this feature.
+// Earlier versions reading the data will behave as if no filter was used.
+FilterPolicy* NewRangeFilterPolicy(double bits_per_key, size_t prefix_len = 0,
+                                   int levels = 8);
+
 }  // namespace ROCKSDB_NAMESPACE
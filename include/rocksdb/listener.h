@@ -28,6 +28,8 @@ using TablePropertiesCollection =
 
 class DB;
 class ColumnFamilyHandle;
+struct IOStatsContext;
+struct PerfContext;
 class Status;
 struct CompactionJobStats;
 
@@ -157,6 +159,9 @@ enum class CompactionReason : int {
   // [InternalOnly] DBImpl::ReFitLevel treated as a compaction,
   // Used only for internal conflict checking with other compactions
   kRefitLevel,
+  // Dropping files whose keys are all deleted by range tombstones of a higher
+  // level, see drop_files_covered_by_range_deletions
+  kRangeDeletionCoveredFiles,
   // total number of compaction reasons, new reasons must be added above this.
   kNumOfReasons,
 };
@@ -211,6 +216,26 @@ struct WriteStallInfo {
   } condition;
 };
 
+// A write stall of a column family, from the time its write stall condition
+// or cause changed to a stall until it changed again
+struct WriteStallDetailInfo {
+  // the name of the column family
+  std::string cf_name;
+  // kDelayed or kStopped
+  WriteStallCondition condition = WriteStallCondition::kNormal;
+  WriteStallCause cause = WriteStallCause::kNone;
+  uint64_t start_micros = 0;
+  // 0 while the stall is ongoing
+  uint64_t end_micros = 0;
+  // The state of the column family when the stall started
+  uint64_t pending_compaction_bytes = 0;
+  int num_l0_files = 0;
+  int num_unflushed_memtables = 0;
+  int num_memtables_being_flushed = 0;
+  int num_running_compactions = 0;
+  int num_running_l0_compactions = 0;
+};
+
 
 struct FileDeletionInfo {
   FileDeletionInfo() = default;
@@ -536,6 +561,19 @@ struct IOErrorInfo {
   uint64_t offset;
 };
 
+// Information about an operation sampled per
+// DBOptions::perf_context_sample_one_in
+struct SampledOperationInfo {
+  std::string db_name;
+  // "Get" or "Write"
+  const char* operation = nullptr;
+  Status status;
+  uint64_t elapsed_micros = 0;
+  // The contexts of the calling thread, counting only this operation
+  const PerfContext* perf_context = nullptr;
+  const IOStatsContext* iostats_context = nullptr;
+};
+
 // EventListener class contains a set of callback functions that will
 // be called when specific RocksDB event happens such as flush.  It can
 // be used as a building block for developing custom features such as
@@ -754,6 +792,15 @@ class EventListener : public Customizable {
   // returns.  Otherwise, RocksDB may be blocked.
   virtual void OnStallConditionsChanged(const WriteStallInfo& /*info*/) {}
 
+  // A callback function for RocksDB which will be called when a write stall
+  // of a column family starts, with end_micros 0, and when it ends. A change
+  // of the condition or the cause of a stall ends it and starts a new one.
+  // The stalls are also kept in the "rocksdb.cf-write-stall-timeline"
+  // property.
+  //
+  // Like OnStallConditionsChanged(), it must return quickly.
+  virtual void OnWriteStallDetail(const WriteStallDetailInfo& /*info*/) {}
+
   // A callback function for RocksDB which will be called whenever a file read
   // operation finishes.
   virtual void OnFileReadFinish(const FileOperationInfo& /* info */) {}
@@ -844,6 +891,13 @@ class EventListener : public Customizable {
   // happens. ShouldBeNotifiedOnFileIO should be set to true to get a callback.
   virtual void OnIOError(const IOErrorInfo& /*info*/) {}
 
+  // A callback function for RocksDB which will be called, on the thread of
+  // the operation, for each operation sampled per
+  // DBOptions::perf_context_sample_one_in that took at least
+  // perf_context_sample_threshold_micros. The contexts in the info are only
+  // valid during the call.
+  virtual void OnSampledOperation(const SampledOperationInfo& /*info*/) {}
+
   ~EventListener() override {}
 };
 
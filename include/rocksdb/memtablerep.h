@@ -27,7 +27,7 @@
 //  - VectorRep: This is backed by an unordered std::vector. On iteration, the
 // vector is sorted. It is intelligent about sorting; once the MarkReadOnly()
 // has been called, the vector will only be sorted once. It is optimized for
-// random-write-heavy workloads.
+// random-write-heavy workloads, and supports concurrent inserts.
 //
 // The last four implementations are designed for situations in which
 // iteration over the entire collection is rare since doing so requires all the
@@ -80,6 +80,26 @@ class MemTableRep {
     virtual int operator()(const char* prefix_len_key,
                            const Slice& key) const = 0;
 
+    // Returns true if keys are ordered by the bytewise order of their user
+    // keys first, so that a.key_head() < b.key_head() implies a < b and a
+    // representation may order most keys without calling this comparator.
+    virtual bool IsBytewiseUserKeyOrder() const { return false; }
+
+    // Returns the first 8 bytes of the user key of a decoded internal key as
+    // a big-endian integer, padded with zeros if the user key is shorter.
+    static uint64_t key_head(const DecodedType& key) {
+      const size_t user_key_size = key.size() > 8 ? key.size() - 8 : 0;
+      const size_t n = user_key_size < 8 ? user_key_size : 8;
+      uint64_t head = 0;
+      for (size_t i = 0; i < 8; i++) {
+        head <<= 8;
+        if (i < n) {
+          head |= static_cast<unsigned char>(key.data()[i]);
+        }
+      }
+      return head;
+    }
+
     virtual ~KeyComparator() {}
   };
 
@@ -334,9 +354,23 @@ class MemTableRepFactory : public Customizable {
 //     search from the previously visited record (doing at most 'lookahead'
 //     steps). This is an optimization for the access pattern including many
 //     seeks with consecutive keys.
+//   use_key_head: If true and the column family uses BytewiseComparator
+//     without timestamps, each node also stores the first 8 bytes of its
+//     user key, so that most comparisons during a search are a single
+//     integer compare. This costs 8 bytes of memtable memory per entry.
+//     Default: false
+//   point_lookup_index_buckets: If non-zero and the column family uses
+//     BytewiseComparator without timestamps, a hash index with this many
+//     buckets maps every user key to its newest entry. Point lookups then
+//     skip the skip list search when the key is absent or its newest version
+//     is visible to them. The index is allocated from the memtable's arena
+//     and counts towards its size: 8 bytes per bucket when the memtable is
+//     created, and 16 bytes per distinct user key.
+//     Default: 0 (no index)
 class SkipListFactory : public MemTableRepFactory {
  public:
-  explicit SkipListFactory(size_t lookahead = 0);
+  explicit SkipListFactory(size_t lookahead = 0, bool use_key_head = false,
+                           size_t point_lookup_index_buckets = 0);
 
   // Methods for Configurable/Customizable class overrides
   static const char* kClassName() { return "SkipListFactory"; }
@@ -357,6 +391,8 @@ class SkipListFactory : public MemTableRepFactory {
 
  private:
   size_t lookahead_;
+  bool use_key_head_;
+  size_t point_lookup_index_buckets_;
 };
 
 // This uses a doubly skip list to store keys, which is similar to skip list,
@@ -380,6 +416,32 @@ class DoublySkipListFactory : public MemTableRepFactory {
   size_t lookahead_;
 };
 
+// This uses a B+-tree with cache line aligned nodes to store keys. A lookup
+// touches fewer cache lines than in a skip list, which pays off for large
+// memtables whose working set doesn't fit in the CPU caches. Inserts lock
+// only the nodes they modify and reads are lock-free, so concurrent inserts
+// are supported. Prev() searches from the root, like in SkipListFactory.
+class BTreeRepFactory : public MemTableRepFactory {
+ public:
+  BTreeRepFactory() {}
+
+  // Methods for Configurable/Customizable class overrides
+  static const char* kClassName() { return "BTreeRepFactory"; }
+  static const char* kNickName() { return "btree"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+
+  // Methods for MemTableRepFactory class overrides
+  using MemTableRepFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                 Allocator*, const SliceTransform*,
+                                 Logger* logger) override;
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+};
+
 // This creates MemTableReps that are backed by an std::vector. On iteration,
 // the vector is sorted. This is useful for workloads where iteration is very
 // rare and writes are generally not issued after reads begin.
@@ -388,11 +450,15 @@ class DoublySkipListFactory : public MemTableRepFactory {
 //   count: Passed to the constructor of the underlying std::vector of each
 //     VectorRep. On initialization, the underlying array will be at least count
 //     bytes reserved for usage.
+// count: the number of entries to reserve space for in each memtable
+// sort_threads: the number of threads that sort a memtable when it is
+// iterated, normally by flush, after it became immutable
 class VectorRepFactory : public MemTableRepFactory {
   size_t count_;
+  int sort_threads_;
 
  public:
-  explicit VectorRepFactory(size_t count = 0);
+  explicit VectorRepFactory(size_t count = 0, int sort_threads = 1);
 
   // Methods for Configurable/Customizable class overrides
   static const char* kClassName() { return "VectorRepFactory"; }
@@ -405,11 +471,15 @@ class VectorRepFactory : public MemTableRepFactory {
   virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
                                          Allocator*, const SliceTransform*,
                                          Logger* logger) override;
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
 };
 
-// This class contains a fixed array of buckets, each
-// pointing to a skiplist (null if the bucket is empty).
-// bucket_count: number of fixed array buckets
+// This class contains a hash table from each prefix to a skiplist of its
+// keys. The table doubles its number of buckets as prefixes are added,
+// splitting one bucket at a time, and supports concurrent inserts
+// (allow_concurrent_memtable_write).
+// bucket_count: initial number of buckets, rounded up to a power of two
 // skiplist_height: the max height of the skiplist
 // skiplist_branching_factor: probabilistic size ratio between adjacent
 //                            link lists in the skiplist
@@ -418,10 +488,11 @@ extern MemTableRepFactory* NewHashSkipListRepFactory(
     int32_t skiplist_branching_factor = 4);
 
 // The factory is to create memtables based on a hash table:
-// it contains a fixed array of buckets, each pointing to either a linked list
-// or a skip list if number of entries inside the bucket exceeds
-// threshold_use_skiplist.
-// @bucket_count: number of fixed array buckets
+// it maps each prefix to either a linked list of its keys or a skip list if
+// number of entries of the prefix exceeds threshold_use_skiplist. The table
+// doubles its number of buckets as prefixes are added, splitting one bucket
+// at a time.
+// @bucket_count: initial number of buckets, rounded up to a power of two
 // @huge_page_tlb_size: if <=0, allocate the hash table bytes from malloc.
 //                      Otherwise from huge page TLB. The user needs to reserve
 //                      huge pages for it to be allocated, like:
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -301,6 +302,21 @@ struct ColumnFamilyOptions : public AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   bool disable_write_stall = false;
 
+  // If true, writes are slowed down gradually before the column family
+  // reaches a write stall condition, instead of at full speed until the
+  // delayed write rate applies. Between where compactions are sped up and
+  // `level0_slowdown_writes_trigger` (or `soft_pending_compaction_bytes_limit`)
+  // the write rate is lowered from `delayed_write_rate` to half of it, in
+  // proportion to how far along the way the L0 file count (or the pending
+  // compaction bytes) is. While that progress is increasing, it is
+  // extrapolated one step ahead, so that the rate drops ahead of a growing
+  // backlog. The delay then continues from that rate once writes stall.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through SetOptions() API
+  bool smooth_write_slowdown = false;
+
   // This is a factory that provides TableFactory objects.
   // Default: a block-based table factory that provides a default
   // implementation of TableBuilder and TableReader with default
@@ -466,6 +482,14 @@ class CompactionService : public Customizable {
     return CompactionServiceJobStatus::kUseLocal;
   }
 
+  // Called once the DB starts shutting down, before it waits for background
+  // work. Compactions blocked in `WaitForCompleteV2()` hold up the shutdown
+  // until they return, so a service should make them return soon after this,
+  // for example by canceling the remote jobs through
+  // `OpenAndCompactOptions::canceled`. Any status they return is fine, the
+  // compaction will be aborted either way. This may be called more than once.
+  virtual void CancelAwaitingJobs() {}
+
   ~CompactionService() override = default;
 };
 
@@ -648,6 +672,17 @@ struct DBOptions {
   // Default: 16
   int max_file_opening_threads = 16;
 
+  // Number of threads used to replay the WAL files in DB::Open(). With more
+  // than one thread, a background thread reads and verifies the WAL records
+  // while the opening thread decodes them and inserts them into memtables.
+  // With more than two threads, and if allow_concurrent_memtable_write is
+  // set and the DB is not a two-phase-commit TransactionDB, the remaining
+  // threads also insert consecutive write batches into memtables
+  // concurrently.
+  //
+  // Default: 1
+  int wal_recovery_threads = 1;
+
   // Once write-ahead logs exceed this size, we will start forcing the flush of
   // column families whose memtables are backed by the oldest live WAL file
   // (i.e. the ones that are causing all the space amplification). If set to 0
@@ -671,6 +706,18 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint64_t max_total_wal_size = 0;
 
+  // If non-zero, once more than this many WAL files are alive we force the
+  // flush of the column families whose memtables are backed by the oldest
+  // one, as with max_total_wal_size. This keeps a column family with a low
+  // write rate from holding on to WAL files that were written mostly by
+  // busier ones, and bounds how many WAL files recovery has to replay.
+  //
+  // Like max_total_wal_size, this option takes effect only when there are
+  // more than one column family.
+  //
+  // Default: 0
+  size_t max_alive_wal_files = 0;
+
   // If non-null, then we should collect metrics about database operations
   std::shared_ptr<Statistics> statistics = nullptr;
 
@@ -768,6 +815,55 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint32_t max_subcompactions = 1;
 
+  // If greater than 1, a compaction that is split into subcompactions cuts
+  // its key range into up to this many pieces per subcompaction thread
+  // instead of one, and the max_subcompactions threads take pieces, largest
+  // estimated size first, as they become free. A thread that finishes early
+  // then picks up work that would otherwise have been left to the slowest
+  // one, so skewed key distributions no longer stretch out the whole
+  // compaction. No piece is made smaller than the target file size of the
+  // output level, and each one ends its last output file at its upper bound,
+  // so this produces a few more files that are smaller than the target.
+  //
+  // Default: 1
+  uint32_t subcompaction_ranges_per_thread = 1;
+
+  // If greater than 1, a flush whose memtables hold at least twice
+  // `target_file_size_base` of data is split into up to this many key ranges,
+  // no smaller than `target_file_size_base` each, which are built into
+  // non-overlapping L0 files in parallel on as many threads. The ranges are
+  // cut at keys sampled from the memtables. This shortens large flushes, for
+  // example with a slow compression, at the cost of more and smaller L0
+  // files, each of which counts towards `level0_file_num_compaction_trigger`
+  // and the L0 write stall triggers. Flushes with range deletions, of column
+  // families with user-defined timestamps or memtables other than skip lists,
+  // and atomic flushes build one file as before.
+  //
+  // Default: 1
+  uint32_t max_flush_subjobs = 1;
+
+  // If positive and `statistics` is set, the number of compactions allowed to
+  // run at once, and the rate of `rate_limiter` if there is one, are adjusted
+  // every ten seconds based on the average latency of the foreground
+  // operations (Get(), MultiGet(), Write() and iterator seeks) recorded in
+  // `statistics` over that time:
+  // - If it is above this value, the number of compactions is halved and so
+  //   is the rate, down to one compaction and an eighth of the rate.
+  // - If it is below 80% of this value, or there were no operations, one more
+  //   compaction is allowed, up to the limit from `max_background_jobs`, and
+  //   the rate is increased by a quarter, up to the one `rate_limiter` had
+  //   when the adjustment started.
+  // This way compactions use the capacity left idle by foreground traffic,
+  // and back off when they slow it down. The limit does not apply while
+  // writes are being delayed or stopped, as holding back compactions then
+  // would only make that worse.
+  //
+  // Default: 0 (disabled, compactions are only limited by
+  // max_background_jobs and the write controller)
+  //
+  // Dynamically changeable through SetDBOptions() API.
+  uint64_t compaction_throttle_latency_micros = 0;
+
   // DEPRECATED: RocksDB automatically decides this based on the
   // value of max_background_jobs. For backwards compatibility we will set
   // `max_background_jobs = max_background_compactions + max_background_flushes`
@@ -823,6 +919,16 @@ struct DBOptions {
   // reach the limit of storage capacity.
   uint64_t max_manifest_file_size = 1024 * 1024 * 1024;
 
+  // If positive, the manifest file is also rolled over once the edits
+  // appended to it exceed this percentage of the snapshot of the live state
+  // that starts it. This bounds what DB::Open() replays to a multiple of the
+  // live state, whatever the history of edits. Each roll over writes a new
+  // snapshot, which adds at most 100 / max_manifest_space_amp_pct times the
+  // appended edits to the writes of the manifest.
+  //
+  // Default: 0 (roll over at max_manifest_file_size only)
+  uint32_t max_manifest_space_amp_pct = 0;
+
   // Number of shards used for table cache.
   int table_cache_numshardbits = 6;
 
@@ -980,6 +1086,19 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t compaction_readahead_size = 2 * 1024 * 1024;
 
+  // If true, and compaction_readahead_size is non-zero, compaction input
+  // files are read ahead asynchronously, into two buffers of half the
+  // readahead size each: while the compaction consumes one of them, the
+  // other is filled, so that reading the input overlaps with processing it.
+  // Each input file of a compaction has its own pair of buffers, so the
+  // files being merged are all read ahead at once. Only has an effect if the
+  // file system supports asynchronous reads, see
+  // FSSupportedOps::kAsyncIO; otherwise input files are read ahead
+  // synchronously, as when false.
+  //
+  // Default: false
+  bool compaction_async_io = false;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -1008,6 +1127,17 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t writable_file_max_buffer_size = 1024 * 1024;
 
+  // If true, the table files written by flushes and compactions are written
+  // behind: once the buffer of a file (see writable_file_max_buffer_size) is
+  // full, it is written out by a background thread while the flush or
+  // compaction fills a second buffer, so that building the file overlaps
+  // with writing it. Range syncs per bytes_per_sync are issued in the
+  // background as well. Doubles the memory used for the buffers of these
+  // files, and has no effect with use_direct_io_for_flush_and_compaction.
+  //
+  // Default: false
+  bool table_file_write_behind = false;
+
   // Use adaptive mutex, which spins in the user space before resorting
   // to kernel. This could reduce context switch when the mutex is not
   // heavily contended. However, if the mutex is hot, we could end up
@@ -1072,6 +1202,52 @@ struct DBOptions {
   // when specific RocksDB event happens.
   std::vector<std::shared_ptr<EventListener>> listeners;
 
+  // If positive and there are listeners, about one in this many Get() and
+  // Write() calls runs with PerfLevel::kEnableTimeExceptForMutex, and those
+  // taking at least perf_context_sample_threshold_micros have their
+  // PerfContext and IOStatsContext passed to
+  // EventListener::OnSampledOperation(). Calls from threads with a perf level
+  // that times counters already are not sampled, and the counters of a
+  // sampled call are left out of the PerfContext and IOStatsContext of the
+  // thread.
+  //
+  // Default: 0 (no sampling)
+  uint32_t perf_context_sample_one_in = 0;
+
+  // See perf_context_sample_one_in
+  //
+  // Default: 0
+  uint64_t perf_context_sample_threshold_micros = 0;
+
+  // If positive, about one in this many block cache lookups of the user reads
+  // of block-based tables is counted, as a hit or a miss, for the SST file of
+  // the block. See DB::Properties::kBlockCacheHeatMap. Sampling costs a
+  // thread-local random number per lookup.
+  //
+  // Default: 1000
+  uint32_t block_cache_heat_sample_one_in = 1000;
+
+  // The flushes and compactions of this DB are scheduled on the thread pools
+  // of `env` with tags registered with this weight: with fair scheduling on
+  // the pools (see Env::SetThreadPoolFairScheduling()), a DB runs up to this
+  // many of its queued jobs of a pool in its turn, so the DBs sharing an Env
+  // get pool threads in proportion to their weights rather than to their
+  // backlogs. The queue waits of the jobs are reported by
+  // DB::Properties::kBackgroundQueueStats. 0 doesn't register the tags.
+  //
+  // Default: 1
+  uint32_t background_job_weight = 1;
+
+  // If positive, the waits for the DB mutex and the holds of it that take at
+  // least this many microseconds are counted for the source file and line
+  // that locked the mutex, and the last long waits are kept with the call
+  // site holding the mutex at the time. See
+  // DB::Properties::kDBMutexContention. Profiling takes two clock reads per
+  // lock of the DB mutex.
+  //
+  // Default: 0 (no profiling)
+  uint64_t db_mutex_contention_threshold_micros = 0;
+
   // If true, then the status of the threads involved in this DB will
   // be tracked and available via GetThreadList() API.
   //
@@ -1111,6 +1287,18 @@ struct DBOptions {
   // Default: false
   bool enable_pipelined_write = false;
 
+  // If enable_pipelined_write is true, a WAL write group with sync=true
+  // appends its records and hands over WAL leadership before the fsync is
+  // issued. The fsync is then done by the memtable writer stage, so the next
+  // group can append to the WAL while the previous one is still syncing. A
+  // write still does not become visible or return until the WAL is durable up
+  // to its last sequence number, and one fsync covers every group appended
+  // before it was issued. Ignored if the WAL file does not support syncing
+  // concurrently with appends, or if manual_wal_flush is set.
+  //
+  // Default: false
+  bool enable_pipelined_wal_sync = false;
+
   // Setting unordered_write to true trades higher write throughput with
   // relaxing the immutability guarantee of snapshots. This violates the
   // repeatability one expects from ::Get from a snapshot, as well as
@@ -1153,6 +1341,15 @@ struct DBOptions {
   // Default: false
   bool enable_multi_batch_write = false;
 
+  // If enable_multi_batch_write is true, WriteBatches larger than this many
+  // bytes are cut into ranges of about this size before they are applied to
+  // the memtable. Writers that finish their own batches early then steal
+  // ranges from the back of a large batch instead of waiting for its writer
+  // to insert it alone. 0 keeps every WriteBatch whole.
+  //
+  // Default: 0
+  size_t multi_batch_write_split_bytes = 0;
+
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
   // is implemented only for SkipListFactory.  Concurrent memtable writes
@@ -1163,6 +1360,46 @@ struct DBOptions {
   // Default: true
   bool allow_concurrent_memtable_write = true;
 
+  // If true, and RocksDB is built with NUMA (WITH_NUMA=ON) on a host with
+  // more than one NUMA node, the memtable arena keeps one arena per node
+  // and concurrent writers allocate their per-core blocks on the node they
+  // run on. Without this, blocks are placed wherever the allocator's memory
+  // happens to live. The MEMTABLE_NUMA_REMOTE_BYTES ticker reports, with or
+  // without this option, how many bytes of such blocks were placed on a
+  // node other than the writer's.
+  //
+  // Default: false
+  bool numa_aware_memtable_arena = false;
+
+  // If >= 0 and RocksDB is built with NUMA, the pages of a memtable that
+  // becomes immutable are moved to this NUMA node while it waits to be
+  // flushed, such as a node of CXL-attached memory, larger but slower than
+  // the DRAM the active memtables stay in. The memtable arenas then map their
+  // blocks separately, which memtable_arena_pool_size does not apply to. The
+  // MEMTABLE_FAR_MEMORY_BYTES ticker counts the bytes moved.
+  //
+  // Default: -1
+  int immutable_memtable_numa_node = -1;
+
+  // If non-zero, memtables of all column families take their arena blocks
+  // from a pool of up to this many bytes, and give them back to it when they
+  // are freed after a flush, instead of returning the memory to the
+  // allocator. Whenever a memtable is created, a background thread fills
+  // the pool with pre-faulted blocks, so that writes into a fresh memtable
+  // do not take page faults. The pooled memory stays allocated while the DB
+  // is open and is not charged to the write buffer manager. Blocks of
+  // memtables that use memtable_huge_page_size are not pooled.
+  //
+  // The pool never holds more than the sum, over the column families, of
+  // write_buffer_size * (max_write_buffer_number - 1), so that pooled and
+  // live memtables together stay within the memory that live memtables
+  // could use anyway. Set this to SIZE_MAX to size the pool by that alone.
+  // The MEMTABLE_ARENA_POOL_HIT and MEMTABLE_ARENA_POOL_MISS tickers count
+  // the blocks that were and were not found in the pool.
+  //
+  // Default: 0 (disabled)
+  size_t memtable_arena_pool_size = 0;
+
   // If true, threads synchronizing with the write batch group leader will
   // wait for up to write_thread_max_yield_usec before blocking on a mutex.
   // This can substantially improve throughput for concurrent workloads,
@@ -1178,6 +1415,19 @@ struct DBOptions {
   // Default: 1 MB
   uint64_t max_write_batch_group_size_bytes = 1 << 20;
 
+  // If non-zero, the byte and writer limits of a write group adapt to the
+  // observed WAL write latency, aiming to keep its p99 under this many
+  // microseconds. Limits shrink when more than 1% of recent WAL writes are
+  // slower than the target, and grow back towards
+  // max_write_batch_group_size_bytes while writers are being left out of
+  // groups only because of those limits. The current limits are exposed as
+  // the "rocksdb.write-group-size-limit-bytes" and
+  // "rocksdb.write-group-size-limit-writers" DB properties. Does not apply
+  // when two_write_queues is set.
+  //
+  // Default: 0 (disabled)
+  uint64_t write_group_target_wal_latency_us = 0;
+
   // The maximum number of microseconds that a write operation will use
   // a yielding spin loop to coordinate with other write threads before
   // blocking on a mutex.  (Assuming write_thread_slow_yield_usec is
@@ -1227,6 +1477,20 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<RowCache> row_cache = nullptr;
 
+  // If true, `row_cache` caches the values that Get() reads from the table
+  // files of a column family by user key, instead of the rows of each table
+  // file. A cached value stays valid until a table file that may have newer
+  // entries than it for the key is added, usually by a flush, so most
+  // compactions keep it, where they drop the rows cached for their input files.
+  // The values cached for a column family are dropped when compactions drop
+  // deletions, and when table files are ingested or deleted with their data, as
+  // by DeleteFilesInRange() and FIFO compaction. Only values read without a
+  // read callback (as in transactions) are cached, and the column families with
+  // a compaction filter or user-defined timestamps don't use the row cache.
+  //
+  // Default: false
+  bool row_cache_by_user_key = false;
+
   // A filter object supplied to be invoked while processing write-ahead-logs
   // (WALs) during recovery. The filter provides a way to inspect log
   // records, ignoring a particular record or skipping replay.
@@ -1290,12 +1554,33 @@ struct DBOptions {
   // file.
   bool manual_wal_flush = false;
 
+  // If true, and RocksDB was built with liburing, WAL appends and syncs on
+  // the Posix file system are submitted through a per-file io_uring. An
+  // append returns once it is submitted instead of once it is written, and a
+  // sync waits for every append issued before it. WAL data that is appended
+  // but not yet synced may briefly be invisible to readers of the live WAL
+  // file, e.g. GetUpdatesSince() or a secondary instance. Other file systems
+  // ignore this option.
+  //
+  // Default: false
+  bool wal_use_io_uring = false;
+
   // This feature is WORK IN PROGRESS
   // If enabled WAL records will be compressed before they are written.
   // Only zstd is supported. Compressed WAL records will be read in supported
   // versions regardless of the wal_compression settings.
   CompressionType wal_compression = kNoCompression;
 
+  // If non-zero and the DB is opened with DB::OpenAsSecondary(), a background
+  // thread of the secondary instance calls TryCatchUpWithPrimary() every this
+  // many milliseconds, tailing the MANIFEST and the WALs of the primary from
+  // where the previous catch-up stopped. The application does not need to
+  // call TryCatchUpWithPrimary() itself then, though it still can. Ignored by
+  // other DBs.
+  //
+  // Default: 0 (disabled)
+  uint64_t secondary_catch_up_interval_ms = 0;
+
   // If true, RocksDB supports flushing multiple column families and committing
   // their results atomically to MANIFEST. Note that it is not
   // necessary to set atomic_flush to true if WAL is always enabled since WAL
@@ -1462,6 +1747,62 @@ struct DBOptions {
   // inconsistency, e.g. deleted old data become visible again, etc.
   bool enforce_single_del_contracts = true;
 
+  // EXPERIMENTAL
+  // If positive, every this many seconds the DB records which blocks of its
+  // table files are in the block cache, in a small BLOCK_CACHE_HOTNESS file
+  // in the DB directory. The next DB::Open() then loads those blocks back into
+  // the block cache in the background: first the index and filter blocks,
+  // then the data blocks, files with the most cached blocks first. Unlike
+  // CacheDumper, only the locations of the blocks are persisted, and blocks of
+  // files compacted away in the meantime are skipped. The reads are issued at
+  // Env::IO_LOW priority, so a `rate_limiter` applying to reads bounds them.
+  //
+  // Default: 0 (disabled)
+  uint64_t block_cache_hotness_persist_period_sec = 0;
+
+  // EXPERIMENTAL
+  // If true, the table cache is a HyperClockCache instead of an LRUCache, so
+  // that looking up a table reader that is already open takes no mutex. This
+  // helps many threads reading with a bounded `max_open_files`. With
+  // `max_open_files` = -1 the readers are pinned and not looked up in the
+  // table cache anyway. The table cache is sized for the `max_open_files` at
+  // DB::Open(), so raising it later with SetDBOptions() gives less benefit.
+  //
+  // Default: false
+  bool lock_free_table_cache = false;
+
+  // EXPERIMENTAL
+  // If true, when an iterator moves to an SST file of a level (other than
+  // L0), the reader of the next file of the level is opened in the background
+  // if it is not in the table cache, so that a forward scan crossing into that
+  // file does not wait for its footer, index and filter to be read. Only one
+  // such open is in progress per level per iterator. Has no effect with
+  // `max_open_files` = -1, where all readers are kept open, unless
+  // `table_cache_open_ahead_prefetch_size` is set.
+  //
+  // Default: false
+  bool table_cache_open_ahead = false;
+
+  // EXPERIMENTAL
+  // With `table_cache_open_ahead`, how far into an SST file a forward scan
+  // reads, as a fraction of the entries of the file, before the next file is
+  // opened ahead. 0 opens it as soon as the scan moves to the file. A larger
+  // fraction avoids opening files ahead of short scans, as long as it leaves
+  // time for the open to complete before the scan reaches the next file.
+  //
+  // Default: 0
+  double table_cache_open_ahead_fraction = 0;
+
+  // EXPERIMENTAL
+  // With `table_cache_open_ahead`, if non-zero, the first data blocks of the
+  // next file, up to this many bytes, are also loaded into the block cache in
+  // the background, whether or not the reader of the file was open already.
+  // A forward scan crossing into the file then does not wait for their reads
+  // either. Has no effect on iterators with `ReadOptions::fill_cache` false.
+  //
+  // Default: 0
+  size_t table_cache_open_ahead_prefetch_size = 0;
+
   // EXPERIMENTAL
   // Implementing off-peak duration awareness in RocksDB. In this context,
   // "off-peak time" signifies periods characterized by significantly less read
@@ -1641,8 +1982,27 @@ struct ReadOptions {
   // MultiGet latency by maximizing the number of SST files read in
   // parallel if the keys in the MultiGet batch are in different levels. It
   // comes at the expense of slightly higher CPU overhead.
+  //
+  // Builds without coroutine support (USE_COROUTINES), or file systems
+  // without async reads, instead hint the file system to read ahead the data
+  // blocks that the keys may be in, in all levels whose filters do not rule
+  // the keys out, before searching the levels one after the other. The hints
+  // only use index and filter blocks already in the block cache and have no
+  // effect with direct I/O.
   bool optimize_multiget_for_io = true;
 
+  // Experimental
+  //
+  // If non-nullptr, wide-column reads (GetEntity, MultiGetEntity and
+  // Iterator::columns()) of entities written by PutEntity only return the
+  // columns whose names are in this list; the values of the other columns
+  // are skipped without being materialized. For iterators, value() of such
+  // an entity is empty unless the default column is in the list. Plain
+  // key-values are not affected. The names must be sorted in bytewise order
+  // without duplicates, and the vector has to outlive the read or the
+  // iterator.
+  const std::vector<Slice>* wide_column_projection = nullptr;
+
   // *** END options relevant to point lookups (as well as scans) ***
   // *** BEGIN options only relevant to iterators or scans ***
 
@@ -1656,6 +2016,20 @@ struct ReadOptions {
   // of forward iteration on spinning disks.
   size_t readahead_size = 0;
 
+  // If non-zero, forward iteration reads ahead this many bytes in each blob
+  // file when a blob value is not in the blob cache, so that the following
+  // blobs, which are usually stored next to each other in key order, are
+  // fetched in the same I/O. Only applies to integrated BlobDB.
+  size_t blob_readahead_size = 0;
+
+  // If greater than one, forward iteration that has to read a blob value
+  // looks ahead at the blob references of up to this many following keys
+  // (at most 32) and reads their blobs together, with one MultiRead() per
+  // blob file in offset order, instead of reading one blob per key. This lets
+  // scans of large values keep several reads outstanding on the device. Only
+  // applies to integrated BlobDB.
+  size_t blob_batch_size = 0;
+
   // A threshold for the number of keys that can be skipped before failing an
   // iterator seek as incomplete. The default value of 0 should be used to
   // never fail a request as incomplete, even on skipping too many keys.
@@ -1765,6 +2139,20 @@ struct ReadOptions {
   // Default: empty (every table will be scanned)
   std::function<bool(const TableProperties&)> table_filter;
 
+  // EXPERIMENTAL A callback to determine whether relevant keys for this scan
+  // exist in a given data block based on the properties the table properties
+  // collectors recorded for it (see
+  // TablePropertiesCollector::FinishDataBlock()). The callback is passed the
+  // name of each collector with a property for the block and that property.
+  // If it returns false for any of them, the block is skipped without being
+  // read, as if it were empty. Like table_filter, skipping a block also skips
+  // the tombstones in it, so older versions of its keys in other tables may
+  // be returned instead. This option only affects Iterators on block-based
+  // tables and has no impact on point lookups.
+  // Default: empty (every data block will be scanned)
+  std::function<bool(const Slice& collector_name, const Slice& block_property)>
+      block_property_filter;
+
   // If auto_readahead_size is set to true, it will auto tune the readahead_size
   // during scans internally.
   // For this feature to enabled, iterate_upper_bound must also be specified.
@@ -1840,10 +2228,13 @@ struct WriteOptions {
   bool low_pri;
 
   // If true, this writebatch will maintain the last insert positions of each
-  // memtable as hints in concurrent write. It can improve write performance
-  // in concurrent writes if keys in one writebatch are sequential. In
-  // non-concurrent writes (when concurrent_memtable_writes is false) this
-  // option will be ignored.
+  // memtable as hints, so that each key is inserted starting from the
+  // position of the previous one instead of with a full search. It can
+  // improve write performance if keys in one writebatch are sequential, e.g.
+  // when replaying sorted data. In concurrent writes the hints are kept per
+  // batch. In non-concurrent writes every memtable keeps a single hint that
+  // is shared by the batches using this option, ahead of any hint from
+  // memtable_insert_with_hint_prefix_extractor.
   //
   // Default: false
   bool memtable_insert_hint_per_batch;
@@ -1917,6 +2308,17 @@ extern Status CreateLoggerFromOptions(const std::string& dbname,
                                       std::shared_ptr<Logger>* logger);
 
 // CompactionOptions are used in CompactFiles() call.
+// For manual compaction, we can configure if we want to skip/force garbage
+// collection of blob files.
+enum class BlobGarbageCollectionPolicy {
+  // Force blob file garbage collection.
+  kForce,
+  // Skip blob file garbage collection.
+  kDisable,
+  // Inherit blob file garbage collection policy from ColumnFamilyOptions.
+  kUseDefault,
+};
+
 struct CompactionOptions {
   // Compaction output compression type
   // Default: snappy
@@ -1929,11 +2331,18 @@ struct CompactionOptions {
   uint64_t output_file_size_limit;
   // If > 0, it will replace the option in the DBOptions for this compaction.
   uint32_t max_subcompactions;
+  // Same as CompactRangeOptions::blob_garbage_collection_policy
+  BlobGarbageCollectionPolicy blob_garbage_collection_policy;
+  // Same as CompactRangeOptions::blob_garbage_collection_age_cutoff
+  double blob_garbage_collection_age_cutoff;
 
   CompactionOptions()
       : compression(kSnappyCompression),
         output_file_size_limit(std::numeric_limits<uint64_t>::max()),
-        max_subcompactions(0) {}
+        max_subcompactions(0),
+        blob_garbage_collection_policy(
+            BlobGarbageCollectionPolicy::kUseDefault),
+        blob_garbage_collection_age_cutoff(-1) {}
 };
 
 // For level based compaction, we can configure if we want to skip/force
@@ -1954,17 +2363,6 @@ enum class BottommostLevelCompaction {
   kForceOptimized,
 };
 
-// For manual compaction, we can configure if we want to skip/force garbage
-// collection of blob files.
-enum class BlobGarbageCollectionPolicy {
-  // Force blob file garbage collection.
-  kForce,
-  // Skip blob file garbage collection.
-  kDisable,
-  // Inherit blob file garbage collection policy from ColumnFamilyOptions.
-  kUseDefault,
-};
-
 // CompactRangeOptions is used by CompactRange() call.
 struct CompactRangeOptions {
   // If true, no other compaction will run at the same time as this
@@ -2022,6 +2420,25 @@ struct CompactRangeOptions {
   double blob_garbage_collection_age_cutoff = -1;
 };
 
+// GarbageCollectBlobFilesOptions is used by GarbageCollectBlobFiles()
+struct GarbageCollectBlobFilesOptions {
+  // The oldest blob files are collected, as many of them as possible while
+  // the ratio of garbage bytes across them stays at least this. Nothing is
+  // collected if the oldest blob file alone has less garbage.
+  double garbage_ratio_threshold = 0.5;
+
+  // If non-zero, the blob files collected by one call total at most about
+  // this many bytes (at least one file is collected though), so that
+  // garbage can be collected a step at a time.
+  uint64_t max_blob_file_bytes = 0;
+
+  // If set, before each group of SST files is rewritten, the bytes of those
+  // files, plus the live bytes of the collected blob files, are requested
+  // from it with Env::IO_LOW priority. This paces the collection apart from
+  // DBOptions::rate_limiter.
+  std::shared_ptr<RateLimiter> rate_limiter;
+};
+
 // IngestExternalFileOptions is used by IngestExternalFile()
 struct IngestExternalFileOptions {
   // Can be set to true to move the files instead of copying them.
@@ -2095,6 +2512,13 @@ struct IngestExternalFileOptions {
   //
   // ingest_behind takes precedence over fail_if_not_bottommost_level.
   bool fail_if_not_bottommost_level = false;
+  // The number of threads that prepare the files of an ingestion: reading
+  // their properties, copying or linking them into the DB, generating their
+  // checksums and writing their global sequence numbers. Each thread works on
+  // one file at a time, so this helps ingestions of many files, especially on
+  // file systems with high latency. The ingestion blocks writes to the DB
+  // while it writes global sequence numbers, see `write_global_seqno`.
+  int max_file_preparation_threads = 1;
 };
 
 enum TraceFilterType : uint64_t {
@@ -2120,6 +2544,13 @@ struct TraceOptions {
   // Specify trace sampling option, i.e. capture one per how many requests.
   // Default to 1 (capture every request).
   uint64_t sampling_frequency = 1;
+  // For IO tracing only. When positive, the last IO operations, about this
+  // many, are kept in an in-memory ring buffer instead of written to the trace
+  // writer, which may be null. DB::DumpIOTrace() writes the last ones out on
+  // demand.
+  //
+  // Default: 0 (write to the trace writer)
+  uint64_t io_trace_ring_buffer_records = 0;
   // Note: The filtering happens before sampling.
   uint64_t filter = kTraceFilterNone;
   // When true, the order of write records in the trace will match the order of
@@ -2135,6 +2566,11 @@ struct TraceOptions {
 struct ImportColumnFamilyOptions {
   // Can be set to true to move the files instead of copying them.
   bool move_files = false;
+  // The number of threads that prepare the files of an import: reading their
+  // properties and copying or linking them into the DB. Each thread works on
+  // one file at a time, so this helps imports of many files, especially on
+  // file systems with high latency.
+  int max_file_preparation_threads = 1;
 };
 
 // Options used with DB::GetApproximateSizes()
@@ -2191,9 +2627,26 @@ struct CompactionServiceOptionsOverride {
       table_properties_collector_factories;
 };
 
+// Progress of a compaction run by `DB::OpenAndCompact()`, reported through
+// `OpenAndCompactOptions::on_progress`.
+struct CompactionServiceProgress {
+  // Bytes read from the input files so far
+  uint64_t bytes_read = 0;
+  // Bytes written to the output files so far
+  uint64_t bytes_written = 0;
+};
+
 struct OpenAndCompactOptions {
   // Allows cancellation of an in-progress compaction.
   std::atomic<bool>* canceled = nullptr;
+
+  // If set, called from the compacting thread every few thousand input keys
+  // and once when the compaction finishes, e.g. to report progress back to
+  // the primary host. Output files can be shipped as soon as they are
+  // finished, without waiting for the result, by setting an EventListener
+  // in `CompactionServiceOptionsOverride::listeners` and handling
+  // `OnTableFileCreated()`.
+  std::function<void(const CompactionServiceProgress&)> on_progress = nullptr;
 };
 
 struct LiveFilesStorageInfoOptions {
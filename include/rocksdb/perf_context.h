@@ -96,6 +96,9 @@ struct PerfContextBase {
 
   uint64_t block_checksum_time;    // total nanos spent on block checksum
   uint64_t block_decompress_time;  // total nanos spent on block decompression
+  // total number of ZSTD compression and decompression contexts created
+  // because none of the cached ones was free
+  uint64_t zstd_context_create_count;
 
   uint64_t get_read_bytes;       // bytes for vals returned by Get
   uint64_t multiget_read_bytes;  // bytes for vals returned by MultiGet
@@ -195,6 +198,18 @@ struct PerfContextBase {
 
   // time spent waiting for other threads of the batch group
   uint64_t write_thread_wait_nanos;
+  // multi-batch write: time spent waiting for the write to be committed in
+  // sequence order, including write_help_other_writers_nanos
+  uint64_t write_commit_wait_nanos;
+  // multi-batch write: time spent inserting batches of other writers into
+  // the memtable while waiting for the commit
+  uint64_t write_help_other_writers_nanos;
+  // pipelined write: time the WAL group leader spends waiting to enter the
+  // memtable stage after writing the WAL
+  uint64_t write_memtable_queue_wait_nanos;
+  // time a parallel memtable writer spends waiting for the rest of its
+  // group to finish
+  uint64_t write_parallel_memtable_wait_nanos;
 
   // time spent on acquiring DB mutex.
   uint64_t db_mutex_lock_nanos;
@@ -30,6 +30,7 @@ enum PerfFlag : uint32_t {
   compressed_sec_cache_compressed_bytes,
   block_checksum_time,
   block_decompress_time,
+  zstd_context_create_count,
   get_read_bytes,
   multiget_read_bytes,
   iter_read_bytes,
@@ -66,6 +67,10 @@ enum PerfFlag : uint32_t {
   write_scheduling_flushes_compactions_time,
   write_pre_and_post_process_time,
   write_thread_wait_nanos,
+  write_commit_wait_nanos,
+  write_help_other_writers_nanos,
+  write_memtable_queue_wait_nanos,
+  write_parallel_memtable_wait_nanos,
   db_mutex_lock_nanos,
   db_condition_wait_nanos,
   merge_operator_time_nanos,
@@ -165,11 +165,26 @@ class RateLimiter {
 // @auto_tuned: Enables dynamic adjustment of rate limit within the range
 //              `[rate_bytes_per_sec / 20, rate_bytes_per_sec]`, according to
 //              the recent demand for background I/O.
+// @ios_per_sec: If positive, also limits the number of requests, for devices
+// throttling on IOPS as well as bandwidth. Each request is charged at least
+// `rate_bytes_per_sec / ios_per_sec` bytes (but no more than a single burst),
+// so that small reads and writes are limited by their count and large ones
+// by their bytes. The budget of requests follows the rate when it is changed
+// or auto-tuned. GetTotalBytesThrough() counts the bytes charged.
 extern RateLimiter* NewGenericRateLimiter(
     int64_t rate_bytes_per_sec, int64_t refill_period_us = 100 * 1000,
     int32_t fairness = 10,
     RateLimiter::Mode mode = RateLimiter::Mode::kWritesOnly,
-    bool auto_tuned = false);
+    bool auto_tuned = false, int64_t ios_per_sec = 0);
+
+// Create a RateLimiter with separate budgets for reads and writes, which
+// forwards the requests to read to `read_limiter` and the others to
+// `write_limiter`, whatever their modes. GetBytesPerSecond() returns the rate
+// of `write_limiter`, and SetBytesPerSecond() sets it and changes the rate of
+// `read_limiter` in proportion. The statistics are the sums of the two.
+extern RateLimiter* NewReadWriteRateLimiter(
+    const std::shared_ptr<RateLimiter>& read_limiter,
+    const std::shared_ptr<RateLimiter>& write_limiter);
 
 extern RateLimiter* NewWriteAmpBasedRateLimiter(
     int64_t rate_bytes_per_sec, int64_t refill_period_us = 100 * 1000,
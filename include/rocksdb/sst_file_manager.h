@@ -82,6 +82,22 @@ class SstFileManager {
   // thread-safe
   virtual uint64_t GetTotalTrashSize() = 0;
 
+  // Return the read latency above which deletions from trash slow down, see
+  // SetDeleteMaxReadLatencyMicros()
+  // thread-safe
+  virtual uint64_t GetDeleteMaxReadLatencyMicros() = 0;
+
+  // Make deletions from trash adapt to their impact on reads, for instance
+  // when deleting files makes SSDs discard blocks. After each file or chunk
+  // deleted from trash, if the average latency of the SST file reads since
+  // the previous one (histogram SST_READ_MICROS of the statistics set with
+  // SetStatisticsPtr()) is above `micros`, the delete rate is halved, down to
+  // 1/16 of the delete rate limit. Otherwise it is doubled back, up to the
+  // limit. Only has an effect with delete rate limiting and statistics.
+  // zero means deletions do not adapt to reads (Default value).
+  // thread-safe
+  virtual void SetDeleteMaxReadLatencyMicros(uint64_t micros) = 0;
+
   // Set the statistics ptr to dump the stat information
   virtual void SetStatisticsPtr(const std::shared_ptr<Statistics>& stats) = 0;
 };
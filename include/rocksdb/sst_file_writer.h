@@ -77,6 +77,18 @@ struct ExternalSstFileInfo {
 
 // SstFileWriter is used to create sst files that can be added to database later
 // All keys in files generated by SstFileWriter will have sequence number = 0.
+//
+// The file is compressed as for the bottommost level of the DB, with
+// `bottommost_compression` and `bottommost_compression_opts` when they are
+// set. With `CompressionOptions::parallel_threads` > 1 in the compression
+// options used, the keys are still added on the calling thread, but the data
+// blocks are compressed on that many threads and written in order.
+//
+// Writers of a large amount of data can also split it into key ranges, write
+// a file for each range concurrently with an SstFileWriter per thread, and
+// ingest the files in one call, since files with non-overlapping key ranges
+// are ingested together. See
+// `IngestExternalFileOptions::max_file_preparation_threads`.
 class SstFileWriter {
  public:
   // User can pass `column_family` to specify that the generated file will
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/customizable.h"
 #include "rocksdb/rocksdb_namespace.h"
@@ -15,6 +16,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Comparator;
 class Slice;
 
 enum PartitionerResult : char {
@@ -82,6 +84,9 @@ class SstPartitioner {
     Slice smallest_user_key;
     // Largest key for compaction
     Slice largest_user_key;
+    // The user comparator of the column family, or nullptr for
+    // BytewiseComparator()
+    const Comparator* user_comparator = nullptr;
 
     // The segments consist with the next level of target level.
     // This will be useful while deciding whether to partition
@@ -96,6 +101,11 @@ class SstPartitioner {
     // [42, 96], which means range ["001", "002") contains 42 bytes of data,
     // ["002", "004") contains 96 bytes of data.
     std::vector<uint64_t> output_next_level_size;
+    // The smallest key of each of those files. The i-th file covers
+    // [output_next_level_smallest_keys[i], output_next_level_boundaries[i+1]],
+    // so keys between the largest key of a file and the smallest key of the
+    // next one don't overlap the next level at all.
+    std::vector<Slice> output_next_level_smallest_keys;
 
     // Helper function to fetch the count of next level segments.
     size_t OutputNextLevelSegmentCount() const {
@@ -180,4 +190,62 @@ class SstPartitionerFixedPrefixFactory : public SstPartitionerFactory {
 extern std::shared_ptr<SstPartitionerFactory>
 NewSstPartitionerFixedPrefixFactory(size_t prefix_len);
 
+/*
+ * Next level boundary partitioner. It splits the output SST files wherever
+ * the keys cross the smallest or largest key of a file in the level after the
+ * output level, so that every output file either overlaps a single file of
+ * that level or none at all. The former only rewrites that one file when it
+ * is compacted down, and the latter can be trivially moved.
+ *
+ * Output files smaller than `min_file_size` are not split, to avoid creating
+ * many tiny files when the next level's files are much smaller than the
+ * output's.
+ */
+class SstPartitionerNextLevel : public SstPartitioner {
+ public:
+  SstPartitionerNextLevel(const Context& context, uint64_t min_file_size);
+
+  ~SstPartitionerNextLevel() override {}
+
+  const char* Name() const override { return "SstPartitionerNextLevel"; }
+
+  PartitionerResult ShouldPartition(const PartitionerRequest& request) override;
+
+  // Allows moving only the files this partitioner would not split.
+  bool CanDoTrivialMove(const Slice& smallest_user_key,
+                        const Slice& largest_user_key) override;
+
+ private:
+  // Returns 2 * i for keys between the (i-1)-th and i-th next level files,
+  // and 2 * i + 1 for keys within the range of the i-th one.
+  size_t Region(const Slice& user_key) const;
+
+  const Comparator* ucmp_;
+  uint64_t min_file_size_;
+  std::vector<std::string> smallest_keys_;
+  std::vector<std::string> largest_keys_;
+};
+
+/*
+ * Factory for next level boundary partitioner.
+ */
+class SstPartitionerNextLevelFactory : public SstPartitionerFactory {
+ public:
+  explicit SstPartitionerNextLevelFactory(uint64_t min_file_size);
+
+  ~SstPartitionerNextLevelFactory() override {}
+
+  static const char* kClassName() { return "SstPartitionerNextLevelFactory"; }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<SstPartitioner> CreatePartitioner(
+      const SstPartitioner::Context& context) const override;
+
+ private:
+  uint64_t min_file_size_;
+};
+
+extern std::shared_ptr<SstPartitionerFactory> NewSstPartitionerNextLevelFactory(
+    uint64_t min_file_size = 0);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -537,6 +537,42 @@ enum Tickers : uint32_t {
   COMPRESSED_SECONDARY_CACHE_PROMOTIONS,
   COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS,
 
+  // Number of WriteBatch bytes applied to the memtable by a multi-batch
+  // writer on behalf of another writer of its group.
+  MULTI_BATCH_WRITE_STOLEN_BYTES,
+
+  // Bytes of memtable arena shard blocks whose pages were placed on a NUMA
+  // node other than the one of the thread that allocated them. Only
+  // counted when RocksDB is built with NUMA.
+  MEMTABLE_NUMA_REMOTE_BYTES,
+
+  // Number of memtable arena blocks taken from, and not found in, the pool
+  // enabled by DBOptions::memtable_arena_pool_size.
+  MEMTABLE_ARENA_POOL_HIT,
+  MEMTABLE_ARENA_POOL_MISS,
+
+  // Bytes of the files marked as trash, to be deleted in the background
+  // rather than immediately
+  FILES_DELETION_DEFERRED_BYTES,
+  // Number of times the deletion of trash files slowed down as SST file reads
+  // were slow, see SstFileManager::SetDeleteMaxReadLatencyMicros()
+  FILES_DELETION_SLOWED_DOWN,
+
+  // Number of point lookups served, and not served, by the merge result
+  // cache enabled by ColumnFamilyOptions::merge_result_cache_size
+  MERGE_RESULT_CACHE_HIT,
+  MERGE_RESULT_CACHE_MISS,
+
+  // Number of data blocks added to the block cache in the memory of
+  // BlockBasedTableOptions::far_memory_allocator, and number of them copied
+  // to the memory of the block cache's allocator on hits
+  BLOCK_CACHE_FAR_MEMORY_ADD,
+  BLOCK_CACHE_FAR_MEMORY_PROMOTE,
+
+  // Bytes of immutable memtables moved to
+  // DBOptions::immutable_memtable_numa_node
+  MEMTABLE_FAR_MEMORY_BYTES,
+
   TICKER_ENUM_MAX
 };
 
@@ -667,6 +703,23 @@ enum Histograms : uint32_t {
   // system's prefetch) from the end of SST table during block based table open
   TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
 
+  // Time a multi-batch write spends inserting its own batches into the
+  // memtable.
+  MULTI_BATCH_WRITE_MEMTABLE_MICROS,
+  // Time a multi-batch write spends waiting to be committed in sequence
+  // order, including inserting batches of other writers meanwhile.
+  MULTI_BATCH_WRITE_COMMIT_WAIT_MICROS,
+  // Time the WAL group leader of a pipelined write waits to enter the
+  // memtable stage.
+  PIPELINED_WRITE_MEMTABLE_WAIT_MICROS,
+
+  // Time reads of each priority wait in the queues of a file system returned
+  // by NewIOSchedulingFileSystem().
+  IO_SCHEDULER_QUEUE_LOW_MICROS,
+  IO_SCHEDULER_QUEUE_MID_MICROS,
+  IO_SCHEDULER_QUEUE_HIGH_MICROS,
+  IO_SCHEDULER_QUEUE_USER_MICROS,
+
   HISTOGRAM_ENUM_MAX
 };
 
@@ -766,6 +819,16 @@ class Statistics : public Customizable {
   // Resets all ticker and histogram stats
   virtual Status Reset() { return Status::NotSupported("Not implemented"); }
 
+  // Adds the tickers and histograms of `other` to these, e.g. to aggregate
+  // the statistics of many DBs. Histograms are merged bucket by bucket
+  // rather than by their percentiles, so the percentiles of the merged
+  // histograms are as accurate as those of the histogram of one DB. The
+  // merge is not forwarded to a wrapped Statistics. Returns NotSupported
+  // unless both objects are created by CreateDBStatistics().
+  virtual Status Merge(const Statistics& /*other*/) {
+    return Status::NotSupported("Not implemented");
+  }
+
   using Customizable::ToString;
   // String representation of the statistic object. Must be thread-safe.
   virtual std::string ToString() const {
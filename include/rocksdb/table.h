@@ -32,8 +32,10 @@ namespace ROCKSDB_NAMESPACE {
 
 // -- Block-based Table
 class Cache;
+class Compressor;
 class FilterPolicy;
 class FlushBlockPolicyFactory;
+class MemoryAllocator;
 class PersistentCache;
 class RandomAccessFile;
 struct TableReaderOptions;
@@ -106,6 +108,19 @@ struct MetadataCacheOptions {
   // any effect. Otherwise the unpartitioned meta-blocks would be held in table
   // reader memory, outside the block cache.
   PinningTier unpartitioned_pinning = PinningTier::kFallback;
+
+  // If non-zero, the index and filter blocks in the block cache, partitions
+  // or not, that reads access the most are pinned, as long as their total
+  // charge fits in this many bytes, in addition to the blocks pinned by the
+  // tiers above. The accesses are sampled per block of each table file, and
+  // the pinned blocks follow the changes of the workload: a block that gets
+  // colder than the others fitting the budget is unpinned. The budget is
+  // shared by the tables of the table factory. The pinned blocks stay charged
+  // to the block cache, within its capacity.
+  //
+  // Note `cache_index_and_filter_blocks` must be true for this option to have
+  // any effect on the unpartitioned blocks and the top-level indexes.
+  size_t dynamic_pinning_budget = 0;
 };
 
 struct CacheEntryRoleOptions {
@@ -232,6 +247,18 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, but the table also stores a piecewise linear model
+    // of where keys fall in the index block, fitted on the first 8 bytes of
+    // the keys. Index lookups use it to predict the position of the key and
+    // only binary search the few entries around it, falling back to the
+    // whole index block if the prediction turns out to be wrong.
+    // Works best when the first 8 bytes of keys are spread evenly, e.g.
+    // big-endian integer keys. The model is only built with
+    // BytewiseComparator() and without user-defined timestamps, and is
+    // skipped when it would not narrow the search down; the table then uses
+    // plain binary search.
+    kLearnedIndexSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -248,6 +275,32 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, data blocks also store the first 8 bytes of the user key of each
+  // restart point in a packed array after the restart array, costing 8 bytes
+  // per restart point. Seek() then narrows its binary search over the restart
+  // points by comparing integers in that array, without decoding keys, and
+  // only compares full keys against the restart points sharing the target's
+  // prefix. This helps most when the first 8 bytes of keys tell them apart.
+  //
+  // Only applies to tables using BytewiseComparator() without user-defined
+  // timestamps; ignored otherwise. Files written with this option cannot be
+  // read by RocksDB versions without support for it.
+  bool data_block_restart_key_prefixes = false;
+
+  // If true, the buckets of the data block hash index (see
+  // kDataBlockBinaryAndHash) point at the first entry of a user key rather
+  // than at its restart interval, so a point lookup decodes at most the
+  // restart key and the entry instead of scanning the interval. To make an
+  // entry decodable on its own, keys are delta encoded against the key at
+  // their restart point instead of the previous key, which costs some key
+  // compression, and the buckets take two bytes instead of one. It also
+  // lifts the limit of 253 restart intervals per block for the hash index.
+  //
+  // Only applies with kDataBlockBinaryAndHash to tables without user-defined
+  // timestamps; ignored otherwise. Files written with this option cannot be
+  // read by RocksDB versions without support for it.
+  bool data_block_hash_index_entry_offsets = false;
+
   // Option hash_index_allow_collision is now deleted.
   // It will behave as if hash_index_allow_collision=true.
 
@@ -269,6 +322,23 @@ struct BlockBasedTableOptions {
   // IF NULL, no page cache is used
   std::shared_ptr<PersistentCache> persistent_cache = nullptr;
 
+  // If non-NULL, the data blocks of the tables at the last level are
+  // allocated from it rather than from the memory allocator of the block
+  // cache when they are loaded into the block cache. This is meant for an
+  // allocator of a larger but slower memory tier, like CXL-attached memory
+  // or persistent memory (see NewMemkindKmemAllocator()), while the index and
+  // filter blocks and the data blocks of the other levels, which are read
+  // more often, stay in the faster memory. The BlockCacheEntryStatsMapKeys::
+  // FarMemoryBytes() entry stats report how much of the cache lives in it.
+  std::shared_ptr<MemoryAllocator> far_memory_allocator = nullptr;
+
+  // A block cache hit on a data block allocated from far_memory_allocator
+  // copies the block into the memory of the block cache's allocator with a
+  // probability of 1 / far_memory_promotion_hits, so that the blocks hit
+  // repeatedly are promoted to the faster tier after about this many hits.
+  // 0 disables promotion.
+  uint32_t far_memory_promotion_hits = 8;
+
   // Approximate size of user data packed per block.  Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -291,6 +361,16 @@ struct BlockBasedTableOptions {
   // Same as block_restart_interval but used for the index block.
   int index_block_restart_interval = 1;
 
+  // If positive, overrides index_block_restart_interval for the partitions of
+  // a kTwoLevelIndexSearch index, leaving the top-level index at
+  // index_block_restart_interval. Partitions are cached as written, so a
+  // larger interval shares more key prefixes and, with format_version >= 4,
+  // delta encodes more block handles, letting the block cache hold more of
+  // the index. Seeks still binary search the restart points and only decode
+  // the one restart interval holding the target, at the cost of scanning up
+  // to this many entries in it.
+  int index_partition_restart_interval = 0;
+
   // Block size for partitioned metadata. Currently applied to indexes when
   // kTwoLevelIndexSearch is used and to filters when partition_filters is used.
   // Note: Since in the current implementation the filters and index partitions
@@ -444,6 +524,12 @@ struct BlockBasedTableOptions {
   // NewBloomFilterPolicy() here.
   std::shared_ptr<const FilterPolicy> filter_policy = nullptr;
 
+  // EXPERIMENTAL
+  // If non-nullptr, compresses the blocks of its compression type in place of
+  // the built-in library, for example on a hardware accelerator. See
+  // Compressor in rocksdb/compressor.h.
+  std::shared_ptr<Compressor> compressor = nullptr;
+
   // If true, place whole keys in the filter (not just prefixes).
   // This must generally be true for gets to be efficient.
   bool whole_key_filtering = true;
@@ -661,6 +747,26 @@ struct BlockBasedTableOptions {
   //
   // Default: 2
   uint64_t num_file_reads_for_auto_readahead = 2;
+
+  // If true, the implicit auto readahead of iterators is sized from the
+  // lengths of the sequential scans of data blocks by recent iterators on the
+  // files of this table factory (usually those of a column family). A scan
+  // expected to read more than its first data block then reads ahead from
+  // that block on, in one read of about the length of most recent scans,
+  // instead of waiting for num_file_reads_for_auto_readahead reads and
+  // ramping up from initial_auto_readahead_size. Suits workloads of many
+  // short iterators with similar scan lengths. The readahead is capped at
+  // max_auto_readahead_size, and not done with ReadOptions::async_io.
+  //
+  // This parameter can be changed dynamically by
+  // DB::SetOptions({{"block_based_table_factory",
+  //                  "{learn_auto_readahead_size=true;}"}}));
+  //
+  // Changing the value dynamically will only affect files opened after the
+  // change.
+  //
+  // Default: false
+  bool learn_auto_readahead_size = false;
 };
 
 // Table Properties that are specific to block-based table properties.
@@ -796,6 +902,10 @@ struct CuckooTablePropertyNames {
   static const std::string kUseModuleHash;
   // Fixed user key length
   static const std::string kUserKeyLength;
+  // Number of older versions of user keys, kept in internal key order in an
+  // overflow area right after the hash table. The hash table itself holds the
+  // newest version of each user key. Absent if there are none.
+  static const std::string kNumOverflowEntries;
 };
 
 struct CuckooTableOptions {
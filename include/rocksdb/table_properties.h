@@ -120,6 +120,17 @@ class TablePropertiesCollector {
     return;
   }
 
+  // EXPERIMENTAL Called when a data block is cut, after AddUserKey() was
+  // called for each of its keys. A collector may summarize those keys in
+  // `block_property`, e.g. with the minimum and maximum of some field of their
+  // values, so that ReadOptions::block_property_filter can skip the block in
+  // scans. Only non-empty properties are stored, and only by block-based
+  // tables.
+  virtual void FinishDataBlock(std::string* /* block_property */) {
+    // Nothing to do here. Callback registers can override.
+    return;
+  }
+
   // Finish() will be called when a table has already been built and is ready
   // for writing the properties block.
   // It will be called only once by RocksDB internal.
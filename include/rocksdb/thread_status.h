@@ -167,6 +167,14 @@ struct ThreadStatus {
   // The state (lower-level action) that the current thread is involved.
   const StateType state_type;
 
+  // The CPU and wall time in microseconds that the thread spent in each
+  // operation stage, other than STAGE_UNKNOWN, since it was registered, up
+  // to its last change of stage. Tells e.g. whether the compactions of the
+  // thread were bound by CPU or by I/O. Only recorded for threads with
+  // thread tracking enabled, see DBOptions::enable_thread_tracking.
+  uint64_t stage_cpu_micros[NUM_OP_STAGES] = {};
+  uint64_t stage_elapsed_micros[NUM_OP_STAGES] = {};
+
   // The followings are a set of utility functions for interpreting
   // the information of ThreadStatus
 
@@ -81,6 +81,22 @@ class CompactionOptionsUniversal {
   // Default: false
   bool incremental;
 
+  // EXPERIMENTAL
+  // Only used when incremental is true. When reducing space amplification,
+  // incremental compaction picks the key range of the second last sorted run
+  // with the lowest fanout into the last one. If every range has a fanout
+  // close to that of compacting all the sorted runs, or if no range can be
+  // picked at all, it falls back to compacting all of them when this option
+  // is true. Such a compaction needs as much temporary space as the whole
+  // column family and can run for hours on large ones. If false, it compacts
+  // the range with the lowest fanout regardless, and tries again later if
+  // none can be picked, so that each compaction stays around
+  // max_compaction_bytes at the cost of some extra write amplification. All
+  // the sorted runs are still compacted when the second last one is in L0,
+  // since L0 files can't be split into key ranges.
+  // Default: true
+  bool incremental_fallback_to_full_compaction;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
@@ -90,7 +106,8 @@ class CompactionOptionsUniversal {
         compression_size_percent(-1),
         stop_style(kCompactionStopStyleTotalSize),
         allow_trivial_move(false),
-        incremental(false) {}
+        incremental(false),
+        incremental_fallback_to_full_compaction(true) {}
 };
 
 }  // namespace ROCKSDB_NAMESPACE
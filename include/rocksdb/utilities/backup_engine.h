@@ -122,6 +122,15 @@ struct BackupEngineOptions {
   // Default: 1
   int max_background_operations;
 
+  // Up to this many threads read each file copied by CreateNewBackup() and
+  // RestoreDBFromBackup(), a chunk each at a time, while the chunks are
+  // written in order. This helps copying large files from file systems with
+  // high read latency, where one read at a time per file leaves most of the
+  // bandwidth unused. The readers are in addition to the threads of
+  // max_background_operations, and each holds a copy buffer.
+  // Default: 1
+  int max_readers_per_file = 1;
+
   // During backup user can get callback every time next
   // callback_trigger_interval_size bytes being copied.
   // Default: 4194304
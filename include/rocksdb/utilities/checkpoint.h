@@ -40,12 +40,17 @@ class Checkpoint {
   // sequence_number_ptr: if it is not nullptr, the value it points to will be
   // set to a sequence number guaranteed to be part of the DB, not necessarily
   // the latest. The default value of this parameter is nullptr.
+  // max_threads: up to this many threads link or copy the files into the
+  // checkpoint. File deletions stay disabled until all are done, so more
+  // threads shorten that for DBs of many files or on file systems with high
+  // latency. The default value of this parameter is 1.
   // NOTE: db_paths and cf_paths are not supported for creating checkpoints
   // and NotSupported will be returned when the DB (without WALs) uses more
   // than one directory.
   virtual Status CreateCheckpoint(const std::string& checkpoint_dir,
                                   uint64_t log_size_for_flush = 0,
-                                  uint64_t* sequence_number_ptr = nullptr);
+                                  uint64_t* sequence_number_ptr = nullptr,
+                                  int max_threads = 1);
 
   // Exports all live SST files of a specified Column Family onto export_dir,
   // returning SST files information in metadata.
@@ -27,6 +27,7 @@ namespace ROCKSDB_NAMESPACE {
 // (int32_t)Timestamp(creation) is suffixed to values in Put internally
 // Expired TTL values deleted in compaction only:(Timestamp+ttl<time_now)
 // Get/Iterator may return expired entries(compaction not run on them yet)
+// DeleteExpiredFiles() drops whole expired files without compacting them
 // Different TTL may be used during different Opens
 // Example: Open1 at t=0 with ttl=4 and insert k1,k2, close at t=2
 //          Open2 at t=3 with ttl=5. Now k1,k2 should be deleted at t>=5
@@ -63,6 +64,15 @@ class DBWithTTL : public StackableDB {
 
   virtual void SetTtl(ColumnFamilyHandle* h, int32_t ttl) = 0;
 
+  // Deletes the files of the last non-empty level of the column family whose
+  // values have all expired, by the newest timestamp recorded in their table
+  // properties, like DB::DeleteFile() and without reading them. In level 0,
+  // only the oldest files are deleted. A file with an entry that is neither
+  // a value nor a deletion, such as a blob reference, is never deleted by
+  // this. Files being compacted are skipped. Snapshots do not prevent the
+  // deletion, like they do not keep expired values from compactions.
+  virtual Status DeleteExpiredFiles(ColumnFamilyHandle* column_family) = 0;
+
  protected:
   explicit DBWithTTL(DB* db) : StackableDB(db) {}
 };
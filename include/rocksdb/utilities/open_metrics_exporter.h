@@ -0,0 +1,63 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/db.h"
+#include "rocksdb/statistics.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct OpenMetricsExporterOptions {
+  // The Statistics whose tickers and histograms are exported. If nullptr,
+  // those of the DB options are exported, if any.
+  std::shared_ptr<Statistics> statistics;
+
+  // The column families whose integer DB properties are exported. If empty,
+  // those of the default column family are exported. The handles must
+  // outlive the exporter.
+  std::vector<ColumnFamilyHandle*> column_families;
+
+  // By default, only the integer DB properties that are read without the DB
+  // mutex are exported, so that an export does not wait for or delay the
+  // background jobs. If true, all integer DB properties are exported.
+  bool include_db_mutex_properties = false;
+};
+
+// Exports the metrics of a DB in the OpenMetrics text format, e.g. to be
+// scraped by Prometheus: the tickers of its Statistics as counters, its
+// histograms as summaries with quantiles 0.5, 0.95, 0.99 and 1, and its
+// integer DB properties as gauges with a "cf" label. The metric names are
+// the names of the tickers, histograms and properties with the characters
+// not allowed in OpenMetrics replaced with '_', e.g.
+// "rocksdb_block_cache_miss_total" for "rocksdb.block.cache.miss".
+//
+// The descriptors of the metrics are built when the exporter is created, so
+// an export does not allocate memory once the output buffer has grown to the
+// size of the metrics, unlike Statistics::getTickerMap() and
+// DB::GetMapProperty(). Export() is thread-safe.
+class OpenMetricsExporter {
+ public:
+  // `db` must outlive the exporter
+  OpenMetricsExporter(DB* db, const OpenMetricsExporterOptions& options);
+  ~OpenMetricsExporter();
+
+  OpenMetricsExporter(const OpenMetricsExporter&) = delete;
+  OpenMetricsExporter& operator=(const OpenMetricsExporter&) = delete;
+
+  // Replaces the contents of `*out` with the metrics, ending with the
+  // "# EOF" line. Reuse `out` across exports to avoid allocations.
+  void Export(std::string* out) const;
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
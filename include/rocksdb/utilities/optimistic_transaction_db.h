@@ -80,6 +80,19 @@ struct OptimisticTransactionDBOptions {
   // an OccLockBuckets will be created using the count in occ_lock_buckets.
   // See MakeSharedOccLockBuckets()
   std::shared_ptr<OccLockBuckets> shared_lock_buckets;
+
+  // If nonzero, transactions are validated against a table of this many
+  // buckets, each holding the sequence number of the last commit to the keys
+  // hashing to it, rather than against the memtables. Validation then costs
+  // O(1) per key and needs no memtable history, so old memtables are not
+  // kept in memory for it (max_write_buffer_size_to_maintain) and
+  // validation never fails with TryAgain. Keys sharing a bucket can cause
+  // spurious conflicts, so more buckets make fewer of them at the cost of
+  // 16 bytes per bucket.
+  // Only the writes made through the OptimisticTransactionDB, by
+  // transactions or not, are seen: writes through GetBaseDB() or with user
+  // timestamps do not conflict with transactions.
+  uint32_t commit_seq_buckets = 0;
 };
 
 // Range deletions (including those in `WriteBatch`es passed to `Write()`) are
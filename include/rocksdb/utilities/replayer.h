@@ -18,7 +18,9 @@ class TraceRecordResult;
 
 struct ReplayOptions {
   // Number of threads used for replaying. If 0 or 1, replay using
-  // single thread.
+  // single thread. With more threads, the traces are decoded ahead of their
+  // time and spread over the threads by key, so the traces of a key (the
+  // first key of a write batch or MultiGet) are executed in trace order.
   uint32_t num_threads;
 
   // Enables fast forwarding a replay by increasing/reducing the delay between
@@ -34,6 +36,15 @@ struct ReplayOptions {
       : num_threads(num_of_threads), fast_forward(fast_forward_ratio) {}
 };
 
+// How late Replay() started executing the traces, against the times the
+// trace stream and the fast forward scheduled them at
+struct ReplayTimingStats {
+  uint64_t num_traces = 0;
+  double average_lag_micros = 0;
+  double p99_lag_micros = 0;
+  uint64_t max_lag_micros = 0;
+};
+
 // Replayer helps to replay the captured RocksDB query level operations.
 // The Replayer can either be created from DB::NewReplayer method, or be
 // instantiated via db_bench today, on using "replay" benchmark.
@@ -76,10 +87,19 @@ class Replayer {
   //
   // result_callback reports the status of executing a trace record, and the
   // actual operation execution result (See the description for Execute()).
+  //
+  // The replay stops at the first trace that fails, other than with
+  // Status::NotSupported(), and returns its status. With several threads,
+  // that is the failed trace with the earliest timestamp.
   virtual Status Replay(
       const ReplayOptions& options,
       const std::function<void(Status, std::unique_ptr<TraceRecordResult>&&)>&
           result_callback) = 0;
+
+  // Return the timing of the traces executed by the last Replay().
+  virtual Status GetTimingStats(ReplayTimingStats* /*stats*/) const {
+    return Status::NotSupported("GetTimingStats() is not implemented.");
+  }
 };
 
 }  // namespace ROCKSDB_NAMESPACE
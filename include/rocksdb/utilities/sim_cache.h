@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <memory>
 #include <string>
 
@@ -20,6 +21,17 @@ namespace ROCKSDB_NAMESPACE {
 
 class SimCache;
 
+// Options for SimCache::StartMissRatioCurve()
+struct MissRatioCurveOptions {
+  // The share of the keys whose lookups are sampled, by the hash of the key.
+  // It is lowered as needed to sample no more than max_sampled_keys.
+  double sampling_rate = 0.01;
+
+  // The maximum number of keys sampled, which bounds the memory used by the
+  // estimate to about 100 bytes per key, whatever the size of the cache.
+  size_t max_sampled_keys = 8192;
+};
+
 // For instrumentation purpose, use NewSimCache instead of NewLRUCache API
 // NewSimCache is a wrapper function returning a SimCache instance that can
 // have additional interface provided in Simcache class besides Cache interface
@@ -47,6 +59,8 @@ class SimCache : public CacheWrapper {
  public:
   using CacheWrapper::CacheWrapper;
 
+  static const char* kClassName() { return "SimCache"; }
+
   // returns the maximum configured capacity of the simcache for simulation
   virtual size_t GetSimCapacity() const = 0;
 
@@ -85,6 +99,22 @@ class SimCache : public CacheWrapper {
   // Status of cache logging happening in background
   virtual Status GetActivityLoggingStatus() = 0;
 
+  // Start estimating the miss ratio of the lookups for any capacity of the
+  // cache, from a sample of the keys looked up (SHARDS), without simulating
+  // a cache of each capacity. Restarts the estimate if already started.
+  virtual Status StartMissRatioCurve(const MissRatioCurveOptions& options) = 0;
+
+  // Stop sampling the lookups, keeping the estimate so far
+  virtual void StopMissRatioCurve() = 0;
+
+  // Returns the estimated miss ratio, between 0 and 1, of an LRU cache of
+  // each capacity in bytes where it changes, for the lookups since
+  // StartMissRatioCurve(). The miss ratio of a capacity between two is that
+  // of the smaller one. Empty if no lookup was sampled. Also available as
+  // DB::Properties::kBlockCacheMissRatioCurve of a DB using the SimCache as
+  // block cache.
+  virtual std::map<uint64_t, double> GetMissRatioCurve() const = 0;
+
  private:
   SimCache(const SimCache&);
   SimCache& operator=(const SimCache&);
@@ -140,6 +140,16 @@ class StackableDB : public DB {
                          statuses, sorted_input);
   }
 
+  void MultiGetStreaming(const ReadOptions& options,
+                         ColumnFamilyHandle* column_family,
+                         const size_t num_keys, const Slice* keys,
+                         PinnableSlice* values, Status* statuses,
+                         const std::function<void(size_t)>& on_key_done,
+                         const bool sorted_input = false) override {
+    db_->MultiGetStreaming(options, column_family, num_keys, keys, values,
+                           statuses, on_key_done, sorted_input);
+  }
+
   using DB::MultiGetEntity;
 
   void MultiGetEntity(const ReadOptions& options,
@@ -217,6 +227,13 @@ class StackableDB : public DB {
     return db_->KeyMayExist(options, column_family, key, value, value_found);
   }
 
+  Status MultiKeyMayExist(const ReadOptions& options,
+                          ColumnFamilyHandle* column_family, size_t num_keys,
+                          const Slice* keys, bool* may_exist) override {
+    return db_->MultiKeyMayExist(options, column_family, num_keys, keys,
+                                 may_exist);
+  }
+
   using DB::Delete;
   virtual Status Delete(const WriteOptions& wopts,
                         ColumnFamilyHandle* column_family,
@@ -343,6 +360,11 @@ class StackableDB : public DB {
                              compaction_job_info);
   }
 
+  Status GarbageCollectBlobFiles(const GarbageCollectBlobFilesOptions& options,
+                                 ColumnFamilyHandle* column_family) override {
+    return db_->GarbageCollectBlobFiles(options, column_family);
+  }
+
   virtual Status PauseBackgroundWork() override {
     return db_->PauseBackgroundWork();
   }
@@ -476,6 +498,12 @@ class StackableDB : public DB {
   using DB::EndIOTrace;
   Status EndIOTrace() override { return db_->EndIOTrace(); }
 
+  using DB::DumpIOTrace;
+  Status DumpIOTrace(uint64_t last_micros,
+                     std::unique_ptr<TraceWriter>&& trace_writer) override {
+    return db_->DumpIOTrace(last_micros, std::move(trace_writer));
+  }
+
   using DB::StartTrace;
   Status StartTrace(const TraceOptions& options,
                     std::unique_ptr<TraceWriter>&& trace_writer) override {
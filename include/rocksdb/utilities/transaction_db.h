@@ -146,6 +146,15 @@ class RangeLockManagerHandle : public LockManagerHandle {
 RangeLockManagerHandle* NewRangeLockManager(
     std::shared_ptr<TransactionDBMutexFactory> mutex_factory);
 
+// Like NewRangeLockManager(), but the lock manager keeps the locks of each
+// column family in an ordered map of disjoint ranges rather than in PerconaFT's
+// locktree, which scales better when the transactions lock disjoint ranges.
+// Locks are never escalated: once the max lock memory is reached (if set with
+// SetMaxLockMemory(), it is unlimited by default), lock requests fail with
+// Status::Busy.
+RangeLockManagerHandle* NewRangeMapLockManager(
+    std::shared_ptr<TransactionDBMutexFactory> mutex_factory);
+
 struct TransactionDBOptions {
   // Specifies the maximum number of keys that can be locked at the same time
   // per column family.
@@ -157,6 +166,16 @@ struct TransactionDBOptions {
   // Stores the number of latest deadlocks to track
   uint32_t max_num_deadlocks = kInitialMaxDeadlocks;
 
+  // If positive, the transactions with TransactionOptions::deadlock_detect
+  // no longer look for a deadlock each time they wait for a lock, which
+  // serializes the waits. A background thread instead looks for cycles in a
+  // copy of the wait-for graph every deadlock_detect_interval_us
+  // microseconds, and fails the lock request of the transaction of each cycle
+  // with the fewest locked keys with Status::Busy(kDeadlock). The whole graph
+  // is searched, whatever the deadlock_detect_depth.
+  // Only supported by the point lock manager.
+  uint64_t deadlock_detect_interval_us = 0;
+
   // Increasing this value will increase the concurrency by dividing the lock
   // table (per column family) into more sub-tables, each with their own
   // separate mutex.
@@ -221,6 +240,20 @@ struct TransactionDBOptions {
   // pending writes into the database. A value of 0 or less means no limit.
   int64_t default_write_batch_flush_threshold = 0;
 
+  // If positive, the memory used by the write batches of the pessimistic
+  // transactions, with their indexes, and by the locks they track is limited
+  // to this many bytes in total. Past it, the writes and GetForUpdate() of the
+  // transactions fail with Status::MemoryLimit() until others commit or roll
+  // back.
+  size_t max_txn_memory = 0;
+
+  // If set, the memory of the transactions, as above, is charged to this
+  // cache, for example the block cache that the WriteBufferManager charges
+  // memtables to, so that they all share one budget. When the cache has
+  // strict_capacity_limit and cannot make room for the charge, the write
+  // fails with Status::MemoryLimit() too.
+  std::shared_ptr<Cache> txn_memory_cache;
+
   // This option is valid only for write-prepared/write-unprepared. Transaction
   // will rely on this callback to determine if a key should be rolled back
   // with Delete or SingleDelete when necessary. If the callback returns true,
@@ -94,10 +94,17 @@ class WriteBatchWithIndex : public WriteBatchBase {
   // overwrite_key: if true, overwrite the key in the index when inserting
   //                the same key as previously, so iterator will never
   //                show two entries with the same key.
+  // defer_index: if true, the writes are only indexed on the next read of
+  //              the index (an iterator, a Get or a MultiGet), all at once
+  //              after sorting them, which is cheaper than indexing them one
+  //              by one when many writes come before the first read. An
+  //              iterator only sees the writes made after its creation once
+  //              another read indexes them.
   explicit WriteBatchWithIndex(
       const Comparator* backup_index_comparator = BytewiseComparator(),
       size_t reserved_bytes = 0, bool overwrite_key = false,
-      size_t max_bytes = 0, size_t protection_bytes_per_key = 0);
+      size_t max_bytes = 0, size_t protection_bytes_per_key = 0,
+      bool defer_index = false);
 
   ~WriteBatchWithIndex() override;
   WriteBatchWithIndex(WriteBatchWithIndex&&);
@@ -292,11 +299,15 @@ class WriteBatchWithIndex : public WriteBatchBase {
   void SetMaxBytes(size_t max_bytes) override;
   size_t GetDataSize() const;
 
+  // Approximate memory used by the write batch together with its index
+  size_t ApproximateMemoryUsage() const;
+
  private:
   friend class PessimisticTransactionDB;
   friend class WritePreparedTxn;
   friend class WriteUnpreparedTxn;
   friend class WriteBatchWithIndex_SubBatchCnt_Test;
+  friend class WriteBatchWithIndexTest_DeferIndex_Test;
   friend class WriteBatchWithIndexInternal;
   // Returns the number of sub-batches inside the write batch. A sub-batch
   // starts right before inserting a key that is a duplicate of a key in the
@@ -118,6 +118,12 @@ class PinnableWideColumns {
   Status SetWideColumnValue(PinnableSlice&& value);
   Status SetWideColumnValue(std::string&& value);
 
+  // Only index the columns named in `projection` when setting a wide-column
+  // value (see ReadOptions::wide_column_projection). Cleared by Reset().
+  void SetProjection(const std::vector<Slice>* projection) {
+    projection_ = projection;
+  }
+
   void Reset();
 
  private:
@@ -131,6 +137,7 @@ class PinnableWideColumns {
 
   PinnableSlice value_;
   WideColumns columns_;
+  const std::vector<Slice>* projection_ = nullptr;
 };
 
 inline void PinnableWideColumns::CopyValue(const Slice& value) {
@@ -208,6 +215,7 @@ inline Status PinnableWideColumns::SetWideColumnValue(std::string&& value) {
 inline void PinnableWideColumns::Reset() {
   value_.Reset();
   columns_.clear();
+  projection_ = nullptr;
 }
 
 inline bool operator==(const PinnableWideColumns& lhs,
@@ -15,7 +15,9 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <list>
+#include <memory>
 #include <mutex>
 
 #include "rocksdb/cache.h"
@@ -36,6 +38,48 @@ class StallInterface {
   virtual void Signal() = 0;
 };
 
+// What WriteBufferManager knows about a column family when it picks one to
+// flush.
+struct WriteBufferFlushCandidate {
+  DB* db = nullptr;
+  ColumnFamilyHandle* cf = nullptr;
+  // Approximate size of the mutable memtable.
+  uint64_t memtable_bytes = 0;
+  // Seconds since the oldest key of the mutable memtable was written, 0 if
+  // not known.
+  uint64_t memtable_age_seconds = 0;
+  // WAL bytes that the flush would allow to be deleted.
+  uint64_t wal_bytes_pinned = 0;
+  uint64_t num_level0_files = 0;
+  int level0_file_num_compaction_trigger = 0;
+};
+
+// Decides which column family a shared WriteBufferManager flushes when the
+// mutable memtables exceed its flush_size. Implementations must be
+// thread-safe.
+class WriteBufferFlushPolicy {
+ public:
+  virtual ~WriteBufferFlushPolicy() {}
+
+  virtual const char* Name() const = 0;
+
+  // Returns how much flushing `candidate` is worth. The candidate with the
+  // highest score is flushed first. Called without holding any DB mutex.
+  virtual double Score(const WriteBufferFlushCandidate& candidate) const = 0;
+};
+
+// Returns a policy that weighs the memory and WAL space a flush frees
+// against the L0 compaction work it adds:
+//   (memtable_bytes + wal_weight * wal_bytes_pinned)
+//     * (1 + min(memtable_age_seconds / age_horizon_seconds, 1))
+//     / (1 + num_level0_files / level0_file_num_compaction_trigger)
+// so that a large memtable still wins, but an old one pinning many WALs is
+// preferred over one of similar size, and column families already behind on
+// L0 compaction are flushed last.
+extern std::shared_ptr<WriteBufferFlushPolicy>
+NewCostAwareWriteBufferFlushPolicy(double wal_weight = 0.25,
+                                   uint64_t age_horizon_seconds = 600);
+
 class WriteBufferManager final {
  public:
   // Parameters:
@@ -101,6 +145,15 @@ class WriteBufferManager final {
     flush_oldest_first_.store(v, std::memory_order_relaxed);
   }
 
+  // Replaces how the column family to flush is picked. When not set, or set
+  // to nullptr, the largest (or oldest, see `flush_oldest_first`) mutable
+  // memtable is flushed, with a penalty for column families with too many L0
+  // files.
+  void SetFlushPolicy(std::shared_ptr<WriteBufferFlushPolicy> policy) {
+    std::lock_guard<std::mutex> lock(sentinels_mu_);
+    flush_policy_ = std::move(policy);
+  }
+
   // Below functions should be called by RocksDB internally.
 
   // This handle is the same as the one created by `DB::Open` or
@@ -188,6 +241,8 @@ class WriteBufferManager final {
   // Protected by `sentinels_mu_`.
   std::list<std::shared_ptr<WriteBufferSentinel>> sentinels_;
   std::mutex sentinels_mu_;
+  // Protected by `sentinels_mu_`.
+  std::shared_ptr<WriteBufferFlushPolicy> flush_policy_;
 
   // Shared by flush_size limit and cache charging.
   // When cache charging is enabled, this is updated under cache_res_mgr_mu_.
@@ -214,5 +269,9 @@ class WriteBufferManager final {
 
   void ReserveMemWithCache(size_t mem);
   void FreeMemWithCache(size_t mem);
+
+  WriteBufferFlushCandidate MakeFlushCandidate(WriteBufferSentinel* s,
+                                               uint64_t memory_bytes,
+                                               uint64_t oldest_key_time);
 };
 }  // namespace ROCKSDB_NAMESPACE
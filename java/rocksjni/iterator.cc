@@ -338,3 +338,59 @@ jint Java_org_rocksdb_RocksIterator_valueByteArray0(
 
   return static_cast<jsize>(value_slice.size());
 }
+
+/*
+ * Copies entries into the direct buffer as length-prefixed keys and values,
+ * moving the iterator past them. Returns the number of entries in the upper
+ * 32 bits and the number of bytes written in the lower 32 bits.
+ *
+ * Class:     org_rocksdb_RocksIterator
+ * Method:    nextBatchDirect0
+ * Signature: (JLjava/nio/ByteBuffer;III)J
+ */
+jlong Java_org_rocksdb_RocksIterator_nextBatchDirect0(
+    JNIEnv* env, jobject /*jobj*/, jlong handle, jobject jtarget,
+    jint jtarget_off, jint jtarget_len, jint jmax_entries) {
+  auto* it = reinterpret_cast<ROCKSDB_NAMESPACE::Iterator*>(handle);
+  char* target = reinterpret_cast<char*>(env->GetDirectBufferAddress(jtarget));
+  if (target == nullptr ||
+      env->GetDirectBufferCapacity(jtarget) < (jtarget_off + jtarget_len)) {
+    ROCKSDB_NAMESPACE::RocksDBExceptionJni::ThrowNew(
+        env, "Invalid target argument");
+    return 0;
+  }
+  target += jtarget_off;
+
+  auto put_length = [](char* dst, size_t length) {
+    dst[0] = static_cast<char>(length >> 24);
+    dst[1] = static_cast<char>(length >> 16);
+    dst[2] = static_cast<char>(length >> 8);
+    dst[3] = static_cast<char>(length);
+  };
+
+  const size_t capacity = static_cast<size_t>(jtarget_len);
+  size_t used = 0;
+  jint num_entries = 0;
+  for (; num_entries < jmax_entries && it->Valid(); ++num_entries) {
+    const ROCKSDB_NAMESPACE::Slice key = it->key();
+    const ROCKSDB_NAMESPACE::Slice value = it->value();
+    const size_t entry_size = 2 * sizeof(jint) + key.size() + value.size();
+    if (entry_size > capacity - used) {
+      break;
+    }
+
+    char* dst = target + used;
+    put_length(dst, key.size());
+    dst += sizeof(jint);
+    memcpy(dst, key.data(), key.size());
+    dst += key.size();
+    put_length(dst, value.size());
+    dst += sizeof(jint);
+    memcpy(dst, value.data(), value.size());
+    used += entry_size;
+
+    it->Next();
+  }
+
+  return (static_cast<jlong>(num_entries) << 32) | static_cast<jlong>(used);
+}
@@ -4703,6 +4703,8 @@ class CompactionPriorityJni {
         return 0x3;
       case ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin:
         return 0x4;
+      case ROCKSDB_NAMESPACE::CompactionPri::kByTombstoneDensity:
+        return 0x5;
       default:
         return 0x0;  // undefined
     }
@@ -4723,6 +4725,8 @@ class CompactionPriorityJni {
         return ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio;
       case 0x4:
         return ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin;
+      case 0x5:
+        return ROCKSDB_NAMESPACE::CompactionPri::kByTombstoneDensity;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionPri::kByCompensatedSize;
@@ -5184,6 +5188,28 @@ class TickerTypeJni {
       case ROCKSDB_NAMESPACE::Tickers::
           COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS:
         return -0x46;
+      case ROCKSDB_NAMESPACE::Tickers::MULTI_BATCH_WRITE_STOLEN_BYTES:
+        return -0x47;
+      case ROCKSDB_NAMESPACE::Tickers::MEMTABLE_NUMA_REMOTE_BYTES:
+        return -0x48;
+      case ROCKSDB_NAMESPACE::Tickers::MEMTABLE_ARENA_POOL_HIT:
+        return -0x49;
+      case ROCKSDB_NAMESPACE::Tickers::MEMTABLE_ARENA_POOL_MISS:
+        return -0x4A;
+      case ROCKSDB_NAMESPACE::Tickers::FILES_DELETION_DEFERRED_BYTES:
+        return -0x4B;
+      case ROCKSDB_NAMESPACE::Tickers::FILES_DELETION_SLOWED_DOWN:
+        return -0x4C;
+      case ROCKSDB_NAMESPACE::Tickers::MERGE_RESULT_CACHE_HIT:
+        return -0x4D;
+      case ROCKSDB_NAMESPACE::Tickers::MERGE_RESULT_CACHE_MISS:
+        return -0x4E;
+      case ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_FAR_MEMORY_ADD:
+        return -0x4F;
+      case ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_FAR_MEMORY_PROMOTE:
+        return -0x50;
+      case ROCKSDB_NAMESPACE::Tickers::MEMTABLE_FAR_MEMORY_BYTES:
+        return -0x51;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -5570,6 +5596,28 @@ class TickerTypeJni {
       case -0x46:
         return ROCKSDB_NAMESPACE::Tickers::
             COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS;
+      case -0x47:
+        return ROCKSDB_NAMESPACE::Tickers::MULTI_BATCH_WRITE_STOLEN_BYTES;
+      case -0x48:
+        return ROCKSDB_NAMESPACE::Tickers::MEMTABLE_NUMA_REMOTE_BYTES;
+      case -0x49:
+        return ROCKSDB_NAMESPACE::Tickers::MEMTABLE_ARENA_POOL_HIT;
+      case -0x4A:
+        return ROCKSDB_NAMESPACE::Tickers::MEMTABLE_ARENA_POOL_MISS;
+      case -0x4B:
+        return ROCKSDB_NAMESPACE::Tickers::FILES_DELETION_DEFERRED_BYTES;
+      case -0x4C:
+        return ROCKSDB_NAMESPACE::Tickers::FILES_DELETION_SLOWED_DOWN;
+      case -0x4D:
+        return ROCKSDB_NAMESPACE::Tickers::MERGE_RESULT_CACHE_HIT;
+      case -0x4E:
+        return ROCKSDB_NAMESPACE::Tickers::MERGE_RESULT_CACHE_MISS;
+      case -0x4F:
+        return ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_FAR_MEMORY_ADD;
+      case -0x50:
+        return ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_FAR_MEMORY_PROMOTE;
+      case -0x51:
+        return ROCKSDB_NAMESPACE::Tickers::MEMTABLE_FAR_MEMORY_BYTES;
       case 0x5F:
         // 0x5F was the max value in the initial copy of tickers to Java.
         // Since these values are exposed directly to Java clients, we keep
@@ -5716,6 +5764,20 @@ class HistogramTypeJni {
       case ROCKSDB_NAMESPACE::Histograms::
           FILE_READ_VERIFY_FILE_CHECKSUMS_MICROS:
         return 0x41;
+      case ROCKSDB_NAMESPACE::Histograms::MULTI_BATCH_WRITE_MEMTABLE_MICROS:
+        return 0x42;
+      case ROCKSDB_NAMESPACE::Histograms::MULTI_BATCH_WRITE_COMMIT_WAIT_MICROS:
+        return 0x43;
+      case ROCKSDB_NAMESPACE::Histograms::PIPELINED_WRITE_MEMTABLE_WAIT_MICROS:
+        return 0x44;
+      case ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_LOW_MICROS:
+        return 0x45;
+      case ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_MID_MICROS:
+        return 0x46;
+      case ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_HIGH_MICROS:
+        return 0x47;
+      case ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_USER_MICROS:
+        return 0x48;
       case ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX:
         // 0x1F for backwards compatibility on current minor version.
         return 0x1F;
@@ -5853,6 +5915,22 @@ class HistogramTypeJni {
       case 0x41:
         return ROCKSDB_NAMESPACE::Histograms::
             FILE_READ_VERIFY_FILE_CHECKSUMS_MICROS;
+      case 0x42:
+        return ROCKSDB_NAMESPACE::Histograms::MULTI_BATCH_WRITE_MEMTABLE_MICROS;
+      case 0x43:
+        return ROCKSDB_NAMESPACE::Histograms::
+            MULTI_BATCH_WRITE_COMMIT_WAIT_MICROS;
+      case 0x44:
+        return ROCKSDB_NAMESPACE::Histograms::
+            PIPELINED_WRITE_MEMTABLE_WAIT_MICROS;
+      case 0x45:
+        return ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_LOW_MICROS;
+      case 0x46:
+        return ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_MID_MICROS;
+      case 0x47:
+        return ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_HIGH_MICROS;
+      case 0x48:
+        return ROCKSDB_NAMESPACE::Histograms::IO_SCHEDULER_QUEUE_USER_MICROS;
       case 0x1F:
         // 0x1F for backwards compatibility on current minor version.
         return ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX;
@@ -6684,6 +6762,9 @@ class IndexTypeJni {
       case ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
           kBinarySearchWithFirstKey:
         return 0x3;
+      case ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
+          kLearnedIndexSearch:
+        return 0x4;
       default:
         return 0x7F;  // undefined
     }
@@ -6706,6 +6787,9 @@ class IndexTypeJni {
       case 0x3:
         return ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
             kBinarySearchWithFirstKey;
+      case 0x4:
+        return ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
+            kLearnedIndexSearch;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
@@ -7281,6 +7365,8 @@ class CompactionReasonJni {
         return 0x12;
       case ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel:
         return 0x13;
+      case ROCKSDB_NAMESPACE::CompactionReason::kRangeDeletionCoveredFiles:
+        return 0x14;
       default:
         return 0x7F;  // undefined
     }
@@ -7331,6 +7417,8 @@ class CompactionReasonJni {
         return ROCKSDB_NAMESPACE::CompactionReason::kRoundRobinTtl;
       case 0x13:
         return ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel;
+      case 0x14:
+        return ROCKSDB_NAMESPACE::CompactionReason::kRangeDeletionCoveredFiles;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionReason::kUnknown;
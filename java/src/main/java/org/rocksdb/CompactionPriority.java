@@ -41,7 +41,15 @@ public enum CompactionPriority {
    * level. The file picking process will cycle through all the files in a
    * round-robin manner.
    */
-  RoundRobin((byte)0x4);
+  RoundRobin((byte)0x4),
+
+  /**
+   * First compact files with the largest share of deletion entries among
+   * their entries, weighted up for files that are read more often than the
+   * average of their level. Files without deletions are picked as with
+   * {@link #MinOverlappingRatio}.
+   */
+  ByTombstoneDensity((byte)0x5);
 
 
   private final byte value;
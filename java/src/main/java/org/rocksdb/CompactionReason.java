@@ -104,7 +104,13 @@ public enum CompactionReason {
   /**
    * Compaction by calling DBImpl::ReFitLevel
    */
-  kRefitLevel((byte) 0x13);
+  kRefitLevel((byte) 0x13),
+
+  /**
+   * Dropping files whose keys are all deleted by range tombstones of a higher
+   * level
+   */
+  kRangeDeletionCoveredFiles((byte) 0x14);
 
   private final byte value;
 
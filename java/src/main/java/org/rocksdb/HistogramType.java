@@ -185,6 +185,36 @@ public enum HistogramType {
 
   FILE_READ_VERIFY_FILE_CHECKSUMS_MICROS((byte) 0x41),
 
+  /**
+   * Time a multi-batch write spends inserting its own batches into the
+   * memtable.
+   */
+  MULTI_BATCH_WRITE_MEMTABLE_MICROS((byte) 0x42),
+
+  /**
+   * Time a multi-batch write spends waiting to be committed in sequence
+   * order.
+   */
+  MULTI_BATCH_WRITE_COMMIT_WAIT_MICROS((byte) 0x43),
+
+  /**
+   * Time the WAL group leader of a pipelined write waits to enter the
+   * memtable stage.
+   */
+  PIPELINED_WRITE_MEMTABLE_WAIT_MICROS((byte) 0x44),
+
+  /**
+   * Time reads of each priority wait in the queues of an I/O scheduling
+   * file system.
+   */
+  IO_SCHEDULER_QUEUE_LOW_MICROS((byte) 0x45),
+
+  IO_SCHEDULER_QUEUE_MID_MICROS((byte) 0x46),
+
+  IO_SCHEDULER_QUEUE_HIGH_MICROS((byte) 0x47),
+
+  IO_SCHEDULER_QUEUE_USER_MICROS((byte) 0x48),
+
   // 0x1F for backwards compatibility on current minor version.
   HISTOGRAM_ENUM_MAX((byte) 0x1F);
 
@@ -36,7 +36,14 @@ public enum IndexType {
    * Makes the index significantly bigger (2x or more), especially when keys
    * are long.
    */
-  kBinarySearchWithFirstKey((byte) 3);
+  kBinarySearchWithFirstKey((byte) 3),
+  /**
+   * Like {@link #kBinarySearch}, but the table also stores a piecewise linear
+   * model of where keys fall in the index, so that lookups only binary search
+   * the few index entries around the predicted one. Works best when the first
+   * 8 bytes of keys are spread evenly. Only used with the bytewise comparator.
+   */
+  kLearnedIndexSearch((byte) 4);
 
   /**
    * Returns the byte value of the enumerations value
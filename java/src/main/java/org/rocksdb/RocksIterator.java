@@ -188,6 +188,39 @@ public class RocksIterator extends AbstractRocksIterator<RocksDB> {
     return valueByteArray0(nativeHandle_, value, offset, len);
   }
 
+  /**
+   * <p>Copies the entries from the current one on into {@code buffer} and
+   * moves the iterator past them, in a single call into the native library.
+   * Each entry is written at the position of the buffer as the length of the
+   * key, the key, the length of the value and the value, the lengths as
+   * big-endian ints as read by {@link ByteBuffer#getInt()}. The limit of the
+   * buffer is set to the end of the last entry written.</p>
+   *
+   * <p>It stops after {@code maxEntries} entries, at the end of the iterator,
+   * or at the first entry that does not fit in the remaining space of the
+   * buffer, which is left as the current entry. Check {@link #isValid()} and
+   * {@link #status()} to tell these apart.</p>
+   *
+   * <p>REQUIRES: {@link #isValid()}</p>
+   *
+   * @param buffer a direct buffer to receive the entries
+   * @param maxEntries the maximum number of entries to copy
+   * @return the number of entries copied
+   *
+   * @throws IllegalArgumentException if {@code buffer} is not direct
+   */
+  public int nextBatch(final ByteBuffer buffer, final int maxEntries) {
+    assert isOwningHandle();
+    if (!buffer.isDirect()) {
+      throw new IllegalArgumentException("buffer must be a direct ByteBuffer");
+    }
+    final long result =
+        nextBatchDirect0(nativeHandle_, buffer, buffer.position(), buffer.remaining(), maxEntries);
+    final int bytes = (int) result;
+    buffer.limit(buffer.position() + bytes);
+    return (int) (result >>> 32);
+  }
+
   @Override protected final native void disposeInternal(final long handle);
   @Override final native boolean isValid0(long handle);
   @Override final native void seekToFirst0(long handle);
@@ -215,4 +248,6 @@ public class RocksIterator extends AbstractRocksIterator<RocksDB> {
   private native int keyByteArray0(long handle, byte[] array, int arrayOffset, int arrayLen);
   private native int valueDirect0(long handle, ByteBuffer buffer, int bufferOffset, int bufferLen);
   private native int valueByteArray0(long handle, byte[] array, int arrayOffset, int arrayLen);
+  private native long nextBatchDirect0(
+      long handle, ByteBuffer buffer, int bufferOffset, int bufferLen, int maxEntries);
 }
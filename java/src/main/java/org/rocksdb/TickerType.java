@@ -776,6 +776,66 @@ public enum TickerType {
 
     PREFETCH_HITS((byte) -0x42),
 
+    /**
+     * Number of WriteBatch bytes applied to the memtable by a multi-batch
+     * writer on behalf of another writer of its group.
+     */
+    MULTI_BATCH_WRITE_STOLEN_BYTES((byte) -0x47),
+
+    /**
+     * Bytes of memtable arena shard blocks whose pages were placed on a NUMA
+     * node other than the one of the thread that allocated them.
+     */
+    MEMTABLE_NUMA_REMOTE_BYTES((byte) -0x48),
+
+    /**
+     * Number of memtable arena blocks taken from the arena block pool.
+     */
+    MEMTABLE_ARENA_POOL_HIT((byte) -0x49),
+
+    /**
+     * Number of memtable arena blocks that were not found in the arena block
+     * pool and were allocated instead.
+     */
+    MEMTABLE_ARENA_POOL_MISS((byte) -0x4A),
+
+    /**
+     * Bytes of the files marked as trash, to be deleted in the background
+     * rather than immediately.
+     */
+    FILES_DELETION_DEFERRED_BYTES((byte) -0x4B),
+
+    /**
+     * Number of times the deletion of trash files slowed down as SST file
+     * reads were slow.
+     */
+    FILES_DELETION_SLOWED_DOWN((byte) -0x4C),
+
+    /**
+     * Number of point lookups served by the merge result cache.
+     */
+    MERGE_RESULT_CACHE_HIT((byte) -0x4D),
+
+    /**
+     * Number of point lookups not served by the merge result cache.
+     */
+    MERGE_RESULT_CACHE_MISS((byte) -0x4E),
+
+    /**
+     * Number of data blocks added to the block cache in far memory.
+     */
+    BLOCK_CACHE_FAR_MEMORY_ADD((byte) -0x4F),
+
+    /**
+     * Number of data blocks in far memory promoted on block cache hits.
+     */
+    BLOCK_CACHE_FAR_MEMORY_PROMOTE((byte) -0x50),
+
+    /**
+     * Bytes of immutable memtables moved to far memory.
+     */
+    MEMTABLE_FAR_MEMORY_BYTES((byte) -0x51),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
@@ -201,15 +201,14 @@ public class WriteOptions extends RocksObject {
 
   /**
    * If true, this writebatch will maintain the last insert positions of each
-   * memtable as hints in concurrent write. It can improve write performance
-   * in concurrent writes if keys in one writebatch are sequential. In
-   * non-concurrent writes (when {@code concurrent_memtable_writes} is false) this
-   * option will be ignored.
+   * memtable as hints. It can improve write performance if keys in one
+   * writebatch are sequential. In non-concurrent writes (when
+   * {@code concurrent_memtable_writes} is false) every memtable keeps a single
+   * hint shared by the batches using this option.
    * <p>
    * Default: false
    *
-   * @return true if writebatch will maintain the last insert positions of each memtable as hints in
-   *     concurrent write.
+   * @return true if writebatch will maintain the last insert positions of each memtable as hints.
    */
   public boolean memtableInsertHintPerBatch() {
     return memtableInsertHintPerBatch(nativeHandle_);
@@ -217,15 +216,15 @@ public class WriteOptions extends RocksObject {
 
   /**
    * If true, this writebatch will maintain the last insert positions of each
-   * memtable as hints in concurrent write. It can improve write performance
-   * in concurrent writes if keys in one writebatch are sequential. In
-   * non-concurrent writes (when {@code concurrent_memtable_writes} is false) this
-   * option will be ignored.
+   * memtable as hints. It can improve write performance if keys in one
+   * writebatch are sequential. In non-concurrent writes (when
+   * {@code concurrent_memtable_writes} is false) every memtable keeps a single
+   * hint shared by the batches using this option.
    * <p>
    * Default: false
    *
    * @param memtableInsertHintPerBatch true if writebatch should maintain the last insert positions
-   *     of each memtable as hints in concurrent write.
+   *     of each memtable as hints.
    * @return the instance of the current WriteOptions.
    */
   public WriteOptions setMemtableInsertHintPerBatch(final boolean memtableInsertHintPerBatch) {
@@ -77,6 +77,69 @@ public class RocksIteratorTest {
     }
   }
 
+  private String getString(final ByteBuffer buffer) {
+    final byte[] bytes = new byte[buffer.getInt()];
+    buffer.get(bytes);
+    return new String(bytes, StandardCharsets.UTF_8);
+  }
+
+  @Test
+  public void rocksIteratorNextBatch() throws RocksDBException {
+    try (final Options options = new Options().setCreateIfMissing(true);
+         final RocksDB db = RocksDB.open(options, dbFolder.getRoot().getAbsolutePath())) {
+      for (int i = 0; i < 5; i++) {
+        db.put(("key" + i).getBytes(), ("value" + i).getBytes());
+      }
+
+      try (final RocksIterator iterator = db.newIterator()) {
+        iterator.seekToFirst();
+        // Each entry takes 4 + 4 + 4 + 6 bytes
+        final ByteBuffer buffer = ByteBuffer.allocateDirect(40);
+
+        // Limited by the number of entries
+        assertThat(iterator.nextBatch(buffer, 1)).isEqualTo(1);
+        assertThat(buffer.remaining()).isEqualTo(18);
+        assertThat(getString(buffer)).isEqualTo("key0");
+        assertThat(getString(buffer)).isEqualTo("value0");
+
+        // Limited by the space in the buffer
+        buffer.clear();
+        assertThat(iterator.nextBatch(buffer, 10)).isEqualTo(2);
+        assertThat(buffer.remaining()).isEqualTo(36);
+        assertThat(getString(buffer)).isEqualTo("key1");
+        assertThat(getString(buffer)).isEqualTo("value1");
+        assertThat(getString(buffer)).isEqualTo("key2");
+        assertThat(getString(buffer)).isEqualTo("value2");
+        assertThat(iterator.isValid()).isTrue();
+        assertThat(iterator.key()).isEqualTo("key3".getBytes());
+
+        // Limited by the end of the iterator
+        buffer.clear();
+        assertThat(iterator.nextBatch(buffer, 10)).isEqualTo(2);
+        assertThat(getString(buffer)).isEqualTo("key3");
+        assertThat(getString(buffer)).isEqualTo("value3");
+        assertThat(getString(buffer)).isEqualTo("key4");
+        assertThat(getString(buffer)).isEqualTo("value4");
+        assertThat(iterator.isValid()).isFalse();
+        iterator.status();
+
+        // Nothing fits
+        iterator.seekToFirst();
+        final ByteBuffer small = ByteBuffer.allocateDirect(10);
+        assertThat(iterator.nextBatch(small, 10)).isEqualTo(0);
+        assertThat(small.remaining()).isEqualTo(0);
+        assertThat(iterator.key()).isEqualTo("key0".getBytes());
+
+        try {
+          iterator.nextBatch(ByteBuffer.allocate(40), 1);
+          fail("Expected IllegalArgumentException");
+        } catch (final IllegalArgumentException ignored) {
+          // we should arrive here
+        }
+      }
+    }
+  }
+
   @Test
   public void rocksIteratorByteArrayValues() throws RocksDBException {
     try (final Options options =
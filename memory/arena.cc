@@ -11,6 +11,11 @@
 
 #include <algorithm>
 
+#ifdef NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif  // NUMA
+
 #include "logging/logging.h"
 #include "port/malloc.h"
 #include "port/port.h"
@@ -20,6 +25,24 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+#ifdef NUMA
+namespace {
+// Asks for the not yet faulted in pages of a mapping to be placed on node.
+// This is only a preference, so that a full node spills over to other
+// nodes instead of failing the allocation.
+// With move, also moves the pages already faulted in, and returns whether
+// that succeeded.
+bool PreferNumaNode(void* addr, size_t length, int node, bool move = false) {
+  struct bitmask* nodes = numa_allocate_nodemask();
+  numa_bitmask_setbit(nodes, static_cast<unsigned int>(node));
+  long ret = mbind(addr, length, MPOL_PREFERRED, nodes->maskp, nodes->size + 1,
+                   move ? MPOL_MF_MOVE : 0);
+  numa_free_nodemask(nodes);
+  return ret == 0;
+}
+}  // namespace
+#endif  // NUMA
+
 size_t Arena::OptimizeBlockSize(size_t block_size) {
   // Make sure block_size is in optimal range
   block_size = std::max(Arena::kMinBlockSize, block_size);
@@ -33,8 +56,16 @@ size_t Arena::OptimizeBlockSize(size_t block_size) {
   return block_size;
 }
 
-Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size)
-    : kBlockSize(OptimizeBlockSize(block_size)), tracker_(tracker) {
+Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size,
+             int numa_node, ArenaBlockPool* block_pool, bool movable)
+    : kBlockSize(OptimizeBlockSize(block_size)),
+      numa_node_(numa_node),
+      block_pool_(block_pool),
+      movable_(movable),
+      tracker_(tracker) {
+#ifndef NUMA
+  movable_ = false;
+#endif  // NUMA
   assert(kBlockSize >= kMinBlockSize && kBlockSize <= kMaxBlockSize &&
          kBlockSize % kAlignUnit == 0);
   TEST_SYNC_POINT_CALLBACK("Arena::Arena:0", const_cast<size_t*>(&kBlockSize));
@@ -54,6 +85,9 @@ Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size)
 }
 
 Arena::~Arena() {
+  for (auto& block : pooled_blocks_) {
+    block_pool_->Return(std::move(block), kBlockSize);
+  }
   if (tracker_ != nullptr) {
     assert(tracker_->is_freed());
     tracker_->FreeMem();
@@ -96,6 +130,11 @@ char* Arena::AllocateFromHugePage(size_t bytes) {
   MemMapping mm = MemMapping::AllocateHuge(bytes);
   auto addr = static_cast<char*>(mm.Get());
   if (addr) {
+#ifdef NUMA
+    if (numa_node_ >= 0) {
+      PreferNumaNode(addr, mm.Length(), numa_node_);
+    }
+#endif  // NUMA
     huge_blocks_.push_back(std::move(mm));
     blocks_memory_ += bytes;
     if (tracker_ != nullptr) {
@@ -142,11 +181,59 @@ char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
   return result;
 }
 
+char* Arena::AllocateOnNumaNode(size_t bytes) {
+#ifdef NUMA
+  MemMapping mm = MemMapping::AllocateLazyZeroed(bytes);
+  auto addr = static_cast<char*>(mm.Get());
+  if (addr) {
+    if (numa_node_ >= 0) {
+      PreferNumaNode(addr, mm.Length(), numa_node_);
+    }
+    huge_blocks_.push_back(std::move(mm));
+    blocks_memory_ += bytes;
+    if (tracker_ != nullptr) {
+      tracker_->Allocate(bytes);
+    }
+  }
+  return addr;
+#else
+  (void)bytes;
+  return nullptr;
+#endif  // NUMA
+}
+
+size_t Arena::MoveToNumaNode(int node) {
+  size_t moved = 0;
+#ifdef NUMA
+  for (auto& mm : huge_blocks_) {
+    if (PreferNumaNode(mm.Get(), mm.Length(), node, /*move=*/true)) {
+      moved += mm.Length();
+    }
+  }
+#else
+  (void)node;
+#endif  // NUMA
+  return moved;
+}
+
 char* Arena::AllocateNewBlock(size_t block_bytes) {
-  // NOTE: std::make_unique zero-initializes the block so is not appropriate
-  // here
-  char* block = new char[block_bytes];
-  blocks_.push_back(std::unique_ptr<char[]>(block));
+  if (numa_node_ >= 0 || movable_) {
+    char* block = AllocateOnNumaNode(block_bytes);
+    if (block != nullptr) {
+      return block;
+    }
+  }
+  char* block;
+  if (block_pool_ != nullptr && block_bytes == kBlockSize) {
+    std::unique_ptr<char[]> pooled = block_pool_->Take(block_bytes);
+    block = pooled != nullptr ? pooled.release() : new char[block_bytes];
+    pooled_blocks_.push_back(std::unique_ptr<char[]>(block));
+  } else {
+    // NOTE: std::make_unique zero-initializes the block so is not
+    // appropriate here
+    block = new char[block_bytes];
+    blocks_.push_back(std::unique_ptr<char[]>(block));
+  }
 
   size_t allocated_size;
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
@@ -17,6 +17,7 @@
 #include <deque>
 
 #include "memory/allocator.h"
+#include "memory/arena_block_pool.h"
 #include "port/mmap.h"
 #include "rocksdb/env.h"
 
@@ -39,8 +40,17 @@ class Arena : public Allocator {
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
   // page TLB first. If allocation fails, will fall back to normal case.
+  // numa_node: if >= 0 and RocksDB is built with NUMA, blocks are mapped
+  // separately and their pages are bound to this NUMA node.
+  // block_pool: if not null, blocks of block_size bytes are taken from it
+  // when it has some, and all of them are returned to it on destruction.
+  // movable: if true and RocksDB is built with NUMA, blocks are mapped
+  // separately, so that MoveToNumaNode() can move them. block_pool is not
+  // used then.
   explicit Arena(size_t block_size = kMinBlockSize,
-                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0);
+                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0,
+                 int numa_node = -1, ArenaBlockPool* block_pool = nullptr,
+                 bool movable = false);
   ~Arena();
 
   char* Allocate(size_t bytes) override;
@@ -64,7 +74,8 @@ class Arena : public Allocator {
   // by the arena (exclude the space allocated but not yet used for future
   // allocations).
   size_t ApproximateMemoryUsage() const {
-    return blocks_memory_ + blocks_.size() * sizeof(char*) -
+    return blocks_memory_ +
+           (blocks_.size() + pooled_blocks_.size()) * sizeof(char*) -
            alloc_bytes_remaining_;
   }
 
@@ -78,8 +89,15 @@ class Arena : public Allocator {
 
   size_t BlockSize() const override { return kBlockSize; }
 
+  // Moves the pages of the blocks mapped separately (see `movable`) to the
+  // NUMA node `node`, and returns their size. Blocks allocated from the heap
+  // are left where they are, as their placement policy would outlive them in
+  // the free memory of the allocator. Always 0 unless RocksDB is built with
+  // NUMA. Not thread-safe with allocations.
+  size_t MoveToNumaNode(int node);
+
   bool IsInInlineBlock() const {
-    return blocks_.empty() && huge_blocks_.empty();
+    return blocks_.empty() && pooled_blocks_.empty() && huge_blocks_.empty();
   }
 
   // check and adjust the block_size so that the return value is
@@ -93,7 +111,9 @@ class Arena : public Allocator {
   const size_t kBlockSize;
   // Allocated memory blocks
   std::deque<std::unique_ptr<char[]>> blocks_;
-  // Huge page allocations
+  // Allocated blocks of kBlockSize bytes that go back to block_pool_
+  std::deque<std::unique_ptr<char[]>> pooled_blocks_;
+  // Huge page and separately mapped allocations
   std::deque<MemMapping> huge_blocks_;
   size_t irregular_block_num = 0;
 
@@ -109,7 +129,13 @@ class Arena : public Allocator {
 
   size_t hugetlb_size_ = 0;
 
+  int numa_node_;
+  ArenaBlockPool* const block_pool_;
+  bool movable_;
+
   char* AllocateFromHugePage(size_t bytes);
+  // Maps a block separately, preferring numa_node_ if set
+  char* AllocateOnNumaNode(size_t bytes);
   char* AllocateFallback(size_t bytes, bool aligned);
   char* AllocateNewBlock(size_t block_bytes);
 
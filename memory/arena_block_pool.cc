@@ -0,0 +1,127 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/arena_block_pool.h"
+
+#include <algorithm>
+
+#include "monitoring/statistics_impl.h"
+#include "test_util/sync_point.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+ArenaBlockPool::ArenaBlockPool(size_t capacity, Statistics* stats)
+    : stats_(stats),
+      capacity_(capacity),
+      cv_(&mutex_),
+      pooled_bytes_(0),
+      closing_(false) {}
+
+ArenaBlockPool::~ArenaBlockPool() {
+  {
+    MutexLock l(&mutex_);
+    closing_ = true;
+    cv_.SignalAll();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::unique_ptr<char[]> ArenaBlockPool::Take(size_t block_size) {
+  std::unique_ptr<char[]> block;
+  {
+    MutexLock l(&mutex_);
+    auto it = blocks_.find(block_size);
+    if (it != blocks_.end() && !it->second.empty()) {
+      block = std::move(it->second.back());
+      it->second.pop_back();
+      pooled_bytes_ -= block_size;
+    }
+  }
+  RecordTick(stats_,
+             block ? MEMTABLE_ARENA_POOL_HIT : MEMTABLE_ARENA_POOL_MISS);
+  return block;
+}
+
+void ArenaBlockPool::Return(std::unique_ptr<char[]> block, size_t block_size) {
+  MutexLock l(&mutex_);
+  if (pooled_bytes_ + block_size <= capacity_) {
+    blocks_[block_size].push_back(std::move(block));
+    pooled_bytes_ += block_size;
+  }
+}
+
+void ArenaBlockPool::Prefault(size_t block_size) {
+  MutexLock l(&mutex_);
+  if (pooled_bytes_ + block_size > capacity_ ||
+      std::find(prefault_requests_.begin(), prefault_requests_.end(),
+                block_size) != prefault_requests_.end()) {
+    return;
+  }
+  prefault_requests_.push_back(block_size);
+  if (!thread_.joinable()) {
+    thread_ = port::Thread([this]() { BackgroundThread(); });
+  }
+  cv_.Signal();
+}
+
+size_t ArenaBlockPool::capacity() const {
+  MutexLock l(&mutex_);
+  return capacity_;
+}
+
+void ArenaBlockPool::SetCapacity(size_t capacity) {
+  std::vector<std::unique_ptr<char[]>> to_free;
+  MutexLock l(&mutex_);
+  capacity_ = capacity;
+  for (auto& entry : blocks_) {
+    while (pooled_bytes_ > capacity_ && !entry.second.empty()) {
+      to_free.push_back(std::move(entry.second.back()));
+      entry.second.pop_back();
+      pooled_bytes_ -= entry.first;
+    }
+  }
+}
+
+size_t ArenaBlockPool::PooledBytes() const {
+  MutexLock l(&mutex_);
+  return pooled_bytes_;
+}
+
+void ArenaBlockPool::BackgroundThread() {
+  MutexLock l(&mutex_);
+  while (true) {
+    while (!closing_ && prefault_requests_.empty()) {
+      cv_.Wait();
+    }
+    if (closing_) {
+      return;
+    }
+    const size_t block_size = prefault_requests_.back();
+    while (!closing_ && pooled_bytes_ + block_size <= capacity_) {
+      mutex_.Unlock();
+      // NOTE: std::make_unique zero-initializes the block, which would fault
+      // in every page too but costs a full memset. Touching one byte per
+      // page is enough.
+      std::unique_ptr<char[]> block(new char[block_size]);
+      for (size_t i = 0; i < block_size; i += port::kPageSize) {
+        block[i] = 0;
+      }
+      mutex_.Lock();
+      if (pooled_bytes_ + block_size > capacity_) {
+        break;
+      }
+      blocks_[block_size].push_back(std::move(block));
+      pooled_bytes_ += block_size;
+      TEST_SYNC_POINT("ArenaBlockPool::BackgroundThread:Prefaulted");
+    }
+    prefault_requests_.erase(std::find(prefault_requests_.begin(),
+                                       prefault_requests_.end(), block_size));
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,74 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Statistics;
+
+// ArenaBlockPool keeps the blocks of destroyed arenas for reuse by new ones,
+// so that memtables written at a steady rate stop handing their memory back
+// to the allocator only to fault it in again in the next memtable. It can
+// also pre-fault blocks in a background thread ahead of demand. Blocks are
+// pooled by size, as arenas of different column families may use different
+// block sizes. Thread-safe.
+class ArenaBlockPool {
+ public:
+  // capacity: the most bytes of blocks the pool holds on to
+  // stats: if not null, records MEMTABLE_ARENA_POOL_HIT and
+  // MEMTABLE_ARENA_POOL_MISS for each Take()
+  explicit ArenaBlockPool(size_t capacity, Statistics* stats = nullptr);
+  // No copying allowed
+  ArenaBlockPool(const ArenaBlockPool&) = delete;
+  void operator=(const ArenaBlockPool&) = delete;
+
+  ~ArenaBlockPool();
+
+  // Returns a block of exactly block_size bytes, or nullptr if the pool has
+  // none.
+  std::unique_ptr<char[]> Take(size_t block_size);
+
+  // Keeps block, of block_size bytes, unless the pool is at capacity, in
+  // which case it is freed.
+  void Return(std::unique_ptr<char[]> block, size_t block_size);
+
+  // Asks the background thread, started on first use, to fill the pool with
+  // pre-faulted blocks of block_size bytes up to its capacity. Does not
+  // wait for it.
+  void Prefault(size_t block_size);
+
+  size_t capacity() const;
+
+  // Changes the capacity, freeing pooled blocks that no longer fit.
+  void SetCapacity(size_t capacity);
+
+  // Returns the number of bytes of blocks currently in the pool.
+  size_t PooledBytes() const;
+
+ private:
+  void BackgroundThread();
+
+  Statistics* const stats_;
+  mutable port::Mutex mutex_;
+  size_t capacity_;
+  port::CondVar cv_;
+  std::unordered_map<size_t, std::vector<std::unique_ptr<char[]>>> blocks_;
+  size_t pooled_bytes_;
+  // Block sizes passed to Prefault() that the background thread has not
+  // handled yet
+  std::vector<size_t> prefault_requests_;
+  bool closing_;
+  port::Thread thread_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
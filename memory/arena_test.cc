@@ -12,6 +12,11 @@
 #ifndef OS_WIN
 #include <sys/resource.h>
 #endif
+#include <algorithm>
+#include <vector>
+
+#include "memory/arena_block_pool.h"
+#include "memory/concurrent_arena.h"
 #include "port/port.h"
 #include "test_util/testharness.h"
 #include "util/random.h"
@@ -293,6 +298,135 @@ TEST_F(ArenaTest, UnmappedAllocation) {
   }
 }
 
+TEST_F(ArenaTest, NumaNodeBlocks) {
+  // Blocks bound to a node are mapped separately; without NUMA support the
+  // arena falls back to regular blocks. Either way it behaves the same.
+  constexpr size_t kBlockSize = 64 << 10;
+  Arena arena(kBlockSize, nullptr, 0, /*numa_node=*/0);
+  std::vector<std::pair<char*, size_t>> allocated;
+  Random rnd(301);
+  size_t bytes = 0;
+  for (int i = 0; i < 1000; i++) {
+    size_t s = 1 + rnd.Uniform(i % 100 == 0 ? kBlockSize : 1000);
+    char* r = i % 2 == 0 ? arena.AllocateAligned(s) : arena.Allocate(s);
+    memset(r, i % 256, s);
+    allocated.emplace_back(r, s);
+    bytes += s;
+  }
+  ASSERT_GE(arena.MemoryAllocatedBytes(), bytes);
+  ASSERT_GE(arena.ApproximateMemoryUsage(), bytes);
+  for (size_t i = 0; i < allocated.size(); i++) {
+    for (size_t j = 0; j < allocated[i].second; j++) {
+      ASSERT_EQ(static_cast<int>(allocated[i].first[j]) & 0xff, i % 256);
+    }
+  }
+}
+
+TEST_F(ArenaTest, MoveToNumaNode) {
+  constexpr size_t kBlockSize = 64 << 10;
+  Arena arena(kBlockSize, nullptr, 0, /*numa_node=*/-1, nullptr,
+              /*movable=*/true);
+  std::vector<std::pair<char*, size_t>> allocated;
+  Random rnd(301);
+  for (int i = 0; i < 100; i++) {
+    size_t s = 1 + rnd.Uniform(i % 10 == 0 ? kBlockSize : 1000);
+    char* r = arena.Allocate(s);
+    memset(r, i % 256, s);
+    allocated.emplace_back(r, s);
+  }
+  // Either way, the contents stay in place
+  const size_t moved = arena.MoveToNumaNode(0);
+#ifdef NUMA
+  ASSERT_LE(moved, arena.MemoryAllocatedBytes());
+#else
+  ASSERT_EQ(moved, 0);
+#endif  // NUMA
+  for (size_t i = 0; i < allocated.size(); i++) {
+    for (size_t j = 0; j < allocated[i].second; j++) {
+      ASSERT_EQ(static_cast<int>(allocated[i].first[j]) & 0xff, i % 256);
+    }
+  }
+}
+
+TEST_F(ArenaTest, NumaAwareConcurrentArena) {
+  constexpr int kNumThreads = 4;
+  constexpr int kAllocsPerThread = 20000;
+  ConcurrentArena arena(1 << 20, nullptr, 0, /*numa_aware=*/true);
+  std::vector<std::vector<char*>> allocated(kNumThreads);
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kAllocsPerThread; i++) {
+        char* r = arena.AllocateAligned(16);
+        memset(r, t, 16);
+        allocated[t].push_back(r);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kNumThreads; t++) {
+    for (char* r : allocated[t]) {
+      for (int j = 0; j < 16; j++) {
+        ASSERT_EQ(t, r[j]);
+      }
+    }
+  }
+  const size_t bytes = size_t{16} * kAllocsPerThread * kNumThreads;
+  ASSERT_GE(arena.ApproximateMemoryUsage(), bytes);
+  ASSERT_GE(arena.MemoryAllocatedBytes(), bytes);
+}
+
+TEST_F(ArenaTest, BlockPool) {
+  constexpr size_t kBlockSize = 64 << 10;
+  ArenaBlockPool pool(4 * kBlockSize);
+  std::vector<char*> blocks;
+  {
+    Arena arena(kBlockSize, nullptr, 0, -1 /* numa_node */, &pool);
+    // The first allocations come from the inline block
+    for (int i = 0; i < 6; i++) {
+      blocks.push_back(arena.AllocateAligned(kBlockSize / 4));
+      blocks.push_back(arena.AllocateAligned(kBlockSize / 4));
+      blocks.push_back(arena.AllocateAligned(kBlockSize / 4));
+      blocks.push_back(arena.AllocateAligned(kBlockSize / 4 - 8));
+    }
+    ASSERT_EQ(0, pool.PooledBytes());
+  }
+  // Six blocks were freed, but the pool only keeps four
+  ASSERT_EQ(4 * kBlockSize, pool.PooledBytes());
+  {
+    Arena arena(kBlockSize, nullptr, 0, -1 /* numa_node */, &pool);
+    char* block = arena.AllocateAligned(kBlockSize / 4);
+    ASSERT_NE(std::find(blocks.begin(), blocks.end(), block), blocks.end());
+    ASSERT_EQ(3 * kBlockSize, pool.PooledBytes());
+    // Blocks of another size are not taken and are freed
+    Arena other(2 * kBlockSize, nullptr, 0, -1 /* numa_node */, &pool);
+    other.AllocateAligned(kBlockSize);
+    ASSERT_EQ(3 * kBlockSize, pool.PooledBytes());
+  }
+  ASSERT_EQ(4 * kBlockSize, pool.PooledBytes());
+  ASSERT_EQ(nullptr, pool.Take(2 * kBlockSize));
+  ASSERT_NE(nullptr, pool.Take(kBlockSize));
+  ASSERT_NE(nullptr, pool.Take(kBlockSize));
+  ASSERT_EQ(2 * kBlockSize, pool.PooledBytes());
+
+  // Prefaulting fills the pool up to its capacity in the background
+  pool.Prefault(kBlockSize);
+  for (int i = 0; pool.PooledBytes() < 4 * kBlockSize; i++) {
+    ASSERT_LT(i, 10000);
+    Env::Default()->SleepForMicroseconds(1000);
+  }
+  pool.Prefault(kBlockSize);
+  ASSERT_EQ(4 * kBlockSize, pool.PooledBytes());
+
+  // Shrinking the pool frees what no longer fits
+  pool.SetCapacity(kBlockSize + 1);
+  ASSERT_EQ(kBlockSize, pool.PooledBytes());
+  pool.Return(std::unique_ptr<char[]>(new char[kBlockSize]), kBlockSize);
+  ASSERT_EQ(kBlockSize, pool.PooledBytes());
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -11,6 +11,11 @@
 
 #include <thread>
 
+#ifdef NUMA
+#include <numa.h>
+#include <numaif.h>
+#endif  // NUMA
+
 #include "port/port.h"
 #include "util/random.h"
 
@@ -24,16 +29,89 @@ namespace {
 // 1MB, 64 cores will quickly allocate 64MB, and may quickly trigger a
 // flush. Cap the size instead.
 const size_t kMaxShardBlockSize = size_t{128 * 1024};
+
+#ifdef NUMA
+// Returns the NUMA node of the CPU the calling thread runs on, or -1.
+int CurrentNumaNode() {
+  int cpu = port::PhysicalCoreID();
+  return cpu < 0 ? -1 : numa_node_of_cpu(cpu);
+}
+
+// Returns the NUMA node that holds the page at addr, or -1.
+int NumaNodeOfAddress(void* addr) {
+  int node = -1;
+  if (get_mempolicy(&node, nullptr, 0, addr, MPOL_F_NODE | MPOL_F_ADDR) !=
+      0) {
+    return -1;
+  }
+  return node;
+}
+#endif  // NUMA
 }  // namespace
 
 ConcurrentArena::ConcurrentArena(size_t block_size, AllocTracker* tracker,
-                                 size_t huge_page_size)
+                                 size_t huge_page_size, bool numa_aware,
+                                 ArenaBlockPool* block_pool, bool movable)
     : shard_block_size_(std::min(kMaxShardBlockSize, block_size / 8)),
       shards_(),
-      arena_(block_size, tracker, huge_page_size) {
+      arena_(block_size, tracker, huge_page_size, -1 /* numa_node */,
+             block_pool, movable),
+      node_allocated_and_unused_(0),
+      numa_remote_bytes_(0),
+      numa_enabled_(false) {
+#ifdef NUMA
+  numa_enabled_ = numa_available() >= 0 && numa_max_node() > 0;
+  if (numa_enabled_ && numa_aware) {
+    for (int node = 0; node <= numa_max_node(); ++node) {
+      node_arenas_.emplace_back(
+          new Arena(block_size, tracker, huge_page_size, node));
+    }
+  }
+#else
+  (void)numa_aware;
+#endif  // NUMA
   Fixup();
 }
 
+size_t ConcurrentArena::RefillShard(Shard* s, size_t exact) {
+  assert(numa_enabled_);
+  int node = -1;
+#ifdef NUMA
+  // The previous block has been written to by now, so its pages have been
+  // placed. Checking one page per block is cheap next to filling it.
+  if (s->block_begin_ != nullptr && s->block_node_ >= 0) {
+    int block_node = NumaNodeOfAddress(s->block_begin_);
+    if (block_node >= 0 && block_node != s->block_node_) {
+      numa_remote_bytes_.fetch_add(s->block_size_, std::memory_order_relaxed);
+    }
+  }
+  node = CurrentNumaNode();
+#endif  // NUMA
+  Arena* arena = &arena_;
+  if (node >= 0 && static_cast<size_t>(node) < node_arenas_.size()) {
+    arena = node_arenas_[node].get();
+    exact = arena->AllocatedAndUnused();
+  }
+  size_t avail =
+      exact >= shard_block_size_ / 2 && exact < shard_block_size_ * 2
+          ? exact
+          : shard_block_size_;
+  s->free_begin_ = arena->AllocateAligned(avail);
+  s->block_begin_ = s->free_begin_;
+  s->block_size_ = avail;
+  s->block_node_ = node;
+  return avail;
+}
+
+size_t ConcurrentArena::MoveToNumaNode(int node) {
+  std::unique_lock<SpinMutex> lock(arena_mutex_);
+  size_t moved = arena_.MoveToNumaNode(node);
+  for (auto& node_arena : node_arenas_) {
+    moved += node_arena->MoveToNumaNode(node);
+  }
+  return moved;
+}
+
 ConcurrentArena::Shard* ConcurrentArena::Repick() {
   auto shard_and_index = shards_.AccessElementAndIndex();
   // even if we are cpu 0, use a non-zero tls_cpuid so we can tell we
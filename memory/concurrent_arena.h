@@ -11,6 +11,7 @@
 #include <atomic>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "memory/allocator.h"
 #include "memory/arena.h"
@@ -45,9 +46,18 @@ class ConcurrentArena : public Allocator {
   // in fact just passed to the constructor of arena_.  The core-local
   // shards compute their shard_block_size as a fraction of block_size
   // that varies according to the hardware concurrency level.
+  //
+  // If numa_aware is true and RocksDB is built with NUMA on a host with
+  // more than one node, the shards refill their blocks from one arena per
+  // NUMA node, picking the node of the CPU the refilling thread runs on,
+  // instead of from wherever the main arena's memory happens to live.
+  //
+  // block_pool and movable are passed to the constructor of arena_.
   explicit ConcurrentArena(size_t block_size = Arena::kMinBlockSize,
                            AllocTracker* tracker = nullptr,
-                           size_t huge_page_size = 0);
+                           size_t huge_page_size = 0, bool numa_aware = false,
+                           ArenaBlockPool* block_pool = nullptr,
+                           bool movable = false);
 
   char* Allocate(size_t bytes) override {
     return AllocateImpl(bytes, false /*force_arena*/,
@@ -70,7 +80,11 @@ class ConcurrentArena : public Allocator {
   size_t ApproximateMemoryUsage() const {
     std::unique_lock<SpinMutex> lock(arena_mutex_, std::defer_lock);
     lock.lock();
-    return arena_.ApproximateMemoryUsage() - ShardAllocatedAndUnused();
+    size_t usage = arena_.ApproximateMemoryUsage();
+    for (const auto& node_arena : node_arenas_) {
+      usage += node_arena->ApproximateMemoryUsage();
+    }
+    return usage - ShardAllocatedAndUnused();
   }
 
   size_t MemoryAllocatedBytes() const {
@@ -79,9 +93,25 @@ class ConcurrentArena : public Allocator {
 
   size_t AllocatedAndUnused() const {
     return arena_allocated_and_unused_.load(std::memory_order_relaxed) +
+           node_allocated_and_unused_.load(std::memory_order_relaxed) +
            ShardAllocatedAndUnused();
   }
 
+  // Returns true if the shards refill from per-NUMA-node arenas.
+  bool IsNumaAware() const { return !node_arenas_.empty(); }
+
+  // Bytes of shard blocks whose pages ended up on a NUMA node other than
+  // the one the thread that refilled the shard was running on. Always 0
+  // unless RocksDB is built with NUMA.
+  uint64_t NumaRemoteBytes() const {
+    return numa_remote_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Moves the pages of the blocks of the arenas that can be moved to the
+  // NUMA node `node`, see Arena::MoveToNumaNode(), and returns their size.
+  // Meant for once no more allocations are made.
+  size_t MoveToNumaNode(int node);
+
   size_t IrregularBlockNum() const {
     return irregular_block_num_.load(std::memory_order_relaxed);
   }
@@ -90,12 +120,22 @@ class ConcurrentArena : public Allocator {
 
  private:
   struct Shard {
-    char padding[40] ROCKSDB_FIELD_UNUSED;
+    char padding[16] ROCKSDB_FIELD_UNUSED;
     mutable SpinMutex mutex;
     char* free_begin_;
     std::atomic<size_t> allocated_and_unused_;
-
-    Shard() : free_begin_(nullptr), allocated_and_unused_(0) {}
+    // The current block and the NUMA node of the thread that allocated it,
+    // for finding out later where its pages were placed
+    char* block_begin_;
+    size_t block_size_;
+    int block_node_;
+
+    Shard()
+        : free_begin_(nullptr),
+          allocated_and_unused_(0),
+          block_begin_(nullptr),
+          block_size_(0),
+          block_node_(-1) {}
   };
 
   static thread_local size_t tls_cpuid;
@@ -111,11 +151,23 @@ class ConcurrentArena : public Allocator {
   std::atomic<size_t> arena_allocated_and_unused_;
   std::atomic<size_t> memory_allocated_bytes_;
   std::atomic<size_t> irregular_block_num_;
+  // One arena per NUMA node, indexed by node, if NUMA aware. Protected by
+  // arena_mutex_.
+  std::vector<std::unique_ptr<Arena>> node_arenas_;
+  std::atomic<size_t> node_allocated_and_unused_;
+  std::atomic<uint64_t> numa_remote_bytes_;
+  // Whether the host has more than one NUMA node
+  bool numa_enabled_;
 
   char padding1[56] ROCKSDB_FIELD_UNUSED;
 
   Shard* Repick();
 
+  // Gives s a new block, from the arena of the current NUMA node if NUMA
+  // aware, and returns its size. exact is arena_.AllocatedAndUnused().
+  // REQUIRES: numa_enabled_, and arena_mutex_ and s->mutex are held
+  size_t RefillShard(Shard* s, size_t exact);
+
   size_t ShardAllocatedAndUnused() const {
     size_t total = 0;
     for (size_t i = 0; i < shards_.Size(); ++i) {
@@ -179,10 +231,14 @@ class ConcurrentArena : public Allocator {
         return rv;
       }
 
-      avail = exact >= shard_block_size_ / 2 && exact < shard_block_size_ * 2
-                  ? exact
-                  : shard_block_size_;
-      s->free_begin_ = arena_.AllocateAligned(avail);
+      if (!numa_enabled_) {
+        avail = exact >= shard_block_size_ / 2 && exact < shard_block_size_ * 2
+                    ? exact
+                    : shard_block_size_;
+        s->free_begin_ = arena_.AllocateAligned(avail);
+      } else {
+        avail = RefillShard(s, exact);
+      }
       Fixup();
     }
     s->allocated_and_unused_.store(avail - bytes, std::memory_order_relaxed);
@@ -202,7 +258,15 @@ class ConcurrentArena : public Allocator {
   void Fixup() {
     arena_allocated_and_unused_.store(arena_.AllocatedAndUnused(),
                                       std::memory_order_relaxed);
-    memory_allocated_bytes_.store(arena_.MemoryAllocatedBytes(),
+    size_t node_allocated_and_unused = 0;
+    size_t memory_allocated_bytes = arena_.MemoryAllocatedBytes();
+    for (const auto& node_arena : node_arenas_) {
+      node_allocated_and_unused += node_arena->AllocatedAndUnused();
+      memory_allocated_bytes += node_arena->MemoryAllocatedBytes();
+    }
+    node_allocated_and_unused_.store(node_allocated_and_unused,
+                                     std::memory_order_relaxed);
+    memory_allocated_bytes_.store(memory_allocated_bytes,
                                   std::memory_order_relaxed);
     irregular_block_num_.store(arena_.IrregularBlockNum(),
                                std::memory_order_relaxed);
@@ -0,0 +1,654 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// ConcurrentBTree is a B+-tree of key pointers designed to back a memtable.
+// Compared to a skip list, a search visits O(log_F n) nodes of F keys each
+// instead of chasing one pointer per comparison. Nodes are a few cache lines
+// big and cache line aligned, and the keys a node points to are prefetched
+// together before it is binary searched, so the cache misses of one level
+// overlap instead of being serialized.
+//
+// Thread safety -------------
+//
+// Insert can be called concurrently with reads and with other inserts. The
+// tree uses optimistic lock coupling: every node carries a version which is
+// odd while a writer modifies the node. Readers never write to shared
+// memory. They read a node's version, read its contents and check that the
+// version didn't change, restarting from the root otherwise. Writers lock
+// only the nodes they modify, by CAS from the version they read, and full
+// nodes are split eagerly on the way down so that a split never has to go
+// up more than one level. Reads require a guarantee that the tree will not
+// be destroyed while the read is in progress.
+//
+// Invariants:
+//
+// (1) Nodes and keys are never freed until the tree is destroyed, so a
+// reader that races with a writer may see stale contents but never freed
+// memory.
+//
+// (2) A split moves the upper half of a node into a new right sibling, so a
+// key only ever moves to the right. An iterator that can't find its
+// successor in its leaf can always follow the leaf's next link.
+//
+// (3) The first key of every leaf except the leftmost one is the separator
+// that routes to it, and never changes. A search for the last key less
+// than a target therefore always finds it in the leaf it lands in, unless
+// that is the leftmost leaf.
+
+#pragma once
+#include <assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "memory/allocator.h"
+#include "port/port.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+template <class Comparator>
+class ConcurrentBTree {
+ public:
+  using DecodedKey =
+      typename std::remove_reference<Comparator>::type::DecodedType;
+
+  // Size of a tree node in bytes.
+  static constexpr size_t kNodeSize =
+      std::max<size_t>(256, static_cast<size_t>(CACHE_LINE_SIZE));
+
+ private:
+  struct Node {
+    explicit Node(bool leaf) : version(0), count(0), is_leaf(leaf) {}
+
+    // Odd while a writer holds the node, bumped again when it is done.
+    std::atomic<uint64_t> version;
+    std::atomic<uint32_t> count;
+    const bool is_leaf;
+  };
+
+  static constexpr uint32_t kLeafCapacity = static_cast<uint32_t>(
+      (kNodeSize - sizeof(Node) - sizeof(void*)) / sizeof(void*));
+  static constexpr uint32_t kInnerCapacity = static_cast<uint32_t>(
+      (kNodeSize - sizeof(Node) - sizeof(void*)) / (2 * sizeof(void*)));
+
+  struct Leaf : public Node {
+    Leaf() : Node(true), next(nullptr) {
+      for (auto& key : keys) {
+        key.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<Leaf*> next;
+    std::atomic<const char*> keys[kLeafCapacity];
+  };
+
+  // Child i holds the keys in [keys[i - 1], keys[i]).
+  struct Inner : public Node {
+    Inner() : Node(false) {
+      for (auto& key : keys) {
+        key.store(nullptr, std::memory_order_relaxed);
+      }
+      for (auto& child : children) {
+        child.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<const char*> keys[kInnerCapacity];
+    std::atomic<Node*> children[kInnerCapacity + 1];
+  };
+
+  static_assert(sizeof(Leaf) <= kNodeSize, "leaf overflows its node");
+  static_assert(sizeof(Inner) <= kNodeSize, "inner node overflows its node");
+
+ public:
+  // Create a new ConcurrentBTree object that will use "cmp" for comparing
+  // keys, and will allocate memory using "*allocator". Objects allocated
+  // in the allocator must remain allocated for the lifetime of the tree.
+  explicit ConcurrentBTree(Comparator cmp, Allocator* allocator);
+  // No copying allowed
+  ConcurrentBTree(const ConcurrentBTree&) = delete;
+  ConcurrentBTree& operator=(const ConcurrentBTree&) = delete;
+
+  // Inserts key into the tree. Returns false if an equal key already
+  // exists, in which case the tree is unchanged. Safe to call concurrently
+  // with reads and with other calls to Insert.
+  bool Insert(const char* key);
+
+  // Returns true iff an entry that compares equal to key is in the tree.
+  bool Contains(const char* key) const;
+
+  // Iteration over the contents of a tree
+  class Iterator {
+   public:
+    // Initialize an iterator over the specified tree.
+    // The returned iterator is not valid.
+    explicit Iterator(const ConcurrentBTree* tree)
+        : tree_(tree), leaf_(nullptr), key_(nullptr), pos_(0) {}
+
+    // Returns true iff the iterator is positioned at a valid node.
+    bool Valid() const { return key_ != nullptr; }
+
+    // Returns the key at the current position.
+    // REQUIRES: Valid()
+    const char* key() const {
+      assert(Valid());
+      return key_;
+    }
+
+    // Advances to the next position.
+    // REQUIRES: Valid()
+    void Next();
+
+    // Advances to the previous position. This searches from the root, as
+    // leaves are only linked forward.
+    // REQUIRES: Valid()
+    void Prev();
+
+    // Advance to the first entry with a key >= target
+    void Seek(const char* target);
+
+    // Retreat to the last entry with a key <= target
+    void SeekForPrev(const char* target);
+
+    // Position at the first entry in tree.
+    // Final state of iterator is Valid() iff tree is not empty.
+    void SeekToFirst();
+
+    // Position at the last entry in tree.
+    // Final state of iterator is Valid() iff tree is not empty.
+    void SeekToLast();
+
+   private:
+    // Positions at the first key starting from leaf that is greater than
+    // target, or equal to it if or_equal. A null target matches any key.
+    void ScanForward(Leaf* leaf, const DecodedKey* target, bool or_equal);
+
+    // Positions at the last key that is less than target, or equal to it
+    // if or_equal. A null target matches any key.
+    void SeekBackward(const DecodedKey* target, bool or_equal);
+
+    const ConcurrentBTree* tree_;
+    Leaf* leaf_;
+    const char* key_;
+    // Where key_ was found in leaf_. Only a hint, as the leaf may have
+    // changed since.
+    uint32_t pos_;
+  };
+
+ private:
+  enum class InsertResult { kInserted, kExists, kRestart };
+
+  static uint64_t AwaitUnlocked(const Node* node) {
+    uint64_t version = node->version.load(std::memory_order_acquire);
+    while ((version & 1) != 0) {
+      port::AsmVolatilePause();
+      version = node->version.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  // Returns true if node didn't change since its version was read.
+  static bool Validate(const Node* node, uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return node->version.load(std::memory_order_relaxed) == version;
+  }
+
+  // Locks node unless it changed since its version was read.
+  static bool TryLock(Node* node, uint64_t version) {
+    if (!node->version.compare_exchange_strong(version, version + 1,
+                                               std::memory_order_acquire)) {
+      return false;
+    }
+    // Orders the stores that follow after the version bump for readers.
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+
+  static void Unlock(Node* node) {
+    node->version.fetch_add(1, std::memory_order_release);
+  }
+
+  static uint32_t Count(const Node* node, uint32_t capacity) {
+    return std::min(node->count.load(std::memory_order_relaxed), capacity);
+  }
+
+  // Sets *rank to the number of keys in keys[0, n) that are less than key,
+  // or less than or equal to it if or_equal. Returns false if it found a
+  // slot that is still being filled in, which means that it raced with a
+  // writer.
+  bool Rank(const std::atomic<const char*>* keys, uint32_t n,
+            const DecodedKey& key, bool or_equal, uint32_t* rank) const;
+
+  // Descends to the leaf whose range holds key, and sets *version to the
+  // version it was found at. A key equal to a separator goes to the right
+  // of it if or_equal, and to the left otherwise. A null key finds the last
+  // leaf.
+  Leaf* FindLeaf(const DecodedKey* key, bool or_equal,
+                 uint64_t* version) const;
+  bool TryFindLeaf(const DecodedKey* key, bool or_equal, Leaf** leaf,
+                   uint64_t* version) const;
+
+  InsertResult TryInsert(const char* key, const DecodedKey& key_decoded);
+
+  // Splits node, and inserts the new separator into parent, or into a new
+  // root if parent is null. Does nothing if either node changed since its
+  // version was read.
+  void Split(Inner* parent, uint64_t parent_version, Node* node,
+             uint64_t version);
+  Node* SplitLeaf(Leaf* leaf, const char** separator);
+  Node* SplitInner(Inner* inner, const char** separator);
+
+  template <typename T>
+  T* NewNode();
+
+  Allocator* const allocator_;
+  Comparator const compare_;
+  Leaf* const head_;
+  std::atomic<Node*> root_;
+};
+
+// Implementation details follow
+
+template <class Comparator>
+ConcurrentBTree<Comparator>::ConcurrentBTree(const Comparator cmp,
+                                             Allocator* allocator)
+    : allocator_(allocator),
+      compare_(cmp),
+      head_(NewNode<Leaf>()),
+      root_(head_) {}
+
+template <class Comparator>
+template <typename T>
+T* ConcurrentBTree<Comparator>::NewNode() {
+  char* mem = allocator_->AllocateAligned(sizeof(T) + CACHE_LINE_SIZE - 1);
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(mem);
+  const uintptr_t aligned =
+      (addr + CACHE_LINE_SIZE - 1) & ~uintptr_t{CACHE_LINE_SIZE - 1};
+  return new (mem + (aligned - addr)) T();
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Rank(const std::atomic<const char*>* keys,
+                                       uint32_t n, const DecodedKey& key,
+                                       bool or_equal, uint32_t* rank) const {
+  // The binary search below touches log(n) keys that are likely not cached.
+  // Fetch them all at once rather than one after the other.
+  for (uint32_t i = 0; i < n; i++) {
+    const char* k = keys[i].load(std::memory_order_acquire);
+    if (k != nullptr) {
+      PREFETCH(k, 0, 1);
+    }
+  }
+  uint32_t lo = 0;
+  uint32_t hi = n;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    const char* k = keys[mid].load(std::memory_order_acquire);
+    if (k == nullptr) {
+      return false;
+    }
+    const int cmp = compare_(k, key);
+    if (cmp < 0 || (or_equal && cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *rank = lo;
+  return true;
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::TryFindLeaf(const DecodedKey* key,
+                                              bool or_equal, Leaf** leaf,
+                                              uint64_t* version) const {
+  Node* node = root_.load(std::memory_order_acquire);
+  uint64_t node_version = AwaitUnlocked(node);
+  // A root split installs the new root before unlocking the old one, which
+  // is then only its left half
+  if (root_.load(std::memory_order_acquire) != node) {
+    return false;
+  }
+  while (!node->is_leaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    const uint32_t n = Count(inner, kInnerCapacity);
+    uint32_t pos = n;
+    if (key != nullptr && !Rank(inner->keys, n, *key, or_equal, &pos)) {
+      return false;
+    }
+    Node* child = inner->children[pos].load(std::memory_order_acquire);
+    if (child == nullptr) {
+      return false;
+    }
+    // Read the child's version before checking that the parent still
+    // routes to it, so that a concurrent split of the child is detected
+    // by whoever looks at the child next.
+    const uint64_t child_version = AwaitUnlocked(child);
+    if (!Validate(inner, node_version)) {
+      return false;
+    }
+    node = child;
+    node_version = child_version;
+  }
+  *leaf = static_cast<Leaf*>(node);
+  *version = node_version;
+  return true;
+}
+
+template <class Comparator>
+typename ConcurrentBTree<Comparator>::Leaf*
+ConcurrentBTree<Comparator>::FindLeaf(const DecodedKey* key, bool or_equal,
+                                      uint64_t* version) const {
+  Leaf* leaf = nullptr;
+  while (!TryFindLeaf(key, or_equal, &leaf, version)) {
+  }
+  return leaf;
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Insert(const char* key) {
+  const DecodedKey key_decoded = compare_.decode_key(key);
+  while (true) {
+    const InsertResult result = TryInsert(key, key_decoded);
+    if (result != InsertResult::kRestart) {
+      return result == InsertResult::kInserted;
+    }
+  }
+}
+
+template <class Comparator>
+typename ConcurrentBTree<Comparator>::InsertResult
+ConcurrentBTree<Comparator>::TryInsert(const char* key,
+                                       const DecodedKey& key_decoded) {
+  Node* node = root_.load(std::memory_order_acquire);
+  uint64_t version = AwaitUnlocked(node);
+  // See TryFindLeaf()
+  if (root_.load(std::memory_order_acquire) != node) {
+    return InsertResult::kRestart;
+  }
+  Inner* parent = nullptr;
+  uint64_t parent_version = 0;
+  while (!node->is_leaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    const uint32_t n = Count(inner, kInnerCapacity);
+    if (n == kInnerCapacity) {
+      Split(parent, parent_version, inner, version);
+      return InsertResult::kRestart;
+    }
+    uint32_t pos = 0;
+    if (!Rank(inner->keys, n, key_decoded, true /* or_equal */, &pos)) {
+      return InsertResult::kRestart;
+    }
+    Node* child = inner->children[pos].load(std::memory_order_acquire);
+    if (child == nullptr) {
+      return InsertResult::kRestart;
+    }
+    const uint64_t child_version = AwaitUnlocked(child);
+    if (!Validate(inner, version)) {
+      return InsertResult::kRestart;
+    }
+    parent = inner;
+    parent_version = version;
+    node = child;
+    version = child_version;
+  }
+
+  Leaf* leaf = static_cast<Leaf*>(node);
+  if (Count(leaf, kLeafCapacity) == kLeafCapacity) {
+    Split(parent, parent_version, leaf, version);
+    return InsertResult::kRestart;
+  }
+  // The leaf is still the one for key as long as it didn't change since
+  // the parent was validated.
+  if (!TryLock(leaf, version)) {
+    return InsertResult::kRestart;
+  }
+  const uint32_t n = leaf->count.load(std::memory_order_relaxed);
+  uint32_t pos = 0;
+  Rank(leaf->keys, n, key_decoded, false /* or_equal */, &pos);
+  if (pos < n && compare_(leaf->keys[pos].load(std::memory_order_acquire),
+                          key_decoded) == 0) {
+    Unlock(leaf);
+    return InsertResult::kExists;
+  }
+  for (uint32_t i = n; i > pos; i--) {
+    leaf->keys[i].store(leaf->keys[i - 1].load(std::memory_order_acquire),
+                        std::memory_order_release);
+  }
+  leaf->keys[pos].store(key, std::memory_order_release);
+  leaf->count.store(n + 1, std::memory_order_relaxed);
+  Unlock(leaf);
+  return InsertResult::kInserted;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Split(Inner* parent, uint64_t parent_version,
+                                        Node* node, uint64_t version) {
+  // Nodes are always locked top-down and TryLock never blocks, so writers
+  // can't deadlock. The parent has room for one more key: a full inner
+  // node is split before anything below it.
+  if (parent != nullptr && !TryLock(parent, parent_version)) {
+    return;
+  }
+  if (!TryLock(node, version)) {
+    if (parent != nullptr) {
+      Unlock(parent);
+    }
+    return;
+  }
+  assert(parent != nullptr || root_.load(std::memory_order_relaxed) == node);
+  const char* separator = nullptr;
+  Node* right = node->is_leaf
+                    ? SplitLeaf(static_cast<Leaf*>(node), &separator)
+                    : SplitInner(static_cast<Inner*>(node), &separator);
+  if (parent != nullptr) {
+    const uint32_t n = parent->count.load(std::memory_order_relaxed);
+    assert(n < kInnerCapacity);
+    uint32_t pos = 0;
+    Rank(parent->keys, n, compare_.decode_key(separator), false /* or_equal */,
+         &pos);
+    for (uint32_t i = n; i > pos; i--) {
+      parent->keys[i].store(parent->keys[i - 1].load(std::memory_order_acquire),
+                            std::memory_order_release);
+      parent->children[i + 1].store(
+          parent->children[i].load(std::memory_order_acquire),
+          std::memory_order_release);
+    }
+    parent->keys[pos].store(separator, std::memory_order_release);
+    parent->children[pos + 1].store(right, std::memory_order_release);
+    parent->count.store(n + 1, std::memory_order_relaxed);
+  } else {
+    Inner* root = NewNode<Inner>();
+    root->keys[0].store(separator, std::memory_order_release);
+    root->children[0].store(node, std::memory_order_release);
+    root->children[1].store(right, std::memory_order_release);
+    root->count.store(1, std::memory_order_relaxed);
+    root_.store(root, std::memory_order_release);
+  }
+  Unlock(node);
+  if (parent != nullptr) {
+    Unlock(parent);
+  }
+}
+
+template <class Comparator>
+typename ConcurrentBTree<Comparator>::Node*
+ConcurrentBTree<Comparator>::SplitLeaf(Leaf* leaf, const char** separator) {
+  const uint32_t n = leaf->count.load(std::memory_order_relaxed);
+  const uint32_t mid = n / 2;
+  Leaf* right = NewNode<Leaf>();
+  for (uint32_t i = mid; i < n; i++) {
+    right->keys[i - mid].store(leaf->keys[i].load(std::memory_order_acquire),
+                               std::memory_order_release);
+  }
+  right->count.store(n - mid, std::memory_order_relaxed);
+  right->next.store(leaf->next.load(std::memory_order_acquire),
+                    std::memory_order_release);
+  // Readers only follow this link after validating the leaf, which orders
+  // the initialization of right before it.
+  leaf->next.store(right, std::memory_order_release);
+  leaf->count.store(mid, std::memory_order_relaxed);
+  *separator = right->keys[0].load(std::memory_order_acquire);
+  return right;
+}
+
+template <class Comparator>
+typename ConcurrentBTree<Comparator>::Node*
+ConcurrentBTree<Comparator>::SplitInner(Inner* inner, const char** separator) {
+  const uint32_t n = inner->count.load(std::memory_order_relaxed);
+  const uint32_t mid = n / 2;
+  Inner* right = NewNode<Inner>();
+  for (uint32_t i = mid + 1; i < n; i++) {
+    right->keys[i - mid - 1].store(
+        inner->keys[i].load(std::memory_order_acquire),
+        std::memory_order_release);
+  }
+  for (uint32_t i = mid + 1; i <= n; i++) {
+    right->children[i - mid - 1].store(
+        inner->children[i].load(std::memory_order_acquire),
+        std::memory_order_release);
+  }
+  right->count.store(n - mid - 1, std::memory_order_relaxed);
+  *separator = inner->keys[mid].load(std::memory_order_acquire);
+  inner->count.store(mid, std::memory_order_relaxed);
+  return right;
+}
+
+template <class Comparator>
+bool ConcurrentBTree<Comparator>::Contains(const char* key) const {
+  const DecodedKey key_decoded = compare_.decode_key(key);
+  while (true) {
+    uint64_t version = 0;
+    Leaf* leaf = FindLeaf(&key_decoded, true /* or_equal */, &version);
+    const uint32_t n = Count(leaf, kLeafCapacity);
+    uint32_t pos = 0;
+    if (!Rank(leaf->keys, n, key_decoded, false /* or_equal */, &pos)) {
+      continue;
+    }
+    const char* found =
+        pos < n ? leaf->keys[pos].load(std::memory_order_acquire) : nullptr;
+    const bool equal = found != nullptr && compare_(found, key_decoded) == 0;
+    if (Validate(leaf, version)) {
+      return equal;
+    }
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::ScanForward(
+    Leaf* leaf, const DecodedKey* target, bool or_equal) {
+  while (leaf != nullptr) {
+    const uint64_t version = AwaitUnlocked(leaf);
+    const uint32_t n = Count(leaf, kLeafCapacity);
+    uint32_t pos = 0;
+    if (target != nullptr &&
+        !tree_->Rank(leaf->keys, n, *target, !or_equal, &pos)) {
+      continue;
+    }
+    const char* found =
+        pos < n ? leaf->keys[pos].load(std::memory_order_acquire) : nullptr;
+    Leaf* next = leaf->next.load(std::memory_order_acquire);
+    if (!Validate(leaf, version) || (pos < n && found == nullptr)) {
+      continue;
+    }
+    if (found != nullptr) {
+      leaf_ = leaf;
+      key_ = found;
+      pos_ = pos;
+      return;
+    }
+    leaf = next;
+  }
+  leaf_ = nullptr;
+  key_ = nullptr;
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekBackward(
+    const DecodedKey* target, bool or_equal) {
+  while (true) {
+    uint64_t version = 0;
+    Leaf* leaf = tree_->FindLeaf(target, or_equal, &version);
+    const uint32_t n = Count(leaf, kLeafCapacity);
+    uint32_t pos = n;
+    if (target != nullptr &&
+        !tree_->Rank(leaf->keys, n, *target, or_equal, &pos)) {
+      continue;
+    }
+    const char* found =
+        pos > 0 ? leaf->keys[pos - 1].load(std::memory_order_acquire)
+                : nullptr;
+    if (!Validate(leaf, version) || (pos > 0 && found == nullptr)) {
+      continue;
+    }
+    leaf_ = found != nullptr ? leaf : nullptr;
+    key_ = found;
+    pos_ = pos > 0 ? pos - 1 : 0;
+    return;
+  }
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Next() {
+  assert(Valid());
+  // Fast path: if the leaf still has key_ where we found it, the next key
+  // is the one after it, or the first one of the next leaf.
+  const uint64_t version = AwaitUnlocked(leaf_);
+  const uint32_t n = Count(leaf_, kLeafCapacity);
+  if (pos_ < n && leaf_->keys[pos_].load(std::memory_order_acquire) == key_) {
+    if (pos_ + 1 < n) {
+      const char* next_key =
+          leaf_->keys[pos_ + 1].load(std::memory_order_acquire);
+      if (next_key != nullptr && Validate(leaf_, version)) {
+        key_ = next_key;
+        pos_++;
+        return;
+      }
+    } else {
+      Leaf* next = leaf_->next.load(std::memory_order_acquire);
+      if (Validate(leaf_, version)) {
+        ScanForward(next, nullptr, true /* or_equal */);
+        return;
+      }
+    }
+  }
+  const DecodedKey current = tree_->compare_.decode_key(key_);
+  ScanForward(leaf_, &current, false /* or_equal */);
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Prev() {
+  assert(Valid());
+  const DecodedKey current = tree_->compare_.decode_key(key_);
+  SeekBackward(&current, false /* or_equal */);
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::Seek(const char* target) {
+  const DecodedKey target_decoded = tree_->compare_.decode_key(target);
+  uint64_t version = 0;
+  Leaf* leaf = tree_->FindLeaf(&target_decoded, true /* or_equal */, &version);
+  ScanForward(leaf, &target_decoded, true /* or_equal */);
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekForPrev(const char* target) {
+  const DecodedKey target_decoded = tree_->compare_.decode_key(target);
+  SeekBackward(&target_decoded, true /* or_equal */);
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekToFirst() {
+  ScanForward(tree_->head_, nullptr, true /* or_equal */);
+}
+
+template <class Comparator>
+void ConcurrentBTree<Comparator>::Iterator::SeekToLast() {
+  SeekBackward(nullptr, false /* or_equal */);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
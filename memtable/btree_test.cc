@@ -0,0 +1,282 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memtable/btree.h"
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+#include "memory/concurrent_arena.h"
+#include "port/port.h"
+#include "port/stack_trace.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Our test tree stores 8-byte unsigned integers
+using Key = uint64_t;
+
+static const char* Encode(const uint64_t* key) {
+  return reinterpret_cast<const char*>(key);
+}
+
+static Key Decode(const char* key) {
+  Key rv;
+  memcpy(&rv, key, sizeof(Key));
+  return rv;
+}
+
+struct TestComparator {
+  using DecodedType = Key;
+
+  static DecodedType decode_key(const char* b) { return Decode(b); }
+
+  int operator()(const char* a, const char* b) const {
+    return (*this)(a, Decode(b));
+  }
+
+  int operator()(const char* a, const DecodedType b) const {
+    if (Decode(a) < b) {
+      return -1;
+    } else if (Decode(a) > b) {
+      return +1;
+    } else {
+      return 0;
+    }
+  }
+};
+
+using TestBTree = ConcurrentBTree<TestComparator>;
+
+class BTreeTest : public testing::Test {
+ public:
+  BTreeTest() : tree_(TestComparator(), &arena_) {}
+
+  bool Insert(Key key) {
+    char* buf = arena_.Allocate(sizeof(Key));
+    memcpy(buf, &key, sizeof(Key));
+    return tree_.Insert(buf);
+  }
+
+  // Checks the contents of the tree against keys, in both directions.
+  void Validate(const std::set<Key>& keys) {
+    for (Key key : keys) {
+      ASSERT_TRUE(tree_.Contains(Encode(&key)));
+    }
+    TestBTree::Iterator iter(&tree_);
+    ASSERT_FALSE(iter.Valid());
+    iter.SeekToFirst();
+    for (Key key : keys) {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(key, Decode(iter.key()));
+      iter.Next();
+    }
+    ASSERT_FALSE(iter.Valid());
+    iter.SeekToLast();
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*it, Decode(iter.key()));
+      iter.Prev();
+    }
+    ASSERT_FALSE(iter.Valid());
+  }
+
+ protected:
+  ConcurrentArena arena_;
+  TestBTree tree_;
+};
+
+TEST_F(BTreeTest, Empty) {
+  Key key = 10;
+  ASSERT_FALSE(tree_.Contains(Encode(&key)));
+
+  TestBTree::Iterator iter(&tree_);
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToFirst();
+  ASSERT_FALSE(iter.Valid());
+  iter.Seek(Encode(&key));
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekForPrev(Encode(&key));
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToLast();
+  ASSERT_FALSE(iter.Valid());
+}
+
+TEST_F(BTreeTest, InsertAndLookup) {
+  const int N = 20000;
+  const Key R = 50000;
+  Random rnd(1000);
+  std::set<Key> keys;
+  for (int i = 0; i < N; i++) {
+    Key key = rnd.Next() % R;
+    ASSERT_EQ(keys.insert(key).second, Insert(key));
+  }
+
+  for (Key i = 0; i < R; i++) {
+    ASSERT_EQ(keys.count(i) == 1, tree_.Contains(Encode(&i)));
+  }
+  Validate(keys);
+
+  // Seek and SeekForPrev against the model, with a few steps each way
+  for (Key i = 0; i < R; i += 7) {
+    TestBTree::Iterator iter(&tree_);
+    iter.Seek(Encode(&i));
+    auto model_iter = keys.lower_bound(i);
+    for (int j = 0; j < 3; j++) {
+      if (model_iter == keys.end()) {
+        ASSERT_FALSE(iter.Valid());
+        break;
+      }
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*model_iter, Decode(iter.key()));
+      ++model_iter;
+      iter.Next();
+    }
+
+    iter.SeekForPrev(Encode(&i));
+    model_iter = keys.upper_bound(i);
+    for (int j = 0; j < 3; j++) {
+      if (model_iter == keys.begin()) {
+        ASSERT_FALSE(iter.Valid());
+        break;
+      }
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*--model_iter, Decode(iter.key()));
+      iter.Prev();
+    }
+  }
+}
+
+TEST_F(BTreeTest, SequentialInserts) {
+  // Ascending and descending runs always split the same side of a node.
+  std::set<Key> keys;
+  for (Key i = 0; i < 20000; i++) {
+    ASSERT_TRUE(Insert(2 * i + 100000));
+    keys.insert(2 * i + 100000);
+  }
+  for (Key i = 0; i < 20000; i++) {
+    ASSERT_TRUE(Insert(99998 - 2 * i));
+    keys.insert(99998 - 2 * i);
+  }
+  ASSERT_FALSE(Insert(100000));
+  Validate(keys);
+}
+
+TEST_F(BTreeTest, ConcurrentInsert) {
+  constexpr int kNumThreads = 4;
+  constexpr Key kNumKeys = 20000;
+  std::atomic<bool> done{false};
+  // A reader that checks that iteration always sees keys in order while
+  // concurrent inserts split nodes under it.
+  port::Thread reader([&]() {
+    TestBTree::Iterator iter(&tree_);
+    while (!done.load(std::memory_order_acquire)) {
+      Key last = 0;
+      bool first = true;
+      for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+        const Key key = Decode(iter.key());
+        ASSERT_TRUE(first || last < key);
+        first = false;
+        last = key;
+      }
+      Key target = last / 2;
+      iter.SeekForPrev(Encode(&target));
+      if (iter.Valid()) {
+        ASSERT_LE(Decode(iter.key()), target);
+      }
+    }
+  });
+  std::vector<port::Thread> writers;
+  for (int t = 0; t < kNumThreads; t++) {
+    writers.emplace_back([&, t]() {
+      // Every writer inserts all keys, in a different order, so that each
+      // key is inserted once and every other attempt is a duplicate.
+      Random rnd(301 + t);
+      for (Key i = 0; i < kNumKeys; i++) {
+        Insert(t % 2 == 0 ? i : kNumKeys - 1 - i);
+        Insert(rnd.Uniform(static_cast<int>(kNumKeys)));
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done.store(true, std::memory_order_release);
+  reader.join();
+
+  std::set<Key> keys;
+  for (Key i = 0; i < kNumKeys; i++) {
+    keys.insert(i);
+  }
+  Validate(keys);
+}
+
+TEST_F(BTreeTest, ConcurrentInsertAndReadFromEmpty) {
+  // Starts over from an empty tree many times, so that the root splits
+  // while other threads are descending from it.
+  constexpr int kNumThreads = 4;
+  constexpr Key kKeysPerThread = 2000;
+  for (int round = 0; round < 50; round++) {
+    ConcurrentArena arena;
+    TestBTree tree(TestComparator(), &arena);
+    // The number of keys each writer has inserted so far
+    std::atomic<Key> progress[kNumThreads];
+    for (auto& p : progress) {
+      p.store(0, std::memory_order_relaxed);
+    }
+    std::atomic<bool> done{false};
+    port::Thread reader([&]() {
+      Random rnd(round);
+      while (!done.load(std::memory_order_acquire)) {
+        for (int t = 0; t < kNumThreads; t++) {
+          const Key n = progress[t].load(std::memory_order_acquire);
+          if (n > 0) {
+            const Key key = t + kNumThreads * rnd.Uniform(static_cast<int>(n));
+            ASSERT_TRUE(tree.Contains(Encode(&key)));
+          }
+        }
+      }
+    });
+    std::vector<port::Thread> writers;
+    for (int t = 0; t < kNumThreads; t++) {
+      writers.emplace_back([&, t]() {
+        // Interleaved keys, so that all writers insert into the same leaves
+        for (Key i = 0; i < kKeysPerThread; i++) {
+          const Key key = t + kNumThreads * i;
+          char* buf = arena.Allocate(sizeof(Key));
+          memcpy(buf, &key, sizeof(Key));
+          ASSERT_TRUE(tree.Insert(buf));
+          progress[t].store(i + 1, std::memory_order_release);
+        }
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    // Every key is found, and the leaves are in order
+    TestBTree::Iterator iter(&tree);
+    iter.SeekToFirst();
+    for (Key key = 0; key < kNumThreads * kKeysPerThread; key++) {
+      ASSERT_TRUE(tree.Contains(Encode(&key)));
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(key, Decode(iter.key()));
+      iter.Next();
+    }
+    ASSERT_FALSE(iter.Valid());
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -11,13 +11,13 @@
 #include "db/memtable.h"
 #include "memory/arena.h"
 #include "memtable/skiplist.h"
+#include "memtable/split_ordered_table.h"
 #include "monitoring/histogram.h"
 #include "port/port.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/utilities/options_type.h"
-#include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace {
@@ -187,11 +187,13 @@ class HashLinkListRep : public MemTableRep {
  private:
   friend class DynamicIterator;
 
-  size_t bucket_size_;
-
   // Maps slices (which are transformed user keys) to buckets of keys sharing
-  // the same transform.
-  Pointer* buckets_;
+  // the same transform. It grows with the number of distinct transforms,
+  // starting from bucket_size buckets.
+  SplitOrderedPrefixTable buckets_;
+
+  // The bucket of the transforms without keys, which stays empty
+  mutable Pointer empty_bucket_;
 
   const uint32_t threshold_use_skiplist_;
 
@@ -221,14 +223,9 @@ class HashLinkListRep : public MemTableRep {
     return transform_->Transform(ExtractUserKey(internal_key));
   }
 
-  size_t GetHash(const Slice& slice) const {
-    return GetSliceRangedNPHash(slice, bucket_size_);
-  }
-
-  Pointer& GetBucket(size_t i) const { return buckets_[i]; }
-
   Pointer& GetBucket(const Slice& slice) const {
-    return GetBucket(GetHash(slice));
+    Pointer* bucket = buckets_.Find(slice);
+    return bucket == nullptr ? empty_bucket_ : *bucket;
   }
 
   bool Equal(const Slice& a, const Key& b) const {
@@ -507,7 +504,8 @@ HashLinkListRep::HashLinkListRep(
     uint32_t threshold_use_skiplist, size_t huge_page_tlb_size, Logger* logger,
     int bucket_entries_logging_threshold, bool if_log_bucket_dist_when_flash)
     : MemTableRep(allocator),
-      bucket_size_(bucket_size),
+      buckets_(allocator, bucket_size, huge_page_tlb_size, logger),
+      empty_bucket_(nullptr),
       // Threshold to use skip list doesn't make sense if less than 3, so we
       // force it to be minimum of 3 to simplify implementation.
       threshold_use_skiplist_(std::max(threshold_use_skiplist, 3U)),
@@ -515,16 +513,7 @@ HashLinkListRep::HashLinkListRep(
       compare_(compare),
       logger_(logger),
       bucket_entries_logging_threshold_(bucket_entries_logging_threshold),
-      if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash) {
-  char* mem = allocator_->AllocateAligned(sizeof(Pointer) * bucket_size,
-                                          huge_page_tlb_size, logger);
-
-  buckets_ = new (mem) Pointer[bucket_size];
-
-  for (size_t i = 0; i < bucket_size_; ++i) {
-    buckets_[i].store(nullptr, std::memory_order_relaxed);
-  }
-}
+      if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash) {}
 
 HashLinkListRep::~HashLinkListRep() = default;
 
@@ -584,7 +573,7 @@ void HashLinkListRep::Insert(KeyHandle handle) {
   assert(!Contains(x->key));
   Slice internal_key = GetLengthPrefixedSlice(x->key);
   auto transformed = GetPrefix(internal_key);
-  auto& bucket = buckets_[GetHash(transformed)];
+  auto& bucket = *buckets_.FindOrInsert(transformed, nullptr);
   Pointer* first_next_pointer =
       static_cast<Pointer*>(bucket.load(std::memory_order_relaxed));
 
@@ -629,10 +618,9 @@ void HashLinkListRep::Insert(KeyHandle handle) {
       header->GetNumEntries() ==
           static_cast<uint32_t>(bucket_entries_logging_threshold_)) {
     Info(logger_,
-         "HashLinkedList bucket %" ROCKSDB_PRIszt
-         " has more than %d "
+         "HashLinkedList bucket of prefix %s has more than %d "
          "entries. Key to insert: %s",
-         GetHash(transformed), header->GetNumEntries(),
+         transformed.ToString(true).c_str(), header->GetNumEntries(),
          GetLengthPrefixedSlice(x->key).ToString(true).c_str());
   }
 
@@ -763,9 +751,9 @@ MemTableRep::Iterator* HashLinkListRep::GetIterator(Arena* alloc_arena) {
   auto list = new MemtableSkipList(compare_, new_arena);
   HistogramImpl keys_per_bucket_hist;
 
-  for (size_t i = 0; i < bucket_size_; ++i) {
+  buckets_.ForEach([&](Pointer* bucket_pointer) {
     int count = 0;
-    Pointer& bucket = GetBucket(i);
+    Pointer& bucket = *bucket_pointer;
     if (!IsEmptyBucket(bucket)) {
       auto* link_list_head = GetLinkListFirstNode(bucket);
       if (link_list_head != nullptr) {
@@ -788,7 +776,7 @@ MemTableRep::Iterator* HashLinkListRep::GetIterator(Arena* alloc_arena) {
     if (if_log_bucket_dist_when_flash_) {
       keys_per_bucket_hist.Add(count);
     }
-  }
+  });
   if (if_log_bucket_dist_when_flash_ && logger_ != nullptr) {
     Info(logger_, "hashLinkedList Entry distribution among buckets: %s",
          keys_per_bucket_hist.ToString().c_str());
@@ -8,13 +8,14 @@
 
 #include "db/memtable.h"
 #include "memory/arena.h"
+#include "memtable/inlineskiplist.h"
 #include "memtable/skiplist.h"
+#include "memtable/split_ordered_table.h"
 #include "port/port.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/utilities/options_type.h"
-#include "util/murmurhash.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace {
@@ -26,8 +27,12 @@ class HashSkipListRep : public MemTableRep {
                   size_t bucket_size, int32_t skiplist_height,
                   int32_t skiplist_branching_factor);
 
+  KeyHandle Allocate(const size_t len, char** buf) override;
+
   void Insert(KeyHandle handle) override;
 
+  void InsertConcurrently(KeyHandle handle) override;
+
   bool Contains(const char* key) const override;
 
   size_t ApproximateMemoryUsage() override;
@@ -44,17 +49,13 @@ class HashSkipListRep : public MemTableRep {
 
  private:
   friend class DynamicIterator;
-  using Bucket = SkipList<const char*, const MemTableRep::KeyComparator&>;
-
-  size_t bucket_size_;
+  using Bucket = InlineSkipList<const MemTableRep::KeyComparator&>;
+  // The keys of all the buckets, copied for a total order iteration
+  using FullList = SkipList<const char*, const MemTableRep::KeyComparator&>;
 
   const int32_t skiplist_height_;
   const int32_t skiplist_branching_factor_;
 
-  // Maps slices (which are transformed user keys) to buckets of keys sharing
-  // the same transform.
-  std::atomic<Bucket*>* buckets_;
-
   // The user-supplied transform whose domain is the user keys.
   const SliceTransform* transform_;
 
@@ -62,24 +63,29 @@ class HashSkipListRep : public MemTableRep {
   // immutable after construction
   Allocator* const allocator_;
 
-  inline size_t GetHash(const Slice& slice) const {
-    return MurmurHash(slice.data(), static_cast<int>(slice.size()), 0) %
-           bucket_size_;
-  }
-  inline Bucket* GetBucket(size_t i) const {
-    return buckets_[i].load(std::memory_order_acquire);
-  }
-  inline Bucket* GetBucket(const Slice& slice) const {
-    return GetBucket(GetHash(slice));
+  // Allocates the nodes of the keys of all the buckets, which share its
+  // allocator, height and branching factor. It never holds a key itself.
+  Bucket key_allocator_;
+
+  // Maps slices (which are transformed user keys) to the bucket of the keys
+  // sharing that transform. It grows with the number of distinct transforms,
+  // starting from bucket_size buckets.
+  SplitOrderedPrefixTable buckets_;
+
+  inline Bucket* GetBucket(const Slice& transformed) const {
+    std::atomic<void*>* slot = buckets_.Find(transformed);
+    return slot == nullptr
+               ? nullptr
+               : static_cast<Bucket*>(slot->load(std::memory_order_acquire));
   }
   // Get a bucket from buckets_. If the bucket hasn't been initialized yet,
-  // initialize it before returning.
+  // initialize it before returning. Thread-safe.
   Bucket* GetInitializedBucket(const Slice& transformed);
 
+  template <class List>
   class Iterator : public MemTableRep::Iterator {
    public:
-    explicit Iterator(Bucket* list, bool own_list = true,
-                      Arena* arena = nullptr)
+    explicit Iterator(List* list, bool own_list = true, Arena* arena = nullptr)
         : list_(list), iter_(list), own_list_(own_list), arena_(arena) {}
 
     ~Iterator() override {
@@ -148,7 +154,7 @@ class HashSkipListRep : public MemTableRep {
     }
 
    protected:
-    void Reset(Bucket* list) {
+    void Reset(List* list) {
       if (own_list_) {
         assert(list_ != nullptr);
         delete list_;
@@ -161,8 +167,8 @@ class HashSkipListRep : public MemTableRep {
    private:
     // if list_ is nullptr, we should NEVER call any methods on iter_
     // if list_ is nullptr, this Iterator is not Valid()
-    Bucket* list_;
-    Bucket::Iterator iter_;
+    List* list_;
+    typename List::Iterator iter_;
     // here we track if we own list_. If we own it, we are also
     // responsible for it's cleaning. This is a poor man's std::shared_ptr
     bool own_list_;
@@ -170,17 +176,17 @@ class HashSkipListRep : public MemTableRep {
     std::string tmp_;  // For passing to EncodeKey
   };
 
-  class DynamicIterator : public HashSkipListRep::Iterator {
+  class DynamicIterator : public HashSkipListRep::Iterator<Bucket> {
    public:
     explicit DynamicIterator(const HashSkipListRep& memtable_rep)
-        : HashSkipListRep::Iterator(nullptr, false),
+        : HashSkipListRep::Iterator<Bucket>(nullptr, false),
           memtable_rep_(memtable_rep) {}
 
     // Advance to the first entry with a key >= target
     void Seek(const Slice& k, const char* memtable_key) override {
       auto transformed = memtable_rep_.transform_->Transform(ExtractUserKey(k));
       Reset(memtable_rep_.GetBucket(transformed));
-      HashSkipListRep::Iterator::Seek(k, memtable_key);
+      HashSkipListRep::Iterator<Bucket>::Seek(k, memtable_key);
     }
 
     // Position at the first entry in collection.
@@ -233,36 +239,37 @@ HashSkipListRep::HashSkipListRep(const MemTableRep::KeyComparator& compare,
                                  size_t bucket_size, int32_t skiplist_height,
                                  int32_t skiplist_branching_factor)
     : MemTableRep(allocator),
-      bucket_size_(bucket_size),
       skiplist_height_(skiplist_height),
       skiplist_branching_factor_(skiplist_branching_factor),
       transform_(transform),
       compare_(compare),
-      allocator_(allocator) {
-  auto mem =
-      allocator->AllocateAligned(sizeof(std::atomic<void*>) * bucket_size);
-  buckets_ = new (mem) std::atomic<Bucket*>[bucket_size];
-
-  for (size_t i = 0; i < bucket_size_; ++i) {
-    buckets_[i].store(nullptr, std::memory_order_relaxed);
-  }
-}
+      allocator_(allocator),
+      key_allocator_(compare, allocator, skiplist_height,
+                     skiplist_branching_factor),
+      buckets_(allocator, bucket_size) {}
 
 HashSkipListRep::~HashSkipListRep() = default;
 
 HashSkipListRep::Bucket* HashSkipListRep::GetInitializedBucket(
     const Slice& transformed) {
-  size_t hash = GetHash(transformed);
-  auto bucket = GetBucket(hash);
+  auto bucket = GetBucket(transformed);
   if (bucket == nullptr) {
+    // Of concurrent inserts of the first keys of a transform, only the bucket
+    // added to buckets_ first is kept
     auto addr = allocator_->AllocateAligned(sizeof(Bucket));
     bucket = new (addr) Bucket(compare_, allocator_, skiplist_height_,
                                skiplist_branching_factor_);
-    buckets_[hash].store(bucket, std::memory_order_release);
+    bucket = static_cast<Bucket*>(buckets_.FindOrInsert(transformed, bucket)
+                                      ->load(std::memory_order_acquire));
   }
   return bucket;
 }
 
+KeyHandle HashSkipListRep::Allocate(const size_t len, char** buf) {
+  *buf = key_allocator_.AllocateKey(len);
+  return static_cast<KeyHandle>(*buf);
+}
+
 void HashSkipListRep::Insert(KeyHandle handle) {
   auto* key = static_cast<char*>(handle);
   assert(!Contains(key));
@@ -271,6 +278,13 @@ void HashSkipListRep::Insert(KeyHandle handle) {
   bucket->Insert(key);
 }
 
+void HashSkipListRep::InsertConcurrently(KeyHandle handle) {
+  auto* key = static_cast<char*>(handle);
+  auto transformed = transform_->Transform(UserKey(key));
+  auto bucket = GetInitializedBucket(transformed);
+  bucket->InsertConcurrently(key);
+}
+
 bool HashSkipListRep::Contains(const char* key) const {
   auto transformed = transform_->Transform(UserKey(key));
   auto bucket = GetBucket(transformed);
@@ -298,21 +312,19 @@ void HashSkipListRep::Get(const LookupKey& k, void* callback_args,
 MemTableRep::Iterator* HashSkipListRep::GetIterator(Arena* arena) {
   // allocate a new arena of similar size to the one currently in use
   Arena* new_arena = new Arena(allocator_->BlockSize());
-  auto list = new Bucket(compare_, new_arena);
-  for (size_t i = 0; i < bucket_size_; ++i) {
-    auto bucket = GetBucket(i);
-    if (bucket != nullptr) {
-      Bucket::Iterator itr(bucket);
-      for (itr.SeekToFirst(); itr.Valid(); itr.Next()) {
-        list->Insert(itr.key());
-      }
+  auto list = new FullList(compare_, new_arena);
+  buckets_.ForEach([&](std::atomic<void*>* slot) {
+    Bucket::Iterator itr(
+        static_cast<Bucket*>(slot->load(std::memory_order_acquire)));
+    for (itr.SeekToFirst(); itr.Valid(); itr.Next()) {
+      list->Insert(itr.key());
     }
-  }
+  });
   if (arena == nullptr) {
-    return new Iterator(list, true, new_arena);
+    return new Iterator<FullList>(list, true, new_arena);
   } else {
-    auto mem = arena->AllocateAligned(sizeof(Iterator));
-    return new (mem) Iterator(list, true, new_arena);
+    auto mem = arena->AllocateAligned(sizeof(Iterator<FullList>));
+    return new (mem) Iterator<FullList>(list, true, new_arena);
   }
 }
 
@@ -364,6 +376,8 @@ class HashSkipListRepFactory : public MemTableRepFactory {
   static const char* kClassName() { return "HashSkipListRepFactory"; }
   static const char* kNickName() { return "prefix_hash"; }
 
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
   virtual const char* Name() const override { return kClassName(); }
   virtual const char* NickName() const override { return kNickName(); }
 
@@ -57,7 +57,13 @@
 
 namespace ROCKSDB_NAMESPACE {
 
-template <class Comparator>
+// If kUseKeyHead is true, every node also stores the first 8 bytes of its
+// key as an integer (see Comparator::key_head()) just before the key, and
+// searches compare those first.  Only the keys whose heads tie are handed to
+// the comparator, which saves decoding and memcmp on most steps of a search
+// at the cost of 8 bytes per entry.  This requires that the comparator order
+// keys by their heads first, i.e. a.head < b.head implies a < b.
+template <class Comparator, bool kUseKeyHead = false>
 class InlineSkipList {
  private:
   struct Node;
@@ -231,10 +237,26 @@ class InlineSkipList {
     return (compare_(a, b) < 0);
   }
 
+  // Returns the head of key, or 0 if kUseKeyHead is false.
+  uint64_t KeyHead(const DecodedKey& key) const {
+    if constexpr (kUseKeyHead) {
+      return compare_.key_head(key);
+    } else {
+      (void)key;
+      return 0;
+    }
+  }
+
+  // Compares the key stored in "n" with key, whose head is key_head.
+  int CompareNode(Node* n, const DecodedKey& key, uint64_t key_head) const;
+
+  // Compares the keys stored in "a" and "b".
+  int CompareNodes(Node* a, Node* b) const;
+
   // Return true if key is greater than the data stored in "n".  Null n
   // is considered infinite.  n should not be head_.
   bool KeyIsAfterNode(const char* key, Node* n) const;
-  bool KeyIsAfterNode(const DecodedKey& key, Node* n) const;
+  bool KeyIsAfterNode(const DecodedKey& key, uint64_t key_head, Node* n) const;
 
   // Returns the earliest node with a key >= key.
   // Return nullptr if there is no such node.
@@ -267,19 +289,20 @@ class InlineSkipList {
   // a node that is after the key.  after should be nullptr if a good after
   // node isn't conveniently available.
   template <bool prefetch_before>
-  void FindSpliceForLevel(const DecodedKey& key, Node* before, Node* after,
-                          int level, Node** out_prev, Node** out_next);
+  void FindSpliceForLevel(const DecodedKey& key, uint64_t key_head,
+                          Node* before, Node* after, int level,
+                          Node** out_prev, Node** out_next);
 
   // Recomputes Splice levels from highest_level (inclusive) down to
   // lowest_level (inclusive).
-  void RecomputeSpliceLevels(const DecodedKey& key, Splice* splice,
-                             int recompute_level);
+  void RecomputeSpliceLevels(const DecodedKey& key, uint64_t key_head,
+                             Splice* splice, int recompute_level);
 };
 
 // Implementation details follow
 
-template <class Comparator>
-struct InlineSkipList<Comparator>::Splice {
+template <class Comparator, bool kUseKeyHead>
+struct InlineSkipList<Comparator, kUseKeyHead>::Splice {
   // The invariant of a Splice is that prev_[i+1].key <= prev_[i].key <
   // next_[i].key <= next_[i+1].key for all i.  That means that if a
   // key is bracketed by prev_[i] and next_[i] then it is bracketed by
@@ -295,9 +318,10 @@ struct InlineSkipList<Comparator>::Splice {
 // a traditional C++ struct.  The key is stored in the bytes immediately
 // after the struct, and the next_ pointers for nodes with height > 1 are
 // stored immediately _before_ the struct.  This avoids the need to include
-// any pointer or sizing data, which reduces per-node memory overheads.
-template <class Comparator>
-struct InlineSkipList<Comparator>::Node {
+// any pointer or sizing data, which reduces per-node memory overheads.  With
+// kUseKeyHead, the key head sits between the struct and the key.
+template <class Comparator, bool kUseKeyHead>
+struct InlineSkipList<Comparator, kUseKeyHead>::Node {
   // Stores the height of the node in the memory location normally used for
   // next_[0].  This is used for passing data from AllocateKey to Insert.
   void StashHeight(const int height) {
@@ -313,7 +337,29 @@ struct InlineSkipList<Comparator>::Node {
     return rv;
   }
 
-  const char* Key() const { return reinterpret_cast<const char*>(&next_[1]); }
+  static constexpr size_t kKeyOffset = kUseKeyHead ? sizeof(uint64_t) : 0;
+
+  // Returns the node whose key starts at key.
+  static Node* FromKey(const char* key) {
+    return reinterpret_cast<Node*>(const_cast<char*>(key) - kKeyOffset) - 1;
+  }
+
+  const char* Key() const {
+    return reinterpret_cast<const char*>(&next_[1]) + kKeyOffset;
+  }
+
+  // Only used if kUseKeyHead is true.  Like the key, the head is immutable
+  // once the node is linked into the list.
+  uint64_t KeyHead() const {
+    uint64_t head;
+    memcpy(&head, &next_[1], sizeof(head));
+    return head;
+  }
+
+  void SetKeyHead(uint64_t head) {
+    static_assert(kUseKeyHead, "node has no room for a key head");
+    memcpy(static_cast<void*>(&next_[1]), &head, sizeof(head));
+  }
 
   // Accessors/mutators for links.  Wrapped in methods so we can add
   // the appropriate barriers as necessary, and perform the necessary
@@ -362,38 +408,39 @@ struct InlineSkipList<Comparator>::Node {
   std::atomic<Node*> next_[1];
 };
 
-template <class Comparator>
-inline InlineSkipList<Comparator>::Iterator::Iterator(
+template <class Comparator, bool kUseKeyHead>
+inline InlineSkipList<Comparator, kUseKeyHead>::Iterator::Iterator(
     const InlineSkipList* list) {
   SetList(list);
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::SetList(
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::SetList(
     const InlineSkipList* list) {
   list_ = list;
   node_ = nullptr;
 }
 
-template <class Comparator>
-inline bool InlineSkipList<Comparator>::Iterator::Valid() const {
+template <class Comparator, bool kUseKeyHead>
+inline bool InlineSkipList<Comparator, kUseKeyHead>::Iterator::Valid() const {
   return node_ != nullptr;
 }
 
-template <class Comparator>
-inline const char* InlineSkipList<Comparator>::Iterator::key() const {
+template <class Comparator, bool kUseKeyHead>
+inline const char* InlineSkipList<Comparator, kUseKeyHead>::Iterator::key()
+    const {
   assert(Valid());
   return node_->Key();
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::Next() {
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::Next() {
   assert(Valid());
   node_ = node_->Next(0);
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::Prev() {
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::Prev() {
   // Instead of using explicit "prev" links, we just search for the
   // last node that falls before key.
   assert(Valid());
@@ -403,13 +450,14 @@ inline void InlineSkipList<Comparator>::Iterator::Prev() {
   }
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::Seek(const char* target) {
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::Seek(
+    const char* target) {
   node_ = list_->FindGreaterOrEqual(target);
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::SeekForPrev(
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::SeekForPrev(
     const char* target) {
   Seek(target);
   if (!Valid()) {
@@ -420,26 +468,26 @@ inline void InlineSkipList<Comparator>::Iterator::SeekForPrev(
   }
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::RandomSeek() {
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::RandomSeek() {
   node_ = list_->FindRandomEntry();
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::SeekToFirst() {
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::SeekToFirst() {
   node_ = list_->head_->Next(0);
 }
 
-template <class Comparator>
-inline void InlineSkipList<Comparator>::Iterator::SeekToLast() {
+template <class Comparator, bool kUseKeyHead>
+inline void InlineSkipList<Comparator, kUseKeyHead>::Iterator::SeekToLast() {
   node_ = list_->FindLast();
   if (node_ == list_->head_) {
     node_ = nullptr;
   }
 }
 
-template <class Comparator>
-int InlineSkipList<Comparator>::RandomHeight() {
+template <class Comparator, bool kUseKeyHead>
+int InlineSkipList<Comparator, kUseKeyHead>::RandomHeight() {
   auto rnd = Random::GetTLSInstance();
 
   // Increase height with probability 1 in kBranching
@@ -454,25 +502,53 @@ int InlineSkipList<Comparator>::RandomHeight() {
   return height;
 }
 
-template <class Comparator>
-bool InlineSkipList<Comparator>::KeyIsAfterNode(const char* key,
-                                                Node* n) const {
+template <class Comparator, bool kUseKeyHead>
+bool InlineSkipList<Comparator, kUseKeyHead>::KeyIsAfterNode(const char* key,
+                                                             Node* n) const {
   // nullptr n is considered infinite
   assert(n != head_);
   return (n != nullptr) && (compare_(n->Key(), key) < 0);
 }
 
-template <class Comparator>
-bool InlineSkipList<Comparator>::KeyIsAfterNode(const DecodedKey& key,
-                                                Node* n) const {
+template <class Comparator, bool kUseKeyHead>
+int InlineSkipList<Comparator, kUseKeyHead>::CompareNode(
+    Node* n, const DecodedKey& key, uint64_t key_head) const {
+  if constexpr (kUseKeyHead) {
+    const uint64_t node_head = n->KeyHead();
+    if (node_head != key_head) {
+      return node_head < key_head ? -1 : 1;
+    }
+  } else {
+    (void)key_head;
+  }
+  return compare_(n->Key(), key);
+}
+
+template <class Comparator, bool kUseKeyHead>
+int InlineSkipList<Comparator, kUseKeyHead>::CompareNodes(Node* a,
+                                                          Node* b) const {
+  if constexpr (kUseKeyHead) {
+    const uint64_t a_head = a->KeyHead();
+    const uint64_t b_head = b->KeyHead();
+    if (a_head != b_head) {
+      return a_head < b_head ? -1 : 1;
+    }
+  }
+  return compare_(a->Key(), b->Key());
+}
+
+template <class Comparator, bool kUseKeyHead>
+bool InlineSkipList<Comparator, kUseKeyHead>::KeyIsAfterNode(
+    const DecodedKey& key, uint64_t key_head, Node* n) const {
   // nullptr n is considered infinite
   assert(n != head_);
-  return (n != nullptr) && (compare_(n->Key(), key) < 0);
+  return (n != nullptr) && (CompareNode(n, key, key_head) < 0);
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Node*
-InlineSkipList<Comparator>::FindGreaterOrEqual(const char* key) const {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Node*
+InlineSkipList<Comparator, kUseKeyHead>::FindGreaterOrEqual(
+    const char* key) const {
   // Note: It looks like we could reduce duplication by implementing
   // this function as FindLessThan(key)->Next(0), but we wouldn't be able
   // to exit early on equality and the result wouldn't even be correct.
@@ -482,6 +558,7 @@ InlineSkipList<Comparator>::FindGreaterOrEqual(const char* key) const {
   int level = GetMaxHeight() - 1;
   Node* last_bigger = nullptr;
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_head = KeyHead(key_decoded);
   while (true) {
     Node* next = x->Next(level);
     if (next != nullptr) {
@@ -490,10 +567,10 @@ InlineSkipList<Comparator>::FindGreaterOrEqual(const char* key) const {
     // Make sure the lists are sorted
     assert(x == head_ || next == nullptr || KeyIsAfterNode(next->Key(), x));
     // Make sure we haven't overshot during our search
-    assert(x == head_ || KeyIsAfterNode(key_decoded, x));
+    assert(x == head_ || KeyIsAfterNode(key_decoded, key_head, x));
     int cmp = (next == nullptr || next == last_bigger)
                   ? 1
-                  : compare_(next->Key(), key_decoded);
+                  : CompareNode(next, key_decoded, key_head);
     if (cmp == 0 || (cmp > 0 && level == 0)) {
       return next;
     } else if (cmp < 0) {
@@ -507,23 +584,25 @@ InlineSkipList<Comparator>::FindGreaterOrEqual(const char* key) const {
   }
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Node*
-InlineSkipList<Comparator>::FindLessThan(const char* key, Node** prev) const {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Node*
+InlineSkipList<Comparator, kUseKeyHead>::FindLessThan(const char* key,
+                                                      Node** prev) const {
   return FindLessThan(key, prev, head_, GetMaxHeight(), 0);
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Node*
-InlineSkipList<Comparator>::FindLessThan(const char* key, Node** prev,
-                                         Node* root, int top_level,
-                                         int bottom_level) const {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Node*
+InlineSkipList<Comparator, kUseKeyHead>::FindLessThan(
+    const char* key, Node** prev, Node* root, int top_level,
+    int bottom_level) const {
   assert(top_level > bottom_level);
   int level = top_level - 1;
   Node* x = root;
   // KeyIsAfter(key, last_not_after) is definitely false
   Node* last_not_after = nullptr;
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_head = KeyHead(key_decoded);
   while (true) {
     assert(x != nullptr);
     Node* next = x->Next(level);
@@ -531,8 +610,8 @@ InlineSkipList<Comparator>::FindLessThan(const char* key, Node** prev,
       PREFETCH(next->Next(level), 0, 1);
     }
     assert(x == head_ || next == nullptr || KeyIsAfterNode(next->Key(), x));
-    assert(x == head_ || KeyIsAfterNode(key_decoded, x));
-    if (next != last_not_after && KeyIsAfterNode(key_decoded, next)) {
+    assert(x == head_ || KeyIsAfterNode(key_decoded, key_head, x));
+    if (next != last_not_after && KeyIsAfterNode(key_decoded, key_head, next)) {
       // Keep searching in this list
       assert(next != nullptr);
       x = next;
@@ -551,9 +630,9 @@ InlineSkipList<Comparator>::FindLessThan(const char* key, Node** prev,
   }
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Node*
-InlineSkipList<Comparator>::FindLast() const {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Node*
+InlineSkipList<Comparator, kUseKeyHead>::FindLast() const {
   Node* x = head_;
   int level = GetMaxHeight() - 1;
   while (true) {
@@ -571,9 +650,9 @@ InlineSkipList<Comparator>::FindLast() const {
   }
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Node*
-InlineSkipList<Comparator>::FindRandomEntry() const {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Node*
+InlineSkipList<Comparator, kUseKeyHead>::FindRandomEntry() const {
   // TODO(bjlemaire): consider adding PREFETCH calls.
   Node *x = head_, *scan_node = nullptr, *limit_node = nullptr;
 
@@ -613,20 +692,22 @@ InlineSkipList<Comparator>::FindRandomEntry() const {
   return x == head_ && head_ != nullptr ? head_->Next(0) : x;
 }
 
-template <class Comparator>
-uint64_t InlineSkipList<Comparator>::EstimateCount(const char* key) const {
+template <class Comparator, bool kUseKeyHead>
+uint64_t InlineSkipList<Comparator, kUseKeyHead>::EstimateCount(
+    const char* key) const {
   uint64_t count = 0;
 
   Node* x = head_;
   int level = GetMaxHeight() - 1;
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_head = KeyHead(key_decoded);
   while (true) {
-    assert(x == head_ || compare_(x->Key(), key_decoded) < 0);
+    assert(x == head_ || CompareNode(x, key_decoded, key_head) < 0);
     Node* next = x->Next(level);
     if (next != nullptr) {
       PREFETCH(next->Next(level), 0, 1);
     }
-    if (next == nullptr || compare_(next->Key(), key_decoded) >= 0) {
+    if (next == nullptr || CompareNode(next, key_decoded, key_head) >= 0) {
       if (level == 0) {
         return count;
       } else {
@@ -641,11 +722,10 @@ uint64_t InlineSkipList<Comparator>::EstimateCount(const char* key) const {
   }
 }
 
-template <class Comparator>
-InlineSkipList<Comparator>::InlineSkipList(const Comparator cmp,
-                                           Allocator* allocator,
-                                           int32_t max_height,
-                                           int32_t branching_factor)
+template <class Comparator, bool kUseKeyHead>
+InlineSkipList<Comparator, kUseKeyHead>::InlineSkipList(
+    const Comparator cmp, Allocator* allocator, int32_t max_height,
+    int32_t branching_factor)
     : kMaxHeight_(static_cast<uint16_t>(max_height)),
       kBranching_(static_cast<uint16_t>(branching_factor)),
       kScaledInverseBranching_((Random::kMaxNext + 1) / kBranching_),
@@ -664,22 +744,24 @@ InlineSkipList<Comparator>::InlineSkipList(const Comparator cmp,
   }
 }
 
-template <class Comparator>
-char* InlineSkipList<Comparator>::AllocateKey(size_t key_size) {
+template <class Comparator, bool kUseKeyHead>
+char* InlineSkipList<Comparator, kUseKeyHead>::AllocateKey(size_t key_size) {
   return const_cast<char*>(AllocateNode(key_size, RandomHeight())->Key());
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Node*
-InlineSkipList<Comparator>::AllocateNode(size_t key_size, int height) {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Node*
+InlineSkipList<Comparator, kUseKeyHead>::AllocateNode(size_t key_size,
+                                                      int height) {
   auto prefix = sizeof(std::atomic<Node*>) * (height - 1);
 
   // prefix is space for the height - 1 pointers that we store before
   // the Node instance (next_[-(height - 1) .. -1]).  Node starts at
   // raw + prefix, and holds the bottom-mode (level 0) skip list pointer
   // next_[0].  key_size is the bytes for the key, which comes just after
-  // the Node.
-  char* raw = allocator_->AllocateAligned(prefix + sizeof(Node) + key_size);
+  // the Node (and its key head, if any).
+  char* raw = allocator_->AllocateAligned(prefix + sizeof(Node) +
+                                          Node::kKeyOffset + key_size);
   Node* x = reinterpret_cast<Node*>(raw + prefix);
 
   // Once we've linked the node into the skip list we don't actually need
@@ -693,9 +775,9 @@ InlineSkipList<Comparator>::AllocateNode(size_t key_size, int height) {
   return x;
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Splice*
-InlineSkipList<Comparator>::AllocateSplice() {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Splice*
+InlineSkipList<Comparator, kUseKeyHead>::AllocateSplice() {
   // size of prev_ and next_
   size_t array_size = sizeof(Node*) * (kMaxHeight_ + 1);
   char* raw = allocator_->AllocateAligned(sizeof(Splice) + array_size * 2);
@@ -706,9 +788,9 @@ InlineSkipList<Comparator>::AllocateSplice() {
   return splice;
 }
 
-template <class Comparator>
-typename InlineSkipList<Comparator>::Splice*
-InlineSkipList<Comparator>::AllocateSpliceOnHeap() {
+template <class Comparator, bool kUseKeyHead>
+typename InlineSkipList<Comparator, kUseKeyHead>::Splice*
+InlineSkipList<Comparator, kUseKeyHead>::AllocateSpliceOnHeap() {
   size_t array_size = sizeof(Node*) * (kMaxHeight_ + 1);
   char* raw = new char[sizeof(Splice) + array_size * 2];
   Splice* splice = reinterpret_cast<Splice*>(raw);
@@ -718,13 +800,14 @@ InlineSkipList<Comparator>::AllocateSpliceOnHeap() {
   return splice;
 }
 
-template <class Comparator>
-bool InlineSkipList<Comparator>::Insert(const char* key) {
+template <class Comparator, bool kUseKeyHead>
+bool InlineSkipList<Comparator, kUseKeyHead>::Insert(const char* key) {
   return Insert<false>(key, seq_splice_, false);
 }
 
-template <class Comparator>
-bool InlineSkipList<Comparator>::InsertConcurrently(const char* key) {
+template <class Comparator, bool kUseKeyHead>
+bool InlineSkipList<Comparator, kUseKeyHead>::InsertConcurrently(
+    const char* key) {
   Node* prev[kMaxPossibleHeight];
   Node* next[kMaxPossibleHeight];
   Splice splice;
@@ -733,8 +816,9 @@ bool InlineSkipList<Comparator>::InsertConcurrently(const char* key) {
   return Insert<true>(key, &splice, false);
 }
 
-template <class Comparator>
-bool InlineSkipList<Comparator>::InsertWithHint(const char* key, void** hint) {
+template <class Comparator, bool kUseKeyHead>
+bool InlineSkipList<Comparator, kUseKeyHead>::InsertWithHint(const char* key,
+                                                             void** hint) {
   assert(hint != nullptr);
   Splice* splice = reinterpret_cast<Splice*>(*hint);
   if (splice == nullptr) {
@@ -744,9 +828,9 @@ bool InlineSkipList<Comparator>::InsertWithHint(const char* key, void** hint) {
   return Insert<false>(key, splice, true);
 }
 
-template <class Comparator>
-bool InlineSkipList<Comparator>::InsertWithHintConcurrently(const char* key,
-                                                            void** hint) {
+template <class Comparator, bool kUseKeyHead>
+bool InlineSkipList<Comparator, kUseKeyHead>::InsertWithHintConcurrently(
+    const char* key, void** hint) {
   assert(hint != nullptr);
   Splice* splice = reinterpret_cast<Splice*>(*hint);
   if (splice == nullptr) {
@@ -756,12 +840,11 @@ bool InlineSkipList<Comparator>::InsertWithHintConcurrently(const char* key,
   return Insert<true>(key, splice, true);
 }
 
-template <class Comparator>
+template <class Comparator, bool kUseKeyHead>
 template <bool prefetch_before>
-void InlineSkipList<Comparator>::FindSpliceForLevel(const DecodedKey& key,
-                                                    Node* before, Node* after,
-                                                    int level, Node** out_prev,
-                                                    Node** out_next) {
+void InlineSkipList<Comparator, kUseKeyHead>::FindSpliceForLevel(
+    const DecodedKey& key, uint64_t key_head, Node* before, Node* after,
+    int level, Node** out_prev, Node** out_next) {
   while (true) {
     Node* next = before->Next(level);
     if (next != nullptr) {
@@ -774,8 +857,8 @@ void InlineSkipList<Comparator>::FindSpliceForLevel(const DecodedKey& key,
     }
     assert(before == head_ || next == nullptr ||
            KeyIsAfterNode(next->Key(), before));
-    assert(before == head_ || KeyIsAfterNode(key, before));
-    if (next == after || !KeyIsAfterNode(key, next)) {
+    assert(before == head_ || KeyIsAfterNode(key, key_head, before));
+    if (next == after || !KeyIsAfterNode(key, key_head, next)) {
       // found it
       *out_prev = before;
       *out_next = next;
@@ -785,24 +868,29 @@ void InlineSkipList<Comparator>::FindSpliceForLevel(const DecodedKey& key,
   }
 }
 
-template <class Comparator>
-void InlineSkipList<Comparator>::RecomputeSpliceLevels(const DecodedKey& key,
-                                                       Splice* splice,
-                                                       int recompute_level) {
+template <class Comparator, bool kUseKeyHead>
+void InlineSkipList<Comparator, kUseKeyHead>::RecomputeSpliceLevels(
+    const DecodedKey& key, uint64_t key_head, Splice* splice,
+    int recompute_level) {
   assert(recompute_level > 0);
   assert(recompute_level <= splice->height_);
   for (int i = recompute_level - 1; i >= 0; --i) {
-    FindSpliceForLevel<true>(key, splice->prev_[i + 1], splice->next_[i + 1], i,
-                             &splice->prev_[i], &splice->next_[i]);
+    FindSpliceForLevel<true>(key, key_head, splice->prev_[i + 1],
+                             splice->next_[i + 1], i, &splice->prev_[i],
+                             &splice->next_[i]);
   }
 }
 
-template <class Comparator>
+template <class Comparator, bool kUseKeyHead>
 template <bool UseCAS>
-bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
-                                        bool allow_partial_splice_fix) {
-  Node* x = reinterpret_cast<Node*>(const_cast<char*>(key)) - 1;
+bool InlineSkipList<Comparator, kUseKeyHead>::Insert(
+    const char* key, Splice* splice, bool allow_partial_splice_fix) {
+  Node* x = Node::FromKey(key);
   const DecodedKey key_decoded = compare_.decode_key(key);
+  const uint64_t key_head = KeyHead(key_decoded);
+  if constexpr (kUseKeyHead) {
+    x->SetKeyHead(key_head);
+  }
   int height = x->UnstashHeight();
   assert(height >= 1 && height <= kMaxHeight_);
 
@@ -870,7 +958,7 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
         // our chances of success.
         ++recompute_height;
       } else if (splice->prev_[recompute_height] != head_ &&
-                 !KeyIsAfterNode(key_decoded,
+                 !KeyIsAfterNode(key_decoded, key_head,
                                  splice->prev_[recompute_height])) {
         // key is from before splice
         if (allow_partial_splice_fix) {
@@ -883,7 +971,8 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
           // we're pessimistic, recompute everything
           recompute_height = max_height;
         }
-      } else if (KeyIsAfterNode(key_decoded, splice->next_[recompute_height])) {
+      } else if (KeyIsAfterNode(key_decoded, key_head,
+                                splice->next_[recompute_height])) {
         // key is from after splice
         if (allow_partial_splice_fix) {
           Node* bad = splice->next_[recompute_height];
@@ -901,7 +990,7 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
   }
   assert(recompute_height <= max_height);
   if (recompute_height > 0) {
-    RecomputeSpliceLevels(key_decoded, splice, recompute_height);
+    RecomputeSpliceLevels(key_decoded, key_head, splice, recompute_height);
   }
 
   bool splice_is_valid = true;
@@ -910,12 +999,12 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
       while (true) {
         // Checking for duplicate keys on the level 0 is sufficient
         if (UNLIKELY(i == 0 && splice->next_[i] != nullptr &&
-                     compare_(x->Key(), splice->next_[i]->Key()) >= 0)) {
+                     CompareNodes(x, splice->next_[i]) >= 0)) {
           // duplicate key
           return false;
         }
         if (UNLIKELY(i == 0 && splice->prev_[i] != head_ &&
-                     compare_(splice->prev_[i]->Key(), x->Key()) >= 0)) {
+                     CompareNodes(splice->prev_[i], x) >= 0)) {
           // duplicate key
           return false;
         }
@@ -933,8 +1022,9 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
         // search, because it should be unlikely that lots of nodes have
         // been inserted between prev[i] and next[i]. No point in using
         // next[i] as the after hint, because we know it is stale.
-        FindSpliceForLevel<false>(key_decoded, splice->prev_[i], nullptr, i,
-                                  &splice->prev_[i], &splice->next_[i]);
+        FindSpliceForLevel<false>(key_decoded, key_head, splice->prev_[i],
+                                  nullptr, i, &splice->prev_[i],
+                                  &splice->next_[i]);
 
         // Since we've narrowed the bracket for level i, we might have
         // violated the Splice constraint between i and i-1.  Make sure
@@ -948,17 +1038,18 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
     for (int i = 0; i < height; ++i) {
       if (i >= recompute_height &&
           splice->prev_[i]->Next(i) != splice->next_[i]) {
-        FindSpliceForLevel<false>(key_decoded, splice->prev_[i], nullptr, i,
-                                  &splice->prev_[i], &splice->next_[i]);
+        FindSpliceForLevel<false>(key_decoded, key_head, splice->prev_[i],
+                                  nullptr, i, &splice->prev_[i],
+                                  &splice->next_[i]);
       }
       // Checking for duplicate keys on the level 0 is sufficient
       if (UNLIKELY(i == 0 && splice->next_[i] != nullptr &&
-                   compare_(x->Key(), splice->next_[i]->Key()) >= 0)) {
+                   CompareNodes(x, splice->next_[i]) >= 0)) {
         // duplicate key
         return false;
       }
       if (UNLIKELY(i == 0 && splice->prev_[i] != head_ &&
-                   compare_(splice->prev_[i]->Key(), x->Key()) >= 0)) {
+                   CompareNodes(splice->prev_[i], x) >= 0)) {
         // duplicate key
         return false;
       }
@@ -997,8 +1088,8 @@ bool InlineSkipList<Comparator>::Insert(const char* key, Splice* splice,
   return true;
 }
 
-template <class Comparator>
-bool InlineSkipList<Comparator>::Contains(const char* key) const {
+template <class Comparator, bool kUseKeyHead>
+bool InlineSkipList<Comparator, kUseKeyHead>::Contains(const char* key) const {
   Node* x = FindGreaterOrEqual(key);
   if (x != nullptr && Equal(key, x->Key())) {
     return true;
@@ -1007,8 +1098,8 @@ bool InlineSkipList<Comparator>::Contains(const char* key) const {
   }
 }
 
-template <class Comparator>
-void InlineSkipList<Comparator>::TEST_Validate() const {
+template <class Comparator, bool kUseKeyHead>
+void InlineSkipList<Comparator, kUseKeyHead>::TEST_Validate() const {
   // Interate over all levels at the same time, and verify nodes appear in
   // the right order, and nodes appear in upper level also appear in lower
   // levels.
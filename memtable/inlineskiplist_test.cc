@@ -62,6 +62,14 @@ struct TestComparator {
 
 using TestInlineSkipList = InlineSkipList<TestComparator>;
 
+// Uses the high bits of a key as its head, so that keys that only differ in
+// their low byte tie on the head and have to be resolved by the comparator.
+struct KeyHeadTestComparator : public TestComparator {
+  static uint64_t key_head(const DecodedType key) { return key >> 8; }
+};
+
+using KeyHeadTestInlineSkipList = InlineSkipList<KeyHeadTestComparator, true>;
+
 class InlineSkipTest : public testing::Test {
  public:
   void Insert(TestInlineSkipList* list, Key key) {
@@ -310,6 +318,79 @@ TEST_F(InlineSkipTest, InsertWithHint_CompatibleWithInsertWithoutHint) {
   Validate(&list);
 }
 
+TEST_F(InlineSkipTest, KeyHead) {
+  const int N = 20000;
+  const Key R = 50000;
+  Random rnd(301);
+  std::set<Key> keys;
+  ConcurrentArena arena;
+  KeyHeadTestComparator cmp;
+  KeyHeadTestInlineSkipList list(cmp, &arena);
+  void* hint = nullptr;
+  for (int i = 0; i < N; i++) {
+    Key key = rnd.Next() % R;
+    char* buf = list.AllocateKey(sizeof(Key));
+    memcpy(buf, &key, sizeof(Key));
+    bool inserted;
+    // Exercise the plain, hinted and concurrent insert paths, all of which
+    // must detect duplicates through the key heads.
+    switch (i % 3) {
+      case 0:
+        inserted = list.Insert(buf);
+        break;
+      case 1:
+        inserted = list.InsertWithHint(buf, &hint);
+        break;
+      default:
+        inserted = list.InsertConcurrently(buf);
+        break;
+    }
+    ASSERT_EQ(keys.insert(key).second, inserted);
+  }
+  list.TEST_Validate();
+
+  for (Key i = 0; i < R; i++) {
+    ASSERT_EQ(keys.count(i) == 1, list.Contains(Encode(&i)));
+  }
+
+  KeyHeadTestInlineSkipList::Iterator iter(&list);
+  iter.SeekToFirst();
+  for (Key key : keys) {
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(key, Decode(iter.key()));
+    iter.Next();
+  }
+  ASSERT_FALSE(iter.Valid());
+
+  for (Key i = 0; i < R; i += 13) {
+    iter.Seek(Encode(&i));
+    auto model_iter = keys.lower_bound(i);
+    if (model_iter == keys.end()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*model_iter, Decode(iter.key()));
+    }
+
+    iter.SeekForPrev(Encode(&i));
+    model_iter = keys.upper_bound(i);
+    if (model_iter == keys.begin()) {
+      ASSERT_FALSE(iter.Valid());
+    } else {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*--model_iter, Decode(iter.key()));
+      // Prev() searches for the node before the current one
+      iter.Prev();
+      if (model_iter == keys.begin()) {
+        ASSERT_FALSE(iter.Valid());
+      } else {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(*--model_iter, Decode(iter.key()));
+      }
+    }
+  }
+}
+
 #if !defined(ROCKSDB_VALGRIND_RUN) || defined(ROCKSDB_FULL_VALGRIND_RUN)
 // We want to make sure that with a single writer and multiple
 // concurrent readers (with no synchronization other than when a
@@ -61,6 +61,7 @@ DEFINE_string(memtablerep, "skiplist",
               "  more details. Options:\n"
               "\tskiplist            -- backed by a skiplist\n"
               "\tvector              -- backed by an std::vector\n"
+              "\tbtree               -- backed by a B+-tree\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
               "\tcuckoo              -- backed by a cuckoo hash table");
@@ -581,6 +582,8 @@ int main(int argc, char** argv) {
     factory.reset(new ROCKSDB_NAMESPACE::SkipListFactory);
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new ROCKSDB_NAMESPACE::VectorRepFactory);
+  } else if (FLAGS_memtablerep == "btree") {
+    factory.reset(new ROCKSDB_NAMESPACE::BTreeRepFactory);
   } else if (FLAGS_memtablerep == "hashskiplist" ||
              FLAGS_memtablerep == "prefix_hash") {
     factory.reset(ROCKSDB_NAMESPACE::NewHashSkipListRepFactory(
@@ -10,29 +10,144 @@
 #include "memtable/doubly_skiplist.h"
 #include "memtable/inlineskiplist.h"
 #include "rocksdb/utilities/options_type.h"
+#include "util/hash.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace {
 
+// InlineSkipList has a defaulted second parameter, so spell out both
+// variants for SkipListRep's single-parameter template template argument.
+template <class Comparator>
+using PlainInlineSkipList = InlineSkipList<Comparator, false>;
+template <class Comparator>
+using KeyHeadInlineSkipList = InlineSkipList<Comparator, true>;
+
+// A lock-free hash table from each user key in a memtable to its newest
+// entry, which lets point lookups skip the skip list search. It never
+// shrinks and all of its memory, the bucket array up front and 16 bytes per
+// distinct user key after that, comes from the memtable's allocator.
+class PointLookupIndex {
+ public:
+  // The index is disabled if num_buckets is 0.
+  PointLookupIndex(Allocator* allocator, size_t num_buckets)
+      : allocator_(allocator), num_buckets_(num_buckets), buckets_(nullptr) {
+    if (num_buckets_ > 0) {
+      char* mem = allocator_->AllocateAligned(sizeof(std::atomic<Entry*>) *
+                                              num_buckets_);
+      buckets_ = reinterpret_cast<std::atomic<Entry*>*>(mem);
+      for (size_t i = 0; i < num_buckets_; i++) {
+        new (&buckets_[i]) std::atomic<Entry*>(nullptr);
+      }
+    }
+  }
+
+  bool enabled() const { return buckets_ != nullptr; }
+
+  // Records key, an entry that has just been inserted into the memtable, if
+  // it is newer than the entry recorded for its user key. Thread-safe.
+  void Add(const char* key) {
+    const Slice internal_key = GetLengthPrefixedSlice(key);
+    const Slice user_key = ExtractUserKey(internal_key);
+    const uint64_t seq = ExtractSequence(internal_key);
+    std::atomic<Entry*>& bucket = Bucket(user_key);
+    Entry* new_entry = nullptr;
+    Entry* head = bucket.load(std::memory_order_acquire);
+    while (true) {
+      Entry* entry = FindInChain(head, user_key);
+      if (entry != nullptr) {
+        const char* newest = entry->key.load(std::memory_order_acquire);
+        while (ExtractSequence(GetLengthPrefixedSlice(newest)) < seq &&
+               !entry->key.compare_exchange_weak(newest, key,
+                                                 std::memory_order_release,
+                                                 std::memory_order_acquire)) {
+        }
+        // An entry allocated by a lost race to add the user key is wasted,
+        // which is rare and bounded by the number of concurrent writers.
+        return;
+      }
+      if (new_entry == nullptr) {
+        new_entry = new (allocator_->AllocateAligned(sizeof(Entry))) Entry();
+        new_entry->key.store(key, std::memory_order_relaxed);
+      }
+      new_entry->next.store(head, std::memory_order_relaxed);
+      if (bucket.compare_exchange_strong(head, new_entry,
+                                         std::memory_order_release,
+                                         std::memory_order_acquire)) {
+        return;
+      }
+      // Somebody else won the bucket, maybe with the same user key; recheck.
+    }
+  }
+
+  // Returns the newest entry for user_key, or nullptr if there is none.
+  const char* Find(const Slice& user_key) const {
+    Entry* entry = FindInChain(Bucket(user_key).load(std::memory_order_acquire),
+                               user_key);
+    return entry == nullptr ? nullptr
+                            : entry->key.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Entry {
+    std::atomic<Entry*> next{nullptr};
+    std::atomic<const char*> key{nullptr};
+  };
+
+  static uint64_t ExtractSequence(const Slice& internal_key) {
+    return DecodeFixed64(internal_key.data() + internal_key.size() - 8) >> 8;
+  }
+
+  std::atomic<Entry*>& Bucket(const Slice& user_key) const {
+    return buckets_[GetSliceRangedNPHash(user_key, num_buckets_)];
+  }
+
+  static Entry* FindInChain(Entry* entry, const Slice& user_key) {
+    for (; entry != nullptr;
+         entry = entry->next.load(std::memory_order_acquire)) {
+      // The user key of an entry never changes, only its sequence number
+      const char* key = entry->key.load(std::memory_order_acquire);
+      if (ExtractUserKey(GetLengthPrefixedSlice(key)) == user_key) {
+        return entry;
+      }
+    }
+    return nullptr;
+  }
+
+  Allocator* const allocator_;
+  const size_t num_buckets_;
+  std::atomic<Entry*>* buckets_;
+};
+
 template <template <typename U> class SkipList>
 class SkipListRep : public MemTableRep {
   SkipList<const MemTableRep::KeyComparator&> skip_list_;
   const MemTableRep::KeyComparator& cmp_;
   const SliceTransform* transform_;
   const size_t lookahead_;
+  PointLookupIndex point_lookup_index_;
 
   friend class LookaheadIterator;
 
+  // Adds the entry to the point lookup index if it has been inserted.
+  bool MaybeIndex(KeyHandle handle, bool inserted) {
+    if (inserted && point_lookup_index_.enabled()) {
+      point_lookup_index_.Add(static_cast<const char*>(handle));
+    }
+    return inserted;
+  }
+
  public:
   explicit SkipListRep(const MemTableRep::KeyComparator& compare,
                        Allocator* allocator, const SliceTransform* transform,
-                       const size_t lookahead)
+                       const size_t lookahead,
+                       const size_t point_lookup_index_buckets = 0)
       : MemTableRep(allocator),
         skip_list_(compare, allocator),
         cmp_(compare),
         transform_(transform),
-        lookahead_(lookahead) {}
+        lookahead_(lookahead),
+        point_lookup_index_(allocator, point_lookup_index_buckets) {}
 
   KeyHandle Allocate(const size_t len, char** buf) override {
     *buf = skip_list_.AllocateKey(len);
@@ -42,36 +157,41 @@ class SkipListRep : public MemTableRep {
   // Insert key into the list.
   // REQUIRES: nothing that compares equal to key is currently in the list.
   void Insert(KeyHandle handle) override {
-    skip_list_.Insert(static_cast<char*>(handle));
+    MaybeIndex(handle, skip_list_.Insert(static_cast<char*>(handle)));
   }
 
   bool InsertKey(KeyHandle handle) override {
-    return skip_list_.Insert(static_cast<char*>(handle));
+    return MaybeIndex(handle, skip_list_.Insert(static_cast<char*>(handle)));
   }
 
   void InsertWithHint(KeyHandle handle, void** hint) override {
-    skip_list_.InsertWithHint(static_cast<char*>(handle), hint);
+    MaybeIndex(handle,
+               skip_list_.InsertWithHint(static_cast<char*>(handle), hint));
   }
 
   bool InsertKeyWithHint(KeyHandle handle, void** hint) override {
-    return skip_list_.InsertWithHint(static_cast<char*>(handle), hint);
+    return MaybeIndex(
+        handle, skip_list_.InsertWithHint(static_cast<char*>(handle), hint));
   }
 
   void InsertWithHintConcurrently(KeyHandle handle, void** hint) override {
-    skip_list_.InsertWithHintConcurrently(static_cast<char*>(handle), hint);
+    MaybeIndex(handle, skip_list_.InsertWithHintConcurrently(
+                           static_cast<char*>(handle), hint));
   }
 
   bool InsertKeyWithHintConcurrently(KeyHandle handle, void** hint) override {
-    return skip_list_.InsertWithHintConcurrently(static_cast<char*>(handle),
-                                                 hint);
+    return MaybeIndex(handle, skip_list_.InsertWithHintConcurrently(
+                                  static_cast<char*>(handle), hint));
   }
 
   void InsertConcurrently(KeyHandle handle) override {
-    skip_list_.InsertConcurrently(static_cast<char*>(handle));
+    MaybeIndex(handle,
+               skip_list_.InsertConcurrently(static_cast<char*>(handle)));
   }
 
   bool InsertKeyConcurrently(KeyHandle handle) override {
-    return skip_list_.InsertConcurrently(static_cast<char*>(handle));
+    return MaybeIndex(
+        handle, skip_list_.InsertConcurrently(static_cast<char*>(handle)));
   }
 
   // Returns true iff an entry that compares equal to key is in the list.
@@ -88,8 +208,30 @@ class SkipListRep : public MemTableRep {
            bool (*callback_func)(void* arg, const char* entry)) override {
     SkipListRep::Iterator iter(&skip_list_);
     Slice dummy_slice;
-    for (iter.Seek(dummy_slice, k.memtable_key().data());
-         iter.Valid() && callback_func(callback_args, iter.key());
+    const char* start = k.memtable_key().data();
+    if (point_lookup_index_.enabled()) {
+      const char* newest = point_lookup_index_.Find(k.user_key());
+      if (newest == nullptr) {
+        // No version of the user key is in the memtable
+        return;
+      }
+      // Unless the newest version is too new for the lookup sequence number,
+      // it is the entry the search would have found.
+      if (cmp_(newest, k.internal_key()) >= 0) {
+        if (!callback_func(callback_args, newest)) {
+          return;
+        }
+        // Older versions are needed too, e.g. for merge operands
+        iter.Seek(dummy_slice, newest);
+        assert(iter.Valid() && iter.key() == newest);
+        iter.Next();
+        start = nullptr;
+      }
+    }
+    if (start != nullptr) {
+      iter.Seek(dummy_slice, start);
+    }
+    for (; iter.Valid() && callback_func(callback_args, iter.key());
          iter.Next()) {
     }
   }
@@ -347,9 +489,32 @@ static std::unordered_map<std::string, OptionTypeInfo> skiplist_factory_info = {
       OptionTypeFlags::kDontSerialize /*Since it is part of the ID*/}},
 };
 
-SkipListFactory::SkipListFactory(size_t lookahead) : lookahead_(lookahead) {
+static std::unordered_map<std::string, OptionTypeInfo>
+    skiplist_factory_key_head_info = {
+        {"use_key_head",
+         {0, OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    skiplist_factory_point_lookup_index_info = {
+        {"point_lookup_index_buckets",
+         {0, OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+SkipListFactory::SkipListFactory(size_t lookahead, bool use_key_head,
+                                 size_t point_lookup_index_buckets)
+    : lookahead_(lookahead),
+      use_key_head_(use_key_head),
+      point_lookup_index_buckets_(point_lookup_index_buckets) {
   RegisterOptions("SkipListFactoryOptions", &lookahead_,
                   &skiplist_factory_info);
+  RegisterOptions("SkipListFactoryKeyHeadOptions", &use_key_head_,
+                  &skiplist_factory_key_head_info);
+  RegisterOptions("SkipListFactoryPointLookupIndexOptions",
+                  &point_lookup_index_buckets_,
+                  &skiplist_factory_point_lookup_index_info);
 }
 
 std::string SkipListFactory::GetId() const {
@@ -363,8 +528,16 @@ std::string SkipListFactory::GetId() const {
 MemTableRep* SkipListFactory::CreateMemTableRep(
     const MemTableRep::KeyComparator& compare, Allocator* allocator,
     const SliceTransform* transform, Logger* /*logger*/) {
-  return new SkipListRep<InlineSkipList>(compare, allocator, transform,
-                                         lookahead_);
+  // Both the key heads and the index rely on equal user keys being equal
+  // bytes, and on bytewise order for the heads.
+  const bool bytewise = compare.IsBytewiseUserKeyOrder();
+  const size_t index_buckets = bytewise ? point_lookup_index_buckets_ : 0;
+  if (use_key_head_ && bytewise) {
+    return new SkipListRep<KeyHeadInlineSkipList>(
+        compare, allocator, transform, lookahead_, index_buckets);
+  }
+  return new SkipListRep<PlainInlineSkipList>(compare, allocator, transform,
+                                              lookahead_, index_buckets);
 }
 
 MemTableRep* DoublySkipListFactory::CreateMemTableRep(
@@ -0,0 +1,206 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memtable/split_ordered_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/hash.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Split-order keys: a prefix with hash h sorts by the reversed bits of h with
+// the highest bit set, after the dummy node of its bucket h mod 2^i, which
+// sorts by the reversed bits of the bucket number, for any i
+inline uint64_t PrefixKey(uint64_t hash) {
+  return ReverseBits(hash | (uint64_t{1} << 63));
+}
+
+inline uint64_t DummyKey(size_t bucket) {
+  return ReverseBits(static_cast<uint64_t>(bucket));
+}
+
+// The bucket that bucket was split from, with the highest bit cleared
+inline size_t ParentBucket(size_t bucket) {
+  assert(bucket > 0);
+  return bucket & ~(size_t{1} << FloorLog2(bucket));
+}
+}  // namespace
+
+SplitOrderedPrefixTable::SplitOrderedPrefixTable(Allocator* allocator,
+                                                 size_t initial_buckets,
+                                                 size_t huge_page_tlb_size,
+                                                 Logger* logger)
+    : allocator_(allocator),
+      huge_page_tlb_size_(huge_page_tlb_size),
+      logger_(logger),
+      initial_buckets_(size_t{1}
+                       << (initial_buckets <= 1
+                               ? 0
+                               : FloorLog2(initial_buckets - 1) + 1)),
+      num_buckets_(initial_buckets_),
+      num_prefixes_(0),
+      head_(nullptr) {
+  for (auto& segment : segments_) {
+    segment.store(nullptr, std::memory_order_relaxed);
+  }
+  segments_[0].store(NewSegment(initial_buckets_), std::memory_order_relaxed);
+  head_ = NewNode(DummyKey(0), Slice(), nullptr);
+  BucketSlot(0)->store(head_, std::memory_order_relaxed);
+}
+
+uint64_t SplitOrderedPrefixTable::Hash(const Slice& prefix) {
+  // The highest bit distinguishes prefixes from buckets in the split order
+  return GetSliceNPHash64(prefix) & ~(uint64_t{1} << 63);
+}
+
+SplitOrderedPrefixTable::Node* SplitOrderedPrefixTable::NewNode(
+    uint64_t so_key, const Slice& prefix, void* value) {
+  char* mem = allocator_->AllocateAligned(sizeof(Node) + prefix.size());
+  Node* node = new (mem) Node();
+  node->so_key = so_key;
+  node->next.store(nullptr, std::memory_order_relaxed);
+  node->value.store(value, std::memory_order_relaxed);
+  if (!prefix.empty()) {
+    char* data = mem + sizeof(Node);
+    memcpy(data, prefix.data(), prefix.size());
+    node->prefix = Slice(data, prefix.size());
+  }
+  return node;
+}
+
+std::atomic<SplitOrderedPrefixTable::Node*>*
+SplitOrderedPrefixTable::NewSegment(size_t num_buckets) {
+  char* mem = allocator_->AllocateAligned(
+      sizeof(std::atomic<Node*>) * num_buckets, huge_page_tlb_size_, logger_);
+  auto* segment = reinterpret_cast<std::atomic<Node*>*>(mem);
+  for (size_t i = 0; i < num_buckets; i++) {
+    new (&segment[i]) std::atomic<Node*>(nullptr);
+  }
+  return segment;
+}
+
+std::atomic<SplitOrderedPrefixTable::Node*>*
+SplitOrderedPrefixTable::BucketSlot(size_t bucket) const {
+  size_t segment = 0;
+  size_t offset = bucket;
+  if (bucket >= initial_buckets_) {
+    segment = FloorLog2(bucket / initial_buckets_) + 1;
+    offset = bucket - (initial_buckets_ << (segment - 1));
+  }
+  std::atomic<Node*>* slots =
+      segments_[segment].load(std::memory_order_acquire);
+  assert(slots != nullptr);
+  return &slots[offset];
+}
+
+SplitOrderedPrefixTable::Node* SplitOrderedPrefixTable::FindPosition(
+    Node* prev, uint64_t so_key, const Slice& prefix, Node** out_prev) {
+  Node* next = prev->next.load(std::memory_order_acquire);
+  while (next != nullptr && Less(next, so_key, prefix)) {
+    prev = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  *out_prev = prev;
+  return next;
+}
+
+SplitOrderedPrefixTable::Node* SplitOrderedPrefixTable::InsertNode(
+    Node* start, uint64_t so_key, const Slice& prefix, void* value,
+    bool* inserted) {
+  Node* new_node = nullptr;
+  Node* prev = start;
+  while (true) {
+    Node* next = FindPosition(prev, so_key, prefix, &prev);
+    if (next != nullptr && next->so_key == so_key && next->prefix == prefix) {
+      // A node allocated by a lost race to insert the same key is wasted,
+      // which is rare and bounded by the number of concurrent writers.
+      *inserted = false;
+      return next;
+    }
+    if (new_node == nullptr) {
+      new_node = NewNode(so_key, prefix, value);
+    }
+    new_node->next.store(next, std::memory_order_relaxed);
+    if (prev->next.compare_exchange_strong(next, new_node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+      *inserted = true;
+      return new_node;
+    }
+    // Nodes are never removed, so the search goes on from prev
+  }
+}
+
+SplitOrderedPrefixTable::Node* SplitOrderedPrefixTable::InitializedBucket(
+    size_t bucket) {
+  std::atomic<Node*>* slot = BucketSlot(bucket);
+  Node* dummy = slot->load(std::memory_order_acquire);
+  if (dummy == nullptr) {
+    Node* parent = InitializedBucket(ParentBucket(bucket));
+    bool inserted = false;
+    dummy = InsertNode(parent, DummyKey(bucket), Slice(), nullptr, &inserted);
+    slot->store(dummy, std::memory_order_release);
+  }
+  return dummy;
+}
+
+std::atomic<void*>* SplitOrderedPrefixTable::Find(const Slice& prefix) const {
+  const uint64_t hash = Hash(prefix);
+  size_t bucket = static_cast<size_t>(
+      hash & (num_buckets_.load(std::memory_order_acquire) - 1));
+  // Readers don't initialize buckets. The prefixes of a bucket without its
+  // dummy node yet follow the dummy node of its closest initialized ancestor.
+  Node* start = BucketSlot(bucket)->load(std::memory_order_acquire);
+  while (start == nullptr) {
+    bucket = ParentBucket(bucket);
+    start = BucketSlot(bucket)->load(std::memory_order_acquire);
+  }
+  const uint64_t so_key = PrefixKey(hash);
+  Node* prev = nullptr;
+  Node* node = FindPosition(start, so_key, prefix, &prev);
+  if (node != nullptr && node->so_key == so_key && node->prefix == prefix) {
+    return &node->value;
+  }
+  return nullptr;
+}
+
+std::atomic<void*>* SplitOrderedPrefixTable::FindOrInsert(const Slice& prefix,
+                                                          void* value) {
+  const uint64_t hash = Hash(prefix);
+  const size_t num_buckets = num_buckets_.load(std::memory_order_acquire);
+  Node* start =
+      InitializedBucket(static_cast<size_t>(hash & (num_buckets - 1)));
+  bool inserted = false;
+  Node* node = InsertNode(start, PrefixKey(hash), prefix, value, &inserted);
+  if (inserted &&
+      num_prefixes_.fetch_add(1, std::memory_order_relaxed) + 1 >
+          kMaxLoadFactor * num_buckets) {
+    MaybeGrow(num_buckets);
+  }
+  return &node->value;
+}
+
+void SplitOrderedPrefixTable::MaybeGrow(size_t num_buckets) {
+  MutexLock l(&grow_mutex_);
+  if (num_buckets_.load(std::memory_order_relaxed) != num_buckets) {
+    // Grown by another thread in the meantime
+    return;
+  }
+  const int segment = FloorLog2(num_buckets / initial_buckets_) + 1;
+  if (segment >= kMaxSegments) {
+    return;
+  }
+  // The new buckets are initialized on their first insert. The segment must
+  // be visible before the number of buckets covering it.
+  segments_[segment].store(NewSegment(num_buckets), std::memory_order_release);
+  num_buckets_.store(num_buckets * 2, std::memory_order_release);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
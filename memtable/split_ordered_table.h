@@ -0,0 +1,134 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "memory/allocator.h"
+#include "port/port.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Logger;
+
+// A lock-free hash table from the distinct prefixes of the keys of a prefix
+// hash memtable to a value slot each. It is a split-ordered list (Shalev and
+// Shavit, "Split-Ordered Lists: Lock-Free Extensible Hash Tables"): all the
+// prefixes are in a single linked list sorted by their bit-reversed hash, and
+// each bucket points to a dummy node where its part of the list starts. So
+// doubling the number of buckets moves no node: a new bucket is initialized
+// on the first insert into it, by splitting the part of its parent bucket
+// with a dummy node. The table grows as prefixes are added, never shrinks,
+// and all of its memory comes from the allocator.
+//
+// Find() and ForEach() never allocate nor write, and may run concurrently
+// with each other and with FindOrInsert(). FindOrInsert() is lock-free but
+// when doubling the number of buckets, and may run concurrently with itself
+// if the allocator is thread-safe.
+class SplitOrderedPrefixTable {
+ public:
+  // initial_buckets is rounded up to a power of two
+  SplitOrderedPrefixTable(Allocator* allocator, size_t initial_buckets,
+                          size_t huge_page_tlb_size = 0,
+                          Logger* logger = nullptr);
+
+  // No copying allowed
+  SplitOrderedPrefixTable(const SplitOrderedPrefixTable&) = delete;
+  void operator=(const SplitOrderedPrefixTable&) = delete;
+
+  // Returns the slot of `prefix`, or nullptr if the table doesn't have it.
+  std::atomic<void*>* Find(const Slice& prefix) const;
+
+  // Returns the slot of `prefix`, adding it with `value` first if the table
+  // doesn't have it.
+  std::atomic<void*>* FindOrInsert(const Slice& prefix, void* value);
+
+  // Calls `f` with the slot of each prefix in the table, in no particular
+  // order
+  template <typename F>
+  void ForEach(F&& f) const {
+    for (Node* node = head_->next.load(std::memory_order_acquire);
+         node != nullptr; node = node->next.load(std::memory_order_acquire)) {
+      if (!node->IsDummy()) {
+        f(&node->value);
+      }
+    }
+  }
+
+  size_t NumPrefixes() const {
+    return num_prefixes_.load(std::memory_order_relaxed);
+  }
+
+  size_t NumBuckets() const {
+    return num_buckets_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // The number of buckets is doubled when there are more prefixes than
+  // kMaxLoadFactor per bucket
+  static constexpr size_t kMaxLoadFactor = 2;
+  // Segment 0 holds the initial buckets, and segment s > 0 the buckets added
+  // by the s-th doubling
+  static constexpr int kMaxSegments = 32;
+
+  struct Node {
+    // The bit-reversed hash, with the lowest bit set for the nodes of
+    // prefixes and clear for the dummy nodes of buckets
+    uint64_t so_key;
+    std::atomic<Node*> next;
+    std::atomic<void*> value;
+    Slice prefix;
+
+    bool IsDummy() const { return (so_key & 1) == 0; }
+  };
+
+  static uint64_t Hash(const Slice& prefix);
+
+  static bool Less(const Node* node, uint64_t so_key, const Slice& prefix) {
+    return node->so_key < so_key ||
+           (node->so_key == so_key && node->prefix.compare(prefix) < 0);
+  }
+
+  Node* NewNode(uint64_t so_key, const Slice& prefix, void* value);
+
+  std::atomic<Node*>* NewSegment(size_t num_buckets);
+
+  // The slot of bucket, whose segment must have been allocated
+  std::atomic<Node*>* BucketSlot(size_t bucket) const;
+
+  // Returns the dummy node of bucket, initializing it and its ancestors
+  // first if needed
+  Node* InitializedBucket(size_t bucket);
+
+  // Returns the first node after `prev` not less than (so_key, prefix), and
+  // the node before it in *out_prev. `prev` must be less than it.
+  static Node* FindPosition(Node* prev, uint64_t so_key, const Slice& prefix,
+                            Node** out_prev);
+
+  // Returns the node of (so_key, prefix) after `start`, inserting it first
+  // if the list doesn't have it
+  Node* InsertNode(Node* start, uint64_t so_key, const Slice& prefix,
+                   void* value, bool* inserted);
+
+  void MaybeGrow(size_t num_buckets);
+
+  Allocator* const allocator_;
+  const size_t huge_page_tlb_size_;
+  Logger* const logger_;
+  const size_t initial_buckets_;
+  std::atomic<size_t> num_buckets_;
+  std::atomic<size_t> num_prefixes_;
+  std::atomic<std::atomic<Node*>*> segments_[kMaxSegments];
+  // The dummy node of bucket 0, which starts the list
+  Node* head_;
+  // Serializes the doublings of the number of buckets
+  port::Mutex grow_mutex_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
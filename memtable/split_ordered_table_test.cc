@@ -0,0 +1,130 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memtable/split_ordered_table.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "memory/arena.h"
+#include "memory/concurrent_arena.h"
+#include "port/port.h"
+#include "port/stack_trace.h"
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+std::string Prefix(uint64_t i) { return "prefix" + std::to_string(i); }
+
+void* Value(uint64_t i) { return reinterpret_cast<void*>(i + 1); }
+
+uint64_t Decode(void* value) { return reinterpret_cast<uint64_t>(value) - 1; }
+}  // namespace
+
+class SplitOrderedTableTest : public testing::Test {};
+
+TEST_F(SplitOrderedTableTest, Empty) {
+  Arena arena;
+  SplitOrderedPrefixTable table(&arena, 3);
+  ASSERT_EQ(table.NumBuckets(), 4);
+  ASSERT_EQ(table.NumPrefixes(), 0);
+  ASSERT_EQ(table.Find("foo"), nullptr);
+  ASSERT_EQ(table.Find(""), nullptr);
+  size_t count = 0;
+  table.ForEach([&](std::atomic<void*>*) { count++; });
+  ASSERT_EQ(count, 0);
+}
+
+TEST_F(SplitOrderedTableTest, FindOrInsert) {
+  Arena arena;
+  SplitOrderedPrefixTable table(&arena, 1);
+  std::atomic<void*>* slot = table.FindOrInsert("foo", Value(1));
+  ASSERT_NE(slot, nullptr);
+  ASSERT_EQ(Decode(slot->load()), 1);
+  // An existing prefix keeps its slot and value
+  ASSERT_EQ(table.FindOrInsert("foo", Value(2)), slot);
+  ASSERT_EQ(Decode(slot->load()), 1);
+  ASSERT_EQ(table.Find("foo"), slot);
+  ASSERT_EQ(table.Find("fo"), nullptr);
+  ASSERT_EQ(table.Find("fooo"), nullptr);
+  ASSERT_EQ(table.NumPrefixes(), 1);
+
+  // The empty prefix is a prefix like any other
+  std::atomic<void*>* empty = table.FindOrInsert("", Value(3));
+  ASSERT_NE(empty, slot);
+  ASSERT_EQ(table.Find(""), empty);
+  ASSERT_EQ(table.NumPrefixes(), 2);
+}
+
+TEST_F(SplitOrderedTableTest, Grow) {
+  const uint64_t kNumPrefixes = 10000;
+  Arena arena;
+  SplitOrderedPrefixTable table(&arena, 4);
+  for (uint64_t i = 0; i < kNumPrefixes; i++) {
+    table.FindOrInsert(Prefix(i), Value(i));
+    // Every prefix is found while the table grows, including in the buckets
+    // not initialized yet
+    if (i % 97 == 0) {
+      for (uint64_t j = 0; j <= i; j += 13) {
+        std::atomic<void*>* slot = table.Find(Prefix(j));
+        ASSERT_NE(slot, nullptr);
+        ASSERT_EQ(Decode(slot->load()), j);
+      }
+    }
+  }
+  ASSERT_EQ(table.NumPrefixes(), kNumPrefixes);
+  ASSERT_GE(table.NumBuckets() * 2, kNumPrefixes);
+  ASSERT_LT(table.NumBuckets(), kNumPrefixes);
+
+  for (uint64_t i = 0; i < kNumPrefixes; i++) {
+    std::atomic<void*>* slot = table.Find(Prefix(i));
+    ASSERT_NE(slot, nullptr);
+    ASSERT_EQ(Decode(slot->load()), i);
+  }
+  ASSERT_EQ(table.Find(Prefix(kNumPrefixes)), nullptr);
+
+  std::set<uint64_t> seen;
+  table.ForEach([&](std::atomic<void*>* slot) {
+    ASSERT_TRUE(seen.insert(Decode(slot->load())).second);
+  });
+  ASSERT_EQ(seen.size(), kNumPrefixes);
+}
+
+TEST_F(SplitOrderedTableTest, ConcurrentInsert) {
+  const int kNumThreads = 4;
+  const uint64_t kNumPrefixes = 20000;
+  ConcurrentArena arena;
+  SplitOrderedPrefixTable table(&arena, 1);
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      // The threads insert the same prefixes in different orders, and look
+      // up the ones they inserted
+      for (uint64_t n = 0; n < kNumPrefixes; n++) {
+        uint64_t i = (n * (2 * t + 1)) % kNumPrefixes;
+        std::atomic<void*>* slot = table.FindOrInsert(Prefix(i), Value(i));
+        ASSERT_EQ(Decode(slot->load()), i);
+        ASSERT_EQ(table.Find(Prefix(i)), slot);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(table.NumPrefixes(), kNumPrefixes);
+  size_t count = 0;
+  table.ForEach([&](std::atomic<void*>*) { count++; });
+  ASSERT_EQ(count, kNumPrefixes);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
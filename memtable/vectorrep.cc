@@ -15,6 +15,7 @@
 #include "port/port.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/utilities/options_type.h"
+#include "util/core_local.h"
 #include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -22,7 +23,8 @@ namespace {
 
 class VectorRep : public MemTableRep {
  public:
-  VectorRep(const KeyComparator& compare, Allocator* allocator, size_t count);
+  VectorRep(const KeyComparator& compare, Allocator* allocator, size_t count,
+            int sort_threads);
 
   // Insert key into the collection. (The caller will pack key and value into a
   // single buffer and pass that in as the parameter to Insert)
@@ -30,6 +32,10 @@ class VectorRep : public MemTableRep {
   // collection.
   void Insert(KeyHandle handle) override;
 
+  // Appends to a per-core buffer instead of the shared vector, so that
+  // concurrent writers don't serialize on rwlock_.
+  void InsertConcurrently(KeyHandle handle) override;
+
   // Returns true iff an entry that compares equal to key is in the collection.
   bool Contains(const char* key) const override;
 
@@ -97,11 +103,31 @@ class VectorRep : public MemTableRep {
  private:
   friend class Iterator;
   using Bucket = std::vector<const char*>;
+
+  struct Shard {
+    char padding[40] ROCKSDB_FIELD_UNUSED;
+    mutable SpinMutex mutex;
+    Bucket bucket;
+  };
+
+  // Returns a copy of all the entries, for iterating a mutable memtable.
+  std::shared_ptr<Bucket> CopyBucket() const;
+  // Moves the entries of the per-core buffers to bucket_.
+  // REQUIRES: rwlock_ is held for write.
+  void MergeShards();
+  // Sorts bucket_, splitting the work across sort_threads_ threads when it is
+  // large enough.
+  void SortBucket(Bucket* bucket) const;
+
   std::shared_ptr<Bucket> bucket_;
   mutable port::RWMutex rwlock_;
   bool immutable_;
   bool sorted_;
   const KeyComparator& compare_;
+  const int sort_threads_;
+  // Entries added by InsertConcurrently() and not yet merged into bucket_
+  CoreLocalArray<Shard> shards_;
+  std::atomic<size_t> num_shard_entries_;
 };
 
 void VectorRep::Insert(KeyHandle handle) {
@@ -111,31 +137,126 @@ void VectorRep::Insert(KeyHandle handle) {
   bucket_->push_back(key);
 }
 
+void VectorRep::InsertConcurrently(KeyHandle handle) {
+  auto* key = static_cast<char*>(handle);
+  Shard* shard = shards_.Access();
+  {
+    std::lock_guard<SpinMutex> l(shard->mutex);
+    assert(!immutable_);
+    shard->bucket.push_back(key);
+  }
+  num_shard_entries_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::shared_ptr<VectorRep::Bucket> VectorRep::CopyBucket() const {
+  // REQUIRES: rwlock_ is held
+  std::shared_ptr<Bucket> copy(new Bucket(*bucket_));
+  if (num_shard_entries_.load(std::memory_order_relaxed) > 0) {
+    for (size_t i = 0; i < shards_.Size(); i++) {
+      Shard* shard = shards_.AccessAtCore(i);
+      std::lock_guard<SpinMutex> shard_lock(shard->mutex);
+      copy->insert(copy->end(), shard->bucket.begin(), shard->bucket.end());
+    }
+  }
+  return copy;
+}
+
+void VectorRep::MergeShards() {
+  if (num_shard_entries_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  bucket_->reserve(bucket_->size() +
+                   num_shard_entries_.load(std::memory_order_relaxed));
+  for (size_t i = 0; i < shards_.Size(); i++) {
+    Shard* shard = shards_.AccessAtCore(i);
+    std::lock_guard<SpinMutex> l(shard->mutex);
+    bucket_->insert(bucket_->end(), shard->bucket.begin(),
+                    shard->bucket.end());
+    Bucket().swap(shard->bucket);
+  }
+  num_shard_entries_.store(0, std::memory_order_relaxed);
+}
+
+void VectorRep::SortBucket(Bucket* bucket) const {
+  // Below this many entries per thread, starting threads costs more than it
+  // saves.
+  constexpr size_t kMinEntriesPerThread = 16384;
+  stl_wrappers::Compare cmp(compare_);
+  size_t num_parts = std::min(static_cast<size_t>(std::max(sort_threads_, 1)),
+                              bucket->size() / kMinEntriesPerThread);
+  if (num_parts <= 1) {
+    std::sort(bucket->begin(), bucket->end(), cmp);
+    return;
+  }
+  // Sort equal parts in parallel, then merge them pairwise.
+  std::vector<size_t> bounds;
+  for (size_t i = 0; i <= num_parts; i++) {
+    bounds.push_back(bucket->size() * i / num_parts);
+  }
+  std::vector<port::Thread> threads;
+  for (size_t i = 1; i < num_parts; i++) {
+    threads.emplace_back([bucket, &bounds, &cmp, i]() {
+      std::sort(bucket->begin() + bounds[i], bucket->begin() + bounds[i + 1],
+                cmp);
+    });
+  }
+  std::sort(bucket->begin(), bucket->begin() + bounds[1], cmp);
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (size_t step = 1; step < num_parts; step *= 2) {
+    for (size_t i = 0; i + step < num_parts; i += 2 * step) {
+      std::inplace_merge(bucket->begin() + bounds[i],
+                         bucket->begin() + bounds[i + step],
+                         bucket->begin() + bounds[std::min(i + 2 * step,
+                                                           num_parts)],
+                         cmp);
+    }
+  }
+}
+
 // Returns true iff an entry that compares equal to key is in the collection.
 bool VectorRep::Contains(const char* key) const {
   ReadLock l(&rwlock_);
-  return std::find(bucket_->begin(), bucket_->end(), key) != bucket_->end();
+  if (std::find(bucket_->begin(), bucket_->end(), key) != bucket_->end()) {
+    return true;
+  }
+  if (num_shard_entries_.load(std::memory_order_relaxed) > 0) {
+    for (size_t i = 0; i < shards_.Size(); i++) {
+      Shard* shard = shards_.AccessAtCore(i);
+      std::lock_guard<SpinMutex> shard_lock(shard->mutex);
+      if (std::find(shard->bucket.begin(), shard->bucket.end(), key) !=
+          shard->bucket.end()) {
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
 void VectorRep::MarkReadOnly() {
   WriteLock l(&rwlock_);
+  MergeShards();
   immutable_ = true;
 }
 
 size_t VectorRep::ApproximateMemoryUsage() {
   return sizeof(bucket_) + sizeof(*bucket_) +
-         bucket_->size() *
+         (bucket_->size() +
+          num_shard_entries_.load(std::memory_order_relaxed)) *
              sizeof(
                  std::remove_reference<decltype(*bucket_)>::type::value_type);
 }
 
 VectorRep::VectorRep(const KeyComparator& compare, Allocator* allocator,
-                     size_t count)
+                     size_t count, int sort_threads)
     : MemTableRep(allocator),
       bucket_(new Bucket()),
       immutable_(false),
       sorted_(false),
-      compare_(compare) {
+      compare_(compare),
+      sort_threads_(sort_threads),
+      num_shard_entries_(0) {
   bucket_.get()->reserve(count);
 }
 
@@ -153,8 +274,7 @@ void VectorRep::Iterator::DoSort() const {
   if (!sorted_ && vrep_ != nullptr) {
     WriteLock l(&vrep_->rwlock_);
     if (!vrep_->sorted_) {
-      std::sort(bucket_->begin(), bucket_->end(),
-                stl_wrappers::Compare(compare_));
+      vrep_->SortBucket(bucket_.get());
       cit_ = bucket_->begin();
       vrep_->sorted_ = true;
     }
@@ -253,7 +373,7 @@ void VectorRep::Get(const LookupKey& k, void* callback_args,
     vector_rep = this;
   } else {
     vector_rep = nullptr;
-    bucket.reset(new Bucket(*bucket_));  // make a copy
+    bucket = CopyBucket();
   }
   VectorRep::Iterator iter(vector_rep, immutable_ ? bucket_ : bucket, compare_);
   rwlock_.ReadUnlock();
@@ -278,8 +398,7 @@ MemTableRep::Iterator* VectorRep::GetIterator(Arena* arena) {
       return new (mem) Iterator(this, bucket_, compare_);
     }
   } else {
-    std::shared_ptr<Bucket> tmp;
-    tmp.reset(new Bucket(*bucket_));  // make a copy
+    std::shared_ptr<Bucket> tmp = CopyBucket();
     if (arena == nullptr) {
       return new Iterator(nullptr, tmp, compare_);
     } else {
@@ -295,13 +414,23 @@ static std::unordered_map<std::string, OptionTypeInfo> vector_rep_table_info = {
       OptionTypeFlags::kNone}},
 };
 
-VectorRepFactory::VectorRepFactory(size_t count) : count_(count) {
+static std::unordered_map<std::string, OptionTypeInfo>
+    vector_rep_sort_table_info = {
+        {"sort_threads",
+         {0, OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+VectorRepFactory::VectorRepFactory(size_t count, int sort_threads)
+    : count_(count), sort_threads_(sort_threads) {
   RegisterOptions("VectorRepFactoryOptions", &count_, &vector_rep_table_info);
+  RegisterOptions("VectorRepFactorySortOptions", &sort_threads_,
+                  &vector_rep_sort_table_info);
 }
 
 MemTableRep* VectorRepFactory::CreateMemTableRep(
     const MemTableRep::KeyComparator& compare, Allocator* allocator,
     const SliceTransform*, Logger* /*logger*/) {
-  return new VectorRep(compare, allocator, count_);
+  return new VectorRep(compare, allocator, count_, sort_threads_);
 }
 }  // namespace ROCKSDB_NAMESPACE
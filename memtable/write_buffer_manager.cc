@@ -9,6 +9,7 @@
 
 #include "rocksdb/write_buffer_manager.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "cache/cache_entry_roles.h"
@@ -161,6 +162,30 @@ void WriteBufferManager::FreeMemWithCache(size_t mem) {
   s.PermitUncheckedError();
 }
 
+WriteBufferFlushCandidate WriteBufferManager::MakeFlushCandidate(
+    WriteBufferSentinel* s, uint64_t memory_bytes, uint64_t oldest_key_time) {
+  WriteBufferFlushCandidate candidate;
+  candidate.db = s->db;
+  candidate.cf = s->cf;
+  candidate.memtable_bytes = memory_bytes;
+  int64_t now = 0;
+  if (oldest_key_time != std::numeric_limits<uint64_t>::max() &&
+      s->db->GetEnv()->GetCurrentTime(&now).ok() &&
+      static_cast<uint64_t>(now) > oldest_key_time) {
+    candidate.memtable_age_seconds =
+        static_cast<uint64_t>(now) - oldest_key_time;
+  }
+  candidate.wal_bytes_pinned =
+      s->db->GetApproximateWalBytesPinnedByMemTables(s->cf);
+  if (s->db->GetIntProperty(s->cf,
+                            DB::Properties::kNumFilesAtLevelPrefix + "0",
+                            &candidate.num_level0_files)) {
+    candidate.level0_file_num_compaction_trigger =
+        s->db->GetOptions(s->cf).level0_file_num_compaction_trigger;
+  }
+  return candidate;
+}
+
 void WriteBufferManager::MaybeFlushLocked(DB* this_db) {
   if (!ShouldFlush()) {
     return;
@@ -176,22 +201,30 @@ void WriteBufferManager::MaybeFlushLocked(DB* this_db) {
   std::set<Candidate, decltype(cmp)> candidates(cmp);
 
   for (auto& s : sentinels_) {
-    // TODO: move this calculation to a callback.
     uint64_t current_score = 0;
     uint64_t current_memory_bytes = std::numeric_limits<uint64_t>::max();
     uint64_t oldest_time = std::numeric_limits<uint64_t>::max();
     s->db->GetApproximateActiveMemTableStats(s->cf, &current_memory_bytes,
                                              &oldest_time);
-    if (flush_oldest_first_.load(std::memory_order_relaxed)) {
+    if (flush_policy_ != nullptr) {
+      double score = flush_policy_->Score(
+          MakeFlushCandidate(s.get(), current_memory_bytes, oldest_time));
+      // Kept as an integer like the default scores below. 1e19 is the
+      // largest round value that fits in uint64_t.
+      current_score =
+          static_cast<uint64_t>(std::min(std::max(score, 0.0), 1e19));
+    } else if (flush_oldest_first_.load(std::memory_order_relaxed)) {
       // Convert oldest to highest score.
       current_score = std::numeric_limits<uint64_t>::max() - oldest_time;
     } else {
       current_score = current_memory_bytes;
     }
-    // A very mild penalty for too many L0 files.
+    // A very mild penalty for too many L0 files. A flush policy accounts for
+    // L0 files itself.
     uint64_t level0;
     // 3 is to optimize the frequency of getting options, which uses mutex.
-    if (s->db->GetIntProperty(DB::Properties::kNumFilesAtLevelPrefix + "0",
+    if (flush_policy_ == nullptr &&
+        s->db->GetIntProperty(DB::Properties::kNumFilesAtLevelPrefix + "0",
                               &level0) &&
         level0 >= 3) {
       auto opts = s->db->GetOptions(s->cf);
@@ -242,6 +275,44 @@ void WriteBufferManager::MaybeFlushLocked(DB* this_db) {
   }
 }
 
+namespace {
+class CostAwareWriteBufferFlushPolicy : public WriteBufferFlushPolicy {
+ public:
+  CostAwareWriteBufferFlushPolicy(double wal_weight,
+                                  uint64_t age_horizon_seconds)
+      : wal_weight_(wal_weight), age_horizon_seconds_(age_horizon_seconds) {}
+
+  const char* Name() const override {
+    return "CostAwareWriteBufferFlushPolicy";
+  }
+
+  double Score(const WriteBufferFlushCandidate& c) const override {
+    double score = static_cast<double>(c.memtable_bytes) +
+                   wal_weight_ * static_cast<double>(c.wal_bytes_pinned);
+    if (age_horizon_seconds_ > 0) {
+      score *= 1.0 + std::min(static_cast<double>(c.memtable_age_seconds) /
+                                  static_cast<double>(age_horizon_seconds_),
+                              1.0);
+    }
+    if (c.level0_file_num_compaction_trigger > 0) {
+      score /= 1.0 + static_cast<double>(c.num_level0_files) /
+                         c.level0_file_num_compaction_trigger;
+    }
+    return score;
+  }
+
+ private:
+  const double wal_weight_;
+  const uint64_t age_horizon_seconds_;
+};
+}  // namespace
+
+std::shared_ptr<WriteBufferFlushPolicy> NewCostAwareWriteBufferFlushPolicy(
+    double wal_weight, uint64_t age_horizon_seconds) {
+  return std::make_shared<CostAwareWriteBufferFlushPolicy>(
+      wal_weight, age_horizon_seconds);
+}
+
 void WriteBufferManager::BeginWriteStall(StallInterface* wbm_stall) {
   assert(wbm_stall != nullptr);
 
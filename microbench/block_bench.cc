@@ -0,0 +1,373 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Micro-benchmarks of the kernels reading a block based table: data block and
+// index block iterators, partitioned filter queries and block decompression.
+// The blocks are built in memory from keys and values generated with a fixed
+// seed, so that the runs are comparable.
+#include <cinttypes>
+#include <map>
+
+#include "benchmark/benchmark.h"
+#include "rocksdb/filter_policy.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_based_table_reader.h"
+#include "table/block_based/block_builder.h"
+#include "table/block_based/filter_policy_internal.h"
+#include "table/block_based/index_builder.h"
+#include "table/block_based/partitioned_filter_block.h"
+#include "table/format.h"
+#include "util/compression.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The user key of the i-th key of a benchmark, in sorted order
+static std::string BenchKey(uint64_t i) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "key%016" PRIu64, i * 2);
+  return buf;
+}
+
+// A user key sorting between BenchKey(i) and BenchKey(i + 1), which is not
+// in the block
+static std::string MissingKey(uint64_t i) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "key%016" PRIu64, i * 2 + 1);
+  return buf;
+}
+
+// Values that compress about 2:1, as in db_bench
+static std::string BenchValue(Random* rnd, int len) {
+  std::string piece = rnd->RandomString(len / 2);
+  std::string value;
+  while (value.size() < static_cast<size_t>(len)) {
+    value.append(piece);
+  }
+  value.resize(len);
+  return value;
+}
+
+// Builds a data block of `num_records` entries of ~100 byte values
+static std::string BuildDataBlock(int restart_interval, bool hash_index,
+                                  int num_records) {
+  Random rnd(301);
+  BlockBuilder builder(
+      restart_interval, true, false,
+      hash_index ? BlockBasedTableOptions::kDataBlockBinaryAndHash
+                 : BlockBasedTableOptions::kDataBlockBinarySearch);
+  for (int i = 0; i < num_records; i++) {
+    InternalKey ikey(BenchKey(i), 0, kTypeValue);
+    builder.Add(ikey.Encode(), BenchValue(&rnd, 100));
+  }
+  return builder.Finish().ToString();
+}
+
+static void DataBlockArguments(benchmark::internal::Benchmark* b) {
+  for (int restart_interval : {1, 4, 16, 64}) {
+    for (int hash_index : {0, 1}) {
+      for (int num_records : {32, 256}) {
+        b->Args({restart_interval, hash_index, num_records});
+      }
+    }
+  }
+  b->ArgNames({"restart_interval", "hash_index", "num_records"});
+}
+
+static void DataBlockIterSeek(benchmark::State& state) {
+  const int num_records = static_cast<int>(state.range(2));
+  std::string data = BuildDataBlock(static_cast<int>(state.range(0)),
+                                    state.range(1) != 0, num_records);
+  Block block{BlockContents(data)};
+
+  Random rnd(302);
+  std::vector<std::string> lookups;
+  for (int i = 0; i < 1024; i++) {
+    lookups.push_back(
+        InternalKey(BenchKey(rnd.Uniform(num_records)), 0, kTypeValue)
+            .Encode()
+            .ToString());
+  }
+
+  DataBlockIter iter;
+  size_t i = 0;
+  uint64_t not_found = 0;
+  for (auto _ : state) {
+    block.NewDataIterator(BytewiseComparator(), kDisableGlobalSequenceNumber,
+                          &iter);
+    // SeekForGet() uses the hash index of the block, if any
+    if (!iter.SeekForGet(lookups[i++ % lookups.size()]) || !iter.Valid()) {
+      not_found++;
+    }
+    benchmark::DoNotOptimize(iter.value());
+  }
+  if (not_found > 0) {
+    state.SkipWithError("key not found");
+  }
+}
+
+BENCHMARK(DataBlockIterSeek)->Apply(DataBlockArguments);
+
+static void DataBlockIterNext(benchmark::State& state) {
+  const int num_records = static_cast<int>(state.range(2));
+  std::string data = BuildDataBlock(static_cast<int>(state.range(0)),
+                                    state.range(1) != 0, num_records);
+  Block block{BlockContents(data)};
+
+  DataBlockIter iter;
+  int64_t num_keys = 0;
+  for (auto _ : state) {
+    block.NewDataIterator(BytewiseComparator(), kDisableGlobalSequenceNumber,
+                          &iter);
+    for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+      benchmark::DoNotOptimize(iter.value());
+      num_keys++;
+    }
+  }
+  state.SetItemsProcessed(num_keys);
+}
+
+BENCHMARK(DataBlockIterNext)->Apply(DataBlockArguments);
+
+static void IndexBlockIterSeek(benchmark::State& state) {
+  const int restart_interval = static_cast<int>(state.range(0));
+  const int num_records = static_cast<int>(state.range(1));
+
+  // An index block of full block handles with the separators of data blocks
+  // holding 8 keys each
+  BlockBuilder builder(restart_interval, true, false);
+  for (int i = 0; i < num_records; i++) {
+    InternalKey separator(BenchKey(i * 8 + 7), 0, kTypeValue);
+    std::string handle;
+    BlockHandle(static_cast<uint64_t>(i) * 4096, 4096).EncodeTo(&handle);
+    builder.Add(separator.Encode(), handle);
+  }
+  std::string data = builder.Finish().ToString();
+  Block block{BlockContents(data)};
+
+  Random rnd(303);
+  std::vector<std::string> lookups;
+  for (int i = 0; i < 1024; i++) {
+    lookups.push_back(
+        InternalKey(BenchKey(rnd.Uniform(num_records * 8)), 0, kTypeValue)
+            .Encode()
+            .ToString());
+  }
+
+  IndexBlockIter iter;
+  size_t i = 0;
+  uint64_t not_found = 0;
+  for (auto _ : state) {
+    block.NewIndexIterator(BytewiseComparator(), kDisableGlobalSequenceNumber,
+                           &iter, /*stats=*/nullptr,
+                           /*total_order_seek=*/true, /*have_first_key=*/false,
+                           /*key_includes_seq=*/true, /*value_is_full=*/true);
+    iter.Seek(lookups[i++ % lookups.size()]);
+    if (!iter.Valid()) {
+      not_found++;
+    } else {
+      benchmark::DoNotOptimize(iter.value().handle.offset());
+    }
+  }
+  if (not_found > 0) {
+    state.SkipWithError("key not found");
+  }
+}
+
+BENCHMARK(IndexBlockIterSeek)
+    ->ArgsProduct({{1, 4, 16}, {128, 1024}})
+    ->ArgNames({"restart_interval", "num_records"});
+
+namespace {
+class BenchBlockBasedTable : public BlockBasedTable {
+ public:
+  BenchBlockBasedTable(Rep* rep, PartitionedIndexBuilder* pib)
+      : BlockBasedTable(rep, /*block_cache_tracer=*/nullptr) {
+    // What Open() sets up as far as the filter reader needs it
+    rep->index_key_includes_seq = pib->seperator_is_key_plus_seq();
+    rep->index_value_is_full = !pib->get_use_value_delta_encoding();
+  }
+};
+
+// A filter reader with all its partitions in memory, as if they were pinned
+class BenchPartitionedFilterBlockReader : public PartitionedFilterBlockReader {
+ public:
+  BenchPartitionedFilterBlockReader(
+      BlockBasedTable* t, CachableEntry<Block>&& filter_block,
+      const std::map<uint64_t, std::string>& partitions)
+      : PartitionedFilterBlockReader(
+            t, std::move(filter_block.As<Block_kFilterPartitionIndex>())) {
+    for (const auto& partition : partitions) {
+      filter_map_[partition.first] = CachableEntry<ParsedFullFilterBlock>(
+          new ParsedFullFilterBlock(
+              t->get_rep()->table_options.filter_policy.get(),
+              BlockContents(Slice(partition.second))),
+          nullptr /* cache */, nullptr /* cache_handle */,
+          true /* own_value */);
+    }
+  }
+};
+}  // namespace
+
+static void PartitionedFilterKeyMayMatch(benchmark::State& state) {
+  const int64_t num_keys = state.range(0);
+  const bool negative_query = state.range(2) != 0;
+
+  Options options;
+  ImmutableOptions ioptions(options);
+  EnvOptions env_options(options);
+  InternalKeyComparator icomp(options.comparator);
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  table_options.partition_filters = true;
+  table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  table_options.metadata_block_size = static_cast<uint64_t>(state.range(1));
+
+  std::unique_ptr<PartitionedIndexBuilder> pib(
+      PartitionedIndexBuilder::CreateIndexBuilder(
+          &icomp, /*use_value_delta_encoding=*/false, table_options,
+          /*ts_sz=*/0, /*persist_user_defined_timestamps=*/true));
+  std::unique_ptr<PartitionedFilterBlockBuilder> builder(
+      new PartitionedFilterBlockBuilder(
+          /*prefix_extractor=*/nullptr, table_options.whole_key_filtering,
+          BloomFilterPolicy::GetBuilderFromContext(
+              FilterBuildingContext(table_options)),
+          table_options.index_block_restart_interval,
+          /*use_value_delta_encoding=*/false, pib.get(),
+          static_cast<uint32_t>(table_options.metadata_block_size),
+          /*ts_sz=*/0, /*persist_user_defined_timestamps=*/true));
+
+  // Cut a data block every 16 keys
+  for (int64_t i = 0; i < num_keys; i++) {
+    std::string key = BenchKey(i);
+    builder->Add(key);
+    if (i % 16 == 15 || i + 1 == num_keys) {
+      std::string last_key = *InternalKey(key, 0, kTypeValue).rep();
+      std::string next_key = *InternalKey(BenchKey(i + 1), 0, kTypeValue).rep();
+      Slice next_key_slice(next_key);
+      pib->AddIndexEntry(&last_key,
+                         i + 1 == num_keys ? nullptr : &next_key_slice,
+                         BlockHandle(static_cast<uint64_t>(i), 1));
+    }
+  }
+
+  // Lay the partitions out as a table would, the top-level index last
+  std::map<uint64_t, std::string> partitions;
+  BlockHandle handle;
+  uint64_t offset = 0;
+  Status s;
+  Slice top_level_index;
+  std::unique_ptr<const char[]> filter_data;
+  do {
+    Slice partition = builder->Finish(handle, &s, &filter_data);
+    handle = BlockHandle(offset, partition.size());
+    offset += partition.size() + BlockBasedTable::kBlockTrailerSize;
+    if (s.IsIncomplete()) {
+      partitions[handle.offset()] = partition.ToString();
+    } else {
+      top_level_index = partition;
+    }
+  } while (s.IsIncomplete());
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+
+  std::unique_ptr<BenchBlockBasedTable> table(new BenchBlockBasedTable(
+      new BlockBasedTable::Rep(ioptions, env_options, table_options, icomp,
+                               /*skip_filters=*/false, /*file_size=*/offset,
+                               /*level=*/0, /*immortal_table=*/false),
+      pib.get()));
+  CachableEntry<Block> top_level_block(
+      new Block(BlockContents(top_level_index)), nullptr /* cache */,
+      nullptr /* cache_handle */, true /* own_value */);
+  BenchPartitionedFilterBlockReader reader(
+      table.get(), std::move(top_level_block), partitions);
+
+  Random rnd(304);
+  std::vector<std::string> user_keys;
+  std::vector<std::string> ikeys;
+  for (int i = 0; i < 1024; i++) {
+    uint64_t k = rnd.Uniform(static_cast<int>(num_keys));
+    user_keys.push_back(negative_query ? MissingKey(k) : BenchKey(k));
+    ikeys.push_back(*InternalKey(user_keys.back(), 0, kTypeValue).rep());
+  }
+
+  ReadOptions read_options;
+  size_t i = 0;
+  uint64_t matches = 0;
+  for (auto _ : state) {
+    const size_t idx = i++ % user_keys.size();
+    const Slice ikey(ikeys[idx]);
+    matches += reader.KeyMayMatch(user_keys[idx], /*no_io=*/false, &ikey,
+                                  /*get_context=*/nullptr,
+                                  /*lookup_context=*/nullptr, read_options);
+  }
+  state.counters["partitions"] = static_cast<double>(partitions.size());
+  state.counters["fp_pct"] =
+      negative_query ? benchmark::Counter(static_cast<double>(matches) * 100,
+                                          benchmark::Counter::kAvgIterations)
+                     : benchmark::Counter(0);
+}
+
+BENCHMARK(PartitionedFilterKeyMayMatch)
+    ->ArgsProduct({{10000, 1000000}, {1024, 4096}, {0, 1}})
+    ->ArgNames({"num_keys", "metadata_block_size", "negative_query"});
+
+static void UncompressBlock(benchmark::State& state) {
+  const auto type = static_cast<CompressionType>(state.range(0));
+  if (!CompressionTypeSupported(type)) {
+    state.SkipWithError(
+        (CompressionTypeToString(type) + " is not supported").c_str());
+    return;
+  }
+  const uint32_t format_version = BlockBasedTableOptions().format_version;
+
+  // A 4KB data block, the default block size
+  std::string raw = BuildDataBlock(16, false, 36);
+
+  CompressionOptions compression_opts;
+  CompressionContext compression_ctx(type, compression_opts);
+  CompressionInfo compression_info(compression_opts, compression_ctx,
+                                   CompressionDict::GetEmptyDict(), type,
+                                   /*sample_for_compression=*/0);
+  std::string compressed;
+  if (!CompressData(raw, compression_info,
+                    GetCompressFormatForVersion(format_version),
+                    &compressed)) {
+    state.SkipWithError("compression failed");
+    return;
+  }
+
+  Options options;
+  ImmutableOptions ioptions(options);
+  UncompressionContext uncompression_ctx(type);
+  UncompressionInfo uncompression_info(
+      uncompression_ctx, UncompressionDict::GetEmptyDict(), type);
+  for (auto _ : state) {
+    BlockContents contents;
+    Status s = UncompressBlockData(uncompression_info, compressed.data(),
+                                   compressed.size(), &contents,
+                                   format_version, ioptions);
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(contents.data.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(raw.size()));
+  state.counters["ratio"] =
+      static_cast<double>(raw.size()) / static_cast<double>(compressed.size());
+}
+
+BENCHMARK(UncompressBlock)
+    ->ArgName("compression_type")
+    ->DenseRange(kSnappyCompression, kLZ4HCCompression)
+    ->Arg(kZSTD);
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
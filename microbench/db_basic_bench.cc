@@ -7,14 +7,18 @@
 #include <unistd.h>
 #endif  // ! OS_WIN
 
+#include <cinttypes>
+
 #include "benchmark/benchmark.h"
 #include "db/db_impl/db_impl.h"
+#include "monitoring/statistics_impl.h"
 #include "rocksdb/db.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/options.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_builder.h"
 #include "util/random.h"
+#include "util/stop_watch.h"
 #include "utilities/merge_operators.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -1288,6 +1292,76 @@ BENCHMARK(IteratorNext)
     ->Iterations(kIteratorNextNum)
     ->Apply(IteratorNextArguments);
 
+static void IteratorNextSortedRuns(benchmark::State& state) {
+  const int num_sorted_runs = static_cast<int>(state.range(0));
+  const uint64_t key_num = 100000;
+  const int per_key_size = 100;
+
+  // setup DB
+  static std::unique_ptr<DB> db;
+  Options options;
+  options.disable_auto_compactions = true;
+  options.level0_slowdown_writes_trigger = 1000;
+  options.level0_stop_writes_trigger = 1000;
+
+  auto rnd = Random(301 + state.thread_index());
+  KeyGenerator kg(key_num);
+
+  if (state.thread_index() == 0) {
+    SetupDB(state, options, &db, "IteratorNextSortedRuns");
+    // Every key is in a different L0 file than the previous one, so that each
+    // Next() of the merging iterator moves to another child
+    auto wo = WriteOptions();
+    wo.disableWAL = true;
+    char key[16];
+    for (int run = 0; run < num_sorted_runs; run++) {
+      for (uint64_t i = run; i < key_num; i += num_sorted_runs) {
+        snprintf(key, sizeof(key), "key%07" PRIu64, i);
+        Status s = db->Put(wo, key, rnd.RandomString(per_key_size));
+        if (!s.ok()) {
+          state.SkipWithError(s.ToString().c_str());
+        }
+      }
+      Status s = db->Flush(FlushOptions());
+      if (!s.ok()) {
+        state.SkipWithError(s.ToString().c_str());
+        return;
+      }
+    }
+  }
+
+  std::unique_ptr<Iterator> iter{db->NewIterator(ReadOptions())};
+  iter->SeekToFirst();
+  for (auto _ : state) {
+    if (!iter->Valid()) {
+      state.PauseTiming();
+      if (!iter->status().ok()) {
+        state.SkipWithError(iter->status().ToString().c_str());
+      }
+      iter->SeekToFirst();
+      state.ResumeTiming();
+    }
+    iter->Next();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  iter.reset();
+
+  if (state.thread_index() == 0) {
+    TeardownDB(state, db, options, kg);
+  }
+}
+
+static void IteratorNextSortedRunsArguments(
+    benchmark::internal::Benchmark* b) {
+  for (int64_t num_sorted_runs : {1, 2, 4, 6, 8, 12, 16}) {
+    b->Args({num_sorted_runs});
+  }
+  b->ArgNames({"num_sorted_runs"});
+}
+BENCHMARK(IteratorNextSortedRuns)
+    ->Iterations(kIteratorNextNum * 10)
+    ->Apply(IteratorNextSortedRunsArguments);
+
 static void IteratorNextWithPerfContext(benchmark::State& state) {
   // setup DB
   static std::unique_ptr<DB> db;
@@ -1615,6 +1689,33 @@ BENCHMARK(RandomAccessFileReaderRead)
     ->Arg(1)
     ->ArgName("enable_statistics");
 
+// The cost of the statistics a Get() records, at each StatsLevel, or without
+// statistics for a negative level
+static void StatisticsOverhead(benchmark::State& state) {
+  static std::shared_ptr<Statistics> stats_share;
+  if (state.thread_index() == 0) {
+    stats_share = CreateDBStatistics();
+    if (state.range(0) >= 0) {
+      stats_share->set_stats_level(static_cast<StatsLevel>(state.range(0)));
+    }
+  }
+  SystemClock* clock = SystemClock::Default().get();
+  for (auto _ : state) {
+    // Read in the loop, which starts once thread 0 has set it
+    Statistics* statistics = state.range(0) >= 0 ? stats_share.get() : nullptr;
+    StopWatch sw(clock, statistics, DB_GET);
+    RecordTick(statistics, NUMBER_KEYS_READ);
+    RecordTick(statistics, BYTES_READ, 100);
+    RecordInHistogram(statistics, BYTES_PER_READ, 100);
+  }
+}
+
+BENCHMARK(StatisticsOverhead)
+    ->DenseRange(-1, StatsLevel::kAll)
+    ->ArgName("stats_level")
+    ->Threads(1)
+    ->Threads(8);
+
 }  // namespace ROCKSDB_NAMESPACE
 
 BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Counts the heap allocations of point lookups served from the memtable or
+// the block cache, which should make none. Global operator new is replaced to
+// count them, which is why this is a binary of its own.
+#ifndef OS_WIN
+#include <unistd.h>
+#endif  // ! OS_WIN
+
+#include <cstdlib>
+#include <new>
+
+#include "benchmark/benchmark.h"
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+#include "util/random.h"
+
+namespace {
+thread_local uint64_t num_allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  num_allocations++;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace ROCKSDB_NAMESPACE {
+
+static void GetAllocations(benchmark::State& state) {
+  const bool from_memtable = state.range(0);
+  const size_t key_size = static_cast<size_t>(state.range(1));
+  const int num_keys = 10000;
+
+  Options options;
+  options.create_if_missing = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(64 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  std::string db_path;
+  Status s = Env::Default()->GetTestDirectory(&db_path);
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+  std::string db_name = db_path + "/get_alloc_bench" + std::to_string(getpid());
+  s = DestroyDB(db_name, options);
+  DB* db_ptr = nullptr;
+  if (s.ok()) {
+    s = DB::Open(options, db_name, &db_ptr);
+  }
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+  std::unique_ptr<DB> db(db_ptr);
+
+  // Keys share most of their prefix, as in a restart interval of a block
+  auto make_key = [key_size](int i) {
+    std::string key = std::to_string(1000000 + i);
+    key.insert(0, key_size - key.size(), 'k');
+    return key;
+  };
+  Random rnd(301);
+  WriteOptions wo;
+  wo.disableWAL = true;
+  for (int i = 0; i < num_keys && s.ok(); i++) {
+    s = db->Put(wo, make_key(i), rnd.RandomString(100));
+  }
+  if (s.ok() && !from_memtable) {
+    s = db->Flush(FlushOptions());
+  }
+  std::vector<std::string> keys;
+  PinnableSlice value;
+  // Fills the block cache
+  for (int i = 0; i < num_keys && s.ok(); i++) {
+    keys.push_back(make_key(static_cast<int>(rnd.Uniform(num_keys))));
+    s = db->Get(ReadOptions(), db->DefaultColumnFamily(), keys.back(), &value);
+    value.Reset();
+  }
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+
+  ReadOptions ro;
+  size_t i = 0;
+  const uint64_t allocations_before = num_allocations;
+  for (auto _ : state) {
+    s = db->Get(ro, db->DefaultColumnFamily(), keys[i++ % keys.size()],
+                &value);
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+    value.Reset();
+  }
+  state.counters["allocs_per_get"] =
+      benchmark::Counter(static_cast<double>(num_allocations -
+                                             allocations_before),
+                         benchmark::Counter::kAvgIterations);
+
+  s = db->Close();
+  db.reset();
+  DestroyDB(db_name, options).PermitUncheckedError();
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+  }
+}
+
+BENCHMARK(GetAllocations)
+    ->ArgsProduct({{false, true}, {16, 48}})
+    ->ArgNames({"from_memtable", "key_size"});
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
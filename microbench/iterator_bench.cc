@@ -0,0 +1,263 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Micro-benchmarks of the kernels moving keys through the DB without IO:
+// merging the iterators of sorted runs, compaction iteration and encoding and
+// iterating write batches. The inputs are generated with a fixed seed, so that
+// the runs are comparable.
+#include <cinttypes>
+
+#include "benchmark/benchmark.h"
+#include "db/compaction/compaction_iterator.h"
+#include "db/merge_helper.h"
+#include "db/range_del_aggregator.h"
+#include "rocksdb/write_batch.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_builder.h"
+#include "table/merging_iterator.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+static std::string BenchKey(uint64_t i) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "key%016" PRIu64, i);
+  return buf;
+}
+
+// Sorted runs held in data blocks, to be read through their iterators
+class SortedRuns {
+ public:
+  // Spreads `num_keys` keys over `num_runs` runs at random, each key with
+  // `num_versions` versions, the newest first. Versions of a key may land in
+  // different runs.
+  SortedRuns(int num_runs, int num_keys, int num_versions) {
+    Random rnd(301);
+    std::vector<std::vector<std::pair<std::string, std::string>>> entries(
+        num_runs);
+    SequenceNumber seq = static_cast<SequenceNumber>(num_keys) * num_versions;
+    for (int i = 0; i < num_keys; i++) {
+      for (int v = 0; v < num_versions; v++) {
+        InternalKey ikey(BenchKey(i), seq--, kTypeValue);
+        entries[rnd.Uniform(num_runs)].emplace_back(
+            ikey.Encode().ToString(), rnd.RandomString(100));
+      }
+    }
+    for (const auto& run : entries) {
+      BlockBuilder builder(16);
+      for (const auto& entry : run) {
+        builder.Add(entry.first, entry.second);
+      }
+      data_.push_back(builder.Finish().ToString());
+    }
+    for (const auto& data : data_) {
+      blocks_.emplace_back(new Block(BlockContents(data)));
+    }
+  }
+
+  InternalIterator* NewIterator(int run) const {
+    return blocks_[run]->NewDataIterator(BytewiseComparator(),
+                                         kDisableGlobalSequenceNumber);
+  }
+
+  // A merging iterator over all the runs
+  InternalIterator* NewMergingIterator(
+      const InternalKeyComparator* icmp) const {
+    std::vector<InternalIterator*> children;
+    for (size_t run = 0; run < blocks_.size(); run++) {
+      children.push_back(NewIterator(static_cast<int>(run)));
+    }
+    return ROCKSDB_NAMESPACE::NewMergingIterator(
+        icmp, children.data(), static_cast<int>(children.size()));
+  }
+
+ private:
+  std::vector<std::string> data_;
+  std::vector<std::unique_ptr<Block>> blocks_;
+};
+
+static void MergingIteratorSeek(benchmark::State& state) {
+  const int num_runs = static_cast<int>(state.range(0));
+  const int num_keys = 4096;
+  SortedRuns runs(num_runs, num_keys, 1);
+  InternalKeyComparator icmp(BytewiseComparator());
+  std::unique_ptr<InternalIterator> iter(runs.NewMergingIterator(&icmp));
+
+  Random rnd(302);
+  std::vector<std::string> lookups;
+  for (int i = 0; i < 1024; i++) {
+    lookups.push_back(InternalKey(BenchKey(rnd.Uniform(num_keys)),
+                                  kMaxSequenceNumber, kValueTypeForSeek)
+                          .Encode()
+                          .ToString());
+  }
+
+  size_t i = 0;
+  uint64_t not_found = 0;
+  for (auto _ : state) {
+    iter->Seek(lookups[i++ % lookups.size()]);
+    if (!iter->Valid()) {
+      not_found++;
+    } else {
+      benchmark::DoNotOptimize(iter->value());
+    }
+  }
+  if (not_found > 0) {
+    state.SkipWithError("key not found");
+  }
+}
+
+BENCHMARK(MergingIteratorSeek)->RangeMultiplier(4)->Range(1, 64)->ArgName(
+    "num_runs");
+
+static void MergingIteratorNext(benchmark::State& state) {
+  const int num_runs = static_cast<int>(state.range(0));
+  SortedRuns runs(num_runs, 4096, 1);
+  InternalKeyComparator icmp(BytewiseComparator());
+
+  int64_t num_keys = 0;
+  for (auto _ : state) {
+    std::unique_ptr<InternalIterator> iter(runs.NewMergingIterator(&icmp));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      benchmark::DoNotOptimize(iter->value());
+      num_keys++;
+    }
+  }
+  state.SetItemsProcessed(num_keys);
+}
+
+BENCHMARK(MergingIteratorNext)->RangeMultiplier(4)->Range(1, 64)->ArgName(
+    "num_runs");
+
+// Compacts the merged runs without snapshots, so that all versions of a key
+// but the newest are dropped
+static void CompactionIteratorNext(benchmark::State& state) {
+  const int num_runs = static_cast<int>(state.range(0));
+  const int num_versions = static_cast<int>(state.range(1));
+  SortedRuns runs(num_runs, 4096 / num_versions, num_versions);
+  InternalKeyComparator icmp(BytewiseComparator());
+  std::vector<SequenceNumber> snapshots;
+  const std::atomic<bool> manual_compaction_canceled{false};
+
+  int64_t num_input = 0;
+  int64_t num_output = 0;
+  for (auto _ : state) {
+    std::unique_ptr<InternalIterator> input(runs.NewMergingIterator(&icmp));
+    input->SeekToFirst();
+    MergeHelper merge_helper(Env::Default(), BytewiseComparator(),
+                             /*user_merge_operator=*/nullptr,
+                             /*compaction_filter=*/nullptr, /*logger=*/nullptr,
+                             /*assert_valid_internal_key=*/true,
+                             kMaxSequenceNumber);
+    CompactionRangeDelAggregator range_del_agg(&icmp, snapshots);
+    CompactionIterator c_iter(
+        input.get(), BytewiseComparator(), &merge_helper, kMaxSequenceNumber,
+        &snapshots, kMaxSequenceNumber, kMaxSequenceNumber,
+        /*snapshot_checker=*/nullptr, Env::Default(),
+        /*report_detailed_time=*/false, /*expect_valid_internal_key=*/true,
+        &range_del_agg, /*blob_file_builder=*/nullptr,
+        /*allow_data_in_errors=*/false, /*enforce_single_del_contracts=*/true,
+        manual_compaction_canceled, /*must_count_input_entries=*/false);
+    for (c_iter.SeekToFirst(); c_iter.Valid(); c_iter.Next()) {
+      benchmark::DoNotOptimize(c_iter.value());
+      num_output++;
+    }
+    if (!c_iter.status().ok()) {
+      state.SkipWithError(c_iter.status().ToString().c_str());
+      break;
+    }
+    num_input += c_iter.iter_stats().num_input_records;
+  }
+  state.SetItemsProcessed(num_input);
+  state.counters["output_pct"] = benchmark::Counter(
+      num_input > 0 ? static_cast<double>(num_output) * 100 / num_input : 0);
+}
+
+BENCHMARK(CompactionIteratorNext)
+    ->ArgsProduct({{1, 8}, {1, 4}})
+    ->ArgNames({"num_runs", "num_versions"});
+
+static void WriteBatchPut(benchmark::State& state) {
+  const int batch_size = static_cast<int>(state.range(0));
+  const int value_size = static_cast<int>(state.range(1));
+  Random rnd(303);
+  std::string value = rnd.RandomString(value_size);
+
+  int64_t num_keys = 0;
+  for (auto _ : state) {
+    WriteBatch batch;
+    for (int i = 0; i < batch_size; i++) {
+      Status s = batch.Put(BenchKey(i), value);
+      if (!s.ok()) {
+        state.SkipWithError(s.ToString().c_str());
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(batch.Data().data());
+    num_keys += batch_size;
+  }
+  state.SetItemsProcessed(num_keys);
+}
+
+BENCHMARK(WriteBatchPut)
+    ->ArgsProduct({{1, 16, 256}, {16, 1024}})
+    ->ArgNames({"batch_size", "value_size"});
+
+namespace {
+// Touches what a memtable insert would read of each entry
+class CountingHandler : public WriteBatch::Handler {
+ public:
+  Status PutCF(uint32_t, const Slice& key, const Slice& value) override {
+    bytes_ += key.size() + value.size();
+    return Status::OK();
+  }
+  Status DeleteCF(uint32_t, const Slice& key) override {
+    bytes_ += key.size();
+    return Status::OK();
+  }
+  Status MergeCF(uint32_t, const Slice& key, const Slice& value) override {
+    bytes_ += key.size() + value.size();
+    return Status::OK();
+  }
+
+  uint64_t bytes_ = 0;
+};
+}  // namespace
+
+static void WriteBatchIterate(benchmark::State& state) {
+  const int batch_size = static_cast<int>(state.range(0));
+  const int value_size = static_cast<int>(state.range(1));
+  Random rnd(304);
+  WriteBatch batch;
+  for (int i = 0; i < batch_size; i++) {
+    Status s = batch.Put(BenchKey(i), rnd.RandomString(value_size));
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      return;
+    }
+  }
+
+  CountingHandler handler;
+  for (auto _ : state) {
+    Status s = batch.Iterate(&handler);
+    if (!s.ok()) {
+      state.SkipWithError(s.ToString().c_str());
+      break;
+    }
+  }
+  benchmark::DoNotOptimize(handler.bytes_);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          batch_size);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(batch.GetDataSize()));
+}
+
+BENCHMARK(WriteBatchIterate)
+    ->ArgsProduct({{1, 16, 256}, {16, 1024}})
+    ->ArgNames({"batch_size", "value_size"});
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
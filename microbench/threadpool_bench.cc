@@ -0,0 +1,92 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Micro-benchmarks of the background thread pool with short jobs, like file
+// deletions and small flushes, where the cost of queueing a job and waking up
+// a thread for it is not hidden by the job itself.
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "util/threadpool_imp.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+struct JobArg {
+  std::atomic<int64_t> done{0};
+  int64_t job_nanos = 0;
+};
+
+void RunJob(void* arg) {
+  auto* job_arg = static_cast<JobArg*>(arg);
+  if (job_arg->job_nanos > 0) {
+    auto end = std::chrono::steady_clock::now() +
+               std::chrono::nanoseconds(job_arg->job_nanos);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+  job_arg->done.fetch_add(1, std::memory_order_release);
+}
+}  // namespace
+
+// Schedules a batch of jobs, as Env::Schedule() does, and waits for all of
+// them to finish
+static void ThreadPoolSchedule(benchmark::State& state) {
+  const int num_threads = static_cast<int>(state.range(0));
+  const int64_t num_jobs = 1024;
+  ThreadPoolImpl pool;
+  pool.SetBackgroundThreads(num_threads);
+  JobArg arg;
+  arg.job_nanos = state.range(1);
+
+  for (auto _ : state) {
+    arg.done.store(0, std::memory_order_relaxed);
+    for (int64_t i = 0; i < num_jobs; i++) {
+      pool.Schedule(&RunJob, &arg, nullptr, nullptr);
+    }
+    while (arg.done.load(std::memory_order_acquire) < num_jobs) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_jobs);
+  pool.JoinAllThreads();
+}
+
+BENCHMARK(ThreadPoolSchedule)
+    ->ArgsProduct({{1, 4, 32}, {0, 10000}})
+    ->ArgNames({"num_threads", "job_nanos"})
+    ->UseRealTime();
+
+// Schedules one job at a time and waits for it, which measures the latency
+// of waking up an idle thread
+static void ThreadPoolWakeUp(benchmark::State& state) {
+  const int num_threads = static_cast<int>(state.range(0));
+  ThreadPoolImpl pool;
+  pool.SetBackgroundThreads(num_threads);
+  JobArg arg;
+
+  int64_t expected = 0;
+  for (auto _ : state) {
+    pool.Schedule(&RunJob, &arg, nullptr, nullptr);
+    expected++;
+    while (arg.done.load(std::memory_order_acquire) < expected) {
+      std::this_thread::yield();
+    }
+  }
+  pool.JoinAllThreads();
+}
+
+BENCHMARK(ThreadPoolWakeUp)
+    ->Arg(1)
+    ->Arg(32)
+    ->ArgName("num_threads")
+    ->UseRealTime();
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
@@ -17,6 +17,7 @@
 
 #include "port/port.h"
 #include "util/cast_util.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -39,16 +40,29 @@ HistogramBucketMapper::HistogramBucketMapper() {
   }
   maxBucketValue_ = bucketValues_.back();
   minBucketValue_ = bucketValues_.front();
+  assert(bucketValues_.size() <= std::numeric_limits<uint8_t>::max());
+  for (int i = 0; i < 64; ++i) {
+    firstIndexForLog2_[i] = static_cast<uint8_t>(
+        std::lower_bound(bucketValues_.begin(), bucketValues_.end(),
+                         uint64_t{1} << i) -
+        bucketValues_.begin());
+  }
 }
 
 size_t HistogramBucketMapper::IndexForValue(const uint64_t value) const {
-  auto beg = bucketValues_.begin();
-  auto end = bucketValues_.end();
   if (value >= maxBucketValue_) {
-    return end - beg - 1;  // bucketValues_.size() - 1
-  } else {
-    return std::lower_bound(beg, end, value) - beg;
+    return bucketValues_.size() - 1;
+  }
+  if (value == 0) {
+    return 0;
+  }
+  // Same as std::lower_bound() over bucketValues_: no bucket before this one
+  // can hold the value, as their limits are less than 2^FloorLog2(value)
+  size_t index = firstIndexForLog2_[FloorLog2(value)];
+  while (bucketValues_[index] < value) {
+    ++index;
   }
+  return index;
 }
 
 namespace {
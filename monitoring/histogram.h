@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <array>
 #include <cassert>
 #include <map>
 #include <mutex>
@@ -41,6 +42,10 @@ class HistogramBucketMapper {
   std::vector<uint64_t> bucketValues_;
   uint64_t maxBucketValue_;
   uint64_t minBucketValue_;
+  // The index of the first bucket whose limit is at least 2^i. Bucket limits
+  // grow by about 1.5x, so the bucket of a value is found from there in a
+  // step or two rather than by a binary search over all of them.
+  std::array<uint8_t, 64> firstIndexForLog2_;
 };
 
 struct HistogramStat {
@@ -108,6 +108,33 @@ TEST_F(HistogramTest, BoundaryValue) {
   ASSERT_LE(fabs(histogram.Percentile(50.0) - 0.5), kIota);
 }
 
+TEST_F(HistogramTest, IndexForValue) {
+  // A value goes in the first bucket whose limit is not below it
+  const size_t num_buckets = bucketMapper.BucketCount();
+  auto expected_index = [&](uint64_t value) {
+    for (size_t b = 0; b + 1 < num_buckets; ++b) {
+      if (bucketMapper.BucketLimit(b) >= value) {
+        return b;
+      }
+    }
+    return num_buckets - 1;
+  };
+  for (uint64_t value = 0; value < 10000; ++value) {
+    ASSERT_EQ(expected_index(value), bucketMapper.IndexForValue(value));
+  }
+  for (size_t b = 0; b < num_buckets; ++b) {
+    const uint64_t limit = bucketMapper.BucketLimit(b);
+    for (uint64_t value : {limit - 1, limit, limit + 1}) {
+      ASSERT_EQ(expected_index(value), bucketMapper.IndexForValue(value));
+    }
+  }
+  Random rnd(test::RandomSeed());
+  for (int i = 0; i < 10000; ++i) {
+    const uint64_t value = rnd.Next64() >> rnd.Uniform(64);
+    ASSERT_EQ(expected_index(value), bucketMapper.IndexForValue(value));
+  }
+}
+
 TEST_F(HistogramTest, MergeHistogram) {
   HistogramImpl histogram;
   HistogramImpl other;
@@ -24,11 +24,21 @@ Statistics* stats_for_report(SystemClock* clock, Statistics* stats) {
 #endif  // NPERF_CONTEXT
 }  // namespace
 
-void InstrumentedMutex::Lock() {
+void InstrumentedMutex::Lock(const char* file, int line) {
   PERF_CONDITIONAL_TIMER_FOR_MUTEX_GUARD(
       db_mutex_lock_nanos, stats_code_ == DB_MUTEX_WAIT_MICROS,
       stats_for_report(clock_, stats_), stats_code_);
-  LockInternal();
+  if (profiler_ == nullptr) {
+    LockInternal();
+    return;
+  }
+  if (!mutex_.TryLock()) {
+    const MutexContentionProfiler::Wait wait = profiler_->BeginWait();
+    TEST_SYNC_POINT("InstrumentedMutex::Lock:Wait");
+    LockInternal();
+    profiler_->EndWait(wait, file, line);
+  }
+  profiler_->OnLocked(file, line);
 }
 
 void InstrumentedMutex::LockInternal() {
@@ -55,11 +65,18 @@ void InstrumentedMutex::LockInternal() {
   mutex_.Lock();
 }
 
-void InstrumentedCondVar::Wait() {
+void InstrumentedCondVar::Wait(const char* file, int line) {
   PERF_CONDITIONAL_TIMER_FOR_MUTEX_GUARD(
       db_condition_wait_nanos, stats_code_ == DB_MUTEX_WAIT_MICROS,
       stats_for_report(clock_, stats_), stats_code_);
+  MutexContentionProfiler* profiler = mutex_->profiler_;
+  if (profiler != nullptr) {
+    profiler->OnUnlock();
+  }
   WaitInternal();
+  if (profiler != nullptr) {
+    profiler->OnLocked(file, line);
+  }
 }
 
 void InstrumentedCondVar::WaitInternal() {
@@ -69,11 +86,20 @@ void InstrumentedCondVar::WaitInternal() {
   cond_.Wait();
 }
 
-bool InstrumentedCondVar::TimedWait(uint64_t abs_time_us) {
+bool InstrumentedCondVar::TimedWait(uint64_t abs_time_us, const char* file,
+                                    int line) {
   PERF_CONDITIONAL_TIMER_FOR_MUTEX_GUARD(
       db_condition_wait_nanos, stats_code_ == DB_MUTEX_WAIT_MICROS,
       stats_for_report(clock_, stats_), stats_code_);
-  return TimedWaitInternal(abs_time_us);
+  MutexContentionProfiler* profiler = mutex_->profiler_;
+  if (profiler != nullptr) {
+    profiler->OnUnlock();
+  }
+  const bool timed_out = TimedWaitInternal(abs_time_us);
+  if (profiler != nullptr) {
+    profiler->OnLocked(file, line);
+  }
+  return timed_out;
 }
 
 bool InstrumentedCondVar::TimedWaitInternal(uint64_t abs_time_us) {
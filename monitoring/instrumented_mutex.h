@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "monitoring/mutex_contention_profiler.h"
 #include "monitoring/statistics_impl.h"
 #include "port/port.h"
 #include "rocksdb/statistics.h"
@@ -42,12 +43,26 @@ class InstrumentedMutex {
         bg_cv_(bg_cv) {}
 #endif
 
-  void Lock();
+  // The call site is only used by the contention profiler, if any
+  void Lock(const char* file = ROCKSDB_CALLER_FILE,
+            int line = ROCKSDB_CALLER_LINE);
 
-  void Unlock() { mutex_.Unlock(); }
+  void Unlock() {
+    if (profiler_ != nullptr) {
+      profiler_->OnUnlock();
+    }
+    mutex_.Unlock();
+  }
 
   void AssertHeld() const { mutex_.AssertHeld(); }
 
+  // Profiles the contention of the mutex with `profiler` from now on, if not
+  // null. Must be called before the mutex is used, and `profiler` must
+  // outlive the mutex.
+  void SetContentionProfiler(MutexContentionProfiler* profiler) {
+    profiler_ = profiler;
+  }
+
  private:
   void LockInternal();
   friend class InstrumentedCondVar;
@@ -55,6 +70,7 @@ class InstrumentedMutex {
   Statistics* stats_;
   SystemClock* clock_;
   int stats_code_;
+  MutexContentionProfiler* profiler_ = nullptr;
 #ifdef COERCE_CONTEXT_SWITCH
   InstrumentedCondVar* bg_cv_ = nullptr;
 #endif
@@ -70,8 +86,11 @@ static_assert(alignof(CacheAlignedInstrumentedMutex) != CACHE_LINE_SIZE ||
 // RAII wrapper for InstrumentedMutex
 class InstrumentedMutexLock {
  public:
-  explicit InstrumentedMutexLock(InstrumentedMutex* mutex) : mutex_(mutex) {
-    mutex_->Lock();
+  explicit InstrumentedMutexLock(InstrumentedMutex* mutex,
+                                 const char* file = ROCKSDB_CALLER_FILE,
+                                 int line = ROCKSDB_CALLER_LINE)
+      : mutex_(mutex) {
+    mutex_->Lock(file, line);
   }
 
   ~InstrumentedMutexLock() { mutex_->Unlock(); }
@@ -86,14 +105,19 @@ class InstrumentedMutexLock {
 // InstrumentedMutexLock
 class InstrumentedMutexUnlock {
  public:
-  explicit InstrumentedMutexUnlock(InstrumentedMutex* mutex) : mutex_(mutex) {
+  explicit InstrumentedMutexUnlock(InstrumentedMutex* mutex,
+                                   const char* file = ROCKSDB_CALLER_FILE,
+                                   int line = ROCKSDB_CALLER_LINE)
+      : mutex_(mutex), file_(file), line_(line) {
     mutex_->Unlock();
   }
 
-  ~InstrumentedMutexUnlock() { mutex_->Lock(); }
+  ~InstrumentedMutexUnlock() { mutex_->Lock(file_, line_); }
 
  private:
   InstrumentedMutex* const mutex_;
+  const char* const file_;
+  const int line_;
   InstrumentedMutexUnlock(const InstrumentedMutexUnlock&) = delete;
   void operator=(const InstrumentedMutexUnlock&) = delete;
 };
@@ -102,13 +126,18 @@ class InstrumentedCondVar {
  public:
   explicit InstrumentedCondVar(InstrumentedMutex* instrumented_mutex)
       : cond_(&(instrumented_mutex->mutex_)),
+        mutex_(instrumented_mutex),
         stats_(instrumented_mutex->stats_),
         clock_(instrumented_mutex->clock_),
         stats_code_(instrumented_mutex->stats_code_) {}
 
-  void Wait();
+  // The call site is only used by the contention profiler of the mutex, if
+  // any, as the mutex is locked again on return
+  void Wait(const char* file = ROCKSDB_CALLER_FILE,
+            int line = ROCKSDB_CALLER_LINE);
 
-  bool TimedWait(uint64_t abs_time_us);
+  bool TimedWait(uint64_t abs_time_us, const char* file = ROCKSDB_CALLER_FILE,
+                 int line = ROCKSDB_CALLER_LINE);
 
   void Signal() { cond_.Signal(); }
 
@@ -118,6 +147,7 @@ class InstrumentedCondVar {
   void WaitInternal();
   bool TimedWaitInternal(uint64_t abs_time_us);
   port::CondVar cond_;
+  InstrumentedMutex* const mutex_;
   Statistics* stats_;
   SystemClock* clock_;
   int stats_code_;
@@ -0,0 +1,115 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "monitoring/mutex_contention_profiler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <vector>
+
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+std::string MutexContentionProfiler::SiteName(const char* file, int line) {
+  if (file == nullptr || *file == '\0') {
+    return "unknown";
+  }
+  // Drop the directories, which are absolute paths in some builds
+  const char* base = strrchr(file, '/');
+  return std::string(base != nullptr ? base + 1 : file) + ":" +
+         std::to_string(line);
+}
+
+void MutexContentionProfiler::RecordWait(const Wait& wait,
+                                         uint64_t wait_micros,
+                                         const char* file, int line) {
+  WaitEvent event;
+  event.end_micros = wait.start_micros + wait_micros;
+  event.wait_micros = wait_micros;
+  event.waiter_site = SiteName(file, line);
+  event.holder_site = SiteName(wait.holder_file, wait.holder_line);
+  event.holder_micros = wait.holder_micros;
+  event.num_waiters = wait.num_waiters;
+
+  MutexLock l(&mutex_);
+  SiteStats& waiter = sites_[event.waiter_site];
+  waiter.long_waits++;
+  waiter.wait_micros += wait_micros;
+  waiter.max_wait_micros = std::max(waiter.max_wait_micros, wait_micros);
+  waiter.max_waiters = std::max(waiter.max_waiters, wait.num_waiters);
+  sites_[event.holder_site].waits_caused++;
+  wait_events_.push_back(std::move(event));
+  if (wait_events_.size() > kMaxWaitEvents) {
+    wait_events_.pop_front();
+  }
+}
+
+void MutexContentionProfiler::RecordHold(const char* file, int line,
+                                         uint64_t hold_micros) {
+  std::string site = SiteName(file, line);
+  MutexLock l(&mutex_);
+  SiteStats& holder = sites_[site];
+  holder.long_holds++;
+  holder.hold_micros += hold_micros;
+  holder.max_hold_micros = std::max(holder.max_hold_micros, hold_micros);
+}
+
+std::string MutexContentionProfiler::ToString() const {
+  char buf[300];
+  std::string ret;
+  snprintf(buf, sizeof(buf),
+           "Waits and holds of at least %" PRIu64
+           " micros\n"
+           "%-36s %10s %12s %10s %10s %12s %10s %11s %7s\n",
+           threshold_micros_, "Call site", "LongWaits", "WaitMicros",
+           "MaxWait", "LongHolds", "HoldMicros", "MaxHold", "WaitsCaused",
+           "Waiters");
+  ret.append(buf);
+
+  MutexLock l(&mutex_);
+  std::vector<const std::pair<const std::string, SiteStats>*> sites;
+  for (const auto& site : sites_) {
+    sites.push_back(&site);
+  }
+  std::stable_sort(sites.begin(), sites.end(), [](auto* a, auto* b) {
+    return a->second.wait_micros + a->second.hold_micros >
+           b->second.wait_micros + b->second.hold_micros;
+  });
+  for (const auto* site : sites) {
+    const SiteStats& s = site->second;
+    snprintf(buf, sizeof(buf),
+             "%-36s %10" PRIu64 " %12" PRIu64 " %10" PRIu64 " %10" PRIu64
+             " %12" PRIu64 " %10" PRIu64 " %11" PRIu64 " %7" PRIu32 "\n",
+             site->first.c_str(), s.long_waits, s.wait_micros,
+             s.max_wait_micros, s.long_holds, s.hold_micros,
+             s.max_hold_micros, s.waits_caused, s.max_waiters);
+    ret.append(buf);
+  }
+
+  if (!wait_events_.empty()) {
+    ret.append("Last long waits:\n");
+  }
+  for (const auto& event : wait_events_) {
+    snprintf(buf, sizeof(buf),
+             "  at %" PRIu64 " %s waited %" PRIu64
+             " micros for %s (held %" PRIu64 " micros by then), %" PRIu32
+             " waiters\n",
+             event.end_micros, event.waiter_site.c_str(), event.wait_micros,
+             event.holder_site.c_str(), event.holder_micros,
+             event.num_waiters);
+    ret.append(buf);
+  }
+  return ret;
+}
+
+void MutexContentionProfiler::Clear() {
+  MutexLock l(&mutex_);
+  sites_.clear();
+  wait_events_.clear();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,146 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+
+#include "port/port.h"
+#include "rocksdb/system_clock.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The file and line of the caller of a function, when used as default
+// arguments of the function. This is how InstrumentedMutex finds the call
+// sites that lock it without changing them.
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define ROCKSDB_CALLER_FILE __builtin_FILE()
+#define ROCKSDB_CALLER_LINE __builtin_LINE()
+#else
+#define ROCKSDB_CALLER_FILE ""
+#define ROCKSDB_CALLER_LINE 0
+#endif
+
+// Profiles the contention of an InstrumentedMutex by call site. The waits for
+// the mutex and the holds of it that take at least a threshold are counted
+// for the call sites that waited and held. The last long waits are kept with
+// the call site that held the mutex when the wait started, how long it had
+// held it by then, and the number of threads waiting.
+//
+// Uncontended locks are not timed, but every hold is, so profiling takes two
+// clock reads per lock of the mutex.
+class MutexContentionProfiler {
+ public:
+  MutexContentionProfiler(SystemClock* clock, uint64_t threshold_micros)
+      : clock_(clock), threshold_micros_(threshold_micros) {}
+
+  MutexContentionProfiler(const MutexContentionProfiler&) = delete;
+  MutexContentionProfiler& operator=(const MutexContentionProfiler&) = delete;
+
+  struct Wait {
+    uint64_t start_micros;
+    const char* holder_file;
+    int holder_line;
+    uint64_t holder_micros;
+    uint32_t num_waiters;
+  };
+
+  // Called by a thread that did not get the mutex at once
+  Wait BeginWait() {
+    Wait wait;
+    wait.start_micros = clock_->NowMicros();
+    wait.holder_file = holder_file_.LoadRelaxed();
+    wait.holder_line = holder_line_.LoadRelaxed();
+    const uint64_t hold_start = hold_start_micros_.LoadRelaxed();
+    wait.holder_micros =
+        wait.start_micros > hold_start ? wait.start_micros - hold_start : 0;
+    wait.num_waiters = num_waiters_.FetchAddRelaxed(1) + 1;
+    return wait;
+  }
+
+  // Called once the thread of `wait` locked the mutex at the call site
+  void EndWait(const Wait& wait, const char* file, int line) {
+    num_waiters_.FetchSubRelaxed(1);
+    const uint64_t now = clock_->NowMicros();
+    if (now - wait.start_micros >= threshold_micros_) {
+      RecordWait(wait, now - wait.start_micros, file, line);
+    }
+  }
+
+  // Called by the thread that locked the mutex at the call site
+  void OnLocked(const char* file, int line) {
+    holder_file_.StoreRelaxed(file);
+    holder_line_.StoreRelaxed(line);
+    hold_start_micros_.StoreRelaxed(clock_->NowMicros());
+  }
+
+  // Called by the thread holding the mutex before it unlocks it
+  void OnUnlock() {
+    const uint64_t hold_micros =
+        clock_->NowMicros() - hold_start_micros_.LoadRelaxed();
+    if (hold_micros >= threshold_micros_) {
+      RecordHold(holder_file_.LoadRelaxed(), holder_line_.LoadRelaxed(),
+                 hold_micros);
+    }
+  }
+
+  uint64_t threshold_micros() const { return threshold_micros_; }
+
+  // The counts of each call site, from the most to the least time spent in
+  // long waits and holds, and the last long waits
+  std::string ToString() const;
+
+  void Clear();
+
+ private:
+  struct SiteStats {
+    uint64_t long_waits = 0;
+    uint64_t wait_micros = 0;
+    uint64_t max_wait_micros = 0;
+    uint64_t long_holds = 0;
+    uint64_t hold_micros = 0;
+    uint64_t max_hold_micros = 0;
+    // The long waits of other threads that started while this site held the
+    // mutex
+    uint64_t waits_caused = 0;
+    uint32_t max_waiters = 0;
+  };
+
+  struct WaitEvent {
+    uint64_t end_micros;
+    uint64_t wait_micros;
+    std::string waiter_site;
+    std::string holder_site;
+    uint64_t holder_micros;
+    uint32_t num_waiters;
+  };
+
+  static const size_t kMaxWaitEvents = 32;
+
+  static std::string SiteName(const char* file, int line);
+
+  void RecordWait(const Wait& wait, uint64_t wait_micros, const char* file,
+                  int line);
+  void RecordHold(const char* file, int line, uint64_t hold_micros);
+
+  SystemClock* const clock_;
+  const uint64_t threshold_micros_;
+
+  // Written by the holder of the mutex, read by its waiters
+  RelaxedAtomic<const char*> holder_file_{""};
+  RelaxedAtomic<int> holder_line_{0};
+  RelaxedAtomic<uint64_t> hold_start_micros_{0};
+  RelaxedAtomic<uint32_t> num_waiters_{0};
+
+  mutable port::Mutex mutex_;
+  std::map<std::string, SiteStats> sites_;
+  // Oldest first
+  std::deque<WaitEvent> wait_events_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -69,6 +69,7 @@ struct PerfContextByLevelInt {
   defCmd(compressed_sec_cache_compressed_bytes)    \
   defCmd(block_checksum_time)                      \
   defCmd(block_decompress_time)                    \
+  defCmd(zstd_context_create_count)                \
   defCmd(get_read_bytes)                           \
   defCmd(multiget_read_bytes)                      \
   defCmd(iter_read_bytes)                          \
@@ -105,6 +106,10 @@ struct PerfContextByLevelInt {
   defCmd(write_scheduling_flushes_compactions_time)\
   defCmd(write_pre_and_post_process_time)          \
   defCmd(write_thread_wait_nanos)                  \
+  defCmd(write_commit_wait_nanos)                  \
+  defCmd(write_help_other_writers_nanos)           \
+  defCmd(write_memtable_queue_wait_nanos)          \
+  defCmd(write_parallel_memtable_wait_nanos)       \
   defCmd(db_mutex_lock_nanos)                      \
   defCmd(db_condition_wait_nanos)                  \
   defCmd(merge_operator_time_nanos)                \
@@ -0,0 +1,90 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <memory>
+#include <string>
+
+#include "monitoring/perf_level_imp.h"
+#include "options/db_options.h"
+#include "port/likely.h"
+#include "rocksdb/iostats_context.h"
+#include "rocksdb/listener.h"
+#include "rocksdb/perf_context.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Runs about one in DBOptions::perf_context_sample_one_in operations with
+// PerfContext and IOStatsContext enabled, and reports those that took at least
+// perf_context_sample_threshold_micros to the EventListeners. Operations of
+// threads that time perf counters themselves are never sampled. The contexts
+// of the thread, and its perf level, are restored after a sample, so that the
+// counters of a sampled operation are left out of them.
+class PerfContextSampler {
+ public:
+  PerfContextSampler(const ImmutableDBOptions& db_options,
+                     const std::string& db_name, const char* operation)
+      : db_options_(db_options), db_name_(db_name), operation_(operation) {
+    const uint32_t one_in = db_options.perf_context_sample_one_in;
+    if (LIKELY(one_in == 0) || db_options.listeners.empty() ||
+        perf_level >= PerfLevel::kEnableTimeExceptForMutex ||
+        !Random::GetTLSInstance()->OneIn(static_cast<int>(one_in))) {
+      return;
+    }
+    saved_.reset(
+        new Saved{*get_perf_context(), *get_iostats_context(), perf_level});
+    get_perf_context()->Reset();
+    get_iostats_context()->Reset();
+    SetPerfLevel(PerfLevel::kEnableTimeExceptForMutex);
+    start_micros_ = db_options.clock->NowMicros();
+  }
+
+  PerfContextSampler(const PerfContextSampler&) = delete;
+  PerfContextSampler& operator=(const PerfContextSampler&) = delete;
+
+  ~PerfContextSampler() { Finish(Status::OK()); }
+
+  // Ends the sample, if any, of an operation that returned `s`
+  void Finish(const Status& s) {
+    if (LIKELY(saved_ == nullptr)) {
+      return;
+    }
+    const uint64_t elapsed = db_options_.clock->NowMicros() - start_micros_;
+    SetPerfLevel(saved_->perf_level);
+    if (elapsed >= db_options_.perf_context_sample_threshold_micros) {
+      SampledOperationInfo info;
+      info.db_name = db_name_;
+      info.operation = operation_;
+      info.status = s;
+      info.elapsed_micros = elapsed;
+      info.perf_context = get_perf_context();
+      info.iostats_context = get_iostats_context();
+      for (const auto& listener : db_options_.listeners) {
+        listener->OnSampledOperation(info);
+      }
+      info.status.PermitUncheckedError();
+    }
+    *get_perf_context() = saved_->perf_context;
+    *get_iostats_context() = saved_->iostats_context;
+    saved_.reset();
+  }
+
+ private:
+  struct Saved {
+    PerfContext perf_context;
+    IOStatsContext iostats_context;
+    PerfLevel perf_level;
+  };
+
+  const ImmutableDBOptions& db_options_;
+  const std::string& db_name_;
+  const char* const operation_;
+  // The contexts of the thread before the sample, only while sampling
+  std::unique_ptr<Saved> saved_;
+  uint64_t start_micros_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -13,6 +13,8 @@
 #include <utility>
 
 #include "db/db_impl/db_impl.h"
+#include "util/coding.h"
+#include "util/compression.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -27,8 +29,13 @@ const std::string kCompatibleVersionKeyString =
 // designates what type of encoding will be used when writing to stats CF;
 // compatible format version designates the minimum format version that
 // can decode the stats CF encoded using the current format version.
-const uint64_t kStatsCFCurrentFormatVersion = 1;
-const uint64_t kStatsCFCompatibleFormatVersion = 1;
+//
+// Format version 2 replaced the key per stats name of each snapshot by a
+// single key per snapshot. Releases of version 1 cannot read it.
+const uint64_t kStatsCFCurrentFormatVersion = 2;
+const uint64_t kStatsCFCompatibleFormatVersion = 2;
+// compress_format_version of the compressed stats snapshots
+const uint32_t kStatsSnapshotCompressFormatVersion = 2;
 
 Status DecodePersistentStatsVersionNumber(DBImpl* db, StatsVersionKeyType type,
                                           uint64_t* version_number) {
@@ -65,6 +72,161 @@ int EncodePersistentStatsKey(uint64_t now_seconds, const std::string& key,
   return snprintf(buf, size, "%s#%s", timestamp, key.c_str());
 }
 
+void EncodePersistentStatsSnapshot(const std::map<std::string, uint64_t>& stats,
+                                   std::string* value) {
+  std::string raw;
+  PutVarint32(&raw, static_cast<uint32_t>(stats.size()));
+  Slice prev_name;
+  for (const auto& stat : stats) {
+    const Slice name(stat.first);
+    const size_t shared = name.difference_offset(prev_name);
+    PutVarint32Varint32(&raw, static_cast<uint32_t>(shared),
+                        static_cast<uint32_t>(name.size() - shared));
+    raw.append(name.data() + shared, name.size() - shared);
+    PutVarint64(&raw, stat.second);
+    prev_name = name;
+  }
+
+  value->clear();
+  for (CompressionType type : {kZSTD, kLZ4Compression, kSnappyCompression}) {
+    if (!CompressionTypeSupported(type)) {
+      continue;
+    }
+    CompressionOptions opts;
+    CompressionContext context(type, opts);
+    CompressionInfo info(opts, context, CompressionDict::GetEmptyDict(), type,
+                         0 /* sample_for_compression */);
+    std::string compressed;
+    if (CompressData(raw, info, kStatsSnapshotCompressFormatVersion,
+                     &compressed) &&
+        compressed.size() < raw.size()) {
+      value->push_back(static_cast<char>(type));
+      value->append(compressed);
+      return;
+    }
+    break;
+  }
+  value->push_back(static_cast<char>(kNoCompression));
+  value->append(raw);
+}
+
+Status DecodePersistentStatsSnapshot(const Slice& value,
+                                     std::map<std::string, uint64_t>* stats) {
+  if (value.empty()) {
+    return Status::Corruption("Empty persistent stats snapshot");
+  }
+  const CompressionType type = static_cast<CompressionType>(value[0]);
+  Slice input(value.data() + 1, value.size() - 1);
+  CacheAllocationPtr uncompressed;
+  if (type != kNoCompression) {
+    UncompressionContext context(type);
+    UncompressionInfo info(context, UncompressionDict::GetEmptyDict(), type);
+    size_t uncompressed_size = 0;
+    uncompressed =
+        UncompressData(info, input.data(), input.size(), &uncompressed_size,
+                       kStatsSnapshotCompressFormatVersion);
+    if (!uncompressed) {
+      return Status::Corruption("Unable to uncompress persistent stats");
+    }
+    input = Slice(uncompressed.get(), uncompressed_size);
+  }
+
+  uint32_t num_stats = 0;
+  if (!GetVarint32(&input, &num_stats)) {
+    return Status::Corruption("Bad persistent stats snapshot");
+  }
+  std::string name;
+  for (uint32_t i = 0; i < num_stats; i++) {
+    uint32_t shared = 0;
+    uint32_t non_shared = 0;
+    uint64_t stat_value = 0;
+    if (!GetVarint32(&input, &shared) || !GetVarint32(&input, &non_shared) ||
+        shared > name.size() || non_shared > input.size()) {
+      return Status::Corruption("Bad persistent stats snapshot");
+    }
+    name.resize(shared);
+    name.append(input.data(), non_shared);
+    input.remove_prefix(non_shared);
+    if (!GetVarint64(&input, &stat_value)) {
+      return Status::Corruption("Bad persistent stats snapshot");
+    }
+    (*stats)[name] = stat_value;
+  }
+  return Status::OK();
+}
+
+namespace {
+// Returns the key to seek to for the snapshots at or after `now_seconds`
+std::string PersistentStatsTimestamp(uint64_t now_seconds) {
+  char timestamp[kNowSecondsStringLength + 1];
+  snprintf(timestamp, sizeof(timestamp), "%010d",
+           static_cast<int>(now_seconds));
+  return std::string(timestamp, kNowSecondsStringLength);
+}
+
+// Parses the time stamp and the stats name of a key of the persistent stats
+// CF. Returns false for the format version keys.
+bool ParsePersistentStatsKey(const Slice& key, uint64_t* time, Slice* name) {
+  const char* sep =
+      static_cast<const char*>(memchr(key.data(), '#', key.size()));
+  if (sep == nullptr) {
+    return false;
+  }
+  const size_t time_len = static_cast<size_t>(sep - key.data());
+  *time = ParseUint64(std::string(key.data(), time_len));
+  *name = Slice(sep + 1, key.size() - time_len - 1);
+  return true;
+}
+
+// Reads the stats of the snapshot at `time`, whose first key `iter` is at,
+// into `*stats`, leaving `iter` at the first key of the next snapshot
+Status ReadPersistentStatsSnapshot(Iterator* iter, uint64_t time,
+                                   std::map<std::string, uint64_t>* stats) {
+  stats->clear();
+  uint64_t key_time = 0;
+  Slice name;
+  for (; iter->Valid(); iter->Next()) {
+    if (!ParsePersistentStatsKey(iter->key(), &key_time, &name) ||
+        key_time != time) {
+      break;
+    }
+    if (name.empty()) {
+      Status s = DecodePersistentStatsSnapshot(iter->value(), stats);
+      if (!s.ok()) {
+        return s;
+      }
+    } else if (name != kFormatVersionKeyString) {
+      (*stats)[name.ToString()] = ParseUint64(iter->value().ToString());
+    }
+  }
+  return iter->status();
+}
+}  // namespace
+
+Status ReadPersistentStatsHistory(
+    DBImpl* db, uint64_t start_time, uint64_t end_time,
+    const std::function<bool(uint64_t, const std::map<std::string, uint64_t>&)>&
+        callback) {
+  ReadOptions ro;
+  std::unique_ptr<Iterator> iter(
+      db->NewIterator(ro, db->PersistentStatsColumnFamily()));
+  std::map<std::string, uint64_t> stats;
+  uint64_t time = 0;
+  Slice name;
+  for (iter->Seek(PersistentStatsTimestamp(start_time));
+       iter->Valid() && ParsePersistentStatsKey(iter->key(), &time, &name) &&
+       time < end_time;) {
+    Status s = ReadPersistentStatsSnapshot(iter.get(), time, &stats);
+    if (!s.ok()) {
+      return s;
+    }
+    if (!callback(time, stats)) {
+      break;
+    }
+  }
+  return iter->status();
+}
+
 void OptimizeForPersistentStats(ColumnFamilyOptions* cfo) {
   cfo->write_buffer_size = 2 << 20;
   cfo->target_file_size_base = 2 * 1048576;
@@ -92,30 +254,6 @@ PersistentStatsHistoryIterator::GetStatsMap() const {
   return stats_map_;
 }
 
-std::pair<uint64_t, std::string> parseKey(const Slice& key,
-                                          uint64_t start_time) {
-  std::pair<uint64_t, std::string> result;
-  std::string key_str = key.ToString();
-  std::string::size_type pos = key_str.find('#');
-  // TODO(Zhongyi): add counters to track parse failures?
-  if (pos == std::string::npos) {
-    result.first = std::numeric_limits<uint64_t>::max();
-    result.second.clear();
-  } else {
-    uint64_t parsed_time = ParseUint64(key_str.substr(0, pos));
-    // skip entries with timestamp smaller than start_time
-    if (parsed_time < start_time) {
-      result.first = std::numeric_limits<uint64_t>::max();
-      result.second = "";
-    } else {
-      result.first = parsed_time;
-      std::string key_resize = key_str.substr(pos + 1);
-      result.second = key_resize;
-    }
-  }
-  return result;
-}
-
 // advance the iterator to the next time between [start_time, end_time)
 // if success, update time_ and stats_map_ with new_time and stats_map
 void PersistentStatsHistoryIterator::AdvanceIteratorByTime(uint64_t start_time,
@@ -123,45 +261,26 @@ void PersistentStatsHistoryIterator::AdvanceIteratorByTime(uint64_t start_time,
   // try to find next entry in stats_history_ map
   if (db_impl_ != nullptr) {
     ReadOptions ro;
-    Iterator* iter =
-        db_impl_->NewIterator(ro, db_impl_->PersistentStatsColumnFamily());
-
-    char timestamp[kNowSecondsStringLength + 1];
-    snprintf(timestamp, sizeof(timestamp), "%010d",
-             static_cast<int>(std::max(time_, start_time)));
-    timestamp[kNowSecondsStringLength] = '\0';
-
-    iter->Seek(timestamp);
-    // no more entries with timestamp >= start_time is found or version key
-    // is found to be incompatible
-    if (!iter->Valid()) {
+    std::unique_ptr<Iterator> iter(
+        db_impl_->NewIterator(ro, db_impl_->PersistentStatsColumnFamily()));
+    iter->Seek(PersistentStatsTimestamp(std::max(time_, start_time)));
+    // no more entries with timestamp >= start_time is found, or the time
+    // exceeds end_time
+    uint64_t time = 0;
+    Slice name;
+    if (!iter->Valid() || !ParsePersistentStatsKey(iter->key(), &time, &name) ||
+        time > end_time) {
       valid_ = false;
-      delete iter;
+      status_ = iter->status();
       return;
     }
-    time_ = parseKey(iter->key(), start_time).first;
+    time_ = time;
     valid_ = true;
-    // check parsed time and invalid if it exceeds end_time
-    if (time_ > end_time) {
+    // one key per snapshot since format version 2, one per stats name before
+    status_ = ReadPersistentStatsSnapshot(iter.get(), time_, &stats_map_);
+    if (!status_.ok()) {
       valid_ = false;
-      delete iter;
-      return;
-    }
-    // find all entries with timestamp equal to time_
-    std::map<std::string, uint64_t> new_stats_map;
-    std::pair<uint64_t, std::string> kv;
-    for (; iter->Valid(); iter->Next()) {
-      kv = parseKey(iter->key(), start_time);
-      if (kv.first != time_) {
-        break;
-      }
-      if (kv.second.compare(kFormatVersionKeyString) == 0) {
-        continue;
-      }
-      new_stats_map[kv.second] = ParseUint64(iter->value().ToString());
     }
-    stats_map_.swap(new_stats_map);
-    delete iter;
   } else {
     valid_ = false;
   }
@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
+#include <string>
+
 #include "db/db_impl/db_impl.h"
 #include "rocksdb/stats_history.h"
 
@@ -36,6 +40,30 @@ Status DecodePersistentStatsVersionNumber(DBImpl* db, StatsVersionKeyType type,
 int EncodePersistentStatsKey(uint64_t timestamp, const std::string& key,
                              int size, char* buf);
 
+// Since format version 2, each stats snapshot is a single key, the snapshot
+// time stamp with an empty stats name, holding all the stats of the
+// snapshot: sorted by name, each name prefix encoded against the previous
+// one and followed by the value as a varint, compressed with the first
+// compression type supported of ZSTD, LZ4 and Snappy. Format version 1 wrote
+// one key per stats name with the value as a decimal string; such keys are
+// still read.
+void EncodePersistentStatsSnapshot(const std::map<std::string, uint64_t>& stats,
+                                   std::string* value);
+
+// Adds the stats of a snapshot encoded by EncodePersistentStatsSnapshot() to
+// `*stats`
+Status DecodePersistentStatsSnapshot(const Slice& value,
+                                     std::map<std::string, uint64_t>* stats);
+
+// Reads the stats snapshots with time stamps in [start_time, end_time) from
+// the persistent stats CF in a single scan, calling `callback` with the time
+// stamp and the stats of each in time order. Stops early when `callback`
+// returns false.
+Status ReadPersistentStatsHistory(
+    DBImpl* db, uint64_t start_time, uint64_t end_time,
+    const std::function<bool(uint64_t, const std::map<std::string, uint64_t>&)>&
+        callback);
+
 void OptimizeForPersistentStats(ColumnFamilyOptions* cfo);
 
 class PersistentStatsHistoryIterator final : public StatsHistoryIterator {
@@ -271,6 +271,17 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.compressed.secondary.cache.promotions"},
     {COMPRESSED_SECONDARY_CACHE_PROMOTION_SKIPS,
      "rocksdb.compressed.secondary.cache.promotion.skips"},
+    {MULTI_BATCH_WRITE_STOLEN_BYTES, "rocksdb.multi.batch.write.stolen.bytes"},
+    {MEMTABLE_NUMA_REMOTE_BYTES, "rocksdb.memtable.numa.remote.bytes"},
+    {MEMTABLE_ARENA_POOL_HIT, "rocksdb.memtable.arena.pool.hit"},
+    {MEMTABLE_ARENA_POOL_MISS, "rocksdb.memtable.arena.pool.miss"},
+    {FILES_DELETION_DEFERRED_BYTES, "rocksdb.files.deletion.deferred.bytes"},
+    {FILES_DELETION_SLOWED_DOWN, "rocksdb.files.deletion.slowed.down"},
+    {MERGE_RESULT_CACHE_HIT, "rocksdb.merge.result.cache.hit"},
+    {MERGE_RESULT_CACHE_MISS, "rocksdb.merge.result.cache.miss"},
+    {BLOCK_CACHE_FAR_MEMORY_ADD, "rocksdb.block.cache.far.memory.add"},
+    {BLOCK_CACHE_FAR_MEMORY_PROMOTE, "rocksdb.block.cache.far.memory.promote"},
+    {MEMTABLE_FAR_MEMORY_BYTES, "rocksdb.memtable.far.memory.bytes"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -340,6 +351,16 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {ASYNC_PREFETCH_ABORT_MICROS, "rocksdb.async.prefetch.abort.micros"},
     {TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
      "rocksdb.table.open.prefetch.tail.read.bytes"},
+    {MULTI_BATCH_WRITE_MEMTABLE_MICROS,
+     "rocksdb.multi.batch.write.memtable.micros"},
+    {MULTI_BATCH_WRITE_COMMIT_WAIT_MICROS,
+     "rocksdb.multi.batch.write.commit.wait.micros"},
+    {PIPELINED_WRITE_MEMTABLE_WAIT_MICROS,
+     "rocksdb.pipelined.write.memtable.wait.micros"},
+    {IO_SCHEDULER_QUEUE_LOW_MICROS, "rocksdb.io.scheduler.queue.low.micros"},
+    {IO_SCHEDULER_QUEUE_MID_MICROS, "rocksdb.io.scheduler.queue.mid.micros"},
+    {IO_SCHEDULER_QUEUE_HIGH_MICROS, "rocksdb.io.scheduler.queue.high.micros"},
+    {IO_SCHEDULER_QUEUE_USER_MICROS, "rocksdb.io.scheduler.queue.user.micros"},
 };
 
 static int RegisterBuiltinStatistics(ObjectLibrary& library,
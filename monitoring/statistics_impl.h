@@ -59,6 +59,7 @@ class StatisticsImpl : public Statistics {
                                  uint64_t value) override;
 
   virtual Status Reset() override;
+  Status Merge(const Statistics& other) override;
   virtual std::string ToString() const override;
   virtual bool getTickerMap(std::map<std::string, uint64_t>*) const override;
   virtual bool HistEnabledForType(uint32_t type) const override;
@@ -283,6 +284,44 @@ Status StatisticsImpl<TICKER_MAX, HISTOGRAM_MAX>::Reset() {
   return Status::OK();
 }
 
+template <uint32_t TICKER_MAX, uint32_t HISTOGRAM_MAX>
+Status StatisticsImpl<TICKER_MAX, HISTOGRAM_MAX>::Merge(
+    const Statistics& other) {
+  if (!other.IsInstanceOf(kClassName())) {
+    return Status::NotSupported("Cannot merge statistics of ", other.Name());
+  }
+  const auto& other_impl =
+      static_cast<const StatisticsImpl<TICKER_MAX, HISTOGRAM_MAX>&>(other);
+  // Only one of the aggregate locks is held at a time, so that merges in
+  // both directions cannot deadlock
+  std::vector<uint64_t> tickers(TICKER_MAX);
+  {
+    MutexLock lock(&other_impl.aggregate_lock_);
+    for (uint32_t i = 0; i < TICKER_MAX; ++i) {
+      tickers[i] = other_impl.getTickerCountLocked(i);
+    }
+  }
+  {
+    MutexLock lock(&aggregate_lock_);
+    for (uint32_t i = 0; i < TICKER_MAX; ++i) {
+      per_core_stats_.AccessAtCore(0)->tickers_[i].fetch_add(
+          tickers[i], std::memory_order_relaxed);
+    }
+  }
+  for (uint32_t i = 0; i < HISTOGRAM_MAX; ++i) {
+    std::unique_ptr<HistogramImpl> hist;
+    {
+      MutexLock lock(&other_impl.aggregate_lock_);
+      hist = other_impl.getHistogramImplLocked(i);
+    }
+    if (!hist->Empty()) {
+      MutexLock lock(&aggregate_lock_);
+      per_core_stats_.AccessAtCore(0)->histograms_[i].Merge(*hist);
+    }
+  }
+  return Status::OK();
+}
+
 namespace {
 
 // a buffer size used for temp string buffers
@@ -79,6 +79,61 @@ TEST_F(StatisticsTest, NoNameStats) {
   ASSERT_NE(stats->inner, nullptr);
   ASSERT_NE("", stats->inner->ToString(options));  // ... even if it does...
 }
+
+TEST_F(StatisticsTest, Merge) {
+  auto stats1 = CreateDBStatistics();
+  auto stats2 = CreateDBStatistics();
+  auto all = CreateDBStatistics();
+  for (int i = 0; i < 1000; ++i) {
+    const uint64_t value = 10 + i % 7;
+    stats1->recordInHistogram(DB_GET, value);
+    all->recordInHistogram(DB_GET, value);
+  }
+  for (int i = 0; i < 20; ++i) {
+    const uint64_t value = 50000 + i;
+    stats2->recordInHistogram(DB_GET, value);
+    all->recordInHistogram(DB_GET, value);
+  }
+  stats1->recordTick(NUMBER_KEYS_READ, 3);
+  stats2->recordTick(NUMBER_KEYS_READ, 4);
+
+  auto merged = CreateDBStatistics();
+  ASSERT_OK(merged->Merge(*stats1));
+  ASSERT_OK(merged->Merge(*stats2));
+  ASSERT_EQ(7U, merged->getTickerCount(NUMBER_KEYS_READ));
+  // The same percentiles as if all the values were recorded in one place
+  HistogramData merged_data;
+  HistogramData all_data;
+  merged->histogramData(DB_GET, &merged_data);
+  all->histogramData(DB_GET, &all_data);
+  ASSERT_EQ(all_data.count, merged_data.count);
+  ASSERT_EQ(all_data.sum, merged_data.sum);
+  ASSERT_EQ(all_data.median, merged_data.median);
+  ASSERT_EQ(all_data.percentile99, merged_data.percentile99);
+  ASSERT_EQ(all_data.max, merged_data.max);
+  ASSERT_GT(merged_data.percentile99, 10000);
+  // The merged statistics are left as they are
+  ASSERT_EQ(3U, stats1->getTickerCount(NUMBER_KEYS_READ));
+  stats1->histogramData(DB_GET, &merged_data);
+  ASSERT_EQ(1000U, merged_data.count);
+
+  class CustomStatistics : public Statistics {
+   public:
+    uint64_t getTickerCount(uint32_t /*tickerType*/) const override {
+      return 0;
+    }
+    void histogramData(uint32_t /*type*/,
+                       HistogramData* const /*data*/) const override {}
+    void recordTick(uint32_t /*tickerType*/, uint64_t /*count*/) override {}
+    void setTickerCount(uint32_t /*tickerType*/, uint64_t /*count*/) override {}
+    uint64_t getAndResetTickerCount(uint32_t /*tickerType*/) override {
+      return 0;
+    }
+  };
+  CustomStatistics custom;
+  ASSERT_TRUE(merged->Merge(custom).IsNotSupported());
+  ASSERT_TRUE(custom.Merge(*stats1).IsNotSupported());
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -334,9 +334,9 @@ TEST_F(StatsHistoryTest, GetStatsHistoryFromDisk) {
       db_->NewIterator(ReadOptions(), dbfull()->PersistentStatsColumnFamily());
   int key_count3 = countkeys(iter);
   delete iter;
-  ASSERT_GE(key_count2, key_count1);
-  ASSERT_GE(key_count3, key_count2);
-  ASSERT_EQ(key_count3 - key_count2, key_count2 - key_count1);
+  // a single key per stats snapshot
+  ASSERT_EQ(key_count2 - key_count1, 1);
+  ASSERT_EQ(key_count3 - key_count2, 1);
   std::unique_ptr<StatsHistoryIterator> stats_iter;
   ASSERT_OK(
       db_->GetStatsHistory(0, mock_clock_->NowSeconds() + 1, &stats_iter));
@@ -357,7 +357,8 @@ TEST_F(StatsHistoryTest, GetStatsHistoryFromDisk) {
   }
   ASSERT_EQ(slice_count, 3);
   // 2 extra keys for format version
-  ASSERT_EQ(stats_count, key_count3 - 2);
+  ASSERT_EQ(slice_count, key_count3 - 2);
+  ASSERT_GT(stats_count, static_cast<size_t>(slice_count));
   // verify reopen will not cause data loss
   ReopenWithColumnFamilies({"default", "pikachu"}, options);
   ASSERT_OK(
@@ -471,7 +472,96 @@ TEST_F(StatsHistoryTest, PersitentStatsVerifyValue) {
   Close();
 }
 
-// TODO(Zhongyi): add test for different format versions
+TEST_F(StatsHistoryTest, PersistentStatsSnapshotEncoding) {
+  std::map<std::string, uint64_t> stats = {{"rocksdb.block.cache.hit", 0},
+                                           {"rocksdb.block.cache.miss", 17},
+                                           {"rocksdb.bytes.read", 1ull << 40},
+                                           {"rocksdb.bytes.written", 42}};
+  std::string value;
+  EncodePersistentStatsSnapshot(stats, &value);
+  std::map<std::string, uint64_t> decoded;
+  ASSERT_OK(DecodePersistentStatsSnapshot(value, &decoded));
+  ASSERT_EQ(stats, decoded);
+
+  EncodePersistentStatsSnapshot({}, &value);
+  decoded.clear();
+  ASSERT_OK(DecodePersistentStatsSnapshot(value, &decoded));
+  ASSERT_TRUE(decoded.empty());
+
+  ASSERT_TRUE(DecodePersistentStatsSnapshot("", &decoded).IsCorruption());
+  EncodePersistentStatsSnapshot(stats, &value);
+  value.resize(value.size() - 1);
+  ASSERT_NOK(DecodePersistentStatsSnapshot(value, &decoded));
+}
+
+TEST_F(StatsHistoryTest, GetTickerHistoryFromDisk) {
+  constexpr int kPeriodSec = 5;
+  Options options;
+  options.create_if_missing = true;
+  options.stats_persist_period_sec = kPeriodSec;
+  options.statistics = CreateDBStatistics();
+  options.persist_stats_to_disk = true;
+  options.env = mock_env_.get();
+  ASSERT_OK(TryReopen(options));
+  ASSERT_OK(Put("foo", "bar"));
+
+  // Wait for the first stats persist to finish, as the initial delay could be
+  // different.
+  dbfull()->TEST_WaitForPeriodicTaskRun(
+      [&] { mock_clock_->MockSleepForSeconds(kPeriodSec - 1); });
+  for (int i = 1; i <= 3; i++) {
+    for (int j = 0; j < i; j++) {
+      ASSERT_EQ("bar", Get("foo"));
+    }
+    dbfull()->TEST_WaitForPeriodicTaskRun(
+        [&] { mock_clock_->MockSleepForSeconds(kPeriodSec); });
+  }
+
+  // A snapshot written by format version 1, with a key per ticker
+  char key[100];
+  int length =
+      EncodePersistentStatsKey(1, "rocksdb.number.keys.read", 100, key);
+  ASSERT_OK(db_->Put(WriteOptions(), dbfull()->PersistentStatsColumnFamily(),
+                     Slice(key, length), "7"));
+
+  const std::string ticker = "rocksdb.number.keys.read";
+  std::vector<std::pair<uint64_t, uint64_t>> history;
+  ASSERT_OK(db_->GetTickerHistory(ticker, 0, mock_clock_->NowSeconds() + 1,
+                                  &history));
+  std::vector<std::pair<uint64_t, uint64_t>> expected = {
+      {1, 7}, {9, 1}, {14, 2}, {19, 3}};
+  ASSERT_EQ(expected, history);
+
+  ASSERT_OK(db_->GetTickerHistory(ticker, 9, 19, &history));
+  expected = {{9, 1}, {14, 2}};
+  ASSERT_EQ(expected, history);
+
+  // The stats history iterator reads both formats alike
+  std::unique_ptr<StatsHistoryIterator> stats_iter;
+  ASSERT_OK(db_->GetStatsHistory(0, 9, &stats_iter));
+  ASSERT_TRUE(stats_iter->Valid());
+  ASSERT_EQ(1, stats_iter->GetStatsTime());
+  ASSERT_EQ(1, stats_iter->GetStatsMap().size());
+  stats_iter->Next();
+  ASSERT_TRUE(stats_iter->Valid());
+  ASSERT_EQ(9, stats_iter->GetStatsTime());
+  ASSERT_EQ(1, stats_iter->GetStatsMap().at(ticker));
+  stats_iter.reset();
+
+  // An older format version is upgraded on open, so that older releases
+  // recreate the CF instead of misreading it
+  ASSERT_OK(db_->Put(WriteOptions(), dbfull()->PersistentStatsColumnFamily(),
+                     kFormatVersionKeyString, "1"));
+  Reopen(options);
+  uint64_t format_version = 0;
+  ASSERT_OK(DecodePersistentStatsVersionNumber(
+      dbfull(), StatsVersionKeyType::kFormatVersion, &format_version));
+  ASSERT_EQ(kStatsCFCurrentFormatVersion, format_version);
+  ASSERT_OK(db_->GetTickerHistory(ticker, 0, mock_clock_->NowSeconds() + 1,
+                                  &history));
+  ASSERT_EQ(4, history.size());
+  Close();
+}
 
 TEST_F(StatsHistoryTest, PersistentStatsCreateColumnFamilies) {
   constexpr int kPeriodSec = 5;
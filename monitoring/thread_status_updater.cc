@@ -84,6 +84,7 @@ void ThreadStatusUpdater::SetThreadOperation(
   //       have a consistent information on its properties.
   data->operation_type.store(type, std::memory_order_release);
   if (type == ThreadStatus::OP_UNKNOWN) {
+    ChargeOperationStage(data);
     data->operation_stage.store(ThreadStatus::STAGE_UNKNOWN,
                                 std::memory_order_relaxed);
     ClearThreadOperationProperties();
@@ -128,6 +129,7 @@ void ThreadStatusUpdater::ClearThreadOperation() {
   if (data == nullptr) {
     return;
   }
+  ChargeOperationStage(data);
   data->operation_stage.store(ThreadStatus::STAGE_UNKNOWN,
                               std::memory_order_relaxed);
   data->operation_type.store(ThreadStatus::OP_UNKNOWN,
@@ -151,9 +153,47 @@ ThreadStatus::OperationStage ThreadStatusUpdater::SetThreadOperationStage(
   if (data == nullptr) {
     return ThreadStatus::STAGE_UNKNOWN;
   }
+  ChargeOperationStage(data);
   return data->operation_stage.exchange(stage, std::memory_order_relaxed);
 }
 
+void ThreadStatusUpdater::ChargeOperationStage(ThreadStatusData* data) {
+  // A clock_gettime() of the thread CPU time is cheaper than a
+  // getrusage(RUSAGE_THREAD), and stages change only a few times per job
+  auto* clock = SystemClock::Default().get();
+  const uint64_t now_micros = clock->NowMicros();
+  const uint64_t now_cpu_micros = clock->CPUMicros();
+  auto stage = data->operation_stage.load(std::memory_order_relaxed);
+  if (stage > ThreadStatus::STAGE_UNKNOWN &&
+      stage < ThreadStatus::NUM_OP_STAGES) {
+    if (now_micros > data->stage_start_micros) {
+      data->stage_elapsed_micros[stage].fetch_add(
+          now_micros - data->stage_start_micros, std::memory_order_relaxed);
+    }
+    if (now_cpu_micros > data->stage_start_cpu_micros) {
+      data->stage_cpu_micros[stage].fetch_add(
+          now_cpu_micros - data->stage_start_cpu_micros,
+          std::memory_order_relaxed);
+    }
+  }
+  data->stage_start_micros = now_micros;
+  data->stage_start_cpu_micros = now_cpu_micros;
+}
+
+void ThreadStatusUpdater::GetThreadStageTimes(ThreadStageTimes* times) {
+  auto* data = GetLocalThreadStatus();
+  if (data == nullptr) {
+    return;
+  }
+  ChargeOperationStage(data);
+  for (int i = 0; i < ThreadStatus::NUM_OP_STAGES; ++i) {
+    times->cpu_micros[i] =
+        data->stage_cpu_micros[i].load(std::memory_order_relaxed);
+    times->elapsed_micros[i] =
+        data->stage_elapsed_micros[i].load(std::memory_order_relaxed);
+  }
+}
+
 void ThreadStatusUpdater::SetThreadState(const ThreadStatus::StateType type) {
   auto* data = GetLocalThreadStatus();
   if (data == nullptr) {
@@ -214,6 +254,12 @@ Status ThreadStatusUpdater::GetThreadList(
         iter != cf_info_map_.end() ? iter->second.db_name : "",
         iter != cf_info_map_.end() ? iter->second.cf_name : "", op_type,
         op_elapsed_micros, op_stage, op_props, state_type);
+    for (int i = 0; i < ThreadStatus::NUM_OP_STAGES; ++i) {
+      thread_list->back().stage_cpu_micros[i] =
+          thread_data->stage_cpu_micros[i].load(std::memory_order_relaxed);
+      thread_list->back().stage_elapsed_micros[i] =
+          thread_data->stage_elapsed_micros[i].load(std::memory_order_relaxed);
+    }
   }
 
   return Status::OK();
@@ -298,6 +344,8 @@ void ThreadStatusUpdater::SetThreadOperation(
 
 void ThreadStatusUpdater::ClearThreadOperation() {}
 
+void ThreadStatusUpdater::GetThreadStageTimes(ThreadStageTimes* /*times*/) {}
+
 void ThreadStatusUpdater::SetThreadState(
     const ThreadStatus::StateType /*type*/) {}
 
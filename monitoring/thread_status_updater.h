@@ -60,6 +60,26 @@ struct ConstantColumnFamilyInfo {
 
 // the internal data-structure that is used to reflect the current
 // status of a thread using a set of atomic pointers.
+// The CPU and wall time in microseconds spent in each operation stage
+struct ThreadStageTimes {
+  uint64_t cpu_micros[ThreadStatus::NUM_OP_STAGES] = {};
+  uint64_t elapsed_micros[ThreadStatus::NUM_OP_STAGES] = {};
+
+  void Add(const ThreadStageTimes& other) {
+    for (int i = 0; i < ThreadStatus::NUM_OP_STAGES; ++i) {
+      cpu_micros[i] += other.cpu_micros[i];
+      elapsed_micros[i] += other.elapsed_micros[i];
+    }
+  }
+
+  void Subtract(const ThreadStageTimes& other) {
+    for (int i = 0; i < ThreadStatus::NUM_OP_STAGES; ++i) {
+      cpu_micros[i] -= other.cpu_micros[i];
+      elapsed_micros[i] -= other.elapsed_micros[i];
+    }
+  }
+};
+
 struct ThreadStatusData {
 #ifdef ROCKSDB_USING_THREAD_STATUS
   explicit ThreadStatusData() {
@@ -69,7 +89,12 @@ struct ThreadStatusData {
     cf_key.store(nullptr);
     operation_type.store(ThreadStatus::OP_UNKNOWN);
     op_start_time.store(0);
+    operation_stage.store(ThreadStatus::STAGE_UNKNOWN);
     state_type.store(ThreadStatus::STATE_UNKNOWN);
+    for (int i = 0; i < ThreadStatus::NUM_OP_STAGES; ++i) {
+      stage_cpu_micros[i].store(0);
+      stage_elapsed_micros[i].store(0);
+    }
   }
 
   // A flag to indicate whether the thread tracking is enabled
@@ -86,6 +111,14 @@ struct ThreadStatusData {
   std::atomic<ThreadStatus::OperationStage> operation_stage;
   std::atomic<uint64_t> op_properties[ThreadStatus::kNumOperationProperties];
   std::atomic<ThreadStatus::StateType> state_type;
+
+  // The time spent in each operation stage, charged to the stage when the
+  // thread leaves it
+  std::atomic<uint64_t> stage_cpu_micros[ThreadStatus::NUM_OP_STAGES];
+  std::atomic<uint64_t> stage_elapsed_micros[ThreadStatus::NUM_OP_STAGES];
+  // When the thread entered its current stage. Only accessed by the thread.
+  uint64_t stage_start_cpu_micros = 0;
+  uint64_t stage_start_micros = 0;
 #endif  // ROCKSDB_USING_THREAD_STATUS
 };
 
@@ -153,6 +186,10 @@ class ThreadStatusUpdater {
   ThreadStatus::OperationStage SetThreadOperationStage(
       const ThreadStatus::OperationStage stage);
 
+  // Stores in `times` the time the current thread spent in each operation
+  // stage, including its current stage up to now.
+  void GetThreadStageTimes(ThreadStageTimes* times);
+
   // Clear thread operation of the current thread.
   void ClearThreadOperation();
 
@@ -202,6 +239,10 @@ class ThreadStatusUpdater {
   // checking whether enabling_tracking is true of not.
   ThreadStatusData* Get() { return thread_status_data_; }
 
+  // Charges the time since the current thread entered its current operation
+  // stage to the stage, and restarts the timing of the stage.
+  void ChargeOperationStage(ThreadStatusData* data);
+
   // The mutex that protects cf_info_map and db_key_map.
   std::mutex thread_list_mutex_;
 
@@ -82,6 +82,13 @@ ThreadStatus::OperationStage ThreadStatusUtil::SetThreadOperationStage(
   return thread_updater_local_cache_->SetThreadOperationStage(stage);
 }
 
+void ThreadStatusUtil::GetThreadStageTimes(ThreadStageTimes* times) {
+  if (thread_updater_local_cache_ == nullptr) {
+    return;
+  }
+  thread_updater_local_cache_->GetThreadStageTimes(times);
+}
+
 void ThreadStatusUtil::SetThreadOperationProperty(int code, uint64_t value) {
   if (thread_updater_local_cache_ == nullptr) {
     // thread_updater_local_cache_ must be set in SetColumnFamily
@@ -179,6 +186,8 @@ void ThreadStatusUtil::SetColumnFamily(const ColumnFamilyData* /*cfd*/) {}
 
 void ThreadStatusUtil::SetThreadOperation(ThreadStatus::OperationType /*op*/) {}
 
+void ThreadStatusUtil::GetThreadStageTimes(ThreadStageTimes* /*times*/) {}
+
 void ThreadStatusUtil::SetThreadOperationProperty(int /*code*/,
                                                   uint64_t /*value*/) {}
 
@@ -67,6 +67,10 @@ class ThreadStatusUtil {
   static ThreadStatus::OperationStage SetThreadOperationStage(
       ThreadStatus::OperationStage stage);
 
+  // Stores in `times` the time the current thread spent in each operation
+  // stage, or leaves it unchanged if the thread is not tracked.
+  static void GetThreadStageTimes(ThreadStageTimes* times);
+
   static void SetThreadOperationProperty(int code, uint64_t value);
 
   static void IncreaseThreadOperationProperty(int code, uint64_t delta);
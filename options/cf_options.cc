@@ -176,6 +176,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"checksum",
          {offsetof(struct CompressionOptions, checksum), OptionType::kBoolean,
           OptionVerificationType::kNormal, OptionTypeFlags::kMutable}},
+        {"adaptive_tolerance_pct",
+         {offsetof(struct CompressionOptions, adaptive_tolerance_pct),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -214,7 +218,12 @@ static std::unordered_map<std::string, OptionTypeInfo>
              OptionTypeInfo::Struct("file_temperature_age_thresholds",
                                     &file_temperature_age_type_info, 0,
                                     OptionVerificationType::kNormal,
-                                    OptionTypeFlags::kMutable))}};
+                                    OptionTypeFlags::kMutable))},
+        {"allow_trivial_copy_when_change_temperature",
+         {offsetof(struct CompactionOptionsFIFO,
+                   allow_trivial_copy_when_change_temperature),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}}};
 
 static std::unordered_map<std::string, OptionTypeInfo>
     universal_compaction_options_type_info = {
@@ -250,6 +259,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"allow_trivial_move",
          {offsetof(class CompactionOptionsUniversal, allow_trivial_move),
           OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"incremental_fallback_to_full_compaction",
+         {offsetof(class CompactionOptionsUniversal,
+                   incremental_fallback_to_full_compaction),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}}};
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -266,6 +280,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, disable_write_stall),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"smooth_write_slowdown",
+         {offsetof(struct MutableCFOptions, smooth_write_slowdown),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"filter_deletes",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -277,6 +295,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, paranoid_file_checks),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"flush_to_lowest_level",
+         {offsetof(struct MutableCFOptions, flush_to_lowest_level),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"verify_checksums_in_compaction",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -395,6 +417,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, max_sequential_skip_in_iterations),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"adapt_max_sequential_skip_in_iterations",
+         {offsetof(struct MutableCFOptions,
+                   adapt_max_sequential_skip_in_iterations),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"target_file_size_base",
          {offsetof(struct MutableCFOptions, target_file_size_base),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -445,6 +472,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, periodic_compaction_seconds),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"compaction_read_heat_weight",
+         {offsetof(struct MutableCFOptions, compaction_read_heat_weight),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"bottommost_temperature",
          {0, OptionType::kTemperature, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -456,6 +487,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, enable_blob_files),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"adaptive_min_blob_size",
+         {offsetof(struct MutableCFOptions, adaptive_min_blob_size),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"min_blob_size",
          {offsetof(struct MutableCFOptions, min_blob_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -468,6 +503,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, blob_compression_type),
           OptionType::kCompressionType, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"blob_compression_max_dict_bytes",
+         {offsetof(struct MutableCFOptions, blob_compression_max_dict_bytes),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"enable_blob_garbage_collection",
          {offsetof(struct MutableCFOptions, enable_blob_garbage_collection),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -493,6 +532,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          OptionTypeInfo::Enum<PrepopulateBlobCache>(
              offsetof(struct MutableCFOptions, prepopulate_blob_cache),
              &prepopulate_blob_cache_string_map, OptionTypeFlags::kMutable)},
+        {"blob_cache_max_garbage_ratio",
+         {offsetof(struct MutableCFOptions, blob_cache_max_garbage_ratio),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"sample_for_compression",
          {offsetof(struct MutableCFOptions, sample_for_compression),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -593,6 +636,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableCFOptions, inplace_update_support),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"inplace_merge_operands",
+         {offsetof(struct ImmutableCFOptions, inplace_merge_operands),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"level_compaction_dynamic_level_bytes",
          {offsetof(struct ImmutableCFOptions,
                    level_compaction_dynamic_level_bytes),
@@ -603,10 +650,19 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    level_compaction_dynamic_file_size),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"drop_files_covered_by_range_deletions",
+         {offsetof(struct ImmutableCFOptions,
+                   drop_files_covered_by_range_deletions),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"optimize_filters_for_hits",
          {offsetof(struct ImmutableCFOptions, optimize_filters_for_hits),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"merge_result_cache_size",
+         {offsetof(struct ImmutableCFOptions, merge_result_cache_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"force_consistency_checks",
          {offsetof(struct ImmutableCFOptions, force_consistency_checks),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -941,6 +997,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
       max_write_buffer_size_to_maintain(
           cf_options.max_write_buffer_size_to_maintain),
       inplace_update_support(cf_options.inplace_update_support),
+      inplace_merge_operands(cf_options.inplace_merge_operands),
       inplace_callback(cf_options.inplace_callback),
       memtable_factory(cf_options.memtable_factory),
       table_factory(cf_options.table_factory),
@@ -951,8 +1008,11 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
           cf_options.level_compaction_dynamic_level_bytes),
       level_compaction_dynamic_file_size(
           cf_options.level_compaction_dynamic_file_size),
+      drop_files_covered_by_range_deletions(
+          cf_options.drop_files_covered_by_range_deletions),
       num_levels(cf_options.num_levels),
       optimize_filters_for_hits(cf_options.optimize_filters_for_hits),
+      merge_result_cache_size(cf_options.merge_result_cache_size),
       force_consistency_checks(cf_options.force_consistency_checks),
       default_temperature(cf_options.default_temperature),
       preclude_last_level_data_seconds(
@@ -1075,6 +1135,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  disable_auto_compactions);
   ROCKS_LOG_INFO(log, "                      disable_write_stall: %d",
                  disable_write_stall);
+  ROCKS_LOG_INFO(log, "                    smooth_write_slowdown: %d",
+                 smooth_write_slowdown);
   ROCKS_LOG_INFO(log, "      soft_pending_compaction_bytes_limit: %" PRIu64,
                  soft_pending_compaction_bytes_limit);
   ROCKS_LOG_INFO(log, "      hard_pending_compaction_bytes_limit: %" PRIu64,
@@ -1101,6 +1163,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  ttl);
   ROCKS_LOG_INFO(log, "              periodic_compaction_seconds: %" PRIu64,
                  periodic_compaction_seconds);
+  ROCKS_LOG_INFO(log, "              compaction_read_heat_weight: %f",
+                 compaction_read_heat_weight);
   std::string result;
   char buf[10];
   for (const auto m : max_bytes_for_level_multiplier_additional) {
@@ -1117,10 +1181,14 @@ void MutableCFOptions::Dump(Logger* log) const {
                  result.c_str());
   ROCKS_LOG_INFO(log, "        max_sequential_skip_in_iterations: %" PRIu64,
                  max_sequential_skip_in_iterations);
+  ROCKS_LOG_INFO(log, "  adapt_max_sequential_skip_in_iterations: %d",
+                 adapt_max_sequential_skip_in_iterations);
   ROCKS_LOG_INFO(log, "         check_flush_compaction_key_order: %d",
                  check_flush_compaction_key_order);
   ROCKS_LOG_INFO(log, "                     paranoid_file_checks: %d",
                  paranoid_file_checks);
+  ROCKS_LOG_INFO(log, "                    flush_to_lowest_level: %d",
+                 flush_to_lowest_level);
   ROCKS_LOG_INFO(log, "                       report_bg_io_stats: %d",
                  report_bg_io_stats);
   ROCKS_LOG_INFO(log, "                              compression: %d",
@@ -1151,22 +1219,37 @@ void MutableCFOptions::Dump(Logger* log) const {
       static_cast<int>(compaction_options_universal.allow_trivial_move));
   ROCKS_LOG_INFO(log, "compaction_options_universal.incremental        : %d",
                  static_cast<int>(compaction_options_universal.incremental));
+  ROCKS_LOG_INFO(
+      log,
+      "compaction_options_universal.incremental_fallback_to_full_compaction"
+      " : %d",
+      static_cast<int>(compaction_options_universal
+                           .incremental_fallback_to_full_compaction));
 
   // FIFO Compaction Options
   ROCKS_LOG_INFO(log, "compaction_options_fifo.max_table_files_size : %" PRIu64,
                  compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_INFO(log, "compaction_options_fifo.allow_compaction : %d",
                  compaction_options_fifo.allow_compaction);
+  ROCKS_LOG_INFO(
+      log,
+      "compaction_options_fifo.allow_trivial_copy_when_change_temperature : "
+      "%d",
+      compaction_options_fifo.allow_trivial_copy_when_change_temperature);
 
   // Blob file related options
   ROCKS_LOG_INFO(log, "                        enable_blob_files: %s",
                  enable_blob_files ? "true" : "false");
+  ROCKS_LOG_INFO(log, "                   adaptive_min_blob_size: %s",
+                 adaptive_min_blob_size ? "true" : "false");
   ROCKS_LOG_INFO(log, "                            min_blob_size: %" PRIu64,
                  min_blob_size);
   ROCKS_LOG_INFO(log, "                           blob_file_size: %" PRIu64,
                  blob_file_size);
   ROCKS_LOG_INFO(log, "                    blob_compression_type: %s",
                  CompressionTypeToString(blob_compression_type).c_str());
+  ROCKS_LOG_INFO(log, "          blob_compression_max_dict_bytes: %" PRIu32,
+                 blob_compression_max_dict_bytes);
   ROCKS_LOG_INFO(log, "           enable_blob_garbage_collection: %s",
                  enable_blob_garbage_collection ? "true" : "false");
   ROCKS_LOG_INFO(log, "       blob_garbage_collection_age_cutoff: %f",
@@ -1181,6 +1264,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  prepopulate_blob_cache == PrepopulateBlobCache::kFlushOnly
                      ? "flush only"
                      : "disable");
+  ROCKS_LOG_INFO(log, "             blob_cache_max_garbage_ratio: %f",
+                 blob_cache_max_garbage_ratio);
   ROCKS_LOG_INFO(log, "                   last_level_temperature: %d",
                  static_cast<int>(last_level_temperature));
 }
@@ -46,6 +46,8 @@ struct ImmutableCFOptions {
 
   bool inplace_update_support;
 
+  bool inplace_merge_operands;
+
   UpdateStatus (*inplace_callback)(char* existing_value,
                                    uint32_t* existing_value_size,
                                    Slice delta_value,
@@ -66,10 +68,14 @@ struct ImmutableCFOptions {
 
   bool level_compaction_dynamic_file_size;
 
+  bool drop_files_covered_by_range_deletions;
+
   int num_levels;
 
   bool optimize_filters_for_hits;
 
+  size_t merge_result_cache_size;
+
   bool force_consistency_checks;
 
   Temperature default_temperature;
@@ -126,6 +132,7 @@ struct MutableCFOptions {
             options.experimental_mempurge_threshold),
         disable_auto_compactions(options.disable_auto_compactions),
         disable_write_stall(options.disable_write_stall),
+        smooth_write_slowdown(options.smooth_write_slowdown),
         soft_pending_compaction_bytes_limit(
             options.soft_pending_compaction_bytes_limit),
         hard_pending_compaction_bytes_limit(
@@ -143,14 +150,18 @@ struct MutableCFOptions {
         max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
         ttl(options.ttl),
         periodic_compaction_seconds(options.periodic_compaction_seconds),
+        compaction_read_heat_weight(options.compaction_read_heat_weight),
         max_bytes_for_level_multiplier_additional(
             options.max_bytes_for_level_multiplier_additional),
         compaction_options_fifo(options.compaction_options_fifo),
         compaction_options_universal(options.compaction_options_universal),
         enable_blob_files(options.enable_blob_files),
+        adaptive_min_blob_size(options.adaptive_min_blob_size),
         min_blob_size(options.min_blob_size),
         blob_file_size(options.blob_file_size),
         blob_compression_type(options.blob_compression_type),
+        blob_compression_max_dict_bytes(
+            options.blob_compression_max_dict_bytes),
         enable_blob_garbage_collection(options.enable_blob_garbage_collection),
         blob_garbage_collection_age_cutoff(
             options.blob_garbage_collection_age_cutoff),
@@ -159,11 +170,15 @@ struct MutableCFOptions {
         blob_compaction_readahead_size(options.blob_compaction_readahead_size),
         blob_file_starting_level(options.blob_file_starting_level),
         prepopulate_blob_cache(options.prepopulate_blob_cache),
+        blob_cache_max_garbage_ratio(options.blob_cache_max_garbage_ratio),
         max_sequential_skip_in_iterations(
             options.max_sequential_skip_in_iterations),
+        adapt_max_sequential_skip_in_iterations(
+            options.adapt_max_sequential_skip_in_iterations),
         check_flush_compaction_key_order(
             options.check_flush_compaction_key_order),
         paranoid_file_checks(options.paranoid_file_checks),
+        flush_to_lowest_level(options.flush_to_lowest_level),
         report_bg_io_stats(options.report_bg_io_stats),
         compression(options.compression),
         bottommost_compression(options.bottommost_compression),
@@ -198,6 +213,7 @@ struct MutableCFOptions {
         experimental_mempurge_threshold(0.0),
         disable_auto_compactions(false),
         disable_write_stall(false),
+        smooth_write_slowdown(false),
         soft_pending_compaction_bytes_limit(0),
         hard_pending_compaction_bytes_limit(0),
         level0_file_num_compaction_trigger(0),
@@ -211,20 +227,26 @@ struct MutableCFOptions {
         max_bytes_for_level_multiplier(0),
         ttl(0),
         periodic_compaction_seconds(0),
+        compaction_read_heat_weight(0),
         compaction_options_fifo(),
         enable_blob_files(false),
+        adaptive_min_blob_size(false),
         min_blob_size(0),
         blob_file_size(0),
         blob_compression_type(kNoCompression),
+        blob_compression_max_dict_bytes(0),
         enable_blob_garbage_collection(false),
         blob_garbage_collection_age_cutoff(0.0),
         blob_garbage_collection_force_threshold(0.0),
         blob_compaction_readahead_size(0),
         blob_file_starting_level(0),
         prepopulate_blob_cache(PrepopulateBlobCache::kDisable),
+        blob_cache_max_garbage_ratio(1.0),
         max_sequential_skip_in_iterations(0),
+        adapt_max_sequential_skip_in_iterations(false),
         check_flush_compaction_key_order(true),
         paranoid_file_checks(false),
+        flush_to_lowest_level(false),
         report_bg_io_stats(false),
         compression(Snappy_Supported() ? kSnappyCompression : kNoCompression),
         bottommost_compression(kDisableCompressionOption),
@@ -283,6 +305,7 @@ struct MutableCFOptions {
   // Compaction related options
   bool disable_auto_compactions;
   bool disable_write_stall;
+  bool smooth_write_slowdown;
   uint64_t soft_pending_compaction_bytes_limit;
   uint64_t hard_pending_compaction_bytes_limit;
   int level0_file_num_compaction_trigger;
@@ -296,26 +319,32 @@ struct MutableCFOptions {
   double max_bytes_for_level_multiplier;
   uint64_t ttl;
   uint64_t periodic_compaction_seconds;
+  double compaction_read_heat_weight;
   std::vector<int> max_bytes_for_level_multiplier_additional;
   CompactionOptionsFIFO compaction_options_fifo;
   CompactionOptionsUniversal compaction_options_universal;
 
   // Blob file related options
   bool enable_blob_files;
+  bool adaptive_min_blob_size;
   uint64_t min_blob_size;
   uint64_t blob_file_size;
   CompressionType blob_compression_type;
+  uint32_t blob_compression_max_dict_bytes;
   bool enable_blob_garbage_collection;
   double blob_garbage_collection_age_cutoff;
   double blob_garbage_collection_force_threshold;
   uint64_t blob_compaction_readahead_size;
   int blob_file_starting_level;
   PrepopulateBlobCache prepopulate_blob_cache;
+  double blob_cache_max_garbage_ratio;
 
   // Misc options
   uint64_t max_sequential_skip_in_iterations;
+  bool adapt_max_sequential_skip_in_iterations;
   bool check_flush_compaction_key_order;
   bool paranoid_file_checks;
+  bool flush_to_lowest_level;
   bool report_bg_io_stats;
   CompressionType compression;
   CompressionType bottommost_compression;
@@ -73,6 +73,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableDBOptions, max_subcompactions),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"compaction_throttle_latency_micros",
+         {offsetof(struct MutableDBOptions, compaction_throttle_latency_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"avoid_flush_during_shutdown",
          {offsetof(struct MutableDBOptions, avoid_flush_during_shutdown),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -251,9 +255,21 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    skip_checking_sst_file_sizes_on_db_open),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"row_cache_by_user_key",
+         {offsetof(struct ImmutableDBOptions, row_cache_by_user_key),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"new_table_reader_for_compaction_inputs",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
+        {"compaction_async_io",
+         {offsetof(struct ImmutableDBOptions, compaction_async_io),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"table_file_write_behind",
+         {offsetof(struct ImmutableDBOptions, table_file_write_behind),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"random_access_max_buffer_size",
          {offsetof(struct ImmutableDBOptions, random_access_max_buffer_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
@@ -269,6 +285,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, max_file_opening_threads),
           OptionType::kInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"wal_recovery_threads",
+         {offsetof(struct ImmutableDBOptions, wal_recovery_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"table_cache_numshardbits",
          {offsetof(struct ImmutableDBOptions, table_cache_numshardbits),
           OptionType::kInt, OptionVerificationType::kNormal,
@@ -315,6 +335,22 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, max_manifest_file_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"max_manifest_space_amp_pct",
+         {offsetof(struct ImmutableDBOptions, max_manifest_space_amp_pct),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_alive_wal_files",
+         {offsetof(struct ImmutableDBOptions, max_alive_wal_files),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"subcompaction_ranges_per_thread",
+         {offsetof(struct ImmutableDBOptions, subcompaction_ranges_per_thread),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_flush_subjobs",
+         {offsetof(struct ImmutableDBOptions, max_flush_subjobs),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"persist_stats_to_disk",
          {offsetof(struct ImmutableDBOptions, persist_stats_to_disk),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -327,6 +363,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, enable_pipelined_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"enable_pipelined_wal_sync",
+         {offsetof(struct ImmutableDBOptions, enable_pipelined_wal_sync),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"enable_pipelined_commit",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -334,6 +374,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, enable_multi_batch_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"multi_batch_write_split_bytes",
+         {offsetof(struct ImmutableDBOptions, multi_batch_write_split_bytes),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"unordered_write",
          {offsetof(struct ImmutableDBOptions, unordered_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -342,6 +386,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, allow_concurrent_memtable_write),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"numa_aware_memtable_arena",
+         {offsetof(struct ImmutableDBOptions, numa_aware_memtable_arena),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"immutable_memtable_numa_node",
+         {offsetof(struct ImmutableDBOptions, immutable_memtable_numa_node),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"memtable_arena_pool_size",
+         {offsetof(struct ImmutableDBOptions, memtable_arena_pool_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"wal_recovery_mode",
          OptionTypeInfo::Enum<WALRecoveryMode>(
              offsetof(struct ImmutableDBOptions, wal_recovery_mode),
@@ -359,6 +415,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, max_write_batch_group_size_bytes),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"write_group_target_wal_latency_us",
+         {offsetof(struct ImmutableDBOptions,
+                   write_group_target_wal_latency_us),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"write_thread_max_yield_usec",
          {offsetof(struct ImmutableDBOptions, write_thread_max_yield_usec),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -398,10 +459,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, manual_wal_flush),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"wal_use_io_uring",
+         {offsetof(struct ImmutableDBOptions, wal_use_io_uring),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"wal_compression",
          {offsetof(struct ImmutableDBOptions, wal_compression),
           OptionType::kCompressionType, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"secondary_catch_up_interval_ms",
+         {offsetof(struct ImmutableDBOptions, secondary_catch_up_interval_ms),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"seq_per_batch",
          {0, OptionType::kBoolean, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -565,6 +634,28 @@ static std::unordered_map<std::string, OptionTypeInfo>
             return Status::OK();
           },
           nullptr}},
+        {"perf_context_sample_one_in",
+         {offsetof(struct ImmutableDBOptions, perf_context_sample_one_in),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"perf_context_sample_threshold_micros",
+         {offsetof(struct ImmutableDBOptions,
+                   perf_context_sample_threshold_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_cache_heat_sample_one_in",
+         {offsetof(struct ImmutableDBOptions, block_cache_heat_sample_one_in),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"background_job_weight",
+         {offsetof(struct ImmutableDBOptions, background_job_weight),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"db_mutex_contention_threshold_micros",
+         {offsetof(struct ImmutableDBOptions,
+                   db_mutex_contention_threshold_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"lowest_used_cache_tier",
          OptionTypeInfo::Enum<CacheTier>(
              offsetof(struct ImmutableDBOptions, lowest_used_cache_tier),
@@ -573,6 +664,28 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, enforce_single_del_contracts),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"block_cache_hotness_persist_period_sec",
+         {offsetof(struct ImmutableDBOptions,
+                   block_cache_hotness_persist_period_sec),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"lock_free_table_cache",
+         {offsetof(struct ImmutableDBOptions, lock_free_table_cache),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"table_cache_open_ahead",
+         {offsetof(struct ImmutableDBOptions, table_cache_open_ahead),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"table_cache_open_ahead_fraction",
+         {offsetof(struct ImmutableDBOptions, table_cache_open_ahead_fraction),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"table_cache_open_ahead_prefetch_size",
+         {offsetof(struct ImmutableDBOptions,
+                   table_cache_open_ahead_prefetch_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kDBOptionsName = "DBOptions";
@@ -705,6 +818,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       info_log(options.info_log),
       info_log_level(options.info_log_level),
       max_file_opening_threads(options.max_file_opening_threads),
+      wal_recovery_threads(options.wal_recovery_threads),
       statistics(options.statistics),
       use_fsync(options.use_fsync),
       db_paths(options.db_paths),
@@ -715,11 +829,17 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       keep_log_file_num(options.keep_log_file_num),
       recycle_log_file_num(options.recycle_log_file_num),
       max_manifest_file_size(options.max_manifest_file_size),
+      max_manifest_space_amp_pct(options.max_manifest_space_amp_pct),
+      max_alive_wal_files(options.max_alive_wal_files),
+      subcompaction_ranges_per_thread(options.subcompaction_ranges_per_thread),
+      max_flush_subjobs(options.max_flush_subjobs),
       table_cache_numshardbits(options.table_cache_numshardbits),
       WAL_ttl_seconds(options.WAL_ttl_seconds),
       WAL_size_limit_MB(options.WAL_size_limit_MB),
       max_write_batch_group_size_bytes(
           options.max_write_batch_group_size_bytes),
+      write_group_target_wal_latency_us(
+          options.write_group_target_wal_latency_us),
       manifest_preallocation_size(options.manifest_preallocation_size),
       allow_mmap_reads(options.allow_mmap_reads),
       allow_mmap_writes(options.allow_mmap_writes),
@@ -732,14 +852,28 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       db_write_buffer_size(options.db_write_buffer_size),
       write_buffer_manager(options.write_buffer_manager),
       access_hint_on_compaction_start(options.access_hint_on_compaction_start),
+      compaction_async_io(options.compaction_async_io),
+      table_file_write_behind(options.table_file_write_behind),
       random_access_max_buffer_size(options.random_access_max_buffer_size),
       use_adaptive_mutex(options.use_adaptive_mutex),
       listeners(options.listeners),
+      perf_context_sample_one_in(options.perf_context_sample_one_in),
+      perf_context_sample_threshold_micros(
+          options.perf_context_sample_threshold_micros),
+      block_cache_heat_sample_one_in(options.block_cache_heat_sample_one_in),
+      background_job_weight(options.background_job_weight),
+      db_mutex_contention_threshold_micros(
+          options.db_mutex_contention_threshold_micros),
       enable_thread_tracking(options.enable_thread_tracking),
       enable_pipelined_write(options.enable_pipelined_write),
+      enable_pipelined_wal_sync(options.enable_pipelined_wal_sync),
       unordered_write(options.unordered_write),
       enable_multi_batch_write(options.enable_multi_batch_write),
+      multi_batch_write_split_bytes(options.multi_batch_write_split_bytes),
       allow_concurrent_memtable_write(options.allow_concurrent_memtable_write),
+      numa_aware_memtable_arena(options.numa_aware_memtable_arena),
+      immutable_memtable_numa_node(options.immutable_memtable_numa_node),
+      memtable_arena_pool_size(options.memtable_arena_pool_size),
       enable_write_thread_adaptive_yield(
           options.enable_write_thread_adaptive_yield),
       write_thread_max_yield_usec(options.write_thread_max_yield_usec),
@@ -750,6 +884,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_recovery_mode(options.wal_recovery_mode),
       allow_2pc(options.allow_2pc),
       row_cache(options.row_cache),
+      row_cache_by_user_key(options.row_cache_by_user_key),
       wal_filter(options.wal_filter),
       fail_if_options_file_error(options.fail_if_options_file_error),
       dump_malloc_stats(options.dump_malloc_stats),
@@ -757,7 +892,9 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       allow_ingest_behind(options.allow_ingest_behind),
       two_write_queues(options.two_write_queues),
       manual_wal_flush(options.manual_wal_flush),
+      wal_use_io_uring(options.wal_use_io_uring),
       wal_compression(options.wal_compression),
+      secondary_catch_up_interval_ms(options.secondary_catch_up_interval_ms),
       atomic_flush(options.atomic_flush),
       avoid_unnecessary_blocking_io(options.avoid_unnecessary_blocking_io),
       persist_stats_to_disk(options.persist_stats_to_disk),
@@ -772,7 +909,14 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       checksum_handoff_file_types(options.checksum_handoff_file_types),
       lowest_used_cache_tier(options.lowest_used_cache_tier),
       compaction_service(options.compaction_service),
-      enforce_single_del_contracts(options.enforce_single_del_contracts) {
+      enforce_single_del_contracts(options.enforce_single_del_contracts),
+      block_cache_hotness_persist_period_sec(
+          options.block_cache_hotness_persist_period_sec),
+      lock_free_table_cache(options.lock_free_table_cache),
+      table_cache_open_ahead(options.table_cache_open_ahead),
+      table_cache_open_ahead_fraction(options.table_cache_open_ahead_fraction),
+      table_cache_open_ahead_prefetch_size(
+          options.table_cache_open_ahead_prefetch_size) {
   fs = env->GetFileSystem();
   clock = env->GetSystemClock().get();
   logger = info_log.get();
@@ -804,6 +948,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    info_log.get());
   ROCKS_LOG_HEADER(log, "               Options.max_file_opening_threads: %d",
                    max_file_opening_threads);
+  ROCKS_LOG_HEADER(log, "                   Options.wal_recovery_threads: %d",
+                   wal_recovery_threads);
   ROCKS_LOG_HEADER(log, "                             Options.statistics: %p",
                    stats);
   if (stats) {
@@ -819,6 +965,17 @@ void ImmutableDBOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "                 Options.max_manifest_file_size: %" PRIu64,
                    max_manifest_file_size);
+  ROCKS_LOG_HEADER(log, "             Options.max_manifest_space_amp_pct: %u",
+                   max_manifest_space_amp_pct);
+  ROCKS_LOG_HEADER(
+      log, "                    Options.max_alive_wal_files: %" ROCKSDB_PRIszt,
+      max_alive_wal_files);
+  ROCKS_LOG_HEADER(log,
+                   "        Options.subcompaction_ranges_per_thread: %" PRIu32,
+                   subcompaction_ranges_per_thread);
+  ROCKS_LOG_HEADER(log,
+                   "                      Options.max_flush_subjobs: %" PRIu32,
+                   max_flush_subjobs);
   ROCKS_LOG_HEADER(
       log, "                  Options.log_file_time_to_roll: %" ROCKSDB_PRIszt,
       log_file_time_to_roll);
@@ -858,6 +1015,9 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    "                       "
                    "Options.max_write_batch_group_size_bytes: %" PRIu64,
                    max_write_batch_group_size_bytes);
+  ROCKS_LOG_HEADER(
+      log, "      Options.write_group_target_wal_latency_us: %" PRIu64,
+      write_group_target_wal_latency_us);
   ROCKS_LOG_HEADER(
       log, "            Options.manifest_preallocation_size: %" ROCKSDB_PRIszt,
       manifest_preallocation_size);
@@ -872,11 +1032,27 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    write_buffer_manager.get());
   ROCKS_LOG_HEADER(log, "        Options.access_hint_on_compaction_start: %d",
                    static_cast<int>(access_hint_on_compaction_start));
+  ROCKS_LOG_HEADER(log, "                    Options.compaction_async_io: %d",
+                   compaction_async_io);
+  ROCKS_LOG_HEADER(log, "                Options.table_file_write_behind: %d",
+                   table_file_write_behind);
   ROCKS_LOG_HEADER(
       log, "          Options.random_access_max_buffer_size: %" ROCKSDB_PRIszt,
       random_access_max_buffer_size);
   ROCKS_LOG_HEADER(log, "                     Options.use_adaptive_mutex: %d",
                    use_adaptive_mutex);
+  ROCKS_LOG_HEADER(log, "             Options.perf_context_sample_one_in: %u",
+                   perf_context_sample_one_in);
+  ROCKS_LOG_HEADER(
+      log, "   Options.perf_context_sample_threshold_micros: %" PRIu64,
+      perf_context_sample_threshold_micros);
+  ROCKS_LOG_HEADER(log, "         Options.block_cache_heat_sample_one_in: %u",
+                   block_cache_heat_sample_one_in);
+  ROCKS_LOG_HEADER(log, "                  Options.background_job_weight: %u",
+                   background_job_weight);
+  ROCKS_LOG_HEADER(
+      log, "   Options.db_mutex_contention_threshold_micros: %" PRIu64,
+      db_mutex_contention_threshold_micros);
   ROCKS_LOG_HEADER(log, "                           Options.rate_limiter: %p",
                    rate_limiter.get());
   Header(
@@ -888,12 +1064,24 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    enable_thread_tracking);
   ROCKS_LOG_HEADER(log, "                 Options.enable_pipelined_write: %d",
                    enable_pipelined_write);
+  ROCKS_LOG_HEADER(log, "              Options.enable_pipelined_wal_sync: %d",
+                   enable_pipelined_wal_sync);
   ROCKS_LOG_HEADER(log, "                 Options.unordered_write: %d",
                    unordered_write);
   ROCKS_LOG_HEADER(log, "              Options.enable_multi_batch_write: %d",
                    enable_multi_batch_write);
+  ROCKS_LOG_HEADER(
+      log, "         Options.multi_batch_write_split_bytes: %" ROCKSDB_PRIszt,
+      multi_batch_write_split_bytes);
   ROCKS_LOG_HEADER(log, "        Options.allow_concurrent_memtable_write: %d",
                    allow_concurrent_memtable_write);
+  ROCKS_LOG_HEADER(log, "              Options.numa_aware_memtable_arena: %d",
+                   numa_aware_memtable_arena);
+  ROCKS_LOG_HEADER(log, "           Options.immutable_memtable_numa_node: %d",
+                   immutable_memtable_numa_node);
+  ROCKS_LOG_HEADER(
+      log, "               Options.memtable_arena_pool_size: %" ROCKSDB_PRIszt,
+      memtable_arena_pool_size);
   ROCKS_LOG_HEADER(log, "     Options.enable_write_thread_adaptive_yield: %d",
                    enable_write_thread_adaptive_yield);
   ROCKS_LOG_HEADER(log,
@@ -911,6 +1099,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "                              Options.row_cache: None");
   }
+  ROCKS_LOG_HEADER(log, "                  Options.row_cache_by_user_key: %d",
+                   row_cache_by_user_key);
   ROCKS_LOG_HEADER(log, "                             Options.wal_filter: %s",
                    wal_filter ? wal_filter->Name() : "None");
 
@@ -922,8 +1112,12 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    two_write_queues);
   ROCKS_LOG_HEADER(log, "            Options.manual_wal_flush: %d",
                    manual_wal_flush);
+  ROCKS_LOG_HEADER(log, "            Options.wal_use_io_uring: %d",
+                   wal_use_io_uring);
   ROCKS_LOG_HEADER(log, "            Options.wal_compression: %d",
                    wal_compression);
+  ROCKS_LOG_HEADER(log, "Options.secondary_catch_up_interval_ms: %" PRIu64,
+                   secondary_catch_up_interval_ms);
   ROCKS_LOG_HEADER(log, "            Options.atomic_flush: %d", atomic_flush);
   ROCKS_LOG_HEADER(log, "            Options.avoid_unnecessary_blocking_io: %d",
                    avoid_unnecessary_blocking_io);
@@ -950,6 +1144,19 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    db_host_id.c_str());
   ROCKS_LOG_HEADER(log, "            Options.enforce_single_del_contracts: %s",
                    enforce_single_del_contracts ? "true" : "false");
+  ROCKS_LOG_HEADER(log,
+                   "Options.block_cache_hotness_persist_period_sec: %" PRIu64,
+                   block_cache_hotness_persist_period_sec);
+  ROCKS_LOG_HEADER(log, "                   Options.lock_free_table_cache: %s",
+                   lock_free_table_cache ? "true" : "false");
+  ROCKS_LOG_HEADER(log, "                  Options.table_cache_open_ahead: %s",
+                   table_cache_open_ahead ? "true" : "false");
+  ROCKS_LOG_HEADER(log, "         Options.table_cache_open_ahead_fraction: %f",
+                   table_cache_open_ahead_fraction);
+  ROCKS_LOG_HEADER(
+      log,
+      "    Options.table_cache_open_ahead_prefetch_size: %" ROCKSDB_PRIszt,
+      table_cache_open_ahead_prefetch_size);
 }
 
 bool ImmutableDBOptions::IsWalDirSameAsDBPath() const {
@@ -991,6 +1198,7 @@ MutableDBOptions::MutableDBOptions()
     : max_background_jobs(2),
       max_background_compactions(-1),
       max_subcompactions(0),
+      compaction_throttle_latency_micros(0),
       avoid_flush_during_shutdown(false),
       writable_file_max_buffer_size(1024 * 1024),
       delayed_write_rate(2 * 1024U * 1024U),
@@ -1010,6 +1218,8 @@ MutableDBOptions::MutableDBOptions(const DBOptions& options)
     : max_background_jobs(options.max_background_jobs),
       max_background_compactions(options.max_background_compactions),
       max_subcompactions(options.max_subcompactions),
+      compaction_throttle_latency_micros(
+          options.compaction_throttle_latency_micros),
       avoid_flush_during_shutdown(options.avoid_flush_during_shutdown),
       writable_file_max_buffer_size(options.writable_file_max_buffer_size),
       delayed_write_rate(options.delayed_write_rate),
@@ -1034,6 +1244,9 @@ void MutableDBOptions::Dump(Logger* log) const {
                    max_background_compactions);
   ROCKS_LOG_HEADER(log, "            Options.max_subcompactions: %" PRIu32,
                    max_subcompactions);
+  ROCKS_LOG_HEADER(
+      log, "            Options.compaction_throttle_latency_micros: %" PRIu64,
+      compaction_throttle_latency_micros);
   ROCKS_LOG_HEADER(log, "            Options.avoid_flush_during_shutdown: %d",
                    avoid_flush_during_shutdown);
   ROCKS_LOG_HEADER(
@@ -34,6 +34,7 @@ struct ImmutableDBOptions {
   std::shared_ptr<Logger> info_log;
   InfoLogLevel info_log_level;
   int max_file_opening_threads;
+  int wal_recovery_threads;
   std::shared_ptr<Statistics> statistics;
   bool use_fsync;
   std::vector<DbPath> db_paths;
@@ -47,10 +48,15 @@ struct ImmutableDBOptions {
   size_t keep_log_file_num;
   size_t recycle_log_file_num;
   uint64_t max_manifest_file_size;
+  uint32_t max_manifest_space_amp_pct;
+  size_t max_alive_wal_files;
+  uint32_t subcompaction_ranges_per_thread;
+  uint32_t max_flush_subjobs;
   int table_cache_numshardbits;
   uint64_t WAL_ttl_seconds;
   uint64_t WAL_size_limit_MB;
   uint64_t max_write_batch_group_size_bytes;
+  uint64_t write_group_target_wal_latency_us;
   size_t manifest_preallocation_size;
   bool allow_mmap_reads;
   bool allow_mmap_writes;
@@ -62,14 +68,26 @@ struct ImmutableDBOptions {
   size_t db_write_buffer_size;
   std::shared_ptr<WriteBufferManager> write_buffer_manager;
   DBOptions::AccessHint access_hint_on_compaction_start;
+  bool compaction_async_io;
+  bool table_file_write_behind;
   size_t random_access_max_buffer_size;
   bool use_adaptive_mutex;
   std::vector<std::shared_ptr<EventListener>> listeners;
+  uint32_t perf_context_sample_one_in;
+  uint64_t perf_context_sample_threshold_micros;
+  uint32_t block_cache_heat_sample_one_in;
+  uint32_t background_job_weight;
+  uint64_t db_mutex_contention_threshold_micros;
   bool enable_thread_tracking;
   bool enable_pipelined_write;
+  bool enable_pipelined_wal_sync;
   bool unordered_write;
   bool enable_multi_batch_write;
+  size_t multi_batch_write_split_bytes;
   bool allow_concurrent_memtable_write;
+  bool numa_aware_memtable_arena;
+  int immutable_memtable_numa_node;
+  size_t memtable_arena_pool_size;
   bool enable_write_thread_adaptive_yield;
   uint64_t write_thread_max_yield_usec;
   uint64_t write_thread_slow_yield_usec;
@@ -78,6 +96,7 @@ struct ImmutableDBOptions {
   WALRecoveryMode wal_recovery_mode;
   bool allow_2pc;
   std::shared_ptr<Cache> row_cache;
+  bool row_cache_by_user_key;
   WalFilter* wal_filter;
   bool fail_if_options_file_error;
   bool dump_malloc_stats;
@@ -85,7 +104,9 @@ struct ImmutableDBOptions {
   bool allow_ingest_behind;
   bool two_write_queues;
   bool manual_wal_flush;
+  bool wal_use_io_uring;
   CompressionType wal_compression;
+  uint64_t secondary_catch_up_interval_ms;
   bool atomic_flush;
   bool avoid_unnecessary_blocking_io;
   bool persist_stats_to_disk;
@@ -106,6 +127,11 @@ struct ImmutableDBOptions {
   Logger* logger;
   std::shared_ptr<CompactionService> compaction_service;
   bool enforce_single_del_contracts;
+  uint64_t block_cache_hotness_persist_period_sec;
+  bool lock_free_table_cache;
+  bool table_cache_open_ahead;
+  double table_cache_open_ahead_fraction;
+  size_t table_cache_open_ahead_prefetch_size;
 
   bool IsWalDirSameAsDBPath() const;
   bool IsWalDirSameAsDBPath(const std::string& path) const;
@@ -123,6 +149,7 @@ struct MutableDBOptions {
   int max_background_jobs;
   int max_background_compactions;
   uint32_t max_subcompactions;
+  uint64_t compaction_throttle_latency_micros;
   bool avoid_flush_during_shutdown;
   size_t writable_file_max_buffer_size;
   uint64_t delayed_write_rate;
@@ -48,6 +48,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       max_write_buffer_size_to_maintain(
           options.max_write_buffer_size_to_maintain),
       inplace_update_support(options.inplace_update_support),
+      inplace_merge_operands(options.inplace_merge_operands),
       inplace_update_num_locks(options.inplace_update_num_locks),
       experimental_mempurge_threshold(options.experimental_mempurge_threshold),
       inplace_callback(options.inplace_callback),
@@ -67,6 +68,8 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       target_file_size_multiplier(options.target_file_size_multiplier),
       level_compaction_dynamic_level_bytes(
           options.level_compaction_dynamic_level_bytes),
+      drop_files_covered_by_range_deletions(
+          options.drop_files_covered_by_range_deletions),
       max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
       max_bytes_for_level_multiplier_additional(
           options.max_bytes_for_level_multiplier_additional),
@@ -83,25 +86,32 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       compaction_options_fifo(options.compaction_options_fifo),
       max_sequential_skip_in_iterations(
           options.max_sequential_skip_in_iterations),
+      adapt_max_sequential_skip_in_iterations(
+          options.adapt_max_sequential_skip_in_iterations),
       memtable_factory(options.memtable_factory),
       table_properties_collector_factories(
           options.table_properties_collector_factories),
       max_successive_merges(options.max_successive_merges),
+      merge_result_cache_size(options.merge_result_cache_size),
       optimize_filters_for_hits(options.optimize_filters_for_hits),
       paranoid_file_checks(options.paranoid_file_checks),
+      flush_to_lowest_level(options.flush_to_lowest_level),
       force_consistency_checks(options.force_consistency_checks),
       report_bg_io_stats(options.report_bg_io_stats),
       ttl(options.ttl),
       periodic_compaction_seconds(options.periodic_compaction_seconds),
+      compaction_read_heat_weight(options.compaction_read_heat_weight),
       sample_for_compression(options.sample_for_compression),
       default_temperature(options.default_temperature),
       preclude_last_level_data_seconds(
           options.preclude_last_level_data_seconds),
       preserve_internal_time_seconds(options.preserve_internal_time_seconds),
       enable_blob_files(options.enable_blob_files),
+      adaptive_min_blob_size(options.adaptive_min_blob_size),
       min_blob_size(options.min_blob_size),
       blob_file_size(options.blob_file_size),
       blob_compression_type(options.blob_compression_type),
+      blob_compression_max_dict_bytes(options.blob_compression_max_dict_bytes),
       enable_blob_garbage_collection(options.enable_blob_garbage_collection),
       blob_garbage_collection_age_cutoff(
           options.blob_garbage_collection_age_cutoff),
@@ -111,6 +121,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       blob_file_starting_level(options.blob_file_starting_level),
       blob_cache(options.blob_cache),
       prepopulate_blob_cache(options.prepopulate_blob_cache),
+      blob_cache_max_garbage_ratio(options.blob_cache_max_garbage_ratio),
       persist_user_defined_timestamps(options.persist_user_defined_timestamps) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
@@ -275,6 +286,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         max_bytes_for_level_base);
     ROCKS_LOG_HEADER(log, "Options.level_compaction_dynamic_level_bytes: %d",
                      level_compaction_dynamic_level_bytes);
+    ROCKS_LOG_HEADER(log,
+                     "Options.drop_files_covered_by_range_deletions: %d",
+                     drop_files_covered_by_range_deletions);
     ROCKS_LOG_HEADER(log, "         Options.max_bytes_for_level_multiplier: %f",
                      max_bytes_for_level_multiplier);
     for (size_t i = 0; i < max_bytes_for_level_multiplier_additional.size();
@@ -287,6 +301,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(
         log, "      Options.max_sequential_skip_in_iterations: %" PRIu64,
         max_sequential_skip_in_iterations);
+    ROCKS_LOG_HEADER(log,
+                     "Options.adapt_max_sequential_skip_in_iterations: %d",
+                     adapt_max_sequential_skip_in_iterations);
     ROCKS_LOG_HEADER(
         log, "                   Options.max_compaction_bytes: %" PRIu64,
         max_compaction_bytes);
@@ -306,6 +323,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                      disable_auto_compactions);
     ROCKS_LOG_HEADER(log, "               Options.disable_write_stall: %d",
                      disable_write_stall);
+    ROCKS_LOG_HEADER(log, "             Options.smooth_write_slowdown: %d",
+                     smooth_write_slowdown);
 
     const auto& it_compaction_style =
         compaction_style_to_string.find(compaction_style);
@@ -369,6 +388,11 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "Options.compaction_options_fifo.allow_compaction: %d",
                      compaction_options_fifo.allow_compaction);
+    ROCKS_LOG_HEADER(log,
+                     "Options.compaction_options_fifo."
+                     "allow_trivial_copy_when_change_temperature: %d",
+                     compaction_options_fifo
+                         .allow_trivial_copy_when_change_temperature);
     std::ostringstream collector_info;
     for (const auto& collector_factory : table_properties_collector_factories) {
       collector_info << collector_factory->ToString() << ';';
@@ -379,6 +403,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "                  Options.inplace_update_support: %d",
                      inplace_update_support);
+    ROCKS_LOG_HEADER(log,
+                     "                  Options.inplace_merge_operands: %d",
+                     inplace_merge_operands);
     ROCKS_LOG_HEADER(
         log,
         "                Options.inplace_update_num_locks: %" ROCKSDB_PRIszt,
@@ -401,11 +428,17 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         log,
         "                   Options.max_successive_merges: %" ROCKSDB_PRIszt,
         max_successive_merges);
+    ROCKS_LOG_HEADER(
+        log,
+        "                 Options.merge_result_cache_size: %" ROCKSDB_PRIszt,
+        merge_result_cache_size);
     ROCKS_LOG_HEADER(log,
                      "               Options.optimize_filters_for_hits: %d",
                      optimize_filters_for_hits);
     ROCKS_LOG_HEADER(log, "               Options.paranoid_file_checks: %d",
                      paranoid_file_checks);
+    ROCKS_LOG_HEADER(log, "              Options.flush_to_lowest_level: %d",
+                     flush_to_lowest_level);
     ROCKS_LOG_HEADER(log, "               Options.force_consistency_checks: %d",
                      force_consistency_checks);
     ROCKS_LOG_HEADER(log, "               Options.report_bg_io_stats: %d",
@@ -415,6 +448,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "         Options.periodic_compaction_seconds: %" PRIu64,
                      periodic_compaction_seconds);
+    ROCKS_LOG_HEADER(log, "         Options.compaction_read_heat_weight: %f",
+                     compaction_read_heat_weight);
     const auto& it_temp = temperature_to_string.find(default_temperature);
     std::string str_default_temperature;
     if (it_temp == temperature_to_string.end()) {
@@ -432,6 +467,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                      preserve_internal_time_seconds);
     ROCKS_LOG_HEADER(log, "                      Options.enable_blob_files: %s",
                      enable_blob_files ? "true" : "false");
+    ROCKS_LOG_HEADER(log, "                 Options.adaptive_min_blob_size: %s",
+                     adaptive_min_blob_size ? "true" : "false");
     ROCKS_LOG_HEADER(
         log, "                          Options.min_blob_size: %" PRIu64,
         min_blob_size);
@@ -440,6 +477,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         blob_file_size);
     ROCKS_LOG_HEADER(log, "                  Options.blob_compression_type: %s",
                      CompressionTypeToString(blob_compression_type).c_str());
+    ROCKS_LOG_HEADER(
+        log, "        Options.blob_compression_max_dict_bytes: %" PRIu32,
+        blob_compression_max_dict_bytes);
     ROCKS_LOG_HEADER(log, "         Options.enable_blob_garbage_collection: %s",
                      enable_blob_garbage_collection ? "true" : "false");
     ROCKS_LOG_HEADER(log, "     Options.blob_garbage_collection_age_cutoff: %f",
@@ -461,6 +501,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
           prepopulate_blob_cache == PrepopulateBlobCache::kFlushOnly
               ? "flush only"
               : "disabled");
+      ROCKS_LOG_HEADER(log,
+                       "           Options.blob_cache_max_garbage_ratio: %f",
+                       blob_cache_max_garbage_ratio);
     }
     ROCKS_LOG_HEADER(log, "        Options.experimental_mempurge_threshold: %f",
                      experimental_mempurge_threshold);
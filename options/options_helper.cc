@@ -77,6 +77,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_open_files = mutable_db_options.max_open_files;
   options.max_file_opening_threads =
       immutable_db_options.max_file_opening_threads;
+  options.wal_recovery_threads = immutable_db_options.wal_recovery_threads;
   options.max_total_wal_size = mutable_db_options.max_total_wal_size;
   options.statistics = immutable_db_options.statistics;
   options.use_fsync = immutable_db_options.use_fsync;
@@ -92,12 +93,20 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.wal_bytes_per_sync = mutable_db_options.wal_bytes_per_sync;
   options.strict_bytes_per_sync = mutable_db_options.strict_bytes_per_sync;
   options.max_subcompactions = mutable_db_options.max_subcompactions;
+  options.compaction_throttle_latency_micros =
+      mutable_db_options.compaction_throttle_latency_micros;
   options.max_background_flushes = mutable_db_options.max_background_flushes;
   options.max_log_file_size = immutable_db_options.max_log_file_size;
   options.log_file_time_to_roll = immutable_db_options.log_file_time_to_roll;
   options.keep_log_file_num = immutable_db_options.keep_log_file_num;
   options.recycle_log_file_num = immutable_db_options.recycle_log_file_num;
   options.max_manifest_file_size = immutable_db_options.max_manifest_file_size;
+  options.max_manifest_space_amp_pct =
+      immutable_db_options.max_manifest_space_amp_pct;
+  options.max_alive_wal_files = immutable_db_options.max_alive_wal_files;
+  options.subcompaction_ranges_per_thread =
+      immutable_db_options.subcompaction_ranges_per_thread;
+  options.max_flush_subjobs = immutable_db_options.max_flush_subjobs;
   options.table_cache_numshardbits =
       immutable_db_options.table_cache_numshardbits;
   options.WAL_ttl_seconds = immutable_db_options.WAL_ttl_seconds;
@@ -124,24 +133,48 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
       immutable_db_options.access_hint_on_compaction_start;
   options.compaction_readahead_size =
       mutable_db_options.compaction_readahead_size;
+  options.compaction_async_io = immutable_db_options.compaction_async_io;
+  options.table_file_write_behind =
+      immutable_db_options.table_file_write_behind;
   options.random_access_max_buffer_size =
       immutable_db_options.random_access_max_buffer_size;
   options.writable_file_max_buffer_size =
       mutable_db_options.writable_file_max_buffer_size;
   options.use_adaptive_mutex = immutable_db_options.use_adaptive_mutex;
   options.listeners = immutable_db_options.listeners;
+  options.perf_context_sample_one_in =
+      immutable_db_options.perf_context_sample_one_in;
+  options.perf_context_sample_threshold_micros =
+      immutable_db_options.perf_context_sample_threshold_micros;
+  options.block_cache_heat_sample_one_in =
+      immutable_db_options.block_cache_heat_sample_one_in;
+  options.background_job_weight = immutable_db_options.background_job_weight;
+  options.db_mutex_contention_threshold_micros =
+      immutable_db_options.db_mutex_contention_threshold_micros;
   options.enable_thread_tracking = immutable_db_options.enable_thread_tracking;
   options.delayed_write_rate = mutable_db_options.delayed_write_rate;
   options.enable_pipelined_write = immutable_db_options.enable_pipelined_write;
+  options.enable_pipelined_wal_sync =
+      immutable_db_options.enable_pipelined_wal_sync;
   options.enable_multi_batch_write =
       immutable_db_options.enable_multi_batch_write;
+  options.multi_batch_write_split_bytes =
+      immutable_db_options.multi_batch_write_split_bytes;
   options.unordered_write = immutable_db_options.unordered_write;
   options.allow_concurrent_memtable_write =
       immutable_db_options.allow_concurrent_memtable_write;
+  options.numa_aware_memtable_arena =
+      immutable_db_options.numa_aware_memtable_arena;
+  options.immutable_memtable_numa_node =
+      immutable_db_options.immutable_memtable_numa_node;
+  options.memtable_arena_pool_size =
+      immutable_db_options.memtable_arena_pool_size;
   options.enable_write_thread_adaptive_yield =
       immutable_db_options.enable_write_thread_adaptive_yield;
   options.max_write_batch_group_size_bytes =
       immutable_db_options.max_write_batch_group_size_bytes;
+  options.write_group_target_wal_latency_us =
+      immutable_db_options.write_group_target_wal_latency_us;
   options.write_thread_max_yield_usec =
       immutable_db_options.write_thread_max_yield_usec;
   options.write_thread_slow_yield_usec =
@@ -153,6 +186,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.wal_recovery_mode = immutable_db_options.wal_recovery_mode;
   options.allow_2pc = immutable_db_options.allow_2pc;
   options.row_cache = immutable_db_options.row_cache;
+  options.row_cache_by_user_key = immutable_db_options.row_cache_by_user_key;
   options.wal_filter = immutable_db_options.wal_filter;
   options.fail_if_options_file_error =
       immutable_db_options.fail_if_options_file_error;
@@ -164,7 +198,10 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.allow_ingest_behind = immutable_db_options.allow_ingest_behind;
   options.two_write_queues = immutable_db_options.two_write_queues;
   options.manual_wal_flush = immutable_db_options.manual_wal_flush;
+  options.wal_use_io_uring = immutable_db_options.wal_use_io_uring;
   options.wal_compression = immutable_db_options.wal_compression;
+  options.secondary_catch_up_interval_ms =
+      immutable_db_options.secondary_catch_up_interval_ms;
   options.atomic_flush = immutable_db_options.atomic_flush;
   options.avoid_unnecessary_blocking_io =
       immutable_db_options.avoid_unnecessary_blocking_io;
@@ -183,6 +220,14 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.lowest_used_cache_tier = immutable_db_options.lowest_used_cache_tier;
   options.enforce_single_del_contracts =
       immutable_db_options.enforce_single_del_contracts;
+  options.block_cache_hotness_persist_period_sec =
+      immutable_db_options.block_cache_hotness_persist_period_sec;
+  options.lock_free_table_cache = immutable_db_options.lock_free_table_cache;
+  options.table_cache_open_ahead = immutable_db_options.table_cache_open_ahead;
+  options.table_cache_open_ahead_fraction =
+      immutable_db_options.table_cache_open_ahead_fraction;
+  options.table_cache_open_ahead_prefetch_size =
+      immutable_db_options.table_cache_open_ahead_prefetch_size;
   options.daily_offpeak_time_utc = mutable_db_options.daily_offpeak_time_utc;
   return options;
 }
@@ -222,6 +267,7 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
   // Compaction related options
   cf_opts->disable_auto_compactions = moptions.disable_auto_compactions;
   cf_opts->disable_write_stall = moptions.disable_write_stall;
+  cf_opts->smooth_write_slowdown = moptions.smooth_write_slowdown;
   cf_opts->soft_pending_compaction_bytes_limit =
       moptions.soft_pending_compaction_bytes_limit;
   cf_opts->hard_pending_compaction_bytes_limit =
@@ -241,6 +287,7 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.max_bytes_for_level_multiplier;
   cf_opts->ttl = moptions.ttl;
   cf_opts->periodic_compaction_seconds = moptions.periodic_compaction_seconds;
+  cf_opts->compaction_read_heat_weight = moptions.compaction_read_heat_weight;
 
   cf_opts->max_bytes_for_level_multiplier_additional.clear();
   for (auto value : moptions.max_bytes_for_level_multiplier_additional) {
@@ -252,9 +299,12 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
 
   // Blob file related options
   cf_opts->enable_blob_files = moptions.enable_blob_files;
+  cf_opts->adaptive_min_blob_size = moptions.adaptive_min_blob_size;
   cf_opts->min_blob_size = moptions.min_blob_size;
   cf_opts->blob_file_size = moptions.blob_file_size;
   cf_opts->blob_compression_type = moptions.blob_compression_type;
+  cf_opts->blob_compression_max_dict_bytes =
+      moptions.blob_compression_max_dict_bytes;
   cf_opts->enable_blob_garbage_collection =
       moptions.enable_blob_garbage_collection;
   cf_opts->blob_garbage_collection_age_cutoff =
@@ -265,13 +315,17 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.blob_compaction_readahead_size;
   cf_opts->blob_file_starting_level = moptions.blob_file_starting_level;
   cf_opts->prepopulate_blob_cache = moptions.prepopulate_blob_cache;
+  cf_opts->blob_cache_max_garbage_ratio = moptions.blob_cache_max_garbage_ratio;
 
   // Misc options
   cf_opts->max_sequential_skip_in_iterations =
       moptions.max_sequential_skip_in_iterations;
+  cf_opts->adapt_max_sequential_skip_in_iterations =
+      moptions.adapt_max_sequential_skip_in_iterations;
   cf_opts->check_flush_compaction_key_order =
       moptions.check_flush_compaction_key_order;
   cf_opts->paranoid_file_checks = moptions.paranoid_file_checks;
+  cf_opts->flush_to_lowest_level = moptions.flush_to_lowest_level;
   cf_opts->report_bg_io_stats = moptions.report_bg_io_stats;
   cf_opts->compression = moptions.compression;
   cf_opts->compression_opts = moptions.compression_opts;
@@ -299,6 +353,7 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
   cf_opts->max_write_buffer_size_to_maintain =
       ioptions.max_write_buffer_size_to_maintain;
   cf_opts->inplace_update_support = ioptions.inplace_update_support;
+  cf_opts->inplace_merge_operands = ioptions.inplace_merge_operands;
   cf_opts->inplace_callback = ioptions.inplace_callback;
   cf_opts->memtable_factory = ioptions.memtable_factory;
   cf_opts->table_factory = ioptions.table_factory;
@@ -309,8 +364,11 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
       ioptions.level_compaction_dynamic_level_bytes;
   cf_opts->level_compaction_dynamic_file_size =
       ioptions.level_compaction_dynamic_file_size;
+  cf_opts->drop_files_covered_by_range_deletions =
+      ioptions.drop_files_covered_by_range_deletions;
   cf_opts->num_levels = ioptions.num_levels;
   cf_opts->optimize_filters_for_hits = ioptions.optimize_filters_for_hits;
+  cf_opts->merge_result_cache_size = ioptions.merge_result_cache_size;
   cf_opts->force_consistency_checks = ioptions.force_consistency_checks;
   cf_opts->memtable_insert_with_hint_prefix_extractor =
       ioptions.memtable_insert_with_hint_prefix_extractor;
@@ -342,7 +400,8 @@ std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
     {kMinOverlappingRatio, "kMinOverlappingRatio"},
-    {kRoundRobin, "kRoundRobin"}};
+    {kRoundRobin, "kRoundRobin"},
+    {kByTombstoneDensity, "kByTombstoneDensity"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -814,7 +873,8 @@ std::unordered_map<std::string, CompactionPri>
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
         {"kMinOverlappingRatio", kMinOverlappingRatio},
-        {"kRoundRobin", kRoundRobin}};
+        {"kRoundRobin", kRoundRobin},
+        {"kByTombstoneDensity", kByTombstoneDensity}};
 
 std::unordered_map<std::string, CompactionStopStyle>
     OptionsHelper::compaction_stop_style_string_map = {
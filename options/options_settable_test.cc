@@ -125,10 +125,14 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
        sizeof(std::shared_ptr<Cache>)},
       {offsetof(struct BlockBasedTableOptions, persistent_cache),
        sizeof(std::shared_ptr<PersistentCache>)},
+      {offsetof(struct BlockBasedTableOptions, far_memory_allocator),
+       sizeof(std::shared_ptr<MemoryAllocator>)},
       {offsetof(struct BlockBasedTableOptions, cache_usage_options),
        sizeof(CacheUsageOptions)},
       {offsetof(struct BlockBasedTableOptions, filter_policy),
        sizeof(std::shared_ptr<const FilterPolicy>)},
+      {offsetof(struct BlockBasedTableOptions, compressor),
+       sizeof(std::shared_ptr<Compressor>)},
   };
 
   // In this test, we catch a new option of BlockBasedTableOptions that is not
@@ -178,13 +182,16 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "cache_index_and_filter_blocks_with_high_priority=true;"
       "metadata_cache_options={top_level_index_pinning=kFallback;"
       "partition_pinning=kAll;"
-      "unpartitioned_pinning=kFlushedAndSimilar;};"
+      "unpartitioned_pinning=kFlushedAndSimilar;"
+      "dynamic_pinning_budget=1024;};"
       "pin_l0_filter_and_index_blocks_in_cache=1;"
       "pin_top_level_index_and_filter=1;"
       "index_type=kHashSearch;"
       "data_block_index_type=kDataBlockBinaryAndHash;"
       "index_shortening=kNoShortening;"
       "data_block_hash_table_util_ratio=0.75;"
+      "data_block_restart_key_prefixes=true;"
+      "data_block_hash_index_entry_offsets=true;"
       "checksum=kxxHash;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
       "block_size_deviation=8;block_restart_interval=4; "
@@ -192,16 +199,19 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "partition_filters=false;"
       "optimize_filters_for_memory=true;"
       "index_block_restart_interval=4;"
+      "index_partition_restart_interval=16;"
       "filter_policy=bloomfilter:4:true;whole_key_filtering=1;detect_filter_"
       "construct_corruption=false;"
       "format_version=1;"
       "verify_compression=true;read_amp_bytes_per_bit=0;"
       "enable_index_compression=false;"
       "block_align=true;"
+      "far_memory_promotion_hits=4;"
       "max_auto_readahead_size=0;"
       "prepopulate_block_cache=kDisable;"
       "initial_auto_readahead_size=0;"
-      "num_file_reads_for_auto_readahead=0",
+      "num_file_reads_for_auto_readahead=0;"
+      "learn_auto_readahead_size=true",
       new_bbto));
 
   ASSERT_EQ(unset_bytes_base,
@@ -289,13 +299,16 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "WAL_ttl_seconds=4295008036;"
                              "WAL_size_limit_MB=4295036161;"
                              "max_write_batch_group_size_bytes=1048576;"
+                             "write_group_target_wal_latency_us=0;"
                              "wal_dir=path/to/wal_dir;"
                              "db_write_buffer_size=2587;"
                              "max_subcompactions=64330;"
                              "table_cache_numshardbits=28;"
                              "max_open_files=72;"
                              "max_file_opening_threads=35;"
+                             "wal_recovery_threads=2;"
                              "max_background_jobs=8;"
+                             "compaction_throttle_latency_micros=1000;"
                              "max_background_compactions=33;"
                              "use_fsync=true;"
                              "use_adaptive_mutex=false;"
@@ -305,6 +318,10 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "skip_stats_update_on_db_open=false;"
                              "skip_checking_sst_file_sizes_on_db_open=false;"
                              "max_manifest_file_size=4295009941;"
+                             "max_manifest_space_amp_pct=100;"
+                             "max_alive_wal_files=0;"
+                             "subcompaction_ranges_per_thread=1;"
+                             "max_flush_subjobs=1;"
                              "db_log_dir=path/to/db_log_dir;"
                              "writable_file_max_buffer_size=1048576;"
                              "paranoid_checks=true;"
@@ -334,13 +351,25 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "use_direct_reads=false;"
                              "use_direct_io_for_flush_and_compaction=false;"
                              "max_log_file_size=4607;"
+                             "compaction_async_io=false;"
+                             "table_file_write_behind=false;"
+                             "perf_context_sample_one_in=100;"
+                             "perf_context_sample_threshold_micros=1000;"
+                             "block_cache_heat_sample_one_in=1000;"
+                             "background_job_weight=2;"
+                             "db_mutex_contention_threshold_micros=100;"
                              "random_access_max_buffer_size=1048576;"
                              "advise_random_on_open=true;"
                              "fail_if_options_file_error=false;"
                              "enable_pipelined_write=false;"
+                             "enable_pipelined_wal_sync=false;"
                              "enable_multi_batch_write=false;"
+                             "multi_batch_write_split_bytes=0;"
                              "unordered_write=false;"
                              "allow_concurrent_memtable_write=true;"
+                             "numa_aware_memtable_arena=false;"
+                             "immutable_memtable_numa_node=1;"
+                             "memtable_arena_pool_size=0;"
                              "wal_recovery_mode=kPointInTimeRecovery;"
                              "enable_write_thread_adaptive_yield=true;"
                              "write_thread_slow_yield_usec=5;"
@@ -349,13 +378,16 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "info_log_level=DEBUG_LEVEL;"
                              "dump_malloc_stats=false;"
                              "allow_2pc=false;"
+                             "row_cache_by_user_key=false;"
                              "avoid_flush_during_recovery=false;"
                              "avoid_flush_during_shutdown=false;"
                              "allow_ingest_behind=false;"
                              "concurrent_prepare=false;"
                              "two_write_queues=false;"
                              "manual_wal_flush=false;"
+                             "wal_use_io_uring=false;"
                              "wal_compression=kZSTD;"
+                             "secondary_catch_up_interval_ms=100;"
                              "seq_per_batch=false;"
                              "atomic_flush=false;"
                              "avoid_unnecessary_blocking_io=false;"
@@ -368,6 +400,11 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "lowest_used_cache_tier=kNonVolatileBlockTier;"
                              "allow_data_in_errors=false;"
                              "enforce_single_del_contracts=false;"
+                             "block_cache_hotness_persist_period_sec=600;"
+                             "lock_free_table_cache=true;"
+                             "table_cache_open_ahead=true;"
+                             "table_cache_open_ahead_fraction=0.5;"
+                             "table_cache_open_ahead_prefetch_size=65536;"
                              "daily_offpeak_time_utc=08:30-19:00;",
                              new_options));
 
@@ -497,6 +534,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "memtable_huge_page_size=2557;"
       "max_successive_merges=5497;"
       "max_sequential_skip_in_iterations=4294971408;"
+      "adapt_max_sequential_skip_in_iterations=true;"
       "arena_block_size=1893;"
       "target_file_size_multiplier=35;"
       "min_write_buffer_number_to_merge=9;"
@@ -510,11 +548,11 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "compression_opts={max_dict_buffer_bytes=5;use_zstd_dict_trainer=true;"
       "enabled=false;parallel_threads=6;zstd_max_train_bytes=7;strategy=8;max_"
       "dict_bytes=9;level=10;window_bits=11;max_compressed_bytes_per_kb=987;"
-      "checksum=true};"
+      "checksum=true;adaptive_tolerance_pct=12};"
       "bottommost_compression_opts={max_dict_buffer_bytes=4;use_zstd_dict_"
       "trainer=true;enabled=true;parallel_threads=5;zstd_max_train_bytes=6;"
       "strategy=7;max_dict_bytes=8;level=9;window_bits=10;max_compressed_bytes_"
-      "per_kb=876;checksum=true};"
+      "per_kb=876;checksum=true;adaptive_tolerance_pct=11};"
       "bottommost_compression=kDisableCompressionOption;"
       "level0_stop_writes_trigger=33;"
       "num_levels=99;"
@@ -530,32 +568,41 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "memtable_insert_with_hint_prefix_extractor=rocksdb.CappedPrefix.13;"
       "check_flush_compaction_key_order=false;"
       "paranoid_file_checks=true;"
+      "flush_to_lowest_level=false;"
       "force_consistency_checks=true;"
       "inplace_update_num_locks=7429;"
       "experimental_mempurge_threshold=0.0001;"
       "optimize_filters_for_hits=false;"
+      "merge_result_cache_size=0;"
       "level_compaction_dynamic_level_bytes=false;"
       "level_compaction_dynamic_file_size=true;"
+      "drop_files_covered_by_range_deletions=false;"
       "inplace_update_support=false;"
+      "inplace_merge_operands=false;"
       "compaction_style=kCompactionStyleFIFO;"
       "compaction_pri=kMinOverlappingRatio;"
       "hard_pending_compaction_bytes_limit=0;"
       "disable_auto_compactions=false;"
       "disable_write_stall=false;"
+      "smooth_write_slowdown=false;"
       "report_bg_io_stats=true;"
       "ttl=60;"
       "periodic_compaction_seconds=3600;"
+      "compaction_read_heat_weight=0.5;"
       "sample_for_compression=0;"
       "enable_blob_files=true;"
+      "adaptive_min_blob_size=true;"
       "min_blob_size=256;"
       "blob_file_size=1000000;"
       "blob_compression_type=kBZip2Compression;"
+      "blob_compression_max_dict_bytes=16384;"
       "enable_blob_garbage_collection=true;"
       "blob_garbage_collection_age_cutoff=0.5;"
       "blob_garbage_collection_force_threshold=0.75;"
       "blob_compaction_readahead_size=262144;"
       "blob_file_starting_level=1;"
       "prepopulate_blob_cache=kDisable;"
+      "blob_cache_max_garbage_ratio=0.5;"
       "bottommost_temperature=kWarm;"
       "last_level_temperature=kWarm;"
       "default_temperature=kHot;"
@@ -563,7 +610,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "preserve_internal_time_seconds=86400;"
       "compaction_options_fifo={max_table_files_size=3;allow_"
       "compaction=true;age_for_warm=0;file_temperature_age_thresholds={{"
-      "temperature=kCold;age=12345}};};"
+      "temperature=kCold;age=12345}};allow_trivial_copy_when_change_"
+      "temperature=true;};"
       "blob_cache=1M;"
       "memtable_protection_bytes_per_key=2;"
       "persist_user_defined_timestamps=true;"
@@ -582,6 +630,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
   // kColumnFamilyOptionsExcluded
   ASSERT_EQ(new_options->compaction_options_fifo.max_table_files_size, 3);
   ASSERT_EQ(new_options->compaction_options_fifo.allow_compaction, true);
+  ASSERT_TRUE(new_options->compaction_options_fifo
+                  .allow_trivial_copy_when_change_temperature);
   ASSERT_EQ(new_options->compaction_options_fifo.file_temperature_age_thresholds
                 .size(),
             1);
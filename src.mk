@@ -9,11 +9,14 @@ LIB_SOURCES =                                                   \
   cache/clock_cache.cc                                          \
   cache/lru_cache.cc                                            \
   cache/compressed_secondary_cache.cc                           \
+  cache/flash_secondary_cache.cc                                \
   cache/secondary_cache.cc                                      \
   cache/secondary_cache_adapter.cc                              \
   cache/sharded_cache.cc                                        \
+  cache/tenant_cache.cc                                         \
   cache/tiered_secondary_cache.cc				\
   db/arena_wrapped_db_iter.cc                                   \
+  db/batch_iterator.cc                                          \
   db/blob/blob_contents.cc                                      \
   db/blob/blob_fetcher.cc                                       \
   db/blob/blob_file_addition.cc                                 \
@@ -26,8 +29,10 @@ LIB_SOURCES =                                                   \
   db/blob/blob_log_format.cc                                    \
   db/blob/blob_log_sequential_reader.cc                         \
   db/blob/blob_log_writer.cc                                    \
+  db/blob/blob_separation_tuner.cc                              \
   db/blob/blob_source.cc                                        \
   db/blob/prefetch_buffer_collection.cc                         \
+  db/block_cache_hotness.cc                                     \
   db/builder.cc                                                 \
   db/c.cc                                                       \
   db/column_family.cc                                           \
@@ -77,10 +82,14 @@ LIB_SOURCES =                                                   \
   db/memtable_list.cc                                           \
   db/merge_helper.cc                                            \
   db/merge_operator.cc                                          \
+  db/merge_result_cache.cc                                      \
+  db/multi_scan_iterator.cc                                     \
   db/output_validator.cc                                        \
+  db/parallel_scan.cc                                           \
   db/periodic_task_scheduler.cc                                 \
   db/range_del_aggregator.cc                                    \
   db/range_tombstone_fragmenter.cc                              \
+  db/range_tombstone_index.cc                                   \
   db/repair.cc                                                  \
   db/seqno_to_time_mapping.cc                                   \
   db/snapshot_impl.cc                                           \
@@ -88,6 +97,7 @@ LIB_SOURCES =                                                   \
   db/table_properties_collector.cc                              \
   db/transaction_log_impl.cc                                    \
   db/trim_history_scheduler.cc                                  \
+  db/user_key_row_cache.cc                                      \
   db/version_builder.cc                                         \
   db/version_edit.cc                                            \
   db/version_edit_handler.cc                                    \
@@ -110,6 +120,8 @@ LIB_SOURCES =                                                   \
   env/env_inspected.cc                                          \
   env/env_posix.cc                                              \
   env/file_system.cc                                            \
+  env/fs_io_scheduler.cc                                        \
+  env/fs_read_coalescing.cc                                     \
   env/fs_posix.cc                                               \
   env/fs_remap.cc                                               \
   env/file_system_tracer.cc                                     \
@@ -131,14 +143,17 @@ LIB_SOURCES =                                                   \
   logging/event_logger.cc                                       \
   logging/log_buffer.cc                                         \
   memory/arena.cc                                               \
+  memory/arena_block_pool.cc                                    \
   memory/concurrent_arena.cc                                    \
   memory/jemalloc_nodump_allocator.cc                           \
   memory/memkind_kmem_allocator.cc                              \
   memory/memory_allocator.cc                                    \
   memtable/alloc_tracker.cc                                     \
+  memtable/btree_rep.cc                                         \
   memtable/hash_linklist_rep.cc                                 \
   memtable/hash_skiplist_rep.cc                                 \
   memtable/skiplistrep.cc                                       \
+  memtable/split_ordered_table.cc                               \
   memtable/vectorrep.cc                                         \
   memtable/write_buffer_manager.cc                              \
   monitoring/histogram.cc                                       \
@@ -146,6 +161,7 @@ LIB_SOURCES =                                                   \
   monitoring/in_memory_stats_history.cc                         \
   monitoring/instrumented_mutex.cc                              \
   monitoring/iostats_context.cc                                 \
+  monitoring/mutex_contention_profiler.cc                       \
   monitoring/perf_context.cc                                    \
   monitoring/perf_level.cc                                      \
   monitoring/perf_flag.cc                                       \
@@ -185,6 +201,7 @@ LIB_SOURCES =                                                   \
   table/block_based/block_prefetcher.cc                         \
   table/block_based/block_prefix_index.cc                       \
   table/block_based/data_block_hash_index.cc                    \
+  table/block_based/data_block_properties.cc                    \
   table/block_based/data_block_footer.cc                        \
   table/block_based/filter_block_reader_common.cc               \
   table/block_based/filter_policy.cc                            \
@@ -193,6 +210,9 @@ LIB_SOURCES =                                                   \
   table/block_based/hash_index_reader.cc                        \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
+  table/block_based/learned_index.cc                            \
+  table/block_based/learned_index_reader.cc                     \
+  table/block_based/metadata_block_pinner.cc                    \
   table/block_based/parsed_full_filter_block.cc                 \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
@@ -294,7 +314,9 @@ LIB_SOURCES =                                                   \
   utilities/merge_operators/string_append/stringappend2.cc      \
   utilities/merge_operators/uint64add.cc                        \
   utilities/merge_operators/bytesxor.cc                         \
+  utilities/merge_operators/wide_column_update.cc               \
   utilities/object_registry.cc                                  \
+  utilities/open_metrics/open_metrics_exporter.cc               \
   utilities/option_change_migration/option_change_migration.cc  \
   utilities/options/options_util.cc                             \
   utilities/persistent_cache/block_cache_tier.cc                \
@@ -304,6 +326,7 @@ LIB_SOURCES =                                                   \
   utilities/persistent_cache/volatile_tier_impl.cc              \
   utilities/rate_limiters/write_amp_based_rate_limiter.cc       \
   utilities/simulator_cache/cache_simulator.cc                  \
+  utilities/simulator_cache/miss_ratio_curve.cc                 \
   utilities/simulator_cache/sim_cache.cc                        \
   utilities/table_properties_collectors/compact_on_deletion_collector.cc \
   utilities/trace/file_trace_reader_writer.cc                   \
@@ -311,6 +334,7 @@ LIB_SOURCES =                                                   \
   utilities/transactions/lock/lock_manager.cc                   \
   utilities/transactions/lock/point/point_lock_tracker.cc       \
   utilities/transactions/lock/point/point_lock_manager.cc       \
+  utilities/transactions/lock/range/range_map/range_map_lock_manager.cc \
   utilities/transactions/optimistic_transaction.cc              \
   utilities/transactions/optimistic_transaction_db_impl.cc      \
   utilities/transactions/pessimistic_transaction.cc             \
@@ -441,6 +465,7 @@ TEST_MAIN_SOURCES =                                                     \
   cache/cache_test.cc                                                   \
   cache/cache_reservation_manager_test.cc                               \
   cache/compressed_secondary_cache_test.cc                              \
+  cache/flash_secondary_cache_test.cc                                   \
   cache/lru_cache_test.cc                                               \
   cache/tiered_secondary_cache_test.cc					\
   db/blob/blob_counting_iterator_test.cc                                \
@@ -450,6 +475,7 @@ TEST_MAIN_SOURCES =                                                     \
   db/blob/blob_file_garbage_test.cc                                     \
   db/blob/blob_file_reader_test.cc                                      \
   db/blob/blob_garbage_meter_test.cc                                    \
+  db/blob/blob_separation_tuner_test.cc                                 \
   db/blob/blob_source_test.cc                                           \
   db/blob/db_blob_basic_test.cc                                         \
   db/blob/db_blob_compaction_test.cc                                    \
@@ -531,6 +557,7 @@ TEST_MAIN_SOURCES =                                                     \
   db/repair_test.cc                                                     \
   db/range_del_aggregator_test.cc                                       \
   db/range_tombstone_fragmenter_test.cc                                 \
+  db/range_tombstone_index_test.cc                                      \
   db/seqno_time_test.cc                                                 \
   db/table_properties_collector_test.cc                                 \
   db/version_builder_test.cc                                            \
@@ -545,6 +572,8 @@ TEST_MAIN_SOURCES =                                                     \
   db/write_controller_test.cc                                           \
   env/env_basic_test.cc                                                 \
   env/env_test.cc                                                       \
+  env/fs_io_scheduler_test.cc                                           \
+  env/fs_read_coalescing_test.cc                                        \
   env/io_posix_test.cc                                                  \
   env/mock_env_test.cc                                                  \
   file/delete_scheduler_test.cc                                         \
@@ -555,8 +584,10 @@ TEST_MAIN_SOURCES =                                                     \
   logging/event_logger_test.cc                                          \
   memory/arena_test.cc                                                  \
   memory/memory_allocator_test.cc                                       \
+  memtable/btree_test.cc                                                \
   memtable/inlineskiplist_test.cc                                       \
   memtable/skiplist_test.cc                                             \
+  memtable/split_ordered_table_test.cc                                  \
   memtable/write_buffer_manager_test.cc                                 \
   monitoring/histogram_test.cc                                          \
   monitoring/iostats_context_test.cc                                    \
@@ -621,6 +652,7 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/memory/memory_test.cc                                       \
   utilities/merge_operators/string_append/stringappend_test.cc          \
   utilities/object_registry_test.cc                                     \
+  utilities/open_metrics/open_metrics_exporter_test.cc                  \
   utilities/option_change_migration/option_change_migration_test.cc     \
   utilities/options/options_util_test.cc                                \
   utilities/persistent_cache/hash_table_test.cc                         \
@@ -647,6 +679,10 @@ TEST_MAIN_SOURCES_C = \
 MICROBENCH_SOURCES =                                          \
   microbench/ribbon_bench.cc                                  \
   microbench/db_basic_bench.cc                                  \
+  microbench/block_bench.cc                                   \
+  microbench/iterator_bench.cc                                \
+  microbench/get_alloc_bench.cc                               \
+  microbench/threadpool_bench.cc                              \
 
 JNI_NATIVE_SOURCES =                                          \
   java/rocksjni/backupenginejni.cc                            \
@@ -49,13 +49,13 @@ struct DecodeEntry {
       // Fast path: all three values are encoded in one byte each
       p += 3;
     } else {
-      if ((p = GetVarint32Ptr(p, limit, shared)) == nullptr) {
+      if ((p = GetShortVarint32Ptr(p, limit, shared)) == nullptr) {
         return nullptr;
       }
-      if ((p = GetVarint32Ptr(p, limit, non_shared)) == nullptr) {
+      if ((p = GetShortVarint32Ptr(p, limit, non_shared)) == nullptr) {
         return nullptr;
       }
-      if ((p = GetVarint32Ptr(p, limit, value_length)) == nullptr) {
+      if ((p = GetShortVarint32Ptr(p, limit, value_length)) == nullptr) {
         return nullptr;
       }
     }
@@ -86,13 +86,13 @@ struct CheckAndDecodeEntry {
       // Fast path: all three values are encoded in one byte each
       p += 3;
     } else {
-      if ((p = GetVarint32Ptr(p, limit, shared)) == nullptr) {
+      if ((p = GetShortVarint32Ptr(p, limit, shared)) == nullptr) {
         return nullptr;
       }
-      if ((p = GetVarint32Ptr(p, limit, non_shared)) == nullptr) {
+      if ((p = GetShortVarint32Ptr(p, limit, non_shared)) == nullptr) {
         return nullptr;
       }
-      if ((p = GetVarint32Ptr(p, limit, value_length)) == nullptr) {
+      if ((p = GetShortVarint32Ptr(p, limit, value_length)) == nullptr) {
         return nullptr;
       }
     }
@@ -299,6 +299,48 @@ void DataBlockIter::PrevImpl() {
   prev_entries_idx_ = static_cast<int32_t>(prev_entries_.size()) - 1;
 }
 
+namespace {
+// Returns how many of the n sorted restart key prefixes at `prefixes` are less
+// than `target`, or, if kOrEqual, not greater than it.
+template <bool kOrEqual>
+uint32_t CountRestartKeyPrefixesBelow(const char* prefixes, uint32_t n,
+                                      uint64_t target) {
+  // Narrow the range down with a binary search, then compare the rest in a
+  // loop without branches the compiler can turn into SIMD comparisons.
+  constexpr uint32_t kScanLength = 16;
+  uint32_t lo = 0;
+  while (n > kScanLength) {
+    const uint32_t half = n / 2;
+    const uint64_t prefix =
+        DecodeFixed64(prefixes + (lo + half) * kRestartKeyPrefixSize);
+    if (kOrEqual ? prefix <= target : prefix < target) {
+      lo += half + 1;
+      n -= half + 1;
+    } else {
+      n = half;
+    }
+  }
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    const uint64_t prefix =
+        DecodeFixed64(prefixes + (lo + i) * kRestartKeyPrefixSize);
+    count += kOrEqual ? prefix <= target : prefix < target;
+  }
+  return lo + count;
+}
+}  // namespace
+
+void DataBlockIter::RestartRangeForPrefix(const Slice& target, uint32_t* begin,
+                                          uint32_t* end) const {
+  assert(restart_prefixes_ != nullptr);
+  const uint64_t target_prefix = RestartKeyPrefix(ExtractUserKey(target));
+  *begin = CountRestartKeyPrefixesBelow<false>(restart_prefixes_,
+                                               num_restarts_, target_prefix);
+  *end = *begin + CountRestartKeyPrefixesBelow<true>(
+                      restart_prefixes_ + *begin * kRestartKeyPrefixSize,
+                      num_restarts_ - *begin, target_prefix);
+}
+
 void DataBlockIter::SeekImpl(const Slice& target) {
   Slice seek_key = target;
   PERF_TIMER_GUARD(block_seek_nanos);
@@ -307,7 +349,13 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  uint32_t begin = 0;
+  uint32_t end = num_restarts_;
+  if (restart_prefixes_ != nullptr) {
+    RestartRangeForPrefix(seek_key, &begin, &end);
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan, begin,
+                                  end);
 
   if (!ok) {
     return;
@@ -358,6 +406,12 @@ void MetaBlockIter::SeekImpl(const Slice& target) {
 bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   Slice target_user_key = ExtractUserKey(target);
   uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  if (restart_prefixes_ != nullptr) {
+    map_offset += num_restarts_ * kRestartKeyPrefixSize;
+  }
+  if (data_block_hash_index_->EntryOffsets()) {
+    return SeekForGetEntryOffsetImpl(target, map_offset);
+  }
   uint8_t entry =
       data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
 
@@ -461,6 +515,87 @@ bool DataBlockIter::SeekForGetImpl(const Slice& target) {
   return true;
 }
 
+bool DataBlockIter::SeekForGetEntryOffsetImpl(const Slice& target,
+                                              uint32_t map_offset) {
+  Slice target_user_key = ExtractUserKey(target);
+  uint16_t entry = data_block_hash_index_->LookupEntryOffset(data_, map_offset,
+                                                             target_user_key);
+
+  if (entry == kCollisionOffset || protection_bytes_per_key_ > 0) {
+    // HashSeek not effective, or jumping to the entry would lose track of
+    // the entry index that per key-value checksums are looked up by
+    SeekImpl(target);
+    return true;
+  }
+
+  if (entry == kNoEntryOffset) {
+    // As in SeekForGetImpl(), the result may still be in the next block, so
+    // pretend the key is in the last restart interval.
+    entry = static_cast<uint16_t>(GetRestartPoint(num_restarts_ - 1));
+  }
+
+  if (entry >= restarts_) {
+    CorruptionError("Bad entry offset in data block hash index");
+    return true;
+  }
+
+  // Find the restart point at or before the entry
+  uint32_t left = 0;
+  uint32_t right = num_restarts_ - 1;
+  while (left < right) {
+    const uint32_t mid = left + (right - left + 1) / 2;
+    if (GetRestartPoint(mid) <= entry) {
+      left = mid;
+    } else {
+      right = mid - 1;
+    }
+  }
+  SeekToRestartPoint(left);
+  if (entry != GetRestartPoint(left)) {
+    // The key of the entry is delta encoded against the restart key, so
+    // decode that one and then skip the entries in between.
+    bool shared;
+    if (!ParseNextDataKey(&shared)) {
+      return true;
+    }
+    value_ = Slice(data_ + entry, 0);
+  }
+
+  // The versions of the user key may run past the end of the restart
+  // interval.
+  while (true) {
+    bool shared;
+    if (!ParseNextDataKey(&shared)) {
+      // The rest of the block is smaller than the target, which may exist in
+      // the next block
+      return true;
+    }
+    if (CompareCurrentKey(target) >= 0) {
+      break;
+    }
+  }
+
+  if (icmp_->user_comparator()->Compare(raw_key_.GetUserKey(),
+                                        target_user_key) != 0) {
+    // the key is not in this block and cannot be at the next block either.
+    return false;
+  }
+
+  // Same as in SeekForGetImpl()
+  ValueType value_type = ExtractValueType(raw_key_.GetInternalKey());
+  if (value_type != ValueType::kTypeValue &&
+      value_type != ValueType::kTypeDeletion &&
+      value_type != ValueType::kTypeMerge &&
+      value_type != ValueType::kTypeSingleDeletion &&
+      value_type != ValueType::kTypeBlobIndex &&
+      value_type != ValueType::kTypeWideColumnEntity &&
+      value_type != ValueType::kTypeTitanBlobIndex) {
+    SeekImpl(target);
+  }
+
+  return true;
+}
+
 void IndexBlockIter::SeekImpl(const Slice& target) {
 #ifndef NDEBUG
   if (TEST_Corrupt_Callback("IndexBlockIter::SeekImpl")) {
@@ -493,6 +628,8 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (learned_index_) {
+    ok = LearnedSeek(seek_key, &index, &skip_linear_scan);
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -513,7 +650,13 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  uint32_t begin = 0;
+  uint32_t end = num_restarts_;
+  if (restart_prefixes_ != nullptr) {
+    RestartRangeForPrefix(seek_key, &begin, &end);
+  }
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan, begin,
+                                  end);
 
   if (!ok) {
     return;
@@ -826,7 +969,8 @@ void BlockIter<TValue>::FindKeyAfterBinarySeek(const Slice& target,
 template <class TValue>
 template <typename DecodeKeyFunc>
 bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
-                                   bool* skip_linear_scan) {
+                                   bool* skip_linear_scan, uint32_t begin,
+                                   uint32_t end) {
   if (restarts_ == 0) {
     // SST files dedicated to range tombstones are written with index blocks
     // that have no keys while also having `num_restarts_ == 1`. This would
@@ -844,7 +988,9 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
+  assert(begin <= end);
+  int64_t left = static_cast<int64_t>(begin) - 1;
+  int64_t right = static_cast<int64_t>(std::min(end, num_restarts_)) - 1;
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -904,6 +1050,35 @@ int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   return CompareCurrentKey(target);
 }
 
+bool IndexBlockIter::LearnedSeek(const Slice& target, uint32_t* index,
+                                 bool* skip_linear_scan) {
+  if (restarts_ == 0) {
+    // See BinarySeek()
+    return false;
+  }
+  uint32_t begin = 0;
+  uint32_t end = 0;
+  learned_index_->Predict(raw_key_.IsUserKey() ? target
+                                               : ExtractUserKey(target),
+                          num_restarts_, &begin, &end);
+  // BinarySeek() needs the restart keys before `begin` to be no greater than
+  // the target and those from `end` on to be greater.
+  if (begin > 0 && CompareBlockKey(begin - 1, target) > 0) {
+    begin = 0;
+  }
+  if (end < num_restarts_ && CompareBlockKey(end, target) <= 0) {
+    end = num_restarts_;
+  }
+  if (!status_.ok()) {
+    return false;
+  }
+  if (value_delta_encoded_) {
+    return BinarySeek<DecodeKeyV4>(target, index, skip_linear_scan, begin,
+                                   end);
+  }
+  return BinarySeek<DecodeKey>(target, index, skip_linear_scan, begin, end);
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool IndexBlockIter::BinaryBlockIndexSeek(const Slice& target,
@@ -1016,7 +1191,7 @@ bool IndexBlockIter::PrefixSeek(const Slice& target, uint32_t* index,
 
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2 * sizeof(uint32_t));
-  uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  uint32_t block_footer = DecodeFixed32(data() + size_ - sizeof(uint32_t));
   uint32_t num_restarts = block_footer;
   if (size_ > kMaxBlockSizeSupportedByHashIndex) {
     // In BlockBuilder, we have ensured a block with HashIndex is less than
@@ -1029,6 +1204,7 @@ uint32_t Block::NumRestarts() const {
     // Such check is for backward compatibility. We can ensure legacy block
     // with a vary large num_restarts i.e. >= 0x80000000 can be interpreted
     // correctly as no HashIndex even if the MSB of num_restarts is set.
+    UnPackRestartKeyPrefixes(&num_restarts);
     return num_restarts;
   }
   BlockBasedTableOptions::DataBlockIndexType index_type;
@@ -1042,7 +1218,7 @@ BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
     // The check is for the same reason as that in NumRestarts()
     return BlockBasedTableOptions::kDataBlockBinarySearch;
   }
-  uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  uint32_t block_footer = DecodeFixed32(data() + size_ - sizeof(uint32_t));
   uint32_t num_restarts = block_footer;
   BlockBasedTableOptions::DataBlockIndexType index_type;
   UnPackIndexTypeAndNumRestarts(block_footer, &index_type, &num_restarts);
@@ -1053,31 +1229,36 @@ Block::~Block() {
   // This sync point can be re-enabled if RocksDB can control the
   // initialization order of any/all static options created by the user.
   // TEST_SYNC_POINT("Block::~Block");
-  delete[] kv_checksum_;
 }
 
 Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
              Statistics* statistics)
     : contents_(std::move(contents)),
-      data_(contents_.data.data()),
-      size_(contents_.data.size()),
+      size_(static_cast<uint32_t>(contents_.data.size())),
       restart_offset_(0),
       num_restarts_(0) {
   TEST_SYNC_POINT("Block::Block:0");
-  if (size_ < sizeof(uint32_t)) {
+  if (size_ < sizeof(uint32_t) ||
+      contents_.data.size() > std::numeric_limits<uint32_t>::max()) {
     size_ = 0;  // Error marker
   } else {
     // Should only decode restart points for uncompressed blocks
     num_restarts_ = NumRestarts();
+    uint32_t block_footer = DecodeFixed32(data() + size_ - sizeof(uint32_t));
+    const bool restart_key_prefixes = UnPackRestartKeyPrefixes(&block_footer);
+    // Size of the restart array and the restart key prefixes
+    const uint64_t restarts_size =
+        uint64_t{num_restarts_} *
+        (sizeof(uint32_t) + (restart_key_prefixes ? kRestartKeyPrefixSize : 0));
     switch (IndexType()) {
       case BlockBasedTableOptions::kDataBlockBinarySearch:
-        restart_offset_ = static_cast<uint32_t>(size_) -
-                          (1 + num_restarts_) * sizeof(uint32_t);
-        if (restart_offset_ > size_ - sizeof(uint32_t)) {
-          // The size is too small for NumRestarts() and therefore
-          // restart_offset_ wrapped around.
+        if (restarts_size > size_ - sizeof(uint32_t)) {
+          // The size is too small for NumRestarts()
           size_ = 0;
+          break;
         }
+        restart_offset_ = static_cast<uint32_t>(size_ - sizeof(uint32_t) -
+                                                restarts_size);
         break;
       case BlockBasedTableOptions::kDataBlockBinaryAndHash:
         if (size_ < sizeof(uint32_t) /* block footer */ +
@@ -1086,27 +1267,29 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
           break;
         }
 
+        bool hash_index_entry_offsets;
+        UnPackIndexTypeAndNumRestarts(block_footer, nullptr, nullptr, nullptr,
+                                      &hash_index_entry_offsets);
         uint16_t map_offset;
         data_block_hash_index_.Initialize(
-            data_, static_cast<uint16_t>(size_ - sizeof(uint32_t)), /*chop off
+            data(), static_cast<uint16_t>(size_ - sizeof(uint32_t)), /*chop off
                                                                 NUM_RESTARTS*/
-            &map_offset);
+            &map_offset, hash_index_entry_offsets);
 
-        restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
-
-        if (restart_offset_ > map_offset) {
-          // map_offset is too small for NumRestarts() and
-          // therefore restart_offset_ wrapped around.
+        if (restarts_size > map_offset) {
+          // map_offset is too small for NumRestarts()
           size_ = 0;
           break;
         }
+        restart_offset_ = static_cast<uint32_t>(map_offset - restarts_size);
         break;
       default:
         size_ = 0;  // Error marker
     }
+    has_restart_prefixes_ = restart_key_prefixes && size_ != 0;
   }
   if (read_amp_bytes_per_bit != 0 && statistics && size_ != 0) {
-    read_amp_bitmap_.reset(new BlockReadAmpBitmap(
+    GetOrCreateExtras()->read_amp_bitmap.reset(new BlockReadAmpBitmap(
         restart_offset_, read_amp_bytes_per_bit, statistics));
   }
 }
@@ -1126,21 +1309,23 @@ void Block::InitializeDataBlockProtectionInfo(uint8_t protection_bytes_per_key,
         raw_ucmp, kDisableGlobalSequenceNumber, nullptr /* iter */,
         nullptr /* stats */, true /* block_contents_pinned */,
         true /* user_defined_timestamps_persisted */)};
+    Extras* extras = GetOrCreateExtras();
     if (iter->status().ok()) {
-      block_restart_interval_ = iter->GetRestartInterval();
+      extras->block_restart_interval = iter->GetRestartInterval();
     }
     uint32_t num_keys = 0;
     if (iter->status().ok()) {
-      num_keys = iter->NumberOfKeys(block_restart_interval_);
+      num_keys = iter->NumberOfKeys(extras->block_restart_interval);
     }
     if (iter->status().ok()) {
-      checksum_size_ = num_keys * protection_bytes_per_key;
-      kv_checksum_ = new char[(size_t)checksum_size_];
+      extras->checksum_size = num_keys * protection_bytes_per_key;
+      extras->kv_checksum.reset(new char[(size_t)extras->checksum_size]);
       size_t i = 0;
       iter->SeekToFirst();
       while (iter->Valid()) {
-        GenerateKVChecksum(kv_checksum_ + i, protection_bytes_per_key,
-                           iter->key(), iter->value());
+        GenerateKVChecksum(extras->kv_checksum.get() + i,
+                           protection_bytes_per_key, iter->key(),
+                           iter->value());
         iter->Next();
         i += protection_bytes_per_key;
       }
@@ -1175,21 +1360,23 @@ void Block::InitializeIndexBlockProtectionInfo(uint8_t protection_bytes_per_key,
         value_is_full, true /* block_contents_pinned */,
         true /* user_defined_timestamps_persisted*/,
         nullptr /* prefix_index */)};
+    Extras* extras = GetOrCreateExtras();
     if (iter->status().ok()) {
-      block_restart_interval_ = iter->GetRestartInterval();
+      extras->block_restart_interval = iter->GetRestartInterval();
     }
     uint32_t num_keys = 0;
     if (iter->status().ok()) {
-      num_keys = iter->NumberOfKeys(block_restart_interval_);
+      num_keys = iter->NumberOfKeys(extras->block_restart_interval);
     }
     if (iter->status().ok()) {
-      checksum_size_ = num_keys * protection_bytes_per_key;
-      kv_checksum_ = new char[(size_t)checksum_size_];
+      extras->checksum_size = num_keys * protection_bytes_per_key;
+      extras->kv_checksum.reset(new char[(size_t)extras->checksum_size]);
       iter->SeekToFirst();
       size_t i = 0;
       while (iter->Valid()) {
-        GenerateKVChecksum(kv_checksum_ + i, protection_bytes_per_key,
-                           iter->key(), iter->raw_value());
+        GenerateKVChecksum(extras->kv_checksum.get() + i,
+                           protection_bytes_per_key, iter->key(),
+                           iter->raw_value());
         iter->Next();
         i += protection_bytes_per_key;
       }
@@ -1209,21 +1396,23 @@ void Block::InitializeMetaIndexBlockProtectionInfo(
   if (num_restarts_ > 0 && protection_bytes_per_key > 0) {
     std::unique_ptr<MetaBlockIter> iter{
         NewMetaIterator(true /* block_contents_pinned */)};
+    Extras* extras = GetOrCreateExtras();
     if (iter->status().ok()) {
-      block_restart_interval_ = iter->GetRestartInterval();
+      extras->block_restart_interval = iter->GetRestartInterval();
     }
     uint32_t num_keys = 0;
     if (iter->status().ok()) {
-      num_keys = iter->NumberOfKeys(block_restart_interval_);
+      num_keys = iter->NumberOfKeys(extras->block_restart_interval);
     }
     if (iter->status().ok()) {
-      checksum_size_ = num_keys * protection_bytes_per_key;
-      kv_checksum_ = new char[(size_t)checksum_size_];
+      extras->checksum_size = num_keys * protection_bytes_per_key;
+      extras->kv_checksum.reset(new char[(size_t)extras->checksum_size]);
       iter->SeekToFirst();
       size_t i = 0;
       while (iter->Valid()) {
-        GenerateKVChecksum(kv_checksum_ + i, protection_bytes_per_key,
-                           iter->key(), iter->value());
+        GenerateKVChecksum(extras->kv_checksum.get() + i,
+                           protection_bytes_per_key, iter->key(),
+                           iter->value());
         iter->Next();
         i += protection_bytes_per_key;
       }
@@ -1246,9 +1435,9 @@ MetaBlockIter* Block::NewMetaIterator(bool block_contents_pinned) {
     // Empty block.
     iter->Invalidate(Status::OK());
   } else {
-    iter->Initialize(data_, restart_offset_, num_restarts_,
+    iter->Initialize(data(), restart_offset_, num_restarts_,
                      block_contents_pinned, protection_bytes_per_key_,
-                     kv_checksum_, block_restart_interval_);
+                     kv_checksum(), block_restart_interval());
   }
   return iter;
 }
@@ -1273,16 +1462,18 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
     ret_iter->Invalidate(Status::OK());
     return ret_iter;
   } else {
+    BlockReadAmpBitmap* read_amp_bitmap = this->read_amp_bitmap();
     ret_iter->Initialize(
-        raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
-        read_amp_bitmap_.get(), block_contents_pinned,
+        raw_ucmp, data(), restart_offset_, num_restarts_, global_seqno,
+        read_amp_bitmap, block_contents_pinned,
         user_defined_timestamps_persisted,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
-    if (read_amp_bitmap_) {
-      if (read_amp_bitmap_->GetStatistics() != stats) {
-        // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
-        read_amp_bitmap_->SetStatistics(stats);
+        restart_prefixes(), protection_bytes_per_key_, kv_checksum(),
+        block_restart_interval());
+    if (read_amp_bitmap) {
+      if (read_amp_bitmap->GetStatistics() != stats) {
+        // DB changed the Statistics pointer, we need to notify read_amp_bitmap
+        read_amp_bitmap->SetStatistics(stats);
       }
     }
   }
@@ -1295,7 +1486,7 @@ IndexBlockIter* Block::NewIndexIterator(
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
     bool block_contents_pinned, bool user_defined_timestamps_persisted,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index, const LearnedIndex* learned_index) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1314,10 +1505,11 @@ IndexBlockIter* Block::NewIndexIterator(
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index;
     ret_iter->Initialize(
-        raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
+        raw_ucmp, data(), restart_offset_, num_restarts_, global_seqno,
         prefix_index_ptr, have_first_key, key_includes_seq, value_is_full,
         block_contents_pinned, user_defined_timestamps_persisted,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum(), block_restart_interval(),
+        learned_index);
   }
 
   return ret_iter;
@@ -1330,10 +1522,13 @@ size_t Block::ApproximateMemoryUsage() const {
 #else
   usage += sizeof(*this);
 #endif  // ROCKSDB_MALLOC_USABLE_SIZE
-  if (read_amp_bitmap_) {
-    usage += read_amp_bitmap_->ApproximateMemoryUsage();
+  if (extras_) {
+    usage += sizeof(Extras);
+    if (extras_->read_amp_bitmap) {
+      usage += extras_->read_amp_bitmap->ApproximateMemoryUsage();
+    }
+    usage += extras_->checksum_size;
   }
-  usage += checksum_size_;
   return usage;
 }
 
@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -24,6 +25,7 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_hash_index.h"
+#include "table/block_based/learned_index.h"
 #include "table/format.h"
 #include "table/internal_iterator.h"
 #include "test_util/sync_point.h"
@@ -164,12 +166,17 @@ class Block {
   ~Block();
 
   size_t size() const { return size_; }
-  const char* data() const { return data_; }
+  const char* data() const { return contents_.data.data(); }
   // The additional memory space taken by the block data.
   size_t usable_size() const { return contents_.usable_size(); }
   uint32_t NumRestarts() const;
   bool own_bytes() const { return contents_.own_bytes(); }
 
+  // The allocator of the contents if owned, null if allocated with new[]
+  MemoryAllocator* memory_allocator() const {
+    return contents_.allocation.get_deleter().allocator;
+  }
+
   BlockBasedTableOptions::DataBlockIndexType IndexType() const;
 
   // raw_ucmp is a raw (i.e., not wrapped by `UserComparatorWrapper`) user key
@@ -239,7 +246,8 @@ class Block {
       bool have_first_key, bool key_includes_seq, bool value_is_full,
       bool block_contents_pinned = false,
       bool user_defined_timestamps_persisted = true,
-      BlockPrefixIndex* prefix_index = nullptr);
+      BlockPrefixIndex* prefix_index = nullptr,
+      const LearnedIndex* learned_index = nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -273,21 +281,50 @@ class Block {
     ProtectionInfo64().ProtectKV(key, value).Encode(checksum_len, checksum_ptr);
   }
 
-  const char* TEST_GetKVChecksum() const { return kv_checksum_; }
+  const char* TEST_GetKVChecksum() const { return kv_checksum(); }
 
  private:
+  // Members most blocks do without, allocated only when needed to keep the
+  // Block of each cached block small
+  struct Extras {
+    std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap;
+    std::unique_ptr<char[]> kv_checksum;
+    uint32_t checksum_size = 0;
+    // Used by block iterators to calculate current key index within a block
+    uint32_t block_restart_interval = 0;
+  };
+
+  Extras* GetOrCreateExtras() {
+    if (!extras_) {
+      extras_.reset(new Extras());
+    }
+    return extras_.get();
+  }
+  BlockReadAmpBitmap* read_amp_bitmap() const {
+    return extras_ ? extras_->read_amp_bitmap.get() : nullptr;
+  }
+  const char* kv_checksum() const {
+    return extras_ ? extras_->kv_checksum.get() : nullptr;
+  }
+  uint32_t block_restart_interval() const {
+    return extras_ ? extras_->block_restart_interval : 0;
+  }
+  // The restart key prefixes following the restart array, or nullptr
+  const char* restart_prefixes() const {
+    return has_restart_prefixes_
+               ? data() + restart_offset_ + num_restarts_ * sizeof(uint32_t)
+               : nullptr;
+  }
+
+  // Kept to one cache line in 64-bit builds with NDEBUG
   BlockContents contents_;
-  const char* data_;         // contents_.data.data()
-  size_t size_;              // contents_.data.size()
-  uint32_t restart_offset_;  // Offset in data_ of restart array
+  uint32_t size_;            // contents_.data.size(), or 0 on error
+  uint32_t restart_offset_;  // Offset in data() of restart array
   uint32_t num_restarts_;
-  std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
-  char* kv_checksum_{nullptr};
-  uint32_t checksum_size_{0};
-  // Used by block iterators to calculate current key index within a block
-  uint32_t block_restart_interval_{0};
-  uint8_t protection_bytes_per_key_{0};
   DataBlockHashIndex data_block_hash_index_;
+  uint8_t protection_bytes_per_key_{0};
+  bool has_restart_prefixes_{false};
+  std::unique_ptr<Extras> extras_;
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -671,9 +708,12 @@ class BlockIter : public InternalIteratorBase<TValue> {
   }
 
  protected:
+  // Restart keys before `begin` must be known to be no greater than `target`,
+  // and those at or after `end` to be greater.
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t* index,
-                         bool* is_index_key_result);
+                         bool* is_index_key_result, uint32_t begin = 0,
+                         uint32_t end = std::numeric_limits<uint32_t>::max());
 
   // Find the first key in restart interval `index` that is >= `target`.
   // If there is no such key, iterator is positioned at the first key in
@@ -699,6 +739,7 @@ class DataBlockIter final : public BlockIter<Slice> {
                   bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   DataBlockHashIndex* data_block_hash_index,
+                  const char* restart_prefixes,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
                   uint32_t block_restart_interval) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
@@ -709,6 +750,7 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    restart_prefixes_ = restart_prefixes;
   }
 
   Slice value() const override {
@@ -785,8 +827,18 @@ class DataBlockIter final : public BlockIter<Slice> {
   int32_t prev_entries_idx_ = -1;
 
   DataBlockHashIndex* data_block_hash_index_;
+  // See Block::restart_prefixes_
+  const char* restart_prefixes_ = nullptr;
 
   bool SeekForGetImpl(const Slice& target);
+  // SeekForGetImpl() for a hash index holding entry offsets
+  bool SeekForGetEntryOffsetImpl(const Slice& target, uint32_t map_offset);
+
+  // Uses the restart key prefixes to find the restart points BinarySeek()
+  // still has to compare with `target`: [*begin, *end) are the ones sharing
+  // the prefix of its user key.
+  void RestartRangeForPrefix(const Slice& target, uint32_t* begin,
+                             uint32_t* end) const;
 };
 
 // Iterator over MetaBlocks.  MetaBlocks are similar to Data Blocks and
@@ -831,7 +883,8 @@ class MetaBlockIter final : public BlockIter<Slice> {
 
 class IndexBlockIter final : public BlockIter<IndexValue> {
  public:
-  IndexBlockIter() : BlockIter(), prefix_index_(nullptr) {}
+  IndexBlockIter()
+      : BlockIter(), prefix_index_(nullptr), learned_index_(nullptr) {}
 
   // key_includes_seq, default true, means that the keys are in internal key
   // format.
@@ -844,13 +897,15 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                   bool value_is_full, bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const LearnedIndex* learned_index = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts,
                    kDisableGlobalSequenceNumber, block_contents_pinned,
                    user_defined_timestamps_persisted, protection_bytes_per_key,
                    kv_checksum, block_restart_interval);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
+    learned_index_ = learned_index;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
@@ -920,6 +975,8 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  // Predicts the restart points to binary search, see LearnedSeek()
+  const LearnedIndex* learned_index_;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -958,6 +1015,10 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                             uint32_t left, uint32_t right, uint32_t* index,
                             bool* prefix_may_exist);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
+  // Like BinarySeek(), but only searches the restart points predicted by
+  // learned_index_, unless the keys around them show the prediction is wrong.
+  bool LearnedSeek(const Slice& target, uint32_t* index,
+                   bool* skip_linear_scan);
 
   inline bool ParseNextIndexKey();
 
@@ -41,6 +41,7 @@
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/data_block_properties.h"
 #include "table/block_based/filter_block.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
@@ -105,6 +106,9 @@ FilterBlockBuilder* CreateFilterBlockBuilder(
   }
 }
 
+// See Rep::adaptive_compression
+constexpr uint64_t kAdaptiveCompressionSamplePeriod = 16;
+
 bool GoodCompressionRatio(size_t compressed_size, size_t uncomp_size,
                           int max_compressed_bytes_per_kb) {
   // For efficiency, avoid floating point and division
@@ -120,7 +124,7 @@ Slice CompressBlock(const Slice& uncompressed_data, const CompressionInfo& info,
                     CompressionType* type, uint32_t format_version,
                     bool allow_sample, std::string* compressed_output,
                     std::string* sampled_output_fast,
-                    std::string* sampled_output_slow) {
+                    std::string* sampled_output_slow, Compressor* compressor) {
   assert(type);
   assert(compressed_output);
   assert(compressed_output->empty());
@@ -169,10 +173,14 @@ Slice CompressBlock(const Slice& uncompressed_data, const CompressionInfo& info,
     return uncompressed_data;
   }
 
-  // Actually compress the data; if the compression method is not supported,
-  // or the compression fails etc., just fall back to uncompressed
-  if (!CompressData(uncompressed_data, info,
-                    GetCompressFormatForVersion(format_version),
+  // Actually compress the data, with the compressor if it takes the block;
+  // if the compression method is not supported, or the compression fails
+  // etc., just fall back to uncompressed
+  const uint32_t compress_format_version =
+      GetCompressFormatForVersion(format_version);
+  if (!CompressWithCompressor(compressor, uncompressed_data, info,
+                              compress_format_version, compressed_output) &&
+      !CompressData(uncompressed_data, info, compress_format_version,
                     compressed_output)) {
     *type = kNoCompression;
     return uncompressed_data;
@@ -308,6 +316,15 @@ struct BlockBasedTableBuilder::Rep {
   std::vector<std::unique_ptr<CompressionContext>> compression_ctxs;
   std::vector<std::unique_ptr<UncompressionContext>> verify_ctxs;
   std::unique_ptr<UncompressionDict> verify_dict;
+  // Adaptive compression of data blocks, see
+  // CompressionOptions::adaptive_tolerance_pct. Besides no compression and
+  // compression_type, adaptive_fast_type is a candidate unless it is
+  // kNoCompression. adaptive_compression_type is the type picked by the last
+  // sampled data block, for the data blocks up to the next sampled one.
+  bool adaptive_compression = false;
+  CompressionType adaptive_fast_type = kNoCompression;
+  std::atomic<uint64_t> num_adaptive_data_blocks{0};
+  std::atomic<CompressionType> adaptive_compression_type{kNoCompression};
 
   size_t data_begin_offset = 0;
 
@@ -353,6 +370,7 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
+  DataBlockProperties::Builder data_block_properties_builder;
 
   std::unique_ptr<ParallelCompressionRep> pc_rep;
   BlockCreateContext create_context;
@@ -458,7 +476,13 @@ struct BlockBasedTableBuilder::Rep {
                        ? BlockBasedTableOptions::kDataBlockBinarySearch
                        : table_options.data_block_index_type,
                    table_options.data_block_hash_table_util_ratio, ts_sz,
-                   persist_user_defined_timestamps),
+                   persist_user_defined_timestamps, false /* is_user_key */,
+                   table_options.data_block_restart_key_prefixes &&
+                       tbo.internal_comparator.user_comparator() ==
+                           BytewiseComparator() &&
+                       ts_sz == 0,
+                   table_options.data_block_hash_index_entry_offsets &&
+                       ts_sz == 0),
         range_del_block(
             1 /* block_restart_interval */, true /* use_delta_encoding */,
             false /* use_value_delta_encoding */,
@@ -528,6 +552,23 @@ struct BlockBasedTableBuilder::Rep {
       compression_ctxs[i].reset(
           new CompressionContext(compression_type, compression_opts));
     }
+    // Blocks compressed with a dictionary could not be told from the others
+    // when read
+    if (compression_opts.adaptive_tolerance_pct > 0 &&
+        compression_type != kNoCompression &&
+        compression_opts.max_dict_bytes == 0) {
+      adaptive_compression = true;
+      if (LZ4_Supported()) {
+        adaptive_fast_type = kLZ4Compression;
+      } else if (Snappy_Supported()) {
+        adaptive_fast_type = kSnappyCompression;
+      }
+      if (adaptive_fast_type == compression_type) {
+        adaptive_fast_type = kNoCompression;
+      }
+      adaptive_compression_type.store(compression_type,
+                                      std::memory_order_relaxed);
+    }
     if (table_options.index_type ==
         BlockBasedTableOptions::kTwoLevelIndexSearch) {
       p_index_builder_ = PartitionedIndexBuilder::CreateIndexBuilder(
@@ -840,14 +881,20 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
   std::condition_variable first_block_cond;
   std::mutex first_block_mutex;
 
+  // Blocks that may be in flight between Flush() and the write thread, per
+  // compression thread. The write thread takes blocks in order, so with only
+  // one block per thread every compression thread would sit idle whenever
+  // the oldest block is slow to compress, and so would Flush().
+  static constexpr uint32_t kBlocksInFlightPerThread = 4;
+
   explicit ParallelCompressionRep(uint32_t parallel_threads)
       : curr_block_keys(new Keys()),
-        block_rep_buf(parallel_threads),
-        block_rep_pool(parallel_threads),
-        compress_queue(parallel_threads),
-        write_queue(parallel_threads),
+        block_rep_buf(parallel_threads * kBlocksInFlightPerThread),
+        block_rep_pool(parallel_threads * kBlocksInFlightPerThread),
+        compress_queue(parallel_threads * kBlocksInFlightPerThread),
+        write_queue(parallel_threads * kBlocksInFlightPerThread),
         first_block_processed(false) {
-    for (uint32_t i = 0; i < parallel_threads; i++) {
+    for (size_t i = 0; i < block_rep_buf.size(); i++) {
       block_rep_buf[i].contents = Slice();
       block_rep_buf[i].compressed_contents = Slice();
       block_rep_buf[i].data.reset(new std::string());
@@ -1106,6 +1153,8 @@ void BlockBasedTableBuilder::Flush() {
   if (r->data_block.empty()) {
     return;
   }
+  r->data_block_properties_builder.FinishDataBlock(
+      r->table_properties_collectors);
   if (r->IsParallelCompressionEnabled() &&
       r->state == Rep::State::kUnbuffered) {
     r->data_block.Finish();
@@ -1212,12 +1261,82 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
                                      *compression_dict, r->compression_type,
                                      r->sample_for_compression);
 
+    // With adaptive compression, every kAdaptiveCompressionSamplePeriod-th
+    // data block is compressed with all the candidate types, to pick the type
+    // of the data blocks up to the next sampled one
+    CompressionType target_type = r->compression_type;
+    bool pick_type = false;
+    if (is_data_block && r->adaptive_compression) {
+      pick_type = r->num_adaptive_data_blocks.fetch_add(
+                      1, std::memory_order_relaxed) %
+                      kAdaptiveCompressionSamplePeriod ==
+                  0;
+      target_type =
+          r->adaptive_compression_type.load(std::memory_order_relaxed);
+    }
+
     std::string sampled_output_fast;
     std::string sampled_output_slow;
-    *block_contents = CompressBlock(
-        uncompressed_block_data, compression_info, type,
-        r->table_options.format_version, is_data_block /* allow_sample */,
-        compressed_output, &sampled_output_fast, &sampled_output_slow);
+    if (pick_type || target_type == r->compression_type) {
+      *block_contents = CompressBlock(
+          uncompressed_block_data, compression_info, type,
+          r->table_options.format_version, is_data_block /* allow_sample */,
+          compressed_output, &sampled_output_fast, &sampled_output_slow,
+          r->table_options.compressor.get());
+    } else {
+      *type = kNoCompression;
+    }
+
+    // Compressed with the fast type when picking the type or when it was
+    // picked
+    std::string fast_output;
+    CompressionType fast_type = kNoCompression;
+    if ((pick_type && r->adaptive_fast_type != kNoCompression) ||
+        (!pick_type && target_type == r->adaptive_fast_type &&
+         target_type != kNoCompression)) {
+      CompressionOptions fast_opts;
+      fast_opts.max_compressed_bytes_per_kb =
+          r->compression_opts.max_compressed_bytes_per_kb;
+      CompressionContext fast_ctx(r->adaptive_fast_type, fast_opts);
+      CompressionInfo fast_info(fast_opts, fast_ctx,
+                                CompressionDict::GetEmptyDict(),
+                                r->adaptive_fast_type,
+                                0 /* sample_for_compression */);
+      CompressBlock(uncompressed_block_data, fast_info, &fast_type,
+                    r->table_options.format_version, false /* allow_sample */,
+                    &fast_output, nullptr, nullptr,
+                    r->table_options.compressor.get());
+    }
+
+    if (pick_type) {
+      // The cheapest type to decompress of no compression, the fast type and
+      // compression_type whose size is within the tolerance of the smallest
+      const uint64_t none_size = uncompressed_block_data.size();
+      const uint64_t fast_size =
+          fast_type != kNoCompression ? fast_output.size() : none_size;
+      const uint64_t size =
+          *type != kNoCompression ? compressed_output->size() : none_size;
+      const uint64_t max_size =
+          std::min({none_size, fast_size, size}) *
+          (100 + r->compression_opts.adaptive_tolerance_pct) / 100;
+      if (none_size <= max_size) {
+        target_type = kNoCompression;
+      } else if (fast_size <= max_size) {
+        target_type = r->adaptive_fast_type;
+      } else {
+        target_type = r->compression_type;
+      }
+      r->adaptive_compression_type.store(target_type,
+                                         std::memory_order_relaxed);
+    }
+    if (target_type == kNoCompression) {
+      *type = kNoCompression;
+    } else if (target_type != r->compression_type) {
+      assert(target_type == r->adaptive_fast_type);
+      compressed_output->swap(fast_output);
+      *type = fast_type;
+      *block_contents = *compressed_output;
+    }
 
     if (sampled_output_slow.size() > 0 || sampled_output_fast.size() > 0) {
       // Currently compression sampling is only enabled for data block.
@@ -1247,8 +1366,7 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
       }
       assert(verify_dict != nullptr);
       BlockContents contents;
-      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict,
-                                           r->compression_type);
+      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict, *type);
       Status uncompress_status = UncompressBlockData(
           uncompression_info, block_contents->data(), block_contents->size(),
           &contents, r->table_options.format_version, r->ioptions);
@@ -1322,6 +1440,9 @@ void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
   const uint64_t offset = r->get_offset();
   handle->set_offset(offset);
   handle->set_size(block_contents.size());
+  if (is_data_block) {
+    r->data_block_properties_builder.AddDataBlockOffset(offset);
+  }
   assert(status().ok());
   assert(io_status().ok());
   if (uncompressed_block_data == nullptr) {
@@ -1784,6 +1905,19 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WriteDataBlockPropertiesBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  std::string contents;
+  if (ok() && rep_->data_block_properties_builder.Finish(&contents)) {
+    BlockHandle data_block_properties_handle;
+    WriteMaybeCompressedBlock(contents, kNoCompression,
+                              &data_block_properties_handle,
+                              BlockType::kProperties);
+    meta_index_builder->Add(kDataBlockPropertiesBlockName,
+                            data_block_properties_handle);
+  }
+}
+
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
                                          BlockHandle& index_block_handle) {
   assert(ok());
@@ -1995,15 +2129,17 @@ Status BlockBasedTableBuilder::Finish() {
   //    2. [meta block: index]
   //    3. [meta block: compression dictionary]
   //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: properties]
-  //    6. [metaindex block]
-  //    7. Footer
+  //    5. [meta block: data block properties]
+  //    6. [meta block: properties]
+  //    7. [metaindex block]
+  //    8. Footer
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WriteDataBlockPropertiesBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
@@ -20,9 +20,11 @@
 #include "options/options_helper.h"
 #include "port/port.h"
 #include "rocksdb/cache.h"
+#include "rocksdb/compressor.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/flush_block_policy.h"
+#include "rocksdb/memory_allocator.h"
 #include "rocksdb/rocksdb_namespace.h"
 #include "rocksdb/table.h"
 #include "rocksdb/utilities/options_type.h"
@@ -45,6 +47,28 @@ void TailPrefetchStats::RecordEffectiveSize(size_t len) {
   }
 }
 
+void ScanReadaheadStats::RecordScanSize(size_t len) {
+  records_[next_.FetchAddRelaxed(1) % kNumTracked].StoreRelaxed(len);
+}
+
+size_t ScanReadaheadStats::GetSuggestedScanSize() const {
+  std::array<size_t, kNumTracked> sorted;
+  size_t num_records = 0;
+  for (const auto& record : records_) {
+    size_t len = record.LoadRelaxed();
+    if (len > 0) {
+      sorted[num_records++] = len;
+    }
+  }
+  if (num_records == 0) {
+    return 0;
+  }
+  // The 75th percentile, so that most scans are read in one go, without
+  // reading ahead much more than the longest ones need
+  std::sort(sorted.begin(), sorted.begin() + num_records);
+  return sorted[num_records * 3 / 4];
+}
+
 size_t TailPrefetchStats::GetSuggestedPrefetchSize() {
   std::vector<size_t> sorted;
   {
@@ -181,7 +205,9 @@ static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kLearnedIndexSearch",
+         BlockBasedTableOptions::IndexType::kLearnedIndexSearch}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::DataBlockIndexType>
@@ -215,7 +241,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"unpartitioned_pinning",
          OptionTypeInfo::Enum<PinningTier>(
              offsetof(struct MetadataCacheOptions, unpartitioned_pinning),
-             &pinning_tier_type_string_map)}};
+             &pinning_tier_type_string_map)},
+        {"dynamic_pinning_budget",
+         {offsetof(struct MetadataCacheOptions, dynamic_pinning_budget),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::PrepopulateBlockCache>
@@ -269,6 +299,16 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    data_block_hash_table_util_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"data_block_restart_key_prefixes",
+         {offsetof(struct BlockBasedTableOptions,
+                   data_block_restart_key_prefixes),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"data_block_hash_index_entry_offsets",
+         {offsetof(struct BlockBasedTableOptions,
+                   data_block_hash_index_entry_offsets),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"checksum",
          {offsetof(struct BlockBasedTableOptions, checksum),
           OptionType::kChecksumType, OptionVerificationType::kNormal,
@@ -293,6 +333,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions, index_block_restart_interval),
           OptionType::kInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"index_partition_restart_interval",
+         {offsetof(struct BlockBasedTableOptions,
+                   index_partition_restart_interval),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"index_per_partition",
          {0, OptionType::kUInt64T, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
@@ -316,6 +361,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
              offsetof(struct BlockBasedTableOptions, filter_policy),
              OptionVerificationType::kByNameAllowFromNull,
              OptionTypeFlags::kNone)},
+        {"compressor",
+         OptionTypeInfo::AsCustomSharedPtr<Compressor>(
+             offsetof(struct BlockBasedTableOptions, compressor),
+             OptionVerificationType::kByNameAllowFromNull,
+             OptionTypeFlags::kNone)},
         {"whole_key_filtering",
          {offsetof(struct BlockBasedTableOptions, whole_key_filtering),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -393,6 +443,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"block_cache_compressed",
          {0, OptionType::kUnknown, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kNone}},
+        {"far_memory_promotion_hits",
+         {offsetof(struct BlockBasedTableOptions, far_memory_promotion_hits),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"max_auto_readahead_size",
          {offsetof(struct BlockBasedTableOptions, max_auto_readahead_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
@@ -411,6 +465,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    num_file_reads_for_auto_readahead),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"learn_auto_readahead_size",
+         {offsetof(struct BlockBasedTableOptions, learn_auto_readahead_size),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 
 };
 
@@ -418,7 +476,8 @@ static std::unordered_map<std::string, OptionTypeInfo>
 // options
 BlockBasedTableFactory::BlockBasedTableFactory(
     const BlockBasedTableOptions& _table_options)
-    : table_options_(_table_options) {
+    : table_options_(_table_options),
+      scan_readahead_stats_(std::make_shared<ScanReadaheadStats>()) {
   InitializeOptions();
   RegisterOptions(&table_options_, &block_based_table_type_info);
 
@@ -458,6 +517,9 @@ void BlockBasedTableFactory::InitializeOptions() {
   if (table_options_.index_block_restart_interval < 1) {
     table_options_.index_block_restart_interval = 1;
   }
+  if (table_options_.index_partition_restart_interval < 0) {
+    table_options_.index_partition_restart_interval = 0;
+  }
   if (table_options_.index_type == BlockBasedTableOptions::kHashSearch &&
       table_options_.index_block_restart_interval != 1) {
     // Currently kHashSearch is incompatible with
@@ -483,6 +545,17 @@ void BlockBasedTableFactory::InitializeOptions() {
       options_overrides_iter->second.charged = options.charged;
     }
   }
+  const size_t pinning_budget =
+      table_options_.metadata_cache_options.dynamic_pinning_budget;
+  if (pinning_budget == 0 || table_options_.block_cache == nullptr) {
+    metadata_block_pinner_.reset();
+  } else if (metadata_block_pinner_ == nullptr ||
+             metadata_block_pinner_->budget() != pinning_budget ||
+             metadata_block_pinner_->block_cache() !=
+                 table_options_.block_cache.get()) {
+    metadata_block_pinner_ = std::make_shared<MetadataBlockPinner>(
+        table_options_.block_cache, pinning_budget);
+  }
 }
 
 Status BlockBasedTableFactory::PrepareOptions(const ConfigOptions& opts) {
@@ -578,7 +651,11 @@ Status BlockBasedTableFactory::NewTableReader(
       table_reader_options.max_file_size_for_l0_meta_pin,
       table_reader_options.cur_db_session_id, table_reader_options.cur_file_num,
       table_reader_options.unique_id,
-      table_reader_options.user_defined_timestamps_persisted);
+      table_reader_options.user_defined_timestamps_persisted,
+      table_options_.learn_auto_readahead_size ? scan_readahead_stats_
+                                               : nullptr,
+      table_reader_options.block_fetch_hists,
+      table_reader_options.block_cache_heat_map, metadata_block_pinner_);
 }
 
 TableBuilder* BlockBasedTableFactory::NewTableBuilder(
@@ -753,6 +830,12 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  data_block_hash_table_util_ratio: %lf\n",
            table_options_.data_block_hash_table_util_ratio);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_restart_key_prefixes: %d\n",
+           table_options_.data_block_restart_key_prefixes);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_hash_index_entry_offsets: %d\n",
+           table_options_.data_block_hash_index_entry_offsets);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  checksum: %d\n", table_options_.checksum);
   ret.append(buffer);
   snprintf(buffer, kBufferSize, "  no_block_cache: %d\n",
@@ -779,6 +862,14 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
     ret.append(buffer);
     ret.append(table_options_.persistent_cache->GetPrintableOptions());
   }
+  snprintf(buffer, kBufferSize, "  far_memory_allocator: %s\n",
+           table_options_.far_memory_allocator
+               ? table_options_.far_memory_allocator->Name()
+               : "None");
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  far_memory_promotion_hits: %" PRIu32 "\n",
+           table_options_.far_memory_promotion_hits);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  block_size: %" PRIu64 "\n",
            table_options_.block_size);
   ret.append(buffer);
@@ -791,6 +882,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  index_partition_restart_interval: %d\n",
+           table_options_.index_partition_restart_interval);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  metadata_block_size: %" PRIu64 "\n",
            table_options_.metadata_block_size);
   ret.append(buffer);
@@ -805,6 +899,11 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
                ? "nullptr"
                : table_options_.filter_policy->Name());
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  compressor: %s\n",
+           table_options_.compressor == nullptr
+               ? "nullptr"
+               : table_options_.compressor->Name());
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  whole_key_filtering: %d\n",
            table_options_.whole_key_filtering);
   ret.append(buffer);
@@ -838,6 +937,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
            "  num_file_reads_for_auto_readahead: %" PRIu64 "\n",
            table_options_.num_file_reads_for_auto_readahead);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  learn_auto_readahead_size: %d\n",
+           table_options_.learn_auto_readahead_size);
+  ret.append(buffer);
   return ret;
 }
 
@@ -958,6 +1060,7 @@ const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kLearnedIndexBlock = "rocksdb.learnedindex";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -10,6 +10,7 @@
 #pragma once
 #include <stdint.h>
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -17,6 +18,8 @@
 #include "port/port.h"
 #include "rocksdb/flush_block_policy.h"
 #include "rocksdb/table.h"
+#include "table/block_based/metadata_block_pinner.h"
+#include "util/atomic.h"
 
 namespace ROCKSDB_NAMESPACE {
 struct ColumnFamilyOptions;
@@ -47,6 +50,22 @@ class TailPrefetchStats {
   size_t num_records_ = 0;
 };
 
+// Tracks the lengths in bytes of the recent sequential scans of data blocks
+// by iterators, to size the readahead of new scans, see
+// BlockBasedTableOptions::learn_auto_readahead_size. Without a mutex, as
+// each scan records its length.
+class ScanReadaheadStats {
+ public:
+  void RecordScanSize(size_t len);
+  // A size covering most of the recent scans, 0 with no scan recorded yet
+  size_t GetSuggestedScanSize() const;
+
+ private:
+  static constexpr size_t kNumTracked = 32;
+  std::array<RelaxedAtomic<size_t>, kNumTracked> records_;
+  RelaxedAtomic<size_t> next_{0};
+};
+
 class BlockBasedTableFactory : public TableFactory {
  public:
   explicit BlockBasedTableFactory(
@@ -93,10 +112,16 @@ class BlockBasedTableFactory : public TableFactory {
   BlockBasedTableOptions table_options_;
   std::shared_ptr<CacheReservationManager> table_reader_cache_res_mgr_;
   mutable TailPrefetchStats tail_prefetch_stats_;
+  // Shared with the table readers, which may outlive the factory
+  std::shared_ptr<ScanReadaheadStats> scan_readahead_stats_;
+  // For MetadataCacheOptions::dynamic_pinning_budget, null if not set.
+  // Shared with the table readers like scan_readahead_stats_.
+  std::shared_ptr<MetadataBlockPinner> metadata_block_pinner_;
 };
 
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexBlock;
 extern const std::string kPropTrue;
 extern const std::string kPropFalse;
 }  // namespace ROCKSDB_NAMESPACE
@@ -13,7 +13,10 @@ namespace ROCKSDB_NAMESPACE {
 void BlockBasedTableIterator::SeekToFirst() { SeekImpl(nullptr, false); }
 
 void BlockBasedTableIterator::Seek(const Slice& target) {
-  SeekImpl(&target, true);
+  // Compactions read ahead asynchronously, but their seeks are rare and not
+  // retried on Status::TryAgain() by CompactionMergingIterator
+  SeekImpl(&target,
+           lookup_context_.caller != TableReaderCaller::kCompaction);
 }
 
 void BlockBasedTableIterator::SeekSecondPass(const Slice* target) {
@@ -66,6 +69,17 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
                                             : NON_LAST_LEVEL_SEEK_FILTERED);
     return;
   }
+  if (target && check_range_filter_ &&
+      !table_->RangeMayMatch(*target, read_options_, &lookup_context_)) {
+    // No key in [target, iterate_upper_bound). Like with the prefix filter,
+    // don't report out of bound, since the file might hold range tombstones
+    // beyond its last key.
+    ResetDataIter();
+    RecordTick(table_->GetStatistics(), is_last_level_
+                                            ? LAST_LEVEL_SEEK_FILTERED
+                                            : NON_LAST_LEVEL_SEEK_FILTERED);
+    return;
+  }
   if (filter_checked) {
     seek_stat_state_ = kFilterUsed;
     RecordTick(table_->GetStatistics(), is_last_level_
@@ -122,7 +136,7 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
 
   if (!v.first_internal_key.empty() && !same_block &&
       (!target || icomp_.Compare(*target, v.first_internal_key) <= 0) &&
-      allow_unprepared_value_) {
+      allow_unprepared_value_ && CheckBlockPropertiesMayMatch(v.handle)) {
     // Index contains the first key of the block, and it's >= target.
     // We can defer reading the block.
     is_at_first_key_from_index_ = true;
@@ -133,7 +147,8 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
   } else {
     // Need to use the data block.
     if (!same_block) {
-      if (read_options_.async_io && async_prefetch) {
+      if (read_options_.async_io && async_prefetch &&
+          CheckBlockPropertiesMayMatch(v.handle)) {
         AsyncInitDataBlock(/*is_first_pass=*/true);
         if (async_read_in_progress_) {
           // Status::TryAgain indicates asynchronous request for retrieval of
@@ -353,6 +368,15 @@ void BlockBasedTableIterator::InitDataBlock() {
       ResetDataIter();
     }
 
+    if (!CheckBlockPropertiesMayMatch(data_block_handle)) {
+      // Leave block_iter_ empty, so that callers move on to the next block
+      // as if this one had no keys.
+      block_iter_.Invalidate(Status::OK());
+      block_iter_points_to_real_block_ = true;
+      CheckDataBlockWithinUpperBound();
+      return;
+    }
+
     bool is_for_compaction =
         lookup_context_.caller == TableReaderCaller::kCompaction;
 
@@ -591,7 +615,13 @@ void BlockBasedTableIterator::FindBlockForward() {
       //    it's already pointing to next block;
       // 3. Last block could be out of bound and it won't iterate over that
       // during BlockCacheLookup. We need to set for that block here.
+      bool has_prev_index_key = false;
       if (IsIndexAtCurr() || is_index_out_of_bound_) {
+        if (covered_range_checker_ != nullptr && IsIndexAtCurr() &&
+            index_iter_->Valid()) {
+          prev_index_user_key_.SetUserKey(index_iter_->user_key());
+          has_prev_index_key = true;
+        }
         index_iter_->Next();
         if (is_index_out_of_bound_) {
           next_block_is_out_of_bound = is_index_out_of_bound_;
@@ -616,12 +646,16 @@ void BlockBasedTableIterator::FindBlockForward() {
         return;
       }
 
+      if (covered_range_checker_ != nullptr) {
+        SkipCoveredBlocks(has_prev_index_key);
+      }
       if (!index_iter_->Valid()) {
         return;
       }
       IndexValue v = index_iter_->value();
 
-      if (!v.first_internal_key.empty() && allow_unprepared_value_) {
+      if (!v.first_internal_key.empty() && allow_unprepared_value_ &&
+          CheckBlockPropertiesMayMatch(v.handle)) {
         // Index contains the first key of the block. Defer reading the block.
         is_at_first_key_from_index_ = true;
         return;
@@ -632,6 +666,39 @@ void BlockBasedTableIterator::FindBlockForward() {
   } while (!block_iter_.Valid());
 }
 
+void BlockBasedTableIterator::SkipCoveredBlocks(bool has_prev_index_key) {
+  while (index_iter_->Valid()) {
+    // The keys of the block are at least its first key when the index has
+    // it, and otherwise the index key of the block before it
+    IndexValue v = index_iter_->value();
+    Slice smallest_user_key;
+    if (!v.first_internal_key.empty()) {
+      smallest_user_key = ExtractUserKey(v.first_internal_key);
+    } else if (has_prev_index_key) {
+      smallest_user_key = prev_index_user_key_.GetUserKey();
+    } else {
+      return;
+    }
+    const Slice largest_user_key = index_iter_->user_key();
+    // Keep the block that may be the last one within the upper bound, for
+    // FindBlockForward() to check the bound against
+    if (read_options_.iterate_upper_bound != nullptr &&
+        user_comparator_.CompareWithoutTimestamp(
+            *read_options_.iterate_upper_bound, /*a_has_ts=*/false,
+            largest_user_key, /*b_has_ts=*/true) <= 0) {
+      return;
+    }
+    if (!covered_range_checker_->IsCovered(smallest_user_key,
+                                           largest_user_key)) {
+      return;
+    }
+    TEST_SYNC_POINT("BlockBasedTableIterator:SkipCoveredBlock");
+    prev_index_user_key_.SetUserKey(largest_user_key);
+    has_prev_index_key = true;
+    index_iter_->Next();
+  }
+}
+
 void BlockBasedTableIterator::FindKeyBackward() {
   while (!block_iter_.Valid()) {
     if (!block_iter_.status().ok()) {
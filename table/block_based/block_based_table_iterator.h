@@ -25,7 +25,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
       const BlockBasedTable* table, const ReadOptions& read_options,
       const InternalKeyComparator& icomp,
       std::unique_ptr<InternalIteratorBase<IndexValue>>&& index_iter,
-      bool check_filter, bool need_upper_bound_check,
+      bool check_filter, bool check_range_filter, bool need_upper_bound_check,
       const SliceTransform* prefix_extractor, TableReaderCaller caller,
       size_t compaction_readahead_size = 0, bool allow_unprepared_value = false)
       : index_iter_(std::move(index_iter)),
@@ -38,10 +38,14 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
         lookup_context_(caller),
         block_prefetcher_(
             compaction_readahead_size,
-            table_->get_rep()->table_options.initial_auto_readahead_size),
+            table_->get_rep()->table_options.initial_auto_readahead_size,
+            caller == TableReaderCaller::kCompaction
+                ? nullptr
+                : table_->get_rep()->scan_readahead_stats.get()),
         allow_unprepared_value_(allow_unprepared_value),
         block_iter_points_to_real_block_(false),
         check_filter_(check_filter),
+        check_range_filter_(check_range_filter),
         need_upper_bound_check_(need_upper_bound_check),
         async_read_in_progress_(false),
         is_last_level_(table->IsLastLevel()) {}
@@ -143,6 +147,9 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
     pinned_iters_mgr_ = pinned_iters_mgr;
   }
+  void SetCoveredRangeChecker(CoveredRangeChecker* checker) override {
+    covered_range_checker_ = checker;
+  }
   bool IsKeyPinned() const override {
     // Our key comes either from block_iter_'s current key
     // or index_iter_'s current *value*.
@@ -278,6 +285,13 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   const InternalKeyComparator& icomp_;
   UserComparatorWrapper user_comparator_;
   PinnedIteratorsManager* pinned_iters_mgr_;
+  // Set by the merging iterator, to skip the data blocks whose keys are all
+  // deleted by range tombstones of newer sorted runs
+  CoveredRangeChecker* covered_range_checker_ = nullptr;
+  // The user key of the index entry of the block before the one index_iter_
+  // moved to, a lower bound of the keys of that block. Only kept while
+  // covered_range_checker_ is set.
+  IterKey prev_index_user_key_;
   DataBlockIter block_iter_;
   const SliceTransform* prefix_extractor_;
   uint64_t prev_block_offset_ = std::numeric_limits<uint64_t>::max();
@@ -298,6 +312,8 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   // that block yet. A call to PrepareValue() will trigger loading the block.
   bool is_at_first_key_from_index_ = false;
   bool check_filter_;
+  // Whether to check the range filter on Seek() with an upper bound
+  bool check_range_filter_;
   // TODO(Zhongyi): pick a better name
   bool need_upper_bound_check_;
 
@@ -339,6 +355,10 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   bool MaterializeCurrentBlock();
   void FindKeyForward();
   void FindBlockForward();
+  // Moves index_iter_ past the blocks deleted by range tombstones of newer
+  // sorted runs, by their index keys, starting at the current one, which
+  // follows the block of prev_index_user_key_ if `has_prev_index_key`.
+  void SkipCoveredBlocks(bool has_prev_index_key);
   void FindKeyBackward();
   void CheckOutOfBound();
 
@@ -370,6 +390,17 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
     return true;
   }
 
+  // Returns false if ReadOptions::block_property_filter rules out the data
+  // block at `handle`, which then need not be read.
+  bool CheckBlockPropertiesMayMatch(const BlockHandle& handle) const {
+    const DataBlockProperties* data_block_properties =
+        table_->get_rep()->data_block_properties.get();
+    return !read_options_.block_property_filter ||
+           data_block_properties == nullptr ||
+           data_block_properties->MayMatch(handle.offset(),
+                                           read_options_.block_property_filter);
+  }
+
   // *** BEGIN APIs relevant to auto tuning of readahead_size ***
 
   // This API is called to lookup the data blocks ahead in the cache to tune
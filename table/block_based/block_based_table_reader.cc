@@ -35,6 +35,7 @@
 #include "rocksdb/cache.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/convenience.h"
+#include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/filter_policy.h"
@@ -56,6 +57,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -134,8 +136,14 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexBlock;
 
-BlockBasedTable::~BlockBasedTable() { delete rep_; }
+BlockBasedTable::~BlockBasedTable() {
+  if (rep_->metadata_block_pinner) {
+    rep_->metadata_block_pinner->EraseTable(this);
+  }
+  delete rep_;
+}
 
 namespace {
 // Read the block identified by "handle" from "file".
@@ -581,7 +589,11 @@ Status BlockBasedTable::Open(
     BlockCacheTracer* const block_cache_tracer,
     size_t max_file_size_for_l0_meta_pin, const std::string& cur_db_session_id,
     uint64_t cur_file_num, UniqueId64x2 expected_unique_id,
-    const bool user_defined_timestamps_persisted) {
+    const bool user_defined_timestamps_persisted,
+    std::shared_ptr<ScanReadaheadStats> scan_readahead_stats,
+    BlockFetchHistograms* block_fetch_hists,
+    BlockCacheHeatMap* block_cache_heat_map,
+    std::shared_ptr<MetadataBlockPinner> metadata_block_pinner) {
   table_reader->reset();
 
   Status s;
@@ -611,7 +623,17 @@ Status BlockBasedTable::Open(
       return s;
     }
   } else {
-    // Should not prefetch for mmap mode.
+    // Should not prefetch for mmap mode, but when the index and filter blocks
+    // are read at open, the pages of the tail can be read ahead at once
+    // rather than faulted in one by one
+    if ((prefetch_all || preload_all) && tail_size > 0) {
+      IOOptions opts;
+      if (file->PrepareIOOptions(ro, opts).ok()) {
+        file->Prefetch(opts, file_size - tail_size,
+                       static_cast<size_t>(tail_size))
+            .PermitUncheckedError();
+      }
+    }
     prefetch_buffer.reset(new FilePrefetchBuffer(
         0 /* readahead_size */, 0 /* max_readahead_size */, false /* enable */,
         true /* track_min_offset */));
@@ -647,6 +669,19 @@ Status BlockBasedTable::Open(
       file_size, level, immortal_table, user_defined_timestamps_persisted);
   rep->file = std::move(file);
   rep->footer = footer;
+  rep->scan_readahead_stats = std::move(scan_readahead_stats);
+  rep->block_fetch_hists = block_fetch_hists;
+  if (cur_file_num != 0) {
+    rep->block_cache_heat_map = block_cache_heat_map;
+    rep->file_number = cur_file_num;
+  }
+  rep->metadata_block_pinner = std::move(metadata_block_pinner);
+  rep->data_block_allocator = GetMemoryAllocator(table_options);
+  if (table_options.far_memory_allocator && level >= 0 &&
+      level == ioptions.num_levels - 1) {
+    rep->far_memory_allocator = table_options.far_memory_allocator.get();
+    rep->data_block_allocator = rep->far_memory_allocator;
+  }
 
   // For fully portable/stable cache keys, we need to read the properties
   // block before setting up cache keys. TODO: consider setting up a bootstrap
@@ -781,6 +816,11 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  s = new_table->ReadDataBlockPropertiesBlock(ro, prefetch_buffer.get(),
+                                              metaindex_iter.get());
+  if (!s.ok()) {
+    return s;
+  }
   rep->verify_checksum_set_on_open = ro.verify_checksums;
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
@@ -1018,6 +1058,40 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+Status BlockBasedTable::ReadDataBlockPropertiesBlock(
+    const ReadOptions& read_options, FilePrefetchBuffer* prefetch_buffer,
+    InternalIterator* meta_iter) {
+  BlockHandle data_block_properties_handle;
+  Status s = FindOptionalMetaBlock(meta_iter, kDataBlockPropertiesBlockName,
+                                   &data_block_properties_handle);
+  if (!s.ok() || data_block_properties_handle.IsNull()) {
+    // Like the range del block, a missing or unreadable block is not an
+    // error: no data block is skipped then.
+    IGNORE_STATUS_IF_ERROR(s);
+    return Status::OK();
+  }
+
+  BlockContents contents;
+  BlockFetcher block_fetcher(
+      rep_->file.get(), prefetch_buffer, rep_->footer, read_options,
+      data_block_properties_handle, &contents, rep_->ioptions,
+      false /* decompress */, false /* maybe_compressed */,
+      BlockType::kProperties, UncompressionDict::GetEmptyDict(),
+      rep_->persistent_cache_options, GetMemoryAllocator(rep_->table_options));
+  s = block_fetcher.ReadBlockContents();
+  if (s.ok()) {
+    s = DataBlockProperties::Create(std::move(contents),
+                                    &rep_->data_block_properties);
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Failed to read data block properties: %s",
+                   s.ToString().c_str());
+    IGNORE_STATUS_IF_ERROR(s);
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
     InternalIterator* meta_iter, BlockBasedTable* new_table, bool prefetch_all,
@@ -1095,6 +1169,14 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
       }
     }
   }
+  // Range filters can rule out a range only in a full filter of whole keys
+  // in bytewise order
+  rep_->range_filtering =
+      rep_->filter_type == Rep::FilterType::kFullFilter &&
+      rep_->whole_key_filtering &&
+      rep_->internal_comparator.user_comparator() == BytewiseComparator() &&
+      rep_->filter_policy->IsInstanceOf(RangeFilterPolicy::kClassName());
+
   // Partition filters cannot be enabled without partition indexes
   assert(rep_->filter_type != Rep::FilterType::kPartitionedFilter ||
          rep_->index_type == BlockBasedTableOptions::kTwoLevelIndexSearch);
@@ -1250,6 +1332,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->table_properties) {
     usage += rep_->table_properties->ApproximateMemoryUsage();
   }
+  if (rep_->data_block_properties) {
+    usage += rep_->data_block_properties->ApproximateMemoryUsage();
+  }
   return usage;
 }
 
@@ -1391,6 +1476,10 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::PutDataBlockToCache(
 
     if (s.ok()) {
       assert(cache_handle != nullptr);
+      if (memory_allocator != nullptr &&
+          memory_allocator == rep_->far_memory_allocator) {
+        RecordTick(statistics, BLOCK_CACHE_FAR_MEMORY_ADD);
+      }
       out_parsed_block->SetCachedValue(block_holder.release(),
                                        block_cache.get(), cache_handle);
 
@@ -1406,6 +1495,33 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::PutDataBlockToCache(
   return s;
 }
 
+void BlockBasedTable::MaybePromoteFarMemoryBlock(
+    const Slice& cache_key, BlockCacheInterface<Block_kData> block_cache,
+    const CachableEntry<Block_kData>& entry) const {
+  const uint32_t one_in = rep_->table_options.far_memory_promotion_hits;
+  const Block_kData* block = entry.GetValue();
+  if (one_in == 0 || block == nullptr ||
+      block->memory_allocator() != rep_->far_memory_allocator ||
+      !Random::GetTLSInstance()->OneIn(static_cast<int>(one_in))) {
+    return;
+  }
+  // The copy is found by the next lookups, while the readers of the block in
+  // far memory keep it until they release it
+  MemoryAllocator* memory_allocator = GetMemoryAllocator(rep_->table_options);
+  Slice data = block->ContentSlice();
+  BlockContents contents(CopyBufferToHeap(memory_allocator, data),
+                         data.size());
+  CachableEntry<Block_kData> promoted;
+  Status s = PutDataBlockToCache(
+      cache_key, block_cache, &promoted, std::move(contents), BlockContents(),
+      kNoCompression, UncompressionDict::GetEmptyDict(), memory_allocator,
+      /*get_context=*/nullptr);
+  if (s.ok() && promoted.GetCacheHandle() != nullptr) {
+    RecordTick(rep_->ioptions.stats, BLOCK_CACHE_FAR_MEMORY_PROMOTE);
+  }
+  s.PermitUncheckedError();
+}
+
 std::unique_ptr<FilterBlockReader> BlockBasedTable::CreateFilterBlockReader(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer, bool use_cache,
     bool prefetch, bool pin, BlockCacheLookupContext* lookup_context) {
@@ -1548,6 +1664,10 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
   const bool no_io = (ro.read_tier == kBlockCacheTier);
   BlockCacheInterface<TBlocklike> block_cache{
       rep_->table_options.block_cache.get()};
+  MemoryAllocator* const memory_allocator =
+      TBlocklike::kBlockType == BlockType::kData
+          ? rep_->data_block_allocator
+          : GetMemoryAllocator(rep_->table_options);
   // First, try to get the block from the cache
   //
   // If either block cache is enabled, we'll try to read from it.
@@ -1555,6 +1675,10 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
   CacheKey key_data;
   Slice key;
   bool is_cache_hit = false;
+  const bool time_fetch =
+      !for_compaction && !contents && rep_->TimeBlockFetches(ro);
+  const uint64_t fetch_start_micros =
+      time_fetch ? rep_->ioptions.clock->NowMicros() : 0;
   if (block_cache) {
     // create key for block cache
     key_data = GetCacheKey(rep_->base_cache_key, handle);
@@ -1581,6 +1705,13 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
                 ro.adaptive_readahead /*decrease_readahead_size*/);
           }
         }
+        rep_->MaybeSampleBlockCacheLookup(for_compaction, is_cache_hit);
+        if constexpr (TBlocklike::kBlockType == BlockType::kData) {
+          if (is_cache_hit && rep_->far_memory_allocator != nullptr &&
+              !for_compaction) {
+            MaybePromoteFarMemoryBlock(key, block_cache, *out_parsed_block);
+          }
+        }
       }
     }
 
@@ -1618,8 +1749,7 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
             rep_->file.get(), prefetch_buffer, rep_->footer, ro, handle,
             &tmp_contents, rep_->ioptions, do_uncompress, maybe_compressed,
             TBlocklike::kBlockType, uncompression_dict,
-            rep_->persistent_cache_options,
-            GetMemoryAllocator(rep_->table_options),
+            rep_->persistent_cache_options, memory_allocator,
             /*allocator=*/nullptr);
 
         // If prefetch_buffer is not allocated, it will fallback to synchronous
@@ -1666,7 +1796,7 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
           s = PutDataBlockToCache(
               key, block_cache, out_parsed_block, std::move(uncomp_contents),
               std::move(comp_contents), contents_comp_type, uncompression_dict,
-              GetMemoryAllocator(rep_->table_options), get_context);
+              memory_allocator, get_context);
         }
       } else {
         contents_comp_type = GetBlockCompressionType(*contents);
@@ -1682,12 +1812,29 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
           s = PutDataBlockToCache(
               key, block_cache, out_parsed_block, std::move(uncomp_contents),
               std::move(comp_contents), contents_comp_type, uncompression_dict,
-              GetMemoryAllocator(rep_->table_options), get_context);
+              memory_allocator, get_context);
         }
       }
     }
   }
 
+  if ((TBlocklike::kBlockType == BlockType::kIndex ||
+       TBlocklike::kBlockType == BlockType::kFilter ||
+       TBlocklike::kBlockType == BlockType::kFilterPartitionIndex) &&
+      rep_->metadata_block_pinner && !for_compaction &&
+      out_parsed_block->GetCacheHandle() != nullptr) {
+    assert(out_parsed_block->GetCache() ==
+           rep_->metadata_block_pinner->block_cache());
+    rep_->metadata_block_pinner->MaybeRecordAccess(
+        this, handle.offset(), out_parsed_block->GetCacheHandle());
+  }
+
+  if (time_fetch && (out_parsed_block->GetValue() ||
+                     out_parsed_block->GetCacheHandle())) {
+    rep_->block_fetch_hists->ForActivity(ro.io_activity, is_cache_hit)
+        ->Add(rep_->ioptions.clock->NowMicros() - fetch_start_micros);
+  }
+
   // TODO: optimize so that lookup_context != nullptr implies the others
   if (block_cache_tracer_ && block_cache_tracer_->is_tracing_enabled() &&
       lookup_context) {
@@ -1838,11 +1985,19 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::RetrieveBlock(
     Histograms histogram =
         for_compaction ? READ_BLOCK_COMPACTION_MICROS : READ_BLOCK_GET_MICROS;
     StopWatch sw(rep_->ioptions.clock, rep_->ioptions.stats, histogram);
+    const bool time_fetch = !for_compaction && rep_->TimeBlockFetches(ro);
+    const uint64_t fetch_start_micros =
+        time_fetch ? rep_->ioptions.clock->NowMicros() : 0;
     s = ReadAndParseBlockFromFile(
         rep_->file.get(), prefetch_buffer, rep_->footer, ro, handle, &block,
         rep_->ioptions, rep_->create_context, maybe_compressed,
         uncompression_dict, rep_->persistent_cache_options,
         GetMemoryAllocator(rep_->table_options), for_compaction, async_read);
+    if (time_fetch && s.ok()) {
+      rep_->block_fetch_hists
+          ->ForActivity(ro.io_activity, /*is_cache_hit=*/false)
+          ->Add(rep_->ioptions.clock->NowMicros() - fetch_start_micros);
+    }
 
     if (get_context) {
       switch (TBlocklike::kBlockType) {
@@ -1957,6 +2112,20 @@ bool BlockBasedTable::PrefixRangeMayMatch(
   return may_match;
 }
 
+bool BlockBasedTable::RangeMayMatch(
+    const Slice& internal_key, const ReadOptions& read_options,
+    BlockCacheLookupContext* lookup_context) const {
+  FilterBlockReader* const filter = rep_->filter.get();
+  if (!rep_->range_filtering || filter == nullptr ||
+      read_options.iterate_upper_bound == nullptr) {
+    return true;
+  }
+  const bool no_io = read_options.read_tier == kBlockCacheTier;
+  return filter->RangeMayMatch(ExtractUserKey(internal_key),
+                               *read_options.iterate_upper_bound, no_io,
+                               lookup_context, read_options);
+}
+
 bool BlockBasedTable::PrefixExtractorChanged(
     const SliceTransform* prefix_extractor) const {
   if (prefix_extractor == nullptr) {
@@ -1980,6 +2149,11 @@ InternalIterator* BlockBasedTable::NewIterator(
     const ReadOptions& read_options, const SliceTransform* prefix_extractor,
     Arena* arena, bool skip_filters, TableReaderCaller caller,
     size_t compaction_readahead_size, bool allow_unprepared_value) {
+  // None of the versions in the table is visible to the iterator. Its range
+  // tombstones, which have their own iterator, are not visible either.
+  if (!IteratorTimestampMayMatch(read_options)) {
+    return NewEmptyInternalIterator<Slice>(arena);
+  }
   BlockCacheLookupContext lookup_context{caller};
   bool need_upper_bound_check =
       read_options.auto_prefix_mode || PrefixExtractorChanged(prefix_extractor);
@@ -1993,16 +2167,18 @@ InternalIterator* BlockBasedTable::NewIterator(
         this, read_options, rep_->internal_comparator, std::move(index_iter),
         !skip_filters && !read_options.total_order_seek &&
             prefix_extractor != nullptr,
-        need_upper_bound_check, prefix_extractor, caller,
-        compaction_readahead_size, allow_unprepared_value);
+        !skip_filters && rep_->range_filtering, need_upper_bound_check,
+        prefix_extractor, caller, compaction_readahead_size,
+        allow_unprepared_value);
   } else {
     auto* mem = arena->AllocateAligned(sizeof(BlockBasedTableIterator));
     return new (mem) BlockBasedTableIterator(
         this, read_options, rep_->internal_comparator, std::move(index_iter),
         !skip_filters && !read_options.total_order_seek &&
             prefix_extractor != nullptr,
-        need_upper_bound_check, prefix_extractor, caller,
-        compaction_readahead_size, allow_unprepared_value);
+        !skip_filters && rep_->range_filtering, need_upper_bound_check,
+        prefix_extractor, caller, compaction_readahead_size,
+        allow_unprepared_value);
   }
 }
 
@@ -2194,6 +2370,23 @@ bool BlockBasedTable::TimestampMayMatch(const ReadOptions& read_options) const {
   return true;
 }
 
+bool BlockBasedTable::IteratorTimestampMayMatch(
+    const ReadOptions& read_options) const {
+  if (!TimestampMayMatch(read_options)) {
+    return false;
+  }
+  if (read_options.iter_start_ts != nullptr &&
+      !rep_->max_timestamp.empty()) {
+    auto comparator = rep_->internal_comparator.user_comparator();
+    if (comparator->CompareTimestamp(rep_->max_timestamp,
+                                     *read_options.iter_start_ts) < 0) {
+      RecordTick(rep_->ioptions.stats, TIMESTAMP_FILTER_TABLE_FILTERED);
+      return false;
+    }
+  }
+  return true;
+}
+
 Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
                             GetContext* get_context,
                             const SliceTransform* prefix_extractor,
@@ -2392,6 +2585,195 @@ Status BlockBasedTable::MultiGetFilter(const ReadOptions& read_options,
   return Status::OK();
 }
 
+void BlockBasedTable::PrefetchForMultiGet(const ReadOptions& read_options,
+                                          const MultiGetRange* mget_range) {
+  if (mget_range->empty() || rep_->file->use_direct_io()) {
+    // Direct I/O bypasses the page cache the hints would fill
+    return;
+  }
+
+  ReadOptions no_io_read_options(read_options);
+  no_io_read_options.read_tier = kBlockCacheTier;
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kUserMultiGet};
+
+  MultiGetRange range(*mget_range, mget_range->begin(), mget_range->end());
+  FilterBlockReader* const filter = rep_->filter.get();
+  if (filter && rep_->whole_key_filtering) {
+    filter->KeysMayMatch(&range, /*no_io=*/true, &lookup_context,
+                         no_io_read_options);
+    if (range.empty()) {
+      return;
+    }
+  }
+
+  IndexBlockIter iiter_on_stack;
+  auto iiter =
+      NewIndexIterator(no_io_read_options, /*need_upper_bound_check=*/false,
+                       &iiter_on_stack, /*get_context=*/nullptr,
+                       &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+  if (!iiter->status().ok()) {
+    // Index not in the cache
+    return;
+  }
+
+  IOOptions io_options;
+  if (!rep_->file->PrepareIOOptions(read_options, io_options).ok()) {
+    return;
+  }
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  uint64_t prev_offset = std::numeric_limits<uint64_t>::max();
+  for (auto miter = range.begin(); miter != range.end(); ++miter) {
+    iiter->Seek(miter->ikey);
+    if (!iiter->Valid()) {
+      // Past the last block, or an index partition not in the cache
+      continue;
+    }
+    const BlockHandle handle = iiter->value().handle;
+    if (handle.offset() == prev_offset) {
+      continue;
+    }
+    prev_offset = handle.offset();
+    if (block_cache) {
+      const CacheKey key = GetCacheKey(rep_->base_cache_key, handle);
+      Cache::Handle* const cache_handle = block_cache->Lookup(key.AsSlice());
+      if (cache_handle) {
+        block_cache->Release(cache_handle);
+        continue;
+      }
+    }
+    TEST_SYNC_POINT("BlockBasedTable::PrefetchForMultiGet:Prefetch");
+    // Only a hint, so errors are left to the reads that follow
+    rep_->file
+        ->Prefetch(io_options, handle.offset(), BlockSizeWithTrailer(handle))
+        .PermitUncheckedError();
+  }
+}
+
+void BlockBasedTable::PrefetchScanRanges(const ReadOptions& read_options,
+                                         const std::vector<Range>& ranges) {
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  const Comparator* const user_comparator =
+      rep_->internal_comparator.user_comparator();
+  if (ranges.empty() || block_cache == nullptr || !read_options.fill_cache ||
+      read_options.read_tier == kBlockCacheTier ||
+      rep_->ioptions.allow_mmap_reads || rep_->file->use_direct_io() ||
+      user_comparator->timestamp_size() > 0) {
+    return;
+  }
+
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kUserIterator};
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                                &iiter_on_stack, /*get_context=*/nullptr,
+                                &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+  if (!iiter->status().ok()) {
+    return;
+  }
+
+  // Data blocks not in the cache, in file order as the ranges are sorted
+  std::vector<BlockHandle> handles;
+  uint64_t last_offset = 0;
+  IterKey seek_key;
+  for (const Range& range : ranges) {
+    seek_key.SetInternalKey(range.start, kMaxSequenceNumber, kValueTypeForSeek);
+    size_t range_bytes = 0;
+    for (iiter->Seek(seek_key.GetInternalKey());
+         iiter->Valid() &&
+         range_bytes < rep_->table_options.max_auto_readahead_size;
+         iiter->Next()) {
+      const BlockHandle handle = iiter->value().handle;
+      range_bytes += BlockSizeWithTrailer(handle);
+      if (handles.empty() || handle.offset() > last_offset) {
+        last_offset = handle.offset();
+        const CacheKey key = GetCacheKey(rep_->base_cache_key, handle);
+        Cache::Handle* const cache_handle = block_cache->Lookup(key.AsSlice());
+        if (cache_handle) {
+          block_cache->Release(cache_handle);
+        } else {
+          handles.push_back(handle);
+        }
+      }
+      // The index key is at or after the last key of its block
+      const Slice index_user_key = rep_->index_key_includes_seq
+                                       ? ExtractUserKey(iiter->key())
+                                       : iiter->key();
+      if (user_comparator->Compare(index_user_key, range.limit) >= 0) {
+        break;
+      }
+    }
+  }
+  if (handles.empty()) {
+    return;
+  }
+
+  CachableEntry<UncompressionDict> uncompression_dict;
+  if (rep_->uncompression_dict_reader) {
+    Status s =
+        rep_->uncompression_dict_reader->GetOrReadUncompressionDictionary(
+            /*prefetch_buffer=*/nullptr, read_options, /*no_io=*/false,
+            read_options.verify_checksums, /*get_context=*/nullptr,
+            &lookup_context, &uncompression_dict);
+    if (!s.ok()) {
+      return;
+    }
+  }
+  const UncompressionDict& dict = uncompression_dict.GetValue()
+                                      ? *uncompression_dict.GetValue()
+                                      : UncompressionDict::GetEmptyDict();
+
+  std::vector<FSReadRequest> read_reqs(handles.size());
+  for (size_t i = 0; i < handles.size(); ++i) {
+    read_reqs[i].offset = handles[i].offset();
+    read_reqs[i].len = BlockSizeWithTrailer(handles[i]);
+    read_reqs[i].scratch = new char[read_reqs[i].len];
+  }
+  IOOptions opts;
+  IOStatus io_s = rep_->file->PrepareIOOptions(read_options, opts);
+  if (io_s.ok()) {
+    TEST_SYNC_POINT_CALLBACK("BlockBasedTable::PrefetchScanRanges:MultiRead",
+                             &read_reqs);
+    io_s = rep_->file->MultiRead(opts, read_reqs.data(), read_reqs.size(),
+                                 /*aligned_buf=*/nullptr);
+  }
+
+  for (size_t i = 0; i < handles.size(); ++i) {
+    FSReadRequest& req = read_reqs[i];
+    std::unique_ptr<char[]> buf(req.scratch);
+    if (!io_s.ok() || !req.status.ok() || req.result.size() != req.len) {
+      continue;
+    }
+    if (req.result.data() != buf.get()) {
+      memcpy(buf.get(), req.result.data(), req.len);
+    }
+    const BlockHandle& handle = handles[i];
+    if (read_options.verify_checksums &&
+        !VerifyBlockChecksum(rep_->footer, buf.get(), handle.size(),
+                             rep_->file->file_name(), handle.offset())
+             .ok()) {
+      continue;
+    }
+    BlockContents serialized_block(std::move(buf), handle.size());
+#ifndef NDEBUG
+    serialized_block.has_trailer = true;
+#endif
+    CachableEntry<Block_kData> block_entry;
+    MaybeReadBlockAndLoadToCache(
+        /*prefetch_buffer=*/nullptr, read_options, handle, dict,
+        /*for_compaction=*/false, &block_entry, /*get_context=*/nullptr,
+        &lookup_context, &serialized_block, /*async_read=*/false,
+        /*use_block_cache_for_lookup=*/false)
+        .PermitUncheckedError();
+  }
+}
+
 Status BlockBasedTable::Prefetch(const ReadOptions& read_options,
                                  const Slice* const begin,
                                  const Slice* const end) {
@@ -2454,6 +2836,97 @@ Status BlockBasedTable::Prefetch(const ReadOptions& read_options,
   return Status::OK();
 }
 
+Status BlockBasedTable::PrefetchDataBlocks(
+    const ReadOptions& read_options,
+    const std::vector<uint64_t>& block_offsets) {
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                                &iiter_on_stack, /*get_context=*/nullptr,
+                                &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+
+  if (!iiter->status().ok()) {
+    // error opening index iterator
+    return iiter->status();
+  }
+
+  // Data blocks are in file order in the index, so both are walked together.
+  // Offsets are compared without the two lower bits, like in cache keys.
+  auto next = block_offsets.begin();
+  for (iiter->SeekToFirst(); iiter->Valid() && next != block_offsets.end();
+       iiter->Next()) {
+    BlockHandle block_handle = iiter->value().handle;
+    const uint64_t offset = block_handle.offset() >> 2;
+    while (next != block_offsets.end() && (*next >> 2) < offset) {
+      ++next;
+    }
+    if (next == block_offsets.end() || (*next >> 2) != offset) {
+      continue;
+    }
+    ++next;
+
+    // Load the block specified by the block_handle into the block cache
+    DataBlockIter biter;
+    Status tmp_status;
+    NewDataBlockIterator<DataBlockIter>(
+        read_options, block_handle, &biter, /*type=*/BlockType::kData,
+        /*get_context=*/nullptr, &lookup_context,
+        /*prefetch_buffer=*/nullptr, /*for_compaction=*/false,
+        /*async_read=*/false, tmp_status, /*use_block_cache_for_lookup=*/true);
+
+    if (!biter.status().ok()) {
+      return biter.status();
+    }
+  }
+  return iiter->status();
+}
+
+Status BlockBasedTable::PrefetchFirstDataBlocks(
+    const ReadOptions& read_options, size_t prefetch_size) {
+  if (rep_->table_options.block_cache == nullptr) {
+    return Status::OK();
+  }
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                                &iiter_on_stack, /*get_context=*/nullptr,
+                                &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+
+  if (!iiter->status().ok()) {
+    // error opening index iterator
+    return iiter->status();
+  }
+
+  uint64_t prefetched = 0;
+  for (iiter->SeekToFirst(); iiter->Valid() && prefetched < prefetch_size;
+       iiter->Next()) {
+    BlockHandle block_handle = iiter->value().handle;
+    prefetched += BlockSizeWithTrailer(block_handle);
+
+    // Load the block specified by the block_handle into the block cache
+    DataBlockIter biter;
+    Status tmp_status;
+    NewDataBlockIterator<DataBlockIter>(
+        read_options, block_handle, &biter, /*type=*/BlockType::kData,
+        /*get_context=*/nullptr, &lookup_context,
+        /*prefetch_buffer=*/nullptr, /*for_compaction=*/false,
+        /*async_read=*/false, tmp_status, /*use_block_cache_for_lookup=*/true);
+
+    if (!biter.status().ok()) {
+      return biter.status();
+    }
+  }
+  return iiter->status();
+}
+
 Status BlockBasedTable::VerifyChecksum(const ReadOptions& read_options,
                                        TableReaderCaller caller) {
   Status s;
@@ -2560,6 +3033,14 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kLearnedIndexBlock) {
+    return BlockType::kIndex;
+  }
+
+  if (meta_block_name == kDataBlockPropertiesBlockName) {
+    return BlockType::kProperties;
+  }
+
   if (meta_block_name == kIndexBlockName) {
     return BlockType::kIndex;
   }
@@ -2709,6 +3190,11 @@ Status BlockBasedTable::CreateIndexReader(
                                        index_reader);
       }
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer, meta_iter,
+                                        use_cache, prefetch, pin,
+                                        lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + std::to_string(rep_->index_type);
@@ -2946,6 +3432,9 @@ Status BlockBasedTable::DumpTable(WritableFile* out_file) {
       } else if (metaindex_iter->key() == kRangeDelBlockName) {
         out_stream << "  Range deletion block handle: "
                    << metaindex_iter->value().ToString(true) << "\n";
+      } else if (metaindex_iter->key() == kDataBlockPropertiesBlockName) {
+        out_stream << "  Data block properties block handle: "
+                   << metaindex_iter->value().ToString(true) << "\n";
       }
     }
     out_stream << "\n";
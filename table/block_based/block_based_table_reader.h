@@ -24,8 +24,12 @@
 #include "table/block_based/block_cache.h"
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
+#include "table/block_based/data_block_properties.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/metadata_block_pinner.h"
 #include "table/block_based/uncompression_dict_reader.h"
+#include "table/block_cache_heat_map.h"
+#include "table/block_fetch_histograms.h"
 #include "table/format.h"
 #include "table/persistent_cache_options.h"
 #include "table/table_properties_internal.h"
@@ -34,6 +38,7 @@
 #include "trace_replay/block_cache_tracer.h"
 #include "util/coro_utils.h"
 #include "util/hash_containers.h"
+#include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -112,7 +117,11 @@ class BlockBasedTable : public TableReader {
       size_t max_file_size_for_l0_meta_pin = 0,
       const std::string& cur_db_session_id = "", uint64_t cur_file_num = 0,
       UniqueId64x2 expected_unique_id = {},
-      const bool user_defined_timestamps_persisted = true);
+      const bool user_defined_timestamps_persisted = true,
+      std::shared_ptr<ScanReadaheadStats> scan_readahead_stats = nullptr,
+      BlockFetchHistograms* block_fetch_hists = nullptr,
+      BlockCacheHeatMap* block_cache_heat_map = nullptr,
+      std::shared_ptr<MetadataBlockPinner> metadata_block_pinner = nullptr);
 
   bool PrefixRangeMayMatch(const Slice& internal_key,
                            const ReadOptions& read_options,
@@ -121,6 +130,11 @@ class BlockBasedTable : public TableReader {
                            BlockCacheLookupContext* lookup_context,
                            bool* filter_checked) const;
 
+  // Returns false if the range filter rules out any key in
+  // [internal_key, read_options.iterate_upper_bound).
+  bool RangeMayMatch(const Slice& internal_key, const ReadOptions& read_options,
+                     BlockCacheLookupContext* lookup_context) const;
+
   // Returns a new iterator over the table contents.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -156,12 +170,27 @@ class BlockBasedTable : public TableReader {
                                   const SliceTransform* prefix_extractor,
                                   bool skip_filters = false);
 
+  void PrefetchForMultiGet(const ReadOptions& read_options,
+                           const MultiGetRange* mget_range) override;
+
+  // Reads up to max_auto_readahead_size bytes of data blocks from the start
+  // of each range.
+  void PrefetchScanRanges(const ReadOptions& read_options,
+                          const std::vector<Range>& ranges) override;
+
   // Pre-fetch the disk blocks that correspond to the key range specified by
   // (kbegin, kend). The call will return error status in the event of
   // IO or iteration error.
   Status Prefetch(const ReadOptions& read_options, const Slice* begin,
                   const Slice* end) override;
 
+  Status PrefetchDataBlocks(
+      const ReadOptions& read_options,
+      const std::vector<uint64_t>& block_offsets) override;
+
+  Status PrefetchFirstDataBlocks(const ReadOptions& read_options,
+                                 size_t prefetch_size) override;
+
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
   // present in the file). The returned value is in terms of file
@@ -441,6 +470,14 @@ class BlockBasedTable : public TableReader {
       const UncompressionDict& uncompression_dict,
       MemoryAllocator* memory_allocator, GetContext* get_context) const;
 
+  // Copies `entry`, a data block found in the block cache, into the memory of
+  // the block cache's allocator in place of the cached block, with a
+  // probability of one in BlockBasedTableOptions::far_memory_promotion_hits,
+  // if it was allocated from BlockBasedTableOptions::far_memory_allocator
+  void MaybePromoteFarMemoryBlock(
+      const Slice& cache_key, BlockCacheInterface<Block_kData> block_cache,
+      const CachableEntry<Block_kData>& entry) const;
+
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
   // May not make such a call if filter policy says that key is not present.
@@ -492,6 +529,9 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  Status ReadDataBlockPropertiesBlock(const ReadOptions& ro,
+                                      FilePrefetchBuffer* prefetch_buffer,
+                                      InternalIterator* meta_iter);
   Status PrefetchIndexAndFilterBlocks(
       const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
       InternalIterator* meta_iter, BlockBasedTable* new_table,
@@ -532,6 +572,11 @@ class BlockBasedTable : public TableReader {
 
   bool TimestampMayMatch(const ReadOptions& read_options) const;
 
+  // Like TimestampMayMatch(), but also false if the table is older than
+  // ReadOptions::iter_start_ts, so that an iterator would see none of its
+  // versions.
+  bool IteratorTimestampMayMatch(const ReadOptions& read_options) const;
+
   // A cumulative data block file read in MultiGet lower than this size will
   // use a stack buffer
   static constexpr size_t kMultiGetReadStackBufSize = 8192;
@@ -611,9 +656,14 @@ struct BlockBasedTable::Rep {
   BlockBasedTableOptions::IndexType index_type;
   bool whole_key_filtering;
   bool prefix_filtering;
+  // Whether the filter is a range filter usable for range checks
+  bool range_filtering = false;
   std::shared_ptr<const SliceTransform> table_prefix_extractor;
 
   std::shared_ptr<FragmentedRangeTombstoneList> fragmented_range_dels;
+  // For ReadOptions::block_property_filter, null if no data block has any
+  // property
+  std::unique_ptr<DataBlockProperties> data_block_properties;
 
   // FIXME
   // If true, data blocks in this file are definitely ZSTD compressed. If false
@@ -671,6 +721,46 @@ struct BlockBasedTable::Rep {
   std::unique_ptr<CacheReservationManager::CacheReservationHandle>
       table_reader_cache_res_handle = nullptr;
 
+  // For BlockBasedTableOptions::learn_auto_readahead_size, null if not set
+  std::shared_ptr<ScanReadaheadStats> scan_readahead_stats;
+
+  // Latency histograms of the block fetches of the level, if any
+  BlockFetchHistograms* block_fetch_hists = nullptr;
+
+  // Whether the block fetches of a read with `ro` are timed into
+  // block_fetch_hists. Only when statistics time operations, as that takes
+  // a clock read per block even on cache hits.
+  bool TimeBlockFetches(const ReadOptions& ro) const {
+    return block_fetch_hists != nullptr && ioptions.stats != nullptr &&
+           ioptions.stats->get_stats_level() > kExceptTimers &&
+           block_fetch_hists->ForActivity(ro.io_activity,
+                                          /*is_cache_hit=*/false) != nullptr;
+  }
+
+  // The heat map of the level, if any, and the number of the file in it
+  BlockCacheHeatMap* block_cache_heat_map = nullptr;
+  uint64_t file_number = 0;
+
+  // The allocator of the data blocks loaded into the block cache: the one of
+  // the block cache, or BlockBasedTableOptions::far_memory_allocator for the
+  // tables at the last level, then far_memory_allocator is set too
+  MemoryAllocator* data_block_allocator = nullptr;
+  MemoryAllocator* far_memory_allocator = nullptr;
+
+  // For MetadataCacheOptions::dynamic_pinning_budget, null if not set
+  std::shared_ptr<MetadataBlockPinner> metadata_block_pinner;
+
+  // Counts about one in ImmutableOptions::block_cache_heat_sample_one_in
+  // block cache lookups of user reads in block_cache_heat_map
+  void MaybeSampleBlockCacheLookup(bool for_compaction,
+                                   bool is_cache_hit) const {
+    const uint32_t one_in = ioptions.block_cache_heat_sample_one_in;
+    if (block_cache_heat_map != nullptr && one_in > 0 && !for_compaction &&
+        Random::GetTLSInstance()->OneIn(static_cast<int>(one_in))) {
+      block_cache_heat_map->Record(file_number, is_cache_hit);
+    }
+  }
+
   SequenceNumber get_global_seqno(BlockType block_type) const {
     return (block_type == BlockType::kFilterPartitionIndex ||
             block_type == BlockType::kCompressionDictionary)
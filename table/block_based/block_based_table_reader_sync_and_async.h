@@ -161,6 +161,50 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
     }
   }
 
+  // The checksums of the blocks read in full are verified together up
+  // front, so that they can be computed in parallel, see
+  // VerifyBlockChecksums(). Indexed by the valid block index in the batch.
+  std::array<Status, MultiGetContext::MAX_BATCH_SIZE> checksum_statuses;
+  if (options.verify_checksums) {
+    std::array<const char*, MultiGetContext::MAX_BATCH_SIZE> block_data;
+    std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> block_sizes;
+    std::array<uint64_t, MultiGetContext::MAX_BATCH_SIZE> block_offsets;
+    std::array<size_t, MultiGetContext::MAX_BATCH_SIZE> valid_batch_idxs;
+    size_t num_blocks = 0;
+    size_t valid_batch_idx = 0;
+    for (const BlockHandle& handle : *handles) {
+      if (handle.IsNull()) {
+        continue;
+      }
+      const FSReadRequest& req = read_reqs[req_idx_for_block[valid_batch_idx]];
+      const size_t req_offset = req_offset_for_block[valid_batch_idx];
+      if (req.status.ok() && req.result.size() == req.len &&
+          req_offset + BlockSizeWithTrailer(handle) <= req.result.size()) {
+        // Since the scratch might be shared, the offset of the data block in
+        // the buffer might not be 0. req.result.data() only point to the
+        // begin address of each read request, we need to add the offset
+        // in each read request. Checksum is stored in the block trailer,
+        // beyond the payload size.
+        block_data[num_blocks] = req.result.data() + req_offset;
+        block_sizes[num_blocks] = handle.size();
+        block_offsets[num_blocks] = handle.offset();
+        valid_batch_idxs[num_blocks] = valid_batch_idx;
+        num_blocks++;
+      }
+      valid_batch_idx++;
+    }
+    std::array<Status, MultiGetContext::MAX_BATCH_SIZE> block_statuses;
+    VerifyBlockChecksums(footer, num_blocks, block_data.data(),
+                         block_sizes.data(), block_offsets.data(),
+                         rep_->file->file_name(), block_statuses.data());
+    for (size_t i = 0; i < num_blocks; ++i) {
+      checksum_statuses[valid_batch_idxs[i]] = std::move(block_statuses[i]);
+    }
+    for (size_t i = num_blocks; i < block_statuses.size(); ++i) {
+      block_statuses[i].PermitUncheckedError();
+    }
+  }
+
   idx_in_batch = 0;
   size_t valid_batch_idx = 0;
   for (auto mget_iter = batch->begin(); mget_iter != batch->end();
@@ -176,6 +220,7 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
     assert(req_idx_for_block[valid_batch_idx] < read_reqs.size());
     size_t& req_idx = req_idx_for_block[valid_batch_idx];
     size_t& req_offset = req_offset_for_block[valid_batch_idx];
+    Status& checksum_status = checksum_statuses[valid_batch_idx];
     valid_batch_idx++;
     FSReadRequest& req = read_reqs[req_idx];
     Status s = req.status;
@@ -215,15 +260,7 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
 #endif
 
       if (options.verify_checksums) {
-        PERF_TIMER_GUARD(block_checksum_time);
-        const char* data = req.result.data();
-        // Since the scratch might be shared, the offset of the data block in
-        // the buffer might not be 0. req.result.data() only point to the
-        // begin address of each read request, we need to add the offset
-        // in each read request. Checksum is stored in the block trailer,
-        // beyond the payload size.
-        s = VerifyBlockChecksum(footer, data + req_offset, handle.size(),
-                                rep_->file->file_name(), handle.offset());
+        s = std::move(checksum_status);
         TEST_SYNC_POINT_CALLBACK("RetrieveMultipleBlocks:VerifyChecksum", &s);
       }
     } else if (!use_shared_buffer) {
@@ -250,8 +287,7 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
         Slice serialized =
             Slice(req.result.data() + req_offset, BlockSizeWithTrailer(handle));
         serialized_block = BlockContents(
-            CopyBufferToHeap(GetMemoryAllocator(rep_->table_options),
-                             serialized),
+            CopyBufferToHeap(rep_->data_block_allocator, serialized),
             handle.size());
 #ifndef NDEBUG
         serialized_block.has_trailer = true;
@@ -307,6 +343,10 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::RetrieveMultipleBlocks)
     }
     statuses[idx_in_batch] = s;
   }
+  for (const Status& checksum_status : checksum_statuses) {
+    // Those of blocks not read in full are not used
+    checksum_status.PermitUncheckedError();
+  }
 
   if (use_fs_scratch) {
     // Free the allocated scratch buffer by fs here as read requests might have
@@ -392,6 +432,7 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
       uncompression_dict_status.PermitUncheckedError();
       bool uncompression_dict_inited = false;
       size_t total_len = 0;
+      const bool time_fetches = rep_->TimeBlockFetches(read_options);
 
       // GetContext for any key will do, as the stats will be aggregated
       // anyway
@@ -472,26 +513,33 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
             // initialize block to the contents of the data block.
 
             // An async version of MaybeReadBlockAndLoadToCache /
-            // GetDataBlockFromCache
+            // GetDataBlockFromCache, started for all blocks at once below
             BCI::TypedAsyncLookupHandle& async_handle =
                 async_handles[cache_lookup_count];
             cache_keys[cache_lookup_count] =
                 GetCacheKey(rep_->base_cache_key, v.handle);
             async_handle.key = cache_keys[cache_lookup_count].AsSlice();
-            // NB: StartAsyncLookupFull populates async_handle.helper
+            // NB: StartAsyncLookupBatchFull populates async_handle.helper
             async_handle.create_context = &create_ctx;
             async_handle.priority = GetCachePriority<Block_kData>();
             async_handle.stats = rep_->ioptions.statistics.get();
-
-            block_cache.StartAsyncLookupFull(
-                async_handle, rep_->ioptions.lowest_used_cache_tier);
             ++cache_lookup_count;
             // TODO: stats?
           }
         }
 
+        uint64_t lookup_micros = 0;
         if (block_cache) {
+          const uint64_t lookup_start_micros =
+              time_fetches ? rep_->ioptions.clock->NowMicros() : 0;
+          block_cache.StartAsyncLookupBatchFull(
+              &async_handles[0], cache_lookup_count,
+              rep_->ioptions.lowest_used_cache_tier);
           block_cache.get()->WaitAll(&async_handles[0], cache_lookup_count);
+          if (time_fetches) {
+            lookup_micros =
+                rep_->ioptions.clock->NowMicros() - lookup_start_micros;
+          }
         }
         size_t lookup_idx = 0;
         for (size_t i = 0; i < block_handles.size(); ++i) {
@@ -512,11 +560,19 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
               block_handles[i] = BlockHandle::NullBlockHandle();
               UpdateCacheHitMetrics(BlockType::kData, get_context,
                                     block_cache.get()->GetUsage(h));
+              if (time_fetches) {
+                rep_->block_fetch_hists
+                    ->ForActivity(read_options.io_activity,
+                                  /*is_cache_hit=*/true)
+                    ->Add(lookup_micros);
+              }
             } else {
               // Cache miss
               total_len += BlockSizeWithTrailer(block_handles[i]);
               UpdateCacheMissMetrics(BlockType::kData, get_context);
             }
+            rep_->MaybeSampleBlockCacheLookup(/*for_compaction=*/false,
+                                              /*is_cache_hit=*/h != nullptr);
             if (!data_lookup_contexts.empty()) {
               // Populate cache key before it's discarded
               data_lookup_contexts[i].block_key =
@@ -563,9 +619,26 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
             block_buf.reset(scratch);
           }
         }
+        // Each block read together waits for all of them. With mmap reads,
+        // RetrieveBlock() times them one by one.
+        const bool time_reads =
+            time_fetches && !rep_->ioptions.allow_mmap_reads;
+        const uint64_t read_start_micros =
+            time_reads ? rep_->ioptions.clock->NowMicros() : 0;
         CO_AWAIT(RetrieveMultipleBlocks)
         (read_options, &data_block_range, &block_handles, &statuses[0],
          &results[0], scratch, dict, use_fs_scratch);
+        if (time_reads) {
+          const uint64_t read_micros =
+              rep_->ioptions.clock->NowMicros() - read_start_micros;
+          HistogramImpl* hist = rep_->block_fetch_hists->ForActivity(
+              read_options.io_activity, /*is_cache_hit=*/false);
+          for (size_t i = 0; i < block_handles.size(); ++i) {
+            if (!block_handles[i].IsNull() && statuses[i].ok()) {
+              hist->Add(read_micros);
+            }
+          }
+        }
         if (get_context) {
           ++(get_context->get_context_stats_.num_sst_read);
         }
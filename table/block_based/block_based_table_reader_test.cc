@@ -813,6 +813,50 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Values(false), ::testing::ValuesIn(test::GetUDTTestModes()),
         ::testing::Values(1, 2), ::testing::Values(0, 4096),
         ::testing::Values(false)));
+TEST(MetadataBlockPinnerTest, PinsHottestBlocksWithinBudget) {
+  std::shared_ptr<Cache> cache = NewLRUCache(1 << 20);
+  static const Cache::CacheItemHelper kHelper{CacheEntryRole::kMisc};
+  static char kValue = 'v';
+  for (const char* key : {"a", "b", "c"}) {
+    ASSERT_OK(cache->Insert(key, &kValue, &kHelper, /*charge=*/100));
+  }
+  const int table = 0;
+  MetadataBlockPinner pinner(cache, /*budget=*/200, /*sample_one_in=*/1,
+                             /*rebalance_period=*/10);
+  auto access = [&](const char* key, uint64_t offset) {
+    Cache::Handle* handle = cache->Lookup(key);
+    ASSERT_NE(handle, nullptr);
+    pinner.RecordAccess(&table, offset, handle);
+    cache->Release(handle);
+  };
+
+  // Until the first rebalance, the first blocks accessed are pinned as long
+  // as they fit
+  access("a", 0);
+  access("b", 1);
+  access("c", 2);
+  EXPECT_EQ(pinner.GetPinnedUsage(), 200);
+  EXPECT_EQ(cache->GetPinnedUsage(), 200);
+
+  // The rebalance at the tenth access unpins the blocks that got cold, and
+  // the hot one is pinned on its next access
+  for (int i = 0; i < 7; i++) {
+    access("c", 2);
+  }
+  EXPECT_EQ(pinner.GetPinnedUsage(), 0);
+  access("c", 2);
+  EXPECT_EQ(pinner.GetPinnedUsage(), 100);
+  EXPECT_EQ(cache->GetPinnedUsage(), 100);
+
+  // A cold block is not pinned, even if it fits
+  access("a", 0);
+  EXPECT_EQ(pinner.GetPinnedUsage(), 100);
+
+  pinner.EraseTable(&table);
+  EXPECT_EQ(pinner.GetPinnedUsage(), 0);
+  EXPECT_EQ(cache->GetPinnedUsage(), 0);
+}
+
 INSTANTIATE_TEST_CASE_P(
     BlockBasedTableReaderGetTest, BlockBasedTableReaderGetTest,
     ::testing::Combine(
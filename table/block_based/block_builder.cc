@@ -28,8 +28,13 @@
 //
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
+//     restart_prefixes: uint64[num_restarts] (optional)
+//     hash_index (optional)
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// restart_prefixes[i] holds the first bytes of the ith restart key, see
+// RestartKeyPrefix(). Their presence and the index type are packed into the
+// high bits of num_restarts.
 
 #include "table/block_based/block_builder.h"
 
@@ -48,12 +53,14 @@ BlockBuilder::BlockBuilder(
     bool use_value_delta_encoding,
     BlockBasedTableOptions::DataBlockIndexType index_type,
     double data_block_hash_table_util_ratio, size_t ts_sz,
-    bool persist_user_defined_timestamps, bool is_user_key)
+    bool persist_user_defined_timestamps, bool is_user_key,
+    bool restart_key_prefixes, bool hash_index_entry_offsets)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       use_value_delta_encoding_(use_value_delta_encoding),
       strip_ts_sz_(persist_user_defined_timestamps ? 0 : ts_sz),
       is_user_key_(is_user_key),
+      restart_key_prefixes_(restart_key_prefixes),
       restarts_(1, 0),  // First restart point is at offset 0
       counter_(0),
       finished_(false) {
@@ -62,12 +69,13 @@ BlockBuilder::BlockBuilder(
       break;
     case BlockBasedTableOptions::kDataBlockBinaryAndHash:
       data_block_hash_index_builder_.Initialize(
-          data_block_hash_table_util_ratio);
+          data_block_hash_table_util_ratio, hash_index_entry_offsets);
       break;
     default:
       assert(0);
   }
   assert(block_restart_interval_ >= 1);
+  assert(!restart_key_prefixes_ || ts_sz == 0);
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
 }
 
@@ -75,10 +83,12 @@ void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.resize(1);  // First restart point is at offset 0
   assert(restarts_[0] == 0);
+  restart_prefixes_.clear();
   estimate_ = sizeof(uint32_t) + sizeof(uint32_t);
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  restart_key_.clear();
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
@@ -110,6 +120,9 @@ size_t BlockBuilder::EstimateSizeAfterKV(const Slice& key,
 
   if (counter_ >= block_restart_interval_) {
     estimate += sizeof(uint32_t);  // a new restart entry.
+    if (restart_key_prefixes_) {
+      estimate += kRestartKeyPrefixSize;
+    }
   }
 
   estimate += sizeof(int32_t);  // varint for shared prefix length.
@@ -130,6 +143,14 @@ Slice BlockBuilder::Finish() {
   }
 
   uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  // An empty block has a restart point but no restart key
+  const bool restart_key_prefixes =
+      restart_key_prefixes_ && restart_prefixes_.size() == num_restarts;
+  if (restart_key_prefixes) {
+    for (uint64_t prefix : restart_prefixes_) {
+      PutFixed64(&buffer_, prefix);
+    }
+  }
   BlockBasedTableOptions::DataBlockIndexType index_type =
       BlockBasedTableOptions::kDataBlockBinarySearch;
   if (data_block_hash_index_builder_.Valid() &&
@@ -139,7 +160,9 @@ Slice BlockBuilder::Finish() {
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
-  uint32_t block_footer = PackIndexTypeAndNumRestarts(index_type, num_restarts);
+  uint32_t block_footer = PackIndexTypeAndNumRestarts(
+      index_type, num_restarts, restart_key_prefixes,
+      data_block_hash_index_builder_.EntryOffsets());
 
   PutFixed32(&buffer_, block_footer);
   finished_ = true;
@@ -152,7 +175,7 @@ void BlockBuilder::Add(const Slice& key, const Slice& value,
   assert(!add_with_last_key_called_);
 
   AddWithLastKeyImpl(key, value, last_key_, delta_value, buffer_.size());
-  if (use_delta_encoding_) {
+  if (use_delta_encoding_ || data_block_hash_index_builder_.EntryOffsets()) {
     // Update state
     // We used to just copy the changed data, but it appears to be
     // faster to just copy the whole thing.
@@ -202,14 +225,26 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
           ? last_key
           : MaybeStripTimestampFromKey(&last_key_buf, last_key);
   size_t shared = 0;  // number of bytes shared with prev key
-  if (counter_ >= block_restart_interval_) {
+  const bool restart = counter_ >= block_restart_interval_;
+  if (restart) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_size));
     estimate_ += sizeof(uint32_t);
     counter_ = 0;
   } else if (use_delta_encoding_) {
     // See how much sharing to do with previous string
-    shared = key_to_persist.difference_offset(last_key_persisted);
+    shared = key_to_persist.difference_offset(
+        data_block_hash_index_builder_.EntryOffsets() ? Slice(restart_key_)
+                                                      : last_key_persisted);
+  }
+  if (data_block_hash_index_builder_.EntryOffsets() &&
+      (restart || buffer_size == 0)) {
+    restart_key_.assign(key_to_persist.data(), key_to_persist.size());
+  }
+  if (restart_key_prefixes_ && (restart || buffer_size == 0)) {
+    restart_prefixes_.push_back(
+        RestartKeyPrefix(is_user_key_ ? key : ExtractUserKey(key)));
+    estimate_ += kRestartKeyPrefixSize;
   }
 
   const size_t non_shared = key_to_persist.size() - shared;
@@ -242,8 +277,14 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     // And data blocks should always be built with internal keys instead of
     // user keys.
     assert(!is_user_key_);
-    data_block_hash_index_builder_.Add(ExtractUserKey(key),
-                                       restarts_.size() - 1);
+    if (!data_block_hash_index_builder_.EntryOffsets()) {
+      data_block_hash_index_builder_.Add(ExtractUserKey(key),
+                                         restarts_.size() - 1);
+    } else if (last_key.empty() ||
+               ExtractUserKey(key) != ExtractUserKey(last_key)) {
+      // Point at the first (newest) entry of each user key
+      data_block_hash_index_builder_.Add(ExtractUserKey(key), buffer_size);
+    }
   }
 
   counter_++;
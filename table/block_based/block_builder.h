@@ -31,7 +31,9 @@ class BlockBuilder {
                         double data_block_hash_table_util_ratio = 0.75,
                         size_t ts_sz = 0,
                         bool persist_user_defined_timestamps = true,
-                        bool is_user_key = false);
+                        bool is_user_key = false,
+                        bool restart_key_prefixes = false,
+                        bool hash_index_entry_offsets = false);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -112,13 +114,21 @@ class BlockBuilder {
   // index block for partitioned index blocks. In summary, this only applies to
   // block whose key are real user keys or internal keys created from user keys.
   const bool is_user_key_;
+  // Whether to store the prefixes of the restart keys, see
+  // BlockBasedTableOptions::data_block_restart_key_prefixes. Requires keys
+  // without timestamps that are ordered bytewise.
+  const bool restart_key_prefixes_;
 
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
+  std::vector<uint64_t> restart_prefixes_;  // See RestartKeyPrefix()
   size_t estimate_;
   int counter_;    // Number of entries emitted since restart
   bool finished_;  // Has Finish() been called?
   std::string last_key_;
+  // With hash index entry offsets, keys are delta encoded against the
+  // persisted key at their restart point, see DataBlockHashIndex
+  std::string restart_key_;
   DataBlockHashIndexBuilder data_block_hash_index_builder_;
 #ifndef NDEBUG
   bool add_with_last_key_called_ = false;
@@ -20,7 +20,10 @@ void BlockPrefetcher::PrefetchIfNeeded(
   const size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
   const size_t offset = handle.offset();
   if (is_for_compaction) {
-    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0) {
+    // With async_io, the internal prefetch buffer reads ahead into one half
+    // of its buffers while the other half is consumed
+    if (!rep->file->use_direct_io() && !read_options.async_io &&
+        compaction_readahead_size_ > 0) {
       // If FS supports prefetching (readahead_limit_ will be non zero in that
       // case) and current block exists in prefetch buffer then return.
       if (offset + len <= readahead_limit_) {
@@ -87,6 +90,21 @@ void BlockPrefetcher::PrefetchIfNeeded(
     return;
   }
 
+  if (scan_readahead_stats_ != nullptr &&
+      (prev_len_ == 0 || !IsBlockSequential(offset))) {
+    RecordScanSize();
+    scan_start_ = offset;
+    size_t scan_size = scan_readahead_stats_->GetSuggestedScanSize();
+    if (scan_size > len && offset + len > readahead_limit_) {
+      UpdateReadPattern(offset, len);
+      ResetValues(rep->table_options.initial_auto_readahead_size);
+      PrefetchForLearnedScan(
+          rep, handle, std::min(scan_size - len, max_auto_readahead_size),
+          read_options, readaheadsize_cb);
+      return;
+    }
+  }
+
   // If FS supports prefetching (readahead_limit_ will be non zero in that case)
   // and current block exists in prefetch buffer then return.
   if (offset + len <= readahead_limit_) {
@@ -145,4 +163,43 @@ void BlockPrefetcher::PrefetchIfNeeded(
   // max_auto_readahead_size.
   readahead_size_ = std::min(max_auto_readahead_size, readahead_size_ * 2);
 }
+
+void BlockPrefetcher::PrefetchForLearnedScan(
+    const BlockBasedTable::Rep* rep, const BlockHandle& handle,
+    size_t readahead_size, const ReadOptions& read_options,
+    const std::function<void(bool, uint64_t&, uint64_t&)>& readaheadsize_cb) {
+  const size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
+  const size_t offset = handle.offset();
+  const size_t max_auto_readahead_size =
+      rep->table_options.max_auto_readahead_size;
+  // Should the scan be longer than expected, keep reading ahead without
+  // waiting for more sequential reads
+  num_file_reads_ = rep->table_options.num_file_reads_for_auto_readahead + 1;
+  TEST_SYNC_POINT_CALLBACK("BlockPrefetcher::PrefetchForLearnedScan",
+                           &readahead_size);
+
+  if (!rep->file->use_direct_io()) {
+    IOOptions opts;
+    Status s = rep->file->PrepareIOOptions(read_options, opts);
+    if (!s.ok()) {
+      return;
+    }
+    s = rep->file->Prefetch(opts, offset, len + readahead_size);
+    if (s.ok()) {
+      readahead_limit_ = offset + len + readahead_size;
+      readahead_size_ = std::min(max_auto_readahead_size,
+                                 std::max(readahead_size_, readahead_size * 2));
+      return;
+    } else if (!s.IsNotSupported()) {
+      return;
+    }
+  }
+  // If FS prefetch is not supported, fall back to use internal prefetch
+  // buffer, which then reads ahead from this block on.
+  rep->CreateFilePrefetchBufferIfNotExists(
+      readahead_size, max_auto_readahead_size, &prefetch_buffer_,
+      /*implicit_auto_readahead=*/true, num_file_reads_,
+      rep->table_options.num_file_reads_for_auto_readahead, readaheadsize_cb,
+      /*usage=*/FilePrefetchBufferUsage::kUserScanPrefetch);
+}
 }  // namespace ROCKSDB_NAMESPACE
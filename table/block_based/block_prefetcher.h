@@ -12,11 +12,18 @@
 namespace ROCKSDB_NAMESPACE {
 class BlockPrefetcher {
  public:
+  // If `scan_readahead_stats` is non-null, the lengths of the sequential
+  // scans are recorded to it, and it sizes the implicit readahead of new
+  // scans, see BlockBasedTableOptions::learn_auto_readahead_size.
   explicit BlockPrefetcher(size_t compaction_readahead_size,
-                           size_t initial_auto_readahead_size)
+                           size_t initial_auto_readahead_size,
+                           ScanReadaheadStats* scan_readahead_stats = nullptr)
       : compaction_readahead_size_(compaction_readahead_size),
         readahead_size_(initial_auto_readahead_size),
-        initial_auto_readahead_size_(initial_auto_readahead_size) {}
+        initial_auto_readahead_size_(initial_auto_readahead_size),
+        scan_readahead_stats_(scan_readahead_stats) {}
+
+  ~BlockPrefetcher() { RecordScanSize(); }
 
   void PrefetchIfNeeded(
       const BlockBasedTable::Rep* rep, const BlockHandle& handle,
@@ -54,6 +61,22 @@ class BlockPrefetcher {
   }
 
  private:
+  // Records the length of the scan ending at the last block read, if any
+  void RecordScanSize() {
+    if (scan_readahead_stats_ != nullptr && prev_len_ > 0 &&
+        prev_offset_ + prev_len_ > scan_start_) {
+      scan_readahead_stats_->RecordScanSize(
+          static_cast<size_t>(prev_offset_ + prev_len_ - scan_start_));
+    }
+  }
+
+  // Reads ahead `readahead_size` bytes after the first block of a scan,
+  // expected to be that long from the previous ones.
+  void PrefetchForLearnedScan(
+      const BlockBasedTable::Rep* rep, const BlockHandle& handle,
+      size_t readahead_size, const ReadOptions& read_options,
+      const std::function<void(bool, uint64_t&, uint64_t&)>& readaheadsize_cb);
+
   // Readahead size used in compaction, its value is used only if
   // lookup_context_.caller = kCompaction.
   size_t compaction_readahead_size_;
@@ -68,6 +91,9 @@ class BlockPrefetcher {
   uint64_t num_file_reads_ = 0;
   uint64_t prev_offset_ = 0;
   size_t prev_len_ = 0;
+  ScanReadaheadStats* const scan_readahead_stats_;
+  // Offset of the first block of the current scan, if scan_readahead_stats_
+  uint64_t scan_start_ = 0;
   std::unique_ptr<FilePrefetchBuffer> prefetch_buffer_;
 };
 }  // namespace ROCKSDB_NAMESPACE
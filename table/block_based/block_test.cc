@@ -301,6 +301,194 @@ INSTANTIATE_TEST_CASE_P(
             BlockBasedTableOptions::DataBlockIndexType::
                 kDataBlockBinaryAndHash)));
 
+// Test Param 1): data block index type.
+// Test Param 2): restart interval.
+class RestartKeyPrefixesTest
+    : public testing::Test,
+      public testing::WithParamInterface<
+          std::tuple<BlockBasedTableOptions::DataBlockIndexType, int>> {
+ public:
+  BlockBasedTableOptions::DataBlockIndexType dataBlockIndexType() const {
+    return std::get<0>(GetParam());
+  }
+  int restartInterval() const { return std::get<1>(GetParam()); }
+
+  BlockContents BuildBlock(const std::vector<std::string> &keys,
+                           const std::vector<std::string> &values,
+                           bool restart_key_prefixes) {
+    auto &builder = restart_key_prefixes ? builder_with_prefixes_ : builder_;
+    builder.reset(new BlockBuilder(
+        restartInterval(), true /* use_delta_encoding */,
+        false /* use_value_delta_encoding */, dataBlockIndexType(),
+        0.75 /* data_block_hash_table_util_ratio */, 0 /* ts_sz */,
+        true /* persist_user_defined_timestamps */, false /* is_user_key */,
+        restart_key_prefixes));
+    for (size_t i = 0; i < keys.size(); ++i) {
+      builder->Add(keys[i], values[i]);
+    }
+    return BlockContents(builder->Finish());
+  }
+
+ private:
+  std::unique_ptr<BlockBuilder> builder_;
+  std::unique_ptr<BlockBuilder> builder_with_prefixes_;
+};
+
+// Keys share their first 8 bytes in groups, so that restart key prefixes tie
+// and Seek() has to fall back to comparing full keys.
+TEST_P(RestartKeyPrefixesTest, SameResultsAsWithoutPrefixes) {
+  const int kMaxKey = 20000;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&keys, &values, 0 /* first key id */, kMaxKey, 2 /* step */,
+                    0 /* padding_size */, 3 /* keys_share_prefix */);
+
+  BlockContents plain_contents = BuildBlock(keys, values, false);
+  BlockContents prefix_contents = BuildBlock(keys, values, true);
+  ASSERT_GT(prefix_contents.data.size(), plain_contents.data.size());
+  Block plain_block(std::move(plain_contents));
+  Block prefix_block(std::move(prefix_contents));
+  ASSERT_EQ(plain_block.NumRestarts(), prefix_block.NumRestarts());
+  ASSERT_EQ(plain_block.IndexType(), prefix_block.IndexType());
+
+  std::unique_ptr<DataBlockIter> plain_iter(plain_block.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  std::unique_ptr<DataBlockIter> prefix_iter(prefix_block.NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+
+  // Existent keys, keys in between, and keys before and after all of them
+  std::vector<std::string> targets = keys;
+  for (int i = -1; i <= kMaxKey + 1; i++) {
+    targets.emplace_back(GenerateInternalKey(i, 0, 0, nullptr));
+    targets.emplace_back(GenerateInternalKey(i, 9, 0, nullptr));
+  }
+  targets.emplace_back();
+  AppendInternalKeyFooter(&targets.back(), 0 /* seqno */, kTypeValue);
+  targets.emplace_back("\xff\xff\xff\xff\xff\xff\xff\xff\xff");
+  AppendInternalKeyFooter(&targets.back(), 0 /* seqno */, kTypeValue);
+
+  for (const auto &target : targets) {
+    plain_iter->Seek(target);
+    prefix_iter->Seek(target);
+    ASSERT_OK(prefix_iter->status());
+    ASSERT_EQ(plain_iter->Valid(), prefix_iter->Valid());
+    if (plain_iter->Valid()) {
+      ASSERT_EQ(plain_iter->key(), prefix_iter->key());
+      ASSERT_EQ(plain_iter->value(), prefix_iter->value());
+    }
+
+    plain_iter->SeekForPrev(target);
+    prefix_iter->SeekForPrev(target);
+    ASSERT_OK(prefix_iter->status());
+    ASSERT_EQ(plain_iter->Valid(), prefix_iter->Valid());
+    if (plain_iter->Valid()) {
+      ASSERT_EQ(plain_iter->key(), prefix_iter->key());
+    }
+  }
+
+  // Iteration is unaffected
+  size_t count = 0;
+  for (prefix_iter->SeekToFirst(); prefix_iter->Valid(); prefix_iter->Next()) {
+    ASSERT_EQ(prefix_iter->key(), keys[count++]);
+  }
+  ASSERT_EQ(count, keys.size());
+}
+
+TEST_P(RestartKeyPrefixesTest, ShortKeys) {
+  // Keys shorter than a prefix, some of them only differing by trailing zeros
+  std::vector<std::string> user_keys = {"",
+                                        std::string(1, '\0'),
+                                        "a",
+                                        std::string("a\0", 2),
+                                        "a\x01",
+                                        "ab",
+                                        "abcdefg",
+                                        "abcdefgh",
+                                        std::string("abcdefgh\0", 9),
+                                        "abcdefghi",
+                                        "b"};
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (const auto &user_key : user_keys) {
+    keys.emplace_back(user_key);
+    AppendInternalKeyFooter(&keys.back(), 0 /* seqno */, kTypeValue);
+    values.emplace_back("v" + user_key);
+  }
+
+  Block block(BuildBlock(keys, values, true));
+  std::unique_ptr<DataBlockIter> iter(
+      block.NewDataIterator(BytewiseComparator(), kDisableGlobalSequenceNumber));
+  for (size_t i = 0; i < keys.size(); i++) {
+    iter->Seek(keys[i]);
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(iter->key(), keys[i]);
+    ASSERT_EQ(iter->value(), values[i]);
+
+    iter->SeekForPrev(keys[i]);
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(iter->key(), keys[i]);
+  }
+}
+
+TEST_P(RestartKeyPrefixesTest, EmptyBlock) {
+  Block block(BuildBlock({}, {}, true));
+  ASSERT_EQ(block.NumRestarts(), 1);
+  std::unique_ptr<DataBlockIter> iter(
+      block.NewDataIterator(BytewiseComparator(), kDisableGlobalSequenceNumber));
+  std::string target = "a";
+  AppendInternalKeyFooter(&target, 0 /* seqno */, kTypeValue);
+  iter->Seek(target);
+  ASSERT_OK(iter->status());
+  ASSERT_FALSE(iter->Valid());
+}
+
+// Compares Seek() over 16-byte keys with and without restart key prefixes.
+// Run with --gtest_also_run_disabled_tests to print the timings.
+TEST_P(RestartKeyPrefixesTest, DISABLED_SeekBenchmark) {
+  const int kNumKeys = 4096;
+  const int kNumSeeks = 1000000;
+  Random rnd(301);
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    keys.emplace_back(rnd.RandomBinaryString(16));
+    values.emplace_back(rnd.RandomString(16));
+  }
+  std::sort(keys.begin(), keys.end());
+  for (auto &key : keys) {
+    AppendInternalKeyFooter(&key, 0 /* seqno */, kTypeValue);
+  }
+
+  for (bool restart_key_prefixes : {false, true}) {
+    Block block(BuildBlock(keys, values, restart_key_prefixes));
+    std::unique_ptr<DataBlockIter> iter(block.NewDataIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber));
+    Random seek_rnd(302);
+    SystemClock *clock = SystemClock::Default().get();
+    const uint64_t start = clock->NowNanos();
+    for (int i = 0; i < kNumSeeks; i++) {
+      iter->Seek(keys[seek_rnd.Uniform(kNumKeys)]);
+      ASSERT_TRUE(iter->Valid());
+    }
+    const uint64_t elapsed = clock->NowNanos() - start;
+    fprintf(stderr,
+            "restart_key_prefixes=%d restart_interval=%d: %.1f ns/seek\n",
+            restart_key_prefixes, restartInterval(),
+            static_cast<double>(elapsed) / kNumSeeks);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    P, RestartKeyPrefixesTest,
+    ::testing::Combine(
+        ::testing::Values(
+            BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch,
+            BlockBasedTableOptions::DataBlockIndexType::
+                kDataBlockBinaryAndHash),
+        ::testing::Values(1, 16)));
+
 // A slow and accurate version of BlockReadAmpBitmap that simply store
 // all the marked ranges in a set.
 class BlockReadAmpBitmapSlowAndAccurate {
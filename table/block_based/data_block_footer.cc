@@ -15,15 +15,23 @@ namespace ROCKSDB_NAMESPACE {
 
 const int kDataBlockIndexTypeBitShift = 31;
 
-// 0x7FFFFFFF
-const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// A block this large would need 4GiB for its restart array, so the bit was
+// never set by older versions.
+const int kRestartKeyPrefixesBitShift = 30;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// Only set along with the data block index type bit, in blocks under 64KiB
+const int kHashIndexEntryOffsetsBitShift = 29;
+
+// 0x1FFFFFFF
+const uint32_t kMaxNumRestarts = (1u << kHashIndexEntryOffsetsBitShift) - 1u;
+
+// 0x1FFFFFFF
+const uint32_t kNumRestartsMask = (1u << kHashIndexEntryOffsetsBitShift) - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts) {
+    uint32_t num_restarts, bool restart_key_prefixes,
+    bool hash_index_entry_offsets) {
   if (num_restarts > kMaxNumRestarts) {
     assert(0);  // mute travis "unused" warning
   }
@@ -31,17 +39,39 @@ uint32_t PackIndexTypeAndNumRestarts(
   uint32_t block_footer = num_restarts;
   if (index_type == BlockBasedTableOptions::kDataBlockBinaryAndHash) {
     block_footer |= 1u << kDataBlockIndexTypeBitShift;
+    if (hash_index_entry_offsets) {
+      block_footer |= 1u << kHashIndexEntryOffsetsBitShift;
+    }
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
+  if (restart_key_prefixes) {
+    block_footer |= 1u << kRestartKeyPrefixesBitShift;
+  }
 
   return block_footer;
 }
 
+bool UnPackRestartKeyPrefixes(uint32_t* block_footer) {
+  const bool restart_key_prefixes =
+      (*block_footer & 1u << kRestartKeyPrefixesBitShift) != 0;
+  *block_footer &= ~(1u << kRestartKeyPrefixesBitShift);
+  return restart_key_prefixes;
+}
+
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts) {
+    uint32_t* num_restarts, bool* restart_key_prefixes,
+    bool* hash_index_entry_offsets) {
+  if (restart_key_prefixes) {
+    *restart_key_prefixes =
+        (block_footer & 1u << kRestartKeyPrefixesBitShift) != 0;
+  }
+  if (hash_index_entry_offsets) {
+    *hash_index_entry_offsets =
+        (block_footer & 1u << kHashIndexEntryOffsetsBitShift) != 0;
+  }
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -9,17 +9,47 @@
 
 #pragma once
 
+#include <algorithm>
+
+#include "rocksdb/slice.h"
 #include "rocksdb/table.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+// The block footer also records whether the restart array is followed by an
+// array of restart key prefixes, see
+// BlockBasedTableOptions::data_block_restart_key_prefixes, and whether the
+// hash index buckets hold entry offsets, see
+// BlockBasedTableOptions::data_block_hash_index_entry_offsets.
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
-    uint32_t num_restarts);
+    uint32_t num_restarts, bool restart_key_prefixes = false,
+    bool hash_index_entry_offsets = false);
 
 void UnPackIndexTypeAndNumRestarts(
     uint32_t block_footer,
     BlockBasedTableOptions::DataBlockIndexType* index_type,
-    uint32_t* num_restarts);
+    uint32_t* num_restarts, bool* restart_key_prefixes = nullptr,
+    bool* hash_index_entry_offsets = nullptr);
+
+// Clears the restart key prefixes flag from block_footer, returning whether
+// it was set.
+bool UnPackRestartKeyPrefixes(uint32_t* block_footer);
+
+// Each restart key prefix is stored as a fixed64 holding the big-endian value
+// of the first 8 bytes of the user key, padded with zeros. Comparing two of
+// them as integers therefore gives the bytewise order of the user keys,
+// except that a tie does not mean the keys are equal.
+constexpr uint32_t kRestartKeyPrefixSize = sizeof(uint64_t);
+
+inline uint64_t RestartKeyPrefix(const Slice& user_key) {
+  uint64_t prefix = 0;
+  const size_t n = std::min(user_key.size(), size_t{kRestartKeyPrefixSize});
+  for (size_t i = 0; i < n; i++) {
+    prefix |= uint64_t{static_cast<unsigned char>(user_key[i])}
+              << (8 * (kRestartKeyPrefixSize - 1 - i));
+  }
+  return prefix;
+}
 
 }  // namespace ROCKSDB_NAMESPACE
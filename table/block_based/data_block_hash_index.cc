@@ -16,14 +16,20 @@ namespace ROCKSDB_NAMESPACE {
 void DataBlockHashIndexBuilder::Add(const Slice& key,
                                     const size_t restart_index) {
   assert(Valid());
-  if (restart_index > kMaxRestartSupportedByHashIndex) {
+  if (entry_offsets_) {
+    if (restart_index >= kCollisionOffset) {
+      // The block is too large for the hash index anyway, see
+      // BlockBuilder::Finish()
+      return;
+    }
+  } else if (restart_index > kMaxRestartSupportedByHashIndex) {
     valid_ = false;
     return;
   }
 
   uint32_t hash_value = GetSliceHash(key);
   hash_and_restart_pairs_.emplace_back(hash_value,
-                                       static_cast<uint8_t>(restart_index));
+                                       static_cast<uint16_t>(restart_index));
   estimated_num_buckets_ += bucket_per_key_;
 }
 
@@ -41,24 +47,28 @@ void DataBlockHashIndexBuilder::Finish(std::string& buffer) {
   // We made the num_buckets to be odd to avoid this issue.
   num_buckets |= 1;
 
-  std::vector<uint8_t> buckets(num_buckets, kNoEntry);
+  const uint16_t no_entry = entry_offsets_ ? kNoEntryOffset : kNoEntry;
+  const uint16_t collision = entry_offsets_ ? kCollisionOffset : kCollision;
+  std::vector<uint16_t> buckets(num_buckets, no_entry);
   // write the restart_index array
   for (auto& entry : hash_and_restart_pairs_) {
     uint32_t hash_value = entry.first;
-    uint8_t restart_index = entry.second;
+    uint16_t restart_index = entry.second;
     uint16_t buck_idx = static_cast<uint16_t>(hash_value % num_buckets);
-    if (buckets[buck_idx] == kNoEntry) {
+    if (buckets[buck_idx] == no_entry) {
       buckets[buck_idx] = restart_index;
     } else if (buckets[buck_idx] != restart_index) {
       // same bucket cannot store two different restart_index, mark collision
-      buckets[buck_idx] = kCollision;
+      buckets[buck_idx] = collision;
     }
   }
 
-  for (uint8_t restart_index : buckets) {
-    buffer.append(
-        const_cast<const char*>(reinterpret_cast<char*>(&restart_index)),
-        sizeof(restart_index));
+  for (uint16_t restart_index : buckets) {
+    if (entry_offsets_) {
+      PutFixed16(&buffer, restart_index);
+    } else {
+      buffer.push_back(static_cast<char>(restart_index));
+    }
   }
 
   // write NUM_BUCK
@@ -74,13 +84,15 @@ void DataBlockHashIndexBuilder::Reset() {
 }
 
 void DataBlockHashIndex::Initialize(const char* data, uint16_t size,
-                                    uint16_t* map_offset) {
+                                    uint16_t* map_offset, bool entry_offsets) {
   assert(size >= sizeof(uint16_t));  // NUM_BUCKETS
   num_buckets_ = DecodeFixed16(data + size - sizeof(uint16_t));
+  entry_offsets_ = entry_offsets;
+  const size_t bucket_size = entry_offsets ? sizeof(uint16_t) : sizeof(uint8_t);
   assert(num_buckets_ > 0);
-  assert(size > num_buckets_ * sizeof(uint8_t));
+  assert(size > num_buckets_ * bucket_size);
   *map_offset = static_cast<uint16_t>(size - sizeof(uint16_t) -
-                                      num_buckets_ * sizeof(uint8_t));
+                                      num_buckets_ * bucket_size);
 }
 
 uint8_t DataBlockHashIndex::Lookup(const char* data, uint32_t map_offset,
@@ -91,4 +103,14 @@ uint8_t DataBlockHashIndex::Lookup(const char* data, uint32_t map_offset,
   return static_cast<uint8_t>(*(bucket_table + idx * sizeof(uint8_t)));
 }
 
+uint16_t DataBlockHashIndex::LookupEntryOffset(const char* data,
+                                               uint32_t map_offset,
+                                               const Slice& key) const {
+  assert(entry_offsets_);
+  uint32_t hash_value = GetSliceHash(key);
+  uint16_t idx = static_cast<uint16_t>(hash_value % num_buckets_);
+  const char* bucket_table = data + map_offset;
+  return DecodeFixed16(bucket_table + idx * sizeof(uint16_t));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -62,11 +62,28 @@ namespace ROCKSDB_NAMESPACE {
 //
 // Note that we only support blocks with #restart_interval < 254. If a block
 // has more restart interval than that, hash index will not be create for it.
+//
+// With BlockBasedTableOptions::data_block_hash_index_entry_offsets, each
+// bucket is instead a fixed16 offset of the first entry with a user key
+// hashed to it (kNoEntryOffset and kCollisionOffset being the special
+// flags), and a bit in the block footer marks the wider buckets. The keys in
+// such a block are delta encoded against the key at their restart point
+// rather than the previous key, so an entry can be decoded from its restart
+// key alone. That keeps the block readable with the usual sequential
+// decoding, since a key shares at least as many bytes with the previous key
+// as with the restart key, and it lets a point lookup jump straight to the
+// entry instead of scanning the restart interval. There is then no limit on
+// the number of restart intervals.
 
 const uint8_t kNoEntry = 255;
 const uint8_t kCollision = 254;
 const uint8_t kMaxRestartSupportedByHashIndex = 253;
 
+// Entries start at least a block footer before the end of a block, which is
+// at most kMaxBlockSizeSupportedByHashIndex, so neither is a valid offset.
+const uint16_t kNoEntryOffset = 0xFFFF;
+const uint16_t kCollisionOffset = 0xFFFE;
+
 // Because we use uint16_t address, we only support block no more than 64KB
 const size_t kMaxBlockSizeSupportedByHashIndex = 1u << 16;
 const double kDefaultUtilRatio = 0.75;
@@ -78,15 +95,18 @@ class DataBlockHashIndexBuilder {
         estimated_num_buckets_(0),
         valid_(false) {}
 
-  void Initialize(double util_ratio) {
+  void Initialize(double util_ratio, bool entry_offsets = false) {
     if (util_ratio <= 0) {
       util_ratio = kDefaultUtilRatio;  // sanity check
     }
     bucket_per_key_ = 1 / util_ratio;
+    entry_offsets_ = entry_offsets;
     valid_ = true;
   }
 
   inline bool Valid() const { return valid_ && bucket_per_key_ > 0; }
+  inline bool EntryOffsets() const { return entry_offsets_; }
+  // `restart_index` is the offset of the entry when EntryOffsets().
   void Add(const Slice& key, const size_t restart_index);
   void Finish(std::string& buffer);
   void Reset();
@@ -98,7 +118,8 @@ class DataBlockHashIndexBuilder {
     estimated_num_buckets |= 1;
 
     return sizeof(uint16_t) +
-           static_cast<size_t>(estimated_num_buckets * sizeof(uint8_t));
+           static_cast<size_t>(estimated_num_buckets) *
+               (entry_offsets_ ? sizeof(uint16_t) : sizeof(uint8_t));
   }
 
  private:
@@ -109,8 +130,9 @@ class DataBlockHashIndexBuilder {
   // restart_index is larger than supported. In this case HashIndex is not
   // appended to the block content.
   bool valid_;
+  bool entry_offsets_ = false;
 
-  std::vector<std::pair<uint32_t, uint8_t>> hash_and_restart_pairs_;
+  std::vector<std::pair<uint32_t, uint16_t>> hash_and_restart_pairs_;
   friend class DataBlockHashIndex_DataBlockHashTestSmall_Test;
 };
 
@@ -118,11 +140,19 @@ class DataBlockHashIndex {
  public:
   DataBlockHashIndex() : num_buckets_(0) {}
 
-  void Initialize(const char* data, uint16_t size, uint16_t* map_offset);
+  void Initialize(const char* data, uint16_t size, uint16_t* map_offset,
+                  bool entry_offsets = false);
 
   uint8_t Lookup(const char* data, uint32_t map_offset, const Slice& key) const;
 
+  // Returns the offset of the first entry with a user key hashed to the same
+  // bucket as `key`, kNoEntryOffset or kCollisionOffset.
+  // REQUIRES: EntryOffsets()
+  uint16_t LookupEntryOffset(const char* data, uint32_t map_offset,
+                             const Slice& key) const;
+
   inline bool Valid() { return num_buckets_ != 0; }
+  inline bool EntryOffsets() const { return entry_offsets_; }
 
  private:
   // To make the serialized hash index compact and to save the space overhead,
@@ -132,6 +162,7 @@ class DataBlockHashIndex {
   // So in other words, DataBlockHashIndex does not support block size equal
   // or greater then 64KiB.
   uint16_t num_buckets_;
+  bool entry_offsets_ = false;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
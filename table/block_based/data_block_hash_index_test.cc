@@ -529,6 +529,114 @@ TEST(DataBlockHashIndex, BlockTestLarge) {
   }
 }
 
+TEST(DataBlockHashIndex, BlockTestEntryOffsets) {
+  Random rnd(1019);
+  const InternalKeyComparator icmp(BytewiseComparator());
+  constexpr int kNumUserKeys = 300;
+  constexpr int kNumVersions = 3;
+
+  // Existing user keys end with "1" and missing ones with "0", as above
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumUserKeys; i++) {
+    keys.emplace_back(GenerateKey(i, 0, 0, &rnd));
+  }
+  for (int i = 0; i < kNumUserKeys * kNumVersions; i++) {
+    values.emplace_back(rnd.RandomString(10));
+  }
+
+  // More restart intervals than a hash index of restart indexes supports
+  for (int restart_interval : {1, 16}) {
+    for (bool restart_key_prefixes : {false, true}) {
+      SCOPED_TRACE("restart_interval=" + std::to_string(restart_interval) +
+                   " restart_key_prefixes=" +
+                   std::to_string(restart_key_prefixes));
+      BlockBuilder builder(
+          restart_interval, true /* use_delta_encoding */,
+          false /* use_value_delta_encoding */,
+          BlockBasedTableOptions::kDataBlockBinaryAndHash,
+          0.75 /* data_block_hash_table_util_ratio */, 0 /* ts_sz */,
+          true /* persist_user_defined_timestamps */, false /* is_user_key */,
+          restart_key_prefixes, true /* hash_index_entry_offsets */);
+      std::vector<std::string> ikeys;
+      for (int i = 0; i < kNumUserKeys; i++) {
+        for (int v = 0; v < kNumVersions; v++) {
+          // Newer versions first
+          InternalKey ikey(keys[i] + "1", 100 - 10 * v, kTypeValue);
+          ikeys.push_back(ikey.Encode().ToString());
+          builder.Add(ikeys.back(), values[i * kNumVersions + v]);
+        }
+      }
+      Slice rawblock = builder.Finish();
+      ASSERT_LT(rawblock.size(), kMaxBlockSizeSupportedByHashIndex);
+
+      BlockContents contents;
+      contents.data = rawblock;
+      Block reader(std::move(contents));
+      ASSERT_EQ(reader.IndexType(),
+                BlockBasedTableOptions::kDataBlockBinaryAndHash);
+
+      // Keys delta encoded against restart keys still decode sequentially
+      {
+        std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+            icmp.user_comparator(), kDisableGlobalSequenceNumber));
+        size_t i = 0;
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+          ASSERT_LT(i, ikeys.size());
+          ASSERT_EQ(ikeys[i], iter->key());
+          ASSERT_EQ(values[i], iter->value());
+        }
+        ASSERT_OK(iter->status());
+        ASSERT_EQ(ikeys.size(), i);
+        i = ikeys.size();
+        for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+          ASSERT_EQ(ikeys[--i], iter->key());
+        }
+        ASSERT_EQ(0, i);
+      }
+
+      for (int i = 0; i < kNumUserKeys; i++) {
+        for (int v = 0; v < kNumVersions; v++) {
+          std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+              icmp.user_comparator(), kDisableGlobalSequenceNumber));
+          // Reading at a snapshot between two versions finds the older one
+          InternalKey ikey(keys[i] + "1", 105 - 10 * v, kValueTypeForSeek);
+          ASSERT_TRUE(iter->SeekForGet(ikey.Encode().ToString()));
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_EQ(ikeys[i * kNumVersions + v], iter->key());
+          ASSERT_EQ(values[i * kNumVersions + v], iter->value());
+        }
+
+        std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+            icmp.user_comparator(), kDisableGlobalSequenceNumber));
+        InternalKey ikey(keys[i] + "0", kMaxSequenceNumber, kValueTypeForSeek);
+        bool may_exist = iter->SeekForGet(ikey.Encode().ToString());
+        if (!may_exist) {
+          ASSERT_TRUE(iter->Valid());
+          ASSERT_NE(ExtractUserKey(iter->key()), ikey.user_key());
+        }
+        if (!iter->Valid()) {
+          ASSERT_TRUE(may_exist);
+        }
+      }
+
+      {
+        // Past the last key of the block, it may be in the next block
+        std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+            icmp.user_comparator(), kDisableGlobalSequenceNumber));
+        InternalKey ikey(keys.back() + "2", kMaxSequenceNumber,
+                         kValueTypeForSeek);
+        ASSERT_TRUE(iter->SeekForGet(ikey.Encode().ToString()));
+        ASSERT_FALSE(iter->Valid());
+        // And so may a version of the last user key older than those here
+        ikey.Set(keys.back() + "1", 1, kValueTypeForSeek);
+        ASSERT_TRUE(iter->SeekForGet(ikey.Encode().ToString()));
+        ASSERT_FALSE(iter->Valid());
+      }
+    }
+  }
+}
+
 // helper routine for DataBlockHashIndex.BlockBoundary
 void TestBoundary(InternalKey& ik1, std::string& v1, InternalKey& ik2,
                   std::string& v2, InternalKey& seek_ikey,
@@ -0,0 +1,95 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#include "table/block_based/data_block_properties.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+const std::string kDataBlockPropertiesBlockName =
+    "rocksdb.data_block_properties";
+
+bool DataBlockProperties::MayMatch(uint64_t offset,
+                                   const Filter& filter) const {
+  auto it = std::lower_bound(
+      blocks_.begin(), blocks_.end(), offset,
+      [](const std::pair<uint64_t, Slice>& block, uint64_t target) {
+        return block.first < target;
+      });
+  if (it == blocks_.end() || it->first != offset) {
+    return true;
+  }
+  Slice input = it->second;
+  Slice collector_name;
+  Slice property;
+  while (GetLengthPrefixedSlice(&input, &collector_name) &&
+         GetLengthPrefixedSlice(&input, &property)) {
+    if (!filter(collector_name, property)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status DataBlockProperties::Create(
+    BlockContents&& contents, std::unique_ptr<DataBlockProperties>* result) {
+  std::unique_ptr<DataBlockProperties> properties(new DataBlockProperties());
+  properties->contents_ = std::move(contents);
+  Slice input = properties->contents_.data;
+  uint64_t offset = 0;
+  while (!input.empty()) {
+    uint64_t delta;
+    Slice block_properties;
+    if (!GetVarint64(&input, &delta) ||
+        !GetLengthPrefixedSlice(&input, &block_properties)) {
+      return Status::Corruption("bad data block properties");
+    }
+    if (!properties->blocks_.empty() && delta == 0) {
+      return Status::Corruption("data block properties out of order");
+    }
+    offset += delta;
+    properties->blocks_.emplace_back(offset, block_properties);
+  }
+  *result = std::move(properties);
+  return Status::OK();
+}
+
+void DataBlockProperties::Builder::FinishDataBlock(
+    const std::vector<std::unique_ptr<IntTblPropCollector>>& collectors) {
+  std::string encoded;
+  std::string property;
+  for (auto& collector : collectors) {
+    property.clear();
+    collector->FinishDataBlock(&property);
+    if (!property.empty()) {
+      PutLengthPrefixedSlice(&encoded, collector->Name());
+      PutLengthPrefixedSlice(&encoded, property);
+    }
+  }
+  if (!encoded.empty()) {
+    properties_.emplace_back(num_blocks_, std::move(encoded));
+  }
+  num_blocks_++;
+}
+
+bool DataBlockProperties::Builder::Finish(std::string* contents) {
+  if (properties_.empty()) {
+    return false;
+  }
+  assert(offsets_.size() == num_blocks_);
+  uint64_t last_offset = 0;
+  for (const auto& block : properties_) {
+    const uint64_t offset = offsets_[block.first];
+    PutVarint64(contents, offset - last_offset);
+    PutLengthPrefixedSlice(contents, block.second);
+    last_offset = offset;
+  }
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,79 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "db/table_properties_collector.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+extern const std::string kDataBlockPropertiesBlockName;
+
+// The properties that table properties collectors recorded for the data
+// blocks of a table, see TablePropertiesCollector::FinishDataBlock(). They
+// are kept in a kDataBlockPropertiesBlockName meta block rather than in the
+// index, so that every index type and older readers work unchanged. For each
+// data block with any property, in file order, the meta block holds
+//    offset delta: varint64, from the offset of the previous such block
+//    properties: length prefixed, a sequence of
+//      collector name: length prefixed
+//      block property: length prefixed
+class DataBlockProperties {
+ public:
+  using Filter =
+      std::function<bool(const Slice& collector_name, const Slice& property)>;
+
+  // Returns whether `filter` accepts every property of the data block at
+  // `offset`. Blocks without properties are always accepted.
+  bool MayMatch(uint64_t offset, const Filter& filter) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(DataBlockProperties) + contents_.ApproximateMemoryUsage() +
+           blocks_.capacity() * sizeof(blocks_[0]);
+  }
+
+  // Create the lookup table from the contents of the meta block.
+  static Status Create(BlockContents&& contents,
+                       std::unique_ptr<DataBlockProperties>* result);
+
+  class Builder {
+   public:
+    // Asks `collectors` for the properties of the data block just cut.
+    // REQUIRES: called for each data block, in order.
+    void FinishDataBlock(
+        const std::vector<std::unique_ptr<IntTblPropCollector>>& collectors);
+
+    // REQUIRES: called with the offset of each data block as it is written,
+    // in order, possibly from another thread than FinishDataBlock().
+    void AddDataBlockOffset(uint64_t offset) { offsets_.push_back(offset); }
+
+    // Encodes the meta block into *contents. Returns false if no data block
+    // has any property.
+    bool Finish(std::string* contents);
+
+   private:
+    // Encoded properties of the data blocks with any, by block number
+    std::vector<std::pair<size_t, std::string>> properties_;
+    size_t num_blocks_ = 0;
+    std::vector<uint64_t> offsets_;
+  };
+
+ private:
+  BlockContents contents_;
+  // Data block offsets and their encoded properties, by offset
+  std::vector<std::pair<uint64_t, Slice>> blocks_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
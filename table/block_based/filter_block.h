@@ -155,6 +155,18 @@ class FilterBlockReader {
     }
   }
 
+  /**
+   * Returns false only if no user key (without timestamp) in [begin, end)
+   * was added to the filter, which only range filters can tell. no_io means
+   * the same as in KeyMayMatch
+   */
+  virtual bool RangeMayMatch(const Slice& /*begin*/, const Slice& /*end*/,
+                             const bool /*no_io*/,
+                             BlockCacheLookupContext* /*lookup_context*/,
+                             const ReadOptions& /*read_options*/) {
+    return true;
+  }
+
   virtual size_t ApproximateMemoryUsage() const = 0;
 
   // convert this object to a human readable form
@@ -988,9 +988,9 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
           &saved[i].segment_num, &saved[i].num_columns, &saved[i].start_bits);
     }
     for (int i = 0; i < num_keys; ++i) {
-      may_match[i] = ribbon::InterleavedFilterQuery(
+      may_match[i] = soln_.PreparedFilterQuery(
           saved[i].seeded_hash, saved[i].segment_num, saved[i].num_columns,
-          saved[i].start_bits, hasher_, soln_);
+          saved[i].start_bits, hasher_);
     }
   }
 
@@ -1302,6 +1302,232 @@ Status XXPH3FilterBitsBuilder::MaybePostVerify(const Slice& filter_content) {
   ResetEntries();
   return s;
 }
+
+// Range filter data:
+//             0 +-----------------------------------+
+//               | Inner filter data, including its  |
+//               |   own metadata                    |
+//           len +-----------------------------------+
+//               | byte for marker -3                |
+//         len+1 +-----------------------------------+
+//               | byte for number of levels         |
+//         len+2 +-----------------------------------+
+//               | byte for prefix_len               |
+//         len+3 +-----------------------------------+
+//               | two bytes reserved (zero)         |
+// len_with_meta +-----------------------------------+
+//
+// For a key with prefix p of prefix_len bytes, let v be the next eight bytes
+// (zero padded) as a big-endian integer. The inner filter holds the entry
+// (p, l, v >> l) for each level l < levels, so that a range [a, b) of keys
+// sharing prefix p is checked by probing the dyadic intervals covering
+// [v(a), v(b)], which hold every v(k) for a <= k < b.
+static constexpr int8_t kRangeFilterMarker = -3;
+
+// At the top level, probe at most this many values before giving up
+static constexpr uint64_t kRangeFilterMaxTopLevelProbes = 4;
+
+Slice RangeFilterPrefix(const Slice& key, size_t prefix_len) {
+  return Slice(key.data(), std::min(key.size(), prefix_len));
+}
+
+uint64_t RangeFilterValue(const Slice& key, size_t prefix_len) {
+  uint64_t value = 0;
+  for (size_t i = prefix_len; i < prefix_len + 8; ++i) {
+    value <<= 8;
+    if (i < key.size()) {
+      value |= static_cast<unsigned char>(key[i]);
+    }
+  }
+  return value;
+}
+
+void EncodeRangeFilterEntry(const Slice& prefix, int level, uint64_t value,
+                            std::string* entry) {
+  entry->assign(prefix.data(), prefix.size());
+  entry->push_back(static_cast<char>(level));
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    entry->push_back(static_cast<char>(value >> shift));
+  }
+}
+
+class RangeFilterBitsBuilder : public BuiltinFilterBitsBuilder {
+ public:
+  RangeFilterBitsBuilder(BuiltinFilterBitsBuilder* inner, size_t prefix_len,
+                         int levels)
+      : inner_(inner), prefix_len_(prefix_len), levels_(levels) {}
+
+  // No Copy allowed
+  RangeFilterBitsBuilder(const RangeFilterBitsBuilder&) = delete;
+  void operator=(const RangeFilterBitsBuilder&) = delete;
+
+  void AddKey(const Slice& key) override {
+    const Slice prefix = RangeFilterPrefix(key, prefix_len_);
+    const uint64_t value = RangeFilterValue(key, prefix_len_);
+    const bool same_prefix = has_last_ && prefix == Slice(last_prefix_);
+    for (int level = 0; level < levels_; ++level) {
+      if (same_prefix && (value >> level) == (last_value_ >> level)) {
+        // Keys are added in order, so this and all higher levels were
+        // already added for the previous key
+        break;
+      }
+      EncodeRangeFilterEntry(prefix, level, value >> level, &entry_);
+      inner_->AddKey(entry_);
+    }
+    last_prefix_.assign(prefix.data(), prefix.size());
+    last_value_ = value;
+    has_last_ = true;
+  }
+
+  size_t EstimateEntriesAdded() override {
+    return inner_->EstimateEntriesAdded();
+  }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    return Finish(buf, nullptr);
+  }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf, Status* status) override {
+    std::unique_ptr<const char[]> inner_buf;
+    Slice inner = inner_->Finish(&inner_buf, status);
+    if (inner.size() <= kMetadataLen) {
+      // Empty or broken filter, readable as is
+      *buf = std::move(inner_buf);
+      return inner;
+    }
+    const size_t len_with_metadata = inner.size() + kMetadataLen;
+    std::unique_ptr<char[]> mutable_buf(new char[len_with_metadata]);
+    memcpy(mutable_buf.get(), inner.data(), inner.size());
+    char* metadata = mutable_buf.get() + inner.size();
+    metadata[0] = static_cast<char>(kRangeFilterMarker);
+    metadata[1] = static_cast<char>(levels_);
+    metadata[2] = static_cast<char>(prefix_len_);
+    metadata[3] = 0;
+    metadata[4] = 0;
+    Slice rv(mutable_buf.get(), len_with_metadata);
+    *buf = std::move(mutable_buf);
+    return rv;
+  }
+
+  Status MaybePostVerify(const Slice& filter_content) override {
+    if (filter_content.size() <= kMetadataLen) {
+      return inner_->MaybePostVerify(filter_content);
+    }
+    return inner_->MaybePostVerify(
+        Slice(filter_content.data(), filter_content.size() - kMetadataLen));
+  }
+
+  size_t ApproximateNumEntries(size_t bytes) override {
+    return inner_->ApproximateNumEntries(bytes) / levels_;
+  }
+
+  size_t CalculateSpace(size_t num_entries) override {
+    return inner_->CalculateSpace(num_entries * levels_) + kMetadataLen;
+  }
+
+  double EstimatedFpRate(size_t num_entries, size_t bytes) override {
+    return inner_->EstimatedFpRate(num_entries * levels_,
+                                   bytes > kMetadataLen ? bytes - kMetadataLen
+                                                        : bytes);
+  }
+
+ private:
+  std::unique_ptr<BuiltinFilterBitsBuilder> inner_;
+  const size_t prefix_len_;
+  const int levels_;
+  std::string entry_;
+  // Prefix and value of the most recently added key
+  bool has_last_ = false;
+  std::string last_prefix_;
+  uint64_t last_value_ = 0;
+};
+
+class RangeFilterBitsReader : public BuiltinFilterBitsReader {
+ public:
+  RangeFilterBitsReader(BuiltinFilterBitsReader* inner, size_t prefix_len,
+                        int levels)
+      : inner_(inner), prefix_len_(prefix_len), levels_(levels) {}
+
+  // No Copy allowed
+  RangeFilterBitsReader(const RangeFilterBitsReader&) = delete;
+  void operator=(const RangeFilterBitsReader&) = delete;
+
+  bool MayMatch(const Slice& key) override {
+    std::string entry;
+    EncodeRangeFilterEntry(RangeFilterPrefix(key, prefix_len_), 0,
+                           RangeFilterValue(key, prefix_len_), &entry);
+    return inner_->MayMatch(entry);
+  }
+  using FilterBitsReader::MayMatch;  // inherit overload
+
+  bool HashMayMatch(const uint64_t h) override {
+    return inner_->HashMayMatch(h);
+  }
+  using BuiltinFilterBitsReader::HashMayMatch;  // inherit overload
+
+  bool RangeMayMatch(const Slice& begin, const Slice& end) override {
+    if (begin.size() < prefix_len_ || end.size() < prefix_len_ ||
+        memcmp(begin.data(), end.data(), prefix_len_) != 0) {
+      // Keys in the range might have any prefix
+      return true;
+    }
+    const Slice prefix(begin.data(), prefix_len_);
+    // Inclusive bounds of the values to check, in units of 2^level
+    uint64_t lo = RangeFilterValue(begin, prefix_len_);
+    uint64_t hi = RangeFilterValue(end, prefix_len_);
+    for (int level = 0;; ++level) {
+      if (lo > hi) {
+        return false;
+      }
+      if (level == levels_ - 1) {
+        if (hi - lo >= kRangeFilterMaxTopLevelProbes) {
+          return true;
+        }
+        for (uint64_t value = lo;; ++value) {
+          if (Probe(prefix, level, value)) {
+            return true;
+          }
+          if (value == hi) {
+            return false;
+          }
+        }
+      }
+      // Probe the ends that do not start or end an interval of the next
+      // level
+      if (lo & 1) {
+        if (Probe(prefix, level, lo)) {
+          return true;
+        }
+        if (lo == hi) {
+          return false;
+        }
+        ++lo;
+      }
+      if (!(hi & 1)) {
+        if (Probe(prefix, level, hi)) {
+          return true;
+        }
+        if (lo == hi) {
+          return false;
+        }
+        --hi;
+      }
+      lo >>= 1;
+      hi >>= 1;
+    }
+  }
+
+ private:
+  bool Probe(const Slice& prefix, int level, uint64_t value) {
+    EncodeRangeFilterEntry(prefix, level, value, &entry_);
+    return inner_->MayMatch(entry_);
+  }
+
+  std::unique_ptr<BuiltinFilterBitsReader> inner_;
+  const size_t prefix_len_;
+  const int levels_;
+  std::string entry_;
+};
 }  // namespace
 
 const char* BuiltinFilterPolicy::kClassName() {
@@ -1591,6 +1817,9 @@ BuiltinFilterBitsReader* BuiltinFilterPolicy::GetBuiltinFilterBitsReader(
       case -2:
         // Marker for Ribbon implementations
         return GetRibbonBitsReader(contents);
+      case kRangeFilterMarker:
+        // Marker for range filter implementations
+        return GetRangeBitsReader(contents);
       default:
         // Reserved (treat as zero probes, always FP, for now)
         return new AlwaysTrueFilter();
@@ -1662,6 +1891,26 @@ BuiltinFilterBitsReader* BuiltinFilterPolicy::GetRibbonBitsReader(
                                          seed);
 }
 
+// For range filter implementations, see RangeFilterBitsBuilder
+BuiltinFilterBitsReader* BuiltinFilterPolicy::GetRangeBitsReader(
+    const Slice& contents) {
+  uint32_t len_with_meta = static_cast<uint32_t>(contents.size());
+  uint32_t len = len_with_meta - kMetadataLen;
+
+  assert(len > 0);  // precondition
+
+  int levels = static_cast<uint8_t>(contents.data()[len + 1]);
+  size_t prefix_len = static_cast<uint8_t>(contents.data()[len + 2]);
+  if (levels < 1 || levels > RangeFilterPolicy::kMaxLevels) {
+    // Not supported
+    // Return something safe:
+    return new AlwaysTrueFilter();
+  }
+  return new RangeFilterBitsReader(
+      GetBuiltinFilterBitsReader(Slice(contents.data(), len)), prefix_len,
+      levels);
+}
+
 // For newer Bloom filter implementations
 BuiltinFilterBitsReader* BuiltinFilterPolicy::GetBloomBitsReader(
     const Slice& contents) {
@@ -1801,6 +2050,37 @@ FilterPolicy* NewRibbonFilterPolicy(double bloom_equivalent_bits_per_key,
                                 bloom_before_level);
 }
 
+RangeFilterPolicy::RangeFilterPolicy(double bits_per_key, size_t prefix_len,
+                                     int levels)
+    : BloomLikeFilterPolicy(bits_per_key),
+      prefix_len_(std::min(prefix_len, kMaxPrefixLen)),
+      levels_(std::max(1, std::min(levels, kMaxLevels))) {}
+
+FilterBitsBuilder* RangeFilterPolicy::GetBuilderWithContext(
+    const FilterBuildingContext& context) const {
+  if (GetMillibitsPerKey() == 0) {
+    // "No filter" special case
+    return nullptr;
+  }
+  return new RangeFilterBitsBuilder(
+      static_cast<BuiltinFilterBitsBuilder*>(
+          GetFastLocalBloomBuilderWithContext(context)),
+      prefix_len_, levels_);
+}
+
+const char* RangeFilterPolicy::kClassName() { return "rangefilter"; }
+const char* RangeFilterPolicy::kNickName() { return "rocksdb.RangeFilter"; }
+
+std::string RangeFilterPolicy::GetId() const {
+  return BloomLikeFilterPolicy::GetId() + ":" + std::to_string(prefix_len_) +
+         ":" + std::to_string(levels_);
+}
+
+FilterPolicy* NewRangeFilterPolicy(double bits_per_key, size_t prefix_len,
+                                   int levels) {
+  return new RangeFilterPolicy(bits_per_key, prefix_len, levels);
+}
+
 FilterBuildingContext::FilterBuildingContext(
     const BlockBasedTableOptions& _table_options)
     : table_options(_table_options) {}
@@ -1903,6 +2183,20 @@ static int RegisterBuiltinFilterPolicies(ObjectLibrary& library,
         guard->reset(NewRibbonFilterPolicy(bits_per_key, bloom_before_level));
         return guard->get();
       });
+  library.AddFactory<const FilterPolicy>(
+      FilterPatternEntryWithBits(RangeFilterPolicy::kClassName())
+          .AnotherName(RangeFilterPolicy::kNickName())
+          .AddNumber(":", true)
+          .AddNumber(":", true),
+      [](const std::string& uri, std::unique_ptr<const FilterPolicy>* guard,
+         std::string* /* errmsg */) {
+        const std::vector<std::string> vals = StringSplit(uri, ':');
+        double bits_per_key = ParseDouble(vals[1]);
+        size_t prefix_len = ParseSizeT(vals[2]);
+        int levels = ParseInt(vals[3]);
+        guard->reset(NewRangeFilterPolicy(bits_per_key, prefix_len, levels));
+        return guard->get();
+      });
   library.AddFactory<const FilterPolicy>(
       FilterPatternEntryWithBits(test::LegacyBloomFilterPolicy::kClassName()),
       [](const std::string& uri, std::unique_ptr<const FilterPolicy>* guard,
@@ -95,6 +95,12 @@ class FilterBitsReader {
       may_match[i] = MayMatch(*keys[i]);
     }
   }
+
+  // Check if any entry in [begin, end) may have been added to the filter.
+  // Only range filters (see NewRangeFilterPolicy) can rule out a range.
+  virtual bool RangeMayMatch(const Slice& /* begin */, const Slice& /* end */) {
+    return true;
+  }
 };
 
 // Exposes any extra information needed for testing built-in
@@ -157,6 +163,9 @@ class BuiltinFilterPolicy : public FilterPolicy {
 
   // For Ribbon filter implementation(s)
   static BuiltinFilterBitsReader* GetRibbonBitsReader(const Slice& contents);
+
+  // For range filter implementation(s)
+  static BuiltinFilterBitsReader* GetRangeBitsReader(const Slice& contents);
 };
 
 // A "read only" filter policy used for backward compatibility with old
@@ -297,6 +306,36 @@ class RibbonFilterPolicy : public BloomLikeFilterPolicy {
   std::atomic<int> bloom_before_level_;
 };
 
+// For NewRangeFilterPolicy
+//
+// This is a user-facing policy that builds a FastLocalBloom filter over a
+// dyadic decomposition of the keys, so that it can also rule out ranges.
+class RangeFilterPolicy : public BloomLikeFilterPolicy {
+ public:
+  explicit RangeFilterPolicy(double bits_per_key, size_t prefix_len,
+                             int levels);
+
+  FilterBitsBuilder* GetBuilderWithContext(
+      const FilterBuildingContext&) const override;
+
+  size_t GetPrefixLen() const { return prefix_len_; }
+  int GetLevels() const { return levels_; }
+
+  static const char* kClassName();
+  const char* Name() const override { return kClassName(); }
+  static const char* kNickName();
+  const char* NickName() const override { return kNickName(); }
+  std::string GetId() const override;
+
+  // Largest supported prefix_len and levels
+  static constexpr size_t kMaxPrefixLen = 255;
+  static constexpr int kMaxLevels = 64;
+
+ private:
+  size_t prefix_len_;
+  int levels_;
+};
+
 // For testing only, but always constructable with internal names
 namespace test {
 
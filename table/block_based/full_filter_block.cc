@@ -198,6 +198,40 @@ bool FullFilterBlockReader::MayMatch(const Slice& entry, bool no_io,
   return true;
 }
 
+bool FullFilterBlockReader::RangeMayMatch(
+    const Slice& begin, const Slice& end, const bool no_io,
+    BlockCacheLookupContext* lookup_context, const ReadOptions& read_options) {
+  if (!whole_key_filtering()) {
+    return true;
+  }
+
+  CachableEntry<ParsedFullFilterBlock> filter_block;
+
+  const Status s = GetOrReadFilterBlock(no_io, /*get_context=*/nullptr,
+                                        lookup_context, &filter_block,
+                                        read_options);
+  if (!s.ok()) {
+    IGNORE_STATUS_IF_ERROR(s);
+    return true;
+  }
+
+  assert(filter_block.GetValue());
+
+  FilterBitsReader* const filter_bits_reader =
+      filter_block.GetValue()->filter_bits_reader();
+
+  if (filter_bits_reader) {
+    if (filter_bits_reader->RangeMayMatch(begin, end)) {
+      PERF_COUNTER_ADD(bloom_sst_hit_count, 1);
+      return true;
+    } else {
+      PERF_COUNTER_ADD(bloom_sst_miss_count, 1);
+      return false;
+    }
+  }
+  return true;
+}
+
 void FullFilterBlockReader::KeysMayMatch(
     MultiGetRange* range, const bool no_io,
     BlockCacheLookupContext* lookup_context, const ReadOptions& read_options) {
@@ -132,6 +132,10 @@ class FullFilterBlockReader
                         const bool no_io,
                         BlockCacheLookupContext* lookup_context,
                         const ReadOptions& read_options) override;
+  bool RangeMayMatch(const Slice& begin, const Slice& end, const bool no_io,
+                     BlockCacheLookupContext* lookup_context,
+                     const ReadOptions& read_options) override;
+
   size_t ApproximateMemoryUsage() const override;
 
  private:
@@ -65,6 +65,13 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
           persist_user_defined_timestamps);
       break;
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      result = new LearnedIndexBuilder(
+          comparator, table_opt.index_block_restart_interval,
+          table_opt.format_version, use_value_delta_encoding,
+          table_opt.index_shortening, ts_sz, persist_user_defined_timestamps);
+      break;
+    }
     default: {
       assert(!"Do not recognize the index type ");
       break;
@@ -153,7 +160,10 @@ PartitionedIndexBuilder::~PartitionedIndexBuilder() {
 void PartitionedIndexBuilder::MakeNewSubIndexBuilder() {
   assert(sub_index_builder_ == nullptr);
   sub_index_builder_ = new ShortenedIndexBuilder(
-      comparator_, table_opt_.index_block_restart_interval,
+      comparator_,
+      table_opt_.index_partition_restart_interval > 0
+          ? table_opt_.index_partition_restart_interval
+          : table_opt_.index_block_restart_interval,
       table_opt_.format_version, use_value_delta_encoding_,
       table_opt_.index_shortening, /* include_first_key */ false, ts_sz_,
       persist_user_defined_timestamps_);
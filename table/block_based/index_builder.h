@@ -18,6 +18,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -419,6 +420,81 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder builds the same index block as ShortenedIndexBuilder,
+// plus a metablock holding a LearnedIndex fitted on the restart keys of that
+// index block. Readers ignoring the metablock still find a plain binary
+// searchable index.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  // Each prediction is at most this many restart points off, before
+  // accounting for restart keys sharing their first 8 bytes.
+  static constexpr uint32_t kMaxError = 8;
+
+  LearnedIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+      size_t ts_sz, const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               ts_sz, persist_user_defined_timestamps),
+        index_block_restart_interval_(index_block_restart_interval),
+        // The model orders keys by their bytes
+        build_model_(comparator->user_comparator() == BytewiseComparator() &&
+                     ts_sz == 0),
+        learned_index_builder_(kMaxError) {
+    assert(index_block_restart_interval_ >= 1);
+  }
+
+  void AddIndexEntry(std::string* last_key_in_current_block,
+                     const Slice* first_key_in_next_block,
+                     const BlockHandle& block_handle) override {
+    primary_index_builder_.AddIndexEntry(last_key_in_current_block,
+                                         first_key_in_next_block, block_handle);
+    // *last_key_in_current_block is now the separator added to the index
+    // block, which starts a restart interval every
+    // index_block_restart_interval_ entries.
+    if (build_model_ && num_entries_ % index_block_restart_interval_ == 0) {
+      learned_index_builder_.Add(ExtractUserKey(*last_key_in_current_block));
+    }
+    ++num_entries_;
+  }
+
+  void OnKeyAdded(const Slice& key) override {
+    primary_index_builder_.OnKeyAdded(key);
+  }
+
+  Status Finish(IndexBlocks* index_blocks,
+                const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    if (build_model_ && learned_index_builder_.Finish(&learned_index_block_)) {
+      index_blocks->meta_blocks.insert(
+          {kLearnedIndexBlock.c_str(), learned_index_block_});
+    }
+    return s;
+  }
+
+  size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + learned_index_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  const uint64_t index_block_restart_interval_;
+  const bool build_model_;
+  LearnedIndex::Builder learned_index_builder_;
+  std::string learned_index_block_;
+  uint64_t num_entries_ = 0;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -0,0 +1,152 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "table/block_based/data_block_footer.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The learned index block has the form:
+//     error: fixed32
+//     num_segments: fixed32
+//     segments: (first_key: fixed64, first_restart: fixed32,
+//                slope: fixed64 holding the bits of a double)[num_segments]
+namespace {
+constexpr size_t kHeaderSize = 2 * sizeof(uint32_t);
+constexpr size_t kSegmentSize =
+    sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint64_t);
+}  // namespace
+
+void LearnedIndex::Predict(const Slice& user_key, uint32_t num_restarts,
+                           uint32_t* begin, uint32_t* end) const {
+  const uint64_t key = RestartKeyPrefix(user_key);
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), key,
+      [](uint64_t k, const Segment& segment) { return k < segment.first_key; });
+  double predicted = 0;
+  if (it != segments_.begin()) {
+    const Segment& segment = *(it - 1);
+    predicted = segment.first_restart +
+                segment.slope * static_cast<double>(key - segment.first_key);
+    // Keys past the last point of a segment still sort before the next one
+    if (it != segments_.end()) {
+      predicted = std::min(predicted, static_cast<double>(it->first_restart));
+    }
+  }
+  const uint64_t restart = static_cast<uint64_t>(
+      std::min(predicted, static_cast<double>(num_restarts)));
+  *begin = static_cast<uint32_t>(restart > error_ ? restart - error_ : 0);
+  *end = static_cast<uint32_t>(
+      std::min(restart + error_ + 1, uint64_t{num_restarts}));
+}
+
+Status LearnedIndex::Create(const Slice& contents,
+                            std::unique_ptr<LearnedIndex>* learned_index) {
+  if (contents.size() < kHeaderSize) {
+    return Status::Corruption("Learned index block too short");
+  }
+  const uint32_t error = DecodeFixed32(contents.data());
+  const uint32_t num_segments =
+      DecodeFixed32(contents.data() + sizeof(uint32_t));
+  if (contents.size() != kHeaderSize + uint64_t{num_segments} * kSegmentSize) {
+    return Status::Corruption("Learned index block has the wrong size");
+  }
+
+  std::unique_ptr<LearnedIndex> result(new LearnedIndex());
+  result->error_ = error;
+  result->segments_.reserve(num_segments);
+  const char* p = contents.data() + kHeaderSize;
+  for (uint32_t i = 0; i < num_segments; i++, p += kSegmentSize) {
+    Segment segment;
+    segment.first_key = DecodeFixed64(p);
+    segment.first_restart = DecodeFixed32(p + sizeof(uint64_t));
+    const uint64_t slope_bits =
+        DecodeFixed64(p + sizeof(uint64_t) + sizeof(uint32_t));
+    memcpy(&segment.slope, &slope_bits, sizeof(double));
+    if (!(segment.slope >= 0) ||
+        (!result->segments_.empty() &&
+         (segment.first_key <= result->segments_.back().first_key ||
+          segment.first_restart <= result->segments_.back().first_restart))) {
+      return Status::Corruption("Bad learned index segment");
+    }
+    result->segments_.push_back(segment);
+  }
+  *learned_index = std::move(result);
+  return Status::OK();
+}
+
+void LearnedIndex::Builder::Add(const Slice& user_key) {
+  const uint64_t key = RestartKeyPrefix(user_key);
+  const uint32_t restart = num_restarts_++;
+  if (restart > 0 && key == last_key_) {
+    // Only the first restart key with a given prefix is a point of the model.
+    // The search window covers the others.
+    max_run_ = std::max(max_run_, ++run_);
+    return;
+  }
+  assert(restart == 0 || key > last_key_);
+  last_key_ = key;
+  run_ = 1;
+  max_run_ = std::max(max_run_, run_);
+
+  if (!segments_.empty()) {
+    const Segment& segment = segments_.back();
+    const double dx = static_cast<double>(key - segment.first_key);
+    const double dy = static_cast<double>(restart - segment.first_restart);
+    const double min_slope = (dy - max_error_) / dx;
+    const double max_slope = (dy + max_error_) / dx;
+    if ((!has_max_slope_ || min_slope <= max_slope_) &&
+        max_slope >= min_slope_) {
+      // The point fits in the cone; narrow it down
+      min_slope_ = std::max(min_slope_, min_slope);
+      max_slope_ = has_max_slope_ ? std::min(max_slope_, max_slope) : max_slope;
+      has_max_slope_ = true;
+      return;
+    }
+    FinishSegment();
+  }
+  segments_.push_back({key, restart, 0});
+  min_slope_ = 0;
+  has_max_slope_ = false;
+}
+
+void LearnedIndex::Builder::FinishSegment() {
+  assert(!segments_.empty());
+  // Any slope in the cone is within max_error_ of all the points
+  segments_.back().slope =
+      has_max_slope_ ? min_slope_ + (max_slope_ - min_slope_) / 2 : 0;
+}
+
+bool LearnedIndex::Builder::Finish(std::string* contents) {
+  if (segments_.empty()) {
+    return false;
+  }
+  FinishSegment();
+  // A key whose prefix falls between two points of the model may belong
+  // anywhere in the run of restart keys sharing the smaller prefix, and
+  // rounding the prediction down may lose one more restart point.
+  const uint64_t error = uint64_t{max_error_} + max_run_ + 1;
+  if (2 * error + 1 > num_restarts_ / 2) {
+    // Binary search would not take many more steps than the model saves
+    return false;
+  }
+  PutFixed32(contents, static_cast<uint32_t>(error));
+  PutFixed32(contents, static_cast<uint32_t>(segments_.size()));
+  for (const Segment& segment : segments_) {
+    PutFixed64(contents, segment.first_key);
+    PutFixed32(contents, segment.first_restart);
+    uint64_t slope_bits;
+    memcpy(&slope_bits, &segment.slope, sizeof(double));
+    PutFixed64(contents, slope_bits);
+  }
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
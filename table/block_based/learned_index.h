@@ -0,0 +1,90 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A piecewise linear model of the restart keys of an index block, for
+// BlockBasedTableOptions::kLearnedIndexSearch. It maps the first 8 bytes of a
+// user key, read as a big-endian integer (see RestartKeyPrefix()), to the
+// restart points an index block binary search still has to look at, so the
+// search only compares the target with a few keys near the predicted one.
+//
+// The mapping follows the bytewise order of user keys, so the model is only
+// built for tables using BytewiseComparator() without user-defined timestamps.
+class LearnedIndex {
+ private:
+  struct Segment {
+    // Prefix of the first restart key in the segment
+    uint64_t first_key;
+    // Restart index of that key
+    uint32_t first_restart;
+    // Restart points per unit of key prefix
+    double slope;
+  };
+
+ public:
+  // Sets [*begin, *end) to the restart points that may hold the last restart
+  // key not greater than a key with `user_key`: the restart keys before
+  // *begin are not greater than it and those from *end on are greater.
+  // Callers must verify the bounds, as a model read from a file might be off.
+  void Predict(const Slice& user_key, uint32_t num_restarts, uint32_t* begin,
+               uint32_t* end) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(LearnedIndex) + segments_.capacity() * sizeof(Segment);
+  }
+
+  // Create the model from the contents of a learned index meta block.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<LearnedIndex>* learned_index);
+
+  // Fits the model with a greedy "shrinking cone" pass: each segment grows
+  // until no line from its first point stays within `max_error` restart
+  // points of all the points it covers.
+  class Builder {
+   public:
+    explicit Builder(uint32_t max_error) : max_error_(max_error) {}
+
+    // REQUIRES: called with the user key of each restart point, in order.
+    void Add(const Slice& user_key);
+
+    // Encodes the model into *contents. Returns false, leaving *contents
+    // unchanged, if the model would not narrow the search enough to help,
+    // e.g. when many restart keys share their first 8 bytes.
+    bool Finish(std::string* contents);
+
+   private:
+    void FinishSegment();
+
+    const uint32_t max_error_;
+    std::vector<LearnedIndex::Segment> segments_;
+    uint32_t num_restarts_ = 0;
+    // Most consecutive restart keys sharing a prefix
+    uint32_t max_run_ = 0;
+    uint32_t run_ = 0;
+    uint64_t last_key_ = 0;
+    // Bounds on the slope of the current segment
+    double min_slope_ = 0;
+    double max_slope_ = 0;
+    bool has_max_slope_ = false;
+  };
+
+ private:
+  std::vector<Segment> segments_;
+  // How far from the predicted restart point the search has to look
+  uint32_t error_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,130 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/metadata_block_pinner.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+MetadataBlockPinner::MetadataBlockPinner(std::shared_ptr<Cache> block_cache,
+                                         size_t budget, uint32_t sample_one_in,
+                                         uint32_t rebalance_period)
+    : block_cache_(std::move(block_cache)),
+      budget_(budget),
+      sample_one_in_(sample_one_in),
+      rebalance_period_(std::max(rebalance_period, uint32_t{1})) {
+  assert(block_cache_ != nullptr);
+}
+
+MetadataBlockPinner::~MetadataBlockPinner() {
+  for (auto& table : tables_) {
+    for (auto& block : table.second) {
+      Unpin(&block.second);
+    }
+  }
+  assert(pinned_usage_ == 0);
+}
+
+void MetadataBlockPinner::Unpin(Entry* entry) {
+  if (entry->pinned != nullptr) {
+    block_cache_->Release(entry->pinned);
+    entry->pinned = nullptr;
+    pinned_usage_ -= entry->charge;
+  }
+}
+
+void MetadataBlockPinner::RecordAccess(const void* table, uint64_t offset,
+                                       Cache::Handle* handle) {
+  MutexLock l(&mutex_);
+  Entry& entry = tables_[table][offset];
+  entry.count++;
+  if (entry.pinned == nullptr) {
+    entry.charge = block_cache_->GetCharge(handle);
+    if (entry.count >= admission_threshold_ &&
+        pinned_usage_ + entry.charge <= budget_ &&
+        block_cache_->Ref(handle)) {
+      entry.pinned = handle;
+      pinned_usage_ += entry.charge;
+    }
+  }
+  if (++samples_since_rebalance_ >= rebalance_period_) {
+    samples_since_rebalance_ = 0;
+    Rebalance();
+  }
+}
+
+void MetadataBlockPinner::Rebalance() {
+  mutex_.AssertHeld();
+  // The counts and charges of the blocks, hottest first
+  std::vector<std::pair<uint64_t, size_t>> blocks;
+  for (auto& table : tables_) {
+    for (auto& block : table.second) {
+      block.second.count /= 2;
+      blocks.emplace_back(block.second.count, block.second.charge);
+    }
+  }
+  std::sort(blocks.begin(), blocks.end(),
+            std::greater<std::pair<uint64_t, size_t>>());
+
+  uint64_t threshold = std::numeric_limits<uint64_t>::max();
+  size_t usage = 0;
+  for (const auto& block : blocks) {
+    if (block.first == 0 || usage + block.second > budget_) {
+      break;
+    }
+    usage += block.second;
+    threshold = block.first;
+  }
+  if (blocks.empty() || blocks.front().first == 0) {
+    // All blocks have gone cold, any new access makes a block the hottest
+    threshold = 1;
+  }
+  admission_threshold_ = threshold;
+
+  for (auto table = tables_.begin(); table != tables_.end();) {
+    TableEntries& entries = table->second;
+    for (auto block = entries.begin(); block != entries.end();) {
+      if (block->second.count < threshold) {
+        Unpin(&block->second);
+      }
+      if (block->second.count == 0) {
+        block = entries.erase(block);
+      } else {
+        ++block;
+      }
+    }
+    if (entries.empty()) {
+      table = tables_.erase(table);
+    } else {
+      ++table;
+    }
+  }
+}
+
+void MetadataBlockPinner::EraseTable(const void* table) {
+  MutexLock l(&mutex_);
+  auto it = tables_.find(table);
+  if (it == tables_.end()) {
+    return;
+  }
+  for (auto& block : it->second) {
+    Unpin(&block.second);
+  }
+  tables_.erase(it);
+}
+
+size_t MetadataBlockPinner::GetPinnedUsage() const {
+  MutexLock l(&mutex_);
+  return pinned_usage_;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,94 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "port/port.h"
+#include "rocksdb/advanced_cache.h"
+#include "util/hash_containers.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Pins in the block cache the index and filter blocks, partitions or not,
+// that the reads of the table readers of a BlockBasedTableFactory access the
+// most, for MetadataCacheOptions::dynamic_pinning_budget. A block is pinned by
+// holding a reference to its cache entry, so it stays charged to the block
+// cache as before, and the pinned blocks take at most the budget.
+//
+// The accesses are sampled and counted per block. Every rebalance_period
+// samples, the counts are halved so that they follow the workload, the
+// blocks that no longer rank among the hottest ones fitting the budget are
+// unpinned, and the count of the coldest of those becomes the count a block
+// needs to be pinned on its next access. The rebalancing is amortized over
+// the sampled accesses, in the threads of the reads.
+//
+// Thread-safe.
+class MetadataBlockPinner {
+ public:
+  static constexpr uint32_t kDefaultSampleOneIn = 16;
+  static constexpr uint32_t kDefaultRebalancePeriod = 1024;
+
+  MetadataBlockPinner(std::shared_ptr<Cache> block_cache, size_t budget,
+                      uint32_t sample_one_in = kDefaultSampleOneIn,
+                      uint32_t rebalance_period = kDefaultRebalancePeriod);
+  ~MetadataBlockPinner();
+
+  MetadataBlockPinner(const MetadataBlockPinner&) = delete;
+  MetadataBlockPinner& operator=(const MetadataBlockPinner&) = delete;
+
+  // Counts about one in sample_one_in accesses to the metadata block at
+  // `offset` of the file of `table`, whose entry in the block cache is
+  // `handle`, and pins the block if it is hot enough
+  void MaybeRecordAccess(const void* table, uint64_t offset,
+                         Cache::Handle* handle) {
+    if (sample_one_in_ <= 1 ||
+        Random::GetTLSInstance()->OneIn(static_cast<int>(sample_one_in_))) {
+      RecordAccess(table, offset, handle);
+    }
+  }
+
+  void RecordAccess(const void* table, uint64_t offset, Cache::Handle* handle);
+
+  // Unpins the blocks of `table` and drops their counts, for a table reader
+  // being closed
+  void EraseTable(const void* table);
+
+  // The total charge of the pinned blocks
+  size_t GetPinnedUsage() const;
+
+  Cache* block_cache() const { return block_cache_.get(); }
+  size_t budget() const { return budget_; }
+
+ private:
+  struct Entry {
+    uint64_t count = 0;
+    size_t charge = 0;
+    // The reference held on the block, if pinned
+    Cache::Handle* pinned = nullptr;
+  };
+  using TableEntries = UnorderedMap<uint64_t, Entry>;
+
+  // REQUIRES: mutex_ held
+  void Rebalance();
+  void Unpin(Entry* entry);
+
+  const std::shared_ptr<Cache> block_cache_;
+  const size_t budget_;
+  const uint32_t sample_one_in_;
+  const uint32_t rebalance_period_;
+
+  mutable port::Mutex mutex_;
+  UnorderedMap<const void*, TableEntries> tables_;
+  size_t pinned_usage_ = 0;
+  // The count of an unpinned block needs to reach this to be pinned
+  uint64_t admission_threshold_ = 1;
+  uint32_t samples_since_rebalance_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "table/block_based/reader_common.h"
 
+#include <algorithm>
+
 #include "monitoring/perf_context_imp.h"
 #include "rocksdb/table.h"
 #include "table/format.h"
@@ -22,22 +24,15 @@ void ForceReleaseCachedEntry(void* arg, void* h) {
   cache->Release(handle, true /* erase_if_last_ref */);
 }
 
-// WART: this is specific to block-based table
-Status VerifyBlockChecksum(const Footer& footer, const char* data,
-                           size_t block_size, const std::string& file_name,
-                           uint64_t offset) {
-  PERF_TIMER_GUARD(block_checksum_time);
-
-  assert(footer.GetBlockTrailerSize() == 5);
+namespace {
+// Compares `computed`, the checksum of the block, with the one stored in its
+// trailer
+Status CheckBlockChecksum(const Footer& footer, const char* data,
+                          size_t block_size, const std::string& file_name,
+                          uint64_t offset, uint32_t computed) {
   ChecksumType type = footer.checksum_type();
-
-  // After block_size bytes is compression type (1 byte), which is part of
-  // the checksummed section.
-  size_t len = block_size + 1;
-  // And then the stored checksum value (4 bytes).
-  uint32_t stored = DecodeFixed32(data + len);
-
-  uint32_t computed = ComputeBuiltinChecksum(type, data, len);
+  // The stored checksum value (4 bytes) follows the compression type
+  uint32_t stored = DecodeFixed32(data + block_size + 1);
 
   // Unapply context to 'stored' rather than apply to 'computed, for people
   // who might look for reference crc value in error message
@@ -61,4 +56,46 @@ Status VerifyBlockChecksum(const Footer& footer, const char* data,
         std::to_string(offset) + " size " + std::to_string(block_size));
   }
 }
+}  // namespace
+
+// WART: this is specific to block-based table
+Status VerifyBlockChecksum(const Footer& footer, const char* data,
+                           size_t block_size, const std::string& file_name,
+                           uint64_t offset) {
+  PERF_TIMER_GUARD(block_checksum_time);
+
+  assert(footer.GetBlockTrailerSize() == 5);
+  // After block_size bytes is compression type (1 byte), which is part of
+  // the checksummed section.
+  uint32_t computed =
+      ComputeBuiltinChecksum(footer.checksum_type(), data, block_size + 1);
+  return CheckBlockChecksum(footer, data, block_size, file_name, offset,
+                            computed);
+}
+
+void VerifyBlockChecksums(const Footer& footer, size_t count,
+                          const char* const* data, const size_t* block_sizes,
+                          const uint64_t* offsets,
+                          const std::string& file_name, Status* statuses) {
+  PERF_TIMER_GUARD(block_checksum_time);
+  assert(footer.GetBlockTrailerSize() == 5);
+  // crc32c::ValueMulti() interleaves three inputs at a time
+  constexpr size_t kGroupSize = 3;
+  for (size_t i = 0; i < count; i += kGroupSize) {
+    const size_t n = std::min(kGroupSize, count - i);
+    size_t lens[kGroupSize];
+    uint32_t computed[kGroupSize];
+    for (size_t j = 0; j < n; ++j) {
+      // Including the compression type
+      lens[j] = block_sizes[i + j] + 1;
+    }
+    ComputeBuiltinChecksums(footer.checksum_type(), n, data + i, lens,
+                            computed);
+    for (size_t j = 0; j < n; ++j) {
+      statuses[i + j] =
+          CheckBlockChecksum(footer, data[i + j], block_sizes[i + j],
+                             file_name, offsets[i + j], computed[j]);
+    }
+  }
+}
 }  // namespace ROCKSDB_NAMESPACE
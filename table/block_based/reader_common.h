@@ -34,4 +34,15 @@ extern Status VerifyBlockChecksum(const Footer& footer, const char* data,
                                   size_t block_size,
                                   const std::string& file_name,
                                   uint64_t offset);
+
+// Like VerifyBlockChecksum() for `count` blocks, setting statuses[i] for
+// the block of block_sizes[i] bytes at data[i] and file offset offsets[i].
+// The checksums of the blocks are computed together, see
+// ComputeBuiltinChecksums().
+extern void VerifyBlockChecksums(const Footer& footer, size_t count,
+                                 const char* const* data,
+                                 const size_t* block_sizes,
+                                 const uint64_t* offsets,
+                                 const std::string& file_name,
+                                 Status* statuses);
 }  // namespace ROCKSDB_NAMESPACE
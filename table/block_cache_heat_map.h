@@ -0,0 +1,123 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The sampled block cache hits and misses of the table readers of one level,
+// attributed to their SST files and so to the key ranges of the files. The
+// files are kept in a fixed open-addressing table, so that recording a sample
+// takes no lock and no allocation. The samples of a file that finds no free
+// slot are counted as untracked.
+//
+// The counts are approximate: a sample racing with the Prune() of its slot
+// may be lost, and a file may take two slots after a prune, which GetCounts()
+// merges.
+class BlockCacheHeatMap {
+ public:
+  struct Counts {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  };
+
+  void Record(uint64_t file_number, bool is_cache_hit) {
+    size_t idx = SlotIndex(file_number);
+    for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+      Slot& slot = slots_[idx];
+      uint64_t cur = slot.file_number.LoadRelaxed();
+      if (cur == 0 && (slot.file_number.CasStrongRelaxed(cur, file_number) ||
+                       cur == file_number)) {
+        slot.counts.Add(is_cache_hit);
+        return;
+      }
+      if (cur == file_number) {
+        slot.counts.Add(is_cache_hit);
+        return;
+      }
+      idx = (idx + 1) % kNumSlots;
+    }
+    untracked_.Add(is_cache_hit);
+  }
+
+  // Adds the counts of each tracked file to `*files`, and the untracked
+  // samples to `*untracked`
+  void GetCounts(std::map<uint64_t, Counts>* files, Counts* untracked) const {
+    for (const auto& slot : slots_) {
+      const uint64_t file_number = slot.file_number.LoadRelaxed();
+      if (file_number != 0) {
+        Counts& counts = (*files)[file_number];
+        counts.hits += slot.counts.hits.LoadRelaxed();
+        counts.misses += slot.counts.misses.LoadRelaxed();
+      }
+    }
+    untracked->hits += untracked_.hits.LoadRelaxed();
+    untracked->misses += untracked_.misses.LoadRelaxed();
+  }
+
+  // Frees the slots of the files for which `is_live(file_number)` is false,
+  // dropping their counts. Not thread-safe with other calls of Prune() or
+  // Clear().
+  template <typename IsLive>
+  void Prune(const IsLive& is_live) {
+    for (auto& slot : slots_) {
+      const uint64_t file_number = slot.file_number.LoadRelaxed();
+      if (file_number != 0 && !is_live(file_number)) {
+        slot.counts.Clear();
+        slot.file_number.StoreRelaxed(0);
+      }
+    }
+  }
+
+  // Not thread-safe with other calls of Prune() or Clear()
+  void Clear() {
+    for (auto& slot : slots_) {
+      slot.counts.Clear();
+      slot.file_number.StoreRelaxed(0);
+    }
+    untracked_.Clear();
+  }
+
+  static constexpr size_t kNumSlots = 64;
+
+ private:
+  static constexpr size_t kMaxProbes = 8;
+
+  struct AtomicCounts {
+    RelaxedAtomic<uint64_t> hits{0};
+    RelaxedAtomic<uint64_t> misses{0};
+
+    void Add(bool is_cache_hit) {
+      (is_cache_hit ? hits : misses).FetchAddRelaxed(1);
+    }
+    void Clear() {
+      hits.StoreRelaxed(0);
+      misses.StoreRelaxed(0);
+    }
+  };
+
+  struct Slot {
+    // 0 if free, as no table file has number 0
+    RelaxedAtomic<uint64_t> file_number{0};
+    AtomicCounts counts;
+  };
+
+  static size_t SlotIndex(uint64_t file_number) {
+    // Spreads the consecutive numbers of the files of a level
+    return static_cast<size_t>((file_number * 0x9E3779B97F4A7C15ULL) >> 58) %
+           kNumSlots;
+  }
+
+  std::array<Slot, kNumSlots> slots_;
+  AtomicCounts untracked_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,67 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include "monitoring/histogram.h"
+#include "rocksdb/env.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Latency histograms of the block fetches done by the table readers of one
+// level for user reads, by operation and by whether the block was found in
+// the block cache
+struct BlockFetchHistograms {
+  enum Operation { kGet, kMultiGet, kIterator, kNumOperations };
+
+  HistogramImpl cache_hit[kNumOperations];
+  HistogramImpl cache_miss[kNumOperations];
+
+  static const char* OperationName(int op) {
+    static const char* const kNames[kNumOperations] = {"Get", "MultiGet",
+                                                       "Iterator"};
+    return kNames[op];
+  }
+
+  // Returns the histogram for a block fetch of a read with the IOActivity,
+  // or nullptr for activities other than user reads
+  HistogramImpl* ForActivity(Env::IOActivity activity, bool is_cache_hit) {
+    Operation op;
+    switch (activity) {
+      case Env::IOActivity::kGet:
+      case Env::IOActivity::kGetEntity:
+        op = kGet;
+        break;
+      case Env::IOActivity::kMultiGet:
+      case Env::IOActivity::kMultiGetEntity:
+        op = kMultiGet;
+        break;
+      case Env::IOActivity::kDBIterator:
+        op = kIterator;
+        break;
+      default:
+        return nullptr;
+    }
+    return is_cache_hit ? &cache_hit[op] : &cache_miss[op];
+  }
+
+  bool Empty() const {
+    for (int op = 0; op < kNumOperations; ++op) {
+      if (!cache_hit[op].Empty() || !cache_miss[op].Empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Clear() {
+    for (int op = 0; op < kNumOperations; ++op) {
+      cache_hit[op].Clear();
+      cache_miss[op].Clear();
+    }
+  }
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -42,6 +42,8 @@ const std::string CuckooTablePropertyNames::kUseModuleHash =
     "rocksdb.cuckoo.hash.usemodule";
 const std::string CuckooTablePropertyNames::kUserKeyLength =
     "rocksdb.cuckoo.hash.userkeylength";
+const std::string CuckooTablePropertyNames::kNumOverflowEntries =
+    "rocksdb.cuckoo.overflow.entries";
 
 // Obtained by running echo rocksdb.table.cuckoo | sha1sum
 extern const uint64_t kCuckooTableMagicNumber = 0x926789d0c5f17873ull;
@@ -69,6 +71,7 @@ CuckooTableBuilder::CuckooTableBuilder(
       value_size_(0),
       num_entries_(0),
       num_values_(0),
+      num_overflow_entries_(0),
       ucomp_(user_comparator),
       use_module_hash_(use_module_hash),
       identity_as_first_hash_(identity_as_first_hash),
@@ -100,7 +103,8 @@ void CuckooTableBuilder::Add(const Slice& key, const Slice& value) {
                                  pik_status.getState());
     return;
   }
-  if (ikey.type != kTypeDeletion && ikey.type != kTypeValue) {
+  if (ikey.type != kTypeDeletion && ikey.type != kTypeValue &&
+      ikey.type != kTypeMerge) {
     status_ = Status::NotSupported("Unsupported key type " +
                                    std::to_string(ikey.type));
     return;
@@ -121,8 +125,14 @@ void CuckooTableBuilder::Add(const Slice& key, const Slice& value) {
     status_ = Status::NotSupported("all keys have to be the same size");
     return;
   }
+  // The type is not stored in last level files, so every entry there reads
+  // back as a value.
+  if (is_last_level_file_ && ikey.type == kTypeMerge) {
+    status_ = Status::NotSupported("Merge operands need sequence numbers");
+    return;
+  }
 
-  if (ikey.type == kTypeValue) {
+  if (ikey.type != kTypeDeletion) {
     if (!has_seen_first_value_) {
       has_seen_first_value_ = true;
       value_size_ = value.size();
@@ -131,7 +141,26 @@ void CuckooTableBuilder::Add(const Slice& key, const Slice& value) {
       status_ = Status::NotSupported("all values have to be the same size");
       return;
     }
+  }
 
+  // Keys arrive in internal key order, so the first version of a user key is
+  // the newest one. Only that one goes into the hash table; older versions are
+  // kept in order for the overflow area.
+  if (!is_last_level_file_ && num_entries_ > 0 &&
+      ucomp_->Compare(ikey.user_key, last_user_key_) == 0) {
+    overflow_keys_.append(key.data(), key.size());
+    if (ikey.type != kTypeDeletion) {
+      overflow_values_.append(value.data(), value.size());
+    }
+    overflow_is_deletion_.push_back(ikey.type == kTypeDeletion);
+    ++num_overflow_entries_;
+    return;
+  }
+  if (!is_last_level_file_) {
+    last_user_key_.assign(ikey.user_key.data(), ikey.user_key.size());
+  }
+
+  if (ikey.type != kTypeDeletion) {
     if (is_last_level_file_) {
       kvs_.append(ikey.user_key.data(), ikey.user_key.size());
     } else {
@@ -308,8 +337,13 @@ Status CuckooTableBuilder::Finish() {
       AppendInternalKey(&unused_bucket, ikey);
     }
   }
-  properties_.num_entries = num_entries_;
-  properties_.num_deletions = num_entries_ - num_values_;
+  uint64_t num_overflow_deletions = 0;
+  for (bool is_deletion : overflow_is_deletion_) {
+    num_overflow_deletions += is_deletion ? 1 : 0;
+  }
+  properties_.num_entries = NumEntries();
+  properties_.num_deletions =
+      num_entries_ - num_values_ + num_overflow_deletions;
   properties_.fixed_key_len = key_size_;
   properties_.user_collected_properties[CuckooTablePropertyNames::kValueLength]
       .assign(reinterpret_cast<const char*>(&value_size_), sizeof(value_size_));
@@ -335,11 +369,32 @@ Status CuckooTableBuilder::Finish() {
       return status_;
     }
   }
+  // Older versions follow the hash table, in the order they were added.
+  size_t value_pos = 0;
+  for (size_t i = 0; i < num_overflow_entries_; ++i) {
+    ++num_added;
+    io_status_ = file_->Append(
+        Slice(&overflow_keys_[static_cast<size_t>(i * key_size_)],
+              static_cast<size_t>(key_size_)));
+    if (io_status_.ok() && value_size_ > 0) {
+      if (overflow_is_deletion_[i]) {
+        io_status_ = file_->Append(GetValue(num_values_));
+      } else {
+        io_status_ = file_->Append(Slice(&overflow_values_[value_pos],
+                                         static_cast<size_t>(value_size_)));
+        value_pos += static_cast<size_t>(value_size_);
+      }
+    }
+    if (!io_status_.ok()) {
+      status_ = io_status_;
+      return status_;
+    }
+  }
   assert(num_added == NumEntries());
   properties_.raw_key_size = num_added * properties_.fixed_key_len;
   properties_.raw_value_size = num_added * value_size_;
 
-  uint64_t offset = buckets.size() * bucket_size;
+  uint64_t offset = (buckets.size() + num_overflow_entries_) * bucket_size;
   properties_.data_size = offset;
   unused_bucket.resize(static_cast<size_t>(properties_.fixed_key_len));
   properties_.user_collected_properties[CuckooTablePropertyNames::kEmptyKey] =
@@ -371,6 +426,13 @@ Status CuckooTableBuilder::Finish() {
       .user_collected_properties[CuckooTablePropertyNames::kUserKeyLength]
       .assign(reinterpret_cast<const char*>(&user_key_len),
               sizeof(user_key_len));
+  if (num_overflow_entries_ > 0) {
+    properties_
+        .user_collected_properties
+            [CuckooTablePropertyNames::kNumOverflowEntries]
+        .assign(reinterpret_cast<const char*>(&num_overflow_entries_),
+                sizeof(num_overflow_entries_));
+  }
 
   // Write meta blocks.
   MetaIndexBuilder meta_index_builder;
@@ -418,7 +480,9 @@ void CuckooTableBuilder::Abandon() {
   closed_ = true;
 }
 
-uint64_t CuckooTableBuilder::NumEntries() const { return num_entries_; }
+uint64_t CuckooTableBuilder::NumEntries() const {
+  return num_entries_ + num_overflow_entries_;
+}
 
 uint64_t CuckooTableBuilder::FileSize() const {
   if (closed_) {
@@ -427,9 +491,12 @@ uint64_t CuckooTableBuilder::FileSize() const {
     return 0;
   }
 
+  const uint64_t overflow_size =
+      (key_size_ + value_size_) * num_overflow_entries_;
   if (use_module_hash_) {
     return static_cast<uint64_t>((key_size_ + value_size_) * num_entries_ /
-                                 max_hash_table_ratio_);
+                                 max_hash_table_ratio_) +
+           overflow_size;
   } else {
     // Account for buckets being a power of two.
     // As elements are added, file size remains constant for a while and
@@ -440,7 +507,8 @@ uint64_t CuckooTableBuilder::FileSize() const {
     if (expected_hash_table_size < (num_entries_ + 1) / max_hash_table_ratio_) {
       expected_hash_table_size *= 2;
     }
-    return (key_size_ + value_size_) * expected_hash_table_size - 1;
+    return (key_size_ + value_size_) * expected_hash_table_size - 1 +
+           overflow_size;
   }
 }
 
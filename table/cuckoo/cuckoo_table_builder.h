@@ -118,6 +118,15 @@ class CuckooTableBuilder : public TableBuilder {
   uint64_t num_entries_;
   // Number of keys that contain value (non-deletion op)
   uint64_t num_values_;
+  // Older versions of user keys already in the hash table, in the order they
+  // were added. Their keys are fixed-size and concatenated; values are kept
+  // only for non-deletions.
+  std::string overflow_keys_;
+  std::string overflow_values_;
+  std::vector<bool> overflow_is_deletion_;
+  uint64_t num_overflow_entries_;
+  // User key of the last entry added to the hash table
+  std::string last_user_key_;
   Status status_;
   IOStatus io_status_;
   TableProperties properties_;
@@ -51,6 +51,7 @@ CuckooTableReader::CuckooTableReader(
       cuckoo_block_size_(0),
       cuckoo_block_bytes_minus_one_(0),
       table_size_(0),
+      num_overflow_entries_(0),
       ucomp_(comparator),
       get_slice_hash_(get_slice_hash) {
   if (!ioptions.allow_mmap_reads) {
@@ -143,6 +144,12 @@ CuckooTableReader::CuckooTableReader(
   cuckoo_block_size_ =
       *reinterpret_cast<const uint32_t*>(cuckoo_block_size->second.data());
   cuckoo_block_bytes_minus_one_ = cuckoo_block_size_ * bucket_length_ - 1;
+  auto num_overflow_entries =
+      user_props.find(CuckooTablePropertyNames::kNumOverflowEntries);
+  if (num_overflow_entries != user_props.end()) {
+    num_overflow_entries_ = *reinterpret_cast<const uint64_t*>(
+        num_overflow_entries->second.data());
+  }
   // TODO: rate limit reads of whole cuckoo tables.
   status_ = file_->Read(IOOptions(), 0, static_cast<size_t>(file_size),
                         &file_data_, nullptr, nullptr);
@@ -185,10 +192,18 @@ Status CuckooTableReader::Get(const ReadOptions& /*readOptions*/,
           if (!s.ok()) {
             return s;
           }
-          bool dont_care __attribute__((__unused__));
-          get_context->SaveValue(found_ikey, value, &dont_care);
+          // Skip versions newer than the snapshot, and carry on past merge
+          // operands, with the older versions.
+          if (found_ikey.sequence <= GetInternalKeySeqno(key)) {
+            bool dont_care __attribute__((__unused__));
+            if (!get_context->SaveValue(found_ikey, value, &dont_care)) {
+              return Status::OK();
+            }
+          }
+          if (num_overflow_entries_ > 0) {
+            return GetOverflow(key, get_context);
+          }
         }
-        // We don't support merge operations. So, we return here.
         return Status::OK();
       }
     }
@@ -196,6 +211,50 @@ Status CuckooTableReader::Get(const ReadOptions& /*readOptions*/,
   return Status::OK();
 }
 
+Status CuckooTableReader::GetOverflow(const Slice& key,
+                                      GetContext* get_context) {
+  Slice user_key = ExtractUserKey(key);
+  const SequenceNumber seq = GetInternalKeySeqno(key);
+  const char* overflow =
+      file_data_.data() +
+      (table_size_ + cuckoo_block_size_ - 1) * bucket_length_;
+  // Find the first, that is newest, older version of user_key.
+  uint64_t left = 0;
+  uint64_t right = num_overflow_entries_;
+  while (left < right) {
+    uint64_t mid = left + (right - left) / 2;
+    if (ucomp_->Compare(Slice(overflow + mid * bucket_length_,
+                              user_key_length_),
+                        user_key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  for (const char* bucket = overflow + left * bucket_length_;
+       left < num_overflow_entries_; ++left, bucket += bucket_length_) {
+    if (!ucomp_->Equal(user_key, Slice(bucket, user_key_length_))) {
+      break;
+    }
+    ParsedInternalKey found_ikey;
+    Status s = ParseInternalKey(Slice(bucket, key_length_), &found_ikey,
+                                false /* log_err_key */);
+    if (!s.ok()) {
+      return s;
+    }
+    if (found_ikey.sequence > seq) {
+      continue;
+    }
+    bool dont_care __attribute__((__unused__));
+    if (!get_context->SaveValue(found_ikey,
+                                Slice(bucket + key_length_, value_length_),
+                                &dont_care)) {
+      break;
+    }
+  }
+  return Status::OK();
+}
+
 void CuckooTableReader::Prepare(const Slice& key) {
   // Prefetch the first Cuckoo Block.
   Slice user_key = ExtractUserKey(key);
@@ -230,23 +289,33 @@ class CuckooTableIterator : public InternalIterator {
 
  private:
   struct BucketComparator {
+    // Orders internal keys of the same user key by their trailer, newest
+    // first, unless only user keys are stored.
     BucketComparator(const Slice& file_data, const Comparator* ucomp,
                      uint32_t bucket_len, uint32_t user_key_len,
-                     const Slice& target = Slice())
+                     bool has_seq_no, const Slice& target = Slice())
         : file_data_(file_data),
           ucomp_(ucomp),
           bucket_len_(bucket_len),
           user_key_len_(user_key_len),
+          has_seq_no_(has_seq_no),
           target_(target) {}
     bool operator()(const uint32_t first, const uint32_t second) const {
-      const char* first_bucket = (first == kInvalidIndex)
-                                     ? target_.data()
-                                     : &file_data_.data()[first * bucket_len_];
+      const char* first_bucket =
+          (first == kInvalidIndex)
+              ? target_.data()
+              : &file_data_.data()[static_cast<uint64_t>(first) * bucket_len_];
       const char* second_bucket =
-          (second == kInvalidIndex) ? target_.data()
-                                    : &file_data_.data()[second * bucket_len_];
-      return ucomp_->Compare(Slice(first_bucket, user_key_len_),
-                             Slice(second_bucket, user_key_len_)) < 0;
+          (second == kInvalidIndex)
+              ? target_.data()
+              : &file_data_.data()[static_cast<uint64_t>(second) * bucket_len_];
+      int cmp = ucomp_->Compare(Slice(first_bucket, user_key_len_),
+                                Slice(second_bucket, user_key_len_));
+      if (cmp == 0 && has_seq_no_) {
+        return DecodeFixed64(first_bucket + user_key_len_) >
+               DecodeFixed64(second_bucket + user_key_len_);
+      }
+      return cmp < 0;
     }
 
    private:
@@ -254,6 +323,7 @@ class CuckooTableIterator : public InternalIterator {
     const Comparator* ucomp_;
     const uint32_t bucket_len_;
     const uint32_t user_key_len_;
+    const bool has_seq_no_;
     const Slice target_;
   };
 
@@ -271,7 +341,8 @@ class CuckooTableIterator : public InternalIterator {
 
 CuckooTableIterator::CuckooTableIterator(CuckooTableReader* reader)
     : bucket_comparator_(reader->file_data_, reader->ucomp_,
-                         reader->bucket_length_, reader->user_key_length_),
+                         reader->bucket_length_, reader->user_key_length_,
+                         !reader->is_last_level_),
       reader_(reader),
       initialized_(false),
       curr_key_idx_(kInvalidIndex) {
@@ -287,7 +358,7 @@ void CuckooTableIterator::InitIfNeeded() {
   sorted_bucket_ids_.reserve(
       static_cast<size_t>(reader_->GetTableProperties()->num_entries));
   uint64_t num_buckets = reader_->table_size_ + reader_->cuckoo_block_size_ - 1;
-  assert(num_buckets < kInvalidIndex);
+  assert(num_buckets + reader_->num_overflow_entries_ < kInvalidIndex);
   const char* bucket = reader_->file_data_.data();
   for (uint32_t bucket_id = 0; bucket_id < num_buckets; ++bucket_id) {
     if (Slice(bucket, reader_->key_length_) != Slice(reader_->unused_key_)) {
@@ -295,6 +366,9 @@ void CuckooTableIterator::InitIfNeeded() {
     }
     bucket += reader_->bucket_length_;
   }
+  for (uint64_t i = 0; i < reader_->num_overflow_entries_; ++i) {
+    sorted_bucket_ids_.push_back(static_cast<uint32_t>(num_buckets + i));
+  }
   assert(sorted_bucket_ids_.size() ==
          reader_->GetTableProperties()->num_entries);
   std::sort(sorted_bucket_ids_.begin(), sorted_bucket_ids_.end(),
@@ -319,7 +393,8 @@ void CuckooTableIterator::Seek(const Slice& target) {
   InitIfNeeded();
   const BucketComparator seek_comparator(
       reader_->file_data_, reader_->ucomp_, reader_->bucket_length_,
-      reader_->user_key_length_, ExtractUserKey(target));
+      reader_->user_key_length_, !reader_->is_last_level_,
+      reader_->is_last_level_ ? ExtractUserKey(target) : target);
   auto seek_it =
       std::lower_bound(sorted_bucket_ids_.begin(), sorted_bucket_ids_.end(),
                        kInvalidIndex, seek_comparator);
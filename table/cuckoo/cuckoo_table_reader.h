@@ -76,6 +76,9 @@ class CuckooTableReader : public TableReader {
  private:
   friend class CuckooTableIterator;
   void LoadAllKeys(std::vector<std::pair<Slice, uint32_t>>* key_to_bucket_id);
+  // Continues a lookup of internal key `key` with the older versions of its
+  // user key, if any.
+  Status GetOverflow(const Slice& key, GetContext* get_context);
   std::unique_ptr<RandomAccessFileReader> file_;
   Slice file_data_;
   bool is_last_level_;
@@ -92,6 +95,9 @@ class CuckooTableReader : public TableReader {
   uint32_t cuckoo_block_size_;
   uint32_t cuckoo_block_bytes_minus_one_;
   uint64_t table_size_;
+  // Older versions follow the hash table, see
+  // CuckooTablePropertyNames::kNumOverflowEntries.
+  uint64_t num_overflow_entries_;
   const Comparator* ucomp_;
   uint64_t (*get_slice_hash_)(const Slice& s, uint32_t index,
                               uint64_t max_num_buckets);
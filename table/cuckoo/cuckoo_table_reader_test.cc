@@ -311,6 +311,49 @@ TEST_F(CuckooReaderTest, CheckIteratorUint64) {
   CheckIterator(test::Uint64Comparator());
 }
 
+TEST_F(CuckooReaderTest, WhenKeyHasOlderVersions) {
+  const uint32_t kNumVersions = 3;
+  SetUp(4 * kNumVersions);
+  fname = test::PerThreadDBPath("CuckooReader_WhenKeyHasOlderVersions");
+  for (uint64_t i = 0; i < num_items; i++) {
+    user_keys[i] = "key" + NumToStr(i / kNumVersions);
+    // Newest version first, as in internal key order.
+    ParsedInternalKey ikey(user_keys[i], 1000 + kNumVersions - i % kNumVersions,
+                           kTypeValue);
+    AppendInternalKey(&keys[i], ikey);
+    values[i] = "value" + NumToStr(i);
+    AddHashLookups(user_keys[i], i / kNumVersions, kNumHashFunc);
+  }
+  // Each lookup reads as of the sequence number of its key.
+  CreateCuckooFileAndCheckReader();
+  CheckIterator();
+
+  std::unique_ptr<RandomAccessFileReader> file_reader;
+  ASSERT_OK(RandomAccessFileReader::Create(
+      env->GetFileSystem(), fname, file_options, &file_reader, nullptr));
+  const ImmutableOptions ioptions(options);
+  CuckooTableReader reader(ioptions, std::move(file_reader), file_size,
+                           BytewiseComparator(), GetSliceHash);
+  ASSERT_OK(reader.status());
+  const std::string& num_overflow_entries =
+      reader.GetTableProperties()->user_collected_properties.at(
+          CuckooTablePropertyNames::kNumOverflowEntries);
+  ASSERT_EQ(num_items / kNumVersions * (kNumVersions - 1),
+            *reinterpret_cast<const uint64_t*>(num_overflow_entries.data()));
+
+  // Nothing is visible before the oldest version.
+  std::string lookup_key;
+  AppendInternalKey(&lookup_key,
+                    ParsedInternalKey(user_keys[0], 1000, kTypeValue));
+  PinnableSlice value;
+  GetContext get_context(BytewiseComparator(), nullptr, nullptr, nullptr,
+                         GetContext::kNotFound, Slice(user_keys[0]), &value,
+                         nullptr, nullptr, nullptr, nullptr, true, nullptr,
+                         nullptr);
+  ASSERT_OK(reader.Get(ReadOptions(), lookup_key, &get_context, nullptr));
+  ASSERT_EQ(GetContext::kNotFound, get_context.State());
+}
+
 TEST_F(CuckooReaderTest, WhenKeyNotFound) {
   // Add keys with colliding hash values.
   SetUp(kNumHashFunc);
@@ -591,6 +591,22 @@ uint32_t ComputeBuiltinChecksum(ChecksumType type, const char* data,
   }
 }
 
+void ComputeBuiltinChecksums(ChecksumType type, size_t count,
+                             const char* const* data, const size_t* sizes,
+                             uint32_t* checksums) {
+  if (type == kCRC32c) {
+    crc32c::ValueMulti(data, sizes, count, checksums);
+    for (size_t i = 0; i < count; ++i) {
+      checksums[i] = crc32c::Mask(checksums[i]);
+    }
+    return;
+  }
+  // The xxHash functions have no such form, each input is hashed in turn
+  for (size_t i = 0; i < count; ++i) {
+    checksums[i] = ComputeBuiltinChecksum(type, data[i], sizes[i]);
+  }
+}
+
 uint32_t ComputeBuiltinChecksumWithLastByte(ChecksumType type, const char* data,
                                             size_t data_size, char last_byte) {
   switch (type) {
@@ -309,6 +309,13 @@ uint32_t ComputeBuiltinChecksum(ChecksumType type, const char* data,
 uint32_t ComputeBuiltinChecksumWithLastByte(ChecksumType type, const char* data,
                                             size_t size, char last_byte);
 
+// Sets checksums[i] to ComputeBuiltinChecksum(type, data[i], sizes[i]) for
+// each i < count. With kCRC32c, the checksums are computed together, see
+// crc32c::ValueMulti().
+void ComputeBuiltinChecksums(ChecksumType type, size_t count,
+                             const char* const* data, const size_t* sizes,
+                             uint32_t* checksums);
+
 // Represents the contents of a block read from an SST file. Depending on how
 // it's created, it may or may not own the actual block bytes. As an example,
 // BlockContents objects representing data read from mmapped files only point
@@ -7,6 +7,7 @@
 
 #include "db/blob//blob_fetcher.h"
 #include "db/merge_helper.h"
+#include "db/merge_result_cache.h"
 #include "db/pinned_iterators_manager.h"
 #include "db/read_callback.h"
 #include "db/wide/wide_column_serialization.h"
@@ -449,6 +450,16 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
 
       case kTypeMerge:
         assert(state_ == kNotFound || state_ == kMerge);
+        if (state_ == kNotFound && merge_result_cache_ != nullptr) {
+          assert(pinnable_val_ != nullptr && do_merge_);
+          if (merge_result_cache_->Lookup(parsed_key.user_key,
+                                          parsed_key.sequence, pinnable_val_,
+                                          statistics_)) {
+            state_ = kFound;
+            return false;
+          }
+          merge_result_seq_ = parsed_key.sequence;
+        }
         state_ = kMerge;
         // value_pinner is not set from plain_table_reader.cc for example.
         push_operand(value, value_pinner);
@@ -485,6 +496,14 @@ void GetContext::PostprocessMerge(const Status& merge_status) {
 
   if (LIKELY(pinnable_val_ != nullptr)) {
     pinnable_val_->PinSelf();
+    CacheMergeResult(*pinnable_val_);
+  }
+}
+
+void GetContext::CacheMergeResult(const Slice& result) {
+  if (merge_result_cache_ != nullptr &&
+      merge_result_seq_ != kMaxSequenceNumber) {
+    merge_result_cache_->Insert(user_key_, merge_result_seq_, result);
   }
 }
 
@@ -14,6 +14,7 @@ class BlobFetcher;
 class Comparator;
 class Logger;
 class MergeContext;
+class MergeResultCache;
 class MergeOperator;
 class PinnableWideColumns;
 class PinnedIteratorsManager;
@@ -164,6 +165,19 @@ class GetContext {
   // another GetContext with replayGetContextLog.
   void SetReplayLog(std::string* replay_log) { replay_log_ = replay_log; }
 
+  // If a non-null cache is passed, the result of merging the operands of the
+  // key is looked up in it when the newest operand is found, before reading
+  // the older ones, and inserted into it otherwise. Only for lookups of a
+  // plain value, without a ReadCallback, whose operands are all in table
+  // files.
+  void SetMergeResultCache(MergeResultCache* merge_result_cache) {
+    merge_result_cache_ = merge_result_cache;
+  }
+
+  // Inserts `result` of merging the operands into the merge result cache, if
+  // one is set and the newest operand was found by this GetContext
+  void CacheMergeResult(const Slice& result);
+
   // Do we need to fetch the SequenceNumber for this key?
   bool NeedToReadSequence() const { return (seq_ != nullptr); }
 
@@ -245,6 +259,9 @@ class GetContext {
   // Get or a MultiGet.
   const uint64_t tracing_get_id_;
   BlobFetcher* blob_fetcher_;
+  MergeResultCache* merge_result_cache_ = nullptr;
+  // Sequence number of the newest merge operand, if found by this GetContext
+  SequenceNumber merge_result_seq_ = kMaxSequenceNumber;
 };
 
 // Call this to replay a log and bring the get_context up to date. The replay
@@ -25,6 +25,19 @@ enum class IterBoundCheck : char {
   kInbound,
 };
 
+// Tells an iterator over a sorted run whether the range tombstones of newer
+// sorted runs delete all of its keys in a user key range, so that it can move
+// forward past them without reading them.
+class CoveredRangeChecker {
+ public:
+  virtual ~CoveredRangeChecker() {}
+
+  // Returns true if all keys of the sorted run with a user key in
+  // [`smallest_user_key`, `largest_user_key`] are deleted.
+  virtual bool IsCovered(const Slice& smallest_user_key,
+                         const Slice& largest_user_key) const = 0;
+};
+
 struct IterateResult {
   Slice key;
   IterBoundCheck bound_check_result = IterBoundCheck::kUnknown;
@@ -204,6 +217,13 @@ class InternalIteratorBase : public Cleanable {
   // used by MergingIterator and LevelIterator for now.
   virtual bool IsDeleteRangeSentinelKey() const { return false; }
 
+  // Set by MergingIterator on the iterators of sorted runs older than others
+  // with range tombstones. Iterators of files and levels may then skip the
+  // data blocks and files that `checker` reports as covered when moving
+  // forward. `checker` must outlive this iterator. Default implementation is
+  // no-op.
+  virtual void SetCoveredRangeChecker(CoveredRangeChecker* /*checker*/) {}
+
  protected:
   void SeekForPrevImpl(const Slice& target, const CompareInterface* cmp) {
     Seek(target);
@@ -121,6 +121,16 @@ class MergingIterator : public InternalIterator {
         // TruncatedRangeDelIterator::start_key()/end_key()).
         pinned_heap_item_[i].tombstone_pik.type = kTypeMaxValid;
       }
+      if (comparator_->user_comparator()->timestamp_size() == 0) {
+        covered_range_checkers_.reserve(children_.size());
+        for (size_t i = 0; i < children_.size(); ++i) {
+          covered_range_checkers_.emplace_back(this, i);
+          if (i > 0) {
+            children_[i].iter.iter()->SetCoveredRangeChecker(
+                &covered_range_checkers_[i]);
+          }
+        }
+      }
     }
   }
 
@@ -558,9 +568,101 @@ class MergingIterator : public InternalIterator {
     const InternalKeyComparator* comparator_;
   };
 
-  using MergerMinIterHeap = BinaryHeap<HeapItem*, MinHeapItemComparator>;
+  // Up to this many children, the min heap is a SortedArrayHeap, which takes
+  // fewer key comparisons than a BinaryHeap for so few elements
+  static constexpr size_t kMaxChildrenForSortedHeap = 8;
+
+  // A BinaryHeap or a SortedArrayHeap, depending on the number of children.
+  // The choice is made each time the heap is cleared.
+  class MergerMinIterHeap {
+   public:
+    explicit MergerMinIterHeap(const MinHeapItemComparator& cmp)
+        : binary_heap_(cmp), sorted_heap_(cmp) {}
+
+    void set_use_sorted(bool use_sorted) {
+      assert(empty());
+      use_sorted_ = use_sorted;
+    }
+
+    void push(HeapItem* item) {
+      if (use_sorted_) {
+        sorted_heap_.push(item);
+      } else {
+        binary_heap_.push(item);
+      }
+    }
+
+    HeapItem* top() const {
+      return use_sorted_ ? sorted_heap_.top() : binary_heap_.top();
+    }
+
+    void replace_top(HeapItem* item) {
+      if (use_sorted_) {
+        sorted_heap_.replace_top(item);
+      } else {
+        binary_heap_.replace_top(item);
+      }
+    }
+
+    void pop() {
+      if (use_sorted_) {
+        sorted_heap_.pop();
+      } else {
+        binary_heap_.pop();
+      }
+    }
+
+    void clear() {
+      sorted_heap_.clear();
+      binary_heap_.clear();
+    }
+
+    bool empty() const {
+      return use_sorted_ ? sorted_heap_.empty() : binary_heap_.empty();
+    }
+
+   private:
+    BinaryHeap<HeapItem*, MinHeapItemComparator> binary_heap_;
+    SortedArrayHeap<HeapItem*, MinHeapItemComparator> sorted_heap_;
+    bool use_sorted_ = false;
+  };
   using MergerMaxIterHeap = BinaryHeap<HeapItem*, MaxHeapItemComparator>;
 
+  // Checks the keys of children_[level] against the range tombstones of the
+  // newer sorted runs, those of the lower levels. Each range tombstone
+  // iterator is positioned at a range tombstone visible to the read, which
+  // deletes all keys of the older sorted runs in its range.
+  class LevelCoveredRangeChecker : public CoveredRangeChecker {
+   public:
+    LevelCoveredRangeChecker(MergingIterator* merging_iter, size_t level)
+        : merging_iter_(merging_iter), level_(level) {}
+
+    bool IsCovered(const Slice& smallest_user_key,
+                   const Slice& largest_user_key) const override {
+      const Comparator* ucmp = merging_iter_->comparator_->user_comparator();
+      for (size_t i = 0; i < level_; ++i) {
+        TruncatedRangeDelIterator* iter =
+            merging_iter_->range_tombstone_iters_[i];
+        if (iter == nullptr || !iter->Valid()) {
+          continue;
+        }
+        // A start key truncated at a file boundary does not cover the whole
+        // user key, and the end key is exclusive
+        const ParsedInternalKey start = iter->start_key();
+        const int cmp = ucmp->Compare(start.user_key, smallest_user_key);
+        if ((cmp < 0 || (cmp == 0 && start.sequence == kMaxSequenceNumber)) &&
+            ucmp->Compare(largest_user_key, iter->end_key().user_key) < 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+   private:
+    MergingIterator* merging_iter_;
+    size_t level_;
+  };
+
   friend class MergeIteratorBuilder;
   // Clears heaps for both directions, used when changing direction or seeking
   void ClearHeaps(bool clear_active = true);
@@ -628,6 +730,10 @@ class MergingIterator : public InternalIterator {
   // and pinned_heap_item_[i].type == DELETE_RANGE_END.
   std::set<size_t> active_;
 
+  // covered_range_checkers_[i] is set on children_[i] for i > 0 when range
+  // tombstones are handled, see LevelCoveredRangeChecker.
+  std::vector<LevelCoveredRangeChecker> covered_range_checkers_;
+
   bool SkipNextDeleted();
 
   bool SkipPrevDeleted();
@@ -641,7 +747,7 @@ class MergingIterator : public InternalIterator {
   // If any of the children have non-ok status, this is one of them.
   Status status_;
   // Invariant: min heap property is maintained (parent is always <= child).
-  // This holds by using only BinaryHeap APIs to modify heap. One
+  // This holds by using only MergerMinIterHeap APIs to modify heap. One
   // exception is to modify heap top item directly (by caller iter->Next()), and
   // it should be followed by a call to replace_top() or pop().
   MergerMinIterHeap minHeap_;
@@ -1426,6 +1532,7 @@ void MergingIterator::SwitchToBackward() {
 
 void MergingIterator::ClearHeaps(bool clear_active) {
   minHeap_.clear();
+  minHeap_.set_use_sorted(children_.size() <= kMaxChildrenForSortedHeap);
   if (maxHeap_) {
     maxHeap_->clear();
   }
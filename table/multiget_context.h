@@ -6,6 +6,7 @@
 #pragma once
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <string>
 
 #include "db/dbformat.h"
@@ -107,6 +108,9 @@ class MultiGetContext {
   using Mask = uint64_t;
   static_assert(MAX_BATCH_SIZE < sizeof(Mask) * 8);
 
+  // Called for each key of the batch once its result is final
+  using KeyDoneCallback = std::function<void(KeyContext*)>;
+
   MultiGetContext(autovector<KeyContext*, MAX_BATCH_SIZE>* sorted_keys,
                   size_t begin, size_t num_keys, SequenceNumber snapshot,
                   const ReadOptions& read_opts, FileSystem* fs,
@@ -151,6 +155,29 @@ class MultiGetContext {
     }
   }
 
+  void SetKeyDoneCallback(const KeyDoneCallback* callback) {
+    key_done_callback_ = callback;
+  }
+
+  // Invokes the key done callback, if any, for the keys found so far that
+  // were not reported yet. Keys pointing to a blob are skipped, as their
+  // values are only read at the end of the lookup. With `all`, every key
+  // not reported yet is, as the lookup of the batch is finished.
+  void ReportDoneKeys(bool all) {
+    if (key_done_callback_ == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < num_keys_; ++i) {
+      const Mask bit = Mask{1} << i;
+      if ((reported_mask_ & bit) ||
+          (!all && (!(value_mask_ & bit) || sorted_keys_[i]->is_blob_index))) {
+        continue;
+      }
+      reported_mask_ |= bit;
+      (*key_done_callback_)(sorted_keys_[i]);
+    }
+  }
+
 #if USE_COROUTINES
   SingleThreadExecutor& executor() { return executor_; }
 
@@ -165,6 +192,8 @@ class MultiGetContext {
   std::array<KeyContext*, MAX_BATCH_SIZE> sorted_keys_;
   size_t num_keys_;
   Mask value_mask_;
+  Mask reported_mask_ = 0;
+  const KeyDoneCallback* key_done_callback_ = nullptr;
   uint64_t value_size_;
   std::unique_ptr<char[]> lookup_key_heap_buf;
   LookupKey* lookup_key_ptr_;
@@ -24,11 +24,13 @@
 #include "table/format.h"
 #include "table/get_context.h"
 #include "table/internal_iterator.h"
+#include "table/block_fetcher.h"
 #include "table/meta_blocks.h"
 #include "table/plain/plain_table_bloom.h"
 #include "table/plain/plain_table_factory.h"
 #include "table/plain/plain_table_key_coding.h"
 #include "table/two_level_iterator.h"
+#include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/dynamic_bloom.h"
 #include "util/hash.h"
@@ -215,6 +217,7 @@ InternalIterator* PlainTableReader::NewIterator(
 Status PlainTableReader::PopulateIndexRecordList(
     PlainTableIndexBuilder* index_builder,
     std::vector<uint32_t>* prefix_hashes) {
+  TEST_SYNC_POINT("PlainTableReader::PopulateIndexRecordList");
   Slice prev_key_prefix_slice;
   std::string prev_key_prefix_buf;
   uint32_t pos = data_start_offset_;
@@ -291,6 +294,19 @@ Status PlainTableReader::MmapDataIfNeeded() {
   return Status::OK();
 }
 
+Status PlainTableReader::ReadIndexOrBloomBlock(const Footer& footer,
+                                               const ReadOptions& read_options,
+                                               const BlockHandle& handle,
+                                               BlockType block_type,
+                                               BlockContents* contents) {
+  return BlockFetcher(file_info_.file.get(), nullptr /* prefetch_buffer */,
+                      footer, read_options, handle, contents, ioptions_,
+                      false /* decompress */, false /*maybe_compressed*/,
+                      block_type, UncompressionDict::GetEmptyDict(),
+                      PersistentCacheOptions::kEmpty)
+      .ReadBlockContents();
+}
+
 Status PlainTableReader::PopulateIndex(TableProperties* props,
                                        int bloom_bits_per_key,
                                        double hash_table_ratio,
@@ -298,27 +314,51 @@ Status PlainTableReader::PopulateIndex(TableProperties* props,
                                        size_t huge_page_tlb_size) {
   assert(props != nullptr);
 
-  BlockContents index_block_contents;
-
   // TODO: plumb Env::IOActivity
   const ReadOptions read_options;
-  Status s =
-      ReadMetaBlock(file_info_.file.get(), nullptr /* prefetch_buffer */,
-                    file_size_, kPlainTableMagicNumber, ioptions_, read_options,
-                    PlainTableIndexBuilder::kPlainTableIndexBlock,
-                    BlockType::kIndex, &index_block_contents);
+  // Look up both the index and the bloom block in one read of the footer and
+  // meta index block, so that opening a file with its index stored in it
+  // costs a few small reads rather than a scan of the data.
+  Footer footer;
+  BlockContents metaindex_contents;
+  Status s = ReadMetaIndexBlockInFile(
+      file_info_.file.get(), file_size_, kPlainTableMagicNumber, ioptions_,
+      read_options, &metaindex_contents, nullptr /* memory_allocator */,
+      nullptr /* prefetch_buffer */, &footer);
+  if (!s.ok()) {
+    return s;
+  }
+  Block metaindex_block(std::move(metaindex_contents));
+  std::unique_ptr<InternalIterator> meta_iter(
+      metaindex_block.NewMetaIterator());
 
-  bool index_in_file = s.ok();
+  BlockHandle index_block_handle;
+  s = FindOptionalMetaBlock(meta_iter.get(),
+                            PlainTableIndexBuilder::kPlainTableIndexBlock,
+                            &index_block_handle);
+  if (!s.ok()) {
+    return s;
+  }
+  BlockContents index_block_contents;
+  bool index_in_file = false;
+  if (!index_block_handle.IsNull()) {
+    s = ReadIndexOrBloomBlock(footer, read_options, index_block_handle,
+                              BlockType::kIndex, &index_block_contents);
+    index_in_file = s.ok();
+  }
 
   BlockContents bloom_block_contents;
   bool bloom_in_file = false;
   // We only need to read the bloom block if index block is in file.
   if (index_in_file) {
-    s = ReadMetaBlock(file_info_.file.get(), nullptr /* prefetch_buffer */,
-                      file_size_, kPlainTableMagicNumber, ioptions_,
-                      read_options, BloomBlockBuilder::kBloomBlock,
-                      BlockType::kFilter, &bloom_block_contents);
-    bloom_in_file = s.ok() && bloom_block_contents.data.size() > 0;
+    BlockHandle bloom_block_handle;
+    s = FindOptionalMetaBlock(meta_iter.get(), BloomBlockBuilder::kBloomBlock,
+                              &bloom_block_handle);
+    if (s.ok() && !bloom_block_handle.IsNull()) {
+      s = ReadIndexOrBloomBlock(footer, read_options, bloom_block_handle,
+                                BlockType::kFilter, &bloom_block_contents);
+      bloom_in_file = s.ok() && bloom_block_contents.data.size() > 0;
+    }
   }
 
   Slice* bloom_block;
@@ -139,6 +139,12 @@ class PlainTableReader : public TableReader {
   Status MmapDataIfNeeded();
 
  private:
+  // Reads the index or bloom block stored in the file at `handle`
+  Status ReadIndexOrBloomBlock(const Footer& footer,
+                               const ReadOptions& read_options,
+                               const BlockHandle& handle, BlockType block_type,
+                               BlockContents* contents);
+
   const InternalKeyComparator internal_comparator_;
   EncodingType encoding_type_;
   // represents plain table's current status.
@@ -211,6 +211,28 @@ Status SstFileDumper::VerifyChecksum() {
                                        TableReaderCaller::kSSTDumpTool);
 }
 
+Status SstFileDumper::GetSplitKeys(uint64_t split_bytes,
+                                   std::vector<std::string>* split_keys) {
+  if (!table_reader_) {
+    return init_result_;
+  }
+  std::vector<TableReader::Anchor> anchors;
+  Status s = table_reader_->ApproximateKeyAnchors(read_options_, anchors);
+  if (!s.ok()) {
+    return s;
+  }
+  uint64_t range_size = 0;
+  // The last anchor is the last key of the file
+  for (size_t i = 0; i + 1 < anchors.size(); i++) {
+    range_size += anchors[i].range_size;
+    if (range_size >= split_bytes) {
+      split_keys->push_back(anchors[i].user_key);
+      range_size = 0;
+    }
+  }
+  return Status::OK();
+}
+
 Status SstFileDumper::DumpTable(const std::string& out_filename) {
   std::unique_ptr<WritableFile> out_file;
   Env* env = options_.env;
@@ -508,11 +530,14 @@ Status SstFileDumper::ReadSequential(bool print_kv, uint64_t read_num,
 
     // the key returned is not prefixed with out 'from' key
     if (use_from_as_prefix && !ikey.user_key.starts_with(from_key)) {
+      // Not read, so that the entries of adjacent ranges add up
+      --i;
       break;
     }
 
     // If end marker was specified, we stop before it
     if (to.has_value() && ucmp->Compare(ikey.user_key, to.value()) >= 0) {
+      --i;
       break;
     }
 
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "db/dbformat.h"
 #include "file/writable_file_writer.h"
@@ -34,6 +35,10 @@ class SstFileDumper {
   TableProperties* GetInitTableProperties() { return table_properties_.get(); }
 
   Status VerifyChecksum();
+  // Sets `*split_keys` to the user keys splitting the file into ranges of
+  // about `split_bytes` of data blocks, per the index of the file
+  Status GetSplitKeys(uint64_t split_bytes,
+                      std::vector<std::string>* split_keys);
   Status DumpTable(const std::string& out_filename);
   Status getStatus() { return init_result_; }
 
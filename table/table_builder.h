@@ -22,6 +22,8 @@
 #include "options/cf_options.h"
 #include "rocksdb/options.h"
 #include "rocksdb/table_properties.h"
+#include "table/block_cache_heat_map.h"
+#include "table/block_fetch_histograms.h"
 #include "table/unique_id_impl.h"
 #include "trace_replay/block_cache_tracer.h"
 
@@ -97,6 +99,14 @@ struct TableReaderOptions {
 
   // Whether the key in the table contains user-defined timestamps.
   bool user_defined_timestamps_persisted;
+
+  // If not null, the histograms of the level of the table to record the
+  // latency of its block fetches in
+  BlockFetchHistograms* block_fetch_hists = nullptr;
+
+  // If not null, the heat map of the level of the table to sample its block
+  // cache lookups in, under cur_file_num
+  BlockCacheHeatMap* block_cache_heat_map = nullptr;
 };
 
 struct TableBuilderOptions {
@@ -31,6 +31,7 @@ struct ReadOptions;
 struct TableProperties;
 class GetContext;
 class MultiGetContext;
+struct Range;
 
 // A Table (also referred to as SST) is a sorted map from strings to strings.
 // Tables are immutable and persistent.  A Table may be safely accessed from
@@ -156,6 +157,21 @@ class TableReader {
     }
   }
 
+  // Hints the file system to start reading, without waiting for them, the
+  // data blocks that the keys of `mget_range` not excluded by the filter may
+  // be in, so that the I/O of several files overlaps before MultiGet() reads
+  // the blocks. Only uses metadata already in memory and never blocks on I/O.
+  virtual void PrefetchForMultiGet(
+      const ReadOptions& /*read_options*/,
+      const MultiGetContext::Range* /*mget_range*/) {}
+
+  // Reads into the block cache, in one batch of reads, the data blocks at the
+  // start of each of `ranges` of user keys that are not in the cache yet, for
+  // the scans of a multi-range iterator, see DB::NewMultiScanIterator().
+  // `ranges` are sorted and disjoint. Errors are left to the scans.
+  virtual void PrefetchScanRanges(const ReadOptions& /*read_options*/,
+                                  const std::vector<Range>& /*ranges*/) {}
+
 #if USE_COROUTINES
   virtual folly::coro::Task<void> MultiGetCoroutine(
       const ReadOptions& readOptions, const MultiGetContext::Range* mget_range,
@@ -178,6 +194,25 @@ class TableReader {
     return Status::OK();
   }
 
+  // Load the data blocks starting at `block_offsets` (ascending, possibly
+  // rounded down to a multiple of 4) into the block cache, to warm it up.
+  // Offsets not starting a data block are ignored.
+  virtual Status PrefetchDataBlocks(
+      const ReadOptions& /* read_options */,
+      const std::vector<uint64_t>& /* block_offsets */) {
+    // Default implementation is NOOP.
+    return Status::OK();
+  }
+
+  // Load the first data blocks of the file, at least one and up to
+  // `prefetch_size` bytes, into the block cache, ahead of a scan from the
+  // start of the file.
+  virtual Status PrefetchFirstDataBlocks(const ReadOptions& /* read_options */,
+                                         size_t /* prefetch_size */) {
+    // Default implementation is NOOP.
+    return Status::OK();
+  }
+
   // convert db file to a human readable form
   virtual Status DumpTable(WritableFile* /*out_file*/) {
     return Status::NotSupported("DumpTable() not supported");
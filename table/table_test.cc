@@ -2434,6 +2434,30 @@ TEST_P(BuiltinChecksumTest, ChecksumZeroInputs) {
   }
 }
 
+TEST_P(BuiltinChecksumTest, ChecksumMultipleInputs) {
+  Random rnd(301);
+  std::vector<std::string> inputs;
+  for (size_t len : {0, 1, 7, 8, 9, 100, 4096, 4097, 20000, 3, 64}) {
+    inputs.push_back(rnd.RandomString(static_cast<int>(len)));
+  }
+  std::vector<const char*> data;
+  std::vector<size_t> sizes;
+  for (const auto& input : inputs) {
+    data.push_back(input.data());
+    sizes.push_back(input.size());
+  }
+  // Any number of inputs, not only multiples of those computed together
+  for (size_t count = 0; count <= inputs.size(); ++count) {
+    std::vector<uint32_t> checksums(count);
+    ComputeBuiltinChecksums(GetParam(), count, data.data(), sizes.data(),
+                            checksums.data());
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(checksums[i],
+                ComputeBuiltinChecksum(GetParam(), data[i], sizes[i]));
+    }
+  }
+}
+
 void AddInternalKey(TableConstructor* c, const std::string& prefix,
                     std::string value = "v", int /*suffix_len*/ = 800) {
   static Random rnd(1023);
@@ -2661,6 +2685,122 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, LearnedIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.index_type = BlockBasedTableOptions::kLearnedIndexSearch;
+  IndexTest(table_options);
+}
+
+// Seeks in tables whose keys start with 8-byte big-endian integers, checking
+// the results against kBinarySearch and that the model is only written when it
+// narrows the search down.
+TEST_P(BlockBasedTableTest, LearnedIndexSeek) {
+  const int kNumKeys = 5000;
+  auto big_endian_key = [](uint64_t n, const std::string& suffix) {
+    std::string key;
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      key.push_back(static_cast<char>((n >> shift) & 0xff));
+    }
+    return key + suffix;
+  };
+  // Returns the user key of key i, and sets *model_expected to whether the
+  // keys are different enough in their first 8 bytes to be modeled
+  std::vector<std::function<std::string(int, bool*)>> key_generators = {
+      // Evenly spread
+      [&](int i, bool* model_expected) {
+        *model_expected = true;
+        return big_endian_key(uint64_t{1000} * i, "");
+      },
+      // Unevenly spread, of different lengths
+      [&](int i, bool* model_expected) {
+        *model_expected = true;
+        return big_endian_key(
+            (uint64_t{1} << (i * 48 / kNumKeys)) * 1000 + i,
+            std::string(i % 3, 'x'));
+      },
+      // Sharing their first 8 bytes
+      [&](int i, bool* model_expected) {
+        *model_expected = false;
+        return big_endian_key(42, std::to_string(100000 + i));
+      }};
+
+  for (const auto& key_generator : key_generators) {
+    for (int restart_interval : {1, 4}) {
+      bool model_expected = false;
+      std::vector<std::string> user_keys;
+      for (int i = 0; i < kNumKeys; i++) {
+        user_keys.push_back(key_generator(i, &model_expected));
+      }
+      std::sort(user_keys.begin(), user_keys.end());
+      // Targets between and around the keys
+      std::vector<std::string> targets = user_keys;
+      for (const auto& user_key : user_keys) {
+        targets.push_back(user_key + "\x01");
+        std::string before = user_key;
+        if (!before.empty() && before.back() != 0) {
+          before.back()--;
+          targets.push_back(before);
+        }
+      }
+      targets.push_back("");
+      targets.push_back(std::string(9, '\xff'));
+
+      uint64_t index_size[2] = {0, 0};
+      for (auto index_type : {BlockBasedTableOptions::kBinarySearch,
+                              BlockBasedTableOptions::kLearnedIndexSearch}) {
+        BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+        table_options.index_type = index_type;
+        table_options.index_block_restart_interval = restart_interval;
+        // One key per data block
+        table_options.block_size = 64;
+        Options options;
+        options.compression = kNoCompression;
+        options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+        TableConstructor c(BytewiseComparator(),
+                           true /* convert_to_internal_key */);
+        for (const auto& user_key : user_keys) {
+          c.Add(user_key, std::string(100, 'v'));
+        }
+        std::vector<std::string> keys;
+        stl_wrappers::KVMap kvmap;
+        const ImmutableOptions ioptions(options);
+        const MutableCFOptions moptions(options);
+        const InternalKeyComparator comparator(BytewiseComparator());
+        c.Finish(options, ioptions, moptions, table_options, comparator, &keys,
+                 &kvmap);
+        auto reader = c.GetTableReader();
+        index_size[index_type == BlockBasedTableOptions::kLearnedIndexSearch] =
+            reader->GetTableProperties()->index_size;
+
+        std::unique_ptr<InternalIterator> iter(reader->NewIterator(
+            ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+            /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+        for (const auto& target : targets) {
+          iter->Seek(
+              InternalKey(target, kMaxSequenceNumber, kValueTypeForSeek)
+                  .Encode());
+          ASSERT_OK(iter->status());
+          auto expected =
+              std::lower_bound(user_keys.begin(), user_keys.end(), target);
+          if (expected == user_keys.end()) {
+            ASSERT_FALSE(iter->Valid());
+          } else {
+            ASSERT_TRUE(iter->Valid());
+            ASSERT_EQ(*expected, ExtractUserKey(iter->key()).ToString());
+          }
+        }
+        c.ResetTableReader();
+      }
+      if (model_expected) {
+        ASSERT_GT(index_size[1], index_size[0]);
+      } else {
+        ASSERT_EQ(index_size[1], index_size[0]);
+      }
+    }
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
@@ -2673,6 +2813,67 @@ TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   }
 }
 
+TEST_P(BlockBasedTableTest, PartitionIndexRestartInterval) {
+  const int kNumKeys = 2000;
+  Random rnd(301);
+  std::vector<std::string> user_keys;
+  for (int i = 0; i < kNumKeys; i++) {
+    user_keys.push_back("key" + std::to_string(1000000 + i) +
+                        rnd.RandomString(20));
+  }
+
+  uint64_t index_size[2] = {0, 0};
+  for (int partition_restart_interval : {0, 16}) {
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+    table_options.index_shortening =
+        BlockBasedTableOptions::IndexShorteningMode::kNoShortening;
+    table_options.index_partition_restart_interval =
+        partition_restart_interval;
+    table_options.block_size = 64;
+    table_options.metadata_block_size = 512;
+    Options options;
+    options.compression = kNoCompression;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+    TableConstructor c(BytewiseComparator(),
+                       true /* convert_to_internal_key */);
+    for (const auto& user_key : user_keys) {
+      c.Add(user_key, std::string(100, 'v'));
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+    const InternalKeyComparator comparator(BytewiseComparator());
+    c.Finish(options, ioptions, moptions, table_options, comparator, &keys,
+             &kvmap);
+    auto reader = c.GetTableReader();
+    index_size[partition_restart_interval > 0] =
+        reader->GetTableProperties()->index_size;
+
+    std::unique_ptr<InternalIterator> iter(reader->NewIterator(
+        ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+        /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+    for (const auto& kv : kvmap) {
+      iter->Seek(
+          InternalKey(kv.first, kMaxSequenceNumber, kValueTypeForSeek).Encode());
+      ASSERT_OK(iter->status());
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(kv.first, ExtractUserKey(iter->key()).ToString());
+    }
+    size_t count = 0;
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      count++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kvmap.size(), count);
+    c.ResetTableReader();
+  }
+  // Keys in a restart interval share their prefixes
+  ASSERT_LT(index_size[1], index_size[0]);
+}
+
 TEST_P(BlockBasedTableTest, IndexSeekOptimizationIncomplete) {
   std::unique_ptr<InternalKeyComparator> comparator(
       new InternalKeyComparator(BytewiseComparator()));
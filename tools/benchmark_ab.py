@@ -0,0 +1,323 @@
+#!/usr/bin/env python3
+#  Copyright (c) Meta Platforms, Inc. and affiliates.
+#  This source code is licensed under both the GPLv2 (found in the
+#  COPYING file in the root directory) and Apache 2.0 License
+#  (found in the LICENSE.Apache file in the root directory).
+
+"""Compare two db_bench builds with benchmark.sh, with confidence intervals
+
+The builds are run in repeated trials, interleaved as A B, B A, A B, ... so
+that drift of the host over time affects both alike. Each trial of a build
+loads a fresh DB and runs the tests on it. The tests can be pinned to CPUs,
+and the page cache can be dropped before each test.
+
+For each test and metric, the mean of each build is reported with its
+confidence interval, and so is the difference of the means of B and A, as a
+percent of the mean of A, with the interval of Welch's t-test. A difference
+is significant when its interval excludes zero and it is at least
+--min_diff_pct. The summary is written to summary.tsv in the output directory,
+and the exit status is 1 if a metric of B regressed significantly.
+"""
+
+import argparse
+import logging
+import math
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+
+logging.basicConfig(level=logging.INFO)
+
+# Environment variables passed on to benchmark.sh
+benchmark_env_keys = [
+    "LD_LIBRARY_PATH",
+    "NUM_KEYS",
+    "NUM_THREADS",
+    "KEY_SIZE",
+    "VALUE_SIZE",
+    "CACHE_SIZE",
+    "DURATION",
+    "MB_WRITE_PER_SEC",
+    "COMPRESSION_TYPE",
+    "MIN_LEVEL_TO_COMPRESS",
+    "WRITE_BUFFER_SIZE_MB",
+    "TARGET_FILE_SIZE_BASE_MB",
+    "MAX_BYTES_FOR_LEVEL_BASE_MB",
+    "MAX_BACKGROUND_JOBS",
+    "CACHE_INDEX_AND_FILTER_BLOCKS",
+    "USE_O_DIRECT",
+    "BYTES_PER_SYNC",
+    "STATS_INTERVAL_SECONDS",
+    "SUBCOMPACTIONS",
+]
+
+
+def cpu_usecs_per_op(row):
+    # u_cpu and s_cpu are in thousands of seconds
+    cpu_secs = (float(row["u_cpu"]) + float(row["s_cpu"])) * 1000
+    ops = float(row["ops_sec"]) * float(row["uptime"])
+    return cpu_secs * 1000000 / ops
+
+
+# (name, higher is better, value of a row of report.tsv)
+metrics = [
+    ("ops_sec", True, lambda row: float(row["ops_sec"])),
+    ("p99_usecs", False, lambda row: float(row["p99"])),
+    ("w_amp", False, lambda row: float(row["w_amp"])),
+    ("cpu_usecs_per_op", False, cpu_usecs_per_op),
+]
+
+
+def t_quantile(confidence, df):
+    """Two-sided quantile of Student's t distribution, by the Cornish-Fisher
+    expansion from the normal quantile, which is within 1% of the exact value
+    for df >= 2
+    """
+    z = statistics.NormalDist().inv_cdf(1 - (1 - confidence) / 2)
+    g1 = (z**3 + z) / 4
+    g2 = (5 * z**5 + 16 * z**3 + 3 * z) / 96
+    g3 = (3 * z**7 + 19 * z**5 + 17 * z**3 - 15 * z) / 384
+    g4 = (
+        79 * z**9 + 776 * z**7 + 1482 * z**5 - 1920 * z**3 - 945 * z
+    ) / 92160
+    return z + g1 / df + g2 / df**2 + g3 / df**3 + g4 / df**4
+
+
+def mean_interval(values, confidence):
+    """Returns the mean of values and the half width of its interval"""
+    mean = statistics.mean(values)
+    if len(values) < 2:
+        return mean, math.nan
+    sem = statistics.stdev(values) / math.sqrt(len(values))
+    return mean, t_quantile(confidence, len(values) - 1) * sem
+
+
+def diff_interval(a, b, confidence):
+    """Returns the difference of the means of b and a and the half width of its
+    interval, by Welch's t-test
+    """
+    diff = statistics.mean(b) - statistics.mean(a)
+    if len(a) < 2 or len(b) < 2:
+        return diff, math.nan
+    va = statistics.variance(a) / len(a)
+    vb = statistics.variance(b) / len(b)
+    if va + vb == 0:
+        return diff, 0.0
+    df = (va + vb) ** 2 / (va**2 / (len(a) - 1) + vb**2 / (len(b) - 1))
+    return diff, t_quantile(confidence, df) * math.sqrt(va + vb)
+
+
+def read_report(path):
+    """Returns the rows of a report.tsv of benchmark.sh by test, in order"""
+    rows = {}
+    header = None
+    with open(path, "r") as f:
+        for line in f:
+            if line.startswith("#") or not line.strip():
+                continue
+            fields = line.rstrip("\n").split("\t")
+            if header is None:
+                header = fields
+            else:
+                row = dict(zip(header, fields))
+                rows[row["test"]] = row
+    return rows
+
+
+class Build:
+    def __init__(self, label, db_bench, output_dir):
+        self.label = label
+        self.db_bench = os.path.abspath(os.path.expanduser(db_bench))
+        # benchmark.sh runs ./db_bench, so each build has its own directory
+        # to run in, with a link to its db_bench
+        self.cwd = os.path.join(output_dir, label)
+        # results[test][trial] is the row of report.tsv
+        self.results = {}
+
+    def prepare(self):
+        if not os.access(self.db_bench, os.X_OK):
+            raise Exception(f"{self.db_bench} is not executable")
+        os.makedirs(self.cwd)
+        os.symlink(self.db_bench, os.path.join(self.cwd, "db_bench"))
+
+
+def drop_caches():
+    subprocess.run(["sync"], check=True)
+    with open("/proc/sys/vm/drop_caches", "w") as f:
+        f.write("3\n")
+
+
+def run_trial(build, trial, args, script):
+    output_dir = os.path.join(build.cwd, f"trial-{trial}")
+    os.makedirs(output_dir)
+    shutil.rmtree(args.db_dir, ignore_errors=True)
+    os.makedirs(args.db_dir)
+
+    env = {key: os.environ[key] for key in benchmark_env_keys if key in os.environ}
+    env.update(
+        {
+            "PATH": os.environ.get("PATH", "/usr/bin:/bin"),
+            "DB_DIR": args.db_dir,
+            "WAL_DIR": args.db_dir,
+            "OUTPUT_DIR": output_dir,
+            "DB_BENCH_NO_SYNC": "1",
+        }
+    )
+    prefix = ["taskset", "-c", args.cpus] if args.cpus else []
+
+    for test in [args.load] + args.tests:
+        if args.drop_caches:
+            drop_caches()
+        cmd = prefix + ["bash", script, test]
+        logging.info(f"Trial {trial} of {build.label}: {' '.join(cmd)}")
+        p = subprocess.run(cmd, env=env, cwd=build.cwd)
+        if p.returncode != 0:
+            raise Exception(f"{test} of {build.label} failed: {p.returncode}")
+
+    rows = read_report(os.path.join(output_dir, "report.tsv"))
+    for test, row in rows.items():
+        build.results.setdefault(test, []).append(row)
+
+
+def values_of(rows, value):
+    values = []
+    for row in rows:
+        try:
+            values.append(value(row))
+        except (KeyError, ValueError, ZeroDivisionError):
+            # The metric is NA for the test, or the test failed
+            pass
+    return values
+
+
+def summarize(a, b, args):
+    """Writes summary.tsv and returns the number of significant regressions"""
+    header = [
+        "test",
+        "metric",
+        "n",
+        "mean_a",
+        "ci_a",
+        "mean_b",
+        "ci_b",
+        "diff_pct",
+        "ci_low_pct",
+        "ci_high_pct",
+        "verdict",
+    ]
+    lines = ["\t".join(header)]
+    regressions = 0
+    for test, rows_a in a.results.items():
+        rows_b = b.results.get(test, [])
+        for name, higher_is_better, value in metrics:
+            va = values_of(rows_a, value)
+            vb = values_of(rows_b, value)
+            if not va or not vb:
+                continue
+            mean_a, ci_a = mean_interval(va, args.confidence)
+            mean_b, ci_b = mean_interval(vb, args.confidence)
+            diff, ci_diff = diff_interval(va, vb, args.confidence)
+            if mean_a == 0:
+                continue
+            diff_pct = diff * 100 / mean_a
+            ci_pct = ci_diff * 100 / abs(mean_a)
+            low, high = diff_pct - ci_pct, diff_pct + ci_pct
+            verdict = "same"
+            if (low > 0 or high < 0) and abs(diff_pct) >= args.min_diff_pct:
+                if (diff_pct > 0) == higher_is_better:
+                    verdict = "better"
+                else:
+                    verdict = "worse"
+                    regressions += 1
+            elif math.isnan(ci_pct):
+                verdict = "unknown"
+            lines.append(
+                f"{test}\t{name}\t{min(len(va), len(vb))}\t{mean_a:.2f}\t"
+                f"{ci_a:.2f}\t{mean_b:.2f}\t{ci_b:.2f}\t{diff_pct:.2f}\t"
+                f"{low:.2f}\t{high:.2f}\t{verdict}"
+            )
+
+    summary = os.path.join(args.output_dir, "summary.tsv")
+    with open(summary, "w") as f:
+        f.write(f"# A: {a.db_bench}\n# B: {b.db_bench}\n")
+        f.write(f"# {args.trials} trials, {args.confidence:.0%} confidence\n")
+        f.write("\n".join(lines) + "\n")
+    print("\n".join(lines))
+    logging.info(f"Summary at {summary}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare two db_bench builds with confidence intervals."
+    )
+    parser.add_argument("--db_bench_a", required=True, help="Baseline db_bench")
+    parser.add_argument("--db_bench_b", required=True, help="Candidate db_bench")
+    parser.add_argument(
+        "--db_dir",
+        default="~/tmp/rocksdb-benchmark-datadir",
+        help="Database directory, removed before each trial",
+    )
+    parser.add_argument(
+        "--output_dir",
+        default="~/tmp/benchmark-ab-results",
+        help="Benchmark output goes here, must not exist",
+    )
+    parser.add_argument(
+        "--load",
+        default="fillseq_disable_wal",
+        help="benchmark.sh job loading the DB of each trial",
+    )
+    parser.add_argument(
+        "--tests",
+        default="readrandom,overwrite",
+        help="Comma separated benchmark.sh jobs run after the load",
+    )
+    parser.add_argument("--trials", type=int, default=5, help="Trials per build")
+    parser.add_argument(
+        "--cpus", default="", help="CPU list for taskset, e.g. 0-7, to pin to"
+    )
+    parser.add_argument(
+        "--drop_caches",
+        action="store_true",
+        help="Drop the page cache before each test, needs root",
+    )
+    parser.add_argument(
+        "--confidence", type=float, default=0.95, help="Confidence level"
+    )
+    parser.add_argument(
+        "--min_diff_pct",
+        type=float,
+        default=1.0,
+        help="Smallest difference in percent reported as significant",
+    )
+    args = parser.parse_args()
+    args.db_dir = os.path.expanduser(args.db_dir)
+    args.output_dir = os.path.abspath(os.path.expanduser(args.output_dir))
+    args.tests = [t for t in args.tests.split(",") if t]
+
+    if args.trials < 2:
+        raise Exception("--trials must be at least 2 for confidence intervals")
+    if not 0 < args.confidence < 1:
+        raise Exception("--confidence must be between 0 and 1")
+    if os.path.exists(args.output_dir):
+        raise Exception(f"Output directory exists: {args.output_dir}")
+
+    script = os.path.join(os.path.dirname(os.path.abspath(__file__)), "benchmark.sh")
+    a = Build("a", args.db_bench_a, args.output_dir)
+    b = Build("b", args.db_bench_b, args.output_dir)
+    a.prepare()
+    b.prepare()
+
+    for trial in range(args.trials):
+        order = [a, b] if trial % 2 == 0 else [b, a]
+        for build in order:
+            run_trial(build, trial, args, script)
+
+    return 1 if summarize(a, b, args) > 0 else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -27,8 +27,10 @@
 #ifdef __FreeBSD__
 #include <sys/sysctl.h>
 #endif
+#include <array>
 #include <atomic>
 #include <cinttypes>
+#include <cmath>
 #include <condition_variable>
 #include <cstddef>
 #include <iostream>
@@ -153,6 +155,7 @@ DEFINE_string(
     "acquireload,"
     "fillseekseq,"
     "randomtransaction,"
+    "transactioncontention,"
     "randomreplacekeys,"
     "timeseries,"
     "getmergeoperands,",
@@ -176,6 +179,9 @@ DEFINE_string(
     "sync mode\n"
     "\tfill100K      -- write N/1000 100K values in random order in"
     " async mode\n"
+    "\tmultibatchwrite -- write N values in random key order in writes"
+    " of unbalanced sizes across threads, as vectors of batches with"
+    " --use_multi_thread_write\n"
     "\tdeleteseq     -- delete N keys in sequential order\n"
     "\tdeleterandom  -- delete N keys in random order\n"
     "\treadseq       -- read N times sequentially\n"
@@ -218,6 +224,8 @@ DEFINE_string(
     "them by seeking to each key\n"
     "\trandomtransaction     -- execute N random transactions and "
     "verify correctness\n"
+    "\ttransactioncontention -- execute N transactions locking a few "
+    "hot keys\n"
     "\trandomreplacekeys     -- randomly replaces N keys by deleting "
     "the old version and putting the new version\n\n"
     "\ttimeseries            -- 1 writer generates time series data "
@@ -554,6 +562,10 @@ DEFINE_bool(universal_allow_trivial_move, false,
 DEFINE_bool(universal_incremental, false,
             "Enable incremental compactions in universal compaction.");
 
+DEFINE_bool(universal_incremental_fallback_to_full_compaction, true,
+            "Whether incremental universal compaction falls back to compacting"
+            " all sorted runs when it finds no good key range to compact.");
+
 DEFINE_int64(cache_size, 32 << 20,  // 32MB
              "Number of bytes to use as a cache of uncompressed data");
 
@@ -638,6 +650,10 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(learned_index, false,
+            "Predict index lookups with a learned model of the index "
+            "(kLearnedIndexSearch)");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -685,6 +701,12 @@ DEFINE_int32(
     "Number of keys between restart points "
     "for delta encoding of keys in index block.");
 
+DEFINE_int32(index_partition_restart_interval,
+             ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                 .index_partition_restart_interval,
+             "If positive, overrides index_block_restart_interval for "
+             "partitions of a partitioned index.");
+
 DEFINE_int32(read_amp_bytes_per_bit,
              ROCKSDB_NAMESPACE::BlockBasedTableOptions().read_amp_bytes_per_bit,
              "Number of bytes per bit to be used in block read-amp bitmap");
@@ -712,6 +734,17 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(data_block_restart_key_prefixes,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_restart_key_prefixes,
+            "Store restart key prefixes in data blocks to speed up seeks");
+
+DEFINE_bool(data_block_hash_index_entry_offsets,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_hash_index_entry_offsets,
+            "Point data block hash index buckets at entries rather than "
+            "restart intervals. Only valid with use_data_block_hash_index");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -719,6 +752,11 @@ DEFINE_int64(row_cache_size, 0,
              "Number of bytes to use as a cache of individual rows"
              " (0 = disabled).");
 
+DEFINE_bool(row_cache_by_user_key,
+            ROCKSDB_NAMESPACE::Options().row_cache_by_user_key,
+            "Cache the rows read from table files by user key, so that they "
+            "stay cached across compactions");
+
 DEFINE_int32(open_files, ROCKSDB_NAMESPACE::Options().max_open_files,
              "Maximum number of files to keep open at the same time"
              " (use default if == 0)");
@@ -728,10 +766,20 @@ DEFINE_int32(file_opening_threads,
              "If open_files is set to -1, this option set the number of "
              "threads that will be used to open files during DB::Open()");
 
+DEFINE_int32(wal_recovery_threads,
+             ROCKSDB_NAMESPACE::Options().wal_recovery_threads,
+             "Number of threads used to replay the WAL during DB::Open()");
+
 DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
 
+DEFINE_bool(compaction_async_io, false,
+            "Read ahead compaction input files asynchronously");
+
+DEFINE_bool(table_file_write_behind, false,
+            "Write table files of flushes and compactions in the background");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
@@ -885,6 +933,17 @@ DEFINE_uint64(periodic_compaction_seconds,
               "Files older than this will be picked up for compaction and"
               " rewritten to the same level");
 
+DEFINE_double(compaction_read_heat_weight,
+              ROCKSDB_NAMESPACE::Options().compaction_read_heat_weight,
+              "How much to favor compacting the levels serving the most reads."
+              " 0 disables it");
+
+DEFINE_bool(adapt_max_sequential_skip_in_iterations,
+            ROCKSDB_NAMESPACE::Options()
+                .adapt_max_sequential_skip_in_iterations,
+            "Tune the number of hidden entries iterators step over before a"
+            " reseek from the measured costs of both");
+
 DEFINE_uint64(ttl_seconds, ROCKSDB_NAMESPACE::Options().ttl, "Set options.ttl");
 
 static bool ValidateInt32Percent(const char* flagname, int32_t value) {
@@ -971,6 +1030,14 @@ DEFINE_int32(transaction_sleep, 0,
              "Max microseconds to sleep in between "
              "reading and writing a value (used in RandomTransaction only). ");
 
+DEFINE_uint64(transaction_hot_keys, 16,
+              "Number of keys the transactions lock (used in "
+              "TransactionContention only)");
+
+DEFINE_int32(transaction_shared_lock_pct, 0,
+             "Percentage of the transactions taking a shared lock rather "
+             "than writing the key (used in TransactionContention only)");
+
 DEFINE_uint64(transaction_lock_timeout, 100,
               "If using a transaction_db, specifies the lock wait timeout in"
               " milliseconds before failing a transaction waiting on a lock");
@@ -1008,6 +1075,27 @@ DEFINE_bool(use_blob_db, false, "[Stacked BlobDB] Open a BlobDB instance.");
 DEFINE_bool(use_multi_thread_write, false,
             "Open a RocksDB with multi thread write pool");
 
+DEFINE_uint64(multi_batch_write_split_bytes,
+              ROCKSDB_NAMESPACE::Options().multi_batch_write_split_bytes,
+              "With --use_multi_thread_write, WriteBatches larger than this "
+              "are split for other writers of the group to help insert. 0 "
+              "keeps them whole.");
+
+DEFINE_string(multibatchwrite_thread_entries, "",
+              "For multibatchwrite, the comma-separated mean numbers of "
+              "entries per write of the threads, given to them in turn, e.g. "
+              "1,1,1,1000 for one large writer in four. Empty for "
+              "--batch_size entries in every thread.");
+
+DEFINE_string(multibatchwrite_entries_dist, "fixed",
+              "For multibatchwrite, the distribution of the entries of a "
+              "write around the mean of its thread: fixed, uniform (from 1 "
+              "to twice the mean) or exponential.");
+
+DEFINE_int32(multibatchwrite_batch_entries, 32,
+             "For multibatchwrite with --use_multi_thread_write, the entries "
+             "of each WriteBatch of the vector of a write.");
+
 DEFINE_bool(
     blob_db_enable_gc,
     ROCKSDB_NAMESPACE::blob_db::BlobDBOptions().enable_garbage_collection,
@@ -1075,6 +1163,18 @@ DEFINE_string(blob_compression_type, "none",
               "[Integrated BlobDB] The compression algorithm to use for large "
               "values stored in blob files.");
 
+DEFINE_bool(adaptive_min_blob_size,
+            ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                .adaptive_min_blob_size,
+            "[Integrated BlobDB] Pick the min blob size from the value sizes, "
+            "reads and write amplification of the column family.");
+
+DEFINE_uint32(blob_compression_max_dict_bytes,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_compression_max_dict_bytes,
+              "[Integrated BlobDB] Maximum size of the compression dictionary "
+              "of blob files.");
+
 DEFINE_bool(enable_blob_garbage_collection,
             ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
                 .enable_blob_garbage_collection,
@@ -1254,6 +1354,13 @@ DEFINE_uint64(
     "num_file_reads_for_auto_readahead indicates after how many sequential "
     "reads into that file internal auto prefetching should be start.");
 
+DEFINE_bool(learn_auto_readahead_size,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .learn_auto_readahead_size,
+            "Size the implicit readahead of iterators from the lengths of "
+            "the recent scans, see "
+            "BlockBasedTableOptions::learn_auto_readahead_size");
+
 DEFINE_bool(
     auto_readahead_size, false,
     "When set true, RocksDB does auto tuning of readahead size during Scans");
@@ -1433,6 +1540,13 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
+DEFINE_bool(enable_pipelined_wal_sync, false,
+            "With --enable_pipelined_write and --sync, let the next WAL "
+            "group append while the previous group's fsync is in flight");
+
+DEFINE_bool(wal_use_io_uring, false,
+            "Submit WAL appends and syncs through io_uring when available");
+
 DEFINE_bool(
     unordered_write, false,
     "Enable the unordered write feature, which provides higher throughput but "
@@ -1441,6 +1555,19 @@ DEFINE_bool(
 DEFINE_bool(allow_concurrent_memtable_write, true,
             "Allow multi-writers to update mem tables in parallel.");
 
+DEFINE_bool(numa_aware_memtable_arena, false,
+            "Allocate the per-core memtable arena blocks on the NUMA node "
+            "of the writing thread.");
+
+DEFINE_int32(immutable_memtable_numa_node, -1,
+             "If >= 0, the NUMA node to move the pages of the immutable "
+             "memtables to while they wait to be flushed.");
+
+DEFINE_uint64(memtable_arena_pool_size, 0,
+              "If non-zero, recycle the arena blocks of flushed memtables "
+              "through a pool of this many bytes, which is pre-faulted in "
+              "the background.");
+
 DEFINE_double(experimental_mempurge_threshold, 0.0,
               "Maximum useful payload ratio estimate that triggers a mempurge "
               "(memtable garbage collection).");
@@ -1464,6 +1591,11 @@ DEFINE_uint64(write_thread_slow_yield_usec, 3,
               "The threshold at which a slow yield is considered a signal that "
               "other processes or threads want the core.");
 
+DEFINE_uint64(write_group_target_wal_latency_us,
+              ROCKSDB_NAMESPACE::Options().write_group_target_wal_latency_us,
+              "If non-zero, adapt write group limits to keep the p99 WAL "
+              "write latency under this many microseconds.");
+
 DEFINE_uint64(rate_limiter_bytes_per_sec, 0, "Set options.rate_limiter value.");
 
 DEFINE_int64(rate_limiter_refill_period_us, 100 * 1000,
@@ -1555,12 +1687,39 @@ DEFINE_uint64(
     "Interval of which the sine wave read_rate_limit is recalculated");
 DEFINE_int64(mix_accesses, -1,
              "The total query accesses of mix_graph workload");
+DEFINE_string(workload_model, "",
+              "If non-empty, the mix_graph workload follows the workload model "
+              "in this file, as written by trace_analyzer "
+              "--output_workload_model: its ratio of Get, Put, Seek and Delete "
+              "queries, the popularity of its keys scaled to --num keys, and "
+              "the sizes of its values. It replaces --mix_*_ratio, "
+              "--key_dist_*, --keyrange_dist_* and the value size distribution "
+              "parameters.");
 
 DEFINE_uint64(
     benchmark_read_rate_limit, 0,
     "If non-zero, db_bench will rate-limit the reads from RocksDB. This "
     "is the global rate in ops/second.");
 
+DEFINE_double(
+    open_loop_ops_per_sec, 0,
+    "If positive, each thread issues its operations open loop, on an arrival "
+    "schedule of this many operations per second, rather than each as soon as "
+    "the previous one finished. The latencies in the histograms are then "
+    "measured from the scheduled start of each operation, so they include the "
+    "time it was delayed by the operations before it.");
+
+DEFINE_string(open_loop_arrival, "poisson",
+              "The arrival schedule of --open_loop_ops_per_sec: poisson for "
+              "exponentially distributed gaps between the operations, or fixed "
+              "for equal gaps.");
+
+DEFINE_string(hdr_histogram_prefix, "",
+              "If non-empty and --histogram is set, the percentile "
+              "distribution of the latencies of each operation type of a "
+              "benchmark is written to <prefix><benchmark>.<operation>.hgrm, "
+              "in the text format of HdrHistogram read by its plotting tools.");
+
 DEFINE_uint64(max_compaction_bytes,
               ROCKSDB_NAMESPACE::Options().max_compaction_bytes,
               "Max bytes allowed in one compaction");
@@ -1715,6 +1874,13 @@ DEFINE_string(merge_operator, "",
 DEFINE_int32(skip_list_lookahead, 0,
              "Used with skip_list memtablerep; try linear search first for "
              "this many steps from the previous position");
+DEFINE_bool(skip_list_use_key_head, false,
+            "Used with skip_list memtablerep; store the first 8 bytes of "
+            "each user key in its node and compare those first");
+DEFINE_uint64(skip_list_point_lookup_index_buckets, 0,
+              "Used with skip_list memtablerep; if nonzero, index the newest "
+              "entry of each user key in a hash table with this many "
+              "buckets for point lookups");
 DEFINE_bool(report_file_operations, false,
             "if report number of file operations");
 DEFINE_bool(report_open_timing, false, "if report open timing");
@@ -1786,7 +1952,9 @@ static Status CreateMemTableRepFactory(
     std::shared_ptr<MemTableRepFactory>* factory) {
   Status s;
   if (!strcasecmp(FLAGS_memtablerep.c_str(), SkipListFactory::kNickName())) {
-    factory->reset(new SkipListFactory(FLAGS_skip_list_lookahead));
+    factory->reset(new SkipListFactory(
+        FLAGS_skip_list_lookahead, FLAGS_skip_list_use_key_head,
+        static_cast<size_t>(FLAGS_skip_list_point_lookup_index_buckets)));
   } else if (!strcasecmp(FLAGS_memtablerep.c_str(), "prefix_hash")) {
     factory->reset(NewHashSkipListRepFactory(FLAGS_hash_bucket_count));
   } else if (!strcasecmp(FLAGS_memtablerep.c_str(),
@@ -2218,6 +2386,10 @@ class Stats {
   uint64_t bytes_;
   uint64_t last_op_finish_;
   uint64_t last_report_finish_;
+  // The scheduled start of the next operation in --open_loop_ops_per_sec mode
+  double next_arrival_;
+  bool fixed_arrival_;
+  Random64 arrival_rand_{0};
   std::unordered_map<OperationType, std::shared_ptr<HistogramImpl>,
                      std::hash<unsigned char>>
       hist_;
@@ -2246,6 +2418,9 @@ class Stats {
     sine_interval_ = clock_->NowMicros();
     finish_ = start_;
     last_report_finish_ = start_;
+    next_arrival_ = static_cast<double>(start_);
+    fixed_arrival_ = !strcasecmp(FLAGS_open_loop_arrival.c_str(), "fixed");
+    arrival_rand_ = Random64(seed_base.value_or(0) + id);
     message_.clear();
     // When set, stats from this thread won't be merged with others.
     exclude_from_merge_ = false;
@@ -2337,9 +2512,18 @@ class Stats {
     if (reporter_agent_) {
       reporter_agent_->ReportFinishedOps(num_ops);
     }
+    const bool open_loop = FLAGS_open_loop_ops_per_sec > 0;
+    // The scheduled start of the first of the finished operations
+    const uint64_t arrival = static_cast<uint64_t>(next_arrival_);
+    if (open_loop) {
+      for (int64_t i = 0; i < num_ops; ++i) {
+        next_arrival_ += NextArrivalGap();
+      }
+    }
     if (FLAGS_histogram) {
       uint64_t now = clock_->NowMicros();
-      uint64_t micros = now - last_op_finish_;
+      uint64_t micros = open_loop ? (now > arrival ? now - arrival : 0)
+                                  : now - last_op_finish_;
 
       if (hist_.find(op_type) == hist_.end()) {
         auto hist_temp = std::make_shared<HistogramImpl>();
@@ -2456,6 +2640,29 @@ class Stats {
       }
       fflush(stderr);
     }
+
+    if (open_loop) {
+      // Waits for the scheduled start of the next operation. One that is
+      // already late starts at once, and its delay counts in its latency.
+      uint64_t now = clock_->NowMicros();
+      if (next_arrival_ > static_cast<double>(now)) {
+        clock_->SleepForMicroseconds(
+            static_cast<int>(next_arrival_ - static_cast<double>(now)));
+      }
+    }
+  }
+
+  // The micros between the scheduled starts of two operations
+  double NextArrivalGap() {
+    const double mean = 1e6 / FLAGS_open_loop_ops_per_sec;
+    if (fixed_arrival_) {
+      return mean;
+    }
+    // Exponentially distributed, from a uniform in (0, 1]
+    const double uniform =
+        (static_cast<double>(arrival_rand_.Next() >> 11) + 1) /
+        static_cast<double>(uint64_t{1} << 53);
+    return -mean * std::log(uniform);
   }
 
   void AddBytes(int64_t n) { bytes_ += n; }
@@ -2487,9 +2694,16 @@ class Stats {
             elapsed, done_, (extra.empty() ? "" : " "), extra.c_str());
     if (FLAGS_histogram) {
       for (auto it = hist_.begin(); it != hist_.end(); ++it) {
-        fprintf(stdout, "Microseconds per %s:\n%s\n",
+        fprintf(stdout, "Microseconds per %s%s:\n%s\n",
                 OperationTypeString[it->first].c_str(),
+                FLAGS_open_loop_ops_per_sec > 0 ? " from its scheduled start"
+                                                : "",
                 it->second->ToString().c_str());
+        if (!FLAGS_hdr_histogram_prefix.empty()) {
+          WriteHdrHistogram(name.ToString() + "." +
+                                OperationTypeString[it->first] + ".hgrm",
+                            *it->second);
+        }
       }
     }
     if (FLAGS_report_file_operations) {
@@ -2501,6 +2715,48 @@ class Stats {
     }
     fflush(stdout);
   }
+
+  // Writes the percentile distribution of `hist` in the text format of
+  // HdrHistogram, with values in micros
+  static void WriteHdrHistogram(const std::string& name,
+                                const HistogramImpl& hist) {
+    std::string file_name = FLAGS_hdr_histogram_prefix + name;
+    for (auto& c : file_name) {
+      if (c == ' ') {
+        c = '_';
+      }
+    }
+    FILE* file = fopen(file_name.c_str(), "w");
+    if (file == nullptr) {
+      fprintf(stderr, "Cannot write %s\n", file_name.c_str());
+      return;
+    }
+    fprintf(file, "%12s %14s %10s %14s\n\n", "Value", "Percentile",
+            "TotalCount", "1/(1-Percentile)");
+    const uint64_t count = hist.num();
+    // As HdrHistogram does, halves the distance to 100% every 5 steps
+    for (int halvings = 0; count > 0; ++halvings) {
+      for (int step = 0; step < 5; ++step) {
+        const double fraction = 1.0 - std::pow(0.5, halvings + step / 5.0);
+        const double value =
+            fraction == 0 ? static_cast<double>(hist.min())
+                          : hist.Percentile(fraction * 100);
+        fprintf(file, "%12.3f %2.12f %10" PRIu64 " %14.2f\n", value, fraction,
+                static_cast<uint64_t>(fraction * count), 1 / (1 - fraction));
+      }
+      if (std::pow(0.5, halvings + 1) * count < 1) {
+        break;
+      }
+    }
+    fprintf(file, "%12.3f %2.12f %10" PRIu64 "\n",
+            static_cast<double>(hist.max()), 1.0, count);
+    fprintf(file,
+            "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n"
+            "#[Max     = %12.3f, Total count    = %12" PRIu64 "]\n",
+            hist.Average(), hist.StandardDeviation(),
+            static_cast<double>(hist.max()), count);
+    fclose(file);
+  }
 };
 
 class CombinedStats {
@@ -2791,6 +3047,11 @@ class Benchmark {
   bool read_operands_;  // read via GetMergeOperands()
   std::vector<std::string> keys_;
   bool use_multi_write_;
+  // The kMultiBatchWriteTickers when multibatchwrite started
+  std::vector<uint64_t> multi_batch_write_tickers_;
+  static constexpr std::array<Tickers, 4> kMultiBatchWriteTickers = {
+      WRITE_DONE_BY_SELF, WRITE_DONE_BY_OTHER, BYTES_WRITTEN,
+      MULTI_BATCH_WRITE_STOLEN_BYTES};
 
   class ErrorHandlerListener : public EventListener {
    public:
@@ -3577,6 +3838,15 @@ class Benchmark {
       } else if (name == "fillrandom") {
         fresh_db = true;
         method = &Benchmark::WriteRandom;
+      } else if (name == "multibatchwrite") {
+        fresh_db = true;
+        method = &Benchmark::MultiBatchWriteRandom;
+        post_process_method = &Benchmark::ReportMultiBatchWrite;
+        multi_batch_write_tickers_.clear();
+        for (Tickers ticker : kMultiBatchWriteTickers) {
+          multi_batch_write_tickers_.push_back(
+              dbstats ? dbstats->getTickerCount(ticker) : 0);
+        }
       } else if (name == "filluniquerandom" ||
                  name == "fillanddeleteuniquerandom") {
         fresh_db = true;
@@ -3725,6 +3995,8 @@ class Benchmark {
       } else if (name == "randomtransaction") {
         method = &Benchmark::RandomTransaction;
         post_process_method = &Benchmark::RandomTransactionVerify;
+      } else if (name == "transactioncontention") {
+        method = &Benchmark::TransactionContention;
       } else if (name == "randomreplacekeys") {
         fresh_db = true;
         method = &Benchmark::RandomReplaceKeys;
@@ -4318,7 +4590,10 @@ class Benchmark {
     }
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
+    options.wal_recovery_threads = FLAGS_wal_recovery_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.compaction_async_io = FLAGS_compaction_async_io;
+    options.table_file_write_behind = FLAGS_table_file_write_behind;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
@@ -4413,6 +4688,9 @@ class Benchmark {
       } else if (FLAGS_index_with_first_key) {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
+      } else if (FLAGS_learned_index) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kLearnedIndexSearch;
       }
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
@@ -4484,6 +4762,8 @@ class Benchmark {
       block_based_options.block_restart_interval = FLAGS_block_restart_interval;
       block_based_options.index_block_restart_interval =
           FLAGS_index_block_restart_interval;
+      block_based_options.index_partition_restart_interval =
+          FLAGS_index_partition_restart_interval;
       block_based_options.format_version =
           static_cast<uint32_t>(FLAGS_format_version);
       block_based_options.read_amp_bytes_per_bit = FLAGS_read_amp_bytes_per_bit;
@@ -4497,6 +4777,8 @@ class Benchmark {
           FLAGS_initial_auto_readahead_size;
       block_based_options.num_file_reads_for_auto_readahead =
           FLAGS_num_file_reads_for_auto_readahead;
+      block_based_options.learn_auto_readahead_size =
+          FLAGS_learn_auto_readahead_size;
       BlockBasedTableOptions::PrepopulateBlockCache prepopulate_block_cache =
           block_based_options.prepopulate_block_cache;
       switch (FLAGS_prepopulate_block_cache) {
@@ -4521,6 +4803,10 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.data_block_restart_key_prefixes =
+          FLAGS_data_block_restart_key_prefixes;
+      block_based_options.data_block_hash_index_entry_offsets =
+          FLAGS_data_block_hash_index_entry_offsets;
       if (FLAGS_read_cache_path != "") {
         Status rc_status;
 
@@ -4651,6 +4937,10 @@ class Benchmark {
     options.delayed_write_rate = FLAGS_delayed_write_rate;
     options.allow_concurrent_memtable_write =
         FLAGS_allow_concurrent_memtable_write;
+    options.numa_aware_memtable_arena = FLAGS_numa_aware_memtable_arena;
+    options.immutable_memtable_numa_node = FLAGS_immutable_memtable_numa_node;
+    options.memtable_arena_pool_size =
+        static_cast<size_t>(FLAGS_memtable_arena_pool_size);
     options.experimental_mempurge_threshold =
         FLAGS_experimental_mempurge_threshold;
     options.inplace_update_support = FLAGS_inplace_update_support;
@@ -4658,9 +4948,14 @@ class Benchmark {
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+    options.enable_pipelined_wal_sync = FLAGS_enable_pipelined_wal_sync;
+    options.wal_use_io_uring = FLAGS_wal_use_io_uring;
     options.unordered_write = FLAGS_unordered_write;
+    options.multi_batch_write_split_bytes = FLAGS_multi_batch_write_split_bytes;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
+    options.write_group_target_wal_latency_us =
+        FLAGS_write_group_target_wal_latency_us;
     options.table_cache_numshardbits = FLAGS_table_cache_numshardbits;
     options.max_compaction_bytes = FLAGS_max_compaction_bytes;
     options.disable_auto_compactions = FLAGS_disable_auto_compactions;
@@ -4670,6 +4965,9 @@ class Benchmark {
     options.check_flush_compaction_key_order =
         FLAGS_check_flush_compaction_key_order;
     options.periodic_compaction_seconds = FLAGS_periodic_compaction_seconds;
+    options.compaction_read_heat_weight = FLAGS_compaction_read_heat_weight;
+    options.adapt_max_sequential_skip_in_iterations =
+        FLAGS_adapt_max_sequential_skip_in_iterations;
     options.ttl = FLAGS_ttl_seconds;
     // fill storage options
     options.advise_random_on_open = FLAGS_advise_random_on_open;
@@ -4716,6 +5014,9 @@ class Benchmark {
         FLAGS_universal_allow_trivial_move;
     options.compaction_options_universal.incremental =
         FLAGS_universal_incremental;
+    options.compaction_options_universal
+        .incremental_fallback_to_full_compaction =
+        FLAGS_universal_incremental_fallback_to_full_compaction;
     if (FLAGS_thread_status_per_interval > 0) {
       options.enable_thread_tracking = true;
     }
@@ -4735,9 +5036,12 @@ class Benchmark {
     // Integrated BlobDB
     options.enable_blob_files = FLAGS_enable_blob_files;
     options.min_blob_size = FLAGS_min_blob_size;
+    options.adaptive_min_blob_size = FLAGS_adaptive_min_blob_size;
     options.blob_file_size = FLAGS_blob_file_size;
     options.blob_compression_type =
         StringToCompressionType(FLAGS_blob_compression_type.c_str());
+    options.blob_compression_max_dict_bytes =
+        FLAGS_blob_compression_max_dict_bytes;
     options.enable_blob_garbage_collection =
         FLAGS_enable_blob_garbage_collection;
     options.blob_garbage_collection_age_cutoff =
@@ -4814,6 +5118,7 @@ class Benchmark {
         }
       }
     }
+    options.row_cache_by_user_key = FLAGS_row_cache_by_user_key;
 
     if (options.env == Env::Default()) {
       options.env = FLAGS_env;
@@ -5065,6 +5370,125 @@ class Benchmark {
 
   void WriteRandom(ThreadState* thread) { DoWrite(thread, RANDOM); }
 
+  // Writes in random key order, with numbers of entries per write drawn
+  // around a mean that may differ between the threads. With
+  // --use_multi_thread_write, the entries of a write are passed to
+  // MultiBatchWrite() as a vector of batches, otherwise as one batch to
+  // Write(), to compare with the other write modes.
+  void MultiBatchWriteRandom(ThreadState* thread) {
+    std::vector<int64_t> thread_entries;
+    for (const auto& entries :
+         StringSplit(FLAGS_multibatchwrite_thread_entries, ',')) {
+      thread_entries.push_back(std::max<int64_t>(std::stoll(entries), 1));
+    }
+    const int64_t mean_entries =
+        thread_entries.empty()
+            ? std::max<int64_t>(entries_per_batch_, 1)
+            : thread_entries[thread->tid % thread_entries.size()];
+    const std::string& dist = FLAGS_multibatchwrite_entries_dist;
+    if (dist != "fixed" && dist != "uniform" && dist != "exponential") {
+      fprintf(stderr, "Unknown multibatchwrite_entries_dist: %s\n",
+              dist.c_str());
+      ErrorExit();
+    }
+
+    DBWithColumnFamilies* db_with_cfh = SelectDBWithCfh(thread);
+    DB* db = db_with_cfh->db;
+    RandomGenerator gen;
+    WriteBatch batch(/*reserved_bytes=*/0, /*max_bytes=*/0,
+                     FLAGS_write_batch_protection_bytes_per_key,
+                     user_timestamp_size_);
+    WriteBatchVec batches(static_cast<uint32_t>(
+        std::max(FLAGS_multibatchwrite_batch_entries, 1)));
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    HistogramImpl write_micros;
+    int64_t num_writes = 0;
+    int64_t num_entries = 0;
+    int64_t bytes = 0;
+    Duration duration(FLAGS_duration, writes_);
+    while (true) {
+      int64_t entries = mean_entries;
+      if (dist == "uniform") {
+        entries = 1 + static_cast<int64_t>(thread->rand.Uniform(
+                          static_cast<uint64_t>(2 * mean_entries - 1)));
+      } else if (dist == "exponential") {
+        const double u =
+            (thread->rand.Uniform(1 << 30) + 1.0) / ((1 << 30) + 1.0);
+        entries = 1 + static_cast<int64_t>(-std::log(u) * (mean_entries - 1));
+      }
+      if (duration.Done(entries)) {
+        break;
+      }
+      batch.Clear();
+      batches.Clear();
+      for (int64_t j = 0; j < entries; j++) {
+        GenerateKeyFromInt(thread->rand.Next() % FLAGS_num, FLAGS_num, &key);
+        Slice val = gen.Generate();
+        Status s = use_multi_write_ ? batches.Put(key, val)
+                                    : batch.Put(key, val);
+        if (!s.ok()) {
+          fprintf(stderr, "put error: %s\n", s.ToString().c_str());
+          ErrorExit();
+        }
+        bytes += key.size() + val.size();
+      }
+      const uint64_t start = FLAGS_env->NowMicros();
+      Status s = use_multi_write_ ? db->MultiBatchWrite(write_options_,
+                                                        batches.GetWriteBatch())
+                                  : db->Write(write_options_, &batch);
+      write_micros.Add(FLAGS_env->NowMicros() - start);
+      thread->stats.FinishedOps(db_with_cfh, db, entries, kWrite);
+      if (!s.ok()) {
+        fprintf(stderr, "put error: %s\n", s.ToString().c_str());
+        ErrorExit();
+      }
+      num_writes++;
+      num_entries += entries;
+    }
+    thread->stats.AddBytes(bytes);
+
+    MutexLock l(&thread->shared->mu);
+    fprintf(stdout,
+            "Thread %d: %" PRIi64 " writes of %.1f entries, P50 %.1f P99 %.1f "
+            "P99.9 %.1f micros per write\n",
+            thread->tid, num_writes,
+            num_writes > 0 ? static_cast<double>(num_entries) / num_writes : 0,
+            write_micros.Median(), write_micros.Percentile(99),
+            write_micros.Percentile(99.9));
+  }
+
+  // Reports the write groups and the help between multi-batch writers of the
+  // last multibatchwrite
+  void ReportMultiBatchWrite() {
+    if (!dbstats) {
+      fprintf(stdout,
+              "Use --statistics for the sizes of the write groups and the "
+              "helping ratio\n");
+      return;
+    }
+    std::vector<uint64_t> counts;
+    for (size_t i = 0; i < kMultiBatchWriteTickers.size(); ++i) {
+      counts.push_back(dbstats->getTickerCount(kMultiBatchWriteTickers[i]) -
+                       multi_batch_write_tickers_[i]);
+    }
+    const uint64_t done_by_self = counts[0];
+    const uint64_t done_by_other = counts[1];
+    const uint64_t bytes_written = counts[2];
+    const uint64_t stolen_bytes = counts[3];
+    fprintf(stdout, "Write groups: %" PRIu64 " of %.2f writes on average\n",
+            done_by_self,
+            done_by_self > 0 ? static_cast<double>(done_by_self +
+                                                   done_by_other) /
+                                   done_by_self
+                             : 0.0);
+    fprintf(stdout,
+            "Helping ratio: %.2f%% of %" PRIu64
+            " bytes inserted by other writers of the group\n",
+            bytes_written > 0 ? 100.0 * stolen_bytes / bytes_written : 0.0,
+            bytes_written);
+  }
+
   void WriteUniqueRandom(ThreadState* thread) {
     DoWrite(thread, UNIQUE_RANDOM);
   }
@@ -6431,6 +6855,137 @@ class Benchmark {
     }
   };
 
+  // The workload model written by trace_analyzer --output_workload_model
+  class WorkloadModel {
+   public:
+    // The ratios of the Get, Put, Seek and Delete queries
+    std::vector<double> ratio_;
+
+    Status Load(const std::string& path, int64_t num_keys) {
+      std::string data;
+      Status s = ReadFileToString(FLAGS_env, path, &data);
+      if (!s.ok()) {
+        return s;
+      }
+      num_keys_ = num_keys;
+      ratio_.assign(4, 0.0);
+      // (access count, number of keys)
+      std::vector<std::pair<uint64_t, uint64_t>> key_access;
+      for (const auto& line : StringSplit(data, '\n')) {
+        char name[64];
+        uint64_t a = 0, b = 0, c = 0;
+        if (line.empty() || line[0] == '#') {
+          continue;
+        }
+        if (sscanf(line.c_str(), "op %63s %" SCNu64, name, &a) == 2) {
+          const std::string op = name;
+          if (op == "get" || op == "multiget") {
+            ratio_[0] += a;
+          } else if (op == "put" || op == "merge") {
+            ratio_[1] += a;
+          } else if (op == "iterator_Seek" || op == "iterator_SeekForPrev") {
+            ratio_[2] += a;
+          } else if (op == "delete" || op == "single_delete" ||
+                     op == "range_delete") {
+            ratio_[3] += a;
+          }
+        } else if (sscanf(line.c_str(), "key_access %" SCNu64 " %" SCNu64, &a,
+                          &b) == 2) {
+          key_access.emplace_back(a, b);
+        } else if (sscanf(line.c_str(),
+                          "value_size %" SCNu64 " %" SCNu64 " %" SCNu64, &a,
+                          &b, &c) == 3) {
+          if (b > a && c > 0) {
+            value_sizes_.push_back({(value_sizes_.empty()
+                                         ? 0
+                                         : value_sizes_.back().cumulative) +
+                                        c,
+                                    a, b});
+          }
+        } else {
+          return Status::Corruption("Bad line in workload model", line);
+        }
+      }
+      if (ratio_[0] + ratio_[1] + ratio_[2] + ratio_[3] <= 0) {
+        return Status::Corruption("No queries in workload model", path);
+      }
+
+      // Lays out the keys from the most to the least accessed ones over the
+      // key space, each popularity class taking the share of the key space
+      // it has of the keys of the trace
+      std::sort(key_access.begin(), key_access.end(),
+                std::greater<std::pair<uint64_t, uint64_t>>());
+      uint64_t total_keys = 0;
+      for (const auto& access : key_access) {
+        total_keys += access.second;
+      }
+      uint64_t keys_before = 0;
+      for (const auto& access : key_access) {
+        if (access.first == 0 || access.second == 0) {
+          continue;
+        }
+        KeyClass key_class;
+        key_class.start = static_cast<int64_t>(
+            static_cast<double>(keys_before) / total_keys * num_keys);
+        keys_before += access.second;
+        int64_t end = static_cast<int64_t>(static_cast<double>(keys_before) /
+                                           total_keys * num_keys);
+        key_class.start = std::min(key_class.start, num_keys - 1);
+        key_class.num = std::max<int64_t>(1, end - key_class.start);
+        key_class.cumulative =
+            (key_classes_.empty() ? 0 : key_classes_.back().cumulative) +
+            access.first * access.second;
+        key_classes_.push_back(key_class);
+      }
+      return Status::OK();
+    }
+
+    int64_t GetKeyID(Random64* rand) const {
+      if (key_classes_.empty()) {
+        return static_cast<int64_t>(rand->Uniform(num_keys_));
+      }
+      const uint64_t pos = rand->Uniform(key_classes_.back().cumulative);
+      const auto& key_class = *std::upper_bound(
+          key_classes_.begin(), key_classes_.end(), pos,
+          [](uint64_t p, const KeyClass& c) { return p < c.cumulative; });
+      return key_class.start +
+             static_cast<int64_t>(rand->Uniform(key_class.num));
+    }
+
+    // Returns -1 if the model has no value sizes
+    int64_t GetValueSize(Random64* rand) const {
+      if (value_sizes_.empty()) {
+        return -1;
+      }
+      const uint64_t pos = rand->Uniform(value_sizes_.back().cumulative);
+      const auto& range = *std::upper_bound(
+          value_sizes_.begin(), value_sizes_.end(), pos,
+          [](uint64_t p, const ValueSizeRange& r) { return p < r.cumulative; });
+      return static_cast<int64_t>(range.begin +
+                                  rand->Uniform(range.end - range.begin));
+    }
+
+   private:
+    // The keys accessed the same number of times in the model
+    struct KeyClass {
+      // The accesses to this and the more accessed classes
+      uint64_t cumulative;
+      int64_t start;
+      int64_t num;
+    };
+
+    struct ValueSizeRange {
+      // The values in this and the smaller ranges
+      uint64_t cumulative;
+      uint64_t begin;
+      uint64_t end;
+    };
+
+    int64_t num_keys_ = 0;
+    std::vector<KeyClass> key_classes_;
+    std::vector<ValueSizeRange> value_sizes_;
+  };
+
   // KeyrangeUnit is the struct of a keyrange. It is used in a keyrange vector
   // to transfer a random value to one keyrange based on the hotness.
   struct KeyrangeUnit {
@@ -6579,6 +7134,7 @@ class Benchmark {
   void MixGraph(ThreadState* thread) {
     int64_t gets = 0;
     int64_t puts = 0;
+    int64_t deletes = 0;
     int64_t get_found = 0;
     int64_t seek = 0;
     int64_t seek_found = 0;
@@ -6593,6 +7149,8 @@ class Benchmark {
     bool use_prefix_modeling = false;
     bool use_random_modeling = false;
     GenerateTwoTermExpKeys gen_exp;
+    WorkloadModel model;
+    const bool use_workload_model = !FLAGS_workload_model.empty();
     std::vector<double> ratio{FLAGS_mix_get_ratio, FLAGS_mix_put_ratio,
                               FLAGS_mix_seek_ratio};
     char value_buffer[default_value_max];
@@ -6606,6 +7164,15 @@ class Benchmark {
     std::unique_ptr<const char[]> key_guard;
     Slice key = AllocateKey(&key_guard);
     PinnableSlice pinnable_val;
+    if (use_workload_model) {
+      s = model.Load(FLAGS_workload_model, FLAGS_num);
+      if (!s.ok()) {
+        fprintf(stderr, "Cannot load workload model: %s\n",
+                s.ToString().c_str());
+        ErrorExit();
+      }
+      ratio = model.ratio_;
+    }
     query.Initiate(ratio);
 
     // the limit of qps initiation
@@ -6637,7 +7204,9 @@ class Benchmark {
       double u = static_cast<double>(rand_v) / FLAGS_num;
 
       // Generate the keyID based on the key hotness and prefix hotness
-      if (use_random_modeling) {
+      if (use_workload_model) {
+        key_rand = model.GetKeyID(&thread->rand);
+      } else if (use_random_modeling) {
         key_rand = ini_rand;
       } else if (use_prefix_modeling) {
         key_rand =
@@ -6669,6 +7238,9 @@ class Benchmark {
             SineRate(usecs_since_start / 1000000.0), FLAGS_sine_mix_rate_noise);
         read_rate = mix_rate_with_noise * (query.ratio_[0] + query.ratio_[2]);
         write_rate = mix_rate_with_noise * query.ratio_[1];
+        if (query.ratio_.size() > 3) {
+          write_rate += mix_rate_with_noise * query.ratio_[3];
+        }
 
         if (read_rate > 0) {
           thread->shared->read_rate_limiter->SetBytesPerSecond(
@@ -6709,8 +7281,13 @@ class Benchmark {
       } else if (query_type == 1) {
         // the Put query
         puts++;
-        int64_t val_size = ParetoCdfInversion(u, FLAGS_value_theta,
-                                              FLAGS_value_k, FLAGS_value_sigma);
+        int64_t val_size = use_workload_model
+                               ? model.GetValueSize(&thread->rand)
+                               : -1;
+        if (val_size < 0) {
+          val_size = ParetoCdfInversion(u, FLAGS_value_theta, FLAGS_value_k,
+                                        FLAGS_value_sigma);
+        }
         if (val_size < 10) {
           val_size = 10;
         } else if (val_size > value_max) {
@@ -6759,6 +7336,20 @@ class Benchmark {
           delete single_iter;
         }
         thread->stats.FinishedOps(db_with_cfh, db_with_cfh->db, 1, kSeek);
+      } else if (query_type == 3) {
+        // Delete query, only in workload models
+        deletes++;
+        s = db_with_cfh->db->Delete(write_options_, key);
+        if (!s.ok()) {
+          fprintf(stderr, "delete error: %s\n", s.ToString().c_str());
+          ErrorExit();
+        }
+
+        if (thread->shared->write_rate_limiter && deletes % 100 == 0) {
+          thread->shared->write_rate_limiter->Request(100, Env::IO_HIGH,
+                                                      nullptr /*stats*/);
+        }
+        thread->stats.FinishedOps(db_with_cfh, db_with_cfh->db, 1, kDelete);
       }
     }
     char msg[256];
@@ -6772,6 +7363,10 @@ class Benchmark {
 
     thread->stats.AddBytes(bytes);
     thread->stats.AddMessage(msg);
+    if (deletes > 0) {
+      snprintf(msg, sizeof(msg), "( Deletes:%" PRIu64 ")", deletes);
+      thread->stats.AddMessage(msg);
+    }
   }
 
   void IteratorCreation(ThreadState* thread) {
@@ -8034,6 +8629,70 @@ class Benchmark {
     }
   }
 
+  // This benchmark measures lock contention of a TransactionDB: each
+  // Transaction locks one of --transaction_hot_keys keys with GetForUpdate()
+  // and writes it, or only takes a shared lock for
+  // --transaction_shared_lock_pct percent of them. With --threads, the
+  // transactions wait for each other on the hot keys.
+  void TransactionContention(ThreadState* thread) {
+    if (!FLAGS_transaction_db) {
+      fprintf(stderr,
+              "transactioncontention benchmark requires "
+              "--transaction_db=true\n");
+      abort();
+    }
+    if (FLAGS_transaction_hot_keys == 0) {
+      fprintf(stderr, "invalid value for transaction_hot_keys\n");
+      abort();
+    }
+
+    TransactionDB* txn_db = static_cast<TransactionDB*>(db_.db);
+    TransactionOptions txn_options;
+    txn_options.lock_timeout = FLAGS_transaction_lock_timeout;
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    RandomGenerator gen;
+    std::string value;
+    Transaction* txn = nullptr;
+    uint64_t transactions_done = 0;
+    uint64_t lock_failures = 0;
+
+    Duration duration(FLAGS_duration, readwrites_);
+    while (!duration.Done(1)) {
+      GenerateKeyFromInt(thread->rand.Next() % FLAGS_transaction_hot_keys,
+                         FLAGS_num, &key);
+      const bool exclusive = static_cast<int>(thread->rand.Uniform(100)) >=
+                             FLAGS_transaction_shared_lock_pct;
+      txn = txn_db->BeginTransaction(write_options_, txn_options, txn);
+
+      Status s = txn->GetForUpdate(read_options_, key, &value, exclusive);
+      if (s.ok() || s.IsNotFound()) {
+        s = exclusive ? txn->Put(key, gen.Generate()) : Status::OK();
+        if (s.ok()) {
+          s = txn->Commit();
+        }
+      } else if (s.IsTimedOut() || s.IsBusy()) {
+        // Lock timeout or deadlock
+        lock_failures++;
+        s = txn->Rollback();
+      }
+      if (!s.ok()) {
+        fprintf(stderr, "Unexpected error: %s\n", s.ToString().c_str());
+        abort();
+      }
+
+      thread->stats.FinishedOps(nullptr, db_.db, 1, kOthers);
+      transactions_done++;
+    }
+    delete txn;
+
+    char msg[100];
+    snprintf(msg, sizeof(msg),
+             "( transactions:%" PRIu64 " lock failures:%" PRIu64 ")",
+             transactions_done, lock_failures);
+    thread->stats.AddMessage(msg);
+  }
+
   // Writes and deletes random keys without overwriting keys.
   //
   // This benchmark is intended to partially replicate the behavior of MyRocks
@@ -8558,10 +9217,20 @@ class Benchmark {
         ReplayOptions(static_cast<uint32_t>(FLAGS_trace_replay_threads),
                       FLAGS_trace_replay_fast_forward),
         nullptr);
+    ReplayTimingStats timing_stats;
+    Status timing_s = replayer->GetTimingStats(&timing_stats);
     replayer.reset();
     if (s.ok()) {
       fprintf(stdout, "Replay completed from trace_file: %s\n",
               FLAGS_trace_file.c_str());
+      if (timing_s.ok()) {
+        fprintf(stdout,
+                "Replay timing: %" PRIu64
+                " traces started late by %.1f micros on average, %.1f at "
+                "P99, %" PRIu64 " at most\n",
+                timing_stats.num_traces, timing_stats.average_lag_micros,
+                timing_stats.p99_lag_micros, timing_stats.max_lag_micros);
+      }
     } else {
       fprintf(stderr, "Replay failed. Error: %s\n", s.ToString().c_str());
     }
@@ -8721,6 +9390,13 @@ int db_bench_tool(int argc, char** argv) {
     exit(1);
   }
 
+  if (strcasecmp(FLAGS_open_loop_arrival.c_str(), "poisson") &&
+      strcasecmp(FLAGS_open_loop_arrival.c_str(), "fixed")) {
+    fprintf(stderr, "Unknown open loop arrival %s\n",
+            FLAGS_open_loop_arrival.c_str());
+    exit(1);
+  }
+
 #ifdef OPENSSL
   if (!FLAGS_encryption_method.empty()) {
     ROCKSDB_NAMESPACE::encryption::EncryptionMethod method =
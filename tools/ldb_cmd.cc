@@ -7,6 +7,7 @@
 #include "rocksdb/utilities/ldb_cmd.h"
 
 #include <cstddef>
+#include <atomic>
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
@@ -31,6 +32,7 @@
 #include "rocksdb/file_checksum.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/options.h"
+#include "rocksdb/sst_file_writer.h"
 #include "rocksdb/table_properties.h"
 #include "rocksdb/utilities/backup_engine.h"
 #include "rocksdb/utilities/checkpoint.h"
@@ -44,6 +46,7 @@
 #include "util/cast_util.h"
 #include "util/coding.h"
 #include "util/file_checksum_helper.h"
+#include "util/mutexlock.h"
 #include "util/stderr_logger.h"
 #include "util/string_util.h"
 #include "utilities/blob_db/blob_dump_tool.h"
@@ -1253,9 +1256,61 @@ void CompactorCommand::DoCommand() {
 }
 
 // ---------------------------------------------------------------------------
+namespace {
+
+// The partition files written by `dump --export_dir` and read by
+// `load --import_dir`, in the text format of `dump`
+const std::string kPartitionFilePrefix = "partition-";
+const std::string kPartitionFileSuffix = ".dump";
+
+std::string PartitionFileName(const std::string& dir, size_t partition) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%06zu", partition);
+  return dir + "/" + kPartitionFilePrefix + buf + kPartitionFileSuffix;
+}
+
+// Calls `fn(i)` for each i in [0, n) on up to `num_threads` threads including
+// the calling one. Returns the first error, after which no more calls start.
+Status RunPartitions(size_t n, int num_threads,
+                     const std::function<Status(size_t)>& fn) {
+  std::atomic<size_t> next{0};
+  std::atomic<bool> stop{false};
+  port::Mutex mutex;
+  Status status;
+  auto run = [&]() {
+    size_t i;
+    while (!stop.load(std::memory_order_relaxed) &&
+           (i = next.fetch_add(1, std::memory_order_relaxed)) < n) {
+      Status s = fn(i);
+      if (!s.ok()) {
+        MutexLock l(&mutex);
+        if (status.ok()) {
+          status = s;
+        }
+        stop.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+  std::vector<port::Thread> threads;
+  const size_t num_run_threads =
+      std::min(static_cast<size_t>(std::max(num_threads, 1)), n);
+  for (size_t i = 1; i < num_run_threads; ++i) {
+    threads.emplace_back(run);
+  }
+  run();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return status;
+}
+
+}  // namespace
+
 const std::string DBLoaderCommand::ARG_DISABLE_WAL = "disable_wal";
 const std::string DBLoaderCommand::ARG_BULK_LOAD = "bulk_load";
 const std::string DBLoaderCommand::ARG_COMPACT = "compact";
+const std::string DBLoaderCommand::ARG_IMPORT_DIR = "import_dir";
+const std::string DBLoaderCommand::ARG_PARALLELISM = "parallelism";
 
 DBLoaderCommand::DBLoaderCommand(
     const std::vector<std::string>& /*params*/,
@@ -1265,14 +1320,22 @@ DBLoaderCommand::DBLoaderCommand(
           options, flags, false,
           BuildCmdLineOptions({ARG_HEX, ARG_KEY_HEX, ARG_VALUE_HEX, ARG_FROM,
                                ARG_TO, ARG_CREATE_IF_MISSING, ARG_DISABLE_WAL,
-                               ARG_BULK_LOAD, ARG_COMPACT})),
+                               ARG_BULK_LOAD, ARG_COMPACT, ARG_IMPORT_DIR,
+                               ARG_PARALLELISM})),
       disable_wal_(false),
       bulk_load_(false),
-      compact_(false) {
+      compact_(false),
+      parallelism_(1) {
   create_if_missing_ = IsFlagPresent(flags, ARG_CREATE_IF_MISSING);
   disable_wal_ = IsFlagPresent(flags, ARG_DISABLE_WAL);
   bulk_load_ = IsFlagPresent(flags, ARG_BULK_LOAD);
   compact_ = IsFlagPresent(flags, ARG_COMPACT);
+  ParseStringOption(options, ARG_IMPORT_DIR, &import_dir_);
+  if (ParseIntOption(options, ARG_PARALLELISM, parallelism_, exec_state_) &&
+      parallelism_ < 1) {
+    exec_state_ = LDBCommandExecuteResult::Failed(ARG_PARALLELISM +
+                                                  " must be at least 1");
+  }
 }
 
 void DBLoaderCommand::Help(std::string& ret) {
@@ -1282,6 +1345,8 @@ void DBLoaderCommand::Help(std::string& ret) {
   ret.append(" [--" + ARG_DISABLE_WAL + "]");
   ret.append(" [--" + ARG_BULK_LOAD + "]");
   ret.append(" [--" + ARG_COMPACT + "]");
+  ret.append(" [--" + ARG_IMPORT_DIR + "=<dir of dump --export_dir>]");
+  ret.append(" [--" + ARG_PARALLELISM + "=<threads building table files>]");
   ret.append("\n");
 }
 
@@ -1299,6 +1364,11 @@ void DBLoaderCommand::DoCommand() {
     return;
   }
 
+  if (!import_dir_.empty()) {
+    DoImportCommand();
+    return;
+  }
+
   WriteOptions write_options;
   if (disable_wal_) {
     write_options.disableWAL = true;
@@ -1343,6 +1413,109 @@ void DBLoaderCommand::DoCommand() {
   }
 }
 
+void DBLoaderCommand::DoImportCommand() {
+  Env* env = options_.env;
+  std::vector<std::string> children;
+  Status s = env->GetChildren(import_dir_, &children);
+  std::vector<std::string> partitions;
+  for (const auto& child : children) {
+    if (StartsWith(child, kPartitionFilePrefix) &&
+        EndsWith(child, kPartitionFileSuffix)) {
+      partitions.push_back(import_dir_ + "/" + child);
+    }
+  }
+  std::sort(partitions.begin(), partitions.end());
+  if (s.ok() && partitions.empty()) {
+    s = Status::NotFound("No partition files in " + import_dir_);
+  }
+
+  // Each partition is sorted, so it is written to table files as is, rolling
+  // them over at the target file size
+  std::vector<std::vector<std::string>> table_files(partitions.size());
+  std::atomic<uint64_t> num_keys{0};
+  std::atomic<uint64_t> bad_lines{0};
+  if (s.ok()) {
+    s = RunPartitions(partitions.size(), parallelism_, [&](size_t i) {
+      std::ifstream in(partitions[i]);
+      if (!in.is_open()) {
+        return Status::IOError("Cannot open", partitions[i]);
+      }
+      const std::string base = partitions[i].substr(
+          0, partitions[i].size() - kPartitionFileSuffix.size());
+      SstFileWriter writer(EnvOptions(options_), options_, GetCfHandle());
+      bool writer_open = false;
+      uint64_t partition_keys = 0;
+      std::string line;
+      std::string key;
+      std::string value;
+      Status ps;
+      while (ps.ok() && getline(in, line, '\n')) {
+        if (!ParseKeyValue(line, &key, &value, is_key_hex_, is_value_hex_)) {
+          bad_lines.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        if (!writer_open) {
+          table_files[i].push_back(base + "-" +
+                                   std::to_string(table_files[i].size()) +
+                                   ".sst");
+          ps = writer.Open(table_files[i].back());
+          writer_open = ps.ok();
+        }
+        if (ps.ok()) {
+          ps = writer.Put(key, value);
+          partition_keys++;
+        }
+        if (ps.ok() && writer.FileSize() >= options_.target_file_size_base) {
+          ps = writer.Finish();
+          writer_open = false;
+        }
+      }
+      if (ps.ok() && writer_open) {
+        ps = writer.Finish();
+      }
+      if (ps.ok() && in.bad()) {
+        ps = Status::IOError("Cannot read", partitions[i]);
+      }
+      num_keys.fetch_add(partition_keys, std::memory_order_relaxed);
+      return ps;
+    });
+  }
+
+  std::vector<std::string> files;
+  for (const auto& partition_files : table_files) {
+    files.insert(files.end(), partition_files.begin(), partition_files.end());
+  }
+  if (s.ok() && !files.empty()) {
+    IngestExternalFileOptions ingest_options;
+    ingest_options.move_files = true;
+    s = db_->IngestExternalFile(GetCfHandle(), files, ingest_options);
+  }
+  if (!s.ok()) {
+    for (const auto& file : files) {
+      env->DeleteFile(file).PermitUncheckedError();
+    }
+    exec_state_ =
+        LDBCommandExecuteResult::Failed("Import failed: " + s.ToString());
+    return;
+  }
+  if (bad_lines.load() > 0) {
+    std::cout << "Warning: " << bad_lines.load() << " bad lines ignored."
+              << std::endl;
+  }
+  fprintf(stdout,
+          "Imported %" PRIu64 " keys from %zu partitions in %zu table files\n",
+          num_keys.load(), partitions.size(), files.size());
+
+  if (compact_) {
+    s = db_->CompactRange(CompactRangeOptions(), GetCfHandle(), nullptr,
+                          nullptr);
+    if (!s.ok()) {
+      exec_state_ = LDBCommandExecuteResult::Failed("Compaction failed: " +
+                                                    s.ToString());
+    }
+  }
+}
+
 // ----------------------------------------------------------------------------
 
 namespace {
@@ -1973,6 +2146,8 @@ const std::string DBDumperCommand::ARG_COUNT_ONLY = "count_only";
 const std::string DBDumperCommand::ARG_COUNT_DELIM = "count_delim";
 const std::string DBDumperCommand::ARG_STATS = "stats";
 const std::string DBDumperCommand::ARG_TTL_BUCKET = "bucket";
+const std::string DBDumperCommand::ARG_EXPORT_DIR = "export_dir";
+const std::string DBDumperCommand::ARG_PARALLELISM = "parallelism";
 
 DBDumperCommand::DBDumperCommand(
     const std::vector<std::string>& /*params*/,
@@ -1984,14 +2159,16 @@ DBDumperCommand::DBDumperCommand(
               {ARG_TTL, ARG_HEX, ARG_KEY_HEX, ARG_VALUE_HEX, ARG_FROM, ARG_TO,
                ARG_MAX_KEYS, ARG_COUNT_ONLY, ARG_COUNT_DELIM, ARG_STATS,
                ARG_TTL_START, ARG_TTL_END, ARG_TTL_BUCKET, ARG_TIMESTAMP,
-               ARG_PATH, ARG_DECODE_BLOB_INDEX, ARG_DUMP_UNCOMPRESSED_BLOBS})),
+               ARG_PATH, ARG_DECODE_BLOB_INDEX, ARG_DUMP_UNCOMPRESSED_BLOBS,
+               ARG_EXPORT_DIR, ARG_PARALLELISM})),
       null_from_(true),
       null_to_(true),
       max_keys_(-1),
       count_only_(false),
       count_delim_(false),
       print_stats_(false),
-      decode_blob_index_(false) {
+      decode_blob_index_(false),
+      parallelism_(1) {
   auto itr = options.find(ARG_FROM);
   if (itr != options.end()) {
     null_from_ = false;
@@ -2050,6 +2227,20 @@ DBDumperCommand::DBDumperCommand(
       db_path_ = path_;
     }
   }
+
+  if (ParseIntOption(options, ARG_PARALLELISM, parallelism_, exec_state_) &&
+      parallelism_ < 1) {
+    exec_state_ = LDBCommandExecuteResult::Failed(ARG_PARALLELISM +
+                                                  " must be at least 1");
+  }
+  ParseStringOption(options, ARG_EXPORT_DIR, &export_dir_);
+  if (!export_dir_.empty() && (is_db_ttl_ || max_keys_ >= 0 || count_only_ ||
+                               count_delim_ || !path_.empty())) {
+    exec_state_ = LDBCommandExecuteResult::Failed(
+        ARG_EXPORT_DIR + " cannot be used with --" + ARG_TTL + ", --" +
+        ARG_MAX_KEYS + ", --" + ARG_COUNT_ONLY + ", --" + ARG_COUNT_DELIM +
+        " or --" + ARG_PATH);
+  }
 }
 
 void DBDumperCommand::Help(std::string& ret) {
@@ -2068,6 +2259,8 @@ void DBDumperCommand::Help(std::string& ret) {
   ret.append(" [--" + ARG_PATH + "=<path_to_a_file>]");
   ret.append(" [--" + ARG_DECODE_BLOB_INDEX + "]");
   ret.append(" [--" + ARG_DUMP_UNCOMPRESSED_BLOBS + "]");
+  ret.append(" [--" + ARG_EXPORT_DIR + "=<dir for load --import_dir>]");
+  ret.append(" [--" + ARG_PARALLELISM + "=<threads writing partitions>]");
   ret.append("\n");
 }
 
@@ -2122,6 +2315,8 @@ void DBDumperCommand::DoCommand() {
         break;
     }
 
+  } else if (!export_dir_.empty()) {
+    DoExportCommand();
   } else {
     DoDumpCommand();
   }
@@ -2279,6 +2474,130 @@ void DBDumperCommand::DoDumpCommand() {
   delete iter;
 }
 
+void DBDumperCommand::DoExportCommand() {
+  assert(nullptr != db_);
+  Env* env = options_.env;
+  Status s = env->CreateDirIfMissing(export_dir_);
+  std::vector<std::string> children;
+  if (s.ok()) {
+    s = env->GetChildren(export_dir_, &children);
+  }
+  for (const auto& child : children) {
+    // They would be imported with the new ones
+    if (s.ok() && StartsWith(child, kPartitionFilePrefix) &&
+        EndsWith(child, kPartitionFileSuffix)) {
+      s = Status::InvalidArgument(export_dir_ + " has partition files");
+    }
+  }
+  if (!s.ok()) {
+    exec_state_ =
+        LDBCommandExecuteResult::Failed("Export failed: " + s.ToString());
+    return;
+  }
+
+  ReadOptions read_options;
+  read_options.total_order_seek = true;
+  read_options.fill_cache = false;
+  read_options.snapshot = db_->GetSnapshot();
+
+  // Split the range at the key anchors of the table files into more
+  // partitions than threads, for the threads finishing early to take over.
+  // The anchors are only looked for between the first and last keys of the
+  // range.
+  constexpr uint64_t kPartitionsPerThread = 4;
+  std::vector<std::string> boundaries;
+  {
+    std::unique_ptr<Iterator> iter(
+        db_->NewIterator(read_options, GetCfHandle()));
+    if (null_from_) {
+      iter->SeekToFirst();
+    } else {
+      iter->Seek(from_);
+    }
+    std::string first = iter->Valid() ? iter->key().ToString() : "";
+    if (null_to_) {
+      iter->SeekToLast();
+    } else {
+      iter->SeekForPrev(to_);
+    }
+    std::string last = iter->Valid() ? iter->key().ToString() : "";
+    s = iter->status();
+    // Without a snapshot the partitions would see different states of the DB
+    if (s.ok() && parallelism_ > 1 && read_options.snapshot != nullptr &&
+        !first.empty() && !last.empty()) {
+      DBImpl* db_impl = static_cast_with_check<DBImpl>(db_->GetRootDB());
+      db_impl->GetScanBoundaries(
+          read_options, GetCfHandle(), Range(first, last),
+          static_cast<uint64_t>(parallelism_) * kPartitionsPerThread,
+          &boundaries);
+    }
+  }
+
+  // Each partition is written with a buffer of this size
+  constexpr size_t kWriteBufferSize = 1 << 20;
+  std::atomic<uint64_t> num_keys{0};
+  const size_t num_partitions = boundaries.size() + 1;
+  if (s.ok()) {
+    s = RunPartitions(num_partitions, parallelism_, [&](size_t i) {
+      ReadOptions ro(read_options);
+      Slice lower_bound = i > 0 ? Slice(boundaries[i - 1]) : Slice(from_);
+      Slice upper_bound =
+          i + 1 < num_partitions ? Slice(boundaries[i]) : Slice(to_);
+      if (i > 0 || !null_from_) {
+        ro.iterate_lower_bound = &lower_bound;
+      }
+      if (i + 1 < num_partitions || !null_to_) {
+        ro.iterate_upper_bound = &upper_bound;
+      }
+      std::unique_ptr<WritableFile> file;
+      Status ps = env->NewWritableFile(PartitionFileName(export_dir_, i),
+                                       &file, EnvOptions(options_));
+      if (!ps.ok()) {
+        return ps;
+      }
+      std::unique_ptr<Iterator> iter(db_->NewIterator(ro, GetCfHandle()));
+      uint64_t partition_keys = 0;
+      std::string buf;
+      for (iter->Seek(lower_bound); ps.ok() && iter->Valid(); iter->Next()) {
+        buf.append(PrintKeyValue(iter->key().ToString(),
+                                 iter->value().ToString(), is_key_hex_,
+                                 is_value_hex_));
+        buf.push_back('\n');
+        partition_keys++;
+        if (buf.size() >= kWriteBufferSize) {
+          ps = file->Append(buf);
+          buf.clear();
+        }
+      }
+      if (ps.ok()) {
+        ps = iter->status();
+      }
+      if (ps.ok()) {
+        ps = file->Append(buf);
+      }
+      if (ps.ok()) {
+        ps = file->Sync();
+      }
+      if (ps.ok()) {
+        ps = file->Close();
+      }
+      num_keys.fetch_add(partition_keys, std::memory_order_relaxed);
+      return ps;
+    });
+  }
+  if (read_options.snapshot != nullptr) {
+    db_->ReleaseSnapshot(read_options.snapshot);
+  }
+
+  if (!s.ok()) {
+    exec_state_ =
+        LDBCommandExecuteResult::Failed("Export failed: " + s.ToString());
+    return;
+  }
+  fprintf(stdout, "Exported %" PRIu64 " keys in %zu partitions to %s\n",
+          num_keys.load(), num_partitions, export_dir_.c_str());
+}
+
 const std::string ReduceDBLevelsCommand::ARG_NEW_LEVELS = "new_levels";
 const std::string ReduceDBLevelsCommand::ARG_PRINT_OLD_LEVELS =
     "print_old_levels";
@@ -98,6 +98,10 @@ class DBDumperCommand : public LDBCommand {
 
   void DoDumpCommand();
 
+  // Writes the key-values of the range, read from a snapshot, to partition
+  // files of export_dir_ on parallelism_ threads
+  void DoExportCommand();
+
   bool null_from_;
   std::string from_;
   bool null_to_;
@@ -110,11 +114,15 @@ class DBDumperCommand : public LDBCommand {
   std::string path_;
   bool decode_blob_index_;
   bool dump_uncompressed_blobs_;
+  std::string export_dir_;
+  int parallelism_;
 
   static const std::string ARG_COUNT_ONLY;
   static const std::string ARG_COUNT_DELIM;
   static const std::string ARG_STATS;
   static const std::string ARG_TTL_BUCKET;
+  static const std::string ARG_EXPORT_DIR;
+  static const std::string ARG_PARALLELISM;
 };
 
 class InternalDumpCommand : public LDBCommand {
@@ -166,13 +174,21 @@ class DBLoaderCommand : public LDBCommand {
   void OverrideBaseOptions() override;
 
  private:
+  // Builds table files from the partition files of import_dir_ on
+  // parallelism_ threads and ingests all of them at once
+  void DoImportCommand();
+
   bool disable_wal_;
   bool bulk_load_;
   bool compact_;
+  std::string import_dir_;
+  int parallelism_;
 
   static const std::string ARG_DISABLE_WAL;
   static const std::string ARG_BULK_LOAD;
   static const std::string ARG_COMPACT;
+  static const std::string ARG_IMPORT_DIR;
+  static const std::string ARG_PARALLELISM;
 };
 
 class ManifestDumpCommand : public LDBCommand {
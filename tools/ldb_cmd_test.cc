@@ -11,6 +11,7 @@
 #include "db/version_edit.h"
 #include "db/version_set.h"
 #include "env/composite_env_wrapper.h"
+#include "file/file_util.h"
 #include "file/filename.h"
 #include "port/stack_trace.h"
 #include "rocksdb/advanced_options.h"
@@ -1207,6 +1208,91 @@ TEST_F(LdbCmdTest, RenameDbAndLoadOptions) {
   ASSERT_OK(DestroyDB(new_dbname, opts));
 }
 
+TEST_F(LdbCmdTest, DumpExportAndLoadImport) {
+  Env* env = TryLoadCustomOrDefaultEnv();
+  Options opts;
+  opts.env = env;
+  opts.create_if_missing = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  opts.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  const std::string dbname = test::PerThreadDBPath(env, "ldb_cmd_test_export");
+  const std::string new_dbname =
+      test::PerThreadDBPath(env, "ldb_cmd_test_import");
+  const std::string export_dir =
+      test::PerThreadDBPath(env, "ldb_cmd_test_partitions");
+  ASSERT_OK(DestroyDB(dbname, opts));
+  ASSERT_OK(DestroyDB(new_dbname, opts));
+  DestroyDir(env, export_dir).PermitUncheckedError();
+
+  // Overlapping files, with overwritten and deleted keys
+  auto key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06d", i);
+    return std::string(buf);
+  };
+  DB* db = nullptr;
+  ASSERT_OK(DB::Open(opts, dbname, &db));
+  Random rnd(301);
+  for (int f = 0; f < 4; ++f) {
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_OK(db->Put(WriteOptions(), key(i * 4 + f % 3),
+                        rnd.RandomBinaryString(100)));
+    }
+    ASSERT_OK(db->Flush(FlushOptions()));
+  }
+  for (int i = 0; i < 4000; i += 7) {
+    ASSERT_OK(db->Delete(WriteOptions(), key(i)));
+  }
+  std::map<std::string, std::string> expected;
+  {
+    std::unique_ptr<Iterator> iter(db->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      expected[iter->key().ToString()] = iter->value().ToString();
+    }
+    ASSERT_OK(iter->status());
+  }
+  delete db;
+
+  const std::string db_arg = "--db=" + dbname;
+  const std::string new_db_arg = "--db=" + new_dbname;
+  const std::string export_arg = "--export_dir=" + export_dir;
+  const std::string import_arg = "--import_dir=" + export_dir;
+  const char* dump_argv[] = {"./ldb", db_arg.c_str(),     "dump",
+                             "--hex", export_arg.c_str(), "--parallelism=4"};
+  const char* load_argv[] = {"./ldb",
+                             new_db_arg.c_str(),
+                             "load",
+                             "--hex",
+                             "--create_if_missing",
+                             import_arg.c_str(),
+                             "--parallelism=4"};
+  ASSERT_EQ(0, LDBCommandRunner::RunCommand(6, const_cast<char**>(dump_argv),
+                                            opts, LDBOptions(), nullptr));
+  // The partitions of an earlier export are not overwritten
+  ASSERT_NE(0, LDBCommandRunner::RunCommand(6, const_cast<char**>(dump_argv),
+                                            opts, LDBOptions(), nullptr));
+  ASSERT_EQ(0, LDBCommandRunner::RunCommand(7, const_cast<char**>(load_argv),
+                                            opts, LDBOptions(), nullptr));
+
+  ASSERT_OK(DB::Open(opts, new_dbname, &db));
+  std::map<std::string, std::string> actual;
+  {
+    std::unique_ptr<Iterator> iter(db->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      actual[iter->key().ToString()] = iter->value().ToString();
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(expected, actual);
+  delete db;
+
+  ASSERT_OK(DestroyDB(dbname, opts));
+  ASSERT_OK(DestroyDB(new_dbname, opts));
+  ASSERT_OK(DestroyDir(env, export_dir));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -7,6 +7,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
 #include <cstdint>
 
 #include "db/wide/wide_column_serialization.h"
@@ -16,6 +17,7 @@
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/sst_dump_tool.h"
 #include "table/block_based/block_based_table_factory.h"
+#include "table/sst_file_dumper.h"
 #include "table/table_builder.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
@@ -445,6 +447,71 @@ TEST_F(SSTDumpToolTest, ValidSSTPath) {
   }
 }
 
+TEST_F(SSTDumpToolTest, Parallelism) {
+  Options opts;
+  opts.env = env();
+  std::vector<std::string> files = {MakeFilePath("rocksdb_sst_test1.sst"),
+                                    MakeFilePath("rocksdb_sst_test2.sst"),
+                                    MakeFilePath("rocksdb_sst_test3.sst")};
+  for (const auto& file : files) {
+    createSST(opts, file);
+  }
+
+  char* usage[5];
+  // The directory of the files
+  PopulateCommandArgs(MakeFilePath(""), "", usage);
+  snprintf(usage[3], kOptLength, "--parallelism=2");
+  snprintf(usage[4], kOptLength, "--use_mmap_reads");
+  SSTDumpTool tool;
+  for (const auto& command : {"--command=check", "--command=verify"}) {
+    snprintf(usage[1], kOptLength, "%s", command);
+    ASSERT_TRUE(!tool.Run(5, usage, opts));
+  }
+
+  for (const auto& file : files) {
+    cleanup(opts, file);
+  }
+  for (int i = 0; i < 5; i++) {
+    delete[] usage[i];
+  }
+}
+
+TEST_F(SSTDumpToolTest, SplitKeys) {
+  Options opts;
+  opts.env = env();
+  std::string file_path = MakeFilePath("rocksdb_sst_test.sst");
+  createSST(opts, file_path);
+
+  SstFileDumper dumper(opts, file_path, Temperature::kUnknown,
+                       /*readahead_size=*/0, /*verify_checksum=*/true,
+                       /*output_hex=*/false, /*decode_blob_index=*/false,
+                       EnvOptions(), /*silent=*/true);
+  ASSERT_OK(dumper.getStatus());
+  // A split after each data block
+  std::vector<std::string> split_keys;
+  ASSERT_OK(dumper.GetSplitKeys(/*split_bytes=*/1, &split_keys));
+  ASSERT_GE(split_keys.size(), 2U);
+  ASSERT_TRUE(std::is_sorted(split_keys.begin(), split_keys.end()));
+
+  // The ranges between the keys hold every entry once
+  uint64_t num_entries = 0;
+  for (size_t k = 0; k <= split_keys.size(); k++) {
+    SstFileDumper range_dumper(opts, file_path, Temperature::kUnknown,
+                               /*readahead_size=*/0, /*verify_checksum=*/true,
+                               /*output_hex=*/false,
+                               /*decode_blob_index=*/false, EnvOptions(),
+                               /*silent=*/true);
+    ASSERT_OK(range_dumper.ReadSequential(
+        /*print_kv=*/false, /*read_num=*/0, k > 0,
+        k > 0 ? split_keys[k - 1] : "", k < split_keys.size(),
+        k < split_keys.size() ? split_keys[k] : ""));
+    num_entries += range_dumper.GetReadNumber();
+  }
+  ASSERT_EQ(static_cast<uint64_t>(kNumKey), num_entries);
+
+  cleanup(opts, file_path);
+}
+
 TEST_F(SSTDumpToolTest, RawOutput) {
   Options opts;
   opts.env = env();
@@ -359,6 +359,30 @@ TEST_F(TraceAnalyzerTest, Put) {
   */
 }
 
+// Test the output of the workload model
+TEST_F(TraceAnalyzerTest, WorkloadModel) {
+  std::string trace_path = test_path_ + "/trace";
+  std::string output_path = test_path_ + "/workload_model";
+  std::vector<std::string> paras = {
+      "-analyze_get=true",           "-analyze_put=true",
+      "-analyze_delete=false",       "-analyze_single_delete=false",
+      "-analyze_range_delete=false", "-analyze_iterator=false",
+      "-analyze_multiget=false",     "-output_workload_model"};
+  paras.push_back("-output_dir=" + output_path);
+  paras.push_back("-trace_path=" + trace_path);
+  paras.push_back("-key_space_dir=" + test_path_);
+  AnalyzeTrace(paras, output_path, trace_path);
+
+  // Key "a" is put and got, key "g" is only got
+  std::vector<std::string> model = {"# RocksDB workload model",
+                                    "op get 2",
+                                    "op put 1",
+                                    "key_access 1 1",
+                                    "key_access 2 1",
+                                    "value_size 8 16 1"};
+  CheckFileContent(model, output_path + "/test-workload_model.txt", true);
+}
+
 // Test analyzing of delete
 TEST_F(TraceAnalyzerTest, Delete) {
   std::string trace_path = test_path_ + "/trace";
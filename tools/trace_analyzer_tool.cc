@@ -110,6 +110,15 @@ DEFINE_bool(output_qps_stats, false,
             "For each cf and query, it will have its own qps output.\n"
             "File name: <prefix>-<query_type>-<cf_id>_qps_stats.txt \n"
             "Format:[query_count_in_this_second].");
+DEFINE_bool(output_workload_model, false,
+            "Output a model of the workload of the analyzed query types, "
+            "which db_bench --workload_model replays with the mixgraph "
+            "benchmark.\n"
+            "File name: <prefix>-workload_model.txt\n"
+            "Format: [op <query_type> <count>], "
+            "[key_access <access_count> <number_of_keys>] over all the "
+            "analyzed query types, and [value_size <begin> <end> <count>] of "
+            "the writes.");
 DEFINE_bool(no_print, false, "Do not print out any result");
 DEFINE_string(
     print_correlation, "",
@@ -640,9 +649,73 @@ Status TraceAnalyzer::MakeStatistics() {
     }
   }
 
+  if (FLAGS_output_workload_model) {
+    s = MakeStatisticWorkloadModel();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
   return Status::OK();
 }
 
+// Output the model of the workload: the count of each query type, the number
+// of keys accessed each number of times by any of the query types, and the
+// value size distribution of the writes
+Status TraceAnalyzer::MakeStatisticWorkloadModel() {
+  std::unique_ptr<ROCKSDB_NAMESPACE::WritableFile> model_f;
+  std::string model_name =
+      output_path_ + "/" + FLAGS_output_prefix + "-workload_model.txt";
+  Status s = env_->NewWritableFile(model_name, &model_f, env_options_);
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::string out = "# RocksDB workload model\n";
+  std::map<std::pair<uint32_t, std::string>, uint64_t> key_access;
+  std::map<uint64_t, uint64_t> value_size_stats;
+  for (int type = 0; type < kTaTypeNum; type++) {
+    if (!ta_[type].enabled) {
+      continue;
+    }
+    uint64_t count = 0;
+    for (auto& stat : ta_[type].stats) {
+      count += stat.second.a_count;
+      for (auto& record : stat.second.a_key_stats) {
+        key_access[{stat.first, record.first}] += record.second.access_count;
+      }
+      if (type == TraceOperationType::kPut ||
+          type == TraceOperationType::kMerge) {
+        for (auto& record : stat.second.a_value_size_stats) {
+          value_size_stats[record.first] += record.second;
+        }
+      }
+    }
+    out += "op " + ta_[type].type_name + " " + std::to_string(count) + "\n";
+  }
+
+  std::map<uint64_t, uint64_t> access_count_stats;
+  for (auto& record : key_access) {
+    access_count_stats[record.second]++;
+  }
+  for (auto& record : access_count_stats) {
+    out += "key_access " + std::to_string(record.first) + " " +
+           std::to_string(record.second) + "\n";
+  }
+  for (auto& record : value_size_stats) {
+    out += "value_size " + std::to_string(record.first * FLAGS_value_interval) +
+           " " + std::to_string((record.first + 1) * FLAGS_value_interval) +
+           " " + std::to_string(record.second) + "\n";
+  }
+
+  s = model_f->Append(out);
+  if (!s.ok()) {
+    fprintf(stderr, "Write workload model file failed\n");
+    return s;
+  }
+  return model_f->Close();
+}
+
 // Process the statistics of the key access and
 // prefix of the accessed keys if required
 Status TraceAnalyzer::MakeStatisticKeyStatsOrPrefix(TraceStats& stats) {
@@ -320,6 +320,7 @@ class TraceAnalyzer : private TraceRecord::Handler,
   Status MakeStatisticKeyStatsOrPrefix(TraceStats& stats);
   Status MakeStatisticCorrelation(TraceStats& stats, StatsUnit& unit);
   Status MakeStatisticQPS();
+  Status MakeStatisticWorkloadModel();
   int db_version_;
 };
 
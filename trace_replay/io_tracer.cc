@@ -5,6 +5,7 @@
 
 #include "trace_replay/io_tracer.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
@@ -16,6 +17,7 @@
 #include "rocksdb/trace_reader_writer.h"
 #include "util/coding.h"
 #include "util/hash.h"
+#include "util/random.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -32,6 +34,14 @@ Status IOTraceWriter::WriteIOOp(const IOTraceRecord& record,
   if (trace_file_size > trace_options_.max_trace_file_size) {
     return Status::OK();
   }
+  std::string encoded_trace;
+  EncodeIOOp(record, dbg, &encoded_trace);
+  return trace_writer_->Write(encoded_trace);
+}
+
+void IOTraceWriter::EncodeIOOp(const IOTraceRecord& record,
+                               IODebugContext* dbg,
+                               std::string* encoded_trace) {
   Trace trace;
   trace.ts = record.access_timestamp;
   trace.type = record.trace_type;
@@ -92,21 +102,75 @@ Status IOTraceWriter::WriteIOOp(const IOTraceRecord& record,
     trace_data &= (trace_data - 1);
   }
 
-  std::string encoded_trace;
-  TracerHelper::EncodeTrace(trace, &encoded_trace);
-  return trace_writer_->Write(encoded_trace);
+  encoded_trace->clear();
+  TracerHelper::EncodeTrace(trace, encoded_trace);
 }
 
 Status IOTraceWriter::WriteHeader() {
+  return WriteHeader(clock_, trace_writer_.get());
+}
+
+Status IOTraceWriter::WriteHeader(SystemClock* clock,
+                                  TraceWriter* trace_writer) {
   Trace trace;
-  trace.ts = clock_->NowMicros();
+  trace.ts = clock->NowMicros();
   trace.type = TraceType::kTraceBegin;
   PutLengthPrefixedSlice(&trace.payload, kTraceMagic);
   PutFixed32(&trace.payload, kMajorVersion);
   PutFixed32(&trace.payload, kMinorVersion);
   std::string encoded_trace;
   TracerHelper::EncodeTrace(trace, &encoded_trace);
-  return trace_writer_->Write(encoded_trace);
+  return trace_writer->Write(encoded_trace);
+}
+
+IOTraceRingBuffer::IOTraceRingBuffer(size_t num_records) {
+  slots_per_ring_ = std::max<size_t>(
+      1, (num_records + rings_.Size() - 1) / rings_.Size());
+  for (size_t i = 0; i < rings_.Size(); ++i) {
+    rings_.AccessAtCore(i)->slots.reset(new Slot[slots_per_ring_]);
+  }
+}
+
+void IOTraceRingBuffer::Add(const IOTraceRecord& record, IODebugContext* dbg) {
+  Ring* ring = rings_.Access();
+  Slot& slot = ring->slots[ring->next.FetchAddRelaxed(1) % slots_per_ring_];
+  if (!slot.TryLock()) {
+    // Being written by a thread that wrapped around the ring, or read by a
+    // dump
+    return;
+  }
+  slot.timestamp = record.access_timestamp;
+  IOTraceWriter::EncodeIOOp(record, dbg, &slot.encoded_trace);
+  slot.Unlock();
+}
+
+Status IOTraceRingBuffer::Dump(SystemClock* clock, uint64_t min_timestamp,
+                               TraceWriter* trace_writer) {
+  std::vector<std::pair<uint64_t, std::string>> traces;
+  for (size_t i = 0; i < rings_.Size(); ++i) {
+    Ring* ring = rings_.AccessAtCore(i);
+    for (size_t j = 0; j < slots_per_ring_; ++j) {
+      Slot& slot = ring->slots[j];
+      // Skips a slot being written, which holds a record too new to matter
+      if (!slot.TryLock()) {
+        continue;
+      }
+      if (!slot.encoded_trace.empty() && slot.timestamp >= min_timestamp) {
+        traces.emplace_back(slot.timestamp, slot.encoded_trace);
+      }
+      slot.Unlock();
+    }
+  }
+  std::stable_sort(traces.begin(), traces.end(),
+                   [](const std::pair<uint64_t, std::string>& a,
+                      const std::pair<uint64_t, std::string>& b) {
+                     return a.first < b.first;
+                   });
+  Status s = IOTraceWriter::WriteHeader(clock, trace_writer);
+  for (size_t i = 0; s.ok() && i < traces.size(); ++i) {
+    s = trace_writer->Write(traces[i].second);
+  }
+  return s;
 }
 
 IOTraceReader::IOTraceReader(std::unique_ptr<TraceReader>&& reader)
@@ -262,7 +326,10 @@ Status IOTraceReader::ReadIOOp(IOTraceRecord* record) {
   return Status::OK();
 }
 
-IOTracer::IOTracer() : tracing_enabled(false) { writer_.store(nullptr); }
+IOTracer::IOTracer() : tracing_enabled(false) {
+  writer_.store(nullptr);
+  ring_buffer_.store(nullptr);
+}
 
 IOTracer::~IOTracer() { EndIOTrace(); }
 
@@ -270,10 +337,22 @@ Status IOTracer::StartIOTrace(SystemClock* clock,
                               const TraceOptions& trace_options,
                               std::unique_ptr<TraceWriter>&& trace_writer) {
   InstrumentedMutexLock lock_guard(&trace_writer_mutex_);
-  if (writer_.load()) {
+  if (writer_.load() || ring_buffer_.load()) {
     return Status::Busy();
   }
   trace_options_ = trace_options;
+  sampling_frequency_.StoreRelaxed(trace_options.sampling_frequency);
+  if (trace_options.io_trace_ring_buffer_records > 0) {
+    clock_ = clock;
+    ring_buffers_.emplace_back(
+        new IOTraceRingBuffer(trace_options.io_trace_ring_buffer_records));
+    ring_buffer_.store(ring_buffers_.back().get());
+    tracing_enabled = true;
+    return Status::OK();
+  }
+  if (trace_writer == nullptr) {
+    return Status::InvalidArgument("A trace writer is required");
+  }
   writer_.store(
       new IOTraceWriter(clock, trace_options, std::move(trace_writer)));
   tracing_enabled = true;
@@ -282,7 +361,10 @@ Status IOTracer::StartIOTrace(SystemClock* clock,
 
 void IOTracer::EndIOTrace() {
   InstrumentedMutexLock lock_guard(&trace_writer_mutex_);
+  // The ring buffer is kept, as threads may still be adding to it
+  ring_buffer_.store(nullptr);
   if (!writer_.load()) {
+    tracing_enabled = false;
     return;
   }
   delete writer_.load();
@@ -290,7 +372,32 @@ void IOTracer::EndIOTrace() {
   tracing_enabled = false;
 }
 
+Status IOTracer::DumpIOTrace(uint64_t last_micros,
+                             std::unique_ptr<TraceWriter>&& trace_writer) {
+  InstrumentedMutexLock lock_guard(&trace_writer_mutex_);
+  IOTraceRingBuffer* ring_buffer = ring_buffer_.load();
+  if (ring_buffer == nullptr) {
+    return Status::InvalidArgument("Not tracing IO to a ring buffer");
+  }
+  const uint64_t now = clock_->NowNanos();
+  const uint64_t last_nanos = last_micros * 1000;
+  return ring_buffer->Dump(clock_, now > last_nanos ? now - last_nanos : 0,
+                           trace_writer.get());
+}
+
 void IOTracer::WriteIOOp(const IOTraceRecord& record, IODebugContext* dbg) {
+  const uint64_t sampling_frequency = sampling_frequency_.LoadRelaxed();
+  if (sampling_frequency > 1 &&
+      !Random::GetTLSInstance()->OneIn(
+          static_cast<uint32_t>(std::min<uint64_t>(sampling_frequency,
+                                                   UINT32_MAX)))) {
+    return;
+  }
+  IOTraceRingBuffer* ring_buffer = ring_buffer_.load();
+  if (ring_buffer != nullptr) {
+    ring_buffer->Add(record, dbg);
+    return;
+  }
   if (!writer_.load()) {
     return;
   }
@@ -7,6 +7,7 @@
 
 #include <atomic>
 #include <fstream>
+#include <vector>
 
 #include "monitoring/instrumented_mutex.h"
 #include "port/lang.h"
@@ -14,6 +15,8 @@
 #include "rocksdb/options.h"
 #include "rocksdb/trace_record.h"
 #include "trace_replay/trace_replay.h"
+#include "util/atomic.h"
+#include "util/core_local.h"
 
 namespace ROCKSDB_NAMESPACE {
 class SystemClock;
@@ -116,12 +119,55 @@ class IOTraceWriter {
   // with some metadata like a magic number and RocksDB version.
   Status WriteHeader();
 
+  static Status WriteHeader(SystemClock* clock, TraceWriter* trace_writer);
+
+  // Encodes `record` as WriteIOOp() writes it into `*encoded_trace`
+  static void EncodeIOOp(const IOTraceRecord& record, IODebugContext* dbg,
+                         std::string* encoded_trace);
+
  private:
   SystemClock* clock_;
   TraceOptions trace_options_;
   std::unique_ptr<TraceWriter> trace_writer_;
 };
 
+// The last encoded IO trace records, kept in memory in a ring per core until
+// they are dumped to a trace file. Adding a record takes no lock; a record
+// whose slot is in use by another thread is dropped.
+class IOTraceRingBuffer {
+ public:
+  // Keeps about `num_records` records overall
+  explicit IOTraceRingBuffer(size_t num_records);
+
+  void Add(const IOTraceRecord& record, IODebugContext* dbg);
+
+  // Writes a trace header and the records with an access timestamp of at
+  // least `min_timestamp` nanos in timestamp order to `trace_writer`
+  Status Dump(SystemClock* clock, uint64_t min_timestamp,
+              TraceWriter* trace_writer);
+
+ private:
+  struct Slot {
+    AcqRelAtomic<bool> busy{false};
+    uint64_t timestamp = 0;
+    std::string encoded_trace;
+
+    bool TryLock() {
+      bool expected = false;
+      return busy.CasStrong(expected, true);
+    }
+    void Unlock() { busy.Store(false); }
+  };
+
+  struct Ring {
+    std::unique_ptr<Slot[]> slots;
+    RelaxedAtomic<size_t> next{0};
+  };
+
+  CoreLocalArray<Ring> rings_;
+  size_t slots_per_ring_;
+};
+
 // IOTraceReader helps read the trace file generated by IOTraceWriter.
 class IOTraceReader {
  public:
@@ -159,7 +205,9 @@ class IOTracer {
   // mutex and ignore the operation if writer_is null. So its ok if
   // tracing_enabled shows non updated value.
 
-  // Start writing IO operations to the trace_writer.
+  // Start writing IO operations to the trace_writer, or to a ring buffer if
+  // trace_options.io_trace_ring_buffer_records > 0, in which case
+  // trace_writer is not used.
   TSAN_SUPPRESSION Status
   StartIOTrace(SystemClock* clock, const TraceOptions& trace_options,
                std::unique_ptr<TraceWriter>&& trace_writer);
@@ -167,6 +215,11 @@ class IOTracer {
   // Stop writing IO operations to the trace_writer.
   TSAN_SUPPRESSION void EndIOTrace();
 
+  // Writes the IO operations of the last `last_micros` in the ring buffer to
+  // trace_writer, as a trace file readable by IOTraceReader.
+  Status DumpIOTrace(uint64_t last_micros,
+                     std::unique_ptr<TraceWriter>&& trace_writer);
+
   TSAN_SUPPRESSION bool is_tracing_enabled() const { return tracing_enabled; }
 
   void WriteIOOp(const IOTraceRecord& record, IODebugContext* dbg);
@@ -176,6 +229,12 @@ class IOTracer {
   // A mutex protects the writer_.
   InstrumentedMutex trace_writer_mutex_;
   std::atomic<IOTraceWriter*> writer_;
+  std::atomic<IOTraceRingBuffer*> ring_buffer_;
+  // The ring buffers of all the traces, never freed before the tracer, as a
+  // thread may still add to one after its trace ended
+  std::vector<std::unique_ptr<IOTraceRingBuffer>> ring_buffers_;
+  SystemClock* clock_ = nullptr;
+  RelaxedAtomic<uint64_t> sampling_frequency_{1};
   // bool tracing_enabled is added to avoid costly operation of checking atomic
   // variable 'writer_' is nullptr or not in is_tracing_enabled().
   // is_tracing_enabled() is invoked multiple times by FileSystem classes.
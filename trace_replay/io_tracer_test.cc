@@ -344,6 +344,58 @@ TEST_F(IOTracerTest, AtomicMultipleWrites) {
     ASSERT_NOK(reader.ReadIOOp(&record));
   }
 }
+
+TEST_F(IOTracerTest, RingBuffer) {
+  TraceOptions trace_opt;
+  trace_opt.io_trace_ring_buffer_records = 1000;
+  IOTracer tracer;
+  ASSERT_OK(tracer.StartIOTrace(clock_, trace_opt, nullptr));
+  ASSERT_TRUE(tracer.is_tracing_enabled());
+  // Only one trace at a time
+  ASSERT_TRUE(tracer.StartIOTrace(clock_, trace_opt, nullptr).IsBusy());
+
+  const uint64_t now = clock_->NowNanos();
+  for (uint64_t i = 0; i < 10; i++) {
+    IOTraceRecord record;
+    record.io_op_data = 1 << IOTraceOp::kIOLen;
+    record.trace_type = TraceType::kIOTracer;
+    // The first five are from a minute ago
+    record.access_timestamp =
+        i < 5 ? now - uint64_t{60} * 1000 * 1000 * 1000 : now + i;
+    record.file_operation = GetFileOperation(i);
+    record.io_status = IOStatus::OK().ToString();
+    record.file_name = kDummyFile + std::to_string(i);
+    record.len = i;
+    tracer.WriteIOOp(record, nullptr);
+  }
+
+  std::unique_ptr<TraceWriter> trace_writer;
+  ASSERT_OK(NewFileTraceWriter(env_, env_options_, trace_file_path_,
+                               &trace_writer));
+  ASSERT_OK(tracer.DumpIOTrace(/*last_micros=*/10 * 1000 * 1000,
+                               std::move(trace_writer)));
+  tracer.EndIOTrace();
+  ASSERT_FALSE(tracer.is_tracing_enabled());
+  ASSERT_TRUE(tracer.DumpIOTrace(1000, nullptr).IsInvalidArgument());
+
+  std::unique_ptr<TraceReader> trace_reader;
+  ASSERT_OK(NewFileTraceReader(env_, env_options_, trace_file_path_,
+                               &trace_reader));
+  IOTraceReader reader(std::move(trace_reader));
+  IOTraceHeader header;
+  ASSERT_OK(reader.ReadHeader(&header));
+  ASSERT_EQ(kMajorVersion, static_cast<int>(header.rocksdb_major_version));
+  // The last five, in timestamp order
+  for (uint64_t i = 5; i < 10; i++) {
+    IOTraceRecord record;
+    ASSERT_OK(reader.ReadIOOp(&record));
+    ASSERT_EQ(record.access_timestamp, now + i);
+    ASSERT_EQ(record.file_operation, GetFileOperation(i));
+    ASSERT_EQ(record.len, i);
+  }
+  IOTraceRecord record;
+  ASSERT_NOK(reader.ReadIOOp(&record));
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -1183,6 +1183,87 @@ TEST(RibbonTest, RibbonTestLevelThreshold) {
   }
 }
 
+namespace {
+// Key with a two byte prefix followed by `value` in big-endian order
+std::string RangeTestKey(uint64_t value) {
+  std::string key = "ab";
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>(value >> shift));
+  }
+  return key;
+}
+}  // namespace
+
+TEST(RangeFilterTest, RangeMayMatch) {
+  BlockBasedTableOptions opts;
+  FilterBuildingContext ctx(opts);
+  std::shared_ptr<const FilterPolicy> policy(
+      NewRangeFilterPolicy(10, /*prefix_len*/ 2, /*levels*/ 8));
+
+  std::unique_ptr<FilterBitsBuilder> builder(
+      policy->GetBuilderWithContext(ctx));
+  ASSERT_NE(builder, nullptr);
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    builder->AddKey(RangeTestKey(i * 1000));
+  }
+  std::unique_ptr<const char[]> buf;
+  Slice filter = builder->Finish(&buf);
+  ASSERT_OK(builder->MaybePostVerify(filter));
+
+  std::unique_ptr<FilterBitsReader> reader(
+      policy->GetFilterBitsReader(filter));
+
+  int fps = 0;
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    const uint64_t value = i * 1000;
+    // No false negatives
+    ASSERT_TRUE(reader->MayMatch(RangeTestKey(value)));
+    ASSERT_TRUE(reader->RangeMayMatch(RangeTestKey(value),
+                                      RangeTestKey(value + 1)));
+    ASSERT_TRUE(reader->RangeMayMatch(RangeTestKey(value - 50),
+                                      RangeTestKey(value + 50)));
+    ASSERT_TRUE(reader->RangeMayMatch(RangeTestKey(value - 100),
+                                      RangeTestKey(value)));
+    // Empty range
+    if (reader->RangeMayMatch(RangeTestKey(value + 1),
+                              RangeTestKey(value + 101))) {
+      ++fps;
+    }
+  }
+  // Up to about 2 * levels probes per range at about 1% FP rate each
+  EXPECT_LT(fps, 200);
+
+  // Ranges with different prefixes are not ruled out
+  ASSERT_TRUE(reader->RangeMayMatch("aa", "ac"));
+  ASSERT_TRUE(reader->RangeMayMatch("a", RangeTestKey(1)));
+  // Ranges too wide to check are not ruled out
+  ASSERT_TRUE(
+      reader->RangeMayMatch(RangeTestKey(1), RangeTestKey(uint64_t{1} << 40)));
+  // Nothing is in an empty range
+  ASSERT_FALSE(reader->RangeMayMatch(RangeTestKey(2), RangeTestKey(1)));
+
+  // Non-range filters do not rule out ranges
+  std::shared_ptr<const FilterPolicy> bloom(NewBloomFilterPolicy(10));
+  builder.reset(bloom->GetBuilderWithContext(ctx));
+  builder->AddKey(RangeTestKey(0));
+  filter = builder->Finish(&buf);
+  reader.reset(bloom->GetFilterBitsReader(filter));
+  ASSERT_TRUE(reader->RangeMayMatch(RangeTestKey(1), RangeTestKey(2)));
+}
+
+TEST(RangeFilterTest, CreateFromString) {
+  ConfigOptions config_options;
+  std::shared_ptr<const FilterPolicy> policy;
+  ASSERT_OK(FilterPolicy::CreateFromString(config_options, "rangefilter:10:4:6",
+                                           &policy));
+  auto rfp = dynamic_cast<const RangeFilterPolicy*>(policy.get());
+  ASSERT_NE(rfp, nullptr);
+  ASSERT_EQ(rfp->GetMillibitsPerKey(), 10000);
+  ASSERT_EQ(rfp->GetPrefixLen(), 4U);
+  ASSERT_EQ(rfp->GetLevels(), 6);
+  ASSERT_EQ(rfp->GetId(), "rangefilter:10:4:6");
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -168,6 +168,33 @@ TEST(Coding, Varint32Truncation) {
   ASSERT_EQ(large_value, result);
 }
 
+TEST(Coding, ShortVarint32) {
+  // Compares with GetVarint32Ptr on each prefix of the input
+  auto check = [](const std::string& s) {
+    for (size_t len = 0; len <= s.size(); len++) {
+      const char* limit = s.data() + len;
+      uint32_t expected = 0;
+      const char* expected_end = GetVarint32Ptr(s.data(), limit, &expected);
+      uint32_t actual = 0;
+      const char* actual_end = GetShortVarint32Ptr(s.data(), limit, &actual);
+      ASSERT_EQ(expected_end, actual_end);
+      if (expected_end != nullptr) {
+        ASSERT_EQ(expected, actual);
+      }
+    }
+  };
+
+  for (uint32_t v : {0u, 1u, 127u, 128u, 16383u, 16384u, (1u << 21) - 1,
+                     1u << 21, 1u << 28, 0xffffffffu}) {
+    std::string s;
+    PutVarint32(&s, v);
+    check(s);
+    s.push_back('\x01');
+    check(s);
+  }
+  check("\x81\x82\x83\x84\x85\x11");
+}
+
 TEST(Coding, Varint64Overflow) {
   uint64_t result;
   std::string input("\x81\x82\x83\x84\x85\x81\x82\x83\x84\x85\x11");
@@ -29,6 +29,7 @@ void CompactionJobStats::Reset() {
   total_blob_bytes_read = 0;
   total_output_bytes = 0;
   total_output_bytes_blob = 0;
+  total_trivially_moved_bytes = 0;
 
   num_records_replaced = 0;
 
@@ -44,6 +45,9 @@ void CompactionJobStats::Reset() {
   file_range_sync_nanos = 0;
   file_fsync_nanos = 0;
   file_prepare_write_nanos = 0;
+  input_read_cpu_nanos = 0;
+  output_write_cpu_nanos = 0;
+  merge_cpu_nanos = 0;
 
   smallest_output_key_prefix.clear();
   largest_output_key_prefix.clear();
@@ -70,6 +74,7 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   total_blob_bytes_read += stats.total_blob_bytes_read;
   total_output_bytes += stats.total_output_bytes;
   total_output_bytes_blob += stats.total_output_bytes_blob;
+  total_trivially_moved_bytes += stats.total_trivially_moved_bytes;
 
   num_records_replaced += stats.num_records_replaced;
 
@@ -85,6 +90,9 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   file_range_sync_nanos += stats.file_range_sync_nanos;
   file_fsync_nanos += stats.file_fsync_nanos;
   file_prepare_write_nanos += stats.file_prepare_write_nanos;
+  input_read_cpu_nanos += stats.input_read_cpu_nanos;
+  output_write_cpu_nanos += stats.output_write_cpu_nanos;
+  merge_cpu_nanos += stats.merge_cpu_nanos;
 
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
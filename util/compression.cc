@@ -5,8 +5,16 @@
 
 #include "util/compression.h"
 
+#include "rocksdb/utilities/customizable_util.h"
+
 namespace ROCKSDB_NAMESPACE {
 
+Status Compressor::CreateFromString(const ConfigOptions& config_options,
+                                    const std::string& id,
+                                    std::shared_ptr<Compressor>* result) {
+  return LoadSharedObject<Compressor>(config_options, id, result);
+}
+
 StreamingCompress* StreamingCompress::Create(CompressionType compression_type,
                                              const CompressionOptions& opts,
                                              uint32_t compress_format_version,
@@ -21,6 +21,7 @@
 #include <string>
 
 #include "memory/memory_allocator_impl.h"
+#include "rocksdb/compressor.h"
 #include "rocksdb/options.h"
 #include "rocksdb/table.h"
 #include "table/block_based/block_type.h"
@@ -129,6 +130,51 @@ class ZSTDUncompressCachedData {
   ZSTDNativeContext zstd_ctx_ = nullptr;
   int64_t cache_idx_ = -1;  // -1 means this instance owns the context
 };
+
+// Same as ZSTDUncompressCachedData, for compression contexts
+class ZSTDCompressCachedData {
+ public:
+  using ZSTDNativeContext = ZSTD_CCtx*;
+  ZSTDCompressCachedData() {}
+  ZSTDCompressCachedData(const ZSTDCompressCachedData& o) = delete;
+  ZSTDCompressCachedData& operator=(const ZSTDCompressCachedData&) = delete;
+  ZSTDCompressCachedData(ZSTDCompressCachedData&& o) noexcept
+      : ZSTDCompressCachedData() {
+    *this = std::move(o);
+  }
+  ZSTDCompressCachedData& operator=(ZSTDCompressCachedData&& o) noexcept {
+    assert(zstd_ctx_ == nullptr);
+    std::swap(zstd_ctx_, o.zstd_ctx_);
+    std::swap(cache_idx_, o.cache_idx_);
+    return *this;
+  }
+  ZSTDNativeContext Get() const { return zstd_ctx_; }
+  int64_t GetCacheIndex() const { return cache_idx_; }
+  void CreateIfNeeded() {
+    if (zstd_ctx_ == nullptr) {
+#ifdef ROCKSDB_ZSTD_CUSTOM_MEM
+      zstd_ctx_ =
+          ZSTD_createCCtx_advanced(port::GetJeZstdAllocationOverrides());
+#else   // ROCKSDB_ZSTD_CUSTOM_MEM
+      zstd_ctx_ = ZSTD_createCCtx();
+#endif  // ROCKSDB_ZSTD_CUSTOM_MEM
+      cache_idx_ = -1;
+    }
+  }
+  void InitFromCache(const ZSTDCompressCachedData& o, int64_t idx) {
+    zstd_ctx_ = o.zstd_ctx_;
+    cache_idx_ = idx;
+  }
+  ~ZSTDCompressCachedData() {
+    if (zstd_ctx_ != nullptr && cache_idx_ == -1) {
+      ZSTD_freeCCtx(zstd_ctx_);
+    }
+  }
+
+ private:
+  ZSTDNativeContext zstd_ctx_ = nullptr;
+  int64_t cache_idx_ = -1;  // -1 means this instance owns the context
+};
 #endif  // (ZSTD_VERSION_NUMBER >= 500)
 }  // namespace ROCKSDB_NAMESPACE
 #endif  // ZSTD
@@ -153,6 +199,25 @@ class ZSTDUncompressCachedData {
  private:
   void ignore_padding__() { padding = nullptr; }
 };
+
+class ZSTDCompressCachedData {
+  void* padding;  // unused
+ public:
+  using ZSTDNativeContext = void*;
+  ZSTDCompressCachedData() {}
+  ZSTDCompressCachedData(const ZSTDCompressCachedData&) {}
+  ZSTDCompressCachedData& operator=(const ZSTDCompressCachedData&) = delete;
+  ZSTDCompressCachedData(ZSTDCompressCachedData&&) noexcept = default;
+  ZSTDCompressCachedData& operator=(ZSTDCompressCachedData&&) noexcept =
+      default;
+  ZSTDNativeContext Get() const { return nullptr; }
+  int64_t GetCacheIndex() const { return -1; }
+  void CreateIfNeeded() {}
+  void InitFromCache(const ZSTDCompressCachedData&, int64_t) {}
+
+ private:
+  void ignore_padding__() { padding = nullptr; }
+};
 }  // namespace ROCKSDB_NAMESPACE
 #endif
 
@@ -369,18 +434,14 @@ class CompressionContext {
  private:
 #if defined(ZSTD) && (ZSTD_VERSION_NUMBER >= 500)
   ZSTD_CCtx* zstd_ctx_ = nullptr;
-
-  ZSTD_CCtx* CreateZSTDContext() {
-#ifdef ROCKSDB_ZSTD_CUSTOM_MEM
-    return ZSTD_createCCtx_advanced(port::GetJeZstdAllocationOverrides());
-#else   // ROCKSDB_ZSTD_CUSTOM_MEM
-    return ZSTD_createCCtx();
-#endif  // ROCKSDB_ZSTD_CUSTOM_MEM
-  }
+  ZSTDCompressCachedData zstd_cached_data_;
 
   void CreateNativeContext(CompressionType type, int level, bool checksum) {
     if (type == kZSTD || type == kZSTDNotFinalCompression) {
-      zstd_ctx_ = CreateZSTDContext();
+      // Contexts come back to the cache reset, see DestroyNativeContext()
+      zstd_cached_data_ =
+          CompressionContextCache::Instance()->GetCachedZSTDCompressData();
+      zstd_ctx_ = zstd_cached_data_.Get();
 #ifdef ZSTD_ADVANCED
       if (level == CompressionOptions::kDefaultCompressionLevel) {
         // 3 is the value of ZSTD_CLEVEL_DEFAULT (not exposed publicly), see
@@ -391,15 +452,13 @@ class CompressionContext {
           ZSTD_CCtx_setParameter(zstd_ctx_, ZSTD_c_compressionLevel, level);
       if (ZSTD_isError(err)) {
         assert(false);
-        ZSTD_freeCCtx(zstd_ctx_);
-        zstd_ctx_ = CreateZSTDContext();
+        ZSTD_CCtx_reset(zstd_ctx_, ZSTD_reset_parameters);
       }
       if (checksum) {
         err = ZSTD_CCtx_setParameter(zstd_ctx_, ZSTD_c_checksumFlag, 1);
         if (ZSTD_isError(err)) {
           assert(false);
-          ZSTD_freeCCtx(zstd_ctx_);
-          zstd_ctx_ = CreateZSTDContext();
+          ZSTD_CCtx_reset(zstd_ctx_, ZSTD_reset_parameters);
         }
       }
 #else
@@ -409,9 +468,16 @@ class CompressionContext {
     }
   }
   void DestroyNativeContext() {
-    if (zstd_ctx_ != nullptr) {
-      ZSTD_freeCCtx(zstd_ctx_);
+    if (zstd_cached_data_.GetCacheIndex() != -1) {
+#ifdef ZSTD_ADVANCED
+      // Drop the parameters and the dictionary of this use, the latter
+      // possibly referenced rather than copied
+      ZSTD_CCtx_reset(zstd_ctx_, ZSTD_reset_session_and_parameters);
+#endif  // ZSTD_ADVANCED
+      CompressionContextCache::Instance()->ReturnCachedZSTDCompressData(
+          zstd_cached_data_.GetCacheIndex());
     }
+    // Otherwise zstd_cached_data_ owns the context and frees it
   }
 
  public:
@@ -1668,6 +1734,51 @@ inline bool CompressData(const Slice& raw,
   return ret;
 }
 
+// Compresses `raw` with `compressor` in place of the built-in library, into
+// the same format as CompressData. Returns false, for the caller to fall back
+// to CompressData, if the compressor is not for compression_info.type() or
+// fails.
+inline bool CompressWithCompressor(Compressor* compressor, const Slice& raw,
+                                   const CompressionInfo& compression_info,
+                                   uint32_t compress_format_version,
+                                   std::string* compressed_output) {
+  if (compressor == nullptr ||
+      compressor->GetCompressionType() != compression_info.type() ||
+      !compression_info.dict().GetRawDict().empty() ||
+      raw.size() > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  switch (compression_info.type()) {
+    case kSnappyCompression:
+      break;
+    case kZlibCompression:
+    case kBZip2Compression:
+    case kLZ4Compression:
+    case kLZ4HCCompression:
+      if (compress_format_version != 2) {
+        // The legacy formats are not supported
+        return false;
+      }
+      compression::PutDecompressedSizeInfo(compressed_output,
+                                            static_cast<uint32_t>(raw.size()));
+      break;
+    case kZSTD:
+    case kZSTDNotFinalCompression:
+      compression::PutDecompressedSizeInfo(compressed_output,
+                                            static_cast<uint32_t>(raw.size()));
+      break;
+    default:
+      return false;
+  }
+  Status s =
+      compressor->Compress(compression_info.options(), raw, compressed_output);
+  if (!s.ok()) {
+    compressed_output->clear();
+    return false;
+  }
+  return true;
+}
+
 inline CacheAllocationPtr UncompressData(
     const UncompressionInfo& uncompression_info, const char* data, size_t n,
     size_t* uncompressed_size, uint32_t compress_format_version,
@@ -9,8 +9,10 @@
 
 #include "util/compression_context_cache.h"
 
+#include <algorithm>
 #include <atomic>
 
+#include "monitoring/perf_context_imp.h"
 #include "util/compression.h"
 #include "util/core_local.h"
 
@@ -18,69 +20,102 @@ namespace ROCKSDB_NAMESPACE {
 namespace compression_cache {
 
 void* const SentinelValue = nullptr;
-// Cache ZSTD uncompression contexts for reads
-// if needed we can add ZSTD compression context caching
-// which is currently is not done since BlockBasedTableBuilder
-// simply creates one compression context per new SST file.
+// Number of cores whose cached instance is tried before creating a one time
+// instance, starting at the current core
+constexpr size_t kMaxCoresToTry = 4;
+
+// Cache ZSTD uncompression contexts for reads and ZSTD compression contexts,
+// which are mostly short lived, e.g. for a blob or an entry of the compressed
+// secondary cache. A BlockBasedTableBuilder keeps its compression contexts
+// for the whole SST file, and the instances of their cores borrowed meanwhile.
+template <class TCachedData>
 struct ZSTDCachedData {
   // We choose to cache the below structure instead of a ptr
   // because we want to avoid a) native types leak b) make
   // cache use transparent for the user
-  ZSTDUncompressCachedData uncomp_cached_data_;
-  std::atomic<void*> zstd_uncomp_sentinel_;
+  TCachedData cached_data_;
+  std::atomic<void*> zstd_sentinel_;
 
-  char
-      padding[(CACHE_LINE_SIZE -
-               (sizeof(ZSTDUncompressCachedData) + sizeof(std::atomic<void*>)) %
-                   CACHE_LINE_SIZE)];  // unused padding field
+  char padding[(CACHE_LINE_SIZE -
+                (sizeof(TCachedData) + sizeof(std::atomic<void*>)) %
+                    CACHE_LINE_SIZE)];  // unused padding field
 
-  ZSTDCachedData() : zstd_uncomp_sentinel_(&uncomp_cached_data_) {}
+  ZSTDCachedData() : zstd_sentinel_(&cached_data_) {}
   ZSTDCachedData(const ZSTDCachedData&) = delete;
   ZSTDCachedData& operator=(const ZSTDCachedData&) = delete;
 
-  ZSTDUncompressCachedData GetUncompressData(int64_t idx) {
-    ZSTDUncompressCachedData result;
-    void* expected = &uncomp_cached_data_;
-    if (zstd_uncomp_sentinel_.compare_exchange_strong(expected,
-                                                      SentinelValue)) {
-      uncomp_cached_data_.CreateIfNeeded();
-      result.InitFromCache(uncomp_cached_data_, idx);
-    } else {
-      // Creates one time use data
-      result.CreateIfNeeded();
+  // Returns whether the cached data could be borrowed
+  bool TryGet(int64_t idx, TCachedData* result) {
+    void* expected = &cached_data_;
+    if (!zstd_sentinel_.compare_exchange_strong(expected, SentinelValue)) {
+      return false;
     }
-    return result;
+    cached_data_.CreateIfNeeded();
+    result->InitFromCache(cached_data_, idx);
+    return true;
   }
   // Return the entry back into circulation
   // This is executed only when we successfully obtained
   // in the first place
-  void ReturnUncompressData() {
-    if (zstd_uncomp_sentinel_.exchange(&uncomp_cached_data_) != SentinelValue) {
+  void Return() {
+    if (zstd_sentinel_.exchange(&cached_data_) != SentinelValue) {
       // Means we are returning while not having it acquired.
       assert(false);
     }
   }
 };
-static_assert(sizeof(ZSTDCachedData) % CACHE_LINE_SIZE == 0,
+static_assert(sizeof(ZSTDCachedData<ZSTDUncompressCachedData>) %
+                      CACHE_LINE_SIZE ==
+                  0,
+              "Expected CACHE_LINE_SIZE alignment");
+static_assert(sizeof(ZSTDCachedData<ZSTDCompressCachedData>) %
+                      CACHE_LINE_SIZE ==
+                  0,
               "Expected CACHE_LINE_SIZE alignment");
+
+template <class TCachedData>
+class PerCoreCache {
+ public:
+  TCachedData Get() {
+    TCachedData result;
+    auto p = per_core_.AccessElementAndIndex();
+    const size_t num_cores = std::min(kMaxCoresToTry, per_core_.Size());
+    for (size_t i = 0; i < num_cores; i++) {
+      // Size() is a power of two
+      const size_t core_idx = (p.second + i) & (per_core_.Size() - 1);
+      if (per_core_.AccessAtCore(core_idx)->TryGet(
+              static_cast<int64_t>(core_idx), &result)) {
+        return result;
+      }
+    }
+    // Creates one time use data
+    result.CreateIfNeeded();
+    PERF_COUNTER_ADD(zstd_context_create_count, 1);
+    return result;
+  }
+  void Return(int64_t idx) {
+    assert(idx >= 0);
+    per_core_.AccessAtCore(static_cast<size_t>(idx))->Return();
+  }
+
+ private:
+  CoreLocalArray<ZSTDCachedData<TCachedData>> per_core_;
+};
 }  // namespace compression_cache
 
 class CompressionContextCache::Rep {
  public:
   Rep() = default;
   ZSTDUncompressCachedData GetZSTDUncompressData() {
-    auto p = per_core_uncompr_.AccessElementAndIndex();
-    int64_t idx = static_cast<int64_t>(p.second);
-    return p.first->GetUncompressData(idx);
-  }
-  void ReturnZSTDUncompressData(int64_t idx) {
-    assert(idx >= 0);
-    auto* cn = per_core_uncompr_.AccessAtCore(static_cast<size_t>(idx));
-    cn->ReturnUncompressData();
+    return uncompress_.Get();
   }
+  void ReturnZSTDUncompressData(int64_t idx) { uncompress_.Return(idx); }
+  ZSTDCompressCachedData GetZSTDCompressData() { return compress_.Get(); }
+  void ReturnZSTDCompressData(int64_t idx) { compress_.Return(idx); }
 
  private:
-  CoreLocalArray<compression_cache::ZSTDCachedData> per_core_uncompr_;
+  compression_cache::PerCoreCache<ZSTDUncompressCachedData> uncompress_;
+  compression_cache::PerCoreCache<ZSTDCompressCachedData> compress_;
 };
 
 CompressionContextCache::CompressionContextCache() : rep_(new Rep()) {}
@@ -101,6 +136,14 @@ void CompressionContextCache::ReturnCachedZSTDUncompressData(int64_t idx) {
   rep_->ReturnZSTDUncompressData(idx);
 }
 
+ZSTDCompressCachedData CompressionContextCache::GetCachedZSTDCompressData() {
+  return rep_->GetZSTDCompressData();
+}
+
+void CompressionContextCache::ReturnCachedZSTDCompressData(int64_t idx) {
+  rep_->ReturnZSTDCompressData(idx);
+}
+
 CompressionContextCache::~CompressionContextCache() { delete rep_; }
 
 }  // namespace ROCKSDB_NAMESPACE
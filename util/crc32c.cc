@@ -11,6 +11,7 @@
 // four bytes at a time.
 #include "util/crc32c.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <utility>
@@ -1134,6 +1135,40 @@ uint32_t Extend(uint32_t crc, const char* buf, size_t size) {
   return ChosenExtend(crc, buf, size);
 }
 
+void ValueMulti(const char* const* data, const size_t* n, size_t count,
+                uint32_t* crcs) {
+  size_t i = 0;
+#if !defined(HAVE_POWER8) && !defined(HAVE_ARM64_CRC)
+  // Each step of DefaultCRC32() depends on the previous one of its stream,
+  // so steps of three streams in lockstep keep the table lookups or crc32
+  // instructions of the CPU busy. The rest of each input is left to Extend().
+  for (; i + 3 <= count; i += 3) {
+    const uint8_t* p[3];
+    uint64_t l[3];
+    size_t common = n[i];
+    for (size_t j = 0; j < 3; ++j) {
+      p[j] = reinterpret_cast<const uint8_t*>(data[i + j]);
+      l[j] = 0xffffffffu;
+      common = std::min(common, n[i + j]);
+    }
+    for (size_t k = 0; k < common / 8; ++k) {
+      DefaultCRC32(&l[0], &p[0]);
+      DefaultCRC32(&l[1], &p[1]);
+      DefaultCRC32(&l[2], &p[2]);
+    }
+    const size_t done = common / 8 * 8;
+    for (size_t j = 0; j < 3; ++j) {
+      crcs[i + j] =
+          Extend(static_cast<uint32_t>(l[j] ^ 0xffffffffu),
+                 reinterpret_cast<const char*>(p[j]), n[i + j] - done);
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    crcs[i] = Value(data[i], n[i]);
+  }
+}
+
 // The code for crc32c combine, copied with permission from folly
 
 // Standard galois-field multiply.  The only modification is that a,
@@ -34,6 +34,12 @@ extern uint32_t Crc32cCombine(uint32_t crc1, uint32_t crc2, size_t crc2len);
 // Return the crc32c of data[0,n-1]
 inline uint32_t Value(const char* data, size_t n) { return Extend(0, data, n); }
 
+// Sets crcs[i] to the crc32c of data[i][0,n[i]-1] for each i < count. The
+// inputs are processed three at a time, interleaved, so that independent
+// crc computations overlap where Extend() handles one stream at a time.
+extern void ValueMulti(const char* const* data, const size_t* n, size_t count,
+                       uint32_t* crcs);
+
 static const uint32_t kMaskDelta = 0xa282ead8ul;
 
 // Return a masked representation of crc.
@@ -117,6 +117,30 @@ TEST(CRC, Extend) {
   ASSERT_EQ(Value("hello world", 11), Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, ValueMulti) {
+  Random rnd(301);
+  // Inputs of various lengths and alignments, including empty ones, so that
+  // both the interleaved part and the rest of each input are covered
+  std::vector<std::string> inputs;
+  for (int i = 0; i < 8; ++i) {
+    inputs.push_back(rnd.RandomString(static_cast<int>(rnd.Uniform(300))));
+  }
+  inputs.emplace_back();
+  std::vector<const char*> data;
+  std::vector<size_t> n;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    data.push_back(inputs[i].data() + (i % 2));
+    n.push_back(inputs[i].empty() ? 0 : inputs[i].size() - (i % 2));
+  }
+  for (size_t count = 0; count <= inputs.size(); ++count) {
+    std::vector<uint32_t> crcs(count);
+    ValueMulti(data.data(), n.data(), count, crcs.data());
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(Value(data[i], n[i]), crcs[i]);
+    }
+  }
+}
+
 TEST(CRC, Mask) {
   uint32_t crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
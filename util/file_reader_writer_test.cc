@@ -473,6 +473,76 @@ TEST_F(WritableFileWriterTest, AppendStatusReturn) {
   ASSERT_NOK(writer->Append(std::string(2 * kMb, 'b')));
 }
 
+TEST_F(WritableFileWriterTest, WriteBehind) {
+  class FakeWF : public FSWritableFile {
+   public:
+    explicit FakeWF(std::string* _file_data) : file_data_(_file_data) {}
+
+    using FSWritableFile::Append;
+    IOStatus Append(const Slice& data, const IOOptions& /*options*/,
+                    IODebugContext* /*dbg*/) override {
+      if (io_error_.load()) {
+        return IOStatus::IOError("Fake IO error");
+      }
+      file_data_->append(data.data(), data.size());
+      return IOStatus::OK();
+    }
+    IOStatus Close(const IOOptions& /*options*/,
+                   IODebugContext* /*dbg*/) override {
+      return IOStatus::OK();
+    }
+    IOStatus Flush(const IOOptions& /*options*/,
+                   IODebugContext* /*dbg*/) override {
+      return IOStatus::OK();
+    }
+    IOStatus Sync(const IOOptions& /*options*/,
+                  IODebugContext* /*dbg*/) override {
+      return IOStatus::OK();
+    }
+    void SetIOError(bool val) { io_error_.store(val); }
+
+   private:
+    std::string* file_data_;
+    std::atomic<bool> io_error_{false};
+  };
+
+  std::string file_data;
+  EnvOptions env_options;
+  env_options.writable_file_max_buffer_size = 64 << 10;
+  env_options.write_behind = true;
+  std::unique_ptr<WritableFileWriter> writer(new WritableFileWriter(
+      std::unique_ptr<FakeWF>(new FakeWF(&file_data)), "" /* don't care */,
+      env_options));
+
+  // The first buffer is only written out once the caller filled the next
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"WritableFileWriterTest::WriteBehind:Appended",
+        "WritableFileWriter::BGWriteBehind:Start"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const std::string data = rnd.RandomString(96 << 10);
+  ASSERT_OK(writer->Append(Slice(data.data(), 48 << 10)));
+  ASSERT_OK(writer->Append(Slice(data.data() + (48 << 10), 48 << 10)));
+  ASSERT_TRUE(file_data.empty());
+  TEST_SYNC_POINT("WritableFileWriterTest::WriteBehind:Appended");
+  ASSERT_OK(writer->Flush());
+  ASSERT_EQ(file_data, data);
+  ASSERT_EQ(writer->GetFlushedSize(), data.size());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // A failed background write is seen by the next call
+  FakeWF* fwf = static_cast<FakeWF*>(writer->writable_file());
+  fwf->SetIOError(true);
+  ASSERT_OK(writer->Append(Slice(data.data(), 48 << 10)));
+  ASSERT_OK(writer->Append(Slice(data.data() + (48 << 10), 48 << 10)));
+  ASSERT_TRUE(writer->Flush().IsIOError());
+  ASSERT_NOK(writer->Append(data));
+  ASSERT_NOK(writer->Close());
+  ASSERT_EQ(file_data, data);
+}
+
 class ReadaheadRandomAccessFileTest
     : public testing::Test,
       public testing::WithParamInterface<size_t> {
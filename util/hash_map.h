@@ -55,6 +55,16 @@ class HashMap {
     }
   }
 
+  // Calls f(key, value) for each entry
+  template <typename Function>
+  void ForEach(Function&& f) {
+    for (auto& bucket : table_) {
+      for (auto& p : bucket) {
+        f(p.first, p.second);
+      }
+    }
+  }
+
   V& Get(K key) {
     auto& bucket = table_[key % size];
     auto it = std::find_if(
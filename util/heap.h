@@ -171,4 +171,59 @@ class BinaryHeap {
   size_t root_cmp_cache_ = std::numeric_limits<size_t>::max();
 };
 
+// Alternative to BinaryHeap for merging a few streams, with the same
+// interface and ordering. The elements are kept sorted in an array with the
+// top at the end, so pop() takes no comparisons. replace_top() and push()
+// move the new element toward the front, with one comparison per element it
+// passes plus one, so replace_top() takes a single comparison when the
+// replacement element is also the new top, like BinaryHeap at best. With up
+// to about eight elements this takes fewer comparisons than BinaryHeap on
+// average, and its short loops branch less.
+template <typename T, typename Compare = std::less<T>>
+class SortedArrayHeap {
+ public:
+  SortedArrayHeap() {}
+  explicit SortedArrayHeap(Compare cmp) : cmp_(std::move(cmp)) {}
+
+  void push(const T& value) {
+    data_.push_back(value);
+    sift_down(data_.size() - 1);
+  }
+
+  const T& top() const {
+    assert(!empty());
+    return data_.back();
+  }
+
+  void replace_top(const T& value) {
+    assert(!empty());
+    data_.back() = value;
+    sift_down(data_.size() - 1);
+  }
+
+  void pop() {
+    assert(!empty());
+    data_.pop_back();
+  }
+
+  void clear() { data_.clear(); }
+
+  bool empty() const { return data_.empty(); }
+
+  size_t size() const { return data_.size(); }
+
+ private:
+  void sift_down(size_t index) {
+    T v = std::move(data_[index]);
+    while (index > 0 && cmp_(v, data_[index - 1])) {
+      data_[index] = std::move(data_[index - 1]);
+      --index;
+    }
+    data_[index] = std::move(v);
+  }
+
+  Compare cmp_;
+  autovector<T> data_;
+};
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -31,12 +31,17 @@ namespace ROCKSDB_NAMESPACE {
 using HeapTestValue = uint64_t;
 using Params = std::tuple<size_t, HeapTestValue, int64_t>;
 
-class HeapTest : public ::testing::TestWithParam<Params> {};
-
-TEST_P(HeapTest, Test) {
+class HeapTest : public ::testing::TestWithParam<Params> {
+ protected:
+  template <typename Heap>
+  void RunTest();
+};
+
+template <typename Heap>
+void HeapTest::RunTest() {
   // This test performs the same pseudorandom sequence of operations on a
-  // BinaryHeap and an std::priority_queue, comparing output.  The three
-  // possible operations are insert, replace top and pop.
+  // heap from util/heap.h and an std::priority_queue, comparing output.  The
+  // three possible operations are insert, replace top and pop.
   //
   // Insert is chosen slightly more often than the others so that the size of
   // the heap slowly grows.  Once the size heats the MAX_HEAP_SIZE limit, we
@@ -47,7 +52,7 @@ TEST_P(HeapTest, Test) {
   const auto MAX_VALUE = std::get<1>(GetParam());
   const auto RNG_SEED = std::get<2>(GetParam());
 
-  BinaryHeap<HeapTestValue> heap;
+  Heap heap;
   std::priority_queue<HeapTestValue> ref;
 
   std::mt19937 rng(static_cast<unsigned int>(RNG_SEED));
@@ -101,6 +106,12 @@ TEST_P(HeapTest, Test) {
   ASSERT_TRUE(heap.empty());
 }
 
+TEST_P(HeapTest, Test) { RunTest<BinaryHeap<HeapTestValue>>(); }
+
+TEST_P(HeapTest, SortedArrayHeap) {
+  RunTest<SortedArrayHeap<HeapTestValue>>();
+}
+
 // Basic test, MAX_VALUE = 3*MAX_HEAP_SIZE (occasional duplicates)
 INSTANTIATE_TEST_CASE_P(Basic, HeapTest,
                         ::testing::Values(Params(1000, 3000,
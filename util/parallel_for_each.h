@@ -0,0 +1,61 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Calls `work` with each index in [0, n) on up to `max_threads` threads, the
+// calling thread included, and returns the first failure by index. Indexes
+// are handed out in increasing order and no more after a failure, so `work`
+// has been called with every index before the first one that failed. With
+// `max_threads` <= 1, the indexes are worked on in order on the calling
+// thread, stopping at the first failure.
+inline Status ParallelForEach(size_t n, int max_threads,
+                              const std::function<Status(size_t)>& work) {
+  std::vector<Status> statuses(n);
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+  auto worker = [&]() {
+    while (!failed.load(std::memory_order_relaxed)) {
+      const size_t i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= n) {
+        break;
+      }
+      statuses[i] = work(i);
+      if (!statuses[i].ok()) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  const size_t num_threads =
+      std::min(n, static_cast<size_t>(std::max(1, max_threads)));
+  std::vector<port::Thread> threads;
+  for (size_t t = 1; t < num_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (const Status& s : statuses) {
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -46,7 +46,7 @@ struct GenericRateLimiter::Req {
 GenericRateLimiter::GenericRateLimiter(
     int64_t rate_bytes_per_sec, int64_t refill_period_us, int32_t fairness,
     RateLimiter::Mode mode, const std::shared_ptr<SystemClock>& clock,
-    bool auto_tuned)
+    bool auto_tuned, int64_t ios_per_sec)
     : RateLimiter(mode),
       refill_period_us_(refill_period_us),
       rate_bytes_per_sec_(auto_tuned ? rate_bytes_per_sec / 2
@@ -65,7 +65,10 @@ GenericRateLimiter::GenericRateLimiter(
       auto_tuned_(auto_tuned),
       num_drains_(0),
       max_bytes_per_sec_(rate_bytes_per_sec),
-      tuned_time_(NowMicrosMonotonicLocked()) {
+      tuned_time_(NowMicrosMonotonicLocked()),
+      bytes_per_io_(ios_per_sec > 0 ? std::max(static_cast<int64_t>(1),
+                                               rate_bytes_per_sec / ios_per_sec)
+                                    : 0) {
   for (int i = Env::IO_LOW; i < Env::IO_TOTAL; ++i) {
     total_requests_[i] = 0;
     total_bytes_through_[i] = 0;
@@ -128,6 +131,12 @@ void GenericRateLimiter::Request(int64_t bytes, const Env::IOPriority pri,
                                  Statistics* stats) {
   assert(bytes <= refill_bytes_per_period_.load(std::memory_order_relaxed));
   bytes = std::max(static_cast<int64_t>(0), bytes);
+  if (bytes_per_io_ > 0) {
+    // Charge small requests for the I/O they take, within a single burst
+    bytes = std::max(
+        bytes, std::min(bytes_per_io_, refill_bytes_per_period_.load(
+                                           std::memory_order_relaxed)));
+  }
   TEST_SYNC_POINT("GenericRateLimiter::Request");
   TEST_SYNC_POINT_CALLBACK("GenericRateLimiter::Request:1",
                            &rate_bytes_per_sec_);
@@ -394,18 +403,107 @@ Status GenericRateLimiter::TuneLocked() {
   return Status::OK();
 }
 
+ReadWriteRateLimiter::ReadWriteRateLimiter(
+    std::shared_ptr<RateLimiter> read_limiter,
+    std::shared_ptr<RateLimiter> write_limiter)
+    : RateLimiter(RateLimiter::Mode::kAllIo),
+      read_limiter_(std::move(read_limiter)),
+      write_limiter_(std::move(write_limiter)) {}
+
+void ReadWriteRateLimiter::SetBytesPerSecond(int64_t bytes_per_second) {
+  assert(bytes_per_second > 0);
+  const int64_t write_bytes_per_sec = write_limiter_->GetBytesPerSecond();
+  const int64_t read_bytes_per_sec = read_limiter_->GetBytesPerSecond();
+  write_limiter_->SetBytesPerSecond(bytes_per_second);
+  if (write_bytes_per_sec > 0) {
+    const double ratio = static_cast<double>(read_bytes_per_sec) /
+                         static_cast<double>(write_bytes_per_sec);
+    read_limiter_->SetBytesPerSecond(std::max(
+        static_cast<int64_t>(1),
+        static_cast<int64_t>(static_cast<double>(bytes_per_second) * ratio)));
+  }
+}
+
+void ReadWriteRateLimiter::SetAutoTuned(bool auto_tuned) {
+  read_limiter_->SetAutoTuned(auto_tuned);
+  write_limiter_->SetAutoTuned(auto_tuned);
+}
+
+void ReadWriteRateLimiter::Request(const int64_t bytes,
+                                   const Env::IOPriority pri,
+                                   Statistics* stats) {
+  write_limiter_->Request(bytes, pri, stats);
+}
+
+void ReadWriteRateLimiter::Request(const int64_t bytes,
+                                   const Env::IOPriority pri, Statistics* stats,
+                                   OpType op_type) {
+  LimiterFor(op_type)->Request(bytes, pri, stats);
+}
+
+int64_t ReadWriteRateLimiter::GetSingleBurstBytes() const {
+  return std::min(read_limiter_->GetSingleBurstBytes(),
+                  write_limiter_->GetSingleBurstBytes());
+}
+
+int64_t ReadWriteRateLimiter::GetTotalBytesThrough(
+    const Env::IOPriority pri) const {
+  return read_limiter_->GetTotalBytesThrough(pri) +
+         write_limiter_->GetTotalBytesThrough(pri);
+}
+
+int64_t ReadWriteRateLimiter::GetTotalRequests(
+    const Env::IOPriority pri) const {
+  return read_limiter_->GetTotalRequests(pri) +
+         write_limiter_->GetTotalRequests(pri);
+}
+
+Status ReadWriteRateLimiter::GetTotalPendingRequests(
+    int64_t* total_pending_requests, const Env::IOPriority pri) const {
+  assert(total_pending_requests != nullptr);
+  int64_t read_pending = 0;
+  Status s = read_limiter_->GetTotalPendingRequests(&read_pending, pri);
+  if (!s.ok()) {
+    return s;
+  }
+  int64_t write_pending = 0;
+  s = write_limiter_->GetTotalPendingRequests(&write_pending, pri);
+  if (!s.ok()) {
+    return s;
+  }
+  *total_pending_requests = read_pending + write_pending;
+  return Status::OK();
+}
+
+int64_t ReadWriteRateLimiter::GetBytesPerSecond() const {
+  return write_limiter_->GetBytesPerSecond();
+}
+
+bool ReadWriteRateLimiter::GetAutoTuned() const {
+  return read_limiter_->GetAutoTuned() || write_limiter_->GetAutoTuned();
+}
+
 RateLimiter* NewGenericRateLimiter(
     int64_t rate_bytes_per_sec, int64_t refill_period_us /* = 100 * 1000 */,
     int32_t fairness /* = 10 */,
     RateLimiter::Mode mode /* = RateLimiter::Mode::kWritesOnly */,
-    bool auto_tuned /* = false */) {
+    bool auto_tuned /* = false */, int64_t ios_per_sec /* = 0 */) {
   assert(rate_bytes_per_sec > 0);
   assert(refill_period_us > 0);
   assert(fairness > 0);
-  std::unique_ptr<RateLimiter> limiter(
-      new GenericRateLimiter(rate_bytes_per_sec, refill_period_us, fairness,
-                             mode, SystemClock::Default(), auto_tuned));
+  assert(ios_per_sec >= 0);
+  std::unique_ptr<RateLimiter> limiter(new GenericRateLimiter(
+      rate_bytes_per_sec, refill_period_us, fairness, mode,
+      SystemClock::Default(), auto_tuned, ios_per_sec));
   return limiter.release();
 }
 
+RateLimiter* NewReadWriteRateLimiter(
+    const std::shared_ptr<RateLimiter>& read_limiter,
+    const std::shared_ptr<RateLimiter>& write_limiter) {
+  assert(read_limiter != nullptr);
+  assert(write_limiter != nullptr);
+  return new ReadWriteRateLimiter(read_limiter, write_limiter);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
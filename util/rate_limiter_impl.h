@@ -29,7 +29,7 @@ class GenericRateLimiter : public RateLimiter {
   GenericRateLimiter(int64_t refill_bytes, int64_t refill_period_us,
                      int32_t fairness, RateLimiter::Mode mode,
                      const std::shared_ptr<SystemClock>& clock,
-                     bool auto_tuned);
+                     bool auto_tuned, int64_t ios_per_sec = 0);
 
   virtual ~GenericRateLimiter();
 
@@ -41,7 +41,8 @@ class GenericRateLimiter : public RateLimiter {
   // Request for token to write bytes. If this request can not be satisfied,
   // the call is blocked. Caller is responsible to make sure
   // bytes <= GetSingleBurstBytes() and bytes >= 0. Negative bytes
-  // passed in will be rounded up to 0.
+  // passed in will be rounded up to 0. With an I/O budget, the request is
+  // charged at least `bytes_per_io_`.
   using RateLimiter::Request;
   virtual void Request(const int64_t bytes, const Env::IOPriority pri,
                        Statistics* stats) override;
@@ -146,6 +147,62 @@ class GenericRateLimiter : public RateLimiter {
   int64_t num_drains_;
   const int64_t max_bytes_per_sec_;
   std::chrono::microseconds tuned_time_;
+
+  // The least number of bytes a request is charged, so that no more than
+  // `ios_per_sec` requests go through per second at the initial rate. Zero
+  // without an I/O budget.
+  const int64_t bytes_per_io_;
+};
+
+// Forwards the requests to read and write to separate rate limiters
+class ReadWriteRateLimiter : public RateLimiter {
+ public:
+  ReadWriteRateLimiter(std::shared_ptr<RateLimiter> read_limiter,
+                       std::shared_ptr<RateLimiter> write_limiter);
+
+  // Sets the rate of the write limiter, and scales the rate of the read
+  // limiter by the same factor
+  void SetBytesPerSecond(int64_t bytes_per_second) override;
+
+  void SetAutoTuned(bool auto_tuned) override;
+
+  // Charged to the write limiter
+  using RateLimiter::Request;
+  void Request(const int64_t bytes, const Env::IOPriority pri,
+               Statistics* stats) override;
+
+  // Charged to the limiter of `op_type`, regardless of its mode
+  void Request(const int64_t bytes, const Env::IOPriority pri,
+               Statistics* stats, OpType op_type) override;
+
+  // The smaller of the bursts of the two limiters
+  int64_t GetSingleBurstBytes() const override;
+
+  int64_t GetTotalBytesThrough(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
+
+  int64_t GetTotalRequests(
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
+
+  Status GetTotalPendingRequests(
+      int64_t* total_pending_requests,
+      const Env::IOPriority pri = Env::IO_TOTAL) const override;
+
+  // The rate of the write limiter
+  int64_t GetBytesPerSecond() const override;
+
+  bool GetAutoTuned() const override;
+
+  bool IsRateLimited(OpType /*op_type*/) override { return true; }
+
+ private:
+  RateLimiter* LimiterFor(OpType op_type) const {
+    return op_type == OpType::kRead ? read_limiter_.get()
+                                    : write_limiter_.get();
+  }
+
+  const std::shared_ptr<RateLimiter> read_limiter_;
+  const std::shared_ptr<RateLimiter> write_limiter_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -582,6 +582,67 @@ TEST_F(RateLimiterTest, RuntimeSingleBurstBytesChange) {
                    RateLimiter::OpType::kWrite);
 }
 
+TEST_F(RateLimiterTest, IOsPerSecond) {
+  const std::chrono::seconds kTimePerRefill(1);
+  auto mock_clock =
+      std::make_shared<MockSystemClock>(Env::Default()->GetSystemClock());
+  // Each request is charged at least 1000 / 10 = 100 bytes
+  std::unique_ptr<RateLimiter> limiter(new GenericRateLimiter(
+      1000 /* rate_bytes_per_sec */,
+      std::chrono::microseconds(kTimePerRefill).count(), 10 /* fairness */,
+      RateLimiter::Mode::kAllIo, mock_clock, false /* auto_tuned */,
+      10 /* ios_per_sec */));
+
+  const uint64_t start_us = mock_clock->NowMicros();
+  for (int i = 0; i < 30; ++i) {
+    limiter->Request(1 /* bytes */, Env::IO_LOW, nullptr /* stats */,
+                     RateLimiter::OpType::kRead);
+  }
+  ASSERT_EQ(30, limiter->GetTotalRequests());
+  ASSERT_EQ(3000, limiter->GetTotalBytesThrough());
+  // Ten requests are granted per refill, so the last ten waited for the third
+  ASSERT_GE(mock_clock->NowMicros() - start_us,
+            2 * std::chrono::microseconds(kTimePerRefill).count());
+
+  // Requests larger than the charge of an I/O are charged their bytes
+  limiter->Request(500 /* bytes */, Env::IO_LOW, nullptr /* stats */,
+                   RateLimiter::OpType::kWrite);
+  ASSERT_EQ(3500, limiter->GetTotalBytesThrough());
+}
+
+TEST_F(RateLimiterTest, ReadWriteRateLimiter) {
+  // The read limiter limits reads although its mode is writes only
+  std::shared_ptr<RateLimiter> read_limiter(
+      NewGenericRateLimiter(1000 /* rate_bytes_per_sec */));
+  std::shared_ptr<RateLimiter> write_limiter(
+      NewGenericRateLimiter(2000 /* rate_bytes_per_sec */));
+  std::unique_ptr<RateLimiter> limiter(
+      NewReadWriteRateLimiter(read_limiter, write_limiter));
+  ASSERT_TRUE(limiter->IsRateLimited(RateLimiter::OpType::kRead));
+  ASSERT_TRUE(limiter->IsRateLimited(RateLimiter::OpType::kWrite));
+  ASSERT_EQ(100, limiter->GetSingleBurstBytes());
+
+  limiter->Request(50 /* bytes */, Env::IO_HIGH, nullptr /* stats */,
+                   RateLimiter::OpType::kRead);
+  limiter->Request(150 /* bytes */, Env::IO_HIGH, nullptr /* stats */,
+                   RateLimiter::OpType::kWrite);
+  ASSERT_EQ(50, read_limiter->GetTotalBytesThrough());
+  ASSERT_EQ(150, write_limiter->GetTotalBytesThrough());
+  ASSERT_EQ(200, limiter->GetTotalBytesThrough());
+  ASSERT_EQ(2, limiter->GetTotalRequests());
+
+  ASSERT_EQ(100, limiter->RequestToken(1000 /* bytes */, 0 /* alignment */,
+                                       Env::IO_HIGH, nullptr /* stats */,
+                                       RateLimiter::OpType::kRead));
+  ASSERT_EQ(150, read_limiter->GetTotalBytesThrough());
+
+  // The rate of reads follows the one of writes
+  ASSERT_EQ(2000, limiter->GetBytesPerSecond());
+  limiter->SetBytesPerSecond(4000);
+  ASSERT_EQ(4000, write_limiter->GetBytesPerSecond());
+  ASSERT_EQ(2000, read_limiter->GetBytesPerSecond());
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -14,6 +14,7 @@
 #endif
 
 #ifdef OS_LINUX
+#include <sched.h>
 #include <sys/resource.h>
 #include <sys/syscall.h>
 #endif
@@ -22,11 +23,13 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "monitoring/thread_status_util.h"
@@ -60,6 +63,14 @@ struct ThreadPoolImpl::Impl {
 
   void LowerCPUPriority(CpuPriority pri);
 
+  Status SetCpuAffinity(const std::vector<int>& cpus);
+
+  void SetFairScheduling(bool fair);
+
+  void SetSchedulingWeight(void* tag, uint32_t weight);
+
+  bool GetQueueStats(void* tag, ThreadPoolQueueStats* stats);
+
   void WakeUpAllThreads() { bgsignal_.notify_all(); }
 
   void BGThread(size_t thread_id);
@@ -117,6 +128,7 @@ struct ThreadPoolImpl::Impl {
     int released_threads_in_success =
         std::min(reserved_threads_, threads_to_be_released);
     reserved_threads_ -= released_threads_in_success;
+    lock.unlock();
     WakeUpAllThreads();
     return released_threads_in_success;
   }
@@ -126,6 +138,10 @@ struct ThreadPoolImpl::Impl {
 
   bool low_io_priority_;
   CpuPriority cpu_priority_;
+  // CPUs to run on, any when empty. The version is bumped on each change, for
+  // threads to notice it.
+  std::vector<int> cpu_affinity_;
+  uint64_t cpu_affinity_version_;
   Env::Priority priority_;
   Env* env_;
 
@@ -149,10 +165,45 @@ struct ThreadPoolImpl::Impl {
     void* tag = nullptr;
     std::function<void()> function;
     std::function<void()> unschedFunction;
+    // The order of the Submit() calls, to restore when leaving fair mode
+    uint64_t seqno = 0;
+    std::chrono::steady_clock::time_point enqueue_time;
   };
 
   using BGQueue = std::deque<BGItem>;
+
+  // The jobs of a tag in fair mode, and how many more of them run before the
+  // next tag's turn
+  struct TagQueue {
+    BGQueue items;
+    uint32_t credits = 0;
+  };
+
+  // A tag registered with SetSchedulingWeight()
+  struct TagInfo {
+    uint32_t weight = 1;
+    ThreadPoolQueueStats stats;
+  };
+
+  void Enqueue(BGItem&& item);
+  // Removes the next job to run, there must be one
+  BGItem Dequeue();
+  uint32_t WeightOf(void* tag) const;
+  void UpdateQueueLen() {
+    queue_len_.store(static_cast<unsigned int>(num_queued_),
+                     std::memory_order_relaxed);
+  }
+
+  // All the jobs in the order they were submitted, unless fair_
   BGQueue queue_;
+  bool fair_;
+  // The jobs by tag if fair_, with the tags taking turns in the order of
+  // ready_tags_
+  std::unordered_map<void*, TagQueue> tag_queues_;
+  std::deque<void*> ready_tags_;
+  std::unordered_map<void*, TagInfo> tag_infos_;
+  size_t num_queued_;
+  uint64_t next_seqno_;
 
   std::mutex mu_;
   std::condition_variable bgsignal_;
@@ -162,6 +213,8 @@ struct ThreadPoolImpl::Impl {
 inline ThreadPoolImpl::Impl::Impl()
     : low_io_priority_(false),
       cpu_priority_(CpuPriority::kNormal),
+      cpu_affinity_(),
+      cpu_affinity_version_(0),
       priority_(Env::LOW),
       env_(nullptr),
       total_threads_limit_(0),
@@ -171,6 +224,12 @@ inline ThreadPoolImpl::Impl::Impl()
       exit_all_threads_(false),
       wait_for_jobs_to_complete_(false),
       queue_(),
+      fair_(false),
+      tag_queues_(),
+      ready_tags_(),
+      tag_infos_(),
+      num_queued_(0),
+      next_seqno_(0),
       mu_(),
       bgsignal_(),
       bgthreads_() {}
@@ -213,9 +272,158 @@ inline void ThreadPoolImpl::Impl::LowerCPUPriority(CpuPriority pri) {
   cpu_priority_ = pri;
 }
 
+Status ThreadPoolImpl::Impl::SetCpuAffinity(const std::vector<int>& cpus) {
+#ifdef OS_LINUX
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return Status::InvalidArgument("CPU out of range: " +
+                                     std::to_string(cpu));
+    }
+  }
+  std::lock_guard<std::mutex> lock(mu_);
+  cpu_affinity_ = cpus;
+  cpu_affinity_version_++;
+  return Status::OK();
+#else
+  (void)cpus;
+  return Status::NotSupported("CPU affinity is only supported on Linux");
+#endif
+}
+
+uint32_t ThreadPoolImpl::Impl::WeightOf(void* tag) const {
+  auto it = tag_infos_.find(tag);
+  return it != tag_infos_.end() ? it->second.weight : 1;
+}
+
+void ThreadPoolImpl::Impl::Enqueue(BGItem&& item) {
+  num_queued_++;
+  if (!fair_) {
+    queue_.push_back(std::move(item));
+    return;
+  }
+  TagQueue& tag_queue = tag_queues_[item.tag];
+  if (tag_queue.items.empty()) {
+    // A tag joins the turns at the back with a full turn ahead
+    tag_queue.credits = WeightOf(item.tag);
+    ready_tags_.push_back(item.tag);
+  }
+  tag_queue.items.push_back(std::move(item));
+}
+
+ThreadPoolImpl::Impl::BGItem ThreadPoolImpl::Impl::Dequeue() {
+  assert(num_queued_ > 0);
+  num_queued_--;
+  BGItem item;
+  if (!fair_) {
+    item = std::move(queue_.front());
+    queue_.pop_front();
+  } else {
+    void* tag = ready_tags_.front();
+    auto it = tag_queues_.find(tag);
+    assert(it != tag_queues_.end());
+    TagQueue& tag_queue = it->second;
+    item = std::move(tag_queue.items.front());
+    tag_queue.items.pop_front();
+    ready_tags_.pop_front();
+    if (tag_queue.items.empty()) {
+      tag_queues_.erase(it);
+    } else if (tag_queue.credits > 1) {
+      tag_queue.credits--;
+      ready_tags_.push_front(tag);
+    } else {
+      tag_queue.credits = WeightOf(tag);
+      ready_tags_.push_back(tag);
+    }
+  }
+  auto info = tag_infos_.find(item.tag);
+  if (info != tag_infos_.end()) {
+    const uint64_t wait_micros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - item.enqueue_time)
+            .count());
+    ThreadPoolQueueStats& stats = info->second.stats;
+    stats.num_jobs++;
+    stats.total_wait_micros += wait_micros;
+    stats.max_wait_micros = std::max(stats.max_wait_micros, wait_micros);
+  }
+  return item;
+}
+
+void ThreadPoolImpl::Impl::SetFairScheduling(bool fair) {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (fair == fair_) {
+    return;
+  }
+  // Moves the pending jobs over, in the order they were submitted
+  BGQueue pending;
+  if (fair_) {
+    for (auto& tag_queue : tag_queues_) {
+      for (auto& item : tag_queue.second.items) {
+        pending.push_back(std::move(item));
+      }
+    }
+    std::sort(pending.begin(), pending.end(),
+              [](const BGItem& a, const BGItem& b) {
+                return a.seqno < b.seqno;
+              });
+    tag_queues_.clear();
+    ready_tags_.clear();
+  } else {
+    pending.swap(queue_);
+  }
+  fair_ = fair;
+  num_queued_ = 0;
+  for (auto& item : pending) {
+    Enqueue(std::move(item));
+  }
+}
+
+void ThreadPoolImpl::Impl::SetSchedulingWeight(void* tag, uint32_t weight) {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (weight == 0) {
+    tag_infos_.erase(tag);
+  } else {
+    tag_infos_[tag].weight = weight;
+  }
+}
+
+bool ThreadPoolImpl::Impl::GetQueueStats(void* tag,
+                                         ThreadPoolQueueStats* stats) {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = tag_infos_.find(tag);
+  if (it == tag_infos_.end()) {
+    return false;
+  }
+  *stats = it->second.stats;
+  return true;
+}
+
+namespace {
+#ifdef OS_LINUX
+// Restricts the calling thread to `cpus`, or allows all CPUs when empty
+void SetThreadCpuAffinity(const std::vector<int>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (cpus.empty()) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      CPU_SET(cpu, &set);
+    }
+  } else {
+    for (int cpu : cpus) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  // Fails when none of the CPUs is online or allowed, which leaves the
+  // affinity unchanged
+  sched_setaffinity(0 /* current thread */, sizeof(set), &set);
+}
+#endif
+}  // namespace
+
 void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
   bool low_io_priority = false;
   CpuPriority current_cpu_priority = CpuPriority::kNormal;
+  uint64_t current_cpu_affinity_version = 0;
 
   while (true) {
     // Wait until there is an item that is ready to run
@@ -232,7 +440,7 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
     // 3) the number of waiting threads is not greater than reserved threads
     // (i.e, no available threads due to full reservation")
     while (!exit_all_threads_ && !IsLastExcessiveThread(thread_id) &&
-           (queue_.empty() || IsExcessiveThread(thread_id) ||
+           (num_queued_ == 0 || IsExcessiveThread(thread_id) ||
             num_waiting_threads_ <= reserved_threads_)) {
       bgsignal_.wait(lock);
     }
@@ -241,7 +449,7 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
 
     if (exit_all_threads_) {  // mechanism to let BG threads exit safely
 
-      if (!wait_for_jobs_to_complete_ || queue_.empty()) {
+      if (!wait_for_jobs_to_complete_ || num_queued_ == 0) {
         break;
       }
     } else if (IsLastExcessiveThread(thread_id)) {
@@ -263,14 +471,18 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
       break;
     }
 
-    auto func = std::move(queue_.front().function);
-    queue_.pop_front();
-
-    queue_len_.store(static_cast<unsigned int>(queue_.size()),
-                     std::memory_order_relaxed);
+    auto func = Dequeue().function;
+    UpdateQueueLen();
 
     bool decrease_io_priority = (low_io_priority != low_io_priority_);
     CpuPriority cpu_priority = cpu_priority_;
+    std::vector<int> cpu_affinity;
+    const bool update_cpu_affinity =
+        current_cpu_affinity_version != cpu_affinity_version_;
+    if (update_cpu_affinity) {
+      cpu_affinity = cpu_affinity_;
+      current_cpu_affinity_version = cpu_affinity_version_;
+    }
     lock.unlock();
 
     if (cpu_priority < current_cpu_priority) {
@@ -306,6 +518,14 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
     (void)decrease_io_priority;  // avoid 'unused variable' error
 #endif
 
+    if (update_cpu_affinity) {
+#ifdef OS_LINUX
+      SetThreadCpuAffinity(cpu_affinity);
+#endif
+      TEST_SYNC_POINT_CALLBACK("ThreadPoolImpl::BGThread::AfterSetCpuAffinity",
+                               &cpu_affinity);
+    }
+
     TEST_SYNC_POINT_CALLBACK("ThreadPoolImpl::Impl::BGThread:BeforeRun",
                              &priority_);
 
@@ -402,7 +622,7 @@ void ThreadPoolImpl::Impl::StartBGThreads() {
 void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
                                   std::function<void()>&& unschedule,
                                   void* tag) {
-  std::lock_guard<std::mutex> lock(mu_);
+  std::unique_lock<std::mutex> lock(mu_);
 
   if (exit_all_threads_) {
     return;
@@ -411,17 +631,22 @@ void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
   StartBGThreads();
 
   // Add to priority queue
-  queue_.push_back(BGItem());
+  BGItem item;
   TEST_SYNC_POINT("ThreadPoolImpl::Submit::Enqueue");
-  auto& item = queue_.back();
   item.tag = tag;
   item.function = std::move(schedule);
   item.unschedFunction = std::move(unschedule);
+  item.seqno = next_seqno_++;
+  item.enqueue_time = std::chrono::steady_clock::now();
+  Enqueue(std::move(item));
 
-  queue_len_.store(static_cast<unsigned int>(queue_.size()),
-                   std::memory_order_relaxed);
+  UpdateQueueLen();
 
-  if (!HasExcessiveThread()) {
+  // Notify after unlocking, so that the woken up thread does not block right
+  // away on the mutex still held here
+  const bool has_excessive_thread = HasExcessiveThread();
+  lock.unlock();
+  if (!has_excessive_thread) {
     // Wake up at least one waiting thread.
     bgsignal_.notify_one();
   } else {
@@ -439,20 +664,35 @@ int ThreadPoolImpl::Impl::UnSchedule(void* arg) {
     std::lock_guard<std::mutex> lock(mu_);
 
     // Remove from priority queue
-    BGQueue::iterator it = queue_.begin();
-    while (it != queue_.end()) {
-      if (arg == (*it).tag) {
-        if (it->unschedFunction) {
-          candidates.push_back(std::move(it->unschedFunction));
+    if (!fair_) {
+      BGQueue::iterator it = queue_.begin();
+      while (it != queue_.end()) {
+        if (arg == (*it).tag) {
+          if (it->unschedFunction) {
+            candidates.push_back(std::move(it->unschedFunction));
+          }
+          it = queue_.erase(it);
+          count++;
+        } else {
+          ++it;
         }
-        it = queue_.erase(it);
-        count++;
-      } else {
-        ++it;
+      }
+    } else {
+      auto it = tag_queues_.find(arg);
+      if (it != tag_queues_.end()) {
+        for (auto& item : it->second.items) {
+          if (item.unschedFunction) {
+            candidates.push_back(std::move(item.unschedFunction));
+          }
+          count++;
+        }
+        tag_queues_.erase(it);
+        ready_tags_.erase(
+            std::find(ready_tags_.begin(), ready_tags_.end(), arg));
       }
     }
-    queue_len_.store(static_cast<unsigned int>(queue_.size()),
-                     std::memory_order_relaxed);
+    num_queued_ -= count;
+    UpdateQueueLen();
   }
 
   // Run unschedule functions outside the mutex
@@ -491,6 +731,22 @@ void ThreadPoolImpl::LowerCPUPriority(CpuPriority pri) {
   impl_->LowerCPUPriority(pri);
 }
 
+Status ThreadPoolImpl::SetCpuAffinity(const std::vector<int>& cpus) {
+  return impl_->SetCpuAffinity(cpus);
+}
+
+void ThreadPoolImpl::SetFairScheduling(bool fair) {
+  impl_->SetFairScheduling(fair);
+}
+
+void ThreadPoolImpl::SetSchedulingWeight(void* tag, uint32_t weight) {
+  impl_->SetSchedulingWeight(tag, weight);
+}
+
+bool ThreadPoolImpl::GetQueueStats(void* tag, ThreadPoolQueueStats* stats) {
+  return impl_->GetQueueStats(tag, stats);
+}
+
 void ThreadPoolImpl::IncBackgroundThreadsIfNeeded(int num) {
   impl_->SetBackgroundThreadsInternal(num, false);
 }
@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "rocksdb/env.h"
 #include "rocksdb/threadpool.h"
@@ -53,6 +54,21 @@ class ThreadPoolImpl : public ThreadPool {
   // Currently only has effect on Linux
   void LowerCPUPriority(CpuPriority pri);
 
+  // Restrict threads to run on the given CPUs, or on any with no CPUs given
+  // Currently only supported on Linux
+  Status SetCpuAffinity(const std::vector<int>& cpus);
+
+  // Take turns between the tags of the jobs rather than run the jobs in
+  // order, see Env::SetThreadPoolFairScheduling()
+  void SetFairScheduling(bool fair);
+
+  // Register `tag` with a weight, or unregister it with 0, see
+  // Env::SetThreadPoolSchedulingWeight()
+  void SetSchedulingWeight(void* tag, uint32_t weight);
+
+  // Get the queue waits of the jobs of a registered tag, false if it isn't
+  bool GetQueueStats(void* tag, ThreadPoolQueueStats* stats);
+
   // Ensure there is at aleast num threads in the pool
   // but do not kill threads if there are more
   void IncBackgroundThreadsIfNeeded(int num);
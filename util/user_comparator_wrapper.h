@@ -15,14 +15,18 @@ namespace ROCKSDB_NAMESPACE {
 
 // Wrapper of user comparator, with auto increment to
 // perf_context.user_key_comparison_count.
+//
+// The built-in bytewise and reverse bytewise comparators, which almost all
+// column families use, are recognized once at construction, and their key
+// comparisons are then inlined rather than made through virtual calls.
 class UserComparatorWrapper {
  public:
   // `UserComparatorWrapper`s constructed with the default constructor are not
   // usable and will segfault on any attempt to use them for comparisons.
-  UserComparatorWrapper() : user_comparator_(nullptr) {}
+  UserComparatorWrapper() : user_comparator_(nullptr), kind_(kOther) {}
 
   explicit UserComparatorWrapper(const Comparator* const user_cmp)
-      : user_comparator_(user_cmp) {}
+      : user_comparator_(user_cmp), kind_(KindOf(user_cmp)) {}
 
   ~UserComparatorWrapper() = default;
 
@@ -30,11 +34,14 @@ class UserComparatorWrapper {
 
   int Compare(const Slice& a, const Slice& b) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
-    return user_comparator_->Compare(a, b);
+    return CompareImpl(a, b);
   }
 
   bool Equal(const Slice& a, const Slice& b) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (kind_ != kOther) {
+      return a == b;
+    }
     return user_comparator_->Equal(a, b);
   }
 
@@ -44,21 +51,56 @@ class UserComparatorWrapper {
 
   int CompareWithoutTimestamp(const Slice& a, const Slice& b) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (kind_ != kOther) {
+      // No timestamps
+      return CompareImpl(a, b);
+    }
     return user_comparator_->CompareWithoutTimestamp(a, b);
   }
 
   int CompareWithoutTimestamp(const Slice& a, bool a_has_ts, const Slice& b,
                               bool b_has_ts) const {
     PERF_COUNTER_ADD(user_key_comparison_count, 1);
+    if (kind_ != kOther) {
+      return CompareImpl(a, b);
+    }
     return user_comparator_->CompareWithoutTimestamp(a, a_has_ts, b, b_has_ts);
   }
 
   bool EqualWithoutTimestamp(const Slice& a, const Slice& b) const {
+    if (kind_ != kOther) {
+      return a == b;
+    }
     return user_comparator_->EqualWithoutTimestamp(a, b);
   }
 
  private:
+  enum Kind : uint8_t { kOther, kBytewise, kReverseBytewise };
+
+  static Kind KindOf(const Comparator* cmp) {
+    if (cmp == nullptr) {
+      return kOther;
+    } else if (cmp == BytewiseComparator()) {
+      return kBytewise;
+    } else if (cmp == ReverseBytewiseComparator()) {
+      return kReverseBytewise;
+    }
+    return kOther;
+  }
+
+  int CompareImpl(const Slice& a, const Slice& b) const {
+    switch (kind_) {
+      case kBytewise:
+        return a.compare(b);
+      case kReverseBytewise:
+        return -a.compare(b);
+      default:
+        return user_comparator_->Compare(a, b);
+    }
+  }
+
   const Comparator* user_comparator_;
+  Kind kind_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -31,6 +31,7 @@
 #include "env/fs_remap.h"
 #include "file/filename.h"
 #include "file/line_file_reader.h"
+#include "file/random_access_file_reader.h"
 #include "file/sequence_file_reader.h"
 #include "file/writable_file_writer.h"
 #include "logging/logging.h"
@@ -124,6 +125,8 @@ void BackupEngineOptions::Dump(Logger* logger) const {
                  restore_rate_limit);
   ROCKS_LOG_INFO(logger, "Options.max_background_operations: %d",
                  max_background_operations);
+  ROCKS_LOG_INFO(logger, "     Options.max_readers_per_file: %d",
+                 max_readers_per_file);
 }
 
 namespace {
@@ -2159,6 +2162,11 @@ IOStatus BackupEngineImpl::CopyOrCreateFile(
   IOStatus io_s;
   std::unique_ptr<FSWritableFile> dst_file;
   std::unique_ptr<FSSequentialFile> src_file;
+  // With more than one reader, the source is read in batches of one chunk per
+  // reader, in parallel, and the chunks are written in order
+  const size_t num_readers =
+      static_cast<size_t>(std::max(1, options_.max_readers_per_file));
+  std::unique_ptr<FSRandomAccessFile> src_random_file;
   FileOptions dst_file_options;
   dst_file_options.use_mmap_writes = false;
   dst_file_options.temperature = dst_temperature;
@@ -2175,17 +2183,23 @@ IOStatus BackupEngineImpl::CopyOrCreateFile(
 
   io_s = dst_env->GetFileSystem()->NewWritableFile(dst, dst_file_options,
                                                    &dst_file, nullptr);
+  auto open_src_file = [&](const FileOptions& src_file_options) {
+    if (num_readers > 1) {
+      return src_env->GetFileSystem()->NewRandomAccessFile(
+          src, src_file_options, &src_random_file, nullptr);
+    }
+    return src_env->GetFileSystem()->NewSequentialFile(src, src_file_options,
+                                                       &src_file, nullptr);
+  };
   if (io_s.ok() && !src.empty()) {
     auto src_file_options = FileOptions(src_env_options);
     src_file_options.temperature = *src_temperature;
-    io_s = src_env->GetFileSystem()->NewSequentialFile(src, src_file_options,
-                                                       &src_file, nullptr);
+    io_s = open_src_file(src_file_options);
   }
   if (io_s.IsPathNotFound() && *src_temperature != Temperature::kUnknown) {
     // Retry without temperature hint in case the FileSystem is strict with
     // non-kUnknown temperature option
-    io_s = src_env->GetFileSystem()->NewSequentialFile(
-        src, FileOptions(src_env_options), &src_file, nullptr);
+    io_s = open_src_file(FileOptions(src_env_options));
   }
   if (!io_s.ok()) {
     return io_s;
@@ -2194,12 +2208,25 @@ IOStatus BackupEngineImpl::CopyOrCreateFile(
   size_t buf_size =
       rate_limiter ? static_cast<size_t>(rate_limiter->GetSingleBurstBytes())
                    : kDefaultCopyFileBufferSize;
+  TEST_SYNC_POINT_CALLBACK("BackupEngineImpl::CopyOrCreateFile:BufferSize",
+                           &buf_size);
 
   std::unique_ptr<WritableFileWriter> dest_writer(
       new WritableFileWriter(std::move(dst_file), dst, dst_file_options));
   std::unique_ptr<SequentialFileReader> src_reader;
+  std::unique_ptr<RandomAccessFileReader> src_random_reader;
   std::unique_ptr<char[]> buf;
-  if (!src.empty()) {
+  if (!src.empty() && num_readers > 1) {
+    // Return back current temperature in FileSystem
+    *src_temperature = src_random_file->GetTemperature();
+
+    src_random_reader.reset(new RandomAccessFileReader(
+        std::move(src_random_file), src, nullptr /* clock */,
+        nullptr /* io_tracer */, nullptr /* stats */,
+        Histograms::HISTOGRAM_ENUM_MAX /* hist_type */,
+        nullptr /* file_read_hist */, rate_limiter));
+    buf.reset(new char[buf_size * num_readers]);
+  } else if (!src.empty()) {
     // Return back current temperature in FileSystem
     *src_temperature = src_file->GetTemperature();
 
@@ -2208,12 +2235,59 @@ IOStatus BackupEngineImpl::CopyOrCreateFile(
     buf.reset(new char[buf_size]);
   }
 
+  // The chunks of the last batch read in parallel, and the next to write
+  std::vector<Slice> chunks;
+  size_t next_chunk = 0;
+  uint64_t batch_offset = 0;
+  auto read_chunks = [&]() {
+    chunks.assign(num_readers, Slice());
+    std::vector<IOStatus> statuses(num_readers);
+    auto read_chunk = [&](size_t i) {
+      const uint64_t offset_in_batch = uint64_t{i} * buf_size;
+      if (offset_in_batch >= size_limit) {
+        return;
+      }
+      IOOptions io_opts;
+      io_opts.rate_limiter_priority = Env::IO_LOW;
+      statuses[i] = src_random_reader->Read(
+          io_opts, batch_offset + offset_in_batch,
+          static_cast<size_t>(
+              std::min(uint64_t{buf_size}, size_limit - offset_in_batch)),
+          &chunks[i], buf.get() + i * buf_size, nullptr /* aligned_buf */);
+    };
+    std::vector<port::Thread> readers;
+    for (size_t i = 1; i < num_readers; i++) {
+      readers.emplace_back(read_chunk, i);
+    }
+    read_chunk(0);
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    batch_offset += uint64_t{buf_size} * num_readers;
+    next_chunk = 0;
+
+    IOStatus s;
+    for (auto& chunk_s : statuses) {
+      if (s.ok() && !chunk_s.ok()) {
+        s = chunk_s;
+      }
+      chunk_s.PermitUncheckedError();
+    }
+    return s;
+  };
+
   Slice data;
   do {
     if (stop_backup_.load(std::memory_order_acquire)) {
       return status_to_io_status(Status::Incomplete("Backup stopped"));
     }
-    if (!src.empty()) {
+    if (src_random_reader) {
+      if (next_chunk == chunks.size()) {
+        io_s = read_chunks();
+      }
+      data = io_s.ok() ? chunks[next_chunk++] : Slice();
+      *bytes_toward_next_callback += data.size();
+    } else if (!src.empty()) {
       size_t buffer_to_read =
           (buf_size < size_limit) ? buf_size : static_cast<size_t>(size_limit);
       io_s = src_reader->Read(buffer_to_read, &data, buf.get(),
@@ -1979,6 +1979,35 @@ TEST_F(BackupEngineTest, NoShareTableFiles) {
   }
 }
 
+TEST_F(BackupEngineTest, ParallelReadsPerFile) {
+  // Small chunks, so that files are read in several batches of chunks
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "BackupEngineImpl::CopyOrCreateFile:BufferSize",
+      [](void* arg) { *static_cast<size_t*>(arg) = 1000; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  const int keys_iteration = 5000;
+  engine_options_->max_readers_per_file = 3;
+  OpenDBAndBackupEngine(true);
+  for (int i = 0; i < 2; ++i) {
+    FillDB(db_.get(), keys_iteration * i, keys_iteration * (i + 1));
+    ASSERT_OK(backup_engine_->CreateNewBackup(db_.get(), !!(i % 2)));
+  }
+  CloseDBAndBackupEngine();
+
+  for (int i = 0; i < 2; ++i) {
+    AssertBackupConsistency(i + 1, 0, keys_iteration * (i + 1),
+                            keys_iteration * 3);
+  }
+
+  OpenBackupEngine();
+  ASSERT_OK(backup_engine_->VerifyBackup(2, true /* verify_with_checksum */));
+  CloseBackupEngine();
+
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 // Verify that you can backup and restore with share_files_with_checksum on
 TEST_F(BackupEngineTest, ShareTableFilesWithChecksums) {
   const int keys_iteration = 5000;
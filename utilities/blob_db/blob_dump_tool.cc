@@ -140,6 +140,29 @@ Status BlobDumpTool::DumpBlobLogHeader(uint64_t* offset,
           GetString(header.expiration_range).c_str());
   *offset = BlobLogHeader::kSize;
   *compression = header.compression;
+  if (header.has_compression_dict) {
+    uint32_t dict_size = 0;
+    s = Read(*offset, BlobLogHeader::kCompressionDictSizeBytes, &slice);
+    if (s.ok()) {
+      s = BlobLogHeader::DecodeCompressionDictSize(slice, &dict_size);
+    }
+    if (s.ok()) {
+      *offset += BlobLogHeader::kCompressionDictSizeBytes;
+      s = Read(*offset, dict_size + sizeof(uint32_t), &slice);
+    }
+    if (s.ok()) {
+      s = header.DecodeCompressionDictFrom(slice);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+    *offset += dict_size + sizeof(uint32_t);
+    fprintf(stdout, "  Dictionary size  : %" PRIu32 "\n", dict_size);
+    uncompression_dict_.reset(new UncompressionDict(
+        std::move(header.compression_dict),
+        header.compression == kZSTD ||
+            header.compression == kZSTDNotFinalCompression));
+  }
   return s;
 }
 
@@ -210,7 +233,10 @@ Status BlobDumpTool::DumpRecord(DisplayType show_key, DisplayType show_blob,
       (show_uncompressed_blob != DisplayType::kNone || show_summary)) {
     BlockContents contents;
     UncompressionContext context(compression);
-    UncompressionInfo info(context, UncompressionDict::GetEmptyDict(),
+    UncompressionInfo info(context,
+                           uncompression_dict_
+                               ? *uncompression_dict_
+                               : UncompressionDict::GetEmptyDict(),
                            compression);
     s = UncompressBlockData(
         info, slice.data() + key_size, static_cast<size_t>(value_size),
@@ -12,6 +12,7 @@
 #include "file/random_access_file_reader.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
+#include "util/compression.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace blob_db {
@@ -35,6 +36,8 @@ class BlobDumpTool {
   std::unique_ptr<RandomAccessFileReader> reader_;
   std::unique_ptr<char[]> buffer_;
   size_t buffer_size_;
+  // The dictionary the blobs are compressed with, nullptr without one
+  std::unique_ptr<UncompressionDict> uncompression_dict_;
 
   Status Read(uint64_t offset, size_t size, Slice* result);
   Status DumpBlobLogHeader(uint64_t* offset, CompressionType* compression);
@@ -11,6 +11,7 @@
 #include "utilities/checkpoint/checkpoint_impl.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <string>
 #include <tuple>
@@ -32,6 +33,7 @@
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 #include "util/file_checksum_helper.h"
+#include "util/parallel_for_each.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -42,7 +44,8 @@ Status Checkpoint::Create(DB* db, Checkpoint** checkpoint_ptr) {
 
 Status Checkpoint::CreateCheckpoint(const std::string& /*checkpoint_dir*/,
                                     uint64_t /*log_size_for_flush*/,
-                                    uint64_t* /*sequence_number_ptr*/) {
+                                    uint64_t* /*sequence_number_ptr*/,
+                                    int /*max_threads*/) {
   return Status::NotSupported("");
 }
 
@@ -79,7 +82,8 @@ Status Checkpoint::ExportColumnFamily(
 // Builds an openable snapshot of RocksDB
 Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
                                         uint64_t log_size_for_flush,
-                                        uint64_t* sequence_number_ptr) {
+                                        uint64_t* sequence_number_ptr,
+                                        int max_threads) {
   DBOptions db_options = db_->GetDBOptions();
 
   Status s = db_->GetEnv()->FileExists(checkpoint_dir);
@@ -144,7 +148,8 @@ Status CheckpointImpl::CreateCheckpoint(const std::string& checkpoint_dir,
                               full_private_path + "/" + fname, contents,
                               db_options.use_fsync);
           } /* create_file_cb */,
-          &sequence_number, log_size_for_flush);
+          &sequence_number, log_size_for_flush,
+          false /* get_live_table_checksum */, max_threads);
 
       // we copied all the files, enable file deletions
       if (disabled_file_deletions) {
@@ -201,7 +206,7 @@ Status CheckpointImpl::CreateCustomCheckpoint(
                          FileType type)>
         create_file_cb,
     uint64_t* sequence_number, uint64_t log_size_for_flush,
-    bool get_live_table_checksum) {
+    bool get_live_table_checksum, int max_threads) {
   *sequence_number = db_->GetLatestSequenceNumber();
 
   LiveFilesStorageInfoOptions opts;
@@ -229,9 +234,11 @@ Status CheckpointImpl::CreateCustomCheckpoint(
         "db_paths / cf_paths not supported for Checkpoint nor BackupEngine");
   }
 
-  bool same_fs = true;
+  // Cleared by the first link that is not supported, after which the files
+  // are copied
+  std::atomic<bool> same_fs{true};
 
-  for (auto& info : infos) {
+  auto checkpoint_file = [&](const LiveFileStorageInfo& info) {
     Status s;
     if (!info.replacement_contents.empty()) {
       // Currently should only be used for CURRENT file.
@@ -245,16 +252,19 @@ Status CheckpointImpl::CreateCustomCheckpoint(
                            info.file_type);
       }
     } else {
-      if (same_fs && !info.trim_to_size) {
+      bool linked = false;
+      if (same_fs.load(std::memory_order_relaxed) && !info.trim_to_size) {
         s = link_file_cb(info.directory, info.relative_filename,
                          info.file_type);
         if (s.IsNotSupported()) {
-          same_fs = false;
+          same_fs.store(false, std::memory_order_relaxed);
           s = Status::OK();
+        } else {
+          linked = true;
         }
         s.MustCheck();
       }
-      if (!same_fs || info.trim_to_size) {
+      if (!linked) {
         assert(info.file_checksum_func_name.empty() ==
                !opts.include_checksum_info);
         // no assertion on file_checksum because empty is used for both "not
@@ -270,12 +280,11 @@ Status CheckpointImpl::CreateCustomCheckpoint(
         }
       }
     }
-    if (!s.ok()) {
-      return s;
-    }
-  }
+    return s;
+  };
 
-  return Status::OK();
+  return ParallelForEach(infos.size(), max_threads,
+                         [&](size_t i) { return checkpoint_file(infos[i]); });
 }
 
 // Exports all live SST files of a specified Column Family onto export_dir,
@@ -19,14 +19,16 @@ class CheckpointImpl : public Checkpoint {
 
   Status CreateCheckpoint(const std::string& checkpoint_dir,
                           uint64_t log_size_for_flush,
-                          uint64_t* sequence_number_ptr) override;
+                          uint64_t* sequence_number_ptr,
+                          int max_threads) override;
 
   Status ExportColumnFamily(ColumnFamilyHandle* handle,
                             const std::string& export_dir,
                             ExportImportFilesMetaData** metadata) override;
 
   // Checkpoint logic can be customized by providing callbacks for link, copy,
-  // or create.
+  // or create. With max_threads > 1, the callbacks are called for several
+  // files at a time and must be thread-safe.
   Status CreateCustomCheckpoint(
       std::function<Status(const std::string& src_dirname,
                            const std::string& fname, FileType type)>
@@ -41,7 +43,7 @@ class CheckpointImpl : public Checkpoint {
                            const std::string& contents, FileType type)>
           create_file_cb,
       uint64_t* sequence_number, uint64_t log_size_for_flush,
-      bool get_live_table_checksum = false);
+      bool get_live_table_checksum = false, int max_threads = 1);
 
  private:
   void CleanStagingDirectory(const std::string& path, Logger* info_log);
@@ -583,6 +583,52 @@ TEST_F(CheckpointTest, CheckpointCFNoFlush) {
   snapshotDB = nullptr;
 }
 
+TEST_F(CheckpointTest, CheckpointWithThreads) {
+  Options options = CurrentOptions();
+  CreateAndReopenWithCF({"one", "two"}, options);
+
+  for (int i = 0; i < 4; i++) {
+    for (int cf = 0; cf < 3; cf++) {
+      ASSERT_OK(Put(cf, "key" + std::to_string(i), "val" + std::to_string(i)));
+      ASSERT_OK(Flush(cf));
+    }
+  }
+  // In the WAL only, copied into the checkpoint instead of flushed
+  ASSERT_OK(Put(2, "unflushed", "val"));
+
+  Checkpoint* checkpoint;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+  ASSERT_OK(checkpoint->CreateCheckpoint(snapshot_name_, 1000000,
+                                         nullptr /* sequence_number_ptr */,
+                                         4 /* max_threads */));
+  delete checkpoint;
+  Close();
+
+  DB* snapshotDB;
+  std::vector<ColumnFamilyHandle*> cphandles;
+  std::vector<ColumnFamilyDescriptor> column_families;
+  for (const auto& cf : {kDefaultColumnFamilyName, std::string("one"),
+                         std::string("two")}) {
+    column_families.push_back(ColumnFamilyDescriptor(cf, options));
+  }
+  ASSERT_OK(DB::Open(options, snapshot_name_, column_families, &cphandles,
+                     &snapshotDB));
+  std::string result;
+  for (int i = 0; i < 4; i++) {
+    for (auto* h : cphandles) {
+      ASSERT_OK(snapshotDB->Get(ReadOptions(), h, "key" + std::to_string(i),
+                                &result));
+      ASSERT_EQ("val" + std::to_string(i), result);
+    }
+  }
+  ASSERT_OK(snapshotDB->Get(ReadOptions(), cphandles[2], "unflushed", &result));
+  ASSERT_EQ("val", result);
+  for (auto h : cphandles) {
+    delete h;
+  }
+  delete snapshotDB;
+}
+
 TEST_F(CheckpointTest, CurrentFileModifiedWhileCheckpointing) {
   Options options = CurrentOptions();
   options.max_manifest_file_size = 0;  // always rollover manifest for file add
@@ -18,6 +18,7 @@
 #include "utilities/merge_operators/string_append/stringappend.h"
 #include "utilities/merge_operators/string_append/stringappend2.h"
 #include "utilities/merge_operators/uint64add.h"
+#include "utilities/merge_operators/wide_column_update.h"
 
 namespace ROCKSDB_NAMESPACE {
 static int RegisterBuiltinMergeOperators(ObjectLibrary& library,
@@ -63,6 +64,14 @@ static int RegisterBuiltinMergeOperators(ObjectLibrary& library,
         guard->reset(new UInt64AddOperator());
         return guard->get();
       });
+  library.AddFactory<MergeOperator>(
+      ObjectLibrary::PatternEntry(WideColumnUpdateOperator::kClassName())
+          .AnotherName(WideColumnUpdateOperator::kNickName()),
+      [](const std::string& /*uri*/, std::unique_ptr<MergeOperator>* guard,
+         std::string* /*errmsg*/) {
+        guard->reset(new WideColumnUpdateOperator());
+        return guard->get();
+      });
   library.AddFactory<MergeOperator>(
       ObjectLibrary::PatternEntry(MaxOperator::kClassName())
           .AnotherName(MaxOperator::kNickName()),
@@ -26,6 +26,15 @@ class UInt64AddOperator : public AssociativeMergeOperator {
              const Slice& value, std::string* new_value,
              Logger* logger) const override;
 
+  // Sum all the operands in one pass instead of encoding a partial sum after
+  // each operand, as AssociativeMergeOperator does
+  bool FullMergeV2(const MergeOperationInput& merge_in,
+                   MergeOperationOutput* merge_out) const override;
+
+  bool PartialMergeMulti(const Slice& key,
+                         const std::deque<Slice>& operand_list,
+                         std::string* new_value, Logger* logger) const override;
+
  private:
   // Takes the string and decodes it into a uint64_t
   // On error, prints a message and returns 0
@@ -0,0 +1,97 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "utilities/merge_operators/wide_column_update.h"
+
+#include <vector>
+
+#include "utilities/merge_operators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+std::shared_ptr<MergeOperator>
+MergeOperators::CreateWideColumnUpdateOperator() {
+  return std::make_shared<WideColumnUpdateOperator>();
+}
+
+std::string WideColumnUpdateOperator::SetColumn(const Slice& name,
+                                                const Slice& value) {
+  return UpdateColumns({{name, value}}, {});
+}
+
+std::string WideColumnUpdateOperator::DeleteColumn(const Slice& name) {
+  return UpdateColumns({}, {name});
+}
+
+std::string WideColumnUpdateOperator::UpdateColumns(
+    const WideColumns& columns, const std::vector<Slice>& deleted) {
+  WideColumnUpdates updates;
+  updates.reserve(columns.size() + deleted.size());
+  for (const auto& column : columns) {
+    updates.push_back({WideColumnUpdate::kSet, column.name(), column.value()});
+  }
+  for (const auto& name : deleted) {
+    updates.push_back({WideColumnUpdate::kDelete, name, Slice()});
+  }
+
+  std::string operand;
+  const Status s = WideColumnSerialization::SerializeUpdates(updates, operand);
+  assert(s.ok());
+  (void)s;
+  return operand;
+}
+
+bool WideColumnUpdateOperator::FullMergeV3(
+    const MergeOperationInputV3& merge_in,
+    MergeOperationOutputV3* merge_out) const {
+  assert(merge_out);
+
+  WideColumns base;
+  if (const Slice* value = std::get_if<Slice>(&merge_in.existing_value)) {
+    base.emplace_back(kDefaultWideColumnName, *value);
+  } else if (const WideColumns* columns =
+                 std::get_if<WideColumns>(&merge_in.existing_value)) {
+    base = *columns;
+  }
+
+  WideColumnUpdates updates;
+  const Status s = WideColumnSerialization::DeserializeUpdates(
+      merge_in.operand_list, updates);
+  if (!s.ok()) {
+    return false;
+  }
+
+  WideColumns columns;
+  WideColumnSerialization::ApplyUpdates(base, updates, columns);
+
+  MergeOperationOutputV3::NewColumns new_columns;
+  new_columns.reserve(columns.size());
+  for (const auto& column : columns) {
+    new_columns.emplace_back(column.name().ToString(),
+                             column.value().ToString());
+  }
+  merge_out->new_value = std::move(new_columns);
+
+  return true;
+}
+
+bool WideColumnUpdateOperator::PartialMergeMulti(
+    const Slice& /*key*/, const std::deque<Slice>& operand_list,
+    std::string* new_value, Logger* /*logger*/) const {
+  assert(new_value);
+
+  const std::vector<Slice> operands(operand_list.begin(), operand_list.end());
+  WideColumnUpdates updates;
+  Status s = WideColumnSerialization::DeserializeUpdates(operands, updates);
+  if (!s.ok()) {
+    return false;
+  }
+
+  new_value->clear();
+  s = WideColumnSerialization::SerializeUpdates(updates, *new_value);
+  return s.ok();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,54 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// A MergeOperator that updates single columns of wide-column entities. Each
+// operand sets or deletes one or more columns, leaving the other columns of
+// the entity as they are; a plain base value is the default column. The DB
+// merges these operands during reads and compactions by splicing the columns
+// of the base entity and of the updates, without materializing the columns
+// as strings.
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "db/wide/wide_column_serialization.h"
+#include "rocksdb/merge_operator.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/wide_columns.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class WideColumnUpdateOperator : public MergeOperator {
+ public:
+  // Returns an operand setting the column `name` to `value`
+  static std::string SetColumn(const Slice& name, const Slice& value);
+
+  // Returns an operand deleting the column `name`
+  static std::string DeleteColumn(const Slice& name);
+
+  // Returns an operand setting the columns `columns` and deleting the columns
+  // `deleted`, which must not overlap
+  static std::string UpdateColumns(const WideColumns& columns,
+                                   const std::vector<Slice>& deleted);
+
+  bool FullMergeV3(const MergeOperationInputV3& merge_in,
+                   MergeOperationOutputV3* merge_out) const override;
+
+  bool PartialMergeMulti(const Slice& key,
+                         const std::deque<Slice>& operand_list,
+                         std::string* new_value, Logger* logger) const override;
+
+  static const char* kClassName() {
+    return WideColumnSerialization::kUpdateMergeOperatorName;
+  }
+  static const char* kNickName() { return "wide_column_update"; }
+
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+};
+
+}  // namespace ROCKSDB_NAMESPACE
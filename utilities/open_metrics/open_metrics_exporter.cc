@@ -0,0 +1,193 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/open_metrics_exporter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+
+#include "db/db_impl/db_impl.h"
+#include "db/internal_stats.h"
+#include "util/cast_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Returns `name` with the characters not allowed in OpenMetrics metric names
+// replaced with '_'
+std::string MetricName(const std::string& name) {
+  std::string ret = name;
+  for (auto& c : ret) {
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != ':') {
+      c = '_';
+    }
+  }
+  return ret;
+}
+
+// Returns `value` escaped for an OpenMetrics label value
+std::string LabelValue(const std::string& value) {
+  std::string ret;
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      ret.push_back('\\');
+      ret.push_back(c);
+    } else if (c == '\n') {
+      ret.append("\\n");
+    } else {
+      ret.push_back(c);
+    }
+  }
+  return ret;
+}
+
+void AppendUint64(std::string* out, uint64_t value) {
+  char buf[24];
+  int len = snprintf(buf, sizeof(buf), "%" PRIu64 "\n", value);
+  out->append(buf, static_cast<size_t>(len));
+}
+
+void AppendDouble(std::string* out, double value) {
+  char buf[40];
+  int len = snprintf(buf, sizeof(buf), "%.17g\n", value);
+  out->append(buf, static_cast<size_t>(len));
+}
+}  // namespace
+
+struct OpenMetricsExporter::Rep {
+  struct Ticker {
+    uint32_t type;
+    // The "# TYPE" line of the metric
+    std::string header;
+    // The sample up to its value
+    std::string sample;
+  };
+
+  struct Histogram {
+    uint32_t type;
+    std::string header;
+    std::string median;
+    std::string percentile95;
+    std::string percentile99;
+    std::string max;
+    std::string sum;
+    std::string count;
+  };
+
+  struct Property {
+    const DBPropertyInfo* info;
+    std::string header;
+    // The sample of each column family up to its value
+    std::vector<std::string> samples;
+  };
+
+  DBImpl* db_impl;
+  std::shared_ptr<Statistics> statistics;
+  std::vector<ColumnFamilyHandle*> column_families;
+  std::vector<Ticker> tickers;
+  std::vector<Histogram> histograms;
+  std::vector<Property> properties;
+};
+
+OpenMetricsExporter::OpenMetricsExporter(
+    DB* db, const OpenMetricsExporterOptions& options)
+    : rep_(new Rep()) {
+  rep_->db_impl = static_cast_with_check<DBImpl>(db->GetRootDB());
+  rep_->statistics = options.statistics;
+  if (rep_->statistics == nullptr) {
+    rep_->statistics = db->GetDBOptions().statistics;
+  }
+  rep_->column_families = options.column_families;
+  if (rep_->column_families.empty()) {
+    rep_->column_families.push_back(db->DefaultColumnFamily());
+  }
+
+  if (rep_->statistics != nullptr) {
+    for (const auto& ticker : TickersNameMap) {
+      const std::string name = MetricName(ticker.second);
+      rep_->tickers.push_back({ticker.first, "# TYPE " + name + " counter\n",
+                               name + "_total "});
+    }
+    for (const auto& histogram : HistogramsNameMap) {
+      const std::string name = MetricName(histogram.second);
+      Rep::Histogram h;
+      h.type = histogram.first;
+      h.header = "# TYPE " + name + " summary\n";
+      h.median = name + "{quantile=\"0.5\"} ";
+      h.percentile95 = name + "{quantile=\"0.95\"} ";
+      h.percentile99 = name + "{quantile=\"0.99\"} ";
+      h.max = name + "{quantile=\"1\"} ";
+      h.sum = name + "_sum ";
+      h.count = name + "_count ";
+      rep_->histograms.push_back(std::move(h));
+    }
+  }
+
+  std::vector<std::string> property_names;
+  for (const auto& property : InternalStats::ppt_name_to_info) {
+    if (property.second.handle_int != nullptr &&
+        (property.second.need_out_of_mutex ||
+         options.include_db_mutex_properties)) {
+      property_names.push_back(property.first);
+    }
+  }
+  std::sort(property_names.begin(), property_names.end());
+  for (const auto& property_name : property_names) {
+    const std::string name = MetricName(property_name);
+    Rep::Property p;
+    p.info = &InternalStats::ppt_name_to_info.at(property_name);
+    p.header = "# TYPE " + name + " gauge\n";
+    for (auto* cfh : rep_->column_families) {
+      p.samples.push_back(name + "{cf=\"" + LabelValue(cfh->GetName()) +
+                          "\"} ");
+    }
+    rep_->properties.push_back(std::move(p));
+  }
+}
+
+OpenMetricsExporter::~OpenMetricsExporter() = default;
+
+void OpenMetricsExporter::Export(std::string* out) const {
+  out->clear();
+  Statistics* statistics = rep_->statistics.get();
+  for (const auto& ticker : rep_->tickers) {
+    out->append(ticker.header);
+    out->append(ticker.sample);
+    AppendUint64(out, statistics->getTickerCount(ticker.type));
+  }
+  for (const auto& histogram : rep_->histograms) {
+    HistogramData data;
+    statistics->histogramData(histogram.type, &data);
+    out->append(histogram.header);
+    out->append(histogram.median);
+    AppendDouble(out, data.median);
+    out->append(histogram.percentile95);
+    AppendDouble(out, data.percentile95);
+    out->append(histogram.percentile99);
+    AppendDouble(out, data.percentile99);
+    out->append(histogram.max);
+    AppendDouble(out, data.max);
+    out->append(histogram.sum);
+    AppendUint64(out, data.sum);
+    out->append(histogram.count);
+    AppendUint64(out, data.count);
+  }
+  for (const auto& property : rep_->properties) {
+    out->append(property.header);
+    for (size_t i = 0; i < rep_->column_families.size(); ++i) {
+      uint64_t value = 0;
+      if (rep_->db_impl->GetIntPropertyByInfo(rep_->column_families[i],
+                                              *property.info, &value)) {
+        out->append(property.samples[i]);
+        AppendUint64(out, value);
+      }
+    }
+  }
+  out->append("# EOF\n");
+}
+
+}  // namespace ROCKSDB_NAMESPACE
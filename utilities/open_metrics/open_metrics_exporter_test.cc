@@ -0,0 +1,83 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/open_metrics_exporter.h"
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class OpenMetricsExporterTest : public DBTestBase {
+ public:
+  OpenMetricsExporterTest()
+      : DBTestBase("open_metrics_exporter_test", /*env_do_fsync=*/false) {}
+};
+
+TEST_F(OpenMetricsExporterTest, Export) {
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  ASSERT_OK(Put(1, "foo", "v1"));
+  ASSERT_OK(Flush(1));
+  ASSERT_EQ("v1", Get(1, "foo"));
+  ASSERT_EQ("NOT_FOUND", Get(1, "bar"));
+
+  OpenMetricsExporterOptions exporter_options;
+  exporter_options.column_families = handles_;
+  OpenMetricsExporter exporter(db_, exporter_options);
+  std::string metrics;
+  exporter.Export(&metrics);
+
+  ASSERT_NE(metrics.find("# TYPE rocksdb_number_keys_written counter\n"
+                         "rocksdb_number_keys_written_total 1\n"),
+            std::string::npos);
+  ASSERT_NE(metrics.find("# TYPE rocksdb_db_get_micros summary\n"
+                         "rocksdb_db_get_micros{quantile=\"0.5\"} "),
+            std::string::npos);
+  ASSERT_NE(metrics.find("rocksdb_db_get_micros_count 2\n"),
+            std::string::npos);
+  ASSERT_NE(metrics.find("# TYPE rocksdb_estimate_live_data_size gauge\n"
+                         "rocksdb_estimate_live_data_size{cf=\"default\"} 0\n"
+                         "rocksdb_estimate_live_data_size{cf=\"pikachu\"} "),
+            std::string::npos);
+  // Properties read under the DB mutex are left out by default
+  ASSERT_EQ(metrics.find("rocksdb_num_running_compactions"),
+            std::string::npos);
+  ASSERT_EQ(metrics.rfind("# EOF\n"), metrics.size() - 6);
+
+  // An export reuses the buffer
+  const size_t capacity = metrics.capacity();
+  exporter.Export(&metrics);
+  ASSERT_EQ(metrics.capacity(), capacity);
+
+  exporter_options.include_db_mutex_properties = true;
+  OpenMetricsExporter all_exporter(db_, exporter_options);
+  all_exporter.Export(&metrics);
+  ASSERT_NE(metrics.find("rocksdb_num_running_compactions{cf=\"pikachu\"} 0\n"),
+            std::string::npos);
+}
+
+TEST_F(OpenMetricsExporterTest, NoStatistics) {
+  Options options = CurrentOptions();
+  options.statistics = nullptr;
+  Reopen(options);
+
+  OpenMetricsExporter exporter(db_, OpenMetricsExporterOptions());
+  std::string metrics;
+  exporter.Export(&metrics);
+  ASSERT_EQ(metrics.find("_total "), std::string::npos);
+  ASSERT_NE(metrics.find("rocksdb_estimate_table_readers_mem{cf=\"default\"}"),
+            std::string::npos);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
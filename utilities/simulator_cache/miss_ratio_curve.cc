@@ -0,0 +1,249 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "utilities/simulator_cache/miss_ratio_curve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "util/hash.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+int MissRatioCurveEstimator::BucketOf(uint64_t distance) {
+  if (distance < 4) {
+    return static_cast<int>(distance);
+  }
+  const int log2 = FloorLog2(distance);
+  return 4 * (log2 - 1) + static_cast<int>((distance >> (log2 - 2)) & 3);
+}
+
+uint64_t MissRatioCurveEstimator::BucketUpperBound(int bucket) {
+  if (bucket < 4) {
+    return static_cast<uint64_t>(bucket);
+  }
+  const int shift = bucket / 4 - 1;
+  const uint64_t lower = static_cast<uint64_t>(4 + bucket % 4) << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+Status MissRatioCurveEstimator::Start(const MissRatioCurveOptions& options) {
+  if (!(options.sampling_rate > 0 && options.sampling_rate <= 1)) {
+    return Status::InvalidArgument("sampling_rate must be in (0, 1]");
+  }
+  if (options.max_sampled_keys == 0) {
+    return Status::InvalidArgument("max_sampled_keys must be positive");
+  }
+  MutexLock l(&mutex_);
+  threshold_ = std::max(
+      uint64_t{1}, static_cast<uint64_t>(std::llround(
+                       options.sampling_rate * static_cast<double>(kModulus))));
+  max_sampled_keys_ = options.max_sampled_keys;
+  samples_.clear();
+  by_hash_.clear();
+  // With room for as many lookups as keys between renumberings, and for one
+  // key over the maximum before its eviction
+  charge_tree_.assign(2 * (max_sampled_keys_ + 1) + 1, 0);
+  total_charge_ = 0;
+  now_ = 0;
+  histogram_.assign(kNumBuckets, 0);
+  cold_misses_ = 0;
+  num_sampled_lookups_ = 0;
+  num_lookups_.store(0, std::memory_order_relaxed);
+  sample_threshold_.store(threshold_, std::memory_order_relaxed);
+  return Status::OK();
+}
+
+void MissRatioCurveEstimator::Stop() {
+  MutexLock l(&mutex_);
+  sample_threshold_.store(0, std::memory_order_relaxed);
+}
+
+bool MissRatioCurveEstimator::MaySample(const Slice& key,
+                                        uint64_t* hash) const {
+  const uint64_t threshold = sample_threshold_.load(std::memory_order_relaxed);
+  if (threshold == 0) {
+    return false;
+  }
+  *hash = GetSliceNPHash64(key);
+  return (*hash % kModulus) < threshold;
+}
+
+void MissRatioCurveEstimator::AddCharge(uint64_t time, uint64_t delta) {
+  // Unsigned arithmetic wraps around for the negative deltas
+  for (; time < charge_tree_.size(); time += time & (~time + 1)) {
+    charge_tree_[time] += delta;
+  }
+  total_charge_ += delta;
+}
+
+uint64_t MissRatioCurveEstimator::ChargeUpTo(uint64_t time) const {
+  uint64_t sum = 0;
+  for (; time > 0; time -= time & (~time + 1)) {
+    sum += charge_tree_[time];
+  }
+  return sum;
+}
+
+uint64_t MissRatioCurveEstimator::NextTime() {
+  if (now_ + 1 >= charge_tree_.size()) {
+    RenumberTimes();
+  }
+  return ++now_;
+}
+
+void MissRatioCurveEstimator::RenumberTimes() {
+  std::vector<std::pair<uint64_t, Sample*>> by_time;
+  by_time.reserve(samples_.size());
+  for (auto& entry : samples_) {
+    by_time.emplace_back(entry.second.time, &entry.second);
+  }
+  std::sort(by_time.begin(), by_time.end(),
+            [](const std::pair<uint64_t, Sample*>& a,
+               const std::pair<uint64_t, Sample*>& b) {
+              return a.first < b.first;
+            });
+  std::fill(charge_tree_.begin(), charge_tree_.end(), 0);
+  total_charge_ = 0;
+  now_ = 0;
+  for (auto& entry : by_time) {
+    entry.second->time = ++now_;
+    AddCharge(now_, entry.second->charge);
+  }
+}
+
+void MissRatioCurveEstimator::AddSample(uint64_t hash, size_t charge) {
+  const uint64_t time = NextTime();
+  samples_.emplace(hash, Sample{time, charge});
+  by_hash_.emplace(hash % kModulus, hash);
+  AddCharge(time, charge);
+  MaybeEvict();
+}
+
+void MissRatioCurveEstimator::SetCharge(Sample* sample, size_t charge) {
+  AddCharge(sample->time, uint64_t{charge} - uint64_t{sample->charge});
+  sample->charge = charge;
+}
+
+void MissRatioCurveEstimator::MaybeEvict() {
+  if (samples_.size() <= max_sampled_keys_) {
+    return;
+  }
+  const uint64_t old_threshold = threshold_;
+  while (samples_.size() > max_sampled_keys_) {
+    // The keys with the highest hash are no longer sampled
+    threshold_ = by_hash_.rbegin()->first;
+    while (!by_hash_.empty() && by_hash_.rbegin()->first == threshold_) {
+      auto it = samples_.find(by_hash_.rbegin()->second);
+      AddCharge(it->second.time, ~uint64_t{it->second.charge} + 1);
+      samples_.erase(it);
+      by_hash_.erase(std::prev(by_hash_.end()));
+    }
+  }
+  sample_threshold_.store(threshold_, std::memory_order_relaxed);
+  // The lookups sampled so far are counted as if sampled at the lower rate
+  const double scale = static_cast<double>(threshold_) / old_threshold;
+  for (double& count : histogram_) {
+    count *= scale;
+  }
+  cold_misses_ *= scale;
+  num_sampled_lookups_ *= scale;
+}
+
+void MissRatioCurveEstimator::Lookup(const Slice& key, size_t charge) {
+  if (!IsStarted()) {
+    return;
+  }
+  num_lookups_.fetch_add(1, std::memory_order_relaxed);
+  uint64_t hash = 0;
+  if (!MaySample(key, &hash)) {
+    return;
+  }
+  MutexLock l(&mutex_);
+  if (hash % kModulus >= sample_threshold_.load(std::memory_order_relaxed)) {
+    // Stopped, or the threshold was lowered in the meantime
+    return;
+  }
+  num_sampled_lookups_ += 1;
+  auto it = samples_.find(hash);
+  if (it == samples_.end()) {
+    cold_misses_ += 1;
+    AddSample(hash, charge);
+    return;
+  }
+  Sample& sample = it->second;
+  if (charge != 0) {
+    SetCharge(&sample, charge);
+  }
+  // The charge of the keys looked up since, scaled to all the keys, plus
+  // the charge of the key itself
+  const uint64_t others = total_charge_ - ChargeUpTo(sample.time);
+  const double scaled =
+      static_cast<double>(others) / SamplingRate() + sample.charge;
+  const uint64_t distance = scaled < 0x1p64
+                                ? static_cast<uint64_t>(scaled)
+                                : std::numeric_limits<uint64_t>::max();
+  histogram_[BucketOf(distance)] += 1;
+  // NextTime() may renumber the times of all the keys, so first
+  const uint64_t time = NextTime();
+  AddCharge(sample.time, ~uint64_t{sample.charge} + 1);
+  sample.time = time;
+  AddCharge(time, sample.charge);
+}
+
+void MissRatioCurveEstimator::Insert(const Slice& key, size_t charge) {
+  uint64_t hash = 0;
+  if (!MaySample(key, &hash)) {
+    return;
+  }
+  MutexLock l(&mutex_);
+  if (hash % kModulus >= sample_threshold_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  auto it = samples_.find(hash);
+  if (it == samples_.end()) {
+    // Inserted without a lookup first, it takes room in the cache all the
+    // same
+    AddSample(hash, charge);
+  } else {
+    SetCharge(&it->second, charge);
+  }
+}
+
+std::map<uint64_t, double> MissRatioCurveEstimator::GetCurve() const {
+  std::map<uint64_t, double> curve;
+  MutexLock l(&mutex_);
+  if (threshold_ == 0) {
+    return curve;
+  }
+  std::vector<double> histogram = histogram_;
+  // The sampled lookups deviate from the expected share of all the lookups
+  // by chance, mostly because of the few most popular keys. As in SHARDS_adj
+  // the difference is made up by the smallest reuse distances.
+  const double expected =
+      static_cast<double>(num_lookups_.load(std::memory_order_relaxed)) *
+      SamplingRate();
+  histogram[0] = std::max(0.0, histogram[0] + expected - num_sampled_lookups_);
+  double total = cold_misses_;
+  for (double count : histogram) {
+    total += count;
+  }
+  if (total <= 0) {
+    return curve;
+  }
+  double misses = total;
+  for (int bucket = 0; bucket < kNumBuckets; bucket++) {
+    if (histogram[bucket] > 0) {
+      misses -= histogram[bucket];
+      curve[BucketUpperBound(bucket)] = std::max(0.0, misses / total);
+    }
+  }
+  return curve;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
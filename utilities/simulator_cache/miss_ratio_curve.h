@@ -0,0 +1,119 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/utilities/sim_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Estimates the miss ratio curve of the lookups of a cache, that is the miss
+// ratio of an LRU cache of any capacity, with fixed-size SHARDS (Waldspurger
+// et al., "Efficient MRC Construction with SHARDS"). Only the keys whose hash
+// falls below a threshold are sampled, and the reuse distance of each lookup
+// of a sampled key, the total charge of the distinct sampled keys looked up
+// since its previous lookup, is scaled by the sampling rate into a histogram.
+// When more keys than the maximum are sampled, the threshold is lowered to
+// drop the keys with the highest hashes, and the histogram is rescaled.
+//
+// The lookups of keys not sampled only hash the key and count the lookup.
+// Thread-safe.
+class MissRatioCurveEstimator {
+ public:
+  MissRatioCurveEstimator() = default;
+
+  MissRatioCurveEstimator(const MissRatioCurveEstimator&) = delete;
+  MissRatioCurveEstimator& operator=(const MissRatioCurveEstimator&) = delete;
+
+  // Starts estimating the curve from scratch
+  Status Start(const MissRatioCurveOptions& options);
+
+  // Stops sampling, keeping the estimate
+  void Stop();
+
+  bool IsStarted() const {
+    return sample_threshold_.load(std::memory_order_relaxed) != 0;
+  }
+
+  // Records a lookup of key, with the charge of its entry if the cache has
+  // it, or 0 if unknown
+  void Lookup(const Slice& key, size_t charge);
+
+  // Records the charge of the entry of key inserted in the cache
+  void Insert(const Slice& key, size_t charge);
+
+  // See SimCache::GetMissRatioCurve()
+  std::map<uint64_t, double> GetCurve() const;
+
+ private:
+  // A key is sampled when its hash modulo kModulus is less than the threshold
+  static constexpr uint64_t kModulus = uint64_t{1} << 24;
+  // Reuse distances are bucketed by their log2 with 2 more bits of precision
+  static constexpr int kNumBuckets = 252;
+
+  struct Sample {
+    // The logical time of the last lookup of the key
+    uint64_t time;
+    size_t charge;
+  };
+
+  static int BucketOf(uint64_t distance);
+  static uint64_t BucketUpperBound(int bucket);
+
+  // Returns the hash of key, and whether it may be sampled
+  bool MaySample(const Slice& key, uint64_t* hash) const;
+
+  double SamplingRate() const {
+    return static_cast<double>(threshold_) / kModulus;
+  }
+
+  // The charges of the sampled keys by the time of their last lookup, as a
+  // Fenwick tree
+  void AddCharge(uint64_t time, uint64_t delta);
+  uint64_t ChargeUpTo(uint64_t time) const;
+
+  uint64_t NextTime();
+  // Renumbers the times of the sampled keys from 1 when they run out
+  void RenumberTimes();
+
+  void AddSample(uint64_t hash, size_t charge);
+  void SetCharge(Sample* sample, size_t charge);
+  // Lowers the threshold until no more than the maximum keys are sampled
+  void MaybeEvict();
+
+  // A copy of threshold_ to filter the keys without the mutex, 0 when
+  // stopped
+  std::atomic<uint64_t> sample_threshold_{0};
+  // All the lookups since Start(), sampled or not
+  std::atomic<uint64_t> num_lookups_{0};
+
+  mutable port::Mutex mutex_;
+  uint64_t threshold_ = 0;
+  size_t max_sampled_keys_ = 0;
+  std::unordered_map<uint64_t, Sample> samples_;
+  // The sampled keys by their hash modulo kModulus, to lower the threshold
+  std::set<std::pair<uint64_t, uint64_t>> by_hash_;
+  std::vector<uint64_t> charge_tree_;
+  uint64_t total_charge_ = 0;
+  uint64_t now_ = 0;
+  // The sampled lookups by reuse distance, and those of keys not sampled
+  // before, in the units of the current sampling rate
+  std::vector<double> histogram_;
+  double cold_misses_ = 0;
+  double num_sampled_lookups_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -14,6 +14,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
 #include "util/mutexlock.h"
+#include "utilities/simulator_cache/miss_ratio_curve.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -159,7 +160,7 @@ class SimCacheImpl : public SimCache {
 
   ~SimCacheImpl() override {}
 
-  const char* Name() const override { return "SimCache"; }
+  const char* Name() const override { return kClassName(); }
 
   void SetCapacity(size_t capacity) override { target_->SetCapacity(capacity); }
 
@@ -188,6 +189,9 @@ class SimCacheImpl : public SimCache {
     }
 
     cache_activity_logger_.ReportAdd(key, charge);
+    if (miss_ratio_curve_.IsStarted()) {
+      miss_ratio_curve_.Insert(key, charge);
+    }
     if (!target_) {
       return Status::OK();
     }
@@ -201,13 +205,20 @@ class SimCacheImpl : public SimCache {
                  Statistics* stats = nullptr) override {
     HandleLookup(key, stats);
     if (!target_) {
+      miss_ratio_curve_.Lookup(key, 0);
       return nullptr;
     }
-    return target_->Lookup(key, helper, create_context, priority, stats);
+    Handle* h = target_->Lookup(key, helper, create_context, priority, stats);
+    if (miss_ratio_curve_.IsStarted()) {
+      // The charge of a hit is known, that of a miss once inserted
+      miss_ratio_curve_.Lookup(key, h != nullptr ? target_->GetCharge(h) : 0);
+    }
+    return h;
   }
 
   void StartAsyncLookup(AsyncLookupHandle& async_handle) override {
     HandleLookup(async_handle.key, async_handle.stats);
+    miss_ratio_curve_.Lookup(async_handle.key, 0);
     if (target_) {
       target_->StartAsyncLookup(async_handle);
     }
@@ -325,12 +336,23 @@ class SimCacheImpl : public SimCache {
     return cache_activity_logger_.bg_status();
   }
 
+  Status StartMissRatioCurve(const MissRatioCurveOptions& options) override {
+    return miss_ratio_curve_.Start(options);
+  }
+
+  void StopMissRatioCurve() override { miss_ratio_curve_.Stop(); }
+
+  std::map<uint64_t, double> GetMissRatioCurve() const override {
+    return miss_ratio_curve_.GetCurve();
+  }
+
  private:
   std::shared_ptr<Cache> key_only_cache_;
   std::atomic<uint64_t> miss_times_;
   std::atomic<uint64_t> hit_times_;
   Statistics* stats_;
   CacheActivityLogger cache_activity_logger_;
+  MissRatioCurveEstimator miss_ratio_curve_;
 
   void inc_miss_counter() {
     miss_times_.fetch_add(1, std::memory_order_relaxed);
@@ -217,6 +217,114 @@ TEST_F(SimCacheTest, SimCacheLogging) {
   ASSERT_GT(fsize, max_size - 100);
 }
 
+namespace {
+// The miss ratio of a capacity on the curve
+double MissRatioAt(const std::map<uint64_t, double>& curve, uint64_t capacity) {
+  auto it = curve.upper_bound(capacity);
+  return it == curve.begin() ? 1.0 : std::prev(it)->second;
+}
+
+// Looks up the keys in a loop as a block cache does, inserting the misses
+void LookupInLoop(Cache* cache, int num_keys, int num_loops,
+                  size_t charge) {
+  for (int loop = 0; loop < num_loops; loop++) {
+    for (int i = 0; i < num_keys; i++) {
+      std::string key = "key" + std::to_string(i);
+      Cache::Handle* h = cache->Lookup(key);
+      if (h == nullptr) {
+        ASSERT_OK(cache->Insert(key, nullptr, &kNoopCacheItemHelper, charge));
+      } else {
+        cache->Release(h);
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST_F(SimCacheTest, MissRatioCurve) {
+  std::shared_ptr<SimCache> sim_cache =
+      NewSimCache(NewLRUCache(1 << 20, 0), 1 << 20, 0);
+  MissRatioCurveOptions mrc_options;
+  mrc_options.sampling_rate = 0;
+  ASSERT_TRUE(sim_cache->StartMissRatioCurve(mrc_options).IsInvalidArgument());
+  mrc_options.sampling_rate = 1;
+  mrc_options.max_sampled_keys = 0;
+  ASSERT_TRUE(sim_cache->StartMissRatioCurve(mrc_options).IsInvalidArgument());
+  ASSERT_TRUE(sim_cache->GetMissRatioCurve().empty());
+
+  // All the keys sampled: the loop over 100 keys of 10 bytes misses but
+  // for the first time in a cache of 1000 bytes or more
+  mrc_options.max_sampled_keys = 1000;
+  ASSERT_OK(sim_cache->StartMissRatioCurve(mrc_options));
+  LookupInLoop(sim_cache.get(), 100, 5, 10);
+  std::map<uint64_t, double> curve = sim_cache->GetMissRatioCurve();
+  ASSERT_EQ(curve.size(), 1);
+  ASSERT_GE(curve.begin()->first, 1000);
+  ASSERT_LT(curve.begin()->first, 1100);
+  ASSERT_DOUBLE_EQ(curve.begin()->second, 0.2);
+  ASSERT_DOUBLE_EQ(MissRatioAt(curve, 999), 1.0);
+
+  // Stopping keeps the estimate
+  sim_cache->StopMissRatioCurve();
+  LookupInLoop(sim_cache.get(), 10, 1, 10);
+  ASSERT_EQ(sim_cache->GetMissRatioCurve(), curve);
+
+  // With more keys than sampled, the distances are scaled up
+  mrc_options.max_sampled_keys = 500;
+  ASSERT_OK(sim_cache->StartMissRatioCurve(mrc_options));
+  LookupInLoop(sim_cache.get(), 20000, 5, 10);
+  curve = sim_cache->GetMissRatioCurve();
+  ASSERT_GT(MissRatioAt(curve, 150000), 0.95);
+  ASSERT_NEAR(MissRatioAt(curve, 250000), 0.2, 0.05);
+}
+
+TEST_F(SimCacheTest, MissRatioCurveProperty) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  std::shared_ptr<SimCache> sim_cache =
+      NewSimCache(NewLRUCache(1 << 20), 1 << 20, 0);
+  table_options.block_cache = sim_cache;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_OK(Flush());
+
+  MissRatioCurveOptions mrc_options;
+  mrc_options.sampling_rate = 1;
+  ASSERT_OK(sim_cache->StartMissRatioCurve(mrc_options));
+  for (int loop = 0; loop < 3; loop++) {
+    for (int i = 0; i < 20; i++) {
+      ASSERT_EQ(Get(Key(i)), "val");
+    }
+  }
+  std::map<uint64_t, double> curve = sim_cache->GetMissRatioCurve();
+  ASSERT_FALSE(curve.empty());
+
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheMissRatioCurve, &values));
+  ASSERT_EQ(values.size(), curve.size());
+  for (const auto& point : curve) {
+    ASSERT_EQ(values[std::to_string(point.first)],
+              std::to_string(point.second));
+  }
+  std::string value;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlockCacheMissRatioCurve,
+                               &value));
+  ASSERT_NE(value.find("MissRatio"), std::string::npos);
+
+  // Not available for other caches
+  table_options.block_cache = NewLRUCache(1 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_FALSE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheMissRatioCurve, &values));
+  ASSERT_FALSE(
+      db_->GetProperty(DB::Properties::kBlockCacheMissRatioCurve, &value));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -6,16 +6,116 @@
 
 #include "utilities/trace/replayer_impl.h"
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <limits>
 #include <thread>
 
+#include "db/dbformat.h"
+#include "db/write_batch_internal.h"
+#include "port/port.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/system_clock.h"
-#include "util/threadpool_imp.h"
+#include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+using ReplayClock = std::chrono::steady_clock;
+
+// The number of traces read and decoded before handing them to the threads of
+// a multi-threaded replay
+constexpr size_t kReplayBatchSize = 256;
+// The number of decoded traces a thread may have queued before the reading
+// waits for it
+constexpr size_t kMaxQueuedTraces = 64 * kReplayBatchSize;
+// Sleeping wakes up too late by tens of micros, so the last ones are spun
+constexpr int64_t kSpinMicros = 50;
+
+ReplayClock::time_point DueTime(ReplayClock::time_point replay_epoch,
+                                uint64_t trace_ts, uint64_t header_ts,
+                                double fast_forward) {
+  return replay_epoch +
+         std::chrono::microseconds(static_cast<uint64_t>(
+             std::llround(1.0 * (trace_ts - header_ts) / fast_forward)));
+}
+
+// Waits until `due` and returns how late it is then in micros
+uint64_t WaitUntil(ReplayClock::time_point due) {
+  const auto spin = std::chrono::microseconds(kSpinMicros);
+  if (due - ReplayClock::now() > spin) {
+    std::this_thread::sleep_until(due - spin);
+  }
+  ReplayClock::time_point now = ReplayClock::now();
+  while (now < due) {
+    std::this_thread::yield();
+    now = ReplayClock::now();
+  }
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(now - due)
+          .count());
+}
+
+// The key that decides the thread of a trace in a multi-threaded replay
+Slice GetRoutingKey(const TraceRecord& record) {
+  switch (record.GetTraceType()) {
+    case kTraceGet:
+      return static_cast<const GetQueryTraceRecord&>(record).GetKey();
+    case kTraceIteratorSeek:
+    case kTraceIteratorSeekForPrev:
+      return static_cast<const IteratorSeekQueryTraceRecord&>(record).GetKey();
+    case kTraceMultiGet: {
+      const auto& multi_get =
+          static_cast<const MultiGetQueryTraceRecord&>(record);
+      return multi_get.GetKeys().empty() ? Slice() : multi_get.GetKeys()[0];
+    }
+    case kTraceWrite: {
+      Slice input =
+          static_cast<const WriteQueryTraceRecord&>(record).GetWriteBatchRep();
+      if (input.size() < WriteBatchInternal::kHeader) {
+        return Slice();
+      }
+      input.remove_prefix(WriteBatchInternal::kHeader);
+      while (!input.empty()) {
+        char tag = 0;
+        uint32_t column_family = 0;
+        Slice key, value, blob, xid;
+        if (!ReadRecordFromWriteBatch(&input, &tag, &column_family, &key,
+                                      &value, &blob, &xid)
+                 .ok()) {
+          break;
+        }
+        if (!key.empty()) {
+          return key;
+        }
+      }
+      return Slice();
+    }
+    default:
+      return Slice();
+  }
+}
+
+// A decoded trace and the time to execute it at
+struct ScheduledTrace {
+  ReplayClock::time_point due;
+  std::unique_ptr<TraceRecord> record;
+};
+
+// The traces of one thread of a multi-threaded replay, in trace order
+struct ReplayQueue {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<ScheduledTrace> traces;
+  bool done = false;
+  HistogramImpl lag;
+};
+}  // namespace
+
 ReplayerImpl::ReplayerImpl(DB* db,
                            const std::vector<ColumnFamilyHandle*>& handles,
                            std::unique_ptr<TraceReader>&& reader)
@@ -96,8 +196,8 @@ Status ReplayerImpl::Replay(
 
   if (options.num_threads <= 1) {
     // num_threads == 0 or num_threads == 1 uses single thread.
-    std::chrono::system_clock::time_point replay_epoch =
-        std::chrono::system_clock::now();
+    HistogramImpl lag;
+    ReplayClock::time_point replay_epoch = ReplayClock::now();
 
     while (s.ok()) {
       Trace trace;
@@ -121,13 +221,8 @@ Status ReplayerImpl::Replay(
         break;
       }
 
-      std::chrono::system_clock::time_point sleep_to =
-          replay_epoch +
-          std::chrono::microseconds(static_cast<uint64_t>(std::llround(
-              1.0 * (trace.ts - header_ts_) / options.fast_forward)));
-      if (sleep_to > std::chrono::system_clock::now()) {
-        std::this_thread::sleep_until(sleep_to);
-      }
+      uint64_t lag_micros = WaitUntil(
+          DueTime(replay_epoch, trace.ts, header_ts_, options.fast_forward));
 
       // Skip unsupported traces, stop for other errors.
       if (s.IsNotSupported()) {
@@ -137,6 +232,7 @@ Status ReplayerImpl::Replay(
         s = Status::OK();
         continue;
       }
+      lag.Add(lag_micros);
 
       if (result_callback == nullptr) {
         s = Execute(record, nullptr);
@@ -146,107 +242,174 @@ Status ReplayerImpl::Replay(
         result_callback(s, std::move(res));
       }
     }
+    SetTimingStats(lag);
   } else {
-    // Multi-threaded replay.
-    ThreadPoolImpl thread_pool;
-    thread_pool.SetHostEnv(env_);
-    thread_pool.SetBackgroundThreads(static_cast<int>(options.num_threads));
-
-    std::mutex mtx;
-    // Background decoding and execution status.
-    Status bg_s = Status::OK();
-    uint64_t last_err_ts = static_cast<uint64_t>(-1);
-    // Callback function used in background work to update bg_s for the ealiest
-    // TraceRecord which has execution error. This is different from the
-    // timestamp of the first execution error (either start or end timestamp).
-    //
-    // Suppose TraceRecord R1, R2, with timestamps T1 < T2. Their execution
-    // timestamps are T1_start, T1_end, T2_start, T2_end.
-    // Single-thread: there must be T1_start < T1_end < T2_start < T2_end.
-    // Multi-thread: T1_start < T2_start may not be enforced. Orders of them are
-    // totally unknown.
-    // In order to report the same `first` error in both single-thread and
-    // multi-thread replay, we can only rely on the TraceRecords' timestamps,
-    // rather than their executin timestamps. Although in single-thread replay,
-    // the first error is also the last error, while in multi-thread replay, the
-    // first error may not be the first error in execution, and it may not be
-    // the last error in exeution as well.
-    auto error_cb = [&mtx, &bg_s, &last_err_ts](Status err, uint64_t err_ts) {
-      std::lock_guard<std::mutex> gd(mtx);
-      // Only record the first error.
-      if (!err.ok() && !err.IsNotSupported() && err_ts < last_err_ts) {
-        bg_s = err;
-        last_err_ts = err_ts;
-      }
-    };
+    s = ReplayMultiThreaded(options, result_callback);
+  }
 
-    std::chrono::system_clock::time_point replay_epoch =
-        std::chrono::system_clock::now();
+  if (s.IsIncomplete()) {
+    // Reaching eof returns Incomplete status at the moment.
+    // Could happen when killing a process without calling EndTrace() API.
+    // TODO: Add better error handling.
+    trace_end_ = true;
+    return Status::OK();
+  }
+  return s;
+}
+
+Status ReplayerImpl::ReplayMultiThreaded(
+    const ReplayOptions& options,
+    const std::function<void(Status, std::unique_ptr<TraceRecordResult>&&)>&
+        result_callback) {
+  // The traces are decoded here, so the threads only wait for their time and
+  // execute them.
+  //
+  // Like the single-threaded replay, the replay stops at the first trace that
+  // fails and returns its error. The traces don't finish in timestamp order,
+  // so the first one is the failed trace with the earliest timestamp, rather
+  // than the first to fail. No more traces are queued once one has failed,
+  // but the ones already queued still run.
+  std::mutex error_mutex;
+  Status error_s;
+  uint64_t error_ts = std::numeric_limits<uint64_t>::max();
+  std::atomic<bool> failed{false};
+  auto record_error = [&](const Status& err, uint64_t ts) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (ts < error_ts) {
+      error_s = err;
+      error_ts = ts;
+    }
+    failed.store(true, std::memory_order_release);
+  };
+
+  std::vector<std::unique_ptr<ReplayQueue>> queues;
+  std::vector<port::Thread> threads;
+  for (uint32_t i = 0; i < options.num_threads; ++i) {
+    queues.emplace_back(new ReplayQueue());
+    ReplayQueue* queue = queues.back().get();
+    threads.emplace_back([this, queue, &result_callback, &record_error]() {
+      while (true) {
+        ScheduledTrace trace;
+        {
+          std::unique_lock<std::mutex> lock(queue->mutex);
+          queue->cv.wait(lock, [queue] {
+            return !queue->traces.empty() || queue->done;
+          });
+          if (queue->traces.empty()) {
+            break;
+          }
+          trace = std::move(queue->traces.front());
+          queue->traces.pop_front();
+        }
+        // Wakes up the reading if it waits for room
+        queue->cv.notify_all();
+
+        queue->lag.Add(WaitUntil(trace.due));
+        Status exec_s;
+        if (result_callback == nullptr) {
+          exec_s = Execute(trace.record, nullptr);
+        } else {
+          std::unique_ptr<TraceRecordResult> res;
+          exec_s = Execute(trace.record, &res);
+          result_callback(exec_s, std::move(res));
+        }
+        if (!exec_s.ok() && !exec_s.IsNotSupported()) {
+          record_error(exec_s, trace.record->GetTimestamp());
+        }
+      }
+    });
+  }
 
-    while (bg_s.ok() && s.ok()) {
+  Status s;
+  std::vector<std::vector<ScheduledTrace>> batches(queues.size());
+  ReplayClock::time_point replay_epoch = ReplayClock::now();
+  while (s.ok() && !failed.load(std::memory_order_acquire)) {
+    for (size_t n = 0; n < kReplayBatchSize; ++n) {
       Trace trace;
       s = ReadTrace(&trace);
       // If already at trace end, ReadTrace should return Status::Incomplete().
       if (!s.ok()) {
         break;
       }
-
-      TraceType trace_type = trace.type;
-
-      // No need to sleep before breaking the loop if at the trace end.
-      if (trace_type == kTraceEnd) {
+      if (trace.type == kTraceEnd) {
         trace_end_ = true;
         s = Status::Incomplete("Trace end.");
         break;
       }
 
-      // In multi-threaded replay, sleep first then start decoding and
-      // execution in a thread.
-      std::chrono::system_clock::time_point sleep_to =
-          replay_epoch +
-          std::chrono::microseconds(static_cast<uint64_t>(std::llround(
-              1.0 * (trace.ts - header_ts_) / options.fast_forward)));
-      if (sleep_to > std::chrono::system_clock::now()) {
-        std::this_thread::sleep_until(sleep_to);
-      }
-
-      if (trace_type == kTraceWrite || trace_type == kTraceGet ||
-          trace_type == kTraceIteratorSeek ||
-          trace_type == kTraceIteratorSeekForPrev ||
-          trace_type == kTraceMultiGet) {
-        std::unique_ptr<ReplayerWorkerArg> ra(new ReplayerWorkerArg);
-        ra->trace_entry = std::move(trace);
-        ra->handler = exec_handler_.get();
-        ra->trace_file_version = trace_file_version_;
-        ra->error_cb = error_cb;
-        ra->result_cb = result_callback;
-        thread_pool.Schedule(&ReplayerImpl::BackgroundWork, ra.release(),
-                             nullptr, nullptr);
-      } else {
-        // Skip unsupported traces.
+      ScheduledTrace scheduled;
+      scheduled.due =
+          DueTime(replay_epoch, trace.ts, header_ts_, options.fast_forward);
+      s = TracerHelper::DecodeTraceRecord(&trace, trace_file_version_,
+                                          &scheduled.record);
+      // Skip unsupported traces, stop for other errors.
+      if (s.IsNotSupported()) {
         if (result_callback != nullptr) {
-          result_callback(Status::NotSupported("Unsupported trace type."),
-                          nullptr);
+          result_callback(s, nullptr);
         }
+        s = Status::OK();
+        continue;
       }
+      if (!s.ok()) {
+        record_error(s, trace.ts);
+        break;
+      }
+      const size_t idx = static_cast<size_t>(
+          GetSliceNPHash64(GetRoutingKey(*scheduled.record)) % queues.size());
+      batches[idx].push_back(std::move(scheduled));
     }
 
-    thread_pool.WaitForJobsAndJoinAllThreads();
-    if (!bg_s.ok()) {
-      s = bg_s;
+    // The traces decoded before an error or the end are still executed
+    for (size_t i = 0; i < queues.size(); ++i) {
+      if (batches[i].empty()) {
+        continue;
+      }
+      ReplayQueue* queue = queues[i].get();
+      {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        queue->cv.wait(lock, [queue] {
+          return queue->traces.size() < kMaxQueuedTraces;
+        });
+        for (auto& trace : batches[i]) {
+          queue->traces.push_back(std::move(trace));
+        }
+      }
+      queue->cv.notify_all();
+      batches[i].clear();
     }
   }
 
-  if (s.IsIncomplete()) {
-    // Reaching eof returns Incomplete status at the moment.
-    // Could happen when killing a process without calling EndTrace() API.
-    // TODO: Add better error handling.
-    trace_end_ = true;
-    return Status::OK();
+  HistogramImpl lag;
+  for (size_t i = 0; i < queues.size(); ++i) {
+    {
+      std::lock_guard<std::mutex> lock(queues[i]->mutex);
+      queues[i]->done = true;
+    }
+    queues[i]->cv.notify_all();
+    threads[i].join();
+    lag.Merge(queues[i]->lag);
+  }
+  SetTimingStats(lag);
+  if (failed.load(std::memory_order_acquire)) {
+    s = error_s;
   }
   return s;
 }
 
+void ReplayerImpl::SetTimingStats(const HistogramImpl& lag) {
+  std::lock_guard<std::mutex> lock(timing_mutex_);
+  timing_stats_.num_traces = lag.num();
+  timing_stats_.average_lag_micros = lag.num() > 0 ? lag.Average() : 0;
+  timing_stats_.p99_lag_micros = lag.num() > 0 ? lag.Percentile(99) : 0;
+  timing_stats_.max_lag_micros = lag.num() > 0 ? lag.max() : 0;
+}
+
+Status ReplayerImpl::GetTimingStats(ReplayTimingStats* stats) const {
+  std::lock_guard<std::mutex> lock(timing_mutex_);
+  *stats = timing_stats_;
+  return Status::OK();
+}
+
 uint64_t ReplayerImpl::GetHeaderTimestamp() const { return header_ts_; }
 
 Status ReplayerImpl::ReadHeader(Trace* header) {
@@ -281,34 +444,4 @@ Status ReplayerImpl::ReadTrace(Trace* trace) {
   return TracerHelper::DecodeTrace(encoded_trace, trace);
 }
 
-void ReplayerImpl::BackgroundWork(void* arg) {
-  std::unique_ptr<ReplayerWorkerArg> ra(
-      reinterpret_cast<ReplayerWorkerArg*>(arg));
-  assert(ra != nullptr);
-
-  std::unique_ptr<TraceRecord> record;
-  Status s = TracerHelper::DecodeTraceRecord(&(ra->trace_entry),
-                                             ra->trace_file_version, &record);
-  if (!s.ok()) {
-    // Stop the replay
-    if (ra->error_cb != nullptr) {
-      ra->error_cb(s, ra->trace_entry.ts);
-    }
-    // Report the result
-    if (ra->result_cb != nullptr) {
-      ra->result_cb(s, nullptr);
-    }
-    return;
-  }
-
-  if (ra->result_cb == nullptr) {
-    s = record->Accept(ra->handler, nullptr);
-  } else {
-    std::unique_ptr<TraceRecordResult> res;
-    s = record->Accept(ra->handler, &res);
-    ra->result_cb(s, std::move(res));
-  }
-  record.reset();
-}
-
 }  // namespace ROCKSDB_NAMESPACE
@@ -18,6 +18,7 @@
 #include "rocksdb/trace_record.h"
 #include "rocksdb/trace_record_result.h"
 #include "rocksdb/utilities/replayer.h"
+#include "monitoring/histogram.h"
 #include "trace_replay/trace_replay.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -47,12 +48,19 @@ class ReplayerImpl : public Replayer {
   using Replayer::GetHeaderTimestamp;
   uint64_t GetHeaderTimestamp() const override;
 
+  using Replayer::GetTimingStats;
+  Status GetTimingStats(ReplayTimingStats* stats) const override;
+
  private:
   Status ReadHeader(Trace* header);
   Status ReadTrace(Trace* trace);
 
-  // Generic function to execute a Trace in a thread pool.
-  static void BackgroundWork(void* arg);
+  Status ReplayMultiThreaded(
+      const ReplayOptions& options,
+      const std::function<void(Status, std::unique_ptr<TraceRecordResult>&&)>&
+          result_callback);
+
+  void SetTimingStats(const HistogramImpl& lag);
 
   std::unique_ptr<TraceReader> trace_reader_;
   std::mutex mutex_;
@@ -65,20 +73,8 @@ class ReplayerImpl : public Replayer {
   // Replayer will use different decode method to get the trace content based
   // on different trace file version.
   int trace_file_version_;
-};
-
-// Arguments passed to BackgroundWork() for replaying in a thread pool.
-struct ReplayerWorkerArg {
-  Trace trace_entry;
-  int trace_file_version;
-  // Handler to execute TraceRecord.
-  TraceRecord::Handler* handler;
-  // Callback function to report the error status and the timestamp of the
-  // TraceRecord (not the start/end timestamp of executing the TraceRecord).
-  std::function<void(Status, uint64_t)> error_cb;
-  // Callback function to report the trace execution status and operation
-  // execution status/result(s).
-  std::function<void(Status, std::unique_ptr<TraceRecordResult>&&)> result_cb;
+  mutable std::mutex timing_mutex_;
+  ReplayTimingStats timing_stats_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
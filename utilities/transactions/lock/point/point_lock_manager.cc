@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <deque>
 #include <mutex>
 
 #include "monitoring/perf_context_imp.h"
@@ -45,6 +46,20 @@ struct LockInfo {
   DECLARE_DEFAULT_MOVES(LockInfo);
 };
 
+// A transaction waiting for a key, woken through its own condition variable
+// when it may be its turn to take the lock
+struct LockWaiter {
+  LockWaiter(TransactionID id, bool ex,
+             std::shared_ptr<TransactionDBCondVar>&& condvar)
+      : txn_id(id), exclusive(ex), cv(std::move(condvar)) {}
+
+  TransactionID txn_id;
+  bool exclusive;
+  std::shared_ptr<TransactionDBCondVar> cv;
+};
+
+using LockWaiterQueue = std::deque<LockWaiter*>;
+
 struct LockMapStripe {
   explicit LockMapStripe(std::shared_ptr<TransactionDBMutexFactory> factory) {
     stripe_mutex = factory->AllocateMutex();
@@ -56,12 +71,21 @@ struct LockMapStripe {
   // Mutex must be held before modifying keys map
   std::shared_ptr<TransactionDBMutex> stripe_mutex;
 
-  // Condition Variable per stripe for waiting on a lock
+  // Condition Variable per stripe for waiting on the lock limit, see
+  // num_limit_waiters
   std::shared_ptr<TransactionDBCondVar> stripe_cv;
 
   // Locked keys mapped to the info about the transactions that locked them.
   // TODO(agiardullo): Explore performance of other data structures.
   UnorderedMap<std::string, LockInfo> keys;
+
+  // Transactions waiting for each key, in the order they are to take it.
+  // Holders of a shared lock waiting to upgrade it go first.
+  UnorderedMap<std::string, LockWaiterQueue> waiters;
+
+  // Number of waiters blocked by PointLockManager::max_num_locks_ rather
+  // than by other transactions, woken by any unlock in the stripe
+  size_t num_limit_waiters = 0;
 };
 
 // Map of #num_stripes LockMapStripes
@@ -112,7 +136,15 @@ PointLockManager::PointLockManager(PessimisticTransactionDB* txn_db,
       dlock_buffer_(opt.max_num_deadlocks),
       mutex_factory_(opt.custom_mutex_factory
                          ? opt.custom_mutex_factory
-                         : std::make_shared<TransactionDBMutexFactoryImpl>()) {}
+                         : std::make_shared<TransactionDBMutexFactoryImpl>()),
+      deadlock_detect_interval_us_(opt.deadlock_detect_interval_us) {
+  if (deadlock_detect_interval_us_ > 0) {
+    deadlock_detect_thread_.reset(new RepeatableThread(
+        [this]() { DetectDeadlocks(); }, "txn_deadlock",
+        SystemClock::Default().get(), deadlock_detect_interval_us_,
+        deadlock_detect_interval_us_));
+  }
+}
 
 size_t LockMap::GetStripe(const std::string& key) const {
   assert(num_stripes_ > 0);
@@ -278,11 +310,28 @@ Status PointLockManager::AcquireWithTimeout(
   uint64_t expire_time_hint = 0;
   autovector<TransactionID> wait_ids;
   result = AcquireLocked(lock_map, stripe, key, env, lock_info,
-                         &expire_time_hint, &wait_ids);
+                         &expire_time_hint, &wait_ids, nullptr);
 
+  autovector<std::shared_ptr<TransactionDBCondVar>> to_notify;
   if (!result.ok() && timeout != 0) {
     PERF_TIMER_GUARD(key_lock_wait_time);
     PERF_COUNTER_ADD(key_lock_wait_count, 1);
+    // Take a place in the queue of the key, where an unlock wakes only the
+    // waiters whose turn it is. A holder of the key upgrading its lock goes
+    // first, since every other waiter waits for it anyway.
+    LockWaiter waiter(lock_info.txn_ids[0], lock_info.exclusive,
+                      mutex_factory_->AllocateCondVar());
+    LockWaiterQueue& queue = stripe->waiters[key];
+    auto stripe_iter = stripe->keys.find(key);
+    if (stripe_iter != stripe->keys.end() &&
+        std::find(stripe_iter->second.txn_ids.begin(),
+                  stripe_iter->second.txn_ids.end(),
+                  waiter.txn_id) != stripe_iter->second.txn_ids.end()) {
+      queue.push_front(&waiter);
+    } else {
+      queue.push_back(&waiter);
+    }
+
     // If we weren't able to acquire the lock, we will keep retrying as long
     // as the timeout allows.
     bool timed_out = false;
@@ -304,31 +353,45 @@ Status PointLockManager::AcquireWithTimeout(
       if (wait_ids.size() != 0) {
         if (txn->IsDeadlockDetect()) {
           if (IncrementWaiters(txn, wait_ids, key, column_family_id,
-                               lock_info.exclusive, env)) {
+                               lock_info.exclusive, env, stripe, waiter.cv)) {
             result = Status::Busy(Status::SubCode::kDeadlock);
-            stripe->stripe_mutex->UnLock();
-            return result;
+            break;
           }
         }
         txn->SetWaitingTxn(wait_ids, column_family_id, &key);
       }
 
+      // Only the lock limit can make us wait without waiting for anyone,
+      // which any unlock in the stripe may lift
+      std::shared_ptr<TransactionDBCondVar> cv = waiter.cv;
+      const bool limit_wait = result.IsBusy();
+      if (limit_wait) {
+        cv = stripe->stripe_cv;
+        stripe->num_limit_waiters++;
+      }
+
       TEST_SYNC_POINT("PointLockManager::AcquireWithTimeout:WaitingTxn");
       if (cv_end_time < 0) {
         // Wait indefinitely
-        result = stripe->stripe_cv->Wait(stripe->stripe_mutex);
+        result = cv->Wait(stripe->stripe_mutex);
       } else {
         uint64_t now = env->NowMicros();
         if (static_cast<uint64_t>(cv_end_time) > now) {
-          result = stripe->stripe_cv->WaitFor(stripe->stripe_mutex,
-                                              cv_end_time - now);
+          result = cv->WaitFor(stripe->stripe_mutex, cv_end_time - now);
         }
       }
 
+      if (limit_wait) {
+        assert(stripe->num_limit_waiters > 0);
+        stripe->num_limit_waiters--;
+      }
+
       if (wait_ids.size() != 0) {
         txn->ClearWaitingTxn();
-        if (txn->IsDeadlockDetect()) {
-          DecrementWaiters(txn, wait_ids);
+        if (txn->IsDeadlockDetect() && DecrementWaiters(txn, wait_ids)) {
+          // Chosen as the victim of a deadlock in the background
+          result = Status::Busy(Status::SubCode::kDeadlock);
+          break;
         }
       }
 
@@ -341,21 +404,74 @@ Status PointLockManager::AcquireWithTimeout(
 
       if (result.ok() || result.IsTimedOut()) {
         result = AcquireLocked(lock_map, stripe, key, env, lock_info,
-                               &expire_time_hint, &wait_ids);
+                               &expire_time_hint, &wait_ids, &waiter);
       }
     } while (!result.ok() && !timed_out);
+
+    RemoveWaiter(stripe, key, &waiter);
+    if (!result.ok()) {
+      // Giving up may make it the turn of the waiters behind us
+      WakeWaiters(stripe, key, &to_notify);
+    }
   }
 
   stripe->stripe_mutex->UnLock();
 
+  for (auto& cv : to_notify) {
+    cv->Notify();
+  }
+
   return result;
 }
 
-void PointLockManager::DecrementWaiters(
+// Wakes the waiters at the front of the queue of the key: the first one,
+// and the shared ones following it when it is shared.
+// REQUIRED:  Stripe mutex must be held.
+void PointLockManager::WakeWaiters(
+    LockMapStripe* stripe, const std::string& key,
+    autovector<std::shared_ptr<TransactionDBCondVar>>* to_notify) {
+  if (stripe->waiters.empty()) {
+    return;
+  }
+  auto waiters_iter = stripe->waiters.find(key);
+  if (waiters_iter == stripe->waiters.end()) {
+    return;
+  }
+  bool first = true;
+  for (LockWaiter* waiter : waiters_iter->second) {
+    if (waiter->exclusive && !first) {
+      break;
+    }
+    to_notify->push_back(waiter->cv);
+    if (waiter->exclusive) {
+      break;
+    }
+    first = false;
+  }
+}
+
+// REQUIRED:  Stripe mutex must be held.
+void PointLockManager::RemoveWaiter(LockMapStripe* stripe,
+                                    const std::string& key,
+                                    const LockWaiter* waiter) {
+  auto waiters_iter = stripe->waiters.find(key);
+  assert(waiters_iter != stripe->waiters.end());
+  LockWaiterQueue& queue = waiters_iter->second;
+  auto it = std::find(queue.begin(), queue.end(), waiter);
+  assert(it != queue.end());
+  queue.erase(it);
+  if (queue.empty()) {
+    stripe->waiters.erase(waiters_iter);
+  }
+}
+
+bool PointLockManager::DecrementWaiters(
     const PessimisticTransaction* txn,
     const autovector<TransactionID>& wait_ids) {
   std::lock_guard<std::mutex> lock(wait_txn_map_mutex_);
+  bool victim = wait_txn_map_.Get(txn->GetID()).m_deadlock_victim;
   DecrementWaitersImpl(txn, wait_ids);
+  return victim;
 }
 
 void PointLockManager::DecrementWaitersImpl(
@@ -376,8 +492,28 @@ void PointLockManager::DecrementWaitersImpl(
 bool PointLockManager::IncrementWaiters(
     const PessimisticTransaction* txn,
     const autovector<TransactionID>& wait_ids, const std::string& key,
-    const uint32_t& cf_id, const bool& exclusive, Env* const env) {
+    const uint32_t& cf_id, const bool& exclusive, Env* const env,
+    LockMapStripe* stripe, const std::shared_ptr<TransactionDBCondVar>& cv) {
   auto id = txn->GetID();
+  if (deadlock_detect_interval_us_ > 0) {
+    // Only join the wait-for graph, where DetectDeadlocks() looks for cycles
+    std::lock_guard<std::mutex> lock(wait_txn_map_mutex_);
+    assert(!wait_txn_map_.Contains(id));
+    TrackedTrxInfo info{wait_ids, cf_id, exclusive, key};
+    info.m_num_keys = txn->GetNumKeys();
+    info.m_wait_seq = ++wait_seq_;
+    info.m_stripe_mutex = stripe->stripe_mutex;
+    info.m_cv = cv;
+    wait_txn_map_.Insert(id, info);
+    for (auto wait_id : wait_ids) {
+      if (rev_wait_txn_map_.Contains(wait_id)) {
+        rev_wait_txn_map_.Get(wait_id)++;
+      } else {
+        rev_wait_txn_map_.Insert(wait_id, 1);
+      }
+    }
+    return false;
+  }
   std::vector<int> queue_parents(
       static_cast<size_t>(txn->GetDeadlockDetectDepth()));
   std::vector<TransactionID> queue_values(
@@ -468,20 +604,182 @@ bool PointLockManager::IncrementWaiters(
   return true;
 }
 
+namespace {
+struct WaitForNode {
+  autovector<TransactionID> wait_ids;
+  uint64_t num_keys;
+  uint64_t wait_seq;
+};
+using WaitForGraph = UnorderedMap<TransactionID, WaitForNode>;
+
+// Finds a cycle in the graph with a depth-first search, returning its
+// transactions in wait order
+bool FindWaitCycle(const WaitForGraph& graph,
+                   std::vector<TransactionID>* cycle) {
+  // 1 while on the search path, 2 once known not to lead to a cycle
+  UnorderedMap<TransactionID, int> state;
+  // The transactions of the search path, with the index of the next of their
+  // wait ids to follow
+  std::vector<std::pair<TransactionID, size_t>> path;
+  for (const auto& start : graph) {
+    if (state.find(start.first) != state.end()) {
+      continue;
+    }
+    state[start.first] = 1;
+    path.emplace_back(start.first, 0);
+    while (!path.empty()) {
+      const TransactionID id = path.back().first;
+      const autovector<TransactionID>& wait_ids = graph.at(id).wait_ids;
+      if (path.back().second == wait_ids.size()) {
+        state[id] = 2;
+        path.pop_back();
+        continue;
+      }
+      const TransactionID next = wait_ids[path.back().second++];
+      if (graph.find(next) == graph.end()) {
+        // Not waiting
+        continue;
+      }
+      auto state_iter = state.find(next);
+      if (state_iter == state.end()) {
+        state[next] = 1;
+        path.emplace_back(next, 0);
+      } else if (state_iter->second == 1) {
+        auto path_iter = path.begin();
+        while (path_iter->first != next) {
+          ++path_iter;
+        }
+        cycle->clear();
+        for (; path_iter != path.end(); ++path_iter) {
+          cycle->push_back(path_iter->first);
+        }
+        return true;
+      }
+    }
+  }
+  return false;
+}
+}  // namespace
+
+void PointLockManager::DetectDeadlocks() {
+  // The search runs on a copy of the wait-for graph, so that the waiters are
+  // only held up by the copy
+  WaitForGraph graph;
+  {
+    std::lock_guard<std::mutex> lock(wait_txn_map_mutex_);
+    wait_txn_map_.ForEach([&graph](TransactionID id,
+                                   const TrackedTrxInfo& info) {
+      graph[id] = {info.m_neighbors, info.m_num_keys, info.m_wait_seq};
+    });
+  }
+
+  std::vector<TransactionID> cycle;
+  while (FindWaitCycle(graph, &cycle)) {
+    // The transaction of the cycle with the fewest locked keys has the least
+    // work to redo. Between equals, the newest one.
+    TransactionID victim = cycle[0];
+    for (TransactionID id : cycle) {
+      const WaitForNode& node = graph.at(id);
+      const WaitForNode& victim_node = graph.at(victim);
+      if (node.num_keys < victim_node.num_keys ||
+          (node.num_keys == victim_node.num_keys && id > victim)) {
+        victim = id;
+      }
+    }
+
+    std::shared_ptr<TransactionDBMutex> stripe_mutex;
+    std::shared_ptr<TransactionDBCondVar> cv;
+    {
+      std::lock_guard<std::mutex> lock(wait_txn_map_mutex_);
+      // The cycle is still there only if none of its transactions stopped
+      // waiting since the copy
+      std::vector<DeadlockInfo> path;
+      for (TransactionID id : cycle) {
+        if (!wait_txn_map_.Contains(id) ||
+            wait_txn_map_.Get(id).m_wait_seq != graph.at(id).wait_seq) {
+          path.clear();
+          break;
+        }
+        const TrackedTrxInfo& info = wait_txn_map_.Get(id);
+        path.push_back(
+            {id, info.m_cf_id, info.m_exclusive, info.m_waiting_key});
+      }
+      if (!path.empty()) {
+        TrackedTrxInfo& info = wait_txn_map_.Get(victim);
+        info.m_deadlock_victim = true;
+        stripe_mutex = info.m_stripe_mutex;
+        cv = info.m_cv;
+        int64_t deadlock_time = 0;
+        if (!SystemClock::Default()->GetCurrentTime(&deadlock_time).ok()) {
+          deadlock_time = 0;
+        }
+        dlock_buffer_.AddNewPath(DeadlockPath(path, deadlock_time));
+      }
+    }
+    if (cv != nullptr) {
+      // The victim holds the stripe mutex until it waits on cv, so that the
+      // notification is not lost
+      if (stripe_mutex->Lock().ok()) {
+        cv->Notify();
+        stripe_mutex->UnLock();
+      }
+    }
+    graph.erase(victim);
+  }
+}
+
 // Try to lock this key after we have acquired the mutex.
 // Sets *expire_time to the expiration time in microseconds
 //  or 0 if no expiration.
+// `waiter` is our place in the queue of the key if we are waiting for it,
+// otherwise nullptr. Only holders of the key can take it ahead of the
+// waiters queued before us.
 // REQUIRED:  Stripe mutex must be held.
 Status PointLockManager::AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
                                        const std::string& key, Env* env,
                                        const LockInfo& txn_lock_info,
                                        uint64_t* expire_time,
-                                       autovector<TransactionID>* txn_ids) {
+                                       autovector<TransactionID>* txn_ids,
+                                       const LockWaiter* waiter) {
   assert(txn_lock_info.txn_ids.size() == 1);
+  const TransactionID txn_id = txn_lock_info.txn_ids[0];
 
   Status result;
   // Check if this key is already locked
   auto stripe_iter = stripe->keys.find(key);
+  const bool holder =
+      stripe_iter != stripe->keys.end() &&
+      std::find(stripe_iter->second.txn_ids.begin(),
+                stripe_iter->second.txn_ids.end(),
+                txn_id) != stripe_iter->second.txn_ids.end();
+  // Skipped without any waiters, as when there is no contention
+  auto waiters_iter = holder || stripe->waiters.empty()
+                          ? stripe->waiters.end()
+                          : stripe->waiters.find(key);
+  if (waiters_iter != stripe->waiters.end()) {
+    // Shared locks may be taken together, anything else waits its turn
+    autovector<TransactionID> ahead;
+    bool blocked = false;
+    for (const LockWaiter* other : waiters_iter->second) {
+      if (other == waiter) {
+        break;
+      }
+      blocked = blocked || other->exclusive || txn_lock_info.exclusive;
+      ahead.push_back(other->txn_id);
+    }
+    if (blocked) {
+      // We wait for the holders and for the waiters ahead of us
+      txn_ids->clear();
+      if (stripe_iter != stripe->keys.end()) {
+        *txn_ids = stripe_iter->second.txn_ids;
+      }
+      for (TransactionID id : ahead) {
+        txn_ids->push_back(id);
+      }
+      return Status::TimedOut(Status::SubCode::kLockTimeout);
+    }
+  }
+
   if (stripe_iter != stripe->keys.end()) {
     // Lock already held
     LockInfo& lock_info = stripe_iter->second;
@@ -506,7 +804,13 @@ Status PointLockManager::AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
           // lock_cnt does not change
         } else {
           result = Status::TimedOut(Status::SubCode::kLockTimeout);
-          *txn_ids = lock_info.txn_ids;
+          // Upgrading our shared lock, we wait only for the other holders
+          txn_ids->clear();
+          for (TransactionID id : lock_info.txn_ids) {
+            if (id != txn_id) {
+              txn_ids->push_back(id);
+            }
+          }
         }
       }
     } else {
@@ -538,9 +842,10 @@ Status PointLockManager::AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
   return result;
 }
 
-void PointLockManager::UnLockKey(PessimisticTransaction* txn,
-                                 const std::string& key, LockMapStripe* stripe,
-                                 LockMap* lock_map, Env* env) {
+void PointLockManager::UnLockKey(
+    PessimisticTransaction* txn, const std::string& key, LockMapStripe* stripe,
+    LockMap* lock_map, Env* env,
+    autovector<std::shared_ptr<TransactionDBCondVar>>* to_notify) {
 #ifdef NDEBUG
   (void)env;
 #endif
@@ -567,6 +872,8 @@ void PointLockManager::UnLockKey(PessimisticTransaction* txn,
         assert(lock_map->lock_cnt.load(std::memory_order_relaxed) > 0);
         lock_map->lock_cnt--;
       }
+
+      WakeWaiters(stripe, key, to_notify);
     }
   } else {
     // This key is either not locked or locked by someone else.  This should
@@ -591,12 +898,19 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
   assert(lock_map->lock_map_stripes_.size() > stripe_num);
   LockMapStripe* stripe = lock_map->lock_map_stripes_.at(stripe_num);
 
+  autovector<std::shared_ptr<TransactionDBCondVar>> to_notify;
   stripe->stripe_mutex->Lock().PermitUncheckedError();
-  UnLockKey(txn, key, stripe, lock_map, env);
+  UnLockKey(txn, key, stripe, lock_map, env, &to_notify);
+  const bool notify_limit_waiters = stripe->num_limit_waiters > 0;
   stripe->stripe_mutex->UnLock();
 
-  // Signal waiting threads to retry locking
-  stripe->stripe_cv->NotifyAll();
+  // Signal the waiting threads whose turn it is to retry locking
+  for (auto& cv : to_notify) {
+    cv->Notify();
+  }
+  if (notify_limit_waiters) {
+    stripe->stripe_cv->NotifyAll();
+  }
 }
 
 void PointLockManager::UnLock(PessimisticTransaction* txn,
@@ -633,16 +947,23 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
       assert(lock_map->lock_map_stripes_.size() > stripe_num);
       LockMapStripe* stripe = lock_map->lock_map_stripes_.at(stripe_num);
 
+      autovector<std::shared_ptr<TransactionDBCondVar>> to_notify;
       stripe->stripe_mutex->Lock().PermitUncheckedError();
 
       for (const std::string* key : stripe_keys) {
-        UnLockKey(txn, *key, stripe, lock_map, env);
+        UnLockKey(txn, *key, stripe, lock_map, env, &to_notify);
       }
 
+      const bool notify_limit_waiters = stripe->num_limit_waiters > 0;
       stripe->stripe_mutex->UnLock();
 
-      // Signal waiting threads to retry locking
-      stripe->stripe_cv->NotifyAll();
+      // Signal the waiting threads whose turn it is to retry locking
+      for (auto& cv : to_notify) {
+        cv->Notify();
+      }
+      if (notify_limit_waiters) {
+        stripe->stripe_cv->NotifyAll();
+      }
     }
   }
 }
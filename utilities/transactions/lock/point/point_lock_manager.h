@@ -13,9 +13,11 @@
 
 #include "monitoring/instrumented_mutex.h"
 #include "rocksdb/utilities/transaction.h"
+#include "rocksdb/utilities/transaction_db_mutex.h"
 #include "util/autovector.h"
 #include "util/hash_containers.h"
 #include "util/hash_map.h"
+#include "util/repeatable_thread.h"
 #include "util/thread_local.h"
 #include "utilities/transactions/lock/lock_manager.h"
 #include "utilities/transactions/lock/point/point_lock_tracker.h"
@@ -26,6 +28,7 @@ class ColumnFamilyHandle;
 struct LockInfo;
 struct LockMap;
 struct LockMapStripe;
+struct LockWaiter;
 
 template <class Path>
 class DeadlockInfoBufferTempl {
@@ -105,6 +108,14 @@ struct TrackedTrxInfo {
   uint32_t m_cf_id;
   bool m_exclusive;
   std::string m_waiting_key;
+  // Only set with the background deadlock detection. The waiter is woken
+  // through m_cv, under m_stripe_mutex, when chosen as the victim of a
+  // deadlock.
+  uint64_t m_num_keys = 0;
+  uint64_t m_wait_seq = 0;
+  bool m_deadlock_victim = false;
+  std::shared_ptr<TransactionDBMutex> m_stripe_mutex = nullptr;
+  std::shared_ptr<TransactionDBCondVar> m_cv = nullptr;
 };
 
 class PointLockManager : public LockManager {
@@ -115,7 +126,7 @@ class PointLockManager : public LockManager {
   PointLockManager(const PointLockManager&) = delete;
   PointLockManager& operator=(const PointLockManager&) = delete;
 
-  ~PointLockManager() override {}
+  ~PointLockManager() override { deadlock_detect_thread_.reset(); }
 
   bool IsPointLockSupported() const override { return true; }
 
@@ -186,11 +197,17 @@ class PointLockManager : public LockManager {
   HashMap<TransactionID, int> rev_wait_txn_map_;
   // Maps from waiter -> waitee.
   HashMap<TransactionID, TrackedTrxInfo> wait_txn_map_;
+  // Tells apart the successive waits of a transaction in wait_txn_map_
+  uint64_t wait_seq_ = 0;
   DeadlockInfoBuffer dlock_buffer_;
 
   // Used to allocate mutexes/condvars to use when locking keys
   std::shared_ptr<TransactionDBMutexFactory> mutex_factory_;
 
+  // See TransactionDBOptions::deadlock_detect_interval_us
+  const uint64_t deadlock_detect_interval_us_;
+  std::unique_ptr<RepeatableThread> deadlock_detect_thread_;
+
   bool IsLockExpired(TransactionID txn_id, const LockInfo& lock_info, Env* env,
                      uint64_t* wait_time);
 
@@ -204,19 +221,35 @@ class PointLockManager : public LockManager {
   Status AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
                        const std::string& key, Env* env,
                        const LockInfo& lock_info, uint64_t* wait_time,
-                       autovector<TransactionID>* txn_ids);
+                       autovector<TransactionID>* txn_ids,
+                       const LockWaiter* waiter);
 
   void UnLockKey(PessimisticTransaction* txn, const std::string& key,
-                 LockMapStripe* stripe, LockMap* lock_map, Env* env);
+                 LockMapStripe* stripe, LockMap* lock_map, Env* env,
+                 autovector<std::shared_ptr<TransactionDBCondVar>>* to_notify);
+
+  void WakeWaiters(
+      LockMapStripe* stripe, const std::string& key,
+      autovector<std::shared_ptr<TransactionDBCondVar>>* to_notify);
+
+  void RemoveWaiter(LockMapStripe* stripe, const std::string& key,
+                    const LockWaiter* waiter);
 
   bool IncrementWaiters(const PessimisticTransaction* txn,
                         const autovector<TransactionID>& wait_ids,
                         const std::string& key, const uint32_t& cf_id,
-                        const bool& exclusive, Env* const env);
-  void DecrementWaiters(const PessimisticTransaction* txn,
+                        const bool& exclusive, Env* const env,
+                        LockMapStripe* stripe,
+                        const std::shared_ptr<TransactionDBCondVar>& cv);
+  // Returns true if the transaction was chosen as the victim of a deadlock
+  // while waiting
+  bool DecrementWaiters(const PessimisticTransaction* txn,
                         const autovector<TransactionID>& wait_ids);
   void DecrementWaitersImpl(const PessimisticTransaction* txn,
                             const autovector<TransactionID>& wait_ids);
+
+  // One pass of the background deadlock detection
+  void DetectDeadlocks();
 };
 
 }  // namespace ROCKSDB_NAMESPACE
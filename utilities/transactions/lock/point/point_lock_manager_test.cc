@@ -157,6 +157,133 @@ TEST_F(PointLockManagerTest, DeadlockDepthExceeded) {
   delete txn1;
 }
 
+TEST_F(PointLockManagerTest, BackgroundDeadlockDetection) {
+  TransactionDBOptions txn_db_opt;
+  txn_db_opt.transaction_lock_timeout = 0;
+  txn_db_opt.deadlock_detect_interval_us = 1000;
+  ResetLocker(txn_db_opt);
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.deadlock_detect = true;
+  txn_opt.lock_timeout = 1000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k1", env_, true));
+  ASSERT_OK(locker_->TryLock(txn2, 1, "k2", env_, true));
+
+  port::Thread t1 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    // block because txn2 is holding a lock on k2.
+    ASSERT_OK(locker_->TryLock(txn1, 1, "k2", env_, true));
+  });
+  // Neither holds more keys than the other, so the newest is the victim
+  auto s = locker_->TryLock(txn2, 1, "k1", env_, true);
+  ASSERT_TRUE(s.IsBusy());
+  ASSERT_EQ(s.subcode(), Status::SubCode::kDeadlock);
+
+  std::vector<DeadlockPath> deadlock_paths = locker_->GetDeadlockInfoBuffer();
+  ASSERT_EQ(deadlock_paths.size(), 1u);
+  ASSERT_FALSE(deadlock_paths[0].limit_exceeded);
+  ASSERT_EQ(deadlock_paths[0].path.size(), 2u);
+
+  locker_->UnLock(txn2, 1, "k2", env_);
+  t1.join();
+
+  delete txn2;
+  delete txn1;
+}
+
+TEST_F(PointLockManagerTest, WaitersTakeLockInOrder) {
+  // Tests that the waiters for a key take it in the order they came, and
+  // that no transaction takes the key ahead of them.
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 1000000;
+  auto txn1 = NewTxn();
+  auto txn2 = NewTxn(txn_opt);
+  auto txn3 = NewTxn();
+  auto txn4 = NewTxn(txn_opt);
+  std::vector<TransactionID> order;
+
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, false));
+
+  port::Thread t1 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, true));
+    order.push_back(txn2->GetID());
+    locker_->UnLock(txn2, 1, "k", env_);
+  });
+
+  // txn1 shares the key, but txn2 is waiting for it already
+  auto s = locker_->TryLock(txn3, 1, "k", env_, false);
+  ASSERT_TRUE(s.IsTimedOut());
+
+  port::Thread t2 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn4, 1, "k", env_, true));
+    order.push_back(txn4->GetID());
+    locker_->UnLock(txn4, 1, "k", env_);
+  });
+
+  // The waiters are then woken one by one
+  locker_->UnLock(txn1, 1, "k", env_);
+  t1.join();
+  t2.join();
+  ASSERT_EQ(order, std::vector<TransactionID>({txn2->GetID(), txn4->GetID()}));
+
+  delete txn4;
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
+TEST_F(PointLockManagerTest, UpgradeWaitsForOtherHolders) {
+  // Tests that a txn sharing a lock upgrades it without releasing it, ahead
+  // of the other waiters, once the other holders release it.
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.deadlock_detect = true;
+  txn_opt.lock_timeout = 1000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+  auto txn3 = NewTxn(txn_opt);
+
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, false));
+  ASSERT_OK(locker_->TryLock(txn2, 1, "k", env_, false));
+
+  port::Thread t1 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn3, 1, "k", env_, true));
+    locker_->UnLock(txn3, 1, "k", env_);
+  });
+
+  port::Thread t2 = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    ASSERT_OK(locker_->TryLock(txn1, 1, "k", env_, true));
+  });
+
+  // txn1 waits only for txn2, not for itself or for txn3
+  uint32_t wait_cf_id;
+  std::string wait_key;
+  auto waiters = txn1->GetWaitingTxns(&wait_cf_id, &wait_key);
+  ASSERT_EQ(wait_key, "k");
+  ASSERT_EQ(waiters, std::vector<TransactionID>({txn2->GetID()}));
+
+  locker_->UnLock(txn2, 1, "k", env_);
+  t2.join();
+
+  auto lock_status = locker_->GetPointLockStatus();
+  ASSERT_EQ(lock_status.size(), 1u);
+  ASSERT_TRUE(lock_status.begin()->second.exclusive);
+  ASSERT_EQ(lock_status.begin()->second.ids,
+            std::vector<TransactionID>({txn1->GetID()}));
+
+  locker_->UnLock(txn1, 1, "k", env_);
+  t1.join();
+
+  delete txn3;
+  delete txn2;
+  delete txn1;
+}
+
 INSTANTIATE_TEST_CASE_P(PointLockManager, AnyLockManagerTest,
                         ::testing::Values(nullptr));
 
@@ -72,11 +72,18 @@ class PointLockManagerTest : public testing::Test {
     return reinterpret_cast<PessimisticTransaction*>(txn);
   }
 
+  // Replaces locker_ with a lock manager of other options
+  void ResetLocker(const TransactionDBOptions& txn_opt) {
+    locker_.reset(new PointLockManager(
+        static_cast<PessimisticTransactionDB*>(db_), txn_opt));
+  }
+
  protected:
   Env* env_;
   std::shared_ptr<LockManager> locker_;
   const char* wait_sync_point_name_;
   friend void PointLockManagerTestExternalSetup(PointLockManagerTest*);
+  friend void RangeMapLockManagerTestExternalSetup(PointLockManagerTest*);
 
  private:
   std::string db_dir_;
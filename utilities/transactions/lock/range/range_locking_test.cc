@@ -405,6 +405,76 @@ TEST_F(RangeLockingTest, LockWaiteeAccess) {
   delete txn1;
 }
 
+TEST_F(RangeLockingTest, RangeMapLockManager) {
+  delete db;
+  db = nullptr;
+  ASSERT_OK(DestroyDB(dbname, options));
+  range_lock_mgr.reset(NewRangeMapLockManager(nullptr));
+  txn_db_options.lock_mgr_handle = range_lock_mgr;
+  ASSERT_OK(TransactionDB::Open(options, txn_db_options, dbname, &db));
+
+  auto cf = db->DefaultColumnFamily();
+  TransactionOptions txn_options;
+  txn_options.lock_timeout = 10;
+  Transaction* txn0 = db->BeginTransaction(WriteOptions(), txn_options);
+  Transaction* txn1 = db->BeginTransaction(WriteOptions(), txn_options);
+
+  // Disjoint ranges do not conflict
+  ASSERT_OK(txn0->GetRangeLock(cf, Endpoint("a"), Endpoint("c")));
+  ASSERT_OK(txn1->GetRangeLock(cf, Endpoint("d"), Endpoint("f")));
+  ASSERT_TRUE(
+      txn1->GetRangeLock(cf, Endpoint("b"), Endpoint("e")).IsTimedOut());
+  // The end of a range with inf_suffix comes after the keys it prefixes
+  ASSERT_OK(txn1->GetRangeLock(cf, Endpoint("c1"), Endpoint("c1")));
+  ASSERT_OK(txn0->GetRangeLock(cf, Endpoint("c", true), Endpoint("c", true)));
+  ASSERT_TRUE(
+      txn0->GetRangeLock(cf, Endpoint("c0"), Endpoint("c2")).IsTimedOut());
+
+  // Locking within a range already held changes nothing
+  ASSERT_OK(txn0->Put(cf, "b", "value"));
+  auto status = range_lock_mgr->GetRangeLockStatusData();
+  ASSERT_EQ(status.size(), 4);
+  for (const auto& it : status) {
+    ASSERT_EQ(it.second.ids.size(), 1);
+    if (it.second.start.slice == "a") {
+      ASSERT_EQ(it.second.ids[0], txn0->GetID());
+      ASSERT_EQ(it.second.end.slice, "c");
+    }
+  }
+  ASSERT_GT(range_lock_mgr->GetStatus().current_lock_memory, 0);
+
+  // Shared locks
+  std::string value;
+  ASSERT_TRUE(txn0->GetForUpdate(ReadOptions(), cf, "h", &value, false)
+                  .IsNotFound());
+  ASSERT_TRUE(txn1->GetForUpdate(ReadOptions(), cf, "h", &value, false)
+                  .IsNotFound());
+  ASSERT_TRUE(
+      txn1->GetRangeLock(cf, Endpoint("g"), Endpoint("i")).IsTimedOut());
+
+  // Releasing the locks of txn0 lets txn1 take its ranges
+  ASSERT_OK(txn0->Commit());
+  ASSERT_OK(txn1->GetRangeLock(cf, Endpoint("b"), Endpoint("e")));
+  ASSERT_OK(txn1->GetRangeLock(cf, Endpoint("g"), Endpoint("k")));
+  ASSERT_EQ(EDOM, range_lock_mgr->SetMaxLockMemory(1));
+  ASSERT_OK(txn1->Commit());
+  ASSERT_EQ(range_lock_mgr->GetStatus().current_lock_memory, 0);
+
+  // Locks are not escalated past the max lock memory
+  ASSERT_EQ(0, range_lock_mgr->SetMaxLockMemory(1));
+  delete txn0;
+  txn0 = db->BeginTransaction(WriteOptions(), txn_options);
+  ASSERT_OK(txn0->GetRangeLock(cf, Endpoint("a"), Endpoint("c")));
+  auto s = txn0->GetRangeLock(cf, Endpoint("x"), Endpoint("z"));
+  ASSERT_TRUE(s.IsBusy());
+  ASSERT_EQ(s.subcode(), Status::SubCode::kLockLimit);
+  ASSERT_EQ(range_lock_mgr->GetStatus().escalation_count, 0);
+  txn0->Rollback();
+
+  delete txn0;
+  delete txn1;
+}
+
 void PointLockManagerTestExternalSetup(PointLockManagerTest* self) {
   self->env_ = Env::Default();
   self->db_dir_ = test::PerThreadDBPath("point_lock_manager_test");
@@ -425,8 +495,29 @@ void PointLockManagerTestExternalSetup(PointLockManagerTest* self) {
   self->wait_sync_point_name_ = "RangeTreeLockManager::TryRangeLock:WaitingTxn";
 }
 
-INSTANTIATE_TEST_CASE_P(RangeLockManager, AnyLockManagerTest,
-                        ::testing::Values(PointLockManagerTestExternalSetup));
+void RangeMapLockManagerTestExternalSetup(PointLockManagerTest* self) {
+  self->env_ = Env::Default();
+  self->db_dir_ = test::PerThreadDBPath("point_lock_manager_test");
+  ASSERT_OK(self->env_->CreateDir(self->db_dir_));
+
+  Options opt;
+  opt.create_if_missing = true;
+  TransactionDBOptions txn_opt;
+  txn_opt.transaction_lock_timeout = 0;
+
+  auto mutex_factory = std::make_shared<TransactionDBMutexFactoryImpl>();
+  self->locker_.reset(NewRangeMapLockManager(mutex_factory)->getLockManager());
+  txn_opt.lock_mgr_handle =
+      std::dynamic_pointer_cast<RangeLockManagerHandle>(self->locker_);
+
+  ASSERT_OK(TransactionDB::Open(opt, txn_opt, self->db_dir_, &self->db_));
+  self->wait_sync_point_name_ = "RangeMapLockManager::TryLock:WaitingTxn";
+}
+
+INSTANTIATE_TEST_CASE_P(
+    RangeLockManager, AnyLockManagerTest,
+    ::testing::Values(PointLockManagerTestExternalSetup,
+                      RangeMapLockManagerTestExternalSetup));
 
 }  // namespace ROCKSDB_NAMESPACE
 
@@ -0,0 +1,639 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "utilities/transactions/lock/range/range_map/range_map_lock_manager.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <map>
+
+#include "monitoring/perf_context_imp.h"
+#include "rocksdb/comparator.h"
+#include "test_util/sync_point.h"
+#include "utilities/transactions/pessimistic_transaction.h"
+#include "utilities/transactions/transaction_db_mutex_impl.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+RangeLockManagerHandle* NewRangeMapLockManager(
+    std::shared_ptr<TransactionDBMutexFactory> mutex_factory) {
+  if (!mutex_factory) {
+    mutex_factory = std::make_shared<TransactionDBMutexFactoryImpl>();
+  }
+  return new RangeMapLockManager(mutex_factory);
+}
+
+namespace {
+// Orders the endpoints the same way as RangeTreeLockManager: an endpoint
+// with inf_suffix comes after all the keys it is a prefix of.
+int CompareEndpoints(const Comparator* cmp, const Slice& a, bool a_inf,
+                     const Slice& b, bool b_inf) {
+  size_t min_len = std::min(a.size(), b.size());
+  int res = cmp->Compare(Slice(a.data(), min_len), Slice(b.data(), min_len));
+  if (res != 0) {
+    return res;
+  }
+  if (a.size() < b.size()) {
+    return a_inf ? 1 : -1;
+  }
+  if (b.size() < a.size()) {
+    return b_inf ? -1 : 1;
+  }
+  return static_cast<int>(a_inf) - static_cast<int>(b_inf);
+}
+}  // anonymous namespace
+
+// A point between the endpoints: just before the endpoint, or just after it
+// when `after` is set. A lock on [start, end] covers from the bound before
+// start to the bound after end.
+struct RangeBound {
+  RangeBound(const Endpoint& endp, bool is_after)
+      : key(endp.slice.ToString()),
+        inf_suffix(endp.inf_suffix),
+        after(is_after) {}
+  RangeBound(const EndpointWithString& endp, bool is_after)
+      : key(endp.slice), inf_suffix(endp.inf_suffix), after(is_after) {}
+
+  EndpointWithString GetEndpoint() const { return {key, inf_suffix}; }
+
+  std::string key;
+  bool inf_suffix;
+  bool after;
+};
+
+struct RangeBoundLess {
+  bool operator()(const RangeBound& a, const RangeBound& b) const {
+    int res = CompareEndpoints(cmp, a.key, a.inf_suffix, b.key, b.inf_suffix);
+    return res < 0 || (res == 0 && !a.after && b.after);
+  }
+
+  const Comparator* cmp;
+};
+
+// The range from the bound it is mapped from to `end`, and the transactions
+// holding a lock on all of it. An exclusive lock has a single holder.
+struct RangeLockSegment {
+  RangeBound end;
+  bool exclusive;
+  autovector<TransactionID> txn_ids;
+};
+
+// A transaction waiting for the range [*lo, *hi) to be released
+struct RangeLockWaiter {
+  const RangeBound* lo;
+  const RangeBound* hi;
+  std::shared_ptr<TransactionDBCondVar> cv;
+};
+
+// The locks of a column family
+struct RangeLockMap {
+  using Segments = std::map<RangeBound, RangeLockSegment, RangeBoundLess>;
+
+  RangeLockMap(const Comparator* cmp,
+               std::shared_ptr<TransactionDBMutexFactory> factory,
+               std::atomic<uint64_t>* total_memory)
+      : less{cmp},
+        mutex(factory->AllocateMutex()),
+        segments(less),
+        total_lock_memory(total_memory) {}
+
+  ~RangeLockMap() { *total_lock_memory -= memory; }
+
+  // The first segment that ends after lo
+  Segments::iterator FirstOverlap(const RangeBound& lo) {
+    auto it = segments.upper_bound(lo);
+    if (it != segments.begin()) {
+      auto prev = std::prev(it);
+      if (less(lo, prev->second.end)) {
+        return prev;
+      }
+    }
+    return it;
+  }
+
+  Segments::iterator Insert(Segments::iterator hint, const RangeBound& start,
+                            RangeLockSegment&& segment) {
+    Charge(start, segment);
+    return segments.emplace_hint(hint, start, std::move(segment));
+  }
+
+  Segments::iterator Erase(Segments::iterator it) {
+    Uncharge(it->first, it->second);
+    return segments.erase(it);
+  }
+
+  // Cuts the segment at `bound`, which it covers, returning the second piece
+  Segments::iterator Split(Segments::iterator it, const RangeBound& bound) {
+    RangeLockSegment tail = it->second;
+    Uncharge(it->first, it->second);
+    it->second.end = bound;
+    Charge(it->first, it->second);
+    return Insert(std::next(it), bound, std::move(tail));
+  }
+
+  static size_t SegmentMemory(const RangeBound& start,
+                              const RangeLockSegment& segment) {
+    return sizeof(RangeBound) + sizeof(RangeLockSegment) + start.key.size() +
+           segment.end.key.size();
+  }
+
+  void Charge(const RangeBound& start, const RangeLockSegment& segment) {
+    size_t size = SegmentMemory(start, segment);
+    memory += size;
+    *total_lock_memory += size;
+  }
+
+  void Uncharge(const RangeBound& start, const RangeLockSegment& segment) {
+    size_t size = SegmentMemory(start, segment);
+    memory -= size;
+    *total_lock_memory -= size;
+  }
+
+  const RangeBoundLess less;
+
+  // Must be held when accessing segments and waiters
+  std::shared_ptr<TransactionDBMutex> mutex;
+
+  // Disjoint ranges locked by transactions, by their lower bound
+  Segments segments;
+
+  std::vector<RangeLockWaiter*> waiters;
+
+  // Memory used by segments, included in total_lock_memory
+  uint64_t memory = 0;
+  std::atomic<uint64_t>* const total_lock_memory;
+};
+
+namespace {
+void UnrefRangeLockMapsCache(void* ptr) {
+  // Called when a thread exits or a ThreadLocalPtr gets destroyed.
+  auto lock_maps_cache = static_cast<
+      std::unordered_map<ColumnFamilyId, std::shared_ptr<RangeLockMap>>*>(
+      ptr);
+  delete lock_maps_cache;
+}
+}  // anonymous namespace
+
+RangeMapLockManager::RangeMapLockManager(
+    std::shared_ptr<TransactionDBMutexFactory> mutex_factory)
+    : mutex_factory_(mutex_factory),
+      lock_maps_cache_(new ThreadLocalPtr(&UnrefRangeLockMapsCache)),
+      max_lock_memory_(0),
+      dlock_buffer_(10) {}
+
+RangeMapLockManager::~RangeMapLockManager() {
+  autovector<void*> local_caches;
+  lock_maps_cache_->Scrape(&local_caches, nullptr);
+  for (auto cache : local_caches) {
+    delete static_cast<LockMaps*>(cache);
+  }
+  lock_maps_.clear();
+}
+
+void RangeMapLockManager::AddColumnFamily(const ColumnFamilyHandle* cfh) {
+  InstrumentedMutexLock l(&lock_map_mutex_);
+  if (lock_maps_.find(cfh->GetID()) == lock_maps_.end()) {
+    lock_maps_.emplace(cfh->GetID(), std::make_shared<RangeLockMap>(
+                                         cfh->GetComparator(), mutex_factory_,
+                                         &current_lock_memory_));
+  }
+}
+
+void RangeMapLockManager::RemoveColumnFamily(const ColumnFamilyHandle* cfh) {
+  // Concurrent transactions can keep using the RangeLockMap until they
+  // release their references to it.
+  {
+    InstrumentedMutexLock l(&lock_map_mutex_);
+    lock_maps_.erase(cfh->GetID());
+  }
+
+  autovector<void*> local_caches;
+  lock_maps_cache_->Scrape(&local_caches, nullptr);
+  for (auto cache : local_caches) {
+    delete static_cast<LockMaps*>(cache);
+  }
+}
+
+std::shared_ptr<RangeLockMap> RangeMapLockManager::GetLockMap(
+    ColumnFamilyId column_family_id) {
+  // First check thread-local cache
+  if (lock_maps_cache_->Get() == nullptr) {
+    lock_maps_cache_->Reset(new LockMaps());
+  }
+
+  auto lock_maps_cache = static_cast<LockMaps*>(lock_maps_cache_->Get());
+
+  auto it = lock_maps_cache->find(column_family_id);
+  if (it != lock_maps_cache->end()) {
+    return it->second;
+  }
+
+  // Not found in local cache, grab mutex and check shared LockMaps
+  InstrumentedMutexLock l(&lock_map_mutex_);
+
+  it = lock_maps_.find(column_family_id);
+  if (it == lock_maps_.end()) {
+    return nullptr;
+  }
+  lock_maps_cache->insert({column_family_id, it->second});
+  return it->second;
+}
+
+Status RangeMapLockManager::TryLock(PessimisticTransaction* txn,
+                                    ColumnFamilyId column_family_id,
+                                    const Endpoint& start_endp,
+                                    const Endpoint& end_endp, Env* env,
+                                    bool exclusive) {
+  TEST_SYNC_POINT("RangeMapLockManager::TryLock:enter");
+  std::shared_ptr<RangeLockMap> lock_map_ptr = GetLockMap(column_family_id);
+  RangeLockMap* lock_map = lock_map_ptr.get();
+  if (lock_map == nullptr) {
+    char msg[255];
+    snprintf(msg, sizeof(msg), "Column family id not found: %" PRIu32,
+             column_family_id);
+    return Status::InvalidArgument(msg);
+  }
+
+  const RangeBound lo(start_endp, false);
+  const RangeBound hi(end_endp, true);
+  const int64_t timeout = txn->GetLockTimeout();
+  uint64_t end_time = 0;
+  if (timeout > 0) {
+    end_time = env->NowMicros() + timeout;
+  }
+
+  Status result = timeout < 0 ? lock_map->mutex->Lock()
+                              : lock_map->mutex->TryLockFor(timeout);
+  if (!result.ok()) {
+    return result;
+  }
+
+  autovector<TransactionID> wait_ids;
+  result = AcquireLocked(lock_map, txn->GetID(), lo, hi, exclusive, &wait_ids);
+
+  if (!result.ok() && timeout != 0 && !wait_ids.empty()) {
+    PERF_TIMER_GUARD(key_lock_wait_time);
+    PERF_COUNTER_ADD(key_lock_wait_count, 1);
+    lock_wait_count_.fetch_add(1, std::memory_order_relaxed);
+
+    // Only the unlocks of overlapping ranges wake the waiter up
+    RangeLockWaiter waiter{&lo, &hi, mutex_factory_->AllocateCondVar()};
+    lock_map->waiters.push_back(&waiter);
+    const std::string wait_key = start_endp.slice.ToString();
+    bool timed_out = false;
+    do {
+      if (txn->IsDeadlockDetect() &&
+          IncrementWaiters(txn, wait_ids, column_family_id, exclusive,
+                           start_endp, end_endp, env)) {
+        result = Status::Busy(Status::SubCode::kDeadlock);
+        break;
+      }
+      txn->SetWaitingTxn(wait_ids, column_family_id, &wait_key);
+
+      TEST_SYNC_POINT("RangeMapLockManager::TryLock:WaitingTxn");
+      if (end_time == 0) {
+        result = waiter.cv->Wait(lock_map->mutex);
+      } else {
+        uint64_t now = env->NowMicros();
+        result = end_time > now
+                     ? waiter.cv->WaitFor(lock_map->mutex, end_time - now)
+                     : Status::TimedOut(Status::SubCode::kLockTimeout);
+      }
+
+      txn->ClearWaitingTxn();
+      if (txn->IsDeadlockDetect()) {
+        DecrementWaiters(txn);
+      }
+
+      if (result.IsTimedOut()) {
+        timed_out = true;
+        // Make one more attempt, we may have missed the wake up
+      }
+      if (result.ok() || result.IsTimedOut()) {
+        wait_ids.clear();
+        result =
+            AcquireLocked(lock_map, txn->GetID(), lo, hi, exclusive, &wait_ids);
+      }
+    } while (!result.ok() && !wait_ids.empty() && !timed_out);
+
+    lock_map->waiters.erase(std::find(lock_map->waiters.begin(),
+                                      lock_map->waiters.end(), &waiter));
+  }
+
+  lock_map->mutex->UnLock();
+  return result;
+}
+
+Status RangeMapLockManager::AcquireLocked(RangeLockMap* lock_map,
+                                          TransactionID txn_id,
+                                          const RangeBound& lo,
+                                          const RangeBound& hi, bool exclusive,
+                                          autovector<TransactionID>* wait_ids) {
+  const RangeBoundLess& less = lock_map->less;
+  const auto first = lock_map->FirstOverlap(lo);
+
+  // Look for the conflicting locks, and whether the transaction already
+  // holds the lock on all of the range
+  bool held = true;
+  const RangeBound* covered = &lo;
+  for (auto it = first;
+       it != lock_map->segments.end() && less(it->first, hi); ++it) {
+    const RangeLockSegment& segment = it->second;
+    bool holder = false;
+    for (TransactionID id : segment.txn_ids) {
+      if (id == txn_id) {
+        holder = true;
+      } else if ((exclusive || segment.exclusive) &&
+                 std::find(wait_ids->begin(), wait_ids->end(), id) ==
+                     wait_ids->end()) {
+        wait_ids->push_back(id);
+      }
+    }
+    if (less(*covered, it->first) || !holder ||
+        (exclusive && !segment.exclusive)) {
+      held = false;
+    }
+    covered = &segment.end;
+  }
+  if (!wait_ids->empty()) {
+    return Status::TimedOut(Status::SubCode::kLockTimeout);
+  }
+  if (held && !less(*covered, hi)) {
+    return Status::OK();
+  }
+  const size_t max_lock_memory = max_lock_memory_.load();
+  if (max_lock_memory > 0 && current_lock_memory_.load() >= max_lock_memory) {
+    return Status::Busy(Status::SubCode::kLockLimit);
+  }
+
+  // Fill the gaps with new segments and add the transaction to the segments
+  // it does not hold yet, cutting those at lo and hi first
+  const RangeBound* pos = &lo;
+  auto it = first;
+  while (less(*pos, hi)) {
+    if (it == lock_map->segments.end() || !less(it->first, hi)) {
+      lock_map->Insert(it, *pos, {hi, exclusive, {txn_id}});
+      break;
+    }
+    if (less(*pos, it->first)) {
+      lock_map->Insert(it, *pos, {it->first, exclusive, {txn_id}});
+      pos = &it->first;
+      continue;
+    }
+    RangeLockSegment& segment = it->second;
+    const bool holder = std::find(segment.txn_ids.begin(),
+                                  segment.txn_ids.end(),
+                                  txn_id) != segment.txn_ids.end();
+    if (!holder || (exclusive && !segment.exclusive)) {
+      if (less(it->first, *pos)) {
+        it = lock_map->Split(it, *pos);
+      }
+      if (less(hi, it->second.end)) {
+        lock_map->Split(it, hi);
+      }
+      if (!holder) {
+        it->second.txn_ids.push_back(txn_id);
+      }
+      it->second.exclusive = it->second.exclusive || exclusive;
+    }
+    pos = &it->second.end;
+    ++it;
+  }
+  return Status::OK();
+}
+
+void RangeMapLockManager::UnLockLocked(
+    RangeLockMap* lock_map, TransactionID txn_id, const RangeBound& lo,
+    const RangeBound& hi,
+    autovector<std::shared_ptr<TransactionDBCondVar>>* to_notify) {
+  const RangeBoundLess& less = lock_map->less;
+  auto it = lock_map->FirstOverlap(lo);
+  while (it != lock_map->segments.end() && less(it->first, hi)) {
+    autovector<TransactionID>& txn_ids = it->second.txn_ids;
+    auto id_it = std::find(txn_ids.begin(), txn_ids.end(), txn_id);
+    if (id_it == txn_ids.end()) {
+      ++it;
+      continue;
+    }
+    for (RangeLockWaiter* waiter : lock_map->waiters) {
+      if (less(*waiter->lo, it->second.end) && less(it->first, *waiter->hi) &&
+          std::find(to_notify->begin(), to_notify->end(), waiter->cv) ==
+              to_notify->end()) {
+        to_notify->push_back(waiter->cv);
+      }
+    }
+    if (txn_ids.size() == 1) {
+      it = lock_map->Erase(it);
+    } else {
+      // The other holders share the lock
+      *id_it = txn_ids.back();
+      txn_ids.pop_back();
+      ++it;
+    }
+  }
+}
+
+void RangeMapLockManager::UnLockRanges(
+    PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+    const std::vector<TrackedRange>& ranges) {
+  std::shared_ptr<RangeLockMap> lock_map_ptr = GetLockMap(column_family_id);
+  RangeLockMap* lock_map = lock_map_ptr.get();
+  if (lock_map == nullptr) {
+    // Column Family must have been dropped.
+    return;
+  }
+
+  autovector<std::shared_ptr<TransactionDBCondVar>> to_notify;
+  lock_map->mutex->Lock().PermitUncheckedError();
+  for (const TrackedRange& range : ranges) {
+    UnLockLocked(lock_map, txn->GetID(), RangeBound(range.start, false),
+                 RangeBound(range.end, true), &to_notify);
+  }
+  lock_map->mutex->UnLock();
+
+  for (auto& cv : to_notify) {
+    cv->Notify();
+  }
+}
+
+void RangeMapLockManager::UnLock(PessimisticTransaction* txn,
+                                 const LockTracker& tracker, Env*) {
+  const auto& range_tracker = static_cast<const RangeMapLockTracker&>(tracker);
+  for (const auto& cf_ranges : range_tracker.ranges()) {
+    UnLockRanges(txn, cf_ranges.first, cf_ranges.second);
+  }
+}
+
+void RangeMapLockManager::UnLock(PessimisticTransaction* txn,
+                                 ColumnFamilyId column_family_id,
+                                 const std::string& key, Env*) {
+  UnLockRanges(txn, column_family_id, {{{key, false}, {key, false}}});
+}
+
+void RangeMapLockManager::UnLock(PessimisticTransaction* txn,
+                                 ColumnFamilyId column_family_id,
+                                 const Endpoint& start_endp,
+                                 const Endpoint& end_endp, Env*) {
+  UnLockRanges(
+      txn, column_family_id,
+      {{{start_endp.slice.ToString(), start_endp.inf_suffix},
+        {end_endp.slice.ToString(), end_endp.inf_suffix}}});
+}
+
+bool RangeMapLockManager::IncrementWaiters(
+    const PessimisticTransaction* txn,
+    const autovector<TransactionID>& wait_ids, ColumnFamilyId column_family_id,
+    bool exclusive, const Endpoint& start_endp, const Endpoint& end_endp,
+    Env* env) {
+  const TransactionID id = txn->GetID();
+  const size_t depth = static_cast<size_t>(txn->GetDeadlockDetectDepth());
+  std::lock_guard<std::mutex> lock(wait_txn_map_mutex_);
+  assert(wait_txn_map_.find(id) == wait_txn_map_.end());
+  wait_txn_map_.emplace(
+      id, WaitInfo{wait_ids,
+                   {id,
+                    column_family_id,
+                    exclusive,
+                    {start_endp.slice.ToString(), start_endp.inf_suffix},
+                    {end_endp.slice.ToString(), end_endp.inf_suffix}}});
+
+  // Breadth-first search of the transactions waited for, each one queued
+  // with the index of the one it was reached from
+  std::vector<std::pair<TransactionID, int>> queue;
+  for (TransactionID wait_id : wait_ids) {
+    queue.emplace_back(wait_id, -1);
+  }
+  for (size_t head = 0; head < queue.size(); head++) {
+    int64_t deadlock_time = 0;
+    if (head >= depth) {
+      // Wait cycle too big, just assume deadlock.
+      if (!env->GetCurrentTime(&deadlock_time).ok()) {
+        deadlock_time = 0;
+      }
+      dlock_buffer_.AddNewPath(RangeDeadlockPath(deadlock_time, true));
+      wait_txn_map_.erase(id);
+      return true;
+    }
+    const TransactionID next = queue[head].first;
+    if (next == id) {
+      std::vector<RangeDeadlockInfo> path;
+      for (int i = static_cast<int>(head); i != -1; i = queue[i].second) {
+        path.push_back(wait_txn_map_.at(queue[i].first).info);
+      }
+      std::reverse(path.begin(), path.end());
+      if (!env->GetCurrentTime(&deadlock_time).ok()) {
+        deadlock_time = 0;
+      }
+      dlock_buffer_.AddNewPath(RangeDeadlockPath(path, deadlock_time));
+      wait_txn_map_.erase(id);
+      return true;
+    }
+    auto wait_it = wait_txn_map_.find(next);
+    if (wait_it == wait_txn_map_.end()) {
+      continue;
+    }
+    for (TransactionID wait_id : wait_it->second.waitees) {
+      queue.emplace_back(wait_id, static_cast<int>(head));
+    }
+  }
+  return false;
+}
+
+void RangeMapLockManager::DecrementWaiters(const PessimisticTransaction* txn) {
+  std::lock_guard<std::mutex> lock(wait_txn_map_mutex_);
+  wait_txn_map_.erase(txn->GetID());
+}
+
+LockManager::PointLockStatus RangeMapLockManager::GetPointLockStatus() {
+  PointLockStatus res;
+  LockManager::RangeLockStatus data = GetRangeLockStatus();
+  // report left endpoints
+  for (auto it = data.begin(); it != data.end(); ++it) {
+    auto& val = it->second;
+    res.insert({it->first, {val.start.slice, val.ids, val.exclusive}});
+  }
+  return res;
+}
+
+LockManager::RangeLockStatus RangeMapLockManager::GetRangeLockStatus() {
+  LockManager::RangeLockStatus data;
+  InstrumentedMutexLock l(&lock_map_mutex_);
+  for (const auto& cf_lock_map : lock_maps_) {
+    RangeLockMap* lock_map = cf_lock_map.second.get();
+    lock_map->mutex->Lock().PermitUncheckedError();
+    // Adjacent segments of the same holders are reported as one range
+    RangeLockInfo* last = nullptr;
+    const RangeBound* last_end = nullptr;
+    for (const auto& it : lock_map->segments) {
+      const RangeLockSegment& segment = it.second;
+      if (last != nullptr && last->exclusive == segment.exclusive &&
+          !lock_map->less(*last_end, it.first) &&
+          std::equal(last->ids.begin(), last->ids.end(),
+                     segment.txn_ids.begin(), segment.txn_ids.end())) {
+        last->end = segment.end.GetEndpoint();
+        last_end = &segment.end;
+        continue;
+      }
+      RangeLockInfo info;
+      info.start = it.first.GetEndpoint();
+      info.end = segment.end.GetEndpoint();
+      info.ids.assign(segment.txn_ids.begin(), segment.txn_ids.end());
+      info.exclusive = segment.exclusive;
+      last = &data.insert({cf_lock_map.first, std::move(info)})->second;
+      last_end = &segment.end;
+    }
+    lock_map->mutex->UnLock();
+  }
+  return data;
+}
+
+std::vector<DeadlockPath> RangeMapLockManager::GetDeadlockInfoBuffer() {
+  std::vector<DeadlockPath> res;
+  // report left endpoints
+  for (const RangeDeadlockPath& range_path : GetRangeDeadlockInfoBuffer()) {
+    std::vector<DeadlockInfo> path;
+    for (const RangeDeadlockInfo& info : range_path.path) {
+      path.push_back(
+          {info.m_txn_id, info.m_cf_id, info.m_exclusive, info.m_start.slice});
+    }
+    DeadlockPath deadlock_path(path, range_path.deadlock_time);
+    deadlock_path.limit_exceeded = range_path.limit_exceeded;
+    res.push_back(std::move(deadlock_path));
+  }
+  return res;
+}
+
+void RangeMapLockManager::Resize(uint32_t target_size) {
+  SetRangeDeadlockInfoBufferSize(target_size);
+}
+
+std::vector<RangeDeadlockPath>
+RangeMapLockManager::GetRangeDeadlockInfoBuffer() {
+  return dlock_buffer_.PrepareBuffer();
+}
+
+void RangeMapLockManager::SetRangeDeadlockInfoBufferSize(
+    uint32_t target_size) {
+  dlock_buffer_.Resize(target_size);
+}
+
+int RangeMapLockManager::SetMaxLockMemory(size_t max_lock_memory) {
+  if (max_lock_memory > 0 && current_lock_memory_.load() > max_lock_memory) {
+    return EDOM;
+  }
+  max_lock_memory_.store(max_lock_memory);
+  return 0;
+}
+
+RangeLockManagerHandle::Counters RangeMapLockManager::GetStatus() {
+  Counters res;
+  res.escalation_count = 0;
+  res.lock_wait_count = lock_wait_count_.load(std::memory_order_relaxed);
+  res.current_lock_memory = current_lock_memory_.load();
+  return res;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,163 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "monitoring/instrumented_mutex.h"
+#include "rocksdb/utilities/transaction_db_mutex.h"
+#include "util/autovector.h"
+#include "util/thread_local.h"
+// For DeadlockInfoBufferTempl:
+#include "utilities/transactions/lock/point/point_lock_manager.h"
+#include "utilities/transactions/lock/range/range_lock_manager.h"
+#include "utilities/transactions/lock/range/range_map/range_map_lock_tracker.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct RangeBound;
+struct RangeLockMap;
+
+// A Range Lock Manager that keeps the locks of each column family in an
+// ordered map of disjoint key ranges, each with the transactions holding it.
+// The map is only latched for the lookup and update of the ranges a request
+// overlaps, and an unlock only wakes the waiters for the ranges it released,
+// so that transactions locking disjoint ranges rarely get in each other's
+// way. Unlike RangeTreeLockManager, locks are not escalated: a request that
+// would take more than the max lock memory fails with Status::Busy.
+class RangeMapLockManager : public RangeLockManagerBase,
+                            public RangeLockManagerHandle {
+ public:
+  explicit RangeMapLockManager(
+      std::shared_ptr<TransactionDBMutexFactory> mutex_factory);
+  // No copying allowed
+  RangeMapLockManager(const RangeMapLockManager&) = delete;
+  RangeMapLockManager& operator=(const RangeMapLockManager&) = delete;
+
+  ~RangeMapLockManager() override;
+
+  LockManager* getLockManager() override { return this; }
+
+  bool IsPointLockSupported() const override {
+    // One could have acquired a point lock (it is reduced to range lock)
+    return true;
+  }
+
+  bool IsRangeLockSupported() const override { return true; }
+
+  const LockTrackerFactory& GetLockTrackerFactory() const override {
+    return RangeMapLockTrackerFactory::Get();
+  }
+
+  void AddColumnFamily(const ColumnFamilyHandle* cfh) override;
+  void RemoveColumnFamily(const ColumnFamilyHandle* cfh) override;
+
+  using LockManager::TryLock;
+  Status TryLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+                 const Endpoint& start_endp, const Endpoint& end_endp, Env* env,
+                 bool exclusive) override;
+
+  // Releasing a range releases every range of the transaction that overlaps
+  // it, as with RangeTreeLockManager
+  void UnLock(PessimisticTransaction* txn, const LockTracker& tracker,
+              Env* env) override;
+  void UnLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+              const std::string& key, Env* env) override;
+  void UnLock(PessimisticTransaction* txn, ColumnFamilyId column_family_id,
+              const Endpoint& start_endp, const Endpoint& end_endp,
+              Env* env) override;
+
+  PointLockStatus GetPointLockStatus() override;
+
+  LockManager::RangeLockStatus GetRangeLockStatus() override;
+
+  RangeLockManagerHandle::RangeLockStatus GetRangeLockStatusData() override {
+    return GetRangeLockStatus();
+  }
+
+  std::vector<DeadlockPath> GetDeadlockInfoBuffer() override;
+  void Resize(uint32_t target_size) override;
+
+  std::vector<RangeDeadlockPath> GetRangeDeadlockInfoBuffer() override;
+  void SetRangeDeadlockInfoBufferSize(uint32_t target_size) override;
+
+  int SetMaxLockMemory(size_t max_lock_memory) override;
+  size_t GetMaxLockMemory() override { return max_lock_memory_.load(); }
+
+  // Locks are never escalated, so there is no barrier to check
+  void SetEscalationBarrierFunc(EscalationBarrierFunc) override {}
+
+  Counters GetStatus() override;
+
+ private:
+  // A transaction waiting in a deadlock detecting wait, see IncrementWaiters()
+  struct WaitInfo {
+    autovector<TransactionID> waitees;
+    RangeDeadlockInfo info;
+  };
+
+  std::shared_ptr<RangeLockMap> GetLockMap(ColumnFamilyId column_family_id);
+
+  // Takes the lock if no other transaction holds a conflicting lock on the
+  // range, else returns Status::TimedOut and the transactions to wait for.
+  // REQUIRED: the mutex of lock_map must be held.
+  Status AcquireLocked(RangeLockMap* lock_map, TransactionID txn_id,
+                       const RangeBound& lo, const RangeBound& hi,
+                       bool exclusive, autovector<TransactionID>* wait_ids);
+
+  // Releases the locks of the transaction overlapping [lo, hi), collecting
+  // the waiters to wake into to_notify.
+  // REQUIRED: the mutex of lock_map must be held.
+  void UnLockLocked(
+      RangeLockMap* lock_map, TransactionID txn_id, const RangeBound& lo,
+      const RangeBound& hi,
+      autovector<std::shared_ptr<TransactionDBCondVar>>* to_notify);
+
+  void UnLockRanges(PessimisticTransaction* txn,
+                    ColumnFamilyId column_family_id,
+                    const std::vector<TrackedRange>& ranges);
+
+  // Returns true if waiting for wait_ids closes a cycle of waits, in which
+  // case the deadlock is recorded and the transaction must not wait
+  bool IncrementWaiters(const PessimisticTransaction* txn,
+                        const autovector<TransactionID>& wait_ids,
+                        ColumnFamilyId column_family_id, bool exclusive,
+                        const Endpoint& start_endp, const Endpoint& end_endp,
+                        Env* env);
+  void DecrementWaiters(const PessimisticTransaction* txn);
+
+  std::shared_ptr<TransactionDBMutexFactory> mutex_factory_;
+
+  // Must be held when accessing/modifying lock_maps_, before any mutex of a
+  // RangeLockMap
+  InstrumentedMutex lock_map_mutex_;
+
+  using LockMaps =
+      std::unordered_map<ColumnFamilyId, std::shared_ptr<RangeLockMap>>;
+  LockMaps lock_maps_;
+
+  // Thread-local cache of entries in lock_maps_, to avoid taking
+  // lock_map_mutex_ in order to look up a RangeLockMap
+  std::unique_ptr<ThreadLocalPtr> lock_maps_cache_;
+
+  std::atomic<size_t> max_lock_memory_;
+  std::atomic<uint64_t> current_lock_memory_{0};
+  std::atomic<uint64_t> lock_wait_count_{0};
+
+  // Taken after the mutex of a RangeLockMap. Must be held when accessing
+  // wait_txn_map_.
+  std::mutex wait_txn_map_mutex_;
+  std::unordered_map<TransactionID, WaitInfo> wait_txn_map_;
+
+  DeadlockInfoBufferTempl<RangeDeadlockPath> dlock_buffer_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,112 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utilities/transactions/lock/lock_tracker.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A range locked by a transaction, both ends included
+struct TrackedRange {
+  EndpointWithString start;
+  EndpointWithString end;
+};
+
+// A LockTracker that is used together with RangeMapLockManager. It keeps the
+// ranges in the order they were locked, so that they can all be released.
+// Like RangeTreeLockTracker, it does not support untracking or save points.
+class RangeMapLockTracker : public LockTracker {
+ public:
+  RangeMapLockTracker() {}
+
+  RangeMapLockTracker(const RangeMapLockTracker&) = delete;
+  RangeMapLockTracker& operator=(const RangeMapLockTracker&) = delete;
+
+  bool IsPointLockSupported() const override {
+    // This indicates that we don't implement GetPointLockStatus()
+    return false;
+  }
+  bool IsRangeLockSupported() const override { return true; }
+
+  void Track(const PointLockRequest& lock_req) override {
+    ranges_[lock_req.column_family_id].push_back(
+        {{lock_req.key, false}, {lock_req.key, false}});
+  }
+
+  void Track(const RangeLockRequest& lock_req) override {
+    ranges_[lock_req.column_family_id].push_back(
+        {{lock_req.start_endp.slice.ToString(), lock_req.start_endp.inf_suffix},
+         {lock_req.end_endp.slice.ToString(), lock_req.end_endp.inf_suffix}});
+  }
+
+  UntrackStatus Untrack(const PointLockRequest& /*lock_request*/) override {
+    return UntrackStatus::NOT_TRACKED;
+  }
+
+  UntrackStatus Untrack(const RangeLockRequest& /*lock_request*/) override {
+    return UntrackStatus::NOT_TRACKED;
+  }
+
+  void Merge(const LockTracker&) override {}
+
+  void Subtract(const LockTracker&) override {}
+
+  void Clear() override { ranges_.clear(); }
+
+  LockTracker* GetTrackedLocksSinceSavePoint(
+      const LockTracker&) const override {
+    return nullptr;
+  }
+
+  PointLockStatus GetPointLockStatus(
+      ColumnFamilyId /*column_family_id*/,
+      const std::string& /*key*/) const override {
+    // Not expected to be called, see IsPointLockSupported()
+    PointLockStatus p;
+    p.locked = false;
+    p.exclusive = true;
+    p.seq = 0;
+    return p;
+  }
+
+  uint64_t GetNumPointLocks() const override { return 0; }
+
+  ColumnFamilyIterator* GetColumnFamilyIterator() const override {
+    return nullptr;
+  }
+
+  KeyIterator* GetKeyIterator(
+      ColumnFamilyId /*column_family_id*/) const override {
+    return nullptr;
+  }
+
+  const std::unordered_map<ColumnFamilyId, std::vector<TrackedRange>>& ranges()
+      const {
+    return ranges_;
+  }
+
+ private:
+  std::unordered_map<ColumnFamilyId, std::vector<TrackedRange>> ranges_;
+};
+
+class RangeMapLockTrackerFactory : public LockTrackerFactory {
+ public:
+  static const RangeMapLockTrackerFactory& Get() {
+    static const RangeMapLockTrackerFactory instance;
+    return instance;
+  }
+
+  LockTracker* Create() const override { return new RangeMapLockTracker(); }
+
+ private:
+  RangeMapLockTrackerFactory() {}
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -85,6 +85,12 @@ Status OptimisticTransaction::CommitWithSerialValidate() {
   Status s = db_impl->WriteWithCallback(
       write_options_, GetWriteBatch()->GetWriteBatch(), &callback);
 
+  if (!commit_buckets_.empty()) {
+    // Marked by CheckTransactionForConflicts()
+    GetCommitSeqTable()->EndCommit(db_impl->GetLatestSequenceNumber(),
+                                   &commit_buckets_);
+  }
+
   if (s.ok()) {
     Clear();
   }
@@ -135,13 +141,24 @@ Status OptimisticTransaction::CommitWithParallelValidate() {
     }
   });
 
-  Status s = TransactionUtil::CheckKeysForConflicts(db_impl, *tracked_locks_,
-                                                    true /* cache_only */);
+  OccCommitSeqTable* commit_seqs = txn_db_impl->GetCommitSeqTable();
+  Status s = commit_seqs != nullptr
+                 ? commit_seqs->Validate(*tracked_locks_)
+                 : TransactionUtil::CheckKeysForConflicts(
+                       db_impl, *tracked_locks_, true /* cache_only */);
   if (!s.ok()) {
     return s;
   }
 
-  s = db_impl->Write(write_options_, GetWriteBatch()->GetWriteBatch());
+  WriteBatch* batch = GetWriteBatch()->GetWriteBatch();
+  if (commit_seqs != nullptr) {
+    commit_seqs->BeginCommit(batch, &commit_buckets_);
+  }
+  s = db_impl->Write(write_options_, batch);
+  if (commit_seqs != nullptr) {
+    commit_seqs->EndCommit(db_impl->GetLatestSequenceNumber(),
+                           &commit_buckets_);
+  }
   if (s.ok()) {
     Clear();
   }
@@ -194,6 +211,18 @@ Status OptimisticTransaction::TryLock(ColumnFamilyHandle* column_family,
 Status OptimisticTransaction::CheckTransactionForConflicts(DB* db) {
   auto db_impl = static_cast_with_check<DBImpl>(db);
 
+  OccCommitSeqTable* commit_seqs = GetCommitSeqTable();
+  if (commit_seqs != nullptr) {
+    Status s = commit_seqs->Validate(*tracked_locks_);
+    if (s.ok()) {
+      // The transactions validated after us conflict with our write, which
+      // is now certain unless it fails
+      commit_seqs->BeginCommit(GetWriteBatch()->GetWriteBatch(),
+                               &commit_buckets_);
+    }
+    return s;
+  }
+
   // Since we are on the write thread and do not want to block other writers,
   // we will do a cache-only conflict check.  This can result in TryAgain
   // getting returned if there is not sufficient memtable history to check
@@ -202,6 +231,13 @@ Status OptimisticTransaction::CheckTransactionForConflicts(DB* db) {
                                                 true /* cache_only */);
 }
 
+OccCommitSeqTable* OptimisticTransaction::GetCommitSeqTable() const {
+  auto txn_db_impl = static_cast_with_check<OptimisticTransactionDBImpl,
+                                            OptimisticTransactionDB>(txn_db_);
+  assert(txn_db_impl);
+  return txn_db_impl->GetCommitSeqTable();
+}
+
 Status OptimisticTransaction::SetName(const TransactionName& /* unused */) {
   return Status::InvalidArgument("Optimistic transactions cannot be named.");
 }
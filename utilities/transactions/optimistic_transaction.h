@@ -20,6 +20,7 @@
 #include "rocksdb/utilities/optimistic_transaction_db.h"
 #include "rocksdb/utilities/transaction.h"
 #include "rocksdb/utilities/write_batch_with_index.h"
+#include "utilities/transactions/optimistic_transaction_db_impl.h"
 #include "utilities/transactions/transaction_base.h"
 #include "utilities/transactions/transaction_util.h"
 
@@ -77,6 +78,13 @@ class OptimisticTransaction : public TransactionBaseImpl {
   Status CommitWithSerialValidate();
 
   Status CommitWithParallelValidate();
+
+  // See OptimisticTransactionDBOptions::commit_seq_buckets
+  OccCommitSeqTable* GetCommitSeqTable() const;
+
+  // The buckets of the commit sequence table marked for the commit in
+  // progress
+  std::vector<OccCommitSeqTable::Bucket*> commit_buckets_;
 };
 
 // Used at commit time to trigger transaction validation
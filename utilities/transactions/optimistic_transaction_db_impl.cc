@@ -6,6 +6,7 @@
 
 #include "utilities/transactions/optimistic_transaction_db_impl.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -13,6 +14,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
+#include "utilities/transactions/lock/lock_tracker.h"
 #include "utilities/transactions/optimistic_transaction.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -26,6 +28,98 @@ std::shared_ptr<OccLockBuckets> MakeSharedOccLockBuckets(size_t bucket_count,
   }
 }
 
+Status OccCommitSeqTable::Validate(const LockTracker& tracker) {
+  std::unique_ptr<LockTracker::ColumnFamilyIterator> cf_it(
+      tracker.GetColumnFamilyIterator());
+  assert(cf_it != nullptr);
+  while (cf_it->HasNext()) {
+    ColumnFamilyId cf = cf_it->Next();
+    std::unique_ptr<LockTracker::KeyIterator> key_it(
+        tracker.GetKeyIterator(cf));
+    assert(key_it != nullptr);
+    while (key_it->HasNext()) {
+      const std::string& key = key_it->Next();
+      Bucket& bucket = GetBucket(cf, key);
+      // The count is read first, as EndCommit() decrements it last
+      if (bucket.commits_in_flight.Load() > 0 ||
+          bucket.seq.Load() > tracker.GetPointLockStatus(cf, key).seq) {
+        return Status::Busy();
+      }
+    }
+  }
+  return Status::OK();
+}
+
+namespace {
+// Collects the buckets of the keys written by a batch
+class CommitSeqBucketCollector : public WriteBatch::Handler {
+ public:
+  CommitSeqBucketCollector(OccCommitSeqTable* table,
+                           std::vector<OccCommitSeqTable::Bucket*>* buckets)
+      : table_(table), buckets_(buckets) {}
+
+  Status PutCF(uint32_t cf, const Slice& key, const Slice&) override {
+    return Add(cf, key);
+  }
+  Status PutEntityCF(uint32_t cf, const Slice& key, const Slice&) override {
+    return Add(cf, key);
+  }
+  Status DeleteCF(uint32_t cf, const Slice& key) override {
+    return Add(cf, key);
+  }
+  Status SingleDeleteCF(uint32_t cf, const Slice& key) override {
+    return Add(cf, key);
+  }
+  Status MergeCF(uint32_t cf, const Slice& key, const Slice&) override {
+    return Add(cf, key);
+  }
+  Status PutBlobIndexCF(uint32_t cf, const Slice& key, const Slice&) override {
+    return Add(cf, key);
+  }
+  Status MarkBeginPrepare(bool) override { return Status::OK(); }
+  Status MarkEndPrepare(const Slice&) override { return Status::OK(); }
+  Status MarkCommit(const Slice&) override { return Status::OK(); }
+  Status MarkRollback(const Slice&) override { return Status::OK(); }
+  Status MarkNoop(bool) override { return Status::OK(); }
+
+ private:
+  Status Add(uint32_t cf, const Slice& key) {
+    buckets_->push_back(&table_->GetBucket(cf, key));
+    return Status::OK();
+  }
+
+  OccCommitSeqTable* table_;
+  std::vector<OccCommitSeqTable::Bucket*>* buckets_;
+};
+}  // namespace
+
+void OccCommitSeqTable::BeginCommit(WriteBatch* batch,
+                                    std::vector<Bucket*>* buckets) {
+  assert(buckets->empty());
+  CommitSeqBucketCollector collector(this, buckets);
+  // Nothing can fail in the handler
+  batch->Iterate(&collector).PermitUncheckedError();
+  // A bucket is counted once per commit
+  std::sort(buckets->begin(), buckets->end());
+  buckets->erase(std::unique(buckets->begin(), buckets->end()),
+                 buckets->end());
+  for (Bucket* bucket : *buckets) {
+    bucket->commits_in_flight.FetchAdd(1);
+  }
+}
+
+void OccCommitSeqTable::EndCommit(SequenceNumber seq,
+                                  std::vector<Bucket*>* buckets) {
+  for (Bucket* bucket : *buckets) {
+    SequenceNumber cur = bucket->seq.Load();
+    while (cur < seq && !bucket->seq.CasWeak(cur, seq)) {
+    }
+    assert(bucket->commits_in_flight.Load() > 0);
+    bucket->commits_in_flight.FetchSub(1);
+  }
+  buckets->clear();
+}
+
 Transaction* OptimisticTransactionDBImpl::BeginTransaction(
     const WriteOptions& write_options,
     const OptimisticTransactionOptions& txn_options, Transaction* old_txn) {
@@ -79,8 +173,12 @@ Status OptimisticTransactionDB::Open(
 
   std::vector<ColumnFamilyDescriptor> column_families_copy = column_families;
 
-  // Enable MemTable History if not already enabled
+  // Enable MemTable History if not already enabled, unless the
+  // transactions are validated without it
   for (auto& column_family : column_families_copy) {
+    if (occ_options.commit_seq_buckets > 0) {
+      break;
+    }
     ColumnFamilyOptions* options = &column_family.options;
 
     if (options->max_write_buffer_size_to_maintain == 0 &&
@@ -100,6 +198,23 @@ Status OptimisticTransactionDB::Open(
   return s;
 }
 
+Status OptimisticTransactionDBImpl::Write(const WriteOptions& write_opts,
+                                          WriteBatch* batch,
+                                          PostWriteCallback* callback) {
+  if (batch->HasDeleteRange()) {
+    return Status::NotSupported();
+  }
+  if (!commit_seqs_) {
+    return OptimisticTransactionDB::Write(write_opts, batch, callback);
+  }
+  // The transactions reading the keys conflict with the write
+  std::vector<OccCommitSeqTable::Bucket*> buckets;
+  commit_seqs_->BeginCommit(batch, &buckets);
+  Status s = OptimisticTransactionDB::Write(write_opts, batch, callback);
+  commit_seqs_->EndCommit(GetLatestSequenceNumber(), &buckets);
+  return s;
+}
+
 void OptimisticTransactionDBImpl::ReinitializeTransaction(
     Transaction* txn, const WriteOptions& write_options,
     const OptimisticTransactionOptions& txn_options) {
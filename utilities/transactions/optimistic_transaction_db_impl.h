@@ -13,6 +13,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
+#include "util/atomic.h"
 #include "util/cast_util.h"
 #include "util/mutexlock.h"
 
@@ -41,6 +42,41 @@ class OccLockBucketsImpl : public OccLockBucketsImplBase {
   Striped<M> locks_;
 };
 
+class LockTracker;
+
+// The sequence numbers of the last commits to the keys hashing to each
+// bucket, see OptimisticTransactionDBOptions::commit_seq_buckets. A bucket
+// with a commit in flight conflicts with every transaction tracking its keys.
+class OccCommitSeqTable {
+ public:
+  struct Bucket {
+    AcqRelAtomic<SequenceNumber> seq;
+    AcqRelAtomic<uint32_t> commits_in_flight;
+  };
+
+  explicit OccCommitSeqTable(size_t bucket_count) : buckets_(bucket_count) {}
+
+  // Returns Status::Busy() if a key tracked by a transaction may have been
+  // written after the transaction tracked it
+  Status Validate(const LockTracker& tracker);
+
+  // Marks the keys written by the batch as being committed, saving their
+  // buckets in `buckets` for EndCommit()
+  void BeginCommit(WriteBatch* batch, std::vector<Bucket*>* buckets);
+
+  // Records the keys of BeginCommit() as committed at `seq` or before
+  void EndCommit(SequenceNumber seq, std::vector<Bucket*>* buckets);
+
+  Bucket& GetBucket(uint32_t cf, const Slice& key) {
+    // Seeded by column family, like the lock buckets
+    return buckets_.Get(key, uint64_t{0xb83c07fbc6ced699} /*random prime*/ *
+                                 (uint64_t{cf} + 1));
+  }
+
+ private:
+  Striped<Bucket> buckets_;
+};
+
 class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
  public:
   explicit OptimisticTransactionDBImpl(
@@ -58,6 +94,9 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
       bucketed_locks_ = static_cast_with_check<OccLockBucketsImplBase>(
           std::move(bucketed_locks));
     }
+    if (occ_options.commit_seq_buckets > 0) {
+      commit_seqs_.reset(new OccCommitSeqTable(occ_options.commit_seq_buckets));
+    }
   }
 
   ~OptimisticTransactionDBImpl() {
@@ -83,15 +122,53 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
   // incompatible with `OptimisticTransactionDB`.
   using OptimisticTransactionDB::Write;
   virtual Status Write(const WriteOptions& write_opts, WriteBatch* batch,
-                       PostWriteCallback* callback) override {
-    if (batch->HasDeleteRange()) {
-      return Status::NotSupported();
-    }
-    return OptimisticTransactionDB::Write(write_opts, batch, callback);
+                       PostWriteCallback* callback) override;
+
+  // With a commit sequence table, the writes go through Write() to be
+  // recorded in it
+  using OptimisticTransactionDB::Put;
+  Status Put(const WriteOptions& options, ColumnFamilyHandle* column_family,
+             const Slice& key, const Slice& value) override {
+    return commit_seqs_ ? DB::Put(options, column_family, key, value)
+                        : OptimisticTransactionDB::Put(options, column_family,
+                                                       key, value);
+  }
+  using OptimisticTransactionDB::PutEntity;
+  Status PutEntity(const WriteOptions& options,
+                   ColumnFamilyHandle* column_family, const Slice& key,
+                   const WideColumns& columns) override {
+    return commit_seqs_ ? DB::PutEntity(options, column_family, key, columns)
+                        : OptimisticTransactionDB::PutEntity(
+                              options, column_family, key, columns);
+  }
+  using OptimisticTransactionDB::Delete;
+  Status Delete(const WriteOptions& options, ColumnFamilyHandle* column_family,
+                const Slice& key) override {
+    return commit_seqs_
+               ? DB::Delete(options, column_family, key)
+               : OptimisticTransactionDB::Delete(options, column_family, key);
+  }
+  using OptimisticTransactionDB::SingleDelete;
+  Status SingleDelete(const WriteOptions& options,
+                      ColumnFamilyHandle* column_family,
+                      const Slice& key) override {
+    return commit_seqs_ ? DB::SingleDelete(options, column_family, key)
+                        : OptimisticTransactionDB::SingleDelete(
+                              options, column_family, key);
+  }
+  using OptimisticTransactionDB::Merge;
+  Status Merge(const WriteOptions& options, ColumnFamilyHandle* column_family,
+               const Slice& key, const Slice& value) override {
+    return commit_seqs_ ? DB::Merge(options, column_family, key, value)
+                        : OptimisticTransactionDB::Merge(
+                              options, column_family, key, value);
   }
 
   OccValidationPolicy GetValidatePolicy() const { return validate_policy_; }
 
+  // nullptr unless OptimisticTransactionDBOptions::commit_seq_buckets is set
+  OccCommitSeqTable* GetCommitSeqTable() const { return commit_seqs_.get(); }
+
   port::Mutex& GetLockBucket(const Slice& key, uint64_t seed) {
     return bucketed_locks_->GetLockBucket(key, seed);
   }
@@ -99,6 +176,8 @@ class OptimisticTransactionDBImpl : public OptimisticTransactionDB {
  private:
   std::shared_ptr<OccLockBucketsImplBase> bucketed_locks_;
 
+  std::unique_ptr<OccCommitSeqTable> commit_seqs_;
+
   bool db_owner_;
 
   const OccValidationPolicy validate_policy_;
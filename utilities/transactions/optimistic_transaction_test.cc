@@ -396,6 +396,54 @@ TEST_P(OptimisticTransactionTest, FlushTest2) {
   delete txn;
 }
 
+TEST_P(OptimisticTransactionTest, CommitSeqTable) {
+  // Validate without any memtable history
+  options.max_write_buffer_size_to_maintain = 0;
+  occ_opts.commit_seq_buckets = 1 << 16;
+  Reopen();
+
+  WriteOptions write_options;
+  ReadOptions read_options;
+  std::string value;
+  ASSERT_OK(txn_db->Put(write_options, "foo", "bar"));
+
+  // A write outside of transactions conflicts
+  Transaction* txn = txn_db->BeginTransaction(write_options);
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_OK(txn->Put("foo", "bar2"));
+  ASSERT_OK(txn_db->Put(write_options, "foo", "bar3"));
+  ASSERT_TRUE(txn->Commit().IsBusy());
+
+  // So does the commit of another transaction
+  txn = txn_db->BeginTransaction(write_options, OptimisticTransactionOptions(),
+                                 txn);
+  Transaction* txn2 = txn_db->BeginTransaction(write_options);
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_EQ(value, "bar3");
+  ASSERT_OK(txn2->GetForUpdate(read_options, "foo", &value));
+  ASSERT_OK(txn2->Put("foo", "bar4"));
+  ASSERT_OK(txn2->Commit());
+  ASSERT_OK(txn->Put("foo", "bar5"));
+  ASSERT_TRUE(txn->Commit().IsBusy());
+
+  // Flushed memtables do not matter
+  txn = txn_db->BeginTransaction(write_options, OptimisticTransactionOptions(),
+                                 txn);
+  ASSERT_OK(txn->GetForUpdate(read_options, "foo", &value));
+  ASSERT_EQ(value, "bar4");
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(txn_db->Put(write_options, "dummy", std::to_string(i)));
+    ASSERT_OK(txn_db->Flush(FlushOptions()));
+  }
+  ASSERT_OK(txn->Put("foo", "bar5"));
+  ASSERT_OK(txn->Commit());
+  ASSERT_OK(txn_db->Get(read_options, "foo", &value));
+  ASSERT_EQ(value, "bar5");
+
+  delete txn2;
+  delete txn;
+}
+
 // Trigger the condition where some old memtables are skipped when doing
 // TransactionUtil::CheckKey(), and make sure the result is still correct.
 TEST_P(OptimisticTransactionTest, CheckKeySkipOldMemtable) {
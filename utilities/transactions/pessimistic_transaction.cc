@@ -106,6 +106,7 @@ void PessimisticTransaction::Initialize(const TransactionOptions& txn_options) {
 
 PessimisticTransaction::~PessimisticTransaction() {
   txn_db_impl_->UnLock(this, *tracked_locks_);
+  txn_db_impl_->ChargeTxnMemory(&charged_memory_, 0).PermitUncheckedError();
   if (expiration_time_ > 0) {
     txn_db_impl_->RemoveExpirableTransaction(txn_id_);
   }
@@ -117,6 +118,19 @@ PessimisticTransaction::~PessimisticTransaction() {
 void PessimisticTransaction::Clear() {
   txn_db_impl_->UnLock(this, *tracked_locks_);
   TransactionBaseImpl::Clear();
+  txn_db_impl_->ChargeTxnMemory(&charged_memory_, 0).PermitUncheckedError();
+}
+
+Status PessimisticTransaction::ChargeMemory(size_t pending_bytes) {
+  if (!txn_db_impl_->IsTxnMemoryCharged()) {
+    return Status::OK();
+  }
+  const size_t usage =
+      GetWriteBatch()->ApproximateMemoryUsage() +
+      static_cast<size_t>(tracked_locks_->GetNumPointLocks()) *
+          sizeof(PointLockRequest) +
+      pending_bytes;
+  return txn_db_impl_->ChargeTxnMemory(&charged_memory_, usage);
 }
 
 void PessimisticTransaction::Reinitialize(
@@ -958,7 +972,12 @@ Status PessimisticTransaction::TryLock(ColumnFamilyHandle* column_family,
                                        bool exclusive, const bool do_validate,
                                        const bool assume_tracked) {
   assert(!assume_tracked || !do_validate);
-  Status s;
+  // Every write goes through here, so the memory it is about to take is
+  // charged here too
+  Status s = ChargeMemory(key.size());
+  if (!s.ok()) {
+    return s;
+  }
   if (UNLIKELY(skip_concurrency_control_)) {
     return s;
   }
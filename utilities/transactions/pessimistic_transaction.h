@@ -148,6 +148,10 @@ class PessimisticTransaction : public TransactionBaseImpl {
 
   Status LockBatch(WriteBatch* batch, LockTracker* keys_to_unlock);
 
+  // Charges the memory of the write batch and the tracked locks, plus
+  // pending_bytes about to be added, see TransactionDBOptions::max_txn_memory
+  Status ChargeMemory(size_t pending_bytes);
+
   Status TryLock(ColumnFamilyHandle* column_family, const Slice& key,
                  bool read_only, bool exclusive, const bool do_validate = true,
                  const bool assume_tracked = false) override;
@@ -208,6 +212,9 @@ class PessimisticTransaction : public TransactionBaseImpl {
   // Refer to TransactionOptions::skip_concurrency_control
   bool skip_concurrency_control_;
 
+  // Memory charged by ChargeMemory()
+  size_t charged_memory_ = 0;
+
   virtual Status ValidateSnapshot(ColumnFamilyHandle* column_family,
                                   const Slice& key,
                                   SequenceNumber* tracked_at_seq);
@@ -35,6 +35,11 @@ PessimisticTransactionDB::PessimisticTransactionDB(
       lock_manager_(NewLockManager(this, txn_db_options)) {
   assert(db_impl_ != nullptr);
   info_log_ = db_impl_->GetDBOptions().info_log;
+  if (txn_db_options_.txn_memory_cache) {
+    txn_cache_res_mgr_ = std::make_shared<ConcurrentCacheReservationManager>(
+        std::make_shared<CacheReservationManagerImpl<CacheEntryRole::kMisc>>(
+            txn_db_options_.txn_memory_cache));
+  }
 }
 
 // Support initiliazing PessimisticTransactionDB from a stackable db
@@ -60,6 +65,11 @@ PessimisticTransactionDB::PessimisticTransactionDB(
       txn_db_options_(txn_db_options),
       lock_manager_(NewLockManager(this, txn_db_options)) {
   assert(db_impl_ != nullptr);
+  if (txn_db_options_.txn_memory_cache) {
+    txn_cache_res_mgr_ = std::make_shared<ConcurrentCacheReservationManager>(
+        std::make_shared<CacheReservationManagerImpl<CacheEntryRole::kMisc>>(
+            txn_db_options_.txn_memory_cache));
+  }
 }
 
 PessimisticTransactionDB::~PessimisticTransactionDB() {
@@ -479,6 +489,45 @@ void PessimisticTransactionDB::UnLock(PessimisticTransaction* txn,
   lock_manager_->UnLock(txn, cfh_id, key, GetEnv());
 }
 
+Status PessimisticTransactionDB::ChargeTxnMemory(size_t* charged,
+                                                 size_t new_charge) {
+  if (new_charge == *charged) {
+    return Status::OK();
+  }
+  if (new_charge < *charged) {
+    const size_t delta = *charged - new_charge;
+    txn_memory_usage_.fetch_sub(delta, std::memory_order_relaxed);
+    if (txn_cache_res_mgr_) {
+      txn_cache_res_mgr_->UpdateCacheReservation(delta, /*increase=*/false)
+          .PermitUncheckedError();
+    }
+    *charged = new_charge;
+    return Status::OK();
+  }
+  const size_t delta = new_charge - *charged;
+  const size_t limit = txn_db_options_.max_txn_memory;
+  const size_t usage =
+      txn_memory_usage_.fetch_add(delta, std::memory_order_relaxed) + delta;
+  if (limit > 0 && usage > limit) {
+    txn_memory_usage_.fetch_sub(delta, std::memory_order_relaxed);
+    return Status::MemoryLimit("Transactions use more than max_txn_memory");
+  }
+  if (txn_cache_res_mgr_) {
+    Status s =
+        txn_cache_res_mgr_->UpdateCacheReservation(delta, /*increase=*/true);
+    if (!s.ok()) {
+      // Give back what was reserved before the cache filled up
+      txn_cache_res_mgr_->UpdateCacheReservation(delta, /*increase=*/false)
+          .PermitUncheckedError();
+      txn_memory_usage_.fetch_sub(delta, std::memory_order_relaxed);
+      return Status::MemoryLimit("No room in txn_memory_cache: " +
+                                 s.ToString());
+    }
+  }
+  *charged = new_charge;
+  return Status::OK();
+}
+
 // Used when wrapping DB write operations in a transaction
 Transaction* PessimisticTransactionDB::BeginInternalTransaction(
     const WriteOptions& options) {
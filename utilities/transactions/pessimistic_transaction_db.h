@@ -12,6 +12,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "cache/cache_reservation_manager.h"
 #include "db/db_iter.h"
 #include "db/read_callback.h"
 #include "db/snapshot_checker.h"
@@ -126,6 +127,17 @@ class PessimisticTransactionDB : public TransactionDB {
 
   void AddColumnFamily(const ColumnFamilyHandle* handle);
 
+  // Whether the memory of transactions is charged, see
+  // TransactionDBOptions::max_txn_memory and txn_memory_cache
+  bool IsTxnMemoryCharged() const {
+    return txn_db_options_.max_txn_memory > 0 || txn_cache_res_mgr_ != nullptr;
+  }
+
+  // Replaces *charged, the memory charged for a transaction, with new_charge.
+  // Fails with Status::MemoryLimit(), leaving *charged as is, when there is
+  // no room for more.
+  Status ChargeTxnMemory(size_t* charged, size_t new_charge);
+
   static TransactionDBOptions ValidateTxnDBOptions(
       const TransactionDBOptions& txn_db_options);
 
@@ -214,6 +226,10 @@ class PessimisticTransactionDB : public TransactionDB {
 
   std::shared_ptr<LockManager> lock_manager_;
 
+  // Memory charged for all transactions
+  std::atomic<size_t> txn_memory_usage_{0};
+  std::shared_ptr<ConcurrentCacheReservationManager> txn_cache_res_mgr_;
+
   // Must be held when adding/dropping column families.
   InstrumentedMutex column_family_mutex_;
 
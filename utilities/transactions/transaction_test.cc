@@ -3811,6 +3811,56 @@ TEST_P(TransactionTest, LockLimitTest) {
   delete txn2;
 }
 
+TEST_P(TransactionTest, TxnMemoryLimitTest) {
+  WriteOptions write_options;
+  ReadOptions read_options;
+  TransactionOptions txn_options;
+  std::string value;
+
+  delete db;
+  db = nullptr;
+
+  txn_db_options.max_txn_memory = 64 << 10;
+  std::shared_ptr<Cache> cache = NewLRUCache(4 << 20);
+  txn_db_options.txn_memory_cache = cache;
+  ASSERT_OK(ReOpen());
+  ASSERT_NE(db, nullptr);
+
+  // Writes fail once the transaction takes more than max_txn_memory
+  Transaction* txn = db->BeginTransaction(write_options, txn_options);
+  ASSERT_TRUE(txn);
+  const std::string big_value(8 << 10, 'v');
+  Status s;
+  int num_puts = 0;
+  for (; num_puts < 100; ++num_puts) {
+    s = txn->Put("key" + std::to_string(num_puts), big_value);
+    if (!s.ok()) {
+      break;
+    }
+  }
+  ASSERT_TRUE(s.IsMemoryLimit());
+  ASSERT_GT(num_puts, 0);
+  ASSERT_GT(cache->GetUsage(), 0);
+
+  // Across all transactions
+  Transaction* txn2 = db->BeginTransaction(write_options, txn_options);
+  ASSERT_TRUE(txn2);
+  ASSERT_TRUE(txn2->Put("other", big_value).IsMemoryLimit());
+  ASSERT_TRUE(txn2->GetForUpdate(read_options, "other", &value)
+                  .IsMemoryLimit());
+
+  // Committing gives the memory back
+  ASSERT_OK(txn->Commit());
+  delete txn;
+  ASSERT_OK(txn2->Put("other", big_value));
+  ASSERT_OK(txn2->Commit());
+  delete txn2;
+  ASSERT_EQ(cache->GetUsage(), 0);
+
+  ASSERT_OK(db->Get(read_options, "key0", &value));
+  ASSERT_EQ(big_value, value);
+}
+
 TEST_P(TransactionTest, IteratorTest) {
   // This test does writes without snapshot validation, and then tries to create
   // iterator later, which is unsupported in write unprepared.
@@ -748,6 +748,45 @@ TEST_P(WritePreparedTransactionTest, CommitMap) {
   ASSERT_EQ(e4, e);
 }
 
+TEST_P(WritePreparedTransactionTest, AddCommittedRange) {
+  const size_t snapshot_cache_bits = 7;
+  const size_t commit_cache_bits = 3;  // 8 entries
+  UpdateTransactionDBOptions(snapshot_cache_bits, commit_cache_bits);
+  DBImpl* mock_db = new DBImpl(options, dbname);
+  std::unique_ptr<WritePreparedTxnDBMock> wp_db(
+      new WritePreparedTxnDBMock(mock_db, txn_db_options));
+  const size_t size = wp_db->COMMIT_CACHE_SIZE;
+  ASSERT_EQ(8, size);
+
+  CommitEntry64b dont_care;
+  CommitEntry e;
+  wp_db->AddCommittedRange(1000, 3, 1010);
+  for (uint64_t p = 1000; p < 1003; p++) {
+    ASSERT_TRUE(wp_db->GetCommitEntry(p % size, &dont_care, &e));
+    ASSERT_EQ(CommitEntry(p, 1010), e);
+  }
+  ASSERT_EQ(0, wp_db->max_evicted_seq_);
+
+  // Evicts the entries of the first range, advancing the max once
+  wp_db->AddCommittedRange(1000 + size, 3, 1020);
+  for (uint64_t p = 1000 + size; p < 1003 + size; p++) {
+    ASSERT_TRUE(wp_db->GetCommitEntry(p % size, &dont_care, &e));
+    ASSERT_EQ(CommitEntry(p, 1020), e);
+  }
+  ASSERT_EQ(1010, wp_db->max_evicted_seq_);
+  ASSERT_TRUE(wp_db->IsInSnapshot(1001, 1015));
+  ASSERT_FALSE(wp_db->IsInSnapshot(1001 + size, 1015));
+  ASSERT_TRUE(wp_db->IsInSnapshot(1001 + size, 1020));
+
+  // A range larger than the cache leaves its last entries
+  wp_db->AddCommittedRange(2000, size + 2, 2020);
+  for (uint64_t p = 2002; p < 2002 + size; p++) {
+    ASSERT_TRUE(wp_db->GetCommitEntry(p % size, &dont_care, &e));
+    ASSERT_EQ(CommitEntry(p, 2020), e);
+  }
+  ASSERT_EQ(2020, wp_db->max_evicted_seq_);
+}
+
 TEST_P(WritePreparedTransactionTest, MaybeUpdateOldCommitMap) {
   // If prepare <= snapshot < commit we should keep the entry around since its
   // nonexistence could be interpreted as committed in the snapshot while it is
@@ -567,51 +567,7 @@ void WritePreparedTxnDB::AddCommitted(uint64_t prepare_seq, uint64_t commit_seq,
   bool to_be_evicted = GetCommitEntry(indexed_seq, &evicted_64b, &evicted);
   if (LIKELY(to_be_evicted)) {
     assert(evicted.prep_seq != prepare_seq);
-    auto prev_max = max_evicted_seq_.load(std::memory_order_acquire);
-    ROCKS_LOG_DETAILS(info_log_,
-                      "Evicting %" PRIu64 ",%" PRIu64 " with max %" PRIu64,
-                      evicted.prep_seq, evicted.commit_seq, prev_max);
-    if (prev_max < evicted.commit_seq) {
-      auto last = db_impl_->GetLastPublishedSequence();  // could be 0
-      SequenceNumber max_evicted_seq;
-      if (LIKELY(evicted.commit_seq < last)) {
-        assert(last > 0);
-        // Inc max in larger steps to avoid frequent updates
-        max_evicted_seq =
-            std::min(evicted.commit_seq + INC_STEP_FOR_MAX_EVICTED, last - 1);
-      } else {
-        // legit when a commit entry in a write batch overwrite the previous one
-        max_evicted_seq = evicted.commit_seq;
-      }
-#ifdef OS_LINUX
-      if (rocksdb_write_prepared_TEST_ShouldClearCommitCache &&
-          rocksdb_write_prepared_TEST_ShouldClearCommitCache()) {
-        max_evicted_seq = last;
-      }
-#endif  // OS_LINUX
-      ROCKS_LOG_DETAILS(info_log_,
-                        "%lu Evicting %" PRIu64 ",%" PRIu64 " with max %" PRIu64
-                        " => %lu",
-                        prepare_seq, evicted.prep_seq, evicted.commit_seq,
-                        prev_max, max_evicted_seq);
-      AdvanceMaxEvictedSeq(prev_max, max_evicted_seq);
-    }
-    if (UNLIKELY(!delayed_prepared_empty_.load(std::memory_order_acquire))) {
-      WriteLock wl(&prepared_mutex_);
-      auto dp_iter = delayed_prepared_.find(evicted.prep_seq);
-      if (dp_iter != delayed_prepared_.end()) {
-        // This is a rare case that txn is committed but prepared_txns_ is not
-        // cleaned up yet. Refer to delayed_prepared_commits_ definition for
-        // why it should be kept updated.
-        delayed_prepared_commits_[evicted.prep_seq] = evicted.commit_seq;
-        ROCKS_LOG_DEBUG(info_log_,
-                        "delayed_prepared_commits_[%" PRIu64 "]=%" PRIu64,
-                        evicted.prep_seq, evicted.commit_seq);
-      }
-    }
-    // After each eviction from commit cache, check if the commit entry should
-    // be kept around because it overlaps with a live snapshot.
-    CheckAgainstSnapshots(evicted);
+    HandleEvictedCommitEntries(&evicted, 1);
   }
   bool succ =
       ExchangeCommitEntry(indexed_seq, evicted_64b, {prepare_seq, commit_seq});
@@ -632,6 +588,106 @@ void WritePreparedTxnDB::AddCommitted(uint64_t prepare_seq, uint64_t commit_seq,
   TEST_SYNC_POINT("WritePreparedTxnDB::AddCommitted:end:pause");
 }
 
+void WritePreparedTxnDB::AddCommittedRange(uint64_t prepare_seq, size_t cnt,
+                                           uint64_t commit_seq) {
+  if (cnt == 1 || cnt > COMMIT_CACHE_SIZE) {
+    // Nothing to batch, or the entries of the range evict each other
+    for (size_t i = 0; i < cnt; i++) {
+      AddCommitted(prepare_seq + i, commit_seq);
+    }
+    return;
+  }
+  for (size_t i = 0; i < cnt; i++) {
+    PREFETCH(&commit_cache_[static_cast<size_t>((prepare_seq + i) %
+                                                COMMIT_CACHE_SIZE)],
+             1, 1);
+  }
+  std::vector<CommitEntry64b> entries_64b(cnt);
+  std::vector<CommitEntry> evicted;
+  evicted.reserve(cnt);
+  for (size_t i = 0; i < cnt; i++) {
+    CommitEntry entry;
+    if (GetCommitEntry((prepare_seq + i) % COMMIT_CACHE_SIZE, &entries_64b[i],
+                       &entry)) {
+      assert(entry.prep_seq != prepare_seq + i);
+      evicted.push_back(entry);
+    }
+  }
+  if (!evicted.empty()) {
+    HandleEvictedCommitEntries(evicted.data(), evicted.size());
+  }
+  for (size_t i = 0; i < cnt; i++) {
+    const uint64_t indexed_seq = (prepare_seq + i) % COMMIT_CACHE_SIZE;
+    if (UNLIKELY(!ExchangeCommitEntry(indexed_seq, entries_64b[i],
+                                      {prepare_seq + i, commit_seq}))) {
+      // A very rare event, in which the commit entry is updated before we do.
+      // It is retried alone.
+      ROCKS_LOG_ERROR(info_log_,
+                      "ExchangeCommitEntry failed on [%" PRIu64 "] %" PRIu64
+                      ",%" PRIu64 " retrying...",
+                      indexed_seq, prepare_seq + i, commit_seq);
+      AddCommitted(prepare_seq + i, commit_seq, 1);
+    }
+  }
+}
+
+void WritePreparedTxnDB::HandleEvictedCommitEntries(const CommitEntry* evicted,
+                                                    size_t cnt) {
+  SequenceNumber max_commit_seq = 0;
+  for (size_t i = 0; i < cnt; i++) {
+    max_commit_seq = std::max(max_commit_seq, evicted[i].commit_seq);
+  }
+  auto prev_max = max_evicted_seq_.load(std::memory_order_acquire);
+  ROCKS_LOG_DETAILS(info_log_,
+                    "Evicting %" ROCKSDB_PRIszt " entries up to %" PRIu64
+                    " with max %" PRIu64,
+                    cnt, max_commit_seq, prev_max);
+  if (prev_max < max_commit_seq) {
+    auto last = db_impl_->GetLastPublishedSequence();  // could be 0
+    SequenceNumber max_evicted_seq;
+    if (LIKELY(max_commit_seq < last)) {
+      assert(last > 0);
+      // Inc max in larger steps to avoid frequent updates
+      max_evicted_seq =
+          std::min(max_commit_seq + INC_STEP_FOR_MAX_EVICTED, last - 1);
+    } else {
+      // legit when a commit entry in a write batch overwrite the previous one
+      max_evicted_seq = max_commit_seq;
+    }
+#ifdef OS_LINUX
+    if (rocksdb_write_prepared_TEST_ShouldClearCommitCache &&
+        rocksdb_write_prepared_TEST_ShouldClearCommitCache()) {
+      max_evicted_seq = last;
+    }
+#endif  // OS_LINUX
+    ROCKS_LOG_DETAILS(info_log_,
+                      "Evicting up to %" PRIu64 " with max %" PRIu64
+                      " => %" PRIu64,
+                      max_commit_seq, prev_max, max_evicted_seq);
+    AdvanceMaxEvictedSeq(prev_max, max_evicted_seq);
+  }
+  if (UNLIKELY(!delayed_prepared_empty_.load(std::memory_order_acquire))) {
+    WriteLock wl(&prepared_mutex_);
+    for (size_t i = 0; i < cnt; i++) {
+      auto dp_iter = delayed_prepared_.find(evicted[i].prep_seq);
+      if (dp_iter != delayed_prepared_.end()) {
+        // This is a rare case that txn is committed but prepared_txns_ is not
+        // cleaned up yet. Refer to delayed_prepared_commits_ definition for
+        // why it should be kept updated.
+        delayed_prepared_commits_[evicted[i].prep_seq] = evicted[i].commit_seq;
+        ROCKS_LOG_DEBUG(info_log_,
+                        "delayed_prepared_commits_[%" PRIu64 "]=%" PRIu64,
+                        evicted[i].prep_seq, evicted[i].commit_seq);
+      }
+    }
+  }
+  // After each eviction from commit cache, check if the commit entry should
+  // be kept around because it overlaps with a live snapshot.
+  for (size_t i = 0; i < cnt; i++) {
+    CheckAgainstSnapshots(evicted[i]);
+  }
+}
+
 void WritePreparedTxnDB::RemovePrepared(const uint64_t prepare_seq,
                                         const size_t batch_cnt) {
   TEST_SYNC_POINT_CALLBACK(
@@ -158,6 +158,9 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
     SequenceNumber max_evicted_seq_lb, max_evicted_seq_ub;
     CommitEntry64b dont_care;
     auto indexed_seq = prep_seq % COMMIT_CACHE_SIZE;
+    // The entry is likely not in the cpu cache, so its load starts before
+    // the ones of max_evicted_seq_ and delayed_prepared_empty_
+    PREFETCH(&commit_cache_[static_cast<size_t>(indexed_seq)], 0, 1);
     size_t repeats = 0;
     do {
       repeats++;
@@ -336,6 +339,13 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   // Note: must be called serially.
   void AddCommitted(uint64_t prepare_seq, uint64_t commit_seq,
                     uint8_t loop_cnt = 0);
+  // Same as AddCommitted() for each of the cnt sub-batches prepared from
+  // prepare_seq on, but with the commit cache entries they evict handled
+  // together: max_evicted_seq_ is advanced and prepared_mutex_ is taken at
+  // most once for all of them.
+  // Note: must be called serially.
+  void AddCommittedRange(uint64_t prepare_seq, size_t cnt,
+                         uint64_t commit_seq);
 
   struct CommitEntry {
     uint64_t prep_seq;
@@ -493,6 +503,7 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   friend class WritePreparedTransactionTest_CheckAgainstSnapshots_Test;
   friend class WritePreparedTransactionTest_CleanupSnapshotEqualToMax_Test;
   friend class WritePreparedTransactionTest_ConflictDetectionAfterRecovery_Test;
+  friend class WritePreparedTransactionTest_AddCommittedRange_Test;
   friend class WritePreparedTransactionTest_CommitMap_Test;
   friend class WritePreparedTransactionTest_DoubleSnapshot_Test;
   friend class WritePreparedTransactionTest_IsInSnapshotEmptyMap_Test;
@@ -650,6 +661,12 @@ class WritePreparedTxnDB : public PessimisticTransactionDB {
   void AdvanceMaxEvictedSeq(const SequenceNumber& prev_max,
                             const SequenceNumber& new_max);
 
+  // Takes care of the entries evicted from the commit cache to make room for
+  // new commits, before the new commits replace them: max_evicted_seq_ is
+  // advanced past their commit seqs, and they are kept in
+  // delayed_prepared_commits_ or old_commit_map_ when still needed.
+  void HandleEvictedCommitEntries(const CommitEntry* evicted, size_t cnt);
+
   inline SequenceNumber SmallestUnCommittedSeq() {
     // Note: We have two lists to look into, but for performance reasons they
     // are not read atomically. Since CheckPreparedAgainstMax copies the entry
@@ -960,24 +977,18 @@ class WritePreparedCommitEntryPreReleaseCallback : public PreReleaseCallback {
                                          ? commit_seq
                                          : commit_seq + data_batch_cnt_ - 1;
     if (prep_seq_ != kMaxSequenceNumber) {
-      for (size_t i = 0; i < prep_batch_cnt_; i++) {
-        db_->AddCommitted(prep_seq_ + i, last_commit_seq);
-      }
+      db_->AddCommittedRange(prep_seq_, prep_batch_cnt_, last_commit_seq);
     }  // else there was no prepare phase
     if (includes_aux_batch_) {
-      for (size_t i = 0; i < aux_batch_cnt_; i++) {
-        db_->AddCommitted(aux_seq_ + i, last_commit_seq);
-      }
+      db_->AddCommittedRange(aux_seq_, aux_batch_cnt_, last_commit_seq);
     }
     if (includes_data_) {
       assert(data_batch_cnt_);
-      // Commit the data that is accompanied with the commit request
-      for (size_t i = 0; i < data_batch_cnt_; i++) {
-        // For commit seq of each batch use the commit seq of the last batch.
-        // This would make debugging easier by having all the batches having
-        // the same sequence number.
-        db_->AddCommitted(commit_seq + i, last_commit_seq);
-      }
+      // Commit the data that is accompanied with the commit request. For
+      // commit seq of each batch use the commit seq of the last batch. This
+      // would make debugging easier by having all the batches having the same
+      // sequence number.
+      db_->AddCommittedRange(commit_seq, data_batch_cnt_, last_commit_seq);
     }
     if (db_impl_->immutable_db_options().two_write_queues) {
       assert(is_mem_disabled);  // implies the 2nd queue
@@ -1048,9 +1059,7 @@ class WritePreparedRollbackPreReleaseCallback : public PreReleaseCallback {
 #endif
     const uint64_t last_commit_seq = commit_seq;
     db_->AddCommitted(rollback_seq_, last_commit_seq);
-    for (size_t i = 0; i < prep_batch_cnt_; i++) {
-      db_->AddCommitted(prep_seq_ + i, last_commit_seq);
-    }
+    db_->AddCommittedRange(prep_seq_, prep_batch_cnt_, last_commit_seq);
     db_impl_->SetLastPublishedSequence(last_commit_seq);
     return Status::OK();
   }
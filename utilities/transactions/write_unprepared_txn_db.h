@@ -63,20 +63,16 @@ class WriteUnpreparedCommitEntryPreReleaseCallback : public PreReleaseCallback {
                                          : commit_seq + data_batch_cnt_ - 1;
     // Recall that unprep_seqs maps (un)prepared_seq => prepare_batch_cnt.
     for (const auto& s : unprep_seqs_) {
-      for (size_t i = 0; i < s.second; i++) {
-        db_->AddCommitted(s.first + i, last_commit_seq);
-      }
+      db_->AddCommittedRange(s.first, s.second, last_commit_seq);
     }
 
     if (includes_data_) {
       assert(data_batch_cnt_);
-      // Commit the data that is accompanied with the commit request
-      for (size_t i = 0; i < data_batch_cnt_; i++) {
-        // For commit seq of each batch use the commit seq of the last batch.
-        // This would make debugging easier by having all the batches having
-        // the same sequence number.
-        db_->AddCommitted(commit_seq + i, last_commit_seq);
-      }
+      // Commit the data that is accompanied with the commit request. For
+      // commit seq of each batch use the commit seq of the last batch. This
+      // would make debugging easier by having all the batches having the same
+      // sequence number.
+      db_->AddCommittedRange(commit_seq, data_batch_cnt_, last_commit_seq);
     }
     if (db_impl_->immutable_db_options().two_write_queues && publish_seq_) {
       assert(is_mem_disabled);  // implies the 2nd queue
@@ -5,6 +5,8 @@
 
 #include "utilities/ttl/db_ttl_impl.h"
 
+#include <algorithm>
+
 #include "db/write_batch_internal.h"
 #include "file/filename.h"
 #include "logging/logging.h"
@@ -16,6 +18,7 @@
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/options_type.h"
 #include "util/coding.h"
+#include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
 static std::unordered_map<std::string, OptionTypeInfo> ttl_merge_op_type_info =
@@ -170,6 +173,57 @@ void DBWithTTLImpl::SanitizeOptions(int32_t ttl, ColumnFamilyOptions* options,
     options->merge_operator.reset(
         new TtlMergeOperator(options->merge_operator, clock));
   }
+
+  options->table_properties_collector_factories.push_back(
+      std::make_shared<TtlTablePropertiesCollectorFactory>());
+}
+
+const std::string DBWithTTLImpl::kNewestTimestampProperty =
+    "rocksdb.ttl.newest.timestamp";
+
+Status TtlTablePropertiesCollector::AddUserKey(const Slice& /*key*/,
+                                               const Slice& value,
+                                               EntryType type,
+                                               SequenceNumber /*seq*/,
+                                               uint64_t /*file_size*/) {
+  switch (type) {
+    case kEntryPut:
+    case kEntryMerge:
+      if (value.size() < DBWithTTLImpl::kTSLength) {
+        has_unknown_entry_ = true;
+      } else {
+        int32_t timestamp = static_cast<int32_t>(DecodeFixed32(
+            value.data() + value.size() - DBWithTTLImpl::kTSLength));
+        if (!has_value_ || timestamp > newest_timestamp_) {
+          newest_timestamp_ = timestamp;
+        }
+        has_value_ = true;
+      }
+      break;
+    case kEntryDelete:
+    case kEntrySingleDelete:
+    case kEntryRangeDeletion:
+      break;
+    default:
+      has_unknown_entry_ = true;
+      break;
+  }
+  return Status::OK();
+}
+
+Status TtlTablePropertiesCollector::Finish(
+    UserCollectedProperties* properties) {
+  *properties = GetReadableProperties();
+  return Status::OK();
+}
+
+UserCollectedProperties TtlTablePropertiesCollector::GetReadableProperties()
+    const {
+  if (!has_value_ || has_unknown_entry_) {
+    return {};
+  }
+  return {{DBWithTTLImpl::kNewestTimestampProperty,
+           std::to_string(newest_timestamp_)}};
 }
 
 static std::unordered_map<std::string, OptionTypeInfo> ttl_type_info = {
@@ -302,6 +356,14 @@ int RegisterTtlObjects(ObjectLibrary& library, const std::string& /*arg*/) {
          std::string* /* errmsg */) {
         return new TtlCompactionFilter(0, nullptr, nullptr);
       });
+  library.AddFactory<TablePropertiesCollectorFactory>(
+      TtlTablePropertiesCollectorFactory::kClassName(),
+      [](const std::string& /*uri*/,
+         std::unique_ptr<TablePropertiesCollectorFactory>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new TtlTablePropertiesCollectorFactory());
+        return guard->get();
+      });
   size_t num_types;
   return static_cast<int>(library.GetFactoryCount(&num_types));
 }
@@ -610,6 +672,106 @@ Iterator* DBWithTTLImpl::NewIterator(const ReadOptions& _read_options,
   return new TtlIterator(db_->NewIterator(read_options, column_family));
 }
 
+int32_t DBWithTTLImpl::GetTtl(ColumnFamilyHandle* column_family) {
+  Options opts = GetOptions(column_family);
+  if (opts.compaction_filter != nullptr) {
+    auto filter = opts.compaction_filter->CheckedCast<TtlCompactionFilter>();
+    if (filter != nullptr) {
+      return filter->GetTtl();
+    }
+  }
+  if (opts.compaction_filter_factory != nullptr) {
+    auto factory = opts.compaction_filter_factory
+                       ->CheckedCast<TtlCompactionFilterFactory>();
+    if (factory != nullptr) {
+      return factory->GetTtl();
+    }
+  }
+  return 0;
+}
+
+Status DBWithTTLImpl::DeleteExpiredFiles(ColumnFamilyHandle* column_family) {
+  const int32_t ttl = GetTtl(column_family);
+  if (ttl <= 0) {
+    return Status::OK();
+  }
+  int64_t curtime;
+  Status s = GetEnv()->GetSystemClock()->GetCurrentTime(&curtime);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // Only the files of the last non-empty level can be deleted, as with
+  // DB::DeleteFile(), so that no deletion is lost
+  ColumnFamilyMetaData cf_meta;
+  GetColumnFamilyMetaData(column_family, &cf_meta);
+  const LevelMetaData* last_level = nullptr;
+  for (auto it = cf_meta.levels.rbegin(); it != cf_meta.levels.rend(); ++it) {
+    if (!it->files.empty()) {
+      last_level = &*it;
+      break;
+    }
+  }
+  if (last_level == nullptr) {
+    return Status::OK();
+  }
+
+  TablePropertiesCollection props;
+  s = GetPropertiesOfAllTables(column_family, &props);
+  if (!s.ok()) {
+    return s;
+  }
+  std::unordered_map<uint64_t, uint64_t> newest_timestamps;
+  for (const auto& file_props : props) {
+    const std::string& path = file_props.first;
+    uint64_t number;
+    FileType type;
+    if (!ParseFileName(path.substr(path.rfind('/') + 1), &number, &type)) {
+      continue;
+    }
+    const auto& user_props = file_props.second->user_collected_properties;
+    auto newest = user_props.find(kNewestTimestampProperty);
+    if (newest == user_props.end()) {
+      continue;
+    }
+    Slice input(newest->second);
+    uint64_t timestamp;
+    if (ConsumeDecimalNumber(&input, &timestamp) && input.empty()) {
+      newest_timestamps[number] = timestamp;
+    }
+  }
+
+  // Level 0 files are ordered from the newest, and can only be deleted from
+  // the oldest
+  std::vector<SstFileMetaData> files = last_level->files;
+  if (last_level->level == 0) {
+    std::reverse(files.begin(), files.end());
+  }
+  for (const auto& file : files) {
+    auto newest = newest_timestamps.find(file.file_number);
+    const bool expired =
+        newest != newest_timestamps.end() &&
+        static_cast<int64_t>(newest->second) + ttl < curtime;
+    if (!expired) {
+      if (last_level->level == 0) {
+        break;
+      }
+      continue;
+    }
+    s = DeleteFile(file.relative_filename);
+    if (s.IsInvalidArgument()) {
+      // The file was compacted in the meantime
+      s = Status::OK();
+      if (last_level->level == 0) {
+        break;
+      }
+    } else if (!s.ok()) {
+      return s;
+    }
+  }
+  return s;
+}
+
 void DBWithTTLImpl::SetTtl(ColumnFamilyHandle* h, int32_t ttl) {
   std::shared_ptr<TtlCompactionFilterFactory> filter;
   Options opts;
@@ -14,6 +14,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/system_clock.h"
+#include "rocksdb/table_properties.h"
 #include "rocksdb/utilities/db_ttl.h"
 #include "utilities/compaction_filters/layered_compaction_filter_base.h"
 
@@ -106,7 +107,17 @@ class DBWithTTLImpl : public DBWithTTL {
 
   void SetTtl(ColumnFamilyHandle* h, int32_t ttl) override;
 
+  using DBWithTTL::DeleteExpiredFiles;
+  Status DeleteExpiredFiles(ColumnFamilyHandle* column_family) override;
+
+  // The table property with the newest timestamp of the values of a file, in
+  // decimal
+  static const std::string kNewestTimestampProperty;
+
  private:
+  // Returns the TTL of the column family, non-positive if there is none
+  int32_t GetTtl(ColumnFamilyHandle* column_family);
+
   // remember whether the Close completes or not
   bool closed_;
 };
@@ -171,6 +182,7 @@ class TtlCompactionFilter : public LayeredCompactionFilterBase {
       return LayeredCompactionFilterBase::IsInstanceOf(name);
     }
   }
+  int32_t GetTtl() const { return ttl_; }
 
   Status PrepareOptions(const ConfigOptions& config_options) override;
   Status ValidateOptions(const DBOptions& db_opts,
@@ -190,6 +202,7 @@ class TtlCompactionFilterFactory : public CompactionFilterFactory {
   std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) override;
   void SetTtl(int32_t ttl) { ttl_ = ttl; }
+  int32_t GetTtl() const { return ttl_; }
 
   const char* Name() const override { return kClassName(); }
   static const char* kClassName() { return "TtlCompactionFilterFactory"; }
@@ -206,6 +219,40 @@ class TtlCompactionFilterFactory : public CompactionFilterFactory {
   std::shared_ptr<CompactionFilterFactory> user_comp_filter_factory_;
 };
 
+// Records the newest timestamp of the values of a table file, so that
+// DBWithTTLImpl::DeleteExpiredFiles() can tell whether all of them expired
+class TtlTablePropertiesCollector : public TablePropertiesCollector {
+ public:
+  Status AddUserKey(const Slice& key, const Slice& value, EntryType type,
+                    SequenceNumber seq, uint64_t file_size) override;
+
+  Status Finish(UserCollectedProperties* properties) override;
+
+  UserCollectedProperties GetReadableProperties() const override;
+
+  const char* Name() const override { return "TtlTablePropertiesCollector"; }
+
+ private:
+  int32_t newest_timestamp_ = 0;
+  bool has_value_ = false;
+  // An entry whose time of write is unknown was added
+  bool has_unknown_entry_ = false;
+};
+
+class TtlTablePropertiesCollectorFactory
+    : public TablePropertiesCollectorFactory {
+ public:
+  TablePropertiesCollector* CreateTablePropertiesCollector(
+      TablePropertiesCollectorFactory::Context /*context*/) override {
+    return new TtlTablePropertiesCollector();
+  }
+
+  static const char* kClassName() {
+    return "TtlTablePropertiesCollectorFactory";
+  }
+  const char* Name() const override { return kClassName(); }
+};
+
 class TtlMergeOperator : public MergeOperator {
  public:
   explicit TtlMergeOperator(const std::shared_ptr<MergeOperator>& merge_op,
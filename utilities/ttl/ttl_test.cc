@@ -727,6 +727,32 @@ TEST_F(TtlTest, ChangeTtlOnOpenDb) {
   CloseTtl();
 }
 
+TEST_F(TtlTest, DeleteExpiredFiles) {
+  MakeKVMap(kSampleSize_);
+
+  OpenTtl(2);                  // T=0:Open the db with ttl = 2
+  PutValues(0, kSampleSize_);  // T=0:Insert Set1. Delete at t=3
+  ASSERT_OK(ManualCompact());
+  auto num_files = [&]() {
+    std::vector<LiveFileMetaData> files;
+    db_ttl_->GetLiveFilesMetaData(&files);
+    return files.size();
+  };
+  const size_t num_files_before = num_files();
+  ASSERT_GT(num_files_before, 0);
+
+  env_->Sleep(1);  // T=1:Set1 has not expired
+  ASSERT_OK(db_ttl_->DeleteExpiredFiles(db_ttl_->DefaultColumnFamily()));
+  ASSERT_EQ(num_files_before, num_files());
+  CompactCheck(0, kSampleSize_, true);
+
+  env_->Sleep(2);  // T=3:Set1 is dropped without a compaction
+  ASSERT_OK(db_ttl_->DeleteExpiredFiles(db_ttl_->DefaultColumnFamily()));
+  ASSERT_EQ(0, num_files());
+  CompactCheck(0, kSampleSize_, false);
+  CloseTtl();
+}
+
 // Test DeleteRange for DBWithTtl
 TEST_F(TtlTest, DeleteRangeTest) {
   OpenTtl();
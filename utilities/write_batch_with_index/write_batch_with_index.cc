@@ -5,6 +5,7 @@
 
 #include "rocksdb/utilities/write_batch_with_index.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -27,12 +28,13 @@ namespace ROCKSDB_NAMESPACE {
 struct WriteBatchWithIndex::Rep {
   explicit Rep(const Comparator* index_comparator, size_t reserved_bytes = 0,
                size_t max_bytes = 0, bool _overwrite_key = false,
-               size_t protection_bytes_per_key = 0)
+               size_t protection_bytes_per_key = 0, bool _defer_index = false)
       : write_batch(reserved_bytes, max_bytes, protection_bytes_per_key,
                     index_comparator ? index_comparator->timestamp_size() : 0),
         comparator(index_comparator, &write_batch),
         skip_list(comparator, &arena),
         overwrite_key(_overwrite_key),
+        defer_index(_defer_index),
         last_entry_offset(0),
         last_sub_batch_offset(0),
         sub_batch_cnt(1) {}
@@ -41,6 +43,7 @@ struct WriteBatchWithIndex::Rep {
   Arena arena;
   WriteBatchEntrySkipList skip_list;
   bool overwrite_key;
+  bool defer_index;
   size_t last_entry_offset;
   // The starting offset of the last sub-batch. A sub-batch starts right before
   // inserting a key that is a duplicate of a key in the last sub-batch. Zero,
@@ -49,10 +52,23 @@ struct WriteBatchWithIndex::Rep {
   // Total number of sub-batches in the write batch. Default is 1.
   size_t sub_batch_cnt;
 
+  struct PendingEntry {
+    WriteBatchIndexEntry entry;
+    WriteType type;
+  };
+  // With defer_index, the index entries of the writes not in skip_list yet,
+  // in the order of the writes
+  std::vector<PendingEntry> pending;
+
   // Remember current offset of internal write batch, which is used as
   // the starting offset of the next record.
   void SetLastEntryOffset() { last_entry_offset = write_batch.GetDataSize(); }
 
+  // Returns the last index entry of the key in skip_list, nullptr if there is
+  // none
+  WriteBatchIndexEntry* FindLastEntry(uint32_t column_family_id,
+                                      const Slice& key);
+
   // In overwrite mode, find the existing entry for the same key and update it
   // to point to the current entry.
   // Return true if the key is found and updated.
@@ -71,6 +87,13 @@ struct WriteBatchWithIndex::Rep {
   // put it to skip list.
   void AddNewEntry(uint32_t column_family_id);
 
+  // Index entry pointing to the last entry in the write batch
+  WriteBatchIndexEntry MakeEntry(uint32_t column_family_id);
+
+  // Adds the pending entries to skip_list, sorted first so that they are
+  // inserted in order. Must be called before skip_list is read.
+  void IndexPendingEntries();
+
   // Clear all updates buffered in this batch.
   void Clear();
   void ClearIndex();
@@ -86,19 +109,15 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntry(
   return UpdateExistingEntryWithCfId(cf_id, key, type);
 }
 
-bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
-    uint32_t column_family_id, const Slice& key, WriteType type) {
-  if (!overwrite_key) {
-    return false;
-  }
-
+WriteBatchIndexEntry* WriteBatchWithIndex::Rep::FindLastEntry(
+    uint32_t column_family_id, const Slice& key) {
   WBWIIteratorImpl iter(column_family_id, &skip_list, &write_batch,
                         &comparator);
   iter.Seek(key);
   if (!iter.Valid()) {
-    return false;
+    return nullptr;
   } else if (!iter.MatchesKey(column_family_id, key)) {
-    return false;
+    return nullptr;
   } else {
     // Move to the end of this key (NextKey-Prev)
     iter.NextKey();  // Move to the next key
@@ -108,8 +127,19 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
       iter.SeekToLast();
     }
   }
-  WriteBatchIndexEntry* non_const_entry =
-      const_cast<WriteBatchIndexEntry*>(iter.GetRawEntry());
+  return const_cast<WriteBatchIndexEntry*>(iter.GetRawEntry());
+}
+
+bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
+    uint32_t column_family_id, const Slice& key, WriteType type) {
+  if (!overwrite_key) {
+    return false;
+  }
+
+  WriteBatchIndexEntry* non_const_entry = FindLastEntry(column_family_id, key);
+  if (non_const_entry == nullptr) {
+    return false;
+  }
   if (LIKELY(last_sub_batch_offset <= non_const_entry->offset)) {
     last_sub_batch_offset = last_entry_offset;
     sub_batch_cnt++;
@@ -124,6 +154,15 @@ bool WriteBatchWithIndex::Rep::UpdateExistingEntryWithCfId(
 
 void WriteBatchWithIndex::Rep::AddOrUpdateIndex(
     ColumnFamilyHandle* column_family, const Slice& key, WriteType type) {
+  if (defer_index) {
+    uint32_t cf_id = GetColumnFamilyID(column_family);
+    const auto* cf_cmp = GetColumnFamilyUserComparator(column_family);
+    if (cf_cmp != nullptr) {
+      comparator.SetComparatorForCF(cf_id, cf_cmp);
+    }
+    pending.push_back({MakeEntry(cf_id), type});
+    return;
+  }
   if (!UpdateExistingEntry(column_family, key, type)) {
     uint32_t cf_id = GetColumnFamilyID(column_family);
     const auto* cf_cmp = GetColumnFamilyUserComparator(column_family);
@@ -136,12 +175,24 @@ void WriteBatchWithIndex::Rep::AddOrUpdateIndex(
 
 void WriteBatchWithIndex::Rep::AddOrUpdateIndex(const Slice& key,
                                                 WriteType type) {
+  if (defer_index) {
+    pending.push_back({MakeEntry(0), type});
+    return;
+  }
   if (!UpdateExistingEntryWithCfId(0, key, type)) {
     AddNewEntry(0);
   }
 }
 
 void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id) {
+  auto* mem = arena.Allocate(sizeof(WriteBatchIndexEntry));
+  auto* index_entry =
+      new (mem) WriteBatchIndexEntry(MakeEntry(column_family_id));
+  skip_list.Insert(index_entry);
+}
+
+WriteBatchIndexEntry WriteBatchWithIndex::Rep::MakeEntry(
+    uint32_t column_family_id) {
   const std::string& wb_data = write_batch.Data();
   Slice entry_ptr = Slice(wb_data.data() + last_entry_offset,
                           wb_data.size() - last_entry_offset);
@@ -161,11 +212,70 @@ void WriteBatchWithIndex::Rep::AddNewEntry(uint32_t column_family_id) {
     key.remove_suffix(ts_sz);
   }
 
-  auto* mem = arena.Allocate(sizeof(WriteBatchIndexEntry));
-  auto* index_entry =
-      new (mem) WriteBatchIndexEntry(last_entry_offset, column_family_id,
-                                     key.data() - wb_data.data(), key.size());
-  skip_list.Insert(index_entry);
+  return WriteBatchIndexEntry(last_entry_offset, column_family_id,
+                              key.data() - wb_data.data(), key.size());
+}
+
+void WriteBatchWithIndex::Rep::IndexPendingEntries() {
+  if (pending.empty()) {
+    return;
+  }
+  // Offsets are unique, so the entries of a key stay in the order of the
+  // writes
+  std::vector<size_t> order(pending.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return comparator(&pending[a].entry, &pending[b].entry) < 0;
+  });
+
+  const char* const wb_data = write_batch.Data().data();
+  auto key_of = [wb_data](const WriteBatchIndexEntry& entry) {
+    return Slice(wb_data + entry.key_offset, entry.key_size);
+  };
+  // In overwrite mode, the offset of the previous write of the same key, for
+  // counting the sub-batches below the way AddOrUpdateIndex() does
+  constexpr size_t kNoPrevWrite = std::numeric_limits<size_t>::max();
+  std::vector<size_t> prev_offsets(pending.size(), kNoPrevWrite);
+  // The last entry of the current key, only tracked in overwrite mode
+  WriteBatchIndexEntry* last = nullptr;
+  for (size_t k = 0; k < order.size(); ++k) {
+    const PendingEntry& p = pending[order[k]];
+    bool same_key = false;
+    if (k > 0) {
+      const WriteBatchIndexEntry& prev = pending[order[k - 1]].entry;
+      same_key = prev.column_family == p.entry.column_family &&
+                 comparator.CompareKey(p.entry.column_family, key_of(prev),
+                                       key_of(p.entry)) == 0;
+    }
+    if (overwrite_key && !same_key) {
+      // The first write of the key since the last indexing
+      last = FindLastEntry(p.entry.column_family, key_of(p.entry));
+    }
+    if (last != nullptr) {
+      prev_offsets[order[k]] = last->offset;
+    }
+    if (last != nullptr && p.type != kMergeRecord) {
+      last->offset = p.entry.offset;
+    } else {
+      auto* mem = arena.Allocate(sizeof(WriteBatchIndexEntry));
+      auto* index_entry = new (mem) WriteBatchIndexEntry(p.entry);
+      skip_list.Insert(index_entry);
+      if (overwrite_key) {
+        last = index_entry;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < pending.size(); ++i) {
+    if (prev_offsets[i] != kNoPrevWrite &&
+        last_sub_batch_offset <= prev_offsets[i]) {
+      last_sub_batch_offset = pending[i].entry.offset;
+      sub_batch_cnt++;
+    }
+  }
+  pending.clear();
 }
 
 void WriteBatchWithIndex::Rep::Clear() {
@@ -174,6 +284,7 @@ void WriteBatchWithIndex::Rep::Clear() {
 }
 
 void WriteBatchWithIndex::Rep::ClearIndex() {
+  pending.clear();
   skip_list.~WriteBatchEntrySkipList();
   arena.~Arena();
   new (&arena) Arena();
@@ -279,9 +390,10 @@ Status WriteBatchWithIndex::Rep::ReBuildIndex() {
 
 WriteBatchWithIndex::WriteBatchWithIndex(
     const Comparator* default_index_comparator, size_t reserved_bytes,
-    bool overwrite_key, size_t max_bytes, size_t protection_bytes_per_key)
+    bool overwrite_key, size_t max_bytes, size_t protection_bytes_per_key,
+    bool defer_index)
     : rep(new Rep(default_index_comparator, reserved_bytes, max_bytes,
-                  overwrite_key, protection_bytes_per_key)) {}
+                  overwrite_key, protection_bytes_per_key, defer_index)) {}
 
 WriteBatchWithIndex::~WriteBatchWithIndex() {}
 
@@ -292,15 +404,20 @@ WriteBatchWithIndex& WriteBatchWithIndex::operator=(WriteBatchWithIndex&&) =
 
 WriteBatch* WriteBatchWithIndex::GetWriteBatch() { return &rep->write_batch; }
 
-size_t WriteBatchWithIndex::SubBatchCnt() { return rep->sub_batch_cnt; }
+size_t WriteBatchWithIndex::SubBatchCnt() {
+  rep->IndexPendingEntries();
+  return rep->sub_batch_cnt;
+}
 
 WBWIIterator* WriteBatchWithIndex::NewIterator() {
+  rep->IndexPendingEntries();
   return new WBWIIteratorImpl(0, &(rep->skip_list), &rep->write_batch,
                               &(rep->comparator));
 }
 
 WBWIIterator* WriteBatchWithIndex::NewIterator(
     ColumnFamilyHandle* column_family) {
+  rep->IndexPendingEntries();
   return new WBWIIteratorImpl(GetColumnFamilyID(column_family),
                               &(rep->skip_list), &rep->write_batch,
                               &(rep->comparator));
@@ -309,6 +426,7 @@ WBWIIterator* WriteBatchWithIndex::NewIterator(
 Iterator* WriteBatchWithIndex::NewIteratorWithBase(
     ColumnFamilyHandle* column_family, Iterator* base_iterator,
     const ReadOptions* read_options) {
+  rep->IndexPendingEntries();
   WBWIIteratorImpl* wbwiii;
   if (read_options != nullptr) {
     wbwiii = new WBWIIteratorImpl(
@@ -326,6 +444,7 @@ Iterator* WriteBatchWithIndex::NewIteratorWithBase(
 }
 
 Iterator* WriteBatchWithIndex::NewIteratorWithBase(Iterator* base_iterator) {
+  rep->IndexPendingEntries();
   // default column family's comparator
   auto wbwiii = new WBWIIteratorImpl(0, &(rep->skip_list), &rep->write_batch,
                                      &rep->comparator);
@@ -794,6 +913,11 @@ size_t WriteBatchWithIndex::GetDataSize() const {
   return rep->write_batch.GetDataSize();
 }
 
+size_t WriteBatchWithIndex::ApproximateMemoryUsage() const {
+  return rep->write_batch.GetDataSize() + rep->arena.MemoryAllocatedBytes() +
+         rep->pending.capacity() * sizeof(Rep::PendingEntry);
+}
+
 const Comparator* WriteBatchWithIndexInternal::GetUserComparator(
     const WriteBatchWithIndex& wbwi, uint32_t cf_id) {
   const WriteBatchEntryComparator& ucmps = wbwi.rep->comparator;
@@ -803,6 +803,67 @@ TEST_P(WriteBatchWithIndexTest, TestWBWIIterator) {
   AssertIterEqual(iter2.get(), {"a", "b", "d", "f"});
 }
 
+TEST_P(WriteBatchWithIndexTest, DeferIndex) {
+  // The same writes to a batch indexing them as they come and to one
+  // indexing them on the next read give the same index
+  WriteBatchWithIndex deferred(BytewiseComparator(), 20, GetParam(), 0, 0,
+                               true /* defer_index */);
+  ColumnFamilyHandleImplDummy cf1(1, BytewiseComparator());
+  auto dump = [&](WriteBatchWithIndex* batch) {
+    std::string result;
+    for (ColumnFamilyHandle* cf : {static_cast<ColumnFamilyHandle*>(nullptr),
+                                   static_cast<ColumnFamilyHandle*>(&cf1)}) {
+      std::unique_ptr<WBWIIterator> iter(cf ? batch->NewIterator(cf)
+                                            : batch->NewIterator());
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        WriteEntry e = iter->Entry();
+        result += std::to_string(e.type) + e.key.ToString() + "=" +
+                  e.value.ToString() + ";";
+      }
+      result += "|";
+    }
+    return result;
+  };
+
+  Random rnd(301);
+  for (int i = 0; i < 1000; ++i) {
+    const std::string key = "k" + std::to_string(rnd.Uniform(20));
+    const std::string value = "v" + std::to_string(i);
+    ColumnFamilyHandle* cf = rnd.OneIn(2) ? &cf1 : nullptr;
+    const uint32_t op = rnd.Uniform(4);
+    for (WriteBatchWithIndex* batch : {batch_.get(), &deferred}) {
+      switch (op) {
+        case 0:
+          ASSERT_OK(cf ? batch->Put(cf, key, value) : batch->Put(key, value));
+          break;
+        case 1:
+          ASSERT_OK(cf ? batch->Merge(cf, key, value)
+                       : batch->Merge(key, value));
+          break;
+        case 2:
+          ASSERT_OK(cf ? batch->Delete(cf, key) : batch->Delete(key));
+          break;
+        default:
+          ASSERT_OK(cf ? batch->SingleDelete(cf, key)
+                       : batch->SingleDelete(key));
+          break;
+      }
+    }
+    if (rnd.OneIn(100)) {
+      ASSERT_EQ(dump(batch_.get()), dump(&deferred));
+    }
+  }
+  ASSERT_EQ(dump(batch_.get()), dump(&deferred));
+  ASSERT_EQ(batch_->SubBatchCnt(), deferred.SubBatchCnt());
+  if (GetParam()) {
+    ASSERT_GT(deferred.SubBatchCnt(), 1U);
+  }
+
+  deferred.Clear();
+  ASSERT_EQ(dump(&deferred), "||");
+  ASSERT_EQ(deferred.SubBatchCnt(), 1U);
+}
+
 TEST_P(WriteBatchWithIndexTest, TestRandomIteraratorWithBase) {
   std::vector<std::string> source_strings = {"a", "b", "c", "d", "e",
                                              "f", "g", "h", "i", "j"};